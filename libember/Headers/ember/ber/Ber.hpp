@@ -25,6 +25,7 @@
  */
 
 #include "../Version.hpp"
+#include "DecoderFactory.hpp"
 #include "Encoding.hpp"
 
 
@@ -22,7 +22,13 @@
 
 #include <map>
 #include "../util/Api.hpp"
+#include "traits/Boolean.hpp"
 #include "traits/Decoder.hpp"
+#include "traits/Integral.hpp"
+#include "traits/ObjectIdentifier.hpp"
+#include "traits/Octets.hpp"
+#include "traits/Real.hpp"
+#include "traits/StdString.hpp"
 
 namespace libember { namespace ber
 {
@@ -32,9 +38,16 @@ namespace libember { namespace ber
     LIBEMBER_API DecoderFactory& decoderFactory();
 
     /**
-     * A global factory class with which all decoder implementations are
-     * automatically registered. And which may be used to dynamically map
-     * universal tags to specific decoders for the corresponding C++ type.
+     * A global factory class which may be used to dynamically map universal
+     * tags to specific decoders for the corresponding C++ type.
+     * The decoders of the types supported by the library are owned by the
+     * factory and registered by its constructor: integers are decoded as long,
+     * reals as double, and booleans, strings, octet strings and object identifiers
+     * as the corresponding library types. The factory is constructed during
+     * static initialization and is not modified afterwards, so it may be used
+     * by any number of threads at the same time without synchronization.
+     * Decoders for additional types may be registered with a RegisterDecoder
+     * instance, which must have static storage duration for the same reason.
      */
     class LIBEMBER_API DecoderFactory
     {
@@ -55,8 +68,8 @@ namespace libember { namespace ber
 
         protected:
             /**
-             * Default constructor. Creates a decoder factory without any
-             * preregistered decoders.
+             * Default constructor. Creates a decoder factory with the decoders
+             * of the types supported by the library.
              */
             DecoderFactory();
 
@@ -70,16 +83,49 @@ namespace libember { namespace ber
              *      decoding concrete, typed values corresponding to the
              *      universal type tag passed in @p universalTag.
              */
-            void registerDecoder(Tag universalTag, Decoder* decoder);
+            void registerDecoder(Tag universalTag, Decoder const* decoder);
 
         private:
-            typedef std::map<Tag, Decoder*> DecoderMap;
+            typedef std::map<Tag, Decoder const*> DecoderMap;
+
+            /**
+             * The number of primitive universal tags whose decoders are stored in
+             * a directly indexed table. Covers all types defined by X.680.
+             */
+            enum { UniversalTableSize = 32 };
+
+            /**
+             * Returns whether the decoder for @p universalTag is stored in the
+             * directly indexed table, which is the case for primitive universal
+             * tags with a number below UniversalTableSize.
+             * @param universalTag The tag to test.
+             * @return true if the decoder is stored in the table, otherwise false.
+             */
+            static bool isTableTag(Tag const& universalTag);
 
         private:
+            /** Prohibit copying */
+            DecoderFactory(DecoderFactory const&);
+
+            /** Prohibit assignment */
+            DecoderFactory& operator=(DecoderFactory const&);
+
+        private:
+            DecoderImpl<bool> const m_booleanDecoder;
+            DecoderImpl<long> const m_integerDecoder;
+            DecoderImpl<double> const m_realDecoder;
+            DecoderImpl<std::string> const m_stringDecoder;
+            DecoderImpl<Octets> const m_octetsDecoder;
+            DecoderImpl<ObjectIdentifier> const m_objectIdentifierDecoder;
+
             /**
-             * @note Please note that the decoders contained in this map are not
-             *      owned by this instance.
+             * @note Please note that apart from the built-in decoders above the
+             *      decoders contained in the table and in the map are not owned by
+             *      this instance. The map only contains decoders for tags that do
+             *      not fit into the table.
              */
+            Decoder const* m_universalDecoders[UniversalTableSize];
+
 #ifdef _MSC_VER
 #  pragma warning(push)
 #  pragma warning(disable : 4251)
@@ -92,7 +138,10 @@ namespace libember { namespace ber
 
     /**
      * Singleton accessor function. Returns a reference to the global decoder
-     * factory.
+     * factory, which is constructed during static initialization. A thread
+     * started by main() therefore never observes the factory while it is
+     * constructed, even with compilers that do not synchronize the
+     * initialization of function-local statics.
      * @return A reference to the global decoder factory.
      */
     LIBEMBER_API
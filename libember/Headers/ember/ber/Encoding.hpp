@@ -24,6 +24,7 @@
 #include "traits/Tag.hpp"
 #include "traits/Length.hpp"
 #include "traits/Octets.hpp"
+#include "traits/OctetsView.hpp"
 #include "traits/ObjectIdentifier.hpp"
 #include "traits/Boolean.hpp"
 #include "traits/Integral.hpp"
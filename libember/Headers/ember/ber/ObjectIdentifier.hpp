@@ -21,18 +21,21 @@
 #define __LIBEMBER_BER_OBJECTIDENTIFIER_HPP
 
 #include <algorithm>
-#include <deque>
+#include <cstddef>
 #include "../util/Api.hpp"
+#include "../util/SmallVector.hpp"
 
 namespace libember { namespace ber
 {
     /**
      * A simple template type that wraps an array of signed integer values representing a
      * relative object identifier.
+     * Up to twelve sub-identifiers are stored within the object itself, so that
+     * the paths commonly used by Ember+ do not require a heap allocation.
      */
     class LIBEMBER_API ObjectIdentifier
     {
-        typedef std::deque<std::size_t> Container;
+        typedef util::SmallVector<std::size_t, 12> Container;
 
         public:
             typedef Container::value_type value_type;
@@ -124,6 +127,7 @@ namespace libember { namespace ber
             /**
              * Swap method that exchanges the object identifier stored within
              * this instance with the object identifier stored in @p other.
+             * Never throws.
              * @param other a reference to the ObjectIdentifier instance this
              *      instance should exchange its contents with.
              */
@@ -149,9 +153,41 @@ namespace libember { namespace ber
             /**
              * Prepends the given element value to the beginning of the oid. 
              * @param value The value to prepend to the oid.
+             * @note The sub-identifiers are stored contiguously, so this method
+             *      moves all of them and takes linear time. Use push_back and
+             *      std::reverse to build an oid from its end.
              */
             void push_front(value_type value);
 
+            /**
+             * Removes the last element of the oid. The storage is kept, so
+             * an oid used as a path stack doesn't allocate once it has grown.
+             * @note The behaviour of this method is undefined if the oid is empty.
+             */
+            void pop_back();
+
+            /**
+             * Removes all elements of the oid, keeping the storage.
+             */
+            void clear();
+
+            /**
+             * Returns whether this object identifier starts with the sub-identifiers
+             * of @p prefix. An object identifier always starts with itself and with
+             * an empty object identifier.
+             * @param prefix The object identifier to compare the beginning of this
+             *      instance with.
+             * @return True if @p prefix is a prefix of this object identifier.
+             */
+            bool startsWith(ObjectIdentifier const& prefix) const;
+
+            /**
+             * Computes a hash value of the sub-identifiers, which can be used to
+             * store object identifiers in hashed containers.
+             * @return The hash value of this object identifier.
+             */
+            std::size_t hash() const;
+
         private:
 #ifdef _MSC_VER
 #  pragma warning(push)
@@ -207,7 +243,8 @@ namespace libember { namespace ber
     template<typename InputIterator>
     ObjectIdentifier::ObjectIdentifier(InputIterator first, InputIterator last)
     {
-        m_items.assign(first, last);
+        for(; first != last; ++first)
+            m_items.push_back(static_cast<value_type>(*first));
     }
 
     inline bool ObjectIdentifier::empty() const
@@ -242,12 +279,17 @@ namespace libember { namespace ber
 
     inline ObjectIdentifier::reference ObjectIdentifier::back()
     {
-        return m_items.back();
+        return m_items[m_items.size() - 1];
     }
 
     inline ObjectIdentifier::const_reference ObjectIdentifier::back() const
     {
-        return m_items.back();
+        return m_items[m_items.size() - 1];
+    }
+
+    inline bool ObjectIdentifier::startsWith(ObjectIdentifier const& prefix) const
+    {
+        return (prefix.size() <= size()) && std::equal(prefix.begin(), prefix.end(), begin());
     }
 
     inline bool operator!=(ObjectIdentifier const& lhs, ObjectIdentifier const& rhs)
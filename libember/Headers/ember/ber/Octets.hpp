@@ -81,10 +81,25 @@ namespace libember { namespace ber
              */
             const_iterator end() const;
 
+            /**
+             * Non-throwing swap method. Exchanges the bytes of this instance
+             * with those of @p other.
+             * @param other The instance to exchange the bytes with.
+             */
+            void swap(Octets& other);
+
         private:
             ByteVector m_data;
     };
 
+    /**
+     * Free version of swap to allow it's usage through ADL.
+     * @param lhs a reference to the first instance.
+     * @param rhs a reference to a second instance whose contents should be
+     *      swapped with those of @p lhs.
+     */
+    void swap(Octets& lhs, Octets& rhs);
+
     /**************************************************************************/
     /* Inline implementation                                                  */
     /**************************************************************************/
@@ -128,6 +143,16 @@ namespace libember { namespace ber
     {
         return m_data.end();
     }
+
+    inline void Octets::swap(Octets& other)
+    {
+        m_data.swap(other.m_data);
+    }
+
+    inline void swap(Octets& lhs, Octets& rhs)
+    {
+        lhs.swap(rhs);
+    }
 }
 }
 
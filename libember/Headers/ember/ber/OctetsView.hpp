@@ -0,0 +1,148 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef __LIBEMBER_BER_OCTETSVIEW_HPP
+#define __LIBEMBER_BER_OCTETSVIEW_HPP
+
+#include <cstddef>
+#include "Octets.hpp"
+
+namespace libember { namespace ber
+{
+    /**
+     * A non-owning reference to a byte array, which is encoded like Octets.
+     * A view may be stored in a leaf, so that octet strings can be forwarded
+     * without copying them, but it does not keep the referenced bytes alive.
+     * Whoever keeps the bytes beyond the lifetime of their owner, for example
+     * the decoded tree they have been taken from, has to call retain() to
+     * create an owning copy.
+     */
+    class OctetsView
+    {
+        public:
+            typedef unsigned char       value_type;
+            typedef std::size_t         size_type;
+            typedef value_type const*   const_iterator;
+
+            /** Default constructor. Initializes an empty view. */
+            OctetsView();
+
+            /**
+             * Initializes a view that refers to the bytes in the range
+             * [@p first, @p last).
+             * @param first Pointer to the first byte.
+             * @param last Pointer to the byte one past the last byte.
+             */
+            OctetsView(const_iterator first, const_iterator last);
+
+            /**
+             * Initializes a view that refers to the bytes stored in @p octets.
+             * The view becomes invalid when @p octets is modified or destroyed.
+             * @param octets The byte array to refer to.
+             */
+            explicit OctetsView(Octets const& octets);
+
+            /**
+             * Returns whether or not this view is empty.
+             * @return True if the view does not refer to any bytes.
+             */
+            bool empty() const;
+
+            /**
+             * Returns the number of bytes this view refers to.
+             * @return The number of bytes this view refers to.
+             */
+            size_type size() const;
+
+            /**
+             * Returns a pointer to the first byte of this view.
+             * @return A pointer to the first byte of this view.
+             */
+            const_iterator begin() const;
+
+            /**
+             * Returns a pointer to the byte one past the last byte of this view.
+             * @return A pointer to the byte one past the last byte of this view.
+             */
+            const_iterator end() const;
+
+            /**
+             * Copies the referenced bytes into a new Octets instance, which
+             * remains valid independently of the owner of the bytes.
+             * @return An owning copy of the referenced bytes.
+             */
+            Octets retain() const;
+
+        private:
+            const_iterator m_first;
+            const_iterator m_last;
+    };
+
+    /**************************************************************************/
+    /* Inline implementation                                                  */
+    /**************************************************************************/
+
+    inline OctetsView::OctetsView()
+        : m_first(0), m_last(0)
+    {
+    }
+
+    inline OctetsView::OctetsView(const_iterator first, const_iterator last)
+        : m_first(first), m_last(last)
+    {
+    }
+
+    inline OctetsView::OctetsView(Octets const& octets)
+        : m_first(0), m_last(0)
+    {
+        if (octets.size() > 0)
+        {
+            m_first = &*octets.begin();
+            m_last = m_first + octets.size();
+        }
+    }
+
+    inline bool OctetsView::empty() const
+    {
+        return m_first == m_last;
+    }
+
+    inline OctetsView::size_type OctetsView::size() const
+    {
+        return static_cast<size_type>(m_last - m_first);
+    }
+
+    inline OctetsView::const_iterator OctetsView::begin() const
+    {
+        return m_first;
+    }
+
+    inline OctetsView::const_iterator OctetsView::end() const
+    {
+        return m_last;
+    }
+
+    inline Octets OctetsView::retain() const
+    {
+        return Octets(m_first, m_last);
+    }
+}
+}
+
+#endif  // __LIBEMBER_BER_OCTETSVIEW_HPP
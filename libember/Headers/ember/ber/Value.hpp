@@ -20,6 +20,7 @@
 #ifndef __LIBEMBER_BER_VALUE_HPP
 #define __LIBEMBER_BER_VALUE_HPP
 
+#include <algorithm>
 #include <typeinfo>
 #include "../util/Api.hpp"
 #include "traits/CodecTraits.hpp"
@@ -55,6 +56,18 @@ namespace libember { namespace ber
             template<typename ValueType>
             Value(ValueType value);
 
+            /**
+             * Creates an instance that wraps the contents of @p value without
+             * copying them. The contents are swapped into the wrapped value, so
+             * @p value is left in a default constructed state. This avoids copying
+             * large strings or octet sequences, which C++03 cannot move.
+             * @param value a reference to the value whose contents should be
+             *      taken over.
+             * @return An instance wrapping the former contents of @p value.
+             */
+            template<typename ValueType>
+            static Value adopt(ValueType& value);
+
             /** Destructor. */
             virtual ~Value();
 
@@ -79,6 +92,17 @@ namespace libember { namespace ber
              */
             Value& operator=(Value other);
 
+            /**
+             * Sets the wrapped value to a copy of @p value. If this instance is
+             * the only owner of a payload of the same type, the payload is reused
+             * and the value is assigned in place, so that no memory is allocated
+             * unless the wrapped value itself has to grow. Otherwise a new payload
+             * is created.
+             * @param value The value to wrap.
+             */
+            template<typename ValueType>
+            void assign(ValueType const& value);
+
             /**
              * Implicit conversion to boolean operator to test whether
              * the object is in a regular state, i.e. has a valid wrapped
@@ -152,6 +176,16 @@ namespace libember { namespace ber
             template<typename DestType>
             DestType as() const;
 
+            /**
+             * Returns a pointer to the currently wrapped value without copying it.
+             * @return A pointer to the wrapped value, or a null pointer if the
+             *      instance is currently in a singular state or the type of the
+             *      wrapped value does not match the requested type. The pointer
+             *      remains valid until this instance is modified or destroyed.
+             */
+            template<typename DestType>
+            DestType const* peek() const;
+
         private:
             /**
              * Type-erasure structure that makes the operations defined in the
@@ -204,6 +238,12 @@ namespace libember { namespace ber
                      */
                     void releaseRef();
 
+                    /**
+                     * Returns whether this payload is referenced by a single value.
+                     * @return True if the reference count is one, otherwise false.
+                     */
+                    bool unique() const;
+
                 protected:
                     /**
                      * Default constructor.
@@ -251,7 +291,20 @@ namespace libember { namespace ber
                      * count of one and the wrapped value as a copy of @p value.
                      * @param value the value this instance should wrap.
                      */
-                    explicit PayloadImpl(ValueType value);
+                    explicit PayloadImpl(ValueType const& value);
+
+                    /**
+                     * Exchanges the held value with @p value.
+                     * @param value a reference to the value to exchange the held
+                     *      value with.
+                     */
+                    void swapValue(ValueType& value);
+
+                    /**
+                     * Replaces the held value with a copy of @p value.
+                     * @param value the value to copy.
+                     */
+                    void assignValue(ValueType const& value);
 
                     /**
                      * Accessor to retrieve the held value.
@@ -259,6 +312,12 @@ namespace libember { namespace ber
                      */
                     ValueType value() const;
 
+                    /**
+                     * Accessor to retrieve a reference to the held value.
+                     * @return A reference to the held value.
+                     */
+                    ValueType const& reference() const;
+
                     /** @see Payload::universalTag() */
                     virtual Tag universalTag() const;
 
@@ -298,6 +357,35 @@ namespace libember { namespace ber
         : m_payload(new PayloadImpl<ValueType>(value))
     {}
 
+    template<typename ValueType>
+    inline Value Value::adopt(ValueType& value)
+    {
+        PayloadImpl<ValueType>* const payload = new PayloadImpl<ValueType>();
+        payload->swapValue(value);
+
+        Value result;
+        result.m_payload = payload;
+        return result;
+    }
+
+    template<typename ValueType>
+    inline void Value::assign(ValueType const& value)
+    {
+        if ((m_payload != 0) && m_payload->unique() && (m_payload->typeId() == typeid(ValueType)))
+        {
+            static_cast<PayloadImpl<ValueType>*>(m_payload)->assignValue(value);
+        }
+        else
+        {
+            Value(value).swap(*this);
+        }
+    }
+
+    inline bool Value::Payload::unique() const
+    {
+        return m_refCount == 1;
+    }
+
     template<typename DestType>
     inline DestType Value::as() const
     {
@@ -308,22 +396,51 @@ namespace libember { namespace ber
         return static_cast<PayloadImpl<DestType> const*>(m_payload)->value();
     }
 
+    template<typename DestType>
+    inline DestType const* Value::peek() const
+    {
+        if ((m_payload == 0) || (m_payload->typeId() != typeid(DestType)))
+        {
+            return 0;
+        }
+        return &static_cast<PayloadImpl<DestType> const*>(m_payload)->reference();
+    }
+
     template<typename ValueType>
     inline Value::PayloadImpl<ValueType>::PayloadImpl()
         : Payload(), m_value()
     {}
 
     template<typename ValueType>
-    inline Value::PayloadImpl<ValueType>::PayloadImpl(ValueType value)
+    inline Value::PayloadImpl<ValueType>::PayloadImpl(ValueType const& value)
         : Payload(), m_value(value)
     {}
 
+    template<typename ValueType>
+    inline void Value::PayloadImpl<ValueType>::swapValue(ValueType& value)
+    {
+        using std::swap;
+        swap(m_value, value);
+    }
+
+    template<typename ValueType>
+    inline void Value::PayloadImpl<ValueType>::assignValue(ValueType const& value)
+    {
+        m_value = value;
+    }
+
     template<typename ValueType>
     inline ValueType Value::PayloadImpl<ValueType>::value() const
     {
         return m_value;
     }
 
+    template<typename ValueType>
+    inline ValueType const& Value::PayloadImpl<ValueType>::reference() const
+    {
+        return m_value;
+    }
+
     template<typename ValueType>
     inline Tag Value::PayloadImpl<ValueType>::universalTag() const
     {
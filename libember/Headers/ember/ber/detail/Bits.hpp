@@ -0,0 +1,85 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef __LIBEMBER_BER_DETAIL_BITS_HPP
+#define __LIBEMBER_BER_DETAIL_BITS_HPP
+
+#include <cstddef>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+#  include <intrin.h>
+#  pragma intrinsic(_BitScanReverse64)
+#  pragma intrinsic(_BitScanForward64)
+#endif
+
+namespace libember { namespace ber { namespace detail
+{
+    /**
+     * Returns the number of bits required to represent @p value, which is the
+     * position of the most significant set bit plus one.
+     * @param value The value to examine.
+     * @return The number of significant bits, or zero if @p value is zero.
+     */
+    inline std::size_t significantBits(unsigned long long value)
+    {
+        if (value == 0)
+            return 0;
+
+#if defined(__GNUC__)
+        return 64 - static_cast<std::size_t>(__builtin_clzll(value));
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+        unsigned long index;
+        _BitScanReverse64(&index, value);
+        return static_cast<std::size_t>(index) + 1;
+#else
+        std::size_t bits = 0;
+        for (; value != 0; value >>= 1)
+            ++bits;
+
+        return bits;
+#endif
+    }
+
+    /**
+     * Returns the number of consecutive zero bits starting at the least
+     * significant bit of @p value.
+     * @param value The value to examine. Must not be zero.
+     * @return The number of trailing zero bits.
+     */
+    inline std::size_t trailingZeroBits(unsigned long long value)
+    {
+#if defined(__GNUC__)
+        return static_cast<std::size_t>(__builtin_ctzll(value));
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+        unsigned long index;
+        _BitScanForward64(&index, value);
+        return static_cast<std::size_t>(index);
+#else
+        std::size_t bits = 0;
+        for (; (value & 1) == 0; value >>= 1)
+            ++bits;
+
+        return bits;
+#endif
+    }
+}
+}
+}
+
+#endif  // __LIBEMBER_BER_DETAIL_BITS_HPP
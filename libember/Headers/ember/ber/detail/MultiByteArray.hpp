@@ -0,0 +1,211 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef __LIBEMBER_BER_DETAIL_MULTIBYTEARRAY_HPP
+#define __LIBEMBER_BER_DETAIL_MULTIBYTEARRAY_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include "../../util/OctetStream.hpp"
+
+namespace libember { namespace ber { namespace detail
+{
+    /**
+     * Provides the largest number of bytes a sub-identifier of type @p ValueType
+     * may occupy when encoded in multibyte form.
+     */
+    template<typename ValueType>
+    struct MultiByteMaxEncodedLength
+    {
+        enum { value = (sizeof(ValueType) * 8 + 6) / 7 };
+    };
+
+    /**
+     * Decodes a contiguous sequence of multibyte words, like the payload of a
+     * RELATIVE-OID, into an array of sub-identifiers.
+     * Runs of eight single byte words, which make up most paths and
+     * connection sources, are recognized with a single test of a
+     * machine word and copied without further branching.
+     * A last word that is not terminated is decoded from the bytes present.
+     * Bits exceeding the width of @p ValueType are discarded.
+     * @param first a pointer to the first byte to decode.
+     * @param last a pointer one past the last byte to decode.
+     * @param output a pointer to the array receiving the sub-identifiers. The
+     *      array must be able to hold at least last - first items.
+     * @return The number of sub-identifiers written to @p output.
+     */
+    template<typename ValueType>
+    std::size_t decodeMultibyteArray(unsigned char const* first, unsigned char const* last, ValueType* output);
+
+    /**
+     * Returns the number of bytes required to encode an array of
+     * sub-identifiers in multibyte form.
+     * @param first a pointer to the first sub-identifier.
+     * @param last a pointer one past the last sub-identifier.
+     * @return The encoded length in bytes.
+     */
+    template<typename ValueType>
+    std::size_t getMultiByteArrayEncodedLength(ValueType const* first, ValueType const* last);
+
+    /**
+     * Encodes an array of sub-identifiers in multibyte form, producing the
+     * same bytes as encodeMultibyte does for each sub-identifier.
+     * @param first a pointer to the first sub-identifier.
+     * @param last a pointer one past the last sub-identifier.
+     * @param output a pointer to the buffer receiving the encoded bytes. The
+     *      buffer must be able to hold at least the number of bytes returned
+     *      by getMultiByteArrayEncodedLength.
+     * @return A pointer one past the last byte written.
+     */
+    template<typename ValueType>
+    unsigned char* encodeMultibyteArray(ValueType const* first, ValueType const* last, unsigned char* output);
+
+    /**
+     * Encodes an array of sub-identifiers in multibyte form and appends the
+     * encoded bytes to an octet stream. The sub-identifiers are encoded into
+     * a local buffer in blocks, each of which is appended as a whole.
+     * @param output a reference to the octet stream to append the bytes to.
+     * @param first a pointer to the first sub-identifier.
+     * @param last a pointer one past the last sub-identifier.
+     */
+    template<typename ValueType>
+    void encodeMultibyteArray(util::OctetStream& output, ValueType const* first, ValueType const* last);
+
+
+    /**************************************************************************/
+    /* Mandatory inline implementation                                        */
+    /**************************************************************************/
+
+    template<typename ValueType>
+    inline std::size_t decodeMultibyteArray(unsigned char const* first, unsigned char const* last, ValueType* output)
+    {
+        ValueType* const begin = output;
+
+        while (first != last)
+        {
+            if (last - first >= 8)
+            {
+                // The continuation bits are tested in all eight bytes at once, which
+                // does not depend on the byte order of the machine.
+                unsigned long long word;
+                std::memcpy(&word, first, 8);
+
+                if ((word & 0x8080808080808080ULL) == 0)
+                {
+                    output[0] = first[0];
+                    output[1] = first[1];
+                    output[2] = first[2];
+                    output[3] = first[3];
+                    output[4] = first[4];
+                    output[5] = first[5];
+                    output[6] = first[6];
+                    output[7] = first[7];
+                    output += 8;
+                    first += 8;
+                    continue;
+                }
+            }
+
+            ValueType value = 0;
+            unsigned char byte = 0;
+            do
+            {
+                byte = *first++;
+                value = static_cast<ValueType>((value << 7) | (byte & 0x7F));
+            } while (((byte & 0x80) != 0) && (first != last));
+
+            *output++ = value;
+        }
+
+        return static_cast<std::size_t>(output - begin);
+    }
+
+    template<typename ValueType>
+    inline std::size_t getMultiByteArrayEncodedLength(ValueType const* first, ValueType const* last)
+    {
+        std::size_t length = 0;
+        for (/* Nothing */; first != last; ++first)
+        {
+            length += 1;
+            for (ValueType rest = *first >> 7; rest != 0; rest >>= 7)
+            {
+                length += 1;
+            }
+        }
+        return length;
+    }
+
+    template<typename ValueType>
+    inline unsigned char* encodeMultibyteArray(ValueType const* first, ValueType const* last, unsigned char* output)
+    {
+        // The shift of the most significant group of seven bits a ValueType may hold.
+        int const MostSignificantShift = (MultiByteMaxEncodedLength<ValueType>::value - 1) * 7;
+
+        for (/* Nothing */; first != last; ++first)
+        {
+            ValueType const value = *first;
+
+            if (value < (ValueType(1) << 7))
+            {
+                *output++ = static_cast<unsigned char>(value);
+            }
+            else if (value < (ValueType(1) << 14))
+            {
+                output[0] = static_cast<unsigned char>(0x80 | (value >> 7));
+                output[1] = static_cast<unsigned char>(value & 0x7F);
+                output += 2;
+            }
+            else
+            {
+                int shift = MostSignificantShift;
+                while ((value >> shift) == 0)
+                {
+                    shift -= 7;
+                }
+
+                for (/* Nothing */; shift > 0; shift -= 7)
+                {
+                    *output++ = static_cast<unsigned char>(0x80 | ((value >> shift) & 0x7F));
+                }
+                *output++ = static_cast<unsigned char>(value & 0x7F);
+            }
+        }
+        return output;
+    }
+
+    template<typename ValueType>
+    inline void encodeMultibyteArray(util::OctetStream& output, ValueType const* first, ValueType const* last)
+    {
+        std::size_t const BlockLength = 64;
+        unsigned char buffer[BlockLength * MultiByteMaxEncodedLength<ValueType>::value];
+
+        while (first != last)
+        {
+            ValueType const* const blockLast = first + std::min<std::size_t>(BlockLength, last - first);
+            unsigned char* const bufferLast = encodeMultibyteArray(first, blockLast, buffer);
+            output.append(buffer, bufferLast);
+            first = blockLast;
+        }
+    }
+}
+}
+}
+
+#endif  // __LIBEMBER_BER_DETAIL_MULTIBYTEARRAY_HPP
@@ -20,6 +20,7 @@
 #ifndef __LIBEMBER_BER_IMPL_DECODERFACTORY_IPP
 #define __LIBEMBER_BER_IMPL_DECODERFACTORY_IPP
 
+#include <algorithm>
 #include <stdexcept>
 #include "../../util/Inline.hpp"
 #include "../Length.hpp"
@@ -38,25 +39,71 @@ namespace libember { namespace ber
             throw std::runtime_error("Expected a universal tag. But found a different tag instead."); 
         }
        
-        DecoderMap::const_iterator const it = m_decoderMap.find(universalTag);
-        if (it == m_decoderMap.end())
+        Decoder const* decoder = 0;
+        if (isTableTag(universalTag))
+        {
+            decoder = m_universalDecoders[universalTag.number()];
+        }
+        else
+        {
+            DecoderMap::const_iterator const it = m_decoderMap.find(universalTag);
+            if (it != m_decoderMap.end())
+            {
+                decoder = it->second;
+            }
+        }
+
+        if (decoder == 0)
         {
             throw std::runtime_error("Encountered universal tag for which no suitable decoder is available."); 
         }
 
         LengthType const length = ber::decode<LengthType>(input);
-        return it->second->decode(input, length.value);
+        return decoder->decode(input, length.value);
     }
 
     LIBEMBER_INLINE
     DecoderFactory::DecoderFactory()
-        : m_decoderMap()
-    {}
+        : m_booleanDecoder()
+        , m_integerDecoder()
+        , m_realDecoder()
+        , m_stringDecoder()
+        , m_octetsDecoder()
+        , m_objectIdentifierDecoder()
+        , m_decoderMap()
+    {
+        std::fill(m_universalDecoders, m_universalDecoders + UniversalTableSize, static_cast<Decoder const*>(0));
+
+        registerDecoder(universalTag<bool>(), &m_booleanDecoder);
+        registerDecoder(universalTag<long>(), &m_integerDecoder);
+        registerDecoder(universalTag<double>(), &m_realDecoder);
+        registerDecoder(universalTag<std::string>(), &m_stringDecoder);
+        registerDecoder(universalTag<Octets>(), &m_octetsDecoder);
+        registerDecoder(universalTag<ObjectIdentifier>(), &m_objectIdentifierDecoder);
+    }
 
     LIBEMBER_INLINE
-    void DecoderFactory::registerDecoder(Tag universalTag, Decoder* decoder)
+    void DecoderFactory::registerDecoder(Tag universalTag, Decoder const* decoder)
     {
-        m_decoderMap.insert(std::make_pair(universalTag, decoder));
+        if (isTableTag(universalTag))
+        {
+            Decoder const*& entry = m_universalDecoders[universalTag.number()];
+            if (entry == 0)
+            {
+                entry = decoder;
+            }
+        }
+        else
+        {
+            m_decoderMap.insert(std::make_pair(universalTag, decoder));
+        }
+    }
+
+    LIBEMBER_INLINE
+    bool DecoderFactory::isTableTag(Tag const& universalTag)
+    {
+        return universalTag.preamble() == Class::Universal
+            && universalTag.number() < static_cast<Tag::Number>(UniversalTableSize);
     }
 
 
@@ -68,6 +115,15 @@ namespace libember { namespace ber
         return theDecoderFactory;
     }
 
+    namespace
+    {
+        /**
+         * Constructs the global decoder factory during static initialization,
+         * before any thread that decodes values may have been started.
+         */
+        DecoderFactory const& theDecoderFactoryInitializer = decoderFactory();
+    }
+
     LIBEMBER_API
     LIBEMBER_INLINE
     Value decode(util::OctetStream& input)
@@ -27,8 +27,9 @@ namespace libember { namespace ber
 {
     LIBEMBER_INLINE
     ObjectIdentifier::ObjectIdentifier(value_type value)
-        : m_items(1, value)
-    {}
+    {
+        m_items.push_back(value);
+    }
 
     LIBEMBER_INLINE
     ObjectIdentifier::ObjectIdentifier()
@@ -37,8 +38,7 @@ namespace libember { namespace ber
     LIBEMBER_INLINE
     void ObjectIdentifier::swap(ObjectIdentifier& other)
     {
-        using std::swap;
-        swap(m_items, other.m_items);
+        m_items.swap(other.m_items);
     }
 
     LIBEMBER_INLINE
@@ -56,7 +56,35 @@ namespace libember { namespace ber
     LIBEMBER_INLINE
     void ObjectIdentifier::push_front(value_type value)
     {
-        m_items.push_front(value);
+        m_items.insert(m_items.begin(), value);
+    }
+
+    LIBEMBER_INLINE
+    void ObjectIdentifier::pop_back()
+    {
+        m_items.erase(m_items.end() - 1, m_items.end());
+    }
+
+    LIBEMBER_INLINE
+    void ObjectIdentifier::clear()
+    {
+        m_items.clear();
+    }
+
+    LIBEMBER_INLINE
+    std::size_t ObjectIdentifier::hash() const
+    {
+        // FNV-1a over the sub-identifiers.
+        std::size_t result = 2166136261U;
+        const_iterator first = begin();
+        const_iterator const last = end();
+        for(; first != last; ++first)
+        {
+            result ^= static_cast<std::size_t>(*first);
+            result *= 16777619U;
+        }
+
+        return result;
     }
 
     LIBEMBER_INLINE
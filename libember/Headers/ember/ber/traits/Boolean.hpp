@@ -21,7 +21,6 @@
 #define __LIBEMBER_BER_TRAITS_BOOLEAN_HPP
 
 #include "CodecTraits.hpp"
-#include "RegisterDecoder.hpp"
 #include "../../meta/FunctionTraits.hpp"
 
 namespace libember { namespace ber
@@ -84,12 +83,6 @@ namespace libember { namespace ber
             return (byte != 0);
         }
     };
-
-    /**
-     * Helper template instance that makes the boolean decode function
-     * dynamically available.
-     */
-    RegisterDecoder<bool> const _booleanDecoderRegistrar;
 }
 }
 
@@ -21,7 +21,7 @@
 #define __LIBEMBER_BER_TRAITS_INTEGRAL_HPP
 
 #include "CodecTraits.hpp"
-#include "RegisterDecoder.hpp"
+#include "../detail/Bits.hpp"
 #include "../../meta/FunctionTraits.hpp"
 #include "../../meta/Signedness.hpp"
 
@@ -59,15 +59,9 @@ namespace libember { namespace ber
 
             static std::size_t encodedLength(value_type value)
             {
-                // Create a bit-mask that has the eight most significant bits set
-                value_type mask = static_cast<value_type>(value_type(0xFF) << (sizeof(value_type) * 8 - 8));
-                std::size_t length = sizeof(IntegralType);
-
-                for (; (value & mask) == 0 && length > 1; mask >>= 8)
-                {
-                    length -= 1;
-                }
-                return length;
+                // The number of bytes covering the significant bits, but at least one.
+                std::size_t const bits = significantBits(static_cast<unsigned long long>(value));
+                return (bits + 7) / 8 + (bits == 0 ? 1 : 0);
             }
         };
 
@@ -80,23 +74,13 @@ namespace libember { namespace ber
             {
                 typedef typename meta::MakeUnsigned<value_type>::type unsigned_type;
 
-                bool const isPositive = (value >= 0); 
-
-                // Create a bit-mask that has the nine most significant bits set
-                unsigned_type mask = static_cast<unsigned_type>(~((static_cast<unsigned_type>(1U) << (((sizeof(IntegralType) - 1) * 8) - 1)) - 1));
+                // Folding negative values onto their one's complement leaves the bits
+                // that differ from the sign bit, one more bit is required for the sign.
                 unsigned_type const unsignedValue = static_cast<unsigned_type>(value);
+                unsigned_type const sign = static_cast<unsigned_type>(unsigned_type(0) - (unsignedValue >> (sizeof(value_type) * 8 - 1)));
+                unsigned_type const folded = static_cast<unsigned_type>(unsignedValue ^ sign);
 
-                std::size_t length = sizeof(value_type);
-                while ((length > 1) && ((unsignedValue & mask) == (isPositive ? 0 : mask)))
-                {
-                    length -= 1;
-                    mask >>= 8;
-                }
-                if (isPositive && ((unsignedValue >> (length * 8 - 1)) != 0))
-                {
-                    length += 1;
-                }
-                return length;
+                return significantBits(static_cast<unsigned long long>(folded)) / 8 + 1;
             }
         };
 
@@ -107,14 +91,17 @@ namespace libember { namespace ber
 
             static void encode(util::OctetStream& output, value_type value)
             {
+                util::OctetStream::value_type buffer[sizeof(value_type)];
                 std::size_t const length = encodedLength(value);
                 std::size_t bits = length * 8;
 
-                while (bits > 0)
+                for (std::size_t index = 0; index < length; ++index)
                 {
                     bits -= 8;
-                    output.append(static_cast<util::OctetStream::value_type>((value >> bits) & 0xFF));
+                    buffer[index] = static_cast<util::OctetStream::value_type>((value >> bits) & 0xFF);
                 }
+
+                output.append(buffer, buffer + length);
             }
         };
 
@@ -349,21 +336,6 @@ namespace libember { namespace ber
         : detail::IntegerDecodingTraits<unsigned long long>
     {};
     
-
-    /**
-     * Helper template instances that makes the decode function
-     * for the various intrgral types dynamically available.
-     */
-    RegisterDecoder<         char     > const _charDecoderRegistrar;
-    RegisterDecoder<unsigned char     > const _unsignedCharDecoderRegistrar;
-    RegisterDecoder<         short    > const _shortDecoderRegistrar;
-    RegisterDecoder<unsigned short    > const _unsignedShortDecoderRegistrar;
-    RegisterDecoder<         int      > const _intDecoderRegistrar;
-    RegisterDecoder<unsigned int      > const _unsignedIntDecoderRegistrar;
-    RegisterDecoder<         long     > const _longDecoderRegistrar;
-    RegisterDecoder<unsigned long     > const _unsignedLongDecoderRegistrar;
-    RegisterDecoder<         long long> const _longLongDecoderRegistrar;
-    RegisterDecoder<unsigned long long> const _unsignedLongLongDecoderRegistrar;
 }
 }
 
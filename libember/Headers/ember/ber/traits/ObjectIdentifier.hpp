@@ -24,7 +24,7 @@
 #include <vector>
 #include "CodecTraits.hpp"
 #include "../ObjectIdentifier.hpp"
-#include "../detail/MultiByte.hpp"
+#include "../detail/MultiByteArray.hpp"
 #include "../../meta/FunctionTraits.hpp"
 
 namespace libember { namespace ber
@@ -52,27 +52,12 @@ namespace libember { namespace ber
 
         static std::size_t encodedLength(value_type const& value)
         {
-            std::size_t length = 0;
-            value_type::const_iterator first = value.begin();
-            value_type::const_iterator const last = value.end();
-            
-            for (/* Nothing */; first != last; ++first)
-            {
-                length += detail::getMultiByteEncodedLength(*first);
-            }
-
-            return length;
+            return detail::getMultiByteArrayEncodedLength(value.begin(), value.end());
         }
 
         static void encode(util::OctetStream& output, value_type const& value)
         {
-            value_type::const_iterator first = value.begin();
-            value_type::const_iterator const last = value.end();
-
-            for (/* Nothing */; first != last; ++first)
-            {
-                detail::encodeMultibyte(output, *first);
-            }
+            detail::encodeMultibyteArray(output, value.begin(), value.end());
         }
     };
 
@@ -81,6 +66,7 @@ namespace libember { namespace ber
     struct DecodingTraits<ObjectIdentifier>
     {
         typedef ObjectIdentifier value_type;
+
         /**
          * Traits type providing various infos on the decode functions signature.
          * Unfortunately C++03 does not yet support a library independent
@@ -94,17 +80,43 @@ namespace libember { namespace ber
         static value_type decode(util::OctetStream& input, std::size_t size)
         {
             typedef ObjectIdentifier::value_type item_type;
-            std::vector<item_type> items;
-            while(size > 0)
+
+            // Each sub-identifier occupies at least one byte, so the bytes of the
+            // value are collected into a contiguous buffer and decoded into an array
+            // of the same number of items. Short values use buffers on the stack.
+            std::size_t const ShortLength = 64;
+            if (size <= ShortLength)
             {
-                item_type const item = static_cast<item_type>(detail::decodeMultibyte(input));
-                std::size_t const encodedItemLength = detail::getMultiByteEncodedLength(item);
+                unsigned char bytes[ShortLength];
+                item_type items[ShortLength];
+                std::size_t const length = consume(input, bytes, size);
+                std::size_t const count = detail::decodeMultibyteArray(bytes, bytes + length, items);
+                return ObjectIdentifier(items, items + count);
+            }
+            else
+            {
+                std::vector<unsigned char> bytes(size);
+                std::vector<item_type> items(size);
+                std::size_t const length = consume(input, &bytes[0], size);
+                std::size_t const count = detail::decodeMultibyteArray(&bytes[0], &bytes[0] + length, &items[0]);
+                return ObjectIdentifier(items.begin(), items.begin() + count);
+            }
+        }
 
-                items.push_back(item);
-                size -= encodedItemLength;
+    private:
+        static std::size_t consume(util::OctetStream& input, unsigned char* output, std::size_t size)
+        {
+            util::OctetStream::iterator first = input.begin();
+            util::OctetStream::iterator const last = input.end();
+
+            std::size_t length = 0;
+            for (/* Nothing */; (length < size) && (first != last); ++length, ++first)
+            {
+                output[length] = *first;
             }
 
-            return ObjectIdentifier(items.begin(), items.end());
+            input.consume(first);
+            return length;
         }
     };
 }
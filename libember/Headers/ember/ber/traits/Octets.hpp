@@ -21,7 +21,6 @@
 #define __LIBEMBER_BER_TRAITS_OCTETS_HPP
 
 #include "CodecTraits.hpp"
-#include "RegisterDecoder.hpp"
 #include "../Octets.hpp"
 #include "../../meta/FunctionTraits.hpp"
 
@@ -95,12 +94,6 @@ namespace libember { namespace ber
             return octets;
         }
     };
-
-    /**
-     * Helper template instance that makes the Octets decode function
-     * dynamically available.
-     */
-    RegisterDecoder<Octets> const _octetsDecoderRegistrar;
 }
 }
 
@@ -0,0 +1,66 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef __LIBEMBER_BER_TRAITS_OCTETSVIEW_HPP
+#define __LIBEMBER_BER_TRAITS_OCTETSVIEW_HPP
+
+#include "CodecTraits.hpp"
+#include "../OctetsView.hpp"
+
+namespace libember { namespace ber
+{
+    /**
+     * UniversalTagTraits specialization for the OctetsView type.
+     */
+    template<>
+    struct UniversalTagTraits<OctetsView>
+    {
+        typedef OctetsView value_type;
+
+        static Tag universalTag()
+        {
+            return make_tag(Class::Universal, Type::OctetString);
+        }
+    };
+
+    /**
+     * EncodingTraits specialization for the OctetsView type.
+     * There is intentionally no DecodingTraits specialization, since a view
+     * cannot take ownership of the bytes it has been decoded from. Octet
+     * strings are always decoded as Octets.
+     */
+    template<>
+    struct EncodingTraits<OctetsView>
+    {
+        typedef OctetsView value_type;
+
+        static std::size_t encodedLength(value_type const& value)
+        {
+            return value.size();
+        }
+
+        static void encode(util::OctetStream& output, value_type const& value)
+        {
+            output.append(value.begin(), value.end());
+        }
+    };
+}
+}
+
+#endif // __LIBEMBER_BER_TRAITS_OCTETSVIEW_HPP
@@ -22,8 +22,8 @@
 
 #include <limits>
 #include "CodecTraits.hpp"
-#include "RegisterDecoder.hpp"
 #include "Integral.hpp"
+#include "../detail/Bits.hpp"
 #include "../../meta/FunctionTraits.hpp"
 #include "../../util/TypePun.hpp"
 
@@ -73,15 +73,9 @@ namespace libember { namespace ber
 
                     if (bits != 0)
                     {
-                        long long const exponent = ((0x7FF0000000000000LL & bits) >> 52) - 1023;
-                        unsigned long long mantissa = 0x000FFFFFFFFFFFFFULL & bits;
-                        mantissa |= 0x0010000000000000ULL;
-
-                        while((mantissa & 0xFF) == 0x00)
-                            mantissa >>= 8;
-
-                        while((mantissa & 0x01) == 0x00)
-                            mantissa >>= 1;
+                        long long exponent;
+                        unsigned long long mantissa;
+                        decompose(bits, exponent, mantissa);
 
                         std::size_t const exponentLength = ber::encodedLength<long long>(exponent);
                         unsigned char preamble = static_cast<unsigned char>(0x80 | (exponentLength - 1));
@@ -111,15 +105,9 @@ namespace libember { namespace ber
 
                     if (bits != 0)
                     {
-                        long long const exponent = ((0x7FF0000000000000LL & bits) >> 52) - 1023;
-                        unsigned long long mantissa =   0x000FFFFFFFFFFFFFULL & bits;
-                        mantissa |= 0x0010000000000000ULL;
-
-                        while((mantissa & 0xFF) == 0x00)
-                            mantissa >>= 8;
-
-                        while((mantissa & 0x01) == 0x00)
-                            mantissa >>= 1;
+                        long long exponent;
+                        unsigned long long mantissa;
+                        decompose(bits, exponent, mantissa);
 
                         encodedLength += 1;     // preamble
                         encodedLength += ber::encodedLength<long long>(exponent);
@@ -129,6 +117,22 @@ namespace libember { namespace ber
                     return encodedLength;
                 }
             }
+
+        private:
+            /**
+             * Splits the bits of a non-zero double into its unbiased exponent and
+             * its mantissa including the implicit leading bit. The trailing zero
+             * bits of the mantissa are removed in a single shift.
+             * @param bits The bit pattern of the double value.
+             * @param exponent Receives the unbiased exponent.
+             * @param mantissa Receives the normalized mantissa.
+             */
+            static void decompose(unsigned long long bits, long long& exponent, unsigned long long& mantissa)
+            {
+                exponent = ((0x7FF0000000000000LL & bits) >> 52) - 1023;
+                mantissa = (0x000FFFFFFFFFFFFFULL & bits) | 0x0010000000000000ULL;
+                mantissa >>= trailingZeroBits(mantissa);
+            }
         };
 
 
@@ -231,13 +235,6 @@ namespace libember { namespace ber
     struct DecodingTraits<double>
         : detail::RealDecodingTraits<double>
     {};
-
-    /**
-     * Helper template instances that makes the decode function
-     * for the various floating point types dynamically available.
-     */
-    RegisterDecoder<float > const _floatDecoderRegistrar;
-    RegisterDecoder<double> const _doubleDecoderRegistrar;
 }
 }
 
@@ -24,6 +24,13 @@
 
 namespace libember { namespace ber
 {
+    /**
+     * Registers the decoder of a type that is not supported by the library with
+     * the global DecoderFactory, mapping the universal tag of the type to it.
+     * Instances must have static storage duration, since the factory is shared
+     * by all threads and may only be modified before the first of them is started.
+     * The decoders of the built-in types are registered by the factory itself.
+     */
     template<typename ValueType>
     class RegisterDecoder
     {
@@ -22,7 +22,6 @@
 
 #include <string>
 #include "CodecTraits.hpp"
-#include "RegisterDecoder.hpp"
 #include "../../meta/FunctionTraits.hpp"
 
 namespace libember { namespace ber
@@ -98,12 +97,6 @@ namespace libember { namespace ber
             return result;
         }
     };
-
-    /**
-     * Helper template instance that makes the std::string decode function
-     * dynamically available.
-     */
-    RegisterDecoder<std::string> const _stdstringDecoderRegistrar;
 }
 }
 
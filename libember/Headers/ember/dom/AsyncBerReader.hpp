@@ -22,8 +22,10 @@
 
 #include <memory>
 #include <deque>
+#include <stdexcept>
 #include "../util/Api.hpp"
 #include "../util/OctetStream.hpp"
+#include "../util/OctetSlice.hpp"
 #include "../ber/Encoding.hpp"
 #include "../ber/Length.hpp"
 
@@ -31,7 +33,9 @@ namespace libember { namespace dom
 {
     class Container;
     class Node;
+    class NodeAllocator;
     class NodeFactory;
+    class StringPool;
 
     /**
      * Base class for an asynchronous ember reader
@@ -46,20 +50,129 @@ namespace libember { namespace dom
             typedef util::OctetStream::value_type value_type;
             typedef ber::Length<size_type> length_type;
 
+            /**
+             * A scoped enumeration type containing the results of decoding
+             * the bytes passed to tryRead.
+             */
+            struct ReadStatus
+            {
+                enum _Domain
+                {
+                    /** The bytes have been decoded. */
+                    Ok,
+
+                    /** A tag consists of too many bytes. */
+                    InvalidTag,
+
+                    /** A length consists of too many bytes. */
+                    InvalidLength,
+
+                    /** A terminator contains a byte that is not zero. */
+                    InvalidTerminator,
+
+                    /** A terminator appears outside of a container with indefinite length. */
+                    UnexpectedTerminator,
+
+                    /** A container ends before the element it contains is complete. */
+                    UnexpectedEndOfContainer,
+
+                    /** The outer length of an element is zero. */
+                    ZeroOuterLength,
+
+                    /** An element is longer than Limits::maximumLength. */
+                    LengthLimitExceeded,
+
+                    /** Containers are nested deeper than Limits::maximumDepth. */
+                    DepthLimitExceeded,
+
+                    /** A root element contains more than Limits::maximumElements elements. */
+                    ElementLimitExceeded,
+
+                    /** No node exists for the type of a container and Limits::skipUnknownContainers is false. */
+                    UnknownContainer
+                };
+            };
+
+            /**
+             * Bounds the memory a peer may make the reader allocate. The lengths
+             * are checked when they are decoded, before the bytes they announce are
+             * buffered. Input exceeding a limit fails like malformed input.
+             * Containers no node exists for are skipped by default, but may be
+             * rejected as well.
+             */
+            struct LIBEMBER_API Limits
+            {
+                /** Initializes limits which do not restrict the input. */
+                Limits();
+
+                /** The maximum encoded length of a single value or definite length container. */
+                size_type maximumLength;
+
+                /** The maximum number of nested containers, including the root. */
+                size_type maximumDepth;
+
+                /** The maximum number of values and containers nested within a root element. */
+                size_type maximumElements;
+
+                /**
+                 * Whether containers no node exists for are skipped together with their
+                 * contents. If false, such a container fails the reader with
+                 * ReadStatus::UnknownContainer.
+                 */
+                bool skipUnknownContainers;
+            };
+
             /** Virtual destructor */
             virtual ~AsyncBerReader();
 
             /**
-             * Resets the state of the reader
+             * Resets the state of the reader, including a decoding error.
              */
             void reset();
 
+            /**
+             * Decodes a single byte without throwing an exception for malformed input.
+             * Once an error has been detected, all further bytes are ignored and the
+             * error is returned until reset() is called. A reader decoding an S101
+             * stream thus resynchronizes at the next frame that starts a message.
+             * Exceptions thrown by the container and item callbacks or by the
+             * allocator are passed on.
+             * @param value The byte to decode.
+             * @return ReadStatus::Ok or the error that has been detected.
+             */
+            ReadStatus::_Domain tryRead(value_type value);
+
+            /**
+             * Decodes the bytes of the contiguous buffer referred to by @p first and
+             * @p last without throwing an exception for malformed input.
+             * @param first a pointer to the first byte of the buffer to decode.
+             * @param last a pointer to the byte one past the last byte of the buffer
+             *      to decode.
+             * @return ReadStatus::Ok or the error that has been detected.
+             * @see tryRead(value_type)
+             */
+            ReadStatus::_Domain tryRead(value_type const* first, value_type const* last);
+
+            /**
+             * Returns the error that has been detected since the last reset.
+             * @return ReadStatus::Ok if no error has been detected.
+             */
+            ReadStatus::_Domain status() const;
+
+            /**
+             * Returns a description of the passed status.
+             * @param status The status to describe.
+             * @return A static string describing @p status.
+             */
+            static char const* describe(ReadStatus::_Domain status);
+
             /**
              * Reads a single byte.
              * @param value The byte to decode.
              * @throw std::runtime_error if the end of a stream is reached while still decoding
              *      a container; when there is a mismatch with the decoded tag or length or
              *      when a memory exception occurs.
+             * @see tryRead(value_type)
              */
             void read(value_type value);
 
@@ -76,6 +189,75 @@ namespace libember { namespace dom
             template<typename InputIterator>
             void read(InputIterator first, InputIterator last);
 
+            /**
+             * Decodes the bytes of the contiguous buffer referred to by @p first and
+             * @p last. Unlike the generic iterator overload, this method copies complete
+             * value payloads and tag and length headers that are entirely contained in
+             * the buffer in a single step and only falls back to decoding single bytes
+             * when an element crosses the end of the buffer.
+             * @param first a pointer to the first byte of the buffer to decode.
+             * @param last a pointer to the byte one past the last byte of the buffer
+             *      to decode.
+             * @throw std::runtime_error if the end of a stream is reached while still decoding
+             *      a container; when there is a mismatch with the decoded tag or length or
+             *      when a memory exception occurs.
+             */
+            void read(value_type const* first, value_type const* last);
+
+            /**
+             * Decodes the bytes of the contiguous buffer referred to by @p first and @p last.
+             * @see read(value_type const*, value_type const*)
+             */
+            void read(value_type* first, value_type* last);
+
+            /**
+             * Enables or disables the lazy decoding of string leaves. When enabled,
+             * leaves containing a UTF8String or an OctetString keep a reference to
+             * their encoded payload, which is shared with other leaves decoded by this
+             * reader, and only decode it when their value is accessed.
+             * Lazy decoding is disabled by default.
+             * @param enabled true to enable lazy decoding, false to disable it.
+             */
+            void setLazyLeafDecoding(bool enabled);
+
+            /**
+             * Returns whether or not lazy decoding of string leaves is enabled.
+             * @return true if lazy decoding of string leaves is enabled.
+             * @see setLazyLeafDecoding
+             */
+            bool lazyLeafDecoding() const;
+
+            /**
+             * Sets the pool used to intern the values of UTF8String leaves. Leaves
+             * decoded from equal strings then share a single payload instead of
+             * allocating a copy each. Strings longer than the maximum length of the
+             * pool are decoded as usual. Interning takes precedence over lazy
+             * decoding for the strings it applies to.
+             * @param pool The pool to intern strings in, or 0 to disable interning.
+             *      The pool is not owned by this reader and must outlive the nodes
+             *      decoded while it was set.
+             */
+            void setStringPool(StringPool* pool);
+
+            /**
+             * Returns the pool used to intern the values of UTF8String leaves.
+             * @return The pool used to intern strings, or 0 if interning is disabled.
+             * @see setStringPool
+             */
+            StringPool* stringPool() const;
+
+            /**
+             * Sets the limits the decoded input is checked against.
+             * @param limits The limits to apply to the bytes read after this call.
+             */
+            void setLimits(Limits const& limits);
+
+            /**
+             * Returns the limits the decoded input is checked against.
+             * @return The current limits.
+             */
+            Limits const& limits() const;
+
         protected:
             /** Constructor */
             AsyncBerReader();
@@ -109,6 +291,18 @@ namespace libember { namespace dom
              */
             bool isContainer() const;
 
+            /**
+             * Returns the application tag of the node currently being decoded.
+             * @return The application tag of the node currently being decoded.
+             */
+            ber::Tag const& applicationTag() const;
+
+            /**
+             * Returns the type tag of the node currently being decoded.
+             * @return The type tag of the node currently being decoded.
+             */
+            ber::Tag const& typeTag() const;
+
             /**
              * Decodes a value from the value buffer.
              */
@@ -122,7 +316,65 @@ namespace libember { namespace dom
              */
             dom::Node* decodeNode(dom::NodeFactory const& factory);
 
+            /**
+             * Creates a new node from the current buffer, using the provided allocator.
+             * @param factory The application defined node factory.
+             * @param allocator The allocator to create the node with.
+             * @return A pointer to the newly created dom node.
+             */
+            dom::Node* decodeNode(dom::NodeFactory const& factory, dom::NodeAllocator& allocator);
+
+            /**
+             * Skips the contents of the container that is currently being decoded.
+             * This method may only be called from containerReady(). Neither the
+             * nodes within the container nor the end of the container itself are
+             * reported. When the container has a definite length, its contents are
+             * consumed without being decoded, otherwise only the tags and lengths are
+             * decoded until the end of the container has been found.
+             */
+            void skipContainer();
+
+            /**
+             * Records the first error detected since the last reset.
+             * @param status The detected error.
+             */
+            void fail(ReadStatus::_Domain status);
+
         private:
+            /**
+             * Returns true if the current container has a definite length and is being
+             * skipped, in which case its remaining bytes can be consumed without being decoded.
+             * @return True if the bytes of the current container can be consumed directly.
+             */
+            bool isSkippingBytes() const;
+
+            /**
+             * Consumes up to the number of remaining bytes of the current container, which
+             * is being skipped.
+             * @param first Pointer to the first byte to consume.
+             * @param last Pointer to one past the last available byte.
+             * @return A pointer to the first byte that has not been consumed.
+             */
+            value_type const* skipBlock(value_type const* first, value_type const* last);
+
+            /**
+             * Returns true if the current container or one of its parents is being skipped.
+             * @return True if the current container or one of its parents is being skipped.
+             */
+            bool isSkipping() const;
+
+            /**
+             * Copies the payload of the current value buffer into the slice buffer.
+             * @return A slice referring to the copied payload.
+             */
+            util::OctetSlice encodedSlice();
+
+            /**
+             * Decodes a single byte, unless an error has been detected.
+             * @param value The byte to decode.
+             */
+            void readByte(value_type value);
+
             /**
              * Decodes a tag. This method is called when the current decoding state 
              * is Tag.
@@ -151,6 +403,124 @@ namespace libember { namespace dom
              */
             bool readTerminatorByte(value_type value);
 
+            /**
+             * Tries to decode the element currently being read from the contiguous buffer
+             * referred to by @p first and @p last in a single step. Complete tags and
+             * lengths as well as (parts of) value payloads are consumed at once.
+             * @param first a pointer to the first byte of the buffer to decode.
+             * @param last a pointer to the byte one past the last byte of the buffer.
+             * @return A pointer to the first byte that has not been consumed. If this
+             *      equals @p first, the next byte has to be decoded by read(value_type).
+             */
+            value_type const* readBlock(value_type const* first, value_type const* last);
+
+            /**
+             * Consumes the complete tag contained in the buffer referred to by @p first
+             * and @p last. This method is called when the current decoding state is Tag
+             * and no byte of the tag has been read yet.
+             * @param first a pointer to the first byte of the buffer to decode.
+             * @param last a pointer to the byte one past the last byte of the buffer.
+             * @return A pointer to the first byte following the tag or @p first if the
+             *      tag is not completely contained in the buffer.
+             */
+            value_type const* readTagBlock(value_type const* first, value_type const* last);
+
+            /**
+             * Consumes a header consisting of a single byte tag and a short form length,
+             * which is how nearly all Glow elements are encoded, without buffering or
+             * decoding it byte by byte. This method is called when the current decoding
+             * state is Tag and no byte of the tag has been read yet.
+             * @param first a pointer to the first byte of the buffer to decode.
+             * @param last a pointer to the byte one past the last byte of the buffer.
+             * @return A pointer to the first byte following the header or @p first if
+             *      the buffer does not start with such a header. In that case the
+             *      header has to be decoded by readTagBlock and readLengthBlock.
+             */
+            value_type const* readHeaderBlock(value_type const* first, value_type const* last);
+
+            /**
+             * Consumes the complete length contained in the buffer referred to by @p first
+             * and @p last. This method is called when the current decoding state is Length
+             * and no byte of the length has been read yet.
+             * @param first a pointer to the first byte of the buffer to decode.
+             * @param last a pointer to the byte one past the last byte of the buffer.
+             * @return A pointer to the first byte following the length or @p first if the
+             *      length is not completely contained in the buffer.
+             */
+            value_type const* readLengthBlock(value_type const* first, value_type const* last);
+
+            /**
+             * Consumes as many bytes of the current value payload as are contained in
+             * the buffer referred to by @p first and @p last. This method is called when
+             * the current decoding state is Value.
+             * @param first a pointer to the first byte of the buffer to decode.
+             * @param last a pointer to the byte one past the last byte of the buffer.
+             * @return A pointer to the first byte that does not belong to the value.
+             */
+            value_type const* readValueBlock(value_type const* first, value_type const* last);
+
+            /**
+             * Appends the bytes referred to by @p first and @p last to the current buffer
+             * and adds their number to the bytes read by the current container.
+             * @param first a pointer to the first byte to append.
+             * @param last a pointer to the byte one past the last byte to append.
+             */
+            void appendBlock(value_type const* first, value_type const* last);
+
+            /**
+             * Adds @p count to the bytes read by the current container, if any.
+             * @param count The number of bytes that have been consumed.
+             */
+            void incrementContainerBytes(size_type count);
+
+            /**
+             * Returns the number of bytes that may still be read until the container
+             * currently being decoded is complete.
+             * @return The number of bytes remaining in the current container. If there
+             *      is no current container or the container has an indefinite length,
+             *      the maximum value of size_type is returned.
+             */
+            size_type remainingContainerBytes() const;
+
+            /**
+             * Pops all containers from the stack whose content has been read completely.
+             * @param isEofOk Specifies whether the element that has just been decoded may
+             *      terminate a container. If it may not, but a container ends, the reader
+             *      fails with ReadStatus::UnexpectedEndOfContainer.
+             */
+            void popCompletedContainers(bool isEofOk);
+
+            /**
+             * Stores the decoded tag either as application tag or type tag and resets the
+             * decoder state to Length.
+             * @param tag The decoded tag.
+             */
+            void assignTag(ber::Tag const& tag);
+
+            /**
+             * Creates the tag encoded by a single byte whose number is not 0x1F.
+             * @param value The byte containing the class, the container flag and
+             *      the number of the tag.
+             * @return The tag encoded by @p value.
+             */
+            static ber::Tag makeSingleByteTag(value_type value);
+
+            /**
+             * Decodes the length stored in the current buffer and updates the decoder state
+             * depending on whether the outer length, a container length or a value length
+             * has been decoded.
+             * @return True if the decoded element may terminate a container.
+             */
+            bool assignLength();
+
+            /**
+             * Updates the decoder state depending on whether the outer length, a container
+             * length or a value length has been decoded.
+             * @param length The decoded length.
+             * @return True if the decoded element may terminate a container.
+             */
+            bool assignLength(size_type length);
+
             /**
              * Resets the state of the decoder, including the current buffer.
              * @param state The new decoding state to set.
@@ -236,12 +606,15 @@ namespace libember { namespace dom
                      * @param tag The application tag of the container.
                      * @param type The type tag of the container.
                      * @param length The encoded length of the container.
+                     * @param isSkipped True if the contents of the container shall not
+                     *      be reported.
                      */
-                    AsyncContainer(ber::Tag const& tag, ber::Tag const& type, size_type length)
+                    AsyncContainer(ber::Tag const& tag, ber::Tag const& type, size_type length, bool isSkipped)
                         : m_tag(tag)
                         , m_type(type)
                         , m_length(length)
                         , m_bytesRead(0)
+                        , m_isSkipped(isSkipped)
                     {}
 
                     /**
@@ -309,11 +682,21 @@ namespace libember { namespace dom
                         return m_length;
                     }
 
+                    /**
+                     * Returns true if the contents of this container are being skipped.
+                     * @return True if the contents of this container are being skipped.
+                     */
+                    bool isSkipped() const
+                    {
+                        return m_isSkipped;
+                    }
+
                 private:
                     ber::Tag m_tag;
                     ber::Tag m_type;
                     size_type m_length;
                     size_type m_bytesRead;
+                    bool m_isSkipped;
             };
 
             typedef std::deque<AsyncContainer> AsyncContainerStack;
@@ -326,6 +709,7 @@ namespace libember { namespace dom
             AsyncContainerStack m_stack;
             util::OctetStream m_buffer;
             util::OctetStream m_valueBuffer;
+            util::OctetSliceBuffer m_sliceBuffer;
 #ifdef _MSC_VER
 #  pragma warning(pop)
 #endif
@@ -338,6 +722,12 @@ namespace libember { namespace dom
             ber::Tag m_typeTag;
             size_type m_length;
             size_type m_outerLength;
+            bool m_lazyLeafDecoding;
+            bool m_skipRequested;
+            StringPool* m_stringPool;
+            ReadStatus::_Domain m_status;
+            Limits m_limits;
+            size_type m_elements;
     };
 
     /**************************************************************************
@@ -349,10 +739,16 @@ namespace libember { namespace dom
     {
         for( /* Nothing */; first != last; ++first)
         {
-            read(*first);
+            if (tryRead(*first) != ReadStatus::Ok)
+                throw std::runtime_error(describe(m_status));
         }
     }
 
+    inline void AsyncBerReader::read(value_type* first, value_type* last)
+    {
+        read(static_cast<value_type const*>(first), static_cast<value_type const*>(last));
+    }
+
     template<typename ValueType>
     inline ValueType AsyncBerReader::decode()
     {
@@ -29,11 +29,15 @@ namespace libember { namespace dom
 {
     class Container;
     class Node;
+    class NodeAllocator;
     class NodeFactory;
+    class NodeFilter;
 
     /**
      * Implementation of an Async Dom reader which reconstructs
-     * a tree from the provided data.
+     * a tree from the provided data. Leaves the factory creates no node for are
+     * skipped, as are containers together with their contents, unless
+     * Limits::skipUnknownContainers is false.
      */
     class LIBEMBER_API AsyncDomReader : public AsyncBerReader
     {
@@ -44,6 +48,17 @@ namespace libember { namespace dom
              */
             explicit AsyncDomReader(dom::NodeFactory const& factory);
 
+            /**
+             * Initializes a new AsyncDomReader instance which creates all decoded
+             * nodes with the provided allocator. When an ArenaNodeAllocator is used,
+             * the storage of a complete decoded tree can be released at once after
+             * the tree has been deleted.
+             * @param factory Reference to the node factory to use.
+             * @param allocator Reference to the allocator to create the nodes with.
+             *      The allocator must outlive all nodes decoded by this reader.
+             */
+            AsyncDomReader(dom::NodeFactory const& factory, dom::NodeAllocator& allocator);
+
             /**
              * Destructor, deletes the root node, if set.
              */
@@ -62,6 +77,21 @@ namespace libember { namespace dom
              */
             dom::Node* detachRoot();
 
+            /**
+             * Sets the filter that decides which containers are decoded. Containers
+             * rejected by the filter are skipped together with all of their children,
+             * without creating any nodes. The root container is always decoded.
+             * @param filter The filter to use, or null to decode all containers. The
+             *      filter must outlive this reader or be reset before it is destroyed.
+             */
+            void setNodeFilter(dom::NodeFilter const* filter);
+
+            /**
+             * Returns the filter that decides which containers are decoded.
+             * @return The current filter or null if all containers are decoded.
+             */
+            dom::NodeFilter const* nodeFilter() const;
+
         protected:
             /**
              * This method is called when a new container node has been decoded. The
@@ -108,6 +138,8 @@ namespace libember { namespace dom
             dom::Node* m_root;
             dom::Node* m_current;
             dom::NodeFactory const& m_factory;
+            dom::NodeAllocator& m_allocator;
+            dom::NodeFilter const* m_filter;
     };
 }
 }
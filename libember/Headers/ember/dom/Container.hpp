@@ -21,6 +21,7 @@
 #define __LIBEMBER_DOM_CONTAINER_HPP
 
 #include <list>
+#include <vector>
 #include "Node.hpp"
 #include "../util/TypeErasedIterator.hpp"
 
@@ -111,6 +112,43 @@ namespace libember { namespace dom
              */
             iterator insert(iterator const& where, Node* child);
 
+            /**
+             * Inserts the nodes of the range [@p first, @p last) in front of the
+             * position referred to by @p where, in the order of the range. Unlike
+             * inserting the nodes one by one, the nodes are validated before any of
+             * them is inserted, storage for all of them is reserved at once and
+             * this container is marked dirty only once.
+             * @param where an iterator referring to a position where the children
+             *      should be inserted.
+             * @param first an input iterator referring to the first pointer to a
+             *      node that should be inserted.
+             * @param last an input iterator referring to the position one past the
+             *      last pointer to a node that should be inserted.
+             * @throw std::runtime_error if one of the nodes is already owned by a
+             *      container, in which case none of them is inserted. If inserting
+             *      a node fails, the nodes inserted before are owned by this
+             *      container, the others remain owned by the caller.
+             * @note A node must not occur more than once within the range.
+             */
+            template<typename InputIterator>
+            void insert(iterator const& where, InputIterator first, InputIterator last);
+
+            /**
+             * Appends the nodes of the range [@p first, @p last) to the sequence of
+             * child nodes.
+             * @see insert(iterator const&, InputIterator, InputIterator)
+             */
+            template<typename InputIterator>
+            void append(InputIterator first, InputIterator last);
+
+            /**
+             * Reserves storage for at least @p capacity child nodes, if the
+             * container type supports it, so that subsequent inserts do not need to
+             * reallocate.
+             * @param capacity The number of children to reserve storage for.
+             */
+            void reserve(size_type capacity);
+
             /**
              * Clear this container node by removing all child nodes contained
              * within this node.
@@ -144,6 +182,26 @@ namespace libember { namespace dom
              */
             void erase(iterator const& first, iterator const& last);
 
+            /**
+             * Remove the child node referred to by @p i from this container
+             * without deleting it. Ownership of the node is transferred back to
+             * the caller, who may insert it into a container again.
+             * @param i an iterator referring to the child node that should be
+             *      released.
+             * @return A pointer to the released node.
+             * @throw An exception derived from std::runtime_error if the
+             *      container policy does not allow the element to be erased.
+             */
+            Node* release(iterator const& i);
+
+            /**
+             * Returns a number that changes whenever child nodes are inserted into
+             * or erased from this container, so that data derived from the
+             * sequence of child nodes, like an index, can detect that it is stale.
+             * @return The current generation of the sequence of child nodes.
+             */
+            size_type generation() const;
+
         protected:
             /**
              * Constructor that initializes the node with the application tag
@@ -171,6 +229,13 @@ namespace libember { namespace dom
              */
             void fixParent(Node* child);
 
+            /**
+             * Acknowledges a change of @p child that has been reported by
+             * Node::childChanged(), so that its next change is reported again.
+             * @param child The child node whose change has been accounted for.
+             */
+            static void acknowledgeChange(Node const& child);
+
             /**
              * Try to insert the node referred to by @p child to the sequence of
              * child nodes at the position referred to by @p where. If successful,
@@ -215,13 +280,51 @@ namespace libember { namespace dom
              */
             virtual void eraseImpl(iterator const& first, iterator const& last) = 0;
 
-         private:
+            /**
+             * Reserves storage for at least @p capacity child nodes. Does nothing by
+             * default.
+             * @param capacity The number of children to reserve storage for.
+             * @note This method is never called directly, it is invoked through the
+             *      reserve() method and by the range insert.
+             */
+            virtual void reserveImpl(size_type capacity);
+
+        private:
+            /**
+             * Inserts the nodes of a contiguous range of pointers.
+             * @see insert(iterator const&, InputIterator, InputIterator)
+             */
+            void insertNodes(iterator const& where, Node* const* first, Node* const* last);
+
             /**
              * Private and unimplemented assignment operator to disallow assignment
              * of nodes to each other.
              */
             Container& operator=(Container const&);
+
+        private:
+            size_type m_generation;
    };
+
+    /**************************************************************************
+     * Mandatory inline implementation                                        *
+     **************************************************************************/
+
+    template<typename InputIterator>
+    inline void Container::insert(iterator const& where, InputIterator first, InputIterator last)
+    {
+        std::vector<Node*> const nodes(first, last);
+        if (nodes.empty() == false)
+        {
+            insertNodes(where, &nodes[0], &nodes[0] + nodes.size());
+        }
+    }
+
+    template<typename InputIterator>
+    inline void Container::append(InputIterator first, InputIterator last)
+    {
+        insert(end(), first, last);
+    }
 }
 }
 
@@ -29,7 +29,18 @@
 #include "VariantLeaf.hpp"
 #include "Sequence.hpp"
 #include "Set.hpp"
+#include "EncodedNode.hpp"
+#include "SharedNode.hpp"
+#include "NodeAllocator.hpp"
 #include "NodeFactory.hpp"
+#include "NodeFilter.hpp"
+#include "StringPool.hpp"
+#include "Executor.hpp"
+#include "WorkStealingExecutor.hpp"
+#include "ParallelEncoder.hpp"
+#include "ParallelDecoder.hpp"
+#include "LazyDocument.hpp"
+#include "FlatTree.hpp"
 #include "DomReader.hpp"
 #include "AsyncDomReader.hpp"
 
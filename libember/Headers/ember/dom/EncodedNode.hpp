@@ -0,0 +1,82 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef __LIBEMBER_DOM_ENCODEDNODE_HPP
+#define __LIBEMBER_DOM_ENCODEDNODE_HPP
+
+#include "../util/OctetSlice.hpp"
+#include "Node.hpp"
+
+namespace libember { namespace dom
+{
+    /**
+     * A node that stores the complete BER encoding of one or more consecutive nodes
+     * and writes it unchanged when being encoded. It allows to insert bytes that
+     * have been encoded in advance, such as the static properties of an element,
+     * into a tree without rebuilding the nodes they were encoded from.
+     * @note The application tag of an EncodedNode is never encoded, the node only
+     *      contributes the referenced bytes to the encoding of its parent.
+     */
+    class LIBEMBER_API EncodedNode : public Node
+    {
+        public:
+            /**
+             * Initializes a new EncodedNode which refers to the bytes of @p encoding.
+             * @param encoding The encoded nodes. The slice shares its storage, so the
+             *      bytes are not copied.
+             */
+            explicit EncodedNode(util::OctetSlice const& encoding);
+
+            /**
+             * Covariant override of Node::clone()
+             * @see Node::clone()
+             */
+            virtual EncodedNode* clone() const;
+
+            /**
+             * Returns the encoded nodes this instance refers to.
+             * @return The encoded nodes this instance refers to.
+             */
+            util::OctetSlice const& encoding() const;
+
+        protected:
+            /** @see Node::typeTagImpl() */
+            virtual ber::Tag typeTagImpl() const;
+
+            /** @see Node::updateImpl() */
+            virtual void updateImpl() const;
+
+            /** @see Node::encodeImpl() */
+            virtual void encodeImpl(util::OctetStream& output) const;
+
+            /** @see Node::encodedLengthImpl() */
+            virtual std::size_t encodedLengthImpl() const;
+
+        private:
+            util::OctetSlice m_encoding;
+    };
+}
+}
+
+#ifdef LIBEMBER_HEADER_ONLY
+#  include "impl/EncodedNode.ipp"
+#endif
+
+#endif  // __LIBEMBER_DOM_ENCODEDNODE_HPP
+
@@ -0,0 +1,71 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef __LIBEMBER_DOM_EXECUTOR_HPP
+#define __LIBEMBER_DOM_EXECUTOR_HPP
+
+#include <cstddef>
+#include "../util/Api.hpp"
+
+namespace libember { namespace dom
+{
+    /**
+     * A unit of work that can be run on any thread.
+     */
+    class LIBEMBER_API Task
+    {
+        public:
+            /** Destructor */
+            virtual ~Task();
+
+            /**
+             * Performs the work of this task. Does not throw.
+             */
+            virtual void run() = 0;
+    };
+
+    /**
+     * Interface of the thread pools the ParallelEncoder and the ParallelDecoder run
+     * their tasks with. Since libember does not depend on a threading library, the
+     * application implements this interface, usually by forwarding the tasks to a
+     * thread pool of its own.
+     */
+    class LIBEMBER_API Executor
+    {
+        public:
+            /** Destructor */
+            virtual ~Executor();
+
+            /**
+             * Runs all tasks and returns when all of them have completed.
+             * The tasks are independent of each other and may be run in
+             * any order and on any thread, including the calling one.
+             * @param tasks Pointer to the first of @p count tasks.
+             * @param count The number of tasks.
+             */
+            virtual void execute(Task* const* tasks, std::size_t count) = 0;
+    };
+}
+}
+
+#ifdef LIBEMBER_HEADER_ONLY
+#  include "impl/Executor.ipp"
+#endif
+
+#endif  // __LIBEMBER_DOM_EXECUTOR_HPP
@@ -0,0 +1,221 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef __LIBEMBER_DOM_FLATTREE_HPP
+#define __LIBEMBER_DOM_FLATTREE_HPP
+
+#include <cstddef>
+#include <vector>
+#include "../util/Api.hpp"
+#include "../ber/Tag.hpp"
+#include "../ber/Type.hpp"
+#include "../ber/Value.hpp"
+
+namespace libember { namespace dom
+{
+    /**
+     * A read-only representation of a decoded tree that stores every element as a
+     * fixed-size record in a single contiguous vector. The records are linked by
+     * their indices instead of pointers, and the encoded payloads of the leaves are
+     * kept in a separate byte arena. Compared to a tree of Node objects, this avoids
+     * one allocation and one virtual call per node and keeps siblings close to each
+     * other in memory, which suits consumers that only read a message, like a
+     * monitor or a log writer. A tree that is reused for several messages only
+     * allocates when a message is larger than any of the previous ones.
+     * The records are stored in pre-order, the root has the index 0.
+     */
+    class LIBEMBER_API FlatTree
+    {
+        public:
+            typedef unsigned char value_type;
+            typedef std::size_t size_type;
+
+            /** Index used for the links of records that do not exist. */
+            static size_type const npos = static_cast<size_type>(-1);
+
+            /**
+             * A single element of the tree.
+             */
+            struct Record
+            {
+                /** The application tag, without the constructed bit. */
+                ber::Tag applicationTag;
+
+                /** The type tag, without the constructed bit. */
+                ber::Tag typeTag;
+
+                /** Index of the parent, npos for the root. */
+                size_type parent;
+
+                /** Index of the first child, npos for leaves and empty containers. */
+                size_type firstChild;
+
+                /** Index of the next sibling, npos for the last child. */
+                size_type nextSibling;
+
+                /** Offset of the payload of a leaf within the arena. */
+                size_type valueOffset;
+
+                /** The length of the payload of a leaf. */
+                size_type valueLength;
+
+                /** True if the element is a container. */
+                bool isContainer;
+            };
+
+        public:
+            /** Initializes an empty tree. */
+            FlatTree();
+
+            /**
+             * Initializes the tree with the elements encoded in the range [first, last).
+             * @param first Pointer to the first byte of the encoded tree.
+             * @param last Pointer to the end of the encoded tree.
+             * @throw std::runtime_error if the range does not contain a complete,
+             *      well-formed tree.
+             */
+            FlatTree(value_type const* first, value_type const* last);
+
+            /**
+             * Replaces the content of this tree with the elements encoded in the range
+             * [first, last). The storage of the previous content is reused. Bytes
+             * following the encoded root are ignored.
+             * @param first Pointer to the first byte of the encoded tree.
+             * @param last Pointer to the end of the encoded tree.
+             * @throw std::runtime_error if the range does not contain a complete,
+             *      well-formed tree. The tree is empty in that case.
+             */
+            void assign(value_type const* first, value_type const* last);
+
+            /**
+             * Removes all elements, the storage is kept.
+             */
+            void clear();
+
+            /**
+             * Returns true if the tree does not contain any elements.
+             * @return True if the tree does not contain any elements.
+             */
+            bool empty() const;
+
+            /**
+             * Returns the number of elements.
+             * @return The number of elements.
+             */
+            size_type size() const;
+
+            /**
+             * Returns the record at @p index.
+             * @param index The index of the record, which must be less than size().
+             * @return The record at @p index.
+             */
+            Record const& operator[](size_type index) const;
+
+            /**
+             * Returns the type of the element at @p index.
+             * @param index The index of the element.
+             * @return The type of the element.
+             */
+            ber::Type type(size_type index) const;
+
+            /**
+             * Returns the number of children of the element at @p index.
+             * @param index The index of the element.
+             * @return The number of children of the element.
+             */
+            size_type childCount(size_type index) const;
+
+            /**
+             * Returns the index of the first child of @p parent with the application
+             * tag @p tag.
+             * @param parent The index of the container to search.
+             * @param tag The application tag to look for.
+             * @return The index of the child or npos if no child has this tag.
+             */
+            size_type find(size_type parent, ber::Tag const& tag) const;
+
+            /**
+             * Returns a pointer to the encoded payload of the leaf at @p index.
+             * @param index The index of the leaf.
+             * @return A pointer to the first byte of the payload, whose length is
+             *      stored in the record.
+             */
+            value_type const* payload(size_type index) const;
+
+            /**
+             * Decodes the value of the leaf at @p index.
+             * @param index The index of the leaf.
+             * @return The decoded value, or an empty value if the element is a
+             *      container or its universal type is not supported.
+             */
+            ber::Value value(size_type index) const;
+
+        private:
+            /** Records the elements reported by detail::scanTree(). */
+            class Builder;
+            friend class Builder;
+
+        private:
+#ifdef _MSC_VER
+#  pragma warning(push)
+#  pragma warning(disable : 4251)
+#endif
+            std::vector<Record> m_records;
+            std::vector<value_type> m_arena;
+#ifdef _MSC_VER
+#  pragma warning(pop)
+#endif
+    };
+
+    /**************************************************************************/
+    /* Mandatory inline implementation                                        */
+    /**************************************************************************/
+
+    inline bool FlatTree::empty() const
+    {
+        return m_records.empty();
+    }
+
+    inline FlatTree::size_type FlatTree::size() const
+    {
+        return m_records.size();
+    }
+
+    inline FlatTree::Record const& FlatTree::operator[](size_type index) const
+    {
+        return m_records[index];
+    }
+
+    inline ber::Type FlatTree::type(size_type index) const
+    {
+        return ber::Type::fromTag(m_records[index].typeTag);
+    }
+
+    inline FlatTree::value_type const* FlatTree::payload(size_type index) const
+    {
+        return m_arena.empty() ? 0 : &m_arena[0] + m_records[index].valueOffset;
+    }
+}
+}
+
+#ifdef LIBEMBER_HEADER_ONLY
+#  include "impl/FlatTree.ipp"
+#endif
+
+#endif  // __LIBEMBER_DOM_FLATTREE_HPP
@@ -0,0 +1,385 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef __LIBEMBER_DOM_LAZYDOCUMENT_HPP
+#define __LIBEMBER_DOM_LAZYDOCUMENT_HPP
+
+#include <cstddef>
+#include <vector>
+#include "../util/Api.hpp"
+#include "../ber/Tag.hpp"
+#include "../ber/Type.hpp"
+#include "../ber/Value.hpp"
+
+namespace libember { namespace dom
+{
+    /** Forward declarations */
+    class Node;
+    class NodeFactory;
+
+    /**
+     * An encoded tree that is navigated without being decoded. The constructor copies
+     * the message into a contiguous buffer and scans it once, recording the tags and
+     * the offsets of every TLV, but neither creates nodes nor decodes any values.
+     * Elements are then visited through lightweight handles, which decode the value
+     * of a leaf or materialize the nodes of a subtree only when asked to.
+     * Unlike a reader configured with a NodeFilter, which has to decide in advance
+     * which containers to decode, this allows a caller to look at any part of the
+     * tree in any order and to only pay for the elements it actually touches, for
+     * example when forwarding a few leaves of a large message.
+     * @note The handles refer to the document and must not be used after it has
+     *      been destroyed.
+     */
+    class LIBEMBER_API LazyDocument
+    {
+        public:
+            typedef unsigned char value_type;
+            typedef std::size_t size_type;
+
+        private:
+            /**
+             * The information recorded for a single TLV. The entries are stored in
+             * pre-order, so the first child of a container directly follows it.
+             */
+            struct Entry
+            {
+                /** The application tag, without the constructed bit. */
+                ber::Tag applicationTag;
+
+                /** The type tag, without the constructed bit. */
+                ber::Tag typeTag;
+
+                /** Offset of the first byte of the TLV. */
+                size_type begin;
+
+                /** Offset of the first byte following the TLV. */
+                size_type end;
+
+                /** Offset of the contents of the type tag. */
+                size_type contents;
+
+                /** The length of the contents, only used for leaves. */
+                size_type length;
+
+                /** Index of the parent entry. */
+                size_type parent;
+
+                /** Index of the next sibling entry. */
+                size_type nextSibling;
+
+                /** The number of children. */
+                size_type childCount;
+
+                /** True if the type tag is constructed. */
+                bool isContainer;
+            };
+
+        public:
+            /**
+             * A handle to a single element of a LazyDocument. Handles are cheap to
+             * copy and compare equal if they refer to the same element. A default
+             * constructed handle refers to no element at all and is returned when
+             * a requested element does not exist.
+             */
+            class LIBEMBER_API Element
+            {
+                friend class LazyDocument;
+
+                public:
+                    /** Initializes a handle that refers to no element. */
+                    Element();
+
+                    /**
+                     * Returns true if this handle does not refer to an element.
+                     * @return True if this handle does not refer to an element.
+                     */
+                    bool isNull() const;
+
+                    /**
+                     * Returns the application tag of this element.
+                     * @return The application tag of this element.
+                     */
+                    ber::Tag applicationTag() const;
+
+                    /**
+                     * Returns the type of this element, which is either a universal
+                     * type or an application defined type.
+                     * @return The type of this element.
+                     */
+                    ber::Type type() const;
+
+                    /**
+                     * Returns true if this element is a container.
+                     * @return True if this element is a container.
+                     */
+                    bool isContainer() const;
+
+                    /**
+                     * Returns the number of children of this element.
+                     * @return The number of children of this element.
+                     */
+                    size_type childCount() const;
+
+                    /**
+                     * Returns the first child of this element.
+                     * @return The first child or a null handle if this element has no children.
+                     */
+                    Element firstChild() const;
+
+                    /**
+                     * Returns the element following this one within its parent.
+                     * @return The next sibling or a null handle if this is the last child.
+                     */
+                    Element nextSibling() const;
+
+                    /**
+                     * Returns the container this element is a child of.
+                     * @return The parent or a null handle if this is the root.
+                     */
+                    Element parent() const;
+
+                    /**
+                     * Returns the child at @p index. The children are visited in order,
+                     * so the cost of this lookup grows with the index.
+                     * @param index The zero-based index of the child.
+                     * @return The child or a null handle if index is out of range.
+                     */
+                    Element child(size_type index) const;
+
+                    /**
+                     * Returns the first child with the application tag @p tag.
+                     * @param tag The application tag to look for.
+                     * @return The child or a null handle if no child has this tag.
+                     */
+                    Element find(ber::Tag const& tag) const;
+
+                    /**
+                     * Returns a pointer to the first byte of the encoded element.
+                     * @return A pointer to the first byte of the encoded element.
+                     */
+                    value_type const* begin() const;
+
+                    /**
+                     * Returns a pointer to the byte following the encoded element.
+                     * @return A pointer to the byte following the encoded element.
+                     */
+                    value_type const* end() const;
+
+                    /**
+                     * Decodes the value of this element straight from the buffer.
+                     * @return The decoded value, or an empty value if this element is
+                     *      a container or its universal type is not supported.
+                     */
+                    ber::Value value() const;
+
+                    /**
+                     * Creates the nodes of the subtree starting at this element. Only
+                     * this subtree is decoded, the rest of the document is not touched.
+                     * @param factory The factory used to create application defined nodes.
+                     * @return The created node, which is owned by the caller, or null if
+                     *      the type of this element is not supported.
+                     * @throw std::runtime_error if the subtree cannot be decoded.
+                     */
+                    Node* materialize(NodeFactory const& factory) const;
+
+                    /**
+                     * Returns true if both handles refer to the same element.
+                     * @param other The handle to compare this instance with.
+                     * @return True if both handles refer to the same element.
+                     */
+                    bool operator==(Element const& other) const;
+
+                    /**
+                     * Returns true if the handles refer to different elements.
+                     * @param other The handle to compare this instance with.
+                     * @return True if the handles refer to different elements.
+                     */
+                    bool operator!=(Element const& other) const;
+
+                private:
+                    /**
+                     * Initializes a handle that refers to an entry of a document.
+                     * @param document The document containing the element.
+                     * @param index The index of the entry describing the element.
+                     */
+                    Element(LazyDocument const* document, size_type index);
+
+                    /**
+                     * Returns the entry describing this element.
+                     * @return The entry describing this element.
+                     */
+                    Entry const& entry() const;
+
+                private:
+                    LazyDocument const* m_document;
+                    size_type m_index;
+            };
+
+            friend class Element;
+
+        public:
+            /**
+             * Copies the encoded tree in the range [first, last) and scans it. Bytes
+             * following the encoded root are ignored.
+             * @param first Pointer to the first byte of the encoded tree.
+             * @param last Pointer to the end of the encoded tree.
+             * @throw std::runtime_error if the range does not contain a complete,
+             *      well-formed tree.
+             */
+            LazyDocument(value_type const* first, value_type const* last);
+
+            /**
+             * Returns the root element of the document.
+             * @return The root element of the document.
+             */
+            Element root() const;
+
+            /**
+             * Returns the number of elements that have been found by the scan.
+             * @return The number of elements of the document.
+             */
+            size_type elementCount() const;
+
+            /**
+             * Returns the number of bytes of the encoded root.
+             * @return The number of bytes of the encoded root.
+             */
+            size_type encodedLength() const;
+
+        private:
+            /** Records the entries reported by detail::scanTree(). */
+            class Indexer;
+            friend class Indexer;
+
+            /** Index used for the links of entries that do not exist. */
+            static size_type const npos = static_cast<size_type>(-1);
+
+        private:
+#ifdef _MSC_VER
+#  pragma warning(push)
+#  pragma warning(disable : 4251)
+#endif
+            std::vector<value_type> m_buffer;
+            std::vector<Entry> m_entries;
+#ifdef _MSC_VER
+#  pragma warning(pop)
+#endif
+    };
+
+    /**************************************************************************/
+    /* Mandatory inline implementation                                        */
+    /**************************************************************************/
+
+    inline LazyDocument::Element::Element()
+        : m_document(0), m_index(0)
+    {}
+
+    inline LazyDocument::Element::Element(LazyDocument const* document, size_type index)
+        : m_document(document), m_index(index)
+    {}
+
+    inline LazyDocument::Entry const& LazyDocument::Element::entry() const
+    {
+        return m_document->m_entries[m_index];
+    }
+
+    inline bool LazyDocument::Element::isNull() const
+    {
+        return m_document == 0;
+    }
+
+    inline ber::Tag LazyDocument::Element::applicationTag() const
+    {
+        return entry().applicationTag;
+    }
+
+    inline ber::Type LazyDocument::Element::type() const
+    {
+        return ber::Type::fromTag(entry().typeTag);
+    }
+
+    inline bool LazyDocument::Element::isContainer() const
+    {
+        return entry().isContainer;
+    }
+
+    inline LazyDocument::size_type LazyDocument::Element::childCount() const
+    {
+        return entry().childCount;
+    }
+
+    inline LazyDocument::Element LazyDocument::Element::firstChild() const
+    {
+        return entry().childCount > 0 ? Element(m_document, m_index + 1) : Element();
+    }
+
+    inline LazyDocument::Element LazyDocument::Element::nextSibling() const
+    {
+        size_type const next = entry().nextSibling;
+        return next != npos ? Element(m_document, next) : Element();
+    }
+
+    inline LazyDocument::Element LazyDocument::Element::parent() const
+    {
+        size_type const parent = entry().parent;
+        return parent != npos ? Element(m_document, parent) : Element();
+    }
+
+    inline LazyDocument::value_type const* LazyDocument::Element::begin() const
+    {
+        return &m_document->m_buffer[0] + entry().begin;
+    }
+
+    inline LazyDocument::value_type const* LazyDocument::Element::end() const
+    {
+        return &m_document->m_buffer[0] + entry().end;
+    }
+
+    inline bool LazyDocument::Element::operator==(Element const& other) const
+    {
+        return m_document == other.m_document && (m_document == 0 || m_index == other.m_index);
+    }
+
+    inline bool LazyDocument::Element::operator!=(Element const& other) const
+    {
+        return !(*this == other);
+    }
+
+    inline LazyDocument::Element LazyDocument::root() const
+    {
+        return Element(this, 0);
+    }
+
+    inline LazyDocument::size_type LazyDocument::elementCount() const
+    {
+        return m_entries.size();
+    }
+
+    inline LazyDocument::size_type LazyDocument::encodedLength() const
+    {
+        return m_entries.front().end;
+    }
+}
+}
+
+#ifdef LIBEMBER_HEADER_ONLY
+#  include "impl/LazyDocument.ipp"
+#endif
+
+#endif  // __LIBEMBER_DOM_LAZYDOCUMENT_HPP
@@ -23,6 +23,7 @@
 #include "../ber/Type.hpp"
 #include "../ber/Tag.hpp"
 #include "../util/OctetStream.hpp"
+#include "NodeAllocator.hpp"
 
 namespace libember { namespace dom
 {
@@ -54,6 +55,38 @@ namespace libember { namespace dom
              */
             virtual ~Node();
 
+            /**
+             * Allocates the storage for a node from the default heap allocator.
+             * @param size The size of the node to allocate.
+             * @return A pointer to the allocated storage.
+             */
+            static void* operator new(std::size_t size);
+
+            /**
+             * Allocates the storage for a node from the allocator passed in
+             * @p allocator. The node remembers its allocator, so that deleting
+             * it returns the storage to @p allocator.
+             * @param size The size of the node to allocate.
+             * @param allocator The allocator to obtain the storage from.
+             * @return A pointer to the allocated storage.
+             */
+            static void* operator new(std::size_t size, NodeAllocator& allocator);
+
+            /**
+             * Returns the storage of a node to the allocator it has been created with.
+             * @param ptr A pointer to the storage of the node.
+             * @param size The size of the node.
+             */
+            static void operator delete(void* ptr, std::size_t size);
+
+            /**
+             * Called when the constructor of a node allocated with
+             * operator new(std::size_t, NodeAllocator&) throws an exception.
+             * @param ptr A pointer to the storage of the node.
+             * @param allocator The allocator the storage has been obtained from.
+             */
+            static void operator delete(void* ptr, NodeAllocator& allocator);
+
             /**
              * Return the application tag of this node.
              * @return The application tag of this node.
@@ -101,6 +134,19 @@ namespace libember { namespace dom
              */
             void encode(util::OctetStream& output) const;
 
+            /**
+             * Encode the BER representation of this node to the stream buffer
+             * provided in @p output, using the indefinite length form for all
+             * containers. Unlike encode(), this method does not have to calculate
+             * the encoded lengths of the containers in advance, so the tree is
+             * traversed only once and the cached lengths of the containers are
+             * neither used nor updated.
+             * @param output a reference to the stream buffer, to which the contents
+             *      of this node should be encoded.
+             * @see encode()
+             */
+            void encodeIndefinite(util::OctetStream& output) const;
+
             /**
              * Return the number of bytes the BER representation of this node
              * requires. In case this node is currently marked dirty this method
@@ -143,6 +189,17 @@ namespace libember { namespace dom
              */
             virtual void encodeImpl(util::OctetStream& output) const = 0;
 
+            /**
+             * Encode the BER representation of this node to the stream buffer
+             * provided in @p output, using the indefinite length form for all
+             * containers. The default implementation calls encode(), which is
+             * what primitive nodes require. Containers override this method.
+             * @param output a reference to the stream buffer, to which the contents
+             *      of this node should be encoded.
+             * @see encodeIndefinite()
+             */
+            virtual void encodeIndefiniteImpl(util::OctetStream& output) const;
+
             /**
              * Return the number of bytes the BER representation of this node
              * requires. 
@@ -156,6 +213,21 @@ namespace libember { namespace dom
              */
             virtual std::size_t encodedLengthImpl() const = 0;
 
+            /**
+             * Called on the parent of @p child when @p child is about to be marked
+             * dirty, while it still reports the encoded length it had when the
+             * length of this node was calculated. A container may subtract that
+             * length and later add the new length of @p child, instead of summing
+             * up the lengths of all of its children again. Each child is reported
+             * once, until the container acknowledges the change by calling
+             * Container::acknowledgeChange(). The default implementation returns
+             * false.
+             * @param child The child node that is about to change.
+             * @return True if the container keeps track of the change and will
+             *      acknowledge it, false if the change does not need to be tracked.
+             */
+            virtual bool childChanged(Node const& child) const;
+
         protected:
             /**
              * Constructor that initializes the node with the application tag
@@ -209,10 +281,24 @@ namespace libember { namespace dom
              */
             Node& operator=(Node const&);
 
+            /**
+             * Header stored in front of every node allocated with one of the
+             * operator new overloads, referring to the allocator that owns the
+             * node's storage.
+             */
+            union AllocationHeader
+            {
+                NodeAllocator* allocator;
+                double alignDouble;
+                long alignLong;
+                void* alignPointer;
+            };
+
         private:
             ber::Tag m_applicationTag;
             Node* m_parent;
             mutable bool m_dirty;
+            mutable bool m_changeReported;
     };
 }
 }
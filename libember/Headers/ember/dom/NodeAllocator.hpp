@@ -0,0 +1,145 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef __LIBEMBER_DOM_NODEALLOCATOR_HPP
+#define __LIBEMBER_DOM_NODEALLOCATOR_HPP
+
+#include <cstddef>
+#include "../util/Api.hpp"
+
+namespace libember { namespace dom
+{
+    /**
+     * Interface of the allocators that provide the storage for dom nodes.
+     * A node allocated with the placement form <code>new (allocator) NodeType(...)</code>
+     * remembers the allocator it has been created with, so that a subsequent
+     * <code>delete</code> returns its storage to the same allocator.
+     * @see Node::operator new(std::size_t, NodeAllocator&)
+     */
+    class LIBEMBER_API NodeAllocator
+    {
+        public:
+            /**
+             * Returns the default allocator, which forwards all requests to the
+             * global operator new and operator delete. The allocator has no state
+             * and is constructed during static initialization, so it may be used by
+             * several threads at the same time.
+             * @return The default allocator.
+             */
+            static NodeAllocator& heap();
+
+        public:
+            /** Destructor */
+            virtual ~NodeAllocator();
+
+            /**
+             * Allocates @p size bytes of storage, suitably aligned for any node type.
+             * @param size The number of bytes to allocate.
+             * @return A pointer to the allocated storage.
+             * @throw std::bad_alloc if the storage could not be allocated.
+             */
+            virtual void* allocate(std::size_t size) = 0;
+
+            /**
+             * Returns the storage referred to by @p ptr, which has previously been
+             * obtained from allocate.
+             * @param ptr A pointer to the storage to release.
+             * @param size The number of bytes that have been requested. If a node
+             *      constructor throws, the size of the node is not known and only the
+             *      size of the allocation header is passed.
+             */
+            virtual void deallocate(void* ptr, std::size_t size) = 0;
+    };
+
+
+    /**
+     * Monotonic allocator that carves node storage out of large blocks. Deallocating
+     * a single node is a no-op, all storage is returned at once when release() is
+     * called or when the allocator is destroyed. This turns the hundreds of thousands
+     * of small allocations and frees required to decode and destroy a large tree into
+     * a handful of block allocations.
+     * @note The allocator must outlive all nodes that have been created with it.
+     *      Nodes still have to be deleted before the allocator is released, because
+     *      their destructors free the resources they own, such as string values.
+     */
+    class LIBEMBER_API ArenaNodeAllocator : public NodeAllocator
+    {
+        public:
+            /**
+             * Initializes a new arena.
+             * @param blockSize The size of the blocks to allocate. Requests exceeding
+             *      this size are served from a block of their own.
+             */
+            explicit ArenaNodeAllocator(std::size_t blockSize = 64 * 1024);
+
+            /** Destructor. Releases all blocks. */
+            virtual ~ArenaNodeAllocator();
+
+            /** @see NodeAllocator::allocate() */
+            virtual void* allocate(std::size_t size);
+
+            /** @see NodeAllocator::deallocate() */
+            virtual void deallocate(void* ptr, std::size_t size);
+
+            /**
+             * Returns all blocks that have been allocated by this arena. All nodes
+             * created with this allocator must have been destroyed before.
+             */
+            void release();
+
+            /**
+             * Returns the number of bytes handed out since the last call to release().
+             * @return The number of bytes handed out since the last call to release().
+             */
+            std::size_t allocatedBytes() const;
+
+        private:
+            /**
+             * Header of an allocated block, the usable storage directly follows it.
+             */
+            union Block
+            {
+                Block* next;
+                double alignDouble;
+                long alignLong;
+                void* alignPointer;
+            };
+
+            /** Prohibit copying */
+            ArenaNodeAllocator(ArenaNodeAllocator const&);
+
+            /** Prohibit assignments */
+            ArenaNodeAllocator& operator=(ArenaNodeAllocator const&);
+
+        private:
+            Block* m_blocks;
+            unsigned char* m_position;
+            std::size_t m_available;
+            std::size_t m_blockSize;
+            std::size_t m_allocatedBytes;
+    };
+}
+}
+
+#ifdef LIBEMBER_HEADER_ONLY
+#  include "impl/NodeAllocator.ipp"
+#endif
+
+#endif  // __LIBEMBER_DOM_NODEALLOCATOR_HPP
+
@@ -24,6 +24,7 @@
 #include "../util/OctetStream.hpp"
 #include "../ber/Tag.hpp"
 #include "../ber/Type.hpp"
+#include "NodeAllocator.hpp"
 
 namespace libember { namespace dom
 {
@@ -47,6 +48,18 @@ namespace libember { namespace dom
              */
             virtual Node* createApplicationDefinedNode(ber::Type const& type, ber::Tag const& tag) const = 0;
 
+            /**
+             * This method is called by the reader when in detected an application defined node type
+             * and the reader has been configured to use a specific node allocator.
+             * The default implementation ignores @p allocator and forwards the call to
+             * createApplicationDefinedNode(ber::Type const&, ber::Tag const&), implementations
+             * should override it and create the node with <code>new (allocator) NodeType(tag)</code>.
+             * @param type The decoded object type.
+             * @param tag The decoded object application tag.
+             * @param allocator The allocator to create the node with.
+             */
+            virtual Node* createApplicationDefinedNode(ber::Type const& type, ber::Tag const& tag, NodeAllocator& allocator) const;
+
         protected:
             /**
              * Creates a default set with the specified application tag.
@@ -61,6 +74,22 @@ namespace libember { namespace dom
              * @return Returns a Sequence.
              */
             Node* createSequence(ber::Tag const& tag) const;
+
+            /**
+             * Creates a default set with the specified application tag.
+             * @param tag Application tag
+             * @param allocator The allocator to create the set with.
+             * @return Returns a Set.
+             */
+            Node* createSet(ber::Tag const& tag, NodeAllocator& allocator) const;
+
+            /**
+             * Creates a default sequence with the specified application tag.
+             * @param tag Application tag
+             * @param allocator The allocator to create the sequence with.
+             * @return Returns a Sequence.
+             */
+            Node* createSequence(ber::Tag const& tag, NodeAllocator& allocator) const;
     };
 }
 }
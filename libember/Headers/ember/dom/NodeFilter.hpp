@@ -0,0 +1,61 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef __LIBEMBER_DOM_NODEFILTER_HPP
+#define __LIBEMBER_DOM_NODEFILTER_HPP
+
+#include "../util/Api.hpp"
+#include "../ber/Tag.hpp"
+#include "../ber/Type.hpp"
+
+namespace libember { namespace dom
+{
+    class Node;
+
+    /**
+     * NodeFilter interface. An AsyncDomReader that has been configured with a filter
+     * asks it for every container it encounters whether the container shall be decoded.
+     * Rejected containers are skipped without creating any nodes.
+     */
+    class LIBEMBER_API NodeFilter
+    {
+        public:
+            /** Destructor */
+            virtual ~NodeFilter();
+
+            /**
+             * This method is called by the reader before it creates a container node.
+             * @param parent The node the container would be inserted into. The parent
+             *      has been decoded up to the container, so leaves encoded in front of
+             *      it, like the number of an element, are already available.
+             * @param type The decoded type of the container.
+             * @param tag The decoded application tag of the container.
+             * @return True if the container shall be decoded, false if it shall be skipped.
+             */
+            virtual bool accept(Node const* parent, ber::Type const& type, ber::Tag const& tag) const = 0;
+    };
+}
+}
+
+#ifdef LIBEMBER_HEADER_ONLY
+#  include "impl/NodeFilter.ipp"
+#endif
+
+#endif  // __LIBEMBER_DOM_NODEFILTER_HPP
+
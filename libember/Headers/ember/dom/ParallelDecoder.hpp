@@ -0,0 +1,117 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef __LIBEMBER_DOM_PARALLELDECODER_HPP
+#define __LIBEMBER_DOM_PARALLELDECODER_HPP
+
+#include <cstddef>
+#include "../util/Api.hpp"
+#include "Executor.hpp"
+#include "WorkStealingExecutor.hpp"
+
+namespace libember { namespace dom
+{
+    /** Forward declarations */
+    class Node;
+    class NodeFactory;
+
+    /**
+     * Decodes the children of a root container concurrently. In a first pass, the
+     * boundaries of the encoded children are determined by scanning their headers,
+     * without decoding them. The children are then split into a number of
+     * consecutive ranges of roughly equal size, each of which is decoded by a task
+     * with an AsyncDomReader of its own. Finally, the decoded children are inserted
+     * into the root container in their original order, so the resulting tree is
+     * identical to the one produced by an AsyncDomReader.
+     * This reduces the latency of decoding large trees, for example a
+     * GlowRootElementCollection with thousands of qualified parameters that is
+     * received after connecting to a provider.
+     * The tasks are run by an Executor provided by the application.
+     * @note The node factory is used by all tasks at the same time and therefore
+     *      must not have any mutable state.
+     */
+    class LIBEMBER_API ParallelDecoder
+    {
+        public:
+            typedef unsigned char value_type;
+
+            /**
+             * Initializes a new ParallelDecoder.
+             * @param factory The factory used to create the decoded nodes. It must
+             *      outlive this instance.
+             * @param executor The executor to run the decoding tasks with. It must
+             *      outlive this instance.
+             * @param taskCount The maximum number of tasks the children of the root
+             *      are split into, usually the number of threads of the executor.
+             * @param minimumBytes The minimum number of encoded bytes a task decodes.
+             *      Trees smaller than twice this number are decoded sequentially,
+             *      because splitting them costs more than it saves.
+             */
+            ParallelDecoder(NodeFactory const& factory, Executor& executor, std::size_t taskCount, std::size_t minimumBytes = 64 * 1024);
+
+            /**
+             * Initializes a new ParallelDecoder that splits the children of the root
+             * into ranges of at least @p minimumBytes encoded bytes, up to the task
+             * limit of @p executor, which balances the tasks over its workers.
+             * @param factory The factory used to create the decoded nodes. It must
+             *      outlive this instance.
+             * @param executor The executor to run the decoding tasks with. It must
+             *      outlive this instance.
+             * @param minimumBytes The minimum number of encoded bytes a task decodes.
+             */
+            ParallelDecoder(NodeFactory const& factory, WorkStealingExecutor& executor, std::size_t minimumBytes = 64 * 1024);
+
+            /**
+             * Decodes the tree encoded in the range [first, last). Bytes following
+             * the encoded root are ignored.
+             * @param first Pointer to the first byte of the encoded tree.
+             * @param last Pointer to the end of the encoded tree.
+             * @return The decoded root node. Ownership is transferred to the caller.
+             * @throw std::runtime_error if the range does not contain a complete
+             *      tree or decoding a child failed.
+             */
+            Node* decode(value_type const* first, value_type const* last) const;
+
+        private:
+            /**
+             * Decodes the tree encoded in the range [first, last) with a single
+             * AsyncDomReader.
+             * @param first Pointer to the first byte of the encoded tree.
+             * @param last Pointer to the end of the encoded tree.
+             * @return The decoded root node.
+             */
+            Node* decodeSequential(value_type const* first, value_type const* last) const;
+
+            /** Prohibit assignment */
+            ParallelDecoder& operator=(ParallelDecoder const&);
+
+        private:
+            NodeFactory const& m_factory;
+            Executor& m_executor;
+            std::size_t m_taskCount;
+            std::size_t m_minimumBytes;
+    };
+}
+}
+
+#ifdef LIBEMBER_HEADER_ONLY
+#  include "impl/ParallelDecoder.ipp"
+#endif
+
+#endif  // __LIBEMBER_DOM_PARALLELDECODER_HPP
@@ -0,0 +1,102 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef __LIBEMBER_DOM_PARALLELENCODER_HPP
+#define __LIBEMBER_DOM_PARALLELENCODER_HPP
+
+#include <cstddef>
+#include "../util/Api.hpp"
+#include "../util/OctetStream.hpp"
+#include "Executor.hpp"
+#include "WorkStealingExecutor.hpp"
+
+namespace libember { namespace dom
+{
+    /** Forward declarations */
+    namespace detail
+    {
+        class ListContainer;
+    }
+
+    /**
+     * Encodes the children of a container concurrently. The children are split
+     * into a number of consecutive ranges, each of which is encoded into a buffer
+     * of its own by a task. The buffers are then appended to the output, preceded
+     * by the header of the container. The result is identical to the one produced
+     * by Node::encode(). This reduces the latency of encoding large trees, for
+     * example a GlowRootElementCollection with thousands of qualified parameters
+     * that is sent to a consumer which has just connected.
+     * The tasks are run by an Executor provided by the application.
+     * @note The encoded tree must not be modified while it is being encoded.
+     *      Each task only accesses the subtrees of its own range of children.
+     */
+    class LIBEMBER_API ParallelEncoder
+    {
+        public:
+            /**
+             * Initializes a new ParallelEncoder.
+             * @param executor The executor to run the encoding tasks with. It must
+             *      outlive this instance.
+             * @param taskCount The maximum number of tasks the children of a
+             *      container are split into, usually the number of threads of the
+             *      executor.
+             * @param minimumChildren The minimum number of children a task encodes.
+             *      Containers with fewer children than twice this number are
+             *      encoded sequentially, because splitting them costs more than
+             *      it saves.
+             */
+            ParallelEncoder(Executor& executor, std::size_t taskCount, std::size_t minimumChildren = 64);
+
+            /**
+             * Initializes a new ParallelEncoder that splits the children of a container
+             * into ranges of at least @p minimumChildren children, up to the task limit
+             * of @p executor. Since the executor balances the tasks over its workers,
+             * containers whose children differ in size are encoded more evenly than
+             * with one task per thread.
+             * @param executor The executor to run the encoding tasks with. It must
+             *      outlive this instance.
+             * @param minimumChildren The minimum number of children a task encodes.
+             */
+            explicit ParallelEncoder(WorkStealingExecutor& executor, std::size_t minimumChildren = 64);
+
+            /**
+             * Encodes @p container and all of its children to @p output.
+             * @param container The container to encode.
+             * @param output The stream to append the encoded container to.
+             * @throw std::runtime_error if encoding a child failed.
+             */
+            void encode(detail::ListContainer const& container, util::OctetStream& output) const;
+
+        private:
+            /** Prohibit assignment */
+            ParallelEncoder& operator=(ParallelEncoder const&);
+
+        private:
+            Executor& m_executor;
+            std::size_t m_taskCount;
+            std::size_t m_minimumChildren;
+    };
+}
+}
+
+#ifdef LIBEMBER_HEADER_ONLY
+#  include "impl/ParallelEncoder.ipp"
+#endif
+
+#endif  // __LIBEMBER_DOM_PARALLELENCODER_HPP
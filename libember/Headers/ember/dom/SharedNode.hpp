@@ -0,0 +1,176 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef __LIBEMBER_DOM_SHAREDNODE_HPP
+#define __LIBEMBER_DOM_SHAREDNODE_HPP
+
+#include "Node.hpp"
+
+namespace libember { namespace dom
+{
+    /**
+     * A node that refers to an immutable subtree which is shared by all copies of
+     * the node. Cloning a SharedNode only increments a reference count, so a parent
+     * whose children are shared nodes is cloned without copying their subtrees.
+     * When being encoded, a SharedNode writes the encoding of the shared subtree,
+     * which makes it transparent to the receiver.
+     * This allows applications like proxies and mirrors to keep decoded elements
+     * and to forward them several times without deep-copying them.
+     * @note The shared subtree must not be modified after it has been passed to
+     *      a SharedNode. To modify it, create a private deep copy with copy().
+     *      The reference count is not synchronized, so all copies of a SharedNode
+     *      must be used within the same thread.
+     */
+    class LIBEMBER_API SharedNode : public Node
+    {
+        public:
+            /**
+             * Initializes a new SharedNode which takes ownership of the passed subtree.
+             * The node is deleted when the last SharedNode referring to it is deleted.
+             * @param node The root of the subtree to share. Must not be 0.
+             * @throw std::runtime_error if @p node is 0 or already has a parent.
+             */
+            explicit SharedNode(Node* node);
+
+            /**
+             * Initializes a new SharedNode which refers to the same subtree as
+             * @p other.
+             * @param other The instance to share the subtree with.
+             */
+            SharedNode(SharedNode const& other);
+
+            /**
+             * Destructor, deletes the shared subtree if this is the last instance
+             * referring to it.
+             */
+            virtual ~SharedNode();
+
+            /**
+             * Covariant override of Node::clone(). The returned node shares the
+             * subtree of this instance, so this operation does not depend on the
+             * size of the subtree.
+             * @see Node::clone()
+             */
+            virtual SharedNode* clone() const;
+
+            /**
+             * Returns the shared subtree.
+             * @return The root of the shared subtree.
+             */
+            Node const* get() const;
+
+            /**
+             * Creates a deep copy of the shared subtree, which may be modified and
+             * needs to be deleted by the caller.
+             * @return The root of the copied subtree.
+             */
+            Node* copy() const;
+
+            /**
+             * Returns the number of SharedNode instances that refer to the subtree
+             * of this instance.
+             * @return The number of instances sharing the subtree.
+             */
+            std::size_t useCount() const;
+
+        protected:
+            /** @see Node::typeTagImpl() */
+            virtual ber::Tag typeTagImpl() const;
+
+            /** @see Node::updateImpl() */
+            virtual void updateImpl() const;
+
+            /** @see Node::encodeImpl() */
+            virtual void encodeImpl(util::OctetStream& output) const;
+
+            /** @see Node::encodeIndefiniteImpl() */
+            virtual void encodeIndefiniteImpl(util::OctetStream& output) const;
+
+            /** @see Node::encodedLengthImpl() */
+            virtual std::size_t encodedLengthImpl() const;
+
+        private:
+            /**
+             * The reference-counted owner of the shared subtree.
+             */
+            class Storage
+            {
+                public:
+                    /**
+                     * Initializes a new storage with a reference count of one.
+                     * @param node The root of the subtree to own.
+                     */
+                    explicit Storage(Node* node);
+
+                    /** Destructor, deletes the owned subtree. */
+                    ~Storage();
+
+                    /**
+                     * Increments the reference count of this storage by one.
+                     * @return The this pointer.
+                     */
+                    Storage* addRef();
+
+                    /**
+                     * Decrements the reference count of this storage by one. If the
+                     * reference count reaches zero, the storage deletes itself.
+                     */
+                    void releaseRef();
+
+                    /**
+                     * Returns the owned subtree.
+                     * @return The root of the owned subtree.
+                     */
+                    Node const* node() const;
+
+                    /**
+                     * Returns the number of references to this storage.
+                     * @return The number of references to this storage.
+                     */
+                    std::size_t refCount() const;
+
+                private:
+                    /** Prohibit copies */
+                    Storage(Storage const&);
+                    Storage& operator=(Storage const&);
+
+                private:
+                    Node* const m_node;
+                    std::size_t m_refCount;
+            };
+
+            /**
+             * Verifies that @p node may be shared.
+             * @param node The node to verify.
+             * @return The passed node.
+             * @throw std::runtime_error if @p node is 0 or already has a parent.
+             */
+            static Node* validate(Node* node);
+
+        private:
+            Storage* m_storage;
+    };
+}
+}
+
+#ifdef LIBEMBER_HEADER_ONLY
+#  include "impl/SharedNode.ipp"
+#endif
+
+#endif  // __LIBEMBER_DOM_SHAREDNODE_HPP
@@ -114,6 +114,11 @@ namespace libember { namespace dom
         : Node(tag), m_value(), m_cachedLength(0)
     {}
 
+    template<typename ValueType>
+    inline StaticLeaf<ValueType>::StaticLeaf(ber::Tag tag, value_type value)
+        : Node(tag), m_value(value), m_cachedLength(0)
+    {}
+
     template<typename ValueType>
     inline StaticLeaf<ValueType>::StaticLeaf(StaticLeaf const& other)
         : Node(static_cast<Node const&>(other)), m_value(other.m_value),
@@ -0,0 +1,134 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef __LIBEMBER_DOM_STRINGPOOL_HPP
+#define __LIBEMBER_DOM_STRINGPOOL_HPP
+
+#include <map>
+#include <string>
+#include "../ber/Value.hpp"
+#include "../util/Api.hpp"
+
+namespace libember { namespace dom
+{
+    /**
+     * Stores each distinct short string only once. Decoded consumer trees contain the same
+     * identifiers, descriptions and schema identifiers over and over, so an AsyncBerReader
+     * that has been configured with a pool decodes UTF8String leaves into values that share
+     * the single payload held by the pool instead of allocating a string per leaf. Leaves
+     * decoded with the same pool and holding the same string therefore refer to the same
+     * std::string instance.
+     * Strings are retained until the pool is cleared or destroyed, even if all trees
+     * referring to them have been deleted. Since the payloads are reference counted without
+     * synchronization, the pool and all trees decoded with it must only be used by one
+     * thread at a time.
+     */
+    class LIBEMBER_API StringPool
+    {
+        public:
+            typedef std::size_t size_type;
+
+        public:
+            /**
+             * Initializes an empty pool.
+             * @param maximumLength Strings longer than this are not interned, since long
+             *      strings like formulas or large descriptions are rarely duplicated.
+             */
+            explicit StringPool(size_type maximumLength = 64);
+
+            /**
+             * Returns a value holding the passed string, which shares its payload with all
+             * other values returned for the same string.
+             * @param value The string to intern.
+             * @return A value holding the string. Strings exceeding the maximum length are
+             *      returned in a value of their own.
+             */
+            ber::Value intern(std::string const& value);
+
+            /**
+             * Returns a value holding the string formed by @p length characters starting at
+             * @p first. Unless the string has to be added to the pool, no string is allocated.
+             * @param first Points to the first character of the string.
+             * @param length The number of characters of the string.
+             * @return A value holding the string.
+             */
+            template<typename InputIterator>
+            ber::Value intern(InputIterator first, size_type length);
+
+            /**
+             * Returns the maximum length of the strings that are interned.
+             * @return The maximum length of the strings that are interned.
+             */
+            size_type maximumLength() const;
+
+            /**
+             * Returns the number of distinct strings stored in the pool.
+             * @return The number of distinct strings.
+             */
+            size_type size() const;
+
+            /**
+             * Removes all strings. Values returned before remain valid.
+             */
+            void clear();
+
+        private:
+            typedef std::multimap<size_type, ber::Value> ValueMap;
+
+            /**
+             * Computes the FNV-1a hash of a string.
+             */
+            static size_type hash(std::string const& value);
+
+        private:
+#ifdef _MSC_VER
+#  pragma warning(push)
+#  pragma warning(disable : 4251)
+#endif
+            ValueMap m_values;
+            std::string m_scratch;
+#ifdef _MSC_VER
+#  pragma warning(pop)
+#endif
+            size_type m_maximumLength;
+    };
+
+    /**************************************************************************
+     * Mandatory inline implementation                                        *
+     **************************************************************************/
+
+    template<typename InputIterator>
+    inline ber::Value StringPool::intern(InputIterator first, size_type length)
+    {
+        // the scratch string keeps its capacity, so strings already in the pool are not allocated
+        m_scratch.resize(length);
+        for (std::string::iterator it = m_scratch.begin(); it != m_scratch.end(); ++it, ++first)
+        {
+            *it = static_cast<char>(*first);
+        }
+        return intern(m_scratch);
+    }
+}
+}
+
+#ifdef LIBEMBER_HEADER_ONLY
+#  include "impl/StringPool.ipp"
+#endif
+
+#endif  // __LIBEMBER_DOM_STRINGPOOL_HPP
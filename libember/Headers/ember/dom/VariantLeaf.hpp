@@ -20,7 +20,10 @@
 #ifndef __LIBEMBER_DOM_VARIANTLEAF_HPP
 #define __LIBEMBER_DOM_VARIANTLEAF_HPP
 
+#include "../ber/OctetsView.hpp"
 #include "../ber/Value.hpp"
+#include "../util/Instrumentation.hpp"
+#include "../util/OctetSlice.hpp"
 #include "Node.hpp"
 
 //SimianIgnore
@@ -31,7 +34,7 @@ namespace libember { namespace dom
      * Base class for all leaf nodes. Serves as an extension point
      * in case functionality common to all leaf nodes has to be added.
      */
-    class LIBEMBER_API VariantLeaf : public Node 
+    class LIBEMBER_API VariantLeaf : public Node, private util::InstanceCounter<util::Instrumentation::VariantLeaf> 
     {
         friend class VariantValue;
         public:
@@ -57,6 +60,22 @@ namespace libember { namespace dom
              */
             explicit VariantLeaf(ber::Tag tag, ber::Value value);
 
+            /**
+             * Constructor that initializes the node with the application tag
+             * specified in @p tag and the still encoded payload of a string
+             * value specified in @p encoded. The payload is only decoded when
+             * the value is accessed for the first time, until then the leaf
+             * re-encodes the referenced bytes unchanged.
+             * @param tag the application tag of this node.
+             * @param typeTag the universal type tag of the encoded value. Only
+             *      ber::Type::UTF8String and ber::Type::OctetString are supported.
+             * @param encoded the encoded payload of the value.
+             * @note Please note that a newly constructed node is always marked
+             *      dirty, because the state variables affecting its encoded
+             *      representation have not yet been calculated.
+             */
+            VariantLeaf(ber::Tag tag, ber::Tag typeTag, util::OctetSlice encoded);
+
             /**
              * Copy constructor that copies the contents of @p other to the
              * newly created instance.
@@ -79,6 +98,37 @@ namespace libember { namespace dom
              */
             ber::Value value() const;
 
+            /**
+             * Returns a view onto the bytes of an octet string value without
+             * decoding or copying them. The view remains valid until this leaf
+             * is modified or destroyed, call ber::OctetsView::retain() to keep
+             * the bytes beyond that.
+             * @return A view onto the octet string represented by this leaf, or
+             *      an empty view if this leaf does not contain an octet string.
+             */
+            ber::OctetsView octets() const;
+
+            /**
+             * Returns the encoded string or octet string value this leaf still
+             * refers to. Unlike value(), this method does not decode the value,
+             * so it may be used to inspect a tree without changing its memory
+             * footprint.
+             * @return The encoded value, or an empty slice if the value has been
+             *      decoded or assigned, or is not a string.
+             */
+            util::OctetSlice const& encodedValue() const;
+
+            /**
+             * Returns a pointer to the primitive value represented by this leaf
+             * node without copying it. A lazily decoded payload is decoded first.
+             * The pointer remains valid until this leaf is modified or destroyed.
+             * @return A pointer to the value, or null if this leaf does not
+             *      contain a value of type @p ValueType.
+             * @see ber::Value::peek()
+             */
+            template<typename ValueType>
+            ValueType const* peekValue() const;
+
             /**
              * Setter for the primitive value represented by this leaf node.
              * @param value the type-erased primitive value to which the value
@@ -86,6 +136,16 @@ namespace libember { namespace dom
              */
             void setValue(ber::Value value);
 
+            /**
+             * Sets the primitive value represented by this leaf node, reusing the
+             * storage of the current value if it has the same type.
+             * @param value the value to which the value represented by this leaf
+             *      should be set.
+             * @see ber::Value::assign()
+             */
+            template<typename ValueType>
+            void assignValue(ValueType const& value);
+
         protected:
             /** @see Node::typeTagImpl() */
             virtual ber::Tag typeTagImpl() const;
@@ -100,10 +160,37 @@ namespace libember { namespace dom
             virtual std::size_t encodedLengthImpl() const;
 
         private:
-            ber::Value m_value;
+            /**
+             * Decodes the payload referenced by m_encoded into m_value and
+             * releases the slice. Does nothing if the value has already been decoded.
+             */
+            void decodeEncodedValue() const;
+
+        private:
+            mutable ber::Value m_value;
+            mutable util::OctetSlice m_encoded;
+            ber::Tag m_encodedTypeTag;
             mutable std::size_t m_cachedLength;
     };
 
+    /**************************************************************************/
+    /* Mandatory inline implementation                                        */
+    /**************************************************************************/
+
+    template<typename ValueType>
+    inline ValueType const* VariantLeaf::peekValue() const
+    {
+        decodeEncodedValue();
+        return m_value.peek<ValueType>();
+    }
+
+    template<typename ValueType>
+    inline void VariantLeaf::assignValue(ValueType const& value)
+    {
+        util::OctetSlice().swap(m_encoded);
+        m_value.assign(value);
+        markDirty();
+    }
 }
 }
 
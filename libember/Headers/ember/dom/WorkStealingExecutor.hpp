@@ -0,0 +1,111 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef __LIBEMBER_DOM_WORKSTEALINGEXECUTOR_HPP
+#define __LIBEMBER_DOM_WORKSTEALINGEXECUTOR_HPP
+
+#include <cstddef>
+#include "../util/Api.hpp"
+#include "Executor.hpp"
+
+namespace libember { namespace dom
+{
+    /**
+     * An executor that distributes a large number of small tasks over a fixed number
+     * of workers. The tasks passed to execute() are split into one consecutive range
+     * per worker. Each worker runs the tasks of its own range from the front and,
+     * once its range is empty, steals the back half of the range of another worker,
+     * so that workers which happen to get cheap tasks help the others.
+     * The workers themselves are run by another Executor, usually the one forwarding
+     * to the thread pool of the application, which therefore only has to run a few
+     * long running tasks per call, no matter how many tasks are executed.
+     * Several components may share a single instance, each call to execute() is
+     * independent of the others.
+     * @note On compilers without support for atomic operations, all tasks are run
+     *      on the calling thread.
+     */
+    class LIBEMBER_API WorkStealingExecutor : public Executor
+    {
+        public:
+            /**
+             * The number of tasks per worker the ParallelEncoder and the ParallelDecoder
+             * split their work into at most, when they are given a WorkStealingExecutor.
+             */
+            static std::size_t const TasksPerWorker = 4;
+
+            /**
+             * Initializes a new WorkStealingExecutor.
+             * @param threads The executor that runs the workers. It must be able to
+             *      run @p workerCount tasks concurrently to make use of all workers,
+             *      and it must outlive this instance.
+             * @param workerCount The number of workers, usually the number of threads
+             *      of @p threads. A value of 0 or 1 runs all tasks on the calling thread.
+             */
+            WorkStealingExecutor(Executor& threads, std::size_t workerCount);
+
+            /**
+             * Runs all tasks and returns when all of them have completed.
+             * @param tasks Pointer to the first of @p count tasks.
+             * @param count The number of tasks.
+             */
+            virtual void execute(Task* const* tasks, std::size_t count);
+
+            /**
+             * Returns the number of workers the tasks are distributed over.
+             * @return The number of workers.
+             */
+            std::size_t workerCount() const;
+
+            /**
+             * Returns the maximum number of tasks work should be split into, which
+             * is workerCount() multiplied by TasksPerWorker.
+             * @return The maximum number of tasks work should be split into.
+             */
+            std::size_t taskLimit() const;
+
+        private:
+            /** Prohibit assignment */
+            WorkStealingExecutor& operator=(WorkStealingExecutor const&);
+
+        private:
+            Executor& m_threads;
+            std::size_t m_workerCount;
+    };
+
+    /**************************************************************************/
+    /* Mandatory inline implementation                                        */
+    /**************************************************************************/
+
+    inline std::size_t WorkStealingExecutor::workerCount() const
+    {
+        return m_workerCount;
+    }
+
+    inline std::size_t WorkStealingExecutor::taskLimit() const
+    {
+        return m_workerCount * TasksPerWorker;
+    }
+}
+}
+
+#ifdef LIBEMBER_HEADER_ONLY
+#  include "impl/WorkStealingExecutor.ipp"
+#endif
+
+#endif  // __LIBEMBER_DOM_WORKSTEALINGEXECUTOR_HPP
@@ -0,0 +1,201 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef __LIBEMBER_DOM_DETAIL_ENCODEDHEADER_HPP
+#define __LIBEMBER_DOM_DETAIL_ENCODEDHEADER_HPP
+
+#include <cstddef>
+#include "../../ber/Tag.hpp"
+
+namespace libember { namespace dom { namespace detail
+{
+    typedef unsigned char decode_value_type;
+
+    /**
+     * The header of an encoded TLV, as determined by scanHeader().
+     */
+    struct EncodedHeader
+    {
+        /** Pointer to the end of the encoded tag. */
+        decode_value_type const* tagEnd;
+
+        /** Pointer to the first byte of the contents. */
+        decode_value_type const* contents;
+
+        /** The length of the contents, only valid if indefinite is false. */
+        std::size_t length;
+
+        /** True if the constructed bit of the tag is set. */
+        bool constructed;
+
+        /** True if the contents are terminated by an end-of-contents marker. */
+        bool indefinite;
+    };
+
+    /**
+     * Scans the tag and the length of the TLV starting at @p first.
+     * @param first Pointer to the first byte of the TLV.
+     * @param last Pointer to the end of the available data.
+     * @param header Receives the scanned header.
+     * @return false if the header is incomplete or its length cannot be
+     *      represented.
+     */
+    inline bool scanHeader(decode_value_type const* first, decode_value_type const* last, EncodedHeader& header)
+    {
+        decode_value_type const* current = first;
+        if (current == last)
+        {
+            return false;
+        }
+
+        decode_value_type const leading = *current++;
+        if ((leading & 0x1F) == 0x1F)
+        {
+            while (current != last && (*current & 0x80) != 0)
+            {
+                ++current;
+            }
+
+            if (current == last)
+            {
+                return false;
+            }
+
+            ++current;
+        }
+
+        header.tagEnd = current;
+        header.constructed = (leading & 0x20) != 0;
+        header.indefinite = false;
+        header.length = 0;
+
+        if (current == last)
+        {
+            return false;
+        }
+
+        decode_value_type const length = *current++;
+        if (length == 0x80)
+        {
+            header.indefinite = true;
+        }
+        else if ((length & 0x80) == 0)
+        {
+            header.length = length;
+        }
+        else
+        {
+            std::size_t const bytes = length & 0x7F;
+            if (bytes > sizeof(std::size_t) || static_cast<std::size_t>(last - current) < bytes)
+            {
+                return false;
+            }
+
+            for (std::size_t i = 0; i < bytes; ++i)
+            {
+                header.length = (header.length << 8) | *current++;
+            }
+        }
+
+        header.contents = current;
+        return header.indefinite || header.length <= static_cast<std::size_t>(last - current);
+    }
+
+    /**
+     * Returns true if the range [first, last) starts with an end-of-contents marker.
+     */
+    inline bool isEndOfContents(decode_value_type const* first, decode_value_type const* last)
+    {
+        return last - first >= 2 && first[0] == 0 && first[1] == 0;
+    }
+
+    /**
+     * Determines the end of the TLV starting at @p first. The contents of TLVs
+     * with a definite length are skipped, those with an indefinite length are
+     * scanned up to their end-of-contents marker.
+     * @param first Pointer to the first byte of the TLV.
+     * @param last Pointer to the end of the available data.
+     * @return A pointer to the end of the TLV, or 0 if the TLV is incomplete.
+     */
+    inline decode_value_type const* skipElement(decode_value_type const* first, decode_value_type const* last)
+    {
+        decode_value_type const* current = first;
+        std::size_t depth = 0;
+
+        do
+        {
+            if (depth > 0 && isEndOfContents(current, last))
+            {
+                current += 2;
+                --depth;
+                continue;
+            }
+
+            EncodedHeader header;
+            if (scanHeader(current, last, header) == false)
+            {
+                return 0;
+            }
+
+            if (header.indefinite)
+            {
+                if (header.constructed == false)
+                {
+                    return 0;
+                }
+
+                current = header.contents;
+                ++depth;
+            }
+            else
+            {
+                current = header.contents + header.length;
+            }
+        }
+        while (depth > 0);
+
+        return current;
+    }
+
+    /**
+     * Decodes the tag of a TLV whose header has been scanned by scanHeader().
+     * @param first Pointer to the first byte of the TLV.
+     * @param tagEnd Pointer to the end of the encoded tag, as reported by
+     *      scanHeader().
+     * @return The decoded tag, including the constructed bit.
+     */
+    inline ber::Tag decodeTag(decode_value_type const* first, decode_value_type const* tagEnd)
+    {
+        ber::Tag::Preamble const preamble = static_cast<ber::Tag::Preamble>(*first & 0xE0);
+        ber::Tag::Number number = *first & 0x1F;
+        if (number == 0x1F)
+        {
+            number = 0;
+            for (decode_value_type const* current = first + 1; current != tagEnd; ++current)
+            {
+                number = (number << 7) | (*current & 0x7F);
+            }
+        }
+        return ber::make_tag(preamble, number);
+    }
+}
+}
+}
+
+#endif  // __LIBEMBER_DOM_DETAIL_ENCODEDHEADER_HPP
@@ -20,14 +20,32 @@
 #ifndef __LIBEMBER_DOM_DETAIL_LISTCONTAINER_HPP
 #define __LIBEMBER_DOM_DETAIL_LISTCONTAINER_HPP
 
-#include <list>
 #include "../Container.hpp"
+#include "../../util/DerefIterator.hpp"
+#include "../../util/SmallVector.hpp"
 
 namespace libember { namespace dom { namespace detail
 {
     class LIBEMBER_API ListContainer
         : public Container
     {
+        /**
+         * The children are stored contiguously, the inline capacity covers the
+         * typical number of properties of a Glow contents set without requiring
+         * a heap allocation.
+         */
+        typedef util::SmallVector<Node*, 8> NodeList;
+
+        public:
+            /**
+             * Iterators over the child nodes of this concrete container type.
+             * Unlike Container::iterator, they do not allocate memory and do not
+             * dispatch virtually, so they should be preferred for searching and
+             * traversing the children.
+             */
+            typedef util::DerefIterator<NodeList::iterator>     child_iterator;
+            typedef util::DerefIterator<Node const* const*>     const_child_iterator;
+
         public:
             /**
              * Destructor. Frees all child nodes below this container.
@@ -52,6 +70,37 @@ namespace libember { namespace dom { namespace detail
             /** @see Container::end() */
             virtual const_iterator end() const;
 
+            /**
+             * Return a concrete iterator referring to the first child node.
+             * @return A concrete iterator referring to the first child node.
+             */
+            child_iterator childBegin();
+
+            /** @see childBegin() */
+            const_child_iterator childBegin() const;
+
+            /**
+             * Return a concrete iterator referring to the element one past the last
+             * child node.
+             * @return A concrete iterator referring to the element one past the last
+             *      child node.
+             */
+            child_iterator childEnd();
+
+            /** @see childEnd() */
+            const_child_iterator childEnd() const;
+
+            /**
+             * Convert a concrete iterator into the type erased iterator referring
+             * to the same child node.
+             * @param i The concrete iterator to convert.
+             * @return The type erased iterator referring to the same child node.
+             */
+            iterator toIterator(child_iterator const& i);
+
+            /** @see toIterator(child_iterator const&) */
+            const_iterator toIterator(const_child_iterator const& i) const;
+
         protected:
             /**
              * Constructor that initializes the node with the application tag
@@ -94,6 +143,9 @@ namespace libember { namespace dom { namespace detail
             /** @see Node::encodeImpl() */
             virtual void encodeImpl(util::OctetStream& output) const;
 
+            /** @see Node::encodeIndefiniteImpl() */
+            virtual void encodeIndefiniteImpl(util::OctetStream& output) const;
+
             /** @see Node::encodedLengthImpl() */
             virtual std::size_t encodedLengthImpl() const;
 
@@ -103,8 +155,24 @@ namespace libember { namespace dom { namespace detail
             /** @see Container::eraseImpl() */
             virtual void eraseImpl(iterator const& first, iterator const& last);
 
+            /** @see Container::reserveImpl() */
+            virtual void reserveImpl(size_type capacity);
+
+            /**
+             * Remembers @p child, so that the next update adjusts the cached
+             * payload length by the change of its length.
+             * @see Node::childChanged()
+             */
+            virtual bool childChanged(Node const& child) const;
+
         private:
-            typedef std::list<Node*> NodeList;
+            typedef util::SmallVector<Node const*, 2> ChangeList;
+
+            /**
+             * Discards the cached payload length and the changes reported since,
+             * so that the next update sums up the lengths of all children.
+             */
+            void invalidatePayloadLength() const;
 
         private:
 #ifdef _MSC_VER
@@ -112,12 +180,50 @@ namespace libember { namespace dom { namespace detail
 #  pragma warning(disable : 4251)
 #endif
             NodeList m_children;
+            mutable ChangeList m_changedChildren;
 #ifdef _MSC_VER
 #  pragma warning(pop)
 #endif
             mutable std::size_t m_cachedLength;
+            mutable std::size_t m_payloadLength;
+            mutable bool m_isPayloadLengthValid;
     };
 
+
+
+    /**************************************************************************/
+    /* Mandatory inline implementation                                        */
+    /**************************************************************************/
+
+    inline ListContainer::child_iterator ListContainer::childBegin()
+    {
+        return child_iterator(m_children.begin());
+    }
+
+    inline ListContainer::const_child_iterator ListContainer::childBegin() const
+    {
+        return const_child_iterator(m_children.begin());
+    }
+
+    inline ListContainer::child_iterator ListContainer::childEnd()
+    {
+        return child_iterator(m_children.end());
+    }
+
+    inline ListContainer::const_child_iterator ListContainer::childEnd() const
+    {
+        return const_child_iterator(m_children.end());
+    }
+
+    inline ListContainer::iterator ListContainer::toIterator(child_iterator const& i)
+    {
+        return iterator(i);
+    }
+
+    inline ListContainer::const_iterator ListContainer::toIterator(const_child_iterator const& i) const
+    {
+        return const_iterator(i);
+    }
 }
 }
 }
@@ -0,0 +1,128 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef __LIBEMBER_DOM_DETAIL_TASKLIST_HPP
+#define __LIBEMBER_DOM_DETAIL_TASKLIST_HPP
+
+#include <cstddef>
+#include <vector>
+#include "../Executor.hpp"
+
+namespace libember { namespace dom { namespace detail
+{
+    /**
+     * Owns the tasks that are passed to an Executor at once.
+     */
+    template<typename TaskType>
+    class TaskList
+    {
+        public:
+            /**
+             * Initializes an empty list.
+             * @param capacity The maximum number of tasks that will be added.
+             */
+            explicit TaskList(std::size_t capacity);
+
+            /** Destructor, deletes all tasks. */
+            ~TaskList();
+
+            /**
+             * Adds a task and takes ownership of it. Does not throw as long as
+             * fewer tasks than the capacity have been added.
+             * @param task The task to add.
+             */
+            void add(TaskType* task);
+
+            /**
+             * Returns the tasks in the form expected by Executor::execute().
+             * @return A pointer to the first task.
+             */
+            Task* const* tasks() const;
+
+            /**
+             * Returns the number of tasks.
+             * @return The number of tasks.
+             */
+            std::size_t size() const;
+
+            /**
+             * Returns the task at position @p index.
+             * @param index The position of the task.
+             * @return The task at position @p index.
+             */
+            TaskType& operator[](std::size_t index) const;
+
+        private:
+            /** Prohibit copying */
+            TaskList(TaskList const&);
+
+            /** Prohibit assignment */
+            TaskList& operator=(TaskList const&);
+
+        private:
+            std::vector<Task*> m_tasks;
+    };
+
+    /**************************************************************************/
+    /* Mandatory inline implementation                                        */
+    /**************************************************************************/
+
+    template<typename TaskType>
+    inline TaskList<TaskType>::TaskList(std::size_t capacity)
+    {
+        m_tasks.reserve(capacity);
+    }
+
+    template<typename TaskType>
+    inline TaskList<TaskType>::~TaskList()
+    {
+        for (std::vector<Task*>::size_type i = 0; i < m_tasks.size(); ++i)
+        {
+            delete m_tasks[i];
+        }
+    }
+
+    template<typename TaskType>
+    inline void TaskList<TaskType>::add(TaskType* task)
+    {
+        m_tasks.push_back(task);
+    }
+
+    template<typename TaskType>
+    inline Task* const* TaskList<TaskType>::tasks() const
+    {
+        return m_tasks.empty() ? 0 : &m_tasks[0];
+    }
+
+    template<typename TaskType>
+    inline std::size_t TaskList<TaskType>::size() const
+    {
+        return m_tasks.size();
+    }
+
+    template<typename TaskType>
+    inline TaskType& TaskList<TaskType>::operator[](std::size_t index) const
+    {
+        return *static_cast<TaskType*>(m_tasks[index]);
+    }
+}
+}
+}
+
+#endif  // __LIBEMBER_DOM_DETAIL_TASKLIST_HPP
@@ -0,0 +1,287 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef __LIBEMBER_DOM_DETAIL_TREESCANNER_HPP
+#define __LIBEMBER_DOM_DETAIL_TREESCANNER_HPP
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "../../ber/Encoding.hpp"
+#include "../../ber/Type.hpp"
+#include "EncodedHeader.hpp"
+
+namespace libember { namespace dom { namespace detail
+{
+    /**
+     * Describes a TLV found by scanTree().
+     */
+    struct ScannedElement
+    {
+        /** The application tag, without the constructed bit. */
+        ber::Tag applicationTag;
+
+        /** The type tag, without the constructed bit. */
+        ber::Tag typeTag;
+
+        /** Pointer to the first byte of the TLV. */
+        decode_value_type const* begin;
+
+        /** Pointer to the contents of the type tag. */
+        decode_value_type const* contents;
+
+        /** The length of the contents, only valid for leaves. */
+        std::size_t length;
+
+        /** True if the type tag is constructed. */
+        bool isContainer;
+    };
+
+    /**
+     * Scans the encoded tree starting at @p first without decoding any values and
+     * reports every TLV to @p builder, in pre-order. The builder must provide the
+     * following methods:
+     * - std::size_t beginElement(ScannedElement const& element, std::size_t parent,
+     *   std::size_t previous), which is invoked when the header of an element has
+     *   been scanned and returns the index the builder assigned to the element.
+     *   @p parent and @p previous are the indices of the parent and of the previous
+     *   sibling, or @p none if the element has no parent or is the first child.
+     * - void endElement(std::size_t index, decode_value_type const* end), which is
+     *   invoked after the element and all of its descendants have been scanned.
+     * @param first Pointer to the first byte of the TLV.
+     * @param last Pointer to the end of the available data.
+     * @param builder The builder to report the elements to.
+     * @param parent The index of the parent element.
+     * @param previous The index of the previous sibling.
+     * @param none The index used for elements that do not exist.
+     * @param index Receives the index the builder assigned to the TLV.
+     * @return A pointer to the byte following the TLV.
+     * @throw std::runtime_error if the TLV is malformed or incomplete.
+     */
+    template<typename Builder>
+    decode_value_type const* scanTree(decode_value_type const* first, decode_value_type const* last, Builder& builder, std::size_t parent, std::size_t previous, std::size_t none, std::size_t& index);
+
+    /**
+     * Decodes the contents of a leaf.
+     * @param type The universal type of the leaf.
+     * @param first Pointer to the first byte of the contents.
+     * @param length The length of the contents.
+     * @return The decoded value, or an empty value if the type is not supported.
+     */
+    ber::Value decodeValue(ber::Type const& type, decode_value_type const* first, std::size_t length);
+
+    /**************************************************************************/
+    /* Mandatory inline implementation                                        */
+    /**************************************************************************/
+
+    /**
+     * The state of an element whose header has been scanned by scanTree() but
+     * whose end has not been reached yet.
+     */
+    struct ScanFrame
+    {
+        /** The index the builder assigned to the element. */
+        std::size_t index;
+
+        /** The index of the last child scanned so far. */
+        std::size_t child;
+
+        /** The end of the data available to the element. */
+        decode_value_type const* last;
+
+        /** The end of the contents of the outer tag. */
+        decode_value_type const* outerLast;
+
+        /** The end of the contents of the type tag. */
+        decode_value_type const* innerLast;
+
+        /** True if the outer tag uses the indefinite length form. */
+        bool isIndefinite;
+
+        /** True if the type tag is constructed. */
+        bool isContainer;
+    };
+
+    /**
+     * Scans the outer and the type tag of the TLV at @p first.
+     * @param first Pointer to the first byte of the TLV.
+     * @param last Pointer to the end of the available data.
+     * @param element Receives the description of the TLV.
+     * @param frame Receives the bounds of the TLV. The indices are not set.
+     * @throw std::runtime_error if the headers are malformed or incomplete.
+     */
+    inline void scanElementHeader(decode_value_type const* first, decode_value_type const* last, ScannedElement& element, ScanFrame& frame)
+    {
+        EncodedHeader outer;
+        if (scanHeader(first, last, outer) == false)
+        {
+            throw std::runtime_error("Incomplete or invalid outer tag");
+        }
+
+        element.applicationTag = decodeTag(first, outer.tagEnd);
+        if (!(outer.constructed && element.applicationTag.getClass() != ber::Class::Universal))
+        {
+            throw std::runtime_error("Implicit tag or universal outer tag found");
+        }
+
+        if (outer.indefinite == false && outer.length == 0)
+        {
+            throw std::runtime_error("Zero outer length");
+        }
+
+        decode_value_type const* const outerLast = outer.indefinite ? last : outer.contents + outer.length;
+        EncodedHeader inner;
+        if (scanHeader(outer.contents, outerLast, inner) == false)
+        {
+            throw std::runtime_error("Incomplete or invalid type tag");
+        }
+
+        if (inner.indefinite != outer.indefinite)
+        {
+            throw std::runtime_error("Outer and inner tag must use the same length form");
+        }
+
+        if (inner.indefinite && inner.constructed == false)
+        {
+            throw std::runtime_error("Indefinite length form is only allowed on containers");
+        }
+
+        element.typeTag = decodeTag(outer.contents, inner.tagEnd);
+        element.applicationTag.setContainer(false);
+        element.typeTag.setContainer(false);
+        element.begin = first;
+        element.contents = inner.contents;
+        element.length = inner.length;
+        element.isContainer = inner.constructed;
+
+        frame.last = last;
+        frame.outerLast = outerLast;
+        frame.innerLast = inner.indefinite ? outerLast : inner.contents + inner.length;
+        frame.isIndefinite = outer.indefinite;
+        frame.isContainer = inner.constructed;
+    }
+
+    template<typename Builder>
+    inline decode_value_type const* scanTree(decode_value_type const* first, decode_value_type const* last, Builder& builder, std::size_t parent, std::size_t previous, std::size_t none, std::size_t& index)
+    {
+        // The open elements are kept on the heap instead of the call stack, so
+        // the nesting depth of untrusted input is only bounded by its size.
+        std::vector<ScanFrame> stack;
+        decode_value_type const* current = first;
+        decode_value_type const* limit = last;
+
+        for (;;)
+        {
+            ScannedElement element;
+            ScanFrame frame;
+            scanElementHeader(current, limit, element, frame);
+
+            std::size_t const parentIndex = stack.empty() ? parent : stack.back().index;
+            std::size_t const previousIndex = stack.empty() ? previous : stack.back().child;
+            frame.index = builder.beginElement(element, parentIndex, previousIndex);
+            frame.child = none;
+            current = frame.isContainer ? element.contents : element.contents + element.length;
+            stack.push_back(frame);
+
+            for (;;)
+            {
+                ScanFrame const& top = stack.back();
+                if (top.isContainer)
+                {
+                    bool const isComplete = top.isIndefinite ? isEndOfContents(current, top.innerLast) : current == top.innerLast;
+                    if (isComplete == false)
+                    {
+                        break;
+                    }
+
+                    if (top.isIndefinite)
+                    {
+                        current += 2;
+                    }
+                }
+
+                if (top.isIndefinite)
+                {
+                    if (isEndOfContents(current, top.last) == false)
+                    {
+                        throw std::runtime_error("Missing terminator of indefinite length field");
+                    }
+
+                    current += 2;
+                }
+                else if (current != top.outerLast)
+                {
+                    throw std::runtime_error("Inner length does not match the outer length");
+                }
+
+                std::size_t const scanned = top.index;
+                builder.endElement(scanned, current);
+                stack.pop_back();
+
+                if (stack.empty())
+                {
+                    index = scanned;
+                    return current;
+                }
+
+                stack.back().child = scanned;
+            }
+
+            limit = stack.back().innerLast;
+        }
+    }
+
+    inline ber::Value decodeValue(ber::Type const& type, decode_value_type const* first, std::size_t length)
+    {
+        util::OctetStream input;
+        input.append(first, first + length);
+
+        switch(type.value())
+        {
+            case ber::Type::Boolean:
+                return ber::Value(ber::decode<bool>(input, length));
+
+            case ber::Type::Integer:
+                if (length > 4)
+                    return ber::Value(ber::decode<long>(input, length));
+                else
+                    return ber::Value(ber::decode<int>(input, length));
+
+            case ber::Type::Real:
+                return ber::Value(ber::decode<double>(input, length));
+
+            case ber::Type::UTF8String:
+                return ber::Value(ber::decode<std::string>(input, length));
+
+            case ber::Type::RelativeObject:
+                return ber::Value(ber::decode<ber::ObjectIdentifier>(input, length));
+
+            case ber::Type::OctetString:
+                return ber::Value(ber::decode<ber::Octets>(input, length));
+
+            default:
+                return ber::Value();
+        }
+    }
+}
+}
+}
+
+#endif  // __LIBEMBER_DOM_DETAIL_TREESCANNER_HPP
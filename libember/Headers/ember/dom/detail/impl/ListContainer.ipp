@@ -20,6 +20,7 @@
 #ifndef __LIBEMBER_DOM_DETAIL_IMPL_LISTCONTAINER_IPP
 #define __LIBEMBER_DOM_DETAIL_IMPL_LISTCONTAINER_IPP
 
+#include <algorithm>
 #include "../../../util/DerefIterator.hpp"
 #include "../../../util/Inline.hpp"
 #include "../../../ber/Encoding.hpp"
@@ -28,12 +29,12 @@ namespace libember { namespace dom { namespace detail
 {
     LIBEMBER_INLINE    
     ListContainer::ListContainer(ber::Tag tag)
-        : Container(tag), m_children(), m_cachedLength(0)
+        : Container(tag), m_children(), m_changedChildren(), m_cachedLength(0), m_payloadLength(0), m_isPayloadLengthValid(false)
     {}
 
     LIBEMBER_INLINE    
     ListContainer::ListContainer(ListContainer const& other)
-        : Container(other), m_children(), m_cachedLength(0)
+        : Container(other), m_children(), m_changedChildren(), m_cachedLength(0), m_payloadLength(0), m_isPayloadLengthValid(false)
     {
         try
         {
@@ -84,48 +85,81 @@ namespace libember { namespace dom { namespace detail
     LIBEMBER_INLINE    
     ListContainer::iterator ListContainer::begin()
     {
-        util::DerefIterator<NodeList::iterator> const result(m_children.begin());
-        return result;
+        return toIterator(childBegin());
     }
 
     LIBEMBER_INLINE    
     ListContainer::const_iterator ListContainer::begin() const
     {
-        util::DerefIterator<NodeList::const_iterator> const result(m_children.begin());
-        return result;
+        return toIterator(childBegin());
     }
 
     LIBEMBER_INLINE    
     ListContainer::iterator ListContainer::end()
     {
-        util::DerefIterator<NodeList::iterator> const result(m_children.end());
-        return result;
+        return toIterator(childEnd());
     }
 
     LIBEMBER_INLINE    
     ListContainer::const_iterator ListContainer::end() const
     {
-        util::DerefIterator<NodeList::const_iterator> const result(m_children.end());
-        return result;
+        return toIterator(childEnd());
     }
 
     LIBEMBER_INLINE    
     ListContainer::iterator ListContainer::insertImpl(iterator const& where, Node* child)
     {
-        typedef util::DerefIterator<NodeList::iterator> DerefIteratorType;
-        NodeList::iterator const i = where.as<DerefIteratorType>().wrappedIterator();
-        return DerefIteratorType(m_children.insert(i, child));
+        NodeList::iterator const i = where.as<child_iterator>().wrappedIterator();
+        iterator const result = toIterator(m_children.insert(i, child));
+        invalidatePayloadLength();
+        return result;
     }
 
     LIBEMBER_INLINE    
     void ListContainer::eraseImpl(iterator const& first, iterator const& last)
     {
-        typedef util::DerefIterator<NodeList::iterator> DerefIteratorType;
-        NodeList::iterator const f = first.as<DerefIteratorType>().wrappedIterator();
-        NodeList::iterator const l = last.as<DerefIteratorType>().wrappedIterator();
+        NodeList::iterator const f = first.as<child_iterator>().wrappedIterator();
+        NodeList::iterator const l = last.as<child_iterator>().wrappedIterator();
+
+        // the erased children may be reported as changed
+        invalidatePayloadLength();
         m_children.erase(f, l);
     }
 
+    LIBEMBER_INLINE
+    void ListContainer::reserveImpl(size_type capacity)
+    {
+        // the capacity grows at least geometrically, so appending many small ranges
+        // remains linear
+        if (capacity > m_children.capacity())
+        {
+            m_children.reserve(std::max(capacity, m_children.capacity() * 2));
+        }
+    }
+
+    LIBEMBER_INLINE
+    bool ListContainer::childChanged(Node const& child) const
+    {
+        if (m_isPayloadLengthValid == false)
+            return false;
+
+        m_payloadLength -= child.encodedLength();
+        m_changedChildren.push_back(&child);
+        return true;
+    }
+
+    LIBEMBER_INLINE
+    void ListContainer::invalidatePayloadLength() const
+    {
+        for (ChangeList::iterator i = m_changedChildren.begin(); i != m_changedChildren.end(); ++i)
+        {
+            acknowledgeChange(**i);
+        }
+
+        m_changedChildren.clear();
+        m_isPayloadLengthValid = false;
+    }
+
     LIBEMBER_INLINE    
     std::size_t ListContainer::encodedPayloadLength() const
     {
@@ -149,8 +183,25 @@ namespace libember { namespace dom { namespace detail
     LIBEMBER_INLINE
     void ListContainer::updateImpl() const
     {
+        if (m_isPayloadLengthValid)
+        {
+            // only the children reported as changed need to be measured again
+            for (ChangeList::iterator i = m_changedChildren.begin(); i != m_changedChildren.end(); ++i)
+            {
+                m_payloadLength += (*i)->encodedLength();
+                acknowledgeChange(**i);
+            }
+
+            m_changedChildren.clear();
+        }
+        else
+        {
+            m_payloadLength = encodedPayloadLength();
+            m_isPayloadLengthValid = true;
+        }
+
         std::size_t const innerTagLength = ber::encodedLength(typeTag().toContainer());
-        std::size_t const payloadLength  = encodedPayloadLength();
+        std::size_t const payloadLength  = m_payloadLength;
         std::size_t const innerLength    = innerTagLength + ber::encodedLength(ber::make_length(payloadLength)) + payloadLength;
         
         std::size_t const outerTagLength = ber::encodedLength(applicationTag().toContainer());
@@ -164,7 +215,7 @@ namespace libember { namespace dom { namespace detail
     {
         ber::Tag const innerContainerTag = typeTag().toContainer();
         std::size_t const innerTagLength = ber::encodedLength(innerContainerTag);
-        std::size_t const payloadLength  = encodedPayloadLength();
+        std::size_t const payloadLength  = m_payloadLength;
         std::size_t const innerLength    = innerTagLength + ber::encodedLength(ber::make_length(payloadLength)) + payloadLength;
         
         ber::encode(output, applicationTag().toContainer());
@@ -176,6 +227,29 @@ namespace libember { namespace dom { namespace detail
         encodePayload(output);
     }
 
+    LIBEMBER_INLINE
+    void ListContainer::encodeIndefiniteImpl(util::OctetStream& output) const
+    {
+        ber::Length<std::size_t> const indefinite = ber::make_length(ber::Length<std::size_t>::INDEFINITE);
+
+        ber::encode(output, applicationTag().toContainer());
+        ber::encode(output, indefinite);
+
+        ber::encode(output, typeTag().toContainer());
+        ber::encode(output, indefinite);
+
+        for (NodeList::const_iterator i = m_children.begin(); i != m_children.end(); ++i)
+        {
+            (*i)->encodeIndefinite(output); 
+        }
+
+        // End-of-contents octets of the inner and the outer frame
+        output.append(0x00);
+        output.append(0x00);
+        output.append(0x00);
+        output.append(0x00);
+    }
+
     LIBEMBER_INLINE
     std::size_t ListContainer::encodedLengthImpl() const
     {
@@ -25,10 +25,20 @@
 #include "../VariantLeaf.hpp"
 #include "../Set.hpp"
 #include "../Sequence.hpp"
+#include "../NodeAllocator.hpp"
 #include "../NodeFactory.hpp"
+#include "../StringPool.hpp"
 
 namespace libember { namespace dom 
 {
+    LIBEMBER_INLINE
+    AsyncBerReader::Limits::Limits()
+        : maximumLength(static_cast<size_type>(-1))
+        , maximumDepth(static_cast<size_type>(-1))
+        , maximumElements(static_cast<size_type>(-1))
+        , skipUnknownContainers(true)
+    {}
+
     LIBEMBER_INLINE
     AsyncBerReader::AsyncBerReader()
         : m_buffer(0)
@@ -40,6 +50,11 @@ namespace libember { namespace dom
         , m_isContainer(false)
         , m_length(0)
         , m_outerLength(0)
+        , m_lazyLeafDecoding(false)
+        , m_skipRequested(false)
+        , m_stringPool(0)
+        , m_status(ReadStatus::Ok)
+        , m_elements(0)
     {}
 
     LIBEMBER_INLINE
@@ -57,12 +72,120 @@ namespace libember { namespace dom
         }
         disposeCurrentTLV();
         reset(DecodeState::Tag);
+        m_sliceBuffer.reset();
+        m_skipRequested = false;
+        m_status = ReadStatus::Ok;
         resetImpl();
     }
 
+    LIBEMBER_INLINE
+    AsyncBerReader::ReadStatus::_Domain AsyncBerReader::tryRead(value_type value)
+    {
+        readByte(value);
+        return m_status;
+    }
+
+    LIBEMBER_INLINE
+    AsyncBerReader::ReadStatus::_Domain AsyncBerReader::tryRead(value_type const* first, value_type const* last)
+    {
+        while (first != last && m_status == ReadStatus::Ok)
+        {
+            value_type const* const next = readBlock(first, last);
+            if (next == first)
+            {
+                readByte(*first);
+                ++first;
+            }
+            else
+            {
+                first = next;
+            }
+        }
+
+        return m_status;
+    }
+
+    LIBEMBER_INLINE
+    AsyncBerReader::ReadStatus::_Domain AsyncBerReader::status() const
+    {
+        return m_status;
+    }
+
+    LIBEMBER_INLINE
+    char const* AsyncBerReader::describe(ReadStatus::_Domain status)
+    {
+        switch(status)
+        {
+            case ReadStatus::Ok:
+                return "No error";
+
+            case ReadStatus::InvalidTag:
+                return "Number of tag octets out of bounds";
+
+            case ReadStatus::InvalidLength:
+                return "Number of length octets out of bounds";
+
+            case ReadStatus::InvalidTerminator:
+                return "Non-zero byte in terminator";
+
+            case ReadStatus::UnexpectedTerminator:
+                return "Unexpected terminator";
+
+            case ReadStatus::UnexpectedEndOfContainer:
+                return "Unexpected end of container";
+
+            case ReadStatus::ZeroOuterLength:
+                return "Zero outer length encountered";
+
+            case ReadStatus::LengthLimitExceeded:
+                return "Length exceeds the limit";
+
+            case ReadStatus::DepthLimitExceeded:
+                return "Nesting depth exceeds the limit";
+
+            case ReadStatus::ElementLimitExceeded:
+                return "Number of elements exceeds the limit";
+
+            case ReadStatus::UnknownContainer:
+                return "Container of an unknown type";
+        }
+
+        return "Unknown error";
+    }
+
     LIBEMBER_INLINE
     void AsyncBerReader::read(value_type value)
     {
+        if (tryRead(value) != ReadStatus::Ok)
+            throw std::runtime_error(describe(m_status));
+    }
+
+    LIBEMBER_INLINE
+    void AsyncBerReader::read(value_type const* first, value_type const* last)
+    {
+        if (tryRead(first, last) != ReadStatus::Ok)
+            throw std::runtime_error(describe(m_status));
+    }
+
+    LIBEMBER_INLINE
+    void AsyncBerReader::fail(ReadStatus::_Domain status)
+    {
+        if (m_status == ReadStatus::Ok)
+            m_status = status;
+    }
+
+    LIBEMBER_INLINE
+    void AsyncBerReader::readByte(value_type value)
+    {
+        if (m_status != ReadStatus::Ok)
+            return;
+
+        if (isSkippingBytes())
+        {
+            skipBlock(&value, &value + 1);
+            return;
+        }
+
         m_buffer.append(value);
 
         if (!m_stack.empty())
@@ -92,14 +215,45 @@ namespace libember { namespace dom
                 break;
         }
 
-        while (!m_stack.empty() && m_stack.back().eof())
-        {
-            if (!isEofOk)
-            {
-                throw std::runtime_error("Unexpected end of container");
-            }
-            popContainer();
-        }
+        popCompletedContainers(isEofOk);
+    }
+
+    LIBEMBER_INLINE
+    void AsyncBerReader::setLazyLeafDecoding(bool enabled)
+    {
+        m_lazyLeafDecoding = enabled;
+        if (enabled == false)
+            m_sliceBuffer.reset();
+    }
+
+    LIBEMBER_INLINE
+    bool AsyncBerReader::lazyLeafDecoding() const
+    {
+        return m_lazyLeafDecoding;
+    }
+
+    LIBEMBER_INLINE
+    void AsyncBerReader::setStringPool(StringPool* pool)
+    {
+        m_stringPool = pool;
+    }
+
+    LIBEMBER_INLINE
+    StringPool* AsyncBerReader::stringPool() const
+    {
+        return m_stringPool;
+    }
+
+    LIBEMBER_INLINE
+    void AsyncBerReader::setLimits(Limits const& limits)
+    {
+        m_limits = limits;
+    }
+
+    LIBEMBER_INLINE
+    AsyncBerReader::Limits const& AsyncBerReader::limits() const
+    {
+        return m_limits;
     }
 
     LIBEMBER_INLINE
@@ -118,8 +272,26 @@ namespace libember { namespace dom
         return m_isContainer;
     }
 
+    LIBEMBER_INLINE
+    ber::Tag const& AsyncBerReader::applicationTag() const
+    {
+        return m_appTag;
+    }
+
+    LIBEMBER_INLINE
+    ber::Tag const& AsyncBerReader::typeTag() const
+    {
+        return m_typeTag;
+    }
+
     LIBEMBER_INLINE
     dom::Node* AsyncBerReader::decodeNode(dom::NodeFactory const& factory)
+    {
+        return decodeNode(factory, dom::NodeAllocator::heap());
+    }
+
+    LIBEMBER_INLINE
+    dom::Node* AsyncBerReader::decodeNode(dom::NodeFactory const& factory, dom::NodeAllocator& allocator)
     {
         ber::Type const type = ber::Type::fromTag(m_typeTag);
         ber::Tag const tag = m_appTag;
@@ -131,10 +303,10 @@ namespace libember { namespace dom
                 switch(type.value())
                 {
                     case ber::Type::Set:
-                        return new dom::Set(tag);
+                        return new (allocator) dom::Set(tag);
 
                     case ber::Type::Sequence:
-                        return new dom::Sequence(tag);
+                        return new (allocator) dom::Sequence(tag);
 
                     default:
                         return 0;
@@ -145,25 +317,33 @@ namespace libember { namespace dom
                 switch(type.value())
                 {
                     case ber::Type::Boolean:
-                        return new dom::VariantLeaf(tag, decode<bool>());
+                        return new (allocator) dom::VariantLeaf(tag, decode<bool>());
 
                     case ber::Type::Integer:
                         if (m_length > 4)
-                            return new dom::VariantLeaf(tag, decode<long>());
+                            return new (allocator) dom::VariantLeaf(tag, decode<long>());
                         else
-                            return new dom::VariantLeaf(tag, decode<int>());
+                            return new (allocator) dom::VariantLeaf(tag, decode<int>());
 
                     case ber::Type::Real:
-                        return new dom::VariantLeaf(tag, decode<double>());
+                        return new (allocator) dom::VariantLeaf(tag, decode<double>());
 
                     case ber::Type::UTF8String:
-                        return new dom::VariantLeaf(tag, decode<std::string>());
+                        if (m_stringPool != 0 && m_valueLength <= m_stringPool->maximumLength())
+                            return new (allocator) dom::VariantLeaf(tag, m_stringPool->intern(m_valueBuffer.begin(), m_valueLength));
+                        else if (m_lazyLeafDecoding && m_valueLength > 0)
+                            return new (allocator) dom::VariantLeaf(tag, ber::make_tag(ber::Class::Universal, ber::Type::UTF8String), encodedSlice());
+                        else
+                            return new (allocator) dom::VariantLeaf(tag, decode<std::string>());
 
                     case ber::Type::RelativeObject:
-                        return new dom::VariantLeaf(tag, decode<ber::ObjectIdentifier>());
+                        return new (allocator) dom::VariantLeaf(tag, decode<ber::ObjectIdentifier>());
 
                     case ber::Type::OctetString:
-                        return new dom::VariantLeaf(tag, decode<ber::Octets>());
+                        if (m_lazyLeafDecoding && m_valueLength > 0)
+                            return new (allocator) dom::VariantLeaf(tag, ber::make_tag(ber::Class::Universal, ber::Type::OctetString), encodedSlice());
+                        else
+                            return new (allocator) dom::VariantLeaf(tag, decode<ber::Octets>());
 
                     default:
                         break;
@@ -174,10 +354,50 @@ namespace libember { namespace dom
         }
         else
         {
-            return factory.createApplicationDefinedNode(type, tag);
+            return factory.createApplicationDefinedNode(type, tag, allocator);
         }
     }
 
+    LIBEMBER_INLINE
+    void AsyncBerReader::skipContainer()
+    {
+        m_skipRequested = true;
+    }
+
+    LIBEMBER_INLINE
+    bool AsyncBerReader::isSkippingBytes() const
+    {
+        if (m_stack.empty() || m_decodeState.value() != DecodeState::Tag || m_bytesRead != 0)
+            return false;
+
+        AsyncContainer const& currentContainer = m_stack.back();
+        return currentContainer.isSkipped() && currentContainer.length() != length_type::INDEFINITE;
+    }
+
+    LIBEMBER_INLINE
+    AsyncBerReader::value_type const* AsyncBerReader::skipBlock(value_type const* first, value_type const* last)
+    {
+        size_type const available = static_cast<size_type>(last - first);
+        size_type const remaining = remainingContainerBytes();
+        size_type const count = (remaining < available) ? remaining : available;
+
+        m_stack.back().incrementBytesRead(count);
+        popCompletedContainers(true);
+        return first + count;
+    }
+
+    LIBEMBER_INLINE
+    bool AsyncBerReader::isSkipping() const
+    {
+        return !m_stack.empty() && m_stack.back().isSkipped();
+    }
+
+    LIBEMBER_INLINE
+    util::OctetSlice AsyncBerReader::encodedSlice()
+    {
+        return m_sliceBuffer.append(m_valueBuffer.begin(), m_valueLength);
+    }
+
     LIBEMBER_INLINE
     bool AsyncBerReader::readTagByte(value_type value)
     {
@@ -188,27 +408,20 @@ namespace libember { namespace dom
         }
 
         if (m_bytesRead > 12)
-            throw std::runtime_error("Number of tag octets out of bounds");
-
-        if ((m_bytesRead == 0 && (value & 0x1F) != 0x1F)
-        ||  (m_bytesRead > 0 && (value & 0x80) == 0))
         {
-            if (m_appTag.number() == 0 && m_appTag.preamble() == 0)
-            {
-                ber::Tag const tag = libember::ber::decode<ber::Tag>(m_buffer);
-
-                m_appTag = tag;
-                m_appTag.setContainer(false);
-            }
-            else
-            {
-                ber::Tag const tag = libember::ber::decode<ber::Tag>(m_buffer);
+            fail(ReadStatus::InvalidTag);
+            return false;
+        }
 
-                m_isContainer = tag.isContainer();
-                m_typeTag = tag;
-            }
+        if (m_bytesRead == 0 && (value & 0x1F) != 0x1F)
+        {
+            assignTag(makeSingleByteTag(value));
+            return false;
+        }
 
-            reset(DecodeState::Length);
+        if (m_bytesRead > 0 && (value & 0x80) == 0)
+        {
+            assignTag(libember::ber::decode<ber::Tag>(m_buffer));
             return false;
         }
 
@@ -221,58 +434,24 @@ namespace libember { namespace dom
     {
         if (m_bytesExpected == 0)
         {
-            if ((value & 0x80) != 0)
-            {
-                m_bytesExpected = (value & 0x7F) + 1;
-            }
-            else
-            {
-                m_bytesExpected = 1;
-            }
+            // Short form lengths are complete with their first byte
+            if ((value & 0x80) == 0)
+                return assignLength(value);
+
+            m_bytesExpected = (value & 0x7F) + 1;
 
             if (m_bytesExpected > 5)
-                throw std::runtime_error("Number of length octets out of bounds");
+            {
+                fail(ReadStatus::InvalidLength);
+                return false;
+            }
         }
 
         ++m_bytesRead;
 
         if (m_bytesRead == m_bytesExpected)
         {
-            ber::Type const type = ber::Type::fromTag(m_typeTag);
-            if (type.value() == 0)
-            {
-                m_outerLength = ber::decode<length_type>(m_buffer).value;
-
-                if (m_outerLength == 0)
-                    throw std::runtime_error("Zero outer length encountered");
-
-                reset(DecodeState::Tag);
-            }
-            else 
-            {
-                m_length = ber::decode<length_type>(m_buffer).value;
-
-                bool const isEofOk = m_length == 0;
-                if (m_isContainer)
-                {
-                    reset(DecodeState::Tag);
-                    containerReady();
-                    pushContainer();
-                    disposeCurrentTLV();
-                    return isEofOk;
-                }
-
-                if (m_length == 0)
-                {
-                    preloadValue();
-                }
-                else
-                {
-                    reset(DecodeState::Value);
-                }
-
-                return isEofOk;
-            }
+            return assignLength();
         }
         return false;
     }
@@ -299,18 +478,21 @@ namespace libember { namespace dom
     {
         if (value != 0)
         {
-            throw std::runtime_error("Non-zero byte in terminator");
+            fail(ReadStatus::InvalidTerminator);
+            return false;
         }
 
         if (m_stack.empty()) 
         {
-            throw std::runtime_error("Unexpected terminator");
+            fail(ReadStatus::UnexpectedTerminator);
+            return false;
         }
 
         AsyncContainer& currentContainer = m_stack.back();
         if  (currentContainer.length() != length_type::INDEFINITE)
         {
-            throw std::runtime_error("Unexpected terminator");
+            fail(ReadStatus::UnexpectedTerminator);
+            return false;
         }
 
         m_bytesRead += 1;
@@ -323,6 +505,281 @@ namespace libember { namespace dom
         return false;
     }
 
+    LIBEMBER_INLINE
+    AsyncBerReader::value_type const* AsyncBerReader::readBlock(value_type const* first, value_type const* last)
+    {
+        // Never consume bytes beyond the end of the current container in a single step, so
+        // that a container which ends within an element is detected exactly as by read(value_type).
+        size_type const available = static_cast<size_type>(last - first);
+        size_type const remaining = remainingContainerBytes();
+        value_type const* const end = (remaining < available) ? first + remaining : last;
+
+        if (isSkippingBytes())
+            return skipBlock(first, end);
+
+        switch(m_decodeState.value())
+        {
+            case DecodeState::Tag:
+            {
+                value_type const* const next = readHeaderBlock(first, end);
+                return (next != first) ? next : readTagBlock(first, end);
+            }
+
+            case DecodeState::Length:
+                return readLengthBlock(first, end);
+
+            case DecodeState::Value:
+                return readValueBlock(first, end);
+
+            default:
+                return first;
+        }
+    }
+
+    LIBEMBER_INLINE
+    AsyncBerReader::value_type const* AsyncBerReader::readHeaderBlock(value_type const* first, value_type const* last)
+    {
+        if (m_bytesRead != 0 || last - first < 2)
+            return first;
+
+        value_type const tagByte = first[0];
+        value_type const lengthByte = first[1];
+        if (tagByte == 0 || (tagByte & 0x1F) == 0x1F || (lengthByte & 0x80) != 0)
+            return first;
+
+        // The header is validated completely, so neither byte needs to be buffered.
+        incrementContainerBytes(2);
+        assignTag(makeSingleByteTag(tagByte));
+        popCompletedContainers(assignLength(lengthByte));
+        return first + 2;
+    }
+
+    LIBEMBER_INLINE
+    AsyncBerReader::value_type const* AsyncBerReader::readTagBlock(value_type const* first, value_type const* last)
+    {
+        if (m_bytesRead != 0 || first == last || *first == 0)
+            return first;
+
+        value_type const* it = first;
+        if ((*it & 0x1F) == 0x1F)
+        {
+            for (++it; it != last && (*it & 0x80) != 0; ++it)
+                ;
+
+            if (it == last)
+                return first;
+        }
+
+        ++it;
+
+        // Let the single byte decoder report tags that exceed the maximum size.
+        if (it - first > 13)
+            return first;
+
+        appendBlock(first, it);
+        assignTag(libember::ber::decode<ber::Tag>(m_buffer));
+        popCompletedContainers(false);
+        return it;
+    }
+
+    LIBEMBER_INLINE
+    AsyncBerReader::value_type const* AsyncBerReader::readLengthBlock(value_type const* first, value_type const* last)
+    {
+        if (m_bytesRead != 0 || first == last)
+            return first;
+
+        value_type const value = *first;
+        if ((value & 0x80) == 0)
+        {
+            incrementContainerBytes(1);
+            popCompletedContainers(assignLength(value));
+            return first + 1;
+        }
+
+        size_type const bytesExpected = ((value & 0x80) != 0) ? (value & 0x7F) + 1 : 1;
+        if (bytesExpected > 5 || static_cast<size_type>(last - first) < bytesExpected)
+            return first;
+
+        value_type const* const end = first + bytesExpected;
+        appendBlock(first, end);
+        m_bytesExpected = bytesExpected;
+        m_bytesRead = bytesExpected;
+        popCompletedContainers(assignLength());
+        return end;
+    }
+
+    LIBEMBER_INLINE
+    AsyncBerReader::value_type const* AsyncBerReader::readValueBlock(value_type const* first, value_type const* last)
+    {
+        if (first == last)
+            return first;
+
+        if (m_bytesRead == 0)
+            m_bytesExpected = m_length;
+
+        size_type const available = static_cast<size_type>(last - first);
+        size_type const bytesRemaining = m_bytesExpected - m_bytesRead;
+        value_type const* const end = (bytesRemaining < available) ? first + bytesRemaining : last;
+
+        appendBlock(first, end);
+        m_bytesRead += static_cast<size_type>(end - first);
+
+        if (m_bytesRead == m_bytesExpected)
+        {
+            preloadValue();
+            popCompletedContainers(true);
+        }
+        else
+        {
+            popCompletedContainers(false);
+        }
+        return end;
+    }
+
+    LIBEMBER_INLINE
+    void AsyncBerReader::appendBlock(value_type const* first, value_type const* last)
+    {
+        m_buffer.append(first, last);
+        incrementContainerBytes(static_cast<size_type>(last - first));
+    }
+
+    LIBEMBER_INLINE
+    void AsyncBerReader::incrementContainerBytes(size_type count)
+    {
+        if (!m_stack.empty())
+        {
+            AsyncContainer& currentContainer = m_stack.back();
+            currentContainer.incrementBytesRead(count);
+        }
+    }
+
+    LIBEMBER_INLINE
+    AsyncBerReader::size_type AsyncBerReader::remainingContainerBytes() const
+    {
+        if (!m_stack.empty())
+        {
+            AsyncContainer const& currentContainer = m_stack.back();
+            if (currentContainer.length() != length_type::INDEFINITE)
+            {
+                return (currentContainer.bytesRead() < currentContainer.length())
+                    ? currentContainer.length() - currentContainer.bytesRead()
+                    : 0;
+            }
+        }
+        return static_cast<size_type>(-1);
+    }
+
+    LIBEMBER_INLINE
+    void AsyncBerReader::popCompletedContainers(bool isEofOk)
+    {
+        while (!m_stack.empty() && m_stack.back().eof())
+        {
+            if (!isEofOk)
+            {
+                fail(ReadStatus::UnexpectedEndOfContainer);
+                return;
+            }
+            popContainer();
+        }
+    }
+
+    LIBEMBER_INLINE
+    void AsyncBerReader::assignTag(ber::Tag const& tag)
+    {
+        if (m_appTag.number() == 0 && m_appTag.preamble() == 0)
+        {
+            m_appTag = tag;
+            m_appTag.setContainer(false);
+        }
+        else
+        {
+            m_isContainer = tag.isContainer();
+            m_typeTag = tag;
+        }
+
+        reset(DecodeState::Length);
+    }
+
+    LIBEMBER_INLINE
+    ber::Tag AsyncBerReader::makeSingleByteTag(value_type value)
+    {
+        return ber::Tag(static_cast<ber::Tag::Preamble>(value & 0xE0), static_cast<ber::Tag::Number>(value & 0x1F));
+    }
+
+    LIBEMBER_INLINE
+    bool AsyncBerReader::assignLength()
+    {
+        return assignLength(ber::decode<length_type>(m_buffer).value);
+    }
+
+    LIBEMBER_INLINE
+    bool AsyncBerReader::assignLength(size_type length)
+    {
+        if (length > m_limits.maximumLength && length != length_type::INDEFINITE)
+        {
+            fail(ReadStatus::LengthLimitExceeded);
+            return false;
+        }
+
+        ber::Type const type = ber::Type::fromTag(m_typeTag);
+        if (type.value() == 0)
+        {
+            m_outerLength = length;
+
+            if (m_outerLength == 0)
+            {
+                fail(ReadStatus::ZeroOuterLength);
+                return false;
+            }
+
+            reset(DecodeState::Tag);
+            return false;
+        }
+        else
+        {
+            m_length = length;
+
+            // the elements are counted per root, which is the only element on an empty stack
+            m_elements = m_stack.empty() ? 0 : m_elements + 1;
+            if (m_elements > m_limits.maximumElements)
+            {
+                fail(ReadStatus::ElementLimitExceeded);
+                return false;
+            }
+
+            bool const isEofOk = m_length == 0;
+            if (m_isContainer)
+            {
+                if (m_stack.size() >= m_limits.maximumDepth)
+                {
+                    fail(ReadStatus::DepthLimitExceeded);
+                    return false;
+                }
+
+                reset(DecodeState::Tag);
+                if (isSkipping())
+                    m_skipRequested = true;
+                else
+                    containerReady();
+
+                pushContainer();
+                disposeCurrentTLV();
+                return isEofOk;
+            }
+
+            if (m_length == 0)
+            {
+                preloadValue();
+            }
+            else
+            {
+                reset(DecodeState::Value);
+            }
+
+            return isEofOk;
+        }
+    }
+
     LIBEMBER_INLINE
     void AsyncBerReader::reset(DecodeState const& state)
     {
@@ -342,15 +799,18 @@ namespace libember { namespace dom
         m_valueLength = std::min(m_length, m_valueBuffer.size());
 
         reset(DecodeState::Tag);
-        itemReady();
+        if (isSkipping() == false)
+            itemReady();
+
         disposeCurrentTLV();
     }
 
     LIBEMBER_INLINE
     void AsyncBerReader::pushContainer()
     {
-        AsyncContainer newContainer(m_appTag, m_typeTag, m_length);
+        AsyncContainer newContainer(m_appTag, m_typeTag, m_length, m_skipRequested);
         m_stack.push_back(newContainer);
+        m_skipRequested = false;
     }
 
     LIBEMBER_INLINE
@@ -360,17 +820,20 @@ namespace libember { namespace dom
 
         if (!m_stack.empty())
         {
+            bool isSkipped;
             {
                 AsyncContainer const& currentContainer = m_stack.back();
                 m_appTag  = currentContainer.tag();
                 m_typeTag = currentContainer.type();
                 m_length  = currentContainer.length();
                 m_isContainer = true;
+                isSkipped = currentContainer.isSkipped();
 
                 m_stack.pop_back();
             }
 
-            itemReady();
+            if (isSkipped == false)
+                itemReady();
 
             if (!m_stack.empty())
             {
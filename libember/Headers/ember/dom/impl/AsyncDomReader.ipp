@@ -23,6 +23,8 @@
 #include <stdexcept>
 #include "../../util/Inline.hpp"
 #include "../Container.hpp"
+#include "../NodeAllocator.hpp"
+#include "../NodeFilter.hpp"
 
 namespace libember { namespace dom 
 {
@@ -32,6 +34,19 @@ namespace libember { namespace dom
         , m_root(0)
         , m_current(0)
         , m_factory(factory)
+        , m_allocator(dom::NodeAllocator::heap())
+        , m_filter(0)
+    {
+    }
+
+    LIBEMBER_INLINE
+    AsyncDomReader::AsyncDomReader(dom::NodeFactory const& factory, dom::NodeAllocator& allocator)
+        : m_isRootReady(false)
+        , m_root(0)
+        , m_current(0)
+        , m_factory(factory)
+        , m_allocator(allocator)
+        , m_filter(0)
     {
     }
 
@@ -65,6 +80,18 @@ namespace libember { namespace dom
         }
     }
 
+    LIBEMBER_INLINE
+    void AsyncDomReader::setNodeFilter(dom::NodeFilter const* filter)
+    {
+        m_filter = filter;
+    }
+
+    LIBEMBER_INLINE
+    dom::NodeFilter const* AsyncDomReader::nodeFilter() const
+    {
+        return m_filter;
+    }
+
     LIBEMBER_INLINE
     void AsyncDomReader::containerReady(dom::Node*) 
     {
@@ -97,7 +124,27 @@ namespace libember { namespace dom
     LIBEMBER_INLINE
     void AsyncDomReader::containerReady()
     {
-        dom::Node* container = decodeNode(m_factory);
+        if (m_filter != 0 && m_root != 0 && m_isRootReady == false)
+        {
+            if (m_filter->accept(m_current, ber::Type::fromTag(typeTag()), applicationTag()) == false)
+            {
+                skipContainer();
+                return;
+            }
+        }
+
+        dom::Node* container = decodeNode(m_factory, m_allocator);
+        if (container == 0)
+        {
+            // No node exists for the type of the container, so it is either dropped with
+            // its contents, like leaves of an unknown type, or rejected.
+            if (limits().skipUnknownContainers)
+                skipContainer();
+            else
+                fail(ReadStatus::UnknownContainer);
+            return;
+        }
+
         if (m_isRootReady)
         {
             resetImpl();
@@ -140,7 +187,7 @@ namespace libember { namespace dom
         }
         else
         {
-            dom::Node* node = decodeNode(m_factory);
+            dom::Node* node = decodeNode(m_factory, m_allocator);
             if (node != 0)
             {
                 dom::Container* container = dynamic_cast<dom::Container*>(m_current);
@@ -28,6 +28,7 @@ namespace libember { namespace dom
     LIBEMBER_INLINE
     Container::Container(ber::Tag tag)
         : Node(tag)
+        , m_generation(0)
     {}
 
     LIBEMBER_INLINE
@@ -39,10 +40,72 @@ namespace libember { namespace dom
         }
         iterator const result = insertImpl(where, child);
         result->setParent(this);
+        ++m_generation;
         markDirty();
         return result;
     }
 
+    LIBEMBER_INLINE
+    void Container::insertNodes(iterator const& where, Node* const* first, Node* const* last)
+    {
+        for (Node* const* it = first; it != last; ++it)
+        {
+            if ((*it)->parent() != 0)
+            {
+                throw std::runtime_error("Attempt to add a node already owned by a container node.");
+            }
+        }
+
+        // reserving may move the children, so the position is restored from its offset
+        bool const isAppend = where == end();
+        size_type offset = 0;
+        for (iterator it = begin(); isAppend == false && it != where; ++it)
+        {
+            ++offset;
+        }
+
+        reserveImpl(size() + static_cast<size_type>(last - first));
+
+        iterator position = isAppend ? end() : begin();
+        for (size_type i = 0; i < offset; ++i)
+        {
+            ++position;
+        }
+
+        Node* const* it = first;
+        try
+        {
+            for ( ; it != last; ++it)
+            {
+                iterator const result = insertImpl(position, *it);
+                result->setParent(this);
+                position = result;
+                ++position;
+            }
+        }
+        catch (...)
+        {
+            if (it != first)
+            {
+                ++m_generation;
+                markDirty();
+            }
+            throw;
+        }
+        ++m_generation;
+        markDirty();
+    }
+
+    LIBEMBER_INLINE
+    void Container::reserve(size_type capacity)
+    {
+        reserveImpl(capacity);
+    }
+
+    LIBEMBER_INLINE
+    void Container::reserveImpl(size_type)
+    {}
+
     LIBEMBER_INLINE
     void Container::fixParent(Node* child)
     {
@@ -53,6 +116,12 @@ namespace libember { namespace dom
         child->setParent(this);
     }
 
+    LIBEMBER_INLINE
+    void Container::acknowledgeChange(Node const& child)
+    {
+        child.m_changeReported = false;
+    }
+
     LIBEMBER_INLINE
     void Container::clear()
     {
@@ -79,12 +148,29 @@ namespace libember { namespace dom
             size_type const newSize = size();
             if (newSize != oldSize)
             {
+                ++m_generation;
                 markDirty();
             }
             throw;
         }
+        ++m_generation;
         markDirty();
     }
+
+    LIBEMBER_INLINE
+    Node* Container::release(iterator const& i)
+    {
+        Node* const child = &*i;
+        erase(i);
+        child->setParent(0);
+        return child;
+    }
+
+    LIBEMBER_INLINE
+    Container::size_type Container::generation() const
+    {
+        return m_generation;
+    }
 }
 }
 
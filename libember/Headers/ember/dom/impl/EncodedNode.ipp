@@ -0,0 +1,71 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef __LIBEMBER_DOM_IMPL_ENCODEDNODE_IPP
+#define __LIBEMBER_DOM_IMPL_ENCODEDNODE_IPP
+
+#include "../../util/Inline.hpp"
+
+namespace libember { namespace dom
+{
+    LIBEMBER_INLINE
+    EncodedNode::EncodedNode(util::OctetSlice const& encoding)
+        : Node(ber::make_tag(ber::Class::Universal, 0))
+        , m_encoding(encoding)
+    {}
+
+    LIBEMBER_INLINE
+    EncodedNode* EncodedNode::clone() const
+    {
+        return new EncodedNode(*this);
+    }
+
+    LIBEMBER_INLINE
+    util::OctetSlice const& EncodedNode::encoding() const
+    {
+        return m_encoding;
+    }
+
+    LIBEMBER_INLINE
+    ber::Tag EncodedNode::typeTagImpl() const
+    {
+        return ber::make_tag(ber::Class::Universal, 0);
+    }
+
+    LIBEMBER_INLINE
+    void EncodedNode::updateImpl() const
+    {
+    }
+
+    LIBEMBER_INLINE
+    void EncodedNode::encodeImpl(util::OctetStream& output) const
+    {
+        output.append(m_encoding.begin(), m_encoding.end());
+    }
+
+    LIBEMBER_INLINE
+    std::size_t EncodedNode::encodedLengthImpl() const
+    {
+        return m_encoding.size();
+    }
+}
+}
+
+#endif  // __LIBEMBER_DOM_IMPL_ENCODEDNODE_IPP
+
@@ -0,0 +1,169 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef __LIBEMBER_DOM_IMPL_FLATTREE_IPP
+#define __LIBEMBER_DOM_IMPL_FLATTREE_IPP
+
+#include <stdexcept>
+#include "../../util/Inline.hpp"
+#include "../detail/TreeScanner.hpp"
+
+namespace libember { namespace dom
+{
+    /**
+     * The builder passed to detail::scanTree() by FlatTree::assign().
+     */
+    class FlatTree::Builder
+    {
+        public:
+            explicit Builder(FlatTree& tree)
+                : m_tree(tree)
+            {}
+
+            size_type beginElement(detail::ScannedElement const& element, size_type parent, size_type previous)
+            {
+                std::vector<Record>& records = m_tree.m_records;
+                std::vector<value_type>& arena = m_tree.m_arena;
+                size_type const index = records.size();
+
+                Record record;
+                record.applicationTag = element.applicationTag;
+                record.typeTag = element.typeTag;
+                record.parent = parent;
+                record.firstChild = npos;
+                record.nextSibling = npos;
+                record.valueOffset = 0;
+                record.valueLength = 0;
+                record.isContainer = element.isContainer;
+
+                if (element.isContainer == false)
+                {
+                    record.valueOffset = arena.size();
+                    record.valueLength = element.length;
+                    arena.insert(arena.end(), element.contents, element.contents + element.length);
+                }
+
+                records.push_back(record);
+
+                if (previous != npos)
+                {
+                    records[previous].nextSibling = index;
+                }
+                else if (parent != npos)
+                {
+                    records[parent].firstChild = index;
+                }
+                return index;
+            }
+
+            void endElement(size_type, value_type const*)
+            {}
+
+        private:
+            /** Prohibit assignment */
+            Builder& operator=(Builder const&);
+
+        private:
+            FlatTree& m_tree;
+    };
+
+    LIBEMBER_INLINE
+    FlatTree::FlatTree()
+    {}
+
+    LIBEMBER_INLINE
+    FlatTree::FlatTree(value_type const* first, value_type const* last)
+    {
+        assign(first, last);
+    }
+
+    LIBEMBER_INLINE
+    void FlatTree::assign(value_type const* first, value_type const* last)
+    {
+        clear();
+
+        if (first == last)
+        {
+            throw std::runtime_error("Empty document");
+        }
+
+        try
+        {
+            Builder builder(*this);
+            size_type root = 0;
+            detail::scanTree(first, last, builder, npos, npos, npos, root);
+
+            if (m_records.front().isContainer == false)
+            {
+                throw std::runtime_error("Root node is not a container");
+            }
+        }
+        catch (...)
+        {
+            clear();
+            throw;
+        }
+    }
+
+    LIBEMBER_INLINE
+    void FlatTree::clear()
+    {
+        m_records.clear();
+        m_arena.clear();
+    }
+
+    LIBEMBER_INLINE
+    FlatTree::size_type FlatTree::childCount(size_type index) const
+    {
+        size_type count = 0;
+        for (size_type child = m_records[index].firstChild; child != npos; child = m_records[child].nextSibling)
+        {
+            ++count;
+        }
+        return count;
+    }
+
+    LIBEMBER_INLINE
+    FlatTree::size_type FlatTree::find(size_type parent, ber::Tag const& tag) const
+    {
+        size_type child = m_records[parent].firstChild;
+        while (child != npos && m_records[child].applicationTag != tag)
+        {
+            child = m_records[child].nextSibling;
+        }
+        return child;
+    }
+
+    LIBEMBER_INLINE
+    ber::Value FlatTree::value(size_type index) const
+    {
+        Record const& record = m_records[index];
+        ber::Type const type = ber::Type::fromTag(record.typeTag);
+
+        if (record.isContainer || type.isApplicationDefined())
+        {
+            return ber::Value();
+        }
+
+        return detail::decodeValue(type, payload(index), record.valueLength);
+    }
+}
+}
+
+#endif  // __LIBEMBER_DOM_IMPL_FLATTREE_IPP
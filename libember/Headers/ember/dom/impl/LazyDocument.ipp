@@ -0,0 +1,174 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef __LIBEMBER_DOM_IMPL_LAZYDOCUMENT_IPP
+#define __LIBEMBER_DOM_IMPL_LAZYDOCUMENT_IPP
+
+#include <stdexcept>
+#include <vector>
+#include "../../util/Inline.hpp"
+#include "../AsyncDomReader.hpp"
+#include "../NodeFactory.hpp"
+#include "../VariantLeaf.hpp"
+#include "../detail/TreeScanner.hpp"
+
+namespace libember { namespace dom
+{
+    /**
+     * The builder passed to detail::scanTree() by the constructor of a LazyDocument.
+     */
+    class LazyDocument::Indexer
+    {
+        public:
+            explicit Indexer(LazyDocument& document)
+                : m_document(document)
+                , m_buffer(&document.m_buffer[0])
+            {}
+
+            size_type beginElement(detail::ScannedElement const& element, size_type parent, size_type previous)
+            {
+                std::vector<Entry>& entries = m_document.m_entries;
+                size_type const index = entries.size();
+
+                Entry entry;
+                entry.applicationTag = element.applicationTag;
+                entry.typeTag = element.typeTag;
+                entry.begin = static_cast<size_type>(element.begin - m_buffer);
+                entry.end = 0;
+                entry.contents = static_cast<size_type>(element.contents - m_buffer);
+                entry.length = element.length;
+                entry.parent = parent;
+                entry.nextSibling = npos;
+                entry.childCount = 0;
+                entry.isContainer = element.isContainer;
+                entries.push_back(entry);
+
+                if (previous != npos)
+                {
+                    entries[previous].nextSibling = index;
+                }
+
+                if (parent != npos)
+                {
+                    entries[parent].childCount += 1;
+                }
+                return index;
+            }
+
+            void endElement(size_type index, value_type const* end)
+            {
+                m_document.m_entries[index].end = static_cast<size_type>(end - m_buffer);
+            }
+
+        private:
+            /** Prohibit assignment */
+            Indexer& operator=(Indexer const&);
+
+        private:
+            LazyDocument& m_document;
+            value_type const* m_buffer;
+    };
+
+    LIBEMBER_INLINE
+    LazyDocument::LazyDocument(value_type const* first, value_type const* last)
+        : m_buffer(first, last)
+    {
+        if (m_buffer.empty())
+        {
+            throw std::runtime_error("Empty document");
+        }
+
+        value_type const* const buffer = &m_buffer[0];
+        Indexer indexer(*this);
+        size_type root = 0;
+        detail::scanTree(buffer, buffer + m_buffer.size(), indexer, npos, npos, npos, root);
+
+        if (m_entries.front().isContainer == false)
+        {
+            throw std::runtime_error("Root node is not a container");
+        }
+    }
+
+    LIBEMBER_INLINE
+    LazyDocument::Element LazyDocument::Element::child(size_type index) const
+    {
+        Element result = firstChild();
+        for (/* Nothing */; index > 0 && result.isNull() == false; --index)
+        {
+            result = result.nextSibling();
+        }
+        return result;
+    }
+
+    LIBEMBER_INLINE
+    LazyDocument::Element LazyDocument::Element::find(ber::Tag const& tag) const
+    {
+        Element result = firstChild();
+        while (result.isNull() == false && result.applicationTag() != tag)
+        {
+            result = result.nextSibling();
+        }
+        return result;
+    }
+
+    LIBEMBER_INLINE
+    ber::Value LazyDocument::Element::value() const
+    {
+        Entry const& entry = this->entry();
+        ber::Type const type = ber::Type::fromTag(entry.typeTag);
+
+        if (entry.isContainer || type.isApplicationDefined())
+        {
+            return ber::Value();
+        }
+
+        return detail::decodeValue(type, &m_document->m_buffer[0] + entry.contents, entry.length);
+    }
+
+    LIBEMBER_INLINE
+    Node* LazyDocument::Element::materialize(NodeFactory const& factory) const
+    {
+        Entry const& entry = this->entry();
+
+        if (entry.isContainer)
+        {
+            AsyncDomReader reader(factory);
+            reader.read(begin(), end());
+
+            if (reader.isRootReady() == false)
+            {
+                throw std::runtime_error("Incomplete root node.");
+            }
+
+            return reader.detachRoot();
+        }
+
+        ber::Type const type = ber::Type::fromTag(entry.typeTag);
+        if (type.isApplicationDefined())
+        {
+            return factory.createApplicationDefinedNode(type, entry.applicationTag);
+        }
+
+        ber::Value const value = this->value();
+        return value ? new VariantLeaf(entry.applicationTag, value) : 0;
+    }
+}
+}
+
+#endif  // __LIBEMBER_DOM_IMPL_LAZYDOCUMENT_IPP
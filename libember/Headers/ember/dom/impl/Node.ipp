@@ -21,24 +21,66 @@
 #define __LIBEMBER_DOM_IMPL_NODE_IPP
 
 #include "../../util/Inline.hpp"
+#include "../../util/Instrumentation.hpp"
 #include "../Container.hpp"
 
 namespace libember { namespace dom 
 {
     LIBEMBER_INLINE
     Node::Node(ber::Tag tag)
-        : m_applicationTag(tag), m_parent(0), m_dirty(true)
+        : m_applicationTag(tag), m_parent(0), m_dirty(true), m_changeReported(false)
     {}
 
     LIBEMBER_INLINE
     Node::Node(Node const& other)
-        : m_applicationTag(other.m_applicationTag), m_parent(0), m_dirty(true)
+        : m_applicationTag(other.m_applicationTag), m_parent(0), m_dirty(true), m_changeReported(false)
     {}
 
     LIBEMBER_INLINE
     Node::~Node()
     {}
 
+    LIBEMBER_INLINE
+    void* Node::operator new(std::size_t size)
+    {
+        return operator new(size, NodeAllocator::heap());
+    }
+
+    LIBEMBER_INLINE
+    void* Node::operator new(std::size_t size, NodeAllocator& allocator)
+    {
+        AllocationHeader* const header = static_cast<AllocationHeader*>(allocator.allocate(sizeof(AllocationHeader) + size));
+        header->allocator = &allocator;
+#ifdef LIBEMBER_INSTRUMENTATION
+        util::Instrumentation::allocated(util::Instrumentation::NodeStorage, sizeof(AllocationHeader) + size);
+#endif
+        return header + 1;
+    }
+
+    LIBEMBER_INLINE
+    void Node::operator delete(void* ptr, std::size_t size)
+    {
+        if (ptr != 0)
+        {
+            AllocationHeader* const header = static_cast<AllocationHeader*>(ptr) - 1;
+#ifdef LIBEMBER_INSTRUMENTATION
+            util::Instrumentation::released(util::Instrumentation::NodeStorage, sizeof(AllocationHeader) + size);
+#endif
+            header->allocator->deallocate(header, sizeof(AllocationHeader) + size);
+        }
+    }
+
+    LIBEMBER_INLINE
+    void Node::operator delete(void* ptr, NodeAllocator& allocator)
+    {
+        AllocationHeader* const header = static_cast<AllocationHeader*>(ptr) - 1;
+#ifdef LIBEMBER_INSTRUMENTATION
+        // The size of the node is not known here, so the live bytes keep the size of the node.
+        util::Instrumentation::released(util::Instrumentation::NodeStorage, sizeof(AllocationHeader));
+#endif
+        allocator.deallocate(header, sizeof(AllocationHeader));
+    }
+
     LIBEMBER_INLINE
     ber::Tag Node::applicationTag() const
     {
@@ -86,6 +128,18 @@ namespace libember { namespace dom
         encodeImpl(output);
     }
 
+    LIBEMBER_INLINE
+    void Node::encodeIndefinite(util::OctetStream& output) const
+    {
+        encodeIndefiniteImpl(output);
+    }
+
+    LIBEMBER_INLINE
+    void Node::encodeIndefiniteImpl(util::OctetStream& output) const
+    {
+        encode(output);
+    }
+
 
     LIBEMBER_INLINE
     std::size_t Node::encodedLength() const
@@ -94,9 +148,20 @@ namespace libember { namespace dom
         return encodedLengthImpl();
     }
 
+    LIBEMBER_INLINE
+    bool Node::childChanged(Node const&) const
+    {
+        return false;
+    }
+
     LIBEMBER_INLINE
     void Node::markDirty() const
     {
+        if (m_changeReported == false && m_parent != 0)
+        {
+            m_changeReported = m_parent->childChanged(*this);
+        }
+
         m_dirty = true;
         if (m_parent != 0)
         {
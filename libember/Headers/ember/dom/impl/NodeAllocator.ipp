@@ -0,0 +1,144 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef __LIBEMBER_DOM_IMPL_NODEALLOCATOR_IPP
+#define __LIBEMBER_DOM_IMPL_NODEALLOCATOR_IPP
+
+#include <new>
+#include "../../util/Inline.hpp"
+
+namespace libember { namespace dom 
+{
+    namespace detail
+    {
+        /**
+         * The default allocator, using the global operator new and operator delete.
+         */
+        class HeapNodeAllocator : public NodeAllocator
+        {
+            public:
+                virtual void* allocate(std::size_t size)
+                {
+                    return ::operator new(size);
+                }
+
+                virtual void deallocate(void* ptr, std::size_t)
+                {
+                    ::operator delete(ptr);
+                }
+        };
+    }
+
+    LIBEMBER_INLINE
+    NodeAllocator& NodeAllocator::heap()
+    {
+        static detail::HeapNodeAllocator instance;
+        return instance;
+    }
+
+    namespace
+    {
+        /**
+         * Constructs the default allocator during static initialization, before
+         * any thread that decodes nodes may have been started.
+         */
+        NodeAllocator const& theHeapNodeAllocatorInitializer = NodeAllocator::heap();
+    }
+
+    LIBEMBER_INLINE
+    NodeAllocator::~NodeAllocator()
+    {}
+
+    LIBEMBER_INLINE
+    ArenaNodeAllocator::ArenaNodeAllocator(std::size_t blockSize)
+        : m_blocks(0)
+        , m_position(0)
+        , m_available(0)
+        , m_blockSize(blockSize)
+        , m_allocatedBytes(0)
+    {}
+
+    LIBEMBER_INLINE
+    ArenaNodeAllocator::~ArenaNodeAllocator()
+    {
+        release();
+    }
+
+    LIBEMBER_INLINE
+    void* ArenaNodeAllocator::allocate(std::size_t size)
+    {
+        std::size_t const alignment = sizeof(Block);
+        std::size_t const alignedSize = ((size + alignment - 1) / alignment) * alignment;
+
+        if (alignedSize > m_available)
+        {
+            std::size_t const capacity = (alignedSize > m_blockSize) ? alignedSize : m_blockSize;
+            Block* const block = static_cast<Block*>(::operator new(sizeof(Block) + capacity));
+            block->next = m_blocks;
+            m_blocks = block;
+
+            if (capacity == m_blockSize || m_available == 0)
+            {
+                m_position = reinterpret_cast<unsigned char*>(block + 1);
+                m_available = capacity;
+            }
+            else
+            {
+                // Oversized requests get a block of their own, the current block remains in use.
+                m_allocatedBytes += alignedSize;
+                return block + 1;
+            }
+        }
+
+        void* const result = m_position;
+        m_position += alignedSize;
+        m_available -= alignedSize;
+        m_allocatedBytes += alignedSize;
+        return result;
+    }
+
+    LIBEMBER_INLINE
+    void ArenaNodeAllocator::deallocate(void*, std::size_t)
+    {}
+
+    LIBEMBER_INLINE
+    void ArenaNodeAllocator::release()
+    {
+        while (m_blocks != 0)
+        {
+            Block* const next = m_blocks->next;
+            ::operator delete(m_blocks);
+            m_blocks = next;
+        }
+
+        m_position = 0;
+        m_available = 0;
+        m_allocatedBytes = 0;
+    }
+
+    LIBEMBER_INLINE
+    std::size_t ArenaNodeAllocator::allocatedBytes() const
+    {
+        return m_allocatedBytes;
+    }
+}
+}
+
+#endif  // __LIBEMBER_DOM_IMPL_NODEALLOCATOR_IPP
+
@@ -30,6 +30,12 @@ namespace libember { namespace dom
     NodeFactory::~NodeFactory()
     {}
 
+    LIBEMBER_INLINE
+    Node* NodeFactory::createApplicationDefinedNode(ber::Type const& type, ber::Tag const& tag, NodeAllocator&) const
+    {
+        return createApplicationDefinedNode(type, tag);
+    }
+
     LIBEMBER_INLINE
     Node* NodeFactory::createSet(ber::Tag const& tag) const
     {
@@ -41,6 +47,18 @@ namespace libember { namespace dom
     {
         return new Sequence(tag);
     }
+
+    LIBEMBER_INLINE
+    Node* NodeFactory::createSet(ber::Tag const& tag, NodeAllocator& allocator) const
+    {
+        return new (allocator) Set(tag);
+    }
+
+    LIBEMBER_INLINE
+    Node* NodeFactory::createSequence(ber::Tag const& tag, NodeAllocator& allocator) const
+    {
+        return new (allocator) Sequence(tag);
+    }
 }
 }
 
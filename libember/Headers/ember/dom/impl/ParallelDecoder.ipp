@@ -0,0 +1,294 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef __LIBEMBER_DOM_IMPL_PARALLELDECODER_IPP
+#define __LIBEMBER_DOM_IMPL_PARALLELDECODER_IPP
+
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "../../util/Inline.hpp"
+#include "../AsyncDomReader.hpp"
+#include "../Container.hpp"
+#include "../Node.hpp"
+#include "../detail/EncodedHeader.hpp"
+#include "../detail/TaskList.hpp"
+
+namespace libember { namespace dom
+{
+    namespace detail
+    {
+        /**
+         * Decodes a range of top-level children, each with a reader of its own.
+         */
+        class DecodeRangeTask : public Task
+        {
+            public:
+                typedef decode_value_type const* const* boundary_iterator;
+
+                /**
+                 * Initializes a task that decodes the children whose boundaries
+                 * are stored in [first, last]. The child i ranges from first[i]
+                 * to first[i + 1].
+                 */
+                DecodeRangeTask(NodeFactory const& factory, boundary_iterator first, boundary_iterator last)
+                    : m_factory(factory)
+                    , m_first(first)
+                    , m_last(last)
+                    , m_failed(false)
+                {}
+
+                virtual ~DecodeRangeTask()
+                {
+                    for (std::vector<Node*>::size_type i = 0; i < m_nodes.size(); ++i)
+                    {
+                        delete m_nodes[i];
+                    }
+                }
+
+                virtual void run()
+                {
+                    try
+                    {
+                        AsyncDomReader reader(m_factory);
+                        m_nodes.reserve(m_last - m_first);
+
+                        for (boundary_iterator it = m_first; it != m_last; ++it)
+                        {
+                            reader.read(it[0], it[1]);
+                            if (reader.isRootReady() == false)
+                            {
+                                throw std::runtime_error("Incomplete child of the root container.");
+                            }
+
+                            m_nodes.push_back(reader.detachRoot());
+                        }
+                    }
+                    catch (std::exception const& e)
+                    {
+                        m_failed = true;
+                        m_error = e.what();
+                    }
+                    catch (...)
+                    {
+                        m_failed = true;
+                        m_error = "Unknown error while decoding a node.";
+                    }
+                }
+
+                bool failed() const
+                {
+                    return m_failed;
+                }
+
+                std::string const& error() const
+                {
+                    return m_error;
+                }
+
+                /**
+                 * Returns the decoded children. Entries set to 0 by the caller
+                 * are no longer owned by this task.
+                 */
+                std::vector<Node*>& nodes()
+                {
+                    return m_nodes;
+                }
+
+            private:
+                NodeFactory const& m_factory;
+                boundary_iterator m_first;
+                boundary_iterator m_last;
+                std::vector<Node*> m_nodes;
+                bool m_failed;
+                std::string m_error;
+        };
+    }
+
+    LIBEMBER_INLINE
+    ParallelDecoder::ParallelDecoder(NodeFactory const& factory, Executor& executor, std::size_t taskCount, std::size_t minimumBytes)
+        : m_factory(factory)
+        , m_executor(executor)
+        , m_taskCount(taskCount)
+        , m_minimumBytes(minimumBytes > 0 ? minimumBytes : 1)
+    {}
+
+    LIBEMBER_INLINE
+    ParallelDecoder::ParallelDecoder(NodeFactory const& factory, WorkStealingExecutor& executor, std::size_t minimumBytes)
+        : m_factory(factory)
+        , m_executor(executor)
+        , m_taskCount(executor.taskLimit())
+        , m_minimumBytes(minimumBytes > 0 ? minimumBytes : 1)
+    {}
+
+    LIBEMBER_INLINE
+    Node* ParallelDecoder::decode(value_type const* first, value_type const* last) const
+    {
+        std::size_t const maximumTasks = static_cast<std::size_t>(last - first) / m_minimumBytes;
+        if (maximumTasks < 2 || m_taskCount < 2)
+        {
+            return decodeSequential(first, last);
+        }
+
+        // First pass: the root consists of an application tag and a type tag, each
+        // followed by a length, and the children. Anything unexpected is left to
+        // the sequential decoder, which reports it the usual way.
+        detail::EncodedHeader outer;
+        detail::EncodedHeader inner;
+        if (detail::scanHeader(first, last, outer) == false || outer.constructed == false
+        ||  detail::scanHeader(outer.contents, last, inner) == false || inner.constructed == false)
+        {
+            return decodeSequential(first, last);
+        }
+
+        value_type const* const end = inner.indefinite ? last : inner.contents + inner.length;
+        std::vector<value_type const*> boundaries;
+        boundaries.reserve(1024);
+
+        value_type const* current = inner.contents;
+        boundaries.push_back(current);
+        while (current != end && (inner.indefinite == false || detail::isEndOfContents(current, end) == false))
+        {
+            // Only containers become roots of their own reader.
+            detail::EncodedHeader child;
+            detail::EncodedHeader type;
+            if (detail::scanHeader(current, end, child) == false || child.constructed == false
+            ||  detail::scanHeader(child.contents, end, type) == false || type.constructed == false)
+            {
+                return decodeSequential(first, last);
+            }
+
+            current = detail::skipElement(current, end);
+            if (current == 0)
+            {
+                return decodeSequential(first, last);
+            }
+
+            boundaries.push_back(current);
+        }
+
+        std::size_t const childCount = boundaries.size() - 1;
+        std::size_t const totalBytes = static_cast<std::size_t>(current - inner.contents);
+        std::size_t taskCount = maximumTasks < m_taskCount ? maximumTasks : m_taskCount;
+        taskCount = childCount < taskCount ? childCount : taskCount;
+
+        if (taskCount < 2)
+        {
+            return decodeSequential(first, last);
+        }
+
+        // The empty root is created from its own header, followed by an empty
+        // set of children.
+        std::size_t const shellLength = static_cast<std::size_t>(inner.tagEnd - outer.contents) + 1;
+        if (shellLength >= 0x80)
+        {
+            return decodeSequential(first, last);
+        }
+
+        std::vector<value_type> shell(first, outer.tagEnd);
+        shell.push_back(static_cast<value_type>(shellLength));
+        shell.insert(shell.end(), outer.contents, inner.tagEnd);
+        shell.push_back(0);
+
+        Node* const root = decodeSequential(&shell[0], &shell[0] + shell.size());
+        try
+        {
+            Container* const container = dynamic_cast<Container*>(root);
+            if (container == 0)
+            {
+                throw std::runtime_error("The root node is not a container.");
+            }
+
+            // Second pass: split the children into ranges of roughly equal size.
+            detail::TaskList<detail::DecodeRangeTask> tasks(taskCount);
+            std::vector<value_type const*>::size_type index = 0;
+            for (std::size_t i = 0; i < taskCount; ++i)
+            {
+                std::vector<value_type const*>::size_type const start = index;
+                value_type const* const limit = inner.contents + totalBytes / taskCount * (i + 1);
+                std::size_t const remainingTasks = taskCount - i - 1;
+
+                do
+                {
+                    ++index;
+                }
+                while (index + remainingTasks < childCount && (i + 1 == taskCount || boundaries[index] < limit));
+
+                tasks.add(new detail::DecodeRangeTask(m_factory, &boundaries[start], &boundaries[index]));
+            }
+
+            m_executor.execute(tasks.tasks(), tasks.size());
+
+            for (std::size_t i = 0; i < tasks.size(); ++i)
+            {
+                if (tasks[i].failed())
+                {
+                    throw std::runtime_error(tasks[i].error());
+                }
+            }
+
+            for (std::size_t i = 0; i < tasks.size(); ++i)
+            {
+                std::vector<Node*>& nodes = tasks[i].nodes();
+                for (std::vector<Node*>::size_type n = 0; n < nodes.size(); ++n)
+                {
+                    Node* const node = nodes[n];
+                    if (node != 0)
+                    {
+                        nodes[n] = 0;
+                        try
+                        {
+                            container->insert(container->end(), node);
+                        }
+                        catch (...)
+                        {
+                            delete node;
+                            throw;
+                        }
+                    }
+                }
+            }
+        }
+        catch (...)
+        {
+            delete root;
+            throw;
+        }
+
+        return root;
+    }
+
+    LIBEMBER_INLINE
+    Node* ParallelDecoder::decodeSequential(value_type const* first, value_type const* last) const
+    {
+        AsyncDomReader reader(m_factory);
+        reader.read(first, last);
+
+        if (reader.isRootReady() == false)
+        {
+            throw std::runtime_error("Incomplete root node.");
+        }
+
+        return reader.detachRoot();
+    }
+}
+}
+
+#endif  // __LIBEMBER_DOM_IMPL_PARALLELDECODER_IPP
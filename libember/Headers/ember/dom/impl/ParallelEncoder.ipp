@@ -0,0 +1,175 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef __LIBEMBER_DOM_IMPL_PARALLELENCODER_IPP
+#define __LIBEMBER_DOM_IMPL_PARALLELENCODER_IPP
+
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "../../util/Inline.hpp"
+#include "../../util/ContiguousOctetStream.hpp"
+#include "../../ber/Encoding.hpp"
+#include "../detail/ListContainer.hpp"
+#include "../detail/TaskList.hpp"
+
+namespace libember { namespace dom
+{
+    namespace detail
+    {
+        /**
+         * Encodes a range of children into a buffer of its own.
+         */
+        class EncodeRangeTask : public Task
+        {
+            public:
+                typedef ListContainer::const_child_iterator const_child_iterator;
+
+                EncodeRangeTask(const_child_iterator first, const_child_iterator last)
+                    : m_first(first)
+                    , m_last(last)
+                    , m_failed(false)
+                {}
+
+                virtual void run()
+                {
+                    try
+                    {
+                        for (const_child_iterator it = m_first; it != m_last; ++it)
+                        {
+                            it->encode(m_output);
+                        }
+                    }
+                    catch (std::exception const& e)
+                    {
+                        m_failed = true;
+                        m_error = e.what();
+                    }
+                    catch (...)
+                    {
+                        m_failed = true;
+                        m_error = "Unknown error while encoding a node.";
+                    }
+                }
+
+                bool failed() const
+                {
+                    return m_failed;
+                }
+
+                std::string const& error() const
+                {
+                    return m_error;
+                }
+
+                util::ContiguousOctetStream& output()
+                {
+                    return m_output;
+                }
+
+            private:
+                const_child_iterator m_first;
+                const_child_iterator m_last;
+                util::ContiguousOctetStream m_output;
+                bool m_failed;
+                std::string m_error;
+        };
+    }
+
+    LIBEMBER_INLINE
+    ParallelEncoder::ParallelEncoder(Executor& executor, std::size_t taskCount, std::size_t minimumChildren)
+        : m_executor(executor)
+        , m_taskCount(taskCount)
+        , m_minimumChildren(minimumChildren > 0 ? minimumChildren : 1)
+    {}
+
+    LIBEMBER_INLINE
+    ParallelEncoder::ParallelEncoder(WorkStealingExecutor& executor, std::size_t minimumChildren)
+        : m_executor(executor)
+        , m_taskCount(executor.taskLimit())
+        , m_minimumChildren(minimumChildren > 0 ? minimumChildren : 1)
+    {}
+
+    LIBEMBER_INLINE
+    void ParallelEncoder::encode(detail::ListContainer const& container, util::OctetStream& output) const
+    {
+        typedef detail::ListContainer::const_child_iterator const_child_iterator;
+
+        const_child_iterator const first = container.childBegin();
+        std::size_t const childCount = container.size();
+        std::size_t const maximumTasks = childCount / m_minimumChildren;
+        std::size_t const taskCount = maximumTasks < m_taskCount ? maximumTasks : m_taskCount;
+
+        if (taskCount < 2)
+        {
+            container.encode(output);
+            return;
+        }
+
+        detail::TaskList<detail::EncodeRangeTask> tasks(taskCount);
+        const_child_iterator current = first;
+        for (std::size_t i = 0; i < taskCount; ++i)
+        {
+            // Distributes the remainder over the first tasks.
+            std::size_t const count = childCount / taskCount + (i < childCount % taskCount ? 1 : 0);
+            const_child_iterator next = current;
+            for (std::size_t n = 0; n < count; ++n)
+            {
+                ++next;
+            }
+
+            tasks.add(new detail::EncodeRangeTask(current, next));
+            current = next;
+        }
+
+        m_executor.execute(tasks.tasks(), tasks.size());
+
+        std::size_t payloadLength = 0;
+        for (std::size_t i = 0; i < tasks.size(); ++i)
+        {
+            if (tasks[i].failed())
+            {
+                throw std::runtime_error(tasks[i].error());
+            }
+
+            payloadLength += tasks[i].output().size();
+        }
+
+        ber::Tag const innerContainerTag = container.typeTag().toContainer();
+        std::size_t const innerTagLength = ber::encodedLength(innerContainerTag);
+        std::size_t const innerLength    = innerTagLength + ber::encodedLength(ber::make_length(payloadLength)) + payloadLength;
+
+        ber::encode(output, container.applicationTag().toContainer());
+        ber::encode(output, ber::make_length(innerLength));
+
+        ber::encode(output, innerContainerTag);
+        ber::encode(output, ber::make_length(payloadLength));
+
+        for (std::size_t i = 0; i < tasks.size(); ++i)
+        {
+            util::ContiguousOctetStream& encoded = tasks[i].output();
+            util::ContiguousOctetStream::const_pointer const data = encoded.data();
+            output.append(data, data + encoded.size());
+        }
+    }
+}
+}
+
+#endif  // __LIBEMBER_DOM_IMPL_PARALLELENCODER_IPP
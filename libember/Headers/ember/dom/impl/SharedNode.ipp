@@ -0,0 +1,162 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef __LIBEMBER_DOM_IMPL_SHAREDNODE_IPP
+#define __LIBEMBER_DOM_IMPL_SHAREDNODE_IPP
+
+#include <stdexcept>
+#include "../../util/Inline.hpp"
+
+namespace libember { namespace dom
+{
+    LIBEMBER_INLINE
+    SharedNode::Storage::Storage(Node* node)
+        : m_node(node), m_refCount(1)
+    {}
+
+    LIBEMBER_INLINE
+    SharedNode::Storage::~Storage()
+    {
+        delete m_node;
+    }
+
+    LIBEMBER_INLINE
+    SharedNode::Storage* SharedNode::Storage::addRef()
+    {
+        m_refCount += 1;
+        return this;
+    }
+
+    LIBEMBER_INLINE
+    void SharedNode::Storage::releaseRef()
+    {
+        m_refCount -= 1;
+        if (m_refCount == 0)
+        {
+            delete this;
+        }
+    }
+
+    LIBEMBER_INLINE
+    Node const* SharedNode::Storage::node() const
+    {
+        return m_node;
+    }
+
+    LIBEMBER_INLINE
+    std::size_t SharedNode::Storage::refCount() const
+    {
+        return m_refCount;
+    }
+
+    LIBEMBER_INLINE
+    SharedNode::SharedNode(Node* node)
+        : Node(validate(node)->applicationTag()), m_storage(0)
+    {
+        try
+        {
+            m_storage = new Storage(node);
+        }
+        catch (...)
+        {
+            delete node;
+            throw;
+        }
+    }
+
+    LIBEMBER_INLINE
+    SharedNode::SharedNode(SharedNode const& other)
+        : Node(other), m_storage(other.m_storage->addRef())
+    {}
+
+    LIBEMBER_INLINE
+    SharedNode::~SharedNode()
+    {
+        m_storage->releaseRef();
+    }
+
+    LIBEMBER_INLINE
+    SharedNode* SharedNode::clone() const
+    {
+        return new SharedNode(*this);
+    }
+
+    LIBEMBER_INLINE
+    Node const* SharedNode::get() const
+    {
+        return m_storage->node();
+    }
+
+    LIBEMBER_INLINE
+    Node* SharedNode::copy() const
+    {
+        return m_storage->node()->clone();
+    }
+
+    LIBEMBER_INLINE
+    std::size_t SharedNode::useCount() const
+    {
+        return m_storage->refCount();
+    }
+
+    LIBEMBER_INLINE
+    ber::Tag SharedNode::typeTagImpl() const
+    {
+        return m_storage->node()->typeTag();
+    }
+
+    LIBEMBER_INLINE
+    void SharedNode::updateImpl() const
+    {
+        m_storage->node()->update();
+    }
+
+    LIBEMBER_INLINE
+    void SharedNode::encodeImpl(util::OctetStream& output) const
+    {
+        m_storage->node()->encode(output);
+    }
+
+    LIBEMBER_INLINE
+    void SharedNode::encodeIndefiniteImpl(util::OctetStream& output) const
+    {
+        m_storage->node()->encodeIndefinite(output);
+    }
+
+    LIBEMBER_INLINE
+    std::size_t SharedNode::encodedLengthImpl() const
+    {
+        return m_storage->node()->encodedLength();
+    }
+
+    LIBEMBER_INLINE
+    Node* SharedNode::validate(Node* node)
+    {
+        if (node == 0)
+            throw std::runtime_error("Attempt to share a null node.");
+
+        if (node->parent() != 0)
+            throw std::runtime_error("Attempt to share a node owned by a container node.");
+
+        return node;
+    }
+}
+}
+
+#endif  // __LIBEMBER_DOM_IMPL_SHAREDNODE_IPP
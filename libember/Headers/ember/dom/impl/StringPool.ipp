@@ -0,0 +1,86 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef __LIBEMBER_DOM_IMPL_STRINGPOOL_IPP
+#define __LIBEMBER_DOM_IMPL_STRINGPOOL_IPP
+
+#include "../../util/Inline.hpp"
+#include "../../ber/Encoding.hpp"
+
+namespace libember { namespace dom
+{
+    LIBEMBER_INLINE
+    StringPool::StringPool(size_type maximumLength)
+        : m_maximumLength(maximumLength)
+    {}
+
+    LIBEMBER_INLINE
+    ber::Value StringPool::intern(std::string const& value)
+    {
+        if (value.size() > m_maximumLength)
+        {
+            return ber::Value(value);
+        }
+
+        size_type const key = hash(value);
+        std::pair<ValueMap::const_iterator, ValueMap::const_iterator> const range = m_values.equal_range(key);
+        for (ValueMap::const_iterator it = range.first; it != range.second; ++it)
+        {
+            std::string const* const entry = it->second.peek<std::string>();
+            if (entry != 0 && *entry == value)
+            {
+                return it->second;
+            }
+        }
+
+        return m_values.insert(std::make_pair(key, ber::Value(value)))->second;
+    }
+
+    LIBEMBER_INLINE
+    StringPool::size_type StringPool::maximumLength() const
+    {
+        return m_maximumLength;
+    }
+
+    LIBEMBER_INLINE
+    StringPool::size_type StringPool::size() const
+    {
+        return m_values.size();
+    }
+
+    LIBEMBER_INLINE
+    void StringPool::clear()
+    {
+        m_values.clear();
+    }
+
+    LIBEMBER_INLINE
+    StringPool::size_type StringPool::hash(std::string const& value)
+    {
+        size_type result = 2166136261U;
+        for (std::string::const_iterator it = value.begin(); it != value.end(); ++it)
+        {
+            result = (result ^ static_cast<unsigned char>(*it)) * 16777619U;
+        }
+        return result;
+    }
+}
+}
+
+#endif  // __LIBEMBER_DOM_IMPL_STRINGPOOL_IPP
@@ -20,24 +20,33 @@
 #ifndef __LIBEMBER_DOM_IMPL_VARIANTLEAF_IPP
 #define __LIBEMBER_DOM_IMPL_VARIANTLEAF_IPP
 
+#include <string>
 #include "../../util/Inline.hpp"
 #include "../../ber/Encoding.hpp"
+#include "../../ber/Octets.hpp"
 
 namespace libember { namespace dom
 {
     LIBEMBER_INLINE
     VariantLeaf::VariantLeaf(ber::Tag tag)
-        : Node(tag), m_value(), m_cachedLength(0)
+        : Node(tag), m_value(), m_encoded(), m_encodedTypeTag(), m_cachedLength(0)
     {}
 
     LIBEMBER_INLINE
     VariantLeaf::VariantLeaf(ber::Tag tag, ber::Value value)
-        : Node(tag), m_value(value), m_cachedLength(0)
+        : Node(tag), m_value(value), m_encoded(), m_encodedTypeTag(), m_cachedLength(0)
+    {}
+
+    LIBEMBER_INLINE
+    VariantLeaf::VariantLeaf(ber::Tag tag, ber::Tag typeTag, util::OctetSlice encoded)
+        : Node(tag), m_value(), m_encoded(encoded), m_encodedTypeTag(typeTag), m_cachedLength(0)
     {}
 
     LIBEMBER_INLINE
     VariantLeaf::VariantLeaf(VariantLeaf const& other)
-        : Node(static_cast<Node const&>(other)), m_value(other.m_value),
+        : Node(static_cast<Node const&>(other)),
+            util::InstanceCounter<util::Instrumentation::VariantLeaf>(other), m_value(other.m_value),
+            m_encoded(other.m_encoded), m_encodedTypeTag(other.m_encodedTypeTag),
             m_cachedLength(0)
     {}
 
@@ -50,19 +59,67 @@ namespace libember { namespace dom
     LIBEMBER_INLINE
     ber::Value VariantLeaf::value() const
     {
+        decodeEncodedValue();
         return m_value;
     }
 
+    LIBEMBER_INLINE
+    ber::OctetsView VariantLeaf::octets() const
+    {
+        if (m_encoded.empty() == false)
+        {
+            return (m_encodedTypeTag.number() == ber::Type::OctetString)
+                ? ber::OctetsView(m_encoded.begin(), m_encoded.end())
+                : ber::OctetsView();
+        }
+
+        if (ber::Octets const* const octets = m_value.peek<ber::Octets>())
+            return ber::OctetsView(*octets);
+
+        if (ber::OctetsView const* const view = m_value.peek<ber::OctetsView>())
+            return *view;
+
+        return ber::OctetsView();
+    }
+
+    LIBEMBER_INLINE
+    util::OctetSlice const& VariantLeaf::encodedValue() const
+    {
+        return m_encoded;
+    }
+
     LIBEMBER_INLINE
     void VariantLeaf::setValue(ber::Value value)
     {
+        util::OctetSlice().swap(m_encoded);
         m_value.swap(value);
         markDirty();
     }
 
+    LIBEMBER_INLINE
+    void VariantLeaf::decodeEncodedValue() const
+    {
+        if (m_encoded.empty() == false)
+        {
+            if (m_encodedTypeTag.number() == ber::Type::OctetString)
+            {
+                ber::Value(ber::Octets(m_encoded.begin(), m_encoded.end())).swap(m_value);
+            }
+            else
+            {
+                ber::Value(std::string(m_encoded.begin(), m_encoded.end())).swap(m_value);
+            }
+
+            util::OctetSlice().swap(m_encoded);
+        }
+    }
+
     LIBEMBER_INLINE
     ber::Tag VariantLeaf::typeTagImpl() const
     {
+        if (m_encoded.empty() == false)
+            return m_encodedTypeTag;
+
         return m_value.universalTag();
     }
 
@@ -70,7 +127,7 @@ namespace libember { namespace dom
     void VariantLeaf::updateImpl() const
     {
         std::size_t const innerTagLength = ber::encodedLength(typeTag());
-        std::size_t const payloadLength  = m_value.encodedLength();
+        std::size_t const payloadLength  = m_encoded.empty() ? m_value.encodedLength() : m_encoded.size();
         std::size_t const innerLength    = innerTagLength + ber::encodedLength(ber::make_length(payloadLength)) + payloadLength;
 
         std::size_t const outerTagLength = ber::encodedLength(applicationTag().toContainer());
@@ -84,7 +141,7 @@ namespace libember { namespace dom
     {
         ber::Tag const innerTag = typeTag();
         std::size_t const innerTagLength = ber::encodedLength(innerTag);
-        std::size_t const payloadLength  = m_value.encodedLength();
+        std::size_t const payloadLength  = m_encoded.empty() ? m_value.encodedLength() : m_encoded.size();
         std::size_t const innerLength    = innerTagLength + ber::encodedLength(ber::make_length(payloadLength)) + payloadLength;
         
         // Encode the outer frame (as a container)
@@ -95,8 +152,11 @@ namespace libember { namespace dom
         ber::encode(output, innerTag);
         ber::encode(output, ber::make_length(payloadLength));
 
-        // Encode the value
-        m_value.encode(output);
+        // Encode the value, an encoded payload that has not been accessed is copied unchanged
+        if (m_encoded.empty() == false)
+            output.append(m_encoded.begin(), m_encoded.end());
+        else
+            m_value.encode(output);
     }
 
     LIBEMBER_INLINE
@@ -0,0 +1,225 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef __LIBEMBER_DOM_IMPL_WORKSTEALINGEXECUTOR_IPP
+#define __LIBEMBER_DOM_IMPL_WORKSTEALINGEXECUTOR_IPP
+
+#include <vector>
+#include "../../util/Inline.hpp"
+#include "../detail/TaskList.hpp"
+
+#if defined(_MSC_VER)
+#  include <intrin.h>
+#  define LIBEMBER_WORKSTEALING_ATOMICS
+#elif defined(__GNUC__)
+#  define LIBEMBER_WORKSTEALING_ATOMICS
+#endif
+
+namespace libember { namespace dom
+{
+    namespace detail
+    {
+        /**
+         * A range of task indices, packed into a single 64 bit word so that it can
+         * be updated with a single compare and swap. The first index is stored in
+         * the upper half, the end index in the lower half.
+         */
+        typedef long long packed_range_type;
+
+        inline packed_range_type packRange(std::size_t first, std::size_t last)
+        {
+            return static_cast<packed_range_type>((static_cast<unsigned long long>(first) << 32) | static_cast<unsigned long long>(last));
+        }
+
+        inline std::size_t rangeFirst(packed_range_type range)
+        {
+            return static_cast<std::size_t>(static_cast<unsigned long long>(range) >> 32);
+        }
+
+        inline std::size_t rangeLast(packed_range_type range)
+        {
+            return static_cast<std::size_t>(static_cast<unsigned long long>(range) & 0xFFFFFFFFULL);
+        }
+
+        /**
+         * Atomically replaces @p target with @p value if it equals @p expected.
+         * @return The value @p target had before.
+         */
+        inline packed_range_type compareAndSwap(packed_range_type volatile& target, packed_range_type expected, packed_range_type value)
+        {
+#if defined(_MSC_VER)
+            return _InterlockedCompareExchange64(&target, value, expected);
+#elif defined(__GNUC__)
+            return __sync_val_compare_and_swap(&target, expected, value);
+#else
+            packed_range_type const previous = target;
+            if (previous == expected)
+            {
+                target = value;
+            }
+            return previous;
+#endif
+        }
+
+        /**
+         * Atomically reads @p target, which may not be read with a single
+         * instruction on 32 bit platforms.
+         */
+        inline packed_range_type atomicLoad(packed_range_type volatile& target)
+        {
+            return compareAndSwap(target, 0, 0);
+        }
+
+        /**
+         * A worker of a single call to WorkStealingExecutor::execute(). It runs the tasks
+         * of its own range and steals from the other workers once its range is empty.
+         */
+        class StealingWorker : public Task
+        {
+            public:
+                StealingWorker(Task* const* tasks, std::vector<StealingWorker*> const& workers, std::size_t index, std::size_t first, std::size_t last)
+                    : m_tasks(tasks)
+                    , m_workers(workers)
+                    , m_index(index)
+                    , m_range(packRange(first, last))
+                {}
+
+                virtual void run()
+                {
+                    std::size_t task;
+                    while (pop(task) || steal(task))
+                    {
+                        m_tasks[task]->run();
+                    }
+                }
+
+            private:
+                /**
+                 * Takes the first task of the own range.
+                 */
+                bool pop(std::size_t& task)
+                {
+                    for (;;)
+                    {
+                        packed_range_type const range = atomicLoad(m_range);
+                        std::size_t const first = rangeFirst(range);
+                        std::size_t const last = rangeLast(range);
+                        if (first >= last)
+                        {
+                            return false;
+                        }
+
+                        if (compareAndSwap(m_range, range, packRange(first + 1, last)) == range)
+                        {
+                            task = first;
+                            return true;
+                        }
+                    }
+                }
+
+                /**
+                 * Takes the back half of the range of another worker, keeps its first
+                 * task to be run next and makes the rest of it the own range.
+                 */
+                bool steal(std::size_t& task)
+                {
+                    std::size_t const count = m_workers.size();
+                    for (std::size_t offset = 1; offset < count; ++offset)
+                    {
+                        StealingWorker& victim = *m_workers[(m_index + offset) % count];
+                        for (;;)
+                        {
+                            packed_range_type const range = atomicLoad(victim.m_range);
+                            std::size_t const first = rangeFirst(range);
+                            std::size_t const last = rangeLast(range);
+                            if (first >= last)
+                            {
+                                break;
+                            }
+
+                            std::size_t const stolen = (last - first + 1) / 2;
+                            if (compareAndSwap(victim.m_range, range, packRange(first, last - stolen)) == range)
+                            {
+                                // The own range is empty, so only thieves may access it
+                                // concurrently, and they do not modify empty ranges.
+                                packed_range_type const empty = atomicLoad(m_range);
+                                compareAndSwap(m_range, empty, packRange(last - stolen + 1, last));
+                                task = last - stolen;
+                                return true;
+                            }
+                        }
+                    }
+
+                    return false;
+                }
+
+            private:
+                Task* const* m_tasks;
+                std::vector<StealingWorker*> const& m_workers;
+                std::size_t m_index;
+                packed_range_type volatile m_range;
+        };
+    }
+
+    LIBEMBER_INLINE
+    WorkStealingExecutor::WorkStealingExecutor(Executor& threads, std::size_t workerCount)
+        : m_threads(threads)
+        , m_workerCount(workerCount > 0 ? workerCount : 1)
+    {}
+
+    LIBEMBER_INLINE
+    void WorkStealingExecutor::execute(Task* const* tasks, std::size_t count)
+    {
+        std::size_t const workerCount = count < m_workerCount ? count : m_workerCount;
+
+#ifdef LIBEMBER_WORKSTEALING_ATOMICS
+        // The task indices are packed into 32 bits each.
+        if (workerCount >= 2 && static_cast<unsigned long long>(count) <= 0xFFFFFFFFULL)
+        {
+            std::vector<detail::StealingWorker*> workers;
+            detail::TaskList<detail::StealingWorker> list(workerCount);
+
+            workers.reserve(workerCount);
+            std::size_t first = 0;
+            for (std::size_t i = 0; i < workerCount; ++i)
+            {
+                // Distributes the remainder over the first workers.
+                std::size_t const last = first + count / workerCount + (i < count % workerCount ? 1 : 0);
+                detail::StealingWorker* const worker = new detail::StealingWorker(tasks, workers, i, first, last);
+                list.add(worker);
+                workers.push_back(worker);
+                first = last;
+            }
+
+            m_threads.execute(list.tasks(), list.size());
+            return;
+        }
+#endif
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            tasks[i]->run();
+        }
+    }
+}
+}
+
+#undef LIBEMBER_WORKSTEALING_ATOMICS
+
+#endif  // __LIBEMBER_DOM_IMPL_WORKSTEALINGEXECUTOR_IPP
@@ -63,7 +63,30 @@ namespace libember { namespace glow
                  * The command number for an invocation request. This command
                  * is used let the provider execute a function.
                  */
-                Invoke = 33
+                Invoke = 33,
+
+                /**
+                 * The command number for a recursive GetDirectory command. This
+                 * command is an extension of Glow, which queries all descendants
+                 * of a node at once. A provider supporting it reports the elements
+                 * as qualified elements, in the order of a depth-first walk.
+                 * Other providers ignore it, so a consumer should fall back to
+                 * GetDirectory if no response arrives.
+                 */
+                GetDirectoryRecursive = 132,
+
+                /**
+                 * The command number for a resync request. This command is an
+                 * extension of Glow, which lets a reconnecting consumer query the
+                 * elements that have changed since the sequence number it presents.
+                 * A provider supporting it replies with the changed elements as
+                 * qualified elements, followed by a command of this type carrying
+                 * its current sequence number. If the provider no longer knows all
+                 * changes, the reply carries no sequence number and the consumer
+                 * has to query the tree again. A request without a sequence number
+                 * only queries the current sequence number.
+                 */
+                GetChangesSince = 133
             };
 
             typedef int value_type;
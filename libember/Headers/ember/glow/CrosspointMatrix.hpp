@@ -0,0 +1,277 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef __LIBEMBER_GLOW_CROSSPOINTMATRIX_HPP
+#define __LIBEMBER_GLOW_CROSSPOINTMATRIX_HPP
+
+#include <vector>
+#include "../ber/ObjectIdentifier.hpp"
+#include "../util/Api.hpp"
+#include "ConnectionOperation.hpp"
+
+namespace libember { namespace glow
+{
+    /** Forward declarations */
+    class GlowConnection;
+    class GlowConnectionTable;
+
+    /**
+     * The routing state of a linear matrix as seen by a consumer. Each target has a
+     * row of bits, one per source, and the crosspoints are additionally listed per
+     * target and per source. Connections reported by the provider are applied
+     * incrementally, according to their operation, so that only the crosspoints that
+     * actually change are touched. Whether a crosspoint is connected, the sources
+     * of a target and the targets a source is routed to are all answered without
+     * searching, which is what tally systems need when a source goes on air.
+     * Targets and sources are addressed by their numbers, which must be less than
+     * the counts passed to the constructor or reset(). Numbers outside of this range
+     * are ignored.
+     */
+    class LIBEMBER_API CrosspointMatrix
+    {
+        public:
+            typedef std::size_t size_type;
+            typedef std::vector<int> SignalCollection;
+
+            /**
+             * Interface notified about every crosspoint that changes.
+             */
+            class LIBEMBER_API Listener
+            {
+                public:
+                    /** Destructor */
+                    virtual ~Listener();
+
+                    /**
+                     * Called after a crosspoint has been connected or disconnected. The
+                     * matrix already reflects the change, so sources() and targets() may
+                     * be queried, but further crosspoints changed by the same connection
+                     * may not have been applied yet.
+                     * @param target The number of the target.
+                     * @param source The number of the source.
+                     * @param isConnected True if the crosspoint has been connected, false
+                     *      if it has been disconnected.
+                     */
+                    virtual void crosspointChanged(int target, int source, bool isConnected) = 0;
+            };
+
+        public:
+            /**
+             * Initializes a matrix with all crosspoints disconnected.
+             * @param targetCount The number of targets of the matrix.
+             * @param sourceCount The number of sources of the matrix.
+             * @param listener The listener to notify about changed crosspoints, or null.
+             *      The matrix does not take ownership.
+             */
+            CrosspointMatrix(int targetCount, int sourceCount, Listener* listener = 0);
+
+            /**
+             * Changes the dimensions of the matrix and disconnects all crosspoints,
+             * without notifying the listener. Used when the provider reports a different
+             * number of targets or sources.
+             * @param targetCount The new number of targets.
+             * @param sourceCount The new number of sources.
+             */
+            void reset(int targetCount, int sourceCount);
+
+            /**
+             * Returns the number of targets of the matrix.
+             * @return The number of targets.
+             */
+            int targetCount() const;
+
+            /**
+             * Returns the number of sources of the matrix.
+             * @return The number of sources.
+             */
+            int sourceCount() const;
+
+            /**
+             * Returns whether a source is connected to a target.
+             * @param target The number of the target.
+             * @param source The number of the source.
+             * @return True if the crosspoint is connected, false if not or if either
+             *      number is out of range.
+             */
+            bool isConnected(int target, int source) const;
+
+            /**
+             * Returns the sources connected to a target, in the order they have been
+             * connected.
+             * @param target The number of the target.
+             * @return The numbers of the connected sources, which is empty if the target
+             *      number is out of range.
+             */
+            SignalCollection const& sources(int target) const;
+
+            /**
+             * Returns the targets a source is connected to, in the order they have been
+             * connected.
+             * @param source The number of the source.
+             * @return The numbers of the targets, which is empty if the source number
+             *      is out of range.
+             */
+            SignalCollection const& targets(int source) const;
+
+            /**
+             * Returns whether at least one target is connected to a source.
+             * @param source The number of the source.
+             * @return True if the source is in use.
+             */
+            bool isSourceUsed(int source) const;
+
+            /**
+             * Connects or disconnects a single crosspoint, e.g. when the routing has been
+             * changed locally.
+             * @param target The number of the target.
+             * @param source The number of the source.
+             * @param isConnected True to connect, false to disconnect the crosspoint.
+             * @return True if the crosspoint has changed.
+             */
+            bool set(int target, int source, bool isConnected);
+
+            /**
+             * Applies the sources of a connection to a target. An absolute connection
+             * replaces the sources of the target, connect adds the sources and disconnect
+             * removes them.
+             * @param target The number of the target.
+             * @param first Pointer to the first source number.
+             * @param last Pointer to the source number one past the last.
+             * @param operation The operation of the connection.
+             * @return The number of crosspoints that have changed.
+             */
+            size_type apply(int target, int const* first, int const* last, ConnectionOperation const& operation);
+
+            /**
+             * Applies the sources of a connection reported by a GlowReader.
+             * @param target The number of the target.
+             * @param sources The numbers of the sources.
+             * @param operation The operation of the connection.
+             * @return The number of crosspoints that have changed.
+             */
+            size_type apply(int target, ber::ObjectIdentifier const& sources, ConnectionOperation const& operation);
+
+            /**
+             * Applies a connection contained in a matrix notification.
+             * @param connection The connection to apply.
+             * @return The number of crosspoints that have changed.
+             */
+            size_type apply(GlowConnection const& connection);
+
+            /**
+             * Applies all connections of a table, in the order they are stored.
+             * @param table The connections to apply.
+             * @return The number of crosspoints that have changed.
+             */
+            size_type apply(GlowConnectionTable const& table);
+
+        private:
+            typedef unsigned long word_type;
+
+            /**
+             * Returns whether a target or source number is within the range of the matrix.
+             */
+            bool contains(int target, int source) const;
+
+            /**
+             * Removes the first occurrence of a number from a collection, keeping the
+             * order of the remaining numbers.
+             */
+            static void erase(SignalCollection& signals, int number);
+
+            /** Prohibit copying */
+            CrosspointMatrix(CrosspointMatrix const&);
+
+            /** Prohibit assignment */
+            CrosspointMatrix& operator=(CrosspointMatrix const&);
+
+        private:
+            int m_targetCount;
+            int m_sourceCount;
+            size_type m_rowWords;
+            Listener* m_listener;
+#ifdef _MSC_VER
+#  pragma warning(push)
+#  pragma warning(disable : 4251)
+#endif
+            std::vector<word_type> m_bits;
+            std::vector<SignalCollection> m_sources;
+            std::vector<SignalCollection> m_targets;
+            SignalCollection m_request;
+            SignalCollection m_previous;
+            SignalCollection const m_empty;
+#ifdef _MSC_VER
+#  pragma warning(pop)
+#endif
+    };
+
+    /**************************************************************************
+     * Mandatory inline implementation                                        *
+     **************************************************************************/
+
+    inline int CrosspointMatrix::targetCount() const
+    {
+        return m_targetCount;
+    }
+
+    inline int CrosspointMatrix::sourceCount() const
+    {
+        return m_sourceCount;
+    }
+
+    inline bool CrosspointMatrix::contains(int target, int source) const
+    {
+        return target >= 0 && target < m_targetCount && source >= 0 && source < m_sourceCount;
+    }
+
+    inline bool CrosspointMatrix::isConnected(int target, int source) const
+    {
+        if (contains(target, source) == false)
+        {
+            return false;
+        }
+
+        size_type const bits = sizeof(word_type) * 8;
+        size_type const index = static_cast<size_type>(source);
+        word_type const word = m_bits[static_cast<size_type>(target) * m_rowWords + index / bits];
+        return (word & (word_type(1) << (index % bits))) != 0;
+    }
+
+    inline CrosspointMatrix::SignalCollection const& CrosspointMatrix::sources(int target) const
+    {
+        return target >= 0 && target < m_targetCount ? m_sources[target] : m_empty;
+    }
+
+    inline CrosspointMatrix::SignalCollection const& CrosspointMatrix::targets(int source) const
+    {
+        return source >= 0 && source < m_sourceCount ? m_targets[source] : m_empty;
+    }
+
+    inline bool CrosspointMatrix::isSourceUsed(int source) const
+    {
+        return targets(source).empty() == false;
+    }
+}
+}
+
+#ifdef LIBEMBER_HEADER_ONLY
+#  include "impl/CrosspointMatrix.ipp"
+#endif
+
+#endif  // __LIBEMBER_GLOW_CROSSPOINTMATRIX_HPP
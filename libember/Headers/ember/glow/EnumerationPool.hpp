@@ -0,0 +1,246 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef __LIBEMBER_GLOW_ENUMERATIONPOOL_HPP
+#define __LIBEMBER_GLOW_ENUMERATIONPOOL_HPP
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#include "../util/Api.hpp"
+#include "Enumeration.hpp"
+
+namespace libember { namespace glow
+{
+    /**
+     * Stores each distinct enumeration of a tree only once. Parameters usually share a small
+     * number of option lists, so the pool parses an enumeration string when it is interned
+     * for the first time and returns the same table for all later occurrences of the string.
+     * The entries of a table refer to the names within a single copy of the enumeration
+     * string, no string is allocated per entry. Tables are found by the hash of their text,
+     * and since each distinct enumeration exists only once, two tables of the same pool are
+     * equal if and only if their pointers are equal.
+     */
+    class LIBEMBER_API EnumerationPool
+    {
+        public:
+            typedef std::size_t size_type;
+
+            /**
+             * An immutable enumeration, which remains valid until the pool is cleared
+             * or destroyed.
+             */
+            class LIBEMBER_API Table
+            {
+                friend class EnumerationPool;
+                public:
+                    /**
+                     * A single entry, whose name refers to the text of the table.
+                     */
+                    struct Entry
+                    {
+                        /**
+                         * Returns a copy of the name.
+                         * @return A copy of the name.
+                         */
+                        std::string name() const;
+
+                        /** Points to the first character of the name, which is not terminated. */
+                        char const* first;
+
+                        /** The number of characters of the name. */
+                        size_type length;
+
+                        /** The value or index of the entry. */
+                        int value;
+                    };
+
+                    typedef std::vector<Entry> EntryCollection;
+                    typedef EntryCollection::const_iterator const_iterator;
+
+                public:
+                    /**
+                     * Returns the number of entries.
+                     * @return The number of entries.
+                     */
+                    size_type size() const;
+
+                    /**
+                     * Returns an iterator to the first entry.
+                     * @return An iterator to the first entry.
+                     */
+                    const_iterator begin() const;
+
+                    /**
+                     * Returns an iterator pointing to the first entry beyond the table.
+                     * @return An iterator pointing to the first entry beyond the table.
+                     */
+                    const_iterator end() const;
+
+                    /**
+                     * Returns the entry at the specified index.
+                     * @param index The index of the entry to return.
+                     * @return The entry at the specified index.
+                     */
+                    Entry const& operator[](size_type index) const;
+
+                    /**
+                     * Looks up the entry with the passed value. The entries of an enumeration
+                     * string are found by their index, those of an enumeration map by a
+                     * binary search, so the cost does not grow linearly with large maps.
+                     * @param value The value of the entry to find.
+                     * @return The entry, or null if the table does not contain the value. If
+                     *      several entries share the value, the first one is returned.
+                     */
+                    Entry const* find(int value) const;
+
+                    /**
+                     * Looks up the entry with the passed name, using the hashes of the names.
+                     * @param name The name of the entry to find.
+                     * @return The entry, or null if the table does not contain the name. If
+                     *      several entries share the name, the first one is returned.
+                     */
+                    Entry const* find(std::string const& name) const;
+
+                    /**
+                     * Returns the names of all entries, separated by '\n'.
+                     * @return The names of all entries.
+                     */
+                    std::string const& text() const;
+
+                private:
+                    /**
+                     * Initializes a table with the entries of a newline separated enumeration
+                     * string, whose values are their indices.
+                     */
+                    explicit Table(std::string const& text);
+
+                    /**
+                     * Initializes a table with the name-value pairs of an enumeration map.
+                     */
+                    explicit Table(Enumeration const& enumeration);
+
+                    /**
+                     * Tests whether this table contains the passed name-value pairs.
+                     */
+                    bool isEqual(Enumeration const& enumeration) const;
+
+                    /**
+                     * Sorts the entries by their values, unless they are indexed, and by the
+                     * hashes of their names. Called once the entries are complete.
+                     */
+                    void buildIndices();
+
+                    /** Prohibits copying, since the entries refer to the own text. */
+                    Table(Table const&);
+                    Table& operator=(Table const&);
+
+                private:
+#ifdef _MSC_VER
+#  pragma warning(push)
+#  pragma warning(disable : 4251)
+#endif
+                    std::string m_text;
+                    EntryCollection m_entries;
+                    std::vector<std::pair<int, size_type> > m_values;
+                    std::vector<std::pair<size_type, size_type> > m_names;
+#ifdef _MSC_VER
+#  pragma warning(pop)
+#endif
+                    bool m_isIndexed;
+            };
+
+        public:
+            /** Initializes an empty pool. */
+            EnumerationPool();
+
+            /** Destructor, deletes all tables. */
+            ~EnumerationPool();
+
+            /**
+             * Returns the table of an enumeration string, as stored in the enumeration
+             * property of a parameter, and parses the string if it has not been interned yet.
+             * @param enumeration The entries, separated by '\n'.
+             * @return The shared table of the enumeration.
+             */
+            Table const* intern(std::string const& enumeration);
+
+            /**
+             * Returns the table of an enumeration map, and creates it if the same name-value
+             * pairs have not been interned yet.
+             * @param enumeration The name-value pairs of the enumeration map.
+             * @return The shared table of the enumeration.
+             */
+            Table const* intern(Enumeration const& enumeration);
+
+            /**
+             * Returns the number of distinct enumerations stored in the pool.
+             * @return The number of tables.
+             */
+            size_type size() const;
+
+            /**
+             * Deletes all tables. All previously returned tables become invalid.
+             */
+            void clear();
+
+            /**
+             * Returns a number that changes whenever the pool is cleared. A caller that keeps
+             * a table may compare this number to find out whether the table is still valid.
+             * @return The number of times the pool has been cleared.
+             */
+            size_type generation() const;
+
+        private:
+            typedef std::multimap<size_type, Table*> TableMap;
+
+            /**
+             * Computes the FNV-1a hash of the passed characters.
+             */
+            static size_type hash(char const* first, char const* last);
+
+            /**
+             * Computes the hash of the names of an enumeration map, joined by '\n'.
+             */
+            static size_type hash(Enumeration const& enumeration);
+
+            /** Prohibits copying, since the tables are owned by the pool. */
+            EnumerationPool(EnumerationPool const&);
+            EnumerationPool& operator=(EnumerationPool const&);
+
+        private:
+#ifdef _MSC_VER
+#  pragma warning(push)
+#  pragma warning(disable : 4251)
+#endif
+            TableMap m_tables;
+#ifdef _MSC_VER
+#  pragma warning(pop)
+#endif
+            size_type m_generation;
+    };
+}
+}
+
+#ifdef LIBEMBER_HEADER_ONLY
+#  include "impl/EnumerationPool.ipp"
+#endif
+
+#endif  // __LIBEMBER_GLOW_ENUMERATIONPOOL_HPP
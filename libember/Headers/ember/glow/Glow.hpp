@@ -31,23 +31,38 @@
 #include "GlowStringIntegerCollection.hpp"
 #include "GlowNode.hpp"
 #include "GlowNodeFactory.hpp"
+#include "GlowNodeFilter.hpp"
 #include "GlowParameter.hpp"
 #include "GlowQualifiedNode.hpp"
 #include "GlowQualifiedParameter.hpp"
+#include "GlowReader.hpp"
 #include "GlowRootElementCollection.hpp"
 #include "GlowStreamCollection.hpp"
 #include "GlowStreamEntry.hpp"
+#include "GlowStreamDecoder.hpp"
 #include "GlowTags.hpp"
+#include "GlowVisitor.hpp"
 #include "GlowMatrix.hpp"
 #include "GlowQualifiedMatrix.hpp"
 #include "GlowTarget.hpp"
 #include "GlowSource.hpp"
 #include "GlowConnection.hpp"
+#include "GlowConnectionTable.hpp"
+#include "CrosspointMatrix.hpp"
 #include "GlowLabel.hpp"
 #include "GlowInvocation.hpp"
 #include "GlowInvocationResult.hpp"
+#include "GlowInvocationTable.hpp"
 #include "GlowFunction.hpp"
 #include "GlowQualifiedFunction.hpp"
+#include "EnumerationPool.hpp"
+#include "GlowTreeMirror.hpp"
+#include "GlowTreeDiff.hpp"
+#include "GlowProxy.hpp"
+#include "GlowSession.hpp"
+#include "GlowTreeBrowser.hpp"
+#include "GlowRequestEncoder.hpp"
+#include "GlowWriter.hpp"
 
 #endif  // __LIBEMBER_GLOW_GLOW_HPP
 
@@ -96,6 +96,12 @@ namespace libember { namespace glow
              */
             GlowInvocation const* invocation() const;
 
+            /**
+             * Returns the sequence number of a GetChangesSince command.
+             * @return The sequence number, or -1 if the command does not contain one.
+             */
+            long sequence() const;
+
             /**
              * Sets the dirFieldFlags. This property is only considered when the command type is
              * set to 'GetDirectory'.
@@ -109,6 +115,12 @@ namespace libember { namespace glow
              */
             void setInvocation(GlowInvocation* value);
 
+            /**
+             * Sets the sequence number of a GetChangesSince command.
+             * @param value The sequence number to set.
+             */
+            void setSequence(long value);
+
         private:
             /**
              * This constructor initializes a command without the mandatory number.
@@ -0,0 +1,213 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef __LIBEMBER_GLOW_GLOWCONNECTIONTABLE_HPP
+#define __LIBEMBER_GLOW_GLOWCONNECTIONTABLE_HPP
+
+#include <vector>
+#include "../ber/Tag.hpp"
+#include "../util/Api.hpp"
+#include "../util/OctetStream.hpp"
+#include "ConnectionDisposition.hpp"
+#include "ConnectionOperation.hpp"
+
+namespace libember { namespace glow
+{
+    /**
+     * A compact list of matrix connections, each consisting of a target number
+     * and the numbers of its connected sources. All source numbers are stored in
+     * a single array, so a table with thousands of connections needs only a few
+     * allocations instead of a GlowConnection set with four leaves per connection.
+     * A provider encodes a table with GlowMatrixBase::insertConnections(), a
+     * consumer fills it from the connections reported by a GlowReader.
+     */
+    class LIBEMBER_API GlowConnectionTable
+    {
+        public:
+            typedef std::size_t size_type;
+            typedef int const* const_iterator;
+
+            /** Constructor, initializes an empty table. */
+            GlowConnectionTable();
+
+            /**
+             * Returns whether or not this table contains any connections.
+             * @return True if the table is empty.
+             */
+            bool empty() const;
+
+            /**
+             * Returns the number of connections in this table.
+             * @return The number of connections in this table.
+             */
+            size_type size() const;
+
+            /**
+             * Reserves storage for the specified number of connections and sources.
+             * @param connections The number of connections to reserve storage for.
+             * @param sources The total number of sources of all connections.
+             */
+            void reserve(size_type connections, size_type sources);
+
+            /** Removes all connections, the reserved storage is kept. */
+            void clear();
+
+            /**
+             * Appends a connection.
+             * @param target The number of the target.
+             * @param first An iterator referring to the first source number.
+             * @param last An iterator referring to the source number one past the last.
+             * @param operation The connection operation.
+             * @param disposition The connection disposition.
+             */
+            template<typename InputIterator>
+            void insert(int target, InputIterator first, InputIterator last,
+                ConnectionOperation const& operation = ConnectionOperation::Absolute,
+                ConnectionDisposition const& disposition = ConnectionDisposition::Tally);
+
+            /**
+             * Returns the target number of the connection at @p index.
+             * @param index The index of the connection.
+             * @return The target number.
+             */
+            int target(size_type index) const;
+
+            /**
+             * Returns a pointer to the first source number of the connection at @p index.
+             * @param index The index of the connection.
+             * @return A pointer to the first source number.
+             */
+            const_iterator sourcesBegin(size_type index) const;
+
+            /**
+             * Returns a pointer to the source number one past the last of the connection
+             * at @p index.
+             * @param index The index of the connection.
+             * @return A pointer to the source number one past the last.
+             */
+            const_iterator sourcesEnd(size_type index) const;
+
+            /**
+             * Returns the operation of the connection at @p index.
+             * @param index The index of the connection.
+             * @return The connection operation.
+             */
+            ConnectionOperation operation(size_type index) const;
+
+            /**
+             * Returns the disposition of the connection at @p index.
+             * @param index The index of the connection.
+             * @return The connection disposition.
+             */
+            ConnectionDisposition disposition(size_type index) const;
+
+            /**
+             * Returns the number of bytes encode() writes.
+             * @return The encoded length of all connections.
+             */
+            std::size_t encodedLength() const;
+
+            /**
+             * Encodes all connections the way a connections sequence encodes its
+             * GlowConnection children, without creating any dom nodes. Operation and
+             * disposition are omitted if they have their default values.
+             * @param output The stream to write the encoded connections to.
+             */
+            void encode(libember::util::OctetStream& output) const;
+
+        private:
+            /**
+             * Describes a single connection, its sources are stored in m_sources.
+             */
+            struct Entry
+            {
+                int target;
+                size_type offset;
+                size_type count;
+                int operation;
+                int disposition;
+            };
+
+            /**
+             * Returns the encoded length of the contents of the connection set
+             * describing @p entry.
+             * @param entry The connection to measure.
+             * @return The encoded length of the leaves of the connection.
+             */
+            std::size_t encodedContentLength(Entry const& entry) const;
+
+            /**
+             * Returns the encoded length of the sources of @p entry as RELATIVE-OID.
+             * @param entry The connection to measure.
+             * @return The encoded length of the source numbers.
+             */
+            std::size_t encodedSourcesLength(Entry const& entry) const;
+
+            /**
+             * Returns the encoded length of a leaf whose payload has the specified length.
+             * @param tag The application tag of the leaf.
+             * @param type The universal type tag of the payload.
+             * @param payloadLength The length of the payload.
+             * @return The encoded length of the leaf including its two frames.
+             */
+            static std::size_t encodedLeafLength(ber::Tag const& tag, ber::Tag const& type, std::size_t payloadLength);
+
+            /**
+             * Writes both frame headers of a leaf whose payload has the specified length.
+             * @param output The stream to write to.
+             * @param tag The application tag of the leaf.
+             * @param type The universal type tag of the payload.
+             * @param payloadLength The length of the payload.
+             */
+            static void encodeLeafHeader(libember::util::OctetStream& output, ber::Tag const& tag, ber::Tag const& type, std::size_t payloadLength);
+
+        private:
+#ifdef _MSC_VER
+#  pragma warning(push)
+#  pragma warning(disable : 4251)
+#endif
+            std::vector<Entry> m_entries;
+            std::vector<int> m_sources;
+#ifdef _MSC_VER
+#  pragma warning(pop)
+#endif
+    };
+
+    /**************************************************************************
+     * Mandatory inline implementation                                        *
+     **************************************************************************/
+
+    template<typename InputIterator>
+    inline void GlowConnectionTable::insert(int target, InputIterator first, InputIterator last,
+        ConnectionOperation const& operation, ConnectionDisposition const& disposition)
+    {
+        size_type const offset = m_sources.size();
+        m_sources.insert(m_sources.end(), first, last);
+
+        Entry const entry = { target, offset, m_sources.size() - offset, operation.value(), disposition.value() };
+        m_entries.push_back(entry);
+    }
+}
+}
+
+#ifdef LIBEMBER_HEADER_ONLY
+#  include "impl/GlowConnectionTable.ipp"
+#endif
+
+#endif  // __LIBEMBER_GLOW_GLOWCONNECTIONTABLE_HPP
@@ -21,8 +21,10 @@
 #define __LIBEMBER_GLOW_CONTENTELEMENT_HPP
 
 #include "../ber/Value.hpp"
+#include "../dom/EncodedNode.hpp"
 #include "../dom/Set.hpp"
 #include "../dom/VariantLeaf.hpp"
+#include "../util/SmallVector.hpp"
 #include "util/Find.hpp"
 #include "GlowElement.hpp"
 
@@ -77,10 +79,10 @@ namespace libember { namespace glow
             const_iterator end() const;
 
             /**
-             * Adds an Ember Container to the content set.
+             * Adds an Ember node, usually a container, to the content set.
              * @param value the ember element to add.
              */
-            void set(dom::Container* value);
+            void set(dom::Node* value);
 
             /**
              * Adds or changes the leaf node with the provided application tag and value.
@@ -88,7 +90,17 @@ namespace libember { namespace glow
              * @param value The value to set.
              */
             template<typename ValueType>
-            void set(ber::Tag const& tag, ValueType value);
+            void set(ber::Tag const& tag, ValueType const& value);
+
+            /**
+             * Adds or changes the leaf node with the provided application tag and
+             * takes over the contents of @p value instead of copying them.
+             * @param tag The application tag of the leaf to add or update.
+             * @param value The value to store, left default constructed on return.
+             * @see ber::Value::adopt()
+             */
+            template<typename ValueType>
+            void adopt(ber::Tag const& tag, ValueType& value);
 
             /**
              * Searches for a VariantLeaf with the specified application tag and returns its value.
@@ -97,6 +109,36 @@ namespace libember { namespace glow
              */
             ber::Value get(ber::Tag const& tag) const;
 
+            /**
+             * Returns the value of the VariantLeaf storing the property with the
+             * specified number. Properties are stored with a context-specific tag
+             * whose number equals the property number, so the node is taken
+             * directly from the tag index without constructing a tag.
+             * @param property The number of the property, for example a
+             *      ParameterProperty value.
+             * @return The node's value if found, otherwise a Value in an irregular state will be returned.
+             */
+            ber::Value getProperty(flag_type property) const;
+
+            /**
+             * Returns a pointer to the value of the property with the specified
+             * number without copying it. The pointer remains valid until the
+             * property is changed or the content set is destroyed.
+             * @param property The number of the property, for example a
+             *      ParameterProperty value.
+             * @return A pointer to the value, or null if the property does not
+             *      exist or does not contain a value of type @p ValueType.
+             */
+            template<typename ValueType>
+            ValueType const* peekProperty(flag_type property) const;
+
+            /**
+             * Removes all properties from the content set. The leaves storing
+             * property values are not deleted but kept for reuse, so setting
+             * the same properties again allocates no nodes.
+             */
+            void recycle();
+
             /**
              * Checks if the passed property exists in the content set.
              * @param property Property to look for.
@@ -116,29 +158,95 @@ namespace libember { namespace glow
              */
             Contents(GlowContentElement& parent, ber::Tag const& contentTag);
 
+            /** Destructor, deletes the leaves kept for reuse. */
+            ~Contents();
+
+            /**
+             * Removes the leaf with the application tag @p tag from the leaves
+             * kept for reuse.
+             * @param tag The application tag of the leaf.
+             * @return The leaf, or null if no leaf with this tag is kept.
+             */
+            dom::VariantLeaf* takeRecycled(ber::Tag const& tag);
+
             /**
              * Assures that the content set exists.
              */
             void assureContainer() const;
 
             /**
-             * Scans the collection for available properties and returns flags
-             * indicating which properties exist.
-             * The flag for each property is constructed by left-shifting 1 by the value of the property.
-             * @param first First element of the container to traverse.
-             * @param last End of the container.
-             * @return Returns a mask indicating the available properties.
+             * Rebuilds the property flags and the tag index from the current content set.
+             */
+            void rebuildIndex() const;
+
+            /**
+             * Assures that the content set exists and that the tag index reflects its
+             * current state. The index is rebuilt when nodes have been inserted into
+             * or erased from the content set without going through this class.
+             */
+            void assureIndex() const;
+
+            /**
+             * Returns the node with the specified application tag. Context-specific
+             * tags with a number below the width of flag_type are looked up in the
+             * tag index, all other tags are searched linearly.
+             * @param tag The application tag to look for.
+             * @return The first node with the specified tag or null if the content
+             *      set contains no such node.
+             */
+            dom::Node* lookup(ber::Tag const& tag) const;
+
+            /**
+             * Returns the node with the context-specific tag number @p number from
+             * the tag index.
+             * @param number The tag number, which must be less than the width of
+             *      flag_type.
+             * @return The first node with the specified tag number or null if the
+             *      content set contains no such node.
              */
-            flag_type generatePropertyFlags(const_iterator first, const_iterator last) const;
+            dom::Node* lookupProperty(flag_type number) const;
+
+            /**
+             * Adds the node @p node, which has just been inserted into the content
+             * set, to the tag index and the property flags.
+             * @param node The inserted node.
+             */
+            void indexInsertedNode(dom::Node* node) const;
+
+            /**
+             * Returns the position of the node with the context-specific tag number
+             * @p number within the tag index, which is the number of indexed tags
+             * with a lower number.
+             * @param number The tag number.
+             * @return The position within the tag index.
+             */
+            size_type indexPosition(ber::Tag::Number number) const;
+
+            /** Prohibit copying */
+            Contents(Contents const&);
 
             /** Prohibit assignment */
             Contents& operator=(Contents const&);
 
+        private:
+            /**
+             * Contains the first node of each context-specific tag present in the
+             * content set, ordered by tag number. The position of a node is derived
+             * from the property flags, so a lookup requires no search.
+             */
+            typedef libember::util::SmallVector<dom::Node*, 8> TagIndex;
+
+            /** The leaves removed by recycle(), which set() reuses. */
+            typedef libember::util::SmallVector<dom::VariantLeaf*, 8> LeafList;
+
         private:
             GlowContentElement& m_parent;
             ber::Tag m_contentTag;
             mutable flag_type m_propertyFlags;
             mutable dom::Set* m_container;
+            mutable TagIndex m_index;
+            mutable dom::Container::size_type m_indexedGeneration;
+            LeafList m_recycled;
     };
 
 
@@ -148,6 +256,37 @@ namespace libember { namespace glow
      */
     class LIBEMBER_API GlowContentElement : public GlowElement
     {
+        public:
+            /**
+             * Encodes the properties stored in the content set, without the
+             * header of the set itself. The result can be cached and inserted
+             * into another element of the same type with insertEncodedProperties().
+             * @param output The stream to append the encoded properties to.
+             */
+            void encodeProperties(libember::util::OctetStream& output) const;
+
+            /**
+             * Inserts properties that have been encoded by encodeProperties()
+             * into the content set. The bytes are encoded unchanged, without
+             * decoding the properties they contain.
+             * @param properties The encoded properties.
+             * @note The inserted properties are opaque, they are neither returned
+             *      by the property accessors nor replaced when the same property
+             *      is set again. A property must therefore either be encoded in
+             *      advance or be set directly, but not both.
+             */
+            void insertEncodedProperties(libember::util::OctetSlice const& properties);
+
+            /**
+             * Removes all properties of this element, keeping the leaves that
+             * stored them for reuse. An element that is refilled with the same
+             * properties after each use, for example when answering the same
+             * request repeatedly, then reaches a state in which no nodes are
+             * allocated, and values of the same type reuse their storage.
+             * Children of the element other than the content set are not affected.
+             */
+            void recycleProperties();
+
         protected:
             /**
              * Initializes a new Content element with the specified glow type and 
@@ -184,7 +323,7 @@ namespace libember { namespace glow
     template<typename PropertyType>
     inline bool Contents::contains(PropertyType const& property) const
     {
-        assureContainer();
+        assureIndex();
         bool const result = (m_propertyFlags & (1 << property.value())) != 0;
         return result;
     }
@@ -196,57 +335,84 @@ namespace libember { namespace glow
     }
 
     template<typename ValueType>
-    inline void Contents::set(ber::Tag const& tag, ValueType value)
+    inline void Contents::set(ber::Tag const& tag, ValueType const& value)
     {
-        iterator const first = begin();
-        iterator const last = end();
-        iterator const result = util::find_tag(first, last, tag);
-        if (result != last)
+        dom::Node* const result = lookup(tag);
+        if (result != 0)
         {
-            dom::VariantLeaf* node = dynamic_cast<dom::VariantLeaf*>(&*result);
+            dom::VariantLeaf* node = dynamic_cast<dom::VariantLeaf*>(result);
             if (node != 0)
-                node->setValue(value);
-            else
-                return;
+                node->assignValue(value);
         }
         else
         {
             if (m_container != 0)
-                m_container->insert(last, new dom::VariantLeaf(tag, value));
-            else
-                return;
+            {
+                dom::VariantLeaf* node = takeRecycled(tag);
+                if (node != 0)
+                {
+                    node->assignValue(value);
+                }
+                else
+                {
+                    node = new dom::VariantLeaf(tag, value);
+                }
+
+                m_container->insert(m_container->end(), node);
+                indexInsertedNode(node);
+            }
         }
+    }
 
-        m_propertyFlags |= (tag.getClass() == ber::Class::ContextSpecific ? (1 << tag.number()) : 0);
+    template<typename ValueType>
+    inline void Contents::adopt(ber::Tag const& tag, ValueType& value)
+    {
+        set(tag, ber::Value::adopt(value));
     }
 
-    inline void Contents::set(dom::Container* value)
+    inline void Contents::set(dom::Node* value)
     {
-        ber::Tag const tag = value->applicationTag();
-        iterator const where = end();
+        assureIndex();
         if (m_container != 0)
         {
-            m_container->insert(where, value);
-            m_propertyFlags |= (tag.getClass() == ber::Class::ContextSpecific ? (1 << tag.number()) : 0);
+            m_container->insert(m_container->end(), value);
+            indexInsertedNode(value);
         }
     }
 
     inline ber::Value Contents::get(ber::Tag const& tag) const
     {
-        const_iterator const first = begin();
-        const_iterator const last = end();
-        const_iterator const result = util::find_tag(first, last, tag);
-        if (result != last)
+        dom::VariantLeaf const* node = dynamic_cast<dom::VariantLeaf const*>(lookup(tag));
+        if (node != 0)
         {
-            dom::VariantLeaf const* node = dynamic_cast<dom::VariantLeaf const*>(&*result);
-            if (node != 0)
-            {
-                return node->value();
-            }
+            return node->value();
+        }
+
+        return ber::Value();
+    }
+
+    inline ber::Value Contents::getProperty(flag_type property) const
+    {
+        dom::VariantLeaf const* node = dynamic_cast<dom::VariantLeaf const*>(lookupProperty(property));
+        if (node != 0)
+        {
+            return node->value();
         }
 
         return ber::Value();
     }
+
+    template<typename ValueType>
+    inline ValueType const* Contents::peekProperty(flag_type property) const
+    {
+        dom::VariantLeaf const* node = dynamic_cast<dom::VariantLeaf const*>(lookupProperty(property));
+        if (node != 0)
+        {
+            return node->peekValue<ValueType>();
+        }
+
+        return 0;
+    }
 }
 }
 
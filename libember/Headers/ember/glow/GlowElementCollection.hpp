@@ -20,6 +20,9 @@
 #ifndef __LIBEMBER_GLOW_GLOWELEMENTCOLLECTION_HPP
 #define __LIBEMBER_GLOW_GLOWELEMENTCOLLECTION_HPP
 
+#include <utility>
+#include <vector>
+#include "../ber/ObjectIdentifier.hpp"
 #include "GlowContainer.hpp"
 #include "util/TypeFilter.hpp"
 
@@ -46,12 +49,88 @@ namespace libember { namespace glow
              */
             explicit GlowElementCollection(ber::Tag const& tag);
 
+            /**
+             * Copy constructor, the copy builds its own number index when it is
+             * searched for the first time.
+             * @param other The collection to copy.
+             */
+            GlowElementCollection(GlowElementCollection const& other);
+
             /**
              * Extracts all GlowElement objects from this sequence into the passed OutputIterator.
              * @return The number of copied pointers.
              */
             template<typename OutputIterator>
             size_type elements(OutputIterator dest) const;
+
+            /**
+             * Returns the node, parameter, matrix or function with the specified number.
+             * The first lookup builds an index of the numbers of all children, which is
+             * discarded when a child is inserted or removed. Subsequent lookups do not
+             * need to compare the number of every child.
+             * @param number The number of the element to look for.
+             * @return The element with the specified number or null, if no child has
+             *      this number.
+             */
+            GlowElement* elementAt(int number);
+
+            /**
+             * Returns the node, parameter, matrix or function with the specified number.
+             * @see elementAt(int)
+             * @param number The number of the element to look for.
+             * @return The element with the specified number or null, if no child has
+             *      this number.
+             */
+            GlowElement const* elementAt(int number) const;
+
+            /**
+             * Resolves a path relative to this collection. The first number selects a
+             * child of this collection, each further number selects a child of the node
+             * found for the previous one, using the number index of its children.
+             * @param path The numbers of the elements to walk along.
+             * @return The element at the end of the path or null, if the path is empty
+             *      or an element along the path does not exist or is not a node.
+             */
+            GlowElement* elementAt(ber::ObjectIdentifier const& path);
+
+            /**
+             * Resolves a path relative to this collection.
+             * @see elementAt(ber::ObjectIdentifier const&)
+             * @param path The numbers of the elements to walk along.
+             * @return The element at the end of the path or null, if the path is empty
+             *      or an element along the path does not exist or is not a node.
+             */
+            GlowElement const* elementAt(ber::ObjectIdentifier const& path) const;
+
+        protected:
+            /** Discards the number index and inserts the child. */
+            virtual iterator insertImpl(iterator const& where, Node* child);
+
+            /** Discards the number index and removes the children. */
+            virtual void eraseImpl(iterator const& first, iterator const& last);
+
+        private:
+            typedef std::pair<int, GlowElement*> IndexEntry;
+            typedef std::vector<IndexEntry> IndexEntryVector;
+
+            /**
+             * Collects the numbers of all numbered children and sorts them. The index is
+             * only marked valid when the number of every child is known. A child that is
+             * still being decoded has no number yet, so the index is built again by the
+             * next lookup in that case.
+             */
+            void buildIndex() const;
+
+        private:
+#ifdef _MSC_VER
+#  pragma warning(push)
+#  pragma warning(disable : 4251)
+#endif
+            mutable IndexEntryVector m_index;
+#ifdef _MSC_VER
+#  pragma warning(pop)
+#endif
+            mutable bool m_isIndexValid;
     };
 
     /**************************************************************************/
@@ -61,7 +140,7 @@ namespace libember { namespace glow
     template<typename OutputIterator>
     inline GlowContainer::size_type GlowElementCollection::elements(OutputIterator dest) const
     {
-        return util::TypeFilter<GlowElement>::collect(begin(), end(), dest);
+        return util::TypeFilter<GlowElement>::collect(childBegin(), childEnd(), dest);
     }
 }
 }
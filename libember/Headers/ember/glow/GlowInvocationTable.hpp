@@ -0,0 +1,184 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+#ifndef __LIBEMBER_GLOW_GLOWINVOCATIONTABLE_HPP
+#define __LIBEMBER_GLOW_GLOWINVOCATIONTABLE_HPP
+
+#include <map>
+#include "../util/Api.hpp"
+
+namespace libember { namespace glow
+{
+    /** Forward declarations **/
+    class GlowInvocation;
+    class GlowInvocationResult;
+
+    /**
+     * Correlates the invocation results received by a consumer with the invocations
+     * it has sent. The table allocates the invocation identifiers, keeps the pending
+     * invocations together with a deadline and notifies a callback when the result
+     * of an invocation arrives or when its deadline has passed without a result.
+     * Since libember does not depend on a clock, the deadlines are expressed in ticks
+     * of a clock chosen by the application, for example milliseconds. The table is
+     * not synchronized and is usually owned by the thread that reads the provider's
+     * messages.
+     */
+    class LIBEMBER_API GlowInvocationTable
+    {
+        public:
+            typedef std::size_t size_type;
+            typedef unsigned long tick_type;
+
+            /**
+             * Interface notified about the outcome of a pending invocation.
+             */
+            class LIBEMBER_API Callback
+            {
+                public:
+                    /** Destructor */
+                    virtual ~Callback();
+
+                    /**
+                     * Called when the result of an invocation has been received.
+                     * The invocation has already been removed from the table.
+                     * @param invocationId The identifier of the invocation.
+                     * @param result The received result.
+                     */
+                    virtual void completed(int invocationId, GlowInvocationResult const& result) = 0;
+
+                    /**
+                     * Called when the deadline of an invocation has passed before
+                     * its result has been received. The invocation has already been
+                     * removed from the table, so a result arriving later is ignored.
+                     * @param invocationId The identifier of the invocation.
+                     */
+                    virtual void timedOut(int invocationId) = 0;
+            };
+
+        public:
+            /** Constructor, initializes an empty table. */
+            GlowInvocationTable();
+
+            /**
+             * Adds a pending invocation and returns the identifier to send it with.
+             * Identifiers are positive and are not reused while an invocation with
+             * the same identifier is still pending.
+             * @param callback The callback to notify about the outcome of the invocation.
+             *      The table does not take ownership, the callback must remain valid
+             *      until it has been notified or the invocation has been cancelled.
+             * @param deadline The tick at which the invocation times out.
+             * @return The identifier of the invocation.
+             */
+            int add(Callback* callback, tick_type deadline);
+
+            /**
+             * Adds a pending invocation and creates the GlowInvocation to send, with
+             * its identifier already set.
+             * @param callback The callback to notify about the outcome of the invocation.
+             * @param deadline The tick at which the invocation times out.
+             * @return A new invocation, to be attached to a command with
+             *      GlowCommand::setInvocation(). The caller takes ownership.
+             * @see add()
+             */
+            GlowInvocation* createInvocation(Callback* callback, tick_type deadline);
+
+            /**
+             * Removes the invocation @p result belongs to and notifies its callback.
+             * @param result A received invocation result.
+             * @return True if the result belonged to a pending invocation, false if the
+             *      invocation is unknown, has been cancelled or has already timed out.
+             */
+            bool complete(GlowInvocationResult const& result);
+
+            /**
+             * Removes all invocations whose deadline is not after @p now and notifies
+             * their callbacks. The comparison tolerates a wrap-around of the clock.
+             * @param now The current tick.
+             * @return The number of invocations that have timed out.
+             */
+            size_type expire(tick_type now);
+
+            /**
+             * Removes a pending invocation without notifying its callback.
+             * @param invocationId The identifier of the invocation.
+             * @return True if the invocation was pending.
+             */
+            bool cancel(int invocationId);
+
+            /** Removes all pending invocations without notifying their callbacks. */
+            void clear();
+
+            /**
+             * Tests whether an invocation is still pending.
+             * @param invocationId The identifier of the invocation.
+             * @return True if the invocation is pending.
+             */
+            bool contains(int invocationId) const;
+
+            /**
+             * Returns whether or not any invocation is pending.
+             * @return True if no invocation is pending.
+             */
+            bool empty() const;
+
+            /**
+             * Returns the number of pending invocations.
+             * @return The number of pending invocations.
+             */
+            size_type size() const;
+
+        private:
+            struct Pending
+            {
+                Pending(Callback* callback, tick_type deadline);
+
+                Callback* callback;
+                tick_type deadline;
+            };
+
+            typedef std::map<int, Pending> PendingMap;
+
+            /**
+             * Tests whether @p deadline is not after @p now.
+             * @param deadline The deadline to test.
+             * @param now The current tick.
+             * @return True if the deadline has been reached.
+             */
+            static bool isDue(tick_type deadline, tick_type now);
+
+        private:
+#ifdef _MSC_VER
+#  pragma warning(push)
+#  pragma warning(disable: 4251)
+#endif
+            PendingMap m_pending;
+#ifdef _MSC_VER
+#  pragma warning(pop)
+#endif
+            int m_nextId;
+    };
+}
+}
+
+#ifdef LIBEMBER_HEADER_ONLY
+#  include "impl/GlowInvocationTable.ipp"
+#endif
+
+#endif  // __LIBEMBER_GLOW_GLOWINVOCATIONTABLE_HPP
@@ -28,10 +28,12 @@
 #include "ParametersLocation.hpp"
 #include "util/CompliesWithSchema.hpp"
 #include "util/TypeFilter.hpp"
+#include "util/ValueConverter.hpp"
 #include "GlowLabel.hpp"
 #include "GlowTarget.hpp"
 #include "GlowSource.hpp"
 #include "GlowConnection.hpp"
+#include "GlowConnectionTable.hpp"
 
 namespace libember { namespace glow
 {
@@ -158,6 +160,15 @@ namespace libember { namespace glow
              */
             dom::Sequence* connections();
 
+            /**
+             * Appends all connections of @p table to the connections sequence. The
+             * connections are encoded right away and inserted as a single dom::EncodedNode,
+             * so no GlowConnection objects are created. They are therefore not reported by
+             * typedConnections().
+             * @param table The connections to insert.
+             */
+            void insertConnections(GlowConnectionTable const& table);
+
             /**
              * Returns the identifier string.
              * @return The identifier string.
@@ -177,9 +188,44 @@ namespace libember { namespace glow
              */
             std::string schemaIdentifiers() const;
 
+            /**
+             * Returns the identifier string without copying it.
+             * @return A pointer to the identifier, which remains valid until the
+             *      identifier is changed or this matrix is destroyed, or null if the
+             *      identifier is not set.
+             */
+            std::string const* peekIdentifier() const;
+
+            /**
+             * Returns the description string without copying it.
+             * @return A pointer to the description, which remains valid until the
+             *      description is changed or this matrix is destroyed, or null if the
+             *      description is not set.
+             */
+            std::string const* peekDescription() const;
+
+            /**
+             * Returns the string containing the schema identifiers without copying it.
+             * @return A pointer to the schema identifiers, which remains valid until
+             *      they are changed or this matrix is destroyed, or null if no schema
+             *      identifiers are set.
+             */
+            std::string const* peekSchemaIdentifiers() const;
+
+            /**
+             * Reads the value of a property with a single lookup.
+             * @param property The property to read.
+             * @param value Receives the value of the property if it exists and has
+             *      the type @p ValueType, remains unchanged otherwise.
+             * @return true if the property exists and has the type @p ValueType.
+             */
+            template<typename ValueType>
+            bool tryGet(MatrixProperty const& property, ValueType& value) const;
+
             /**
              * Tests if the matrix complies with the specified schema.
-             * @param schemaIdentifier The identifier of the schema to test.
+             * @param schemaIdentifier The identifier of the schema to test, which must equal a
+             *      complete entry of the schema identifiers. An empty identifier never matches.
              * @return true, if the schema is supported. Otherwise, this method
              *      return false.
              */
@@ -368,9 +414,15 @@ namespace libember { namespace glow
                : 0;
     }
 
+    template<typename ValueType>
+    inline bool GlowMatrixBase::tryGet(MatrixProperty const& property, ValueType& value) const
+    {
+        return util::ValueConverter::tryValueOf(contents().getProperty(property.value()), value);
+    }
+
     inline bool GlowMatrixBase::compliesWithSchema(std::string const& schemaIdentifier) const
     {
-        return util::complies_with_schema(schemaIdentifiers(), schemaIdentifier);
+        return util::complies_with_schema(contents().getProperty(MatrixProperty::SchemaIdentifiers), schemaIdentifier);
     }
 }
 }
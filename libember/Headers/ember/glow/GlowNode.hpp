@@ -20,6 +20,7 @@
 #ifndef __LIBEMBER_GLOW_GLOWNODE_HPP
 #define __LIBEMBER_GLOW_GLOWNODE_HPP
 
+#include "../util/Instrumentation.hpp"
 #include "GlowNodeBase.hpp"
 
 namespace libember { namespace glow
@@ -35,7 +36,7 @@ namespace libember { namespace glow
      * The methods to access a property of this object return a default value if a property doesn't exist.
      * To assure that the property exists, the contains method should be used.
      */
-    class LIBEMBER_API GlowNode : public GlowNodeBase
+    class LIBEMBER_API GlowNode : public GlowNodeBase, private libember::util::InstanceCounter<libember::util::Instrumentation::GlowNode>
     {
         friend class GlowNodeFactory;
         public:
@@ -24,6 +24,7 @@
 #include "GlowElementCollection.hpp"
 #include "NodeProperty.hpp"
 #include "util/CompliesWithSchema.hpp"
+#include "util/ValueConverter.hpp"
 
 namespace libember { namespace glow
 {
@@ -54,6 +55,18 @@ namespace libember { namespace glow
              */
             void setDescription(std::string const& description);
 
+            /**
+             * Sets the identifier string without copying it.
+             * @param identifier The identifier string, empty on return.
+             */
+            void adoptIdentifier(std::string& identifier);
+
+            /**
+             * Sets the description string without copying it.
+             * @param description The description string to set, empty on return.
+             */
+            void adoptDescription(std::string& description);
+
             /**
              * Sets the string containing the schema identifiers. The identifiers
              * are separated by the linefeed character (0x0A, '\n')
@@ -101,9 +114,44 @@ namespace libember { namespace glow
              */
             std::string schemaIdentifiers() const;
 
+            /**
+             * Returns the identifier string without copying it.
+             * @return A pointer to the identifier, which remains valid until the
+             *      identifier is changed or this node is destroyed, or null if the
+             *      identifier is not set.
+             */
+            std::string const* peekIdentifier() const;
+
+            /**
+             * Returns the description string without copying it.
+             * @return A pointer to the description, which remains valid until the
+             *      description is changed or this node is destroyed, or null if the
+             *      description is not set.
+             */
+            std::string const* peekDescription() const;
+
+            /**
+             * Returns the string containing the schema identifiers without copying it.
+             * @return A pointer to the schema identifiers, which remains valid until
+             *      they are changed or this node is destroyed, or null if no schema
+             *      identifiers are set.
+             */
+            std::string const* peekSchemaIdentifiers() const;
+
+            /**
+             * Reads the value of a property with a single lookup.
+             * @param property The property to read.
+             * @param value Receives the value of the property if it exists and has
+             *      the type @p ValueType, remains unchanged otherwise.
+             * @return true if the property exists and has the type @p ValueType.
+             */
+            template<typename ValueType>
+            bool tryGet(NodeProperty const& property, ValueType& value) const;
+
             /**
              * Tests if the node complies with the specified schema.
-             * @param schemaIdentifier The identifier of the schema to test.
+             * @param schemaIdentifier The identifier of the schema to test, which must equal a
+             *      complete entry of the schema identifiers. An empty identifier never matches.
              * @return true, if the schema is supported. Otherwise, this method
              *      return false.
              */
@@ -149,9 +197,15 @@ namespace libember { namespace glow
      ******************************************************/
 
 
+    template<typename ValueType>
+    inline bool GlowNodeBase::tryGet(NodeProperty const& property, ValueType& value) const
+    {
+        return util::ValueConverter::tryValueOf(contents().getProperty(property.value()), value);
+    }
+
     inline bool GlowNodeBase::compliesWithSchema(std::string const& schemaIdentifier) const
     {
-        return util::complies_with_schema(schemaIdentifiers(), schemaIdentifier);
+        return util::complies_with_schema(contents().getProperty(NodeProperty::SchemaIdentifiers), schemaIdentifier);
     }
 }
 }
@@ -32,7 +32,9 @@ namespace libember { namespace glow
     {
         public:
             /**
-             * Returns the singleton instance of this factory.
+             * Returns the singleton instance of this factory. The factory has no
+             * state and is constructed during static initialization, so it may be
+             * used by several readers on different threads at the same time.
              * @return The singleton instance of this factory.
              */
             static dom::NodeFactory& getFactory();
@@ -45,6 +47,15 @@ namespace libember { namespace glow
              */
             dom::Node* createApplicationDefinedNode(ber::Type const& type, ber::Tag const& tag) const;
 
+            /**
+             * Creates a Glow specific type, using the provided allocator.
+             * @param type The application defined type decoded by the reader.
+             * @param tag The application tag.
+             * @param allocator The allocator to create the Glow type with.
+             * @return A Glow type or null if the provided type is unknown.
+             */
+            dom::Node* createApplicationDefinedNode(ber::Type const& type, ber::Tag const& tag, dom::NodeAllocator& allocator) const;
+
         private:
             /** Private constructor. **/
             GlowNodeFactory();
@@ -0,0 +1,121 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef __LIBEMBER_GLOW_GLOWNODEFILTER_HPP
+#define __LIBEMBER_GLOW_GLOWNODEFILTER_HPP
+
+#include "../ber/ObjectIdentifier.hpp"
+#include "../dom/NodeFilter.hpp"
+#include "GlowType.hpp"
+
+namespace libember { namespace glow
+{
+    /**
+     * Node filter that restricts the decoding of a Glow message to the elements a
+     * consumer is interested in. It can be passed to dom::AsyncDomReader::setNodeFilter.
+     * An element is skipped when its type has been excluded. When a path prefix is set,
+     * the children of an element are only decoded if the element lies on the path to
+     * the prefix or within the subtree identified by the prefix. The number and contents
+     * of such an element are still decoded, only its children are skipped.
+     */
+    class LIBEMBER_API GlowNodeFilter : public dom::NodeFilter
+    {
+        public:
+            /**
+             * Initializes a filter that accepts all elements.
+             */
+            GlowNodeFilter();
+
+            /**
+             * Initializes a filter that only decodes the children along and below
+             * the specified path.
+             * @param prefix The path of the subtree to decode.
+             */
+            explicit GlowNodeFilter(ber::ObjectIdentifier const& prefix);
+
+            /**
+             * Sets the path of the subtree to decode. An empty path decodes the
+             * children of all elements.
+             * @param prefix The path of the subtree to decode.
+             */
+            void setPrefix(ber::ObjectIdentifier const& prefix);
+
+            /**
+             * Returns the path of the subtree to decode.
+             * @return The path of the subtree to decode.
+             */
+            ber::ObjectIdentifier const& prefix() const;
+
+            /**
+             * Skips all elements of the specified type.
+             * @param type The type to skip, for example GlowType::Matrix.
+             */
+            void excludeType(GlowType const& type);
+
+            /**
+             * Decodes elements of the specified type again after they have been
+             * excluded.
+             * @param type The type to decode.
+             */
+            void includeType(GlowType const& type);
+
+            /**
+             * Returns false if the container is an element of an excluded type or the
+             * children collection of an element that lies outside of the prefix.
+             * @see dom::NodeFilter::accept
+             */
+            virtual bool accept(dom::Node const* parent, ber::Type const& type, ber::Tag const& tag) const;
+
+        private:
+            /**
+             * Computes the path of an element from its number and the numbers of
+             * its parents.
+             * @param node The element whose number has already been decoded.
+             * @param path Receives the path of the element.
+             * @return True if @p node is an element and its path could be computed.
+             */
+            static bool elementPath(dom::Node const* node, ber::ObjectIdentifier& path);
+
+            /**
+             * Returns true if the children of the element with the specified path
+             * shall be decoded.
+             * @param path The path of the element.
+             */
+            bool isWithinPrefix(ber::ObjectIdentifier const& path) const;
+
+        private:
+#ifdef _MSC_VER
+#  pragma warning(push)
+#  pragma warning(disable : 4251)
+#endif
+            ber::ObjectIdentifier m_prefix;
+#ifdef _MSC_VER
+#  pragma warning(pop)
+#endif
+            unsigned long m_excludedTypes;
+    };
+}
+}
+
+#ifdef LIBEMBER_HEADER_ONLY
+#  include "impl/GlowNodeFilter.ipp"
+#endif
+
+#endif  // __LIBEMBER_GLOW_GLOWNODEFILTER_HPP
+
@@ -20,6 +20,7 @@
 #ifndef __LIBEMBER_GLOW_GLOWPARAMETER_HPP
 #define __LIBEMBER_GLOW_GLOWPARAMETER_HPP
 
+#include "../util/Instrumentation.hpp"
 #include "GlowParameterBase.hpp"
 
 namespace libember { namespace glow
@@ -34,7 +35,7 @@ namespace libember { namespace glow
      * The methods to access a property of this object return a default value if a property doesn't exist.
      * To assure that the property exists, the contains method should be used.
      */
-    class LIBEMBER_API GlowParameter : public GlowParameterBase
+    class LIBEMBER_API GlowParameter : public GlowParameterBase, private libember::util::InstanceCounter<libember::util::Instrumentation::GlowParameter>
     {
         friend class GlowNodeFactory;
         public:
@@ -25,6 +25,7 @@
 #include "../ber/Octets.hpp"
 #include "Access.hpp"
 #include "Enumeration.hpp"
+#include "EnumerationPool.hpp"
 #include "Formula.hpp"
 #include "GlowContentElement.hpp"
 #include "GlowElementCollection.hpp"
@@ -67,6 +68,18 @@ namespace libember { namespace glow
              */
             void setDescription(std::string const& description);
 
+            /**
+             * Sets the identifier of this parameter without copying it.
+             * @param identifier Identifier of this parameter, empty on return.
+             */
+            void adoptIdentifier(std::string& identifier);
+
+            /**
+             * Sets the description of this parameter without copying it.
+             * @param description Description string, empty on return.
+             */
+            void adoptDescription(std::string& description);
+
             /**
              * Sets the string containing the schema identifiers. The identifiers
              * are separated by the linefeed character (0x0A, '\n')
@@ -250,6 +263,18 @@ namespace libember { namespace glow
              */
             void setValue(ber::Octets const& value);
 
+            /**
+             * Sets the value of this parameter without copying it.
+             * @param value Parameter value, as string. Empty on return.
+             */
+            void adoptValue(std::string& value);
+
+            /**
+             * Sets the value of this parameter without copying it.
+             * @param value Parameter value, as octets. Empty on return.
+             */
+            void adoptValue(ber::Octets& value);
+
             /**
              * Sets the way the parameter can be accessed.
              * @param access Determines whether this parameter can be modified or not.
@@ -311,9 +336,44 @@ namespace libember { namespace glow
              */
             std::string schemaIdentifiers() const;
 
+            /**
+             * Returns the identifier string without copying it.
+             * @return A pointer to the identifier, which remains valid until the
+             *      identifier is changed or this parameter is destroyed, or null if the
+             *      identifier is not set.
+             */
+            std::string const* peekIdentifier() const;
+
+            /**
+             * Returns the description string without copying it.
+             * @return A pointer to the description, which remains valid until the
+             *      description is changed or this parameter is destroyed, or null if the
+             *      description is not set.
+             */
+            std::string const* peekDescription() const;
+
+            /**
+             * Returns the string containing the schema identifiers without copying it.
+             * @return A pointer to the schema identifiers, which remains valid until
+             *      they are changed or this parameter is destroyed, or null if no schema
+             *      identifiers are set.
+             */
+            std::string const* peekSchemaIdentifiers() const;
+
+            /**
+             * Reads the value of a property with a single lookup.
+             * @param property The property to read.
+             * @param value Receives the value of the property if it exists and has
+             *      the type @p ValueType, remains unchanged otherwise.
+             * @return true if the property exists and has the type @p ValueType.
+             */
+            template<typename ValueType>
+            bool tryGet(ParameterProperty const& property, ValueType& value) const;
+
             /**
              * Tests if the parameter complies with the specified schema.
-             * @param schemaIdentifier The identifier of the schema to test.
+             * @param schemaIdentifier The identifier of the schema to test, which must equal a
+             *      complete entry of the schema identifiers. An empty identifier never matches.
              * @return true, if the schema is supported. Otherwise, this method
              *      return false.
              */
@@ -343,6 +403,23 @@ namespace libember { namespace glow
              */
             Enumeration enumerationMap() const;
 
+            /**
+             * Returns the shared table of the enumeration property. Unlike enumeration(), this
+             * method does not create a string per entry, and parameters with the same enumeration
+             * string receive the same table.
+             * @param pool The pool to intern the enumeration in.
+             * @return The table of the enumeration, which also exists if the property is not set.
+             */
+            EnumerationPool::Table const* enumeration(EnumerationPool& pool) const;
+
+            /**
+             * Returns the shared table of the enumeration map. Parameters with the same name-value
+             * pairs receive the same table.
+             * @param pool The pool to intern the enumeration map in.
+             * @return The table of the enumeration map, which also exists if the map is not set.
+             */
+            EnumerationPool::Table const* enumerationMap(EnumerationPool& pool) const;
+
             /**
              * Returns the minimum property.
              * @return The minimum value allowed for the value of this parameter.
@@ -477,7 +554,8 @@ namespace libember { namespace glow
                 stream << "\n";
         }
 
-        setEnumeration(stream.str());
+        std::string enumeration = stream.str();
+        contents().adopt(GlowTags::ParameterContents::Enumeration(), enumeration);
     }
 
     template<typename InputIterator>
@@ -507,9 +585,15 @@ namespace libember { namespace glow
         setDefault(long(value));
     }
 
+    template<typename ValueType>
+    inline bool GlowParameterBase::tryGet(ParameterProperty const& property, ValueType& value) const
+    {
+        return util::ValueConverter::tryValueOf(contents().getProperty(property.value()), value);
+    }
+
     inline bool GlowParameterBase::compliesWithSchema(std::string const& schemaIdentifier) const
     {
-        return util::complies_with_schema(schemaIdentifiers(), schemaIdentifier);
+        return util::complies_with_schema(contents().getProperty(ParameterProperty::SchemaIdentifiers), schemaIdentifier);
     }
 }
 }
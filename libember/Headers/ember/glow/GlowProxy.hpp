@@ -0,0 +1,358 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+#ifndef __LIBEMBER_GLOW_GLOWPROXY_HPP
+#define __LIBEMBER_GLOW_GLOWPROXY_HPP
+
+#include <map>
+#include <set>
+#include "../ber/ObjectIdentifier.hpp"
+#include "../util/Api.hpp"
+#include "CommandType.hpp"
+#include "GlowInvocationTable.hpp"
+#include "GlowTreeMirror.hpp"
+#include "GlowVisitor.hpp"
+
+namespace libember { namespace glow
+{
+    /** Forward declarations */
+    class GlowContentElement;
+    class GlowMatrixBase;
+    class GlowStreamCollection;
+
+    /**
+     * Shares a single provider connection among any number of consumers. The proxy
+     * keeps one cached tree of the provider, stored in a GlowTreeMirror that retains
+     * all properties, and answers the GetDirectory requests of the consumers from
+     * this cache. A directory is requested from the provider only once, when the
+     * first consumer asks for it, and consumers asking while the request is pending
+     * are answered together with the provider's response.
+     * Subscriptions are multiplexed: the provider receives a subscribe command when the
+     * first consumer subscribes to an element and an unsubscribe command when the last
+     * one unsubscribes, so the load of the provider does not depend on the number of
+     * consumers. Notifications of the provider are forwarded to all consumers that
+     * have requested the directory of the changed element's parent or subscribed to
+     * it, stream entries to the consumers that subscribed to a parameter with the
+     * entry's stream identifier.
+     * Parameter values, matrix connections and function invocations sent by consumers
+     * are forwarded to the provider. The invocation identifiers are replaced by ones
+     * allocated from a GlowInvocationTable, so that invocations of different consumers
+     * do not collide, and the results are returned to the consumer that sent the
+     * invocation.
+     * The proxy is independent of the transport. The application decodes the received
+     * messages, usually from S101 frames, passes them to providerMessage() or
+     * consumerMessage() and implements Connection to encode and send the messages the
+     * proxy writes. The proxy is not synchronized.
+     */
+    class LIBEMBER_API GlowProxy : private GlowVisitor
+    {
+        public:
+            typedef std::size_t size_type;
+            typedef GlowInvocationTable::tick_type tick_type;
+
+            /**
+             * Interface of a connection the proxy writes messages to, either the
+             * connection to the provider or the connection to a consumer.
+             */
+            class LIBEMBER_API Connection
+            {
+                public:
+                    /** Destructor */
+                    virtual ~Connection();
+
+                    /**
+                     * Sends a message, which usually is a GlowRootElementCollection or, when
+                     * an invocation result is returned to a consumer, a GlowInvocationResult.
+                     * The message is deleted after the call returns.
+                     * @param message The message to send.
+                     */
+                    virtual void write(dom::Node const& message) = 0;
+            };
+
+        public:
+            /**
+             * Initializes a new proxy with an empty cache.
+             * @param provider The connection to the provider. The proxy does not take
+             *      ownership, the connection must outlive the proxy.
+             * @param invocationTimeout The number of ticks after which a forwarded
+             *      invocation is reported as failed to its consumer if the provider
+             *      has not answered it.
+             */
+            GlowProxy(Connection& provider, tick_type invocationTimeout);
+
+            /** Destructor */
+            virtual ~GlowProxy();
+
+            /**
+             * Returns the cached tree of the provider.
+             * @return The cached tree of the provider.
+             */
+            GlowTreeMirror const& cache() const;
+
+            /**
+             * Registers a consumer connection. Connections that have not been registered
+             * are registered by their first message.
+             * @param consumer The connection to the consumer. The proxy does not take
+             *      ownership, the connection must remain valid until it is detached.
+             */
+            void attach(Connection* consumer);
+
+            /**
+             * Removes a consumer connection, usually after it has been closed. The
+             * subscriptions of the consumer are released, and the results of its
+             * pending invocations are discarded.
+             * @param consumer The connection to remove.
+             */
+            void detach(Connection* consumer);
+
+            /**
+             * Returns the number of registered consumers.
+             * @return The number of registered consumers.
+             */
+            size_type consumerCount() const;
+
+            /**
+             * Returns the number of elements the proxy has subscribed to at the provider.
+             * @return The number of subscribed elements.
+             */
+            size_type subscriptionCount() const;
+
+            /**
+             * Processes a message received from the provider. The message is merged into
+             * the cache and forwarded to the interested consumers, pending directory
+             * requests are answered and invocation results returned.
+             * @param message The received message.
+             */
+            void providerMessage(dom::Node const& message);
+
+            /**
+             * Processes a message received from a consumer.
+             * @param consumer The connection the message has been received from.
+             * @param message The received message.
+             */
+            void consumerMessage(Connection* consumer, dom::Node const& message);
+
+            /**
+             * Must be called when the connection to the provider has been established again
+             * after it had been lost. The cache is cleared, all directories the consumers
+             * have requested are requested again and all subscriptions are renewed.
+             */
+            void providerConnected();
+
+            /**
+             * Reports the forwarded invocations that have not been answered in time as
+             * failed. The application calls this method periodically, the passed tick is
+             * also used to calculate the deadlines of new invocations.
+             * @param now The current tick.
+             * @return The number of invocations that have timed out.
+             */
+            size_type expire(tick_type now);
+
+        private:
+            /**
+             * Orders object identifiers lexicographically, so they can be used as keys.
+             */
+            struct PathLess
+            {
+                bool operator()(ber::ObjectIdentifier const& lhs, ber::ObjectIdentifier const& rhs) const;
+            };
+
+            typedef std::set<Connection*> ConnectionSet;
+            typedef std::set<ber::ObjectIdentifier, PathLess> PathSet;
+            typedef std::map<Connection*, GlowRootElementCollection*> MessageMap;
+            typedef std::map<Connection*, GlowStreamCollection*> StreamMap;
+            typedef std::multimap<int, Connection*> StreamRouteMap;
+
+            /**
+             * The paths a consumer is interested in.
+             */
+            struct Consumer
+            {
+                /** The elements whose directory the consumer has received. */
+                PathSet directories;
+
+                /** The elements the consumer has subscribed to. */
+                PathSet subscriptions;
+            };
+
+            /**
+             * A directory that has been requested from the provider.
+             */
+            struct Directory
+            {
+                explicit Directory(GlowTreeMirror::ElementType type);
+
+                GlowTreeMirror::ElementType type;
+                bool isResolved;
+
+                /** The consumers waiting for the provider's response. */
+                ConnectionSet waiting;
+            };
+
+            /**
+             * An element the proxy has subscribed to at the provider.
+             */
+            struct Subscription
+            {
+                explicit Subscription(GlowTreeMirror::ElementType type);
+
+                GlowTreeMirror::ElementType type;
+                ConnectionSet consumers;
+            };
+
+            /**
+             * Returns the result of a forwarded invocation to the consumer that sent it.
+             */
+            class PendingInvocation : public GlowInvocationTable::Callback
+            {
+                public:
+                    PendingInvocation(GlowProxy& proxy, Connection* consumer, int invocationId);
+
+                    /** @see GlowInvocationTable::Callback::completed() */
+                    virtual void completed(int invocationId, GlowInvocationResult const& result);
+
+                    /** @see GlowInvocationTable::Callback::timedOut() */
+                    virtual void timedOut(int invocationId);
+
+                    GlowProxy& proxy;
+                    Connection* consumer;
+                    int const invocationId;
+            };
+
+            typedef std::map<Connection*, Consumer> ConsumerMap;
+            typedef std::map<ber::ObjectIdentifier, Directory, PathLess> DirectoryMap;
+            typedef std::map<ber::ObjectIdentifier, Subscription, PathLess> SubscriptionMap;
+            typedef std::set<PendingInvocation*> InvocationSet;
+
+            /** Handles an element of a received message, m_path contains its path. */
+            void element(GlowContentElement const& glow, GlowTreeMirror::ElementType type, GlowElementCollection const* children);
+
+            /** Forwards an element received from the provider to the interested consumers. */
+            void forward(GlowContentElement const& glow, GlowTreeMirror::ElementType type);
+
+            /** Forwards the values, connections or invocation of a consumer's element to the provider. */
+            void request(GlowContentElement const& glow, GlowTreeMirror::ElementType type);
+
+            /**
+             * Answers a directory request of a consumer from the cache and registers the
+             * consumer's interest in the directory.
+             */
+            void answer(Connection* consumer, ber::ObjectIdentifier const& path);
+
+            void getDirectory(Connection* consumer, ber::ObjectIdentifier const& path, GlowTreeMirror::ElementType type);
+            void subscribe(Connection* consumer, ber::ObjectIdentifier const& path, GlowTreeMirror::ElementType type);
+            void unsubscribe(Connection* consumer, ber::ObjectIdentifier const& path);
+            void invoke(Connection* consumer, ber::ObjectIdentifier const& path, GlowInvocation const& invocation);
+
+            /** Appends a command for the element with the passed path to the message for the provider. */
+            void command(ber::ObjectIdentifier const& path, GlowTreeMirror::ElementType type, CommandType const& command);
+
+            /** Answers the waiting consumers of all directories the last provider message has resolved. */
+            void resolveDirectories();
+
+            /**
+             * Returns the message that is sent to a connection when the current message
+             * has been processed, creating it if necessary.
+             */
+            GlowRootElementCollection& messageFor(Connection* connection);
+
+            /**
+             * Returns the stream collection that is sent to a consumer when the current
+             * message has been processed, creating it if necessary.
+             */
+            GlowStreamCollection& streamsFor(Connection* consumer);
+
+            /** Sends and deletes all messages created while processing a received message. */
+            void flush();
+
+            /**
+             * Appends a qualified element with the passed type and path to a message.
+             * @return The new element.
+             */
+            static GlowContentElement* createElement(GlowRootElementCollection& message, GlowTreeMirror::ElementType type, ber::ObjectIdentifier const& path);
+
+            /** Returns the children of an element created by createElement(), creating the collection if necessary. */
+            static GlowElementCollection* childrenOf(GlowContentElement& element, GlowTreeMirror::ElementType type);
+
+            /** Appends a qualified copy of a cached element to a message. */
+            void createElement(GlowRootElementCollection& message, GlowTreeMirror::Element const& element, bool withConnections);
+
+            /** Appends the signals and connections of a cached matrix to a glow matrix. */
+            static void insertConnections(GlowMatrixBase& matrix, GlowTreeMirror::MatrixState const& state);
+
+            /** Inserts copies of the children of a sequence into another sequence. */
+            static void copyChildren(dom::Sequence* target, dom::Sequence const* source);
+
+            /** Returns the path of the parent of an element. */
+            static ber::ObjectIdentifier parentOf(ber::ObjectIdentifier const& path);
+
+            virtual void visit(GlowRootElementCollection const& glow);
+            virtual void visit(GlowElementCollection const& glow);
+            virtual void visit(GlowNode const& glow);
+            virtual void visit(GlowQualifiedNode const& glow);
+            virtual void visit(GlowParameter const& glow);
+            virtual void visit(GlowQualifiedParameter const& glow);
+            virtual void visit(GlowMatrix const& glow);
+            virtual void visit(GlowQualifiedMatrix const& glow);
+            virtual void visit(GlowFunction const& glow);
+            virtual void visit(GlowQualifiedFunction const& glow);
+            virtual void visit(GlowCommand const& glow);
+            virtual void visit(GlowStreamCollection const& glow);
+            virtual void visit(GlowInvocationResult const& glow);
+
+        private:
+            /** Prohibit copying */
+            GlowProxy(GlowProxy const&);
+
+            /** Prohibit assignment */
+            GlowProxy& operator=(GlowProxy const&);
+
+        private:
+#ifdef _MSC_VER
+#  pragma warning(push)
+#  pragma warning(disable: 4251)
+#endif
+            GlowTreeMirror m_cache;
+            GlowInvocationTable m_invocations;
+            ConsumerMap m_consumers;
+            DirectoryMap m_directories;
+            SubscriptionMap m_subscriptions;
+            InvocationSet m_pendingInvocations;
+            MessageMap m_messages;
+            StreamMap m_streams;
+            PathSet m_touched;
+            ber::ObjectIdentifier m_path;
+#ifdef _MSC_VER
+#  pragma warning(pop)
+#endif
+            Connection& m_provider;
+            Connection* m_source;
+            GlowTreeMirror::ElementType m_type;
+            tick_type const m_invocationTimeout;
+            tick_type m_now;
+    };
+}
+}
+
+#ifdef LIBEMBER_HEADER_ONLY
+#  include "impl/GlowProxy.ipp"
+#endif
+
+#endif  // __LIBEMBER_GLOW_GLOWPROXY_HPP
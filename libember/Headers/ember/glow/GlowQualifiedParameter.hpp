@@ -21,6 +21,7 @@
 #define __LIBEMBER_GLOW_GLOWQUALIFIEDPARAMETER_HPP
 
 #include "../ber/ObjectIdentifier.hpp"
+#include "../util/Instrumentation.hpp"
 #include "GlowParameterBase.hpp"
 
 namespace libember { namespace glow
@@ -34,7 +35,7 @@ namespace libember { namespace glow
      * The methods to access a property of this object return a default value if a property doesn't exist.
      * To assure that the property exists, the contains method should be used.
      */
-    class LIBEMBER_API GlowQualifiedParameter : public GlowParameterBase
+    class LIBEMBER_API GlowQualifiedParameter : public GlowParameterBase, private libember::util::InstanceCounter<libember::util::Instrumentation::GlowQualifiedParameter>
     {
         friend class GlowNodeFactory;
         public:
@@ -0,0 +1,301 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef __LIBEMBER_GLOW_GLOWREADER_HPP
+#define __LIBEMBER_GLOW_GLOWREADER_HPP
+
+#include <vector>
+#include "../ber/ObjectIdentifier.hpp"
+#include "../ber/Type.hpp"
+#include "../ber/Value.hpp"
+#include "../dom/AsyncBerReader.hpp"
+#include "ConnectionDisposition.hpp"
+#include "ConnectionOperation.hpp"
+#include "GlowType.hpp"
+
+namespace libember { namespace glow
+{
+    /**
+     * Event driven reader for Glow messages. In contrast to the dom::AsyncDomReader,
+     * this reader does not create any dom nodes. Instead, it reports the elements
+     * and their properties while they are being decoded, together with the
+     * path of the element they belong to. The memory required only depends on the
+     * nesting depth of the message, not on the number of elements it contains.
+     * A derived class overrides the notifications it is interested in, all of them
+     * do nothing by default.
+     * @note An element is reported as soon as its number or path has been decoded.
+     *      Glow encoders write the number first, so the properties of an element
+     *      are always reported with its complete path. Properties encoded as
+     *      containers, for example an enumeration map or stream descriptor, are
+     *      skipped.
+     * When schema validation is enabled, the reader also checks the constraints of the
+     * Glow DTD it can verify while decoding: the numbers and paths elements are required
+     * to have, the required properties of a matrix, the types numbers, paths and
+     * properties are encoded with, and the placement of qualified elements. The checks
+     * only use the tags of the current item and a few flags of the containers being
+     * decoded, so a message is validated without building or walking a dom tree.
+     * Properties unknown to the DTD are not checked, so messages of newer versions
+     * remain valid.
+     */
+    class LIBEMBER_API GlowReader : public dom::AsyncBerReader
+    {
+        public:
+            /**
+             * A scoped enumeration type containing the violations of the Glow DTD
+             * detected while schema validation is enabled.
+             */
+            struct ValidationError
+            {
+                enum _Domain
+                {
+                    /** A node, parameter, matrix or function does not contain a number. */
+                    MissingNumber,
+
+                    /** A qualified element does not contain a path. */
+                    MissingPath,
+
+                    /** The path of a qualified element is empty. */
+                    EmptyPath,
+
+                    /** A qualified element is nested within another element. */
+                    NestedQualifiedElement,
+
+                    /** A command does not contain a command number. */
+                    MissingCommandNumber,
+
+                    /** A connection does not contain a target. */
+                    MissingTarget,
+
+                    /** The contents of a matrix lack its identifier, target count or source count. */
+                    MissingProperty,
+
+                    /** A number, path or property is encoded with a type the DTD does not allow. */
+                    TypeMismatch
+                };
+            };
+
+        public:
+            /** Constructor */
+            GlowReader();
+
+            /** Destructor */
+            virtual ~GlowReader();
+
+            /**
+             * Enables or disables the validation of the decoded messages against the
+             * Glow DTD. Violations are reported to validationFailed(). Validation is
+             * disabled by default.
+             * @param enabled true to enable validation, false to disable it.
+             */
+            void setSchemaValidation(bool enabled);
+
+            /**
+             * Returns whether or not schema validation is enabled.
+             * @return true if schema validation is enabled.
+             * @see setSchemaValidation
+             */
+            bool schemaValidation() const;
+
+            /**
+             * Returns a description of the passed validation error.
+             * @param error The error to describe.
+             * @return A static string describing @p error.
+             */
+            static char const* describe(ValidationError::_Domain error);
+
+        protected:
+            /**
+             * Called when the number or path of a node, parameter, matrix or function
+             * has been decoded.
+             * @param type The type of the element, for example GlowType::Parameter
+             *      or GlowType::QualifiedParameter.
+             * @param path The path of the element.
+             */
+            virtual void elementReady(GlowType const& type, ber::ObjectIdentifier const& path);
+
+            /**
+             * Called for every property leaf within the contents set of an element.
+             * @param type The type of the element that owns the property.
+             * @param path The path of the element that owns the property.
+             * @param tag The application tag of the property, which is a context-specific
+             *      tag whose number identifies the property, for example
+             *      ParameterProperty::Value.
+             * @param value The decoded value of the property.
+             */
+            virtual void propertyReady(GlowType const& type, ber::ObjectIdentifier const& path, ber::Tag const& tag, ber::Value const& value);
+
+            /**
+             * Called when an element, including all of its children, has been decoded.
+             * @param type The type of the element.
+             * @param path The path of the element.
+             */
+            virtual void elementDone(GlowType const& type, ber::ObjectIdentifier const& path);
+
+            /**
+             * Called when a command has been decoded.
+             * @param path The path of the element the command has been sent to. The path
+             *      is empty if the command addresses the root.
+             * @param number The command number, for example CommandType::GetDirectory.
+             */
+            virtual void commandReady(ber::ObjectIdentifier const& path, int number);
+
+            /**
+             * Called when a connection of a matrix has been decoded. Together with a
+             * GlowConnectionTable this allows collecting large connection lists without
+             * creating a GlowConnection for each of them.
+             * @param path The path of the matrix the connection belongs to.
+             * @param target The number of the target.
+             * @param sources The numbers of the sources, empty if the connection does
+             *      not contain any sources.
+             * @param operation The connection operation, ConnectionOperation::Absolute
+             *      if it has not been encoded.
+             * @param disposition The connection disposition, ConnectionDisposition::Tally
+             *      if it has not been encoded.
+             */
+            virtual void connectionReady(ber::ObjectIdentifier const& path, int target, ber::ObjectIdentifier const& sources, ConnectionOperation const& operation, ConnectionDisposition const& disposition);
+
+            /**
+             * Called when the outermost container of a message has been decoded.
+             */
+            virtual void rootReady();
+
+            /**
+             * Called when schema validation is enabled and the message violates the Glow DTD.
+             * The default implementation throws a std::runtime_error, which aborts reading
+             * the current buffer; the reader has to be reset before it is used again.
+             * A derived class that only records the error may return, in which case decoding
+             * continues. Values encoded with an invalid type are then ignored, and commands
+             * and connections lacking their number or target are not reported.
+             * @param error The violation that has been detected.
+             * @param type The type of the element or command the violation belongs to.
+             * @param path The path of the element. If the element lacks its number or
+             *      path, this is the path of its parent.
+             * @throw std::runtime_error by the default implementation.
+             */
+            virtual void validationFailed(ValidationError::_Domain error, GlowType const& type, ber::ObjectIdentifier const& path);
+
+            /**
+             * Clears the container stack and the current path.
+             */
+            virtual void resetImpl();
+
+            /**
+             * Pushes a frame describing the container that has just been opened.
+             */
+            virtual void containerReady();
+
+            /**
+             * Updates the current path and reports elements, properties and commands.
+             */
+            virtual void itemReady();
+
+        private:
+            /**
+             * Decodes the value of the current leaf.
+             * @return The decoded value, or a Value in an irregular state if the
+             *      leaf has an unsupported type.
+             */
+            ber::Value decodeValue();
+
+            /**
+             * Tests whether the DTD allows the current item as the property of an element.
+             * @param type The type of the element that owns the property.
+             * @param tag The application tag of the property.
+             * @return True if the type of the current item matches the property, or if
+             *      the property is unknown.
+             */
+            bool isPropertyTypeValid(GlowType::value_type type, ber::Tag const& tag) const;
+
+            /**
+             * Tests whether the current item is a leaf of the passed universal type.
+             * Reports a type mismatch if schema validation is enabled and it is not.
+             * @param type The universal type the DTD requires.
+             * @param owner The type of the element or command the item belongs to.
+             * @return False if the item has to be ignored.
+             */
+            bool expectLeaf(ber::Type::value_type type, GlowType::value_type owner);
+
+        private:
+            /**
+             * Describes a container that is currently being decoded.
+             */
+            struct Frame
+            {
+                enum Kind
+                {
+                    Other,
+                    Element,
+                    QualifiedElement,
+                    Contents,
+                    Command,
+                    Connection
+                };
+
+                /**
+                 * Initializes a new frame.
+                 * @param kind The role the container plays within the message.
+                 * @param type The Glow type of the container, or zero if the container
+                 *      is a universal set or sequence.
+                 */
+                Frame(Kind kind, GlowType::value_type type);
+
+                Kind kind;
+                GlowType::value_type type;
+                bool isAnnounced;
+                bool hasNumber;
+                int number;
+
+                /** The numbers of the properties below 32 decoded within the contents set. */
+                unsigned long properties;
+                ber::ObjectIdentifier outerPath;
+            };
+
+            typedef std::vector<Frame> FrameStack;
+
+            /**
+             * Reports the element described by @p frame if this hasn't already been done.
+             * @param frame The frame of the element.
+             */
+            void announce(Frame& frame);
+
+        private:
+#ifdef _MSC_VER
+#  pragma warning(push)
+#  pragma warning(disable : 4251)
+#endif
+            FrameStack m_frames;
+            ber::ObjectIdentifier m_path;
+            ber::ObjectIdentifier m_connectionSources;
+            int m_connectionTarget;
+            int m_connectionOperation;
+            int m_connectionDisposition;
+#ifdef _MSC_VER
+#  pragma warning(pop)
+#endif
+            bool m_schemaValidation;
+    };
+}
+}
+
+#ifdef LIBEMBER_HEADER_ONLY
+#  include "impl/GlowReader.ipp"
+#endif
+
+#endif  // __LIBEMBER_GLOW_GLOWREADER_HPP
+
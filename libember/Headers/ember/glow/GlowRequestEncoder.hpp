@@ -0,0 +1,124 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+#ifndef __LIBEMBER_GLOW_GLOWREQUESTENCODER_HPP
+#define __LIBEMBER_GLOW_GLOWREQUESTENCODER_HPP
+
+#include <vector>
+#include "../ber/ObjectIdentifier.hpp"
+#include "../util/Api.hpp"
+#include "CommandType.hpp"
+#include "GlowTreeMirror.hpp"
+
+namespace libember { namespace glow
+{
+    /**
+     * Encodes the small requests a consumer sends most often without building a
+     * tree: a command addressing an element and the change of an integer value.
+     * The tags of these messages never change and the command part is a constant
+     * byte sequence, so only the path, the value and the lengths of the enclosing
+     * sequences are filled in. The message is written back to front into a buffer
+     * that keeps its capacity, which allows each length to be encoded after the
+     * content it covers. The encoding is identical to the one of the equivalent
+     * tree of GlowRootElementCollection, GlowQualifiedNode and GlowCommand.
+     */
+    class LIBEMBER_API GlowRequestEncoder
+    {
+        public:
+            typedef unsigned char value_type;
+            typedef value_type const* const_iterator;
+            typedef std::size_t size_type;
+
+            /** Initializes an empty encoder. */
+            GlowRequestEncoder();
+
+            /**
+             * Encodes a command addressing an element. A command with an empty
+             * path is encoded as a command of the root.
+             * @param path The path of the element the command addresses.
+             * @param type The type of the element, which determines its tag.
+             * @param command The command to encode.
+             */
+            void encodeCommand(ber::ObjectIdentifier const& path, GlowTreeMirror::ElementType type, CommandType const& command);
+
+            /**
+             * Encodes the change of an integer parameter.
+             * @param path The path of the parameter.
+             * @param value The new value of the parameter.
+             */
+            void encodeValue(ber::ObjectIdentifier const& path, long value);
+
+            /**
+             * Returns the first byte of the last encoded message.
+             * @return The first byte of the last encoded message.
+             */
+            const_iterator begin() const;
+
+            /**
+             * Returns the byte one past the last byte of the last encoded message.
+             * @return The end of the last encoded message.
+             */
+            const_iterator end() const;
+
+            /**
+             * Returns the number of bytes of the last encoded message.
+             * @return The number of bytes of the last encoded message.
+             */
+            size_type size() const;
+
+        private:
+            /**
+             * Discards the last message and makes room for a message addressing @p path.
+             * @param path The path the next message addresses.
+             */
+            void reset(ber::ObjectIdentifier const& path);
+
+            /** Prepends a sequence of constant bytes. */
+            void prepend(value_type const* first, value_type const* last);
+
+            /** Prepends the path as a RELATIVE-OID frame with the context tag of the path. */
+            void prependPath(ber::ObjectIdentifier const& path);
+
+            /**
+             * Encloses everything written so far in a frame with the passed tag.
+             * @param tag The encoded tag of the frame, which occupies a single byte.
+             */
+            void wrap(value_type tag);
+
+            /** Prepends a length in its shortest definite form. */
+            void prependLength(size_type length);
+
+        private:
+#ifdef _MSC_VER
+#  pragma warning(push)
+#  pragma warning(disable: 4251)
+#endif
+            std::vector<value_type> m_buffer;
+#ifdef _MSC_VER
+#  pragma warning(pop)
+#endif
+            size_type m_first;
+    };
+}
+}
+
+#ifdef LIBEMBER_HEADER_ONLY
+#  include "impl/GlowRequestEncoder.ipp"
+#endif
+
+#endif  // __LIBEMBER_GLOW_GLOWREQUESTENCODER_HPP
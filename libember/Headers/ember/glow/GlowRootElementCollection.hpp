@@ -74,7 +74,7 @@ namespace libember { namespace glow
     template<typename OutputIterator>
     inline GlowContainer::size_type GlowRootElementCollection::elements(OutputIterator dest) const
     {
-        return util::TypeFilter<GlowElement>::collect(begin(), end(), dest);
+        return util::TypeFilter<GlowElement>::collect(childBegin(), childEnd(), dest);
     }
 }
 }
@@ -0,0 +1,437 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef __LIBEMBER_GLOW_GLOWSESSION_HPP
+#define __LIBEMBER_GLOW_GLOWSESSION_HPP
+
+#include <map>
+#include <set>
+#include <vector>
+#include "../ber/ObjectIdentifier.hpp"
+#include "../util/Api.hpp"
+#include "CommandType.hpp"
+#include "GlowInvocation.hpp"
+#include "GlowInvocationTable.hpp"
+#include "GlowTreeMirror.hpp"
+#include "GlowVisitor.hpp"
+#include "Value.hpp"
+
+namespace libember { namespace glow
+{
+    /** Forward declarations */
+    class GlowContentElement;
+    class GlowRootElementCollection;
+
+    /**
+     * The consumer side of a provider connection, which correlates the responses
+     * of the provider with the requests that caused them. Every operation takes a
+     * Continuation, which is resumed once with the outcome of the operation: a
+     * directory request is resumed with the elements of the first message that
+     * reports the requested directory, a value change with the first report of the
+     * parameter and an invocation with its result. Operations the provider does not
+     * answer in time are resumed with Status::TimedOut when expire() is called.
+     * Since a pending operation is a small record in a map rather than a blocked
+     * thread, a single session can keep any number of operations outstanding.
+     * Listeners registered with subscribe() are notified about every report of the
+     * subscribed element and its children until they are unsubscribed.
+     * The session is independent of the transport. The application decodes the
+     * received messages and passes them to providerMessage(), and implements
+     * Connection to send the requests. Continuations and listeners are invoked
+     * by providerMessage() and expire(), so they run on the thread, or executor,
+     * the application calls these methods from. The session is not synchronized.
+     * By default, every request is sent as a message of its own. setBatching()
+     * lets the session gather requests into a single message, which saves the
+     * framing and decoding of a message per request on both ends, e.g. while a
+     * fader is moved or many parameters are subscribed at once.
+     */
+    class LIBEMBER_API GlowSession : private GlowVisitor
+    {
+        public:
+            typedef std::size_t size_type;
+            typedef GlowInvocationTable::tick_type tick_type;
+            typedef std::vector<GlowContentElement const*> ElementCollection;
+            typedef std::vector<ber::ObjectIdentifier> PathCollection;
+
+            /**
+             * Scoped enumeration of the outcomes of an operation.
+             */
+            struct Status
+            {
+                enum _Domain
+                {
+                    /** The provider has answered the operation. */
+                    Completed,
+
+                    /** The provider has not answered the operation in time. */
+                    TimedOut,
+                };
+            };
+
+            /**
+             * The outcome of an operation. The elements belong to the received
+             * message and are only valid while the continuation is resumed.
+             */
+            struct Result
+            {
+                /** Initializes an empty result with the passed status. */
+                explicit Result(Status::_Domain status);
+
+                Status::_Domain status;
+
+                /**
+                 * The reported elements: the children of a requested directory, or
+                 * the element itself if it has no children, and the reported parameter
+                 * of a value change. The path of elements[i] is paths[i].
+                 */
+                ElementCollection elements;
+                PathCollection paths;
+
+                /** The result of an invocation, or null. */
+                GlowInvocationResult const* invocationResult;
+            };
+
+            /**
+             * Interface of the continuation of an operation.
+             */
+            class LIBEMBER_API Continuation
+            {
+                public:
+                    /** Destructor */
+                    virtual ~Continuation();
+
+                    /**
+                     * Called once when the operation has completed or timed out.
+                     * @param result The outcome of the operation.
+                     */
+                    virtual void resume(Result const& result) = 0;
+            };
+
+            /**
+             * Interface notified about the reports of a subscribed element.
+             */
+            class LIBEMBER_API Listener
+            {
+                public:
+                    /** Destructor */
+                    virtual ~Listener();
+
+                    /**
+                     * Called for every report of the subscribed element or one of its
+                     * children. The element is only valid during the call.
+                     * @param path The path of the reported element.
+                     * @param element The reported element.
+                     */
+                    virtual void notify(ber::ObjectIdentifier const& path, GlowContentElement const& element) = 0;
+            };
+
+            /**
+             * Interface of the connection the session writes its requests to.
+             */
+            class LIBEMBER_API Connection
+            {
+                public:
+                    /** Destructor */
+                    virtual ~Connection();
+
+                    /**
+                     * Sends a request. The request is deleted after the call returns.
+                     * @param message The request to send.
+                     */
+                    virtual void write(dom::Node const& message) = 0;
+            };
+
+        public:
+            /**
+             * Initializes a new session without pending operations.
+             * @param provider The connection to the provider. The session does not take
+             *      ownership, the connection must outlive the session.
+             * @param timeout The number of ticks after which an operation the provider
+             *      has not answered times out.
+             */
+            GlowSession(Connection& provider, tick_type timeout);
+
+            /** Destructor, drops all pending operations and requests without resuming or sending them. */
+            virtual ~GlowSession();
+
+            /**
+             * Requests the directory of an element.
+             * @param path The path of the element, empty for the root.
+             * @param continuation The continuation to resume. The session does not take
+             *      ownership, the continuation must remain valid until it is resumed.
+             * @param type The type of the element, which determines the type of the
+             *      qualified element the command is sent in.
+             */
+            void getDirectory(ber::ObjectIdentifier const& path, Continuation* continuation, GlowTreeMirror::ElementType type = GlowTreeMirror::Node);
+
+            /**
+             * Sets the value of a parameter. The operation completes when the provider
+             * reports the parameter, usually with the new value.
+             * @param path The path of the parameter.
+             * @param value The new value.
+             * @param continuation The continuation to resume.
+             */
+            void setValue(ber::ObjectIdentifier const& path, Value const& value, Continuation* continuation);
+
+            /**
+             * Invokes a function.
+             * @param path The path of the function.
+             * @param first The first argument value.
+             * @param last The end of the argument values.
+             * @param continuation The continuation to resume with the invocation result.
+             */
+            template<typename InputIterator>
+            void invoke(ber::ObjectIdentifier const& path, InputIterator first, InputIterator last, Continuation* continuation);
+
+            /**
+             * Registers a listener for the reports of an element and its children. The
+             * provider receives a subscribe command when the first listener subscribes.
+             * @param path The path of the element.
+             * @param listener The listener to notify. The session does not take ownership,
+             *      the listener must remain valid until it is unsubscribed.
+             * @param type The type of the element.
+             */
+            void subscribe(ber::ObjectIdentifier const& path, Listener* listener, GlowTreeMirror::ElementType type = GlowTreeMirror::Node);
+
+            /**
+             * Removes a listener. The provider receives an unsubscribe command when the
+             * last listener of the element unsubscribes.
+             * @param path The path of the element.
+             * @param listener The listener to remove.
+             */
+            void unsubscribe(ber::ObjectIdentifier const& path, Listener* listener);
+
+            /**
+             * Removes all pending operations of a continuation without resuming it.
+             * @param continuation The continuation whose operations to remove.
+             * @return The number of removed operations.
+             */
+            size_type cancel(Continuation* continuation);
+
+            /**
+             * Returns the number of pending operations.
+             * @return The number of pending operations.
+             */
+            size_type pendingCount() const;
+
+            /**
+             * Makes the session gather requests into a single message, which is sent
+             * when it contains @p maxRequests requests, when @p window ticks have passed
+             * since its first request was gathered, or when flush() is called. The
+             * requests keep the order they have been made in.
+             * @param maxRequests The number of requests after which a message is sent.
+             *      1, the default, sends every request immediately.
+             * @param window The number of ticks a request may wait for others. The
+             *      window is checked by expire().
+             */
+            void setBatching(size_type maxRequests, tick_type window);
+
+            /**
+             * Sends the gathered requests, if there are any.
+             */
+            void flush();
+
+            /**
+             * Returns the number of requests that have been gathered but not sent yet.
+             * @return The number of requests that have not been sent yet.
+             */
+            size_type batchedCount() const;
+
+            /**
+             * Processes a message received from the provider, resuming the continuations
+             * of all operations it answers and notifying the interested listeners.
+             * @param message The received message.
+             */
+            void providerMessage(dom::Node const& message);
+
+            /**
+             * Resumes the operations whose deadline has passed with Status::TimedOut
+             * and sends the gathered requests whose batching window has passed.
+             * The application calls this method periodically, the passed tick is also
+             * used to calculate the deadlines of new operations.
+             * @param now The current tick.
+             * @return The number of operations that have timed out.
+             */
+            size_type expire(tick_type now);
+
+        private:
+            /**
+             * Orders object identifiers lexicographically, so they can be used as keys.
+             */
+            struct PathLess
+            {
+                bool operator()(ber::ObjectIdentifier const& lhs, ber::ObjectIdentifier const& rhs) const;
+            };
+
+            /**
+             * Scoped enumeration of the kinds of pending operations.
+             */
+            struct OperationKind
+            {
+                enum _Domain
+                {
+                    Directory,
+                    Value,
+                };
+            };
+
+            /**
+             * An operation waiting for a report of the element at its path.
+             */
+            struct Operation
+            {
+                Operation(OperationKind::_Domain kind, Continuation* continuation, tick_type deadline);
+
+                OperationKind::_Domain kind;
+                Continuation* continuation;
+                tick_type deadline;
+            };
+
+            /**
+             * Resumes the continuation of an invocation with its result.
+             */
+            class PendingInvocation : public GlowInvocationTable::Callback
+            {
+                public:
+                    PendingInvocation(GlowSession& session, Continuation* continuation);
+
+                    /** @see GlowInvocationTable::Callback::completed() */
+                    virtual void completed(int invocationId, GlowInvocationResult const& result);
+
+                    /** @see GlowInvocationTable::Callback::timedOut() */
+                    virtual void timedOut(int invocationId);
+
+                    GlowSession& session;
+                    Continuation* continuation;
+                    int invocationId;
+            };
+
+            typedef std::multimap<ber::ObjectIdentifier, Operation, PathLess> OperationMap;
+            typedef std::multimap<ber::ObjectIdentifier, Listener*, PathLess> ListenerMap;
+            typedef std::map<Operation const*, Result> ResultMap;
+            typedef std::set<PendingInvocation*> InvocationSet;
+
+            /** Adds a pending operation waiting for a report of the element at @p path. */
+            void add(ber::ObjectIdentifier const& path, OperationKind::_Domain kind, Continuation* continuation);
+
+            /** Creates the invocation of a new pending invocation. */
+            GlowInvocation* createInvocation(Continuation* continuation);
+
+            /** Sends a pending invocation to the provider. */
+            void sendInvocation(ber::ObjectIdentifier const& path, GlowInvocation* invocation);
+
+            /** Returns the message gathering the requests, creating it if necessary. */
+            GlowRootElementCollection& request();
+
+            /** Counts a request added to the gathered message, sending it when it is full. */
+            void requestAdded();
+
+            /** Sends a command for the element with the passed path to the provider. */
+            void command(ber::ObjectIdentifier const& path, GlowTreeMirror::ElementType type, CommandType const& command);
+
+            /** Handles an element of a received message, m_path contains its path. */
+            void element(GlowContentElement const& glow, GlowTreeMirror::ElementType type, GlowElementCollection const* children);
+
+            /** Adds an element to the results of the operations of the passed kind waiting at @p key. */
+            void collect(ber::ObjectIdentifier const& key, OperationKind::_Domain kind, GlowContentElement const& glow);
+
+            /** Notifies the listeners subscribed at @p key about an element. */
+            void notify(ber::ObjectIdentifier const& key, GlowContentElement const& glow);
+
+            /**
+             * Appends a qualified element with the passed type and path to a message.
+             * @return The new element.
+             */
+            static GlowContentElement* createElement(GlowRootElementCollection& message, GlowTreeMirror::ElementType type, ber::ObjectIdentifier const& path);
+
+            /** Returns the children of an element created by createElement(), creating the collection if necessary. */
+            static GlowElementCollection* childrenOf(GlowContentElement& element, GlowTreeMirror::ElementType type);
+
+            /** Tests whether @p deadline is not after @p now, tolerating a wrap-around of the clock. */
+            static bool isDue(tick_type deadline, tick_type now);
+
+            /** Returns the path of the parent of an element. */
+            static ber::ObjectIdentifier parentOf(ber::ObjectIdentifier const& path);
+
+            virtual void visit(GlowRootElementCollection const& glow);
+            virtual void visit(GlowElementCollection const& glow);
+            virtual void visit(GlowNode const& glow);
+            virtual void visit(GlowQualifiedNode const& glow);
+            virtual void visit(GlowParameter const& glow);
+            virtual void visit(GlowQualifiedParameter const& glow);
+            virtual void visit(GlowMatrix const& glow);
+            virtual void visit(GlowQualifiedMatrix const& glow);
+            virtual void visit(GlowFunction const& glow);
+            virtual void visit(GlowQualifiedFunction const& glow);
+            virtual void visit(GlowInvocationResult const& glow);
+
+        private:
+            /** Prohibit copying */
+            GlowSession(GlowSession const&);
+
+            /** Prohibit assignment */
+            GlowSession& operator=(GlowSession const&);
+
+        private:
+#ifdef _MSC_VER
+#  pragma warning(push)
+#  pragma warning(disable: 4251)
+#endif
+            Connection& m_provider;
+            tick_type const m_timeout;
+            tick_type m_now;
+            OperationMap m_operations;
+            ListenerMap m_listeners;
+            GlowInvocationTable m_invocations;
+            InvocationSet m_pendingInvocations;
+            ber::ObjectIdentifier m_path;
+
+            /** The results of the operations answered by the message being processed. */
+            ResultMap m_results;
+
+            /** The operations answered by the message being processed, in the order they were answered. */
+            std::vector<OperationMap::iterator> m_answered;
+#ifdef _MSC_VER
+#  pragma warning(pop)
+#endif
+            GlowRootElementCollection* m_request;
+            size_type m_requestCount;
+            tick_type m_requestStart;
+            size_type m_maxRequests;
+            tick_type m_window;
+    };
+
+    /**************************************************************************
+     * Inline implementation                                                  *
+     **************************************************************************/
+
+    template<typename InputIterator>
+    inline void GlowSession::invoke(ber::ObjectIdentifier const& path, InputIterator first, InputIterator last, Continuation* continuation)
+    {
+        GlowInvocation* const invocation = createInvocation(continuation);
+        invocation->setTypedArguments(first, last);
+        sendInvocation(path, invocation);
+    }
+}
+}
+
+#ifdef LIBEMBER_HEADER_ONLY
+#  include "impl/GlowSession.ipp"
+#endif
+
+#endif  // __LIBEMBER_GLOW_GLOWSESSION_HPP
@@ -86,6 +86,15 @@ namespace libember { namespace glow
             template<typename InputIterator>
             void insert(int streamIdentifier, InputIterator first, InputIterator last);
 
+            /**
+             * Insert a new StreamEntry whose value refers to an existing byte array without
+             * copying it. The referenced bytes must remain valid until the collection has been
+             * encoded or destroyed.
+             * @param streamIdentifier The stream identifier.
+             * @param value The bytes of the stream value.
+             */
+            void insert(int streamIdentifier, ber::OctetsView const& value);
+
         private:
             /**
              * Initializes an empty stream collection with the provided application tag.
@@ -0,0 +1,176 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef __LIBEMBER_GLOW_GLOWSTREAMDECODER_HPP
+#define __LIBEMBER_GLOW_GLOWSTREAMDECODER_HPP
+
+#include <map>
+#include <vector>
+#include "../ber/OctetsView.hpp"
+#include "../util/Api.hpp"
+#include "StreamFormat.hpp"
+
+namespace libember { namespace glow
+{
+    /** Forward declarations */
+    class GlowStreamCollection;
+    class GlowStreamEntry;
+
+    /**
+     * Decodes the values that several parameters share in the octets of a single stream entry.
+     * Each parameter subscribes with the format and offset of its stream descriptor. The
+     * subscriptions of a stream are kept sorted by format and offset, so a received entry is
+     * unpacked in a single pass, which selects the decoding loop once for every run of values
+     * with the same format and reads the octets in place without copying them.
+     * Derived classes override integerDecoded and realDecoded to receive the decoded values.
+     */
+    class LIBEMBER_API GlowStreamDecoder
+    {
+        public:
+            typedef std::size_t size_type;
+
+        public:
+            /** Initializes a decoder without subscriptions. */
+            GlowStreamDecoder();
+
+            /** Destructor */
+            virtual ~GlowStreamDecoder();
+
+            /**
+             * Subscribes to a value stored in the octets of a stream.
+             * @param streamIdentifier The stream identifier of the parameter.
+             * @param format The format of the value, as reported by the stream descriptor.
+             * @param offset The offset of the value within the octets, as reported by the
+             *      stream descriptor. Subscriptions with a negative offset are ignored.
+             * @param subscriber A caller-defined value, which is passed to the callbacks, for
+             *      example the index of the parameter.
+             */
+            void subscribe(int streamIdentifier, StreamFormat const& format, int offset, int subscriber);
+
+            /**
+             * Removes all subscriptions of a subscriber to a stream.
+             * @param streamIdentifier The stream identifier the subscriber subscribed to.
+             * @param subscriber The subscriber to remove.
+             */
+            void unsubscribe(int streamIdentifier, int subscriber);
+
+            /**
+             * Removes all subscriptions.
+             */
+            void clear();
+
+            /**
+             * Decodes all entries of a stream collection. Entries whose value is not an octet
+             * string are ignored, since their values do not need to be unpacked.
+             * @param collection The stream collection to decode.
+             * @return The number of values that have been decoded.
+             */
+            size_type decode(GlowStreamCollection const& collection);
+
+            /**
+             * Decodes the entry of a single stream.
+             * @param entry The entry to decode.
+             * @return The number of values that have been decoded.
+             */
+            size_type decode(GlowStreamEntry const& entry);
+
+            /**
+             * Decodes the octets of a stream, for example an entry that has been received
+             * through a GlowReader. Values that exceed the octets are not reported.
+             * @param streamIdentifier The identifier of the stream.
+             * @param octets The octets of the stream value.
+             * @return The number of values that have been decoded.
+             */
+            size_type decode(int streamIdentifier, ber::OctetsView const& octets);
+
+        protected:
+            /**
+             * Called for each decoded value of an integer format. Unsigned 64 bit values
+             * exceeding the range of long long are reported as negative numbers. Does
+             * nothing by default.
+             * @param subscriber The subscriber the value has been decoded for.
+             * @param value The decoded value.
+             */
+            virtual void integerDecoded(int subscriber, long long value);
+
+            /**
+             * Called for each decoded value of a floating point format. Does nothing by default.
+             * @param subscriber The subscriber the value has been decoded for.
+             * @param value The decoded value.
+             */
+            virtual void realDecoded(int subscriber, double value);
+
+        private:
+            /**
+             * A single subscription to the value at an offset of a stream.
+             */
+            struct Field
+            {
+                Field(StreamFormat::value_type format, size_type offset, int subscriber);
+
+                bool operator<(Field const& other) const;
+
+                StreamFormat::value_type format;
+                size_type offset;
+                int subscriber;
+            };
+
+            typedef std::vector<Field> FieldCollection;
+            typedef std::map<int, FieldCollection> StreamMap;
+            typedef FieldCollection::const_iterator const_iterator;
+            typedef ber::OctetsView::value_type value_type;
+
+            /**
+             * Decodes a run of fields with the same integer format.
+             * @return The number of values that have been decoded.
+             */
+            template<size_type Width, bool IsBigEndian, bool IsSigned>
+            size_type decodeIntegers(const_iterator first, const_iterator last, ber::OctetsView const& octets);
+
+            /**
+             * Decodes a run of fields with the same floating point format.
+             * @return The number of values that have been decoded.
+             */
+            template<size_type Width, bool IsBigEndian>
+            size_type decodeReals(const_iterator first, const_iterator last, ber::OctetsView const& octets);
+
+            /**
+             * Assembles Width bytes to an unsigned integer.
+             */
+            template<size_type Width, bool IsBigEndian>
+            static unsigned long long read(value_type const* data);
+
+        private:
+#ifdef _MSC_VER
+#  pragma warning(push)
+#  pragma warning(disable : 4251)
+#endif
+            StreamMap m_streams;
+#ifdef _MSC_VER
+#  pragma warning(pop)
+#endif
+    };
+}
+}
+
+#ifdef LIBEMBER_HEADER_ONLY
+#  include "impl/GlowStreamDecoder.ipp"
+#endif
+
+#endif  // __LIBEMBER_GLOW_GLOWSTREAMDECODER_HPP
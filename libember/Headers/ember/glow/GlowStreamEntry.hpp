@@ -21,6 +21,8 @@
 #define __LIBEMBER_GLOW_GLOWSTREAMENTRY_HPP
 
 #include "../ber/Octets.hpp"
+#include "../ber/OctetsView.hpp"
+#include "../util/Instrumentation.hpp"
 #include "GlowContainer.hpp"
 #include "Value.hpp"
 
@@ -30,7 +32,7 @@ namespace libember { namespace glow
      * A GlowStreamEntry represents a single audio level meter entry.
      * It contains a unique stream identifier and its current value in 1/32 dB steps.
      */
-    class LIBEMBER_API GlowStreamEntry : public GlowContainer
+    class LIBEMBER_API GlowStreamEntry : public GlowContainer, private libember::util::InstanceCounter<libember::util::Instrumentation::GlowStreamEntry>
     {
         public:
             /**
@@ -69,6 +71,16 @@ namespace libember { namespace glow
             template<typename InputIterator>
             GlowStreamEntry(int streamIdentifier, InputIterator first, InputIterator last);
 
+            /**
+             * Constructor, initializes a stream entry with a stream identifier and a value that
+             * refers to an existing byte array without copying it. This allows forwarding the
+             * octets of a received entry, the referenced bytes must remain valid until the
+             * entry has been encoded or destroyed.
+             * @param streamIdentifier The stream identifier to set.
+             * @param value The bytes of the stream's current value.
+             */
+            GlowStreamEntry(int streamIdentifier, ber::OctetsView const& value);
+
             /**
              * Returns the value of the stream identifier
              * @return The stream identifier or -1 if the container does not contain this value.
@@ -80,6 +92,14 @@ namespace libember { namespace glow
              * @return The stream value.
              */
             Value value() const;
+
+            /**
+             * Returns a view onto the stream value if it is an octet string. Unlike value(),
+             * this method neither decodes nor copies the bytes.
+             * @return A view onto the stream value, which remains valid until this entry is
+             *      modified or destroyed, or an empty view if the value is not an octet string.
+             */
+            ber::OctetsView octets() const;
     };
 
     /**************************************************************************
@@ -20,6 +20,7 @@
 #ifndef __LIBEMBER_GLOW_GLOWSTRINGINTEGERCOLLECTION_HPP
 #define __LIBEMBER_GLOW_GLOWSTRINGINTEGERCOLLECTION_HPP
 
+#include "EnumerationPool.hpp"
 #include "GlowElement.hpp"
 
 namespace libember { namespace glow
@@ -53,6 +54,35 @@ namespace libember { namespace glow
              *      to the remote device.
              */
             void insert(std::string const& name, int value);
+
+            /**
+             * Decodes the name-value pairs of this collection.
+             * @return The name-value pairs of this collection.
+             */
+            Enumeration enumeration() const;
+
+            /**
+             * Returns the decoded entries of this collection, which are indexed by value and
+             * by name. The table is interned in @p pool, so parameters with identical maps
+             * share it. It is cached by the collection, so the pairs are only decoded again
+             * after a pair has been inserted or removed or the pool has been cleared.
+             * @param pool The pool to intern the entries in. The pool must not be destroyed
+             *      while the collection uses it, unless it is cleared before.
+             * @return The shared table of the entries.
+             */
+            EnumerationPool::Table const* table(EnumerationPool& pool) const;
+
+        protected:
+            /** Discards the cached table and inserts the child. */
+            virtual iterator insertImpl(iterator const& where, Node* child);
+
+            /** Discards the cached table and removes the children. */
+            virtual void eraseImpl(iterator const& first, iterator const& last);
+
+        private:
+            mutable EnumerationPool const* m_pool;
+            mutable EnumerationPool::size_type m_generation;
+            mutable EnumerationPool::Table const* m_table;
     };
 
     /**************************************************************************
@@ -62,6 +92,9 @@ namespace libember { namespace glow
     template<typename InputIterator>
     inline GlowStringIntegerCollection::GlowStringIntegerCollection(ber::Tag const& tag, InputIterator first, InputIterator last)
         : GlowElement(GlowType::StringIntegerCollection, tag)
+        , m_pool(0)
+        , m_generation(0)
+        , m_table(0)
     {
         for ( ; first != last; ++first)
         {
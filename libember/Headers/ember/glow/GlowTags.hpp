@@ -52,6 +52,14 @@ namespace libember { namespace glow
              * @return The tag of the invocation property.
              */
             static ber::Tag Invocation();
+
+            /**
+             * Returns the tag of the sequence number property, which is used by the
+             * GetChangesSince extension. The tag lies outside of the range used
+             * by the standard command properties.
+             * @return The tag of the sequence number property.
+             */
+            static ber::Tag Sequence();
         };
 
         struct LIBEMBER_API NodeContents
@@ -0,0 +1,288 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef __LIBEMBER_GLOW_GLOWTREEBROWSER_HPP
+#define __LIBEMBER_GLOW_GLOWTREEBROWSER_HPP
+
+#include <deque>
+#include <map>
+#include <set>
+#include "../ber/ObjectIdentifier.hpp"
+#include "../util/Api.hpp"
+#include "GlowSession.hpp"
+#include "GlowTreeMirror.hpp"
+
+namespace libember { namespace glow
+{
+    /**
+     * Expands the tree of a provider on demand, as a consumer showing the tree in a
+     * browsable view does. Instead of synchronizing the complete tree, the directory
+     * of a node is only requested when the node is expanded, and the received elements
+     * are stored in a GlowTreeMirror.
+     * To hide the round trip of an expansion, the browser prefetches the directories of
+     * the nodes the application reports as visible, so they are usually known when the
+     * user expands one of them. The prefetches are pipelined: up to a configurable number
+     * of them are outstanding, and they are sent in batches, which GlowSession gathers
+     * into a single message if its batching is enabled. When a prefetch completes, the
+     * next batch is sent even if it is incomplete, so the pipeline does not stall. An
+     * expansion requested by the application is always sent immediately, ahead of the
+     * queued prefetches.
+     * Prefetching a node whose children are all parameters transfers a lot of data for
+     * a node the user may never open. Once a node with at least the configured number
+     * of children turns out to contain nothing but parameters, the browser assumes that
+     * its siblings are built alike, as the channels of a mixer are, and no longer
+     * prefetches them. They are still fetched when they are expanded.
+     * The browser uses the session to send its requests, and the application passes the
+     * received messages to providerMessage(), which merges them into the mirror before
+     * they are passed on to the session. Like the session, the browser is not synchronized.
+     */
+    class LIBEMBER_API GlowTreeBrowser
+    {
+        public:
+            typedef std::size_t size_type;
+
+            /**
+             * Interface notified about the expansions requested by the application.
+             */
+            class LIBEMBER_API Listener
+            {
+                public:
+                    /** Destructor */
+                    virtual ~Listener();
+
+                    /**
+                     * Called when the directory of a node the application has expanded has
+                     * been received and merged into the mirror, or has not been received in time.
+                     * @param path The path of the expanded node.
+                     * @param isComplete True if the directory has been received, false if the
+                     *      request has timed out. A node that has timed out may be expanded again.
+                     */
+                    virtual void expanded(ber::ObjectIdentifier const& path, bool isComplete) = 0;
+            };
+
+        public:
+            /**
+             * Initializes a new browser, which does not know any directory yet.
+             * @param session The session used to request the directories. The browser does not
+             *      take ownership, the session must outlive the browser.
+             * @param mirror The mirror the received messages are merged into. The browser does
+             *      not take ownership, the mirror must outlive the browser.
+             * @param listener The listener to notify about completed expansions, or null.
+             */
+            GlowTreeBrowser(GlowSession& session, GlowTreeMirror& mirror, Listener* listener);
+
+            /** Destructor, cancels the pending requests of the browser. */
+            ~GlowTreeBrowser();
+
+            /**
+             * Configures prefetching.
+             * @param depth The number of prefetches that may be outstanding at once, 16 by
+             *      default. 0 disables prefetching.
+             * @param batchSize The number of prefetches sent at once, 4 by default. A batch
+             *      is sent once the pipeline has room for all of its requests.
+             * @param wideThreshold The number of children from which a node that only contains
+             *      parameters stops the prefetching of its siblings, 64 by default.
+             */
+            void setPrefetching(size_type depth, size_type batchSize, size_type wideThreshold);
+
+            /**
+             * Expands a node, requesting its directory if it is not known yet. If the directory
+             * is being prefetched, the running request is used and no new one is sent.
+             * @param path The path of the node, empty for the root.
+             * @return True if the directory is already known, in which case the listener
+             *      is not notified. Otherwise the listener is notified once the directory
+             *      has been received.
+             */
+            bool expand(ber::ObjectIdentifier const& path);
+
+            /**
+             * Reports whether a node is visible. The directories of visible nodes are
+             * prefetched in the order in which the nodes have become visible, and a
+             * node that is hidden before its prefetch has been sent is not prefetched.
+             * Only complete batches are sent right away, so the application calls flush()
+             * once it has reported all nodes that have become visible, e.g. when its view
+             * has been scrolled.
+             * @param path The path of the node.
+             * @param isVisible True if the node is visible.
+             */
+            void setVisible(ber::ObjectIdentifier const& path, bool isVisible);
+
+            /**
+             * Sends the queued prefetches the pipeline has room for, including an
+             * incomplete batch.
+             */
+            void flush();
+
+            /**
+             * Returns whether the directory of a node has been received.
+             * @param path The path of the node.
+             * @return True if the directory has been received.
+             */
+            bool isExpanded(ber::ObjectIdentifier const& path) const;
+
+            /**
+             * Forgets the directory of a node, so it is requested again when the node is
+             * expanded or becomes visible. The mirror is not changed.
+             * @param path The path of the node.
+             */
+            void invalidate(ber::ObjectIdentifier const& path);
+
+            /**
+             * Processes a message received from the provider. The message is merged into
+             * the mirror, and then passed to the session, which completes the expansions
+             * it answers.
+             * @param message The received message.
+             */
+            void providerMessage(dom::Node const& message);
+
+            /**
+             * Returns the number of directory requests that have not been answered yet.
+             * @return The number of pending requests.
+             */
+            size_type pendingCount() const;
+
+            /**
+             * Returns the number of visible nodes waiting for their prefetch to be sent.
+             * @return The number of queued prefetches.
+             */
+            size_type queuedCount() const;
+
+        private:
+            /**
+             * Orders object identifiers lexicographically, so they can be used as keys.
+             */
+            struct PathLess
+            {
+                bool operator()(ber::ObjectIdentifier const& lhs, ber::ObjectIdentifier const& rhs) const;
+            };
+
+            /**
+             * The continuation of a single directory request.
+             */
+            class Request : public GlowSession::Continuation
+            {
+                public:
+                    Request(GlowTreeBrowser& browser, ber::ObjectIdentifier const& path, bool isPrefetch);
+
+                    /** @see GlowSession::Continuation::resume() */
+                    virtual void resume(GlowSession::Result const& result);
+
+                    GlowTreeBrowser& browser;
+                    ber::ObjectIdentifier const path;
+                    bool const isPrefetch;
+            };
+
+            /**
+             * Scoped enumeration of the states of a directory.
+             */
+            struct DirectoryState
+            {
+                enum _Domain
+                {
+                    /** The node is visible and waits for its prefetch to be sent. */
+                    Queued,
+
+                    /** The directory has been requested. */
+                    Pending,
+
+                    /** The directory has been received. */
+                    Known,
+                };
+            };
+
+            /**
+             * The state of the directory of a node. Nodes whose directory has neither been
+             * requested nor queued have no entry.
+             */
+            struct Entry
+            {
+                explicit Entry(DirectoryState::_Domain state);
+
+                DirectoryState::_Domain state;
+
+                /** True if the application has expanded the node and waits for the listener. */
+                bool isExpanding;
+
+                /** The request, while the state is Pending. */
+                Request* request;
+            };
+
+            typedef std::map<ber::ObjectIdentifier, Entry, PathLess> EntryMap;
+            typedef std::deque<ber::ObjectIdentifier> PathQueue;
+            typedef std::set<ber::ObjectIdentifier, PathLess> PathSet;
+
+            /** Requests the directory of a node and marks it pending. */
+            void request(ber::ObjectIdentifier const& path, Entry& entry, bool isPrefetch);
+
+            /** Called by a request when it has been resumed. */
+            void completed(Request* request, GlowSession::Result const& result);
+
+            /**
+             * Sends the queued prefetches the pipeline has room for.
+             * @param isPartial True if an incomplete batch may be sent.
+             */
+            void prefetch(bool isPartial);
+
+            /** Tests whether the children of a received node are all parameters and many. */
+            bool isWideParameterNode(ber::ObjectIdentifier const& path) const;
+
+            /** Removes a path from the prefetch queue. */
+            void dequeue(ber::ObjectIdentifier const& path);
+
+            /** Returns the type a directory request for an element is sent with. */
+            GlowTreeMirror::ElementType typeOf(ber::ObjectIdentifier const& path) const;
+
+            /** Returns the path of the parent of an element. */
+            static ber::ObjectIdentifier parentOf(ber::ObjectIdentifier const& path);
+
+        private:
+            /** Prohibit copying */
+            GlowTreeBrowser(GlowTreeBrowser const&);
+
+            /** Prohibit assignment */
+            GlowTreeBrowser& operator=(GlowTreeBrowser const&);
+
+        private:
+#ifdef _MSC_VER
+#  pragma warning(push)
+#  pragma warning(disable: 4251)
+#endif
+            GlowSession& m_session;
+            GlowTreeMirror& m_mirror;
+            Listener* m_listener;
+            EntryMap m_entries;
+            PathQueue m_queue;
+            /** The parents whose children are not prefetched, since they are wide parameter nodes. */
+            PathSet m_wideParents;
+#ifdef _MSC_VER
+#  pragma warning(pop)
+#endif
+            size_type m_depth;
+            size_type m_batchSize;
+            size_type m_wideThreshold;
+            size_type m_prefetching;
+    };
+}
+}
+
+#ifdef LIBEMBER_HEADER_ONLY
+#  include "impl/GlowTreeBrowser.ipp"
+#endif
+
+#endif  // __LIBEMBER_GLOW_GLOWTREEBROWSER_HPP
@@ -0,0 +1,199 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef __LIBEMBER_GLOW_GLOWTREEDIFF_HPP
+#define __LIBEMBER_GLOW_GLOWTREEDIFF_HPP
+
+#include <vector>
+#include "../ber/ObjectIdentifier.hpp"
+#include "../util/Api.hpp"
+#include "GlowTreeMirror.hpp"
+
+namespace libember { namespace glow
+{
+    /** Forward declarations */
+    class GlowMatrixBase;
+    class GlowRootElementCollection;
+
+    /**
+     * Computes the structural differences between two versions of a provider's tree, for
+     * example before and after a device description has been reloaded, so that only the
+     * elements and properties that actually changed need to be announced to consumers
+     * instead of the complete tree.
+     * Both trees are merged into mirrors that retain the encoded properties, and the
+     * elements are matched by their number paths. Properties are compared by their
+     * encoding, so the comparison does not depend on the element types or properties
+     * the mirror interprets. Subtrees whose hashes are equal in both mirrors are skipped,
+     * so the cost of a comparison mostly depends on the size of the changes, apart from
+     * merging the trees. The diff owns both mirrors, so the differences and the
+     * notification refer to them until the next comparison.
+     */
+    class LIBEMBER_API GlowTreeDiff
+    {
+        public:
+            typedef std::size_t size_type;
+
+            /**
+             * Enumeration of the kinds of differences.
+             */
+            enum DifferenceType
+            {
+                /** The element only exists in the current tree. */
+                Added,
+
+                /** The element only exists in the previous tree. Its descendants are not reported. */
+                Removed,
+
+                /** The element exists in both trees, but some of its properties or connections differ. */
+                Changed
+            };
+
+            /**
+             * A single added, removed or changed element.
+             */
+            struct Difference
+            {
+                typedef std::vector<unsigned int> PropertyCollection;
+
+                /** Initializes a difference without changed properties. */
+                Difference(DifferenceType type, GlowTreeMirror::ElementType elementType, ber::ObjectIdentifier const& path);
+
+                DifferenceType type;
+                GlowTreeMirror::ElementType elementType;
+                ber::ObjectIdentifier path;
+
+                /**
+                 * The context-specific tag numbers of the properties of the current tree that
+                 * are new or differ from the previous tree, ascending. Contains all properties
+                 * of an added element and none of a removed one. Properties that have only
+                 * been removed are not listed, since Glow can't announce their removal.
+                 */
+                PropertyCollection properties;
+
+                /** True if the targets, sources or connections of a matrix differ. */
+                bool connectionsChanged;
+            };
+
+            typedef std::vector<Difference> DifferenceCollection;
+
+        public:
+            /** Initializes a diff without differences. */
+            GlowTreeDiff();
+
+            /**
+             * Compares two trees, usually GlowRootElementCollections. Qualified as well as
+             * non-qualified elements are accepted.
+             * @param previous The tree that has been announced to the consumers so far.
+             * @param current The new tree.
+             * @return The number of differences.
+             */
+            size_type compare(dom::Node const& previous, dom::Node const& current);
+
+            /**
+             * Compares a new tree with the current tree of the last comparison, which
+             * becomes the previous tree, so successive reloads only decode the new tree.
+             * @param current The new tree.
+             * @return The number of differences.
+             */
+            size_type update(dom::Node const& current);
+
+            /**
+             * Returns the differences found by the last comparison, in the order of the
+             * current tree, followed by the removed elements in the order of the previous tree.
+             * @return The differences.
+             */
+            DifferenceCollection const& differences() const;
+
+            /**
+             * Returns the mirror containing the current tree.
+             * @return The mirror of the current tree.
+             */
+            GlowTreeMirror const& current() const;
+
+            /**
+             * Creates a message that announces the differences to a consumer which knows
+             * the previous tree. It contains a qualified element for each added element
+             * with all of its properties, and for each changed element with the changed
+             * properties and, for matrices, the complete targets, sources and connections.
+             * Removed nodes and parameters are reported offline, since Glow has no element
+             * removal. Removed matrices and functions can't be announced.
+             * @return The new message, which has to be deleted by the caller, or null if
+             *      there is nothing to announce.
+             */
+            GlowRootElementCollection* createNotification() const;
+
+        private:
+            /**
+             * Compares the mirrors and stores the differences.
+             */
+            size_type compare();
+
+            /**
+             * Compares the children of two elements with the same path. Removed children are
+             * appended to @p removed.
+             */
+            void compareChildren(GlowTreeMirror::Element const& previous, GlowTreeMirror::Element const& current, DifferenceCollection& removed);
+
+            /**
+             * Compares the properties of an element that exists in both trees and stores a
+             * difference if any of them differ.
+             */
+            void compareElement(GlowTreeMirror::Element const& previous, GlowTreeMirror::Element const& current);
+
+            /**
+             * Stores an added difference for an element and all its descendants.
+             */
+            void addSubtree(GlowTreeMirror::Element const& current);
+
+            /**
+             * Returns true if the signals or connections of two matrices differ.
+             */
+            static bool isDifferent(GlowTreeMirror::MatrixState const& previous, GlowTreeMirror::MatrixState const& current);
+
+            /**
+             * Inserts the targets, sources and connections of a matrix state into a matrix.
+             */
+            static void insertConnections(GlowMatrixBase& matrix, GlowTreeMirror::MatrixState const& state);
+
+            /** Prohibit copies */
+            GlowTreeDiff(GlowTreeDiff const&);
+            GlowTreeDiff& operator=(GlowTreeDiff const&);
+
+        private:
+#ifdef _MSC_VER
+#  pragma warning(push)
+#  pragma warning(disable : 4251)
+#endif
+            GlowTreeMirror m_first;
+            GlowTreeMirror m_second;
+            DifferenceCollection m_differences;
+#ifdef _MSC_VER
+#  pragma warning(pop)
+#endif
+            GlowTreeMirror* m_previous;
+            GlowTreeMirror* m_current;
+    };
+}
+}
+
+#ifdef LIBEMBER_HEADER_ONLY
+#  include "impl/GlowTreeDiff.ipp"
+#endif
+
+#endif  // __LIBEMBER_GLOW_GLOWTREEDIFF_HPP
@@ -0,0 +1,732 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef __LIBEMBER_GLOW_GLOWTREEMIRROR_HPP
+#define __LIBEMBER_GLOW_GLOWTREEMIRROR_HPP
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#include "../ber/ObjectIdentifier.hpp"
+#include "../dom/Sequence.hpp"
+#include "Access.hpp"
+#include "EnumerationPool.hpp"
+#include "GlowType.hpp"
+#include "GlowVisitor.hpp"
+#include "MatrixAddressingMode.hpp"
+#include "MatrixType.hpp"
+#include "MinMax.hpp"
+#include "ParameterType.hpp"
+#include "Value.hpp"
+
+namespace libember { namespace glow
+{
+    /** Forward declarations */
+    class GlowConnection;
+    class GlowContainer;
+    class GlowFunctionBase;
+    class GlowMatrixBase;
+    class GlowNodeBase;
+    class GlowParameterBase;
+
+    /**
+     * A consumer side mirror of the tree of a provider, which stores the last known state
+     * of every node, parameter, matrix and function that has been received.
+     * Each received message is merged into the mirror with merge(), which accepts qualified
+     * as well as non-qualified elements and only overwrites the properties contained in the
+     * message. The received messages do not need to be retained.
+     * All elements are stored in a single vector, and the children of an element are found
+     * with a hash index keyed by the element's parent and number. Thus looking up a path
+     * costs one hash probe per path segment, and the mirror requires considerably less
+     * memory than the dom trees it has been built from.
+     * The names of matrix signals are indexed while the label parameters are merged, so
+     * signalLabel() answers with a single lookup.
+     * For every parameter, the mirror caches the value to display, computed from the received
+     * value with the factor, the provider to consumer formula and the format of the parameter.
+     * The display value is only recomputed when one of these properties changes, and the
+     * values received with a stream collection are evaluated in batches, with one call of
+     * applyFormula for all parameters sharing a formula.
+     * Derived classes may override elementChanged to be notified about all changes.
+     * Optionally, the mirror also retains the encoded form of every property it receives,
+     * including those it does not interpret, so that the elements can be re-encoded
+     * completely, for example to serve them to other consumers. Such a mirror also maintains
+     * a hash of every subtree, computed from the retained properties and the hashes of the
+     * children, and updated along the path to the root whenever an element changes. Two
+     * mirrors of the same tree can be compared top-down by these hashes, descending only
+     * into the subtrees whose hashes differ.
+     */
+    class LIBEMBER_API GlowTreeMirror : private GlowVisitor
+    {
+        public:
+            typedef std::size_t size_type;
+            typedef unsigned long long hash_type;
+
+            /**
+             * The encoded properties of an element, keyed by the number of their
+             * context-specific tag. Each property replaces the previously received
+             * property with the same tag.
+             */
+            typedef std::map<unsigned int, std::vector<unsigned char> > PropertyMap;
+
+            /**
+             * Enumeration of the element types stored in the mirror.
+             */
+            enum ElementType
+            {
+                /** A node, or the root of the mirror. */
+                Node,
+
+                /** A parameter. */
+                Parameter,
+
+                /** A matrix. */
+                Matrix,
+
+                /** A function. */
+                Function
+            };
+
+            /**
+             * Flags describing how an element has been changed by a merge.
+             */
+            enum Change
+            {
+                /** The element has not been known before. */
+                Added = 0x01,
+
+                /** Any property except the value of a parameter or the connections of a matrix has changed. */
+                ContentsChanged = 0x02,
+
+                /** The value of a parameter has changed. */
+                ValueChanged = 0x04,
+
+                /** The targets, sources or connections of a matrix have changed. */
+                ConnectionsChanged = 0x08
+            };
+
+            /**
+             * Enumeration of the signals a matrix label may name.
+             */
+            enum SignalType
+            {
+                /** A target of the matrix. */
+                TargetSignal,
+
+                /** A source of the matrix. */
+                SourceSignal
+            };
+
+            /**
+             * The properties of a parameter.
+             */
+            struct ParameterState
+            {
+                /** Initializes the properties with their default values. */
+                ParameterState();
+
+                Value value;
+                MinMax minimum;
+                MinMax maximum;
+                Access access;
+                ParameterType type;
+                std::string format;
+                int factor;
+                int streamIdentifier;
+
+                /** The provider to consumer term of the formula, or an empty string if none has been received. */
+                std::string formula;
+
+                /**
+                 * The numeric value to display. For integer and real values, this is the value
+                 * divided by the factor, if it is greater than 1, with the formula applied to
+                 * the result. For enumerations and booleans it is the index or 1 and 0.
+                 */
+                double displayValue;
+
+                /**
+                 * The display value formatted with the format of the parameter, or with a
+                 * default format if the parameter has none or it cannot be applied safely.
+                 * Strings are displayed as they are, enumerations by the name of their entry.
+                 */
+                std::string displayText;
+
+                /**
+                 * The enumeration or enumeration map, shared by all parameters of the mirror with
+                 * the same entries, or null if none has been received.
+                 */
+                EnumerationPool::Table const* enumeration;
+            };
+
+            /**
+             * The sources connected to a single target of a matrix.
+             */
+            struct Connection
+            {
+                /** Initializes a connection without sources. */
+                explicit Connection(int target);
+
+                int target;
+                ber::ObjectIdentifier sources;
+            };
+
+            /**
+             * A label of a matrix, which refers to the node containing the label parameters.
+             */
+            struct Label
+            {
+                /** Initializes a label with the passed base path and description. */
+                Label(ber::ObjectIdentifier const& basePath, std::string const& description);
+
+                ber::ObjectIdentifier basePath;
+                std::string description;
+            };
+
+            /**
+             * The properties, signals and connections of a matrix.
+             */
+            struct MatrixState
+            {
+                typedef std::vector<int> SignalCollection;
+                typedef std::vector<Connection> ConnectionCollection;
+                typedef std::vector<Label> LabelCollection;
+
+                /** Initializes the properties with their default values. */
+                MatrixState();
+
+                /**
+                 * Returns the connection of a target.
+                 * @param target The number of the target.
+                 * @return The connection of the target, or null if no connection of the target
+                 *      has been received yet.
+                 */
+                Connection const* connection(int target) const;
+
+                MatrixType type;
+                MatrixAddressingMode addressingMode;
+                int targetCount;
+                int sourceCount;
+                int maximumTotalConnects;
+                int maximumConnectsPerTarget;
+
+                /** The numbers of the targets of a non-linear matrix, sorted ascending. */
+                SignalCollection targets;
+
+                /** The numbers of the sources of a non-linear matrix, sorted ascending. */
+                SignalCollection sources;
+
+                /** The connections, sorted by target. */
+                ConnectionCollection connections;
+
+                /** The labels, in the order they have been received. */
+                LabelCollection labels;
+            };
+
+            /**
+             * A lightweight reference to an element of a mirror. It remains valid as long as
+             * the mirror exists and has not been cleared, even if further messages are merged.
+             */
+            class LIBEMBER_API Element
+            {
+                friend class GlowTreeMirror;
+                public:
+                    /** Initializes a reference that does not refer to any element. */
+                    Element();
+
+                    /**
+                     * Returns whether this reference refers to an element.
+                     * @return True if the reference is valid.
+                     */
+                    bool isValid() const;
+
+                    /**
+                     * Returns the type of the element.
+                     * @return The type of the element.
+                     */
+                    ElementType type() const;
+
+                    /**
+                     * Returns the number of the element within its parent, 0 for the root.
+                     * @return The number of the element.
+                     */
+                    int number() const;
+
+                    /**
+                     * Returns the path of the element, which is empty for the root.
+                     * @return The path of the element.
+                     */
+                    ber::ObjectIdentifier path() const;
+
+                    /**
+                     * Returns the identifier of the element.
+                     * @return The identifier, or an empty string if it is not known yet.
+                     */
+                    std::string const& identifier() const;
+
+                    /**
+                     * Returns the description of the element.
+                     * @return The description, or an empty string if it is not known.
+                     */
+                    std::string const& description() const;
+
+                    /**
+                     * Returns whether the element is online. Only nodes and parameters
+                     * may be reported offline.
+                     * @return False if the element has been reported offline, otherwise true.
+                     */
+                    bool isOnline() const;
+
+                    /**
+                     * Returns the parent of the element.
+                     * @return The parent, or an invalid reference for the root.
+                     */
+                    Element parent() const;
+
+                    /**
+                     * Returns the first child of the element. The children are ordered by the
+                     * time they have been received.
+                     * @return The first child, or an invalid reference if there are no children.
+                     */
+                    Element firstChild() const;
+
+                    /**
+                     * Returns the next sibling of the element.
+                     * @return The next sibling, or an invalid reference for the last child.
+                     */
+                    Element nextSibling() const;
+
+                    /**
+                     * Looks up a child of the element.
+                     * @param number The number of the child.
+                     * @return The child, or an invalid reference if it is not known.
+                     */
+                    Element child(int number) const;
+
+                    /**
+                     * Returns the number of children of the element.
+                     * @return The number of children.
+                     */
+                    size_type childCount() const;
+
+                    /**
+                     * Returns the properties of a parameter.
+                     * @return The properties, or null if the element is not a parameter.
+                     */
+                    ParameterState const* parameter() const;
+
+                    /**
+                     * Returns the properties of a matrix.
+                     * @return The properties, or null if the element is not a matrix.
+                     */
+                    MatrixState const* matrix() const;
+
+                    /**
+                     * Returns the encoded properties of the element, as they have been received.
+                     * @return The properties, or null if the mirror does not retain properties
+                     *      or no properties of the element have been received.
+                     */
+                    PropertyMap const* properties() const;
+
+                    /**
+                     * Returns the hash of the element and all its descendants. It covers the
+                     * number, the type and the retained properties of each element as well as
+                     * the signals and connections of matrices, but not the order of the children.
+                     * @return The hash of the subtree, or 0 if the mirror does not retain properties.
+                     */
+                    hash_type subtreeHash() const;
+
+                private:
+                    /**
+                     * Initializes a reference to an element of a mirror.
+                     * @param mirror The mirror containing the element.
+                     * @param index The index of the element within the mirror.
+                     */
+                    Element(GlowTreeMirror const* mirror, size_type index);
+
+                private:
+                    GlowTreeMirror const* m_mirror;
+                    size_type m_index;
+            };
+
+        public:
+            /**
+             * Initializes an empty mirror, which only contains the root.
+             * @param retainProperties If true, the encoded properties of all elements are
+             *      retained and can be accessed with Element::properties(). This requires
+             *      about as much memory as the encoded tree.
+             */
+            explicit GlowTreeMirror(bool retainProperties = false);
+
+            /** Destructor */
+            virtual ~GlowTreeMirror();
+
+            /**
+             * Merges a message received from the provider, usually a GlowRootElementCollection,
+             * into the mirror. Elements that are not known yet are created, including the
+             * parents of qualified elements. The entries of a stream collection update the
+             * values of the parameters with their stream identifier, except entries containing
+             * octets, which can be unpacked with a GlowStreamDecoder. Commands are ignored.
+             * @param message The message to merge.
+             * @return The number of elements that have been added or changed.
+             */
+            size_type merge(dom::Node const& message);
+
+            /**
+             * Returns the root of the mirror, which contains all top level elements.
+             * @return The root of the mirror.
+             */
+            Element root() const;
+
+            /**
+             * Looks up the element with the passed path.
+             * @param path The path of the element.
+             * @return The element, or an invalid reference if the element is not known.
+             *      An empty path returns the root.
+             */
+            Element find(ber::ObjectIdentifier const& path) const;
+
+            /**
+             * Returns the number of elements of the mirror, excluding the root.
+             * @return The number of elements.
+             */
+            size_type size() const;
+
+            /**
+             * Returns the name of a target or source of a matrix, which is the value of the
+             * string parameter stored for the signal below the base path of a matrix label.
+             * The label parameters are indexed while they are merged, so the lookup neither
+             * resolves the base path nor walks the label nodes.
+             * @param matrix The matrix owning the signal.
+             * @param type Whether the signal is a target or a source.
+             * @param number The number of the signal.
+             * @param description The description of the label to use, or an empty string
+             *      to use the first label of the matrix.
+             * @return The name of the signal, or an empty string if it is not known.
+             */
+            std::string signalLabel(Element const& matrix, SignalType type, int number, std::string const& description = std::string()) const;
+
+            /**
+             * Removes all elements. All references to elements become invalid.
+             */
+            void clear();
+
+        protected:
+            /**
+             * Called for each element that has been added or changed by merge, right after
+             * its own properties have been merged and before its children are merged. Does
+             * nothing by default.
+             * @param element The element that has been added or changed.
+             * @param changes A combination of the Change flags.
+             */
+            virtual void elementChanged(Element const& element, int changes);
+
+            /**
+             * Applies the provider to consumer formula of one or more parameters to their values,
+             * in place. The mirror calls this method whenever display values are recomputed, once
+             * for all parameters with the same formula, so an implementation only needs to look up
+             * or compile a term once per call, for example with the term cache of libformula.
+             * The default implementation leaves the values unchanged.
+             * @param formula The provider to consumer term, which is never empty.
+             * @param values The values to convert, which have already been divided by the factor.
+             * @param count The number of values, at least 1.
+             */
+            virtual void applyFormula(std::string const& formula, double* values, size_type count);
+
+        private:
+            /**
+             * The structure of an element. The properties specific to parameters and
+             * matrices are stored in separate vectors, so nodes remain small.
+             */
+            struct Entry
+            {
+                Entry(ElementType type, int number, size_type parent);
+
+                int number;
+                ElementType type;
+                bool isOnline;
+                size_type parent;
+                size_type firstChild;
+                size_type lastChild;
+                size_type nextSibling;
+                size_type childCount;
+                size_type detail;
+                hash_type contentHash;
+                hash_type subtreeHash;
+                std::string identifier;
+                std::string description;
+            };
+
+            typedef std::vector<Entry> EntryCollection;
+            typedef std::vector<size_type> SlotCollection;
+            typedef std::vector<ParameterState> ParameterCollection;
+            typedef std::vector<MatrixState> MatrixCollection;
+            typedef std::vector<PropertyMap> PropertyCollection;
+            typedef std::multimap<int, size_type> StreamIndex;
+            typedef std::vector<std::pair<std::string const*, size_type> > FormulaBatch;
+            typedef std::vector<double> ValueCollection;
+
+            /**
+             * Orders the parameters of a formula batch by their formula, so parameters sharing
+             * a formula are adjacent.
+             */
+            struct FormulaOrder
+            {
+                bool operator()(FormulaBatch::value_type const& lhs, FormulaBatch::value_type const& rhs) const;
+            };
+
+            /**
+             * Refers to a label by the index of its matrix and its position within the labels
+             * of the matrix.
+             */
+            struct LabelBase
+            {
+                LabelBase(size_type matrix, size_type label);
+
+                size_type matrix;
+                size_type label;
+            };
+
+            /**
+             * The key of a label parameter within the label index.
+             */
+            struct LabelKey
+            {
+                LabelKey(size_type matrix, size_type label, SignalType type, int number);
+
+                bool operator<(LabelKey const& other) const;
+
+                size_type matrix;
+                size_type label;
+                SignalType type;
+                int number;
+            };
+
+            typedef std::vector<LabelBase> LabelBaseCollection;
+            typedef std::multimap<size_type, LabelBase> LabelBaseIndex;
+            typedef std::map<LabelKey, size_type> LabelIndex;
+
+            /**
+             * Marks unused slots of the index and missing links. Index 0 is the root, which
+             * is never a child or a sibling.
+             */
+            enum { None = 0 };
+
+            /**
+             * Returns the slot of the index where the child with the passed number is stored,
+             * or the empty slot where it would be stored.
+             */
+            size_type slot(size_type parent, int number) const;
+
+            /**
+             * Returns the index of a child, or None if it is not known.
+             */
+            size_type findChild(size_type parent, int number) const;
+
+            /**
+             * Returns the index of a child and creates it if it is not known yet. If the child
+             * exists with another type, its type is changed.
+             * @param changes Receives Added if the child has been created.
+             */
+            size_type child(size_type parent, int number, ElementType type, int& changes);
+
+            /**
+             * Returns the index of the element with the passed path and creates it, and all its
+             * missing parents, if it is not known yet. Missing parents are created as nodes.
+             * @param changes Receives Added if the element has been created.
+             */
+            size_type resolve(ber::ObjectIdentifier const& path, ElementType type, int& changes);
+
+            /**
+             * Doubles the capacity of the index and reinserts all elements.
+             */
+            void grow();
+
+            static bool isEqual(Value const& lhs, Value const& rhs);
+            static bool isEqual(MinMax const& lhs, MinMax const& rhs);
+
+            /**
+             * Assigns a string property if it differs from the stored one.
+             * @return True if the property has changed.
+             */
+            static bool assign(std::string& field, std::string const& value);
+
+            void mergeNode(size_type index, GlowNodeBase const& glow, int changes);
+            void mergeParameter(size_type index, GlowParameterBase const& glow, int changes);
+            void mergeMatrix(size_type index, GlowMatrixBase const& glow, int changes);
+            void mergeFunction(size_type index, GlowFunctionBase const& glow, int changes);
+
+            /**
+             * Stores the encoded properties contained in the content set of an element, if
+             * the mirror retains properties.
+             */
+            void retainProperties(size_type index, GlowContainer const& glow);
+
+            /**
+             * Adds the signals of a targets or sources sequence that are not known yet.
+             * @return True if a signal has been added.
+             */
+            bool mergeSignals(MatrixState::SignalCollection& signals, dom::Sequence const* sequence, GlowType::_Domain type);
+
+            /**
+             * Applies the connections of a connections sequence.
+             * @return True if the sources of a target have changed.
+             */
+            bool mergeConnections(MatrixState& state, dom::Sequence const* sequence);
+
+            /**
+             * Applies a single connection, according to its operation.
+             * @return True if the sources of the target have changed.
+             */
+            bool mergeConnection(MatrixState& state, GlowConnection const& glow);
+
+            /**
+             * Replaces the labels of a matrix if they differ from the stored ones, and removes
+             * the label parameters indexed for the previous labels.
+             * @return True if the labels have changed.
+             */
+            bool mergeLabels(size_type index, MatrixState& state, dom::Sequence const* sequence);
+
+            /**
+             * Removes all labels of a matrix from the index.
+             */
+            void removeLabels(size_type matrix);
+
+            /**
+             * Looks up the base nodes of the labels that have not been resolved yet, and indexes
+             * the label parameters they already contain.
+             */
+            void resolveLabels();
+
+            /**
+             * Indexes a parameter if it is stored below the base node of a label.
+             */
+            void indexLabel(size_type index);
+
+            /**
+             * Determines whether a child of a label base node contains the target or the source
+             * labels, by its identifier or, as long as that is not known, by its number.
+             * @return False if the node contains neither.
+             */
+            bool signalType(size_type group, SignalType& type) const;
+
+            /**
+             * Moves a parameter from the stream identifier it has been indexed with to its
+             * current stream identifier.
+             */
+            void indexStream(size_type index, int previous, int current);
+
+            /**
+             * Recomputes the display values of the parameters in m_pendingValues, evaluating the
+             * formulas in batches, and clears m_pendingValues.
+             */
+            void updateDisplayValues();
+
+            /**
+             * Formats the display value of a parameter and stores it in the display text.
+             */
+            static void formatDisplayValue(ParameterState& state, bool isConverted);
+
+            /**
+             * Formats a number with a format received from the provider. Since the format is not
+             * trusted, it is only applied if it contains literal text, escaped percent signs and
+             * exactly one numeric conversion with at most two digits of width and precision.
+             * @return False if the format cannot be applied.
+             */
+            static bool format(std::string const& format, double value, std::string& text);
+
+            /**
+             * Recomputes the content hash of an element and updates the subtree hashes of the
+             * element and all its ancestors.
+             */
+            void updateHash(size_type index);
+
+            /**
+             * Computes the hash of the number, type and retained properties of an element.
+             */
+            hash_type contentHash(size_type index) const;
+
+            /**
+             * Continues an FNV-1a hash with a range of bytes.
+             */
+            static hash_type append(hash_type hash, unsigned char const* first, unsigned char const* last);
+
+            /**
+             * Continues an FNV-1a hash with the eight bytes of an integer.
+             */
+            static hash_type append(hash_type hash, long long value);
+
+            /**
+             * Mixes the subtree hash of a child before it is added to the hash of its parent, so
+             * that the sum of the children's hashes does not cancel out equal subtrees.
+             */
+            static hash_type mix(hash_type hash);
+
+            /**
+             * Reports a change, if there is one, and merges the children of the element.
+             */
+            void finish(size_type index, int changes, GlowElementCollection const* children);
+
+            virtual void visit(GlowRootElementCollection const& glow);
+            virtual void visit(GlowElementCollection const& glow);
+            virtual void visit(GlowNode const& glow);
+            virtual void visit(GlowQualifiedNode const& glow);
+            virtual void visit(GlowParameter const& glow);
+            virtual void visit(GlowQualifiedParameter const& glow);
+            virtual void visit(GlowMatrix const& glow);
+            virtual void visit(GlowQualifiedMatrix const& glow);
+            virtual void visit(GlowFunction const& glow);
+            virtual void visit(GlowQualifiedFunction const& glow);
+            virtual void visit(GlowStreamCollection const& glow);
+            virtual void visit(GlowStreamEntry const& glow);
+
+        private:
+#ifdef _MSC_VER
+#  pragma warning(push)
+#  pragma warning(disable : 4251)
+#endif
+            EntryCollection m_entries;
+            SlotCollection m_slots;
+            ParameterCollection m_parameters;
+            MatrixCollection m_matrices;
+            PropertyCollection m_properties;
+            EnumerationPool m_enumerations;
+            LabelBaseCollection m_pendingLabels;
+            LabelBaseIndex m_labelBases;
+            LabelIndex m_labelIndex;
+            StreamIndex m_streams;
+            SlotCollection m_pendingValues;
+            SlotCollection m_streamChanges;
+            FormulaBatch m_formulaBatch;
+            ValueCollection m_formulaValues;
+#ifdef _MSC_VER
+#  pragma warning(pop)
+#endif
+            size_type m_parent;
+            size_type m_changed;
+            bool m_retainProperties;
+            bool m_isHashPending;
+    };
+}
+}
+
+#ifdef LIBEMBER_HEADER_ONLY
+#  include "impl/GlowTreeMirror.ipp"
+#endif
+
+#endif  // __LIBEMBER_GLOW_GLOWTREEMIRROR_HPP
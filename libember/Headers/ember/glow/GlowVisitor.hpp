@@ -0,0 +1,239 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef __LIBEMBER_GLOW_GLOWVISITOR_HPP
+#define __LIBEMBER_GLOW_GLOWVISITOR_HPP
+
+#include "../dom/Node.hpp"
+
+namespace libember { namespace glow
+{
+    /** Forward declarations */
+    class GlowContainer;
+    class GlowCommand;
+    class GlowConnection;
+    class GlowElementCollection;
+    class GlowFunction;
+    class GlowInvocation;
+    class GlowInvocationResult;
+    class GlowLabel;
+    class GlowMatrix;
+    class GlowNode;
+    class GlowParameter;
+    class GlowQualifiedFunction;
+    class GlowQualifiedMatrix;
+    class GlowQualifiedNode;
+    class GlowQualifiedParameter;
+    class GlowRootElementCollection;
+    class GlowSource;
+    class GlowStreamCollection;
+    class GlowStreamDescriptor;
+    class GlowStreamEntry;
+    class GlowStringIntegerCollection;
+    class GlowStringIntegerPair;
+    class GlowTarget;
+    class GlowTupleItemDescription;
+
+    /**
+     * Visitor for the elements of a Glow tree. accept() calls the visit overload
+     * matching the concrete type of a node by switching over the GlowType stored
+     * in the node's type tag, so that walking large messages does not require
+     * a dynamic_cast per element. Derived classes override the overloads for
+     * the types they are interested in, all others do nothing.
+     */
+    class LIBEMBER_API GlowVisitor
+    {
+        public:
+            /** Destructor */
+            virtual ~GlowVisitor();
+
+            /**
+             * Calls the visit overload matching the concrete Glow type of @p node.
+             * @param node The node to visit.
+             * @return True if @p node is a Glow container and has been visited,
+             *      false if it is a leaf or a container of an unknown type.
+             */
+            bool accept(dom::Node const& node);
+
+            /**
+             * Visits all children of @p container in order. Children that are not
+             * Glow containers are skipped.
+             * @param container The container whose children to visit.
+             * @return The number of visited children.
+             */
+            std::size_t acceptChildren(GlowContainer const& container);
+
+            /**
+             * Returns @p node as GlowContainer, without using RTTI. Only Glow
+             * containers have an application defined type tag.
+             * @param node The node to convert, may be null.
+             * @return The node as GlowContainer, or null if it is not a Glow container.
+             */
+            static GlowContainer const* toGlowContainer(dom::Node const* node);
+
+            /**
+             * Called for each visited GlowParameter. Does nothing by default.
+             * @param glow The visited element.
+             */
+            virtual void visit(GlowParameter const& glow);
+
+            /**
+             * Called for each visited GlowCommand. Does nothing by default.
+             * @param glow The visited element.
+             */
+            virtual void visit(GlowCommand const& glow);
+
+            /**
+             * Called for each visited GlowNode. Does nothing by default.
+             * @param glow The visited element.
+             */
+            virtual void visit(GlowNode const& glow);
+
+            /**
+             * Called for each visited GlowElementCollection. Does nothing by default.
+             * @param glow The visited element.
+             */
+            virtual void visit(GlowElementCollection const& glow);
+
+            /**
+             * Called for each visited GlowStreamEntry. Does nothing by default.
+             * @param glow The visited element.
+             */
+            virtual void visit(GlowStreamEntry const& glow);
+
+            /**
+             * Called for each visited GlowStreamCollection. Does nothing by default.
+             * @param glow The visited element.
+             */
+            virtual void visit(GlowStreamCollection const& glow);
+
+            /**
+             * Called for each visited GlowStringIntegerPair. Does nothing by default.
+             * @param glow The visited element.
+             */
+            virtual void visit(GlowStringIntegerPair const& glow);
+
+            /**
+             * Called for each visited GlowStringIntegerCollection. Does nothing by default.
+             * @param glow The visited element.
+             */
+            virtual void visit(GlowStringIntegerCollection const& glow);
+
+            /**
+             * Called for each visited GlowQualifiedParameter. Does nothing by default.
+             * @param glow The visited element.
+             */
+            virtual void visit(GlowQualifiedParameter const& glow);
+
+            /**
+             * Called for each visited GlowQualifiedNode. Does nothing by default.
+             * @param glow The visited element.
+             */
+            virtual void visit(GlowQualifiedNode const& glow);
+
+            /**
+             * Called for each visited GlowRootElementCollection. Does nothing by default.
+             * @param glow The visited element.
+             */
+            virtual void visit(GlowRootElementCollection const& glow);
+
+            /**
+             * Called for each visited GlowStreamDescriptor. Does nothing by default.
+             * @param glow The visited element.
+             */
+            virtual void visit(GlowStreamDescriptor const& glow);
+
+            /**
+             * Called for each visited GlowMatrix. Does nothing by default.
+             * @param glow The visited element.
+             */
+            virtual void visit(GlowMatrix const& glow);
+
+            /**
+             * Called for each visited GlowTarget. Does nothing by default.
+             * @param glow The visited element.
+             */
+            virtual void visit(GlowTarget const& glow);
+
+            /**
+             * Called for each visited GlowSource. Does nothing by default.
+             * @param glow The visited element.
+             */
+            virtual void visit(GlowSource const& glow);
+
+            /**
+             * Called for each visited GlowConnection. Does nothing by default.
+             * @param glow The visited element.
+             */
+            virtual void visit(GlowConnection const& glow);
+
+            /**
+             * Called for each visited GlowQualifiedMatrix. Does nothing by default.
+             * @param glow The visited element.
+             */
+            virtual void visit(GlowQualifiedMatrix const& glow);
+
+            /**
+             * Called for each visited GlowLabel. Does nothing by default.
+             * @param glow The visited element.
+             */
+            virtual void visit(GlowLabel const& glow);
+
+            /**
+             * Called for each visited GlowFunction. Does nothing by default.
+             * @param glow The visited element.
+             */
+            virtual void visit(GlowFunction const& glow);
+
+            /**
+             * Called for each visited GlowQualifiedFunction. Does nothing by default.
+             * @param glow The visited element.
+             */
+            virtual void visit(GlowQualifiedFunction const& glow);
+
+            /**
+             * Called for each visited GlowTupleItemDescription. Does nothing by default.
+             * @param glow The visited element.
+             */
+            virtual void visit(GlowTupleItemDescription const& glow);
+
+            /**
+             * Called for each visited GlowInvocation. Does nothing by default.
+             * @param glow The visited element.
+             */
+            virtual void visit(GlowInvocation const& glow);
+
+            /**
+             * Called for each visited GlowInvocationResult. Does nothing by default.
+             * @param glow The visited element.
+             */
+            virtual void visit(GlowInvocationResult const& glow);
+
+        protected:
+            /** Constructor */
+            GlowVisitor();
+    };
+}
+}
+
+#ifdef LIBEMBER_HEADER_ONLY
+#  include "impl/GlowVisitor.ipp"
+#endif
+
+#endif  // __LIBEMBER_GLOW_GLOWVISITOR_HPP
@@ -0,0 +1,543 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef __LIBEMBER_GLOW_GLOWWRITER_HPP
+#define __LIBEMBER_GLOW_GLOWWRITER_HPP
+
+#include <string>
+#include <vector>
+#include "../ber/Encoding.hpp"
+#include "../ber/ObjectIdentifier.hpp"
+#include "../ber/Tag.hpp"
+#include "../util/Api.hpp"
+#include "../util/OctetStream.hpp"
+#include "Access.hpp"
+#include "MatrixAddressingMode.hpp"
+#include "MatrixType.hpp"
+#include "ParameterType.hpp"
+
+namespace libember { namespace glow
+{
+    /**
+     * Encodes nodes, parameters and matrices directly into a buffer, without
+     * building the tree of GlowNode, GlowParameter and GlowMatrix objects first. Elements are written
+     * in document order by nested begin and end calls, properties are written
+     * to the contents of the element that has been begun last:
+     * @code
+     * writer.beginRoot();
+     * writer.beginParameter(path);
+     * writer.value(-20L);
+     * writer.endParameter();
+     * writer.endRoot();
+     * @endcode
+     * The writer produces definite lengths. Every frame reserves a single
+     * length byte when it is begun. When it ends, the length is filled in,
+     * and the content is moved back if the length needs more than one byte.
+     * The open frames are kept on a fixed stack, so writing does not allocate
+     * once the buffer has grown to the size of the largest message.
+     * The encoding is identical to the one of the equivalent tree, provided
+     * that the properties are written in the same order.
+     */
+    class LIBEMBER_API GlowWriter
+    {
+        public:
+            typedef unsigned char value_type;
+            typedef value_type const* const_iterator;
+            typedef std::size_t size_type;
+
+            /** The maximum number of frames that may be open at once. */
+            enum { MaximumDepth = 64 };
+
+            /** Initializes an empty writer. */
+            GlowWriter();
+
+            /**
+             * Discards the encoded bytes and all open frames. The buffer keeps its capacity.
+             */
+            void clear();
+
+            /**
+             * Begins a message, which contains the elements written until endRoot() is called.
+             * @throw std::runtime_error if the maximum depth is exceeded.
+             */
+            void beginRoot();
+
+            /**
+             * Ends the message begun by beginRoot().
+             * @throw std::runtime_error if an element or its children have not been ended.
+             */
+            void endRoot();
+
+            /**
+             * Begins a node of the current collection.
+             * @param number The number of the node.
+             * @throw std::runtime_error if no collection is open or the maximum depth is exceeded.
+             */
+            void beginNode(int number);
+
+            /**
+             * Begins a qualified node of the current collection.
+             * @param path The path of the node.
+             * @throw std::runtime_error if no collection is open or the maximum depth is exceeded.
+             */
+            void beginNode(ber::ObjectIdentifier const& path);
+
+            /**
+             * Ends the node that has been begun last.
+             * @throw std::runtime_error if the current element is not a node.
+             */
+            void endNode();
+
+            /**
+             * Begins a parameter of the current collection.
+             * @param number The number of the parameter.
+             * @throw std::runtime_error if no collection is open or the maximum depth is exceeded.
+             */
+            void beginParameter(int number);
+
+            /**
+             * Begins a qualified parameter of the current collection.
+             * @param path The path of the parameter.
+             * @throw std::runtime_error if no collection is open or the maximum depth is exceeded.
+             */
+            void beginParameter(ber::ObjectIdentifier const& path);
+
+            /**
+             * Ends the parameter that has been begun last.
+             * @throw std::runtime_error if the current element is not a parameter.
+             */
+            void endParameter();
+
+            /**
+             * Begins a matrix of the current collection.
+             * @param number The number of the matrix.
+             * @throw std::runtime_error if no collection is open or the maximum depth is exceeded.
+             */
+            void beginMatrix(int number);
+
+            /**
+             * Begins a qualified matrix of the current collection.
+             * @param path The path of the matrix.
+             * @throw std::runtime_error if no collection is open or the maximum depth is exceeded.
+             */
+            void beginMatrix(ber::ObjectIdentifier const& path);
+
+            /**
+             * Ends the matrix that has been begun last.
+             * @throw std::runtime_error if the current element is not a matrix or one of
+             *      its signal or connection sequences has not been ended.
+             */
+            void endMatrix();
+
+            /**
+             * Begins the children of the current element. No more properties may be
+             * written to the element afterwards.
+             * @throw std::runtime_error if no element is open or the maximum depth is exceeded.
+             */
+            void beginChildren();
+
+            /**
+             * Ends the children of the current element.
+             * @throw std::runtime_error if the children have not been begun or an element
+             *      within them has not been ended.
+             */
+            void endChildren();
+
+            /**
+             * Ends the contents of the current element, so that a part of the element
+             * that follows its properties may be copied, see encoded(). No more
+             * properties may be written to the element afterwards. Beginning the
+             * children, signals or connections of an element ends its contents as well.
+             * @throw std::runtime_error if no element is open.
+             */
+            void endContents();
+
+            /**
+             * Writes the identifier of the current element.
+             * @param identifier The identifier to write.
+             */
+            void identifier(std::string const& identifier);
+
+            /**
+             * Writes the description of the current element.
+             * @param description The description to write.
+             */
+            void description(std::string const& description);
+
+            /**
+             * Writes the online state of the current element.
+             * @param isOnline The online state to write.
+             */
+            void isOnline(bool isOnline);
+
+            /**
+             * Writes the value of the current parameter.
+             * @param value The value to write.
+             */
+            void value(long value);
+
+            /** @see value(long) */
+            void value(double value);
+
+            /** @see value(long) */
+            void value(std::string const& value);
+
+            /** @see value(long) */
+            void value(bool value);
+
+            /**
+             * Writes the minimum of the current parameter.
+             * @param minimum The minimum to write.
+             */
+            void minimum(long minimum);
+
+            /** @see minimum(long) */
+            void minimum(double minimum);
+
+            /**
+             * Writes the maximum of the current parameter.
+             * @param maximum The maximum to write.
+             */
+            void maximum(long maximum);
+
+            /** @see maximum(long) */
+            void maximum(double maximum);
+
+            /**
+             * Writes the access of the current parameter.
+             * @param access The access to write.
+             */
+            void access(Access const& access);
+
+            /**
+             * Writes the type of the current parameter.
+             * @param type The type to write.
+             */
+            void type(ParameterType const& type);
+
+            /**
+             * Writes the type of the current matrix.
+             * @param type The type to write.
+             */
+            void type(MatrixType const& type);
+
+            /**
+             * Writes the addressing mode of the current matrix.
+             * @param addressingMode The addressing mode to write.
+             */
+            void addressingMode(MatrixAddressingMode const& addressingMode);
+
+            /**
+             * Writes the number of targets of the current matrix.
+             * @param targetCount The number of targets to write.
+             */
+            void targetCount(int targetCount);
+
+            /**
+             * Writes the number of sources of the current matrix.
+             * @param sourceCount The number of sources to write.
+             */
+            void sourceCount(int sourceCount);
+
+            /**
+             * Writes the path of the node containing the parameters of the current matrix.
+             * @param basePath The path to write.
+             */
+            void parametersLocation(ber::ObjectIdentifier const& basePath);
+
+            /**
+             * Writes the number of the child of the current matrix that contains its parameters.
+             * @param inlineSubid The number to write.
+             */
+            void parametersLocation(int inlineSubid);
+
+            /**
+             * Writes the number of the gain parameter of the crosspoints of the current matrix.
+             * @param gainParameterNumber The number to write.
+             */
+            void gainParameterNumber(int gainParameterNumber);
+
+            /**
+             * Begins the labels of the current matrix. The labels belong to the contents,
+             * so further properties may be written after endLabels().
+             * @throw std::runtime_error if the current element is not a matrix.
+             */
+            void beginLabels();
+
+            /**
+             * Writes a label to the labels of the current matrix.
+             * @param basePath The path of the node containing the labels.
+             * @param description The description of the label.
+             * @throw std::runtime_error if the labels have not been begun.
+             */
+            void label(ber::ObjectIdentifier const& basePath, std::string const& description);
+
+            /**
+             * Ends the labels of the current matrix.
+             * @throw std::runtime_error if the labels have not been begun.
+             */
+            void endLabels();
+
+            /**
+             * Begins the targets of the current matrix. No more properties may be
+             * written to the matrix afterwards.
+             * @throw std::runtime_error if the current element is not a matrix.
+             */
+            void beginTargets();
+
+            /**
+             * Writes a target to the targets of the current matrix.
+             * @param number The number of the target.
+             * @throw std::runtime_error if the targets have not been begun.
+             */
+            void target(int number);
+
+            /**
+             * Ends the targets of the current matrix.
+             * @throw std::runtime_error if the targets have not been begun.
+             */
+            void endTargets();
+
+            /**
+             * Begins the sources of the current matrix. No more properties may be
+             * written to the matrix afterwards.
+             * @throw std::runtime_error if the current element is not a matrix.
+             */
+            void beginSources();
+
+            /**
+             * Writes a source to the sources of the current matrix.
+             * @param number The number of the source.
+             * @throw std::runtime_error if the sources have not been begun.
+             */
+            void source(int number);
+
+            /**
+             * Ends the sources of the current matrix.
+             * @throw std::runtime_error if the sources have not been begun.
+             */
+            void endSources();
+
+            /**
+             * Begins the connections of the current matrix. No more properties may be
+             * written to the matrix afterwards.
+             * @throw std::runtime_error if the current element is not a matrix.
+             */
+            void beginConnections();
+
+            /**
+             * Writes a connection without sources to the connections of the current matrix.
+             * @param target The number of the target.
+             * @throw std::runtime_error if the connections have not been begun.
+             */
+            void connection(int target);
+
+            /**
+             * Writes a connection to the connections of the current matrix.
+             * @param target The number of the target.
+             * @param sources The numbers of the sources connected to the target.
+             * @throw std::runtime_error if the connections have not been begun.
+             */
+            void connection(int target, ber::ObjectIdentifier const& sources);
+
+            /**
+             * Ends the connections of the current matrix.
+             * @throw std::runtime_error if the connections have not been begun.
+             */
+            void endConnections();
+
+            /**
+             * Appends bytes that have been encoded before to the current frame, for
+             * example a part of an element that is cached across messages. The
+             * contents of the current element are ended first, so no more properties
+             * may be written to the element afterwards. Such a
+             * part may be copied from another writer: the bytes written since
+             * size() has returned a certain value are final once the frames begun
+             * in between have been ended, provided that no frame which was open at
+             * that point, including the contents of an element, has been ended.
+             * @param first The first byte to append.
+             * @param last The byte one past the last byte to append.
+             */
+            void encoded(const_iterator first, const_iterator last);
+
+            /**
+             * Returns the first encoded byte.
+             * @return The first encoded byte.
+             */
+            const_iterator begin() const;
+
+            /**
+             * Returns the byte one past the last encoded byte.
+             * @return The end of the encoded bytes.
+             */
+            const_iterator end() const;
+
+            /**
+             * Returns the number of encoded bytes.
+             * @return The number of encoded bytes.
+             */
+            size_type size() const;
+
+        private:
+            /** The kinds of frames kept on the stack. */
+            enum FrameKind
+            {
+                Collection,
+                Node,
+                Parameter,
+                Matrix,
+                Contents,
+                Labels,
+                Targets,
+                Sources,
+                Connections,
+                Item
+            };
+
+            /**
+             * A constructed element, which consists of an outer frame with the
+             * application tag and an inner frame with the type tag.
+             */
+            struct Frame
+            {
+                size_type outerLength;
+                size_type innerLength;
+                FrameKind kind;
+                bool isSealed;
+            };
+
+            /**
+             * Begins a constructed element and pushes it on the stack.
+             * @param tag The application tag of the element.
+             * @param type The type tag of the element.
+             * @param kind The kind of the element.
+             */
+            void open(ber::Tag const& tag, ber::Tag const& type, FrameKind kind);
+
+            /**
+             * Ends the element on top of the stack.
+             * @param kind The kind the element is expected to have.
+             */
+            void close(FrameKind kind);
+
+            /**
+             * Begins a node, parameter or matrix and writes the tagged number or path.
+             * @param type The type tag of the element.
+             * @param kind The kind of the element.
+             */
+            void openElement(ber::Tag const& type, FrameKind kind);
+
+            /**
+             * Ends the contents of the current element, if they have been begun.
+             */
+            void closeContents();
+
+            /**
+             * Ends the contents of the current element and prevents further
+             * properties from being written to it.
+             */
+            void seal();
+
+            /**
+             * Ends the current node, parameter or matrix.
+             * @param kind The kind the element is expected to have.
+             */
+            void closeElement(FrameKind kind);
+
+            /**
+             * Returns the kind of the current element, beginning its contents if necessary.
+             * @return The kind of the element the contents belong to.
+             * @throw std::runtime_error if no element is open or its children, signals
+             *      or connections have been begun.
+             */
+            FrameKind contents();
+
+            /**
+             * Begins the contents of the current element if necessary.
+             * @param kind The kind the element is expected to have.
+             * @throw std::runtime_error if the current element is not of kind @p kind.
+             */
+            void contents(FrameKind kind);
+
+            /**
+             * Begins one of the sequences of the current matrix.
+             * @param tag The application tag of the sequence.
+             * @param kind The kind of the sequence.
+             */
+            void openSequence(ber::Tag const& tag, FrameKind kind);
+
+            /**
+             * Begins an element of the sequence on top of the stack.
+             * @param type The type tag of the element.
+             * @param kind The kind the sequence is expected to have.
+             */
+            void openItem(ber::Tag const& type, FrameKind kind);
+
+            /** Writes a tag at the end of the buffer. */
+            void writeTag(ber::Tag const& tag);
+
+            /**
+             * Fills in the length reserved at @p offset, moving the content back
+             * if the length does not fit into a single byte.
+             */
+            void writeLength(size_type offset);
+
+            /**
+             * Writes a primitive value enclosed in a frame with the passed tag.
+             * @param tag The application tag of the value.
+             * @param value The value to write.
+             */
+            template<typename ValueType>
+            void property(ber::Tag const& tag, ValueType const& value);
+
+        private:
+#ifdef _MSC_VER
+#  pragma warning(push)
+#  pragma warning(disable: 4251)
+#endif
+            std::vector<value_type> m_buffer;
+#ifdef _MSC_VER
+#  pragma warning(pop)
+#endif
+            libember::util::OctetStream m_scratch;
+            Frame m_frames[MaximumDepth];
+            size_type m_depth;
+    };
+
+    /**************************************************************************
+     * Mandatory inline implementation                                        *
+     **************************************************************************/
+
+    template<typename ValueType>
+    inline void GlowWriter::property(ber::Tag const& tag, ValueType const& value)
+    {
+        m_scratch.clear();
+        ber::encode(m_scratch, tag.toContainer());
+        ber::encode(m_scratch, ber::make_length(ber::encodedFrameLength(value)));
+        ber::encodeFrame(m_scratch, value);
+        m_buffer.insert(m_buffer.end(), m_scratch.begin(), m_scratch.end());
+    }
+}
+}
+
+#ifdef LIBEMBER_HEADER_ONLY
+#  include "impl/GlowWriter.ipp"
+#endif
+
+#endif  // __LIBEMBER_GLOW_GLOWWRITER_HPP
@@ -20,8 +20,8 @@
 #ifndef __LIBEMBER_GLOW_MINMAX_HPP
 #define __LIBEMBER_GLOW_MINMAX_HPP
 
+#include <algorithm>
 #include "ParameterType.hpp"
-#include "Variant.hpp"
 #include "util/ValueConverter.hpp"
 
 namespace libember { namespace glow 
@@ -29,6 +29,7 @@ namespace libember { namespace glow
     /**
      * Stores an integer or a real value. This class is
      * used as minimum and maximum property of a parameter.
+     * The value is stored within the object itself.
      */
     class MinMax
     {
@@ -98,7 +99,14 @@ namespace libember { namespace glow
             MinMax& operator=(MinMax other);
 
         private:
-            Variant* m_value;
+            union Scalar
+            {
+                long integer;
+                double real;
+            };
+
+            ParameterType::_Domain m_type;
+            Scalar m_value;
     };
 
     /******************************************************
@@ -106,13 +114,15 @@ namespace libember { namespace glow
      ******************************************************/
 
     inline MinMax::MinMax()
-        : m_value(Variant::create<void*>(0))
+        : m_type(ParameterType::None)
     {
+        m_value.integer = 0;
     }
 
     inline MinMax::MinMax(ber::Value const& value)
-        : m_value(0)
+        : m_type(ParameterType::Integer)
     {
+        m_value.integer = 0;
 
         //SimianIgnore
 
@@ -122,55 +132,63 @@ namespace libember { namespace glow
             switch(type.number())
             {
                 case ber::Type::Integer:
-                    m_value = Variant::create(util::ValueConverter::valueOf(value, long(0)));
+                    m_value.integer = util::ValueConverter::valueOf(value, long(0));
                     return;
                 case ber::Type::Real:
-                    m_value = Variant::create(util::ValueConverter::valueOf(value, double(0.0)));
+                    m_type = ParameterType::Real;
+                    m_value.real = util::ValueConverter::valueOf(value, double(0.0));
                     return;
             }
         }
 
-        if (m_value == 0)
-            m_value = Variant::create(0L);
-
         //EndSimianIgnore
     }
 
     inline MinMax::MinMax(double value)
-        : m_value(Variant::create(value))
-    {}
+        : m_type(ParameterType::Real)
+    {
+        m_value.real = value;
+    }
 
     inline MinMax::MinMax(long value)
-        : m_value(Variant::create(value))
-    {}
+        : m_type(ParameterType::Integer)
+    {
+        m_value.integer = value;
+    }
 
     inline MinMax::MinMax(const MinMax &other)
-        : m_value(other.m_value->addRef())
+        : m_type(other.m_type)
+        , m_value(other.m_value)
     {}
 
     inline MinMax::~MinMax()
-    {
-        m_value->releaseRef();
-    }
+    {}
 
     inline long MinMax::toInteger() const
     {
-        return m_value->toInteger();
+        if (m_type == ParameterType::Real)
+            return static_cast<long>(m_value.real);
+        else
+            return m_type == ParameterType::Integer ? m_value.integer : 0;
     }
 
     inline double MinMax::toReal() const
     {
-        return m_value->toReal();
+        if (m_type == ParameterType::Integer)
+            return static_cast<double>(m_value.integer);
+        else
+            return m_type == ParameterType::Real ? m_value.real : 0.0;
     }
 
     inline void MinMax::swap(MinMax &other)
     {
+        std::swap(m_type, other.m_type);
         std::swap(m_value, other.m_value);
     }
 
     inline ParameterType MinMax::type() const
     {
-        return m_value->type();
+        return ParameterType(m_type);
     }
 
     inline MinMax& MinMax::operator=(MinMax other)
@@ -33,6 +33,7 @@ namespace libember { namespace glow
      * A class that may store several value types: Integer, Real, Bool, Octets and UTF8String.
      * The value is used by the parameter's value and default property. This class
      * also provides functionality to cast between the different data types.
+     * Numbers, booleans and short strings are stored without a heap allocation.
      */
     class Value
     {
@@ -123,6 +124,17 @@ namespace libember { namespace glow
              */
             std::string toString() const;
 
+            /**
+             * Writes the current value as string into the provided buffer, without
+             * allocating memory. This is the preferred way to display many values.
+             * @param buffer The buffer to write the string to.
+             * @param size The size of @p buffer in characters.
+             * @return The length of the complete string, excluding the terminating
+             *      null character. If it is not less than @p size, the result has
+             *      been truncated to @p size - 1 characters.
+             */
+            std::size_t toString(char* buffer, std::size_t size) const;
+
             /**
              * Returns the current value as Octets.
              * @note If the data type is not Octets, the implementation will try to convert it. If 
@@ -157,7 +169,7 @@ namespace libember { namespace glow
             Value& operator=(Value other);
 
         private:
-            Variant* m_value;
+            Variant m_value;
     };
 
     /******************************************************
@@ -165,13 +177,10 @@ namespace libember { namespace glow
      ******************************************************/
 
     inline Value::Value()
-        : m_value(Variant::create<void*>(0))
-    {
-
-    }
+    {}
 
     inline Value::Value(ber::Value const& value)
-        : m_value(0)
+        : m_value(0L)
     {
 
         //SimianIgnore
@@ -182,26 +191,23 @@ namespace libember { namespace glow
             switch(type.number())
             {
                 case ber::Type::Integer:
-                    m_value = Variant::create(util::ValueConverter::valueOf(value, long(0)));
+                    m_value = Variant(util::ValueConverter::valueOf(value, long(0)));
                     return;
                 case ber::Type::Real:
-                    m_value = Variant::create(util::ValueConverter::valueOf(value, double(0.0)));
+                    m_value = Variant(util::ValueConverter::valueOf(value, double(0.0)));
                     return;
                 case ber::Type::UTF8String:
-                    m_value = Variant::create(util::ValueConverter::valueOf(value, std::string()));
+                    m_value = Variant(util::ValueConverter::valueOf(value, std::string()));
                     return;
                 case ber::Type::OctetString:
-                    m_value = Variant::create(util::ValueConverter::valueOf(value, ber::Octets()));
+                    m_value = Variant(util::ValueConverter::valueOf(value, ber::Octets()));
                     return;
                 case ber::Type::Boolean:
-                    m_value = Variant::create(util::ValueConverter::valueOf(value, false));
+                    m_value = Variant(util::ValueConverter::valueOf(value, false));
                     return;
             }
         }
 
-        if (m_value == 0)
-            m_value = Variant::create(0L);
-
         //EndSimianIgnore
     }
 
@@ -229,71 +235,74 @@ namespace libember { namespace glow
     }
 
     inline Value::Value(double value)
-        : m_value(Variant::create(value))
+        : m_value(value)
     {}
 
     inline Value::Value(long value)
-        : m_value(Variant::create(value))
+        : m_value(value)
     {}
 
     inline Value::Value(std::string const& value)
-        : m_value(Variant::create(value))
+        : m_value(value)
     {}
 
     inline Value::Value(char const* value)
-        : m_value(Variant::create(std::string(value)))
+        : m_value(std::string(value))
     {}
 
     inline Value::Value(ber::Octets const& value)
-        : m_value(Variant::create(value))
+        : m_value(value)
     {}
 
     inline Value::Value(bool value)
-        : m_value(Variant::create(value))
+        : m_value(value)
     {}
 
     inline Value::Value(Value const& other)
-        : m_value(other.m_value->addRef())
+        : m_value(other.m_value)
     {}
 
     inline Value::~Value()
-    {
-        m_value->releaseRef();
-    }
+    {}
 
     inline ParameterType Value::type() const
     {
-        return m_value->type();
+        return m_value.type();
     }
 
     inline long Value::toInteger() const
     {
-        return m_value->toInteger();
+        return m_value.toInteger();
     }
 
     inline double Value::toReal() const
     {
-        return m_value->toReal();
+        return m_value.toReal();
     }
 
     inline std::string Value::toString() const
     {
-        return m_value->toString();
+        return m_value.toString();
+    }
+
+    inline std::size_t Value::toString(char* buffer, std::size_t size) const
+    {
+        return m_value.toString(buffer, size);
     }
 
     inline ber::Octets Value::toOctets() const
     {
-        return m_value->toOctets();
+        return m_value.toOctets();
     }
 
     inline bool Value::toBoolean() const
     {
-        return m_value->toBoolean();
+        return m_value.toBoolean();
     }
 
     inline void Value::swap(Value& other)
     {
-        std::swap(m_value, other.m_value);
+        m_value.swap(other.m_value);
     }
 
     inline Value& Value::operator=(Value other)
@@ -20,9 +20,15 @@
 #ifndef __LIBEMBER_GLOW_VARIANT_HPP
 #define __LIBEMBER_GLOW_VARIANT_HPP
 
-#include <sstream>
+#include <algorithm>
+#include <clocale>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
 #include "ParameterType.hpp"
 #include "../ber/Octets.hpp"
+#include "../util/SmallVector.hpp"
 
 //SimianIgnore
 
@@ -31,90 +37,141 @@ namespace libember { namespace glow
     /**
      * Helper class that may contain different data types (string, int, double) and 
      * is able to convert them to any other type supported.
-     * This class is used by MinMax and Value.
-     * @note This class should not be used directly. Use MinMax or Value instead.
+     * This class is used by Value.
+     * Numbers and booleans are stored within the object itself, as are strings and
+     * octet strings of up to 16 bytes, so that these values can be
+     * created, copied and destroyed without a heap allocation.
+     * @note This class should not be used directly. Use Value instead.
      */
-    struct Variant
+    class Variant
     {
-    public:
-        /** 
-         * Factory method used to create a new instance of a variant.
-         * @param value The value to store in the variant class.
-         * @return The created Variant instance.
-         * @note The Variant class uses reference counting, so release Ref must be called
-         *      in order to indicate that the instance when it is no longer needed.
-         */
-        template<typename ValueType>
-        static Variant* create(ValueType const value);
-
-        /** 
-         * Returns the internal value as integer. If the internal type is not an
-         * integer, the implementation will try to convert it.
-         * @return Returns the internal value as integer.
-         */
-        virtual long toInteger() const = 0;
-
-        /** 
-         * Returns the internal value as double. If the internal type is not a
-         * double, the implementation will try to convert it.
-         * @return Returns the internal value as double.
-         */
-        virtual double toReal() const = 0;
-
-        /** 
-         * Returns the internal value as string. If the internal type is not a
-         * string, the implementation will try to convert it.
-         * @return Returns the internal value as string.
-         */
-        virtual std::string toString() const = 0;
-
-        /** 
-         * Returns the internal value as octet string. If the internal type is not a
-         * string, the implementation will try to convert it.
-         * @return Returns the internal value as octet string.
-         */
-        virtual ber::Octets toOctets() const = 0;
-
-        /** 
-         * Returns the internal value as bool. If the internal type is not a
-         * bool, the implementation will try to convert it.
-         * @return Returns the internal value as bool.
-         */
-        virtual bool toBoolean() const = 0;
-
-        /**
-         * Returns the value type. 
-         * @return The value type.
-         */
-        ParameterType const& type() const;
-
-        /**
-         * Increments the internal reference counter by one.
-         * @return Returns this instance.
-         */
-        Variant* addRef();
-
-        /**
-         * Decrements the internal reference counter by one. If the counter reaches 0,
-         * the instance will delete itself.
-         */
-        void releaseRef();
-
-    protected:
-        /**
-         * Destructor
-         */
-        virtual ~Variant();
-
-        /**
-         * Constructor
-         * @param type The type this variant currently stores.
-         */
-        explicit Variant(ParameterType const& type);
-
-    private:
-        unsigned long m_refCount;
-        ParameterType m_type;
+        typedef libember::util::SmallVector<unsigned char, 16> ByteVector;
+
+        public:
+            /**
+             * Default constructor, which initializes the type with ParameterType::None.
+             */
+            Variant();
+
+            /**
+             * Initializes a variant that contains an integer value.
+             * @param value The value to store.
+             */
+            explicit Variant(long value);
+
+            /**
+             * Initializes a variant that contains a real value.
+             * @param value The value to store.
+             */
+            explicit Variant(double value);
+
+            /**
+             * Initializes a variant that contains a boolean value.
+             * @param value The value to store.
+             */
+            explicit Variant(bool value);
+
+            /**
+             * Initializes a variant that contains a string value.
+             * @param value The value to store.
+             */
+            explicit Variant(std::string const& value);
+
+            /**
+             * Initializes a variant that contains an octet string.
+             * @param value The value to store.
+             */
+            explicit Variant(ber::Octets const& value);
+
+            /** 
+             * Returns the internal value as integer. If the internal type is not an
+             * integer, the implementation will try to convert it.
+             * @return Returns the internal value as integer.
+             */
+            long toInteger() const;
+
+            /** 
+             * Returns the internal value as double. If the internal type is not a
+             * double, the implementation will try to convert it.
+             * @return Returns the internal value as double.
+             */
+            double toReal() const;
+
+            /** 
+             * Returns the internal value as string. If the internal type is not a
+             * string, the implementation will try to convert it.
+             * @return Returns the internal value as string.
+             */
+            std::string toString() const;
+
+            /**
+             * Writes the internal value as string into the provided buffer, without
+             * allocating memory. The result is truncated to @p size - 1 characters
+             * and always terminated with a null character, unless @p size is 0.
+             * @param buffer The buffer to write the string to.
+             * @param size The size of @p buffer in characters.
+             * @return The length of the complete string, excluding the terminating
+             *      null character. If it is not less than @p size, the result has
+             *      been truncated.
+             */
+            std::size_t toString(char* buffer, std::size_t size) const;
+
+            /** 
+             * Returns the internal value as octet string. If the internal type is not a
+             * string, the implementation will try to convert it.
+             * @return Returns the internal value as octet string.
+             */
+            ber::Octets toOctets() const;
+
+            /** 
+             * Returns the internal value as bool. If the internal type is not a
+             * bool, the implementation will try to convert it.
+             * @return Returns the internal value as bool.
+             */
+            bool toBoolean() const;
+
+            /**
+             * Returns the value type. 
+             * @return The value type.
+             */
+            ParameterType type() const;
+
+            /**
+             * Swaps the value of this instance with the one passed.
+             * @param other Instance to exchange the data with.
+             */
+            void swap(Variant& other);
+
+        private:
+            /**
+             * Formats a real number like a default std::ostream does, always using
+             * a dot as decimal point, regardless of the current C locale.
+             * @param value The number to format.
+             * @param buffer The buffer to write the number to, which must hold at
+             *      least 32 characters.
+             * @return The length of the formatted number.
+             */
+            static std::size_t formatReal(double value, char* buffer);
+
+            /**
+             * Parses a real number that uses a dot as decimal point, regardless of
+             * the current C locale.
+             * @param first Pointer to the first character of the text.
+             * @param last Pointer to one past the last character of the text.
+             * @return The parsed number, or 0.0 if the text is not a number.
+             */
+            static double parseReal(char const* first, char const* last);
+
+            union Scalar
+            {
+                long integer;
+                double real;
+                bool boolean;
+            };
+
+            ParameterType::_Domain m_type;
+            Scalar m_scalar;
+            ByteVector m_bytes;
     };
 
 
@@ -122,377 +179,256 @@ namespace libember { namespace glow
      * Inline implementation                              *
      ******************************************************/
 
-    inline Variant::Variant(ParameterType const& type)
-        : m_refCount(1)
-        , m_type(type)
-    {}
+    inline Variant::Variant()
+        : m_type(ParameterType::None)
+    {
+        m_scalar.integer = 0;
+    }
 
-    inline Variant::~Variant()
-    {}
+    inline Variant::Variant(long value)
+        : m_type(ParameterType::Integer)
+    {
+        m_scalar.integer = value;
+    }
 
-    inline ParameterType const& Variant::type() const
+    inline Variant::Variant(double value)
+        : m_type(ParameterType::Real)
     {
-        return m_type;
+        m_scalar.real = value;
     }
 
-    inline Variant* Variant::addRef()
+    inline Variant::Variant(bool value)
+        : m_type(ParameterType::Boolean)
     {
-        m_refCount += 1;
-        return this;
+        m_scalar.boolean = value;
     }
 
-    inline void Variant::releaseRef()
+    inline Variant::Variant(std::string const& value)
+        : m_type(ParameterType::String)
     {
-        m_refCount -= 1;
+        m_scalar.integer = 0;
+        m_bytes.assign(value.begin(), value.end());
+    }
 
-        if (m_refCount == 0)
+    inline Variant::Variant(ber::Octets const& value)
+        : m_type(ParameterType::Octets)
+    {
+        m_scalar.integer = 0;
+        m_bytes.assign(value.begin(), value.end());
+    }
+
+    inline long Variant::toInteger() const
+    {
+        switch(m_type)
         {
-            delete this;
+            case ParameterType::Integer:
+                return m_scalar.integer;
+
+            case ParameterType::Real:
+                return static_cast<long>(m_scalar.real);
+
+            case ParameterType::Boolean:
+                return m_scalar.boolean ? 1 : 0;
+
+            case ParameterType::String:
+            {
+                char text[64];
+                if (toString(text, sizeof(text)) < sizeof(text))
+                    return std::strtol(text, 0, 10);
+                else
+                    return std::strtol(toString().c_str(), 0, 10);
+            }
+
+            default:
+                return 0;
         }
     }
 
+    inline double Variant::toReal() const
+    {
+        switch(m_type)
+        {
+            case ParameterType::Integer:
+                return static_cast<double>(m_scalar.integer);
+
+            case ParameterType::Real:
+                return m_scalar.real;
+
+            case ParameterType::Boolean:
+                return m_scalar.boolean ? 1.0 : 0.0;
 
-    namespace detail 
+            case ParameterType::String:
+            {
+                char const* const text = reinterpret_cast<char const*>(m_bytes.begin());
+                return parseReal(text, text + m_bytes.size());
+            }
+
+            default:
+                return 0.0;
+        }
+    }
+
+    inline std::string Variant::toString() const
     {
-        /** 
-         * VariantTemplate declaration. The template specializations implement the 
-         * Variant base class.
-         **/
-        template<typename ValueType>
-        struct VariantImpl;
-
-
-        /**
-         * Variant specialization for the std::string type.
-         */
-        template<>
-        struct VariantImpl<std::string> : Variant
+        if (m_type == ParameterType::String)
         {
-            friend struct Variant;
-            typedef std::string value_type;
-            public:
-                virtual long toInteger() const
-                {
-                    std::stringstream stream(m_value);
-                    int integer = 0;
-
-                    stream >> integer;
-                    return integer;
-                }
-
-                virtual double toReal() const
-                {
-                    std::stringstream stream(m_value);
-                    double real = 0.0;
-
-                    stream >> real;
-                    return real;
-                }
-
-                virtual std::string toString() const
-                {
-                    return m_value;
-                }
-
-                virtual ber::Octets toOctets() const
-                {
-                    return ber::Octets(m_value.begin(), m_value.end());
-                }
-
-                virtual bool toBoolean() const
-                {
-                    return m_value.size() > 0;
-                }
-
-            private:
-                /**
-                 * Constructor, initializes the variant with a string value.
-                 * @param value Value to store.
-                 */
-                VariantImpl(value_type const& value)
-                    : Variant(ParameterType::String)
-                    , m_value(value)
-                {}
-
-                /** Prohibit assignment */
-                VariantImpl& operator=(VariantImpl const&);
-
-            private:
-                value_type const m_value;
-        };
-
-
-        /**
-         * Variant specialization for the integer type.
-         */
-        template<>
-        struct VariantImpl<long> : Variant
+            return std::string(m_bytes.begin(), m_bytes.end());
+        }
+
+        char text[32];
+        std::size_t const length = toString(text, sizeof(text));
+        return std::string(text, length);
+    }
+
+    inline std::size_t Variant::toString(char* buffer, std::size_t size) const
+    {
+        char number[32];
+        char const* text = number;
+        std::size_t length = 0;
+
+        switch(m_type)
         {
-            friend struct Variant;
-            typedef int value_type;
-            public:
-                virtual long toInteger() const
-                {
-                    return m_value;
-                }
-
-                virtual double toReal() const
-                {
-                    return m_value;
-                }
-
-                virtual std::string toString() const
-                {
-                    std::stringstream stream;
-                    stream << m_value;
-
-                    return stream.str();
-                }
-
-                virtual ber::Octets toOctets() const
-                {
-                    return ber::Octets();
-                }
-
-                virtual bool toBoolean() const
-                {
-                    return m_value != 0;
-                }
-
-            private:
-                /**
-                 * Constructor initializing the variant with an integer.
-                 * @param value Value to initialize the variant with.
-                 */
-                VariantImpl(value_type const& value)
-                    : Variant(ParameterType::Integer)
-                    , m_value(value)
-                {}
-
-                /** Prohibit assignment */
-                VariantImpl& operator=(VariantImpl const&);
-
-            private:
-                value_type const m_value;
-        };
-
-
-        /**
-         * Variant specialization for the double type.
-         */
-        template<>
-        struct VariantImpl<double> : Variant
+            case ParameterType::Integer:
+                length = static_cast<std::size_t>(std::sprintf(number, "%ld", m_scalar.integer));
+                break;
+
+            case ParameterType::Real:
+                length = formatReal(m_scalar.real, number);
+                break;
+
+            case ParameterType::Boolean:
+                text = m_scalar.boolean ? "true" : "false";
+                length = std::strlen(text);
+                break;
+
+            case ParameterType::String:
+                text = reinterpret_cast<char const*>(m_bytes.begin());
+                length = m_bytes.size();
+                break;
+
+            default:
+                break;
+        }
+
+        if (size > 0)
         {
-            friend struct Variant;
-            typedef double value_type;
-            public:
-                virtual long toInteger() const
-                {
-                    return static_cast<long>(m_value);
-                }
-
-                virtual double toReal() const
-                {
-                    return m_value;
-                }
-
-                virtual std::string toString() const
-                {
-                    std::stringstream stream;
-                    stream << m_value;
-
-                    return stream.str();
-                }
-
-                virtual ber::Octets toOctets() const
-                {
-                    return ber::Octets();
-                }
-
-                virtual bool toBoolean() const
-                {
-                    return m_value != 0.0;
-                }
-
-            private:
-                /**
-                 * Constructor initializing the variant with the provided double value.
-                 * @param value Value to initialize the variant with.
-                 */
-                VariantImpl(value_type const& value)
-                    : Variant(ParameterType::Real)
-                    , m_value(value)
-                {}
-
-                /** Prohibit assignment */
-                VariantImpl& operator=(VariantImpl const&);
-
-            private:
-                value_type const m_value;
-            };
+            std::size_t const copied = std::min(length, size - 1);
+            std::memcpy(buffer, text, copied);
+            buffer[copied] = '\0';
+        }
 
+        return length;
+    }
 
-        /**
-         * Variant specialization for the boolean type.
-         */
-        template<>
-        struct VariantImpl<bool> : Variant
+    inline ber::Octets Variant::toOctets() const
+    {
+        if (m_type == ParameterType::String || m_type == ParameterType::Octets)
         {
-            friend struct Variant;
-            typedef bool value_type;
-            public:
-                virtual long toInteger() const
-                {
-                    return m_value ? 1 : 0;
-                }
-
-                virtual double toReal() const
-                {
-                    return m_value ? 1.0 : 0.0;
-                }
-
-                virtual std::string toString() const
-                {
-                    return m_value ? "true" : "false";
-                }
-
-                virtual ber::Octets toOctets() const
-                {
-                    return ber::Octets();
-                }
-
-                virtual bool toBoolean() const
-                {
-                    return m_value;
-                }
-
-            private:
-                /**
-                 * Constructor initializing the variant with the provided boolean value.
-                 * @param value Value to initialize the variant with.
-                 */
-                VariantImpl(value_type const& value)
-                    : Variant(ParameterType::Boolean)
-                    , m_value(value)
-                {}
-
-                /** Prohibit assignment */
-                VariantImpl& operator=(VariantImpl const&);
-
-            private:
-                value_type const m_value;
-            };
+            return ber::Octets(m_bytes.begin(), m_bytes.end());
+        }
 
+        return ber::Octets();
+    }
 
-        /**
-         * Variant specialization for the Octets type.
-         */
-        template<>
-        struct VariantImpl<ber::Octets> : Variant
+    inline bool Variant::toBoolean() const
+    {
+        switch(m_type)
         {
-            friend struct Variant;
-            typedef ber::Octets value_type;
-            public:
-                virtual long toInteger() const
-                {
-                    return 0;
-                }
-
-                virtual double toReal() const
-                {
-                    return 0.0;
-                }
-
-                virtual std::string toString() const
-                {
-                    return std::string();
-                }
-
-                virtual ber::Octets toOctets() const
-                {
-                    return m_value;
-                }
-
-                virtual bool toBoolean() const
-                {
-                    return m_value.size() > 0;
-                }
-
-            private:
-                /**
-                 * Constructor initializing the variant with the provided octet string.
-                 * @param value Value to initialize the variant with.
-                 */
-                VariantImpl(value_type const& value)
-                    : Variant(ParameterType::Octets)
-                    , m_value(value)
-                {}
-
-                /** Prohibit assignment */
-                VariantImpl& operator=(VariantImpl const&);
-
-            private:
-                value_type const m_value;
-            };
+            case ParameterType::Integer:
+                return m_scalar.integer != 0;
+
+            case ParameterType::Real:
+                return m_scalar.real != 0.0;
+
+            case ParameterType::Boolean:
+                return m_scalar.boolean;
 
+            case ParameterType::String:
+            case ParameterType::Octets:
+                return m_bytes.empty() == false;
 
-        /**
-         * Variant specialization for the void type, which is used when no value exists.
-         */
-        template<>
-        struct VariantImpl<void*> : Variant
+            default:
+                return false;
+        }
+    }
+
+    inline ParameterType Variant::type() const
+    {
+        return ParameterType(m_type);
+    }
+
+    inline void Variant::swap(Variant& other)
+    {
+        std::swap(m_type, other.m_type);
+        std::swap(m_scalar, other.m_scalar);
+
+        ByteVector const bytes = m_bytes;
+        m_bytes = other.m_bytes;
+        other.m_bytes = bytes;
+    }
+
+    inline std::size_t Variant::formatReal(double value, char* buffer)
+    {
+        // "%g" formats reals like a default std::ostream does, in at most 13 characters,
+        // but writes the decimal point of the C locale an application may have set.
+        std::size_t length = static_cast<std::size_t>(std::sprintf(buffer, "%g", value));
+        char const* const point = std::localeconv()->decimal_point;
+        std::size_t const pointLength = std::strlen(point);
+        if (pointLength > 0 && std::strcmp(point, ".") != 0)
         {
-            friend struct Variant;
-            typedef void* value_type;
-            public:
-                virtual long toInteger() const
-                {
-                    return 0;
-                }
-
-                virtual double toReal() const
-                {
-                    return 0.0;
-                }
-
-                virtual std::string toString() const
-                {
-                    return std::string();
-                }
-
-                virtual ber::Octets toOctets() const
-                {
-                    return ber::Octets();
-                }
-
-                virtual bool toBoolean() const
-                {
-                    return false;
-                }
-
-            private:
-                /**
-                 * Constructor initializing the variant with the provided value.
-                 * This void overload swallows all values without storing anything.
-                 */
-                template<typename T>
-                VariantImpl(T const&)
-                    : Variant(ParameterType::None)
-                {}
-
-                /** Prohibit assignment */
-                VariantImpl& operator=(VariantImpl const&);
-            };
+            char* const position = std::strstr(buffer, point);
+            if (position != 0)
+            {
+                std::size_t const tail = length - static_cast<std::size_t>(position - buffer) - pointLength;
+                *position = '.';
+                std::memmove(position + 1, position + pointLength, tail + 1);
+                length -= pointLength - 1;
+            }
+        }
+        return length;
     }
-    
 
-    /**
-     * Implementation of the Variant factory.
-     */
-    template<typename ValueType>
-    inline Variant* Variant::create(ValueType const value)
+    inline double Variant::parseReal(char const* first, char const* last)
     {
-        return new detail::VariantImpl<ValueType>(value);
+        // strtod expects the decimal point of the C locale, so the dot is replaced
+        // with it. A localized decimal point ends the number, as it does in the
+        // classic locale.
+        char const* const point = std::localeconv()->decimal_point;
+        std::size_t const pointLength = std::strlen(point);
+        std::size_t const size = static_cast<std::size_t>(last - first) + pointLength + 1;
+
+        char buffer[64];
+        std::string fallback;
+        char* localized = buffer;
+        if (size > sizeof(buffer))
+        {
+            fallback.resize(size);
+            localized = &fallback[0];
+        }
+
+        char* it = localized;
+        bool hasPoint = false;
+        while (first != last && *first != 0)
+        {
+            if (*first == '.' && hasPoint == false)
+            {
+                std::memcpy(it, point, pointLength);
+                it += pointLength;
+                hasPoint = true;
+            }
+            else if (*first == point[0])
+            {
+                break;
+            }
+            else
+            {
+                *it++ = *first;
+            }
+            ++first;
+        }
+
+        *it = 0;
+        return std::strtod(localized, 0);
     }
 }
 }
@@ -0,0 +1,182 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef __LIBEMBER_GLOW_IMPL_CROSSPOINTMATRIX_IPP
+#define __LIBEMBER_GLOW_IMPL_CROSSPOINTMATRIX_IPP
+
+#include <algorithm>
+#include "../../util/Inline.hpp"
+#include "../GlowConnection.hpp"
+#include "../GlowConnectionTable.hpp"
+
+namespace libember { namespace glow
+{
+    LIBEMBER_INLINE
+    CrosspointMatrix::Listener::~Listener()
+    {}
+
+    LIBEMBER_INLINE
+    CrosspointMatrix::CrosspointMatrix(int targetCount, int sourceCount, Listener* listener)
+        : m_targetCount(0)
+        , m_sourceCount(0)
+        , m_rowWords(0)
+        , m_listener(listener)
+    {
+        reset(targetCount, sourceCount);
+    }
+
+    LIBEMBER_INLINE
+    void CrosspointMatrix::reset(int targetCount, int sourceCount)
+    {
+        size_type const bits = sizeof(word_type) * 8;
+
+        m_targetCount = targetCount > 0 ? targetCount : 0;
+        m_sourceCount = sourceCount > 0 ? sourceCount : 0;
+        m_rowWords = (static_cast<size_type>(m_sourceCount) + bits - 1) / bits;
+
+        m_bits.assign(static_cast<size_type>(m_targetCount) * m_rowWords, word_type(0));
+        m_sources.clear();
+        m_sources.resize(static_cast<size_type>(m_targetCount));
+        m_targets.clear();
+        m_targets.resize(static_cast<size_type>(m_sourceCount));
+    }
+
+    LIBEMBER_INLINE
+    bool CrosspointMatrix::set(int target, int source, bool isConnected)
+    {
+        if (contains(target, source) == false || this->isConnected(target, source) == isConnected)
+        {
+            return false;
+        }
+
+        size_type const bits = sizeof(word_type) * 8;
+        size_type const index = static_cast<size_type>(source);
+        word_type& word = m_bits[static_cast<size_type>(target) * m_rowWords + index / bits];
+        word ^= word_type(1) << (index % bits);
+
+        if (isConnected)
+        {
+            m_sources[target].push_back(source);
+            m_targets[source].push_back(target);
+        }
+        else
+        {
+            erase(m_sources[target], source);
+            erase(m_targets[source], target);
+        }
+
+        if (m_listener != 0)
+        {
+            m_listener->crosspointChanged(target, source, isConnected);
+        }
+        return true;
+    }
+
+    LIBEMBER_INLINE
+    CrosspointMatrix::size_type CrosspointMatrix::apply(int target, int const* first, int const* last, ConnectionOperation const& operation)
+    {
+        if (target < 0 || target >= m_targetCount)
+        {
+            return 0;
+        }
+
+        size_type changes = 0;
+        switch (operation.value())
+        {
+            case ConnectionOperation::Connect:
+                for (/* Nothing */; first != last; ++first)
+                {
+                    changes += set(target, *first, true) ? 1 : 0;
+                }
+                break;
+
+            case ConnectionOperation::Disconnect:
+                for (/* Nothing */; first != last; ++first)
+                {
+                    changes += set(target, *first, false) ? 1 : 0;
+                }
+                break;
+
+            default:
+            {
+                // The sources that are no longer requested are disconnected before the
+                // new ones are connected, so a listener never sees more sources than the
+                // provider has reported. The requested sources are sorted to look them up.
+                m_request.assign(first, last);
+                std::sort(m_request.begin(), m_request.end());
+
+                m_previous = m_sources[target];
+                SignalCollection::const_iterator const previousLast = m_previous.end();
+                for (SignalCollection::const_iterator it = m_previous.begin(); it != previousLast; ++it)
+                {
+                    if (std::binary_search(m_request.begin(), m_request.end(), *it) == false)
+                    {
+                        changes += set(target, *it, false) ? 1 : 0;
+                    }
+                }
+
+                for (/* Nothing */; first != last; ++first)
+                {
+                    changes += set(target, *first, true) ? 1 : 0;
+                }
+                break;
+            }
+        }
+        return changes;
+    }
+
+    LIBEMBER_INLINE
+    CrosspointMatrix::size_type CrosspointMatrix::apply(int target, ber::ObjectIdentifier const& sources, ConnectionOperation const& operation)
+    {
+        SignalCollection converted(sources.begin(), sources.end());
+        int const* const first = converted.empty() ? 0 : &converted[0];
+        return apply(target, first, first + converted.size(), operation);
+    }
+
+    LIBEMBER_INLINE
+    CrosspointMatrix::size_type CrosspointMatrix::apply(GlowConnection const& connection)
+    {
+        return apply(connection.target(), connection.sources(), connection.operation());
+    }
+
+    LIBEMBER_INLINE
+    CrosspointMatrix::size_type CrosspointMatrix::apply(GlowConnectionTable const& table)
+    {
+        size_type changes = 0;
+        size_type const size = table.size();
+        for (size_type index = 0; index < size; ++index)
+        {
+            changes += apply(table.target(index), table.sourcesBegin(index), table.sourcesEnd(index), table.operation(index));
+        }
+        return changes;
+    }
+
+    LIBEMBER_INLINE
+    void CrosspointMatrix::erase(SignalCollection& signals, int number)
+    {
+        SignalCollection::iterator const where = std::find(signals.begin(), signals.end(), number);
+        if (where != signals.end())
+        {
+            signals.erase(where);
+        }
+    }
+}
+}
+
+#endif  // __LIBEMBER_GLOW_IMPL_CROSSPOINTMATRIX_IPP
@@ -0,0 +1,322 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef __LIBEMBER_GLOW_IMPL_ENUMERATIONPOOL_IPP
+#define __LIBEMBER_GLOW_IMPL_ENUMERATIONPOOL_IPP
+
+#include <algorithm>
+#include "../../util/Inline.hpp"
+
+namespace libember { namespace glow
+{
+    /**************************************************************************
+     * Table                                                                  *
+     **************************************************************************/
+
+    LIBEMBER_INLINE
+    std::string EnumerationPool::Table::Entry::name() const
+    {
+        return std::string(first, length);
+    }
+
+    LIBEMBER_INLINE
+    EnumerationPool::Table::Table(std::string const& text)
+        : m_text(text)
+        , m_isIndexed(true)
+    {
+        char const* const data = m_text.data();
+        std::string::size_type first = 0;
+        std::string::size_type last = m_text.find('\n');
+
+        while (last != std::string::npos)
+        {
+            Entry const entry = { data + first, last - first, static_cast<int>(m_entries.size()) };
+            m_entries.push_back(entry);
+
+            first = last + 1;
+            last = m_text.find('\n', first);
+        }
+
+        if (first < m_text.length())
+        {
+            Entry const entry = { data + first, m_text.length() - first, static_cast<int>(m_entries.size()) };
+            m_entries.push_back(entry);
+        }
+
+        buildIndices();
+    }
+
+    LIBEMBER_INLINE
+    EnumerationPool::Table::Table(Enumeration const& enumeration)
+        : m_isIndexed(true)
+    {
+        std::vector<size_type> offsets;
+        offsets.reserve(enumeration.size());
+
+        Enumeration::const_iterator const last = enumeration.end();
+        for (Enumeration::const_iterator it = enumeration.begin(); it != last; ++it)
+        {
+            if (it != enumeration.begin())
+            {
+                m_text += '\n';
+            }
+
+            offsets.push_back(m_text.size());
+            m_text += it->first;
+
+            m_isIndexed = m_isIndexed
+                && it->second == static_cast<int>(offsets.size() - 1)
+                && it->first.find('\n') == std::string::npos;
+        }
+
+        // the entries are created once the text is complete, since appending may move it
+        char const* const data = m_text.data();
+        m_entries.reserve(offsets.size());
+        for (size_type i = 0; i < offsets.size(); ++i)
+        {
+            Entry const entry = { data + offsets[i], enumeration[static_cast<int>(i)].first.size(), enumeration[static_cast<int>(i)].second };
+            m_entries.push_back(entry);
+        }
+
+        buildIndices();
+    }
+
+    LIBEMBER_INLINE
+    EnumerationPool::size_type EnumerationPool::Table::size() const
+    {
+        return m_entries.size();
+    }
+
+    LIBEMBER_INLINE
+    EnumerationPool::Table::const_iterator EnumerationPool::Table::begin() const
+    {
+        return m_entries.begin();
+    }
+
+    LIBEMBER_INLINE
+    EnumerationPool::Table::const_iterator EnumerationPool::Table::end() const
+    {
+        return m_entries.end();
+    }
+
+    LIBEMBER_INLINE
+    EnumerationPool::Table::Entry const& EnumerationPool::Table::operator[](size_type index) const
+    {
+        return m_entries[index];
+    }
+
+    LIBEMBER_INLINE
+    EnumerationPool::Table::Entry const* EnumerationPool::Table::find(int value) const
+    {
+        if (m_isIndexed)
+        {
+            return value >= 0 && static_cast<size_type>(value) < m_entries.size()
+                ? &m_entries[value]
+                : 0;
+        }
+
+        std::vector<std::pair<int, size_type> >::const_iterator const last = m_values.end();
+        std::vector<std::pair<int, size_type> >::const_iterator const result = std::lower_bound(m_values.begin(), last, std::make_pair(value, size_type(0)));
+        return result != last && result->first == value ? &m_entries[result->second] : 0;
+    }
+
+    LIBEMBER_INLINE
+    EnumerationPool::Table::Entry const* EnumerationPool::Table::find(std::string const& name) const
+    {
+        char const* const data = name.data();
+        size_type const key = EnumerationPool::hash(data, data + name.size());
+
+        std::vector<std::pair<size_type, size_type> >::const_iterator const last = m_names.end();
+        std::vector<std::pair<size_type, size_type> >::const_iterator it = std::lower_bound(m_names.begin(), last, std::make_pair(key, size_type(0)));
+        for ( ; it != last && it->first == key; ++it)
+        {
+            Entry const& entry = m_entries[it->second];
+            if (entry.length == name.size() && std::equal(entry.first, entry.first + entry.length, data))
+            {
+                return &entry;
+            }
+        }
+        return 0;
+    }
+
+    LIBEMBER_INLINE
+    std::string const& EnumerationPool::Table::text() const
+    {
+        return m_text;
+    }
+
+    LIBEMBER_INLINE
+    bool EnumerationPool::Table::isEqual(Enumeration const& enumeration) const
+    {
+        if (enumeration.size() != m_entries.size())
+        {
+            return false;
+        }
+
+        for (size_type i = 0; i < m_entries.size(); ++i)
+        {
+            Entry const& entry = m_entries[i];
+            Enumeration::const_reference other = enumeration[static_cast<int>(i)];
+            if (entry.value != other.second
+            ||  entry.length != other.first.size()
+            ||  std::equal(entry.first, entry.first + entry.length, other.first.begin()) == false)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+
+    LIBEMBER_INLINE
+    void EnumerationPool::Table::buildIndices()
+    {
+        // the indices are sorted pairs instead of maps, since a table never changes
+        // and a single allocation per index keeps large tables compact
+        if (m_isIndexed == false)
+        {
+            m_values.reserve(m_entries.size());
+            for (size_type i = 0; i < m_entries.size(); ++i)
+            {
+                m_values.push_back(std::make_pair(m_entries[i].value, i));
+            }
+            std::sort(m_values.begin(), m_values.end());
+        }
+
+        m_names.reserve(m_entries.size());
+        for (size_type i = 0; i < m_entries.size(); ++i)
+        {
+            Entry const& entry = m_entries[i];
+            m_names.push_back(std::make_pair(EnumerationPool::hash(entry.first, entry.first + entry.length), i));
+        }
+        std::sort(m_names.begin(), m_names.end());
+    }
+
+
+    /**************************************************************************
+     * EnumerationPool                                                        *
+     **************************************************************************/
+
+    LIBEMBER_INLINE
+    EnumerationPool::EnumerationPool()
+        : m_generation(0)
+    {}
+
+    LIBEMBER_INLINE
+    EnumerationPool::~EnumerationPool()
+    {
+        clear();
+    }
+
+    LIBEMBER_INLINE
+    EnumerationPool::Table const* EnumerationPool::intern(std::string const& enumeration)
+    {
+        char const* const data = enumeration.data();
+        size_type const key = hash(data, data + enumeration.size());
+
+        std::pair<TableMap::const_iterator, TableMap::const_iterator> const range = m_tables.equal_range(key);
+        for (TableMap::const_iterator it = range.first; it != range.second; ++it)
+        {
+            if (it->second->m_isIndexed && it->second->m_text == enumeration)
+            {
+                return it->second;
+            }
+        }
+
+        Table* const table = new Table(enumeration);
+        m_tables.insert(std::make_pair(key, table));
+        return table;
+    }
+
+    LIBEMBER_INLINE
+    EnumerationPool::Table const* EnumerationPool::intern(Enumeration const& enumeration)
+    {
+        size_type const key = hash(enumeration);
+
+        std::pair<TableMap::const_iterator, TableMap::const_iterator> const range = m_tables.equal_range(key);
+        for (TableMap::const_iterator it = range.first; it != range.second; ++it)
+        {
+            if (it->second->isEqual(enumeration))
+            {
+                return it->second;
+            }
+        }
+
+        Table* const table = new Table(enumeration);
+        m_tables.insert(std::make_pair(key, table));
+        return table;
+    }
+
+    LIBEMBER_INLINE
+    EnumerationPool::size_type EnumerationPool::size() const
+    {
+        return m_tables.size();
+    }
+
+    LIBEMBER_INLINE
+    void EnumerationPool::clear()
+    {
+        for (TableMap::const_iterator it = m_tables.begin(); it != m_tables.end(); ++it)
+        {
+            delete it->second;
+        }
+        m_tables.clear();
+        ++m_generation;
+    }
+
+    LIBEMBER_INLINE
+    EnumerationPool::size_type EnumerationPool::generation() const
+    {
+        return m_generation;
+    }
+
+    LIBEMBER_INLINE
+    EnumerationPool::size_type EnumerationPool::hash(char const* first, char const* last)
+    {
+        size_type result = 2166136261U;
+        for ( ; first != last; ++first)
+        {
+            result = (result ^ static_cast<unsigned char>(*first)) * 16777619U;
+        }
+        return result;
+    }
+
+    LIBEMBER_INLINE
+    EnumerationPool::size_type EnumerationPool::hash(Enumeration const& enumeration)
+    {
+        size_type result = 2166136261U;
+        Enumeration::const_iterator const last = enumeration.end();
+        for (Enumeration::const_iterator it = enumeration.begin(); it != last; ++it)
+        {
+            if (it != enumeration.begin())
+            {
+                result = (result ^ static_cast<unsigned char>('\n')) * 16777619U;
+            }
+
+            for (std::string::const_iterator c = it->first.begin(); c != it->first.end(); ++c)
+            {
+                result = (result ^ static_cast<unsigned char>(*c)) * 16777619U;
+            }
+        }
+        return result;
+    }
+}
+}
+
+#endif  // __LIBEMBER_GLOW_IMPL_ENUMERATIONPOOL_IPP
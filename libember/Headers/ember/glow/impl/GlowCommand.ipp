@@ -35,7 +35,7 @@ namespace libember { namespace glow
     GlowCommand::GlowCommand(CommandType const& number, DirFieldMask const& mask)
         : GlowElement(GlowType::Command)
     {
-        insert(begin(), new dom::VariantLeaf(GlowTags::Command::Number(), number.value()));
+        insert(begin(), new dom::StaticLeaf<int>(GlowTags::Command::Number(), number.value()));
         if (mask.value() != DirFieldMask::Default)
             setDirFieldMask(mask);
     }
@@ -44,7 +44,7 @@ namespace libember { namespace glow
     GlowCommand::GlowCommand(GlowRootElementCollection* parent, CommandType const& number, DirFieldMask const& mask)
         : GlowElement(GlowType::Command)
     {
-        insert(begin(), new dom::VariantLeaf(GlowTags::Command::Number(), number.value()));
+        insert(begin(), new dom::StaticLeaf<int>(GlowTags::Command::Number(), number.value()));
         if (parent)
             parent->insert(parent->end(), this);
 
@@ -56,7 +56,7 @@ namespace libember { namespace glow
     GlowCommand::GlowCommand(GlowNodeBase* parent, CommandType const& number, DirFieldMask const& mask)
         : GlowElement(GlowType::Command)
     {
-        insert(begin(), new dom::VariantLeaf(GlowTags::Command::Number(), number.value()));
+        insert(begin(), new dom::StaticLeaf<int>(GlowTags::Command::Number(), number.value()));
         if (parent)
         {
             GlowElementCollection* children = parent->children();
@@ -72,7 +72,7 @@ namespace libember { namespace glow
     GlowCommand::GlowCommand(GlowParameterBase* parent, CommandType const& number, DirFieldMask const& mask)
         : GlowElement(GlowType::Command)
     {
-        insert(begin(), new dom::VariantLeaf(GlowTags::Command::Number(), number.value()));
+        insert(begin(), new dom::StaticLeaf<int>(GlowTags::Command::Number(), number.value()));
         if (parent)
         {
             GlowElementCollection* children = parent->children();
@@ -142,12 +142,44 @@ namespace libember { namespace glow
         }
     }
 
+    LIBEMBER_INLINE
+    long GlowCommand::sequence() const
+    {
+        ber::Tag const tag = GlowTags::Command::Sequence();
+        const_iterator const first = begin();
+        const_iterator const last = end();
+        const_iterator const result = util::find_tag(first, last, tag);
+        if (result != last)
+        {
+            return util::ValueConverter::valueOf(&*result, -1L);
+        }
+        else
+        {
+            return -1;
+        }
+    }
+
     LIBEMBER_INLINE
     void GlowCommand::setDirFieldMask(DirFieldMask const& value)
     {
         insert(end(), new dom::VariantLeaf(GlowTags::Command::DirFieldMask(), value.value()));
     }
 
+    LIBEMBER_INLINE
+    void GlowCommand::setSequence(long value)
+    {
+        iterator const first = begin();
+        iterator const last = end();
+        iterator const result = util::find_tag(first, last, GlowTags::Command::Sequence());
+
+        if (result != last)
+        {
+            erase(result);
+        }
+
+        insert(end(), new dom::VariantLeaf(GlowTags::Command::Sequence(), value));
+    }
+
     LIBEMBER_INLINE
     void GlowCommand::setInvocation(GlowInvocation* value)
     {
@@ -0,0 +1,206 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef __LIBEMBER_GLOW_GLOWCONNECTIONTABLE_IPP
+#define __LIBEMBER_GLOW_GLOWCONNECTIONTABLE_IPP
+
+#include "../../util/Inline.hpp"
+#include "../../ber/Encoding.hpp"
+#include "../../ber/ObjectIdentifier.hpp"
+#include "../../ber/detail/MultiByteArray.hpp"
+#include "../GlowTags.hpp"
+#include "../GlowType.hpp"
+
+namespace libember { namespace glow
+{
+    LIBEMBER_INLINE
+    GlowConnectionTable::GlowConnectionTable()
+    {}
+
+    LIBEMBER_INLINE
+    bool GlowConnectionTable::empty() const
+    {
+        return m_entries.empty();
+    }
+
+    LIBEMBER_INLINE
+    GlowConnectionTable::size_type GlowConnectionTable::size() const
+    {
+        return m_entries.size();
+    }
+
+    LIBEMBER_INLINE
+    void GlowConnectionTable::reserve(size_type connections, size_type sources)
+    {
+        m_entries.reserve(connections);
+        m_sources.reserve(sources);
+    }
+
+    LIBEMBER_INLINE
+    void GlowConnectionTable::clear()
+    {
+        m_entries.clear();
+        m_sources.clear();
+    }
+
+    LIBEMBER_INLINE
+    int GlowConnectionTable::target(size_type index) const
+    {
+        return m_entries[index].target;
+    }
+
+    LIBEMBER_INLINE
+    GlowConnectionTable::const_iterator GlowConnectionTable::sourcesBegin(size_type index) const
+    {
+        Entry const& entry = m_entries[index];
+        return entry.count > 0 ? &m_sources[entry.offset] : 0;
+    }
+
+    LIBEMBER_INLINE
+    GlowConnectionTable::const_iterator GlowConnectionTable::sourcesEnd(size_type index) const
+    {
+        Entry const& entry = m_entries[index];
+        return entry.count > 0 ? &m_sources[entry.offset] + entry.count : 0;
+    }
+
+    LIBEMBER_INLINE
+    ConnectionOperation GlowConnectionTable::operation(size_type index) const
+    {
+        return ConnectionOperation(m_entries[index].operation);
+    }
+
+    LIBEMBER_INLINE
+    ConnectionDisposition GlowConnectionTable::disposition(size_type index) const
+    {
+        return ConnectionDisposition(m_entries[index].disposition);
+    }
+
+    LIBEMBER_INLINE
+    std::size_t GlowConnectionTable::encodedLength() const
+    {
+        ber::Tag const outerTag = GlowTags::ElementDefault().toContainer();
+        ber::Tag const setTag = GlowType(GlowType::Connection).toTypeTag().toContainer();
+
+        std::size_t length = 0;
+        std::vector<Entry>::const_iterator const last = m_entries.end();
+        for (std::vector<Entry>::const_iterator it = m_entries.begin(); it != last; ++it)
+        {
+            std::size_t const contentLength = encodedContentLength(*it);
+            std::size_t const innerLength = ber::encodedLength(setTag) + ber::encodedLength(ber::make_length(contentLength)) + contentLength;
+            length += ber::encodedLength(outerTag) + ber::encodedLength(ber::make_length(innerLength)) + innerLength;
+        }
+        return length;
+    }
+
+    LIBEMBER_INLINE
+    void GlowConnectionTable::encode(libember::util::OctetStream& output) const
+    {
+        typedef unsigned int item_type;
+        ber::Tag const outerTag = GlowTags::ElementDefault().toContainer();
+        ber::Tag const setTag = GlowType(GlowType::Connection).toTypeTag().toContainer();
+        ber::Tag const integerTag = ber::make_tag(ber::Class::Universal, ber::Type::Integer);
+        ber::Tag const sourcesTag = ber::make_tag(ber::Class::Universal, ber::Type::RelativeObject);
+
+        std::vector<Entry>::const_iterator const last = m_entries.end();
+        for (std::vector<Entry>::const_iterator it = m_entries.begin(); it != last; ++it)
+        {
+            Entry const& entry = *it;
+            std::size_t const contentLength = encodedContentLength(entry);
+            std::size_t const innerLength = ber::encodedLength(setTag) + ber::encodedLength(ber::make_length(contentLength)) + contentLength;
+
+            ber::encode(output, outerTag);
+            ber::encode(output, ber::make_length(innerLength));
+            ber::encode(output, setTag);
+            ber::encode(output, ber::make_length(contentLength));
+
+            encodeLeafHeader(output, GlowTags::Connection::Target(), integerTag, ber::encodedLength(entry.target));
+            ber::encode(output, entry.target);
+
+            encodeLeafHeader(output, GlowTags::Connection::Sources(), sourcesTag, encodedSourcesLength(entry));
+            if (entry.count > 0)
+            {
+                item_type const* const firstSource = reinterpret_cast<item_type const*>(&m_sources[entry.offset]);
+                ber::detail::encodeMultibyteArray(output, firstSource, firstSource + entry.count);
+            }
+
+            if (entry.operation != ConnectionOperation::Absolute)
+            {
+                encodeLeafHeader(output, GlowTags::Connection::Operation(), integerTag, ber::encodedLength(entry.operation));
+                ber::encode(output, entry.operation);
+            }
+
+            if (entry.disposition != ConnectionDisposition::Tally)
+            {
+                encodeLeafHeader(output, GlowTags::Connection::Disposition(), integerTag, ber::encodedLength(entry.disposition));
+                ber::encode(output, entry.disposition);
+            }
+        }
+    }
+
+    LIBEMBER_INLINE
+    std::size_t GlowConnectionTable::encodedContentLength(Entry const& entry) const
+    {
+        ber::Tag const integerTag = ber::make_tag(ber::Class::Universal, ber::Type::Integer);
+        ber::Tag const sourcesTag = ber::make_tag(ber::Class::Universal, ber::Type::RelativeObject);
+
+        std::size_t length = encodedLeafLength(GlowTags::Connection::Target(), integerTag, ber::encodedLength(entry.target))
+                           + encodedLeafLength(GlowTags::Connection::Sources(), sourcesTag, encodedSourcesLength(entry));
+
+        if (entry.operation != ConnectionOperation::Absolute)
+            length += encodedLeafLength(GlowTags::Connection::Operation(), integerTag, ber::encodedLength(entry.operation));
+
+        if (entry.disposition != ConnectionDisposition::Tally)
+            length += encodedLeafLength(GlowTags::Connection::Disposition(), integerTag, ber::encodedLength(entry.disposition));
+
+        return length;
+    }
+
+    LIBEMBER_INLINE
+    std::size_t GlowConnectionTable::encodedSourcesLength(Entry const& entry) const
+    {
+        typedef unsigned int item_type;
+
+        if (entry.count == 0)
+            return 0;
+
+        // The sources are stored as ints, which may be accessed as their unsigned counterpart.
+        item_type const* const first = reinterpret_cast<item_type const*>(&m_sources[entry.offset]);
+        return ber::detail::getMultiByteArrayEncodedLength(first, first + entry.count);
+    }
+
+    LIBEMBER_INLINE
+    std::size_t GlowConnectionTable::encodedLeafLength(ber::Tag const& tag, ber::Tag const& type, std::size_t payloadLength)
+    {
+        std::size_t const innerLength = ber::encodedLength(type) + ber::encodedLength(ber::make_length(payloadLength)) + payloadLength;
+        return ber::encodedLength(tag.toContainer()) + ber::encodedLength(ber::make_length(innerLength)) + innerLength;
+    }
+
+    LIBEMBER_INLINE
+    void GlowConnectionTable::encodeLeafHeader(libember::util::OctetStream& output, ber::Tag const& tag, ber::Tag const& type, std::size_t payloadLength)
+    {
+        std::size_t const innerLength = ber::encodedLength(type) + ber::encodedLength(ber::make_length(payloadLength)) + payloadLength;
+        ber::encode(output, tag.toContainer());
+        ber::encode(output, ber::make_length(innerLength));
+        ber::encode(output, type);
+        ber::encode(output, ber::make_length(payloadLength));
+    }
+}
+}
+
+#endif  // __LIBEMBER_GLOW_GLOWCONNECTIONTABLE_IPP
@@ -40,20 +40,29 @@ namespace libember { namespace glow
     LIBEMBER_INLINE
     GlowContainer::iterator GlowContainer::insertImpl(iterator const&, Node* child)
     {
-        iterator const last = end();
+        child_iterator const last = childEnd();
         if (child != 0)
         {
             ber::Tag const tag = child->applicationTag();
-            for (iterator i = begin(); i != last; ++i)
+
+            // children are usually added in the order of their tags, for example all
+            // elements of a collection, so they are appended without a search
+            child_iterator const first = childBegin();
+            if (first == last || ((last - 1)->applicationTag() > tag) == false)
+            {
+                return dom::detail::ListContainer::insertImpl(toIterator(last), child);
+            }
+
+            for (child_iterator i = first; i != last; ++i)
             {
                 ber::Tag const other = i->applicationTag();
                 if (other > tag)
                 {
-                    return dom::detail::ListContainer::insertImpl(i, child);
+                    return dom::detail::ListContainer::insertImpl(toIterator(i), child);
                 }
             }
         }
-        return dom::detail::ListContainer::insertImpl(last, child);
+        return dom::detail::ListContainer::insertImpl(toIterator(last), child);
     }
 
     LIBEMBER_INLINE
@@ -34,8 +34,67 @@ namespace libember { namespace glow
         , m_contentTag(contentTag)
         , m_propertyFlags(0)
         , m_container(0)
+        , m_index()
+        , m_indexedGeneration(0)
+        , m_recycled()
     {}
 
+    LIBEMBER_INLINE
+    Contents::~Contents()
+    {
+        LeafList::const_iterator const last = m_recycled.end();
+        for (LeafList::const_iterator it = m_recycled.begin(); it != last; ++it)
+        {
+            delete *it;
+        }
+    }
+
+    LIBEMBER_INLINE
+    void Contents::recycle()
+    {
+        assureContainer();
+
+        if (m_container == 0)
+            return;
+
+        while (m_container->empty() == false)
+        {
+            dom::Node* const node = m_container->release(m_container->begin());
+            dom::VariantLeaf* const leaf = dynamic_cast<dom::VariantLeaf*>(node);
+
+            if (leaf != 0)
+            {
+                m_recycled.push_back(leaf);
+            }
+            else
+            {
+                delete node;
+            }
+        }
+
+        m_propertyFlags = 0;
+        m_index.clear();
+        m_indexedGeneration = m_container->generation();
+    }
+
+    LIBEMBER_INLINE
+    dom::VariantLeaf* Contents::takeRecycled(ber::Tag const& tag)
+    {
+        LeafList::iterator const first = m_recycled.begin();
+        LeafList::iterator const last = m_recycled.end();
+        for (LeafList::iterator it = first; it != last; ++it)
+        {
+            if ((*it)->applicationTag() == tag)
+            {
+                dom::VariantLeaf* const leaf = *it;
+                m_recycled.erase(it, it + 1);
+                return leaf;
+            }
+        }
+
+        return 0;
+    }
+
     LIBEMBER_INLINE
     void Contents::assureContainer() const
     {
@@ -56,29 +115,101 @@ namespace libember { namespace glow
 
                 if (m_container != 0)
                 {
-                    dom::Set::const_iterator const first = m_container->begin();
-                    dom::Set::const_iterator const last = m_container->end();
-
-                    m_propertyFlags = generatePropertyFlags(first, last);
+                    rebuildIndex();
                 }
             }
         }
     }
 
     LIBEMBER_INLINE
-    Contents::flag_type Contents::generatePropertyFlags(const_iterator first, const_iterator last) const
+    void Contents::rebuildIndex() const
     {
-        flag_type flags = 0;
+        dom::Set::const_iterator first = m_container->begin();
+        dom::Set::const_iterator const last = m_container->end();
+
+        m_propertyFlags = 0;
+        m_index.clear();
+        m_indexedGeneration = m_container->generation();
 
         for(; first != last; ++first)
         {
-            ber::Tag const tag = first->applicationTag();
+            indexInsertedNode(const_cast<dom::Node*>(&*first));
+        }
+    }
 
-            if (tag.getClass() == ber::Class::ContextSpecific)
-                flags |= (1 << tag.number());
+    LIBEMBER_INLINE
+    void Contents::assureIndex() const
+    {
+        assureContainer();
+
+        if (m_container != 0 && m_container->generation() != m_indexedGeneration)
+        {
+            rebuildIndex();
         }
+    }
 
-        return flags;
+    LIBEMBER_INLINE
+    dom::Node* Contents::lookup(ber::Tag const& tag) const
+    {
+        ber::Tag::Number const number = tag.number();
+        if (tag.getClass() == ber::Class::ContextSpecific && number < sizeof(flag_type) * 8)
+        {
+            return lookupProperty(number);
+        }
+        else
+        {
+            assureIndex();
+
+            if (m_container == 0)
+                return 0;
+
+            iterator const first = m_container->begin();
+            iterator const last = m_container->end();
+            iterator const result = util::find_tag(first, last, tag);
+            return result != last ? &*result : 0;
+        }
+    }
+
+    LIBEMBER_INLINE
+    dom::Node* Contents::lookupProperty(flag_type number) const
+    {
+        assureIndex();
+
+        if (m_container == 0 || (m_propertyFlags & (flag_type(1) << number)) == 0)
+            return 0;
+
+        return m_index[indexPosition(number)];
+    }
+
+    LIBEMBER_INLINE
+    void Contents::indexInsertedNode(dom::Node* node) const
+    {
+        ber::Tag const tag = node->applicationTag();
+        ber::Tag::Number const number = tag.number();
+
+        m_indexedGeneration = m_container->generation();
+
+        if (tag.getClass() == ber::Class::ContextSpecific && number < sizeof(flag_type) * 8)
+        {
+            flag_type const flag = flag_type(1) << number;
+            if ((m_propertyFlags & flag) == 0)
+            {
+                m_index.insert(m_index.begin() + indexPosition(number), node);
+                m_propertyFlags |= flag;
+            }
+        }
+    }
+
+    LIBEMBER_INLINE
+    Contents::size_type Contents::indexPosition(ber::Tag::Number number) const
+    {
+        // Counts the bits set below the bit of the requested tag number.
+        flag_type bits = m_propertyFlags & ((flag_type(1) << number) - 1);
+        size_type count = 0;
+        for (; bits != 0; bits &= bits - 1)
+            ++count;
+
+        return count;
     }
 
     LIBEMBER_INLINE
@@ -122,6 +253,32 @@ namespace libember { namespace glow
 #  pragma warning(pop)
 #endif
 
+    LIBEMBER_INLINE
+    void GlowContentElement::encodeProperties(libember::util::OctetStream& output) const
+    {
+        Contents::const_iterator first = m_contents.begin();
+        Contents::const_iterator const last = m_contents.end();
+        for (/* Nothing */; first != last; ++first)
+        {
+            first->encode(output);
+        }
+    }
+
+    LIBEMBER_INLINE
+    void GlowContentElement::insertEncodedProperties(libember::util::OctetSlice const& properties)
+    {
+        if (properties.empty() == false)
+        {
+            m_contents.set(new dom::EncodedNode(properties));
+        }
+    }
+
+    LIBEMBER_INLINE
+    void GlowContentElement::recycleProperties()
+    {
+        m_contents.recycle();
+    }
+
     LIBEMBER_INLINE
     Contents& GlowContentElement::contents() 
     {
@@ -20,20 +20,207 @@
 #ifndef __LIBEMBER_GLOW_GLOWELEMENTCOLLECTION_IPP
 #define __LIBEMBER_GLOW_GLOWELEMENTCOLLECTION_IPP
 
+#include <algorithm>
 #include "../../util/Inline.hpp"
 #include "../GlowElement.hpp"
+#include "../GlowTags.hpp"
+#include "../util/Find.hpp"
+#include "../util/ValueConverter.hpp"
 
 namespace libember { namespace glow 
 {
+    namespace detail
+    {
+        /**
+         * Returns the number of an element that is identified by a number.
+         * @param element The element to return the number of.
+         * @param number Receives the number, which is -1 if it has not been decoded yet.
+         * @return False if the element is not identified by a number, like a command
+         *      or a qualified element.
+         */
+        inline bool numberOf(GlowElement const& element, int& number)
+        {
+            ber::Tag tag;
+            switch(element.typeTag().number())
+            {
+                case GlowType::Node:
+                    tag = GlowTags::Node::Number();
+                    break;
+
+                case GlowType::Parameter:
+                    tag = GlowTags::Parameter::Number();
+                    break;
+
+                case GlowType::Matrix:
+                    tag = GlowTags::Matrix::Number();
+                    break;
+
+                case GlowType::Function:
+                    tag = GlowTags::Function::Number();
+                    break;
+
+                default:
+                    return false;
+            }
+
+            dom::Container::const_iterator const first = element.begin();
+            dom::Container::const_iterator const last = element.end();
+            dom::Container::const_iterator const result = util::find_tag(first, last, tag);
+            number = result != last ? util::ValueConverter::valueOf(&*result, -1) : -1;
+            return true;
+        }
+
+        /**
+         * Returns the children of a node without creating them, since GlowNodeBase
+         * cannot be used here without a circular dependency between the headers.
+         * @param element The element to return the children of.
+         * @return The children or null, if the element is not a node or has no children.
+         */
+        inline GlowElementCollection const* childrenOf(GlowElement const& element)
+        {
+            if (element.typeTag().number() == GlowType::Node)
+            {
+                dom::Container::const_iterator const last = element.end();
+                dom::Container::const_iterator const result = util::find_tag(element.begin(), last, GlowTags::Node::Children());
+                if (result != last)
+                {
+                    return dynamic_cast<GlowElementCollection const*>(&*result);
+                }
+            }
+            return 0;
+        }
+
+        /**
+         * Orders the entries of the number index of an element collection.
+         */
+        struct IndexEntryLess
+        {
+            template<typename Entry>
+            bool operator()(Entry const& lhs, Entry const& rhs) const
+            {
+                return lhs.first < rhs.first;
+            }
+
+            template<typename Entry>
+            bool operator()(Entry const& lhs, int rhs) const
+            {
+                return lhs.first < rhs;
+            }
+        };
+    }
+
     LIBEMBER_INLINE
     GlowElementCollection::GlowElementCollection()
         : GlowContainer(GlowType::ElementCollection)
+        , m_isIndexValid(false)
     {}
 
     LIBEMBER_INLINE
     GlowElementCollection::GlowElementCollection(ber::Tag const& tag)
         : GlowContainer(GlowType::ElementCollection, tag)
+        , m_isIndexValid(false)
+    {}
+
+    LIBEMBER_INLINE
+    GlowElementCollection::GlowElementCollection(GlowElementCollection const& other)
+        : GlowContainer(other)
+        , m_isIndexValid(false)
     {}
+
+    LIBEMBER_INLINE
+    GlowElement* GlowElementCollection::elementAt(int number)
+    {
+        return const_cast<GlowElement*>(static_cast<GlowElementCollection const*>(this)->elementAt(number));
+    }
+
+    LIBEMBER_INLINE
+    GlowElement const* GlowElementCollection::elementAt(int number) const
+    {
+        if (m_isIndexValid == false)
+        {
+            buildIndex();
+        }
+
+        IndexEntryVector::const_iterator const first = m_index.begin();
+        IndexEntryVector::const_iterator const last = m_index.end();
+        IndexEntryVector::const_iterator const result = std::lower_bound(first, last, number, detail::IndexEntryLess());
+        return (result != last && result->first == number) ? result->second : 0;
+    }
+
+    LIBEMBER_INLINE
+    GlowElement* GlowElementCollection::elementAt(ber::ObjectIdentifier const& path)
+    {
+        return const_cast<GlowElement*>(static_cast<GlowElementCollection const*>(this)->elementAt(path));
+    }
+
+    LIBEMBER_INLINE
+    GlowElement const* GlowElementCollection::elementAt(ber::ObjectIdentifier const& path) const
+    {
+        GlowElementCollection const* collection = this;
+        GlowElement const* element = 0;
+        ber::ObjectIdentifier::const_iterator const last = path.end();
+        for (ber::ObjectIdentifier::const_iterator it = path.begin(); it != last; ++it)
+        {
+            if (element != 0)
+            {
+                collection = detail::childrenOf(*element);
+                if (collection == 0)
+                {
+                    return 0;
+                }
+            }
+
+            element = collection->elementAt(static_cast<int>(*it));
+            if (element == 0)
+            {
+                return 0;
+            }
+        }
+        return element;
+    }
+
+    LIBEMBER_INLINE
+    GlowElementCollection::iterator GlowElementCollection::insertImpl(iterator const& where, Node* child)
+    {
+        m_isIndexValid = false;
+        return GlowContainer::insertImpl(where, child);
+    }
+
+    LIBEMBER_INLINE
+    void GlowElementCollection::eraseImpl(iterator const& first, iterator const& last)
+    {
+        m_isIndexValid = false;
+        GlowContainer::eraseImpl(first, last);
+    }
+
+    LIBEMBER_INLINE
+    void GlowElementCollection::buildIndex() const
+    {
+        bool isComplete = true;
+        m_index.clear();
+
+        const_child_iterator const last = childEnd();
+        for (const_child_iterator it = childBegin(); it != last; ++it)
+        {
+            GlowElement const* const element = dynamic_cast<GlowElement const*>(&*it);
+            int number = -1;
+            if (element != 0 && detail::numberOf(*element, number))
+            {
+                if (number != -1)
+                {
+                    m_index.push_back(IndexEntry(number, const_cast<GlowElement*>(element)));
+                }
+                else
+                {
+                    isComplete = false;
+                }
+            }
+        }
+
+        // A stable sort returns the first of several children sharing a number, like a linear search.
+        std::stable_sort(m_index.begin(), m_index.end(), detail::IndexEntryLess());
+        m_isIndexValid = isComplete;
+    }
 }
 }
 
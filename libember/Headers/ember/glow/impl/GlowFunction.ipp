@@ -37,14 +37,14 @@ namespace libember { namespace glow
     GlowFunction::GlowFunction(int number)
         : GlowFunctionBase(GlowType::Function, GlowTags::ElementDefault(), GlowTags::Function::Contents(), GlowTags::Function::Children())
     {
-        insert(begin(), new dom::VariantLeaf(GlowTags::Function::Number(), number));
+        insert(begin(), new dom::StaticLeaf<int>(GlowTags::Function::Number(), number));
     }
 
     LIBEMBER_INLINE
     GlowFunction::GlowFunction(GlowRootElementCollection* parent, int number)
         : GlowFunctionBase(GlowType::Function, GlowTags::ElementDefault(), GlowTags::Function::Contents(), GlowTags::Function::Children())
     {
-        insert(begin(), new dom::VariantLeaf(GlowTags::Function::Number(), number));
+        insert(begin(), new dom::StaticLeaf<int>(GlowTags::Function::Number(), number));
 
         if (parent)
         {
@@ -57,7 +57,7 @@ namespace libember { namespace glow
     GlowFunction::GlowFunction(GlowNodeBase* parent, int number)
         : GlowFunctionBase(GlowType::Function, GlowTags::ElementDefault(), GlowTags::Function::Contents(), GlowTags::Function::Children())
     {
-        insert(begin(), new dom::VariantLeaf(GlowTags::Function::Number(), number));
+        insert(begin(), new dom::StaticLeaf<int>(GlowTags::Function::Number(), number));
 
         if (parent)
         {
@@ -71,7 +71,7 @@ namespace libember { namespace glow
     GlowFunction::GlowFunction(int number, ber::Tag const& tag)
         : GlowFunctionBase(GlowType::Function, tag, GlowTags::Function::Contents(), GlowTags::Function::Children())
     {
-        insert(begin(), new dom::VariantLeaf(GlowTags::Function::Number(), number));
+        insert(begin(), new dom::StaticLeaf<int>(GlowTags::Function::Number(), number));
     }
 
     LIBEMBER_INLINE
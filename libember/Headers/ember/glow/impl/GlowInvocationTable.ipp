@@ -0,0 +1,149 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+#ifndef __LIBEMBER_GLOW_IMPL_GLOWINVOCATIONTABLE_IPP
+#define __LIBEMBER_GLOW_IMPL_GLOWINVOCATIONTABLE_IPP
+
+#include <limits>
+#include <vector>
+#include "../../util/Inline.hpp"
+#include "../GlowInvocation.hpp"
+#include "../GlowInvocationResult.hpp"
+
+namespace libember { namespace glow
+{
+    LIBEMBER_INLINE
+    GlowInvocationTable::Callback::~Callback()
+    {}
+
+    LIBEMBER_INLINE
+    GlowInvocationTable::Pending::Pending(Callback* callback, tick_type deadline)
+        : callback(callback)
+        , deadline(deadline)
+    {}
+
+    LIBEMBER_INLINE
+    GlowInvocationTable::GlowInvocationTable()
+        : m_nextId(1)
+    {}
+
+    LIBEMBER_INLINE
+    int GlowInvocationTable::add(Callback* callback, tick_type deadline)
+    {
+        while (m_pending.find(m_nextId) != m_pending.end())
+        {
+            m_nextId = (m_nextId < std::numeric_limits<int>::max()) ? m_nextId + 1 : 1;
+        }
+
+        int const invocationId = m_nextId;
+        m_nextId = (m_nextId < std::numeric_limits<int>::max()) ? m_nextId + 1 : 1;
+        m_pending.insert(std::make_pair(invocationId, Pending(callback, deadline)));
+        return invocationId;
+    }
+
+    LIBEMBER_INLINE
+    GlowInvocation* GlowInvocationTable::createInvocation(Callback* callback, tick_type deadline)
+    {
+        GlowInvocation* const invocation = new GlowInvocation();
+        invocation->setInvocationId(add(callback, deadline));
+        return invocation;
+    }
+
+    LIBEMBER_INLINE
+    bool GlowInvocationTable::complete(GlowInvocationResult const& result)
+    {
+        int const invocationId = result.invocationId();
+        PendingMap::iterator const it = m_pending.find(invocationId);
+        if (it == m_pending.end())
+        {
+            return false;
+        }
+
+        // removed first, so the callback may add further invocations
+        Callback* const callback = it->second.callback;
+        m_pending.erase(it);
+        callback->completed(invocationId, result);
+        return true;
+    }
+
+    LIBEMBER_INLINE
+    GlowInvocationTable::size_type GlowInvocationTable::expire(tick_type now)
+    {
+        typedef std::vector<std::pair<int, Callback*> > ExpiredVector;
+        ExpiredVector expired;
+        for (PendingMap::iterator it = m_pending.begin(); it != m_pending.end(); )
+        {
+            if (isDue(it->second.deadline, now))
+            {
+                expired.push_back(std::make_pair(it->first, it->second.callback));
+                m_pending.erase(it++);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+
+        for (ExpiredVector::const_iterator it = expired.begin(); it != expired.end(); ++it)
+        {
+            it->second->timedOut(it->first);
+        }
+        return expired.size();
+    }
+
+    LIBEMBER_INLINE
+    bool GlowInvocationTable::cancel(int invocationId)
+    {
+        return m_pending.erase(invocationId) > 0;
+    }
+
+    LIBEMBER_INLINE
+    void GlowInvocationTable::clear()
+    {
+        m_pending.clear();
+    }
+
+    LIBEMBER_INLINE
+    bool GlowInvocationTable::contains(int invocationId) const
+    {
+        return m_pending.find(invocationId) != m_pending.end();
+    }
+
+    LIBEMBER_INLINE
+    bool GlowInvocationTable::empty() const
+    {
+        return m_pending.empty();
+    }
+
+    LIBEMBER_INLINE
+    GlowInvocationTable::size_type GlowInvocationTable::size() const
+    {
+        return m_pending.size();
+    }
+
+    LIBEMBER_INLINE
+    bool GlowInvocationTable::isDue(tick_type deadline, tick_type now)
+    {
+        return static_cast<tick_type>(now - deadline) <= (std::numeric_limits<tick_type>::max() >> 1);
+    }
+}
+}
+
+#endif  // __LIBEMBER_GLOW_IMPL_GLOWINVOCATIONTABLE_IPP
@@ -38,7 +38,7 @@ namespace libember { namespace glow
             GlowTags::Matrix::Sources(),
             GlowTags::Matrix::Connections())
     {
-        insert(begin(), new dom::VariantLeaf(GlowTags::Matrix::Number(), number));
+        insert(begin(), new dom::StaticLeaf<int>(GlowTags::Matrix::Number(), number));
     }
 
     LIBEMBER_INLINE
@@ -52,7 +52,7 @@ namespace libember { namespace glow
             GlowTags::Matrix::Sources(),
             GlowTags::Matrix::Connections())
     {
-        insert(begin(), new dom::VariantLeaf(GlowTags::Matrix::Number(), number));
+        insert(begin(), new dom::StaticLeaf<int>(GlowTags::Matrix::Number(), number));
         if (parent)
         {
             GlowRootElementCollection::iterator const where = parent->end();
@@ -71,7 +71,7 @@ namespace libember { namespace glow
             GlowTags::Matrix::Sources(),
             GlowTags::Matrix::Connections())
     {
-        insert(begin(), new dom::VariantLeaf(GlowTags::Node::Number(), number));
+        insert(begin(), new dom::StaticLeaf<int>(GlowTags::Node::Number(), number));
         if (parent)
         {
             GlowElementCollection* children = parent->children();
@@ -91,7 +91,7 @@ namespace libember { namespace glow
             GlowTags::Matrix::Sources(),
             GlowTags::Matrix::Connections())
     {
-        insert(begin(), new dom::VariantLeaf(GlowTags::Node::Number(), number));
+        insert(begin(), new dom::StaticLeaf<int>(GlowTags::Node::Number(), number));
     }
 
     LIBEMBER_INLINE
@@ -21,6 +21,8 @@
 #define __LIBEMBER_GLOW_GLOWMATRIXBASE_IPP
 
 #include "../../util/Inline.hpp"
+#include "../../dom/EncodedNode.hpp"
+#include "../../util/OctetSlice.hpp"
 #include "../util/ValueConverter.hpp"
 #include "../util/Validation.hpp"
 
@@ -214,31 +216,65 @@ namespace libember { namespace glow
         }
     }
 
+    LIBEMBER_INLINE
+    void GlowMatrixBase::insertConnections(GlowConnectionTable const& table)
+    {
+        if (table.empty())
+            return;
+
+        libember::util::OctetStream stream;
+        table.encode(stream);
+
+        libember::util::OctetSliceBuffer buffer(stream.size());
+        libember::util::OctetSlice const encoding = buffer.append(stream.begin(), stream.size());
+
+        dom::Sequence* const collection = connections();
+        collection->insert(collection->end(), new dom::EncodedNode(encoding));
+    }
+
     LIBEMBER_INLINE
     std::string GlowMatrixBase::description() const
     {
-        ber::Value const value = contents().get(GlowTags::MatrixContents::Description());
+        ber::Value const value = contents().getProperty(MatrixProperty::Description);
         return util::ValueConverter::valueOf(value, std::string());
     }
 
     LIBEMBER_INLINE
     std::string GlowMatrixBase::identifier() const
     {
-        ber::Value const value = contents().get(GlowTags::MatrixContents::Identifier());
+        ber::Value const value = contents().getProperty(MatrixProperty::Identifier);
         return util::ValueConverter::valueOf(value, std::string());
     }
 
     LIBEMBER_INLINE
     std::string GlowMatrixBase::schemaIdentifiers() const
     {
-        ber::Value const value = contents().get(GlowTags::MatrixContents::SchemaIdentifiers());
+        ber::Value const value = contents().getProperty(MatrixProperty::SchemaIdentifiers);
         return util::ValueConverter::valueOf(value, std::string());
     }
 
+    LIBEMBER_INLINE
+    std::string const* GlowMatrixBase::peekIdentifier() const
+    {
+        return contents().peekProperty<std::string>(MatrixProperty::Identifier);
+    }
+
+    LIBEMBER_INLINE
+    std::string const* GlowMatrixBase::peekDescription() const
+    {
+        return contents().peekProperty<std::string>(MatrixProperty::Description);
+    }
+
+    LIBEMBER_INLINE
+    std::string const* GlowMatrixBase::peekSchemaIdentifiers() const
+    {
+        return contents().peekProperty<std::string>(MatrixProperty::SchemaIdentifiers);
+    }
+
     LIBEMBER_INLINE
     MatrixType GlowMatrixBase::type() const
     {
-        ber::Value const value = contents().get(GlowTags::MatrixContents::Type());
+        ber::Value const value = contents().getProperty(MatrixProperty::Type);
         int const type = util::ValueConverter::valueOf(value, int(MatrixType::OneToN));
         return static_cast<MatrixType::_Domain>(type);
     }
@@ -246,7 +282,7 @@ namespace libember { namespace glow
     LIBEMBER_INLINE
     MatrixAddressingMode GlowMatrixBase::addressingMode() const
     {
-        ber::Value const value = contents().get(GlowTags::MatrixContents::AddressingMode());
+        ber::Value const value = contents().getProperty(MatrixProperty::AddressingMode);
         int const type = util::ValueConverter::valueOf(value, int(MatrixAddressingMode::Linear));
         return static_cast<MatrixAddressingMode::_Domain>(type);
     }
@@ -254,42 +290,42 @@ namespace libember { namespace glow
     LIBEMBER_INLINE
     int GlowMatrixBase::targetCount() const
     {
-        ber::Value const value = contents().get(GlowTags::MatrixContents::TargetCount());
+        ber::Value const value = contents().getProperty(MatrixProperty::TargetCount);
         return util::ValueConverter::valueOf(value, 0);
     }
 
     LIBEMBER_INLINE
     int GlowMatrixBase::sourceCount() const
     {
-        ber::Value const value = contents().get(GlowTags::MatrixContents::SourceCount());
+        ber::Value const value = contents().getProperty(MatrixProperty::SourceCount);
         return util::ValueConverter::valueOf(value, 0);
     }
 
     LIBEMBER_INLINE
     int GlowMatrixBase::maximumTotalConnects() const
     {
-        ber::Value const value = contents().get(GlowTags::MatrixContents::MaximumTotalConnects());
+        ber::Value const value = contents().getProperty(MatrixProperty::MaximumTotalConnects);
         return util::ValueConverter::valueOf(value, 0);
     }
 
     LIBEMBER_INLINE
     int GlowMatrixBase::maximumConnectsPerTarget() const
     {
-        ber::Value const value = contents().get(GlowTags::MatrixContents::MaximumConnectsPerTarget());
+        ber::Value const value = contents().getProperty(MatrixProperty::MaximumConnectsPerTarget);
         return util::ValueConverter::valueOf(value, 0);
     }
 
     LIBEMBER_INLINE
     ParametersLocation GlowMatrixBase::parametersLocation() const
     {
-        ber::Value const value = contents().get(GlowTags::MatrixContents::ParametersLocation());
+        ber::Value const value = contents().getProperty(MatrixProperty::ParametersLocation);
         return ParametersLocation(value);
     }
 
     LIBEMBER_INLINE
     int GlowMatrixBase::gainParameterNumber() const
     {
-        ber::Value const value = contents().get(GlowTags::MatrixContents::GainParameterNumber());
+        ber::Value const value = contents().getProperty(MatrixProperty::GainParameterNumber);
         return util::ValueConverter::valueOf(value, -1);
     }
 
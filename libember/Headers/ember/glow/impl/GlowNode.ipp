@@ -32,7 +32,7 @@ namespace libember { namespace glow
         : GlowNodeBase(GlowType::Node, GlowTags::ElementDefault(), GlowTags::Node::Contents(), GlowTags::Node::Children())
         , m_cachedNumber(-1)
     {
-        insert(begin(), new dom::VariantLeaf(GlowTags::Node::Number(), number));
+        insert(begin(), new dom::StaticLeaf<int>(GlowTags::Node::Number(), number));
     }
 
     LIBEMBER_INLINE
@@ -40,7 +40,7 @@ namespace libember { namespace glow
         : GlowNodeBase(GlowType::Node, GlowTags::ElementDefault(), GlowTags::Node::Contents(), GlowTags::Node::Children())
         , m_cachedNumber(-1)
     {
-        insert(begin(), new dom::VariantLeaf(GlowTags::Node::Number(), number));
+        insert(begin(), new dom::StaticLeaf<int>(GlowTags::Node::Number(), number));
         if (parent)
         {
             GlowRootElementCollection::iterator const where = parent->end();
@@ -53,7 +53,7 @@ namespace libember { namespace glow
         : GlowNodeBase(GlowType::Node, GlowTags::ElementDefault(), GlowTags::Node::Contents(), GlowTags::Node::Children())
         , m_cachedNumber(-1)
     {
-        insert(begin(), new dom::VariantLeaf(GlowTags::Node::Number(), number));
+        insert(begin(), new dom::StaticLeaf<int>(GlowTags::Node::Number(), number));
         if (parent)
         {
             GlowElementCollection* children = parent->children();
@@ -67,7 +67,7 @@ namespace libember { namespace glow
         : GlowNodeBase(GlowType::Node, tag, GlowTags::Node::Contents(), GlowTags::Node::Children())
         , m_cachedNumber(-1)
     {
-        insert(begin(), new dom::VariantLeaf(GlowTags::Node::Number(), number));
+        insert(begin(), new dom::StaticLeaf<int>(GlowTags::Node::Number(), number));
     }
 
     LIBEMBER_INLINE
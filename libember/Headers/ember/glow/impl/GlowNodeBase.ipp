@@ -60,6 +60,22 @@ namespace libember { namespace glow
         contents().set(GlowTags::NodeContents::Identifier(), identifier);
     }
 
+    LIBEMBER_INLINE
+    void GlowNodeBase::adoptDescription(std::string& description)
+    {
+        contents().adopt(GlowTags::NodeContents::Description(), description);
+    }
+
+    LIBEMBER_INLINE
+    void GlowNodeBase::adoptIdentifier(std::string& identifier)
+    {
+#ifndef LIBEMBER_DISABLE_IDENTIFIER_VALIDATION
+        libember::glow::util::Validation::assertIdentifierValid(identifier);
+#endif//LIBEMBER_DISABLE_IDENTIFIER_VALIDATION
+
+        contents().adopt(GlowTags::NodeContents::Identifier(), identifier);
+    }
+
     LIBEMBER_INLINE
     void GlowNodeBase::setRoot(bool isRoot)
     {
@@ -93,35 +109,53 @@ namespace libember { namespace glow
     LIBEMBER_INLINE
     bool GlowNodeBase::isRoot() const
     {
-        ber::Value const value = contents().get(GlowTags::NodeContents::IsRoot());
+        ber::Value const value = contents().getProperty(NodeProperty::IsRoot);
         return util::ValueConverter::valueOf(value, false);
     }
 
     LIBEMBER_INLINE
     std::string GlowNodeBase::description() const
     {
-        ber::Value const value = contents().get(GlowTags::NodeContents::Description());
+        ber::Value const value = contents().getProperty(NodeProperty::Description);
         return util::ValueConverter::valueOf(value, std::string());
     }
 
     LIBEMBER_INLINE
     std::string GlowNodeBase::identifier() const
     {
-        ber::Value const value = contents().get(GlowTags::NodeContents::Identifier());
+        ber::Value const value = contents().getProperty(NodeProperty::Identifier);
         return util::ValueConverter::valueOf(value, std::string());
     }
 
     LIBEMBER_INLINE
     std::string GlowNodeBase::schemaIdentifiers() const
     {
-        ber::Value const value = contents().get(GlowTags::NodeContents::SchemaIdentifiers());
+        ber::Value const value = contents().getProperty(NodeProperty::SchemaIdentifiers);
         return util::ValueConverter::valueOf(value, std::string());
     }
 
+    LIBEMBER_INLINE
+    std::string const* GlowNodeBase::peekIdentifier() const
+    {
+        return contents().peekProperty<std::string>(NodeProperty::Identifier);
+    }
+
+    LIBEMBER_INLINE
+    std::string const* GlowNodeBase::peekDescription() const
+    {
+        return contents().peekProperty<std::string>(NodeProperty::Description);
+    }
+
+    LIBEMBER_INLINE
+    std::string const* GlowNodeBase::peekSchemaIdentifiers() const
+    {
+        return contents().peekProperty<std::string>(NodeProperty::SchemaIdentifiers);
+    }
+
     LIBEMBER_INLINE
     bool GlowNodeBase::isOnline() const
     {
-        ber::Value const value = contents().get(GlowTags::NodeContents::IsOnline());
+        ber::Value const value = contents().getProperty(NodeProperty::IsOnline);
         return util::ValueConverter::valueOf(value, true);
     }
 
@@ -54,79 +54,94 @@ namespace libember { namespace glow
         return instance;
     }
 
+    namespace
+    {
+        /**
+         * Constructs the factory during static initialization, before any
+         * thread that decodes messages may have been started.
+         */
+        dom::NodeFactory const& theGlowNodeFactoryInitializer = GlowNodeFactory::getFactory();
+    }
+
     LIBEMBER_INLINE
     dom::Node* GlowNodeFactory::createApplicationDefinedNode(ber::Type const& type, ber::Tag const& tag) const
+    {
+        return createApplicationDefinedNode(type, tag, dom::NodeAllocator::heap());
+    }
+
+    LIBEMBER_INLINE
+    dom::Node* GlowNodeFactory::createApplicationDefinedNode(ber::Type const& type, ber::Tag const& tag, dom::NodeAllocator& allocator) const
     {
         switch(type.value())
         {
             case GlowType::Command:
-                return new GlowCommand(tag);
+                return new (allocator) GlowCommand(tag);
 
             case GlowType::ElementCollection:
-                return new GlowElementCollection(tag);
+                return new (allocator) GlowElementCollection(tag);
 
             case GlowType::RootElementCollection:
-                return new GlowRootElementCollection(tag);
+                return new (allocator) GlowRootElementCollection(tag);
 
             case GlowType::StringIntegerCollection:
-                return new GlowStringIntegerCollection(tag);
+                return new (allocator) GlowStringIntegerCollection(tag);
 
             case GlowType::StringIntegerPair:
-                return new GlowStringIntegerPair(tag);
+                return new (allocator) GlowStringIntegerPair(tag);
 
             case GlowType::Node:
-                return new GlowNode(tag);
+                return new (allocator) GlowNode(tag);
 
             case GlowType::QualifiedNode:
-                return new GlowQualifiedNode(tag);
+                return new (allocator) GlowQualifiedNode(tag);
 
             case GlowType::Parameter:
-                return new GlowParameter(tag);
+                return new (allocator) GlowParameter(tag);
 
             case GlowType::QualifiedParameter:
-                return new GlowQualifiedParameter(tag);
+                return new (allocator) GlowQualifiedParameter(tag);
 
             case GlowType::StreamCollection:
-                return new GlowStreamCollection(tag);
+                return new (allocator) GlowStreamCollection(tag);
 
             case GlowType::StreamEntry:
-                return new GlowStreamEntry(tag);
+                return new (allocator) GlowStreamEntry(tag);
 
             case GlowType::StreamDescriptor:
-                return new GlowStreamDescriptor(tag);
+                return new (allocator) GlowStreamDescriptor(tag);
 
             case GlowType::Matrix:
-                return new GlowMatrix(tag);
+                return new (allocator) GlowMatrix(tag);
 
             case GlowType::QualifiedMatrix:
-                return new GlowQualifiedMatrix(tag);
+                return new (allocator) GlowQualifiedMatrix(tag);
 
             case GlowType::Target:
-                return new GlowTarget(tag);
+                return new (allocator) GlowTarget(tag);
 
             case GlowType::Source:
-                return new GlowSource(tag);
+                return new (allocator) GlowSource(tag);
 
             case GlowType::Connection:
-                return new GlowConnection(tag);
+                return new (allocator) GlowConnection(tag);
 
             case GlowType::Label:
-                return new GlowLabel(tag);
+                return new (allocator) GlowLabel(tag);
 
             case GlowType::Function:
-                return new GlowFunction(tag);
+                return new (allocator) GlowFunction(tag);
 
             case GlowType::QualifiedFunction:
-                return new GlowQualifiedFunction(tag);
+                return new (allocator) GlowQualifiedFunction(tag);
 
             case GlowType::Invocation:
-                return new GlowInvocation(tag);
+                return new (allocator) GlowInvocation(tag);
 
             case GlowType::InvocationResult:
-                return new GlowInvocationResult(tag);
+                return new (allocator) GlowInvocationResult(tag);
 
             case GlowType::TupleItemDescription:
-                return new GlowTupleItemDescription(tag);
+                return new (allocator) GlowTupleItemDescription(tag);
 
             default:
                 return 0;
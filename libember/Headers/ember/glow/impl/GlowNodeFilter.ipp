@@ -0,0 +1,154 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef __LIBEMBER_GLOW_IMPL_GLOWNODEFILTER_IPP
+#define __LIBEMBER_GLOW_IMPL_GLOWNODEFILTER_IPP
+
+#include <vector>
+#include "../../util/Inline.hpp"
+#include "../GlowFunction.hpp"
+#include "../GlowMatrix.hpp"
+#include "../GlowNode.hpp"
+#include "../GlowParameter.hpp"
+#include "../GlowQualifiedFunction.hpp"
+#include "../GlowQualifiedMatrix.hpp"
+#include "../GlowQualifiedNode.hpp"
+#include "../GlowQualifiedParameter.hpp"
+#include "../GlowTags.hpp"
+
+namespace libember { namespace glow
+{
+    LIBEMBER_INLINE
+    GlowNodeFilter::GlowNodeFilter()
+        : m_excludedTypes(0)
+    {}
+
+    LIBEMBER_INLINE
+    GlowNodeFilter::GlowNodeFilter(ber::ObjectIdentifier const& prefix)
+        : m_prefix(prefix)
+        , m_excludedTypes(0)
+    {}
+
+    LIBEMBER_INLINE
+    void GlowNodeFilter::setPrefix(ber::ObjectIdentifier const& prefix)
+    {
+        m_prefix = prefix;
+    }
+
+    LIBEMBER_INLINE
+    ber::ObjectIdentifier const& GlowNodeFilter::prefix() const
+    {
+        return m_prefix;
+    }
+
+    LIBEMBER_INLINE
+    void GlowNodeFilter::excludeType(GlowType const& type)
+    {
+        if (type.value() < 32)
+            m_excludedTypes |= (1UL << type.value());
+    }
+
+    LIBEMBER_INLINE
+    void GlowNodeFilter::includeType(GlowType const& type)
+    {
+        if (type.value() < 32)
+            m_excludedTypes &= ~(1UL << type.value());
+    }
+
+    LIBEMBER_INLINE
+    bool GlowNodeFilter::accept(dom::Node const* parent, ber::Type const& type, ber::Tag const& tag) const
+    {
+        if (type.isApplicationDefined())
+        {
+            if (type.value() < 32 && (m_excludedTypes & (1UL << type.value())) != 0)
+                return false;
+
+            // All elements store their children with the same tag.
+            if (m_prefix.size() > 0 && type.value() == GlowType::ElementCollection && tag == GlowTags::Node::Children())
+            {
+                ber::ObjectIdentifier path;
+                if (elementPath(parent, path))
+                    return isWithinPrefix(path);
+            }
+        }
+
+        return true;
+    }
+
+    LIBEMBER_INLINE
+    bool GlowNodeFilter::elementPath(dom::Node const* node, ber::ObjectIdentifier& path)
+    {
+        std::vector<int> numbers;
+        bool isElement = false;
+
+        // Elements and their children collections alternate, so every other
+        // ancestor contributes a number until a qualified element or the root is reached.
+        for (/* Nothing */; node != 0; node = node->parent())
+        {
+            int number = -1;
+            if (GlowNode const* element = dynamic_cast<GlowNode const*>(node))
+                number = element->number();
+            else if (GlowParameter const* element = dynamic_cast<GlowParameter const*>(node))
+                number = element->number();
+            else if (GlowMatrix const* element = dynamic_cast<GlowMatrix const*>(node))
+                number = element->number();
+            else if (GlowFunction const* element = dynamic_cast<GlowFunction const*>(node))
+                number = element->number();
+            else if (GlowQualifiedNode const* element = dynamic_cast<GlowQualifiedNode const*>(node))
+                path = element->path();
+            else if (GlowQualifiedParameter const* element = dynamic_cast<GlowQualifiedParameter const*>(node))
+                path = element->path();
+            else if (GlowQualifiedMatrix const* element = dynamic_cast<GlowQualifiedMatrix const*>(node))
+                path = element->path();
+            else if (GlowQualifiedFunction const* element = dynamic_cast<GlowQualifiedFunction const*>(node))
+                path = element->path();
+            else
+            {
+                if (isElement == false)
+                    return false;
+
+                continue;
+            }
+
+            isElement = true;
+            if (number < 0)
+                break;
+
+            numbers.push_back(number);
+        }
+
+        if (isElement == false)
+            return false;
+
+        for (std::vector<int>::const_reverse_iterator it = numbers.rbegin(); it != numbers.rend(); ++it)
+            path.push_back(static_cast<ber::ObjectIdentifier::value_type>(*it));
+
+        return true;
+    }
+
+    LIBEMBER_INLINE
+    bool GlowNodeFilter::isWithinPrefix(ber::ObjectIdentifier const& path) const
+    {
+        return path.startsWith(m_prefix) || m_prefix.startsWith(path);
+    }
+}
+}
+
+#endif  // __LIBEMBER_GLOW_IMPL_GLOWNODEFILTER_IPP
+
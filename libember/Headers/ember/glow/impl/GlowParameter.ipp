@@ -33,7 +33,7 @@ namespace libember { namespace glow
         : GlowParameterBase(GlowType::Parameter, GlowTags::ElementDefault(), GlowTags::Parameter::Contents(), GlowTags::Parameter::Children())
         , m_cachedNumber(-1)
     {
-        insert(begin(), new dom::VariantLeaf(GlowTags::Parameter::Number(), number));
+        insert(begin(), new dom::StaticLeaf<int>(GlowTags::Parameter::Number(), number));
     }
 
     LIBEMBER_INLINE
@@ -41,7 +41,7 @@ namespace libember { namespace glow
         : GlowParameterBase(GlowType::Parameter, GlowTags::ElementDefault(), GlowTags::Parameter::Contents(), GlowTags::Parameter::Children())
         , m_cachedNumber(-1)
     {
-        insert(begin(), new dom::VariantLeaf(GlowTags::Parameter::Number(), number));
+        insert(begin(), new dom::StaticLeaf<int>(GlowTags::Parameter::Number(), number));
         if (parent)
         {
             GlowElementCollection* children = parent->children();
@@ -55,7 +55,7 @@ namespace libember { namespace glow
         : GlowParameterBase(GlowType::Parameter, tag, GlowTags::Parameter::Contents(), GlowTags::Parameter::Children())
         , m_cachedNumber(-1)
     {
-        insert(begin(), new dom::VariantLeaf(GlowTags::Parameter::Number(), number));
+        insert(begin(), new dom::StaticLeaf<int>(GlowTags::Parameter::Number(), number));
     }
 
     LIBEMBER_INLINE
@@ -20,6 +20,7 @@
 #ifndef __LIBEMBER_GLOW_GLOWPARAMETERBASE_IPP
 #define __LIBEMBER_GLOW_GLOWPARAMETERBASE_IPP
 
+#include <list>
 #include <sstream>
 #include "../../util/Inline.hpp"
 #include "../util/Validation.hpp"
@@ -65,13 +66,30 @@ namespace libember { namespace glow
         contents().set(GlowTags::ParameterContents::Identifier(), identifier);
     }
 
+    LIBEMBER_INLINE
+    void GlowParameterBase::adoptDescription(std::string& description)
+    {
+        contents().adopt(GlowTags::ParameterContents::Description(), description);
+    }
+
+    LIBEMBER_INLINE
+    void GlowParameterBase::adoptIdentifier(std::string& identifier)
+    {
+#ifndef LIBEMBER_DISABLE_IDENTIFIER_VALIDATION
+        libember::glow::util::Validation::assertIdentifierValid(identifier);
+#endif//LIBEMBER_DISABLE_IDENTIFIER_VALIDATION
+
+        contents().adopt(GlowTags::ParameterContents::Identifier(), identifier);
+    }
+
     LIBEMBER_INLINE
     void GlowParameterBase::setFormula(std::string const& providerToConsumer, std::string const& consumerToProvider)
     {
         std::ostringstream stream;
         stream << providerToConsumer << "\n" << consumerToProvider;
 
-        contents().set(GlowTags::ParameterContents::Formula(), stream.str());
+        std::string formula = stream.str();
+        contents().adopt(GlowTags::ParameterContents::Formula(), formula);
     }
 
     LIBEMBER_INLINE
@@ -176,6 +194,18 @@ namespace libember { namespace glow
         contents().set(GlowTags::ParameterContents::Value(), value);
     }
 
+    LIBEMBER_INLINE
+    void GlowParameterBase::adoptValue(std::string& value)
+    {
+        contents().adopt(GlowTags::ParameterContents::Value(), value);
+    }
+
+    LIBEMBER_INLINE
+    void GlowParameterBase::adoptValue(ber::Octets& value)
+    {
+        contents().adopt(GlowTags::ParameterContents::Value(), value);
+    }
+
     LIBEMBER_INLINE
     void GlowParameterBase::setStep(int value)
     {
@@ -234,28 +264,46 @@ namespace libember { namespace glow
     LIBEMBER_INLINE
     std::string GlowParameterBase::description() const
     {
-        ber::Value const value = contents().get(GlowTags::ParameterContents::Description());
+        ber::Value const value = contents().getProperty(ParameterProperty::Description);
         return util::ValueConverter::valueOf(value, std::string());
     }
 
     LIBEMBER_INLINE
     std::string GlowParameterBase::identifier() const
     {
-        ber::Value const value = contents().get(GlowTags::ParameterContents::Identifier());
+        ber::Value const value = contents().getProperty(ParameterProperty::Identifier);
         return util::ValueConverter::valueOf(value, std::string());
     }
 
     LIBEMBER_INLINE
     std::string GlowParameterBase::schemaIdentifiers() const
     {
-        ber::Value const value = contents().get(GlowTags::ParameterContents::SchemaIdentifiers());
+        ber::Value const value = contents().getProperty(ParameterProperty::SchemaIdentifiers);
         return util::ValueConverter::valueOf(value, std::string());
     }
 
+    LIBEMBER_INLINE
+    std::string const* GlowParameterBase::peekIdentifier() const
+    {
+        return contents().peekProperty<std::string>(ParameterProperty::Identifier);
+    }
+
+    LIBEMBER_INLINE
+    std::string const* GlowParameterBase::peekDescription() const
+    {
+        return contents().peekProperty<std::string>(ParameterProperty::Description);
+    }
+
+    LIBEMBER_INLINE
+    std::string const* GlowParameterBase::peekSchemaIdentifiers() const
+    {
+        return contents().peekProperty<std::string>(ParameterProperty::SchemaIdentifiers);
+    }
+
     LIBEMBER_INLINE
     Formula GlowParameterBase::formula() const
     {
-        ber::Value const value = contents().get(GlowTags::ParameterContents::Formula());
+        ber::Value const value = contents().getProperty(ParameterProperty::Formula);
         std::string const term = util::ValueConverter::valueOf(value, std::string());
         std::size_t const index = term.find('\n');
 
@@ -274,14 +322,14 @@ namespace libember { namespace glow
     LIBEMBER_INLINE
     std::string GlowParameterBase::format() const
     {
-        ber::Value const value = contents().get(GlowTags::ParameterContents::Format());
+        ber::Value const value = contents().getProperty(ParameterProperty::Format);
         return util::ValueConverter::valueOf(value, std::string());
     }
 
     LIBEMBER_INLINE
     Enumeration GlowParameterBase::enumeration() const
     {
-        ber::Value const value = contents().get(GlowTags::ParameterContents::Enumeration());
+        ber::Value const value = contents().getProperty(ParameterProperty::Enumeration);
         std::string const enumeration = util::ValueConverter::valueOf(value, std::string());
         std::size_t first = 0;
         std::size_t last = enumeration.find('\n');
@@ -307,79 +355,88 @@ namespace libember { namespace glow
     Enumeration GlowParameterBase::enumerationMap() const
     {
         Contents::const_iterator const result = util::find_tag(contents().begin(), contents().end(), GlowTags::ParameterContents::EnumMap());
-        std::list<std::pair<std::string, int> > list;
-
         if (result != contents().end())
         {
             GlowStringIntegerCollection const* enumeration = dynamic_cast<GlowStringIntegerCollection const*>(&*result);
+            if (enumeration != 0)
+            {
+                return enumeration->enumeration();
+            }
+        }
 
+        std::list<std::pair<std::string, int> > const empty;
+        return Enumeration(empty.begin(), empty.end());
+    }
+
+    LIBEMBER_INLINE
+    EnumerationPool::Table const* GlowParameterBase::enumeration(EnumerationPool& pool) const
+    {
+        ber::Value const value = contents().getProperty(ParameterProperty::Enumeration);
+        return pool.intern(util::ValueConverter::valueOf(value, std::string()));
+    }
+
+    LIBEMBER_INLINE
+    EnumerationPool::Table const* GlowParameterBase::enumerationMap(EnumerationPool& pool) const
+    {
+        Contents::const_iterator const result = util::find_tag(contents().begin(), contents().end(), GlowTags::ParameterContents::EnumMap());
+        if (result != contents().end())
+        {
+            GlowStringIntegerCollection const* enumeration = dynamic_cast<GlowStringIntegerCollection const*>(&*result);
             if (enumeration != 0)
             {
-                GlowStringIntegerCollection::const_iterator first = enumeration->begin();
-                GlowStringIntegerCollection::const_iterator const last = enumeration->end();
-            
-                for (/** Nothing */; first != last; ++first)
-                {
-                    dom::Node const& node = *first;
-                    GlowStringIntegerPair const* entry = dynamic_cast<GlowStringIntegerPair const*>(&node);
-
-                    if (entry != 0)
-                    {
-                        list.push_back(std::make_pair(entry->name(), entry->value()));
-                    }
-                }
+                return enumeration->table(pool);
             }
         }
 
-        return Enumeration(list.begin(), list.end());
+        return pool.intern(enumerationMap());
     }
 
     LIBEMBER_INLINE
     MinMax GlowParameterBase::minimum() const
     {
-        ber::Value const value = contents().get(GlowTags::ParameterContents::Minimum());
+        ber::Value const value = contents().getProperty(ParameterProperty::Minimum);
         return value ? MinMax(value) : MinMax();
     }
 
     LIBEMBER_INLINE
     MinMax GlowParameterBase::maximum() const
     {
-        ber::Value const value = contents().get(GlowTags::ParameterContents::Maximum());
+        ber::Value const value = contents().getProperty(ParameterProperty::Maximum);
         return value ? MinMax(value) : MinMax();
     }
 
     LIBEMBER_INLINE
     int GlowParameterBase::factor() const
     {
-        ber::Value const value = contents().get(GlowTags::ParameterContents::Factor());
+        ber::Value const value = contents().getProperty(ParameterProperty::Factor);
         return util::ValueConverter::valueOf(value, int(1));
     }
 
     LIBEMBER_INLINE
     Value GlowParameterBase::defaultValue() const
     {
-        ber::Value const value = contents().get(GlowTags::ParameterContents::Default());
+        ber::Value const value = contents().getProperty(ParameterProperty::Default);
         return value ? Value(value) : Value();
     }
 
     LIBEMBER_INLINE
     Value GlowParameterBase::value() const
     {
-        ber::Value const value = contents().get(GlowTags::ParameterContents::Value());
+        ber::Value const value = contents().getProperty(ParameterProperty::Value);
         return value ? Value(value) : Value();
     }
 
     LIBEMBER_INLINE
     int GlowParameterBase::step() const
     {
-        ber::Value const value = contents().get(GlowTags::ParameterContents::Step());
+        ber::Value const value = contents().getProperty(ParameterProperty::Step);
         return util::ValueConverter::valueOf(value, int(1));
     }
 
     LIBEMBER_INLINE
     Access GlowParameterBase::access() const
     {
-        ber::Value const value = contents().get(GlowTags::ParameterContents::Access());
+        ber::Value const value = contents().getProperty(ParameterProperty::Access);
         int const access = util::ValueConverter::valueOf(value, int(Access::ReadOnly));
         return static_cast<Access::_Domain>(access);
     }
@@ -394,7 +451,7 @@ namespace libember { namespace glow
     LIBEMBER_INLINE
     ParameterType GlowParameterBase::type() const
     {
-        ber::Value const value = contents().get(GlowTags::ParameterContents::Type());
+        ber::Value const value = contents().getProperty(ParameterProperty::Type);
         int const type = util::ValueConverter::valueOf(value, int(ParameterType::None));
         return static_cast<ParameterType::_Domain>(type);
     }
@@ -426,7 +483,7 @@ namespace libember { namespace glow
     LIBEMBER_INLINE
     int GlowParameterBase::streamIdentifier() const
     {
-        ber::Value const value = contents().get(GlowTags::ParameterContents::StreamIdentifier());
+        ber::Value const value = contents().getProperty(ParameterProperty::StreamIdentifier);
         return util::ValueConverter::valueOf(value, int(-1));
     }
 
@@ -465,7 +522,7 @@ namespace libember { namespace glow
     LIBEMBER_INLINE
     bool GlowParameterBase::isOnline() const
     {
-        ber::Value const value = contents().get(GlowTags::ParameterContents::IsOnline());
+        ber::Value const value = contents().getProperty(ParameterProperty::IsOnline);
         return util::ValueConverter::valueOf(value, true);
     }
 }
@@ -0,0 +1,832 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+#ifndef __LIBEMBER_GLOW_IMPL_GLOWPROXY_IPP
+#define __LIBEMBER_GLOW_IMPL_GLOWPROXY_IPP
+
+#include <algorithm>
+#include "../../util/Inline.hpp"
+#include "../../util/OctetSlice.hpp"
+#include "../../util/OctetStream.hpp"
+#include "../GlowCommand.hpp"
+#include "../GlowConnection.hpp"
+#include "../GlowElementCollection.hpp"
+#include "../GlowFunction.hpp"
+#include "../GlowInvocation.hpp"
+#include "../GlowInvocationResult.hpp"
+#include "../GlowMatrix.hpp"
+#include "../GlowNode.hpp"
+#include "../GlowParameter.hpp"
+#include "../GlowQualifiedFunction.hpp"
+#include "../GlowQualifiedMatrix.hpp"
+#include "../GlowQualifiedNode.hpp"
+#include "../GlowQualifiedParameter.hpp"
+#include "../GlowRootElementCollection.hpp"
+#include "../GlowSource.hpp"
+#include "../GlowStreamCollection.hpp"
+#include "../GlowStreamEntry.hpp"
+#include "../GlowTarget.hpp"
+
+namespace libember { namespace glow
+{
+    LIBEMBER_INLINE
+    GlowProxy::Connection::~Connection()
+    {}
+
+    LIBEMBER_INLINE
+    bool GlowProxy::PathLess::operator()(ber::ObjectIdentifier const& lhs, ber::ObjectIdentifier const& rhs) const
+    {
+        return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+
+    LIBEMBER_INLINE
+    GlowProxy::Directory::Directory(GlowTreeMirror::ElementType type)
+        : type(type)
+        , isResolved(false)
+    {}
+
+    LIBEMBER_INLINE
+    GlowProxy::Subscription::Subscription(GlowTreeMirror::ElementType type)
+        : type(type)
+    {}
+
+    LIBEMBER_INLINE
+    GlowProxy::PendingInvocation::PendingInvocation(GlowProxy& proxy, Connection* consumer, int invocationId)
+        : proxy(proxy)
+        , consumer(consumer)
+        , invocationId(invocationId)
+    {}
+
+    LIBEMBER_INLINE
+    void GlowProxy::PendingInvocation::completed(int, GlowInvocationResult const& result)
+    {
+        if (consumer != 0)
+        {
+            GlowInvocationResult response;
+            response.setInvocationId(invocationId);
+            response.setSuccess(result.success());
+            copyChildren(response.result(), result.result());
+            consumer->write(response);
+        }
+
+        // the table has already removed the invocation, so this callback is not referenced anymore
+        proxy.m_pendingInvocations.erase(this);
+        delete this;
+    }
+
+    LIBEMBER_INLINE
+    void GlowProxy::PendingInvocation::timedOut(int)
+    {
+        if (consumer != 0)
+        {
+            GlowInvocationResult response;
+            response.setInvocationId(invocationId);
+            response.setSuccess(false);
+            consumer->write(response);
+        }
+
+        proxy.m_pendingInvocations.erase(this);
+        delete this;
+    }
+
+    LIBEMBER_INLINE
+    GlowProxy::GlowProxy(Connection& provider, tick_type invocationTimeout)
+        : m_cache(true)
+        , m_provider(provider)
+        , m_source(0)
+        , m_type(GlowTreeMirror::Node)
+        , m_invocationTimeout(invocationTimeout)
+        , m_now(0)
+    {}
+
+    LIBEMBER_INLINE
+    GlowProxy::~GlowProxy()
+    {
+        m_invocations.clear();
+
+        InvocationSet::iterator const last = m_pendingInvocations.end();
+        for (InvocationSet::iterator it = m_pendingInvocations.begin(); it != last; ++it)
+        {
+            delete *it;
+        }
+
+        MessageMap::iterator const lastMessage = m_messages.end();
+        for (MessageMap::iterator it = m_messages.begin(); it != lastMessage; ++it)
+        {
+            delete it->second;
+        }
+
+        StreamMap::iterator const lastStream = m_streams.end();
+        for (StreamMap::iterator it = m_streams.begin(); it != lastStream; ++it)
+        {
+            delete it->second;
+        }
+    }
+
+    LIBEMBER_INLINE
+    GlowTreeMirror const& GlowProxy::cache() const
+    {
+        return m_cache;
+    }
+
+    LIBEMBER_INLINE
+    void GlowProxy::attach(Connection* consumer)
+    {
+        m_consumers[consumer];
+    }
+
+    LIBEMBER_INLINE
+    void GlowProxy::detach(Connection* consumer)
+    {
+        ConsumerMap::iterator const result = m_consumers.find(consumer);
+        if (result == m_consumers.end())
+            return;
+
+        PathSet const subscriptions = result->second.subscriptions;
+        PathSet::const_iterator const lastSubscription = subscriptions.end();
+        for (PathSet::const_iterator it = subscriptions.begin(); it != lastSubscription; ++it)
+        {
+            unsubscribe(consumer, *it);
+        }
+
+        DirectoryMap::iterator const lastDirectory = m_directories.end();
+        for (DirectoryMap::iterator it = m_directories.begin(); it != lastDirectory; ++it)
+        {
+            it->second.waiting.erase(consumer);
+        }
+
+        // the invocations remain pending, so their identifiers are not reused before
+        // the provider has answered them, but their results are discarded
+        InvocationSet::iterator const lastInvocation = m_pendingInvocations.end();
+        for (InvocationSet::iterator it = m_pendingInvocations.begin(); it != lastInvocation; ++it)
+        {
+            if ((*it)->consumer == consumer)
+            {
+                (*it)->consumer = 0;
+            }
+        }
+
+        m_consumers.erase(result);
+        flush();
+    }
+
+    LIBEMBER_INLINE
+    GlowProxy::size_type GlowProxy::consumerCount() const
+    {
+        return m_consumers.size();
+    }
+
+    LIBEMBER_INLINE
+    GlowProxy::size_type GlowProxy::subscriptionCount() const
+    {
+        return m_subscriptions.size();
+    }
+
+    LIBEMBER_INLINE
+    void GlowProxy::providerMessage(dom::Node const& message)
+    {
+        m_cache.merge(message);
+
+        m_source = 0;
+        m_path = ber::ObjectIdentifier();
+        m_type = GlowTreeMirror::Node;
+        accept(message);
+
+        resolveDirectories();
+        flush();
+    }
+
+    LIBEMBER_INLINE
+    void GlowProxy::consumerMessage(Connection* consumer, dom::Node const& message)
+    {
+        attach(consumer);
+
+        m_source = consumer;
+        m_path = ber::ObjectIdentifier();
+        m_type = GlowTreeMirror::Node;
+        accept(message);
+        m_source = 0;
+
+        flush();
+    }
+
+    LIBEMBER_INLINE
+    void GlowProxy::providerConnected()
+    {
+        m_cache.clear();
+
+        // the map is ordered, so the directory of a parent is requested before those of its children
+        DirectoryMap::iterator const lastDirectory = m_directories.end();
+        for (DirectoryMap::iterator it = m_directories.begin(); it != lastDirectory; ++it)
+        {
+            it->second.isResolved = false;
+            command(it->first, it->second.type, CommandType::GetDirectory);
+        }
+
+        SubscriptionMap::const_iterator const lastSubscription = m_subscriptions.end();
+        for (SubscriptionMap::const_iterator it = m_subscriptions.begin(); it != lastSubscription; ++it)
+        {
+            command(it->first, it->second.type, CommandType::Subscribe);
+        }
+
+        flush();
+    }
+
+    LIBEMBER_INLINE
+    GlowProxy::size_type GlowProxy::expire(tick_type now)
+    {
+        m_now = now;
+        return m_invocations.expire(now);
+    }
+
+    LIBEMBER_INLINE
+    void GlowProxy::element(GlowContentElement const& glow, GlowTreeMirror::ElementType type, GlowElementCollection const* children)
+    {
+        if (m_source == 0)
+        {
+            m_touched.insert(m_path);
+            if (m_path.empty() == false)
+            {
+                m_touched.insert(parentOf(m_path));
+            }
+
+            forward(glow, type);
+        }
+        else
+        {
+            request(glow, type);
+        }
+
+        if (children != 0)
+        {
+            GlowTreeMirror::ElementType const previous = m_type;
+            m_type = type;
+            acceptChildren(*children);
+            m_type = previous;
+        }
+    }
+
+    LIBEMBER_INLINE
+    void GlowProxy::forward(GlowContentElement const& glow, GlowTreeMirror::ElementType type)
+    {
+        libember::util::OctetStream properties;
+        glow.encodeProperties(properties);
+
+        dom::Sequence const* connections = 0;
+        if (type == GlowTreeMirror::Matrix)
+        {
+            connections = static_cast<GlowMatrixBase const&>(glow).connections();
+            if (connections != 0 && connections->empty())
+            {
+                connections = 0;
+            }
+        }
+
+        if (properties.size() == 0 && connections == 0)
+            return;
+
+        ber::ObjectIdentifier const parent = m_path.empty() ? m_path : parentOf(m_path);
+        libember::util::OctetSliceBuffer buffer(properties.size() > 0 ? properties.size() : 1);
+        libember::util::OctetSlice const encoded = buffer.append(properties.begin(), properties.size());
+
+        ConsumerMap::const_iterator const last = m_consumers.end();
+        for (ConsumerMap::const_iterator it = m_consumers.begin(); it != last; ++it)
+        {
+            Consumer const& consumer = it->second;
+            if (consumer.directories.count(parent) != 0
+            ||  consumer.directories.count(m_path) != 0
+            ||  consumer.subscriptions.count(m_path) != 0)
+            {
+                GlowContentElement* const copy = createElement(messageFor(it->first), type, m_path);
+                copy->insertEncodedProperties(encoded);
+
+                if (connections != 0)
+                {
+                    copyChildren(static_cast<GlowMatrixBase*>(copy)->connections(), connections);
+                }
+            }
+        }
+    }
+
+    LIBEMBER_INLINE
+    void GlowProxy::request(GlowContentElement const& glow, GlowTreeMirror::ElementType type)
+    {
+        if (type == GlowTreeMirror::Parameter)
+        {
+            libember::util::OctetStream properties;
+            glow.encodeProperties(properties);
+            if (properties.size() > 0)
+            {
+                libember::util::OctetSliceBuffer buffer(properties.size());
+                GlowContentElement* const copy = createElement(messageFor(&m_provider), type, m_path);
+                copy->insertEncodedProperties(buffer.append(properties.begin(), properties.size()));
+            }
+        }
+        else if (type == GlowTreeMirror::Matrix)
+        {
+            dom::Sequence const* const connections = static_cast<GlowMatrixBase const&>(glow).connections();
+            if (connections != 0 && connections->empty() == false)
+            {
+                GlowContentElement* const copy = createElement(messageFor(&m_provider), type, m_path);
+                copyChildren(static_cast<GlowMatrixBase*>(copy)->connections(), connections);
+            }
+        }
+    }
+
+    LIBEMBER_INLINE
+    void GlowProxy::answer(Connection* consumer, ber::ObjectIdentifier const& path)
+    {
+        GlowTreeMirror::Element const element = path.empty() ? m_cache.root() : m_cache.find(path);
+        if (element.isValid() == false)
+            return;
+
+        m_consumers[consumer].directories.insert(path);
+
+        GlowRootElementCollection& message = messageFor(consumer);
+        if (element.type() == GlowTreeMirror::Node && element.childCount() > 0)
+        {
+            for (GlowTreeMirror::Element child = element.firstChild(); child.isValid(); child = child.nextSibling())
+            {
+                createElement(message, child, false);
+            }
+        }
+        else if (path.empty() == false)
+        {
+            createElement(message, element, true);
+        }
+    }
+
+    LIBEMBER_INLINE
+    void GlowProxy::getDirectory(Connection* consumer, ber::ObjectIdentifier const& path, GlowTreeMirror::ElementType type)
+    {
+        DirectoryMap::iterator result = m_directories.find(path);
+        if (result == m_directories.end())
+        {
+            result = m_directories.insert(std::make_pair(path, Directory(type))).first;
+            command(path, type, CommandType::GetDirectory);
+        }
+
+        if (result->second.isResolved)
+        {
+            answer(consumer, path);
+        }
+        else
+        {
+            result->second.waiting.insert(consumer);
+        }
+    }
+
+    LIBEMBER_INLINE
+    void GlowProxy::subscribe(Connection* consumer, ber::ObjectIdentifier const& path, GlowTreeMirror::ElementType type)
+    {
+        SubscriptionMap::iterator result = m_subscriptions.find(path);
+        if (result == m_subscriptions.end())
+        {
+            result = m_subscriptions.insert(std::make_pair(path, Subscription(type))).first;
+            command(path, type, CommandType::Subscribe);
+        }
+
+        result->second.consumers.insert(consumer);
+        m_consumers[consumer].subscriptions.insert(path);
+    }
+
+    LIBEMBER_INLINE
+    void GlowProxy::unsubscribe(Connection* consumer, ber::ObjectIdentifier const& path)
+    {
+        m_consumers[consumer].subscriptions.erase(path);
+
+        SubscriptionMap::iterator const result = m_subscriptions.find(path);
+        if (result != m_subscriptions.end())
+        {
+            Subscription& subscription = result->second;
+            subscription.consumers.erase(consumer);
+            if (subscription.consumers.empty())
+            {
+                command(path, subscription.type, CommandType::Unsubscribe);
+                m_subscriptions.erase(result);
+            }
+        }
+    }
+
+    LIBEMBER_INLINE
+    void GlowProxy::invoke(Connection* consumer, ber::ObjectIdentifier const& path, GlowInvocation const& invocation)
+    {
+        PendingInvocation* const pending = new PendingInvocation(*this, consumer, invocation.invocationId());
+        m_pendingInvocations.insert(pending);
+
+        GlowInvocation* const forwarded = m_invocations.createInvocation(pending, m_now + m_invocationTimeout);
+        copyChildren(forwarded->arguments(), invocation.arguments());
+
+        GlowCommand* const command = new GlowCommand(CommandType::Invoke);
+        command->setInvocation(forwarded);
+
+        GlowContentElement* const function = createElement(messageFor(&m_provider), GlowTreeMirror::Function, path);
+        GlowElementCollection* const children = childrenOf(*function, GlowTreeMirror::Function);
+        children->insert(children->end(), command);
+    }
+
+    LIBEMBER_INLINE
+    void GlowProxy::command(ber::ObjectIdentifier const& path, GlowTreeMirror::ElementType type, CommandType const& command)
+    {
+        GlowRootElementCollection& message = messageFor(&m_provider);
+        if (path.empty())
+        {
+            new GlowCommand(&message, command);
+        }
+        else
+        {
+            GlowElementCollection* const children = childrenOf(*createElement(message, type, path), type);
+            children->insert(children->end(), new GlowCommand(command));
+        }
+    }
+
+    LIBEMBER_INLINE
+    void GlowProxy::resolveDirectories()
+    {
+        PathSet::const_iterator const last = m_touched.end();
+        for (PathSet::const_iterator it = m_touched.begin(); it != last; ++it)
+        {
+            DirectoryMap::iterator const result = m_directories.find(*it);
+            if (result != m_directories.end())
+            {
+                Directory& directory = result->second;
+                directory.isResolved = true;
+
+                ConnectionSet waiting;
+                waiting.swap(directory.waiting);
+
+                ConnectionSet::const_iterator const lastWaiting = waiting.end();
+                for (ConnectionSet::const_iterator consumer = waiting.begin(); consumer != lastWaiting; ++consumer)
+                {
+                    answer(*consumer, *it);
+                }
+            }
+        }
+
+        m_touched.clear();
+    }
+
+    LIBEMBER_INLINE
+    GlowRootElementCollection& GlowProxy::messageFor(Connection* connection)
+    {
+        GlowRootElementCollection*& message = m_messages[connection];
+        if (message == 0)
+        {
+            message = GlowRootElementCollection::create();
+        }
+        return *message;
+    }
+
+    LIBEMBER_INLINE
+    GlowStreamCollection& GlowProxy::streamsFor(Connection* consumer)
+    {
+        GlowStreamCollection*& streams = m_streams[consumer];
+        if (streams == 0)
+        {
+            streams = new GlowStreamCollection();
+        }
+        return *streams;
+    }
+
+    LIBEMBER_INLINE
+    void GlowProxy::flush()
+    {
+        MessageMap messages;
+        messages.swap(m_messages);
+
+        StreamMap streams;
+        streams.swap(m_streams);
+
+        MessageMap::iterator const lastMessage = messages.end();
+        for (MessageMap::iterator it = messages.begin(); it != lastMessage; ++it)
+        {
+            it->first->write(*it->second);
+            delete it->second;
+        }
+
+        StreamMap::iterator const lastStream = streams.end();
+        for (StreamMap::iterator it = streams.begin(); it != lastStream; ++it)
+        {
+            it->first->write(*it->second);
+            delete it->second;
+        }
+    }
+
+    LIBEMBER_INLINE
+    GlowContentElement* GlowProxy::createElement(GlowRootElementCollection& message, GlowTreeMirror::ElementType type, ber::ObjectIdentifier const& path)
+    {
+        switch(type)
+        {
+            case GlowTreeMirror::Parameter:
+                return new GlowQualifiedParameter(&message, path);
+
+            case GlowTreeMirror::Matrix:
+                return new GlowQualifiedMatrix(&message, path);
+
+            case GlowTreeMirror::Function:
+                return new GlowQualifiedFunction(&message, path);
+
+            default:
+                return new GlowQualifiedNode(&message, path);
+        }
+    }
+
+    LIBEMBER_INLINE
+    GlowElementCollection* GlowProxy::childrenOf(GlowContentElement& element, GlowTreeMirror::ElementType type)
+    {
+        switch(type)
+        {
+            case GlowTreeMirror::Parameter:
+                return static_cast<GlowParameterBase&>(element).children();
+
+            case GlowTreeMirror::Matrix:
+                return static_cast<GlowMatrixBase&>(element).children();
+
+            case GlowTreeMirror::Function:
+                return static_cast<GlowFunctionBase&>(element).children();
+
+            default:
+                return static_cast<GlowNodeBase&>(element).children();
+        }
+    }
+
+    LIBEMBER_INLINE
+    void GlowProxy::createElement(GlowRootElementCollection& message, GlowTreeMirror::Element const& element, bool withConnections)
+    {
+        GlowContentElement* const glow = createElement(message, element.type(), element.path());
+
+        GlowTreeMirror::PropertyMap const* const properties = element.properties();
+        if (properties != 0)
+        {
+            std::size_t size = 0;
+            GlowTreeMirror::PropertyMap::const_iterator const last = properties->end();
+            for (GlowTreeMirror::PropertyMap::const_iterator it = properties->begin(); it != last; ++it)
+            {
+                size += it->second.size();
+            }
+
+            libember::util::OctetSliceBuffer buffer(size > 0 ? size : 1);
+            for (GlowTreeMirror::PropertyMap::const_iterator it = properties->begin(); it != last; ++it)
+            {
+                if (it->second.empty() == false)
+                {
+                    glow->insertEncodedProperties(buffer.append(it->second.begin(), it->second.size()));
+                }
+            }
+        }
+
+        GlowTreeMirror::MatrixState const* const matrix = element.matrix();
+        if (withConnections && matrix != 0)
+        {
+            insertConnections(static_cast<GlowMatrixBase&>(*glow), *matrix);
+        }
+    }
+
+    LIBEMBER_INLINE
+    void GlowProxy::insertConnections(GlowMatrixBase& matrix, GlowTreeMirror::MatrixState const& state)
+    {
+        if (state.targets.empty() == false)
+        {
+            dom::Sequence* const targets = matrix.targets();
+            GlowTreeMirror::MatrixState::SignalCollection::const_iterator const last = state.targets.end();
+            for (GlowTreeMirror::MatrixState::SignalCollection::const_iterator it = state.targets.begin(); it != last; ++it)
+            {
+                targets->insert(targets->end(), new GlowTarget(*it));
+            }
+        }
+
+        if (state.sources.empty() == false)
+        {
+            dom::Sequence* const sources = matrix.sources();
+            GlowTreeMirror::MatrixState::SignalCollection::const_iterator const last = state.sources.end();
+            for (GlowTreeMirror::MatrixState::SignalCollection::const_iterator it = state.sources.begin(); it != last; ++it)
+            {
+                sources->insert(sources->end(), new GlowSource(*it));
+            }
+        }
+
+        if (state.connections.empty() == false)
+        {
+            dom::Sequence* const connections = matrix.connections();
+            GlowTreeMirror::MatrixState::ConnectionCollection::const_iterator const last = state.connections.end();
+            for (GlowTreeMirror::MatrixState::ConnectionCollection::const_iterator it = state.connections.begin(); it != last; ++it)
+            {
+                GlowConnection* const connection = new GlowConnection(it->target);
+                connection->setSources(it->sources);
+                connections->insert(connections->end(), connection);
+            }
+        }
+    }
+
+    LIBEMBER_INLINE
+    void GlowProxy::copyChildren(dom::Sequence* target, dom::Sequence const* source)
+    {
+        if (target == 0 || source == 0)
+            return;
+
+        dom::Sequence::const_iterator const last = source->end();
+        for (dom::Sequence::const_iterator it = source->begin(); it != last; ++it)
+        {
+            target->insert(target->end(), it->clone());
+        }
+    }
+
+    LIBEMBER_INLINE
+    ber::ObjectIdentifier GlowProxy::parentOf(ber::ObjectIdentifier const& path)
+    {
+        return path.empty()
+            ? path
+            : ber::ObjectIdentifier(path.begin(), path.end() - 1);
+    }
+
+    LIBEMBER_INLINE
+    void GlowProxy::visit(GlowRootElementCollection const& glow)
+    {
+        acceptChildren(glow);
+    }
+
+    LIBEMBER_INLINE
+    void GlowProxy::visit(GlowElementCollection const& glow)
+    {
+        acceptChildren(glow);
+    }
+
+    LIBEMBER_INLINE
+    void GlowProxy::visit(GlowNode const& glow)
+    {
+        m_path.push_back(glow.number());
+        element(glow, GlowTreeMirror::Node, glow.children());
+        m_path = parentOf(m_path);
+    }
+
+    LIBEMBER_INLINE
+    void GlowProxy::visit(GlowQualifiedNode const& glow)
+    {
+        ber::ObjectIdentifier const previous = m_path;
+        m_path = glow.path();
+        element(glow, GlowTreeMirror::Node, glow.children());
+        m_path = previous;
+    }
+
+    LIBEMBER_INLINE
+    void GlowProxy::visit(GlowParameter const& glow)
+    {
+        m_path.push_back(glow.number());
+        element(glow, GlowTreeMirror::Parameter, glow.children());
+        m_path = parentOf(m_path);
+    }
+
+    LIBEMBER_INLINE
+    void GlowProxy::visit(GlowQualifiedParameter const& glow)
+    {
+        ber::ObjectIdentifier const previous = m_path;
+        m_path = glow.path();
+        element(glow, GlowTreeMirror::Parameter, glow.children());
+        m_path = previous;
+    }
+
+    LIBEMBER_INLINE
+    void GlowProxy::visit(GlowMatrix const& glow)
+    {
+        m_path.push_back(glow.number());
+        element(glow, GlowTreeMirror::Matrix, glow.children());
+        m_path = parentOf(m_path);
+    }
+
+    LIBEMBER_INLINE
+    void GlowProxy::visit(GlowQualifiedMatrix const& glow)
+    {
+        ber::ObjectIdentifier const previous = m_path;
+        m_path = glow.path();
+        element(glow, GlowTreeMirror::Matrix, glow.children());
+        m_path = previous;
+    }
+
+    LIBEMBER_INLINE
+    void GlowProxy::visit(GlowFunction const& glow)
+    {
+        m_path.push_back(glow.number());
+        element(glow, GlowTreeMirror::Function, glow.children());
+        m_path = parentOf(m_path);
+    }
+
+    LIBEMBER_INLINE
+    void GlowProxy::visit(GlowQualifiedFunction const& glow)
+    {
+        ber::ObjectIdentifier const previous = m_path;
+        m_path = glow.path();
+        element(glow, GlowTreeMirror::Function, glow.children());
+        m_path = previous;
+    }
+
+    LIBEMBER_INLINE
+    void GlowProxy::visit(GlowCommand const& glow)
+    {
+        // commands sent by the provider are ignored
+        if (m_source == 0)
+            return;
+
+        switch(glow.number().value())
+        {
+            case CommandType::GetDirectory:
+                getDirectory(m_source, m_path, m_type);
+                break;
+
+            case CommandType::Subscribe:
+                if (m_path.empty() == false)
+                {
+                    subscribe(m_source, m_path, m_type);
+                }
+                break;
+
+            case CommandType::Unsubscribe:
+                unsubscribe(m_source, m_path);
+                break;
+
+            case CommandType::Invoke:
+                if (glow.invocation() != 0 && m_type == GlowTreeMirror::Function)
+                {
+                    invoke(m_source, m_path, *glow.invocation());
+                }
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    LIBEMBER_INLINE
+    void GlowProxy::visit(GlowStreamCollection const& glow)
+    {
+        if (m_source != 0)
+            return;
+
+        // collect the consumers of every subscribed stream once, instead of searching
+        // the subscriptions for each entry
+        StreamRouteMap routes;
+        SubscriptionMap::const_iterator const lastSubscription = m_subscriptions.end();
+        for (SubscriptionMap::const_iterator it = m_subscriptions.begin(); it != lastSubscription; ++it)
+        {
+            if (it->second.type == GlowTreeMirror::Parameter)
+            {
+                GlowTreeMirror::Element const element = m_cache.find(it->first);
+                GlowTreeMirror::ParameterState const* const parameter = element.parameter();
+                if (parameter != 0 && parameter->streamIdentifier >= 0)
+                {
+                    ConnectionSet::const_iterator const last = it->second.consumers.end();
+                    for (ConnectionSet::const_iterator consumer = it->second.consumers.begin(); consumer != last; ++consumer)
+                    {
+                        routes.insert(std::make_pair(parameter->streamIdentifier, *consumer));
+                    }
+                }
+            }
+        }
+
+        if (routes.empty())
+            return;
+
+        dom::Sequence::const_iterator const last = glow.end();
+        for (dom::Sequence::const_iterator it = glow.begin(); it != last; ++it)
+        {
+            GlowStreamEntry const* const entry = dynamic_cast<GlowStreamEntry const*>(&*it);
+            if (entry != 0)
+            {
+                std::pair<StreamRouteMap::const_iterator, StreamRouteMap::const_iterator> const range = routes.equal_range(entry->streamIdentifier());
+                for (StreamRouteMap::const_iterator route = range.first; route != range.second; ++route)
+                {
+                    dom::Container& streams = streamsFor(route->second);
+                    streams.insert(streams.end(), entry->clone());
+                }
+            }
+        }
+    }
+
+    LIBEMBER_INLINE
+    void GlowProxy::visit(GlowInvocationResult const& glow)
+    {
+        if (m_source == 0)
+        {
+            m_invocations.complete(glow);
+        }
+    }
+}
+}
+
+#endif  // __LIBEMBER_GLOW_IMPL_GLOWPROXY_IPP
@@ -0,0 +1,505 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef __LIBEMBER_GLOW_IMPL_GLOWREADER_IPP
+#define __LIBEMBER_GLOW_IMPL_GLOWREADER_IPP
+
+#include <stdexcept>
+#include <string>
+#include "../../util/Inline.hpp"
+#include "../../ber/Octets.hpp"
+#include "../../ber/Type.hpp"
+#include "../GlowTags.hpp"
+
+namespace libember { namespace glow
+{
+    LIBEMBER_INLINE
+    GlowReader::Frame::Frame(Kind kind, GlowType::value_type type)
+        : kind(kind)
+        , type(type)
+        , isAnnounced(false)
+        , hasNumber(false)
+        , number(0)
+        , properties(0)
+    {}
+
+    LIBEMBER_INLINE
+    GlowReader::GlowReader()
+        : m_connectionTarget(0)
+        , m_connectionOperation(ConnectionOperation::Absolute)
+        , m_connectionDisposition(ConnectionDisposition::Tally)
+        , m_schemaValidation(false)
+    {}
+
+    LIBEMBER_INLINE
+    GlowReader::~GlowReader()
+    {}
+
+    LIBEMBER_INLINE
+    void GlowReader::setSchemaValidation(bool enabled)
+    {
+        m_schemaValidation = enabled;
+    }
+
+    LIBEMBER_INLINE
+    bool GlowReader::schemaValidation() const
+    {
+        return m_schemaValidation;
+    }
+
+    LIBEMBER_INLINE
+    char const* GlowReader::describe(ValidationError::_Domain error)
+    {
+        switch(error)
+        {
+            case ValidationError::MissingNumber:
+                return "An element does not contain a number";
+            case ValidationError::MissingPath:
+                return "A qualified element does not contain a path";
+            case ValidationError::EmptyPath:
+                return "The path of a qualified element is empty";
+            case ValidationError::NestedQualifiedElement:
+                return "A qualified element is nested within another element";
+            case ValidationError::MissingCommandNumber:
+                return "A command does not contain a command number";
+            case ValidationError::MissingTarget:
+                return "A connection does not contain a target";
+            case ValidationError::MissingProperty:
+                return "A matrix lacks its identifier, target count or source count";
+            case ValidationError::TypeMismatch:
+                return "A number, path or property is encoded with an invalid type";
+        }
+        return "Unknown validation error";
+    }
+
+    LIBEMBER_INLINE
+    void GlowReader::elementReady(GlowType const&, ber::ObjectIdentifier const&)
+    {
+    }
+
+    LIBEMBER_INLINE
+    void GlowReader::propertyReady(GlowType const&, ber::ObjectIdentifier const&, ber::Tag const&, ber::Value const&)
+    {
+    }
+
+    LIBEMBER_INLINE
+    void GlowReader::elementDone(GlowType const&, ber::ObjectIdentifier const&)
+    {
+    }
+
+    LIBEMBER_INLINE
+    void GlowReader::commandReady(ber::ObjectIdentifier const&, int)
+    {
+    }
+
+    LIBEMBER_INLINE
+    void GlowReader::connectionReady(ber::ObjectIdentifier const&, int, ber::ObjectIdentifier const&, ConnectionOperation const&, ConnectionDisposition const&)
+    {
+    }
+
+    LIBEMBER_INLINE
+    void GlowReader::rootReady()
+    {
+    }
+
+    LIBEMBER_INLINE
+    void GlowReader::validationFailed(ValidationError::_Domain error, GlowType const&, ber::ObjectIdentifier const&)
+    {
+        throw std::runtime_error(describe(error));
+    }
+
+    LIBEMBER_INLINE
+    void GlowReader::resetImpl()
+    {
+        m_frames.clear();
+        m_path = ber::ObjectIdentifier();
+    }
+
+    LIBEMBER_INLINE
+    void GlowReader::containerReady()
+    {
+        ber::Type const type = ber::Type::fromTag(typeTag());
+        if (m_schemaValidation && m_frames.empty() == false && m_frames.back().kind == Frame::Contents)
+        {
+            // Properties such as the enumeration map or the labels are encoded as containers
+            Frame& element = m_frames[m_frames.size() - 2];
+            if (isPropertyTypeValid(element.type, applicationTag()) == false)
+                validationFailed(ValidationError::TypeMismatch, GlowType(element.type), m_path);
+        }
+
+        if (type.isApplicationDefined())
+        {
+            switch(type.value())
+            {
+                case GlowType::Node:
+                case GlowType::Parameter:
+                case GlowType::Matrix:
+                case GlowType::Function:
+                    m_frames.push_back(Frame(Frame::Element, type.value()));
+                    m_frames.back().outerPath = m_path;
+                    break;
+
+                case GlowType::QualifiedNode:
+                case GlowType::QualifiedParameter:
+                case GlowType::QualifiedMatrix:
+                case GlowType::QualifiedFunction:
+                    // Qualified elements may only appear in the root collection
+                    if (m_schemaValidation && m_path.empty() == false)
+                        validationFailed(ValidationError::NestedQualifiedElement, GlowType(type.value()), m_path);
+
+                    m_frames.push_back(Frame(Frame::QualifiedElement, type.value()));
+                    m_frames.back().outerPath = m_path;
+                    break;
+
+                case GlowType::Command:
+                    m_frames.push_back(Frame(Frame::Command, type.value()));
+                    break;
+
+                case GlowType::Connection:
+                    m_frames.push_back(Frame(Frame::Connection, type.value()));
+                    m_connectionSources = ber::ObjectIdentifier();
+                    m_connectionTarget = 0;
+                    m_connectionOperation = ConnectionOperation::Absolute;
+                    m_connectionDisposition = ConnectionDisposition::Tally;
+                    break;
+
+                default:
+                    m_frames.push_back(Frame(Frame::Other, type.value()));
+                    break;
+            }
+        }
+        else
+        {
+            Frame::Kind kind = Frame::Other;
+            if (m_frames.empty() == false)
+            {
+                Frame const& parent = m_frames.back();
+                bool const isElement = parent.kind == Frame::Element || parent.kind == Frame::QualifiedElement;
+
+                // All elements store their contents set with the same tag.
+                if (isElement && applicationTag() == GlowTags::Node::Contents() && type.value() == ber::Type::Set)
+                    kind = Frame::Contents;
+            }
+
+            m_frames.push_back(Frame(kind, 0));
+        }
+    }
+
+    LIBEMBER_INLINE
+    void GlowReader::itemReady()
+    {
+        if (m_frames.empty())
+            return;
+
+        if (isContainer())
+        {
+            Frame& frame = m_frames.back();
+            switch(frame.kind)
+            {
+                case Frame::Element:
+                case Frame::QualifiedElement:
+                    if (m_schemaValidation && frame.hasNumber == false)
+                    {
+                        ValidationError::_Domain const error = frame.kind == Frame::Element
+                            ? ValidationError::MissingNumber
+                            : ValidationError::MissingPath;
+                        validationFailed(error, GlowType(frame.type), m_path);
+                    }
+
+                    announce(frame);
+                    elementDone(GlowType(frame.type), m_path);
+                    m_path.swap(frame.outerPath);
+                    break;
+
+                case Frame::Command:
+                    if (m_schemaValidation && frame.hasNumber == false)
+                        validationFailed(ValidationError::MissingCommandNumber, GlowType(frame.type), m_path);
+                    else
+                        commandReady(m_path, frame.number);
+                    break;
+
+                case Frame::Connection:
+                    if (m_schemaValidation && frame.hasNumber == false)
+                        validationFailed(ValidationError::MissingTarget, GlowType(frame.type), m_path);
+                    else
+                        connectionReady(m_path, m_connectionTarget, m_connectionSources,
+                            ConnectionOperation(m_connectionOperation), ConnectionDisposition(m_connectionDisposition));
+                    break;
+
+                case Frame::Contents:
+                    if (m_schemaValidation)
+                    {
+                        Frame const& element = m_frames[m_frames.size() - 2];
+                        unsigned long const required = (1UL << MatrixProperty::Identifier)
+                                                     | (1UL << MatrixProperty::TargetCount)
+                                                     | (1UL << MatrixProperty::SourceCount);
+
+                        bool const isMatrix = element.type == GlowType::Matrix || element.type == GlowType::QualifiedMatrix;
+                        if (isMatrix && (element.properties & required) != required)
+                            validationFailed(ValidationError::MissingProperty, GlowType(element.type), m_path);
+                    }
+                    break;
+
+                default:
+                    break;
+            }
+
+            m_frames.pop_back();
+            if (m_frames.empty())
+                rootReady();
+        }
+        else
+        {
+            Frame& frame = m_frames.back();
+            ber::Tag const& tag = applicationTag();
+
+            // Number, Path and the command number all use the first context-specific tag.
+            bool const isNumber = tag == GlowTags::Node::Number();
+            switch(frame.kind)
+            {
+                case Frame::Element:
+                    if (isNumber && frame.isAnnounced == false && expectLeaf(ber::Type::Integer, frame.type))
+                    {
+                        m_path.push_back(decode<int>());
+                        frame.hasNumber = true;
+                        announce(frame);
+                    }
+                    break;
+
+                case Frame::QualifiedElement:
+                    if (isNumber && frame.isAnnounced == false && expectLeaf(ber::Type::RelativeObject, frame.type))
+                    {
+                        m_path = decode<ber::ObjectIdentifier>();
+                        frame.hasNumber = true;
+                        if (m_schemaValidation && m_path.empty())
+                            validationFailed(ValidationError::EmptyPath, GlowType(frame.type), m_path);
+
+                        announce(frame);
+                    }
+                    break;
+
+                case Frame::Command:
+                    if (isNumber && expectLeaf(ber::Type::Integer, frame.type))
+                    {
+                        frame.number = decode<int>();
+                        frame.hasNumber = true;
+                    }
+                    break;
+
+                case Frame::Connection:
+                    if (tag == GlowTags::Connection::Target())
+                    {
+                        if (expectLeaf(ber::Type::Integer, frame.type))
+                        {
+                            m_connectionTarget = decode<int>();
+                            frame.hasNumber = true;
+                        }
+                    }
+                    else if (tag == GlowTags::Connection::Sources())
+                    {
+                        if (expectLeaf(ber::Type::RelativeObject, frame.type))
+                            m_connectionSources = decode<ber::ObjectIdentifier>();
+                    }
+                    else if (tag == GlowTags::Connection::Operation())
+                    {
+                        if (expectLeaf(ber::Type::Integer, frame.type))
+                            m_connectionOperation = decode<int>();
+                    }
+                    else if (tag == GlowTags::Connection::Disposition())
+                    {
+                        if (expectLeaf(ber::Type::Integer, frame.type))
+                            m_connectionDisposition = decode<int>();
+                    }
+                    break;
+
+                case Frame::Contents:
+                    {
+                        Frame& element = m_frames[m_frames.size() - 2];
+                        if (m_schemaValidation)
+                        {
+                            if (isPropertyTypeValid(element.type, tag) == false)
+                            {
+                                validationFailed(ValidationError::TypeMismatch, GlowType(element.type), m_path);
+                                break;
+                            }
+
+                            if (tag.number() < 32)
+                                element.properties |= 1UL << tag.number();
+                        }
+
+                        ber::Value const value = decodeValue();
+
+                        announce(element);
+                        if (value)
+                            propertyReady(GlowType(element.type), m_path, tag, value);
+                    }
+                    break;
+
+                default:
+                    break;
+            }
+        }
+    }
+
+    LIBEMBER_INLINE
+    void GlowReader::announce(Frame& frame)
+    {
+        if (frame.isAnnounced == false)
+        {
+            frame.isAnnounced = true;
+            elementReady(GlowType(frame.type), m_path);
+        }
+    }
+
+    LIBEMBER_INLINE
+    ber::Value GlowReader::decodeValue()
+    {
+        ber::Type const type = ber::Type::fromTag(typeTag());
+        if (type.isApplicationDefined() == false)
+        {
+            switch(type.value())
+            {
+                case ber::Type::Boolean:
+                    return ber::Value(decode<bool>());
+
+                case ber::Type::Integer:
+                    if (length() > 4)
+                        return ber::Value(decode<long>());
+                    else
+                        return ber::Value(decode<int>());
+
+                case ber::Type::Real:
+                    return ber::Value(decode<double>());
+
+                case ber::Type::UTF8String:
+                    return ber::Value(decode<std::string>());
+
+                case ber::Type::RelativeObject:
+                    return ber::Value(decode<ber::ObjectIdentifier>());
+
+                case ber::Type::OctetString:
+                    return ber::Value(decode<ber::Octets>());
+
+                default:
+                    break;
+            }
+        }
+
+        return ber::Value();
+    }
+
+    LIBEMBER_INLINE
+    bool GlowReader::isPropertyTypeValid(GlowType::value_type type, ber::Tag const& tag) const
+    {
+        // The universal types a property may be encoded with, one bit per type.
+        // Properties encoded as containers are marked with the bit of the sequence type.
+        unsigned long const Boolean = 1UL << ber::Type::Boolean;
+        unsigned long const Integer = 1UL << ber::Type::Integer;
+        unsigned long const Real = 1UL << ber::Type::Real;
+        unsigned long const String = 1UL << ber::Type::UTF8String;
+        unsigned long const Octets = 1UL << ber::Type::OctetString;
+        unsigned long const Null = 1UL << ber::Type::Null;
+        unsigned long const RelativeObject = 1UL << ber::Type::RelativeObject;
+        unsigned long const Container = 1UL << ber::Type::Sequence;
+        unsigned long const Value = Boolean | Integer | Real | String | Octets | Null;
+        unsigned long const MinMax = Integer | Real | Null;
+
+        static unsigned long const NodeProperties[] =
+        {
+            String, String, Boolean, Boolean, String
+        };
+
+        static unsigned long const ParameterProperties[] =
+        {
+            String, String, Value, MinMax, MinMax, Integer, String, String, Integer,
+            Boolean, String, Integer, Value, Integer, Integer, Container, Container, String
+        };
+
+        static unsigned long const MatrixProperties[] =
+        {
+            String, String, Integer, Integer, Integer, Integer, Integer, Integer,
+            RelativeObject | Integer, Integer, Container, String
+        };
+
+        static unsigned long const FunctionProperties[] =
+        {
+            String, String, Container, Container
+        };
+
+        unsigned long const* properties = 0;
+        std::size_t count = 0;
+        switch(type)
+        {
+            case GlowType::Node:
+            case GlowType::QualifiedNode:
+                properties = NodeProperties;
+                count = sizeof(NodeProperties) / sizeof(NodeProperties[0]);
+                break;
+
+            case GlowType::Parameter:
+            case GlowType::QualifiedParameter:
+                properties = ParameterProperties;
+                count = sizeof(ParameterProperties) / sizeof(ParameterProperties[0]);
+                break;
+
+            case GlowType::Matrix:
+            case GlowType::QualifiedMatrix:
+                properties = MatrixProperties;
+                count = sizeof(MatrixProperties) / sizeof(MatrixProperties[0]);
+                break;
+
+            case GlowType::Function:
+            case GlowType::QualifiedFunction:
+                properties = FunctionProperties;
+                count = sizeof(FunctionProperties) / sizeof(FunctionProperties[0]);
+                break;
+
+            default:
+                return true;
+        }
+
+        if (tag != ber::make_tag(ber::Class::ContextSpecific, tag.number()) || tag.number() >= count)
+            return true;
+
+        ber::Type const encoded = ber::Type::fromTag(typeTag());
+        unsigned long const actual = isContainer()
+            ? Container
+            : (encoded.isApplicationDefined() || encoded.value() > ber::Type::LastUniversal ? 0UL : 1UL << encoded.value());
+
+        return (properties[tag.number()] & actual) != 0;
+    }
+
+    LIBEMBER_INLINE
+    bool GlowReader::expectLeaf(ber::Type::value_type type, GlowType::value_type owner)
+    {
+        if (m_schemaValidation == false)
+            return true;
+
+        ber::Type const encoded = ber::Type::fromTag(typeTag());
+        if (encoded.isApplicationDefined() == false && encoded.value() == type)
+            return true;
+
+        validationFailed(ValidationError::TypeMismatch, GlowType(owner), m_path);
+        return false;
+    }
+}
+}
+
+#endif  // __LIBEMBER_GLOW_IMPL_GLOWREADER_IPP
+
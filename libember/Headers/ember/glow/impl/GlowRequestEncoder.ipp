@@ -0,0 +1,237 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+#ifndef __LIBEMBER_GLOW_IMPL_GLOWREQUESTENCODER_IPP
+#define __LIBEMBER_GLOW_IMPL_GLOWREQUESTENCODER_IPP
+
+#include "../../util/Inline.hpp"
+#include "../GlowType.hpp"
+
+namespace libember { namespace glow
+{
+    namespace detail
+    {
+        /** The leading bits of an application tag and of a context tag of a constructed frame. */
+        enum
+        {
+            ApplicationTag = 0x60,
+            ContextTag = 0xA0,
+        };
+
+        /**
+         * The children of a qualified element, which consist of a single command.
+         * The last byte is replaced by the number of the command.
+         */
+        static unsigned char const QualifiedCommand[] =
+        {
+            0xA2, 0x0B,                 // [2] children
+            0x64, 0x09,                 // ElementCollection
+            0xA0, 0x07,                 // [0]
+            0x62, 0x05,                 // Command
+            0xA0, 0x03,                 // [0] number
+            0x02, 0x01, 0x00,           // INTEGER
+        };
+
+        /**
+         * A root command. The last byte is replaced by the number of the command.
+         */
+        static unsigned char const RootCommand[] =
+        {
+            0x60, 0x0B,                 // Root
+            0x6B, 0x09,                 // RootElementCollection
+            0xA0, 0x07,                 // [0]
+            0x62, 0x05,                 // Command
+            0xA0, 0x03,                 // [0] number
+            0x02, 0x01, 0x00,           // INTEGER
+        };
+
+        /**
+         * The number of bytes a message may occupy in addition to its path. A message
+         * consists of at most ten frames with a single byte tag and a length of up to
+         * 1 + sizeof(std::size_t) bytes, the constant command bytes or the integer value.
+         */
+        static std::size_t const RequestOverhead = 10 * (2 + sizeof(std::size_t)) + sizeof(QualifiedCommand) + sizeof(long);
+    }
+
+    LIBEMBER_INLINE
+    GlowRequestEncoder::GlowRequestEncoder()
+        : m_first(0)
+    {}
+
+    LIBEMBER_INLINE
+    void GlowRequestEncoder::encodeCommand(ber::ObjectIdentifier const& path, GlowTreeMirror::ElementType type, CommandType const& command)
+    {
+        reset(path);
+
+        if (path.empty())
+        {
+            prepend(detail::RootCommand, detail::RootCommand + sizeof(detail::RootCommand));
+            m_buffer.back() = static_cast<value_type>(command.value());
+            return;
+        }
+
+        prepend(detail::QualifiedCommand, detail::QualifiedCommand + sizeof(detail::QualifiedCommand));
+        m_buffer.back() = static_cast<value_type>(command.value());
+        prependPath(path);
+
+        switch(type)
+        {
+            case GlowTreeMirror::Parameter:
+                wrap(detail::ApplicationTag | GlowType::QualifiedParameter);
+                break;
+
+            case GlowTreeMirror::Matrix:
+                wrap(detail::ApplicationTag | GlowType::QualifiedMatrix);
+                break;
+
+            case GlowTreeMirror::Function:
+                wrap(detail::ApplicationTag | GlowType::QualifiedFunction);
+                break;
+
+            default:
+                wrap(detail::ApplicationTag | GlowType::QualifiedNode);
+                break;
+        }
+
+        wrap(detail::ContextTag | 0);
+        wrap(detail::ApplicationTag | GlowType::RootElementCollection);
+        wrap(detail::ApplicationTag | 0);
+    }
+
+    LIBEMBER_INLINE
+    void GlowRequestEncoder::encodeValue(ber::ObjectIdentifier const& path, long value)
+    {
+        reset(path);
+
+        // minimal two's complement, the sign of the first byte has to match the sign of the value
+        value_type byte;
+        do
+        {
+            byte = static_cast<value_type>(value & 0xFF);
+            m_buffer[--m_first] = byte;
+            value >>= 8;
+        }
+        while ((value != 0 || (byte & 0x80) != 0) && (value != -1 || (byte & 0x80) == 0));
+
+        prependLength(m_buffer.size() - m_first);
+        m_buffer[--m_first] = 0x02;         // INTEGER
+        wrap(detail::ContextTag | 2);       // [2] value
+        wrap(0x31);                         // SET
+        wrap(detail::ContextTag | 1);       // [1] contents
+        prependPath(path);
+        wrap(detail::ApplicationTag | GlowType::QualifiedParameter);
+        wrap(detail::ContextTag | 0);
+        wrap(detail::ApplicationTag | GlowType::RootElementCollection);
+        wrap(detail::ApplicationTag | 0);
+    }
+
+    LIBEMBER_INLINE
+    GlowRequestEncoder::const_iterator GlowRequestEncoder::begin() const
+    {
+        return m_buffer.empty() ? 0 : &m_buffer[0] + m_first;
+    }
+
+    LIBEMBER_INLINE
+    GlowRequestEncoder::const_iterator GlowRequestEncoder::end() const
+    {
+        return m_buffer.empty() ? 0 : &m_buffer[0] + m_buffer.size();
+    }
+
+    LIBEMBER_INLINE
+    GlowRequestEncoder::size_type GlowRequestEncoder::size() const
+    {
+        return m_buffer.size() - m_first;
+    }
+
+    LIBEMBER_INLINE
+    void GlowRequestEncoder::reset(ber::ObjectIdentifier const& path)
+    {
+        // each subidentifier occupies at most one byte per seven bits
+        size_type const subidentifierLength = (sizeof(ber::ObjectIdentifier::value_type) * 8 + 6) / 7;
+        size_type const capacity = path.size() * subidentifierLength + detail::RequestOverhead;
+
+        if (m_buffer.size() < capacity)
+        {
+            m_buffer.resize(capacity);
+        }
+
+        m_first = m_buffer.size();
+    }
+
+    LIBEMBER_INLINE
+    void GlowRequestEncoder::prepend(value_type const* first, value_type const* last)
+    {
+        while (last != first)
+        {
+            m_buffer[--m_first] = *--last;
+        }
+    }
+
+    LIBEMBER_INLINE
+    void GlowRequestEncoder::prependPath(ber::ObjectIdentifier const& path)
+    {
+        size_type const last = m_first;
+
+        ber::ObjectIdentifier::const_iterator it = path.end();
+        while (it != path.begin())
+        {
+            ber::ObjectIdentifier::value_type subidentifier = *--it;
+
+            m_buffer[--m_first] = static_cast<value_type>(subidentifier & 0x7F);
+            for (subidentifier >>= 7; subidentifier != 0; subidentifier >>= 7)
+            {
+                m_buffer[--m_first] = static_cast<value_type>(0x80 | (subidentifier & 0x7F));
+            }
+        }
+
+        prependLength(last - m_first);
+        m_buffer[--m_first] = 0x0D;         // RELATIVE-OID
+        prependLength(last - m_first);
+        m_buffer[--m_first] = detail::ContextTag | 0;
+    }
+
+    LIBEMBER_INLINE
+    void GlowRequestEncoder::wrap(value_type tag)
+    {
+        prependLength(m_buffer.size() - m_first);
+        m_buffer[--m_first] = tag;
+    }
+
+    LIBEMBER_INLINE
+    void GlowRequestEncoder::prependLength(size_type length)
+    {
+        if (length < 0x80)
+        {
+            m_buffer[--m_first] = static_cast<value_type>(length);
+        }
+        else
+        {
+            size_type count = 0;
+            for (size_type rest = length; rest != 0; rest >>= 8, ++count)
+            {
+                m_buffer[--m_first] = static_cast<value_type>(rest & 0xFF);
+            }
+            m_buffer[--m_first] = static_cast<value_type>(0x80 | count);
+        }
+    }
+}
+}
+
+#endif  // __LIBEMBER_GLOW_IMPL_GLOWREQUESTENCODER_IPP
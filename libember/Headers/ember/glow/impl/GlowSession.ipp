@@ -0,0 +1,607 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+#ifndef __LIBEMBER_GLOW_IMPL_GLOWSESSION_IPP
+#define __LIBEMBER_GLOW_IMPL_GLOWSESSION_IPP
+
+#include <algorithm>
+#include "../../util/Inline.hpp"
+#include "../GlowCommand.hpp"
+#include "../GlowElementCollection.hpp"
+#include "../GlowFunction.hpp"
+#include "../GlowInvocationResult.hpp"
+#include "../GlowMatrix.hpp"
+#include "../GlowNode.hpp"
+#include "../GlowParameter.hpp"
+#include "../GlowQualifiedFunction.hpp"
+#include "../GlowQualifiedMatrix.hpp"
+#include "../GlowQualifiedNode.hpp"
+#include "../GlowQualifiedParameter.hpp"
+#include "../GlowRootElementCollection.hpp"
+
+namespace libember { namespace glow
+{
+    LIBEMBER_INLINE
+    GlowSession::Result::Result(Status::_Domain status)
+        : status(status)
+        , invocationResult(0)
+    {}
+
+    LIBEMBER_INLINE
+    GlowSession::Continuation::~Continuation()
+    {}
+
+    LIBEMBER_INLINE
+    GlowSession::Listener::~Listener()
+    {}
+
+    LIBEMBER_INLINE
+    GlowSession::Connection::~Connection()
+    {}
+
+    LIBEMBER_INLINE
+    bool GlowSession::PathLess::operator()(ber::ObjectIdentifier const& lhs, ber::ObjectIdentifier const& rhs) const
+    {
+        return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+
+    LIBEMBER_INLINE
+    GlowSession::Operation::Operation(OperationKind::_Domain kind, Continuation* continuation, tick_type deadline)
+        : kind(kind)
+        , continuation(continuation)
+        , deadline(deadline)
+    {}
+
+    LIBEMBER_INLINE
+    GlowSession::PendingInvocation::PendingInvocation(GlowSession& session, Continuation* continuation)
+        : session(session)
+        , continuation(continuation)
+        , invocationId(0)
+    {}
+
+    LIBEMBER_INLINE
+    void GlowSession::PendingInvocation::completed(int, GlowInvocationResult const& result)
+    {
+        // the table has already removed the invocation, so this callback is not referenced anymore
+        Continuation* const target = continuation;
+        session.m_pendingInvocations.erase(this);
+        delete this;
+
+        Result resumed(Status::Completed);
+        resumed.invocationResult = &result;
+        target->resume(resumed);
+    }
+
+    LIBEMBER_INLINE
+    void GlowSession::PendingInvocation::timedOut(int)
+    {
+        Continuation* const target = continuation;
+        session.m_pendingInvocations.erase(this);
+        delete this;
+
+        target->resume(Result(Status::TimedOut));
+    }
+
+    LIBEMBER_INLINE
+    GlowSession::GlowSession(Connection& provider, tick_type timeout)
+        : m_provider(provider)
+        , m_timeout(timeout)
+        , m_now(0)
+        , m_request(0)
+        , m_requestCount(0)
+        , m_requestStart(0)
+        , m_maxRequests(1)
+        , m_window(0)
+    {}
+
+    LIBEMBER_INLINE
+    GlowSession::~GlowSession()
+    {
+        delete m_request;
+        m_invocations.clear();
+
+        InvocationSet::iterator const last = m_pendingInvocations.end();
+        for (InvocationSet::iterator it = m_pendingInvocations.begin(); it != last; ++it)
+        {
+            delete *it;
+        }
+    }
+
+    LIBEMBER_INLINE
+    void GlowSession::getDirectory(ber::ObjectIdentifier const& path, Continuation* continuation, GlowTreeMirror::ElementType type)
+    {
+        add(path, OperationKind::Directory, continuation);
+        command(path, type, CommandType::GetDirectory);
+    }
+
+    LIBEMBER_INLINE
+    void GlowSession::setValue(ber::ObjectIdentifier const& path, Value const& value, Continuation* continuation)
+    {
+        GlowQualifiedParameter* const parameter = new GlowQualifiedParameter(&request(), path);
+
+        switch(value.type().value())
+        {
+            case ParameterType::Integer:
+                parameter->setValue(value.toInteger());
+                break;
+
+            case ParameterType::Real:
+                parameter->setValue(value.toReal());
+                break;
+
+            case ParameterType::String:
+                parameter->setValue(value.toString());
+                break;
+
+            case ParameterType::Boolean:
+                parameter->setValue(value.toBoolean());
+                break;
+
+            case ParameterType::Octets:
+                parameter->setValue(value.toOctets());
+                break;
+
+            default:
+                break;
+        }
+
+        add(path, OperationKind::Value, continuation);
+        requestAdded();
+    }
+
+    LIBEMBER_INLINE
+    void GlowSession::subscribe(ber::ObjectIdentifier const& path, Listener* listener, GlowTreeMirror::ElementType type)
+    {
+        if (m_listeners.count(path) == 0 && path.empty() == false)
+        {
+            command(path, type, CommandType::Subscribe);
+        }
+
+        m_listeners.insert(std::make_pair(path, listener));
+    }
+
+    LIBEMBER_INLINE
+    void GlowSession::unsubscribe(ber::ObjectIdentifier const& path, Listener* listener)
+    {
+        std::pair<ListenerMap::iterator, ListenerMap::iterator> const range = m_listeners.equal_range(path);
+        for (ListenerMap::iterator it = range.first; it != range.second; ++it)
+        {
+            if (it->second == listener)
+            {
+                m_listeners.erase(it);
+
+                if (m_listeners.count(path) == 0 && path.empty() == false)
+                {
+                    command(path, GlowTreeMirror::Node, CommandType::Unsubscribe);
+                }
+                return;
+            }
+        }
+    }
+
+    LIBEMBER_INLINE
+    GlowSession::size_type GlowSession::cancel(Continuation* continuation)
+    {
+        size_type count = 0;
+
+        for (OperationMap::iterator it = m_operations.begin(); it != m_operations.end(); )
+        {
+            if (it->second.continuation == continuation)
+            {
+                m_operations.erase(it++);
+                ++count;
+            }
+            else
+            {
+                ++it;
+            }
+        }
+
+        for (InvocationSet::iterator it = m_pendingInvocations.begin(); it != m_pendingInvocations.end(); )
+        {
+            PendingInvocation* const invocation = *it;
+            if (invocation->continuation == continuation)
+            {
+                m_invocations.cancel(invocation->invocationId);
+                m_pendingInvocations.erase(it++);
+                delete invocation;
+                ++count;
+            }
+            else
+            {
+                ++it;
+            }
+        }
+
+        return count;
+    }
+
+    LIBEMBER_INLINE
+    GlowSession::size_type GlowSession::pendingCount() const
+    {
+        return m_operations.size() + m_pendingInvocations.size();
+    }
+
+    LIBEMBER_INLINE
+    void GlowSession::setBatching(size_type maxRequests, tick_type window)
+    {
+        m_maxRequests = maxRequests > 0 ? maxRequests : 1;
+        m_window = window;
+
+        if (m_requestCount >= m_maxRequests)
+        {
+            flush();
+        }
+    }
+
+    LIBEMBER_INLINE
+    void GlowSession::flush()
+    {
+        if (m_request != 0)
+        {
+            // the connection may cause new requests, which start a new message
+            GlowRootElementCollection* const message = m_request;
+            m_request = 0;
+            m_requestCount = 0;
+
+            m_provider.write(*message);
+            delete message;
+        }
+    }
+
+    LIBEMBER_INLINE
+    GlowSession::size_type GlowSession::batchedCount() const
+    {
+        return m_requestCount;
+    }
+
+    LIBEMBER_INLINE
+    void GlowSession::providerMessage(dom::Node const& message)
+    {
+        m_path = ber::ObjectIdentifier();
+        accept(message);
+
+        // the answered operations are removed before any continuation runs, so the
+        // continuations may start or cancel operations
+        std::vector<std::pair<Continuation*, Result> > resumed;
+        resumed.reserve(m_answered.size());
+
+        std::vector<OperationMap::iterator>::const_iterator const last = m_answered.end();
+        for (std::vector<OperationMap::iterator>::const_iterator it = m_answered.begin(); it != last; ++it)
+        {
+            ResultMap::iterator const result = m_results.find(&(*it)->second);
+            resumed.push_back(std::make_pair((*it)->second.continuation, result->second));
+            m_operations.erase(*it);
+        }
+
+        m_answered.clear();
+        m_results.clear();
+
+        for (std::vector<std::pair<Continuation*, Result> >::const_iterator it = resumed.begin(); it != resumed.end(); ++it)
+        {
+            it->first->resume(it->second);
+        }
+    }
+
+    LIBEMBER_INLINE
+    GlowSession::size_type GlowSession::expire(tick_type now)
+    {
+        m_now = now;
+
+        if (m_request != 0 && isDue(m_requestStart + m_window, now))
+        {
+            flush();
+        }
+
+        std::vector<Continuation*> expired;
+        for (OperationMap::iterator it = m_operations.begin(); it != m_operations.end(); )
+        {
+            if (isDue(it->second.deadline, now))
+            {
+                expired.push_back(it->second.continuation);
+                m_operations.erase(it++);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+
+        Result const result(Status::TimedOut);
+        std::vector<Continuation*>::const_iterator const last = expired.end();
+        for (std::vector<Continuation*>::const_iterator it = expired.begin(); it != last; ++it)
+        {
+            (*it)->resume(result);
+        }
+
+        return expired.size() + m_invocations.expire(now);
+    }
+
+    LIBEMBER_INLINE
+    void GlowSession::add(ber::ObjectIdentifier const& path, OperationKind::_Domain kind, Continuation* continuation)
+    {
+        m_operations.insert(std::make_pair(path, Operation(kind, continuation, m_now + m_timeout)));
+    }
+
+    LIBEMBER_INLINE
+    GlowInvocation* GlowSession::createInvocation(Continuation* continuation)
+    {
+        PendingInvocation* const pending = new PendingInvocation(*this, continuation);
+        m_pendingInvocations.insert(pending);
+
+        GlowInvocation* const invocation = m_invocations.createInvocation(pending, m_now + m_timeout);
+        pending->invocationId = invocation->invocationId();
+        return invocation;
+    }
+
+    LIBEMBER_INLINE
+    void GlowSession::sendInvocation(ber::ObjectIdentifier const& path, GlowInvocation* invocation)
+    {
+        GlowCommand* const command = new GlowCommand(CommandType::Invoke);
+        command->setInvocation(invocation);
+
+        GlowElementCollection* const children = childrenOf(*createElement(request(), GlowTreeMirror::Function, path), GlowTreeMirror::Function);
+        children->insert(children->end(), command);
+        requestAdded();
+    }
+
+    LIBEMBER_INLINE
+    GlowRootElementCollection& GlowSession::request()
+    {
+        if (m_request == 0)
+        {
+            m_request = GlowRootElementCollection::create();
+            m_requestStart = m_now;
+        }
+
+        return *m_request;
+    }
+
+    LIBEMBER_INLINE
+    void GlowSession::requestAdded()
+    {
+        if (++m_requestCount >= m_maxRequests)
+        {
+            flush();
+        }
+    }
+
+    LIBEMBER_INLINE
+    void GlowSession::command(ber::ObjectIdentifier const& path, GlowTreeMirror::ElementType type, CommandType const& command)
+    {
+        if (path.empty())
+        {
+            new GlowCommand(&request(), command);
+        }
+        else
+        {
+            GlowElementCollection* const children = childrenOf(*createElement(request(), type, path), type);
+            children->insert(children->end(), new GlowCommand(command));
+        }
+
+        requestAdded();
+    }
+
+    LIBEMBER_INLINE
+    void GlowSession::element(GlowContentElement const& glow, GlowTreeMirror::ElementType type, GlowElementCollection const* children)
+    {
+        if (m_path.empty() == false)
+        {
+            ber::ObjectIdentifier const parent = parentOf(m_path);
+            collect(parent, OperationKind::Directory, glow);
+            collect(m_path, OperationKind::Value, glow);
+            notify(parent, glow);
+            notify(m_path, glow);
+        }
+
+        if (children != 0 && children->empty() == false)
+        {
+            acceptChildren(*children);
+        }
+        else if (type != GlowTreeMirror::Node || static_cast<GlowNodeBase const&>(glow).contains(NodeProperty::Identifier) == false)
+        {
+            // the directory of an element without children is the element itself, an
+            // empty node is reported without properties, unlike a node listed by its parent
+            collect(m_path, OperationKind::Directory, glow);
+        }
+    }
+
+    LIBEMBER_INLINE
+    void GlowSession::collect(ber::ObjectIdentifier const& key, OperationKind::_Domain kind, GlowContentElement const& glow)
+    {
+        std::pair<OperationMap::iterator, OperationMap::iterator> const range = m_operations.equal_range(key);
+        for (OperationMap::iterator it = range.first; it != range.second; ++it)
+        {
+            if (it->second.kind == kind)
+            {
+                std::pair<ResultMap::iterator, bool> const result = m_results.insert(std::make_pair(&it->second, Result(Status::Completed)));
+                if (result.second)
+                {
+                    m_answered.push_back(it);
+                }
+
+                result.first->second.elements.push_back(&glow);
+                result.first->second.paths.push_back(m_path);
+            }
+        }
+    }
+
+    LIBEMBER_INLINE
+    void GlowSession::notify(ber::ObjectIdentifier const& key, GlowContentElement const& glow)
+    {
+        std::pair<ListenerMap::iterator, ListenerMap::iterator> const range = m_listeners.equal_range(key);
+        if (range.first == range.second)
+            return;
+
+        // a listener may unsubscribe while it is notified
+        std::vector<Listener*> listeners;
+        for (ListenerMap::iterator it = range.first; it != range.second; ++it)
+        {
+            listeners.push_back(it->second);
+        }
+
+        std::vector<Listener*>::const_iterator const last = listeners.end();
+        for (std::vector<Listener*>::const_iterator it = listeners.begin(); it != last; ++it)
+        {
+            (*it)->notify(m_path, glow);
+        }
+    }
+
+    LIBEMBER_INLINE
+    GlowContentElement* GlowSession::createElement(GlowRootElementCollection& message, GlowTreeMirror::ElementType type, ber::ObjectIdentifier const& path)
+    {
+        switch(type)
+        {
+            case GlowTreeMirror::Parameter:
+                return new GlowQualifiedParameter(&message, path);
+
+            case GlowTreeMirror::Matrix:
+                return new GlowQualifiedMatrix(&message, path);
+
+            case GlowTreeMirror::Function:
+                return new GlowQualifiedFunction(&message, path);
+
+            default:
+                return new GlowQualifiedNode(&message, path);
+        }
+    }
+
+    LIBEMBER_INLINE
+    GlowElementCollection* GlowSession::childrenOf(GlowContentElement& element, GlowTreeMirror::ElementType type)
+    {
+        switch(type)
+        {
+            case GlowTreeMirror::Parameter:
+                return static_cast<GlowParameterBase&>(element).children();
+
+            case GlowTreeMirror::Matrix:
+                return static_cast<GlowMatrixBase&>(element).children();
+
+            case GlowTreeMirror::Function:
+                return static_cast<GlowFunctionBase&>(element).children();
+
+            default:
+                return static_cast<GlowNodeBase&>(element).children();
+        }
+    }
+
+    LIBEMBER_INLINE
+    bool GlowSession::isDue(tick_type deadline, tick_type now)
+    {
+        return static_cast<tick_type>(now - deadline) <= (static_cast<tick_type>(-1) >> 1);
+    }
+
+    LIBEMBER_INLINE
+    ber::ObjectIdentifier GlowSession::parentOf(ber::ObjectIdentifier const& path)
+    {
+        return path.empty()
+            ? path
+            : ber::ObjectIdentifier(path.begin(), path.end() - 1);
+    }
+
+    LIBEMBER_INLINE
+    void GlowSession::visit(GlowRootElementCollection const& glow)
+    {
+        acceptChildren(glow);
+    }
+
+    LIBEMBER_INLINE
+    void GlowSession::visit(GlowElementCollection const& glow)
+    {
+        acceptChildren(glow);
+    }
+
+    LIBEMBER_INLINE
+    void GlowSession::visit(GlowNode const& glow)
+    {
+        m_path.push_back(glow.number());
+        element(glow, GlowTreeMirror::Node, glow.children());
+        m_path = parentOf(m_path);
+    }
+
+    LIBEMBER_INLINE
+    void GlowSession::visit(GlowQualifiedNode const& glow)
+    {
+        ber::ObjectIdentifier const previous = m_path;
+        m_path = glow.path();
+        element(glow, GlowTreeMirror::Node, glow.children());
+        m_path = previous;
+    }
+
+    LIBEMBER_INLINE
+    void GlowSession::visit(GlowParameter const& glow)
+    {
+        m_path.push_back(glow.number());
+        element(glow, GlowTreeMirror::Parameter, glow.children());
+        m_path = parentOf(m_path);
+    }
+
+    LIBEMBER_INLINE
+    void GlowSession::visit(GlowQualifiedParameter const& glow)
+    {
+        ber::ObjectIdentifier const previous = m_path;
+        m_path = glow.path();
+        element(glow, GlowTreeMirror::Parameter, glow.children());
+        m_path = previous;
+    }
+
+    LIBEMBER_INLINE
+    void GlowSession::visit(GlowMatrix const& glow)
+    {
+        m_path.push_back(glow.number());
+        element(glow, GlowTreeMirror::Matrix, glow.children());
+        m_path = parentOf(m_path);
+    }
+
+    LIBEMBER_INLINE
+    void GlowSession::visit(GlowQualifiedMatrix const& glow)
+    {
+        ber::ObjectIdentifier const previous = m_path;
+        m_path = glow.path();
+        element(glow, GlowTreeMirror::Matrix, glow.children());
+        m_path = previous;
+    }
+
+    LIBEMBER_INLINE
+    void GlowSession::visit(GlowFunction const& glow)
+    {
+        m_path.push_back(glow.number());
+        element(glow, GlowTreeMirror::Function, glow.children());
+        m_path = parentOf(m_path);
+    }
+
+    LIBEMBER_INLINE
+    void GlowSession::visit(GlowQualifiedFunction const& glow)
+    {
+        ber::ObjectIdentifier const previous = m_path;
+        m_path = glow.path();
+        element(glow, GlowTreeMirror::Function, glow.children());
+        m_path = previous;
+    }
+
+    LIBEMBER_INLINE
+    void GlowSession::visit(GlowInvocationResult const& glow)
+    {
+        m_invocations.complete(glow);
+    }
+}
+}
+
+#endif  // __LIBEMBER_GLOW_IMPL_GLOWSESSION_IPP
@@ -52,14 +52,14 @@ namespace libember { namespace glow
     GlowSignal::GlowSignal(GlowType const& type, int number)
         : GlowContainer(type)
     {
-        insert(end(), new dom::VariantLeaf(GlowTags::Signal::Number(), number));
+        insert(end(), new dom::StaticLeaf<int>(GlowTags::Signal::Number(), number));
     }
 
     LIBEMBER_INLINE
     GlowSignal::GlowSignal(GlowType const& type, ber::Tag const& tag, int number)
         : GlowContainer(type, tag)
     {
-        insert(end(), new dom::VariantLeaf(GlowTags::Signal::Number(), number));
+        insert(end(), new dom::StaticLeaf<int>(GlowTags::Signal::Number(), number));
     }
 }
 }
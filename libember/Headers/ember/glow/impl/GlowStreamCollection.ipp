@@ -59,6 +59,12 @@ namespace libember { namespace glow
         GlowElement::insert(end(), new GlowStreamEntry(streamIdentifier, value));
     }
 
+    LIBEMBER_INLINE
+    void GlowStreamCollection::insert(int streamIdentifier, ber::OctetsView const& value)
+    {
+        GlowElement::insert(end(), new GlowStreamEntry(streamIdentifier, value));
+    }
+
     LIBEMBER_INLINE
     void GlowStreamCollection::insert(GlowStreamEntry* entry)
     {
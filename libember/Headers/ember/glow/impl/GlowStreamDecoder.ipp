@@ -0,0 +1,233 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef __LIBEMBER_GLOW_IMPL_GLOWSTREAMDECODER_IPP
+#define __LIBEMBER_GLOW_IMPL_GLOWSTREAMDECODER_IPP
+
+#include <algorithm>
+#include <cstring>
+#include "../../util/Inline.hpp"
+#include "../GlowStreamCollection.hpp"
+#include "../GlowStreamEntry.hpp"
+#include "../GlowType.hpp"
+
+namespace libember { namespace glow
+{
+    LIBEMBER_INLINE
+    GlowStreamDecoder::Field::Field(StreamFormat::value_type format, size_type offset, int subscriber)
+        : format(format)
+        , offset(offset)
+        , subscriber(subscriber)
+    {}
+
+    LIBEMBER_INLINE
+    bool GlowStreamDecoder::Field::operator<(Field const& other) const
+    {
+        return format != other.format
+            ? format < other.format
+            : offset < other.offset;
+    }
+
+    LIBEMBER_INLINE
+    GlowStreamDecoder::GlowStreamDecoder()
+    {}
+
+    LIBEMBER_INLINE
+    GlowStreamDecoder::~GlowStreamDecoder()
+    {}
+
+    LIBEMBER_INLINE
+    void GlowStreamDecoder::subscribe(int streamIdentifier, StreamFormat const& format, int offset, int subscriber)
+    {
+        if (offset >= 0)
+        {
+            Field const field(format.value(), static_cast<size_type>(offset), subscriber);
+            FieldCollection& fields = m_streams[streamIdentifier];
+            fields.insert(std::upper_bound(fields.begin(), fields.end(), field), field);
+        }
+    }
+
+    LIBEMBER_INLINE
+    void GlowStreamDecoder::unsubscribe(int streamIdentifier, int subscriber)
+    {
+        StreamMap::iterator const stream = m_streams.find(streamIdentifier);
+        if (stream != m_streams.end())
+        {
+            FieldCollection& fields = stream->second;
+            FieldCollection::iterator where = fields.begin();
+            for (FieldCollection::const_iterator it = fields.begin(); it != fields.end(); ++it)
+            {
+                if (it->subscriber != subscriber)
+                {
+                    *where++ = *it;
+                }
+            }
+            fields.erase(where, fields.end());
+
+            if (fields.empty())
+            {
+                m_streams.erase(stream);
+            }
+        }
+    }
+
+    LIBEMBER_INLINE
+    void GlowStreamDecoder::clear()
+    {
+        m_streams.clear();
+    }
+
+    LIBEMBER_INLINE
+    GlowStreamDecoder::size_type GlowStreamDecoder::decode(GlowStreamCollection const& collection)
+    {
+        size_type count = 0;
+        GlowStreamCollection::const_iterator const last = collection.end();
+        for (GlowStreamCollection::const_iterator it = collection.begin(); it != last; ++it)
+        {
+            ber::Tag const tag = it->typeTag();
+            if (tag.getClass() == ber::Class::Application && tag.number() == GlowType::StreamEntry)
+            {
+                count += decode(static_cast<GlowStreamEntry const&>(*it));
+            }
+        }
+        return count;
+    }
+
+    LIBEMBER_INLINE
+    GlowStreamDecoder::size_type GlowStreamDecoder::decode(GlowStreamEntry const& entry)
+    {
+        return m_streams.empty() == false
+            ? decode(entry.streamIdentifier(), entry.octets())
+            : 0;
+    }
+
+    LIBEMBER_INLINE
+    GlowStreamDecoder::size_type GlowStreamDecoder::decode(int streamIdentifier, ber::OctetsView const& octets)
+    {
+        StreamMap::const_iterator const stream = m_streams.find(streamIdentifier);
+        if (stream == m_streams.end() || octets.empty())
+        {
+            return 0;
+        }
+
+        FieldCollection const& fields = stream->second;
+        const_iterator const end = fields.end();
+        size_type count = 0;
+        for (const_iterator first = fields.begin(), last = first; first != end; first = last)
+        {
+            while (last != end && last->format == first->format)
+            {
+                ++last;
+            }
+
+            switch (first->format)
+            {
+                case StreamFormat::UnsignedInt8:              count += decodeIntegers<1, true, false>(first, last, octets); break;
+                case StreamFormat::UnsignedInt16BigEndian:    count += decodeIntegers<2, true, false>(first, last, octets); break;
+                case StreamFormat::UnsignedInt16LittleEndian: count += decodeIntegers<2, false, false>(first, last, octets); break;
+                case StreamFormat::UnsignedInt32BigEndian:    count += decodeIntegers<4, true, false>(first, last, octets); break;
+                case StreamFormat::UnsignedInt32LittleEndian: count += decodeIntegers<4, false, false>(first, last, octets); break;
+                case StreamFormat::UnsignedInt64BigEndian:    count += decodeIntegers<8, true, false>(first, last, octets); break;
+                case StreamFormat::UnsignedInt64LittleEndian: count += decodeIntegers<8, false, false>(first, last, octets); break;
+                case StreamFormat::SignedInt8:                count += decodeIntegers<1, true, true>(first, last, octets); break;
+                case StreamFormat::SignedInt16BigEndian:      count += decodeIntegers<2, true, true>(first, last, octets); break;
+                case StreamFormat::SignedInt16LittleEndian:   count += decodeIntegers<2, false, true>(first, last, octets); break;
+                case StreamFormat::SignedInt32BigEndian:      count += decodeIntegers<4, true, true>(first, last, octets); break;
+                case StreamFormat::SignedInt32LittleEndian:   count += decodeIntegers<4, false, true>(first, last, octets); break;
+                case StreamFormat::SignedInt64BigEndian:      count += decodeIntegers<8, true, true>(first, last, octets); break;
+                case StreamFormat::SignedInt64LittleEndian:   count += decodeIntegers<8, false, true>(first, last, octets); break;
+                case StreamFormat::IeeeFloat32BigEndian:      count += decodeReals<4, true>(first, last, octets); break;
+                case StreamFormat::IeeeFloat32LittleEndian:   count += decodeReals<4, false>(first, last, octets); break;
+                case StreamFormat::IeeeFloat64BigEndian:      count += decodeReals<8, true>(first, last, octets); break;
+                case StreamFormat::IeeeFloat64LittleEndian:   count += decodeReals<8, false>(first, last, octets); break;
+                default:
+                    break;
+            }
+        }
+        return count;
+    }
+
+    LIBEMBER_INLINE
+    void GlowStreamDecoder::integerDecoded(int, long long)
+    {}
+
+    LIBEMBER_INLINE
+    void GlowStreamDecoder::realDecoded(int, double)
+    {}
+
+    template<GlowStreamDecoder::size_type Width, bool IsBigEndian, bool IsSigned>
+    inline GlowStreamDecoder::size_type GlowStreamDecoder::decodeIntegers(const_iterator first, const_iterator last, ber::OctetsView const& octets)
+    {
+        unsigned long long const sign = static_cast<unsigned long long>(1) << (Width * 8 - 1);
+        value_type const* const data = octets.begin();
+        size_type const size = octets.size();
+        size_type count = 0;
+
+        // the fields are sorted by offset, so all remaining values exceed the octets as well
+        for ( ; first != last && first->offset + Width <= size; ++first, ++count)
+        {
+            unsigned long long const value = read<Width, IsBigEndian>(data + first->offset);
+            integerDecoded(first->subscriber, IsSigned
+                ? static_cast<long long>((value ^ sign) - sign)
+                : static_cast<long long>(value));
+        }
+        return count;
+    }
+
+    template<GlowStreamDecoder::size_type Width, bool IsBigEndian>
+    inline GlowStreamDecoder::size_type GlowStreamDecoder::decodeReals(const_iterator first, const_iterator last, ber::OctetsView const& octets)
+    {
+        value_type const* const data = octets.begin();
+        size_type const size = octets.size();
+        size_type count = 0;
+
+        for ( ; first != last && first->offset + Width <= size; ++first, ++count)
+        {
+            unsigned long long const bits = read<Width, IsBigEndian>(data + first->offset);
+            if (Width == 4)
+            {
+                unsigned int const single = static_cast<unsigned int>(bits);
+                float value;
+                std::memcpy(&value, &single, sizeof(value));
+                realDecoded(first->subscriber, value);
+            }
+            else
+            {
+                double value;
+                std::memcpy(&value, &bits, sizeof(value));
+                realDecoded(first->subscriber, value);
+            }
+        }
+        return count;
+    }
+
+    template<GlowStreamDecoder::size_type Width, bool IsBigEndian>
+    inline unsigned long long GlowStreamDecoder::read(value_type const* data)
+    {
+        unsigned long long result = 0;
+        for (size_type i = 0; i < Width; ++i)
+        {
+            result = (result << 8) | data[IsBigEndian ? i : Width - 1 - i];
+        }
+        return result;
+    }
+}
+}
+
+#endif  // __LIBEMBER_GLOW_IMPL_GLOWSTREAMDECODER_IPP
@@ -56,6 +56,14 @@ namespace libember { namespace glow
         insert(end(), new dom::VariantLeaf(GlowTags::StreamEntry::StreamValue(), value));
     }
 
+    LIBEMBER_INLINE
+    GlowStreamEntry::GlowStreamEntry(int streamIdentifier, ber::OctetsView const& value)
+        : GlowContainer(GlowType::StreamEntry)
+    {
+        insert(end(), new dom::VariantLeaf(GlowTags::StreamEntry::StreamIdentifier(), streamIdentifier));
+        insert(end(), new dom::VariantLeaf(GlowTags::StreamEntry::StreamValue(), value));
+    }
+
     LIBEMBER_INLINE
     int GlowStreamEntry::streamIdentifier() const
     {
@@ -90,6 +98,20 @@ namespace libember { namespace glow
             return Value(-1L);
         }
     }
+
+    LIBEMBER_INLINE
+    ber::OctetsView GlowStreamEntry::octets() const
+    {
+        ber::Tag const tag = GlowTags::StreamEntry::StreamValue(); 
+        const_iterator const first = begin();
+        const_iterator const last = end();
+        const_iterator const result = util::find_tag(first, last, tag);
+        dom::VariantLeaf const* const leaf = (result != last)
+            ? dynamic_cast<dom::VariantLeaf const*>(&*result)
+            : 0;
+
+        return (leaf != 0) ? leaf->octets() : ber::OctetsView();
+    }
 }
 }
 
@@ -20,6 +20,7 @@
 #ifndef __LIBEMBER_GLOW_GLOWSTRINGINTEGERCOLLECTION_IPP
 #define __LIBEMBER_GLOW_GLOWSTRINGINTEGERCOLLECTION_IPP
 
+#include <list>
 #include "../../util/Inline.hpp"
 #include "../GlowStringIntegerPair.hpp"
 
@@ -28,6 +29,9 @@ namespace libember { namespace glow
     LIBEMBER_INLINE
     GlowStringIntegerCollection::GlowStringIntegerCollection(ber::Tag const& tag)
         : GlowElement(GlowType::StringIntegerCollection, tag)
+        , m_pool(0)
+        , m_generation(0)
+        , m_table(0)
     {}
 
     LIBEMBER_INLINE
@@ -35,6 +39,50 @@ namespace libember { namespace glow
     {
         GlowElement::insert(end(), new GlowStringIntegerPair(name, value));
     }
+
+    LIBEMBER_INLINE
+    Enumeration GlowStringIntegerCollection::enumeration() const
+    {
+        std::list<std::pair<std::string, int> > list;
+        const_iterator const last = end();
+        for (const_iterator it = begin(); it != last; ++it)
+        {
+            GlowStringIntegerPair const* entry = dynamic_cast<GlowStringIntegerPair const*>(&*it);
+            if (entry != 0)
+            {
+                list.push_back(std::make_pair(entry->name(), entry->value()));
+            }
+        }
+
+        return Enumeration(list.begin(), list.end());
+    }
+
+    LIBEMBER_INLINE
+    EnumerationPool::Table const* GlowStringIntegerCollection::table(EnumerationPool& pool) const
+    {
+        if (m_table == 0 || m_pool != &pool || m_generation != pool.generation())
+        {
+            m_table = pool.intern(enumeration());
+            m_pool = &pool;
+            m_generation = pool.generation();
+        }
+
+        return m_table;
+    }
+
+    LIBEMBER_INLINE
+    GlowStringIntegerCollection::iterator GlowStringIntegerCollection::insertImpl(iterator const& where, Node* child)
+    {
+        m_table = 0;
+        return GlowElement::insertImpl(where, child);
+    }
+
+    LIBEMBER_INLINE
+    void GlowStringIntegerCollection::eraseImpl(iterator const& first, iterator const& last)
+    {
+        m_table = 0;
+        GlowElement::eraseImpl(first, last);
+    }
 }
 }
 
@@ -62,6 +62,12 @@ namespace libember { namespace glow
         return ber::make_tag(ber::Class::ContextSpecific, 2);
     }
 
+    LIBEMBER_INLINE
+    ber::Tag GlowTags::Command::Sequence()
+    {
+        return ber::make_tag(ber::Class::ContextSpecific, 100);
+    }
+
     /**
      * QualifiedNode Tags
      */
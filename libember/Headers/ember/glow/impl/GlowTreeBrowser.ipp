@@ -0,0 +1,324 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+#ifndef __LIBEMBER_GLOW_IMPL_GLOWTREEBROWSER_IPP
+#define __LIBEMBER_GLOW_IMPL_GLOWTREEBROWSER_IPP
+
+#include <algorithm>
+#include "../../util/Inline.hpp"
+
+namespace libember { namespace glow
+{
+    LIBEMBER_INLINE
+    GlowTreeBrowser::Listener::~Listener()
+    {}
+
+    LIBEMBER_INLINE
+    bool GlowTreeBrowser::PathLess::operator()(ber::ObjectIdentifier const& lhs, ber::ObjectIdentifier const& rhs) const
+    {
+        return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+
+    LIBEMBER_INLINE
+    GlowTreeBrowser::Request::Request(GlowTreeBrowser& browser, ber::ObjectIdentifier const& path, bool isPrefetch)
+        : browser(browser)
+        , path(path)
+        , isPrefetch(isPrefetch)
+    {}
+
+    LIBEMBER_INLINE
+    void GlowTreeBrowser::Request::resume(GlowSession::Result const& result)
+    {
+        browser.completed(this, result);
+    }
+
+    LIBEMBER_INLINE
+    GlowTreeBrowser::Entry::Entry(DirectoryState::_Domain state)
+        : state(state)
+        , isExpanding(false)
+        , request(0)
+    {}
+
+    LIBEMBER_INLINE
+    GlowTreeBrowser::GlowTreeBrowser(GlowSession& session, GlowTreeMirror& mirror, Listener* listener)
+        : m_session(session)
+        , m_mirror(mirror)
+        , m_listener(listener)
+        , m_depth(16)
+        , m_batchSize(4)
+        , m_wideThreshold(64)
+        , m_prefetching(0)
+    {}
+
+    LIBEMBER_INLINE
+    GlowTreeBrowser::~GlowTreeBrowser()
+    {
+        EntryMap::const_iterator const last = m_entries.end();
+        for (EntryMap::const_iterator it = m_entries.begin(); it != last; ++it)
+        {
+            if (it->second.request != 0)
+            {
+                m_session.cancel(it->second.request);
+                delete it->second.request;
+            }
+        }
+    }
+
+    LIBEMBER_INLINE
+    void GlowTreeBrowser::setPrefetching(size_type depth, size_type batchSize, size_type wideThreshold)
+    {
+        m_depth = depth;
+        m_batchSize = std::max(batchSize, size_type(1));
+        m_wideThreshold = std::max(wideThreshold, size_type(1));
+        prefetch(false);
+    }
+
+    LIBEMBER_INLINE
+    bool GlowTreeBrowser::expand(ber::ObjectIdentifier const& path)
+    {
+        EntryMap::iterator it = m_entries.find(path);
+        if (it == m_entries.end())
+        {
+            it = m_entries.insert(std::make_pair(path, Entry(DirectoryState::Queued))).first;
+        }
+
+        Entry& entry = it->second;
+        switch(entry.state)
+        {
+            case DirectoryState::Known:
+                return true;
+
+            case DirectoryState::Queued:
+                dequeue(path);
+                request(path, entry, false);
+                break;
+
+            case DirectoryState::Pending:
+                break;
+        }
+
+        entry.isExpanding = true;
+        return false;
+    }
+
+    LIBEMBER_INLINE
+    void GlowTreeBrowser::setVisible(ber::ObjectIdentifier const& path, bool isVisible)
+    {
+        EntryMap::iterator const it = m_entries.find(path);
+        if (isVisible && it == m_entries.end())
+        {
+            if (m_depth == 0 || typeOf(path) != GlowTreeMirror::Node || m_wideParents.count(parentOf(path)) != 0)
+                return;
+
+            m_entries.insert(std::make_pair(path, Entry(DirectoryState::Queued)));
+            m_queue.push_back(path);
+            prefetch(false);
+        }
+        else if (isVisible == false && it != m_entries.end() && it->second.state == DirectoryState::Queued)
+        {
+            dequeue(path);
+            m_entries.erase(it);
+        }
+    }
+
+    LIBEMBER_INLINE
+    void GlowTreeBrowser::flush()
+    {
+        prefetch(true);
+    }
+
+    LIBEMBER_INLINE
+    bool GlowTreeBrowser::isExpanded(ber::ObjectIdentifier const& path) const
+    {
+        EntryMap::const_iterator const it = m_entries.find(path);
+        return it != m_entries.end() && it->second.state == DirectoryState::Known;
+    }
+
+    LIBEMBER_INLINE
+    void GlowTreeBrowser::invalidate(ber::ObjectIdentifier const& path)
+    {
+        EntryMap::iterator const it = m_entries.find(path);
+        if (it != m_entries.end() && it->second.state == DirectoryState::Known)
+        {
+            m_entries.erase(it);
+        }
+    }
+
+    LIBEMBER_INLINE
+    void GlowTreeBrowser::providerMessage(dom::Node const& message)
+    {
+        // the continuations read the children from the mirror, so it has to be updated first
+        m_mirror.merge(message);
+        m_session.providerMessage(message);
+    }
+
+    LIBEMBER_INLINE
+    GlowTreeBrowser::size_type GlowTreeBrowser::pendingCount() const
+    {
+        size_type count = 0;
+        EntryMap::const_iterator const last = m_entries.end();
+        for (EntryMap::const_iterator it = m_entries.begin(); it != last; ++it)
+        {
+            if (it->second.state == DirectoryState::Pending)
+                ++count;
+        }
+        return count;
+    }
+
+    LIBEMBER_INLINE
+    GlowTreeBrowser::size_type GlowTreeBrowser::queuedCount() const
+    {
+        return m_queue.size();
+    }
+
+    LIBEMBER_INLINE
+    void GlowTreeBrowser::request(ber::ObjectIdentifier const& path, Entry& entry, bool isPrefetch)
+    {
+        Request* const request = new Request(*this, path, isPrefetch);
+        entry.state = DirectoryState::Pending;
+        entry.request = request;
+
+        if (isPrefetch)
+            ++m_prefetching;
+
+        m_session.getDirectory(path, request, typeOf(path));
+    }
+
+    LIBEMBER_INLINE
+    void GlowTreeBrowser::completed(Request* request, GlowSession::Result const& result)
+    {
+        ber::ObjectIdentifier const path = request->path;
+        bool const isComplete = result.status == GlowSession::Status::Completed;
+
+        if (request->isPrefetch)
+            --m_prefetching;
+
+        delete request;
+
+        EntryMap::iterator const it = m_entries.find(path);
+        bool const isExpanding = it->second.isExpanding;
+        if (isComplete)
+        {
+            it->second.state = DirectoryState::Known;
+            it->second.isExpanding = false;
+            it->second.request = 0;
+
+            if (path.empty() == false && isWideParameterNode(path))
+            {
+                ber::ObjectIdentifier const parent = parentOf(path);
+                m_wideParents.insert(parent);
+
+                // the siblings that are still queued are no longer prefetched
+                for (PathQueue::iterator queued = m_queue.begin(); queued != m_queue.end(); )
+                {
+                    if (parentOf(*queued) == parent)
+                    {
+                        m_entries.erase(*queued);
+                        queued = m_queue.erase(queued);
+                    }
+                    else
+                    {
+                        ++queued;
+                    }
+                }
+            }
+        }
+        else
+        {
+            m_entries.erase(it);
+        }
+
+        if (isExpanding && m_listener != 0)
+        {
+            m_listener->expanded(path, isComplete);
+        }
+
+        prefetch(true);
+    }
+
+    LIBEMBER_INLINE
+    void GlowTreeBrowser::prefetch(bool isPartial)
+    {
+        bool isSent = false;
+
+        while (m_queue.empty() == false && m_prefetching < m_depth)
+        {
+            size_type const batch = std::min(m_batchSize, m_queue.size());
+            if (m_depth - m_prefetching < batch || (batch < m_batchSize && isPartial == false))
+                break;
+
+            for (size_type i = 0; i < batch; ++i)
+            {
+                ber::ObjectIdentifier const path = m_queue.front();
+                m_queue.pop_front();
+                request(path, m_entries.find(path)->second, true);
+            }
+
+            isSent = true;
+        }
+
+        if (isSent)
+        {
+            m_session.flush();
+        }
+    }
+
+    LIBEMBER_INLINE
+    bool GlowTreeBrowser::isWideParameterNode(ber::ObjectIdentifier const& path) const
+    {
+        GlowTreeMirror::Element const node = m_mirror.find(path);
+        if (node.isValid() == false || node.childCount() < m_wideThreshold)
+            return false;
+
+        for (GlowTreeMirror::Element child = node.firstChild(); child.isValid(); child = child.nextSibling())
+        {
+            if (child.type() != GlowTreeMirror::Parameter)
+                return false;
+        }
+
+        return true;
+    }
+
+    LIBEMBER_INLINE
+    void GlowTreeBrowser::dequeue(ber::ObjectIdentifier const& path)
+    {
+        PathQueue::iterator const it = std::find(m_queue.begin(), m_queue.end(), path);
+        if (it != m_queue.end())
+        {
+            m_queue.erase(it);
+        }
+    }
+
+    LIBEMBER_INLINE
+    GlowTreeMirror::ElementType GlowTreeBrowser::typeOf(ber::ObjectIdentifier const& path) const
+    {
+        GlowTreeMirror::Element const element = m_mirror.find(path);
+        return element.isValid() ? element.type() : GlowTreeMirror::Node;
+    }
+
+    LIBEMBER_INLINE
+    ber::ObjectIdentifier GlowTreeBrowser::parentOf(ber::ObjectIdentifier const& path)
+    {
+        return path.empty() ? path : ber::ObjectIdentifier(path.begin(), path.end() - 1);
+    }
+}
+}
+
+#endif  // __LIBEMBER_GLOW_IMPL_GLOWTREEBROWSER_IPP
@@ -0,0 +1,335 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef __LIBEMBER_GLOW_IMPL_GLOWTREEDIFF_IPP
+#define __LIBEMBER_GLOW_IMPL_GLOWTREEDIFF_IPP
+
+#include <algorithm>
+#include "../../util/Inline.hpp"
+#include "../../util/OctetSlice.hpp"
+#include "../GlowConnection.hpp"
+#include "../GlowQualifiedFunction.hpp"
+#include "../GlowQualifiedMatrix.hpp"
+#include "../GlowQualifiedNode.hpp"
+#include "../GlowQualifiedParameter.hpp"
+#include "../GlowRootElementCollection.hpp"
+#include "../GlowSource.hpp"
+#include "../GlowTarget.hpp"
+
+namespace libember { namespace glow
+{
+    LIBEMBER_INLINE
+    GlowTreeDiff::Difference::Difference(DifferenceType type, GlowTreeMirror::ElementType elementType, ber::ObjectIdentifier const& path)
+        : type(type)
+        , elementType(elementType)
+        , path(path)
+        , connectionsChanged(false)
+    {}
+
+    LIBEMBER_INLINE
+    GlowTreeDiff::GlowTreeDiff()
+        : m_first(true)
+        , m_second(true)
+        , m_previous(&m_first)
+        , m_current(&m_second)
+    {}
+
+    LIBEMBER_INLINE
+    GlowTreeDiff::size_type GlowTreeDiff::compare(dom::Node const& previous, dom::Node const& current)
+    {
+        m_previous->clear();
+        m_previous->merge(previous);
+        m_current->clear();
+        m_current->merge(current);
+        return compare();
+    }
+
+    LIBEMBER_INLINE
+    GlowTreeDiff::size_type GlowTreeDiff::update(dom::Node const& current)
+    {
+        std::swap(m_previous, m_current);
+        m_current->clear();
+        m_current->merge(current);
+        return compare();
+    }
+
+    LIBEMBER_INLINE
+    GlowTreeDiff::DifferenceCollection const& GlowTreeDiff::differences() const
+    {
+        return m_differences;
+    }
+
+    LIBEMBER_INLINE
+    GlowTreeMirror const& GlowTreeDiff::current() const
+    {
+        return *m_current;
+    }
+
+    LIBEMBER_INLINE
+    GlowTreeDiff::size_type GlowTreeDiff::compare()
+    {
+        DifferenceCollection removed;
+        m_differences.clear();
+        compareChildren(m_previous->root(), m_current->root(), removed);
+
+        m_differences.insert(m_differences.end(), removed.begin(), removed.end());
+        return m_differences.size();
+    }
+
+    LIBEMBER_INLINE
+    void GlowTreeDiff::compareChildren(GlowTreeMirror::Element const& previous, GlowTreeMirror::Element const& current, DifferenceCollection& removed)
+    {
+        for (GlowTreeMirror::Element child = current.firstChild(); child.isValid(); child = child.nextSibling())
+        {
+            // an element whose type has changed replaces the previous one with all its children
+            GlowTreeMirror::Element const match = previous.child(child.number());
+            if (match.isValid() && match.type() == child.type())
+            {
+                // subtrees with equal hashes are equal, so they are not traversed
+                if (match.subtreeHash() != child.subtreeHash())
+                {
+                    compareElement(match, child);
+                    compareChildren(match, child, removed);
+                }
+            }
+            else
+            {
+                addSubtree(child);
+            }
+        }
+
+        for (GlowTreeMirror::Element child = previous.firstChild(); child.isValid(); child = child.nextSibling())
+        {
+            if (current.child(child.number()).isValid() == false)
+            {
+                removed.push_back(Difference(Removed, child.type(), child.path()));
+            }
+        }
+    }
+
+    LIBEMBER_INLINE
+    void GlowTreeDiff::compareElement(GlowTreeMirror::Element const& previous, GlowTreeMirror::Element const& current)
+    {
+        Difference difference(Changed, current.type(), ber::ObjectIdentifier());
+
+        GlowTreeMirror::PropertyMap const* const properties = current.properties();
+        GlowTreeMirror::PropertyMap const* const previousProperties = previous.properties();
+        if (properties != 0)
+        {
+            GlowTreeMirror::PropertyMap::const_iterator const last = properties->end();
+            for (GlowTreeMirror::PropertyMap::const_iterator it = properties->begin(); it != last; ++it)
+            {
+                GlowTreeMirror::PropertyMap::const_iterator const match = previousProperties != 0
+                    ? previousProperties->find(it->first)
+                    : last;
+
+                if (previousProperties == 0 || match == previousProperties->end() || match->second != it->second)
+                {
+                    difference.properties.push_back(it->first);
+                }
+            }
+        }
+
+        GlowTreeMirror::MatrixState const* const matrix = current.matrix();
+        if (matrix != 0)
+        {
+            difference.connectionsChanged = isDifferent(*previous.matrix(), *matrix);
+        }
+
+        if (difference.properties.empty() == false || difference.connectionsChanged)
+        {
+            difference.path = current.path();
+            m_differences.push_back(difference);
+        }
+    }
+
+    LIBEMBER_INLINE
+    void GlowTreeDiff::addSubtree(GlowTreeMirror::Element const& current)
+    {
+        Difference difference(Added, current.type(), current.path());
+
+        GlowTreeMirror::PropertyMap const* const properties = current.properties();
+        if (properties != 0)
+        {
+            GlowTreeMirror::PropertyMap::const_iterator const last = properties->end();
+            for (GlowTreeMirror::PropertyMap::const_iterator it = properties->begin(); it != last; ++it)
+            {
+                difference.properties.push_back(it->first);
+            }
+        }
+
+        GlowTreeMirror::MatrixState const* const matrix = current.matrix();
+        if (matrix != 0)
+        {
+            difference.connectionsChanged = isDifferent(GlowTreeMirror::MatrixState(), *matrix);
+        }
+
+        m_differences.push_back(difference);
+
+        for (GlowTreeMirror::Element child = current.firstChild(); child.isValid(); child = child.nextSibling())
+        {
+            addSubtree(child);
+        }
+    }
+
+    LIBEMBER_INLINE
+    bool GlowTreeDiff::isDifferent(GlowTreeMirror::MatrixState const& previous, GlowTreeMirror::MatrixState const& current)
+    {
+        if (previous.targets != current.targets
+        ||  previous.sources != current.sources
+        ||  previous.connections.size() != current.connections.size())
+        {
+            return true;
+        }
+
+        GlowTreeMirror::MatrixState::ConnectionCollection::const_iterator const last = current.connections.end();
+        GlowTreeMirror::MatrixState::ConnectionCollection::const_iterator other = previous.connections.begin();
+        for (GlowTreeMirror::MatrixState::ConnectionCollection::const_iterator it = current.connections.begin(); it != last; ++it, ++other)
+        {
+            if (it->target != other->target || it->sources != other->sources)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    LIBEMBER_INLINE
+    GlowRootElementCollection* GlowTreeDiff::createNotification() const
+    {
+        GlowRootElementCollection* const message = GlowRootElementCollection::create();
+        size_type count = 0;
+
+        DifferenceCollection::const_iterator const last = m_differences.end();
+        for (DifferenceCollection::const_iterator it = m_differences.begin(); it != last; ++it)
+        {
+            if (it->type == Removed)
+            {
+                if (it->elementType == GlowTreeMirror::Node)
+                {
+                    GlowQualifiedNode* const node = new GlowQualifiedNode(message, it->path);
+                    node->setIsOnline(false);
+                    ++count;
+                }
+                else if (it->elementType == GlowTreeMirror::Parameter)
+                {
+                    GlowQualifiedParameter* const parameter = new GlowQualifiedParameter(message, it->path);
+                    parameter->setIsOnline(false);
+                    ++count;
+                }
+                continue;
+            }
+
+            GlowTreeMirror::Element const element = m_current->find(it->path);
+            GlowContentElement* glow = 0;
+            switch(it->elementType)
+            {
+                case GlowTreeMirror::Parameter:
+                    glow = new GlowQualifiedParameter(message, it->path);
+                    break;
+
+                case GlowTreeMirror::Matrix:
+                    glow = new GlowQualifiedMatrix(message, it->path);
+                    break;
+
+                case GlowTreeMirror::Function:
+                    glow = new GlowQualifiedFunction(message, it->path);
+                    break;
+
+                default:
+                    glow = new GlowQualifiedNode(message, it->path);
+                    break;
+            }
+            ++count;
+
+            GlowTreeMirror::PropertyMap const* const properties = element.properties();
+            if (properties != 0 && it->properties.empty() == false)
+            {
+                std::size_t size = 0;
+                Difference::PropertyCollection::const_iterator const end = it->properties.end();
+                for (Difference::PropertyCollection::const_iterator tag = it->properties.begin(); tag != end; ++tag)
+                {
+                    size += properties->find(*tag)->second.size();
+                }
+
+                libember::util::OctetSliceBuffer buffer(size > 0 ? size : 1);
+                for (Difference::PropertyCollection::const_iterator tag = it->properties.begin(); tag != end; ++tag)
+                {
+                    GlowTreeMirror::PropertyMap::mapped_type const& encoded = properties->find(*tag)->second;
+                    if (encoded.empty() == false)
+                    {
+                        glow->insertEncodedProperties(buffer.append(encoded.begin(), encoded.size()));
+                    }
+                }
+            }
+
+            GlowTreeMirror::MatrixState const* const matrix = element.matrix();
+            if (it->connectionsChanged && matrix != 0)
+            {
+                insertConnections(static_cast<GlowMatrixBase&>(*glow), *matrix);
+            }
+        }
+
+        if (count == 0)
+        {
+            delete message;
+            return 0;
+        }
+        return message;
+    }
+
+    LIBEMBER_INLINE
+    void GlowTreeDiff::insertConnections(GlowMatrixBase& matrix, GlowTreeMirror::MatrixState const& state)
+    {
+        if (state.targets.empty() == false)
+        {
+            dom::Sequence* const targets = matrix.targets();
+            GlowTreeMirror::MatrixState::SignalCollection::const_iterator const last = state.targets.end();
+            for (GlowTreeMirror::MatrixState::SignalCollection::const_iterator it = state.targets.begin(); it != last; ++it)
+            {
+                targets->insert(targets->end(), new GlowTarget(*it));
+            }
+        }
+
+        if (state.sources.empty() == false)
+        {
+            dom::Sequence* const sources = matrix.sources();
+            GlowTreeMirror::MatrixState::SignalCollection::const_iterator const last = state.sources.end();
+            for (GlowTreeMirror::MatrixState::SignalCollection::const_iterator it = state.sources.begin(); it != last; ++it)
+            {
+                sources->insert(sources->end(), new GlowSource(*it));
+            }
+        }
+
+        if (state.connections.empty() == false)
+        {
+            dom::Sequence* const connections = matrix.connections();
+            GlowTreeMirror::MatrixState::ConnectionCollection::const_iterator const last = state.connections.end();
+            for (GlowTreeMirror::MatrixState::ConnectionCollection::const_iterator it = state.connections.begin(); it != last; ++it)
+            {
+                GlowConnection* const connection = new GlowConnection(it->target);
+                connection->setSources(it->sources);
+                connections->insert(connections->end(), connection);
+            }
+        }
+    }
+}
+}
+
+#endif  // __LIBEMBER_GLOW_IMPL_GLOWTREEDIFF_IPP
@@ -0,0 +1,1608 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef __LIBEMBER_GLOW_IMPL_GLOWTREEMIRROR_IPP
+#define __LIBEMBER_GLOW_IMPL_GLOWTREEMIRROR_IPP
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include "../../util/Inline.hpp"
+#include "../../util/OctetStream.hpp"
+#include "../GlowConnection.hpp"
+#include "../GlowElementCollection.hpp"
+#include "../GlowFunction.hpp"
+#include "../GlowLabel.hpp"
+#include "../GlowMatrix.hpp"
+#include "../GlowNode.hpp"
+#include "../GlowParameter.hpp"
+#include "../GlowQualifiedFunction.hpp"
+#include "../GlowQualifiedMatrix.hpp"
+#include "../GlowQualifiedNode.hpp"
+#include "../GlowQualifiedParameter.hpp"
+#include "../GlowRootElementCollection.hpp"
+#include "../GlowSignal.hpp"
+#include "../GlowSource.hpp"
+#include "../GlowStreamCollection.hpp"
+#include "../GlowStreamEntry.hpp"
+#include "../GlowTags.hpp"
+#include "../GlowTarget.hpp"
+#include "../GlowType.hpp"
+
+namespace libember { namespace glow
+{
+    /**************************************************************************
+     * ParameterState, Connection, Label and MatrixState                      *
+     **************************************************************************/
+
+    LIBEMBER_INLINE
+    GlowTreeMirror::ParameterState::ParameterState()
+        : access(Access::ReadOnly)
+        , type(ParameterType::None)
+        , factor(0)
+        , streamIdentifier(-1)
+        , displayValue(0.0)
+        , enumeration(0)
+    {}
+
+    LIBEMBER_INLINE
+    GlowTreeMirror::Connection::Connection(int target)
+        : target(target)
+    {}
+
+    LIBEMBER_INLINE
+    GlowTreeMirror::Label::Label(ber::ObjectIdentifier const& basePath, std::string const& description)
+        : basePath(basePath)
+        , description(description)
+    {}
+
+    LIBEMBER_INLINE
+    GlowTreeMirror::MatrixState::MatrixState()
+        : type(MatrixType::OneToN)
+        , addressingMode(MatrixAddressingMode::Linear)
+        , targetCount(0)
+        , sourceCount(0)
+        , maximumTotalConnects(0)
+        , maximumConnectsPerTarget(0)
+    {}
+
+    LIBEMBER_INLINE
+    GlowTreeMirror::Connection const* GlowTreeMirror::MatrixState::connection(int target) const
+    {
+        ConnectionCollection::const_iterator first = connections.begin();
+        ConnectionCollection::size_type count = connections.size();
+        while (count > 0)
+        {
+            ConnectionCollection::size_type const half = count / 2;
+            if (first[half].target < target)
+            {
+                first += half + 1;
+                count -= half + 1;
+            }
+            else
+            {
+                count = half;
+            }
+        }
+
+        return first != connections.end() && first->target == target
+            ? &*first
+            : 0;
+    }
+
+
+    /**************************************************************************
+     * Element                                                                *
+     **************************************************************************/
+
+    LIBEMBER_INLINE
+    GlowTreeMirror::Element::Element()
+        : m_mirror(0)
+        , m_index(0)
+    {}
+
+    LIBEMBER_INLINE
+    GlowTreeMirror::Element::Element(GlowTreeMirror const* mirror, size_type index)
+        : m_mirror(mirror)
+        , m_index(index)
+    {}
+
+    LIBEMBER_INLINE
+    bool GlowTreeMirror::Element::isValid() const
+    {
+        return m_mirror != 0;
+    }
+
+    LIBEMBER_INLINE
+    GlowTreeMirror::ElementType GlowTreeMirror::Element::type() const
+    {
+        return m_mirror->m_entries[m_index].type;
+    }
+
+    LIBEMBER_INLINE
+    int GlowTreeMirror::Element::number() const
+    {
+        return m_mirror->m_entries[m_index].number;
+    }
+
+    LIBEMBER_INLINE
+    ber::ObjectIdentifier GlowTreeMirror::Element::path() const
+    {
+        // The numbers are collected from the element up to the root.
+        ber::ObjectIdentifier result;
+        for (size_type index = m_index; index != None; index = m_mirror->m_entries[index].parent)
+        {
+            result.push_back(m_mirror->m_entries[index].number);
+        }
+        std::reverse(result.begin(), result.end());
+        return result;
+    }
+
+    LIBEMBER_INLINE
+    std::string const& GlowTreeMirror::Element::identifier() const
+    {
+        return m_mirror->m_entries[m_index].identifier;
+    }
+
+    LIBEMBER_INLINE
+    std::string const& GlowTreeMirror::Element::description() const
+    {
+        return m_mirror->m_entries[m_index].description;
+    }
+
+    LIBEMBER_INLINE
+    bool GlowTreeMirror::Element::isOnline() const
+    {
+        return m_mirror->m_entries[m_index].isOnline;
+    }
+
+    LIBEMBER_INLINE
+    GlowTreeMirror::Element GlowTreeMirror::Element::parent() const
+    {
+        return m_index != None
+            ? Element(m_mirror, m_mirror->m_entries[m_index].parent)
+            : Element();
+    }
+
+    LIBEMBER_INLINE
+    GlowTreeMirror::Element GlowTreeMirror::Element::firstChild() const
+    {
+        size_type const index = m_mirror->m_entries[m_index].firstChild;
+        return index != None
+            ? Element(m_mirror, index)
+            : Element();
+    }
+
+    LIBEMBER_INLINE
+    GlowTreeMirror::Element GlowTreeMirror::Element::nextSibling() const
+    {
+        size_type const index = m_mirror->m_entries[m_index].nextSibling;
+        return index != None
+            ? Element(m_mirror, index)
+            : Element();
+    }
+
+    LIBEMBER_INLINE
+    GlowTreeMirror::Element GlowTreeMirror::Element::child(int number) const
+    {
+        size_type const index = m_mirror->findChild(m_index, number);
+        return index != None
+            ? Element(m_mirror, index)
+            : Element();
+    }
+
+    LIBEMBER_INLINE
+    GlowTreeMirror::size_type GlowTreeMirror::Element::childCount() const
+    {
+        return m_mirror->m_entries[m_index].childCount;
+    }
+
+    LIBEMBER_INLINE
+    GlowTreeMirror::ParameterState const* GlowTreeMirror::Element::parameter() const
+    {
+        Entry const& entry = m_mirror->m_entries[m_index];
+        return entry.type == Parameter
+            ? &m_mirror->m_parameters[entry.detail]
+            : 0;
+    }
+
+    LIBEMBER_INLINE
+    GlowTreeMirror::MatrixState const* GlowTreeMirror::Element::matrix() const
+    {
+        Entry const& entry = m_mirror->m_entries[m_index];
+        return entry.type == Matrix
+            ? &m_mirror->m_matrices[entry.detail]
+            : 0;
+    }
+
+    LIBEMBER_INLINE
+    GlowTreeMirror::PropertyMap const* GlowTreeMirror::Element::properties() const
+    {
+        PropertyCollection const& properties = m_mirror->m_properties;
+        return m_index < properties.size() && properties[m_index].empty() == false
+            ? &properties[m_index]
+            : 0;
+    }
+
+    LIBEMBER_INLINE
+    GlowTreeMirror::hash_type GlowTreeMirror::Element::subtreeHash() const
+    {
+        return m_mirror->m_entries[m_index].subtreeHash;
+    }
+
+
+    /**************************************************************************
+     * GlowTreeMirror                                                         *
+     **************************************************************************/
+
+    LIBEMBER_INLINE
+    GlowTreeMirror::Entry::Entry(ElementType type, int number, size_type parent)
+        : number(number)
+        , type(type)
+        , isOnline(true)
+        , parent(parent)
+        , firstChild(None)
+        , lastChild(None)
+        , nextSibling(None)
+        , childCount(0)
+        , detail(0)
+        , contentHash(0)
+        , subtreeHash(0)
+    {}
+
+    LIBEMBER_INLINE
+    GlowTreeMirror::LabelBase::LabelBase(size_type matrix, size_type label)
+        : matrix(matrix)
+        , label(label)
+    {}
+
+    LIBEMBER_INLINE
+    GlowTreeMirror::LabelKey::LabelKey(size_type matrix, size_type label, SignalType type, int number)
+        : matrix(matrix)
+        , label(label)
+        , type(type)
+        , number(number)
+    {}
+
+    LIBEMBER_INLINE
+    bool GlowTreeMirror::LabelKey::operator<(LabelKey const& other) const
+    {
+        if (matrix != other.matrix)
+            return matrix < other.matrix;
+
+        if (label != other.label)
+            return label < other.label;
+
+        if (type != other.type)
+            return type < other.type;
+
+        return number < other.number;
+    }
+
+    LIBEMBER_INLINE
+    GlowTreeMirror::GlowTreeMirror(bool retainProperties)
+        : m_parent(None)
+        , m_changed(0)
+        , m_retainProperties(retainProperties)
+        , m_isHashPending(false)
+    {
+        clear();
+    }
+
+    LIBEMBER_INLINE
+    GlowTreeMirror::~GlowTreeMirror()
+    {}
+
+    LIBEMBER_INLINE
+    void GlowTreeMirror::clear()
+    {
+        EntryCollection().swap(m_entries);
+        ParameterCollection().swap(m_parameters);
+        MatrixCollection().swap(m_matrices);
+        PropertyCollection().swap(m_properties);
+        m_enumerations.clear();
+        SlotCollection(64, None).swap(m_slots);
+        LabelBaseCollection().swap(m_pendingLabels);
+        m_labelBases.clear();
+        m_labelIndex.clear();
+        m_streams.clear();
+        SlotCollection().swap(m_pendingValues);
+
+        m_entries.push_back(Entry(Node, 0, None));
+    }
+
+    LIBEMBER_INLINE
+    GlowTreeMirror::size_type GlowTreeMirror::merge(dom::Node const& message)
+    {
+        m_parent = None;
+        m_changed = 0;
+        accept(message);
+
+        if (m_pendingLabels.empty() == false)
+        {
+            resolveLabels();
+        }
+        return m_changed;
+    }
+
+    LIBEMBER_INLINE
+    GlowTreeMirror::Element GlowTreeMirror::root() const
+    {
+        return Element(this, None);
+    }
+
+    LIBEMBER_INLINE
+    GlowTreeMirror::Element GlowTreeMirror::find(ber::ObjectIdentifier const& path) const
+    {
+        size_type index = None;
+        ber::ObjectIdentifier::const_iterator const last = path.end();
+        for (ber::ObjectIdentifier::const_iterator it = path.begin(); it != last; ++it)
+        {
+            index = findChild(index, *it);
+            if (index == None)
+            {
+                return Element();
+            }
+        }
+        return Element(this, index);
+    }
+
+    LIBEMBER_INLINE
+    GlowTreeMirror::size_type GlowTreeMirror::size() const
+    {
+        return m_entries.size() - 1;
+    }
+
+    LIBEMBER_INLINE
+    std::string GlowTreeMirror::signalLabel(Element const& matrix, SignalType type, int number, std::string const& description) const
+    {
+        MatrixState const* const state = matrix.m_mirror == this ? matrix.matrix() : 0;
+        if (state == 0)
+        {
+            return std::string();
+        }
+
+        MatrixState::LabelCollection::size_type label = 0;
+        if (description.empty() == false)
+        {
+            while (label < state->labels.size() && state->labels[label].description != description)
+            {
+                ++label;
+            }
+        }
+
+        LabelIndex::const_iterator const result = label < state->labels.size()
+            ? m_labelIndex.find(LabelKey(matrix.m_index, label, type, number))
+            : m_labelIndex.end();
+
+        if (result == m_labelIndex.end())
+        {
+            return std::string();
+        }
+
+        ParameterState const* const parameter = Element(this, result->second).parameter();
+        return parameter != 0 && parameter->value.type().value() == ParameterType::String
+            ? parameter->value.toString()
+            : std::string();
+    }
+
+    LIBEMBER_INLINE
+    void GlowTreeMirror::elementChanged(Element const&, int)
+    {}
+
+    LIBEMBER_INLINE
+    void GlowTreeMirror::applyFormula(std::string const&, double*, size_type)
+    {}
+
+    LIBEMBER_INLINE
+    GlowTreeMirror::size_type GlowTreeMirror::slot(size_type parent, int number) const
+    {
+        size_type const mask = m_slots.size() - 1;
+        size_type hash = parent * 0x9E3779B1UL + static_cast<unsigned int>(number);
+        hash ^= hash >> 16;
+
+        for (size_type slot = hash & mask; ; slot = (slot + 1) & mask)
+        {
+            size_type const index = m_slots[slot];
+            if (index == None || (m_entries[index].parent == parent && m_entries[index].number == number))
+            {
+                return slot;
+            }
+        }
+    }
+
+    LIBEMBER_INLINE
+    GlowTreeMirror::size_type GlowTreeMirror::findChild(size_type parent, int number) const
+    {
+        return m_slots[slot(parent, number)];
+    }
+
+    LIBEMBER_INLINE
+    GlowTreeMirror::size_type GlowTreeMirror::child(size_type parent, int number, ElementType type, int& changes)
+    {
+        size_type const position = slot(parent, number);
+        size_type index = m_slots[position];
+        if (index != None)
+        {
+            if (m_entries[index].type == type)
+            {
+                return index;
+            }
+
+            changes |= ContentsChanged;
+        }
+        else
+        {
+            index = m_entries.size();
+            m_entries.push_back(Entry(type, number, parent));
+            m_slots[position] = index;
+
+            Entry& owner = m_entries[parent];
+            if (owner.lastChild == None)
+            {
+                owner.firstChild = index;
+            }
+            else
+            {
+                m_entries[owner.lastChild].nextSibling = index;
+            }
+            owner.lastChild = index;
+            owner.childCount += 1;
+
+            changes |= Added;
+            if (m_entries.size() * 2 > m_slots.size())
+            {
+                grow();
+            }
+        }
+
+        Entry& entry = m_entries[index];
+        entry.type = type;
+        switch (type)
+        {
+            case Parameter:
+                entry.detail = m_parameters.size();
+                m_parameters.push_back(ParameterState());
+                break;
+
+            case Matrix:
+                entry.detail = m_matrices.size();
+                m_matrices.push_back(MatrixState());
+                break;
+
+            default:
+                entry.detail = 0;
+                break;
+        }
+        return index;
+    }
+
+    LIBEMBER_INLINE
+    GlowTreeMirror::size_type GlowTreeMirror::resolve(ber::ObjectIdentifier const& path, ElementType type, int& changes)
+    {
+        size_type index = None;
+        ber::ObjectIdentifier::size_type const count = path.size();
+        for (ber::ObjectIdentifier::size_type i = 0; i + 1 < count; ++i)
+        {
+            size_type const parent = index;
+            index = findChild(parent, path[static_cast<int>(i)]);
+            if (index == None)
+            {
+                int added = 0;
+                index = child(parent, path[static_cast<int>(i)], Node, added);
+                m_changed += 1;
+                elementChanged(Element(this, index), added);
+            }
+        }
+
+        return count > 0
+            ? child(index, path.back(), type, changes)
+            : index;
+    }
+
+    LIBEMBER_INLINE
+    void GlowTreeMirror::grow()
+    {
+        SlotCollection(m_slots.size() * 2, None).swap(m_slots);
+
+        size_type const count = m_entries.size();
+        for (size_type index = 1; index < count; ++index)
+        {
+            Entry const& entry = m_entries[index];
+            m_slots[slot(entry.parent, entry.number)] = index;
+        }
+    }
+
+    LIBEMBER_INLINE
+    bool GlowTreeMirror::isEqual(Value const& lhs, Value const& rhs)
+    {
+        if (lhs.type().value() != rhs.type().value())
+        {
+            return false;
+        }
+
+        switch (lhs.type().value())
+        {
+            case ParameterType::Integer:
+            case ParameterType::Enum:
+                return lhs.toInteger() == rhs.toInteger();
+
+            case ParameterType::Real:
+                return lhs.toReal() == rhs.toReal();
+
+            case ParameterType::String:
+                return lhs.toString() == rhs.toString();
+
+            case ParameterType::Boolean:
+                return lhs.toBoolean() == rhs.toBoolean();
+
+            case ParameterType::Octets:
+                {
+                    ber::Octets const left = lhs.toOctets();
+                    ber::Octets const right = rhs.toOctets();
+                    return left.size() == right.size() && std::equal(left.begin(), left.end(), right.begin());
+                }
+
+            default:
+                return true;
+        }
+    }
+
+    LIBEMBER_INLINE
+    bool GlowTreeMirror::isEqual(MinMax const& lhs, MinMax const& rhs)
+    {
+        return lhs.type().value() == rhs.type().value()
+            && (lhs.type().value() == ParameterType::Real
+                ? lhs.toReal() == rhs.toReal()
+                : lhs.toInteger() == rhs.toInteger());
+    }
+
+    LIBEMBER_INLINE
+    bool GlowTreeMirror::assign(std::string& field, std::string const& value)
+    {
+        if (field != value)
+        {
+            field = value;
+            return true;
+        }
+        return false;
+    }
+
+    LIBEMBER_INLINE
+    void GlowTreeMirror::mergeNode(size_type index, GlowNodeBase const& glow, int changes)
+    {
+        retainProperties(index, glow);
+
+        Entry& entry = m_entries[index];
+        bool modified = false;
+
+        if (glow.contains(NodeProperty::Identifier))
+            modified |= assign(entry.identifier, glow.identifier());
+
+        if (glow.contains(NodeProperty::Description))
+            modified |= assign(entry.description, glow.description());
+
+        if (glow.contains(NodeProperty::IsOnline) && entry.isOnline != glow.isOnline())
+        {
+            entry.isOnline = glow.isOnline();
+            modified = true;
+        }
+
+        finish(index, changes | (modified ? ContentsChanged : 0), glow.children());
+    }
+
+    LIBEMBER_INLINE
+    void GlowTreeMirror::mergeParameter(size_type index, GlowParameterBase const& glow, int changes)
+    {
+        retainProperties(index, glow);
+
+        Entry& entry = m_entries[index];
+        ParameterState& state = m_parameters[entry.detail];
+        bool modified = false;
+        bool isDisplayModified = false;
+
+        if (glow.contains(ParameterProperty::Identifier))
+            modified |= assign(entry.identifier, glow.identifier());
+
+        if (glow.contains(ParameterProperty::Description))
+            modified |= assign(entry.description, glow.description());
+
+        if (glow.contains(ParameterProperty::Format))
+            isDisplayModified |= assign(state.format, glow.format());
+
+        if (glow.contains(ParameterProperty::Formula))
+            isDisplayModified |= assign(state.formula, glow.formula().providerToConsumer());
+
+        if (glow.contains(ParameterProperty::IsOnline) && entry.isOnline != glow.isOnline())
+        {
+            entry.isOnline = glow.isOnline();
+            modified = true;
+        }
+
+        if (glow.contains(ParameterProperty::Value))
+        {
+            Value const value = glow.value();
+            if (isEqual(state.value, value) == false)
+            {
+                state.value = value;
+                changes |= ValueChanged;
+            }
+        }
+
+        if (glow.contains(ParameterProperty::Minimum))
+        {
+            MinMax const minimum = glow.minimum();
+            if (isEqual(state.minimum, minimum) == false)
+            {
+                state.minimum = minimum;
+                modified = true;
+            }
+        }
+
+        if (glow.contains(ParameterProperty::Maximum))
+        {
+            MinMax const maximum = glow.maximum();
+            if (isEqual(state.maximum, maximum) == false)
+            {
+                state.maximum = maximum;
+                modified = true;
+            }
+        }
+
+        if (glow.contains(ParameterProperty::Access) && state.access.value() != glow.access().value())
+        {
+            state.access = glow.access();
+            modified = true;
+        }
+
+        if (glow.contains(ParameterProperty::Type) && state.type.value() != glow.type().value())
+        {
+            state.type = glow.type();
+            isDisplayModified = true;
+        }
+
+        if (glow.contains(ParameterProperty::Factor) && state.factor != glow.factor())
+        {
+            state.factor = glow.factor();
+            isDisplayModified = true;
+        }
+
+        if (glow.contains(ParameterProperty::StreamIdentifier) && state.streamIdentifier != glow.streamIdentifier())
+        {
+            indexStream(index, state.streamIdentifier, glow.streamIdentifier());
+            state.streamIdentifier = glow.streamIdentifier();
+            modified = true;
+        }
+
+        bool const hasEnumMap = glow.contains(ParameterProperty::EnumMap);
+        if (hasEnumMap || glow.contains(ParameterProperty::Enumeration))
+        {
+            EnumerationPool::Table const* const enumeration = hasEnumMap
+                ? glow.enumerationMap(m_enumerations)
+                : glow.enumeration(m_enumerations);
+
+            // tables of the same pool are equal only if they are the same
+            if (state.enumeration != enumeration)
+            {
+                state.enumeration = enumeration;
+                isDisplayModified = true;
+            }
+        }
+
+        if ((changes & Added) != 0 && m_labelBases.empty() == false)
+        {
+            indexLabel(index);
+        }
+
+        if (isDisplayModified || (changes & ValueChanged) != 0)
+        {
+            m_pendingValues.push_back(index);
+            updateDisplayValues();
+        }
+
+        modified |= isDisplayModified;
+        finish(index, changes | (modified ? ContentsChanged : 0), glow.children());
+    }
+
+    LIBEMBER_INLINE
+    void GlowTreeMirror::mergeMatrix(size_type index, GlowMatrixBase const& glow, int changes)
+    {
+        retainProperties(index, glow);
+
+        Entry& entry = m_entries[index];
+        MatrixState& state = m_matrices[entry.detail];
+        bool modified = false;
+
+        if (glow.contains(MatrixProperty::Identifier))
+            modified |= assign(entry.identifier, glow.identifier());
+
+        if (glow.contains(MatrixProperty::Description))
+            modified |= assign(entry.description, glow.description());
+
+        if (glow.contains(MatrixProperty::Type) && state.type.value() != glow.type().value())
+        {
+            state.type = glow.type();
+            modified = true;
+        }
+
+        if (glow.contains(MatrixProperty::AddressingMode) && state.addressingMode.value() != glow.addressingMode().value())
+        {
+            state.addressingMode = glow.addressingMode();
+            modified = true;
+        }
+
+        if (glow.contains(MatrixProperty::TargetCount) && state.targetCount != glow.targetCount())
+        {
+            state.targetCount = glow.targetCount();
+            modified = true;
+        }
+
+        if (glow.contains(MatrixProperty::SourceCount) && state.sourceCount != glow.sourceCount())
+        {
+            state.sourceCount = glow.sourceCount();
+            modified = true;
+        }
+
+        if (glow.contains(MatrixProperty::MaximumTotalConnects) && state.maximumTotalConnects != glow.maximumTotalConnects())
+        {
+            state.maximumTotalConnects = glow.maximumTotalConnects();
+            modified = true;
+        }
+
+        if (glow.contains(MatrixProperty::MaximumConnectsPerTarget) && state.maximumConnectsPerTarget != glow.maximumConnectsPerTarget())
+        {
+            state.maximumConnectsPerTarget = glow.maximumConnectsPerTarget();
+            modified = true;
+        }
+
+        if (mergeSignals(state.targets, glow.targets(), GlowType::Target)
+        |   mergeSignals(state.sources, glow.sources(), GlowType::Source)
+        |   mergeConnections(state, glow.connections()))
+        {
+            changes |= ConnectionsChanged;
+        }
+
+        modified |= mergeLabels(index, state, glow.labels());
+
+        finish(index, changes | (modified ? ContentsChanged : 0), glow.children());
+    }
+
+    LIBEMBER_INLINE
+    bool GlowTreeMirror::mergeSignals(MatrixState::SignalCollection& signals, dom::Sequence const* sequence, GlowType::_Domain type)
+    {
+        bool modified = false;
+        if (sequence != 0)
+        {
+            dom::Sequence::const_iterator const last = sequence->end();
+            for (dom::Sequence::const_iterator it = sequence->begin(); it != last; ++it)
+            {
+                GlowContainer const* const glow = toGlowContainer(&*it);
+                if (glow != 0 && glow->typeTag().number() == static_cast<ber::Tag::Number>(type))
+                {
+                    int const number = static_cast<GlowSignal const*>(glow)->number();
+                    MatrixState::SignalCollection::iterator const where = std::lower_bound(signals.begin(), signals.end(), number);
+                    if (where == signals.end() || *where != number)
+                    {
+                        signals.insert(where, number);
+                        modified = true;
+                    }
+                }
+            }
+        }
+        return modified;
+    }
+
+    LIBEMBER_INLINE
+    bool GlowTreeMirror::mergeConnections(MatrixState& state, dom::Sequence const* sequence)
+    {
+        bool modified = false;
+        if (sequence != 0)
+        {
+            dom::Sequence::const_iterator const last = sequence->end();
+            for (dom::Sequence::const_iterator it = sequence->begin(); it != last; ++it)
+            {
+                GlowContainer const* const glow = toGlowContainer(&*it);
+                if (glow != 0 && glow->typeTag().number() == GlowType::Connection)
+                {
+                    GlowConnection const& connection = static_cast<GlowConnection const&>(*glow);
+                    modified |= mergeConnection(state, connection);
+                }
+            }
+        }
+        return modified;
+    }
+
+    LIBEMBER_INLINE
+    bool GlowTreeMirror::mergeConnection(MatrixState& state, GlowConnection const& glow)
+    {
+        int const target = glow.target();
+        MatrixState::ConnectionCollection& connections = state.connections;
+        MatrixState::ConnectionCollection::size_type first = 0;
+        MatrixState::ConnectionCollection::size_type count = connections.size();
+        while (count > 0)
+        {
+            MatrixState::ConnectionCollection::size_type const half = count / 2;
+            if (connections[first + half].target < target)
+            {
+                first += half + 1;
+                count -= half + 1;
+            }
+            else
+            {
+                count = half;
+            }
+        }
+
+        MatrixState::ConnectionCollection::iterator where = connections.begin() + first;
+
+        if (where == connections.end() || where->target != target)
+        {
+            where = connections.insert(where, Connection(target));
+        }
+
+        ber::ObjectIdentifier const sources = glow.sources();
+        ber::ObjectIdentifier& current = where->sources;
+        ber::ObjectIdentifier result;
+
+        switch (glow.operation().value())
+        {
+            case ConnectionOperation::Connect:
+                result = current;
+                for (ber::ObjectIdentifier::const_iterator it = sources.begin(); it != sources.end(); ++it)
+                {
+                    if (std::find(result.begin(), result.end(), *it) == result.end())
+                    {
+                        result.push_back(*it);
+                    }
+                }
+                break;
+
+            case ConnectionOperation::Disconnect:
+                for (ber::ObjectIdentifier::const_iterator it = current.begin(); it != current.end(); ++it)
+                {
+                    if (std::find(sources.begin(), sources.end(), *it) == sources.end())
+                    {
+                        result.push_back(*it);
+                    }
+                }
+                break;
+
+            default:
+                result = sources;
+                break;
+        }
+
+        if (result.size() == current.size() && std::equal(result.begin(), result.end(), current.begin()))
+        {
+            return false;
+        }
+
+        current.swap(result);
+        return true;
+    }
+
+    LIBEMBER_INLINE
+    bool GlowTreeMirror::mergeLabels(size_type index, MatrixState& state, dom::Sequence const* sequence)
+    {
+        if (sequence == 0)
+        {
+            return false;
+        }
+
+        MatrixState::LabelCollection labels;
+        dom::Sequence::const_iterator const last = sequence->end();
+        for (dom::Sequence::const_iterator it = sequence->begin(); it != last; ++it)
+        {
+            GlowContainer const* const glow = toGlowContainer(&*it);
+            if (glow != 0 && glow->typeTag().number() == GlowType::Label)
+            {
+                GlowLabel const& label = static_cast<GlowLabel const&>(*glow);
+                labels.push_back(Label(label.basePath(), label.description()));
+            }
+        }
+
+        bool equal = labels.size() == state.labels.size();
+        for (MatrixState::LabelCollection::size_type i = 0; equal && i < labels.size(); ++i)
+        {
+            equal = labels[i].basePath == state.labels[i].basePath
+                &&  labels[i].description == state.labels[i].description;
+        }
+
+        if (equal)
+        {
+            return false;
+        }
+
+        state.labels.swap(labels);
+        removeLabels(index);
+
+        for (MatrixState::LabelCollection::size_type i = 0; i < state.labels.size(); ++i)
+        {
+            m_pendingLabels.push_back(LabelBase(index, i));
+        }
+        return true;
+    }
+
+    LIBEMBER_INLINE
+    void GlowTreeMirror::removeLabels(size_type matrix)
+    {
+        LabelBaseCollection::iterator where = m_pendingLabels.begin();
+        for (LabelBaseCollection::const_iterator it = m_pendingLabels.begin(); it != m_pendingLabels.end(); ++it)
+        {
+            if (it->matrix != matrix)
+            {
+                *where++ = *it;
+            }
+        }
+        m_pendingLabels.erase(where, m_pendingLabels.end());
+
+        for (LabelBaseIndex::iterator it = m_labelBases.begin(); it != m_labelBases.end(); )
+        {
+            if (it->second.matrix == matrix)
+            {
+                m_labelBases.erase(it++);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+
+        int const lowest = std::numeric_limits<int>::min();
+        m_labelIndex.erase(
+            m_labelIndex.lower_bound(LabelKey(matrix, 0, TargetSignal, lowest)),
+            m_labelIndex.lower_bound(LabelKey(matrix + 1, 0, TargetSignal, lowest)));
+    }
+
+    LIBEMBER_INLINE
+    void GlowTreeMirror::resolveLabels()
+    {
+        LabelBaseCollection pending;
+        LabelBaseCollection::const_iterator const last = m_pendingLabels.end();
+        for (LabelBaseCollection::const_iterator it = m_pendingLabels.begin(); it != last; ++it)
+        {
+            MatrixState const& state = m_matrices[m_entries[it->matrix].detail];
+            ber::ObjectIdentifier const& basePath = state.labels[it->label].basePath;
+            Element const base = basePath.empty() == false ? find(basePath) : Element();
+            if (base.isValid() == false)
+            {
+                pending.push_back(*it);
+                continue;
+            }
+
+            m_labelBases.insert(std::make_pair(base.m_index, *it));
+
+            for (size_type group = m_entries[base.m_index].firstChild; group != None; group = m_entries[group].nextSibling)
+            {
+                SignalType type;
+                if (signalType(group, type))
+                {
+                    for (size_type index = m_entries[group].firstChild; index != None; index = m_entries[index].nextSibling)
+                    {
+                        if (m_entries[index].type == Parameter)
+                        {
+                            m_labelIndex[LabelKey(it->matrix, it->label, type, m_entries[index].number)] = index;
+                        }
+                    }
+                }
+            }
+        }
+
+        m_pendingLabels.swap(pending);
+    }
+
+    LIBEMBER_INLINE
+    void GlowTreeMirror::indexLabel(size_type index)
+    {
+        size_type const group = m_entries[index].parent;
+        SignalType type;
+        if (group == None || signalType(group, type) == false)
+        {
+            return;
+        }
+
+        typedef std::pair<LabelBaseIndex::const_iterator, LabelBaseIndex::const_iterator> Range;
+        Range const range = m_labelBases.equal_range(m_entries[group].parent);
+        for (LabelBaseIndex::const_iterator it = range.first; it != range.second; ++it)
+        {
+            m_labelIndex[LabelKey(it->second.matrix, it->second.label, type, m_entries[index].number)] = index;
+        }
+    }
+
+    LIBEMBER_INLINE
+    bool GlowTreeMirror::signalType(size_type group, SignalType& type) const
+    {
+        Entry const& entry = m_entries[group];
+        if (entry.identifier == "targets" || (entry.identifier.empty() && entry.number == 1))
+        {
+            type = TargetSignal;
+            return true;
+        }
+
+        if (entry.identifier == "sources" || (entry.identifier.empty() && entry.number == 2))
+        {
+            type = SourceSignal;
+            return true;
+        }
+        return false;
+    }
+
+    LIBEMBER_INLINE
+    void GlowTreeMirror::mergeFunction(size_type index, GlowFunctionBase const& glow, int changes)
+    {
+        retainProperties(index, glow);
+
+        Entry& entry = m_entries[index];
+        bool modified = false;
+
+        if (glow.contains(FunctionProperty::Identifier))
+            modified |= assign(entry.identifier, glow.identifier());
+
+        if (glow.contains(FunctionProperty::Description))
+            modified |= assign(entry.description, glow.description());
+
+        finish(index, changes | (modified ? ContentsChanged : 0), glow.children());
+    }
+
+    LIBEMBER_INLINE
+    void GlowTreeMirror::retainProperties(size_type index, GlowContainer const& glow)
+    {
+        if (m_retainProperties == false)
+            return;
+
+        // all element types store their properties in a set with the same tag
+        ber::Tag const contentsTag = GlowTags::Node::Contents();
+        GlowContainer::const_child_iterator const last = glow.childEnd();
+        for (GlowContainer::const_child_iterator it = glow.childBegin(); it != last; ++it)
+        {
+            dom::Container const* const contents = dynamic_cast<dom::Container const*>(&*it);
+            if (contents != 0 && it->applicationTag() == contentsTag)
+            {
+                if (m_properties.size() <= index)
+                    m_properties.resize(m_entries.size());
+
+                PropertyMap& properties = m_properties[index];
+                dom::Container::const_iterator const end = contents->end();
+                for (dom::Container::const_iterator property = contents->begin(); property != end; ++property)
+                {
+                    libember::util::OctetStream stream;
+                    property->encode(stream);
+
+                    PropertyMap::mapped_type& encoded = properties[property->applicationTag().number()];
+                    if (encoded.size() != stream.size() || std::equal(stream.begin(), stream.end(), encoded.begin()) == false)
+                    {
+                        encoded.assign(stream.begin(), stream.end());
+                        m_isHashPending = true;
+                    }
+                }
+            }
+        }
+    }
+
+    LIBEMBER_INLINE
+    bool GlowTreeMirror::FormulaOrder::operator()(FormulaBatch::value_type const& lhs, FormulaBatch::value_type const& rhs) const
+    {
+        int const result = lhs.first->compare(*rhs.first);
+        return result < 0 || (result == 0 && lhs.second < rhs.second);
+    }
+
+    LIBEMBER_INLINE
+    void GlowTreeMirror::indexStream(size_type index, int previous, int current)
+    {
+        if (previous != -1)
+        {
+            std::pair<StreamIndex::iterator, StreamIndex::iterator> const range = m_streams.equal_range(previous);
+            for (StreamIndex::iterator it = range.first; it != range.second; ++it)
+            {
+                if (it->second == index)
+                {
+                    m_streams.erase(it);
+                    break;
+                }
+            }
+        }
+
+        if (current != -1)
+        {
+            m_streams.insert(std::make_pair(current, index));
+        }
+    }
+
+    LIBEMBER_INLINE
+    void GlowTreeMirror::updateDisplayValues()
+    {
+        m_formulaBatch.clear();
+
+        SlotCollection::const_iterator const last = m_pendingValues.end();
+        for (SlotCollection::const_iterator it = m_pendingValues.begin(); it != last; ++it)
+        {
+            size_type const detail = m_entries[*it].detail;
+            ParameterState& state = m_parameters[detail];
+            ParameterType::_Domain const type = static_cast<ParameterType::_Domain>(state.value.type().value());
+
+            if (type == ParameterType::Integer || type == ParameterType::Real)
+            {
+                state.displayValue = type == ParameterType::Integer
+                    ? static_cast<double>(state.value.toInteger())
+                    : state.value.toReal();
+
+                if (state.factor > 1)
+                    state.displayValue /= state.factor;
+
+                if (state.formula.empty() == false)
+                {
+                    m_formulaBatch.push_back(std::make_pair(&state.formula, detail));
+                    continue;
+                }
+            }
+
+            formatDisplayValue(state, state.factor > 1 || type == ParameterType::Real);
+        }
+
+        m_pendingValues.clear();
+
+        // parameters sharing a formula are evaluated with a single call
+        std::sort(m_formulaBatch.begin(), m_formulaBatch.end(), FormulaOrder());
+
+        FormulaBatch::const_iterator const end = m_formulaBatch.end();
+        for (FormulaBatch::const_iterator first = m_formulaBatch.begin(); first != end; )
+        {
+            FormulaBatch::const_iterator next = first;
+            m_formulaValues.clear();
+            for ( ; next != end && *next->first == *first->first; ++next)
+            {
+                m_formulaValues.push_back(m_parameters[next->second].displayValue);
+            }
+
+            applyFormula(*first->first, &m_formulaValues[0], m_formulaValues.size());
+
+            for (ValueCollection::const_iterator value = m_formulaValues.begin(); first != next; ++first, ++value)
+            {
+                ParameterState& state = m_parameters[first->second];
+                state.displayValue = *value;
+                formatDisplayValue(state, true);
+            }
+        }
+    }
+
+    LIBEMBER_INLINE
+    void GlowTreeMirror::formatDisplayValue(ParameterState& state, bool isConverted)
+    {
+        switch(state.value.type().value())
+        {
+            case ParameterType::Integer:
+            case ParameterType::Real:
+                if (format(state.format, state.displayValue, state.displayText) == false)
+                {
+                    if (isConverted)
+                    {
+                        char text[32];
+                        std::size_t const length = static_cast<std::size_t>(std::sprintf(text, "%g", state.displayValue));
+                        state.displayText.assign(text, length);
+                    }
+                    else
+                    {
+                        state.displayText = state.value.toString();
+                    }
+                }
+                break;
+
+            case ParameterType::Boolean:
+                state.displayValue = state.value.toBoolean() ? 1.0 : 0.0;
+                state.displayText = state.value.toString();
+                break;
+
+            case ParameterType::String:
+                state.displayValue = 0.0;
+                state.displayText = state.value.toString();
+                break;
+
+            default:
+                state.displayValue = 0.0;
+                state.displayText.clear();
+                break;
+        }
+
+        // enumeration values are received as integers and displayed by the name of their entry
+        if (state.type.value() == ParameterType::Enum && state.value.type().value() == ParameterType::Integer)
+        {
+            long const index = state.value.toInteger();
+            EnumerationPool::Table::Entry const* const entry = state.enumeration != 0 && index >= std::numeric_limits<int>::min() && index <= std::numeric_limits<int>::max()
+                ? state.enumeration->find(static_cast<int>(index))
+                : 0;
+
+            state.displayValue = static_cast<double>(index);
+            if (entry != 0)
+                state.displayText.assign(entry->first, entry->length);
+        }
+    }
+
+    LIBEMBER_INLINE
+    bool GlowTreeMirror::format(std::string const& format, double value, std::string& text)
+    {
+        // conversions are limited to two digits of width and precision, so a single one,
+        // even a fixed point conversion of the largest double, never exceeds the buffer
+        char buffer[512];
+        char specifier[16];
+        std::string result;
+        bool hasConversion = false;
+
+        std::string::const_iterator const last = format.end();
+        for (std::string::const_iterator it = format.begin(); it != last; ++it)
+        {
+            if (*it != '%')
+            {
+                result += *it;
+                continue;
+            }
+
+            if (++it == last)
+                return false;
+
+            if (*it == '%')
+            {
+                result += '%';
+                continue;
+            }
+
+            if (hasConversion)
+                return false;
+
+            std::size_t length = 0;
+            specifier[length++] = '%';
+            for (int flags = 0; it != last && *it != 0 && std::strchr("-+ 0#", *it) != 0; ++it, ++flags)
+            {
+                if (flags == 4)
+                    return false;
+
+                specifier[length++] = *it;
+            }
+
+            for (int digits = 0; it != last && *it >= '0' && *it <= '9'; ++it, ++digits)
+            {
+                if (digits == 2)
+                    return false;
+
+                specifier[length++] = *it;
+            }
+
+            if (it != last && *it == '.')
+            {
+                specifier[length++] = *it++;
+                for (int digits = 0; it != last && *it >= '0' && *it <= '9'; ++it, ++digits)
+                {
+                    if (digits == 2)
+                        return false;
+
+                    specifier[length++] = *it;
+                }
+            }
+
+            // length modifiers are replaced by the ones matching the passed argument
+            for (int modifiers = 0; it != last && (*it == 'l' || *it == 'h' || *it == 'L'); ++it, ++modifiers)
+            {
+                if (modifiers == 2)
+                    return false;
+            }
+
+            if (it == last)
+                return false;
+
+            char const conversion = *it;
+            int written = 0;
+            if (conversion == 'd' || conversion == 'i' || conversion == 'o' || conversion == 'u' || conversion == 'x' || conversion == 'X')
+            {
+                // the value is clamped, since converting an out of range double is undefined
+                double const minimum = static_cast<double>(std::numeric_limits<long>::min());
+                double const maximum = static_cast<double>(std::numeric_limits<long>::max());
+                long const integer = value != value ? 0L
+                    : value <= minimum ? std::numeric_limits<long>::min()
+                    : value >= maximum ? std::numeric_limits<long>::max()
+                    : static_cast<long>(value);
+
+                specifier[length++] = 'l';
+                specifier[length++] = conversion;
+                specifier[length] = 0;
+                written = conversion == 'd' || conversion == 'i'
+                    ? std::sprintf(buffer, specifier, integer)
+                    : std::sprintf(buffer, specifier, static_cast<unsigned long>(integer));
+            }
+            else if (conversion == 'f' || conversion == 'F' || conversion == 'e' || conversion == 'E' || conversion == 'g' || conversion == 'G')
+            {
+                specifier[length++] = conversion;
+                specifier[length] = 0;
+                written = std::sprintf(buffer, specifier, value);
+            }
+            else
+            {
+                return false;
+            }
+
+            if (written < 0)
+                return false;
+
+            result.append(buffer, static_cast<std::size_t>(written));
+            hasConversion = true;
+        }
+
+        if (hasConversion)
+            text.swap(result);
+
+        return hasConversion;
+    }
+
+    LIBEMBER_INLINE
+    void GlowTreeMirror::updateHash(size_type index)
+    {
+        Entry& entry = m_entries[index];
+        hash_type const content = contentHash(index);
+        hash_type previous = entry.subtreeHash;
+
+        // the subtree hash of an element is its content hash plus the mixed subtree hashes of
+        // its children, so a change only updates the hashes along the path to the root
+        entry.subtreeHash += content - entry.contentHash;
+        entry.contentHash = content;
+
+        for (size_type child = index; child != None && m_entries[child].subtreeHash != previous; )
+        {
+            size_type const parent = m_entries[child].parent;
+            hash_type const parentPrevious = m_entries[parent].subtreeHash;
+            m_entries[parent].subtreeHash += mix(m_entries[child].subtreeHash) - mix(previous);
+            previous = parentPrevious;
+            child = parent;
+        }
+    }
+
+    LIBEMBER_INLINE
+    GlowTreeMirror::hash_type GlowTreeMirror::contentHash(size_type index) const
+    {
+        Entry const& entry = m_entries[index];
+        hash_type hash = 14695981039346656037ULL;
+        hash = append(hash, entry.number);
+        hash = append(hash, entry.type);
+
+        if (index < m_properties.size())
+        {
+            PropertyMap const& properties = m_properties[index];
+            PropertyMap::const_iterator const last = properties.end();
+            for (PropertyMap::const_iterator it = properties.begin(); it != last; ++it)
+            {
+                hash = append(hash, it->first);
+                hash = append(hash, static_cast<long long>(it->second.size()));
+                if (it->second.empty() == false)
+                    hash = append(hash, &it->second[0], &it->second[0] + it->second.size());
+            }
+        }
+
+        if (entry.type == Matrix)
+        {
+            MatrixState const& state = m_matrices[entry.detail];
+            hash = append(hash, static_cast<long long>(state.targets.size()));
+            for (MatrixState::SignalCollection::const_iterator it = state.targets.begin(); it != state.targets.end(); ++it)
+                hash = append(hash, *it);
+
+            hash = append(hash, static_cast<long long>(state.sources.size()));
+            for (MatrixState::SignalCollection::const_iterator it = state.sources.begin(); it != state.sources.end(); ++it)
+                hash = append(hash, *it);
+
+            for (MatrixState::ConnectionCollection::const_iterator it = state.connections.begin(); it != state.connections.end(); ++it)
+            {
+                hash = append(hash, it->target);
+                hash = append(hash, static_cast<long long>(it->sources.size()));
+                for (ber::ObjectIdentifier::const_iterator source = it->sources.begin(); source != it->sources.end(); ++source)
+                    hash = append(hash, *source);
+            }
+        }
+
+        // a hash of 0 is reserved for elements that have not been hashed yet
+        return hash != 0 ? hash : 1;
+    }
+
+    LIBEMBER_INLINE
+    GlowTreeMirror::hash_type GlowTreeMirror::append(hash_type hash, unsigned char const* first, unsigned char const* last)
+    {
+        for ( ; first != last; ++first)
+        {
+            hash = (hash ^ *first) * 1099511628211ULL;
+        }
+        return hash;
+    }
+
+    LIBEMBER_INLINE
+    GlowTreeMirror::hash_type GlowTreeMirror::append(hash_type hash, long long value)
+    {
+        unsigned long long const bits = static_cast<unsigned long long>(value);
+        for (int shift = 0; shift < 64; shift += 8)
+        {
+            hash = (hash ^ ((bits >> shift) & 0xFF)) * 1099511628211ULL;
+        }
+        return hash;
+    }
+
+    LIBEMBER_INLINE
+    GlowTreeMirror::hash_type GlowTreeMirror::mix(hash_type hash)
+    {
+        // the finalizer of splitmix64, which maps 0 to 0, so children that have not been
+        // hashed yet do not contribute to the hash of their parent
+        hash = (hash ^ (hash >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        hash = (hash ^ (hash >> 27)) * 0x94D049BB133111EBULL;
+        return hash ^ (hash >> 31);
+    }
+
+    LIBEMBER_INLINE
+    void GlowTreeMirror::finish(size_type index, int changes, GlowElementCollection const* children)
+    {
+        if (m_retainProperties && (changes != 0 || m_isHashPending))
+        {
+            updateHash(index);
+        }
+        m_isHashPending = false;
+
+        if (changes != 0)
+        {
+            m_changed += 1;
+            elementChanged(Element(this, index), changes);
+        }
+
+        if (children != 0)
+        {
+            size_type const parent = m_parent;
+            m_parent = index;
+            acceptChildren(*children);
+            m_parent = parent;
+        }
+    }
+
+    LIBEMBER_INLINE
+    void GlowTreeMirror::visit(GlowRootElementCollection const& glow)
+    {
+        acceptChildren(glow);
+    }
+
+    LIBEMBER_INLINE
+    void GlowTreeMirror::visit(GlowElementCollection const& glow)
+    {
+        acceptChildren(glow);
+    }
+
+    LIBEMBER_INLINE
+    void GlowTreeMirror::visit(GlowNode const& glow)
+    {
+        int changes = 0;
+        size_type const index = child(m_parent, glow.number(), Node, changes);
+        mergeNode(index, glow, changes);
+    }
+
+    LIBEMBER_INLINE
+    void GlowTreeMirror::visit(GlowQualifiedNode const& glow)
+    {
+        int changes = 0;
+        size_type const index = resolve(glow.path(), Node, changes);
+        if (index != None)
+        {
+            mergeNode(index, glow, changes);
+        }
+    }
+
+    LIBEMBER_INLINE
+    void GlowTreeMirror::visit(GlowParameter const& glow)
+    {
+        int changes = 0;
+        size_type const index = child(m_parent, glow.number(), Parameter, changes);
+        mergeParameter(index, glow, changes);
+    }
+
+    LIBEMBER_INLINE
+    void GlowTreeMirror::visit(GlowQualifiedParameter const& glow)
+    {
+        int changes = 0;
+        size_type const index = resolve(glow.path(), Parameter, changes);
+        if (index != None)
+        {
+            mergeParameter(index, glow, changes);
+        }
+    }
+
+    LIBEMBER_INLINE
+    void GlowTreeMirror::visit(GlowMatrix const& glow)
+    {
+        int changes = 0;
+        size_type const index = child(m_parent, glow.number(), Matrix, changes);
+        mergeMatrix(index, glow, changes);
+    }
+
+    LIBEMBER_INLINE
+    void GlowTreeMirror::visit(GlowQualifiedMatrix const& glow)
+    {
+        int changes = 0;
+        size_type const index = resolve(glow.path(), Matrix, changes);
+        if (index != None)
+        {
+            mergeMatrix(index, glow, changes);
+        }
+    }
+
+    LIBEMBER_INLINE
+    void GlowTreeMirror::visit(GlowFunction const& glow)
+    {
+        int changes = 0;
+        size_type const index = child(m_parent, glow.number(), Function, changes);
+        mergeFunction(index, glow, changes);
+    }
+
+    LIBEMBER_INLINE
+    void GlowTreeMirror::visit(GlowQualifiedFunction const& glow)
+    {
+        int changes = 0;
+        size_type const index = resolve(glow.path(), Function, changes);
+        if (index != None)
+        {
+            mergeFunction(index, glow, changes);
+        }
+    }
+
+    LIBEMBER_INLINE
+    void GlowTreeMirror::visit(GlowStreamCollection const& glow)
+    {
+        m_streamChanges.clear();
+        acceptChildren(glow);
+
+        // the formulas of all values of the collection are evaluated before any change is reported
+        m_pendingValues.assign(m_streamChanges.begin(), m_streamChanges.end());
+        updateDisplayValues();
+
+        SlotCollection::const_iterator const last = m_streamChanges.end();
+        for (SlotCollection::const_iterator it = m_streamChanges.begin(); it != last; ++it)
+        {
+            finish(*it, ValueChanged, 0);
+        }
+
+        m_streamChanges.clear();
+    }
+
+    LIBEMBER_INLINE
+    void GlowTreeMirror::visit(GlowStreamEntry const& glow)
+    {
+        std::pair<StreamIndex::const_iterator, StreamIndex::const_iterator> const range = m_streams.equal_range(glow.streamIdentifier());
+        if (range.first == range.second)
+            return;
+
+        Value const value = glow.value();
+        if (value.type().value() == ParameterType::Octets)
+            return;
+
+        for (StreamIndex::const_iterator it = range.first; it != range.second; ++it)
+        {
+            Entry const& entry = m_entries[it->second];
+            if (entry.type != Parameter)
+                continue;
+
+            ParameterState& state = m_parameters[entry.detail];
+            if (isEqual(state.value, value) == false)
+            {
+                state.value = value;
+                m_streamChanges.push_back(it->second);
+            }
+        }
+    }
+}
+}
+
+#endif  // __LIBEMBER_GLOW_IMPL_GLOWTREEMIRROR_IPP
@@ -0,0 +1,285 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef __LIBEMBER_GLOW_IMPL_GLOWVISITOR_IPP
+#define __LIBEMBER_GLOW_IMPL_GLOWVISITOR_IPP
+
+#include "../../util/Inline.hpp"
+#include "../GlowCommand.hpp"
+#include "../GlowConnection.hpp"
+#include "../GlowElementCollection.hpp"
+#include "../GlowFunction.hpp"
+#include "../GlowInvocation.hpp"
+#include "../GlowInvocationResult.hpp"
+#include "../GlowLabel.hpp"
+#include "../GlowMatrix.hpp"
+#include "../GlowNode.hpp"
+#include "../GlowParameter.hpp"
+#include "../GlowQualifiedFunction.hpp"
+#include "../GlowQualifiedMatrix.hpp"
+#include "../GlowQualifiedNode.hpp"
+#include "../GlowQualifiedParameter.hpp"
+#include "../GlowRootElementCollection.hpp"
+#include "../GlowSource.hpp"
+#include "../GlowStreamCollection.hpp"
+#include "../GlowStreamDescriptor.hpp"
+#include "../GlowStreamEntry.hpp"
+#include "../GlowStringIntegerCollection.hpp"
+#include "../GlowStringIntegerPair.hpp"
+#include "../GlowTarget.hpp"
+#include "../GlowTupleItemDescription.hpp"
+#include "../GlowType.hpp"
+
+namespace libember { namespace glow
+{
+    LIBEMBER_INLINE
+    GlowVisitor::GlowVisitor()
+    {}
+
+    LIBEMBER_INLINE
+    GlowVisitor::~GlowVisitor()
+    {}
+
+    LIBEMBER_INLINE
+    GlowContainer const* GlowVisitor::toGlowContainer(dom::Node const* node)
+    {
+        if (node != 0 && node->typeTag().getClass() == ber::Class::Application)
+        {
+            return static_cast<GlowContainer const*>(node);
+        }
+        else
+        {
+            return 0;
+        }
+    }
+
+    LIBEMBER_INLINE
+    bool GlowVisitor::accept(dom::Node const& node)
+    {
+        GlowContainer const* const glow = toGlowContainer(&node);
+        if (glow != 0)
+        {
+            switch(glow->typeTag().number())
+            {
+                case GlowType::Parameter:
+                    visit(static_cast<GlowParameter const&>(*glow));
+                    return true;
+
+                case GlowType::Command:
+                    visit(static_cast<GlowCommand const&>(*glow));
+                    return true;
+
+                case GlowType::Node:
+                    visit(static_cast<GlowNode const&>(*glow));
+                    return true;
+
+                case GlowType::ElementCollection:
+                    visit(static_cast<GlowElementCollection const&>(*glow));
+                    return true;
+
+                case GlowType::StreamEntry:
+                    visit(static_cast<GlowStreamEntry const&>(*glow));
+                    return true;
+
+                case GlowType::StreamCollection:
+                    visit(static_cast<GlowStreamCollection const&>(*glow));
+                    return true;
+
+                case GlowType::StringIntegerPair:
+                    visit(static_cast<GlowStringIntegerPair const&>(*glow));
+                    return true;
+
+                case GlowType::StringIntegerCollection:
+                    visit(static_cast<GlowStringIntegerCollection const&>(*glow));
+                    return true;
+
+                case GlowType::QualifiedParameter:
+                    visit(static_cast<GlowQualifiedParameter const&>(*glow));
+                    return true;
+
+                case GlowType::QualifiedNode:
+                    visit(static_cast<GlowQualifiedNode const&>(*glow));
+                    return true;
+
+                case GlowType::RootElementCollection:
+                    visit(static_cast<GlowRootElementCollection const&>(*glow));
+                    return true;
+
+                case GlowType::StreamDescriptor:
+                    visit(static_cast<GlowStreamDescriptor const&>(*glow));
+                    return true;
+
+                case GlowType::Matrix:
+                    visit(static_cast<GlowMatrix const&>(*glow));
+                    return true;
+
+                case GlowType::Target:
+                    visit(static_cast<GlowTarget const&>(*glow));
+                    return true;
+
+                case GlowType::Source:
+                    visit(static_cast<GlowSource const&>(*glow));
+                    return true;
+
+                case GlowType::Connection:
+                    visit(static_cast<GlowConnection const&>(*glow));
+                    return true;
+
+                case GlowType::QualifiedMatrix:
+                    visit(static_cast<GlowQualifiedMatrix const&>(*glow));
+                    return true;
+
+                case GlowType::Label:
+                    visit(static_cast<GlowLabel const&>(*glow));
+                    return true;
+
+                case GlowType::Function:
+                    visit(static_cast<GlowFunction const&>(*glow));
+                    return true;
+
+                case GlowType::QualifiedFunction:
+                    visit(static_cast<GlowQualifiedFunction const&>(*glow));
+                    return true;
+
+                case GlowType::TupleItemDescription:
+                    visit(static_cast<GlowTupleItemDescription const&>(*glow));
+                    return true;
+
+                case GlowType::Invocation:
+                    visit(static_cast<GlowInvocation const&>(*glow));
+                    return true;
+
+                case GlowType::InvocationResult:
+                    visit(static_cast<GlowInvocationResult const&>(*glow));
+                    return true;
+            }
+        }
+        return false;
+    }
+
+    LIBEMBER_INLINE
+    std::size_t GlowVisitor::acceptChildren(GlowContainer const& container)
+    {
+        std::size_t count = 0;
+        GlowContainer::const_child_iterator const last = container.childEnd();
+        for (GlowContainer::const_child_iterator it = container.childBegin(); it != last; ++it)
+        {
+            if (accept(*it))
+            {
+                count += 1;
+            }
+        }
+        return count;
+    }
+
+    LIBEMBER_INLINE
+    void GlowVisitor::visit(GlowParameter const&)
+    {}
+
+    LIBEMBER_INLINE
+    void GlowVisitor::visit(GlowCommand const&)
+    {}
+
+    LIBEMBER_INLINE
+    void GlowVisitor::visit(GlowNode const&)
+    {}
+
+    LIBEMBER_INLINE
+    void GlowVisitor::visit(GlowElementCollection const&)
+    {}
+
+    LIBEMBER_INLINE
+    void GlowVisitor::visit(GlowStreamEntry const&)
+    {}
+
+    LIBEMBER_INLINE
+    void GlowVisitor::visit(GlowStreamCollection const&)
+    {}
+
+    LIBEMBER_INLINE
+    void GlowVisitor::visit(GlowStringIntegerPair const&)
+    {}
+
+    LIBEMBER_INLINE
+    void GlowVisitor::visit(GlowStringIntegerCollection const&)
+    {}
+
+    LIBEMBER_INLINE
+    void GlowVisitor::visit(GlowQualifiedParameter const&)
+    {}
+
+    LIBEMBER_INLINE
+    void GlowVisitor::visit(GlowQualifiedNode const&)
+    {}
+
+    LIBEMBER_INLINE
+    void GlowVisitor::visit(GlowRootElementCollection const&)
+    {}
+
+    LIBEMBER_INLINE
+    void GlowVisitor::visit(GlowStreamDescriptor const&)
+    {}
+
+    LIBEMBER_INLINE
+    void GlowVisitor::visit(GlowMatrix const&)
+    {}
+
+    LIBEMBER_INLINE
+    void GlowVisitor::visit(GlowTarget const&)
+    {}
+
+    LIBEMBER_INLINE
+    void GlowVisitor::visit(GlowSource const&)
+    {}
+
+    LIBEMBER_INLINE
+    void GlowVisitor::visit(GlowConnection const&)
+    {}
+
+    LIBEMBER_INLINE
+    void GlowVisitor::visit(GlowQualifiedMatrix const&)
+    {}
+
+    LIBEMBER_INLINE
+    void GlowVisitor::visit(GlowLabel const&)
+    {}
+
+    LIBEMBER_INLINE
+    void GlowVisitor::visit(GlowFunction const&)
+    {}
+
+    LIBEMBER_INLINE
+    void GlowVisitor::visit(GlowQualifiedFunction const&)
+    {}
+
+    LIBEMBER_INLINE
+    void GlowVisitor::visit(GlowTupleItemDescription const&)
+    {}
+
+    LIBEMBER_INLINE
+    void GlowVisitor::visit(GlowInvocation const&)
+    {}
+
+    LIBEMBER_INLINE
+    void GlowVisitor::visit(GlowInvocationResult const&)
+    {}
+}
+}
+
+#endif  // __LIBEMBER_GLOW_IMPL_GLOWVISITOR_IPP
@@ -0,0 +1,544 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef __LIBEMBER_GLOW_IMPL_GLOWWRITER_IPP
+#define __LIBEMBER_GLOW_IMPL_GLOWWRITER_IPP
+
+#include <stdexcept>
+#include "../../util/Inline.hpp"
+#include "../GlowTags.hpp"
+#include "../GlowType.hpp"
+
+namespace libember { namespace glow
+{
+    LIBEMBER_INLINE
+    GlowWriter::GlowWriter()
+        : m_depth(0)
+    {}
+
+    LIBEMBER_INLINE
+    void GlowWriter::clear()
+    {
+        m_buffer.clear();
+        m_depth = 0;
+    }
+
+    LIBEMBER_INLINE
+    void GlowWriter::beginRoot()
+    {
+        open(GlowTags::Root(), GlowType(GlowType::RootElementCollection).toTypeTag(), Collection);
+    }
+
+    LIBEMBER_INLINE
+    void GlowWriter::endRoot()
+    {
+        if (m_depth != 1)
+            throw std::runtime_error("Attempt to end the root before its elements");
+
+        close(Collection);
+    }
+
+    LIBEMBER_INLINE
+    void GlowWriter::beginNode(int number)
+    {
+        openElement(GlowType(GlowType::Node).toTypeTag(), Node);
+        property(GlowTags::Node::Number(), number);
+    }
+
+    LIBEMBER_INLINE
+    void GlowWriter::beginNode(ber::ObjectIdentifier const& path)
+    {
+        openElement(GlowType(GlowType::QualifiedNode).toTypeTag(), Node);
+        property(GlowTags::QualifiedNode::Path(), path);
+    }
+
+    LIBEMBER_INLINE
+    void GlowWriter::endNode()
+    {
+        closeElement(Node);
+    }
+
+    LIBEMBER_INLINE
+    void GlowWriter::beginParameter(int number)
+    {
+        openElement(GlowType(GlowType::Parameter).toTypeTag(), Parameter);
+        property(GlowTags::Parameter::Number(), number);
+    }
+
+    LIBEMBER_INLINE
+    void GlowWriter::beginParameter(ber::ObjectIdentifier const& path)
+    {
+        openElement(GlowType(GlowType::QualifiedParameter).toTypeTag(), Parameter);
+        property(GlowTags::QualifiedParameter::Path(), path);
+    }
+
+    LIBEMBER_INLINE
+    void GlowWriter::endParameter()
+    {
+        closeElement(Parameter);
+    }
+
+    LIBEMBER_INLINE
+    void GlowWriter::beginMatrix(int number)
+    {
+        openElement(GlowType(GlowType::Matrix).toTypeTag(), Matrix);
+        property(GlowTags::Matrix::Number(), number);
+    }
+
+    LIBEMBER_INLINE
+    void GlowWriter::beginMatrix(ber::ObjectIdentifier const& path)
+    {
+        openElement(GlowType(GlowType::QualifiedMatrix).toTypeTag(), Matrix);
+        property(GlowTags::QualifiedMatrix::Path(), path);
+    }
+
+    LIBEMBER_INLINE
+    void GlowWriter::endMatrix()
+    {
+        closeElement(Matrix);
+    }
+
+    LIBEMBER_INLINE
+    void GlowWriter::beginChildren()
+    {
+        seal();
+        if (m_depth == 0 || (m_frames[m_depth - 1].kind != Node && m_frames[m_depth - 1].kind != Parameter && m_frames[m_depth - 1].kind != Matrix))
+            throw std::runtime_error("Children can only be written to a node, a parameter or a matrix");
+
+        // the children use the same tag for all element types
+        open(GlowTags::Node::Children(), GlowType(GlowType::ElementCollection).toTypeTag(), Collection);
+    }
+
+    LIBEMBER_INLINE
+    void GlowWriter::endChildren()
+    {
+        // the collection of the root is the only one that is not contained in an element
+        if (m_depth < 2)
+            throw std::runtime_error("Attempt to end children that have not been begun");
+
+        close(Collection);
+    }
+
+    LIBEMBER_INLINE
+    void GlowWriter::endContents()
+    {
+        seal();
+        if (m_depth == 0 || (m_frames[m_depth - 1].kind != Node && m_frames[m_depth - 1].kind != Parameter && m_frames[m_depth - 1].kind != Matrix))
+            throw std::runtime_error("Attempt to end the contents of an element that has not been begun");
+    }
+
+    LIBEMBER_INLINE
+    void GlowWriter::identifier(std::string const& identifier)
+    {
+        contents();
+        property(GlowTags::NodeContents::Identifier(), identifier);
+    }
+
+    LIBEMBER_INLINE
+    void GlowWriter::description(std::string const& description)
+    {
+        contents();
+        property(GlowTags::NodeContents::Description(), description);
+    }
+
+    LIBEMBER_INLINE
+    void GlowWriter::isOnline(bool isOnline)
+    {
+        FrameKind const kind = contents();
+        if (kind == Node)
+            property(GlowTags::NodeContents::IsOnline(), isOnline);
+        else if (kind == Parameter)
+            property(GlowTags::ParameterContents::IsOnline(), isOnline);
+        else
+            throw std::runtime_error("The online state can only be written to a node or a parameter");
+    }
+
+    LIBEMBER_INLINE
+    void GlowWriter::value(long value)
+    {
+        contents(Parameter);
+        property(GlowTags::ParameterContents::Value(), value);
+    }
+
+    LIBEMBER_INLINE
+    void GlowWriter::value(double value)
+    {
+        contents(Parameter);
+        property(GlowTags::ParameterContents::Value(), value);
+    }
+
+    LIBEMBER_INLINE
+    void GlowWriter::value(std::string const& value)
+    {
+        contents(Parameter);
+        property(GlowTags::ParameterContents::Value(), value);
+    }
+
+    LIBEMBER_INLINE
+    void GlowWriter::value(bool value)
+    {
+        contents(Parameter);
+        property(GlowTags::ParameterContents::Value(), value);
+    }
+
+    LIBEMBER_INLINE
+    void GlowWriter::minimum(long minimum)
+    {
+        contents(Parameter);
+        property(GlowTags::ParameterContents::Minimum(), minimum);
+    }
+
+    LIBEMBER_INLINE
+    void GlowWriter::minimum(double minimum)
+    {
+        contents(Parameter);
+        property(GlowTags::ParameterContents::Minimum(), minimum);
+    }
+
+    LIBEMBER_INLINE
+    void GlowWriter::maximum(long maximum)
+    {
+        contents(Parameter);
+        property(GlowTags::ParameterContents::Maximum(), maximum);
+    }
+
+    LIBEMBER_INLINE
+    void GlowWriter::maximum(double maximum)
+    {
+        contents(Parameter);
+        property(GlowTags::ParameterContents::Maximum(), maximum);
+    }
+
+    LIBEMBER_INLINE
+    void GlowWriter::access(Access const& access)
+    {
+        contents(Parameter);
+        property(GlowTags::ParameterContents::Access(), static_cast<int>(access.value()));
+    }
+
+    LIBEMBER_INLINE
+    void GlowWriter::type(ParameterType const& type)
+    {
+        contents(Parameter);
+        property(GlowTags::ParameterContents::Type(), static_cast<int>(type.value()));
+    }
+
+    LIBEMBER_INLINE
+    void GlowWriter::type(MatrixType const& type)
+    {
+        contents(Matrix);
+        property(GlowTags::MatrixContents::Type(), static_cast<int>(type.value()));
+    }
+
+    LIBEMBER_INLINE
+    void GlowWriter::addressingMode(MatrixAddressingMode const& addressingMode)
+    {
+        contents(Matrix);
+        property(GlowTags::MatrixContents::AddressingMode(), static_cast<int>(addressingMode.value()));
+    }
+
+    LIBEMBER_INLINE
+    void GlowWriter::targetCount(int targetCount)
+    {
+        contents(Matrix);
+        property(GlowTags::MatrixContents::TargetCount(), targetCount);
+    }
+
+    LIBEMBER_INLINE
+    void GlowWriter::sourceCount(int sourceCount)
+    {
+        contents(Matrix);
+        property(GlowTags::MatrixContents::SourceCount(), sourceCount);
+    }
+
+    LIBEMBER_INLINE
+    void GlowWriter::parametersLocation(ber::ObjectIdentifier const& basePath)
+    {
+        contents(Matrix);
+        property(GlowTags::MatrixContents::ParametersLocation(), basePath);
+    }
+
+    LIBEMBER_INLINE
+    void GlowWriter::parametersLocation(int inlineSubid)
+    {
+        contents(Matrix);
+        property(GlowTags::MatrixContents::ParametersLocation(), inlineSubid);
+    }
+
+    LIBEMBER_INLINE
+    void GlowWriter::gainParameterNumber(int gainParameterNumber)
+    {
+        contents(Matrix);
+        property(GlowTags::MatrixContents::GainParameterNumber(), gainParameterNumber);
+    }
+
+    LIBEMBER_INLINE
+    void GlowWriter::beginLabels()
+    {
+        contents(Matrix);
+        open(GlowTags::MatrixContents::Labels(), ber::make_tag(ber::Class::Universal, ber::Type::Sequence), Labels);
+    }
+
+    LIBEMBER_INLINE
+    void GlowWriter::label(ber::ObjectIdentifier const& basePath, std::string const& description)
+    {
+        openItem(GlowType(GlowType::Label).toTypeTag(), Labels);
+        property(GlowTags::Label::BasePath(), basePath);
+        property(GlowTags::Label::Description(), description);
+        close(Item);
+    }
+
+    LIBEMBER_INLINE
+    void GlowWriter::endLabels()
+    {
+        close(Labels);
+    }
+
+    LIBEMBER_INLINE
+    void GlowWriter::beginTargets()
+    {
+        openSequence(GlowTags::Matrix::Targets(), Targets);
+    }
+
+    LIBEMBER_INLINE
+    void GlowWriter::target(int number)
+    {
+        openItem(GlowType(GlowType::Target).toTypeTag(), Targets);
+        property(GlowTags::Signal::Number(), number);
+        close(Item);
+    }
+
+    LIBEMBER_INLINE
+    void GlowWriter::endTargets()
+    {
+        close(Targets);
+    }
+
+    LIBEMBER_INLINE
+    void GlowWriter::beginSources()
+    {
+        openSequence(GlowTags::Matrix::Sources(), Sources);
+    }
+
+    LIBEMBER_INLINE
+    void GlowWriter::source(int number)
+    {
+        openItem(GlowType(GlowType::Source).toTypeTag(), Sources);
+        property(GlowTags::Signal::Number(), number);
+        close(Item);
+    }
+
+    LIBEMBER_INLINE
+    void GlowWriter::endSources()
+    {
+        close(Sources);
+    }
+
+    LIBEMBER_INLINE
+    void GlowWriter::beginConnections()
+    {
+        openSequence(GlowTags::Matrix::Connections(), Connections);
+    }
+
+    LIBEMBER_INLINE
+    void GlowWriter::connection(int target)
+    {
+        openItem(GlowType(GlowType::Connection).toTypeTag(), Connections);
+        property(GlowTags::Connection::Target(), target);
+        close(Item);
+    }
+
+    LIBEMBER_INLINE
+    void GlowWriter::connection(int target, ber::ObjectIdentifier const& sources)
+    {
+        openItem(GlowType(GlowType::Connection).toTypeTag(), Connections);
+        property(GlowTags::Connection::Target(), target);
+        property(GlowTags::Connection::Sources(), sources);
+        close(Item);
+    }
+
+    LIBEMBER_INLINE
+    void GlowWriter::endConnections()
+    {
+        close(Connections);
+    }
+
+    LIBEMBER_INLINE
+    void GlowWriter::encoded(const_iterator first, const_iterator last)
+    {
+        seal();
+        m_buffer.insert(m_buffer.end(), first, last);
+    }
+
+    LIBEMBER_INLINE
+    GlowWriter::const_iterator GlowWriter::begin() const
+    {
+        return m_buffer.empty() ? 0 : &m_buffer[0];
+    }
+
+    LIBEMBER_INLINE
+    GlowWriter::const_iterator GlowWriter::end() const
+    {
+        return m_buffer.empty() ? 0 : &m_buffer[0] + m_buffer.size();
+    }
+
+    LIBEMBER_INLINE
+    GlowWriter::size_type GlowWriter::size() const
+    {
+        return m_buffer.size();
+    }
+
+    LIBEMBER_INLINE
+    void GlowWriter::open(ber::Tag const& tag, ber::Tag const& type, FrameKind kind)
+    {
+        if (m_depth == MaximumDepth)
+            throw std::runtime_error("Maximum nesting depth of the writer exceeded");
+
+        Frame& frame = m_frames[m_depth++];
+        frame.kind = kind;
+        frame.isSealed = false;
+
+        writeTag(tag.toContainer());
+        frame.outerLength = m_buffer.size();
+        m_buffer.push_back(0);
+
+        writeTag(type.toContainer());
+        frame.innerLength = m_buffer.size();
+        m_buffer.push_back(0);
+    }
+
+    LIBEMBER_INLINE
+    void GlowWriter::close(FrameKind kind)
+    {
+        if (m_depth == 0 || m_frames[m_depth - 1].kind != kind)
+            throw std::runtime_error("Attempt to end an element that has not been begun");
+
+        // the inner length follows the outer one, so filling it in does not move the outer one
+        Frame const& frame = m_frames[--m_depth];
+        writeLength(frame.innerLength);
+        writeLength(frame.outerLength);
+    }
+
+    LIBEMBER_INLINE
+    void GlowWriter::openElement(ber::Tag const& type, FrameKind kind)
+    {
+        if (m_depth == 0 || m_frames[m_depth - 1].kind != Collection)
+            throw std::runtime_error("Elements can only be written to a collection");
+
+        open(GlowTags::ElementDefault(), type, kind);
+    }
+
+    LIBEMBER_INLINE
+    void GlowWriter::closeContents()
+    {
+        if (m_depth > 0 && m_frames[m_depth - 1].kind == Contents)
+            close(Contents);
+    }
+
+    LIBEMBER_INLINE
+    void GlowWriter::seal()
+    {
+        closeContents();
+        if (m_depth > 0)
+            m_frames[m_depth - 1].isSealed = true;
+    }
+
+    LIBEMBER_INLINE
+    void GlowWriter::closeElement(FrameKind kind)
+    {
+        closeContents();
+        close(kind);
+    }
+
+    LIBEMBER_INLINE
+    GlowWriter::FrameKind GlowWriter::contents()
+    {
+        if (m_depth > 0 && m_frames[m_depth - 1].kind == Contents)
+            return m_frames[m_depth - 2].kind;
+
+        FrameKind const kind = m_depth > 0 ? m_frames[m_depth - 1].kind : Collection;
+        if ((kind != Node && kind != Parameter && kind != Matrix) || m_frames[m_depth - 1].isSealed)
+            throw std::runtime_error("Properties can only be written to an element before its children");
+
+        // all elements use the same tag for their contents
+        open(GlowTags::Node::Contents(), ber::make_tag(ber::Class::Universal, ber::Type::Set), Contents);
+        return kind;
+    }
+
+    LIBEMBER_INLINE
+    void GlowWriter::contents(FrameKind kind)
+    {
+        if (contents() != kind)
+            throw std::runtime_error("The property does not belong to the current element");
+    }
+
+    LIBEMBER_INLINE
+    void GlowWriter::openSequence(ber::Tag const& tag, FrameKind kind)
+    {
+        seal();
+        if (m_depth == 0 || m_frames[m_depth - 1].kind != Matrix)
+            throw std::runtime_error("Signals and connections can only be written to a matrix");
+
+        open(tag, ber::make_tag(ber::Class::Universal, ber::Type::Sequence), kind);
+    }
+
+    LIBEMBER_INLINE
+    void GlowWriter::openItem(ber::Tag const& type, FrameKind kind)
+    {
+        if (m_depth == 0 || m_frames[m_depth - 1].kind != kind)
+            throw std::runtime_error("Attempt to write to a sequence that has not been begun");
+
+        open(GlowTags::ElementDefault(), type, Item);
+    }
+
+    LIBEMBER_INLINE
+    void GlowWriter::writeTag(ber::Tag const& tag)
+    {
+        m_scratch.clear();
+        ber::encode(m_scratch, tag);
+        m_buffer.insert(m_buffer.end(), m_scratch.begin(), m_scratch.end());
+    }
+
+    LIBEMBER_INLINE
+    void GlowWriter::writeLength(size_type offset)
+    {
+        size_type const length = m_buffer.size() - offset - 1;
+        if (length < 0x80)
+        {
+            m_buffer[offset] = static_cast<value_type>(length);
+        }
+        else
+        {
+            // the length octets are encoded like a signed integer, just as
+            // ber::Length does, so the output matches the dom encoding
+            size_type const count = ber::encodedLength(static_cast<int>(length));
+            size_type rest = length;
+
+            m_buffer.insert(m_buffer.begin() + offset + 1, count, 0);
+            m_buffer[offset] = static_cast<value_type>(0x80 | count);
+            for (size_type index = offset + count; index > offset; --index, rest >>= 8)
+            {
+                m_buffer[index] = static_cast<value_type>(rest & 0xFF);
+            }
+        }
+    }
+}
+}
+
+#endif  // __LIBEMBER_GLOW_IMPL_GLOWWRITER_IPP
@@ -21,20 +21,53 @@
 #define __LIBEMBER_GLOW_UTIL_COMPLIESWITHSCHEMA_HPP
 
 #include <string>
+#include "../../ber/Value.hpp"
 
 namespace libember { namespace glow { namespace util
 {
     /**
      * Tests whether the string containing a collection of schema identifiers contains
-     * a specified schema.
+     * a specified schema. The identifiers in the collection are separated with the line
+     * feed character, so an identifier only matches a complete entry of the collection
+     * and not a part of a longer identifier. An empty identifier or one containing a
+     * line feed never matches.
      * @param schemaIdentifiers A string containing a collection of schema identifiers.
      * @param schemaIdentifier The schema identifier to find.
-     * @return true, if the schema identifier is part of the collection. Otherwise, this
-     *      method returns false.
+     * @return true, if the schema identifier is an entry of the collection. Otherwise,
+     *      this method returns false.
      */
     inline bool complies_with_schema(std::string const& schemaIdentifiers, std::string const& schemaIdentifier)
     {
-        return schemaIdentifiers.find(schemaIdentifier) != std::string::npos;
+        std::string::size_type const length = schemaIdentifier.size();
+        if (length == 0 || schemaIdentifier.find('\n') != std::string::npos)
+            return false;
+
+        for (std::string::size_type position = schemaIdentifiers.find(schemaIdentifier);
+             position != std::string::npos;
+             position = schemaIdentifiers.find(schemaIdentifier, position + 1))
+        {
+            std::string::size_type const end = position + length;
+            if ((position == 0 || schemaIdentifiers[position - 1] == '\n')
+             && (end == schemaIdentifiers.size() || schemaIdentifiers[end] == '\n'))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * Tests whether the value of a schema identifiers property contains a specified
+     * schema. The string is accessed in place, so the identifiers are not copied.
+     * @param schemaIdentifiers The value of the schema identifiers property.
+     * @param schemaIdentifier The schema identifier to find.
+     * @return true, if the value is a string and the schema identifier is part of the
+     *      collection it contains. Otherwise, this method returns false.
+     */
+    inline bool complies_with_schema(ber::Value const& schemaIdentifiers, std::string const& schemaIdentifier)
+    {
+        std::string const* const identifiers = schemaIdentifiers.peek<std::string>();
+        return identifiers != 0 && complies_with_schema(*identifiers, schemaIdentifier);
     }
 }
 }
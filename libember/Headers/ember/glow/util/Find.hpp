@@ -21,7 +21,7 @@
 #define __LIBEMBER_GLOW_UTIL_FIND_HPP
 
 #include <algorithm>
-#include "../../dom/Container.hpp"
+#include "../../dom/detail/ListContainer.hpp"
 
 namespace libember { namespace glow { namespace util
 {
@@ -88,36 +88,62 @@ namespace libember { namespace glow { namespace util
         };
 
         /**
-         * Specialization for the default const_iterator of a dom::Container class.
+         * Traits for the concrete child iterators of the dom::detail::ListContainer class.
          */
-        template<>
-        struct Find<dom::Container::const_iterator>
+        template<typename ChildIterator>
+        struct FindChild
         {
-            typedef dom::Container::const_iterator iterator;
+            typedef ChildIterator iterator;
 
             /**
              * Searches for a node with the passed application tag.
-             * @param first The reference to the first node pointer in the collection.
+             * @param first The reference to the first node in the collection.
              * @param last A reference to the first element beyond the node collection.
              * @param tag The tag to look for.
              * @return Returns last if no node with the specified application tag has been found.
              *      Otherwise, this method returns an iterator that points to the node with the 
              *      requested tag.
              */
-            static iterator execute(iterator const& first, iterator const& last, ber::Tag const& tag)
+            static iterator execute(iterator first, iterator const& last, ber::Tag const& tag)
             {
-                iterator const result = std::find_if(first, last, detail::NodeApplicationTagEquals(tag));
-                return result;
+                for ( ; first != last; ++first)
+                {
+                    if (first->applicationTag() == tag)
+                    {
+                        break;
+                    }
+                }
+                return first;
             }
         };
 
         /**
-         * Specialization for the default iterator of a dom::Container class.
+         * Specialization for the concrete child iterator of a dom::detail::ListContainer.
          */
         template<>
-        struct Find<dom::Container::iterator>
+        struct Find<dom::detail::ListContainer::child_iterator>
+            : FindChild<dom::detail::ListContainer::child_iterator>
+        {};
+
+        /**
+         * Specialization for the concrete child const_iterator of a dom::detail::ListContainer.
+         */
+        template<>
+        struct Find<dom::detail::ListContainer::const_child_iterator>
+            : FindChild<dom::detail::ListContainer::const_child_iterator>
+        {};
+
+        /**
+         * Traits for the type erased iterators of the dom::Container class. If
+         * they refer to the children of a dom::detail::ListContainer, which is
+         * true for all containers of the Glow DTD, the children are searched
+         * with the concrete iterators, which avoids a virtual call and a copy of
+         * the type erased iterator per child.
+         */
+        template<typename ErasedIterator, typename ChildIterator>
+        struct FindTypeErased
         {
-            typedef dom::Container::iterator iterator;
+            typedef ErasedIterator iterator;
 
             /**
              * Searches for a node with the passed application tag.
@@ -130,10 +156,33 @@ namespace libember { namespace glow { namespace util
              */
             static iterator execute(iterator const& first, iterator const& last, ber::Tag const& tag)
             {
+                if (first.template is<ChildIterator>() && last.template is<ChildIterator>())
+                {
+                    ChildIterator const end = last.template as<ChildIterator>();
+                    ChildIterator const result = FindChild<ChildIterator>::execute(first.template as<ChildIterator>(), end, tag);
+                    return (result != end) ? iterator(result) : last;
+                }
+
                 iterator const result = std::find_if(first, last, detail::NodeApplicationTagEquals(tag));
                 return result;
             }
         };
+
+        /**
+         * Specialization for the default const_iterator of a dom::Container class.
+         */
+        template<>
+        struct Find<dom::Container::const_iterator>
+            : FindTypeErased<dom::Container::const_iterator, dom::detail::ListContainer::const_child_iterator>
+        {};
+
+        /**
+         * Specialization for the default iterator of a dom::Container class.
+         */
+        template<>
+        struct Find<dom::Container::iterator>
+            : FindTypeErased<dom::Container::iterator, dom::detail::ListContainer::child_iterator>
+        {};
     }
 
     /**
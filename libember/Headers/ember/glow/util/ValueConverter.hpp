@@ -21,6 +21,7 @@
 #define __LIBEMBER_GLOW_UTIL_VALUECONVERTER_HPP
 
 #include "../../ber/Encoding.hpp"
+#include "../../dom/StaticLeaf.hpp"
 #include "../../dom/VariantLeaf.hpp"
 #include "../traits/ValueTypeToBerType.hpp"
 #include "traits/ValueConverterTraits.hpp"
@@ -55,6 +56,28 @@ namespace libember { namespace glow { namespace util
                 return default_;
             }
 
+            /**
+             * Tries to cast the passed ber value to the specified value type.
+             * @param value The ber value to read the value from.
+             * @param result Receives the concrete value if the conversion succeeds,
+             *      remains unchanged otherwise.
+             * @return true if @p value is set and of the specified type.
+             */
+            template<typename ValueType>
+            static bool tryValueOf(ber::Value const& value, ValueType& result)
+            {
+                if (value)
+                {
+                    ber::Type const type = glow::traits::ValueTypeToBerType<ValueType>::berType();
+                    if (value.universalTag().number() == type.value())
+                    {
+                        result = ValueConverterTraits<ValueType>::valueOf(value, result);
+                        return true;
+                    }
+                }
+                return false;
+            }
+
             /**
              * Tries to extract the provided leaf's value and returns it.
              * @param leaf The leaf to get the value from.
@@ -77,7 +100,11 @@ namespace libember { namespace glow { namespace util
             }
 
             /**
-             * Tries to convert the passed node to a dom::VariantLeaf and extract its value.
+             * Tries to convert the passed node to a dom::StaticLeaf of the specified value type
+             * or to a dom::VariantLeaf and extract its value. The glow elements store their
+             * numbers in statically typed leaves, decoded elements use variant leaves.
+             * An integer number may be read as any integral type, like the value of a
+             * variant leaf.
              * @param node The node to get the value from.
              * @param default_ The default value to return when the conversion fails or the leaf is null.
              * @return Returns the extracted value on success or the passed default value if an error occurred.
@@ -85,16 +112,33 @@ namespace libember { namespace glow { namespace util
             template<typename ValueType>
             static ValueType valueOf(dom::Node const* node, ValueType const& default_)
             {
+                dom::StaticLeaf<ValueType> const* const typed = dynamic_cast<dom::StaticLeaf<ValueType> const*>(node);
+                if (typed != 0)
+                {
+                    return typed->value();
+                }
+
+                dom::StaticLeaf<int> const* const number = dynamic_cast<dom::StaticLeaf<int> const*>(node);
+                if (number != 0)
+                {
+                    return valueOf(ber::Value(number->value()), default_);
+                }
                 return valueOf(dynamic_cast<dom::VariantLeaf const*>(node), default_);
             }
 
             /**
-             * Tries to cast the node to a VariantLeaf and returns its value.
+             * Tries to cast the node to a VariantLeaf or to the integer StaticLeaf used for
+             * element numbers and returns its value.
              * @param node The node to get the type erased value from.
              * @return The type erased value of the specified node.
              */
             static ber::Value valueOf(dom::Node const* node)
             {
+                dom::StaticLeaf<int> const* const typed = dynamic_cast<dom::StaticLeaf<int> const*>(node);
+                if (typed != 0)
+                {
+                    return ber::Value(typed->value());
+                }
                 return valueOf(dynamic_cast<dom::VariantLeaf const*>(node));
             }
 
@@ -1,6 +1,8 @@
 #ifndef __LIBEMBER_GLOW_UTIL_TRAITS_VALUECONVERTERTRAITS_HPP
 #define __LIBEMBER_GLOW_UTIL_TRAITS_VALUECONVERTERTRAITS_HPP
 
+#include "../../../ber/Octets.hpp"
+#include "../../../ber/OctetsView.hpp"
 #include "../../../ber/Value.hpp"
 
 //SimianIgnore
@@ -147,6 +149,29 @@ namespace libember { namespace glow { namespace util
             return default_;
         }
     };
+
+    /**
+     * This specialization also accepts leaves that refer to an octet string
+     * through a ber::OctetsView and copies the referenced bytes.
+     */
+    template<>
+    struct ValueConverterTraits<ber::Octets>
+    {
+        typedef ber::Octets value_type;
+
+        static value_type valueOf(ber::Value const& value, value_type const& default_)
+        {
+            if (value.typeId() == typeid(ber::Octets))
+            {
+                return value.as<ber::Octets>();
+            }
+            else if (value.typeId() == typeid(ber::OctetsView))
+            {
+                return value.as<ber::OctetsView>().retain();
+            }
+            return default_;
+        }
+    };
 }
 }
 }
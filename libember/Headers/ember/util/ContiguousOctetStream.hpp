@@ -0,0 +1,151 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef __LIBEMBER_UTIL_CONTIGUOUSOCTETSTREAM_HPP
+#define __LIBEMBER_UTIL_CONTIGUOUSOCTETSTREAM_HPP
+
+#include <vector>
+#include "OctetStream.hpp"
+
+namespace libember { namespace util
+{
+    /**
+     * An OctetStream that collects all encoded bytes in a single contiguous, reservable
+     * buffer, so that a complete message can be passed to a socket or to the S101
+     * encoder as one span instead of being copied byte by byte through the chunk
+     * iterators. Encoders write to it through the regular OctetStream interface, the
+     * chunks are moved to the contiguous buffer in bulk whenever the stream flushes.
+     * @note This stream is intended to be used as encoder output. The encoded bytes
+     *      must be accessed through data() and size(), because begin() and end()
+     *      of the OctetStream base class only cover the bytes not yet flushed.
+     */
+    class ContiguousOctetStream : public OctetStream
+    {
+        public:
+            /**
+             * Initializes an empty stream.
+             * @param capacity The number of bytes to reserve for the contiguous buffer.
+             */
+            explicit ContiguousOctetStream(size_type capacity = 0);
+
+            /**
+             * Reserves storage for at least @p capacity bytes.
+             * @param capacity The number of bytes to reserve.
+             */
+            void reserve(size_type capacity);
+
+            /**
+             * Returns a pointer to the first encoded byte. The pointer remains valid
+             * until the stream is modified.
+             * @return A pointer to the first encoded byte or null if the stream is empty.
+             */
+            const_pointer data();
+
+            /**
+             * Returns the total number of bytes written to this stream.
+             * @return The total number of bytes written to this stream.
+             */
+            size_type size() const;
+
+            /**
+             * Removes all bytes from this stream, the reserved storage is kept.
+             */
+            void clear();
+
+        protected:
+            /**
+             * Moves the bytes currently buffered in the chunks of the base class to the
+             * contiguous buffer.
+             * @see OctetStream::flush()
+             */
+            virtual void flush(iterator first, iterator last);
+
+        private:
+            /**
+             * Appends the content of the chunks of the base class to the contiguous buffer.
+             */
+            void moveChunks();
+
+        private:
+            enum
+            {
+                /** Number of bytes buffered in chunks before they are moved in bulk. */
+                FlushThreshold = 4096
+            };
+
+        private:
+            std::vector<value_type> m_data;
+    };
+
+
+
+    /**************************************************************************/
+    /* Mandatory inline implementation                                        */
+    /**************************************************************************/
+
+    inline ContiguousOctetStream::ContiguousOctetStream(size_type capacity)
+        : OctetStream(FlushThreshold)
+        , m_data()
+    {
+        m_data.reserve(capacity);
+    }
+
+    inline void ContiguousOctetStream::reserve(size_type capacity)
+    {
+        m_data.reserve(capacity);
+    }
+
+    inline ContiguousOctetStream::const_pointer ContiguousOctetStream::data()
+    {
+        moveChunks();
+        OctetStream::clear();
+        return m_data.empty() ? 0 : &m_data[0];
+    }
+
+    inline ContiguousOctetStream::size_type ContiguousOctetStream::size() const
+    {
+        return m_data.size() + OctetStream::size();
+    }
+
+    inline void ContiguousOctetStream::clear()
+    {
+        m_data.clear();
+        OctetStream::clear();
+    }
+
+    inline void ContiguousOctetStream::flush(iterator, iterator)
+    {
+        moveChunks();
+    }
+
+    inline void ContiguousOctetStream::moveChunks()
+    {
+        size_type const offset = m_data.size();
+        size_type const pending = OctetStream::size();
+        if (pending > 0)
+        {
+            m_data.resize(offset + pending);
+            OctetStream::copy(&m_data[offset]);
+        }
+    }
+}
+}
+
+#endif  // __LIBEMBER_UTIL_CONTIGUOUSOCTETSTREAM_HPP
+
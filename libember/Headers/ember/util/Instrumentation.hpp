@@ -0,0 +1,211 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef __LIBEMBER_UTIL_INSTRUMENTATION_HPP
+#define __LIBEMBER_UTIL_INSTRUMENTATION_HPP
+
+#include <cstddef>
+#include <iosfwd>
+#include "Api.hpp"
+
+namespace libember { namespace util
+{
+    /**
+     * Counters of the allocations performed by the library and of the number of live
+     * objects of the most frequently created types.
+     * The counters are only updated if LIBEMBER_INSTRUMENTATION is defined, otherwise
+     * all instrumentation points compile to nothing and the counters remain zero.
+     * Since several instrumentation points are located in templates and inline
+     * functions, the macro should be defined when building the library as well as
+     * when building the code that uses it.
+     * The counters are updated atomically, so they may be read at any time, for example
+     * by a provider that periodically exports them to a monitoring system.
+     * @note The counters are shared by all threads, so every counted allocation
+     *      writes to the same cache lines. Builds that decode on many threads at
+     *      once should therefore leave LIBEMBER_INSTRUMENTATION undefined.
+     */
+    class LIBEMBER_API Instrumentation
+    {
+        public:
+            /**
+             * Enumeration of the counted allocation sites and object types.
+             */
+            enum Category
+            {
+                /** The storage of all dom nodes, as requested from their NodeAllocator. */
+                NodeStorage,
+
+                /** The chunks of all StreamBuffers, including the OctetStreams. */
+                StreamBufferChunk,
+
+                /** The heap storage of SmallVectors that exceed their inline capacity, e.g. long ObjectIdentifiers. */
+                SmallVectorStorage,
+
+                /** Live instances of dom::VariantLeaf, including the glow leaves. */
+                VariantLeaf,
+
+                /** Live instances of glow::GlowNode. */
+                GlowNode,
+
+                /** Live instances of glow::GlowQualifiedNode. */
+                GlowQualifiedNode,
+
+                /** Live instances of glow::GlowParameter. */
+                GlowParameter,
+
+                /** Live instances of glow::GlowQualifiedParameter. */
+                GlowQualifiedParameter,
+
+                /** Live instances of glow::GlowStreamEntry. */
+                GlowStreamEntry,
+
+                CategoryCount
+            };
+
+            /**
+             * A snapshot of the counters of a single category.
+             */
+            struct Counter
+            {
+                /** The total number of allocations or constructed objects. */
+                unsigned long allocations;
+
+                /** The total number of bytes allocated. */
+                unsigned long bytes;
+
+                /** The number of allocations or objects that are currently alive. */
+                long live;
+
+                /** The number of bytes that are currently allocated. */
+                long liveBytes;
+            };
+
+        public:
+            /**
+             * Returns whether the library has been built with LIBEMBER_INSTRUMENTATION.
+             * @return True if the counters are updated, otherwise false.
+             */
+            static bool enabled();
+
+            /**
+             * Returns the name of a category.
+             * @param category The category whose name to return.
+             * @return The name of the category.
+             */
+            static char const* name(Category category);
+
+            /**
+             * Returns a snapshot of the counters of a category.
+             * @param category The category whose counters to return.
+             * @return The current values of the counters.
+             */
+            static Counter counter(Category category);
+
+            /**
+             * Resets the total number of allocations and bytes of all categories. The
+             * live counters are not affected.
+             */
+            static void reset();
+
+            /**
+             * Writes the counters of all categories in a human readable form, one
+             * category per line.
+             * @param stream The stream to write to.
+             */
+            static void dump(std::ostream& stream);
+
+            /**
+             * Records an allocation or the construction of an object.
+             * @param category The category of the allocation.
+             * @param bytes The number of bytes allocated.
+             */
+            static void allocated(Category category, std::size_t bytes);
+
+            /**
+             * Records a deallocation or the destruction of an object.
+             * @param category The category of the deallocation.
+             * @param bytes The number of bytes released.
+             */
+            static void released(Category category, std::size_t bytes);
+    };
+
+
+    /**
+     * Base class that counts the live instances of the classes deriving from it. It
+     * does not have any members and does not increase the size of the derived class.
+     * @param C The category to record the instances in.
+     */
+    template<Instrumentation::Category C>
+    class InstanceCounter
+    {
+        protected:
+            /** Records a new instance. */
+            InstanceCounter();
+
+            /** Records a new instance that is a copy of another one. */
+            InstanceCounter(InstanceCounter const&);
+
+            /** Records the destruction of an instance. */
+            ~InstanceCounter();
+
+            /** Assigning instances does not change their number. */
+            InstanceCounter& operator=(InstanceCounter const&);
+    };
+
+    /**************************************************************************
+     * Mandatory inline implementation                                        *
+     **************************************************************************/
+
+    template<Instrumentation::Category C>
+    inline InstanceCounter<C>::InstanceCounter()
+    {
+#ifdef LIBEMBER_INSTRUMENTATION
+        Instrumentation::allocated(C, 0);
+#endif
+    }
+
+    template<Instrumentation::Category C>
+    inline InstanceCounter<C>::InstanceCounter(InstanceCounter const&)
+    {
+#ifdef LIBEMBER_INSTRUMENTATION
+        Instrumentation::allocated(C, 0);
+#endif
+    }
+
+    template<Instrumentation::Category C>
+    inline InstanceCounter<C>::~InstanceCounter()
+    {
+#ifdef LIBEMBER_INSTRUMENTATION
+        Instrumentation::released(C, 0);
+#endif
+    }
+
+    template<Instrumentation::Category C>
+    inline InstanceCounter<C>& InstanceCounter<C>::operator=(InstanceCounter const&)
+    {
+        return *this;
+    }
+}
+}
+
+#ifdef LIBEMBER_HEADER_ONLY
+#  include "impl/Instrumentation.ipp"
+#endif
+
+#endif  // __LIBEMBER_UTIL_INSTRUMENTATION_HPP
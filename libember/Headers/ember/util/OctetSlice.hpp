@@ -0,0 +1,382 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef __LIBEMBER_UTIL_OCTETSLICE_HPP
+#define __LIBEMBER_UTIL_OCTETSLICE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <vector>
+
+namespace libember { namespace util
+{
+    /** Forward declaration. */
+    class OctetSliceBuffer;
+
+    /**
+     * An immutable view onto a range of bytes stored in a reference-counted block
+     * that is shared with other slices. Copying a slice never copies the referenced
+     * bytes, the block is released when the last slice referring to it is destroyed.
+     * Slices are created by an OctetSliceBuffer.
+     */
+    class OctetSlice
+    {
+        friend class OctetSliceBuffer;
+
+        public:
+            typedef unsigned char       value_type;
+            typedef std::size_t         size_type;
+            typedef value_type const*   const_iterator;
+
+        public:
+            /** Default constructor. Initializes an empty slice. */
+            OctetSlice();
+
+            /**
+             * Copy constructor. The new instance refers to the same bytes as @p other.
+             * @param other The slice to copy.
+             */
+            OctetSlice(OctetSlice const& other);
+
+            /** Destructor. Releases the reference to the shared block. */
+            ~OctetSlice();
+
+            /**
+             * Assignment operator. Makes this instance refer to the same bytes as @p other.
+             * @param other The slice to copy.
+             * @return A reference to this instance.
+             */
+            OctetSlice& operator=(OctetSlice other);
+
+            /**
+             * Exchanges the contents of this slice with those of @p other. This operation
+             * is guaranteed not to throw an exception.
+             * @param other The slice to swap the contents with.
+             */
+            void swap(OctetSlice& other);
+
+            /**
+             * Returns whether or not this slice is empty.
+             * @return True if the slice does not refer to any bytes.
+             */
+            bool empty() const;
+
+            /**
+             * Returns the number of bytes this slice refers to.
+             * @return The number of bytes this slice refers to.
+             */
+            size_type size() const;
+
+            /**
+             * Returns a pointer to the first byte of this slice.
+             * @return A pointer to the first byte of this slice.
+             */
+            const_iterator begin() const;
+
+            /**
+             * Returns a pointer to the byte one past the last byte of this slice.
+             * @return A pointer to the byte one past the last byte of this slice.
+             */
+            const_iterator end() const;
+
+        private:
+            /**
+             * The reference-counted storage area shared by several slices.
+             */
+            class Block
+            {
+                public:
+                    /**
+                     * Initializes a new block that is able to store @p capacity bytes
+                     * and has a reference count of one.
+                     * @param capacity The number of bytes to reserve.
+                     */
+                    explicit Block(size_type capacity);
+
+                    /**
+                     * Increments the reference count of this block by one.
+                     * @return The this pointer.
+                     */
+                    Block* addRef();
+
+                    /**
+                     * Decrements the reference count of this block by one. If the
+                     * reference count reaches zero, the block deletes itself.
+                     */
+                    void releaseRef();
+
+                    /**
+                     * Returns the number of bytes that may still be appended without
+                     * exceeding the reserved capacity.
+                     * @return The number of bytes that may still be appended.
+                     */
+                    size_type available() const;
+
+                    /**
+                     * Appends the bytes referred to by @p first and @p last.
+                     * @param first An iterator referring to the first byte to append.
+                     * @param last An iterator referring to the byte one past the last
+                     *      byte to append.
+                     * @return The offset of the first appended byte.
+                     */
+                    template<typename InputIterator>
+                    size_type append(InputIterator first, InputIterator last);
+
+                    /**
+                     * Returns a pointer to the byte at the offset @p offset.
+                     * @param offset The offset of the byte to return.
+                     * @return A pointer to the byte at the specified offset.
+                     */
+                    value_type const* at(size_type offset) const;
+
+                private:
+                    /** Private, unimplemented copy constructor. */
+                    Block(Block const&);
+
+                    /** Private, unimplemented assignment operator. */
+                    Block& operator=(Block const&);
+
+                private:
+                    std::vector<value_type> m_data;
+                    unsigned long m_refCount;
+            };
+
+            /**
+             * Initializes a slice referring to @p size bytes at @p offset within @p block.
+             * @param block The block containing the bytes. The reference count of this
+             *      block is incremented.
+             * @param offset The offset of the first byte within the block.
+             * @param size The number of bytes.
+             */
+            OctetSlice(Block* block, size_type offset, size_type size);
+
+        private:
+            Block* m_block;
+            size_type m_offset;
+            size_type m_size;
+    };
+
+    /**
+     * Creates OctetSlice instances by copying byte sequences into reference-counted
+     * blocks. Consecutive sequences share the same block until it is full, so that
+     * storing many small values only requires a single allocation per block.
+     */
+    class OctetSliceBuffer
+    {
+        public:
+            typedef OctetSlice::value_type value_type;
+            typedef OctetSlice::size_type size_type;
+
+            /**
+             * Initializes a new buffer.
+             * @param blockSize The number of bytes each block is able to store. Sequences
+             *      larger than this value are stored in a block of their own.
+             */
+            explicit OctetSliceBuffer(size_type blockSize = 4096);
+
+            /** Destructor. Releases the reference to the current block. */
+            ~OctetSliceBuffer();
+
+            /**
+             * Copies @p size bytes, starting at @p first, into the current block and
+             * returns a slice referring to the copy.
+             * @param first An iterator referring to the first byte to copy.
+             * @param size The number of bytes to copy.
+             * @return A slice referring to the copied bytes.
+             */
+            template<typename InputIterator>
+            OctetSlice append(InputIterator first, size_type size);
+
+            /**
+             * Releases the reference to the current block, so that subsequent calls
+             * to append start a new block. Existing slices remain valid.
+             */
+            void reset();
+
+        private:
+            /** Private, unimplemented copy constructor. */
+            OctetSliceBuffer(OctetSliceBuffer const&);
+
+            /** Private, unimplemented assignment operator. */
+            OctetSliceBuffer& operator=(OctetSliceBuffer const&);
+
+        private:
+            OctetSlice::Block* m_block;
+            size_type m_blockSize;
+    };
+
+    /**
+     * Free version of swap to allow it's usage through ADL.
+     * @param lhs a reference to the first instance.
+     * @param rhs a reference to a second instance whose contents should be
+     *      swapped with those of @p lhs.
+     */
+    void swap(OctetSlice& lhs, OctetSlice& rhs);
+
+
+
+    /**************************************************************************/
+    /* Mandatory inline implementation                                        */
+    /**************************************************************************/
+
+    inline OctetSlice::OctetSlice()
+        : m_block(0), m_offset(0), m_size(0)
+    {}
+
+    inline OctetSlice::OctetSlice(OctetSlice const& other)
+        : m_block((other.m_block != 0) ? other.m_block->addRef() : 0)
+        , m_offset(other.m_offset)
+        , m_size(other.m_size)
+    {}
+
+    inline OctetSlice::OctetSlice(Block* block, size_type offset, size_type size)
+        : m_block(block->addRef()), m_offset(offset), m_size(size)
+    {}
+
+    inline OctetSlice::~OctetSlice()
+    {
+        if (m_block != 0)
+        {
+            m_block->releaseRef();
+        }
+    }
+
+    inline OctetSlice& OctetSlice::operator=(OctetSlice other)
+    {
+        swap(other);
+        return *this;
+    }
+
+    inline void OctetSlice::swap(OctetSlice& other)
+    {
+        using std::swap;
+        swap(m_block, other.m_block);
+        swap(m_offset, other.m_offset);
+        swap(m_size, other.m_size);
+    }
+
+    inline bool OctetSlice::empty() const
+    {
+        return m_size == 0;
+    }
+
+    inline OctetSlice::size_type OctetSlice::size() const
+    {
+        return m_size;
+    }
+
+    inline OctetSlice::const_iterator OctetSlice::begin() const
+    {
+        return (m_block != 0) ? m_block->at(m_offset) : 0;
+    }
+
+    inline OctetSlice::const_iterator OctetSlice::end() const
+    {
+        return (m_block != 0) ? m_block->at(m_offset) + m_size : 0;
+    }
+
+    inline OctetSlice::Block::Block(size_type capacity)
+        : m_data(), m_refCount(1)
+    {
+        m_data.reserve(capacity);
+    }
+
+    inline OctetSlice::Block* OctetSlice::Block::addRef()
+    {
+        m_refCount += 1;
+        return this;
+    }
+
+    inline void OctetSlice::Block::releaseRef()
+    {
+        m_refCount -= 1;
+        if (m_refCount == 0)
+        {
+            delete this;
+        }
+    }
+
+    inline OctetSlice::size_type OctetSlice::Block::available() const
+    {
+        return m_data.capacity() - m_data.size();
+    }
+
+    template<typename InputIterator>
+    inline OctetSlice::size_type OctetSlice::Block::append(InputIterator first, InputIterator last)
+    {
+        size_type const offset = m_data.size();
+        m_data.insert(m_data.end(), first, last);
+        return offset;
+    }
+
+    inline OctetSlice::value_type const* OctetSlice::Block::at(size_type offset) const
+    {
+        return &m_data[0] + offset;
+    }
+
+    inline OctetSliceBuffer::OctetSliceBuffer(size_type blockSize)
+        : m_block(0), m_blockSize(blockSize)
+    {}
+
+    inline OctetSliceBuffer::~OctetSliceBuffer()
+    {
+        reset();
+    }
+
+    template<typename InputIterator>
+    inline OctetSlice OctetSliceBuffer::append(InputIterator first, size_type size)
+    {
+        if (size == 0)
+        {
+            return OctetSlice();
+        }
+
+        if (m_block == 0 || m_block->available() < size)
+        {
+            using std::max;
+            OctetSlice::Block* const block = new OctetSlice::Block(max(size, m_blockSize));
+            reset();
+            m_block = block;
+        }
+
+        InputIterator last = first;
+        std::advance(last, size);
+
+        size_type const offset = m_block->append(first, last);
+        return OctetSlice(m_block, offset, size);
+    }
+
+    inline void OctetSliceBuffer::reset()
+    {
+        if (m_block != 0)
+        {
+            m_block->releaseRef();
+            m_block = 0;
+        }
+    }
+
+    inline void swap(OctetSlice& lhs, OctetSlice& rhs)
+    {
+        lhs.swap(rhs);
+    }
+}
+}
+
+#endif  // __LIBEMBER_UTIL_OCTETSLICE_HPP
@@ -0,0 +1,336 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef __LIBEMBER_UTIL_SEGMENTEDOCTETSTREAM_HPP
+#define __LIBEMBER_UTIL_SEGMENTEDOCTETSTREAM_HPP
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+#include "OctetStream.hpp"
+
+namespace libember { namespace util
+{
+    /**
+     * An OctetStream that moves the encoded bytes into buffers provided by the caller
+     * and exposes them as a list of segments, so that an encoded message can be passed
+     * to a gathering write like writev or WSASend without being copied into a single
+     * buffer first. Space for a header can be reserved in front of the first segment
+     * and be filled in once the size of the encoded data is known.
+     * When the provided buffers are exhausted, the stream allocates buffers of its own,
+     * so that encoding never fails for lack of space.
+     * @note Like ContiguousOctetStream, this stream is intended to be used as encoder
+     *      output. The encoded bytes must be accessed through segments(), because begin()
+     *      and end() of the OctetStream base class only cover the bytes not yet moved.
+     */
+    class SegmentedOctetStream : public OctetStream
+    {
+        public:
+            /**
+             * A contiguous range of bytes. The members are declared in the order of
+             * struct iovec, so that the segments can be passed to writev directly.
+             * WSABUF declares them in the opposite order.
+             */
+            struct Segment
+            {
+                pointer data;
+                size_type size;
+            };
+
+            typedef std::vector<Segment> SegmentVector;
+
+        public:
+            /**
+             * Initializes an empty stream without any provided buffers.
+             * @param blockSize The size of the buffers the stream allocates when all
+             *      provided buffers are exhausted.
+             */
+            explicit SegmentedOctetStream(size_type blockSize = DefaultBlockSize);
+
+            /** Destructor. Releases the buffers allocated by the stream. */
+            virtual ~SegmentedOctetStream();
+
+            /**
+             * Appends a buffer to the list of buffers the encoded bytes are moved to.
+             * The buffers are filled in the order they have been provided.
+             * @param buffer A pointer to the first byte of the buffer. The buffer must
+             *      remain valid until the stream has been cleared or destroyed.
+             * @param size The size of the buffer in bytes.
+             */
+            void provide(pointer buffer, size_type size);
+
+            /**
+             * Reserves @p size bytes in front of the encoded data, which become the
+             * first bytes of the first segment. This method must be called before
+             * any byte is written to the stream.
+             * @param size The number of bytes to reserve.
+             * @return A pointer to the reserved bytes, which are initialized to zero
+             *      and remain valid until the stream has been cleared or destroyed.
+             * @throw std::runtime_error if bytes have already been written.
+             */
+            pointer reserveHeader(size_type size);
+
+            /**
+             * Returns the segments that contain the reserved header and all bytes
+             * written to this stream, in order. Consecutive bytes within the same
+             * buffer are reported as a single segment.
+             * @return The list of segments, which remains valid until the stream is
+             *      modified.
+             */
+            SegmentVector const& segments();
+
+            /**
+             * Returns the total number of bytes written to this stream, including
+             * the reserved header.
+             * @return The total number of bytes written to this stream.
+             */
+            size_type size() const;
+
+            /**
+             * Removes all bytes and segments from this stream and forgets all provided
+             * buffers. The buffers allocated by the stream are released.
+             */
+            void clear();
+
+        protected:
+            /**
+             * Moves the bytes currently buffered in the chunks of the base class to the
+             * segments.
+             * @see OctetStream::flush()
+             */
+            virtual void flush(iterator first, iterator last);
+
+        private:
+            /**
+             * Function object that moves a single chunk of the base class to the segments.
+             */
+            class ChunkWriter
+            {
+                public:
+                    explicit ChunkWriter(SegmentedOctetStream* stream)
+                        : m_stream(stream)
+                    {}
+
+                    void operator()(const_pointer first, size_type size) const
+                    {
+                        m_stream->write(first, size);
+                    }
+
+                private:
+                    SegmentedOctetStream* m_stream;
+            };
+
+            /** Private, unimplemented copy constructor. */
+            SegmentedOctetStream(SegmentedOctetStream const&);
+
+            /** Private, unimplemented assignment operator. */
+            SegmentedOctetStream& operator=(SegmentedOctetStream const&);
+
+            /**
+             * Appends the content of the chunks of the base class to the segments.
+             */
+            void moveChunks();
+
+            /**
+             * Copies @p size bytes to the current buffer, continuing with the next
+             * buffers when the current one is full.
+             * @param first A pointer to the first byte to copy.
+             * @param size The number of bytes to copy.
+             */
+            void write(const_pointer first, size_type size);
+
+            /**
+             * Takes @p size bytes from the current buffer and appends them to the
+             * segments.
+             * @param size The number of bytes to take.
+             * @return A pointer to the first byte taken.
+             */
+            pointer advance(size_type size);
+
+            /**
+             * Makes the next provided buffer with at least @p minimum bytes the
+             * current buffer, or allocates a new one if there is none.
+             * @param minimum The minimum number of bytes the buffer must hold.
+             */
+            void nextBuffer(size_type minimum);
+
+        private:
+            enum
+            {
+                /** Number of bytes buffered in chunks before they are moved to the segments. */
+                FlushThreshold = 4096,
+
+                /** The default size of the buffers allocated by the stream. */
+                DefaultBlockSize = 4096
+            };
+
+        private:
+            SegmentVector m_buffers;
+            SegmentVector::size_type m_nextBuffer;
+            SegmentVector m_segments;
+            std::vector<pointer> m_blocks;
+            pointer m_position;
+            size_type m_available;
+            size_type m_written;
+            size_type m_blockSize;
+    };
+
+
+
+    /**************************************************************************/
+    /* Mandatory inline implementation                                        */
+    /**************************************************************************/
+
+    inline SegmentedOctetStream::SegmentedOctetStream(size_type blockSize)
+        : OctetStream(FlushThreshold)
+        , m_nextBuffer(0)
+        , m_position(0)
+        , m_available(0)
+        , m_written(0)
+        , m_blockSize(blockSize > 0 ? blockSize : static_cast<size_type>(DefaultBlockSize))
+    {}
+
+    inline SegmentedOctetStream::~SegmentedOctetStream()
+    {
+        clear();
+    }
+
+    inline void SegmentedOctetStream::provide(pointer buffer, size_type size)
+    {
+        if (size > 0)
+        {
+            Segment const segment = { buffer, size };
+            m_buffers.push_back(segment);
+        }
+    }
+
+    inline SegmentedOctetStream::pointer SegmentedOctetStream::reserveHeader(size_type size)
+    {
+        if (m_written > 0 || OctetStream::size() > 0)
+        {
+            throw std::runtime_error("The header must be reserved before any byte is written.");
+        }
+
+        if (m_available < size)
+        {
+            nextBuffer(size);
+        }
+
+        pointer const header = advance(size);
+        std::fill(header, header + size, 0);
+        return header;
+    }
+
+    inline SegmentedOctetStream::SegmentVector const& SegmentedOctetStream::segments()
+    {
+        moveChunks();
+        OctetStream::clear();
+        return m_segments;
+    }
+
+    inline SegmentedOctetStream::size_type SegmentedOctetStream::size() const
+    {
+        return m_written + OctetStream::size();
+    }
+
+    inline void SegmentedOctetStream::clear()
+    {
+        for (std::vector<pointer>::const_iterator it = m_blocks.begin(); it != m_blocks.end(); ++it)
+        {
+            delete[] *it;
+        }
+
+        m_blocks.clear();
+        m_buffers.clear();
+        m_segments.clear();
+        m_nextBuffer = 0;
+        m_position = 0;
+        m_available = 0;
+        m_written = 0;
+        OctetStream::clear();
+    }
+
+    inline void SegmentedOctetStream::flush(iterator, iterator)
+    {
+        moveChunks();
+    }
+
+    inline void SegmentedOctetStream::moveChunks()
+    {
+        OctetStream::forEachChunk(ChunkWriter(this));
+    }
+
+    inline void SegmentedOctetStream::write(const_pointer first, size_type size)
+    {
+        while (size > 0)
+        {
+            if (m_available == 0)
+            {
+                nextBuffer(1);
+            }
+
+            size_type const count = std::min(size, m_available);
+            std::copy(first, first + count, advance(count));
+            first += count;
+            size -= count;
+        }
+    }
+
+    inline SegmentedOctetStream::pointer SegmentedOctetStream::advance(size_type size)
+    {
+        pointer const result = m_position;
+        if (m_segments.empty() == false && m_segments.back().data + m_segments.back().size == result)
+        {
+            m_segments.back().size += size;
+        }
+        else
+        {
+            Segment const segment = { result, size };
+            m_segments.push_back(segment);
+        }
+
+        m_position += size;
+        m_available -= size;
+        m_written += size;
+        return result;
+    }
+
+    inline void SegmentedOctetStream::nextBuffer(size_type minimum)
+    {
+        while (m_nextBuffer < m_buffers.size())
+        {
+            Segment const& buffer = m_buffers[m_nextBuffer++];
+            if (buffer.size >= minimum)
+            {
+                m_position = buffer.data;
+                m_available = buffer.size;
+                return;
+            }
+        }
+
+        size_type const size = std::max(m_blockSize, minimum);
+        m_blocks.reserve(m_blocks.size() + 1);
+        m_blocks.push_back(new value_type[size]);
+        m_position = m_blocks.back();
+        m_available = size;
+    }
+}
+}
+
+#endif  // __LIBEMBER_UTIL_SEGMENTEDOCTETSTREAM_HPP
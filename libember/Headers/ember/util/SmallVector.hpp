@@ -0,0 +1,411 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef __LIBEMBER_UTIL_SMALLVECTOR_HPP
+#define __LIBEMBER_UTIL_SMALLVECTOR_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <new>
+#include "Instrumentation.hpp"
+
+namespace libember { namespace util
+{
+    /**
+     * A contiguous sequence container that stores up to @p InlineCapacity elements
+     * within the object itself and only allocates storage from the heap when this
+     * capacity is exceeded.
+     * @note The elements are copied with memcpy and memmove, so ValueType must be a
+     *      trivially copyable type such as a pointer.
+     * @note Like with std::vector, inserting or erasing elements invalidates all
+     *      iterators referring to elements after the point of modification, and
+     *      inserting invalidates all iterators if the capacity has to be increased.
+     */
+    template<typename ValueType, std::size_t InlineCapacity>
+    class SmallVector
+    {
+        public:
+            typedef ValueType           value_type;
+            typedef ValueType*          iterator;
+            typedef ValueType const*    const_iterator;
+            typedef ValueType&          reference;
+            typedef ValueType const&    const_reference;
+            typedef std::size_t         size_type;
+
+        public:
+            /** Default constructor. Initializes an empty vector. */
+            SmallVector();
+
+            /**
+             * Copy constructor.
+             * @param other The vector to copy.
+             */
+            SmallVector(SmallVector const& other);
+
+            /** Destructor. Releases the heap storage, if any. */
+            ~SmallVector();
+
+            /**
+             * Assignment operator.
+             * @param other The vector to copy.
+             * @return A reference to this instance.
+             */
+            SmallVector& operator=(SmallVector const& other);
+
+            /**
+             * Returns whether or not this vector is empty.
+             * @return True if the vector contains no elements.
+             */
+            bool empty() const;
+
+            /**
+             * Returns the number of elements stored in this vector.
+             * @return The number of elements stored in this vector.
+             */
+            size_type size() const;
+
+            /**
+             * Returns the number of elements this vector is able to store without
+             * reallocating its storage.
+             * @return The current capacity.
+             */
+            size_type capacity() const;
+
+            /**
+             * Returns an iterator referring to the first element.
+             * @return An iterator referring to the first element.
+             */
+            iterator begin();
+
+            /** @see begin() */
+            const_iterator begin() const;
+
+            /**
+             * Returns an iterator referring to the element one past the last element.
+             * @return An iterator referring to the element one past the last element.
+             */
+            iterator end();
+
+            /** @see end() */
+            const_iterator end() const;
+
+            /**
+             * Accesses the element at the specified position.
+             * @param index The index of the element to return.
+             * @return A reference to the element at the specified position.
+             */
+            reference operator[](size_type index);
+
+            /** @see operator[](size_type) */
+            const_reference operator[](size_type index) const;
+
+            /**
+             * Makes sure this vector is able to store at least @p capacity elements.
+             * @param capacity The requested capacity.
+             */
+            void reserve(size_type capacity);
+
+            /**
+             * Replaces the elements of this vector with copies of the elements
+             * within the range [first, last).
+             * @param first An iterator referring to the first element to copy.
+             * @param last An iterator referring to the element one past the last
+             *      element to copy.
+             */
+            template<typename ForwardIterator>
+            void assign(ForwardIterator first, ForwardIterator last);
+
+            /**
+             * Appends @p value to the end of this vector.
+             * @param value The value to append.
+             */
+            void push_back(value_type value);
+
+            /**
+             * Inserts @p value in front of @p where.
+             * @param where The position to insert the value at.
+             * @param value The value to insert.
+             * @return An iterator referring to the inserted value.
+             */
+            iterator insert(iterator where, value_type value);
+
+            /**
+             * Removes the elements within the range [first, last).
+             * @param first An iterator referring to the first element to remove.
+             * @param last An iterator referring to the element one past the last
+             *      element to remove.
+             * @return An iterator referring to the element that followed the last
+             *      removed element.
+             */
+            iterator erase(iterator first, iterator last);
+
+            /** Removes all elements, the capacity remains unchanged. */
+            void clear();
+
+            /**
+             * Exchanges the elements of this vector with those of @p other. Heap
+             * storage changes hands, inline elements are copied. Never throws.
+             * @param other The vector to exchange the elements with.
+             */
+            void swap(SmallVector& other);
+
+        private:
+            /**
+             * Returns whether or not the elements are currently stored within
+             * the object itself.
+             * @return True if no heap storage is in use.
+             */
+            bool isInline() const;
+
+        private:
+            value_type m_inline[InlineCapacity];
+            value_type* m_data;
+            size_type m_size;
+            size_type m_capacity;
+    };
+
+
+
+    /**************************************************************************/
+    /* Mandatory inline implementation                                        */
+    /**************************************************************************/
+
+    template<typename ValueType, std::size_t InlineCapacity>
+    inline SmallVector<ValueType, InlineCapacity>::SmallVector()
+        : m_data(m_inline), m_size(0), m_capacity(InlineCapacity)
+    {}
+
+    template<typename ValueType, std::size_t InlineCapacity>
+    inline SmallVector<ValueType, InlineCapacity>::SmallVector(SmallVector const& other)
+        : m_data(m_inline), m_size(0), m_capacity(InlineCapacity)
+    {
+        reserve(other.m_size);
+        std::memcpy(m_data, other.m_data, other.m_size * sizeof(value_type));
+        m_size = other.m_size;
+    }
+
+    template<typename ValueType, std::size_t InlineCapacity>
+    inline SmallVector<ValueType, InlineCapacity>::~SmallVector()
+    {
+        if (isInline() == false)
+        {
+#ifdef LIBEMBER_INSTRUMENTATION
+            Instrumentation::released(Instrumentation::SmallVectorStorage, m_capacity * sizeof(value_type));
+#endif
+            ::operator delete(m_data);
+        }
+    }
+
+    template<typename ValueType, std::size_t InlineCapacity>
+    inline SmallVector<ValueType, InlineCapacity>& SmallVector<ValueType, InlineCapacity>::operator=(SmallVector const& other)
+    {
+        if (this != &other)
+        {
+            m_size = 0;
+            reserve(other.m_size);
+            std::memcpy(m_data, other.m_data, other.m_size * sizeof(value_type));
+            m_size = other.m_size;
+        }
+        return *this;
+    }
+
+    template<typename ValueType, std::size_t InlineCapacity>
+    inline bool SmallVector<ValueType, InlineCapacity>::empty() const
+    {
+        return m_size == 0;
+    }
+
+    template<typename ValueType, std::size_t InlineCapacity>
+    inline typename SmallVector<ValueType, InlineCapacity>::size_type SmallVector<ValueType, InlineCapacity>::size() const
+    {
+        return m_size;
+    }
+
+    template<typename ValueType, std::size_t InlineCapacity>
+    inline typename SmallVector<ValueType, InlineCapacity>::size_type SmallVector<ValueType, InlineCapacity>::capacity() const
+    {
+        return m_capacity;
+    }
+
+    template<typename ValueType, std::size_t InlineCapacity>
+    inline typename SmallVector<ValueType, InlineCapacity>::iterator SmallVector<ValueType, InlineCapacity>::begin()
+    {
+        return m_data;
+    }
+
+    template<typename ValueType, std::size_t InlineCapacity>
+    inline typename SmallVector<ValueType, InlineCapacity>::const_iterator SmallVector<ValueType, InlineCapacity>::begin() const
+    {
+        return m_data;
+    }
+
+    template<typename ValueType, std::size_t InlineCapacity>
+    inline typename SmallVector<ValueType, InlineCapacity>::iterator SmallVector<ValueType, InlineCapacity>::end()
+    {
+        return m_data + m_size;
+    }
+
+    template<typename ValueType, std::size_t InlineCapacity>
+    inline typename SmallVector<ValueType, InlineCapacity>::const_iterator SmallVector<ValueType, InlineCapacity>::end() const
+    {
+        return m_data + m_size;
+    }
+
+    template<typename ValueType, std::size_t InlineCapacity>
+    inline typename SmallVector<ValueType, InlineCapacity>::reference SmallVector<ValueType, InlineCapacity>::operator[](size_type index)
+    {
+        return m_data[index];
+    }
+
+    template<typename ValueType, std::size_t InlineCapacity>
+    inline typename SmallVector<ValueType, InlineCapacity>::const_reference SmallVector<ValueType, InlineCapacity>::operator[](size_type index) const
+    {
+        return m_data[index];
+    }
+
+    template<typename ValueType, std::size_t InlineCapacity>
+    inline void SmallVector<ValueType, InlineCapacity>::reserve(size_type capacity)
+    {
+        if (capacity > m_capacity)
+        {
+            value_type* const data = static_cast<value_type*>(::operator new(capacity * sizeof(value_type)));
+            std::memcpy(data, m_data, m_size * sizeof(value_type));
+#ifdef LIBEMBER_INSTRUMENTATION
+            Instrumentation::allocated(Instrumentation::SmallVectorStorage, capacity * sizeof(value_type));
+#endif
+
+            if (isInline() == false)
+            {
+#ifdef LIBEMBER_INSTRUMENTATION
+                Instrumentation::released(Instrumentation::SmallVectorStorage, m_capacity * sizeof(value_type));
+#endif
+                ::operator delete(m_data);
+            }
+
+            m_data = data;
+            m_capacity = capacity;
+        }
+    }
+
+    template<typename ValueType, std::size_t InlineCapacity>
+    template<typename ForwardIterator>
+    inline void SmallVector<ValueType, InlineCapacity>::assign(ForwardIterator first, ForwardIterator last)
+    {
+        m_size = 0;
+        reserve(static_cast<size_type>(std::distance(first, last)));
+
+        for(; first != last; ++first)
+        {
+            m_data[m_size] = static_cast<value_type>(*first);
+            m_size += 1;
+        }
+    }
+
+    template<typename ValueType, std::size_t InlineCapacity>
+    inline void SmallVector<ValueType, InlineCapacity>::push_back(value_type value)
+    {
+        if (m_size == m_capacity)
+        {
+            reserve(m_capacity * 2);
+        }
+        m_data[m_size] = value;
+        m_size += 1;
+    }
+
+    template<typename ValueType, std::size_t InlineCapacity>
+    inline typename SmallVector<ValueType, InlineCapacity>::iterator SmallVector<ValueType, InlineCapacity>::insert(iterator where, value_type value)
+    {
+        size_type const index = static_cast<size_type>(where - m_data);
+        if (m_size == m_capacity)
+        {
+            reserve(m_capacity * 2);
+        }
+
+        value_type* const position = m_data + index;
+        std::memmove(position + 1, position, (m_size - index) * sizeof(value_type));
+        *position = value;
+        m_size += 1;
+        return position;
+    }
+
+    template<typename ValueType, std::size_t InlineCapacity>
+    inline typename SmallVector<ValueType, InlineCapacity>::iterator SmallVector<ValueType, InlineCapacity>::erase(iterator first, iterator last)
+    {
+        if (first != last)
+        {
+            std::memmove(first, last, static_cast<size_type>(end() - last) * sizeof(value_type));
+            m_size -= static_cast<size_type>(last - first);
+        }
+        return first;
+    }
+
+    template<typename ValueType, std::size_t InlineCapacity>
+    inline void SmallVector<ValueType, InlineCapacity>::clear()
+    {
+        m_size = 0;
+    }
+
+    template<typename ValueType, std::size_t InlineCapacity>
+    inline void SmallVector<ValueType, InlineCapacity>::swap(SmallVector& other)
+    {
+        if (this == &other)
+        {
+            return;
+        }
+
+        if (isInline() && other.isInline())
+        {
+            value_type items[InlineCapacity];
+            std::memcpy(items, m_inline, m_size * sizeof(value_type));
+            std::memcpy(m_inline, other.m_inline, other.m_size * sizeof(value_type));
+            std::memcpy(other.m_inline, items, m_size * sizeof(value_type));
+        }
+        else if (isInline())
+        {
+            std::memcpy(other.m_inline, m_inline, m_size * sizeof(value_type));
+            m_data = other.m_data;
+            other.m_data = other.m_inline;
+        }
+        else if (other.isInline())
+        {
+            std::memcpy(m_inline, other.m_inline, other.m_size * sizeof(value_type));
+            other.m_data = m_data;
+            m_data = m_inline;
+        }
+        else
+        {
+            std::swap(m_data, other.m_data);
+        }
+
+        std::swap(m_size, other.m_size);
+        std::swap(m_capacity, other.m_capacity);
+    }
+
+    template<typename ValueType, std::size_t InlineCapacity>
+    inline bool SmallVector<ValueType, InlineCapacity>::isInline() const
+    {
+        return m_data == m_inline;
+    }
+}
+}
+
+#endif  // __LIBEMBER_UTIL_SMALLVECTOR_HPP
+
@@ -169,6 +169,28 @@ namespace libember { namespace util
              */
             size_type consume(iterator last);
 
+            /**
+             * Copies all elements of this buffer to @p output. Unlike iterating over
+             * the buffer, each chunk is copied as a single contiguous range.
+             * @param output an output iterator referring to the destination.
+             * @return An iterator referring to the element following the last
+             *      copied element.
+             */
+            template<typename OutputIterator>
+            OutputIterator copy(OutputIterator output) const;
+
+            /**
+             * Invokes @p function once for each non-empty chunk of this buffer, passing
+             * a pointer to the first element of the chunk and the number of elements
+             * it contains. This allows copying the buffer to non-contiguous storage
+             * one contiguous range at a time.
+             * @param function a function object that is invoked as
+             *      function(const_pointer first, size_type size).
+             * @return The function object after it has been invoked for all chunks.
+             */
+            template<typename Function>
+            Function forEachChunk(Function function) const;
+
             /**
              * Exchange the contents of this stream buffer with those of
              * @p other. This operation is guaranteed not to throw an exception.
@@ -417,6 +439,35 @@ namespace libember { namespace util
         return consumed;
     }
 
+    template<typename ValueType, unsigned short ChunkSize>
+    template<typename OutputIterator>
+    inline OutputIterator StreamBuffer<ValueType, ChunkSize>::copy(OutputIterator output) const
+    {
+        for (node_type const* current = m_head; current != 0; current = current->next())
+        {
+            if (current->empty() == false)
+            {
+                const_pointer const first = &current->at(current->first());
+                output = std::copy(first, first + current->size(), output);
+            }
+        }
+        return output;
+    }
+
+    template<typename ValueType, unsigned short ChunkSize>
+    template<typename Function>
+    inline Function StreamBuffer<ValueType, ChunkSize>::forEachChunk(Function function) const
+    {
+        for (node_type const* current = m_head; current != 0; current = current->next())
+        {
+            if (current->empty() == false)
+            {
+                function(&current->at(current->first()), current->size());
+            }
+        }
+        return function;
+    }
+
     template<typename ValueType, unsigned short ChunkSize>
     inline void StreamBuffer<ValueType, ChunkSize>::swap(StreamBuffer& other)
     {
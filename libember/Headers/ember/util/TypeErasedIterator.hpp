@@ -20,8 +20,11 @@
 #ifndef __LIBEMBER_UTIL_TYPEERASEDITERATOR_HPP
 #define __LIBEMBER_UTIL_TYPEERASEDITERATOR_HPP
 
+#include <cstddef>
+#include <new>
 #include <typeinfo>
 #include <iterator>
+#include "../meta/Boolean.hpp"
 #include "../meta/RemoveCV.hpp"
 
 //SimianIgnore
@@ -58,6 +61,9 @@ namespace libember { namespace util
      * @note Please note that this is a rather minimal implementation relying a lot
      *      on the ability to obtain a pointer to the referred element from a wrapped
      *      iterator.
+     * @note Wrapped iterators of up to a few pointers in size, such as the
+     *      iterators of all dom containers, are stored inline, so that creating
+     *      and copying instances does not allocate memory.
      */
     template<typename ValueType>
     class TypeErasedIterator
@@ -167,13 +173,21 @@ namespace libember { namespace util
             template<typename DestType>
             DestType as() const;
 
+            /**
+             * Returns whether this instance currently wraps an iterator of type
+             * DestType, so that as<DestType>() would not throw.
+             * @return True if the wrapped iterator is of type DestType.
+             */
+            template<typename DestType>
+            bool is() const;
+
         private:
             /**
              * Base class for the internal payload implementations.
              */
             struct Payload
             {
-                virtual Payload* clone() const = 0;
+                virtual Payload* clone(void* storage) const = 0;
                 virtual void preIncrement() = 0;
                 virtual pointer getPointer() const = 0;
                 virtual std::type_info const& typeId() const = 0;
@@ -192,7 +206,17 @@ namespace libember { namespace util
                 public:
                     explicit PayloadImpl(IteratorType iterator);
 
-                    virtual Payload* clone() const;
+                    /**
+                     * Creates a payload wrapping @p iterator, within @p storage
+                     * if the payload fits into the inline storage of
+                     * TypeErasedIterator, otherwise on the heap.
+                     * @param iterator The iterator to wrap.
+                     * @param storage The inline storage of a TypeErasedIterator.
+                     * @return The created payload.
+                     */
+                    static Payload* create(IteratorType const& iterator, void* storage);
+
+                    virtual Payload* clone(void* storage) const;
                     virtual void preIncrement();
                     virtual pointer getPointer() const;
                     virtual std::type_info const& typeId() const;
@@ -200,11 +224,46 @@ namespace libember { namespace util
 
                     IteratorType value() const;
 
+                private:
+                    static Payload* create(IteratorType const& iterator, void* storage, meta::TrueType);
+                    static Payload* create(IteratorType const& iterator, void* storage, meta::FalseType);
+
                 private:
                     IteratorType m_iterator;
             };
 
+            /**
+             * Inline storage for small payloads, aligned for any iterator type.
+             */
+            union Storage
+            {
+                void* alignPointer;
+                double alignDouble;
+                long alignLong;
+                unsigned char bytes[4 * sizeof(void*)];
+            };
+
+            /**
+             * Returns whether the payload is stored in m_storage.
+             * @return True if the payload is stored inline.
+             */
+            bool isInline() const;
+
+            /**
+             * Destroys the payload and leaves this instance in a singular state.
+             */
+            void destroy();
+
+            /**
+             * Takes over the payload of @p other, which is left in a singular
+             * state. This instance must be in a singular state. Inline payloads
+             * are copied, which does not allocate, heap payloads are transferred.
+             * @param other The instance to take the payload from.
+             */
+            void moveFrom(TypeErasedIterator& other);
+
         private:
+            Storage m_storage;
             Payload* m_payload;
     };
 
@@ -230,19 +289,54 @@ namespace libember { namespace util
 
     template<typename ValueType>
     inline TypeErasedIterator<ValueType>::TypeErasedIterator(TypeErasedIterator const& other)
-        : m_payload((other.m_payload != 0) ? other.m_payload->clone() : 0)
+        : m_payload((other.m_payload != 0) ? other.m_payload->clone(&m_storage) : 0)
     {}
 
     template<typename ValueType>
     template<typename IteratorType>
     inline TypeErasedIterator<ValueType>::TypeErasedIterator(IteratorType iterator)
-        : m_payload(new PayloadImpl<IteratorType>(iterator))
+        : m_payload(PayloadImpl<IteratorType>::create(iterator, &m_storage))
     {}
 
     template<typename ValueType>
     inline TypeErasedIterator<ValueType>::~TypeErasedIterator()
     {
-        delete m_payload;
+        destroy();
+    }
+
+    template<typename ValueType>
+    inline bool TypeErasedIterator<ValueType>::isInline() const
+    {
+        return static_cast<void const*>(m_payload) == static_cast<void const*>(&m_storage);
+    }
+
+    template<typename ValueType>
+    inline void TypeErasedIterator<ValueType>::destroy()
+    {
+        if (isInline())
+        {
+            m_payload->~Payload();
+        }
+        else
+        {
+            delete m_payload;
+        }
+        m_payload = 0;
+    }
+
+    template<typename ValueType>
+    inline void TypeErasedIterator<ValueType>::moveFrom(TypeErasedIterator& other)
+    {
+        if (other.isInline())
+        {
+            m_payload = other.m_payload->clone(&m_storage);
+            other.destroy();
+        }
+        else
+        {
+            m_payload = other.m_payload;
+            other.m_payload = 0;
+        }
     }
 
     template<typename ValueType>
@@ -288,8 +382,18 @@ namespace libember { namespace util
     template<typename ValueType>
     inline void TypeErasedIterator<ValueType>::swap(TypeErasedIterator& other)
     {
-        using std::swap;
-        swap(m_payload, other.m_payload);
+        if (isInline() || other.isInline())
+        {
+            TypeErasedIterator temp;
+            temp.moveFrom(*this);
+            moveFrom(other);
+            other.moveFrom(temp);
+        }
+        else
+        {
+            using std::swap;
+            swap(m_payload, other.m_payload);
+        }
     }
 
     template<typename ValueType>
@@ -303,6 +407,13 @@ namespace libember { namespace util
         return static_cast<PayloadImpl<DestType> const*>(m_payload)->value();
     }
 
+    template<typename ValueType>
+    template<typename DestType>
+    inline bool TypeErasedIterator<ValueType>::is() const
+    {
+        return (m_payload != 0) && (m_payload->typeId() == typeid(DestType));
+    }
+
     template<typename ValueType>
     template<typename IteratorType>
     inline TypeErasedIterator<ValueType>::PayloadImpl<IteratorType>::PayloadImpl(IteratorType iterator)
@@ -311,9 +422,30 @@ namespace libember { namespace util
 
     template<typename ValueType>
     template<typename IteratorType>
-    inline typename TypeErasedIterator<ValueType>::Payload* TypeErasedIterator<ValueType>::PayloadImpl<IteratorType>::clone() const
+    inline typename TypeErasedIterator<ValueType>::Payload* TypeErasedIterator<ValueType>::PayloadImpl<IteratorType>::create(IteratorType const& iterator, void* storage)
+    {
+        return create(iterator, storage, meta::Boolean<sizeof(PayloadImpl) <= sizeof(Storage)>());
+    }
+
+    template<typename ValueType>
+    template<typename IteratorType>
+    inline typename TypeErasedIterator<ValueType>::Payload* TypeErasedIterator<ValueType>::PayloadImpl<IteratorType>::create(IteratorType const& iterator, void* storage, meta::TrueType)
+    {
+        return new (storage) PayloadImpl(iterator);
+    }
+
+    template<typename ValueType>
+    template<typename IteratorType>
+    inline typename TypeErasedIterator<ValueType>::Payload* TypeErasedIterator<ValueType>::PayloadImpl<IteratorType>::create(IteratorType const& iterator, void*, meta::FalseType)
+    {
+        return new PayloadImpl(iterator);
+    }
+
+    template<typename ValueType>
+    template<typename IteratorType>
+    inline typename TypeErasedIterator<ValueType>::Payload* TypeErasedIterator<ValueType>::PayloadImpl<IteratorType>::clone(void* storage) const
     {
-        return new PayloadImpl(*this);
+        return create(m_iterator, storage);
     }
 
     template<typename ValueType>
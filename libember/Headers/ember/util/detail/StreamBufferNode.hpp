@@ -23,6 +23,7 @@
 #include <algorithm>
 #include "../../meta/RemoveCV.hpp"
 #include "../../meta/TransferCV.hpp"
+#include "../Instrumentation.hpp"
 
 namespace libember { namespace util { namespace detail
 {
@@ -60,6 +61,9 @@ namespace libember { namespace util { namespace detail
              */
             StreamBufferNode(StreamBufferNode const& other);
 
+            /** Destructor */
+            ~StreamBufferNode();
+
             /**
              * Return the maximum number of elements the node may store.
              * @return The maximum number of elements the node may store.
@@ -212,12 +216,28 @@ namespace libember { namespace util { namespace detail
     template<typename ValueType, unsigned short ChunkSize>
     inline StreamBufferNode<ValueType, ChunkSize>::StreamBufferNode()
         : m_next(0), m_first(0), m_last(0)
-    {}
+    {
+#ifdef LIBEMBER_INSTRUMENTATION
+        Instrumentation::allocated(Instrumentation::StreamBufferChunk, sizeof(StreamBufferNode));
+#endif
+    }
+
     template<typename ValueType, unsigned short ChunkSize>
     inline StreamBufferNode<ValueType, ChunkSize>::StreamBufferNode(StreamBufferNode const& other)
         : m_next(0), m_first(other.m_first), m_last(other.m_last)
     {
         std::copy(other.m_data, other.m_data + other.m_last, m_data);
+#ifdef LIBEMBER_INSTRUMENTATION
+        Instrumentation::allocated(Instrumentation::StreamBufferChunk, sizeof(StreamBufferNode));
+#endif
+    }
+
+    template<typename ValueType, unsigned short ChunkSize>
+    inline StreamBufferNode<ValueType, ChunkSize>::~StreamBufferNode()
+    {
+#ifdef LIBEMBER_INSTRUMENTATION
+        Instrumentation::released(Instrumentation::StreamBufferChunk, sizeof(StreamBufferNode));
+#endif
     }
 
     template<typename ValueType, unsigned short ChunkSize>
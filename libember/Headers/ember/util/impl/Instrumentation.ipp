@@ -0,0 +1,160 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef __LIBEMBER_UTIL_IMPL_INSTRUMENTATION_IPP
+#define __LIBEMBER_UTIL_IMPL_INSTRUMENTATION_IPP
+
+#include <ostream>
+#include "../Inline.hpp"
+
+#if defined(_MSC_VER)
+#  include <intrin.h>
+#endif
+
+namespace libember { namespace util
+{
+    namespace detail
+    {
+        /**
+         * The counters of all categories. Each field is updated atomically.
+         */
+        struct InstrumentationCounters
+        {
+            long volatile allocations[Instrumentation::CategoryCount];
+            long volatile bytes[Instrumentation::CategoryCount];
+            long volatile live[Instrumentation::CategoryCount];
+            long volatile liveBytes[Instrumentation::CategoryCount];
+        };
+
+        /**
+         * Returns the counters of all categories, which are zero initialized
+         * since they have static storage duration.
+         * @return The counters of all categories.
+         */
+        inline InstrumentationCounters& instrumentationCounters()
+        {
+            static InstrumentationCounters counters;
+            return counters;
+        }
+
+        /**
+         * Atomically adds @p value to the counter @p target.
+         * @param target The counter to update.
+         * @param value The value to add, may be negative.
+         */
+        inline void atomicAdd(long volatile& target, long value)
+        {
+#if defined(_MSC_VER)
+            _InterlockedExchangeAdd(&target, value);
+#elif defined(__GNUC__)
+            __sync_fetch_and_add(&target, value);
+#else
+            target += value;
+#endif
+        }
+    }
+
+    LIBEMBER_INLINE
+    bool Instrumentation::enabled()
+    {
+#ifdef LIBEMBER_INSTRUMENTATION
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    LIBEMBER_INLINE
+    char const* Instrumentation::name(Category category)
+    {
+        static char const* const names[CategoryCount] =
+        {
+            "NodeStorage",
+            "StreamBufferChunk",
+            "SmallVectorStorage",
+            "VariantLeaf",
+            "GlowNode",
+            "GlowQualifiedNode",
+            "GlowParameter",
+            "GlowQualifiedParameter",
+            "GlowStreamEntry"
+        };
+
+        return category < CategoryCount ? names[category] : "";
+    }
+
+    LIBEMBER_INLINE
+    Instrumentation::Counter Instrumentation::counter(Category category)
+    {
+        detail::InstrumentationCounters const& counters = detail::instrumentationCounters();
+        Counter result;
+        result.allocations = static_cast<unsigned long>(counters.allocations[category]);
+        result.bytes = static_cast<unsigned long>(counters.bytes[category]);
+        result.live = counters.live[category];
+        result.liveBytes = counters.liveBytes[category];
+        return result;
+    }
+
+    LIBEMBER_INLINE
+    void Instrumentation::reset()
+    {
+        detail::InstrumentationCounters& counters = detail::instrumentationCounters();
+        for (int category = 0; category < CategoryCount; ++category)
+        {
+            detail::atomicAdd(counters.allocations[category], -counters.allocations[category]);
+            detail::atomicAdd(counters.bytes[category], -counters.bytes[category]);
+        }
+    }
+
+    LIBEMBER_INLINE
+    void Instrumentation::dump(std::ostream& stream)
+    {
+        for (int category = 0; category < CategoryCount; ++category)
+        {
+            Counter const current = counter(static_cast<Category>(category));
+            stream << name(static_cast<Category>(category))
+                   << ": allocations=" << current.allocations
+                   << " bytes=" << current.bytes
+                   << " live=" << current.live
+                   << " liveBytes=" << current.liveBytes
+                   << "\n";
+        }
+    }
+
+    LIBEMBER_INLINE
+    void Instrumentation::allocated(Category category, std::size_t bytes)
+    {
+        detail::InstrumentationCounters& counters = detail::instrumentationCounters();
+        detail::atomicAdd(counters.allocations[category], 1);
+        detail::atomicAdd(counters.bytes[category], static_cast<long>(bytes));
+        detail::atomicAdd(counters.live[category], 1);
+        detail::atomicAdd(counters.liveBytes[category], static_cast<long>(bytes));
+    }
+
+    LIBEMBER_INLINE
+    void Instrumentation::released(Category category, std::size_t bytes)
+    {
+        detail::InstrumentationCounters& counters = detail::instrumentationCounters();
+        detail::atomicAdd(counters.live[category], -1);
+        detail::atomicAdd(counters.liveBytes[category], -static_cast<long>(bytes));
+    }
+}
+}
+
+#endif  // __LIBEMBER_UTIL_IMPL_INSTRUMENTATION_IPP
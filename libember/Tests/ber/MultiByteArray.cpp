@@ -0,0 +1,249 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+#include "ember/ber/Ber.hpp"
+#include "ember/ber/detail/MultiByteArray.hpp"
+
+#define THROW_TEST_EXCEPTION(message)                       \
+            {                                               \
+                std::ostringstream msgStream;               \
+                msgStream << message ;                      \
+                throw std::runtime_error(msgStream.str());  \
+            }
+
+namespace
+{
+    using namespace libember;
+
+    /**
+     * Encodes the passed array with the array functions and compares the
+     * result with the bytes produced by encoding each item on its own.
+     */
+    void testArray(std::vector<unsigned int> const& items)
+    {
+        util::OctetStream expected;
+        for (std::size_t i = 0; i < items.size(); ++i)
+        {
+            ber::detail::encodeMultibyte(expected, items[i]);
+        }
+
+        std::vector<unsigned char> expectedBytes(expected.size());
+        expected.copy(expectedBytes.begin());
+
+        unsigned int const* const first = items.empty() ? 0 : &items[0];
+        unsigned int const* const last = first + items.size();
+        std::size_t const length = ber::detail::getMultiByteArrayEncodedLength(first, last);
+        if (length != expectedBytes.size())
+        {
+            THROW_TEST_EXCEPTION("Invalid encoded length! Expected " << expectedBytes.size() << ", found " << length);
+        }
+
+        std::vector<unsigned char> bytes(length + 1);
+        unsigned char const* const bytesLast = ber::detail::encodeMultibyteArray(first, last, &bytes[0]);
+        if (static_cast<std::size_t>(bytesLast - &bytes[0]) != length)
+        {
+            THROW_TEST_EXCEPTION("Invalid number of encoded bytes! Expected " << length << ", found " << (bytesLast - &bytes[0]));
+        }
+        for (std::size_t i = 0; i < length; ++i)
+        {
+            if (bytes[i] != expectedBytes[i])
+            {
+                THROW_TEST_EXCEPTION("Invalid encoded byte at " << i << "! Expected " << int(expectedBytes[i]) << ", found " << int(bytes[i]));
+            }
+        }
+
+        std::vector<unsigned int> decoded(length + 1);
+        std::size_t const count = ber::detail::decodeMultibyteArray(&bytes[0], &bytes[0] + length, &decoded[0]);
+        if (count != items.size())
+        {
+            THROW_TEST_EXCEPTION("Invalid number of decoded items! Expected " << items.size() << ", found " << count);
+        }
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            if (decoded[i] != items[i])
+            {
+                THROW_TEST_EXCEPTION("Invalid decoded item at " << i << "! Expected " << items[i] << ", found " << decoded[i]);
+            }
+        }
+    }
+
+    /**
+     * Encodes a RELATIVE-OID with the passed number of items and decodes it again.
+     */
+    void testObjectIdentifier(std::size_t size)
+    {
+        std::vector<unsigned int> items;
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            items.push_back(static_cast<unsigned int>((i % 3 == 0) ? i * 977 : i % 100));
+        }
+
+        ber::ObjectIdentifier const oid(items.begin(), items.end());
+        util::OctetStream stream;
+        ber::encode(stream, oid);
+
+        std::size_t const length = stream.size();
+        ber::ObjectIdentifier const decoded = ber::decode<ber::ObjectIdentifier>(stream, length);
+        if (decoded.size() != oid.size())
+        {
+            THROW_TEST_EXCEPTION("Invalid size of decoded oid! Expected " << oid.size() << ", found " << decoded.size());
+        }
+        if (decoded != oid)
+        {
+            THROW_TEST_EXCEPTION("Decoded oid of size " << size << " differs from the encoded one");
+        }
+        if (stream.size() != 0)
+        {
+            THROW_TEST_EXCEPTION("The decoder left " << stream.size() << " bytes in the stream");
+        }
+    }
+
+    /**
+     * Encodes a RELATIVE-OID with sub-identifiers that use the full width of
+     * ObjectIdentifier::value_type and decodes it again.
+     */
+    void testLargeSubidentifiers()
+    {
+        typedef ber::ObjectIdentifier::value_type value_type;
+        value_type const highest = ~value_type(0);
+        value_type const items[] = { 0, highest, 5, value_type(1) << (sizeof(value_type) * 8 - 1), 0xFFFFFFFFU, highest >> 1, 1 };
+
+        ber::ObjectIdentifier const oid(items, items + sizeof(items) / sizeof(items[0]));
+        util::OctetStream stream;
+        ber::encode(stream, oid);
+
+        std::size_t const expectedLength = 1 + 2 * ber::detail::MultiByteMaxEncodedLength<value_type>::value + 1 + 5 + (sizeof(value_type) * 8 - 1 + 6) / 7 + 1;
+        if (stream.size() != expectedLength || ber::encodedLength(oid) != expectedLength)
+        {
+            THROW_TEST_EXCEPTION("Invalid encoded length of large sub-identifiers! Expected " << expectedLength << ", found " << stream.size());
+        }
+
+        ber::ObjectIdentifier const decoded = ber::decode<ber::ObjectIdentifier>(stream, expectedLength);
+        if (decoded != oid)
+        {
+            THROW_TEST_EXCEPTION("Decoded oid with large sub-identifiers differs from the encoded one");
+        }
+    }
+
+    /**
+     * Swaps object identifiers stored inline and on the heap in all combinations.
+     */
+    void testSwap()
+    {
+        std::size_t const sizes[] = { 0, 3, 40, 100 };
+        std::size_t const sizeCount = sizeof(sizes) / sizeof(sizes[0]);
+        for (std::size_t i = 0; i < sizeCount; ++i)
+        {
+            for (std::size_t j = 0; j < sizeCount; ++j)
+            {
+                ber::ObjectIdentifier first;
+                ber::ObjectIdentifier second;
+                for (std::size_t k = 0; k < sizes[i]; ++k)
+                {
+                    first.push_back(k);
+                }
+                for (std::size_t k = 0; k < sizes[j]; ++k)
+                {
+                    second.push_back(1000 + k);
+                }
+
+                ber::ObjectIdentifier const expectedFirst = second;
+                ber::ObjectIdentifier const expectedSecond = first;
+                first.swap(second);
+                if (first != expectedFirst || second != expectedSecond)
+                {
+                    THROW_TEST_EXCEPTION("Swapping oids of sizes " << sizes[i] << " and " << sizes[j] << " failed");
+                }
+
+                first.swap(first);
+                if (first != expectedFirst)
+                {
+                    THROW_TEST_EXCEPTION("Swapping an oid of size " << sizes[j] << " with itself failed");
+                }
+            }
+        }
+    }
+}
+
+int main(int, char const* const*)
+{
+    try
+    {
+        unsigned int const boundaries[] = { 0, 1, 127, 128, 129, 16383, 16384, 2097151, 2097152, 268435455, 268435456, 0xFFFFFFFFU };
+        std::size_t const boundaryCount = sizeof(boundaries) / sizeof(boundaries[0]);
+
+        testArray(std::vector<unsigned int>());
+        for (std::size_t i = 0; i < boundaryCount; ++i)
+        {
+            testArray(std::vector<unsigned int>(1, boundaries[i]));
+
+            // Places each boundary value at every position of a run of small items,
+            // so that both the word test and the single item path are exercised.
+            for (std::size_t position = 0; position < 17; ++position)
+            {
+                std::vector<unsigned int> items(17, 5);
+                items[position] = boundaries[i];
+                testArray(items);
+            }
+        }
+
+        std::srand(4711);
+        for (unsigned int i = 0; i < 1000; ++i)
+        {
+            std::vector<unsigned int> items(std::rand() % 200);
+            for (std::size_t j = 0; j < items.size(); ++j)
+            {
+                unsigned int const value = (static_cast<unsigned int>(std::rand()) << 16) ^ static_cast<unsigned int>(std::rand());
+                items[j] = value >> (std::rand() % 32);
+            }
+            testArray(items);
+        }
+
+        {
+            // A last item without its terminating byte is decoded from the bytes present.
+            unsigned char const bytes[] = { 0x01, 0x81, 0x82 };
+            unsigned int items[3];
+            std::size_t const count = ber::detail::decodeMultibyteArray(bytes, bytes + 3, items);
+            if (count != 2 || items[0] != 1 || items[1] != ((1U << 7) | 2))
+            {
+                THROW_TEST_EXCEPTION("Invalid decoding of an unterminated item");
+            }
+        }
+
+        testObjectIdentifier(0);
+        testObjectIdentifier(1);
+        testObjectIdentifier(10);
+        testObjectIdentifier(64);
+        testObjectIdentifier(65);
+        testObjectIdentifier(5000);
+        testLargeSubidentifiers();
+        testSwap();
+    }
+    catch (std::exception const& e)
+    {
+        std::cerr << "ERROR: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
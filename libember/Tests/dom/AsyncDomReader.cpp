@@ -0,0 +1,518 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+#include "ember/Ember.hpp"
+#include "ember/util/ContiguousOctetStream.hpp"
+
+#define THROW_TEST_EXCEPTION(message)                       \
+            {                                               \
+                std::ostringstream msgStream;               \
+                msgStream << message ;                      \
+                throw std::runtime_error(msgStream.str());  \
+            }
+
+namespace
+{
+    typedef std::vector<unsigned char> ByteVector;
+
+    /**
+     * Creates a small glow tree containing nodes and parameters of all common value types.
+     * @return The root of the created tree.
+     */
+    libember::glow::GlowRootElementCollection* createTree()
+    {
+        using namespace libember::glow;
+
+        GlowRootElementCollection* const root = GlowRootElementCollection::create();
+        for (int i = 1; i <= 20; ++i)
+        {
+            GlowNode* const node = new GlowNode(root, i);
+            std::ostringstream identifier;
+            identifier << "node" << i;
+            node->setIdentifier(identifier.str());
+            node->setDescription(std::string(static_cast<std::size_t>(i * 37), 'x'));
+
+            for (int j = 1; j <= 5; ++j)
+            {
+                GlowParameter* const parameter = new GlowParameter(node, j);
+                parameter->setIdentifier("parameter");
+                parameter->setMinimum(-1000 * j);
+                parameter->setMaximum(1000 * j);
+                switch (j % 3)
+                {
+                    case 0:
+                        parameter->setValue(static_cast<long>(i * j * 1234567));
+                        break;
+                    case 1:
+                        parameter->setValue(i * 0.5);
+                        break;
+                    default:
+                        parameter->setValue(std::string(static_cast<std::size_t>(j * 100), 'v'));
+                        break;
+                }
+            }
+        }
+        return root;
+    }
+
+    /**
+     * Encodes the passed node into a byte vector.
+     * @param node The node to encode.
+     * @return The encoded bytes.
+     */
+    ByteVector encode(libember::dom::Node const& node)
+    {
+        libember::util::OctetStream stream;
+        node.encode(stream);
+        return ByteVector(stream.begin(), stream.end());
+    }
+
+    /**
+     * Decodes the passed buffer in chunks of @p chunkSize bytes and returns the encoded
+     * representation of the decoded tree.
+     * @param buffer The buffer to decode.
+     * @param chunkSize The number of bytes to pass to the reader at once.
+     * @param contiguous Specifies whether the contiguous buffer overload or the generic
+     *      iterator overload of AsyncBerReader::read should be used.
+     * @param lazy Specifies whether string leaves should be decoded lazily.
+     * @return The encoded representation of the decoded tree.
+     */
+    ByteVector decodeAndEncode(ByteVector const& buffer, std::size_t chunkSize, bool contiguous, bool lazy = false)
+    {
+        libember::dom::AsyncDomReader reader(libember::glow::GlowNodeFactory::getFactory());
+        reader.setLazyLeafDecoding(lazy);
+        for (std::size_t offset = 0; offset < buffer.size(); offset += chunkSize)
+        {
+            std::size_t const size = std::min(chunkSize, buffer.size() - offset);
+            ByteVector::const_iterator const first = buffer.begin() + offset;
+            ByteVector::const_iterator const last = first + size;
+            if (contiguous)
+            {
+                reader.read(&*first, &*first + size);
+            }
+            else
+            {
+                reader.read(first, last);
+            }
+        }
+
+        std::auto_ptr<libember::dom::Node> root(reader.detachRoot());
+        if (root.get() == 0)
+        {
+            THROW_TEST_EXCEPTION("No root decoded with a chunk size of " << chunkSize);
+        }
+
+        if (lazy)
+        {
+            libember::dom::Container const& container = dynamic_cast<libember::dom::Container const&>(*root);
+            libember::glow::GlowNode const* const node = dynamic_cast<libember::glow::GlowNode const*>(&*container.begin());
+            if (node == 0 || node->identifier() != "node1")
+            {
+                THROW_TEST_EXCEPTION("Lazily decoded identifier mismatch with a chunk size of " << chunkSize);
+            }
+        }
+        return encode(*root);
+    }
+
+    /**
+     * Decodes the passed buffer with a reader that allocates all nodes from an arena
+     * and returns the encoded representation of the decoded tree.
+     * @param buffer The buffer to decode.
+     * @return The encoded representation of the decoded tree.
+     */
+    ByteVector decodeAndEncodeWithArena(ByteVector const& buffer)
+    {
+        libember::dom::ArenaNodeAllocator arena(4096);
+        ByteVector result;
+        {
+            libember::dom::AsyncDomReader reader(libember::glow::GlowNodeFactory::getFactory(), arena);
+            reader.read(&buffer[0], &buffer[0] + buffer.size());
+
+            std::auto_ptr<libember::dom::Node> root(reader.detachRoot());
+            if (root.get() == 0)
+            {
+                THROW_TEST_EXCEPTION("No root decoded with an arena allocator");
+            }
+
+            result = encode(*root);
+        }
+
+        if (arena.allocatedBytes() == 0)
+        {
+            THROW_TEST_EXCEPTION("The reader did not create the nodes with the provided allocator");
+        }
+        arena.release();
+        return result;
+    }
+
+    /**
+     * Counts the nodes of type ElementType within the passed tree.
+     * @param node The root of the tree to search.
+     * @return The number of nodes of type ElementType.
+     */
+    template<typename ElementType>
+    std::size_t countElements(libember::dom::Node const& node)
+    {
+        std::size_t count = (dynamic_cast<ElementType const*>(&node) != 0) ? 1 : 0;
+        libember::dom::Container const* const container = dynamic_cast<libember::dom::Container const*>(&node);
+        if (container != 0)
+        {
+            libember::dom::Container::const_iterator const last = container->end();
+            for (libember::dom::Container::const_iterator it = container->begin(); it != last; ++it)
+            {
+                count += countElements<ElementType>(*it);
+            }
+        }
+        return count;
+    }
+
+    /**
+     * Decodes the passed buffer in chunks of @p chunkSize bytes with a filter that only
+     * accepts the children of the node with the number 3 and verifies the decoded tree.
+     * @param buffer The buffer to decode.
+     * @param chunkSize The number of bytes to pass to the reader at once.
+     */
+    void decodeFiltered(ByteVector const& buffer, std::size_t chunkSize)
+    {
+        libember::ber::ObjectIdentifier prefix;
+        prefix.push_back(3);
+        libember::glow::GlowNodeFilter const filter(prefix);
+
+        libember::dom::AsyncDomReader reader(libember::glow::GlowNodeFactory::getFactory());
+        reader.setNodeFilter(&filter);
+        for (std::size_t offset = 0; offset < buffer.size(); offset += chunkSize)
+        {
+            std::size_t const size = std::min(chunkSize, buffer.size() - offset);
+            reader.read(&buffer[offset], &buffer[offset] + size);
+        }
+
+        std::auto_ptr<libember::dom::Node> root(reader.detachRoot());
+        if (root.get() == 0)
+        {
+            THROW_TEST_EXCEPTION("No root decoded with a node filter and a chunk size of " << chunkSize);
+        }
+        if (countElements<libember::glow::GlowNode>(*root) != 20
+         || countElements<libember::glow::GlowParameter>(*root) != 5)
+        {
+            THROW_TEST_EXCEPTION("The node filter did not skip the expected children with a chunk size of " << chunkSize);
+        }
+    }
+
+    /**
+     * Decodes the passed buffer in chunks of @p chunkSize bytes while interning the
+     * decoded strings in @p pool and returns the encoded representation of the decoded tree.
+     * @param buffer The buffer to decode.
+     * @param chunkSize The number of bytes to pass to the reader at once.
+     * @param pool The pool to intern the decoded strings in.
+     * @return The encoded representation of the decoded tree.
+     */
+    ByteVector decodeAndEncodeWithPool(ByteVector const& buffer, std::size_t chunkSize, libember::dom::StringPool& pool)
+    {
+        libember::dom::AsyncDomReader reader(libember::glow::GlowNodeFactory::getFactory());
+        reader.setStringPool(&pool);
+        for (std::size_t offset = 0; offset < buffer.size(); offset += chunkSize)
+        {
+            std::size_t const size = std::min(chunkSize, buffer.size() - offset);
+            reader.read(&buffer[offset], &buffer[offset] + size);
+        }
+
+        std::auto_ptr<libember::dom::Node> root(reader.detachRoot());
+        if (root.get() == 0)
+        {
+            THROW_TEST_EXCEPTION("No root decoded with a string pool and a chunk size of " << chunkSize);
+        }
+        return encode(*root);
+    }
+
+    /**
+     * Verifies that malformed input is reported by tryRead without an exception, that
+     * the reader ignores all bytes until it is reset and that read still throws.
+     * @param expected The encoding of a valid tree.
+     */
+    void decodeMalformed(ByteVector const& expected)
+    {
+        typedef libember::dom::AsyncBerReader::ReadStatus ReadStatus;
+        unsigned char const zeroOuterLength[] = { 0x60, 0x00 };
+        unsigned char const invalidLength[] = { 0x60, 0x86 };
+        unsigned char const invalidTerminator[] = { 0x00, 0x01 };
+
+        libember::dom::AsyncDomReader reader(libember::glow::GlowNodeFactory::getFactory());
+        if (reader.tryRead(zeroOuterLength, zeroOuterLength + 2) != ReadStatus::ZeroOuterLength
+         || reader.tryRead(&expected.front(), &expected.front() + expected.size()) != ReadStatus::ZeroOuterLength
+         || reader.isRootReady())
+        {
+            THROW_TEST_EXCEPTION("A zero outer length has not stopped the reader");
+        }
+
+        reader.reset();
+        if (reader.tryRead(&expected.front(), &expected.front() + expected.size()) != ReadStatus::Ok
+         || reader.isRootReady() == false)
+        {
+            THROW_TEST_EXCEPTION("The reader has not recovered after a reset");
+        }
+
+        reader.reset();
+        if (reader.tryRead(invalidLength[0]) != ReadStatus::Ok
+         || reader.tryRead(invalidLength[1]) != ReadStatus::InvalidLength)
+        {
+            THROW_TEST_EXCEPTION("Too many length octets have not been reported");
+        }
+
+        reader.reset();
+        if (reader.tryRead(invalidTerminator, invalidTerminator + 2) != ReadStatus::InvalidTerminator
+         || reader.status() != ReadStatus::InvalidTerminator)
+        {
+            THROW_TEST_EXCEPTION("A non-zero terminator byte has not been reported");
+        }
+
+        reader.reset();
+        try
+        {
+            reader.read(zeroOuterLength, zeroOuterLength + 2);
+        }
+        catch (std::runtime_error const& e)
+        {
+            if (std::string(e.what()) != libember::dom::AsyncBerReader::describe(ReadStatus::ZeroOuterLength))
+            {
+                THROW_TEST_EXCEPTION("Unexpected error message: " << e.what());
+            }
+            return;
+        }
+        THROW_TEST_EXCEPTION("Reading malformed input has not thrown an exception");
+    }
+
+    /**
+     * Verifies that containers no node can be created for are skipped together with
+     * their contents, whether they are the root or nested within it.
+     * @param expected The encoding of a valid tree.
+     */
+    void decodeUnknownContainers(ByteVector const& expected)
+    {
+        typedef libember::dom::AsyncBerReader::ReadStatus ReadStatus;
+
+        // A constructed UTF8String within a sequence, which contains a string leaf.
+        unsigned char const nested[] = { 0xA0, 0x09, 0x30, 0x07, 0xA1, 0x05, 0x2C, 0x03, 0x0C, 0x01, 0x41 };
+
+        // An application defined container the glow factory does not know, as root.
+        unsigned char const unknownRoot[] = { 0xA0, 0x07, 0x7E, 0x05, 0xA1, 0x03, 0x0C, 0x01, 0x41 };
+
+        std::size_t const chunkSizes[] = { 1, sizeof(nested) };
+        for (std::size_t i = 0; i < sizeof(chunkSizes) / sizeof(chunkSizes[0]); ++i)
+        {
+            libember::dom::AsyncDomReader reader(libember::glow::GlowNodeFactory::getFactory());
+            for (unsigned char const* first = nested; first != nested + sizeof(nested); first += chunkSizes[i])
+            {
+                if (reader.tryRead(first, first + chunkSizes[i]) != ReadStatus::Ok)
+                {
+                    THROW_TEST_EXCEPTION("A nested container of an unknown type has failed the reader");
+                }
+            }
+
+            std::auto_ptr<libember::dom::Node> root(reader.detachRoot());
+            if (root.get() == 0 || countElements<libember::dom::Node>(*root) != 1)
+            {
+                THROW_TEST_EXCEPTION("A nested container of an unknown type has not been skipped");
+            }
+        }
+
+        libember::dom::AsyncDomReader reader(libember::glow::GlowNodeFactory::getFactory());
+        if (reader.tryRead(unknownRoot, unknownRoot + sizeof(unknownRoot)) != ReadStatus::Ok || reader.isRootReady())
+        {
+            THROW_TEST_EXCEPTION("A root container of an unknown type has not been skipped");
+        }
+
+        if (reader.tryRead(&expected.front(), &expected.front() + expected.size()) != ReadStatus::Ok || reader.isRootReady() == false)
+        {
+            THROW_TEST_EXCEPTION("No root decoded after a skipped root container");
+        }
+    }
+
+    /**
+     * Decodes the passed buffer with the passed limits.
+     * @param buffer The buffer to decode.
+     * @param limits The limits to apply.
+     * @return The status reported by the reader.
+     */
+    libember::dom::AsyncBerReader::ReadStatus::_Domain decodeLimited(ByteVector const& buffer, libember::dom::AsyncBerReader::Limits const& limits)
+    {
+        libember::dom::AsyncDomReader reader(libember::glow::GlowNodeFactory::getFactory());
+        reader.setLimits(limits);
+        libember::dom::AsyncBerReader::ReadStatus::_Domain const status = reader.tryRead(&buffer.front(), &buffer.front() + buffer.size());
+        if (status == libember::dom::AsyncBerReader::ReadStatus::Ok && reader.isRootReady() == false)
+        {
+            THROW_TEST_EXCEPTION("No root decoded within the limits");
+        }
+        return status;
+    }
+
+    /**
+     * Verifies that the reader fails when the input exceeds one of its limits.
+     * @param expected The encoding of a valid tree.
+     */
+    void decodeWithLimits(ByteVector const& expected)
+    {
+        typedef libember::dom::AsyncBerReader::ReadStatus ReadStatus;
+        libember::dom::AsyncBerReader::Limits generous;
+        generous.maximumLength = expected.size();
+        generous.maximumDepth = 16;
+        generous.maximumElements = 100000;
+        if (decodeLimited(expected, generous) != ReadStatus::Ok)
+        {
+            THROW_TEST_EXCEPTION("Decoding within generous limits failed");
+        }
+
+        libember::dom::AsyncBerReader::Limits length = generous;
+        length.maximumLength = 100;
+        if (decodeLimited(expected, length) != ReadStatus::LengthLimitExceeded)
+        {
+            THROW_TEST_EXCEPTION("An element exceeding the maximum length has been decoded");
+        }
+
+        libember::dom::AsyncBerReader::Limits depth = generous;
+        depth.maximumDepth = 2;
+        if (decodeLimited(expected, depth) != ReadStatus::DepthLimitExceeded)
+        {
+            THROW_TEST_EXCEPTION("Containers exceeding the maximum depth have been decoded");
+        }
+
+        libember::dom::AsyncBerReader::Limits elements = generous;
+        elements.maximumElements = 50;
+        if (decodeLimited(expected, elements) != ReadStatus::ElementLimitExceeded)
+        {
+            THROW_TEST_EXCEPTION("A root exceeding the maximum number of elements has been decoded");
+        }
+
+        // A sequence containing a constructed UTF8String, for which no node exists.
+        unsigned char const bytes[] = { 0xA0, 0x09, 0x30, 0x07, 0xA1, 0x05, 0x2C, 0x03, 0x0C, 0x01, 0x41 };
+        ByteVector const unknown(bytes, bytes + sizeof(bytes));
+        if (decodeLimited(unknown, generous) != ReadStatus::Ok)
+        {
+            THROW_TEST_EXCEPTION("A container of an unknown type has not been skipped");
+        }
+
+        libember::dom::AsyncBerReader::Limits strict = generous;
+        strict.skipUnknownContainers = false;
+        if (decodeLimited(unknown, strict) != ReadStatus::UnknownContainer
+         || decodeLimited(expected, strict) != ReadStatus::Ok)
+        {
+            THROW_TEST_EXCEPTION("A container of an unknown type has not been rejected");
+        }
+
+        // A container is checked against the limits before it is skipped.
+        libember::dom::AsyncBerReader::Limits skippedElements = generous;
+        skippedElements.maximumElements = 0;
+        libember::dom::AsyncBerReader::Limits skippedDepth = generous;
+        skippedDepth.maximumDepth = 1;
+        if (decodeLimited(unknown, skippedElements) != ReadStatus::ElementLimitExceeded
+         || decodeLimited(unknown, skippedDepth) != ReadStatus::DepthLimitExceeded)
+        {
+            THROW_TEST_EXCEPTION("A skipped container has not been checked against the limits");
+        }
+    }
+}
+
+int main(int, char const* const*)
+{
+    try
+    {
+        std::auto_ptr<libember::glow::GlowRootElementCollection> const root(createTree());
+        ByteVector const expected = encode(*root);
+
+        std::size_t const chunkSizes[] = { 1, 2, 3, 7, 64, 255, 1024, expected.size() };
+        for (std::size_t i = 0; i < sizeof(chunkSizes) / sizeof(chunkSizes[0]); ++i)
+        {
+            if (decodeAndEncode(expected, chunkSizes[i], false) != expected)
+            {
+                THROW_TEST_EXCEPTION("Byte-wise decoding with a chunk size of " << chunkSizes[i] << " altered the tree");
+            }
+            if (decodeAndEncode(expected, chunkSizes[i], true) != expected)
+            {
+                THROW_TEST_EXCEPTION("Block decoding with a chunk size of " << chunkSizes[i] << " altered the tree");
+            }
+            if (decodeAndEncode(expected, chunkSizes[i], true, true) != expected)
+            {
+                THROW_TEST_EXCEPTION("Lazy decoding with a chunk size of " << chunkSizes[i] << " altered the tree");
+            }
+        }
+
+        libember::util::ContiguousOctetStream contiguous;
+        root->encode(contiguous);
+        if (contiguous.size() != expected.size()
+         || ByteVector(contiguous.data(), contiguous.data() + contiguous.size()) != expected)
+        {
+            THROW_TEST_EXCEPTION("Encoding to a contiguous stream produced different bytes");
+        }
+
+        libember::util::OctetStream indefiniteStream;
+        root->encodeIndefinite(indefiniteStream);
+        ByteVector const indefinite(indefiniteStream.begin(), indefiniteStream.end());
+        if (indefinite == expected)
+        {
+            THROW_TEST_EXCEPTION("Indefinite length encoding produced definite length containers");
+        }
+        for (std::size_t i = 0; i < sizeof(chunkSizes) / sizeof(chunkSizes[0]); ++i)
+        {
+            if (decodeAndEncode(indefinite, chunkSizes[i], false) != expected
+             || decodeAndEncode(indefinite, chunkSizes[i], true) != expected)
+            {
+                THROW_TEST_EXCEPTION("Decoding the indefinite length encoding with a chunk size of " << chunkSizes[i] << " altered the tree");
+            }
+        }
+
+        for (std::size_t i = 0; i < sizeof(chunkSizes) / sizeof(chunkSizes[0]); ++i)
+        {
+            decodeFiltered(expected, chunkSizes[i]);
+            decodeFiltered(indefinite, chunkSizes[i]);
+        }
+
+        if (decodeAndEncodeWithArena(expected) != expected)
+        {
+            THROW_TEST_EXCEPTION("Decoding with an arena allocator altered the tree");
+        }
+
+        // 20 node identifiers, the shared parameter identifier and the only description short enough
+        libember::dom::StringPool pool;
+        for (std::size_t i = 0; i < sizeof(chunkSizes) / sizeof(chunkSizes[0]); ++i)
+        {
+            if (decodeAndEncodeWithPool(expected, chunkSizes[i], pool) != expected)
+            {
+                THROW_TEST_EXCEPTION("Decoding with a string pool and a chunk size of " << chunkSizes[i] << " altered the tree");
+            }
+            if (pool.size() != 22)
+            {
+                THROW_TEST_EXCEPTION("The string pool contains " << pool.size() << " strings instead of 22");
+            }
+        }
+
+        decodeMalformed(expected);
+        decodeUnknownContainers(expected);
+        decodeWithLimits(expected);
+    }
+    catch (std::exception const& e)
+    {
+        std::cerr << "ERROR: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
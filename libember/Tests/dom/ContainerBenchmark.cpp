@@ -0,0 +1,172 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <ctime>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include "ember/Ember.hpp"
+
+#define THROW_TEST_EXCEPTION(message)                       \
+            {                                               \
+                std::ostringstream msgStream;               \
+                msgStream << message ;                      \
+                throw std::runtime_error(msgStream.str());  \
+            }
+
+namespace
+{
+    /**
+     * Creates a set containing @p count leaves, tagged with the context specific
+     * tags 0 to count - 1.
+     * @param count The number of leaves to insert.
+     * @return The created set.
+     */
+    libember::dom::Set* createSet(int count)
+    {
+        using namespace libember;
+
+        dom::Set* const set = new dom::Set(ber::make_tag(ber::Class::ContextSpecific, 0));
+        for (int i = 0; i < count; ++i)
+        {
+            set->insert(set->end(), new dom::VariantLeaf(ber::make_tag(ber::Class::ContextSpecific, i), i));
+        }
+        return set;
+    }
+
+    /**
+     * Returns the number of milliseconds elapsed since @p start.
+     * @param start The start time.
+     * @return The number of milliseconds elapsed since @p start.
+     */
+    double elapsed(std::clock_t start)
+    {
+        return (std::clock() - start) * 1000.0 / CLOCKS_PER_SEC;
+    }
+
+    /**
+     * Iterates @p iterations times over the children of @p set and returns the
+     * sum of the tag numbers of all visited children.
+     */
+    unsigned long iterate(libember::dom::Set const& set, int iterations)
+    {
+        unsigned long sum = 0;
+        for (int i = 0; i < iterations; ++i)
+        {
+            libember::dom::Set::const_iterator const last = set.end();
+            for (libember::dom::Set::const_iterator it = set.begin(); it != last; ++it)
+            {
+                sum += it->applicationTag().number();
+            }
+        }
+        return sum;
+    }
+
+    /**
+     * Iterates @p iterations times over the children of @p set with the concrete
+     * child iterators and returns the sum of the tag numbers of all visited children.
+     */
+    unsigned long iterateChildren(libember::dom::Set const& set, int iterations)
+    {
+        unsigned long sum = 0;
+        for (int i = 0; i < iterations; ++i)
+        {
+            libember::dom::Set::const_child_iterator const last = set.childEnd();
+            for (libember::dom::Set::const_child_iterator it = set.childBegin(); it != last; ++it)
+            {
+                sum += it->applicationTag().number();
+            }
+        }
+        return sum;
+    }
+
+    /**
+     * Looks up every child of @p set by its tag @p iterations times and returns
+     * the number of successful lookups.
+     */
+    unsigned long find(libember::dom::Set const& set, int count, int iterations)
+    {
+        using namespace libember;
+
+        unsigned long found = 0;
+        for (int i = 0; i < iterations; ++i)
+        {
+            for (int number = 0; number < count; ++number)
+            {
+                dom::Set::const_iterator const first = set.begin();
+                dom::Set::const_iterator const last = set.end();
+                if (glow::util::find_tag(first, last, ber::make_tag(ber::Class::ContextSpecific, number)) != last)
+                {
+                    found += 1;
+                }
+            }
+        }
+        return found;
+    }
+}
+
+int main(int, char const* const*)
+{
+    try
+    {
+        int const sizes[] = { 4, 8, 64, 1024 };
+        for (std::size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i)
+        {
+            int const count = sizes[i];
+            int const iterations = (1 << 20) / count;
+            std::auto_ptr<libember::dom::Set> const set(createSet(count));
+
+            std::clock_t start = std::clock();
+            unsigned long const sum = iterate(*set, iterations);
+            double const iterateTime = elapsed(start);
+
+            start = std::clock();
+            unsigned long const childSum = iterateChildren(*set, iterations);
+            double const iterateChildrenTime = elapsed(start);
+
+            int const findIterations = count > 64 ? iterations / count : iterations;
+            start = std::clock();
+            unsigned long const found = find(*set, count, findIterations);
+            double const findTime = elapsed(start);
+
+            unsigned long const expectedSum = static_cast<unsigned long>(count) * (count - 1) / 2 * iterations;
+            if (sum != expectedSum)
+            {
+                THROW_TEST_EXCEPTION("Iteration returned a tag sum of " << sum << ", expected " << expectedSum);
+            }
+            if (childSum != expectedSum)
+            {
+                THROW_TEST_EXCEPTION("Iteration of the children returned a tag sum of " << childSum << ", expected " << expectedSum);
+            }
+            if (found != static_cast<unsigned long>(count) * findIterations)
+            {
+                THROW_TEST_EXCEPTION("Lookup found " << found << " children, expected " << count * findIterations);
+            }
+
+            std::cout << count << " children: iterate " << iterateTime << " ms, iterate children " << iterateChildrenTime << " ms, find " << findTime << " ms" << std::endl;
+        }
+    }
+    catch (std::exception const& e)
+    {
+        std::cerr << "ERROR: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,245 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+#include "ember/Ember.hpp"
+
+#define THROW_TEST_EXCEPTION(message)                       \
+            {                                               \
+                std::ostringstream msgStream;               \
+                msgStream << message ;                      \
+                throw std::runtime_error(msgStream.str());  \
+            }
+
+namespace
+{
+    using namespace libember;
+
+    dom::VariantLeaf* createLeaf(int number)
+    {
+        return new dom::VariantLeaf(ber::make_tag(ber::Class::ContextSpecific, 0), number);
+    }
+
+    /**
+     * Returns the encoding of a node.
+     */
+    std::vector<unsigned char> encode(dom::Node const& node)
+    {
+        util::OctetStream stream;
+        node.encode(stream);
+        return std::vector<unsigned char>(stream.begin(), stream.end());
+    }
+
+    /**
+     * Verifies that the leaves of a sequence contain the values 0 to count - 1 and are
+     * owned by the sequence.
+     */
+    void verifyOrder(dom::Sequence const& sequence, int count)
+    {
+        if (sequence.size() != static_cast<dom::Sequence::size_type>(count))
+        {
+            THROW_TEST_EXCEPTION("The sequence contains " << sequence.size() << " nodes, expected " << count);
+        }
+
+        int expected = 0;
+        dom::Sequence::const_iterator const last = sequence.end();
+        for (dom::Sequence::const_iterator it = sequence.begin(); it != last; ++it, ++expected)
+        {
+            dom::VariantLeaf const& leaf = static_cast<dom::VariantLeaf const&>(*it);
+            if (leaf.parent() != &sequence || leaf.value().as<int>() != expected)
+            {
+                THROW_TEST_EXCEPTION("The node at position " << expected << " is wrong");
+            }
+        }
+    }
+
+    void testAppend()
+    {
+        int const count = 1000;
+        std::vector<dom::Node*> nodes;
+        for (int i = 0; i < count; ++i)
+        {
+            nodes.push_back(createLeaf(i));
+        }
+
+        dom::Sequence sequence(ber::make_tag(ber::Class::ContextSpecific, 1));
+        sequence.append(nodes.begin(), nodes.end());
+        verifyOrder(sequence, count);
+
+        dom::Sequence expected(ber::make_tag(ber::Class::ContextSpecific, 1));
+        for (int i = 0; i < count; ++i)
+        {
+            expected.insert(expected.end(), createLeaf(i));
+        }
+
+        if (encode(sequence) != encode(expected))
+        {
+            THROW_TEST_EXCEPTION("Appending a range encodes differently than inserting the nodes one by one");
+        }
+    }
+
+    void testInsertInFront()
+    {
+        dom::Sequence sequence(ber::make_tag(ber::Class::ContextSpecific, 1));
+        sequence.insert(sequence.end(), createLeaf(0));
+        sequence.insert(sequence.end(), createLeaf(3));
+        // Encoding caches the length of the sequence, which has to be invalidated by the range insert.
+        encode(sequence);
+
+        dom::Node* nodes[] = { createLeaf(1), createLeaf(2) };
+        dom::Sequence::iterator where = sequence.begin();
+        sequence.insert(++where, nodes, nodes + 2);
+        verifyOrder(sequence, 4);
+
+        std::vector<dom::Node*> more;
+        for (int i = 4; i < 24; ++i)
+        {
+            more.push_back(createLeaf(i));
+        }
+        sequence.insert(sequence.end(), more.begin() + 10, more.end());
+        where = sequence.begin();
+        for (int i = 0; i < 4; ++i)
+        {
+            ++where;
+        }
+        sequence.insert(where, more.begin(), more.begin() + 10);
+        verifyOrder(sequence, 24);
+
+        dom::Sequence expected(ber::make_tag(ber::Class::ContextSpecific, 1));
+        for (int i = 0; i < 24; ++i)
+        {
+            expected.insert(expected.end(), createLeaf(i));
+        }
+
+        if (encode(sequence) != encode(expected))
+        {
+            THROW_TEST_EXCEPTION("The cached length has not been updated by a range insert");
+        }
+    }
+
+    void testOwnedNode()
+    {
+        dom::Sequence owner(ber::make_tag(ber::Class::ContextSpecific, 1));
+        dom::Node* const owned = createLeaf(1);
+        owner.insert(owner.end(), owned);
+
+        std::auto_ptr<dom::Node> const free(createLeaf(0));
+        dom::Node* nodes[] = { free.get(), owned };
+
+        dom::Sequence sequence(ber::make_tag(ber::Class::ContextSpecific, 1));
+        try
+        {
+            sequence.insert(sequence.end(), nodes, nodes + 2);
+            THROW_TEST_EXCEPTION("A range containing an owned node has been inserted");
+        }
+        catch (std::runtime_error const&)
+        {
+        }
+
+        if (sequence.empty() == false || free->parent() != 0)
+        {
+            THROW_TEST_EXCEPTION("A node of a rejected range has been inserted");
+        }
+    }
+
+    void testElementCollection()
+    {
+        int const count = 2000;
+        std::vector<dom::Node*> nodes;
+        for (int i = 1; i <= count; ++i)
+        {
+            glow::GlowNode* const node = new glow::GlowNode(i);
+            node->setIdentifier("node");
+            nodes.push_back(node);
+        }
+
+        std::auto_ptr<glow::GlowRootElementCollection> const root(glow::GlowRootElementCollection::create());
+        root->append(nodes.begin(), nodes.end());
+
+        std::auto_ptr<glow::GlowRootElementCollection> const expected(glow::GlowRootElementCollection::create());
+        for (int i = 1; i <= count; ++i)
+        {
+            glow::GlowNode* const node = new glow::GlowNode(expected.get(), i);
+            node->setIdentifier("node");
+        }
+
+        if (root->size() != static_cast<dom::Container::size_type>(count) || encode(*root) != encode(*expected))
+        {
+            THROW_TEST_EXCEPTION("Appending elements to a collection encodes differently than inserting them one by one");
+        }
+    }
+
+    /**
+     * Verifies that the property index of a glow element notices a direct
+     * modification of its content set that keeps the number of properties.
+     */
+    void testContentIndex()
+    {
+        glow::GlowNode node(1);
+        node.setIdentifier("identifier");
+        node.setDescription("description");
+        if (node.identifier() != "identifier")
+        {
+            THROW_TEST_EXCEPTION("Unexpected identifier " << node.identifier());
+        }
+
+        dom::Container* contents = 0;
+        for (dom::Container::iterator it = node.begin(); it != node.end(); ++it)
+        {
+            if (it->applicationTag() == glow::GlowTags::Node::Contents())
+            {
+                contents = dynamic_cast<dom::Container*>(&*it);
+            }
+        }
+
+        if (contents == 0 || contents->size() != 2)
+        {
+            THROW_TEST_EXCEPTION("The content set of a node has not been found");
+        }
+
+        contents->erase(contents->begin());
+        contents->insert(contents->end(), new dom::VariantLeaf(glow::GlowTags::NodeContents::Identifier(), std::string("replaced")));
+        if (node.identifier() != "replaced" || node.description() != "description")
+        {
+            THROW_TEST_EXCEPTION("A replaced property is looked up as " << node.identifier());
+        }
+    }
+}
+
+int main(int, char const* const*)
+{
+    try
+    {
+        testAppend();
+        testInsertInFront();
+        testOwnedNode();
+        testElementCollection();
+        testContentIndex();
+    }
+    catch (std::exception const& e)
+    {
+        std::cerr << "ERROR: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,306 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+#include "ember/Ember.hpp"
+
+#define THROW_TEST_EXCEPTION(message)                       \
+            {                                               \
+                std::ostringstream msgStream;               \
+                msgStream << message ;                      \
+                throw std::runtime_error(msgStream.str());  \
+            }
+
+namespace
+{
+    typedef std::vector<unsigned char> ByteVector;
+    typedef libember::dom::FlatTree FlatTree;
+
+    /**
+     * Encodes the passed node into a byte vector.
+     * @param node The node to encode.
+     * @param indefinite Specifies whether containers use the indefinite length form.
+     * @return The encoded bytes.
+     */
+    ByteVector encode(libember::dom::Node const& node, bool indefinite = false)
+    {
+        libember::util::OctetStream stream;
+        if (indefinite)
+        {
+            node.encodeIndefinite(stream);
+        }
+        else
+        {
+            node.encode(stream);
+        }
+        return ByteVector(stream.begin(), stream.end());
+    }
+
+    /**
+     * Encodes the passed value into a byte vector.
+     * @param value The value to encode.
+     * @return The encoded bytes.
+     */
+    ByteVector encode(libember::ber::Value const& value)
+    {
+        libember::util::OctetStream stream;
+        value.encode(stream);
+        return ByteVector(stream.begin(), stream.end());
+    }
+
+    /**
+     * Creates a small glow tree containing nodes and parameters of all common value types.
+     * @param count The number of nodes below the root.
+     * @return The root of the created tree.
+     */
+    libember::glow::GlowRootElementCollection* createTree(int count)
+    {
+        using namespace libember::glow;
+
+        GlowRootElementCollection* const root = GlowRootElementCollection::create();
+        for (int i = 1; i <= count; ++i)
+        {
+            GlowNode* const node = new GlowNode(root, i);
+            std::ostringstream identifier;
+            identifier << "node" << i;
+            node->setIdentifier(identifier.str());
+            node->setDescription(std::string(static_cast<std::size_t>(i * 37), 'x'));
+
+            for (int j = 1; j <= 4; ++j)
+            {
+                GlowParameter* const parameter = new GlowParameter(node, j);
+                parameter->setIdentifier("parameter");
+                parameter->setMinimum(-1000 * j);
+                switch (j % 4)
+                {
+                    case 0:
+                        parameter->setValue(static_cast<long>(i * j * 1234567));
+                        break;
+                    case 1:
+                        parameter->setValue(i * 0.5);
+                        break;
+                    case 2:
+                        parameter->setValue(j % 2 == 0);
+                        break;
+                    default:
+                        parameter->setValue(std::string(static_cast<std::size_t>(j * 100), 'v'));
+                        break;
+                }
+            }
+        }
+        return root;
+    }
+
+    /**
+     * Compares the element of a flat tree at @p index with the decoded node @p node
+     * and all of their descendants.
+     * @param tree The flat tree.
+     * @param index The index of the element to compare.
+     * @param node The node to compare the element with.
+     */
+    void compare(FlatTree const& tree, FlatTree::size_type index, libember::dom::Node const& node)
+    {
+        FlatTree::Record const& record = tree[index];
+        if (record.applicationTag != node.applicationTag()
+         || record.typeTag.number() != node.typeTag().number()
+         || record.typeTag.getClass() != node.typeTag().getClass())
+        {
+            THROW_TEST_EXCEPTION("Tag mismatch at index " << index);
+        }
+
+        libember::dom::Container const* const container = dynamic_cast<libember::dom::Container const*>(&node);
+        if (record.isContainer != (container != 0))
+        {
+            THROW_TEST_EXCEPTION("Container mismatch at index " << index);
+        }
+
+        if (container != 0)
+        {
+            if (tree.childCount(index) != container->size())
+            {
+                THROW_TEST_EXCEPTION("Child count mismatch at index " << index);
+            }
+
+            FlatTree::size_type child = record.firstChild;
+            libember::dom::Container::const_iterator const last = container->end();
+            for (libember::dom::Container::const_iterator it = container->begin(); it != last; ++it)
+            {
+                if (tree[child].parent != index)
+                {
+                    THROW_TEST_EXCEPTION("Parent mismatch at index " << child);
+                }
+
+                compare(tree, child, *it);
+                child = tree[child].nextSibling;
+            }
+        }
+        else
+        {
+            libember::dom::VariantLeaf const& leaf = dynamic_cast<libember::dom::VariantLeaf const&>(node);
+            libember::ber::Value const value = tree.value(index);
+            if (value.typeId() != leaf.value().typeId() || encode(value) != encode(leaf.value()))
+            {
+                THROW_TEST_EXCEPTION("Value mismatch at index " << index);
+            }
+        }
+    }
+
+    /**
+     * Verifies that a flat tree built from @p encoded matches the tree decoded by a DomReader.
+     * @param tree The flat tree to assign the encoded tree to.
+     * @param encoded The encoded tree.
+     */
+    void testAssign(FlatTree& tree, ByteVector const& encoded)
+    {
+        tree.assign(&encoded.front(), &encoded.front() + encoded.size());
+
+        libember::util::OctetStream stream;
+        stream.append(encoded.begin(), encoded.end());
+        libember::dom::DomReader reader;
+        std::auto_ptr<libember::dom::Node> const root(reader.decodeTree(stream, libember::glow::GlowNodeFactory::getFactory()));
+
+        compare(tree, 0, *root);
+        if (tree[0].parent != FlatTree::npos || tree[0].nextSibling != FlatTree::npos)
+        {
+            THROW_TEST_EXCEPTION("The root is linked to another element");
+        }
+    }
+
+    /**
+     * Verifies the lookup of children by their tag.
+     * @param encoded The encoded tree created by createTree().
+     */
+    void testFind(ByteVector const& encoded)
+    {
+        using namespace libember;
+
+        FlatTree const tree(&encoded.front(), &encoded.front() + encoded.size());
+
+        // The elements of the root collection are encoded with the default element tag.
+        FlatTree::size_type const node = tree.find(0, glow::GlowTags::ElementDefault());
+        if (node == FlatTree::npos || tree.type(node).value() != glow::GlowType::Node)
+        {
+            THROW_TEST_EXCEPTION("The first element of the root is not a node");
+        }
+
+        FlatTree::size_type const number = tree.find(node, glow::GlowTags::Node::Number());
+        if (number == FlatTree::npos || tree.value(number).as<int>() != 1)
+        {
+            THROW_TEST_EXCEPTION("The number of the first node has not been found");
+        }
+
+        if (tree.find(node, ber::make_tag(ber::Class::ContextSpecific, 99)) != FlatTree::npos)
+        {
+            THROW_TEST_EXCEPTION("A missing tag has been found");
+        }
+    }
+
+    /**
+     * Verifies that malformed input is rejected and leaves the tree empty.
+     * @param encoded The encoding of a valid tree.
+     */
+    void testMalformed(ByteVector const& encoded)
+    {
+        FlatTree tree(&encoded.front(), &encoded.front() + encoded.size());
+        try
+        {
+            tree.assign(&encoded.front(), &encoded.front() + encoded.size() - 1);
+        }
+        catch (std::runtime_error const&)
+        {
+            if (tree.empty() == false)
+            {
+                THROW_TEST_EXCEPTION("A failed assignment left elements in the tree");
+            }
+            return;
+        }
+        THROW_TEST_EXCEPTION("A truncated tree has been accepted");
+    }
+
+    /**
+     * Verifies that deeply nested input is indexed without exhausting the stack,
+     * and that it is rejected if its containers are not terminated.
+     */
+    void testDeeplyNested()
+    {
+        unsigned char const header[] = { 0x60, 0x80, 0x30, 0x80 };
+        std::size_t const depth = 100000;
+
+        ByteVector nested;
+        for (std::size_t i = 0; i < depth; ++i)
+        {
+            nested.insert(nested.end(), header, header + sizeof(header));
+        }
+
+        FlatTree tree;
+        bool isRejected = false;
+        try
+        {
+            tree.assign(&nested.front(), &nested.front() + nested.size());
+        }
+        catch (std::runtime_error const&)
+        {
+            isRejected = true;
+        }
+
+        if (isRejected == false || tree.empty() == false)
+        {
+            THROW_TEST_EXCEPTION("Unterminated nested input has been accepted");
+        }
+
+        // The innermost container is empty, each level is closed by two terminators.
+        nested.insert(nested.end(), depth * 4, 0x00);
+        tree.assign(&nested.front(), &nested.front() + nested.size());
+        if (tree.size() != depth)
+        {
+            THROW_TEST_EXCEPTION("Nested input produced " << tree.size() << " instead of " << depth << " elements");
+        }
+    }
+}
+
+int main(int, char const* const*)
+{
+    try
+    {
+        std::auto_ptr<libember::glow::GlowRootElementCollection> const small(createTree(3));
+        std::auto_ptr<libember::glow::GlowRootElementCollection> const large(createTree(20));
+        ByteVector const encoded = encode(*large);
+
+        // The same tree is reused for messages of different sizes.
+        FlatTree tree;
+        testAssign(tree, encoded);
+        testAssign(tree, encode(*small));
+        testAssign(tree, encode(*large, true));
+        testAssign(tree, encoded);
+
+        testFind(encoded);
+        testMalformed(encoded);
+        testDeeplyNested();
+    }
+    catch (std::exception const& e)
+    {
+        std::cerr << "ERROR: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,313 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+#include "ember/Ember.hpp"
+
+#define THROW_TEST_EXCEPTION(message)                       \
+            {                                               \
+                std::ostringstream msgStream;               \
+                msgStream << message ;                      \
+                throw std::runtime_error(msgStream.str());  \
+            }
+
+namespace
+{
+    typedef std::vector<unsigned char> ByteVector;
+    typedef libember::dom::LazyDocument LazyDocument;
+
+    /**
+     * Encodes the passed node into a byte vector.
+     * @param node The node to encode.
+     * @param indefinite Specifies whether containers use the indefinite length form.
+     * @return The encoded bytes.
+     */
+    ByteVector encode(libember::dom::Node const& node, bool indefinite = false)
+    {
+        libember::util::OctetStream stream;
+        if (indefinite)
+        {
+            node.encodeIndefinite(stream);
+        }
+        else
+        {
+            node.encode(stream);
+        }
+        return ByteVector(stream.begin(), stream.end());
+    }
+
+    /**
+     * Creates a tree of universal containers and leaves of all supported value types.
+     * @return The root of the created tree.
+     */
+    libember::dom::Sequence* createUniversalTree()
+    {
+        using namespace libember;
+
+        dom::Sequence* const root = new dom::Sequence(ber::make_tag(ber::Class::Application, 1));
+        root->insert(root->end(), new dom::VariantLeaf(ber::make_tag(ber::Class::ContextSpecific, 0), 42));
+        root->insert(root->end(), new dom::VariantLeaf(ber::make_tag(ber::Class::ContextSpecific, 1), std::string("identifier")));
+
+        dom::Set* const set = new dom::Set(ber::make_tag(ber::Class::ContextSpecific, 2));
+        ber::ObjectIdentifier path;
+        path.push_back(1);
+        path.push_back(200);
+        unsigned char const bytes[] = { 0x00, 0xFF };
+        ber::Octets const octets(bytes, bytes + sizeof(bytes));
+        set->insert(set->end(), new dom::VariantLeaf(ber::make_tag(ber::Class::ContextSpecific, 0), 1234567890123L));
+        set->insert(set->end(), new dom::VariantLeaf(ber::make_tag(ber::Class::ContextSpecific, 1), 0.25));
+        set->insert(set->end(), new dom::VariantLeaf(ber::make_tag(ber::Class::ContextSpecific, 2), true));
+        set->insert(set->end(), new dom::VariantLeaf(ber::make_tag(ber::Class::ContextSpecific, 3), path));
+        set->insert(set->end(), new dom::VariantLeaf(ber::make_tag(ber::Class::ContextSpecific, 4), octets));
+        root->insert(root->end(), set);
+
+        root->insert(root->end(), new dom::Sequence(ber::make_tag(ber::Class::ContextSpecific, 3)));
+        root->insert(root->end(), new dom::VariantLeaf(ber::make_tag(ber::Class::ContextSpecific, 4), -7));
+        return root;
+    }
+
+    /**
+     * Creates a small glow tree of nodes and parameters.
+     * @return The root of the created tree.
+     */
+    libember::glow::GlowRootElementCollection* createGlowTree()
+    {
+        using namespace libember::glow;
+
+        GlowRootElementCollection* const root = GlowRootElementCollection::create();
+        for (int i = 1; i <= 5; ++i)
+        {
+            GlowNode* const node = new GlowNode(root, i);
+            std::ostringstream identifier;
+            identifier << "node" << i;
+            node->setIdentifier(identifier.str());
+
+            for (int j = 1; j <= 3; ++j)
+            {
+                GlowParameter* const parameter = new GlowParameter(node, j);
+                parameter->setIdentifier("parameter");
+                parameter->setValue(i * 100 + j);
+            }
+        }
+        return root;
+    }
+
+    /**
+     * Verifies the scanned structure and the leaf values of the tree created by
+     * createUniversalTree().
+     * @param encoded The encoded tree.
+     * @param expected The encoding a materialized root must reproduce.
+     */
+    void testUniversal(ByteVector const& encoded, ByteVector const& expected)
+    {
+        using namespace libember;
+
+        LazyDocument const document(&encoded.front(), &encoded.front() + encoded.size());
+        LazyDocument::Element const root = document.root();
+
+        if (document.elementCount() != 11 || document.encodedLength() != encoded.size())
+        {
+            THROW_TEST_EXCEPTION("Unexpected number of elements: " << document.elementCount());
+        }
+        if (root.isContainer() == false || root.childCount() != 5 || root.type().value() != ber::Type::Sequence
+         || root.applicationTag() != ber::make_tag(ber::Class::Application, 1) || root.parent().isNull() == false)
+        {
+            THROW_TEST_EXCEPTION("Unexpected root element");
+        }
+
+        LazyDocument::Element const number = root.firstChild();
+        LazyDocument::Element const identifier = number.nextSibling();
+        if (number.value().as<int>() != 42 || identifier.value().as<std::string>() != "identifier")
+        {
+            THROW_TEST_EXCEPTION("Unexpected values of the leaves of the root");
+        }
+
+        LazyDocument::Element const set = root.find(ber::make_tag(ber::Class::ContextSpecific, 2));
+        if (set != root.child(2) || set.parent() != root || set.childCount() != 5 || set.value())
+        {
+            THROW_TEST_EXCEPTION("Unexpected set element");
+        }
+
+        ber::ObjectIdentifier const path = set.child(3).value().as<ber::ObjectIdentifier>();
+        ber::Octets const octets = set.child(4).value().as<ber::Octets>();
+        if (set.child(0).value().as<long>() != 1234567890123L
+         || set.child(1).value().as<double>() != 0.25
+         || set.child(2).value().as<bool>() != true
+         || path.size() != 2 || path[1] != 200
+         || octets.size() != 2 || *(octets.begin() + 1) != 0xFF
+         || set.child(4).nextSibling().isNull() == false || set.nextSibling() != root.child(3))
+        {
+            THROW_TEST_EXCEPTION("Unexpected values of the leaves of the set");
+        }
+
+        LazyDocument::Element const empty = root.child(3);
+        if (empty.childCount() != 0 || empty.firstChild().isNull() == false
+         || root.child(4).value().as<int>() != -7 || root.child(5).isNull() == false
+         || root.find(ber::make_tag(ber::Class::ContextSpecific, 9)).isNull() == false)
+        {
+            THROW_TEST_EXCEPTION("Unexpected trailing elements");
+        }
+
+        std::auto_ptr<dom::Node> const node(root.materialize(glow::GlowNodeFactory::getFactory()));
+        if (node.get() == 0 || encode(*node) != expected)
+        {
+            THROW_TEST_EXCEPTION("The materialized root does not match the original tree");
+        }
+
+        std::auto_ptr<dom::Node> const leaf(set.child(1).materialize(glow::GlowNodeFactory::getFactory()));
+        dom::VariantLeaf const* const variant = dynamic_cast<dom::VariantLeaf const*>(leaf.get());
+        if (variant == 0 || variant->value().as<double>() != 0.25 || variant->applicationTag() != ber::make_tag(ber::Class::ContextSpecific, 1))
+        {
+            THROW_TEST_EXCEPTION("The materialized leaf does not match the original leaf");
+        }
+    }
+
+    /**
+     * Verifies that a single element of a glow tree can be materialized without
+     * touching the rest of the document.
+     */
+    void testGlow()
+    {
+        using namespace libember;
+
+        std::auto_ptr<glow::GlowRootElementCollection> const tree(createGlowTree());
+        ByteVector const encoded = encode(*tree);
+        LazyDocument const document(&encoded.front(), &encoded.front() + encoded.size());
+
+        std::auto_ptr<dom::Node> const root(document.root().materialize(glow::GlowNodeFactory::getFactory()));
+        if (root.get() == 0 || dynamic_cast<glow::GlowRootElementCollection const*>(root.get()) == 0 || encode(*root) != encoded)
+        {
+            THROW_TEST_EXCEPTION("The materialized glow root does not match the original tree");
+        }
+
+        // The third child of the root collection is the node with the number 3.
+        dom::Container::const_iterator original = tree->begin();
+        std::advance(original, 2);
+        LazyDocument::Element const third = document.root().child(2);
+        if (ByteVector(third.begin(), third.end()) != encode(*original))
+        {
+            THROW_TEST_EXCEPTION("The encoded range of an element does not match the original node");
+        }
+
+        std::auto_ptr<dom::Node> const child(third.materialize(glow::GlowNodeFactory::getFactory()));
+        glow::GlowNode const* const node = dynamic_cast<glow::GlowNode const*>(child.get());
+        if (node == 0 || node->number() != 3 || node->identifier() != "node3" || encode(*node) != encode(*original))
+        {
+            THROW_TEST_EXCEPTION("The materialized glow node does not match the original node");
+        }
+    }
+
+    /**
+     * Verifies that incomplete and malformed input is rejected.
+     * @param encoded The encoding of a valid tree.
+     */
+    void testMalformed(ByteVector const& encoded)
+    {
+        unsigned char const universalOuterTag[] = { 0x30, 0x03, 0x02, 0x01, 0x00 };
+        unsigned char const lengthMismatch[] = { 0x61, 0x04, 0x30, 0x00, 0x00, 0x00 };
+        unsigned char const leafRoot[] = { 0x61, 0x03, 0x02, 0x01, 0x05 };
+
+        ByteVector const truncated(encoded.begin(), encoded.end() - 1);
+        ByteVector const inputs[] =
+        {
+            truncated,
+            ByteVector(universalOuterTag, universalOuterTag + sizeof(universalOuterTag)),
+            ByteVector(lengthMismatch, lengthMismatch + sizeof(lengthMismatch)),
+            ByteVector(leafRoot, leafRoot + sizeof(leafRoot)),
+        };
+
+        for (std::size_t i = 0; i < sizeof(inputs) / sizeof(inputs[0]); ++i)
+        {
+            try
+            {
+                LazyDocument const document(&inputs[i].front(), &inputs[i].front() + inputs[i].size());
+            }
+            catch (std::runtime_error const&)
+            {
+                continue;
+            }
+            THROW_TEST_EXCEPTION("Malformed input " << i << " has been accepted");
+        }
+    }
+
+    /**
+     * Verifies that deeply nested input is scanned without exhausting the stack,
+     * and that it is rejected if its containers are not terminated.
+     */
+    void testDeeplyNested()
+    {
+        unsigned char const header[] = { 0x60, 0x80, 0x30, 0x80 };
+        std::size_t const depth = 100000;
+
+        ByteVector nested;
+        for (std::size_t i = 0; i < depth; ++i)
+        {
+            nested.insert(nested.end(), header, header + sizeof(header));
+        }
+
+        bool isRejected = false;
+        try
+        {
+            LazyDocument const document(&nested.front(), &nested.front() + nested.size());
+        }
+        catch (std::runtime_error const&)
+        {
+            isRejected = true;
+        }
+
+        if (isRejected == false)
+        {
+            THROW_TEST_EXCEPTION("Unterminated nested input has been accepted");
+        }
+
+        // The innermost container is empty, each level is closed by two terminators.
+        nested.insert(nested.end(), depth * 4, 0x00);
+        LazyDocument const document(&nested.front(), &nested.front() + nested.size());
+    }
+}
+
+int main(int, char const* const*)
+{
+    try
+    {
+        std::auto_ptr<libember::dom::Sequence> const tree(createUniversalTree());
+        ByteVector const definite = encode(*tree);
+        ByteVector const indefinite = encode(*tree, true);
+        if (definite == indefinite)
+        {
+            THROW_TEST_EXCEPTION("Indefinite length encoding produced definite length containers");
+        }
+
+        testUniversal(definite, definite);
+        testUniversal(indefinite, definite);
+        testGlow();
+        testMalformed(definite);
+        testDeeplyNested();
+    }
+    catch (std::exception const& e)
+    {
+        std::cerr << "ERROR: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
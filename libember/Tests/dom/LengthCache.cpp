@@ -0,0 +1,151 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+#include "ember/Ember.hpp"
+
+#define THROW_TEST_EXCEPTION(message)                       \
+            {                                               \
+                std::ostringstream msgStream;               \
+                msgStream << message ;                      \
+                throw std::runtime_error(msgStream.str());  \
+            }
+
+namespace
+{
+    typedef std::vector<unsigned char> ByteVector;
+
+    /**
+     * Creates a tree of nested sequences whose leaves are stored in @p leaves.
+     * @param leaves Receives the leaves of the tree.
+     * @return The root of the created tree.
+     */
+    libember::dom::Sequence* createTree(std::vector<libember::dom::VariantLeaf*>& leaves)
+    {
+        using namespace libember;
+
+        dom::Sequence* const root = new dom::Sequence(ber::make_tag(ber::Class::Application, 0));
+        for (int i = 0; i < 20; ++i)
+        {
+            dom::Sequence* const node = new dom::Sequence(ber::make_tag(ber::Class::ContextSpecific, i));
+            for (int j = 0; j < 5; ++j)
+            {
+                dom::Sequence* const contents = new dom::Sequence(ber::make_tag(ber::Class::ContextSpecific, j));
+                dom::VariantLeaf* const leaf = new dom::VariantLeaf(ber::make_tag(ber::Class::ContextSpecific, 0), std::string("value"));
+                contents->insert(contents->end(), leaf);
+                contents->insert(contents->end(), new dom::VariantLeaf(ber::make_tag(ber::Class::ContextSpecific, 1), i * j));
+                node->insert(node->end(), contents);
+                leaves.push_back(leaf);
+            }
+            root->insert(root->end(), node);
+        }
+        return root;
+    }
+
+    /**
+     * Encodes the passed node into a byte vector.
+     * @param node The node to encode.
+     * @return The encoded bytes.
+     */
+    ByteVector encode(libember::dom::Node const& node)
+    {
+        libember::util::OctetStream stream;
+        node.encode(stream);
+        return ByteVector(stream.begin(), stream.end());
+    }
+
+    /**
+     * Verifies that the cached lengths of @p root match those of a copy, which
+     * calculates all of its lengths from scratch.
+     * @param root The tree to verify.
+     * @param step A description of the preceding modification.
+     */
+    void verify(libember::dom::Node const& root, char const* step)
+    {
+        std::auto_ptr<libember::dom::Node> const copy(root.clone());
+        ByteVector const expected = encode(*copy);
+        if (root.encodedLength() != expected.size() || encode(root) != expected)
+        {
+            THROW_TEST_EXCEPTION("The cached lengths are wrong after " << step);
+        }
+    }
+}
+
+int main(int, char const* const*)
+{
+    try
+    {
+        using namespace libember;
+
+        std::vector<dom::VariantLeaf*> leaves;
+        std::auto_ptr<dom::Sequence> const root(createTree(leaves));
+        verify(*root, "the initial encoding");
+
+        leaves[7]->setValue(ber::Value(std::string(300, 'x')));
+        verify(*root, "growing a value beyond the short length form");
+
+        leaves[7]->setValue(ber::Value(std::string("short")));
+        leaves[8]->setValue(ber::Value(std::string(1000, 'y')));
+        leaves[9]->setValue(ber::Value(42));
+        verify(*root, "changing several values");
+
+        // the leaf is updated on its own and changed again before its parent is updated
+        leaves[3]->setValue(ber::Value(std::string(200, 'z')));
+        leaves[3]->encodedLength();
+        leaves[3]->setValue(ber::Value(std::string(20, 'z')));
+        verify(*root, "changing a value twice");
+
+        // the parent of a changed leaf is updated before the root
+        leaves[4]->setValue(ber::Value(std::string(5000, 'w')));
+        leaves[4]->parent()->encodedLength();
+        leaves[5]->setValue(ber::Value(std::string(130, 'v')));
+        verify(*root, "updating a subtree before the root");
+
+        dom::Container* const node = dynamic_cast<dom::Container*>(leaves[10]->parent()->parent());
+        leaves[10]->setValue(ber::Value(std::string(400, 'u')));
+        node->insert(node->end(), new dom::VariantLeaf(ber::make_tag(ber::Class::ContextSpecific, 9), std::string(150, 't')));
+        verify(*root, "inserting a node next to a changed one");
+
+        leaves[10]->setValue(ber::Value(std::string(700, 's')));
+        leaves[11]->setValue(ber::Value(std::string(600, 's')));
+        node->erase(node->begin());
+        leaves.erase(leaves.begin() + 10);
+        verify(*root, "erasing a changed node");
+
+        for (std::size_t i = 0; i < leaves.size(); ++i)
+        {
+            leaves[i]->setValue(ber::Value(std::string(i * 13, 'r')));
+            if (i % 7 == 0)
+            {
+                verify(*root, "changing all values");
+            }
+        }
+        verify(*root, "changing all values");
+    }
+    catch (std::exception const& e)
+    {
+        std::cerr << "ERROR: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
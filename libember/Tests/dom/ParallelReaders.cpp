@@ -0,0 +1,309 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+/*
+ * Decodes the same messages with several AsyncDomReader instances on different
+ * threads at the same time, as a provider with one decoding thread per connection
+ * does, and verifies that every reader produces the tree a single reader produces.
+ * The dynamic decoding of universally tagged values, which uses the global decoder
+ * factory, is exercised the same way.
+ * The test uses posix threads.
+ */
+
+#include <pthread.h>
+#include <sys/time.h>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "ember/Ember.hpp"
+
+#define THROW_TEST_EXCEPTION(message)                       \
+            {                                               \
+                std::ostringstream msgStream;               \
+                msgStream << message ;                      \
+                throw std::runtime_error(msgStream.str());  \
+            }
+
+namespace
+{
+    typedef std::vector<unsigned char> ByteVector;
+
+    /** The number of readers running at the same time. */
+    unsigned int const READER_COUNT = 8;
+
+    /** The number of times each reader decodes the messages. */
+    unsigned int const ITERATIONS = 40;
+
+    /** The number of universally tagged values in the encoded value sequence. */
+    unsigned int const VALUE_COUNT = 1000;
+
+    /**
+     * Creates a glow tree containing nodes and parameters of all common value types.
+     * @return The root of the created tree.
+     */
+    libember::glow::GlowRootElementCollection* createTree()
+    {
+        using namespace libember::glow;
+
+        GlowRootElementCollection* const root = GlowRootElementCollection::create();
+        for (int i = 1; i <= 50; ++i)
+        {
+            GlowNode* const node = new GlowNode(root, i);
+            std::ostringstream identifier;
+            identifier << "node" << i;
+            node->setIdentifier(identifier.str());
+
+            for (int j = 1; j <= 20; ++j)
+            {
+                GlowParameter* const parameter = new GlowParameter(node, j);
+                parameter->setIdentifier("parameter");
+                switch (j % 4)
+                {
+                    case 0:
+                        parameter->setValue(static_cast<long>(i * j * 1234567));
+                        break;
+                    case 1:
+                        parameter->setValue(i * 0.25);
+                        break;
+                    case 2:
+                        parameter->setValue(true);
+                        break;
+                    default:
+                        parameter->setValue(std::string(static_cast<std::size_t>(j * 10), 'v'));
+                        break;
+                }
+            }
+        }
+        return root;
+    }
+
+    /**
+     * Encodes the passed node into a byte vector.
+     * @param node The node to encode.
+     * @return The encoded bytes.
+     */
+    ByteVector encode(libember::dom::Node const& node)
+    {
+        libember::util::OctetStream stream;
+        node.encode(stream);
+        return ByteVector(stream.begin(), stream.end());
+    }
+
+    /**
+     * Returns the value at position @p i of the encoded value sequence.
+     */
+    libember::ber::Value generateValue(unsigned int i)
+    {
+        switch (i % 4)
+        {
+            case 0:
+                return static_cast<long>(i * 1000);
+            case 1:
+                return static_cast<double>(i) * 0.5;
+            case 2:
+                return (i % 8) == 2;
+            default:
+                return std::string("value");
+        }
+    }
+
+    /**
+     * Encodes the value sequence as universally tagged frames.
+     * @return The encoded bytes.
+     */
+    ByteVector encodeValues()
+    {
+        libember::util::OctetStream stream;
+        for (unsigned int i = 0; i < VALUE_COUNT; ++i)
+        {
+            libember::ber::encodeFrame(stream, generateValue(i));
+        }
+        return ByteVector(stream.begin(), stream.end());
+    }
+
+    /**
+     * Decodes the passed buffer with a reader of its own, in chunks of @p chunkSize
+     * bytes, and returns the encoded representation of the decoded tree.
+     */
+    ByteVector decodeAndEncode(ByteVector const& buffer, std::size_t chunkSize)
+    {
+        libember::dom::AsyncDomReader reader(libember::glow::GlowNodeFactory::getFactory());
+        for (std::size_t offset = 0; offset < buffer.size(); offset += chunkSize)
+        {
+            std::size_t const size = std::min(chunkSize, buffer.size() - offset);
+            reader.read(&buffer[offset], &buffer[offset] + size);
+        }
+
+        std::auto_ptr<libember::dom::Node> root(reader.detachRoot());
+        if (root.get() == 0)
+        {
+            THROW_TEST_EXCEPTION("The reader did not produce a root");
+        }
+        return encode(*root);
+    }
+
+    /**
+     * Decodes the value sequence with the global decoder factory and compares
+     * each value with the one that has been encoded.
+     */
+    void decodeValues(ByteVector const& buffer)
+    {
+        libember::util::OctetStream stream;
+        stream.append(buffer.begin(), buffer.end());
+        for (unsigned int i = 0; i < VALUE_COUNT; ++i)
+        {
+            libember::ber::Value const expected = generateValue(i);
+            libember::ber::Value const decoded = libember::ber::decode(stream);
+            if (decoded.typeId() != expected.typeId())
+            {
+                THROW_TEST_EXCEPTION("Value " << i << " has been decoded with the wrong type");
+            }
+
+            bool const isEqual = (expected.typeId() == typeid(long) && decoded.as<long>() == expected.as<long>())
+                              || (expected.typeId() == typeid(double) && decoded.as<double>() == expected.as<double>())
+                              || (expected.typeId() == typeid(bool) && decoded.as<bool>() == expected.as<bool>())
+                              || (expected.typeId() == typeid(std::string) && decoded.as<std::string>() == expected.as<std::string>());
+            if (isEqual == false)
+            {
+                THROW_TEST_EXCEPTION("Value " << i << " has been decoded incorrectly");
+            }
+        }
+    }
+
+    /**
+     * The input and the outcome of a single reader thread.
+     */
+    struct ReaderTask
+    {
+        ReaderTask()
+            : message(0)
+            , expected(0)
+            , values(0)
+            , chunkSize(0)
+            , isValid(false)
+        {}
+
+        ByteVector const* message;
+        ByteVector const* expected;
+        ByteVector const* values;
+        std::size_t chunkSize;
+        bool isValid;
+        std::string error;
+    };
+
+    void* runReader(void* argument)
+    {
+        ReaderTask& task = *static_cast<ReaderTask*>(argument);
+        try
+        {
+            for (unsigned int i = 0; i < ITERATIONS; ++i)
+            {
+                if (decodeAndEncode(*task.message, task.chunkSize) != *task.expected)
+                {
+                    THROW_TEST_EXCEPTION("The decoded tree differs in iteration " << i);
+                }
+                decodeValues(*task.values);
+            }
+            task.isValid = true;
+        }
+        catch (std::exception const& ex)
+        {
+            task.error = ex.what();
+        }
+        return 0;
+    }
+
+    double now()
+    {
+        timeval time;
+        gettimeofday(&time, 0);
+        return time.tv_sec * 1000.0 + time.tv_usec / 1000.0;
+    }
+
+    /**
+     * Runs @p count readers at the same time and returns the elapsed time in milliseconds.
+     */
+    double runReaders(unsigned int count, ByteVector const& message, ByteVector const& expected, ByteVector const& values)
+    {
+        std::vector<ReaderTask> tasks(count);
+        std::vector<pthread_t> threads(count);
+
+        double const start = now();
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            tasks[i].message = &message;
+            tasks[i].expected = &expected;
+            tasks[i].values = &values;
+            tasks[i].chunkSize = 64 + i * 193;
+            if (pthread_create(&threads[i], 0, &runReader, &tasks[i]) != 0)
+            {
+                THROW_TEST_EXCEPTION("Failed to start reader " << i);
+            }
+        }
+
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            pthread_join(threads[i], 0);
+        }
+        double const elapsed = now() - start;
+
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            if (tasks[i].isValid == false)
+            {
+                THROW_TEST_EXCEPTION("Reader " << i << " of " << count << " failed: " << tasks[i].error);
+            }
+        }
+        return elapsed;
+    }
+}
+
+int main(int, char const* const*)
+{
+    try
+    {
+        std::auto_ptr<libember::dom::Node> const tree(createTree());
+        ByteVector const message = encode(*tree);
+        ByteVector const expected = decodeAndEncode(message, message.size());
+        ByteVector const values = encodeValues();
+
+        if (expected != message)
+        {
+            THROW_TEST_EXCEPTION("A single reader did not reproduce the encoded tree");
+        }
+
+        double const single = runReaders(1, message, expected, values);
+        double const parallel = runReaders(READER_COUNT, message, expected, values);
+
+        std::cout
+            << "1 reader: " << single << " ms, "
+            << READER_COUNT << " readers: " << parallel << " ms for "
+            << READER_COUNT << " times the work"
+            << std::endl;
+    }
+    catch (std::exception const& ex)
+    {
+        std::cerr << "ERROR: " << ex.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,140 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+#include "ember/Ember.hpp"
+
+#define THROW_TEST_EXCEPTION(message)                       \
+            {                                               \
+                std::ostringstream msgStream;               \
+                msgStream << message ;                      \
+                throw std::runtime_error(msgStream.str());  \
+            }
+
+namespace
+{
+    typedef std::vector<unsigned char> ByteVector;
+
+    /**
+     * Creates a subtree containing a few leaves.
+     * @param number The number of the application tag of the subtree root.
+     * @return The root of the created subtree.
+     */
+    libember::dom::Node* createNode(int number)
+    {
+        using namespace libember;
+
+        dom::Sequence* const node = new dom::Sequence(ber::make_tag(ber::Class::Application, number));
+        node->insert(node->end(), new dom::VariantLeaf(ber::make_tag(ber::Class::ContextSpecific, 0), std::string(200, 'x')));
+
+        for (int i = 1; i <= 10; ++i)
+        {
+            dom::Sequence* const child = new dom::Sequence(ber::make_tag(ber::Class::ContextSpecific, i));
+            child->insert(child->end(), new dom::VariantLeaf(ber::make_tag(ber::Class::ContextSpecific, 0), std::string("child")));
+            child->insert(child->end(), new dom::VariantLeaf(ber::make_tag(ber::Class::ContextSpecific, 1), i * 1000));
+            node->insert(node->end(), child);
+        }
+        return node;
+    }
+
+    /**
+     * Encodes the passed node into a byte vector.
+     * @param node The node to encode.
+     * @return The encoded node.
+     */
+    ByteVector encode(libember::dom::Node const& node)
+    {
+        libember::util::OctetStream stream;
+        node.encode(stream);
+        return ByteVector(stream.begin(), stream.end());
+    }
+}
+
+int main(int, char const* const*)
+{
+    using namespace libember;
+
+    try
+    {
+        ber::Tag const tag = ber::make_tag(ber::Class::Application, 0);
+        std::auto_ptr<dom::Sequence> plain(new dom::Sequence(tag));
+        std::auto_ptr<dom::Sequence> shared(new dom::Sequence(tag));
+        for (int i = 1; i <= 5; ++i)
+        {
+            plain->insert(plain->end(), createNode(i));
+            shared->insert(shared->end(), new dom::SharedNode(createNode(i)));
+        }
+
+        ByteVector const expected = encode(*plain);
+        if (encode(*shared) != expected)
+            THROW_TEST_EXCEPTION("A tree of shared nodes is not encoded like the shared subtrees");
+
+        std::auto_ptr<dom::Sequence> clone(shared->clone());
+        if (encode(*clone) != expected)
+            THROW_TEST_EXCEPTION("The clone of a tree of shared nodes is encoded differently");
+
+        dom::SharedNode const& first = dynamic_cast<dom::SharedNode const&>(*shared->begin());
+        dom::SharedNode const& cloned = dynamic_cast<dom::SharedNode const&>(*clone->begin());
+        if (first.get() != cloned.get() || first.useCount() != 2)
+            THROW_TEST_EXCEPTION("Cloning a shared node copied its subtree");
+
+        std::auto_ptr<dom::Node> copy(first.copy());
+        if (copy.get() == first.get() || encode(*copy) != encode(*first.get()))
+            THROW_TEST_EXCEPTION("The copy of a shared subtree differs from the subtree");
+
+        util::OctetStream indefinite;
+        clone->encodeIndefinite(indefinite);
+        util::OctetStream expectedIndefinite;
+        plain->encodeIndefinite(expectedIndefinite);
+        if (ByteVector(indefinite.begin(), indefinite.end()) != ByteVector(expectedIndefinite.begin(), expectedIndefinite.end()))
+            THROW_TEST_EXCEPTION("Indefinite length encoding of shared nodes differs from the shared subtrees");
+
+        clone.reset();
+        if (first.useCount() != 1)
+            THROW_TEST_EXCEPTION("Deleting a clone did not release the shared subtree");
+
+        dom::Sequence* const owner = new dom::Sequence(tag);
+        dom::Node* const child = createNode(2);
+        owner->insert(owner->end(), child);
+
+        bool isRejected = false;
+        try
+        {
+            dom::SharedNode rejected(child);
+        }
+        catch (std::runtime_error const&)
+        {
+            isRejected = true;
+        }
+
+        delete owner;
+        if (isRejected == false)
+            THROW_TEST_EXCEPTION("A node owned by a container has been shared");
+    }
+    catch (std::exception const& e)
+    {
+        std::cerr << "ERROR: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,238 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+/*
+ * Runs tasks of uneven cost with a WorkStealingExecutor on top of an executor
+ * that runs each worker on a thread of its own, and on top of one that runs the
+ * workers one after another, and verifies that every task runs exactly once.
+ * The ParallelEncoder and the ParallelDecoder are then used with the executor
+ * and have to reproduce the encoding of a single threaded encoder.
+ * The test uses posix threads.
+ */
+
+#include <pthread.h>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+#include "ember/Ember.hpp"
+
+#define THROW_TEST_EXCEPTION(message)                       \
+            {                                               \
+                std::ostringstream msgStream;               \
+                msgStream << message ;                      \
+                throw std::runtime_error(msgStream.str());  \
+            }
+
+namespace
+{
+    typedef std::vector<unsigned char> ByteVector;
+
+    /** The number of threads of the thread executor. */
+    unsigned int const THREAD_COUNT = 4;
+
+    /**
+     * Runs every task on a posix thread of its own, as a minimal thread pool would.
+     */
+    class ThreadExecutor : public libember::dom::Executor
+    {
+        public:
+            virtual void execute(libember::dom::Task* const* tasks, std::size_t count)
+            {
+                std::vector<pthread_t> threads(count);
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    if (pthread_create(&threads[i], 0, &runTask, tasks[i]) != 0)
+                    {
+                        THROW_TEST_EXCEPTION("Failed to start thread " << i);
+                    }
+                }
+
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    pthread_join(threads[i], 0);
+                }
+            }
+
+        private:
+            static void* runTask(void* task)
+            {
+                static_cast<libember::dom::Task*>(task)->run();
+                return 0;
+            }
+    };
+
+    /**
+     * Runs the tasks one after another on the calling thread.
+     */
+    class SequentialExecutor : public libember::dom::Executor
+    {
+        public:
+            virtual void execute(libember::dom::Task* const* tasks, std::size_t count)
+            {
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    tasks[i]->run();
+                }
+            }
+    };
+
+    /**
+     * Counts how often it has been run and burns a number of cycles depending on
+     * its index, so that the workers finish their initial ranges at different times.
+     */
+    class CountingTask : public libember::dom::Task
+    {
+        public:
+            CountingTask()
+                : runs(0)
+                , cost(0)
+                , result(0)
+            {}
+
+            virtual void run()
+            {
+                unsigned long value = 1;
+                for (unsigned int i = 0; i < cost; ++i)
+                {
+                    value = value * 1103515245UL + 12345UL;
+                }
+                result = value;
+                ++runs;
+            }
+
+            unsigned int runs;
+            unsigned int cost;
+            unsigned long result;
+    };
+
+    /**
+     * Executes @p count tasks with @p executor and verifies that each ran once.
+     */
+    void testExecute(libember::dom::Executor& executor, std::size_t count)
+    {
+        std::vector<CountingTask> tasks(count);
+        std::vector<libember::dom::Task*> pointers(count);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            // The tasks of the first quarter are much more expensive than the others.
+            tasks[i].cost = i < count / 4 ? 20000 : 100;
+            pointers[i] = &tasks[i];
+        }
+
+        executor.execute(pointers.empty() ? 0 : &pointers[0], count);
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            if (tasks[i].runs != 1)
+            {
+                THROW_TEST_EXCEPTION("Task " << i << " of " << count << " ran " << tasks[i].runs << " times");
+            }
+        }
+    }
+
+    /**
+     * Creates a glow tree whose top-level nodes differ in size.
+     * @return The root of the created tree.
+     */
+    libember::glow::GlowRootElementCollection* createTree()
+    {
+        using namespace libember::glow;
+
+        GlowRootElementCollection* const root = GlowRootElementCollection::create();
+        for (int i = 1; i <= 400; ++i)
+        {
+            GlowNode* const node = new GlowNode(root, i);
+            node->setIdentifier("node");
+
+            for (int j = 1; j <= (i % 7) * 10; ++j)
+            {
+                GlowParameter* const parameter = new GlowParameter(node, j);
+                parameter->setIdentifier("parameter");
+                parameter->setValue(static_cast<long>(i * j));
+            }
+        }
+        return root;
+    }
+
+    ByteVector toBytes(libember::util::OctetStream const& stream)
+    {
+        return ByteVector(stream.begin(), stream.end());
+    }
+}
+
+int main(int, char const* const*)
+{
+    try
+    {
+        using namespace libember;
+
+        ThreadExecutor threads;
+        SequentialExecutor sequential;
+        dom::WorkStealingExecutor parallel(threads, THREAD_COUNT);
+        dom::WorkStealingExecutor single(sequential, THREAD_COUNT);
+        dom::WorkStealingExecutor direct(threads, 1);
+
+        std::size_t const counts[] = { 0, 1, 2, 3, 4, 5, 17, 100, 1000, 10000 };
+        for (std::size_t i = 0; i < sizeof(counts) / sizeof(counts[0]); ++i)
+        {
+            testExecute(parallel, counts[i]);
+            testExecute(single, counts[i]);
+            testExecute(direct, counts[i]);
+        }
+
+        if (parallel.taskLimit() != THREAD_COUNT * dom::WorkStealingExecutor::TasksPerWorker)
+        {
+            THROW_TEST_EXCEPTION("Invalid task limit " << parallel.taskLimit());
+        }
+
+        std::auto_ptr<glow::GlowRootElementCollection> const tree(createTree());
+        util::OctetStream expected;
+        tree->encode(expected);
+
+        {
+            util::OctetStream encoded;
+            dom::ParallelEncoder const encoder(parallel, 16);
+            encoder.encode(*tree, encoded);
+            if (toBytes(encoded) != toBytes(expected))
+            {
+                THROW_TEST_EXCEPTION("The parallel encoder did not reproduce the encoded tree");
+            }
+        }
+
+        {
+            ByteVector const bytes = toBytes(expected);
+            dom::ParallelDecoder const decoder(glow::GlowNodeFactory::getFactory(), parallel, 1024);
+            std::auto_ptr<dom::Node> const decoded(decoder.decode(&bytes[0], &bytes[0] + bytes.size()));
+
+            util::OctetStream encoded;
+            decoded->encode(encoded);
+            if (toBytes(encoded) != bytes)
+            {
+                THROW_TEST_EXCEPTION("The parallel decoder did not reproduce the encoded tree");
+            }
+        }
+    }
+    catch (std::exception const& e)
+    {
+        std::cerr << "ERROR: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,500 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <algorithm>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "ember/Ember.hpp"
+#include "s101/StreamDecoder.hpp"
+#include "s101/StreamEncoder.hpp"
+#include "CountingAllocator.hpp"
+#include "TreeGenerator.hpp"
+
+#define THROW_TEST_EXCEPTION(message)                       \
+            {                                               \
+                std::ostringstream msgStream;               \
+                msgStream << message ;                      \
+                throw std::runtime_error(msgStream.str());  \
+            }
+
+namespace
+{
+    typedef std::vector<unsigned char> ByteVector;
+    typedef libs101::StreamDecoder<unsigned char> S101Decoder;
+
+    /**
+     * Measures the duration and the allocations of a number of iterations of an operation.
+     */
+    class Measurement
+    {
+        public:
+            /**
+             * Starts a new measurement.
+             * @param iterations The number of iterations that will be measured.
+             */
+            explicit Measurement(int iterations)
+                : m_iterations(iterations)
+                , m_allocations(allocation::Memory::allocations)
+                , m_start(std::clock())
+            {}
+
+            /**
+             * Stops the measurement and prints the throughput of the operation.
+             * @param name The name of the operation.
+             * @param bytes The number of bytes processed by a single iteration, or 0 if
+             *      the operation does not process any bytes.
+             * @param elements The number of elements processed by a single iteration.
+             */
+            void report(std::string const& name, std::size_t bytes, std::size_t elements) const
+            {
+                unsigned long const allocations = allocation::Memory::allocations - m_allocations;
+                double const seconds = std::max((std::clock() - m_start) * 1.0 / CLOCKS_PER_SEC, 1e-6);
+
+                std::cout << "    " << std::left << std::setw(10) << name << std::right << std::fixed << std::setprecision(1);
+                if (bytes > 0)
+                {
+                    std::cout << std::setw(10) << (bytes * 1.0 * m_iterations / seconds / (1024.0 * 1024.0)) << " MB/s";
+                }
+                else
+                {
+                    std::cout << std::setw(15) << "";
+                }
+
+                std::cout << std::setw(14) << (elements * 1.0 * m_iterations / seconds) << " elements/s"
+                          << std::setw(12) << (allocations * 1.0 / m_iterations) << " allocations/op"
+                          << std::endl;
+            }
+
+        private:
+            int const m_iterations;
+            unsigned long const m_allocations;
+            std::clock_t const m_start;
+    };
+
+    /**
+     * Counts the nodes of the passed tree, including all containers and leaves.
+     * @param node The root of the tree.
+     * @return The number of nodes of the tree.
+     */
+    std::size_t countNodes(libember::dom::Node const& node)
+    {
+        std::size_t count = 1;
+        libember::dom::Container const* const container = dynamic_cast<libember::dom::Container const*>(&node);
+        if (container != 0)
+        {
+            libember::dom::Container::const_iterator const last = container->end();
+            for (libember::dom::Container::const_iterator it = container->begin(); it != last; ++it)
+            {
+                count += countNodes(*it);
+            }
+        }
+        return count;
+    }
+
+    /**
+     * Creates a chain of @p depth nested nodes, each containing @p parameters parameters.
+     */
+    libember::glow::GlowRootElementCollection* createDeepTree(int depth, int parameters)
+    {
+        using namespace libember::glow;
+
+        GlowRootElementCollection* const root = GlowRootElementCollection::create();
+        GlowNode* node = new GlowNode(root, 1);
+        for (int level = 0; level < depth; ++level)
+        {
+            node->setIdentifier("node");
+            node->setDescription("A nested node");
+            for (int i = 1; i <= parameters; ++i)
+            {
+                GlowParameter* const parameter = new GlowParameter(node, i);
+                parameter->setIdentifier("parameter");
+                parameter->setValue(static_cast<long>(level * i));
+            }
+
+            if (level + 1 < depth)
+            {
+                node = new GlowNode(node, parameters + 1);
+            }
+        }
+        return root;
+    }
+
+    /**
+     * Creates a flat tree of @p count qualified parameters of various value types.
+     */
+    libember::glow::GlowRootElementCollection* createParameterTree(int count)
+    {
+        using namespace libember;
+        using namespace libember::glow;
+
+        GlowRootElementCollection* const root = GlowRootElementCollection::create();
+        for (int i = 0; i < count; ++i)
+        {
+            int const path[] = { 1, 1 + i / 1000, 1 + i % 1000 };
+            GlowQualifiedParameter* const parameter = new GlowQualifiedParameter(ber::ObjectIdentifier(path, path + 3));
+            parameter->setIdentifier("parameter");
+            parameter->setMinimum(-4096L);
+            parameter->setMaximum(4096L);
+            switch (i % 3)
+            {
+                case 0:
+                    parameter->setValue(static_cast<long>(i % 4096));
+                    break;
+                case 1:
+                    parameter->setValue(i * 0.25);
+                    break;
+                default:
+                    parameter->setValue("value");
+                    break;
+            }
+            root->insert(root->end(), parameter);
+        }
+        return root;
+    }
+
+    /**
+     * Creates a matrix with @p size targets and sources and one connection per target.
+     */
+    libember::glow::GlowRootElementCollection* createMatrixTree(int size)
+    {
+        using namespace libember;
+        using namespace libember::glow;
+
+        GlowRootElementCollection* const root = GlowRootElementCollection::create();
+        GlowMatrix* const matrix = new GlowMatrix(root, 1);
+        matrix->setIdentifier("matrix");
+        matrix->setType(MatrixType::OneToN);
+        matrix->setAddressingMode(MatrixAddressingMode::NonLinear);
+        matrix->setTargetCount(size);
+        matrix->setSourceCount(size);
+
+        dom::Sequence* const targets = matrix->targets();
+        dom::Sequence* const sources = matrix->sources();
+        dom::Sequence* const connections = matrix->connections();
+        for (int i = 0; i < size; ++i)
+        {
+            targets->insert(targets->end(), new GlowTarget(i));
+            sources->insert(sources->end(), new GlowSource(i));
+
+            GlowConnection* const connection = new GlowConnection(i);
+            int const source[] = { (i * 7) % size };
+            connection->setSources(ber::ObjectIdentifier(source, source + 1));
+            connections->insert(connections->end(), connection);
+        }
+        return root;
+    }
+
+    /**
+     * Creates a stream collection of @p count integer and octet string entries.
+     */
+    libember::glow::GlowStreamCollection* createStreamCollection(int count)
+    {
+        libember::glow::GlowStreamCollection* const streams = libember::glow::GlowStreamCollection::create();
+        unsigned char const octets[] = { 0x00, 0x10, 0x20, 0x30, 0x40, 0x50, 0x60, 0x70 };
+        for (int i = 0; i < count; ++i)
+        {
+            if (i % 4 == 0)
+            {
+                streams->insert(i, octets, octets + sizeof(octets));
+            }
+            else
+            {
+                streams->insert(i, (i * 31) % 8192 - 4096);
+            }
+        }
+        return streams;
+    }
+
+    /**
+     * Encodes the passed node into a byte vector.
+     */
+    ByteVector encode(libember::dom::Node const& node)
+    {
+        libember::util::OctetStream stream;
+        node.encode(stream);
+        return ByteVector(stream.begin(), stream.end());
+    }
+
+    /**
+     * Decodes the passed buffer at once with an AsyncDomReader.
+     * @return The decoded tree, must be deleted by the caller.
+     */
+    libember::dom::Node* decode(ByteVector const& buffer)
+    {
+        libember::dom::AsyncDomReader reader(libember::glow::GlowNodeFactory::getFactory());
+        reader.read(&buffer[0], &buffer[0] + buffer.size());
+
+        libember::dom::Node* const root = reader.detachRoot();
+        if (root == 0)
+        {
+            THROW_TEST_EXCEPTION("The encoded tree could not be decoded");
+        }
+        return root;
+    }
+
+    /**
+     * Decodes the passed buffer byte by byte with an AsyncDomReader, like a consumer
+     * does that receives the message through an s101 decoder.
+     * @return The decoded tree, must be deleted by the caller.
+     */
+    libember::dom::Node* decodeBytewise(ByteVector const& buffer)
+    {
+        libember::dom::AsyncDomReader reader(libember::glow::GlowNodeFactory::getFactory());
+        ByteVector::const_iterator const last = buffer.end();
+        for (ByteVector::const_iterator it = buffer.begin(); it != last; ++it)
+        {
+            reader.read(*it);
+        }
+
+        libember::dom::Node* const root = reader.detachRoot();
+        if (root == 0)
+        {
+            THROW_TEST_EXCEPTION("The encoded tree could not be decoded byte by byte");
+        }
+        return root;
+    }
+
+    /**
+     * Frames the passed message into s101 packets of at most 1024 payload bytes each.
+     */
+    std::size_t frame(ByteVector const& message, libs101::StreamEncoder<unsigned char>& encoder, ByteVector& frames)
+    {
+        std::size_t packets = 0;
+        frames.clear();
+        for (std::size_t offset = 0; offset < message.size(); offset += 1024)
+        {
+            std::size_t const size = std::min<std::size_t>(1024, message.size() - offset);
+            encoder.reset();
+            encoder.encode(&message[offset], &message[offset] + size);
+            encoder.finish();
+            frames.insert(frames.end(), encoder.begin(), encoder.end());
+            ++packets;
+        }
+        return packets;
+    }
+
+    /**
+     * Counts the payload bytes of the packets that have been decoded by an s101 decoder.
+     */
+    void countPayload(S101Decoder::const_iterator first, S101Decoder::const_iterator last, std::size_t* state)
+    {
+        *state += std::distance(first, last);
+    }
+
+    /**
+     * Looks up the contents of each child of @p root and the value within the
+     * contents with glow::util::find_tag.
+     * @return The number of successful lookups.
+     */
+    std::size_t findValues(libember::dom::Container const& root)
+    {
+        using namespace libember;
+
+        std::size_t found = 0;
+        dom::Container::const_iterator const last = root.end();
+        for (dom::Container::const_iterator it = root.begin(); it != last; ++it)
+        {
+            dom::Container const* const element = dynamic_cast<dom::Container const*>(&*it);
+            if (element == 0)
+            {
+                continue;
+            }
+
+            dom::Container::const_iterator const contents = glow::util::find_tag(element->begin(), element->end(), glow::GlowTags::QualifiedParameter::Contents());
+            dom::Container const* const set = contents != element->end()
+                ? dynamic_cast<dom::Container const*>(&*contents)
+                : 0;
+
+            if (set != 0 && glow::util::find_tag(set->begin(), set->end(), glow::GlowTags::ParameterContents::Value()) != set->end())
+            {
+                found += 1;
+            }
+        }
+        return found;
+    }
+
+    /**
+     * Runs all benchmarks on the passed tree.
+     * @param name The name of the tree.
+     * @param root The tree to measure.
+     * @param iterations The number of iterations of each operation.
+     */
+    void run(std::string const& name, libember::dom::Node const& root, int iterations)
+    {
+        ByteVector const message = encode(root);
+        std::size_t const nodes = countNodes(root);
+        std::cout << name << ": " << message.size() << " bytes, " << nodes << " nodes" << std::endl;
+
+        {
+            Measurement const measurement(iterations);
+            for (int i = 0; i < iterations; ++i)
+            {
+                libember::util::OctetStream stream;
+                root.encode(stream);
+            }
+            measurement.report("encode", message.size(), nodes);
+        }
+
+        {
+            Measurement const measurement(iterations);
+            for (int i = 0; i < iterations; ++i)
+            {
+                delete decode(message);
+            }
+            measurement.report("decode", message.size(), nodes);
+        }
+
+        {
+            Measurement const measurement(iterations);
+            for (int i = 0; i < iterations; ++i)
+            {
+                delete decodeBytewise(message);
+            }
+            measurement.report("decode 1b", message.size(), nodes);
+        }
+
+        libs101::StreamEncoder<unsigned char> encoder;
+        ByteVector frames;
+        std::size_t const packets = frame(message, encoder, frames);
+        {
+            Measurement const measurement(iterations);
+            for (int i = 0; i < iterations; ++i)
+            {
+                frame(message, encoder, frames);
+            }
+            measurement.report("s101 enc", message.size(), packets);
+        }
+
+        {
+            S101Decoder decoder;
+            std::size_t payload = 0;
+            Measurement const measurement(iterations);
+            for (int i = 0; i < iterations; ++i)
+            {
+                decoder.read(frames.begin(), frames.end(), &countPayload, &payload);
+            }
+            measurement.report("s101 dec", frames.size(), packets);
+
+            if (payload != message.size() * iterations)
+            {
+                THROW_TEST_EXCEPTION("The s101 decoder returned " << payload << " bytes, expected " << message.size() * iterations);
+            }
+        }
+
+        std::auto_ptr<libember::dom::Node> const decoded(decode(message));
+        libember::dom::Container const* const container = dynamic_cast<libember::dom::Container const*>(decoded.get());
+        if (container != 0 && container->size() > 0)
+        {
+            std::size_t found = 0;
+            Measurement const measurement(iterations);
+            for (int i = 0; i < iterations; ++i)
+            {
+                found = findValues(*container);
+            }
+
+            if (found > 0)
+            {
+                measurement.report("find", 0, found * 2);
+            }
+        }
+    }
+
+    /**
+     * Reads a recorded tree, a file containing a BER encoded glow message without s101 framing.
+     * @param filename The name of the file to read.
+     * @return The decoded tree, must be deleted by the caller.
+     */
+    libember::dom::Node* load(char const* filename)
+    {
+        std::ifstream stream(filename, std::ios::binary);
+        if (stream.good() == false)
+        {
+            THROW_TEST_EXCEPTION("Unable to open " << filename);
+        }
+
+        ByteVector const buffer((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+        if (buffer.empty())
+        {
+            THROW_TEST_EXCEPTION(filename << " is empty");
+        }
+        return decode(buffer);
+    }
+}
+
+/**
+ * Measures the glow codec on synthetic trees and on the recorded trees passed
+ * as command line arguments.
+ */
+int main(int argc, char const* const* argv)
+{
+    try
+    {
+        {
+            std::auto_ptr<libember::dom::Node> const tree(createDeepTree(200, 4));
+            run("deep nodes", *tree, 100);
+        }
+        {
+            std::auto_ptr<libember::dom::Node> const tree(createParameterTree(100000));
+            run("100k parameters", *tree, 1);
+        }
+        {
+            std::auto_ptr<libember::dom::Node> const tree(createMatrixTree(4096));
+            run("matrix 4096x4096", *tree, 20);
+        }
+        {
+            generator::TreeShape shape;
+            shape.depth = 4;
+            shape.fanOut = 6;
+            shape.streamParameters = 4;
+            shape.targets = 256;
+            shape.sources = 256;
+            shape.connectsPerTarget = 4;
+
+            generator::TreeGenerator treeGenerator(shape);
+            std::auto_ptr<libember::dom::Node> const tree(treeGenerator.createTree());
+            run("generated tree", *tree, 5);
+        }
+        {
+            std::auto_ptr<libember::dom::Node> const tree(createStreamCollection(10000));
+            run("stream collection", *tree, 50);
+        }
+
+        for (int i = 1; i < argc; ++i)
+        {
+            std::auto_ptr<libember::dom::Node> const tree(load(argv[i]));
+            run(argv[i], *tree, 10);
+        }
+    }
+    catch (std::exception const& e)
+    {
+        std::cerr << "ERROR: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,142 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include "ember/Ember.hpp"
+#include "ember/glow/util/CompliesWithSchema.hpp"
+
+#define THROW_TEST_EXCEPTION(message)                       \
+            {                                               \
+                std::ostringstream msgStream;               \
+                msgStream << message ;                      \
+                throw std::runtime_error(msgStream.str());  \
+            }
+
+namespace
+{
+    using libember::ber::Value;
+    using libember::glow::util::complies_with_schema;
+
+    /**
+     * Verifies the result of both overloads of complies_with_schema for the passed
+     * collection of identifiers.
+     * @param identifiers The collection of schema identifiers.
+     * @param identifier The schema identifier to find.
+     * @param expected The expected result.
+     */
+    void expect(std::string const& identifiers, std::string const& identifier, bool expected)
+    {
+        if (complies_with_schema(identifiers, identifier) != expected)
+        {
+            THROW_TEST_EXCEPTION("Searching \"" << identifier << "\" in the string \"" << identifiers << "\" returned " << !expected);
+        }
+
+        if (complies_with_schema(Value(identifiers), identifier) != expected)
+        {
+            THROW_TEST_EXCEPTION("Searching \"" << identifier << "\" in the value \"" << identifiers << "\" returned " << !expected);
+        }
+    }
+
+    /**
+     * Verifies that only complete entries of a collection match.
+     */
+    void testMatching()
+    {
+        expect("de.l-s-b.emberplus.matrix", "de.l-s-b.emberplus.matrix", true);
+
+        // A prefix or suffix of an identifier is not an identifier of its own.
+        expect("de.l-s-b.emberplus.matrix.extended", "de.l-s-b.emberplus.matrix", false);
+        expect("de.l-s-b.emberplus.matrix", "de.l-s-b.emberplus.matrix.extended", false);
+        expect("com.example.de.l-s-b.emberplus.matrix", "de.l-s-b.emberplus.matrix", false);
+
+        expect("a.b\nc.d\ne.f", "a.b", true);
+        expect("a.b\nc.d\ne.f", "c.d", true);
+        expect("a.b\nc.d\ne.f", "e.f", true);
+        expect("a.b\nc.d\ne.f", "b\nc", false);
+        expect("a.b\nc.d\ne.f", "a.b\nc.d", false);
+        expect("c.d.x\nc.d", "c.d", true);
+
+        expect("a.b\nc.d\n", "c.d", true);
+        expect("a.b\nc.d\n", "c.d\n", false);
+        expect("\na.b", "a.b", true);
+    }
+
+    /**
+     * Verifies that an empty identifier matches nothing and that an empty
+     * collection contains nothing.
+     */
+    void testEmpty()
+    {
+        expect("", "", false);
+        expect("", "a.b", false);
+        expect("a.b", "", false);
+        expect("a.b\n", "", false);
+        expect("a.b\n\nc.d", "", false);
+    }
+
+    /**
+     * Verifies that a value which does not contain a string contains no identifiers.
+     */
+    void testNonStringValue()
+    {
+        if (complies_with_schema(Value(), "a.b") || complies_with_schema(Value(42), "42"))
+        {
+            THROW_TEST_EXCEPTION("A value without a string complies with a schema");
+        }
+    }
+
+    /**
+     * Verifies the check of an element against its schema identifiers property.
+     */
+    void testElement()
+    {
+        libember::glow::GlowNode node(1);
+        if (node.compliesWithSchema("a.b"))
+        {
+            THROW_TEST_EXCEPTION("A node without schema identifiers complies with a schema");
+        }
+
+        node.setSchemaIdentifiers("a.b\nc.d");
+        if (node.compliesWithSchema("a.b") == false || node.compliesWithSchema("c.d") == false || node.compliesWithSchema("c"))
+        {
+            THROW_TEST_EXCEPTION("A node with schema identifiers reported a wrong compliance");
+        }
+    }
+}
+
+int main(int, char const* const*)
+{
+    try
+    {
+        testMatching();
+        testEmpty();
+        testNonStringValue();
+        testElement();
+    }
+    catch (std::exception const& e)
+    {
+        std::cerr << "ERROR: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,165 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef __LIBEMBER_TESTS_GLOW_COUNTINGALLOCATOR_HPP
+#define __LIBEMBER_TESTS_GLOW_COUNTINGALLOCATOR_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+/**
+ * Replaces the global operator new and operator delete of a tool, so that the
+ * number of allocations and the number of live bytes can be measured.
+ * The replacement functions are defined by this header, so it must be included
+ * by exactly one translation unit of a program. Allocations made inside a shared
+ * library that uses its own runtime, like a dll on windows, are not counted.
+ */
+
+#if __cplusplus >= 201103L
+#  define LIBEMBER_TESTS_NOTHROW noexcept
+#else
+#  define LIBEMBER_TESTS_NOTHROW throw()
+#endif
+
+/**
+ * Keeps gcc from inlining the counters into the callers of operator new and
+ * operator delete, where it would report the call to free as mismatched.
+ */
+#ifdef __GNUC__
+#  define LIBEMBER_TESTS_NOINLINE __attribute__((noinline))
+#else
+#  define LIBEMBER_TESTS_NOINLINE
+#endif
+
+namespace allocation
+{
+    /**
+     * Precedes every block returned by the global operator new and records its size,
+     * so operator delete knows the number of bytes it releases.
+     */
+    union AllocationHeader
+    {
+        std::size_t size;
+        long double alignLongDouble;
+        long alignLong;
+        void* alignPointer;
+    };
+
+    /**
+     * Counters of the heap usage of the program.
+     */
+    struct Memory
+    {
+        /** The number of calls to the global operator new. */
+        static unsigned long allocations;
+
+        /** The number of bytes currently allocated through the global operator new. */
+        static std::size_t liveBytes;
+
+        /** The largest value of liveBytes since the last call to resetPeak. */
+        static std::size_t peakBytes;
+
+        /**
+         * Allocates a block and counts it.
+         * @param size The number of bytes requested.
+         * @return The new block, or null if the heap is exhausted.
+         */
+        LIBEMBER_TESTS_NOINLINE static void* allocate(std::size_t size)
+        {
+            AllocationHeader* const header = static_cast<AllocationHeader*>(std::malloc(sizeof(AllocationHeader) + size));
+            if (header == 0)
+            {
+                return 0;
+            }
+
+            header->size = size;
+            allocations += 1;
+            liveBytes += size;
+            peakBytes = std::max(peakBytes, liveBytes);
+            return header + 1;
+        }
+
+        /**
+         * Releases a block returned by allocate.
+         * @param pointer The block to release, may be null.
+         */
+        LIBEMBER_TESTS_NOINLINE static void release(void* pointer)
+        {
+            if (pointer != 0)
+            {
+                AllocationHeader* const header = static_cast<AllocationHeader*>(pointer) - 1;
+                liveBytes -= header->size;
+                std::free(header);
+            }
+        }
+
+        /**
+         * Resets the peak to the current number of live bytes.
+         */
+        static void resetPeak()
+        {
+            peakBytes = liveBytes;
+        }
+    };
+
+    unsigned long Memory::allocations = 0;
+    std::size_t Memory::liveBytes = 0;
+    std::size_t Memory::peakBytes = 0;
+}
+
+void* operator new(std::size_t size)
+{
+    void* const result = allocation::Memory::allocate(size);
+    if (result == 0)
+    {
+        throw std::bad_alloc();
+    }
+    return result;
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void* pointer) LIBEMBER_TESTS_NOTHROW
+{
+    allocation::Memory::release(pointer);
+}
+
+void operator delete[](void* pointer) LIBEMBER_TESTS_NOTHROW
+{
+    allocation::Memory::release(pointer);
+}
+
+#ifdef __cpp_sized_deallocation
+void operator delete(void* pointer, std::size_t) LIBEMBER_TESTS_NOTHROW
+{
+    allocation::Memory::release(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t) LIBEMBER_TESTS_NOTHROW
+{
+    allocation::Memory::release(pointer);
+}
+#endif
+
+#endif  // __LIBEMBER_TESTS_GLOW_COUNTINGALLOCATOR_HPP
@@ -0,0 +1,222 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+#include "ember/Ember.hpp"
+
+#define THROW_TEST_EXCEPTION(message)                       \
+            {                                               \
+                std::ostringstream msgStream;               \
+                msgStream << message ;                      \
+                throw std::runtime_error(msgStream.str());  \
+            }
+
+namespace
+{
+    using libember::glow::ConnectionOperation;
+    using libember::glow::CrosspointMatrix;
+
+    /**
+     * Records the reported crosspoint changes and verifies that the matrix already
+     * reflects each of them when it is reported.
+     */
+    class ChangeRecorder : public CrosspointMatrix::Listener
+    {
+        public:
+            struct Change
+            {
+                int target;
+                int source;
+                bool isConnected;
+            };
+
+            ChangeRecorder()
+                : matrix(0)
+            {}
+
+            virtual void crosspointChanged(int target, int source, bool isConnected)
+            {
+                if (matrix->isConnected(target, source) != isConnected)
+                {
+                    THROW_TEST_EXCEPTION("Crosspoint " << target << "/" << source << " reported before it has been applied");
+                }
+
+                Change const change = { target, source, isConnected };
+                changes.push_back(change);
+            }
+
+            CrosspointMatrix const* matrix;
+            std::vector<Change> changes;
+    };
+
+    void expectSources(CrosspointMatrix const& matrix, int target, int const* first, int const* last)
+    {
+        CrosspointMatrix::SignalCollection const& sources = matrix.sources(target);
+        if (sources != CrosspointMatrix::SignalCollection(first, last))
+        {
+            THROW_TEST_EXCEPTION("Invalid sources of target " << target << ", found " << sources.size() << " sources");
+        }
+
+        for (int const* it = first; it != last; ++it)
+        {
+            if (matrix.isConnected(target, *it) == false)
+            {
+                THROW_TEST_EXCEPTION("Crosspoint " << target << "/" << *it << " is not connected");
+            }
+
+            CrosspointMatrix::SignalCollection const& targets = matrix.targets(*it);
+            if (std::find(targets.begin(), targets.end(), target) == targets.end())
+            {
+                THROW_TEST_EXCEPTION("Target " << target << " is missing from the targets of source " << *it);
+            }
+        }
+    }
+
+    void testOperations()
+    {
+        ChangeRecorder recorder;
+        CrosspointMatrix matrix(8, 100, &recorder);
+        recorder.matrix = &matrix;
+
+        int const absolute[] = { 3, 70, 5 };
+        if (matrix.apply(2, absolute, absolute + 3, ConnectionOperation::Absolute) != 3)
+        {
+            THROW_TEST_EXCEPTION("Absolute connection did not change three crosspoints");
+        }
+        expectSources(matrix, 2, absolute, absolute + 3);
+
+        // Connecting a source twice does not change anything.
+        int const connect[] = { 70, 99 };
+        if (matrix.apply(2, connect, connect + 2, ConnectionOperation::Connect) != 1)
+        {
+            THROW_TEST_EXCEPTION("Connect did not change exactly one crosspoint");
+        }
+
+        int const afterConnect[] = { 3, 70, 5, 99 };
+        expectSources(matrix, 2, afterConnect, afterConnect + 4);
+
+        int const disconnect[] = { 3, 4 };
+        if (matrix.apply(2, disconnect, disconnect + 2, ConnectionOperation::Disconnect) != 1)
+        {
+            THROW_TEST_EXCEPTION("Disconnect did not change exactly one crosspoint");
+        }
+
+        int const afterDisconnect[] = { 70, 5, 99 };
+        expectSources(matrix, 2, afterDisconnect, afterDisconnect + 3);
+
+        matrix.set(6, 70, true);
+        if (matrix.targets(70).size() != 2 || matrix.isSourceUsed(70) == false)
+        {
+            THROW_TEST_EXCEPTION("Source 70 should be used by two targets");
+        }
+
+        // An absolute connection disconnects the sources it does not contain first.
+        recorder.changes.clear();
+        int const replace[] = { 5, 1 };
+        if (matrix.apply(2, replace, replace + 2, ConnectionOperation::Absolute) != 3)
+        {
+            THROW_TEST_EXCEPTION("Absolute replacement did not change three crosspoints");
+        }
+        expectSources(matrix, 2, replace, replace + 2);
+
+        if (recorder.changes.size() != 3
+        ||  recorder.changes[0].isConnected || recorder.changes[1].isConnected
+        ||  recorder.changes[2].isConnected == false || recorder.changes[2].source != 1)
+        {
+            THROW_TEST_EXCEPTION("Invalid changes reported for the absolute replacement");
+        }
+
+        if (matrix.targets(70).size() != 1 || matrix.targets(70)[0] != 6 || matrix.isSourceUsed(99))
+        {
+            THROW_TEST_EXCEPTION("Invalid reverse mapping after the absolute replacement");
+        }
+
+        // Numbers out of range are ignored.
+        int const invalid[] = { -1, 100, 1000 };
+        if (matrix.apply(2, invalid, invalid + 3, ConnectionOperation::Connect) != 0
+        ||  matrix.apply(8, replace, replace + 2, ConnectionOperation::Connect) != 0
+        ||  matrix.isConnected(-1, 5) || matrix.sources(8).empty() == false || matrix.targets(100).empty() == false)
+        {
+            THROW_TEST_EXCEPTION("Numbers out of range have not been ignored");
+        }
+
+        matrix.apply(2, replace, replace, ConnectionOperation::Absolute);
+        if (matrix.sources(2).empty() == false || matrix.isSourceUsed(5))
+        {
+            THROW_TEST_EXCEPTION("An empty absolute connection did not disconnect the target");
+        }
+
+        matrix.reset(4, 4);
+        if (matrix.targetCount() != 4 || matrix.sourceCount() != 4 || matrix.isSourceUsed(1))
+        {
+            THROW_TEST_EXCEPTION("Reset did not clear the matrix");
+        }
+    }
+
+    void testGlowConnections()
+    {
+        using namespace libember::glow;
+
+        CrosspointMatrix matrix(1000, 1000);
+
+        GlowConnectionTable table;
+        for (int target = 0; target < 1000; ++target)
+        {
+            int const source = (target * 7) % 1000;
+            table.insert(target, &source, &source + 1);
+        }
+
+        if (matrix.apply(table) != 1000)
+        {
+            THROW_TEST_EXCEPTION("Applying the table did not connect 1000 crosspoints");
+        }
+
+        GlowConnection connection(10);
+        libember::ber::ObjectIdentifier sources;
+        sources.push_back(70);
+        sources.push_back(999);
+        connection.setSources(sources);
+        connection.setOperation(ConnectionOperation::Connect);
+
+        // Source 70 is already connected to target 10.
+        if (matrix.apply(connection) != 1 || matrix.sources(10).size() != 2 || matrix.targets(999).size() != 2)
+        {
+            THROW_TEST_EXCEPTION("Applying a GlowConnection did not connect source 999 to target 10");
+        }
+    }
+}
+
+int main(int, char const* const*)
+{
+    try
+    {
+        testOperations();
+        testGlowConnections();
+    }
+    catch (std::exception const& e)
+    {
+        std::cerr << "ERROR: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
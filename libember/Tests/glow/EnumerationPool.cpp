@@ -0,0 +1,174 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+#include "ember/Ember.hpp"
+
+#define THROW_TEST_EXCEPTION(message)                       \
+            {                                               \
+                std::ostringstream msgStream;               \
+                msgStream << message ;                      \
+                throw std::runtime_error(msgStream.str());  \
+            }
+
+namespace
+{
+    typedef libember::glow::EnumerationPool EnumerationPool;
+
+    void testEnumerationStrings()
+    {
+        EnumerationPool pool;
+        EnumerationPool::Table const* const first = pool.intern("Off\nOn\n\nAuto");
+        EnumerationPool::Table const* const second = pool.intern(std::string("Off\nOn\n\nAuto"));
+
+        if (first != second || pool.size() != 1 || first->size() != 4)
+        {
+            THROW_TEST_EXCEPTION("An enumeration string has not been shared");
+        }
+
+        if ((*first)[1].name() != "On" || (*first)[2].length != 0 || first->find(3)->name() != "Auto" || first->find(4) != 0)
+        {
+            THROW_TEST_EXCEPTION("An enumeration string has been parsed incorrectly");
+        }
+
+        if (pool.intern("Off\nOn") == first || pool.size() != 2)
+        {
+            THROW_TEST_EXCEPTION("Different enumeration strings share a table");
+        }
+    }
+
+    void testEnumerationMaps()
+    {
+        std::pair<std::string, int> const entries[] = { std::make_pair("Off", 0), std::make_pair("On", 1) };
+        std::pair<std::string, int> const mapped[] = { std::make_pair("Off", 0), std::make_pair("On", 5) };
+
+        EnumerationPool pool;
+        EnumerationPool::Table const* const indexed = pool.intern("Off\nOn");
+        EnumerationPool::Table const* const map = pool.intern(libember::glow::Enumeration(entries, entries + 2));
+        EnumerationPool::Table const* const other = pool.intern(libember::glow::Enumeration(mapped, mapped + 2));
+
+        if (indexed != map || other == map || pool.size() != 2)
+        {
+            THROW_TEST_EXCEPTION("Enumeration maps have not been deduplicated by their entries");
+        }
+
+        if (other->find(5) == 0 || other->find(5)->name() != "On" || other->find(1) != 0 || other->text() != "Off\nOn")
+        {
+            THROW_TEST_EXCEPTION("An enumeration map has been stored incorrectly");
+        }
+    }
+
+    void testLookups()
+    {
+        using namespace libember::glow;
+
+        // A large map whose values are neither indices nor in order.
+        GlowStringIntegerCollection collection(GlowTags::ParameterContents::EnumMap());
+        for (int i = 0; i < 500; ++i)
+        {
+            std::ostringstream name;
+            name << "Source " << i;
+            collection.insert(name.str(), (i * 7919) % 1000);
+        }
+
+        EnumerationPool pool;
+        EnumerationPool::Table const* const table = collection.table(pool);
+        if (table->size() != 500 || table->find(7919 % 1000) == 0 || table->find(7919 % 1000)->name() != "Source 1" || table->find(1) != 0)
+        {
+            THROW_TEST_EXCEPTION("An entry of an enumeration map has not been found by its value");
+        }
+
+        if (table->find(std::string("Source 499")) == 0 || table->find(std::string("Source 499"))->value != (499 * 7919) % 1000
+         || table->find(std::string("Source 500")) != 0 || table->find(std::string("")) != 0)
+        {
+            THROW_TEST_EXCEPTION("An entry of an enumeration map has not been found by its name");
+        }
+
+        EnumerationPool::Table const* const strings = pool.intern("Low\nHigh");
+        if (strings->find(std::string("High")) != &(*strings)[1] || strings->find(std::string("Mid")) != 0)
+        {
+            THROW_TEST_EXCEPTION("An entry of an enumeration string has not been found by its name");
+        }
+
+        // The collection keeps its table until it changes or the pool is cleared.
+        if (collection.table(pool) != table || pool.size() != 2)
+        {
+            THROW_TEST_EXCEPTION("The table of a collection has not been cached");
+        }
+
+        collection.insert("Extra", 1);
+        EnumerationPool::Table const* const extended = collection.table(pool);
+        if (extended == table || extended->size() != 501 || extended->find(1)->name() != "Extra")
+        {
+            THROW_TEST_EXCEPTION("The table of a collection has not been updated after an insertion");
+        }
+
+        pool.clear();
+        if (collection.table(pool) == 0 || collection.table(pool)->size() != 501 || pool.size() != 1)
+        {
+            THROW_TEST_EXCEPTION("The table of a collection has not been interned again after the pool has been cleared");
+        }
+    }
+
+    void testSharedParameters()
+    {
+        using namespace libember::glow;
+
+        std::auto_ptr<GlowRootElementCollection> const root(GlowRootElementCollection::create());
+        GlowNode* const node = new GlowNode(root.get(), 1);
+        for (int number = 1; number <= 3; ++number)
+        {
+            GlowParameter* const parameter = new GlowParameter(node, number);
+            parameter->setEnumeration(number < 3 ? "Mute\nUnmute" : "Low\nHigh");
+        }
+
+        GlowTreeMirror mirror;
+        mirror.merge(*root);
+
+        GlowTreeMirror::Element const parent = mirror.root().child(1);
+        EnumerationPool::Table const* const first = parent.child(1).parameter()->enumeration;
+        EnumerationPool::Table const* const second = parent.child(2).parameter()->enumeration;
+        EnumerationPool::Table const* const third = parent.child(3).parameter()->enumeration;
+        if (first == 0 || first != second || third == first || third->size() != 2 || (*third)[1].name() != "High")
+        {
+            THROW_TEST_EXCEPTION("The mirror does not share the enumerations of its parameters");
+        }
+    }
+}
+
+int main(int, char const* const*)
+{
+    try
+    {
+        testEnumerationStrings();
+        testEnumerationMaps();
+        testLookups();
+        testSharedParameters();
+    }
+    catch (std::exception const& e)
+    {
+        std::cerr << "ERROR: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,178 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+#include "ember/Ember.hpp"
+
+#define THROW_TEST_EXCEPTION(message)                       \
+            {                                               \
+                std::ostringstream msgStream;               \
+                msgStream << message ;                      \
+                throw std::runtime_error(msgStream.str());  \
+            }
+
+
+namespace
+{
+    typedef libember::glow::GlowConnectionTable GlowConnectionTable;
+
+    /**
+     * A reader that collects the decoded connections into a table.
+     */
+    class ConnectionCollector : public libember::glow::GlowReader
+    {
+        public:
+            GlowConnectionTable table;
+            libember::ber::ObjectIdentifier path;
+
+        protected:
+            virtual void connectionReady(libember::ber::ObjectIdentifier const& path, int target, libember::ber::ObjectIdentifier const& sources,
+                libember::glow::ConnectionOperation const& operation, libember::glow::ConnectionDisposition const& disposition)
+            {
+                std::vector<int> const numbers(sources.begin(), sources.end());
+                table.insert(target, numbers.begin(), numbers.end(), operation, disposition);
+                this->path = path;
+            }
+    };
+
+    /**
+     * Creates a connection table for a matrix with @p size targets, where every
+     * target is connected to the sources target and target + size / 2.
+     */
+    void fill(GlowConnectionTable& table, int size)
+    {
+        using namespace libember::glow;
+
+        table.reserve(size, 2 * size);
+        for (int target = 0; target < size; ++target)
+        {
+            int const sources[] = { target, (target + size / 2) % size };
+            int const count = (target % 7 == 0) ? 0 : 2;
+            ConnectionOperation const operation = (target % 5 == 0) ? ConnectionOperation::Connect : ConnectionOperation::Absolute;
+            ConnectionDisposition const disposition = (target % 3 == 0) ? ConnectionDisposition::Modified : ConnectionDisposition::Tally;
+            table.insert(target, sources, sources + count, operation, disposition);
+        }
+    }
+
+    void compare(GlowConnectionTable const& expected, GlowConnectionTable const& actual)
+    {
+        if (expected.size() != actual.size())
+        {
+            THROW_TEST_EXCEPTION("The table contains " << actual.size() << " connections, expected " << expected.size());
+        }
+
+        for (GlowConnectionTable::size_type i = 0; i < expected.size(); ++i)
+        {
+            if (expected.target(i) != actual.target(i)
+            ||  expected.operation(i).value() != actual.operation(i).value()
+            ||  expected.disposition(i).value() != actual.disposition(i).value()
+            ||  std::vector<int>(expected.sourcesBegin(i), expected.sourcesEnd(i)) != std::vector<int>(actual.sourcesBegin(i), actual.sourcesEnd(i)))
+            {
+                THROW_TEST_EXCEPTION("Connection " << i << " does not match");
+            }
+        }
+    }
+
+    void testEncodeAndDecode()
+    {
+        using namespace libember;
+        using namespace libember::glow;
+
+        int const size = 4096;
+        GlowConnectionTable table;
+        fill(table, size);
+
+        int const path[] = { 1, 3 };
+        std::auto_ptr<GlowRootElementCollection> const root(GlowRootElementCollection::create());
+        GlowQualifiedMatrix* const matrix = new GlowQualifiedMatrix(ber::ObjectIdentifier(path, path + 2));
+        root->insert(root->end(), matrix);
+        matrix->insertConnections(table);
+
+        libember::util::OctetStream stream;
+        root->encode(stream);
+        std::vector<unsigned char> const buffer(stream.begin(), stream.end());
+
+        ConnectionCollector collector;
+        collector.read(&buffer[0], &buffer[0] + buffer.size());
+        compare(table, collector.table);
+        if (collector.path.size() != 2 || collector.path[1] != 3)
+        {
+            THROW_TEST_EXCEPTION("The connections have been reported with a wrong matrix path");
+        }
+
+        dom::AsyncDomReader reader(GlowNodeFactory::getFactory());
+        reader.read(&buffer[0], &buffer[0] + buffer.size());
+        std::auto_ptr<dom::Node> const decoded(reader.detachRoot());
+        GlowRootElementCollection const* const collection = dynamic_cast<GlowRootElementCollection const*>(decoded.get());
+        GlowQualifiedMatrix const* const decodedMatrix = (collection != 0 && collection->size() == 1)
+            ? dynamic_cast<GlowQualifiedMatrix const*>(&*collection->begin())
+            : 0;
+
+        std::vector<GlowConnection const*> connections;
+        if (decodedMatrix == 0 || decodedMatrix->typedConnections(std::back_inserter(connections)) != static_cast<std::size_t>(size))
+        {
+            THROW_TEST_EXCEPTION("The encoded connections could not be decoded as GlowConnection");
+        }
+
+        GlowConnectionTable converted;
+        for (std::vector<GlowConnection const*>::const_iterator it = connections.begin(); it != connections.end(); ++it)
+        {
+            ber::ObjectIdentifier const sources = (*it)->sources();
+            std::vector<int> const numbers(sources.begin(), sources.end());
+            converted.insert((*it)->target(), numbers.begin(), numbers.end(), (*it)->operation(), (*it)->disposition());
+        }
+        compare(table, converted);
+
+        if (table.encodedLength() + 4 > buffer.size())
+        {
+            THROW_TEST_EXCEPTION("The encoded length " << table.encodedLength() << " exceeds the message size " << buffer.size());
+        }
+    }
+
+    void testEmptyTable()
+    {
+        GlowConnectionTable table;
+        libember::util::OctetStream stream;
+        table.encode(stream);
+        if (table.empty() == false || stream.size() != 0 || table.encodedLength() != 0)
+        {
+            THROW_TEST_EXCEPTION("An empty table is not encoded as nothing");
+        }
+    }
+}
+
+int main(int, char const* const*)
+{
+    try
+    {
+        testEncodeAndDecode();
+        testEmptyTable();
+    }
+    catch (std::exception const& e)
+    {
+        std::cerr << "ERROR: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,172 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include "ember/Ember.hpp"
+
+#define THROW_TEST_EXCEPTION(message)                       \
+            {                                               \
+                std::ostringstream msgStream;               \
+                msgStream << message ;                      \
+                throw std::runtime_error(msgStream.str());  \
+            }
+
+namespace
+{
+    using namespace libember::glow;
+
+    /**
+     * Creates a node with the passed number and appends it to the children of @p parent.
+     * @param parent The node to add the new node to.
+     * @param number The number of the new node.
+     * @return The created node.
+     */
+    GlowNode* appendNode(GlowNodeBase* parent, int number)
+    {
+        std::ostringstream identifier;
+        identifier << "node" << number;
+
+        GlowNode* const node = new GlowNode(parent, number);
+        node->setIdentifier(identifier.str());
+        return node;
+    }
+
+    /**
+     * Returns a path composed of up to three numbers.
+     * @param first The first number of the path.
+     * @param second The second number, or -1 to end the path.
+     * @param third The third number, or -1 to end the path.
+     * @return The created path.
+     */
+    libember::ber::ObjectIdentifier makePath(int first, int second = -1, int third = -1)
+    {
+        libember::ber::ObjectIdentifier path;
+        int const numbers[] = { first, second, third };
+        for (int i = 0; i < 3 && numbers[i] >= 0; ++i)
+        {
+            path.push_back(numbers[i]);
+        }
+        return path;
+    }
+
+    /**
+     * Verifies the lookup of children by number and by path.
+     */
+    void testLookup()
+    {
+        GlowNode root(1);
+        GlowElementCollection* const children = root.children();
+
+        // The numbers are not added in order on purpose.
+        int const numbers[] = { 7, 3, 9, 1 };
+        for (int i = 0; i < 4; ++i)
+        {
+            GlowNode* const node = appendNode(&root, numbers[i]);
+            for (int j = 3; j > 0; --j)
+            {
+                GlowParameter* const parameter = new GlowParameter(node, j);
+                parameter->setValue(numbers[i] * 10 + j);
+            }
+        }
+
+        GlowNode* const three = dynamic_cast<GlowNode*>(children->elementAt(3));
+        if (three == 0 || three->identifier() != "node3" || children->elementAt(4) != 0)
+        {
+            THROW_TEST_EXCEPTION("Unexpected result of a lookup by number");
+        }
+
+        GlowParameter const* const parameter = dynamic_cast<GlowParameter const*>(children->elementAt(makePath(9, 2)));
+        if (parameter == 0 || parameter->value().toInteger() != 92)
+        {
+            THROW_TEST_EXCEPTION("Unexpected result of a lookup by path");
+        }
+
+        if (children->elementAt(makePath(9, 2, 1)) != 0 || children->elementAt(makePath(8, 1)) != 0
+         || children->elementAt(libember::ber::ObjectIdentifier()) != 0)
+        {
+            THROW_TEST_EXCEPTION("A path to an element that does not exist has been resolved");
+        }
+
+        // Inserting and erasing children must discard the index.
+        appendNode(&root, 4);
+        if (children->elementAt(4) == 0 || children->elementAt(4)->parent() != children)
+        {
+            THROW_TEST_EXCEPTION("A new child has not been found");
+        }
+
+        children->erase(children->begin());
+        if (children->elementAt(7) != 0 || children->elementAt(3) != three)
+        {
+            THROW_TEST_EXCEPTION("An erased child has been found");
+        }
+    }
+
+    /**
+     * Verifies the lookup within a decoded tree, whose elements are inserted
+     * before their numbers have been decoded.
+     */
+    void testDecodedTree()
+    {
+        GlowNode root(1);
+        for (int i = 10; i > 0; --i)
+        {
+            GlowNode* const node = appendNode(&root, i);
+            appendNode(node, i * 100);
+        }
+
+        libember::util::OctetStream stream;
+        root.encode(stream);
+
+        libember::dom::DomReader reader;
+        std::auto_ptr<libember::dom::Node> const decoded(reader.decodeTree(stream, GlowNodeFactory::getFactory()));
+        GlowNode* const node = dynamic_cast<GlowNode*>(decoded.get());
+        if (node == 0 || node->children() == 0)
+        {
+            THROW_TEST_EXCEPTION("The tree has not been decoded");
+        }
+
+        for (int i = 1; i <= 10; ++i)
+        {
+            GlowNode const* const child = dynamic_cast<GlowNode const*>(node->children()->elementAt(makePath(i, i * 100)));
+            if (child == 0 || child->number() != i * 100)
+            {
+                THROW_TEST_EXCEPTION("The decoded element " << i << "." << i * 100 << " has not been found");
+            }
+        }
+    }
+}
+
+int main(int, char const* const*)
+{
+    try
+    {
+        testLookup();
+        testDecodedTree();
+    }
+    catch (std::exception const& e)
+    {
+        std::cerr << "ERROR: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
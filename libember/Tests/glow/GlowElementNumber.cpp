@@ -0,0 +1,169 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include "ember/Ember.hpp"
+
+#define THROW_TEST_EXCEPTION(message)                       \
+            {                                               \
+                std::ostringstream msgStream;               \
+                msgStream << message ;                      \
+                throw std::runtime_error(msgStream.str());  \
+            }
+
+namespace
+{
+    using namespace libember::glow;
+    using libember::glow::util::ValueConverter;
+
+    /**
+     * Creates a tree containing one element of each type that has an integer number.
+     * @return The root of the created tree.
+     */
+    GlowRootElementCollection* createTree()
+    {
+        std::auto_ptr<GlowRootElementCollection> root(GlowRootElementCollection::create());
+        GlowNode* const node = new GlowNode(root.get(), 5);
+        new GlowParameter(node, 7);
+        new GlowFunction(node, 9);
+        new GlowCommand(node, CommandType::GetDirectory);
+
+        GlowMatrix* const matrix = new GlowMatrix(node, 11);
+        matrix->targets()->insert(matrix->targets()->end(), new GlowTarget(3));
+        matrix->sources()->insert(matrix->sources()->end(), new GlowSource(4));
+        return root.release();
+    }
+
+    /**
+     * Verifies that the leaf holding the number of an element, which is its first
+     * child, can be read as int and as long, but not as another type.
+     * @param element The element to examine.
+     * @param number The expected number.
+     * @param origin Describes the tree for error messages.
+     */
+    void expectNumberLeaf(libember::dom::Container const& element, int number, char const* origin)
+    {
+        libember::dom::Node const* const leaf = &*element.begin();
+        if (ValueConverter::valueOf(leaf, -1) != number
+         || ValueConverter::valueOf(leaf, -1L) != number
+         || ValueConverter::valueOf(leaf).as<int>() != number)
+        {
+            THROW_TEST_EXCEPTION("The number leaf of a " << origin << " element cannot be read as integer");
+        }
+
+        if (ValueConverter::valueOf(leaf, std::string("none")) != "none" || ValueConverter::valueOf(leaf, 1.5) != 1.5)
+        {
+            THROW_TEST_EXCEPTION("The number leaf of a " << origin << " element has been read as another type");
+        }
+    }
+
+    /**
+     * Verifies the numbers of the elements created by createTree.
+     * @param root The root of the tree to verify, either created locally or decoded.
+     * @param origin Describes the tree for error messages.
+     */
+    void verifyTree(GlowRootElementCollection const& root, char const* origin)
+    {
+        GlowNode const* const node = dynamic_cast<GlowNode const*>(&*root.begin());
+        if (node == 0 || node->number() != 5 || node->children() == 0)
+        {
+            THROW_TEST_EXCEPTION("Invalid number of a " << origin << " node");
+        }
+        expectNumberLeaf(*node, 5, origin);
+
+        GlowElementCollection const* const children = node->children();
+        GlowParameter const* const parameter = dynamic_cast<GlowParameter const*>(children->elementAt(7));
+        GlowFunction const* const function = dynamic_cast<GlowFunction const*>(children->elementAt(9));
+        GlowMatrix const* const matrix = dynamic_cast<GlowMatrix const*>(children->elementAt(11));
+        if (parameter == 0 || parameter->number() != 7 || function == 0 || function->number() != 9 || matrix == 0 || matrix->number() != 11)
+        {
+            THROW_TEST_EXCEPTION("Invalid number of a " << origin << " parameter, function or matrix");
+        }
+        expectNumberLeaf(*parameter, 7, origin);
+        expectNumberLeaf(*function, 9, origin);
+        expectNumberLeaf(*matrix, 11, origin);
+
+        GlowCommand const* command = 0;
+        for (GlowElementCollection::const_iterator it = children->begin(); it != children->end() && command == 0; ++it)
+        {
+            command = dynamic_cast<GlowCommand const*>(&*it);
+        }
+        if (command == 0 || command->number().value() != CommandType::GetDirectory)
+        {
+            THROW_TEST_EXCEPTION("Invalid number of a " << origin << " command");
+        }
+
+        GlowTarget const* const target = dynamic_cast<GlowTarget const*>(&*matrix->targets()->begin());
+        GlowSource const* const source = dynamic_cast<GlowSource const*>(&*matrix->sources()->begin());
+        if (target == 0 || target->number() != 3 || source == 0 || source->number() != 4)
+        {
+            THROW_TEST_EXCEPTION("Invalid number of a " << origin << " signal");
+        }
+        expectNumberLeaf(*target, 3, origin);
+    }
+
+    /**
+     * Verifies the numbers of a locally created tree and of the tree decoded from
+     * its encoding, which stores the numbers in variant leaves.
+     */
+    void testRoundTrip()
+    {
+        std::auto_ptr<GlowRootElementCollection> const root(createTree());
+        verifyTree(*root, "local");
+
+        libember::util::OctetStream stream;
+        root->encode(stream);
+
+        libember::dom::DomReader reader;
+        std::auto_ptr<libember::dom::Node> decoded(reader.decodeTree(stream, GlowNodeFactory::getFactory()));
+        GlowRootElementCollection const* const decodedRoot = dynamic_cast<GlowRootElementCollection const*>(decoded.get());
+        if (decodedRoot == 0)
+        {
+            THROW_TEST_EXCEPTION("The tree has not been decoded");
+        }
+        verifyTree(*decodedRoot, "decoded");
+
+        libember::util::OctetStream reencoded;
+        decodedRoot->encode(reencoded);
+        libember::util::OctetStream original;
+        root->encode(original);
+        if (reencoded.size() != original.size() || std::equal(original.begin(), original.end(), reencoded.begin()) == false)
+        {
+            THROW_TEST_EXCEPTION("The decoded tree is encoded differently");
+        }
+    }
+}
+
+int main(int, char const* const*)
+{
+    try
+    {
+        testRoundTrip();
+    }
+    catch (std::exception const& e)
+    {
+        std::cerr << "ERROR: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,137 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+#include "ember/Ember.hpp"
+
+#define THROW_TEST_EXCEPTION(message)                       \
+            {                                               \
+                std::ostringstream msgStream;               \
+                msgStream << message ;                      \
+                throw std::runtime_error(msgStream.str());  \
+            }
+
+namespace
+{
+    typedef libember::glow::GlowInvocationTable GlowInvocationTable;
+
+    /**
+     * Records the outcomes reported by a GlowInvocationTable.
+     */
+    class RecordingCallback : public GlowInvocationTable::Callback
+    {
+        public:
+            virtual void completed(int invocationId, libember::glow::GlowInvocationResult const& result)
+            {
+                if (result.success())
+                {
+                    completedIds.push_back(invocationId);
+                }
+            }
+
+            virtual void timedOut(int invocationId)
+            {
+                timedOutIds.push_back(invocationId);
+            }
+
+            std::vector<int> completedIds;
+            std::vector<int> timedOutIds;
+    };
+
+    void testCompletion()
+    {
+        RecordingCallback callback;
+        GlowInvocationTable table;
+
+        std::auto_ptr<libember::glow::GlowInvocation> const invocation(table.createInvocation(&callback, 100));
+        int const other = table.add(&callback, 100);
+        if (invocation->invocationId() <= 0 || other == invocation->invocationId() || table.size() != 2)
+        {
+            THROW_TEST_EXCEPTION("The invocation identifiers have not been allocated correctly");
+        }
+
+        libember::glow::GlowInvocationResult result;
+        result.setInvocationId(invocation->invocationId());
+        if (table.complete(result) == false || table.complete(result) || table.contains(invocation->invocationId()))
+        {
+            THROW_TEST_EXCEPTION("A result has not been matched exactly once");
+        }
+
+        if (callback.completedIds.size() != 1 || callback.completedIds[0] != invocation->invocationId() || table.size() != 1)
+        {
+            THROW_TEST_EXCEPTION("The callback has not been notified about the result");
+        }
+
+        if (table.cancel(other) == false || table.empty() == false)
+        {
+            THROW_TEST_EXCEPTION("An invocation could not be cancelled");
+        }
+    }
+
+    void testTimeouts()
+    {
+        RecordingCallback callback;
+        GlowInvocationTable table;
+
+        // the deadlines wrap around the end of the clock
+        GlowInvocationTable::tick_type const start = static_cast<GlowInvocationTable::tick_type>(-50);
+        int const early = table.add(&callback, start + 10);
+        int const late = table.add(&callback, start + 100);
+
+        if (table.expire(start) != 0 || table.expire(start + 9) != 0)
+        {
+            THROW_TEST_EXCEPTION("An invocation has expired before its deadline");
+        }
+
+        if (table.expire(start + 10) != 1 || callback.timedOutIds.size() != 1 || callback.timedOutIds[0] != early)
+        {
+            THROW_TEST_EXCEPTION("An invocation has not expired at its deadline");
+        }
+
+        libember::glow::GlowInvocationResult result;
+        result.setInvocationId(early);
+        if (table.complete(result) || callback.completedIds.empty() == false)
+        {
+            THROW_TEST_EXCEPTION("The result of an expired invocation has been reported");
+        }
+
+        if (table.expire(start + 200) != 1 || callback.timedOutIds.back() != late || table.empty() == false)
+        {
+            THROW_TEST_EXCEPTION("An invocation has not expired after the clock wrapped around");
+        }
+    }
+}
+
+int main(int, char const* const*)
+{
+    try
+    {
+        testCompletion();
+        testTimeouts();
+    }
+    catch (std::exception const& e)
+    {
+        std::cerr << "ERROR: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
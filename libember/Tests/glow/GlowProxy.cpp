@@ -0,0 +1,333 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+#include "ember/Ember.hpp"
+
+#define THROW_TEST_EXCEPTION(message)                       \
+            {                                               \
+                std::ostringstream msgStream;               \
+                msgStream << message ;                      \
+                throw std::runtime_error(msgStream.str());  \
+            }
+
+namespace
+{
+    using namespace libember::glow;
+
+    /**
+     * A connection which keeps the decoded copies of all messages written to it.
+     */
+    class RecordingConnection : public GlowProxy::Connection
+    {
+        public:
+            ~RecordingConnection()
+            {
+                clear();
+            }
+
+            virtual void write(libember::dom::Node const& message)
+            {
+                libember::util::OctetStream stream;
+                message.encode(stream);
+
+                libember::dom::DomReader reader;
+                libember::dom::Node* const result = reader.decodeTree(stream, GlowNodeFactory::getFactory());
+                if (result == 0)
+                {
+                    THROW_TEST_EXCEPTION("A written message could not be decoded");
+                }
+                messages.push_back(result);
+            }
+
+            void clear()
+            {
+                for (std::vector<libember::dom::Node*>::iterator it = messages.begin(); it != messages.end(); ++it)
+                {
+                    delete *it;
+                }
+                messages.clear();
+            }
+
+            std::vector<libember::dom::Node*> messages;
+    };
+
+    /**
+     * Counts the commands in a message and collects the invocations.
+     */
+    class CommandCounter : private GlowVisitor
+    {
+        public:
+            CommandCounter(libember::dom::Node const& message, CommandType const& type)
+                : count(0)
+                , invocationId(0)
+                , m_type(type)
+            {
+                accept(message);
+            }
+
+            int count;
+            int invocationId;
+
+        private:
+            virtual void visit(GlowRootElementCollection const& glow)
+            {
+                acceptChildren(glow);
+            }
+
+            virtual void visit(GlowQualifiedNode const& glow)
+            {
+                if (glow.children() != 0)
+                    acceptChildren(*glow.children());
+            }
+
+            virtual void visit(GlowQualifiedParameter const& glow)
+            {
+                if (glow.children() != 0)
+                    acceptChildren(*glow.children());
+            }
+
+            virtual void visit(GlowQualifiedFunction const& glow)
+            {
+                if (glow.children() != 0)
+                    acceptChildren(*glow.children());
+            }
+
+            virtual void visit(GlowCommand const& glow)
+            {
+                if (glow.number().value() == m_type.value())
+                {
+                    count += 1;
+                    if (glow.invocation() != 0)
+                        invocationId = glow.invocation()->invocationId();
+                }
+            }
+
+            CommandType const m_type;
+    };
+
+    int countCommands(RecordingConnection const& connection, CommandType const& type)
+    {
+        int count = 0;
+        for (std::vector<libember::dom::Node*>::const_iterator it = connection.messages.begin(); it != connection.messages.end(); ++it)
+        {
+            count += CommandCounter(**it, type).count;
+        }
+        return count;
+    }
+
+    GlowRootElementCollection* createRequest(libember::ber::ObjectIdentifier const& path, CommandType const& type)
+    {
+        GlowRootElementCollection* const root = GlowRootElementCollection::create();
+        if (path.empty())
+        {
+            new GlowCommand(root, type);
+        }
+        else
+        {
+            GlowQualifiedParameter* const parameter = new GlowQualifiedParameter(root, path);
+            parameter->children()->insert(parameter->children()->end(), new GlowCommand(type));
+        }
+        return root;
+    }
+
+    GlowRootElementCollection* createTree()
+    {
+        GlowRootElementCollection* const root = GlowRootElementCollection::create();
+        GlowNode* const node = new GlowNode(root, 1);
+        node->setIdentifier("device");
+
+        GlowParameter* const parameter = new GlowParameter(2);
+        root->insert(root->end(), parameter);
+        parameter->setIdentifier("gain");
+        parameter->setValue(3L);
+        parameter->setStreamIdentifier(5);
+
+        new GlowFunction(root, 3);
+        return root;
+    }
+
+    /**
+     * Merges all messages a consumer has received into a mirror.
+     */
+    void mirror(RecordingConnection const& consumer, GlowTreeMirror& result)
+    {
+        for (std::vector<libember::dom::Node*>::const_iterator it = consumer.messages.begin(); it != consumer.messages.end(); ++it)
+        {
+            result.merge(**it);
+        }
+    }
+
+    void testSharedDirectory()
+    {
+        RecordingConnection provider;
+        RecordingConnection first, second, third;
+        GlowProxy proxy(provider, 100);
+
+        std::auto_ptr<libember::dom::Node> const request(createRequest(libember::ber::ObjectIdentifier(), CommandType::GetDirectory));
+        proxy.consumerMessage(&first, *request);
+        proxy.consumerMessage(&second, *request);
+        if (countCommands(provider, CommandType::GetDirectory) != 1 || first.messages.empty() == false)
+        {
+            THROW_TEST_EXCEPTION("The root directory has not been requested exactly once");
+        }
+
+        std::auto_ptr<libember::dom::Node> const tree(createTree());
+        proxy.providerMessage(*tree);
+
+        GlowTreeMirror firstMirror, secondMirror;
+        mirror(first, firstMirror);
+        mirror(second, secondMirror);
+        if (firstMirror.size() != 3 || secondMirror.size() != 3
+        ||  firstMirror.find(libember::ber::ObjectIdentifier(2)).identifier() != "gain")
+        {
+            THROW_TEST_EXCEPTION("The waiting consumers have not received the directory");
+        }
+
+        provider.clear();
+        proxy.consumerMessage(&third, *request);
+
+        GlowTreeMirror thirdMirror;
+        mirror(third, thirdMirror);
+        if (provider.messages.empty() == false || thirdMirror.size() != 3 || proxy.consumerCount() != 3)
+        {
+            THROW_TEST_EXCEPTION("A resolved directory has not been answered from the cache");
+        }
+
+        // a change of the provider is forwarded to all consumers that know the element
+        GlowRootElementCollection update;
+        GlowQualifiedParameter* const parameter = new GlowQualifiedParameter(&update, libember::ber::ObjectIdentifier(2));
+        parameter->setValue(7L);
+        proxy.providerMessage(update);
+
+        mirror(first, firstMirror);
+        GlowTreeMirror::ParameterState const* const state = firstMirror.find(libember::ber::ObjectIdentifier(2)).parameter();
+        if (state == 0 || state->value.toInteger() != 7)
+        {
+            THROW_TEST_EXCEPTION("A value change has not been forwarded");
+        }
+    }
+
+    void testSubscriptions()
+    {
+        RecordingConnection provider;
+        RecordingConnection first, second;
+        GlowProxy proxy(provider, 100);
+
+        std::auto_ptr<libember::dom::Node> const tree(createTree());
+        proxy.providerMessage(*tree);
+
+        libember::ber::ObjectIdentifier const path(2);
+        std::auto_ptr<libember::dom::Node> const subscribe(createRequest(path, CommandType::Subscribe));
+        std::auto_ptr<libember::dom::Node> const unsubscribe(createRequest(path, CommandType::Unsubscribe));
+        proxy.consumerMessage(&first, *subscribe);
+        proxy.consumerMessage(&second, *subscribe);
+        if (countCommands(provider, CommandType::Subscribe) != 1 || proxy.subscriptionCount() != 1)
+        {
+            THROW_TEST_EXCEPTION("The subscriptions have not been multiplexed");
+        }
+
+        GlowStreamCollection streams;
+        streams.insert(5, 42);
+        streams.insert(6, 43);
+        proxy.providerMessage(streams);
+        if (first.messages.size() != 1 || second.messages.size() != 1
+        ||  dynamic_cast<libember::dom::Container const*>(first.messages[0])->size() != 1)
+        {
+            THROW_TEST_EXCEPTION("The stream entries have not been routed to the subscribers");
+        }
+
+        proxy.consumerMessage(&first, *unsubscribe);
+        if (countCommands(provider, CommandType::Unsubscribe) != 0)
+        {
+            THROW_TEST_EXCEPTION("The provider has been unsubscribed while a consumer is still subscribed");
+        }
+
+        proxy.detach(&second);
+        if (countCommands(provider, CommandType::Unsubscribe) != 1 || proxy.subscriptionCount() != 0 || proxy.consumerCount() != 1)
+        {
+            THROW_TEST_EXCEPTION("Detaching the last subscriber has not unsubscribed the provider");
+        }
+    }
+
+    void testInvocations()
+    {
+        RecordingConnection provider;
+        RecordingConnection consumer;
+        GlowProxy proxy(provider, 100);
+
+        GlowRootElementCollection request;
+        GlowQualifiedFunction* const function = new GlowQualifiedFunction(&request, libember::ber::ObjectIdentifier(3));
+        GlowCommand* const command = new GlowCommand(CommandType::Invoke);
+        GlowInvocation* const invocation = new GlowInvocation();
+        invocation->setInvocationId(77);
+        command->setInvocation(invocation);
+        function->children()->insert(function->children()->end(), command);
+
+        proxy.consumerMessage(&consumer, request);
+        int const forwardedId = CommandCounter(*provider.messages.at(0), CommandType::Invoke).invocationId;
+        if (forwardedId <= 0)
+        {
+            THROW_TEST_EXCEPTION("The invocation has not been forwarded");
+        }
+
+        GlowInvocationResult result;
+        result.setInvocationId(forwardedId);
+        result.setSuccess(true);
+        proxy.providerMessage(result);
+
+        GlowInvocationResult const* const response = dynamic_cast<GlowInvocationResult const*>(consumer.messages.at(0));
+        if (response == 0 || response->invocationId() != 77 || response->success() == false)
+        {
+            THROW_TEST_EXCEPTION("The invocation result has not been returned with the original identifier");
+        }
+
+        proxy.consumerMessage(&consumer, request);
+        if (proxy.expire(99) != 0 || proxy.expire(100) != 1)
+        {
+            THROW_TEST_EXCEPTION("The unanswered invocation has not timed out");
+        }
+
+        GlowInvocationResult const* const failure = dynamic_cast<GlowInvocationResult const*>(consumer.messages.at(1));
+        if (failure == 0 || failure->invocationId() != 77 || failure->success())
+        {
+            THROW_TEST_EXCEPTION("The timed out invocation has not been reported as failed");
+        }
+    }
+}
+
+int main(int, char const* const*)
+{
+    try
+    {
+        testSharedDirectory();
+        testSubscriptions();
+        testInvocations();
+    }
+    catch (std::exception const& ex)
+    {
+        std::cerr << "ERROR: " << ex.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,185 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "ember/Ember.hpp"
+
+#define THROW_TEST_EXCEPTION(message)                       \
+            {                                               \
+                std::ostringstream msgStream;               \
+                msgStream << message ;                      \
+                throw std::runtime_error(msgStream.str());  \
+            }
+
+namespace
+{
+    using namespace libember::glow;
+
+    std::vector<unsigned char> encodeTree(libember::dom::Node const& message)
+    {
+        libember::util::OctetStream stream;
+        message.encode(stream);
+        return std::vector<unsigned char>(stream.begin(), stream.end());
+    }
+
+    void compare(GlowRequestEncoder const& encoder, libember::dom::Node const& message, std::string const& shape)
+    {
+        std::vector<unsigned char> const expected = encodeTree(message);
+        if (encoder.size() != expected.size() || std::equal(encoder.begin(), encoder.end(), expected.begin()) == false)
+        {
+            THROW_TEST_EXCEPTION("The encoding of " << shape << " differs from the encoding of the tree");
+        }
+    }
+
+    GlowContentElement* createElement(GlowRootElementCollection* root, GlowTreeMirror::ElementType type, libember::ber::ObjectIdentifier const& path)
+    {
+        switch(type)
+        {
+            case GlowTreeMirror::Parameter:
+                return new GlowQualifiedParameter(root, path);
+            case GlowTreeMirror::Matrix:
+                return new GlowQualifiedMatrix(root, path);
+            case GlowTreeMirror::Function:
+                return new GlowQualifiedFunction(root, path);
+            default:
+                return new GlowQualifiedNode(root, path);
+        }
+    }
+
+    GlowElementCollection* childrenOf(GlowContentElement* element, GlowTreeMirror::ElementType type)
+    {
+        switch(type)
+        {
+            case GlowTreeMirror::Parameter:
+                return static_cast<GlowParameterBase*>(element)->children();
+            case GlowTreeMirror::Matrix:
+                return static_cast<GlowMatrixBase*>(element)->children();
+            case GlowTreeMirror::Function:
+                return static_cast<GlowFunctionBase*>(element)->children();
+            default:
+                return static_cast<GlowNodeBase*>(element)->children();
+        }
+    }
+
+    std::vector<libember::ber::ObjectIdentifier> createPaths()
+    {
+        std::vector<libember::ber::ObjectIdentifier> paths;
+        paths.push_back(libember::ber::ObjectIdentifier(1));
+
+        libember::ber::ObjectIdentifier wide;
+        wide.push_back(0);
+        wide.push_back(127);
+        wide.push_back(128);
+        wide.push_back(16384);
+        wide.push_back(0xFFFFFFFFU);
+        paths.push_back(wide);
+
+        // long enough for lengths in their long form
+        libember::ber::ObjectIdentifier deep;
+        for (unsigned int index = 0; index < 300; ++index)
+        {
+            deep.push_back(index * 97);
+        }
+        paths.push_back(deep);
+        return paths;
+    }
+
+    void testCommands()
+    {
+        GlowRequestEncoder encoder;
+        CommandType const commands[] = { CommandType::GetDirectory, CommandType::Subscribe, CommandType::Unsubscribe };
+        GlowTreeMirror::ElementType const types[] =
+        {
+            GlowTreeMirror::Node, GlowTreeMirror::Parameter, GlowTreeMirror::Matrix, GlowTreeMirror::Function
+        };
+
+        for (std::size_t command = 0; command < sizeof(commands) / sizeof(commands[0]); ++command)
+        {
+            GlowRootElementCollection root;
+            new GlowCommand(&root, commands[command]);
+            encoder.encodeCommand(libember::ber::ObjectIdentifier(), GlowTreeMirror::Node, commands[command]);
+            compare(encoder, root, "a root command");
+        }
+
+        std::vector<libember::ber::ObjectIdentifier> const paths = createPaths();
+        for (std::vector<libember::ber::ObjectIdentifier>::const_iterator path = paths.begin(); path != paths.end(); ++path)
+        {
+            for (std::size_t type = 0; type < sizeof(types) / sizeof(types[0]); ++type)
+            {
+                for (std::size_t command = 0; command < sizeof(commands) / sizeof(commands[0]); ++command)
+                {
+                    GlowRootElementCollection root;
+                    GlowElementCollection* const children = childrenOf(createElement(&root, types[type], *path), types[type]);
+                    children->insert(children->end(), new GlowCommand(commands[command]));
+
+                    encoder.encodeCommand(*path, types[type], commands[command]);
+                    compare(encoder, root, "a command");
+                }
+            }
+        }
+    }
+
+    void testValues()
+    {
+        GlowRequestEncoder encoder;
+        long const values[] =
+        {
+            0, 1, -1, 127, 128, -128, -129, 255, 256, 32767, -32768, 0x12345678L, -0x12345678L,
+            std::numeric_limits<long>::max(), std::numeric_limits<long>::min()
+        };
+
+        std::vector<libember::ber::ObjectIdentifier> const paths = createPaths();
+        for (std::vector<libember::ber::ObjectIdentifier>::const_iterator path = paths.begin(); path != paths.end(); ++path)
+        {
+            for (std::size_t value = 0; value < sizeof(values) / sizeof(values[0]); ++value)
+            {
+                GlowRootElementCollection root;
+                GlowQualifiedParameter* const parameter = new GlowQualifiedParameter(&root, *path);
+                parameter->setValue(values[value]);
+
+                std::ostringstream shape;
+                shape << "the value " << values[value];
+
+                encoder.encodeValue(*path, values[value]);
+                compare(encoder, root, shape.str());
+            }
+        }
+    }
+}
+
+int main(int, char const* const*)
+{
+    try
+    {
+        testCommands();
+        testValues();
+    }
+    catch (std::exception const& ex)
+    {
+        std::cerr << "ERROR: " << ex.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,384 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "ember/Ember.hpp"
+
+#define THROW_TEST_EXCEPTION(message)                       \
+            {                                               \
+                std::ostringstream msgStream;               \
+                msgStream << message ;                      \
+                throw std::runtime_error(msgStream.str());  \
+            }
+
+namespace
+{
+    using namespace libember::glow;
+    using libember::ber::ObjectIdentifier;
+    using libember::ber::Value;
+    using libember::dom::VariantLeaf;
+
+    typedef GlowReader::ValidationError ValidationError;
+
+    /**
+     * A glow container that does not add any children on its own, used to
+     * create elements the DTD does not allow.
+     */
+    class RawContainer : public GlowContainer
+    {
+        public:
+            RawContainer(GlowType const& type, libember::ber::Tag const& tag)
+                : GlowContainer(type, tag)
+            {}
+    };
+
+    /**
+     * A reader that records the elements it has decoded and the violations it has detected.
+     */
+    class RecordingReader : public GlowReader
+    {
+        public:
+            explicit RecordingReader(bool isValidating)
+                : elements(0)
+                , properties(0)
+                , commands(0)
+                , connections(0)
+            {
+                setSchemaValidation(isValidating);
+            }
+
+            int elements;
+            int properties;
+            int commands;
+            int connections;
+            std::vector<ValidationError::_Domain> errors;
+            std::vector<ObjectIdentifier> paths;
+
+        protected:
+            virtual void elementReady(GlowType const&, ObjectIdentifier const&)
+            {
+                elements += 1;
+            }
+
+            virtual void propertyReady(GlowType const&, ObjectIdentifier const&, libember::ber::Tag const&, Value const&)
+            {
+                properties += 1;
+            }
+
+            virtual void commandReady(ObjectIdentifier const&, int)
+            {
+                commands += 1;
+            }
+
+            virtual void connectionReady(ObjectIdentifier const&, int, ObjectIdentifier const&, ConnectionOperation const&, ConnectionDisposition const&)
+            {
+                connections += 1;
+            }
+
+            virtual void validationFailed(ValidationError::_Domain error, GlowType const&, ObjectIdentifier const& path)
+            {
+                errors.push_back(error);
+                paths.push_back(path);
+            }
+    };
+
+    std::vector<unsigned char> encode(libember::dom::Node const& node)
+    {
+        libember::util::OctetStream stream;
+        node.encode(stream);
+        return std::vector<unsigned char>(stream.begin(), stream.end());
+    }
+
+    void read(GlowReader& reader, libember::dom::Node const& message)
+    {
+        std::vector<unsigned char> const bytes = encode(message);
+        reader.read(&bytes.front(), &bytes.front() + bytes.size());
+    }
+
+    /**
+     * Creates a message using all element types and the properties commonly sent by providers.
+     */
+    GlowRootElementCollection* createValidMessage()
+    {
+        GlowRootElementCollection* const root = GlowRootElementCollection::create();
+        GlowNode* const node = new GlowNode(root, 1);
+        node->setIdentifier("device");
+        node->setDescription("Device");
+        node->setIsOnline(true);
+        node->setSchemaIdentifiers("de.l-s-b.emberplus.device");
+
+        GlowParameter* const gain = new GlowParameter(node, 1);
+        gain->setIdentifier("gain");
+        gain->setValue(-12.5);
+        gain->setMinimum(-128.0);
+        gain->setMaximum(15.0);
+        gain->setAccess(Access::ReadWrite);
+        gain->setFormat("%.2f dB");
+        gain->setFormula("$", "$");
+        gain->setDefault(0.0);
+        gain->setType(ParameterType::Real);
+        gain->setStreamIdentifier(2);
+
+        GlowParameter* const mode = new GlowParameter(node, 2);
+        mode->setIdentifier("mode");
+        mode->setValue(1L);
+        mode->setEnumeration("off\non");
+        mode->setStep(1);
+        mode->setFactor(1);
+
+        GlowParameter* const name = new GlowParameter(node, 3);
+        name->setIdentifier("name");
+        name->setValue(std::string("channel"));
+        name->setStreamDescriptor(StreamFormat::IeeeFloat32LittleEndian, 4);
+
+        GlowMatrix* const matrix = new GlowMatrix(node, 4);
+        matrix->setIdentifier("router");
+        matrix->setTargetCount(4);
+        matrix->setSourceCount(4);
+        matrix->setParametersLocation(ObjectIdentifier(1));
+        GlowConnection* const connection = new GlowConnection(2);
+        connection->setSources(ObjectIdentifier(3));
+        matrix->connections()->insert(matrix->connections()->end(), connection);
+
+        GlowFunction* const function = new GlowFunction(node, 5);
+        function->setIdentifier("reset");
+
+        GlowQualifiedParameter* const level = new GlowQualifiedParameter(root, ObjectIdentifier(1));
+        level->setValue(true);
+
+        GlowCommand* const command = new GlowCommand(CommandType::GetDirectory);
+        root->insert(root->end(), command);
+        return root;
+    }
+
+    void testValidMessage()
+    {
+        std::auto_ptr<libember::dom::Node> const message(createValidMessage());
+
+        RecordingReader plain(false);
+        read(plain, *message);
+
+        RecordingReader validating(true);
+        read(validating, *message);
+
+        if (validating.errors.empty() == false)
+        {
+            THROW_TEST_EXCEPTION("A valid message has been rejected: " << GlowReader::describe(validating.errors.front()));
+        }
+
+        if (validating.elements != plain.elements || validating.properties != plain.properties
+        ||  validating.commands != plain.commands || validating.connections != plain.connections)
+        {
+            THROW_TEST_EXCEPTION("Validation has changed the reported elements");
+        }
+
+        // the default implementation does not throw for a valid message
+        GlowReader reader;
+        reader.setSchemaValidation(true);
+        read(reader, *message);
+    }
+
+    void expect(RecordingReader const& reader, ValidationError::_Domain error, ObjectIdentifier const& path)
+    {
+        if (reader.errors.size() != 1 || reader.errors.front() != error)
+        {
+            THROW_TEST_EXCEPTION("Expected the error \"" << GlowReader::describe(error) << "\", detected " << reader.errors.size() << " errors");
+        }
+
+        if (reader.paths.front() != path)
+        {
+            THROW_TEST_EXCEPTION("The error \"" << GlowReader::describe(error) << "\" has been reported with the wrong path");
+        }
+    }
+
+    void testMissingNumbers()
+    {
+        {
+            std::auto_ptr<GlowRootElementCollection> const root(GlowRootElementCollection::create());
+            GlowNode* const node = new GlowNode(root.get(), 7);
+            RawContainer* const child = new RawContainer(GlowType::Parameter, GlowTags::ElementDefault());
+            node->children()->insert(node->children()->end(), child);
+            libember::dom::Set* const contents = new libember::dom::Set(GlowTags::Parameter::Contents());
+            contents->insert(contents->end(), new VariantLeaf(GlowTags::ParameterContents::Identifier(), Value(std::string("gain"))));
+            child->insert(child->end(), contents);
+
+            RecordingReader reader(true);
+            read(reader, *root);
+            expect(reader, ValidationError::MissingNumber, ObjectIdentifier(7));
+        }
+
+        {
+            std::auto_ptr<GlowRootElementCollection> const root(GlowRootElementCollection::create());
+            root->insert(root->end(), new RawContainer(GlowType::QualifiedNode, GlowTags::ElementDefault()));
+
+            RecordingReader reader(true);
+            read(reader, *root);
+            expect(reader, ValidationError::MissingPath, ObjectIdentifier());
+        }
+
+        {
+            std::auto_ptr<GlowRootElementCollection> const root(GlowRootElementCollection::create());
+            root->insert(root->end(), new RawContainer(GlowType::Command, GlowTags::ElementDefault()));
+
+            RecordingReader reader(true);
+            read(reader, *root);
+            expect(reader, ValidationError::MissingCommandNumber, ObjectIdentifier());
+            if (reader.commands != 0)
+            {
+                THROW_TEST_EXCEPTION("A command without number has been reported");
+            }
+        }
+
+        {
+            std::auto_ptr<GlowRootElementCollection> const root(GlowRootElementCollection::create());
+            GlowMatrix* const matrix = new GlowMatrix(root.get(), 3);
+            matrix->setIdentifier("router");
+            matrix->setTargetCount(4);
+
+            RecordingReader reader(true);
+            read(reader, *root);
+            expect(reader, ValidationError::MissingProperty, ObjectIdentifier(3));
+        }
+    }
+
+    void testPaths()
+    {
+        {
+            std::auto_ptr<GlowRootElementCollection> const root(GlowRootElementCollection::create());
+            new GlowQualifiedNode(root.get(), ObjectIdentifier());
+
+            RecordingReader reader(true);
+            read(reader, *root);
+            expect(reader, ValidationError::EmptyPath, ObjectIdentifier());
+        }
+
+        {
+            std::auto_ptr<GlowRootElementCollection> const root(GlowRootElementCollection::create());
+            GlowNode* const node = new GlowNode(root.get(), 2);
+            GlowQualifiedNode* const nested = new GlowQualifiedNode(ObjectIdentifier(2));
+            node->children()->insert(node->children()->end(), nested);
+
+            RecordingReader reader(true);
+            read(reader, *root);
+            expect(reader, ValidationError::NestedQualifiedElement, ObjectIdentifier(2));
+        }
+    }
+
+    void testTypeMismatches()
+    {
+        {
+            std::auto_ptr<GlowRootElementCollection> const root(GlowRootElementCollection::create());
+            RawContainer* const node = new RawContainer(GlowType::Node, GlowTags::ElementDefault());
+            node->insert(node->end(), new VariantLeaf(GlowTags::Node::Number(), Value(std::string("1"))));
+            root->insert(root->end(), node);
+
+            RecordingReader reader(true);
+            read(reader, *root);
+            if (reader.errors.size() != 2 || reader.errors[0] != ValidationError::TypeMismatch || reader.errors[1] != ValidationError::MissingNumber)
+            {
+                THROW_TEST_EXCEPTION("A number encoded as string has not been rejected");
+            }
+        }
+
+        {
+            std::auto_ptr<GlowRootElementCollection> const root(GlowRootElementCollection::create());
+            RawContainer* const node = new RawContainer(GlowType::Node, GlowTags::ElementDefault());
+            node->insert(node->end(), new VariantLeaf(GlowTags::Node::Number(), Value(5)));
+            libember::dom::Set* const contents = new libember::dom::Set(GlowTags::Node::Contents());
+            contents->insert(contents->end(), new VariantLeaf(GlowTags::NodeContents::Identifier(), Value(42)));
+            contents->insert(contents->end(), new VariantLeaf(GlowTags::NodeContents::IsOnline(), Value(true)));
+            node->insert(node->end(), contents);
+            root->insert(root->end(), node);
+
+            RecordingReader reader(true);
+            read(reader, *root);
+            expect(reader, ValidationError::TypeMismatch, ObjectIdentifier(5));
+            if (reader.properties != 1)
+            {
+                THROW_TEST_EXCEPTION("A property with an invalid type has been reported");
+            }
+
+            RecordingReader plain(false);
+            read(plain, *root);
+            if (plain.errors.empty() == false || plain.properties != 2)
+            {
+                THROW_TEST_EXCEPTION("A reader without validation has checked the message");
+            }
+        }
+
+        {
+            std::auto_ptr<GlowRootElementCollection> const root(GlowRootElementCollection::create());
+            RawContainer* const parameter = new RawContainer(GlowType::Parameter, GlowTags::ElementDefault());
+            parameter->insert(parameter->end(), new VariantLeaf(GlowTags::Parameter::Number(), Value(1)));
+            libember::dom::Set* const contents = new libember::dom::Set(GlowTags::Parameter::Contents());
+            contents->insert(contents->end(), new VariantLeaf(GlowTags::ParameterContents::EnumMap(), Value(std::string("off"))));
+            parameter->insert(parameter->end(), contents);
+            root->insert(root->end(), parameter);
+
+            RecordingReader reader(true);
+            read(reader, *root);
+            expect(reader, ValidationError::TypeMismatch, ObjectIdentifier(1));
+        }
+    }
+
+    void testDefaultHandler()
+    {
+        std::auto_ptr<GlowRootElementCollection> const root(GlowRootElementCollection::create());
+        new GlowQualifiedNode(root.get(), ObjectIdentifier());
+
+        GlowReader reader;
+        read(reader, *root);
+
+        reader.setSchemaValidation(true);
+        reader.reset();
+        try
+        {
+            read(reader, *root);
+        }
+        catch (std::runtime_error const&)
+        {
+            return;
+        }
+
+        THROW_TEST_EXCEPTION("The default handler has not thrown an exception");
+    }
+}
+
+int main(int, char const* const*)
+{
+    try
+    {
+        testValidMessage();
+        testMissingNumbers();
+        testPaths();
+        testTypeMismatches();
+        testDefaultHandler();
+    }
+    catch (std::exception const& ex)
+    {
+        std::cerr << "ERROR: " << ex.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
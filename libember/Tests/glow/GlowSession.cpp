@@ -0,0 +1,425 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+#include "ember/Ember.hpp"
+
+#define THROW_TEST_EXCEPTION(message)                       \
+            {                                               \
+                std::ostringstream msgStream;               \
+                msgStream << message ;                      \
+                throw std::runtime_error(msgStream.str());  \
+            }
+
+namespace
+{
+    using namespace libember::glow;
+
+    /**
+     * A connection which keeps the decoded copies of all messages written to it.
+     */
+    class RecordingConnection : public GlowSession::Connection
+    {
+        public:
+            ~RecordingConnection()
+            {
+                clear();
+            }
+
+            virtual void write(libember::dom::Node const& message)
+            {
+                libember::util::OctetStream stream;
+                message.encode(stream);
+
+                libember::dom::DomReader reader;
+                libember::dom::Node* const result = reader.decodeTree(stream, GlowNodeFactory::getFactory());
+                if (result == 0)
+                {
+                    THROW_TEST_EXCEPTION("A written message could not be decoded");
+                }
+                messages.push_back(result);
+            }
+
+            void clear()
+            {
+                for (std::vector<libember::dom::Node*>::iterator it = messages.begin(); it != messages.end(); ++it)
+                {
+                    delete *it;
+                }
+                messages.clear();
+            }
+
+            std::vector<libember::dom::Node*> messages;
+    };
+
+    /**
+     * Counts the commands in a message and collects the invocations.
+     */
+    class CommandCounter : private GlowVisitor
+    {
+        public:
+            CommandCounter(libember::dom::Node const& message, CommandType const& type)
+                : count(0)
+                , invocationId(0)
+                , m_type(type)
+            {
+                accept(message);
+            }
+
+            int count;
+            int invocationId;
+
+        private:
+            virtual void visit(GlowRootElementCollection const& glow)
+            {
+                acceptChildren(glow);
+            }
+
+            virtual void visit(GlowQualifiedNode const& glow)
+            {
+                if (glow.children() != 0)
+                    acceptChildren(*glow.children());
+            }
+
+            virtual void visit(GlowQualifiedParameter const& glow)
+            {
+                if (glow.children() != 0)
+                    acceptChildren(*glow.children());
+            }
+
+            virtual void visit(GlowQualifiedFunction const& glow)
+            {
+                if (glow.children() != 0)
+                    acceptChildren(*glow.children());
+            }
+
+            virtual void visit(GlowCommand const& glow)
+            {
+                if (glow.number().value() == m_type.value())
+                {
+                    count += 1;
+                    if (glow.invocation() != 0)
+                        invocationId = glow.invocation()->invocationId();
+                }
+            }
+
+            CommandType const m_type;
+    };
+
+    /**
+     * A continuation which keeps the last result it has been resumed with.
+     */
+    class RecordingContinuation : public GlowSession::Continuation
+    {
+        public:
+            RecordingContinuation()
+                : count(0)
+                , result(GlowSession::Status::TimedOut)
+                , success(false)
+            {}
+
+            virtual void resume(GlowSession::Result const& result)
+            {
+                count += 1;
+                this->result = result;
+                success = result.invocationResult != 0 && result.invocationResult->success();
+            }
+
+            int count;
+            GlowSession::Result result;
+            bool success;
+    };
+
+    /**
+     * A listener which counts the notifications it has received.
+     */
+    class CountingListener : public GlowSession::Listener
+    {
+        public:
+            CountingListener()
+                : count(0)
+            {}
+
+            virtual void notify(libember::ber::ObjectIdentifier const& path, GlowContentElement const&)
+            {
+                count += 1;
+                this->path = path;
+            }
+
+            int count;
+            libember::ber::ObjectIdentifier path;
+    };
+
+    int countCommands(RecordingConnection const& connection, CommandType const& type)
+    {
+        int count = 0;
+        for (std::vector<libember::dom::Node*>::const_iterator it = connection.messages.begin(); it != connection.messages.end(); ++it)
+        {
+            count += CommandCounter(**it, type).count;
+        }
+        return count;
+    }
+
+    GlowRootElementCollection* createTree()
+    {
+        GlowRootElementCollection* const root = GlowRootElementCollection::create();
+        GlowNode* const node = new GlowNode(root, 1);
+        node->setIdentifier("device");
+
+        GlowParameter* const parameter = new GlowParameter(2);
+        root->insert(root->end(), parameter);
+        parameter->setIdentifier("gain");
+        parameter->setValue(3L);
+
+        new GlowFunction(root, 3);
+        return root;
+    }
+
+    void testDirectory()
+    {
+        RecordingConnection provider;
+        RecordingContinuation root, device;
+        GlowSession session(provider, 100);
+
+        session.getDirectory(libember::ber::ObjectIdentifier(), &root);
+        session.getDirectory(libember::ber::ObjectIdentifier(1), &device);
+        if (countCommands(provider, CommandType::GetDirectory) != 2 || session.pendingCount() != 2)
+        {
+            THROW_TEST_EXCEPTION("The directories have not been requested");
+        }
+
+        std::auto_ptr<libember::dom::Node> const tree(createTree());
+        session.providerMessage(*tree);
+        if (root.count != 1 || root.result.status != GlowSession::Status::Completed
+        ||  root.result.elements.size() != 3 || root.result.paths.at(1) != libember::ber::ObjectIdentifier(2))
+        {
+            THROW_TEST_EXCEPTION("The root directory has not been completed");
+        }
+
+        if (device.count != 0 || session.pendingCount() != 1)
+        {
+            THROW_TEST_EXCEPTION("The directory of a node has been completed by its parent");
+        }
+
+        // a node without children is reported without properties
+        GlowRootElementCollection empty;
+        new GlowQualifiedNode(&empty, libember::ber::ObjectIdentifier(1));
+        session.providerMessage(empty);
+        if (device.count != 1 || device.result.elements.size() != 1 || session.pendingCount() != 0)
+        {
+            THROW_TEST_EXCEPTION("The empty directory has not been completed");
+        }
+    }
+
+    void testValue()
+    {
+        RecordingConnection provider;
+        RecordingContinuation continuation;
+        GlowSession session(provider, 100);
+
+        libember::ber::ObjectIdentifier const path(2);
+        session.setValue(path, Value(7L), &continuation);
+
+        GlowQualifiedParameter const* const request = dynamic_cast<GlowQualifiedParameter const*>(
+            &*dynamic_cast<libember::dom::Container const*>(provider.messages.at(0))->begin());
+        if (request == 0 || request->path() != path || request->value().toInteger() != 7)
+        {
+            THROW_TEST_EXCEPTION("The value has not been sent");
+        }
+
+        GlowRootElementCollection response;
+        GlowQualifiedParameter* const parameter = new GlowQualifiedParameter(&response, path);
+        parameter->setValue(7L);
+        session.providerMessage(response);
+        if (continuation.count != 1 || continuation.result.elements.size() != 1 || session.pendingCount() != 0)
+        {
+            THROW_TEST_EXCEPTION("The value change has not been completed");
+        }
+    }
+
+    void testInvocations()
+    {
+        RecordingConnection provider;
+        RecordingContinuation answered, unanswered;
+        GlowSession session(provider, 100);
+
+        std::vector<Value> arguments;
+        arguments.push_back(Value(1L));
+        session.invoke(libember::ber::ObjectIdentifier(3), arguments.begin(), arguments.end(), &answered);
+        session.invoke(libember::ber::ObjectIdentifier(3), arguments.begin(), arguments.end(), &unanswered);
+
+        int const invocationId = CommandCounter(*provider.messages.at(0), CommandType::Invoke).invocationId;
+        if (invocationId <= 0 || session.pendingCount() != 2)
+        {
+            THROW_TEST_EXCEPTION("The invocations have not been sent");
+        }
+
+        GlowInvocationResult result;
+        result.setInvocationId(invocationId);
+        result.setSuccess(true);
+        session.providerMessage(result);
+        if (answered.count != 1 || answered.success == false || unanswered.count != 0)
+        {
+            THROW_TEST_EXCEPTION("The invocation result has not been delivered");
+        }
+
+        if (session.expire(99) != 0 || session.expire(100) != 1
+        ||  unanswered.count != 1 || unanswered.result.status != GlowSession::Status::TimedOut)
+        {
+            THROW_TEST_EXCEPTION("The unanswered invocation has not timed out");
+        }
+    }
+
+    void testTimeoutAndCancel()
+    {
+        RecordingConnection provider;
+        RecordingContinuation first, second;
+        GlowSession session(provider, 10);
+
+        session.expire(5);
+        session.getDirectory(libember::ber::ObjectIdentifier(1), &first);
+        session.getDirectory(libember::ber::ObjectIdentifier(2), &second);
+        if (session.cancel(&second) != 1 || session.pendingCount() != 1)
+        {
+            THROW_TEST_EXCEPTION("The operation has not been cancelled");
+        }
+
+        if (session.expire(14) != 0 || session.expire(15) != 1
+        ||  first.count != 1 || first.result.status != GlowSession::Status::TimedOut || second.count != 0)
+        {
+            THROW_TEST_EXCEPTION("The operation has not timed out at its deadline");
+        }
+    }
+
+    void testSubscriptions()
+    {
+        RecordingConnection provider;
+        CountingListener first, second;
+        GlowSession session(provider, 100);
+
+        libember::ber::ObjectIdentifier const path(2);
+        session.subscribe(path, &first, GlowTreeMirror::Parameter);
+        session.subscribe(path, &second, GlowTreeMirror::Parameter);
+        if (countCommands(provider, CommandType::Subscribe) != 1)
+        {
+            THROW_TEST_EXCEPTION("The provider has not been subscribed exactly once");
+        }
+
+        GlowRootElementCollection update;
+        GlowQualifiedParameter* const parameter = new GlowQualifiedParameter(&update, path);
+        parameter->setValue(9L);
+        session.providerMessage(update);
+        if (first.count != 1 || second.count != 1 || first.path != path)
+        {
+            THROW_TEST_EXCEPTION("The listeners have not been notified");
+        }
+
+        session.unsubscribe(path, &first);
+        if (countCommands(provider, CommandType::Unsubscribe) != 0)
+        {
+            THROW_TEST_EXCEPTION("The provider has been unsubscribed while a listener is still subscribed");
+        }
+
+        session.unsubscribe(path, &second);
+        session.providerMessage(update);
+        if (countCommands(provider, CommandType::Unsubscribe) != 1 || second.count != 1)
+        {
+            THROW_TEST_EXCEPTION("Removing the last listener has not unsubscribed the provider");
+        }
+    }
+
+    void testBatching()
+    {
+        RecordingConnection provider;
+        RecordingContinuation continuation;
+        CountingListener listener;
+        GlowSession session(provider, 100);
+        session.setBatching(3, 10);
+
+        libember::ber::ObjectIdentifier const path(2);
+        session.setValue(path, Value(1L), &continuation);
+        session.setValue(path, Value(2L), &continuation);
+        if (provider.messages.empty() == false || session.batchedCount() != 2)
+        {
+            THROW_TEST_EXCEPTION("The requests have not been gathered");
+        }
+
+        session.subscribe(libember::ber::ObjectIdentifier(3), &listener, GlowTreeMirror::Parameter);
+        libember::dom::Container const* const message = dynamic_cast<libember::dom::Container const*>(provider.messages.at(0));
+        if (provider.messages.size() != 1 || message->size() != 3 || session.batchedCount() != 0)
+        {
+            THROW_TEST_EXCEPTION("The full batch has not been sent in one message");
+        }
+
+        libember::dom::Container::const_iterator it = message->begin();
+        GlowQualifiedParameter const* const first = dynamic_cast<GlowQualifiedParameter const*>(&*it++);
+        GlowQualifiedParameter const* const second = dynamic_cast<GlowQualifiedParameter const*>(&*it++);
+        GlowQualifiedParameter const* const third = dynamic_cast<GlowQualifiedParameter const*>(&*it++);
+        if (first == 0 || first->value().toInteger() != 1 || second == 0 || second->value().toInteger() != 2
+        ||  third == 0 || third->path() != libember::ber::ObjectIdentifier(3))
+        {
+            THROW_TEST_EXCEPTION("The batch does not keep the order of the requests");
+        }
+
+        session.expire(20);
+        session.setValue(path, Value(3L), &continuation);
+        session.expire(29);
+        if (provider.messages.size() != 1)
+        {
+            THROW_TEST_EXCEPTION("The request has been sent before its window has passed");
+        }
+
+        session.expire(30);
+        if (provider.messages.size() != 2 || session.batchedCount() != 0)
+        {
+            THROW_TEST_EXCEPTION("The request has not been sent after its window has passed");
+        }
+
+        session.setValue(path, Value(4L), &continuation);
+        session.flush();
+        session.flush();
+        if (provider.messages.size() != 3)
+        {
+            THROW_TEST_EXCEPTION("Flushing has not sent the request exactly once");
+        }
+    }
+}
+
+int main(int, char const* const*)
+{
+    try
+    {
+        testDirectory();
+        testValue();
+        testInvocations();
+        testTimeoutAndCancel();
+        testSubscriptions();
+        testBatching();
+    }
+    catch (std::exception const& ex)
+    {
+        std::cerr << "ERROR: " << ex.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
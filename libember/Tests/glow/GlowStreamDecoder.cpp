@@ -0,0 +1,130 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include "ember/Ember.hpp"
+
+#define THROW_TEST_EXCEPTION(message)                       \
+            {                                               \
+                std::ostringstream msgStream;               \
+                msgStream << message ;                      \
+                throw std::runtime_error(msgStream.str());  \
+            }
+
+namespace
+{
+    using libember::glow::StreamFormat;
+
+    /**
+     * A decoder that records the decoded values by subscriber.
+     */
+    class RecordingDecoder : public libember::glow::GlowStreamDecoder
+    {
+        public:
+            std::map<int, long long> integers;
+            std::map<int, double> reals;
+
+        protected:
+            virtual void integerDecoded(int subscriber, long long value)
+            {
+                integers[subscriber] = value;
+            }
+
+            virtual void realDecoded(int subscriber, double value)
+            {
+                reals[subscriber] = value;
+            }
+    };
+
+    void testSharedEntry()
+    {
+        unsigned char bytes[25] = { 0xC8, 0xFF, 0x38, 0x34, 0x12 };
+
+        float const single = -2.5f;
+        unsigned int bits;
+        std::memcpy(&bits, &single, sizeof(bits));
+        for (int i = 0; i < 4; ++i)
+        {
+            bytes[5 + i] = static_cast<unsigned char>(bits >> (i * 8));
+        }
+
+        // 0.125 as big endian double
+        bytes[9] = 0x3F;
+        bytes[10] = 0xC0;
+
+        // -3 as little endian 64 bit integer
+        bytes[17] = 0xFD;
+        for (int i = 18; i < 25; ++i)
+        {
+            bytes[i] = 0xFF;
+        }
+
+        RecordingDecoder decoder;
+        decoder.subscribe(7, StreamFormat::UnsignedInt8, 0, 1);
+        decoder.subscribe(7, StreamFormat::SignedInt16BigEndian, 1, 2);
+        decoder.subscribe(7, StreamFormat::UnsignedInt16LittleEndian, 3, 3);
+        decoder.subscribe(7, StreamFormat::IeeeFloat32LittleEndian, 5, 4);
+        decoder.subscribe(7, StreamFormat::IeeeFloat64BigEndian, 9, 5);
+        decoder.subscribe(7, StreamFormat::SignedInt64LittleEndian, 17, 6);
+        decoder.subscribe(7, StreamFormat::SignedInt8, 0, 7);
+        decoder.subscribe(7, StreamFormat::UnsignedInt32BigEndian, 24, 8);
+        decoder.subscribe(7, StreamFormat::UnsignedInt8, 2, 9);
+        decoder.subscribe(8, StreamFormat::UnsignedInt8, 0, 10);
+        decoder.unsubscribe(7, 9);
+
+        libember::glow::GlowStreamCollection collection;
+        collection.insert(7, libember::ber::OctetsView(bytes, bytes + sizeof(bytes)));
+        collection.insert(9, 42);
+
+        libember::glow::GlowStreamDecoder::size_type const count = decoder.decode(collection);
+        if (count != 7 || decoder.integers.size() != 5 || decoder.reals.size() != 2)
+        {
+            THROW_TEST_EXCEPTION("Decoded " << count << " values instead of 7");
+        }
+
+        if (decoder.integers[1] != 200 || decoder.integers[2] != -200 || decoder.integers[3] != 0x1234
+        ||  decoder.integers[6] != -3 || decoder.integers[7] != -56)
+        {
+            THROW_TEST_EXCEPTION("An integer value has been decoded incorrectly");
+        }
+
+        if (decoder.reals[4] != -2.5 || decoder.reals[5] != 0.125)
+        {
+            THROW_TEST_EXCEPTION("A real value has been decoded incorrectly");
+        }
+    }
+}
+
+int main(int, char const* const*)
+{
+    try
+    {
+        testSharedEntry();
+    }
+    catch (std::exception const& e)
+    {
+        std::cerr << "ERROR: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,336 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+#include "ember/Ember.hpp"
+
+#define THROW_TEST_EXCEPTION(message)                       \
+            {                                               \
+                std::ostringstream msgStream;               \
+                msgStream << message ;                      \
+                throw std::runtime_error(msgStream.str());  \
+            }
+
+namespace
+{
+    using namespace libember::glow;
+    using libember::ber::ObjectIdentifier;
+
+    /**
+     * A connection which counts the messages written to it and the directory
+     * requests they contain.
+     */
+    class CountingConnection : public GlowSession::Connection, private GlowVisitor
+    {
+        public:
+            CountingConnection()
+                : messages(0)
+                , requests(0)
+            {}
+
+            virtual void write(libember::dom::Node const& message)
+            {
+                messages += 1;
+                accept(message);
+            }
+
+            int messages;
+            int requests;
+
+        private:
+            virtual void visit(GlowRootElementCollection const& glow)
+            {
+                acceptChildren(glow);
+            }
+
+            virtual void visit(GlowQualifiedNode const& glow)
+            {
+                if (glow.children() != 0)
+                    acceptChildren(*glow.children());
+            }
+
+            virtual void visit(GlowCommand const& glow)
+            {
+                if (glow.number().value() == CommandType::GetDirectory)
+                    requests += 1;
+            }
+    };
+
+    /**
+     * A listener which keeps the last expansion it has been notified about.
+     */
+    class RecordingListener : public GlowTreeBrowser::Listener
+    {
+        public:
+            RecordingListener()
+                : count(0)
+                , isComplete(false)
+            {}
+
+            virtual void expanded(ObjectIdentifier const& path, bool isComplete)
+            {
+                count += 1;
+                this->path = path;
+                this->isComplete = isComplete;
+            }
+
+            int count;
+            ObjectIdentifier path;
+            bool isComplete;
+    };
+
+    ObjectIdentifier path(int first)
+    {
+        return ObjectIdentifier(first);
+    }
+
+    /**
+     * Creates the directory of the root, which contains @p count nodes.
+     */
+    GlowRootElementCollection* createRoot(int count)
+    {
+        GlowRootElementCollection* const root = GlowRootElementCollection::create();
+        for (int i = 1; i <= count; ++i)
+        {
+            GlowNode* const node = new GlowNode(root, i);
+            node->setIdentifier("node");
+        }
+        return root;
+    }
+
+    /**
+     * Creates the directory of a top level node, which contains @p nodes nodes
+     * and @p parameters parameters.
+     */
+    GlowRootElementCollection* createDirectory(int number, int nodes, int parameters)
+    {
+        GlowRootElementCollection* const root = GlowRootElementCollection::create();
+        GlowQualifiedNode* const node = new GlowQualifiedNode(root, path(number));
+        GlowElementCollection* const children = node->children();
+        for (int i = 1; i <= nodes; ++i)
+        {
+            GlowNode* const child = new GlowNode(i);
+            child->setIdentifier("child");
+            children->insert(children->end(), child);
+        }
+        for (int i = 1; i <= parameters; ++i)
+        {
+            GlowParameter* const parameter = new GlowParameter(nodes + i);
+            parameter->setIdentifier("gain");
+            parameter->setValue(long(i));
+            children->insert(children->end(), parameter);
+        }
+        return root;
+    }
+
+    void testExpand()
+    {
+        CountingConnection provider;
+        GlowSession session(provider, 100);
+        GlowTreeMirror mirror;
+        RecordingListener listener;
+        GlowTreeBrowser browser(session, mirror, &listener);
+
+        if (browser.expand(ObjectIdentifier()) || provider.requests != 1 || browser.pendingCount() != 1)
+        {
+            THROW_TEST_EXCEPTION("The directory of the root has not been requested");
+        }
+
+        std::auto_ptr<libember::dom::Node> const root(createRoot(3));
+        browser.providerMessage(*root);
+        if (listener.count != 1 || listener.isComplete == false || listener.path.empty() == false
+        ||  browser.isExpanded(ObjectIdentifier()) == false || mirror.size() != 3)
+        {
+            THROW_TEST_EXCEPTION("The expansion of the root has not been completed");
+        }
+
+        if (browser.expand(ObjectIdentifier()) == false || provider.requests != 1 || listener.count != 1)
+        {
+            THROW_TEST_EXCEPTION("A known directory has been requested again");
+        }
+
+        browser.invalidate(ObjectIdentifier());
+        if (browser.expand(ObjectIdentifier()) || provider.requests != 2)
+        {
+            THROW_TEST_EXCEPTION("An invalidated directory has not been requested again");
+        }
+    }
+
+    void testPrefetch()
+    {
+        CountingConnection provider;
+        GlowSession session(provider, 100);
+        GlowTreeMirror mirror;
+        RecordingListener listener;
+        GlowTreeBrowser browser(session, mirror, &listener);
+        browser.setPrefetching(2, 2, 64);
+
+        browser.expand(ObjectIdentifier());
+        std::auto_ptr<libember::dom::Node> const root(createRoot(4));
+        browser.providerMessage(*root);
+
+        for (int i = 1; i <= 4; ++i)
+        {
+            browser.setVisible(path(i), true);
+        }
+        browser.flush();
+        if (provider.requests != 3 || browser.pendingCount() != 2 || browser.queuedCount() != 2)
+        {
+            THROW_TEST_EXCEPTION("The prefetches have not been limited to the pipeline depth");
+        }
+
+        // a hidden node is not prefetched
+        browser.setVisible(path(4), false);
+
+        std::auto_ptr<libember::dom::Node> const first(createDirectory(1, 2, 1));
+        browser.providerMessage(*first);
+        if (listener.count != 1 || browser.isExpanded(path(1)) == false)
+        {
+            THROW_TEST_EXCEPTION("The prefetched directory has not been completed silently");
+        }
+
+        if (provider.requests != 4 || browser.queuedCount() != 0)
+        {
+            THROW_TEST_EXCEPTION("The next prefetch has not been sent");
+        }
+
+        if (browser.expand(path(1)) == false)
+        {
+            THROW_TEST_EXCEPTION("The prefetched node could not be expanded immediately");
+        }
+
+        if (browser.expand(path(2)) || provider.requests != 4)
+        {
+            THROW_TEST_EXCEPTION("A running prefetch has been requested again");
+        }
+
+        std::auto_ptr<libember::dom::Node> const second(createDirectory(2, 1, 0));
+        browser.providerMessage(*second);
+        if (listener.count != 2 || listener.path != path(2) || listener.isComplete == false)
+        {
+            THROW_TEST_EXCEPTION("The listener has not been notified about an expansion using a prefetch");
+        }
+    }
+
+    void testWideParameterNodes()
+    {
+        CountingConnection provider;
+        GlowSession session(provider, 100);
+        GlowTreeMirror mirror;
+        GlowTreeBrowser browser(session, mirror, 0);
+        browser.setPrefetching(1, 1, 4);
+
+        browser.expand(ObjectIdentifier());
+        std::auto_ptr<libember::dom::Node> const root(createRoot(5));
+        browser.providerMessage(*root);
+
+        for (int i = 1; i <= 4; ++i)
+        {
+            browser.setVisible(path(i), true);
+        }
+        browser.flush();
+
+        std::auto_ptr<libember::dom::Node> const wide(createDirectory(1, 0, 4));
+        browser.providerMessage(*wide);
+        if (browser.queuedCount() != 0 || browser.pendingCount() != 0 || provider.requests != 2)
+        {
+            THROW_TEST_EXCEPTION("The siblings of a wide parameter node have been prefetched");
+        }
+
+        browser.setVisible(path(5), true);
+        browser.flush();
+        if (browser.queuedCount() != 0 || provider.requests != 2)
+        {
+            THROW_TEST_EXCEPTION("A sibling of a wide parameter node has been queued");
+        }
+
+        if (browser.expand(path(2)) || provider.requests != 3)
+        {
+            THROW_TEST_EXCEPTION("A sibling of a wide parameter node could not be expanded");
+        }
+    }
+
+    void testBatches()
+    {
+        CountingConnection provider;
+        GlowSession session(provider, 100);
+        GlowTreeMirror mirror;
+        GlowTreeBrowser browser(session, mirror, 0);
+        browser.setPrefetching(8, 4, 64);
+
+        browser.expand(ObjectIdentifier());
+        std::auto_ptr<libember::dom::Node> const root(createRoot(4));
+        browser.providerMessage(*root);
+
+        session.setBatching(16, 100);
+        int const messages = provider.messages;
+        for (int i = 1; i <= 4; ++i)
+        {
+            browser.setVisible(path(i), true);
+        }
+
+        if (provider.messages != messages + 1 || provider.requests != 5 || session.batchedCount() != 0)
+        {
+            THROW_TEST_EXCEPTION("The prefetches have not been sent as a single message");
+        }
+    }
+
+    void testTimeout()
+    {
+        CountingConnection provider;
+        GlowSession session(provider, 10);
+        GlowTreeMirror mirror;
+        RecordingListener listener;
+        GlowTreeBrowser browser(session, mirror, &listener);
+
+        browser.expand(path(1));
+        session.expire(10);
+        if (listener.count != 1 || listener.isComplete || browser.isExpanded(path(1)) || browser.pendingCount() != 0)
+        {
+            THROW_TEST_EXCEPTION("The expansion has not timed out");
+        }
+
+        if (browser.expand(path(1)) || provider.requests != 2)
+        {
+            THROW_TEST_EXCEPTION("A node that has timed out has not been requested again");
+        }
+    }
+}
+
+int main(int, char const* const*)
+{
+    try
+    {
+        testExpand();
+        testPrefetch();
+        testWideParameterNodes();
+        testBatches();
+        testTimeout();
+    }
+    catch (std::exception const& ex)
+    {
+        std::cerr << "ERROR: " << ex.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
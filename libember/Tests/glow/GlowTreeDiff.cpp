@@ -0,0 +1,194 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include "ember/Ember.hpp"
+
+#define THROW_TEST_EXCEPTION(message)                       \
+            {                                               \
+                std::ostringstream msgStream;               \
+                msgStream << message ;                      \
+                throw std::runtime_error(msgStream.str());  \
+            }
+
+namespace
+{
+    using namespace libember::glow;
+
+    libember::ber::ObjectIdentifier makePath(int a, int b = -1, int c = -1)
+    {
+        int const items[] = { a, b, c };
+        int count = 1;
+        while (count < 3 && items[count] >= 0)
+        {
+            ++count;
+        }
+        return libember::ber::ObjectIdentifier(items, items + count);
+    }
+
+    /**
+     * Encodes and decodes the passed tree, so the diff works on decoded elements.
+     */
+    libember::dom::Node* transmit(libember::dom::Node const& node)
+    {
+        libember::util::OctetStream stream;
+        node.encode(stream);
+
+        libember::dom::DomReader reader;
+        libember::dom::Node* const result = reader.decodeTree(stream, GlowNodeFactory::getFactory());
+        if (result == 0)
+        {
+            THROW_TEST_EXCEPTION("The encoded tree could not be decoded");
+        }
+        return result;
+    }
+
+    /**
+     * Creates a device tree. The reloaded version changes the gain and a connection,
+     * removes node 1.3 and adds node 1.5.
+     */
+    libember::dom::Node* createTree(bool isReloaded)
+    {
+        std::auto_ptr<GlowRootElementCollection> const root(GlowRootElementCollection::create());
+        GlowNode* const device = new GlowNode(root.get(), 1);
+        device->setIdentifier("device");
+
+        GlowParameter* const gain = new GlowParameter(device, 1);
+        gain->setIdentifier("gain");
+        gain->setValue(isReloaded ? -6L : 0L);
+
+        GlowParameter* const mute = new GlowParameter(device, 2);
+        mute->setIdentifier("mute");
+        mute->setValue(false);
+
+        GlowMatrix* const matrix = new GlowMatrix(device, 4);
+        matrix->setIdentifier("router");
+        matrix->setTargetCount(4);
+        matrix->setSourceCount(4);
+        GlowConnection* const connection = new GlowConnection(1);
+        connection->setSources(makePath(isReloaded ? 3 : 2));
+        matrix->connections()->insert(matrix->connections()->end(), connection);
+
+        GlowNode* const group = new GlowNode(device, isReloaded ? 5 : 3);
+        group->setIdentifier(isReloaded ? "outputs" : "inputs");
+        GlowParameter* const level = new GlowParameter(group, 1);
+        level->setIdentifier("level");
+        level->setValue(0.5);
+
+        return transmit(*root);
+    }
+
+    void testDifferences()
+    {
+        std::auto_ptr<libember::dom::Node> const previous(createTree(false));
+        std::auto_ptr<libember::dom::Node> const current(createTree(true));
+
+        GlowTreeDiff diff;
+        if (diff.compare(*previous, *previous) != 0)
+        {
+            THROW_TEST_EXCEPTION("Comparing a tree with itself reported differences");
+        }
+
+        if (diff.compare(*previous, *current) != 5)
+        {
+            THROW_TEST_EXCEPTION("The comparison reported " << diff.differences().size() << " differences, expected 5");
+        }
+
+        GlowTreeDiff::DifferenceCollection const& differences = diff.differences();
+        GlowTreeDiff::Difference const& gain = differences[0];
+        if (gain.type != GlowTreeDiff::Changed || gain.path != makePath(1, 1)
+        ||  gain.properties.size() != 1 || gain.properties[0] != GlowTags::ParameterContents::Value().number())
+        {
+            THROW_TEST_EXCEPTION("The changed value of 1.1 has not been reported");
+        }
+
+        if (differences[1].type != GlowTreeDiff::Changed || differences[1].path != makePath(1, 4)
+        ||  differences[1].connectionsChanged == false || differences[1].properties.empty() == false)
+        {
+            THROW_TEST_EXCEPTION("The changed connection of 1.4 has not been reported");
+        }
+
+        if (differences[2].type != GlowTreeDiff::Added || differences[2].path != makePath(1, 5)
+        ||  differences[3].type != GlowTreeDiff::Added || differences[3].path != makePath(1, 5, 1)
+        ||  differences[4].type != GlowTreeDiff::Removed || differences[4].path != makePath(1, 3))
+        {
+            THROW_TEST_EXCEPTION("The added or removed elements have not been reported");
+        }
+
+        if (diff.update(*current) != 0)
+        {
+            THROW_TEST_EXCEPTION("Updating with the same tree reported differences");
+        }
+    }
+
+    void testNotification()
+    {
+        std::auto_ptr<libember::dom::Node> const previous(createTree(false));
+        std::auto_ptr<libember::dom::Node> const current(createTree(true));
+
+        GlowTreeDiff diff;
+        diff.compare(*previous, *current);
+
+        std::auto_ptr<GlowRootElementCollection> const notification(diff.createNotification());
+        if (notification.get() == 0)
+        {
+            THROW_TEST_EXCEPTION("No notification has been created");
+        }
+
+        std::auto_ptr<libember::dom::Node> const message(transmit(*notification));
+        GlowTreeMirror mirror;
+        mirror.merge(*previous);
+        mirror.merge(*message);
+
+        GlowTreeMirror::Element const level = mirror.find(makePath(1, 5, 1));
+        GlowTreeMirror::Connection const* const connection = mirror.find(makePath(1, 4)).matrix()->connection(1);
+        if (mirror.find(makePath(1, 1)).parameter()->value.toInteger() != -6
+        ||  level.isValid() == false || level.identifier() != "level"
+        ||  mirror.find(makePath(1, 5)).identifier() != "outputs"
+        ||  mirror.find(makePath(1, 3)).isOnline()
+        ||  connection == 0 || connection->sources != makePath(3))
+        {
+            THROW_TEST_EXCEPTION("Applying the notification did not reproduce the current tree");
+        }
+
+        diff.compare(*current, *current);
+        if (diff.createNotification() != 0)
+        {
+            THROW_TEST_EXCEPTION("A notification has been created without differences");
+        }
+    }
+}
+
+int main(int, char const* const*)
+{
+    try
+    {
+        testDifferences();
+        testNotification();
+    }
+    catch (std::exception const& e)
+    {
+        std::cerr << "ERROR: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
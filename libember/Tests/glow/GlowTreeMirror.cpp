@@ -0,0 +1,500 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+#include "ember/Ember.hpp"
+#include "TreeGenerator.hpp"
+
+#define THROW_TEST_EXCEPTION(message)                       \
+            {                                               \
+                std::ostringstream msgStream;               \
+                msgStream << message ;                      \
+                throw std::runtime_error(msgStream.str());  \
+            }
+
+namespace
+{
+    typedef libember::glow::GlowTreeMirror GlowTreeMirror;
+
+    /**
+     * A mirror that records the reported changes.
+     */
+    class RecordingMirror : public GlowTreeMirror
+    {
+        public:
+            RecordingMirror()
+                : added(0)
+                , contentsChanged(0)
+                , valueChanged(0)
+                , connectionsChanged(0)
+            {}
+
+            void reset()
+            {
+                added = contentsChanged = valueChanged = connectionsChanged = 0;
+            }
+
+            int added;
+            int contentsChanged;
+            int valueChanged;
+            int connectionsChanged;
+
+        protected:
+            virtual void elementChanged(Element const& element, int changes)
+            {
+                if (element.isValid() == false)
+                {
+                    THROW_TEST_EXCEPTION("A change has been reported for an invalid element");
+                }
+
+                added += (changes & Added) != 0 ? 1 : 0;
+                contentsChanged += (changes & ContentsChanged) != 0 ? 1 : 0;
+                valueChanged += (changes & ValueChanged) != 0 ? 1 : 0;
+                connectionsChanged += (changes & ConnectionsChanged) != 0 ? 1 : 0;
+            }
+    };
+
+    /**
+     * A mirror that evaluates the formula "$*2" and counts the evaluations.
+     */
+    class FormulaMirror : public RecordingMirror
+    {
+        public:
+            FormulaMirror()
+                : calls(0)
+                , values(0)
+            {}
+
+            int calls;
+            size_type values;
+
+        protected:
+            virtual void applyFormula(std::string const& formula, double* first, size_type count)
+            {
+                if (formula != "$*2")
+                {
+                    THROW_TEST_EXCEPTION("An unexpected formula has been applied: " << formula);
+                }
+
+                calls += 1;
+                values += count;
+                for (double* const last = first + count; first != last; ++first)
+                {
+                    *first *= 2.0;
+                }
+            }
+    };
+
+    libember::ber::ObjectIdentifier makePath(int a, int b = -1, int c = -1, int d = -1)
+    {
+        int const items[] = { a, b, c, d };
+        int count = 1;
+        while (count < 4 && items[count] >= 0)
+        {
+            ++count;
+        }
+        return libember::ber::ObjectIdentifier(items, items + count);
+    }
+
+    /**
+     * Encodes and decodes the passed tree, so the mirror works on decoded elements
+     * like a consumer does.
+     */
+    libember::dom::Node* transmit(libember::dom::Node const& node)
+    {
+        libember::util::OctetStream stream;
+        node.encode(stream);
+
+        libember::dom::DomReader reader;
+        libember::dom::Node* const result = reader.decodeTree(stream, libember::glow::GlowNodeFactory::getFactory());
+        if (result == 0)
+        {
+            THROW_TEST_EXCEPTION("The encoded tree could not be decoded");
+        }
+        return result;
+    }
+
+    void testGeneratedTree()
+    {
+        generator::TreeShape shape;
+        shape.streamParameters = 2;
+        generator::TreeGenerator treeGenerator(shape);
+
+        std::auto_ptr<libember::dom::Node> const tree(treeGenerator.createTree());
+        std::auto_ptr<libember::dom::Node> const message(transmit(*tree));
+        generator::TreeStatistics const& statistics = treeGenerator.statistics();
+        std::size_t const expected = statistics.nodes + statistics.parameters + statistics.matrices;
+
+        RecordingMirror mirror;
+        std::size_t const changed = mirror.merge(*message);
+        if (mirror.size() != expected || changed != expected || mirror.added != static_cast<int>(expected))
+        {
+            THROW_TEST_EXCEPTION("Merging the generated tree created " << mirror.size() << " elements and reported "
+                << changed << " changes, expected " << expected);
+        }
+
+        mirror.reset();
+        if (mirror.merge(*message) != 0 || mirror.added != 0 || mirror.contentsChanged != 0)
+        {
+            THROW_TEST_EXCEPTION("Merging the same tree twice reported changes");
+        }
+
+        GlowTreeMirror::Element const root = mirror.find(makePath(1));
+        if (root.isValid() == false || root.identifier() != "root" || root.type() != GlowTreeMirror::Node)
+        {
+            THROW_TEST_EXCEPTION("The root node has not been mirrored");
+        }
+
+        GlowTreeMirror::Element const parameter = mirror.find(makePath(1, 9, 2));
+        if (parameter.isValid() == false || parameter.parameter() == 0 || parameter.identifier() != "param1")
+        {
+            THROW_TEST_EXCEPTION("The parameter 1.9.2 has not been mirrored");
+        }
+
+        if (parameter.parent().path().size() != 2 || parameter.path().size() != 3 || parameter.path()[2] != 2)
+        {
+            THROW_TEST_EXCEPTION("The path of 1.9.2 is wrong");
+        }
+
+        std::size_t children = 0;
+        for (GlowTreeMirror::Element child = root.firstChild(); child.isValid(); child = child.nextSibling())
+        {
+            ++children;
+        }
+
+        if (children != root.childCount() || children != static_cast<std::size_t>(shape.parametersPerNode + shape.fanOut + 2))
+        {
+            THROW_TEST_EXCEPTION("The root node has " << children << " children");
+        }
+
+        GlowTreeMirror::Element const matrix = root.child(shape.parametersPerNode + shape.fanOut + 1);
+        GlowTreeMirror::MatrixState const* const state = matrix.isValid() ? matrix.matrix() : 0;
+        if (state == 0 || state->targets.size() != 16 || state->sources.size() != 16 || state->connections.size() != 16)
+        {
+            THROW_TEST_EXCEPTION("The matrix has not been mirrored");
+        }
+
+        GlowTreeMirror::Connection const* const connection = state->connection(3);
+        if (connection == 0 || connection->sources.size() != 2)
+        {
+            THROW_TEST_EXCEPTION("The connection of target 3 has not been mirrored");
+        }
+
+        if (mirror.find(makePath(1, 99)).isValid() || mirror.find(libember::ber::ObjectIdentifier()).isValid() == false)
+        {
+            THROW_TEST_EXCEPTION("The lookup of unknown paths or of the root failed");
+        }
+    }
+
+    void testQualifiedUpdates()
+    {
+        using namespace libember::glow;
+
+        RecordingMirror mirror;
+        {
+            std::auto_ptr<GlowRootElementCollection> const root(GlowRootElementCollection::create());
+            GlowQualifiedParameter* const parameter = new GlowQualifiedParameter(makePath(1, 2, 3));
+            parameter->setIdentifier("gain");
+            parameter->setValue(0L);
+            root->insert(root->end(), parameter);
+
+            std::auto_ptr<libember::dom::Node> const message(transmit(*root));
+            if (mirror.merge(*message) != 3 || mirror.size() != 3 || mirror.find(makePath(1, 2)).type() != GlowTreeMirror::Node)
+            {
+                THROW_TEST_EXCEPTION("The parents of a qualified parameter have not been created");
+            }
+        }
+
+        mirror.reset();
+        {
+            std::auto_ptr<GlowRootElementCollection> const root(GlowRootElementCollection::create());
+            GlowQualifiedParameter* const parameter = new GlowQualifiedParameter(makePath(1, 2, 3));
+            parameter->setValue(-12L);
+            root->insert(root->end(), parameter);
+
+            GlowNode* const node = new GlowNode(root.get(), 1);
+            node->setIdentifier("device");
+
+            std::auto_ptr<libember::dom::Node> const message(transmit(*root));
+            mirror.merge(*message);
+        }
+
+        GlowTreeMirror::Element const parameter = mirror.find(makePath(1, 2, 3));
+        if (mirror.valueChanged != 1 || mirror.contentsChanged != 1 || mirror.added != 0
+        ||  parameter.identifier() != "gain" || parameter.parameter()->value.toInteger() != -12
+        ||  mirror.find(makePath(1)).identifier() != "device")
+        {
+            THROW_TEST_EXCEPTION("A partial update has not been merged correctly");
+        }
+    }
+
+    void testDisplayValues()
+    {
+        using namespace libember::glow;
+
+        FormulaMirror mirror;
+        {
+            std::auto_ptr<GlowRootElementCollection> const root(GlowRootElementCollection::create());
+            for (int i = 1; i <= 3; ++i)
+            {
+                GlowQualifiedParameter* const parameter = new GlowQualifiedParameter(makePath(1, i));
+                parameter->setValue(100L * i);
+                parameter->setFactor(10);
+                parameter->setFormula("$*2", "$/2");
+                parameter->setFormat("%.1f dB");
+                parameter->setStreamIdentifier(i);
+                root->insert(root->end(), parameter);
+            }
+
+            GlowQualifiedParameter* const real = new GlowQualifiedParameter(makePath(1, 4));
+            real->setValue(0.5);
+            real->setFormat("%s%n");
+            root->insert(root->end(), real);
+
+            GlowQualifiedParameter* const enumeration = new GlowQualifiedParameter(makePath(1, 5));
+            enumeration->setType(ParameterType::Enum);
+            enumeration->setEnumeration("off\non");
+            enumeration->setValue(1L);
+            root->insert(root->end(), enumeration);
+
+            std::auto_ptr<libember::dom::Node> const message(transmit(*root));
+            mirror.merge(*message);
+        }
+
+        GlowTreeMirror::ParameterState const* const gain = mirror.find(makePath(1, 3)).parameter();
+        if (mirror.calls != 3 || gain == 0 || gain->displayValue != 60.0 || gain->displayText != "60.0 dB")
+        {
+            THROW_TEST_EXCEPTION("The display value of 1.3 is \"" << (gain != 0 ? gain->displayText : "") << "\"");
+        }
+
+        if (mirror.find(makePath(1, 4)).parameter()->displayText != "0.5"
+        ||  mirror.find(makePath(1, 5)).parameter()->displayText != "on")
+        {
+            THROW_TEST_EXCEPTION("An unsafe format or an enumeration has not been displayed correctly");
+        }
+
+        mirror.reset();
+        mirror.calls = 0;
+        mirror.values = 0;
+        {
+            std::auto_ptr<GlowStreamCollection> const streams(GlowStreamCollection::create());
+            streams->insert(1, 10);
+            streams->insert(2, 200);
+            streams->insert(3, 20);
+
+            std::auto_ptr<libember::dom::Node> const message(transmit(*streams));
+            if (mirror.merge(*message) != 2 || mirror.valueChanged != 2)
+            {
+                THROW_TEST_EXCEPTION("A stream collection has not been merged");
+            }
+        }
+
+        if (mirror.calls != 1 || mirror.values != 2
+        ||  mirror.find(makePath(1, 1)).parameter()->displayText != "2.0 dB"
+        ||  mirror.find(makePath(1, 2)).parameter()->displayText != "40.0 dB"
+        ||  gain->displayText != "4.0 dB")
+        {
+            THROW_TEST_EXCEPTION("The streamed values have been evaluated with " << mirror.calls << " calls");
+        }
+
+        mirror.calls = 0;
+        {
+            std::auto_ptr<GlowRootElementCollection> const root(GlowRootElementCollection::create());
+            GlowQualifiedParameter* const parameter = new GlowQualifiedParameter(makePath(1, 1));
+            parameter->setDescription("Gain");
+            root->insert(root->end(), parameter);
+
+            std::auto_ptr<libember::dom::Node> const message(transmit(*root));
+            mirror.merge(*message);
+        }
+
+        if (mirror.calls != 0)
+        {
+            THROW_TEST_EXCEPTION("A formula has been applied although the value did not change");
+        }
+    }
+
+    void testSubtreeHashes()
+    {
+        using namespace libember::glow;
+
+        generator::TreeGenerator treeGenerator((generator::TreeShape()));
+        std::auto_ptr<libember::dom::Node> const tree(treeGenerator.createTree());
+        std::auto_ptr<libember::dom::Node> const message(transmit(*tree));
+
+        GlowTreeMirror first(true);
+        GlowTreeMirror second(true);
+        first.merge(*message);
+        second.merge(*message);
+
+        GlowTreeMirror::hash_type const hash = first.root().subtreeHash();
+        if (first.find(makePath(1, 9, 1)).parameter()->value.type().value() != ParameterType::Integer)
+        {
+            THROW_TEST_EXCEPTION("The parameter 1.9.1 is expected to be an integer");
+        }
+
+        if (hash == 0 || hash != second.root().subtreeHash() || GlowTreeMirror().root().subtreeHash() != 0)
+        {
+            THROW_TEST_EXCEPTION("Mirrors of the same tree have different hashes");
+        }
+
+        for (int i = 0; i < 2; ++i)
+        {
+            std::auto_ptr<GlowRootElementCollection> const root(GlowRootElementCollection::create());
+            GlowQualifiedParameter* const parameter = new GlowQualifiedParameter(makePath(1, 9, 1));
+            parameter->setValue(i == 0 ? 4711L : first.find(makePath(1, 9, 1)).parameter()->value.toInteger());
+            root->insert(root->end(), parameter);
+
+            std::auto_ptr<libember::dom::Node> const update(transmit(*root));
+            second.merge(*update);
+
+            if (i == 0
+            && (second.root().subtreeHash() == hash
+            ||  second.find(makePath(1, 9)).subtreeHash() == first.find(makePath(1, 9)).subtreeHash()
+            ||  second.find(makePath(1, 8)).subtreeHash() != first.find(makePath(1, 8)).subtreeHash()))
+            {
+                THROW_TEST_EXCEPTION("A changed value has not been propagated to the hashes of its ancestors");
+            }
+        }
+
+        if (second.root().subtreeHash() != hash)
+        {
+            THROW_TEST_EXCEPTION("Restoring a value did not restore the hash of the tree");
+        }
+    }
+
+    void testConnectionOperations()
+    {
+        using namespace libember;
+        using namespace libember::glow;
+
+        RecordingMirror mirror;
+        int const operations[] = { ConnectionOperation::Absolute, ConnectionOperation::Connect, ConnectionOperation::Disconnect, ConnectionOperation::Connect };
+        int const sources[][2] = { { 1, 2 }, { 2, 3 }, { 1, 2 }, { 3, 3 } };
+        std::size_t const expected[] = { 2, 3, 1, 1 };
+
+        for (int i = 0; i < 4; ++i)
+        {
+            std::auto_ptr<GlowRootElementCollection> const root(GlowRootElementCollection::create());
+            GlowQualifiedMatrix* const matrix = new GlowQualifiedMatrix(makePath(1, 1));
+            root->insert(root->end(), matrix);
+
+            GlowConnection* const connection = new GlowConnection(5);
+            connection->setSources(ber::ObjectIdentifier(sources[i], sources[i] + 2));
+            connection->setOperation(static_cast<ConnectionOperation::_Domain>(operations[i]));
+            matrix->connections()->insert(matrix->connections()->end(), connection);
+
+            std::auto_ptr<dom::Node> const message(transmit(*root));
+            mirror.merge(*message);
+
+            GlowTreeMirror::Connection const* const result = mirror.find(makePath(1, 1)).matrix()->connection(5);
+            if (result == 0 || result->sources.size() != expected[i])
+            {
+                THROW_TEST_EXCEPTION("Connection operation " << i << " resulted in the wrong sources");
+            }
+        }
+
+        if (mirror.connectionsChanged != 3)
+        {
+            THROW_TEST_EXCEPTION("Reported " << mirror.connectionsChanged << " connection changes instead of 3");
+        }
+    }
+
+    void testSignalLabels()
+    {
+        using namespace libember;
+        using namespace libember::glow;
+
+        RecordingMirror mirror;
+        {
+            std::auto_ptr<GlowRootElementCollection> const root(GlowRootElementCollection::create());
+            GlowQualifiedMatrix* const matrix = new GlowQualifiedMatrix(makePath(1, 1));
+            matrix->labels()->insert(matrix->labels()->end(), new GlowLabel(makePath(1, 1, 1), "Primary"));
+            matrix->labels()->insert(matrix->labels()->end(), new GlowLabel(makePath(1, 2), "Secondary"));
+            root->insert(root->end(), matrix);
+
+            GlowNode* const labels = new GlowNode(1);
+            matrix->children()->insert(matrix->children()->end(), labels);
+            GlowNode* const targets = new GlowNode(labels, 1);
+            targets->setIdentifier("targets");
+            GlowParameter* const target = new GlowParameter(targets, 4);
+            target->setValue(std::string("Camera 4"));
+
+            std::auto_ptr<dom::Node> const message(transmit(*root));
+            mirror.merge(*message);
+        }
+
+        GlowTreeMirror::Element const matrix = mirror.find(makePath(1, 1));
+        if (mirror.signalLabel(matrix, GlowTreeMirror::TargetSignal, 4) != "Camera 4"
+        ||  mirror.signalLabel(matrix, GlowTreeMirror::TargetSignal, 4, "Primary") != "Camera 4"
+        ||  mirror.signalLabel(matrix, GlowTreeMirror::TargetSignal, 4, "Secondary").empty() == false
+        ||  mirror.signalLabel(matrix, GlowTreeMirror::SourceSignal, 4).empty() == false)
+        {
+            THROW_TEST_EXCEPTION("The label of target 4 has not been resolved");
+        }
+
+        {
+            std::auto_ptr<GlowRootElementCollection> const root(GlowRootElementCollection::create());
+            GlowQualifiedNode* const sources = new GlowQualifiedNode(makePath(1, 2, 2));
+            root->insert(root->end(), sources);
+
+            GlowParameter* const source = new GlowParameter(sources, 7);
+            source->setValue(std::string("VTR 7"));
+
+            GlowQualifiedNode* const targets = new GlowQualifiedNode(makePath(1, 1, 1, 1));
+            root->insert(root->end(), targets);
+
+            GlowParameter* const target = new GlowParameter(targets, 1);
+            target->setValue(std::string("Camera 1"));
+
+            std::auto_ptr<dom::Node> const message(transmit(*root));
+            mirror.merge(*message);
+        }
+
+        if (mirror.signalLabel(matrix, GlowTreeMirror::SourceSignal, 7, "Secondary") != "VTR 7"
+        ||  mirror.signalLabel(matrix, GlowTreeMirror::TargetSignal, 1) != "Camera 1"
+        ||  mirror.signalLabel(mirror.find(makePath(1)), GlowTreeMirror::TargetSignal, 1).empty() == false)
+        {
+            THROW_TEST_EXCEPTION("Labels merged after the matrix have not been indexed");
+        }
+    }
+}
+
+int main(int, char const* const*)
+{
+    try
+    {
+        testGeneratedTree();
+        testQualifiedUpdates();
+        testDisplayValues();
+        testSubtreeHashes();
+        testConnectionOperations();
+        testSignalLabels();
+    }
+    catch (std::exception const& e)
+    {
+        std::cerr << "ERROR: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
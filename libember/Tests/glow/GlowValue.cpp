@@ -49,6 +49,25 @@ int main(int, char const* const*)
                 THROW_TEST_EXCEPTION("Unexpected type coercion of char const* by glow::Value constructor. Expected glow::ParameterType::String");
             }
         }
+        {
+            std::string const text = "A string that does not fit into the inline storage";
+            libember::glow::Value longText(text);
+            libember::glow::Value number(42L);
+            libember::glow::Value const copy = longText;
+            longText.swap(number);
+            if (copy.toString() != text || number.toString() != text || longText.toInteger() != 42)
+            {
+                THROW_TEST_EXCEPTION("Unexpected value after copying or swapping a glow::Value");
+            }
+        }
+        {
+            libember::glow::MinMax const minimum(-1.5);
+            libember::glow::MinMax const maximum(100L);
+            if (minimum.toInteger() != -1 || maximum.toReal() != 100.0 || minimum.type().value() != libember::glow::ParameterType::Real)
+            {
+                THROW_TEST_EXCEPTION("Unexpected conversion by glow::MinMax");
+            }
+        }
     }
     catch (std::exception const& e)
     {
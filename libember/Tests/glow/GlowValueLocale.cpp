@@ -0,0 +1,124 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <clocale>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include "ember/glow/Value.hpp"
+
+#define THROW_TEST_EXCEPTION(message)                       \
+            {                                               \
+                std::ostringstream msgStream;               \
+                msgStream << message ;                      \
+                throw std::runtime_error(msgStream.str());  \
+            }
+
+namespace
+{
+    /**
+     * Selects a C locale that uses a comma as decimal point, like an application
+     * does by calling setlocale(LC_ALL, "").
+     * @return true if such a locale is installed.
+     */
+    bool selectCommaLocale()
+    {
+        char const* const names[] = { "de_DE.UTF-8", "de_DE.utf8", "de_DE", "fr_FR.UTF-8", "German_Germany.1252" };
+        for (std::size_t i = 0; i < sizeof(names) / sizeof(names[0]); ++i)
+        {
+            if (std::setlocale(LC_ALL, names[i]) != 0 && std::strcmp(std::localeconv()->decimal_point, ",") == 0)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void testFormatting()
+    {
+        libember::glow::Value const value(1.5);
+        if (value.toString() != "1.5")
+        {
+            THROW_TEST_EXCEPTION("1.5 is formatted as \"" << value.toString() << "\"");
+        }
+
+        char buffer[4];
+        if (value.toString(buffer, sizeof(buffer)) != 3 || std::strcmp(buffer, "1.5") != 0)
+        {
+            THROW_TEST_EXCEPTION("1.5 is written as \"" << buffer << "\"");
+        }
+
+        libember::glow::Value const small(-2.5e-12);
+        if (small.toString() != "-2.5e-12")
+        {
+            THROW_TEST_EXCEPTION("-2.5e-12 is formatted as \"" << small.toString() << "\"");
+        }
+    }
+
+    void testParsing()
+    {
+        if (libember::glow::Value(std::string("2.75")).toReal() != 2.75)
+        {
+            THROW_TEST_EXCEPTION("\"2.75\" is parsed as " << libember::glow::Value(std::string("2.75")).toReal());
+        }
+
+        // A comma is not a decimal point, just like in the classic locale
+        if (libember::glow::Value(std::string("2,75")).toReal() != 2.0)
+        {
+            THROW_TEST_EXCEPTION("\"2,75\" is parsed as " << libember::glow::Value(std::string("2,75")).toReal());
+        }
+
+        std::string const padded = "   0.125" + std::string(100, '0');
+        if (libember::glow::Value(padded).toReal() != 0.125)
+        {
+            THROW_TEST_EXCEPTION("A long string is parsed as " << libember::glow::Value(padded).toReal());
+        }
+
+        if (libember::glow::Value(std::string("-7.9")).toInteger() != -7)
+        {
+            THROW_TEST_EXCEPTION("\"-7.9\" is converted to the integer " << libember::glow::Value(std::string("-7.9")).toInteger());
+        }
+    }
+}
+
+int main(int, char const* const*)
+{
+    try
+    {
+        testFormatting();
+        testParsing();
+
+        if (selectCommaLocale())
+        {
+            testFormatting();
+            testParsing();
+        }
+        else
+        {
+            std::cout << "No locale with a decimal comma is installed, skipping the localized tests" << std::endl;
+        }
+    }
+    catch (std::exception const& e)
+    {
+        std::cerr << "ERROR: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
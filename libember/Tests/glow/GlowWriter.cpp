@@ -0,0 +1,439 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "ember/Ember.hpp"
+
+#define THROW_TEST_EXCEPTION(message)                       \
+            {                                               \
+                std::ostringstream msgStream;               \
+                msgStream << message ;                      \
+                throw std::runtime_error(msgStream.str());  \
+            }
+
+namespace
+{
+    using namespace libember::glow;
+
+    std::vector<unsigned char> encodeTree(libember::dom::Node const& message)
+    {
+        libember::util::OctetStream stream;
+        message.encode(stream);
+        return std::vector<unsigned char>(stream.begin(), stream.end());
+    }
+
+    void compare(GlowWriter const& writer, libember::dom::Node const& message, std::string const& shape)
+    {
+        std::vector<unsigned char> const expected = encodeTree(message);
+        if (writer.size() != expected.size() || std::equal(writer.begin(), writer.end(), expected.begin()) == false)
+        {
+            THROW_TEST_EXCEPTION("The encoding of " << shape << " differs from the encoding of the tree");
+        }
+    }
+
+    void testQualified()
+    {
+        libember::ber::ObjectIdentifier path;
+        path.push_back(1);
+        path.push_back(200);
+        path.push_back(70000);
+
+        GlowRootElementCollection* const root = GlowRootElementCollection::create();
+        GlowQualifiedParameter* const parameter = new GlowQualifiedParameter(root, path);
+        parameter->setValue(-20L);
+        GlowQualifiedParameter* const other = new GlowQualifiedParameter(root, path);
+        other->setValue(std::string("text"));
+        other->setIsOnline(false);
+        GlowQualifiedNode* const node = new GlowQualifiedNode(root, path);
+        node->setIsOnline(true);
+        new GlowQualifiedNode(root, path);
+
+        GlowWriter writer;
+        writer.beginRoot();
+        writer.beginParameter(path);
+        writer.value(-20L);
+        writer.endParameter();
+        writer.beginParameter(path);
+        writer.value(std::string("text"));
+        writer.isOnline(false);
+        writer.endParameter();
+        writer.beginNode(path);
+        writer.isOnline(true);
+        writer.endNode();
+        writer.beginNode(path);
+        writer.endNode();
+        writer.endRoot();
+        compare(writer, *root, "qualified elements");
+        delete root;
+
+        // the writer is reused for a message with a different size
+        GlowRootElementCollection* const single = GlowRootElementCollection::create();
+        (new GlowQualifiedParameter(single, path))->setValue(true);
+
+        writer.clear();
+        writer.beginRoot();
+        writer.beginParameter(path);
+        writer.value(true);
+        writer.endParameter();
+        writer.endRoot();
+        compare(writer, *single, "a reused writer");
+        delete single;
+    }
+
+    void writeParameter(GlowWriter& writer, GlowNodeBase* parent, int number)
+    {
+        std::ostringstream identifier;
+        identifier << "parameter" << number;
+
+        GlowParameter* const parameter = new GlowParameter(parent, number);
+        parameter->setIdentifier(identifier.str());
+        writer.beginParameter(number);
+        writer.identifier(identifier.str());
+
+        switch (number % 3)
+        {
+            case 0:
+                parameter->setValue(number * 0.25);
+                parameter->setMinimum(-100.0);
+                parameter->setMaximum(100.0);
+                parameter->setType(ParameterType::Real);
+                writer.value(number * 0.25);
+                writer.minimum(-100.0);
+                writer.maximum(100.0);
+                writer.type(ParameterType::Real);
+                break;
+
+            case 1:
+                parameter->setValue(static_cast<long>(number) * 1000000L);
+                parameter->setMinimum(0L);
+                parameter->setMaximum(0x7FFFFFFFL);
+                parameter->setAccess(Access::ReadWrite);
+                writer.value(static_cast<long>(number) * 1000000L);
+                writer.minimum(0L);
+                writer.maximum(0x7FFFFFFFL);
+                writer.access(Access::ReadWrite);
+                break;
+
+            default:
+                parameter->setValue(std::string(static_cast<std::size_t>(number * 10), 'v'));
+                parameter->setDescription("a string");
+                writer.value(std::string(static_cast<std::size_t>(number * 10), 'v'));
+                writer.description("a string");
+                break;
+        }
+
+        writer.endParameter();
+    }
+
+    void testTree()
+    {
+        GlowRootElementCollection* const root = GlowRootElementCollection::create();
+        GlowWriter writer;
+        writer.beginRoot();
+
+        for (int i = 1; i <= 3; ++i)
+        {
+            GlowNode* const node = new GlowNode(root, i);
+            node->setIdentifier("node");
+            node->setDescription(std::string(static_cast<std::size_t>(i * 30000), 'd'));
+            writer.beginNode(i);
+            writer.identifier("node");
+            writer.description(std::string(static_cast<std::size_t>(i * 30000), 'd'));
+
+            writer.beginChildren();
+            for (int j = 1; j <= 40; ++j)
+            {
+                writeParameter(writer, node, j);
+            }
+
+            GlowNode* const child = new GlowNode(node, 100);
+            child->setIsOnline(true);
+            writer.beginNode(100);
+            writer.isOnline(true);
+            writer.beginChildren();
+            writeParameter(writer, child, 1);
+            writer.endChildren();
+            writer.endNode();
+
+            writer.endChildren();
+            writer.endNode();
+        }
+
+        writer.endRoot();
+        compare(writer, *root, "a tree");
+        delete root;
+    }
+
+    std::vector<unsigned char> encodeSignals(int count)
+    {
+        GlowWriter writer;
+        writer.beginRoot();
+        writer.beginMatrix(0);
+
+        GlowWriter::size_type const first = writer.size();
+        writer.beginTargets();
+        for (int i = 0; i < count; ++i)
+        {
+            writer.target(i);
+        }
+        writer.endTargets();
+        writer.beginSources();
+        for (int i = 0; i < count; ++i)
+        {
+            writer.source(i);
+        }
+        writer.endSources();
+        return std::vector<unsigned char>(writer.begin() + first, writer.end());
+    }
+
+    void testMatrix()
+    {
+        libember::ber::ObjectIdentifier path;
+        path.push_back(1);
+        path.push_back(3);
+
+        libember::ber::ObjectIdentifier labels(path);
+        labels.push_back(1000);
+
+        libember::ber::ObjectIdentifier sources;
+        sources.push_back(2);
+        sources.push_back(300);
+
+        GlowRootElementCollection* const root = GlowRootElementCollection::create();
+        GlowQualifiedMatrix* const matrix = new GlowQualifiedMatrix(root, path);
+        matrix->setIdentifier("matrix");
+        matrix->setTargetCount(400);
+        matrix->setSourceCount(400);
+        matrix->setType(MatrixType::NToN);
+        matrix->setAddressingMode(MatrixAddressingMode::NonLinear);
+        matrix->setParametersLocation(labels);
+        matrix->setGainParameterNumber(1);
+        matrix->labels()->insert(matrix->labels()->end(), new GlowLabel(labels, "Primary"));
+
+        GlowWriter writer;
+        writer.beginRoot();
+        writer.beginMatrix(path);
+        writer.identifier("matrix");
+        writer.targetCount(400);
+        writer.sourceCount(400);
+        writer.type(MatrixType::NToN);
+        writer.addressingMode(MatrixAddressingMode::NonLinear);
+        writer.parametersLocation(labels);
+        writer.gainParameterNumber(1);
+        writer.beginLabels();
+        writer.label(labels, "Primary");
+        writer.endLabels();
+
+        // the signals are the same in every message, so they are encoded once and appended
+        std::vector<unsigned char> const signals = encodeSignals(400);
+        libember::dom::Sequence* const targets = matrix->targets();
+        libember::dom::Sequence* const matrixSources = matrix->sources();
+        for (int i = 0; i < 400; ++i)
+        {
+            targets->insert(targets->end(), new GlowTarget(i));
+        }
+        for (int i = 0; i < 400; ++i)
+        {
+            matrixSources->insert(matrixSources->end(), new GlowSource(i));
+        }
+        writer.encoded(&signals[0], &signals[0] + signals.size());
+
+        libember::dom::Sequence* const connections = matrix->connections();
+        writer.beginConnections();
+        for (int i = 0; i < 400; ++i)
+        {
+            GlowConnection* const connection = new GlowConnection(i);
+            if (i % 2 == 0)
+            {
+                connection->setSources(sources);
+                writer.connection(i, sources);
+            }
+            else
+            {
+                writer.connection(i);
+            }
+            connections->insert(connections->end(), connection);
+        }
+        writer.endConnections();
+        writer.endMatrix();
+        writer.endRoot();
+        compare(writer, *root, "a matrix");
+        delete root;
+
+        // the contents are copied once they have been ended
+        writer.clear();
+        writer.beginRoot();
+        writer.beginMatrix(3);
+        GlowWriter::size_type const first = writer.size();
+        writer.identifier("matrix");
+        writer.endContents();
+        std::vector<unsigned char> const contents(writer.begin() + first, writer.end());
+
+        GlowRootElementCollection* const reencoded = GlowRootElementCollection::create();
+        GlowMatrix* const numbered = new GlowMatrix(reencoded, 3);
+        numbered->setIdentifier("matrix");
+        for (int i = 0; i < 400; ++i)
+        {
+            numbered->targets()->insert(numbered->targets()->end(), new GlowTarget(i));
+        }
+        for (int i = 0; i < 400; ++i)
+        {
+            numbered->sources()->insert(numbered->sources()->end(), new GlowSource(i));
+        }
+
+        writer.clear();
+        writer.beginRoot();
+        writer.beginMatrix(3);
+        writer.encoded(&contents[0], &contents[0] + contents.size());
+        writer.encoded(&signals[0], &signals[0] + signals.size());
+        writer.endMatrix();
+        writer.endRoot();
+        compare(writer, *reencoded, "cached signals");
+        delete reencoded;
+    }
+
+    template<typename Action>
+    void expectFailure(Action action, std::string const& shape)
+    {
+        GlowWriter writer;
+        try
+        {
+            action(writer);
+        }
+        catch (std::runtime_error const&)
+        {
+            return;
+        }
+        THROW_TEST_EXCEPTION("Writing " << shape << " has not failed");
+    }
+
+    void elementWithoutRoot(GlowWriter& writer)
+    {
+        writer.beginNode(1);
+    }
+
+    void propertyAfterChildren(GlowWriter& writer)
+    {
+        writer.beginRoot();
+        writer.beginNode(1);
+        writer.beginChildren();
+        writer.identifier("late");
+    }
+
+    void propertyAfterEndedChildren(GlowWriter& writer)
+    {
+        writer.beginRoot();
+        writer.beginNode(1);
+        writer.beginChildren();
+        writer.endChildren();
+        writer.description("late");
+    }
+
+    void mismatchedEnd(GlowWriter& writer)
+    {
+        writer.beginRoot();
+        writer.beginNode(1);
+        writer.endParameter();
+    }
+
+    void openRoot(GlowWriter& writer)
+    {
+        writer.beginRoot();
+        writer.beginNode(1);
+        writer.endRoot();
+    }
+
+    void tooDeep(GlowWriter& writer)
+    {
+        writer.beginRoot();
+        for (int i = 0; i < GlowWriter::MaximumDepth; ++i)
+        {
+            writer.beginNode(1);
+            writer.beginChildren();
+        }
+    }
+
+    void targetOutsideTargets(GlowWriter& writer)
+    {
+        writer.beginRoot();
+        writer.beginMatrix(1);
+        writer.beginSources();
+        writer.target(1);
+    }
+
+    void propertyAfterTargets(GlowWriter& writer)
+    {
+        writer.beginRoot();
+        writer.beginMatrix(1);
+        writer.beginTargets();
+        writer.endTargets();
+        writer.targetCount(1);
+    }
+
+    void matrixPropertyOfParameter(GlowWriter& writer)
+    {
+        writer.beginRoot();
+        writer.beginParameter(1);
+        writer.gainParameterNumber(1);
+    }
+
+    void openSignals(GlowWriter& writer)
+    {
+        writer.beginRoot();
+        writer.beginMatrix(1);
+        writer.beginTargets();
+        writer.endMatrix();
+    }
+
+    void testErrors()
+    {
+        expectFailure(elementWithoutRoot, "an element outside of a collection");
+        expectFailure(propertyAfterChildren, "a property after the children");
+        expectFailure(propertyAfterEndedChildren, "a property after the ended children");
+        expectFailure(mismatchedEnd, "a mismatched end");
+        expectFailure(openRoot, "a root with an open element");
+        expectFailure(tooDeep, "too many nested elements");
+        expectFailure(targetOutsideTargets, "a target outside of the targets");
+        expectFailure(propertyAfterTargets, "a property after the targets");
+        expectFailure(matrixPropertyOfParameter, "a matrix property of a parameter");
+        expectFailure(openSignals, "a matrix with open targets");
+    }
+}
+
+int main(int, char const* const*)
+{
+    try
+    {
+        testQualified();
+        testTree();
+        testMatrix();
+        testErrors();
+    }
+    catch (std::exception const& ex)
+    {
+        std::cerr << "ERROR: " << ex.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
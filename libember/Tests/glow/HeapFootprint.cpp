@@ -0,0 +1,601 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <new>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <typeinfo>
+#include <vector>
+#include "ember/Ember.hpp"
+#include "CountingAllocator.hpp"
+#include "TreeGenerator.hpp"
+
+#define THROW_TEST_EXCEPTION(message)                       \
+            {                                               \
+                std::ostringstream msgStream;               \
+                msgStream << message ;                      \
+                throw std::runtime_error(msgStream.str());  \
+            }
+
+namespace
+{
+    typedef std::vector<unsigned char> ByteVector;
+
+    /**
+     * The options of the reader used to decode the analysed trees, so the effect of
+     * the memory-reduction features of the reader can be compared.
+     */
+    struct ReaderOptions
+    {
+        ReaderOptions()
+            : lazyLeafDecoding(false)
+            , stringPool(false)
+        {}
+
+        /** Decode string leaves lazily, see AsyncBerReader::setLazyLeafDecoding. */
+        bool lazyLeafDecoding;
+
+        /** Intern strings in a StringPool, see AsyncBerReader::setStringPool. */
+        bool stringPool;
+    };
+
+    /**
+     * The number of objects of a category and the heap bytes they use.
+     */
+    struct Usage
+    {
+        Usage()
+            : count(0)
+            , bytes(0)
+        {}
+
+        void add(std::size_t size)
+        {
+            count += 1;
+            bytes += size;
+        }
+
+        std::size_t count;
+        std::size_t bytes;
+    };
+
+    typedef std::map<std::string, Usage> UsageMap;
+
+    /**
+     * The name and the size of a node type whose instances are reported by name.
+     */
+    struct NodeType
+    {
+        std::type_info const* type;
+        char const* name;
+        std::size_t size;
+    };
+
+#define FOOTPRINT_NODE_TYPE(ns, type) { &typeid(libember::ns::type), #type, sizeof(libember::ns::type) }
+
+    NodeType const nodeTypes[] =
+    {
+        FOOTPRINT_NODE_TYPE(dom, VariantLeaf),
+        FOOTPRINT_NODE_TYPE(dom, Sequence),
+        FOOTPRINT_NODE_TYPE(dom, Set),
+        FOOTPRINT_NODE_TYPE(dom, EncodedNode),
+        FOOTPRINT_NODE_TYPE(dom, SharedNode),
+        FOOTPRINT_NODE_TYPE(glow, GlowCommand),
+        FOOTPRINT_NODE_TYPE(glow, GlowConnection),
+        FOOTPRINT_NODE_TYPE(glow, GlowElementCollection),
+        FOOTPRINT_NODE_TYPE(glow, GlowFunction),
+        FOOTPRINT_NODE_TYPE(glow, GlowInvocation),
+        FOOTPRINT_NODE_TYPE(glow, GlowInvocationResult),
+        FOOTPRINT_NODE_TYPE(glow, GlowLabel),
+        FOOTPRINT_NODE_TYPE(glow, GlowMatrix),
+        FOOTPRINT_NODE_TYPE(glow, GlowNode),
+        FOOTPRINT_NODE_TYPE(glow, GlowParameter),
+        FOOTPRINT_NODE_TYPE(glow, GlowQualifiedFunction),
+        FOOTPRINT_NODE_TYPE(glow, GlowQualifiedMatrix),
+        FOOTPRINT_NODE_TYPE(glow, GlowQualifiedNode),
+        FOOTPRINT_NODE_TYPE(glow, GlowQualifiedParameter),
+        FOOTPRINT_NODE_TYPE(glow, GlowRootElementCollection),
+        FOOTPRINT_NODE_TYPE(glow, GlowSource),
+        FOOTPRINT_NODE_TYPE(glow, GlowStreamCollection),
+        FOOTPRINT_NODE_TYPE(glow, GlowStreamDescriptor),
+        FOOTPRINT_NODE_TYPE(glow, GlowStreamEntry),
+        FOOTPRINT_NODE_TYPE(glow, GlowStringIntegerCollection),
+        FOOTPRINT_NODE_TYPE(glow, GlowStringIntegerPair),
+        FOOTPRINT_NODE_TYPE(glow, GlowTarget),
+        FOOTPRINT_NODE_TYPE(glow, GlowTupleItemDescription),
+    };
+
+#undef FOOTPRINT_NODE_TYPE
+
+    /**
+     * Mirrors the layout of the payload a ber::Value allocates for a value of type T:
+     * a virtual table, a reference count and the value itself.
+     */
+    template<typename T>
+    struct PayloadLayout
+    {
+        virtual ~PayloadLayout() {}
+        unsigned long refCount;
+        T value;
+    };
+
+    /**
+     * The heap footprint of a decoded tree, by element type, by field and by the
+     * number of copies of the strings it contains.
+     * Nodes are attributed their full object size plus the header the node allocator
+     * adds. The heap storage of child lists and object identifiers is estimated from
+     * their size and the growth policy of util::SmallVector, and the payload of a
+     * ber::Value is estimated from the layout of its type. Payloads shared by several
+     * leaves, e.g. interned strings, are only counted for the first leaf.
+     */
+    class HeapFootprint
+    {
+        public:
+            /**
+             * Adds the nodes of a tree to the footprint.
+             * @param root The root of the tree.
+             */
+            void analyze(libember::dom::Node const& root)
+            {
+                visit(root, "", "");
+            }
+
+            /**
+             * Returns the number of bytes attributed to the nodes of the analysed trees.
+             * @return The number of attributed bytes.
+             */
+            std::size_t attributedBytes() const
+            {
+                return sum(m_elements) + sum(m_lists) + sum(m_fields);
+            }
+
+            /**
+             * Writes all categories, each sorted by name.
+             * @param stream The stream to write to.
+             */
+            void report(std::ostream& stream) const
+            {
+                write(stream, "element type (object)", m_elements);
+                write(stream, "element type (child list)", m_lists);
+                write(stream, "field (value)", m_fields);
+                write(stream, "object identifier", m_identifiers);
+                write(stream, "string copies", stringClasses());
+            }
+
+        private:
+            struct StringUsage
+            {
+                StringUsage()
+                    : leaves(0)
+                    , copies(0)
+                    , bytes(0)
+                {}
+
+                /** The number of leaves containing the string. */
+                std::size_t leaves;
+
+                /** The number of separately allocated or encoded copies. */
+                std::size_t copies;
+
+                /** The heap bytes of all copies. */
+                std::size_t bytes;
+            };
+
+            typedef std::map<std::string, StringUsage> StringMap;
+
+            void visit(libember::dom::Node const& node, std::string const& element, std::string const& field)
+            {
+                using namespace libember;
+
+                std::string const name = typeName(node);
+                std::string const tag = format(node.applicationTag());
+
+                bool const isElement = name.compare(0, 4, "Glow") == 0;
+                std::string const owner = isElement ? name : element;
+                std::string const path = isElement ? std::string() : (field.empty() ? tag : field + "/" + tag);
+
+                m_elements[name].add(nodeSize(node));
+
+                if (dom::VariantLeaf const* const leaf = dynamic_cast<dom::VariantLeaf const*>(&node))
+                {
+                    m_fields[(owner.empty() ? std::string("-") : owner) + " " + path].add(valueSize(*leaf));
+                }
+                else if (dom::Container const* const container = dynamic_cast<dom::Container const*>(&node))
+                {
+                    if (dynamic_cast<dom::detail::ListContainer const*>(container) != 0 && container->size() > ChildListInlineCapacity)
+                    {
+                        m_lists[name].add(growCapacity(container->size(), ChildListInlineCapacity) * sizeof(dom::Node*));
+                    }
+
+                    dom::Container::const_iterator const last = container->end();
+                    for (dom::Container::const_iterator it = container->begin(); it != last; ++it)
+                    {
+                        visit(*it, owner, path);
+                    }
+                }
+            }
+
+            std::size_t nodeSize(libember::dom::Node const& node) const
+            {
+                std::size_t const count = sizeof(nodeTypes) / sizeof(nodeTypes[0]);
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    if (*nodeTypes[i].type == typeid(node))
+                    {
+                        return nodeTypes[i].size + NodeHeaderSize;
+                    }
+                }
+                return sizeof(libember::dom::Node) + NodeHeaderSize;
+            }
+
+            std::size_t valueSize(libember::dom::VariantLeaf const& leaf)
+            {
+                using namespace libember;
+
+                util::OctetSlice const& encoded = leaf.encodedValue();
+                if (encoded.empty() == false)
+                {
+                    // The slice refers to a block of the reader that is shared with other leaves.
+                    countString(std::string(encoded.begin(), encoded.end()), 0, encoded.size());
+                    return encoded.size();
+                }
+
+                if (std::string const* const value = leaf.peekValue<std::string>())
+                {
+                    std::size_t const size = sizeof(PayloadLayout<std::string>) + stringCapacity(*value);
+                    bool const isShared = m_payloads.insert(value).second == false;
+                    countString(*value, value, isShared ? 0 : size);
+                    return isShared ? 0 : size;
+                }
+
+                if (ber::ObjectIdentifier const* const value = leaf.peekValue<ber::ObjectIdentifier>())
+                {
+                    std::size_t size = sizeof(PayloadLayout<ber::ObjectIdentifier>);
+                    if (value->size() > ObjectIdentifierInlineCapacity)
+                    {
+                        std::size_t const heap = growCapacity(value->size(), ObjectIdentifierInlineCapacity) * sizeof(ber::ObjectIdentifier::value_type);
+                        m_identifiers["heap"].add(heap);
+                        size += heap;
+                    }
+                    else
+                    {
+                        m_identifiers["inline"].add(0);
+                    }
+                    return size;
+                }
+
+                if (ber::Octets const* const value = leaf.peekValue<ber::Octets>())
+                {
+                    return sizeof(PayloadLayout<ber::Octets>) + value->size();
+                }
+
+                if (leaf.peekValue<long>() != 0 || leaf.peekValue<int>() != 0 || leaf.peekValue<bool>() != 0)
+                {
+                    return sizeof(PayloadLayout<long>);
+                }
+
+                if (leaf.peekValue<double>() != 0)
+                {
+                    return sizeof(PayloadLayout<double>);
+                }
+
+                return leaf.value() ? sizeof(PayloadLayout<long long>) : 0;
+            }
+
+            void countString(std::string const& value, void const* storage, std::size_t bytes)
+            {
+                StringUsage& usage = m_strings[value];
+                usage.leaves += 1;
+                usage.bytes += bytes;
+
+                if (storage == 0 || bytes > 0)
+                {
+                    usage.copies += 1;
+                }
+            }
+
+            /**
+             * Groups the strings by the number of leaves containing them. The bytes are
+             * those of all copies, the count is the number of distinct strings. The
+             * redundant copies are the bytes that could be saved by sharing a single
+             * copy of each string, counted for the strings that have several copies.
+             */
+            UsageMap stringClasses() const
+            {
+                UsageMap result;
+                Usage redundant;
+
+                StringMap::const_iterator const last = m_strings.end();
+                for (StringMap::const_iterator it = m_strings.begin(); it != last; ++it)
+                {
+                    StringUsage const& usage = it->second;
+                    char const* const name = usage.leaves == 1 ? "1 leaf"
+                        : usage.leaves < 10 ? "2-9 leaves"
+                        : usage.leaves < 100 ? "10-99 leaves"
+                        : "100+ leaves";
+
+                    Usage& entry = result[name];
+                    entry.count += 1;
+                    entry.bytes += usage.bytes;
+
+                    if (usage.copies > 1)
+                    {
+                        redundant.add(usage.bytes - usage.bytes / usage.copies);
+                    }
+                }
+
+                result["redundant copies"] = redundant;
+                return result;
+            }
+
+            static std::size_t stringCapacity(std::string const& value)
+            {
+                static std::size_t const inlineCapacity = std::string().capacity();
+                return value.capacity() > inlineCapacity ? value.capacity() + 1 : 0;
+            }
+
+            /**
+             * Returns the capacity of a util::SmallVector that has grown to @p size
+             * elements by appending them one by one.
+             */
+            static std::size_t growCapacity(std::size_t size, std::size_t capacity)
+            {
+                while (capacity < size)
+                {
+                    capacity *= 2;
+                }
+                return capacity;
+            }
+
+            static std::string typeName(libember::dom::Node const& node)
+            {
+                std::size_t const count = sizeof(nodeTypes) / sizeof(nodeTypes[0]);
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    if (*nodeTypes[i].type == typeid(node))
+                    {
+                        return nodeTypes[i].name;
+                    }
+                }
+                return typeid(node).name();
+            }
+
+            static std::string format(libember::ber::Tag const& tag)
+            {
+                using libember::ber::Class;
+
+                std::ostringstream stream;
+                switch (tag.getClass().value())
+                {
+                    case Class::Universal:
+                        stream << "U-";
+                        break;
+
+                    case Class::Application:
+                        stream << "A-";
+                        break;
+
+                    case Class::ContextSpecific:
+                        stream << "C-";
+                        break;
+
+                    default:
+                        stream << "P-";
+                        break;
+                }
+                stream << tag.number();
+                return stream.str();
+            }
+
+            static std::size_t sum(UsageMap const& map)
+            {
+                std::size_t result = 0;
+                UsageMap::const_iterator const last = map.end();
+                for (UsageMap::const_iterator it = map.begin(); it != last; ++it)
+                {
+                    result += it->second.bytes;
+                }
+                return result;
+            }
+
+            static void write(std::ostream& stream, char const* title, UsageMap const& map)
+            {
+                if (map.empty())
+                {
+                    return;
+                }
+
+                stream << "  by " << title << ":" << std::endl;
+
+                UsageMap::const_iterator const last = map.end();
+                for (UsageMap::const_iterator it = map.begin(); it != last; ++it)
+                {
+                    stream << "    " << std::left << std::setw(48) << it->first << std::right
+                           << std::setw(10) << it->second.count
+                           << std::setw(14) << it->second.bytes << " bytes" << std::endl;
+                }
+            }
+
+        private:
+            enum
+            {
+                /** The inline capacity of the child list of a ListContainer. */
+                ChildListInlineCapacity = 8,
+
+                /** The inline capacity of the items of an ObjectIdentifier. */
+                ObjectIdentifierInlineCapacity = 12,
+
+                /** The header the node allocator stores in front of each node. */
+                NodeHeaderSize = sizeof(double) > sizeof(void*) ? sizeof(double) : sizeof(void*),
+            };
+
+            UsageMap m_elements;
+            UsageMap m_lists;
+            UsageMap m_fields;
+            UsageMap m_identifiers;
+            StringMap m_strings;
+            std::set<void const*> m_payloads;
+    };
+
+    /**
+     * Encodes the passed node into a byte vector.
+     */
+    ByteVector encode(libember::dom::Node const& node)
+    {
+        libember::util::OctetStream stream;
+        node.encode(stream);
+        return ByteVector(stream.begin(), stream.end());
+    }
+
+    /**
+     * Decodes an encoded tree, measures the heap bytes retained by the decoded tree and
+     * prints its footprint.
+     * @param name The name of the tree.
+     * @param buffer The encoded tree.
+     * @param options The options of the reader.
+     */
+    void run(std::string const& name, ByteVector const& buffer, ReaderOptions const& options)
+    {
+        using namespace libember;
+
+        dom::StringPool pool;
+        std::size_t const before = allocation::Memory::liveBytes;
+        std::auto_ptr<dom::Node> root;
+        {
+            dom::AsyncDomReader reader(glow::GlowNodeFactory::getFactory());
+            reader.setLazyLeafDecoding(options.lazyLeafDecoding);
+            reader.setStringPool(options.stringPool ? &pool : 0);
+            reader.read(&buffer[0], &buffer[0] + buffer.size());
+            root.reset(reader.detachRoot());
+        }
+
+        if (root.get() == 0)
+        {
+            THROW_TEST_EXCEPTION("The encoded tree could not be decoded");
+        }
+
+        // The pool is not empty when strings have been interned, its entries are part
+        // of the footprint of the tree.
+        std::size_t const measured = allocation::Memory::liveBytes - before;
+
+        HeapFootprint footprint;
+        footprint.analyze(*root);
+
+        std::size_t const attributed = footprint.attributedBytes();
+        std::cout << name << ": " << buffer.size() << " encoded bytes, " << measured << " heap bytes" << std::endl;
+        footprint.report(std::cout);
+        std::cout << "  attributed " << attributed << " bytes, "
+                  << (measured > attributed ? measured - attributed : 0) << " bytes in allocator blocks, pools and overhead" << std::endl
+                  << std::endl;
+    }
+
+    /**
+     * Reads a recorded tree, a file containing a BER encoded glow message without s101 framing.
+     * @param filename The name of the file to read.
+     * @return The encoded tree.
+     */
+    ByteVector load(char const* filename)
+    {
+        std::ifstream stream(filename, std::ios::binary);
+        if (stream.good() == false)
+        {
+            THROW_TEST_EXCEPTION("Unable to open " << filename);
+        }
+
+        ByteVector const buffer((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+        if (buffer.empty())
+        {
+            THROW_TEST_EXCEPTION(filename << " is empty");
+        }
+        return buffer;
+    }
+}
+
+/**
+ * Reports the heap footprint of decoded glow trees by element type, field and string
+ * duplication. The trees are the recorded trees passed as command line arguments, or
+ * a generated tree if no file is passed.
+ * Usage: tool-libember-footprint [-lazy] [-pool] [file...]
+ *   -lazy  decode string leaves lazily
+ *   -pool  intern strings in a StringPool
+ */
+int main(int argc, char const* const* argv)
+{
+    try
+    {
+        ReaderOptions options;
+        std::vector<char const*> files;
+
+        for (int i = 1; i < argc; ++i)
+        {
+            if (std::strcmp(argv[i], "-lazy") == 0)
+            {
+                options.lazyLeafDecoding = true;
+            }
+            else if (std::strcmp(argv[i], "-pool") == 0)
+            {
+                options.stringPool = true;
+            }
+            else
+            {
+                files.push_back(argv[i]);
+            }
+        }
+
+        if (files.empty())
+        {
+            generator::TreeShape shape;
+            shape.depth = 4;
+            shape.fanOut = 6;
+            shape.streamParameters = 4;
+            shape.targets = 256;
+            shape.sources = 256;
+            shape.connectsPerTarget = 4;
+
+            generator::TreeGenerator treeGenerator(shape);
+            ByteVector buffer;
+            {
+                std::auto_ptr<libember::dom::Node> const tree(treeGenerator.createTree());
+                buffer = encode(*tree);
+            }
+            run("generated tree", buffer, options);
+        }
+
+        for (std::vector<char const*>::const_iterator it = files.begin(); it != files.end(); ++it)
+        {
+            run(*it, load(*it), options);
+        }
+    }
+    catch (std::exception const& e)
+    {
+        std::cerr << "ERROR: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
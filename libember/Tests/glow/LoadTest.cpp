@@ -0,0 +1,1501 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+/*
+ * Loads a provider, or a router, with the traffic of many consumers and measures
+ * how fast it answers.
+ *
+ *     tool-libember-loadtest [options] <host> <port>
+ *
+ * The tool opens the requested number of consumer connections, and each consumer
+ * walks the complete tree with GetDirectory requests, like a consumer does after
+ * it has connected. Then every consumer sends requests at a fixed rate, chosen at
+ * random from the configured mix of directory requests, subscriptions, value changes
+ * and matrix salvos, to the nodes, parameters and matrices found by the first consumer.
+ * When the test has finished, the tool reports
+ *
+ *  - the time each consumer has needed to walk the tree,
+ *  - the latency percentiles of each kind of request, from sending the request until
+ *    the provider reports the requested element,
+ *  - the fan-out latency, from sending a value change until each of the other
+ *    consumers is notified about the parameter,
+ *  - the processor time and the memory of the provider, if its process id is passed
+ *    with --pid. These are read from /proc, so they are only available on Linux.
+ *
+ * Subscriptions are not answered by the provider, so only their number is reported.
+ * The tool polls all connections from a single thread, so it should run on a machine
+ * of its own when the provider is loaded to its limits.
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+#include "ember/Ember.hpp"
+#include "s101/CommandType.hpp"
+#include "s101/Dtd.hpp"
+#include "s101/KeepAlive.hpp"
+#include "s101/MessageType.hpp"
+#include "s101/PackageFlag.hpp"
+#include "s101/StreamDecoder.hpp"
+#include "s101/StreamEncoder.hpp"
+
+#define THROW_TEST_EXCEPTION(message)                       \
+            {                                               \
+                std::ostringstream msgStream;               \
+                msgStream << message ;                      \
+                throw std::runtime_error(msgStream.str());  \
+            }
+
+namespace
+{
+    using namespace libember::glow;
+    using libember::ber::ObjectIdentifier;
+
+    typedef std::vector<unsigned char> ByteVector;
+    typedef libs101::StreamDecoder<unsigned char> S101Decoder;
+
+    /**
+     * Returns the time of the monotonic clock in seconds.
+     */
+    double now()
+    {
+        timespec time;
+        ::clock_gettime(CLOCK_MONOTONIC, &time);
+        return time.tv_sec + time.tv_nsec * 1e-9;
+    }
+
+    /**
+     * Orders object identifiers lexicographically, so they can be used as keys.
+     */
+    struct PathLess
+    {
+        bool operator()(ObjectIdentifier const& lhs, ObjectIdentifier const& rhs) const
+        {
+            return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+        }
+    };
+
+    typedef std::set<ObjectIdentifier, PathLess> PathSet;
+
+    /**
+     * A xorshift generator, so a test sends the same sequence of requests when it
+     * is repeated with the same seed.
+     */
+    class Random
+    {
+        public:
+            explicit Random(unsigned long seed)
+                : m_state((seed & 0xFFFFFFFFUL) != 0 ? seed & 0xFFFFFFFFUL : 1)
+            {}
+
+            /**
+             * Returns a number in [0, bound).
+             */
+            unsigned long next(unsigned long bound)
+            {
+                m_state = (m_state ^ (m_state << 13)) & 0xFFFFFFFFUL;
+                m_state = m_state ^ (m_state >> 17);
+                m_state = (m_state ^ (m_state << 5)) & 0xFFFFFFFFUL;
+                return bound > 0 ? m_state % bound : 0;
+            }
+
+        private:
+            unsigned long m_state;
+    };
+
+    /**
+     * The measured durations of one kind of request.
+     */
+    class Samples
+    {
+        public:
+            void add(double seconds)
+            {
+                m_values.push_back(seconds);
+            }
+
+            std::size_t size() const
+            {
+                return m_values.size();
+            }
+
+            /**
+             * Prints the number of samples and their percentiles in milliseconds.
+             */
+            void print(std::string const& name) const
+            {
+                std::cout << "    " << std::left << std::setw(16) << name << std::right << std::setw(10) << m_values.size();
+                if (m_values.empty() == false)
+                {
+                    std::vector<double> sorted(m_values);
+                    std::sort(sorted.begin(), sorted.end());
+                    std::cout << std::fixed << std::setprecision(3)
+                              << std::setw(12) << percentile(sorted, 0.50) * 1e3
+                              << std::setw(12) << percentile(sorted, 0.90) * 1e3
+                              << std::setw(12) << percentile(sorted, 0.99) * 1e3
+                              << std::setw(12) << sorted.back() * 1e3;
+                }
+                std::cout << std::endl;
+            }
+
+        private:
+            static double percentile(std::vector<double> const& sorted, double fraction)
+            {
+                std::size_t const index = static_cast<std::size_t>(fraction * (sorted.size() - 1) + 0.5);
+                return sorted[std::min(index, sorted.size() - 1)];
+            }
+
+        private:
+            std::vector<double> m_values;
+    };
+
+    /**
+     * Scoped enumeration of the requests a consumer sends during the test.
+     */
+    struct RequestKind
+    {
+        enum _Domain
+        {
+            Directory,
+            Subscribe,
+            SetValue,
+            Connect,
+
+            Count
+        };
+    };
+
+    char const* const requestNames[RequestKind::Count] = { "GetDirectory", "Subscribe", "SetValue", "Connect" };
+
+    /**
+     * A parameter the test changes. Only writeable integer, real, boolean and string
+     * parameters without an enumeration are changed, so every change calculated by
+     * nextValue() is valid.
+     */
+    struct ParameterTarget
+    {
+        ParameterTarget(ObjectIdentifier const& path, ParameterType const& type, MinMax const& minimum, MinMax const& maximum)
+            : path(path), type(type), minimum(minimum), maximum(maximum), changes(0)
+        {}
+
+        /**
+         * Returns the next value to send, which differs from the previous one.
+         */
+        Value nextValue()
+        {
+            changes += 1;
+            switch (type.value())
+            {
+                case ParameterType::Integer:
+                    if (minimum.type().value() == ParameterType::Integer && maximum.type().value() == ParameterType::Integer
+                        && maximum.toInteger() > minimum.toInteger())
+                    {
+                        return Value(minimum.toInteger() + static_cast<long>(changes % (maximum.toInteger() - minimum.toInteger() + 1)));
+                    }
+                    return Value(static_cast<long>(changes % 1000));
+
+                case ParameterType::Real:
+                    if (minimum.type().value() == ParameterType::Real && maximum.type().value() == ParameterType::Real
+                        && maximum.toReal() > minimum.toReal())
+                    {
+                        return Value(minimum.toReal() + (maximum.toReal() - minimum.toReal()) * (changes % 100) / 100.0);
+                    }
+                    return Value((changes % 1000) * 0.5);
+
+                case ParameterType::Boolean:
+                    return Value((changes % 2) != 0);
+
+                default:
+                {
+                    std::ostringstream stream;
+                    stream << "load " << changes;
+                    return Value(stream.str());
+                }
+            }
+        }
+
+        ObjectIdentifier path;
+        ParameterType type;
+        MinMax minimum;
+        MinMax maximum;
+        unsigned long changes;
+    };
+
+    /**
+     * A matrix the test sends salvos to, with the numbers of its targets and sources.
+     */
+    struct MatrixTarget
+    {
+        ObjectIdentifier path;
+        std::vector<int> targets;
+        std::vector<int> sources;
+    };
+
+    /**
+     * The elements found while walking the tree.
+     */
+    struct Tree
+    {
+        std::vector<ObjectIdentifier> nodes;
+        std::vector<ParameterTarget> parameters;
+        std::vector<MatrixTarget> matrices;
+    };
+
+    /**
+     * The options of a test.
+     */
+    struct Options
+    {
+        Options()
+            : port(9000)
+            , consumers(10)
+            , duration(10)
+            , rate(20)
+            , salvo(8)
+            , window(32)
+            , timeout(5)
+            , pid(0)
+            , seed(1)
+        {
+            weights[RequestKind::Directory] = 4;
+            weights[RequestKind::Subscribe] = 2;
+            weights[RequestKind::SetValue] = 3;
+            weights[RequestKind::Connect] = 1;
+        }
+
+        std::string host;
+        int port;
+        int consumers;
+        double duration;
+        double rate;
+        int salvo;
+        std::size_t window;
+        double timeout;
+        long pid;
+        unsigned long seed;
+        unsigned long weights[RequestKind::Count];
+    };
+
+    /**
+     * The results gathered by all consumers.
+     */
+    struct Results
+    {
+        Results()
+            : timedOut(0), throttled(0), valueReports(0), subscribedReports(0)
+        {
+            std::fill(sent, sent + RequestKind::Count, 0UL);
+        }
+
+        Samples sync;
+        Samples latency[RequestKind::Count];
+        Samples fanOut;
+        unsigned long sent[RequestKind::Count];
+        unsigned long timedOut;
+        unsigned long throttled;
+        unsigned long valueReports;
+        unsigned long subscribedReports;
+    };
+
+    /**
+     * The processor time and the memory of a process, as reported by /proc.
+     */
+    struct ProcessSample
+    {
+        ProcessSample()
+            : isValid(false), cpuSeconds(0.0), residentKb(0), peakKb(0)
+        {}
+
+        bool isValid;
+        double cpuSeconds;
+        unsigned long residentKb;
+        unsigned long peakKb;
+    };
+
+    /**
+     * Reads the processor time and the memory of a process.
+     */
+    ProcessSample sampleProcess(long pid)
+    {
+        ProcessSample sample;
+        if (pid <= 0)
+        {
+            return sample;
+        }
+
+        std::ostringstream directory;
+        directory << "/proc/" << pid << "/";
+
+        std::ifstream stat((directory.str() + "stat").c_str());
+        std::string line;
+        if (std::getline(stat, line).fail())
+        {
+            return sample;
+        }
+
+        // The name of the process may contain blanks, the fields are counted from its end.
+        std::string::size_type const nameEnd = line.rfind(')');
+        if (nameEnd == std::string::npos)
+        {
+            return sample;
+        }
+
+        std::istringstream fields(line.substr(nameEnd + 1));
+        std::string field;
+        unsigned long userTicks = 0;
+        unsigned long systemTicks = 0;
+        for (int i = 3; i <= 15 && (fields >> field); ++i)
+        {
+            if (i == 14)
+                userTicks = std::strtoul(field.c_str(), 0, 10);
+            else if (i == 15)
+                systemTicks = std::strtoul(field.c_str(), 0, 10);
+        }
+        sample.cpuSeconds = (userTicks + systemTicks) * 1.0 / ::sysconf(_SC_CLK_TCK);
+
+        std::ifstream status((directory.str() + "status").c_str());
+        while (std::getline(status, line))
+        {
+            if (line.compare(0, 6, "VmRSS:") == 0)
+                sample.residentKb = std::strtoul(line.c_str() + 6, 0, 10);
+            else if (line.compare(0, 6, "VmHWM:") == 0)
+                sample.peakKb = std::strtoul(line.c_str() + 6, 0, 10);
+        }
+
+        sample.isValid = true;
+        return sample;
+    }
+
+    class LoadTest;
+    class PendingRequest;
+
+    /**
+     * A single consumer connection. The consumer frames its requests, answers the
+     * keep-alive requests of the provider and passes the received messages to its
+     * GlowSession, which correlates them with the pending requests.
+     */
+    class Consumer
+        : public GlowSession::Connection
+        , public GlowSession::Listener
+        , private libember::dom::AsyncDomReader
+        , private GlowVisitor
+    {
+        public:
+            Consumer(LoadTest& test, std::size_t index, int socket);
+
+            ~Consumer();
+
+            int socket() const
+            {
+                return m_socket;
+            }
+
+            bool wantsToWrite() const
+            {
+                return m_output.empty() == false;
+            }
+
+            bool isSynchronized() const
+            {
+                return m_walking == 0;
+            }
+
+            /** Returns the number of requests that have not been answered yet. */
+            std::size_t outstanding() const
+            {
+                return m_pending.size() + m_salvoCount;
+            }
+
+            Tree const& tree() const
+            {
+                return m_tree;
+            }
+
+            /** Reads all available bytes, throws if the provider has closed the connection. */
+            void receive();
+
+            /** Writes as many of the pending bytes as the socket accepts. */
+            void send();
+
+            /** Starts walking the tree from the root. */
+            void synchronize();
+
+            void getDirectory(ObjectIdentifier const& path);
+
+            void setValue(ParameterTarget& parameter);
+
+            /** Subscribes to a parameter, or unsubscribes if it has already been subscribed. */
+            void toggleSubscription(ObjectIdentifier const& path);
+
+            /** Connects a random source to each of @p count random targets of a matrix. */
+            void connect(MatrixTarget const& matrix, Random& random, int count);
+
+            /** Times out the requests that have not been answered in time. */
+            void expire(double time);
+
+            /** Called by a PendingRequest when the session resumes it. */
+            void completed(PendingRequest* request, GlowSession::Result const& result);
+
+            /** @see GlowSession::Connection::write() */
+            virtual void write(libember::dom::Node const& message);
+
+            /** @see GlowSession::Listener::notify() */
+            virtual void notify(ObjectIdentifier const& path, GlowContentElement const& element);
+
+        private:
+            typedef std::map<ObjectIdentifier, std::deque<double>, PathLess> SalvoMap;
+
+            static void onFrame(S101Decoder::const_iterator first, S101Decoder::const_iterator last, Consumer* state)
+            {
+                state->handleFrame(first, last);
+            }
+
+            void handleFrame(S101Decoder::const_iterator first, S101Decoder::const_iterator last);
+
+            void walk(ObjectIdentifier const& path, GlowTreeMirror::ElementType type);
+
+            void walked(GlowSession::Result const& result);
+
+            void addParameter(ObjectIdentifier const& path, GlowParameterBase const& parameter);
+
+            void addMatrix(ObjectIdentifier const& path, GlowMatrixBase const& matrix);
+
+            void element(GlowContentElement const& glow, GlowElementCollection const* children);
+
+            virtual void rootReady(libember::dom::Node* node);
+
+            virtual void visit(GlowRootElementCollection const& glow);
+            virtual void visit(GlowElementCollection const& glow);
+            virtual void visit(GlowNode const& glow);
+            virtual void visit(GlowQualifiedNode const& glow);
+            virtual void visit(GlowParameter const& glow);
+            virtual void visit(GlowQualifiedParameter const& glow);
+            virtual void visit(GlowMatrix const& glow);
+            virtual void visit(GlowQualifiedMatrix const& glow);
+
+        private:
+            Consumer(Consumer const&);
+            Consumer& operator=(Consumer const&);
+
+        private:
+            LoadTest& m_test;
+            std::size_t const m_index;
+            int const m_socket;
+            S101Decoder m_decoder;
+            ByteVector m_output;
+            GlowSession m_session;
+            std::set<PendingRequest*> m_pending;
+            PathSet m_subscriptions;
+            SalvoMap m_salvos;
+            std::size_t m_salvoCount;
+            ObjectIdentifier m_path;
+            Tree m_tree;
+            PathSet m_visited;
+            PathSet m_matrices;
+            std::size_t m_walking;
+            double m_syncStart;
+    };
+
+    /**
+     * The continuation of a single request, which knows when it has been sent.
+     */
+    class PendingRequest : public GlowSession::Continuation
+    {
+        public:
+            PendingRequest(Consumer& consumer, RequestKind::_Domain kind, bool isWalk)
+                : kind(kind), isWalk(isWalk), sent(now()), m_consumer(consumer)
+            {}
+
+            virtual void resume(GlowSession::Result const& result)
+            {
+                m_consumer.completed(this, result);
+                delete this;
+            }
+
+            RequestKind::_Domain const kind;
+            bool const isWalk;
+            double const sent;
+
+        private:
+            Consumer& m_consumer;
+    };
+
+    /**
+     * Connects the consumers, synchronizes them and runs the load.
+     */
+    class LoadTest
+    {
+        public:
+            explicit LoadTest(Options const& options)
+                : m_options(options)
+                , m_random(options.seed)
+                , m_start(now())
+                , m_peakKb(0)
+            {}
+
+            ~LoadTest()
+            {
+                for (std::vector<Consumer*>::iterator it = m_consumers.begin(); it != m_consumers.end(); ++it)
+                {
+                    delete *it;
+                }
+            }
+
+            Results& results()
+            {
+                return m_results;
+            }
+
+            Options const& options() const
+            {
+                return m_options;
+            }
+
+            /** Returns the tick of the sessions, in milliseconds since the test has started. */
+            GlowSession::tick_type tick() const
+            {
+                return static_cast<GlowSession::tick_type>((now() - m_start) * 1000.0);
+            }
+
+            /**
+             * Remembers a value change, so the reports of the other consumers can be
+             * attributed to it.
+             */
+            void valueSent(std::size_t origin, ObjectIdentifier const& path, double time)
+            {
+                FanOut& fanOut = m_fanOuts[path];
+                fanOut.sent = time;
+                fanOut.origin = origin;
+                fanOut.notified.assign(m_consumers.size(), false);
+                fanOut.notified[origin] = true;
+                fanOut.remaining = m_consumers.size() - 1;
+            }
+
+            /**
+             * Records the fan-out latency of the last change of a parameter when a
+             * consumer other than the one that has changed it receives its first report.
+             */
+            void valueReported(std::size_t consumer, ObjectIdentifier const& path, double time)
+            {
+                m_results.valueReports += 1;
+
+                FanOutMap::iterator const it = m_fanOuts.find(path);
+                if (it != m_fanOuts.end() && it->second.notified[consumer] == false)
+                {
+                    it->second.notified[consumer] = true;
+                    m_results.fanOut.add(time - it->second.sent);
+
+                    if (--it->second.remaining == 0)
+                    {
+                        m_fanOuts.erase(it);
+                    }
+                }
+            }
+
+            void run();
+
+        private:
+            struct FanOut
+            {
+                double sent;
+                std::size_t origin;
+                std::vector<bool> notified;
+                std::size_t remaining;
+            };
+
+            typedef std::map<ObjectIdentifier, FanOut, PathLess> FanOutMap;
+
+            int connectSocket() const;
+
+            void pump(int timeout);
+
+            void issue(Consumer& consumer, Tree& tree);
+
+            ProcessSample sampleProvider();
+
+            void printReport(Tree const& tree, double seconds, ProcessSample const& first, ProcessSample const& last) const;
+
+        private:
+            Options const m_options;
+            Random m_random;
+            double const m_start;
+            std::vector<Consumer*> m_consumers;
+            Results m_results;
+            FanOutMap m_fanOuts;
+            unsigned long m_peakKb;
+    };
+
+    /**************************************************************************
+     * Consumer implementation                                                *
+     **************************************************************************/
+
+    Consumer::Consumer(LoadTest& test, std::size_t index, int socket)
+        : libember::dom::AsyncDomReader(GlowNodeFactory::getFactory())
+        , m_test(test)
+        , m_index(index)
+        , m_socket(socket)
+        , m_session(*this, static_cast<GlowSession::tick_type>(test.options().timeout * 1000.0))
+        , m_salvoCount(0)
+        , m_walking(0)
+        , m_syncStart(0.0)
+    {}
+
+    Consumer::~Consumer()
+    {
+        // The session drops its pending operations without resuming them.
+        for (std::set<PendingRequest*>::iterator it = m_pending.begin(); it != m_pending.end(); ++it)
+        {
+            delete *it;
+        }
+        ::close(m_socket);
+    }
+
+    void Consumer::receive()
+    {
+        unsigned char buffer[65536];
+        for (;;)
+        {
+            ssize_t const count = ::recv(m_socket, buffer, sizeof(buffer), 0);
+            if (count > 0)
+            {
+                m_decoder.read(buffer, buffer + count, &Consumer::onFrame, this);
+            }
+            else if (count == 0)
+            {
+                THROW_TEST_EXCEPTION("The provider has closed the connection of consumer " << m_index);
+            }
+            else if (errno == EAGAIN || errno == EWOULDBLOCK)
+            {
+                return;
+            }
+            else if (errno != EINTR)
+            {
+                THROW_TEST_EXCEPTION("Consumer " << m_index << " failed to receive: " << std::strerror(errno));
+            }
+        }
+    }
+
+    void Consumer::send()
+    {
+        while (m_output.empty() == false)
+        {
+            ssize_t const count = ::send(m_socket, &m_output[0], m_output.size(), MSG_NOSIGNAL);
+            if (count > 0)
+            {
+                m_output.erase(m_output.begin(), m_output.begin() + count);
+            }
+            else if (errno == EAGAIN || errno == EWOULDBLOCK)
+            {
+                return;
+            }
+            else if (errno != EINTR)
+            {
+                THROW_TEST_EXCEPTION("Consumer " << m_index << " failed to send: " << std::strerror(errno));
+            }
+        }
+    }
+
+    void Consumer::synchronize()
+    {
+        m_syncStart = now();
+        m_visited.insert(ObjectIdentifier());
+        m_tree.nodes.push_back(ObjectIdentifier());
+        walk(ObjectIdentifier(), GlowTreeMirror::Node);
+    }
+
+    void Consumer::getDirectory(ObjectIdentifier const& path)
+    {
+        m_test.results().sent[RequestKind::Directory] += 1;
+
+        PendingRequest* const request = new PendingRequest(*this, RequestKind::Directory, false);
+        m_pending.insert(request);
+        m_session.getDirectory(path, request);
+    }
+
+    void Consumer::setValue(ParameterTarget& parameter)
+    {
+        m_test.results().sent[RequestKind::SetValue] += 1;
+
+        PendingRequest* const request = new PendingRequest(*this, RequestKind::SetValue, false);
+        m_pending.insert(request);
+        m_test.valueSent(m_index, parameter.path, request->sent);
+        m_session.setValue(parameter.path, parameter.nextValue(), request);
+    }
+
+    void Consumer::toggleSubscription(ObjectIdentifier const& path)
+    {
+        m_test.results().sent[RequestKind::Subscribe] += 1;
+
+        if (m_subscriptions.insert(path).second)
+        {
+            m_session.subscribe(path, this, GlowTreeMirror::Parameter);
+        }
+        else
+        {
+            m_subscriptions.erase(path);
+            m_session.unsubscribe(path, this);
+        }
+    }
+
+    void Consumer::connect(MatrixTarget const& matrix, Random& random, int count)
+    {
+        m_test.results().sent[RequestKind::Connect] += 1;
+
+        std::auto_ptr<GlowRootElementCollection> const root(GlowRootElementCollection::create());
+        GlowQualifiedMatrix* const qualified = new GlowQualifiedMatrix(root.get(), matrix.path);
+        libember::dom::Sequence* const connections = qualified->connections();
+
+        for (int i = 0; i < count; ++i)
+        {
+            int const source[] = { matrix.sources[random.next(matrix.sources.size())] };
+            GlowConnection* const connection = new GlowConnection(matrix.targets[random.next(matrix.targets.size())]);
+            connection->setSources(ObjectIdentifier(source, source + 1));
+            connection->setOperation(ConnectionOperation::Absolute);
+            connections->insert(connections->end(), connection);
+        }
+
+        m_salvos[matrix.path].push_back(now());
+        m_salvoCount += 1;
+        write(*root);
+    }
+
+    void Consumer::expire(double time)
+    {
+        m_session.expire(m_test.tick());
+
+        // Salvos are not tracked by the session, since they are not one of its operations.
+        double const deadline = time - m_test.options().timeout;
+        for (SalvoMap::iterator it = m_salvos.begin(); it != m_salvos.end(); ++it)
+        {
+            while (it->second.empty() == false && it->second.front() < deadline)
+            {
+                it->second.pop_front();
+                m_salvoCount -= 1;
+                m_test.results().timedOut += 1;
+            }
+        }
+    }
+
+    void Consumer::completed(PendingRequest* request, GlowSession::Result const& result)
+    {
+        m_pending.erase(request);
+
+        if (result.status == GlowSession::Status::TimedOut)
+        {
+            m_test.results().timedOut += 1;
+        }
+        else if (request->isWalk == false)
+        {
+            m_test.results().latency[request->kind].add(now() - request->sent);
+        }
+
+        if (request->isWalk)
+        {
+            walked(result);
+        }
+    }
+
+    void Consumer::write(libember::dom::Node const& message)
+    {
+        libember::util::OctetStream stream;
+        message.encode(stream);
+        ByteVector const buffer(stream.begin(), stream.end());
+
+        unsigned short const version = GlowDtd::version();
+        std::size_t const packageSize = 1024;
+        std::size_t offset = 0;
+        do
+        {
+            std::size_t const size = std::min(packageSize, buffer.size() - offset);
+            unsigned char const flags = static_cast<unsigned char>(
+                    (offset == 0 ? libs101::PackageFlag::FirstPackage : 0) |
+                    (offset + size == buffer.size() ? libs101::PackageFlag::LastPackage : 0) |
+                    (size == 0 ? libs101::PackageFlag::EmptyPackage : 0)
+                );
+
+            libs101::StreamEncoder<unsigned char> encoder;
+            encoder.encode(0x00);                           // Slot
+            encoder.encode(libs101::MessageType::EmBER);    // Message type
+            encoder.encode(libs101::CommandType::EmBER);    // Ember Command
+            encoder.encode(0x01);                           // Version
+            encoder.encode(flags);                          // Flags
+            encoder.encode(libs101::Dtd::Glow);             // Glow Dtd
+            encoder.encode(0x02);                           // App bytes
+            encoder.encode(version & 0xFF);                 // Minor version
+            encoder.encode((version >> 8) & 0xFF);          // Major version
+            if (size > 0)
+            {
+                encoder.encode(&buffer[offset], &buffer[offset] + size);
+            }
+            encoder.finish();
+
+            m_output.insert(m_output.end(), encoder.begin(), encoder.end());
+            offset += size;
+        }
+        while (offset < buffer.size());
+    }
+
+    void Consumer::notify(ObjectIdentifier const&, GlowContentElement const&)
+    {
+        m_test.results().subscribedReports += 1;
+    }
+
+    void Consumer::handleFrame(S101Decoder::const_iterator first, S101Decoder::const_iterator last)
+    {
+        if (libs101::KeepAlive::isRequest(first, last))
+        {
+            m_output.insert(m_output.end(), libs101::KeepAlive::responseBegin(), libs101::KeepAlive::responseEnd());
+            return;
+        }
+
+        // Slot, message type, command, version, flags, dtd and the number of application bytes.
+        std::size_t const size = std::distance(first, last);
+        if (size < 7 || first[1] != libs101::MessageType::EmBER || first[2] != libs101::CommandType::EmBER)
+        {
+            return;
+        }
+
+        std::size_t const headerSize = 7 + first[6];
+        if (headerSize > size)
+        {
+            return;
+        }
+
+        if ((first[4] & libs101::PackageFlag::FirstPackage) != 0)
+        {
+            reset();
+        }
+
+        if (size > headerSize)
+        {
+            unsigned char const* const payload = &*(first + headerSize);
+            read(payload, payload + (size - headerSize));
+        }
+    }
+
+    void Consumer::walk(ObjectIdentifier const& path, GlowTreeMirror::ElementType type)
+    {
+        PendingRequest* const request = new PendingRequest(*this, RequestKind::Directory, true);
+        m_pending.insert(request);
+        m_walking += 1;
+        m_session.getDirectory(path, request, type);
+    }
+
+    void Consumer::walked(GlowSession::Result const& result)
+    {
+        for (std::size_t i = 0; i < result.elements.size(); ++i)
+        {
+            ObjectIdentifier const& path = result.paths[i];
+            GlowContentElement const* const element = result.elements[i];
+
+            if (dynamic_cast<GlowNodeBase const*>(element) != 0)
+            {
+                // An empty node is reported as its own directory.
+                if (m_visited.insert(path).second)
+                {
+                    m_tree.nodes.push_back(path);
+                    walk(path, GlowTreeMirror::Node);
+                }
+            }
+            else if (GlowParameterBase const* const parameter = dynamic_cast<GlowParameterBase const*>(element))
+            {
+                if (m_visited.insert(path).second)
+                {
+                    addParameter(path, *parameter);
+                }
+            }
+            else if (GlowMatrixBase const* const matrix = dynamic_cast<GlowMatrixBase const*>(element))
+            {
+                // The directory of a matrix contains its targets and sources.
+                if (m_visited.insert(path).second)
+                {
+                    walk(path, GlowTreeMirror::Matrix);
+                }
+                else if (m_matrices.insert(path).second)
+                {
+                    addMatrix(path, *matrix);
+                }
+            }
+        }
+
+        m_walking -= 1;
+        if (m_walking == 0)
+        {
+            m_test.results().sync.add(now() - m_syncStart);
+        }
+    }
+
+    void Consumer::addParameter(ObjectIdentifier const& path, GlowParameterBase const& parameter)
+    {
+        if (parameter.isWriteable() == false || parameter.hasEnumeration() || parameter.contains(ParameterProperty::Value) == false)
+        {
+            return;
+        }
+
+        ParameterType const type = parameter.value().type();
+        switch (type.value())
+        {
+            case ParameterType::Integer:
+            case ParameterType::Real:
+            case ParameterType::Boolean:
+            case ParameterType::String:
+                m_tree.parameters.push_back(ParameterTarget(path, type, parameter.minimum(), parameter.maximum()));
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    void Consumer::addMatrix(ObjectIdentifier const& path, GlowMatrixBase const& matrix)
+    {
+        MatrixTarget target;
+        target.path = path;
+
+        libember::dom::Sequence const* const targets = matrix.targets();
+        libember::dom::Sequence const* const sources = matrix.sources();
+        if (targets != 0 && sources != 0)
+        {
+            for (libember::dom::Sequence::const_iterator it = targets->begin(); it != targets->end(); ++it)
+            {
+                if (GlowSignal const* const signal = dynamic_cast<GlowSignal const*>(&*it))
+                    target.targets.push_back(signal->number());
+            }
+            for (libember::dom::Sequence::const_iterator it = sources->begin(); it != sources->end(); ++it)
+            {
+                if (GlowSignal const* const signal = dynamic_cast<GlowSignal const*>(&*it))
+                    target.sources.push_back(signal->number());
+            }
+        }
+        else
+        {
+            // A linear matrix numbers its signals from 0.
+            for (int i = 0; i < matrix.targetCount(); ++i)
+                target.targets.push_back(i);
+            for (int i = 0; i < matrix.sourceCount(); ++i)
+                target.sources.push_back(i);
+        }
+
+        if (target.targets.empty() == false && target.sources.empty() == false)
+        {
+            m_tree.matrices.push_back(target);
+        }
+    }
+
+    void Consumer::rootReady(libember::dom::Node* node)
+    {
+        std::auto_ptr<libember::dom::Node> const root(detachRoot());
+        if (root.get() != node || node == 0)
+        {
+            return;
+        }
+
+        m_session.providerMessage(*root);
+
+        // The value reports and connections are scanned after the session has
+        // resumed the requests, which may have sent follow-up requests already.
+        m_path = ObjectIdentifier();
+        accept(*root);
+    }
+
+    void Consumer::element(GlowContentElement const& glow, GlowElementCollection const* children)
+    {
+        if (GlowParameterBase const* const parameter = dynamic_cast<GlowParameterBase const*>(&glow))
+        {
+            if (parameter->contains(ParameterProperty::Value))
+            {
+                m_test.valueReported(m_index, m_path, now());
+            }
+        }
+        else if (GlowMatrixBase const* const matrix = dynamic_cast<GlowMatrixBase const*>(&glow))
+        {
+            libember::dom::Sequence const* const connections = matrix->connections();
+            SalvoMap::iterator const salvos = m_salvos.find(m_path);
+            if (connections != 0 && connections->empty() == false && salvos != m_salvos.end() && salvos->second.empty() == false)
+            {
+                m_test.results().latency[RequestKind::Connect].add(now() - salvos->second.front());
+                salvos->second.pop_front();
+                m_salvoCount -= 1;
+            }
+        }
+
+        if (children != 0)
+        {
+            acceptChildren(*children);
+        }
+    }
+
+    void Consumer::visit(GlowRootElementCollection const& glow)
+    {
+        acceptChildren(glow);
+    }
+
+    void Consumer::visit(GlowElementCollection const& glow)
+    {
+        acceptChildren(glow);
+    }
+
+    void Consumer::visit(GlowNode const& glow)
+    {
+        m_path.push_back(glow.number());
+        element(glow, glow.children());
+        m_path = ObjectIdentifier(m_path.begin(), m_path.end() - 1);
+    }
+
+    void Consumer::visit(GlowQualifiedNode const& glow)
+    {
+        ObjectIdentifier const previous = m_path;
+        m_path = glow.path();
+        element(glow, glow.children());
+        m_path = previous;
+    }
+
+    void Consumer::visit(GlowParameter const& glow)
+    {
+        m_path.push_back(glow.number());
+        element(glow, glow.children());
+        m_path = ObjectIdentifier(m_path.begin(), m_path.end() - 1);
+    }
+
+    void Consumer::visit(GlowQualifiedParameter const& glow)
+    {
+        ObjectIdentifier const previous = m_path;
+        m_path = glow.path();
+        element(glow, glow.children());
+        m_path = previous;
+    }
+
+    void Consumer::visit(GlowMatrix const& glow)
+    {
+        m_path.push_back(glow.number());
+        element(glow, glow.children());
+        m_path = ObjectIdentifier(m_path.begin(), m_path.end() - 1);
+    }
+
+    void Consumer::visit(GlowQualifiedMatrix const& glow)
+    {
+        ObjectIdentifier const previous = m_path;
+        m_path = glow.path();
+        element(glow, glow.children());
+        m_path = previous;
+    }
+
+    /**************************************************************************
+     * LoadTest implementation                                                *
+     **************************************************************************/
+
+    void LoadTest::run()
+    {
+        for (int i = 0; i < m_options.consumers; ++i)
+        {
+            m_consumers.push_back(new Consumer(*this, m_consumers.size(), connectSocket()));
+        }
+        std::cout << "connected " << m_consumers.size() << " consumers to " << m_options.host << ":" << m_options.port << std::endl;
+
+        for (std::vector<Consumer*>::iterator it = m_consumers.begin(); it != m_consumers.end(); ++it)
+        {
+            (*it)->synchronize();
+        }
+
+        bool isSynchronized = false;
+        while (isSynchronized == false)
+        {
+            pump(10);
+
+            isSynchronized = true;
+            for (std::vector<Consumer*>::const_iterator it = m_consumers.begin(); it != m_consumers.end(); ++it)
+            {
+                isSynchronized = isSynchronized && (*it)->isSynchronized();
+            }
+        }
+
+        Tree tree = m_consumers.front()->tree();
+        std::cout << "synchronized: " << tree.nodes.size() << " nodes, " << tree.parameters.size() << " writeable parameters, "
+                  << tree.matrices.size() << " matrices" << std::endl;
+
+        ProcessSample const first = sampleProvider();
+        double const start = now();
+        double const end = start + m_options.duration;
+        double nextSample = start + 1.0;
+        double const interval = 1.0 / std::max(m_options.rate, 1e-3);
+        std::vector<double> due(m_consumers.size(), start);
+
+        // Spread the requests of the consumers over the interval.
+        for (std::size_t i = 0; i < due.size(); ++i)
+        {
+            due[i] += interval * i / due.size();
+        }
+
+        for (double time = start; time < end; time = now())
+        {
+            for (std::size_t i = 0; i < m_consumers.size(); ++i)
+            {
+                while (due[i] <= time)
+                {
+                    issue(*m_consumers[i], tree);
+                    due[i] += interval;
+                }
+            }
+
+            if (time >= nextSample)
+            {
+                sampleProvider();
+                nextSample += 1.0;
+            }
+
+            pump(1);
+        }
+
+        double const seconds = now() - start;
+        ProcessSample const last = sampleProvider();
+
+        // Waits for the outstanding requests, which are reported as timed out eventually.
+        for (bool isIdle = false; isIdle == false; )
+        {
+            pump(10);
+
+            isIdle = true;
+            for (std::vector<Consumer*>::const_iterator it = m_consumers.begin(); it != m_consumers.end(); ++it)
+            {
+                isIdle = isIdle && (*it)->outstanding() == 0;
+            }
+        }
+
+        printReport(tree, seconds, first, last);
+    }
+
+    int LoadTest::connectSocket() const
+    {
+        std::ostringstream port;
+        port << m_options.port;
+
+        addrinfo hints;
+        std::memset(&hints, 0, sizeof(hints));
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+
+        addrinfo* addresses = 0;
+        int const error = ::getaddrinfo(m_options.host.c_str(), port.str().c_str(), &hints, &addresses);
+        if (error != 0)
+        {
+            THROW_TEST_EXCEPTION("Unable to resolve " << m_options.host << ": " << ::gai_strerror(error));
+        }
+
+        int result = -1;
+        for (addrinfo* address = addresses; address != 0 && result < 0; address = address->ai_next)
+        {
+            result = ::socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+            if (result >= 0 && ::connect(result, address->ai_addr, address->ai_addrlen) != 0)
+            {
+                ::close(result);
+                result = -1;
+            }
+        }
+        ::freeaddrinfo(addresses);
+
+        if (result < 0)
+        {
+            THROW_TEST_EXCEPTION("Unable to connect to " << m_options.host << ":" << m_options.port << ": " << std::strerror(errno));
+        }
+
+        int const noDelay = 1;
+        ::setsockopt(result, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+        ::fcntl(result, F_SETFL, ::fcntl(result, F_GETFL) | O_NONBLOCK);
+        return result;
+    }
+
+    void LoadTest::pump(int timeout)
+    {
+        std::vector<pollfd> descriptors(m_consumers.size());
+        for (std::size_t i = 0; i < m_consumers.size(); ++i)
+        {
+            descriptors[i].fd = m_consumers[i]->socket();
+            descriptors[i].events = static_cast<short>(POLLIN | (m_consumers[i]->wantsToWrite() ? POLLOUT : 0));
+            descriptors[i].revents = 0;
+        }
+
+        if (::poll(&descriptors[0], descriptors.size(), timeout) < 0 && errno != EINTR)
+        {
+            THROW_TEST_EXCEPTION("poll failed: " << std::strerror(errno));
+        }
+
+        double const time = now();
+        for (std::size_t i = 0; i < m_consumers.size(); ++i)
+        {
+            Consumer& consumer = *m_consumers[i];
+            if ((descriptors[i].revents & (POLLIN | POLLHUP | POLLERR)) != 0)
+            {
+                consumer.receive();
+            }
+
+            consumer.expire(time);
+
+            // The requests sent while receiving are written right away.
+            if (consumer.wantsToWrite())
+            {
+                consumer.send();
+            }
+        }
+    }
+
+    void LoadTest::issue(Consumer& consumer, Tree& tree)
+    {
+        if (consumer.outstanding() >= m_options.window)
+        {
+            m_results.throttled += 1;
+            return;
+        }
+
+        // Requests that have no target in the tree are dropped from the mix.
+        unsigned long weights[RequestKind::Count];
+        std::copy(m_options.weights, m_options.weights + RequestKind::Count, weights);
+        if (tree.parameters.empty())
+        {
+            weights[RequestKind::Subscribe] = 0;
+            weights[RequestKind::SetValue] = 0;
+        }
+        if (tree.matrices.empty())
+        {
+            weights[RequestKind::Connect] = 0;
+        }
+
+        unsigned long total = 0;
+        for (int i = 0; i < RequestKind::Count; ++i)
+        {
+            total += weights[i];
+        }
+        if (total == 0)
+        {
+            return;
+        }
+
+        unsigned long choice = m_random.next(total);
+        int kind = 0;
+        while (choice >= weights[kind])
+        {
+            choice -= weights[kind];
+            kind += 1;
+        }
+
+        switch (kind)
+        {
+            case RequestKind::Directory:
+                consumer.getDirectory(tree.nodes[m_random.next(tree.nodes.size())]);
+                break;
+
+            case RequestKind::Subscribe:
+                consumer.toggleSubscription(tree.parameters[m_random.next(tree.parameters.size())].path);
+                break;
+
+            case RequestKind::SetValue:
+                consumer.setValue(tree.parameters[m_random.next(tree.parameters.size())]);
+                break;
+
+            case RequestKind::Connect:
+                consumer.connect(tree.matrices[m_random.next(tree.matrices.size())], m_random, m_options.salvo);
+                break;
+        }
+    }
+
+    ProcessSample LoadTest::sampleProvider()
+    {
+        ProcessSample const sample = sampleProcess(m_options.pid);
+        m_peakKb = std::max(m_peakKb, sample.residentKb);
+        return sample;
+    }
+
+    void LoadTest::printReport(Tree const&, double seconds, ProcessSample const& first, ProcessSample const& last) const
+    {
+        unsigned long requests = 0;
+        for (int i = 0; i < RequestKind::Count; ++i)
+        {
+            requests += m_results.sent[i];
+        }
+
+        std::cout << std::fixed << std::setprecision(1)
+                  << "load: " << requests << " requests in " << seconds << " s, " << (requests / std::max(seconds, 1e-6)) << " requests/s" << std::endl
+                  << "  timed out:        " << m_results.timedOut << std::endl
+                  << "  throttled:        " << m_results.throttled << " (more than " << m_options.window << " requests outstanding)" << std::endl
+                  << "  value reports:    " << m_results.valueReports << ", " << m_results.subscribedReports << " to subscribers" << std::endl
+                  << "  latency [ms]:" << std::endl
+                  << "    " << std::left << std::setw(16) << "request" << std::right << std::setw(10) << "count"
+                  << std::setw(12) << "p50" << std::setw(12) << "p90" << std::setw(12) << "p99" << std::setw(12) << "max" << std::endl;
+
+        m_results.sync.print("tree walk");
+        for (int i = 0; i < RequestKind::Count; ++i)
+        {
+            if (i == RequestKind::Subscribe)
+            {
+                std::cout << "    " << std::left << std::setw(16) << requestNames[i] << std::right << std::setw(10) << m_results.sent[i]
+                          << "  (not answered)" << std::endl;
+            }
+            else
+            {
+                m_results.latency[i].print(requestNames[i]);
+            }
+        }
+        m_results.fanOut.print("fan-out");
+
+        if (first.isValid && last.isValid)
+        {
+            std::cout << std::fixed << std::setprecision(1)
+                      << "  provider " << m_options.pid << ":" << std::endl
+                      << "    cpu:            " << (last.cpuSeconds - first.cpuSeconds) * 100.0 / std::max(seconds, 1e-6) << " %" << std::endl
+                      << "    resident:       " << first.residentKb << " kB before, " << last.residentKb << " kB after, "
+                      << std::max(m_peakKb, last.residentKb) << " kB peak sampled, " << last.peakKb << " kB peak reported" << std::endl;
+        }
+        else if (m_options.pid > 0)
+        {
+            std::cout << "  provider " << m_options.pid << ": /proc is not available" << std::endl;
+        }
+    }
+
+    void printUsage()
+    {
+        Options const defaults;
+        std::cerr << "usage: tool-libember-loadtest [options] <host> <port>" << std::endl
+                  << "  --consumers <count>   The number of consumer connections, " << defaults.consumers << " by default." << std::endl
+                  << "  --duration <seconds>  The duration of the load, " << defaults.duration << " by default." << std::endl
+                  << "  --rate <requests>     The requests per second of each consumer, " << defaults.rate << " by default." << std::endl
+                  << "  --mix <d:s:v:c>       The weights of GetDirectory, Subscribe, SetValue and matrix salvo" << std::endl
+                  << "                        requests, 4:2:3:1 by default." << std::endl
+                  << "  --salvo <count>       The number of connections of a salvo, " << defaults.salvo << " by default." << std::endl
+                  << "  --window <count>      The number of requests a consumer keeps outstanding at most," << std::endl
+                  << "                        " << defaults.window << " by default." << std::endl
+                  << "  --timeout <seconds>   The time after which a request times out, " << defaults.timeout << " by default." << std::endl
+                  << "  --pid <pid>           The process id of the provider, to report its processor time and memory." << std::endl
+                  << "  --seed <number>       The seed of the random choice of requests." << std::endl;
+    }
+
+    bool parseMix(std::string const& text, unsigned long* weights)
+    {
+        std::istringstream stream(text);
+        for (int i = 0; i < RequestKind::Count; ++i)
+        {
+            char separator = ':';
+            if ((i > 0 && ((stream >> separator).fail() || separator != ':')) || (stream >> weights[i]).fail())
+            {
+                return false;
+            }
+        }
+        return stream.eof() || stream.peek() == std::char_traits<char>::eof();
+    }
+}
+
+int main(int argc, char const* const* argv)
+{
+    try
+    {
+        Options options;
+        std::vector<std::string> arguments;
+
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string const argument = argv[i];
+            bool const hasValue = i + 1 < argc;
+            if (argument == "--consumers" && hasValue)
+            {
+                options.consumers = std::max(std::atoi(argv[++i]), 1);
+            }
+            else if (argument == "--duration" && hasValue)
+            {
+                options.duration = std::atof(argv[++i]);
+            }
+            else if (argument == "--rate" && hasValue)
+            {
+                options.rate = std::atof(argv[++i]);
+            }
+            else if (argument == "--mix" && hasValue)
+            {
+                if (parseMix(argv[++i], options.weights) == false)
+                {
+                    printUsage();
+                    return 1;
+                }
+            }
+            else if (argument == "--salvo" && hasValue)
+            {
+                options.salvo = std::max(std::atoi(argv[++i]), 1);
+            }
+            else if (argument == "--window" && hasValue)
+            {
+                options.window = static_cast<std::size_t>(std::max(std::atoi(argv[++i]), 1));
+            }
+            else if (argument == "--timeout" && hasValue)
+            {
+                options.timeout = std::max(std::atof(argv[++i]), 0.1);
+            }
+            else if (argument == "--pid" && hasValue)
+            {
+                options.pid = std::atol(argv[++i]);
+            }
+            else if (argument == "--seed" && hasValue)
+            {
+                options.seed = std::strtoul(argv[++i], 0, 10);
+            }
+            else if (argument.compare(0, 2, "--") == 0)
+            {
+                printUsage();
+                return 1;
+            }
+            else
+            {
+                arguments.push_back(argument);
+            }
+        }
+
+        if (arguments.size() != 2)
+        {
+            printUsage();
+            return 1;
+        }
+
+        options.host = arguments[0];
+        options.port = std::atoi(arguments[1].c_str());
+
+        LoadTest test(options);
+        test.run();
+    }
+    catch (std::exception const& e)
+    {
+        std::cerr << "ERROR: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,858 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+/*
+ * Replays captured Ember+ traffic through the s101 decoder and the AsyncDomReader,
+ * and optionally through the GlowReader of libember_slim, as fast as possible.
+ *
+ *     tool-libember-s101replay [--repeat <count>] [--slim] <file>...
+ *
+ * A file is either a libpcap capture or a raw dump of the s101 byte stream of a
+ * single connection. The tcp payload of a capture is reassembled for each direction
+ * of each connection, so every direction is decoded by a decoder of its own.
+ * The capture is read into memory completely before it is replayed, so the results
+ * only depend on the decoders.
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "ember/Ember.hpp"
+#include "s101/CommandType.hpp"
+#include "s101/KeepAlive.hpp"
+#include "s101/MessageType.hpp"
+#include "s101/PackageFlag.hpp"
+#include "s101/StreamDecoder.hpp"
+#include "CountingAllocator.hpp"
+
+extern "C"
+{
+#include "emberplus.h"
+}
+
+#define THROW_TEST_EXCEPTION(message)                       \
+            {                                               \
+                std::ostringstream msgStream;               \
+                msgStream << message ;                      \
+                throw std::runtime_error(msgStream.str());  \
+            }
+
+namespace
+{
+    typedef std::vector<unsigned char> ByteVector;
+    typedef libs101::StreamDecoder<unsigned char> S101Decoder;
+
+    /**
+     * The reassembled byte stream of one direction of a connection.
+     */
+    struct Flow
+    {
+        Flow()
+            : isStarted(false), nextSequence(0), gaps(0)
+        {}
+
+        std::string name;
+        ByteVector bytes;
+        bool isStarted;
+        unsigned long nextSequence;
+        unsigned long gaps;
+    };
+
+    typedef std::vector<Flow> FlowCollection;
+
+    /**
+     * Reads a file into memory.
+     */
+    ByteVector load(std::string const& filename)
+    {
+        std::ifstream stream(filename.c_str(), std::ios::binary);
+        if (stream.good() == false)
+        {
+            THROW_TEST_EXCEPTION("Unable to open " << filename);
+        }
+        return ByteVector((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+    }
+
+    /**
+     * Reads the numbers of a pcap file, which are stored in the byte order of the
+     * machine that has written the file.
+     */
+    class PcapReader
+    {
+        public:
+            PcapReader(ByteVector const& buffer, bool isSwapped)
+                : m_buffer(buffer), m_isSwapped(isSwapped)
+            {}
+
+            unsigned long read32(std::size_t offset) const
+            {
+                unsigned long const b0 = m_buffer[offset + 0];
+                unsigned long const b1 = m_buffer[offset + 1];
+                unsigned long const b2 = m_buffer[offset + 2];
+                unsigned long const b3 = m_buffer[offset + 3];
+                return m_isSwapped
+                    ? (b0 << 24) | (b1 << 16) | (b2 << 8) | b3
+                    : (b3 << 24) | (b2 << 16) | (b1 << 8) | b0;
+            }
+
+        private:
+            ByteVector const& m_buffer;
+            bool const m_isSwapped;
+    };
+
+    /** Reads a big endian 16 bit number, as used by the network protocols. */
+    unsigned int readNetwork16(unsigned char const* data)
+    {
+        return (static_cast<unsigned int>(data[0]) << 8) | data[1];
+    }
+
+    /** Reads a big endian 32 bit number, as used by the network protocols. */
+    unsigned long readNetwork32(unsigned char const* data)
+    {
+        return (static_cast<unsigned long>(readNetwork16(data)) << 16) | readNetwork16(data + 2);
+    }
+
+    /**
+     * Formats an ip address and a port as text.
+     */
+    std::string formatEndpoint(unsigned char const* address, std::size_t addressSize, unsigned int port)
+    {
+        std::ostringstream stream;
+        if (addressSize == 4)
+        {
+            stream << int(address[0]) << "." << int(address[1]) << "." << int(address[2]) << "." << int(address[3]);
+        }
+        else
+        {
+            stream << "[" << std::hex;
+            for (std::size_t i = 0; i < addressSize; i += 2)
+            {
+                stream << (i > 0 ? ":" : "") << readNetwork16(address + i);
+            }
+            stream << std::dec << "]";
+        }
+        stream << ":" << port;
+        return stream.str();
+    }
+
+    /**
+     * Appends the payload of a tcp segment to its flow. Retransmitted data is dropped,
+     * missing data is counted as a gap, after which the s101 decoder has to wait for
+     * the start of the next frame.
+     */
+    void appendSegment(Flow& flow, unsigned long sequence, bool isSyn, unsigned char const* payload, std::size_t size)
+    {
+        if (isSyn)
+        {
+            flow.isStarted = true;
+            flow.nextSequence = (sequence + 1) & 0xFFFFFFFFUL;
+            return;
+        }
+
+        if (flow.isStarted == false)
+        {
+            flow.isStarted = true;
+            flow.nextSequence = sequence;
+        }
+
+        if (size == 0)
+        {
+            return;
+        }
+
+        unsigned long const distance = (sequence - flow.nextSequence) & 0xFFFFFFFFUL;
+        if (distance >= 0x80000000UL)
+        {
+            // The segment starts before the expected sequence number.
+            std::size_t const overlap = static_cast<std::size_t>((~distance + 1) & 0xFFFFFFFFUL);
+            if (overlap >= size)
+            {
+                return;
+            }
+
+            payload += overlap;
+            size -= overlap;
+        }
+        else if (distance > 0)
+        {
+            flow.gaps += 1;
+        }
+
+        flow.bytes.insert(flow.bytes.end(), payload, payload + size);
+        flow.nextSequence = (flow.nextSequence + (distance < 0x80000000UL ? distance : 0) + size) & 0xFFFFFFFFUL;
+    }
+
+    /**
+     * Extracts the tcp payload of all connections of a pcap capture.
+     * @return false if the buffer does not contain a pcap capture.
+     */
+    bool extractPcapFlows(ByteVector const& buffer, FlowCollection& flows)
+    {
+        if (buffer.size() < 24)
+        {
+            return false;
+        }
+
+        unsigned long const magic = PcapReader(buffer, false).read32(0);
+        bool isSwapped;
+        if (magic == 0xA1B2C3D4UL || magic == 0xA1B23C4DUL)
+        {
+            isSwapped = false;
+        }
+        else if (magic == 0xD4C3B2A1UL || magic == 0x4D3CB2A1UL)
+        {
+            isSwapped = true;
+        }
+        else
+        {
+            return false;
+        }
+
+        PcapReader const reader(buffer, isSwapped);
+        unsigned long const linkType = reader.read32(20);
+        std::map<std::string, std::size_t> flowIndex;
+
+        for (std::size_t offset = 24; offset + 16 <= buffer.size(); )
+        {
+            std::size_t const captured = reader.read32(offset + 8);
+            unsigned char const* packet = &buffer[offset + 16];
+            std::size_t size = std::min<std::size_t>(captured, buffer.size() - offset - 16);
+            offset += 16 + captured;
+
+            unsigned int etherType = 0;
+            switch (linkType)
+            {
+                case 0:     // BSD loopback, the address family is stored in host byte order
+                    if (size < 4)
+                        continue;
+                    etherType = (packet[0] == 2 || packet[3] == 2) ? 0x0800 : 0x86DD;
+                    packet += 4;
+                    size -= 4;
+                    break;
+
+                case 1:     // Ethernet
+                    if (size < 14)
+                        continue;
+                    etherType = readNetwork16(packet + 12);
+                    packet += 14;
+                    size -= 14;
+                    if (etherType == 0x8100 && size >= 4)
+                    {
+                        etherType = readNetwork16(packet + 2);
+                        packet += 4;
+                        size -= 4;
+                    }
+                    break;
+
+                case 101:   // Raw ip
+                    if (size < 1)
+                        continue;
+                    etherType = (packet[0] >> 4) == 4 ? 0x0800 : 0x86DD;
+                    break;
+
+                case 113:   // Linux cooked capture
+                    if (size < 16)
+                        continue;
+                    etherType = readNetwork16(packet + 14);
+                    packet += 16;
+                    size -= 16;
+                    break;
+
+                case 228:   // Raw IPv4
+                    etherType = 0x0800;
+                    break;
+
+                case 229:   // Raw IPv6
+                    etherType = 0x86DD;
+                    break;
+
+                default:
+                    THROW_TEST_EXCEPTION("Unsupported pcap link type " << linkType);
+            }
+
+            unsigned char const* source;
+            unsigned char const* destination;
+            std::size_t addressSize;
+            if (etherType == 0x0800)
+            {
+                if (size < 20 || (packet[0] >> 4) != 4 || packet[9] != 6)
+                    continue;
+
+                // Fragments are not reassembled.
+                if ((readNetwork16(packet + 6) & 0x3FFF) != 0)
+                    continue;
+
+                std::size_t const headerSize = (packet[0] & 0x0F) * 4;
+                std::size_t const totalSize = std::min<std::size_t>(readNetwork16(packet + 2), size);
+                if (headerSize < 20 || totalSize < headerSize)
+                    continue;
+
+                source = packet + 12;
+                destination = packet + 16;
+                addressSize = 4;
+                size = totalSize - headerSize;
+                packet += headerSize;
+            }
+            else if (etherType == 0x86DD)
+            {
+                // Extension headers are not supported.
+                if (size < 40 || packet[6] != 6)
+                    continue;
+
+                source = packet + 8;
+                destination = packet + 24;
+                addressSize = 16;
+                size = std::min<std::size_t>(readNetwork16(packet + 4), size - 40);
+                packet += 40;
+            }
+            else
+            {
+                continue;
+            }
+
+            if (size < 20)
+                continue;
+
+            std::size_t const tcpHeaderSize = (packet[12] >> 4) * 4;
+            if (tcpHeaderSize < 20 || tcpHeaderSize > size)
+                continue;
+
+            std::string const name = formatEndpoint(source, addressSize, readNetwork16(packet))
+                + " > "
+                + formatEndpoint(destination, addressSize, readNetwork16(packet + 2));
+
+            std::map<std::string, std::size_t>::const_iterator const existing = flowIndex.find(name);
+            std::size_t index;
+            if (existing == flowIndex.end())
+            {
+                index = flows.size();
+                flowIndex[name] = index;
+                flows.push_back(Flow());
+                flows.back().name = name;
+            }
+            else
+            {
+                index = existing->second;
+            }
+
+            bool const isSyn = (packet[13] & 0x02) != 0;
+            appendSegment(flows[index], readNetwork32(packet + 4), isSyn, packet + tcpHeaderSize, size - tcpHeaderSize);
+        }
+
+        // Connections that did not carry any payload, like the ones to other services, are dropped.
+        FlowCollection nonEmpty;
+        for (FlowCollection::const_iterator it = flows.begin(); it != flows.end(); ++it)
+        {
+            if (it->bytes.empty() == false)
+            {
+                nonEmpty.push_back(*it);
+            }
+        }
+        flows.swap(nonEmpty);
+        return true;
+    }
+
+    /**
+     * The number of messages and bytes of a single message type.
+     */
+    struct MessageStatistics
+    {
+        MessageStatistics()
+            : count(0), bytes(0)
+        {}
+
+        unsigned long count;
+        unsigned long bytes;
+    };
+
+    typedef std::map<std::string, MessageStatistics> StatisticsCollection;
+
+    /**
+     * Returns the name of a glow type.
+     */
+    std::string glowTypeName(libember::ber::Tag const& tag)
+    {
+        static char const* const names[] =
+        {
+            "", "Parameter", "Command", "Node", "ElementCollection", "StreamEntry", "StreamCollection",
+            "StringIntegerPair", "StringIntegerCollection", "QualifiedParameter", "QualifiedNode",
+            "RootElementCollection", "StreamDescriptor", "Matrix", "Target", "Source", "Connection",
+            "QualifiedMatrix", "Label", "Function", "QualifiedFunction", "TupleItemDescription",
+            "Invocation", "InvocationResult"
+        };
+
+        libember::ber::Tag::Number const number = tag.number();
+        if (tag.getClass() == libember::ber::Class::Application && number > 0 && number < sizeof(names) / sizeof(names[0]))
+        {
+            return names[number];
+        }
+
+        std::ostringstream stream;
+        stream << "Unknown(" << number << ")";
+        return stream.str();
+    }
+
+    /**
+     * Decodes the s101 frames and the glow trees of a single flow with libember.
+     */
+    class FlowDecoder : private libember::dom::AsyncDomReader
+    {
+        public:
+            FlowDecoder(StatisticsCollection& statistics)
+                : libember::dom::AsyncDomReader(libember::glow::GlowNodeFactory::getFactory())
+                , m_statistics(statistics)
+                , m_messageBytes(0)
+                , m_errors(0)
+            {}
+
+            /**
+             * Decodes the next bytes of the flow.
+             */
+            void decode(unsigned char const* first, unsigned char const* last)
+            {
+                m_decoder.read(first, last, &FlowDecoder::onFrame, this);
+            }
+
+            unsigned long errors() const
+            {
+                return m_errors;
+            }
+
+        private:
+            static void onFrame(S101Decoder::const_iterator first, S101Decoder::const_iterator last, FlowDecoder* state)
+            {
+                state->handleFrame(first, last);
+            }
+
+            void handleFrame(S101Decoder::const_iterator first, S101Decoder::const_iterator last)
+            {
+                std::size_t const size = std::distance(first, last);
+                if (libs101::KeepAlive::isRequest(first, last))
+                {
+                    count("s101 KeepAliveRequest", size);
+                    return;
+                }
+                else if (libs101::KeepAlive::isResponse(first, last))
+                {
+                    count("s101 KeepAliveResponse", size);
+                    return;
+                }
+
+                // Slot, message type, command, version, flags, dtd and the number of application bytes.
+                if (size < 7 || first[1] != libs101::MessageType::EmBER)
+                {
+                    count("s101 other", size);
+                    return;
+                }
+
+                unsigned int const command = first[2];
+                if (command != libs101::CommandType::EmBER)
+                {
+                    count(command == libs101::CommandType::ProviderState ? "s101 ProviderState" : "s101 other", size);
+                    return;
+                }
+
+                unsigned int const flags = first[4];
+                std::size_t const headerSize = 7 + first[6];
+                if (headerSize > size)
+                {
+                    count("s101 other", size);
+                    return;
+                }
+
+                count("s101 EmBER package", size);
+
+                if ((flags & libs101::PackageFlag::FirstPackage) != 0)
+                {
+                    reset();
+                    m_messageBytes = 0;
+                }
+
+                std::size_t const payloadSize = size - headerSize;
+                m_messageBytes += payloadSize;
+                try
+                {
+                    if (payloadSize > 0)
+                    {
+                        unsigned char const* const payload = &*(first + headerSize);
+                        read(payload, payload + payloadSize);
+                    }
+                }
+                catch (std::exception const&)
+                {
+                    m_errors += 1;
+                    reset();
+                }
+            }
+
+            virtual void rootReady(libember::dom::Node* node)
+            {
+                std::auto_ptr<libember::dom::Node> const root(detachRoot());
+                std::string const rootName = glowTypeName(node->typeTag());
+                count("glow " + rootName, m_messageBytes);
+
+                libember::dom::Container const* const container = dynamic_cast<libember::dom::Container const*>(node);
+                if (container != 0 && rootName != "StreamCollection")
+                {
+                    libember::dom::Container::const_iterator const last = container->end();
+                    for (libember::dom::Container::const_iterator it = container->begin(); it != last; ++it)
+                    {
+                        count("element " + glowTypeName(it->typeTag()), 0);
+                    }
+                }
+                else if (container != 0)
+                {
+                    m_statistics["element StreamEntry"].count += container->size();
+                }
+            }
+
+            void count(std::string const& type, std::size_t bytes)
+            {
+                MessageStatistics& statistics = m_statistics[type];
+                statistics.count += 1;
+                statistics.bytes += static_cast<unsigned long>(bytes);
+            }
+
+        private:
+            StatisticsCollection& m_statistics;
+            S101Decoder m_decoder;
+            std::size_t m_messageBytes;
+            unsigned long m_errors;
+    };
+
+    /**
+     * Statistics gathered by the libember_slim callbacks.
+     */
+    struct SlimStatistics
+    {
+        unsigned long nodes;
+        unsigned long parameters;
+        unsigned long commands;
+        unsigned long streamEntries;
+        unsigned long matrices;
+        unsigned long signals;
+        unsigned long connections;
+        unsigned long errors;
+    };
+
+    SlimStatistics slimStatistics;
+
+    void onSlimError(int, pcstr)
+    {
+        slimStatistics.errors += 1;
+    }
+
+    void onSlimAssertion(pcstr pFileName, int lineNumber)
+    {
+        std::cerr << "ERROR: libember_slim assertion failed in " << pFileName << " line " << lineNumber << std::endl;
+        std::exit(1);
+    }
+
+    void* allocateSlim(size_t size)
+    {
+        return allocation::Memory::allocate(size);
+    }
+
+    void releaseSlim(void* pointer)
+    {
+        allocation::Memory::release(pointer);
+    }
+
+    void onSlimNode(GlowNode const*, GlowFieldFlags, berint const*, int, voidptr)
+    {
+        slimStatistics.nodes += 1;
+    }
+
+    void onSlimParameter(GlowParameter const*, GlowFieldFlags, berint const*, int, voidptr)
+    {
+        slimStatistics.parameters += 1;
+    }
+
+    void onSlimCommand(GlowCommand const*, berint const*, int, voidptr)
+    {
+        slimStatistics.commands += 1;
+    }
+
+    void onSlimStreamEntry(GlowStreamEntry const*, voidptr)
+    {
+        slimStatistics.streamEntries += 1;
+    }
+
+    void onSlimMatrix(GlowMatrix const*, berint const*, int, voidptr)
+    {
+        slimStatistics.matrices += 1;
+    }
+
+    void onSlimSignal(GlowSignal const*, berint const*, int, voidptr)
+    {
+        slimStatistics.signals += 1;
+    }
+
+    void onSlimConnection(GlowConnection const*, berint const*, int, voidptr)
+    {
+        slimStatistics.connections += 1;
+    }
+
+    double elapsed(std::clock_t start)
+    {
+        return std::max((std::clock() - start) * 1.0 / CLOCKS_PER_SEC, 1e-6);
+    }
+
+    void printThroughput(std::size_t bytes, unsigned long messages, int repeat, double seconds)
+    {
+        std::cout << std::fixed << std::setprecision(3)
+                  << "    time:        " << seconds << " s" << std::endl
+                  << std::setprecision(1)
+                  << "    throughput:  " << (bytes * 1.0 * repeat / seconds / (1024.0 * 1024.0)) << " MB/s, "
+                  << (messages * 1.0 * repeat / seconds) << " messages/s" << std::endl;
+    }
+
+    /**
+     * Replays all flows through libember.
+     */
+    void replay(FlowCollection const& flows, std::size_t bytes, int repeat)
+    {
+        StatisticsCollection statistics;
+        std::size_t const baseline = allocation::Memory::liveBytes;
+        std::size_t retained = 0;
+        std::size_t peak = 0;
+        unsigned long errors = 0;
+        unsigned long const allocations = allocation::Memory::allocations;
+        std::clock_t const start = std::clock();
+
+        for (int pass = 0; pass < repeat; ++pass)
+        {
+            allocation::Memory::resetPeak();
+            std::vector<FlowDecoder*> decoders;
+            for (FlowCollection::const_iterator it = flows.begin(); it != flows.end(); ++it)
+            {
+                decoders.push_back(new FlowDecoder(statistics));
+            }
+
+            for (std::size_t i = 0; i < flows.size(); ++i)
+            {
+                ByteVector const& data = flows[i].bytes;
+                decoders[i]->decode(&data[0], &data[0] + data.size());
+            }
+
+            // The memory still held by the decoders once all traffic has been replayed.
+            retained = allocation::Memory::liveBytes - baseline;
+            peak = std::max(peak, allocation::Memory::peakBytes - baseline);
+
+            for (std::size_t i = 0; i < decoders.size(); ++i)
+            {
+                errors += decoders[i]->errors();
+                delete decoders[i];
+            }
+        }
+
+        double const seconds = elapsed(start);
+        unsigned long const allocated = allocation::Memory::allocations - allocations;
+
+        unsigned long messages = 0;
+        for (StatisticsCollection::const_iterator it = statistics.begin(); it != statistics.end(); ++it)
+        {
+            if (it->first.compare(0, 5, "glow ") == 0)
+            {
+                messages += it->second.count;
+            }
+        }
+        messages /= repeat;
+
+        std::cout << "  libember:" << std::endl;
+        printThroughput(bytes, messages, repeat, seconds);
+        std::cout << "    memory:      " << peak << " bytes peak, " << retained << " bytes retained after the replay, "
+                  << std::setprecision(1) << (messages > 0 ? allocated * 1.0 / (messages * repeat) : 0.0) << " allocations/message" << std::endl
+                  << "    errors:      " << errors / repeat << std::endl
+                  << "    messages:" << std::endl;
+
+        for (StatisticsCollection::const_iterator it = statistics.begin(); it != statistics.end(); ++it)
+        {
+            std::cout << "      " << std::left << std::setw(36) << it->first << std::right
+                      << std::setw(10) << it->second.count / repeat;
+            if (it->second.bytes > 0)
+            {
+                std::cout << std::setw(14) << it->second.bytes / repeat << " bytes";
+            }
+            std::cout << std::endl;
+        }
+    }
+
+    /**
+     * Replays all flows through the GlowReader of libember_slim.
+     */
+    void replaySlim(FlowCollection const& flows, std::size_t bytes, int repeat)
+    {
+        static byte rxBuffer[EMBER_MAXIMUM_PACKAGE_LENGTH];
+
+        std::memset(&slimStatistics, 0, sizeof(slimStatistics));
+        std::size_t const baseline = allocation::Memory::liveBytes;
+        allocation::Memory::resetPeak();
+
+        std::clock_t const start = std::clock();
+        for (int pass = 0; pass < repeat; ++pass)
+        {
+            for (FlowCollection::const_iterator it = flows.begin(); it != flows.end(); ++it)
+            {
+                GlowReader reader;
+                glowReader_init(&reader, onSlimNode, onSlimParameter, onSlimCommand, onSlimStreamEntry, 0, rxBuffer, sizeof(rxBuffer));
+                reader.base.onMatrix = onSlimMatrix;
+                reader.base.onTarget = onSlimSignal;
+                reader.base.onSource = onSlimSignal;
+                reader.base.onConnection = onSlimConnection;
+
+                // The reader takes the count of bytes as an int.
+                for (std::size_t offset = 0; offset < it->bytes.size(); offset += 0x10000)
+                {
+                    std::size_t const size = std::min<std::size_t>(0x10000, it->bytes.size() - offset);
+                    glowReader_readBytes(&reader, &it->bytes[offset], static_cast<int>(size));
+                }
+
+                glowReader_free(&reader);
+            }
+        }
+        double const seconds = elapsed(start);
+
+        unsigned long const elements = slimStatistics.nodes + slimStatistics.parameters + slimStatistics.commands
+            + slimStatistics.streamEntries + slimStatistics.matrices + slimStatistics.signals + slimStatistics.connections;
+
+        std::cout << "  libember_slim:" << std::endl;
+        std::cout << std::fixed << std::setprecision(3)
+                  << "    time:        " << seconds << " s" << std::endl
+                  << std::setprecision(1)
+                  << "    throughput:  " << (bytes * 1.0 * repeat / seconds / (1024.0 * 1024.0)) << " MB/s, "
+                  << (elements * 1.0 / seconds) << " elements/s" << std::endl
+                  << "    memory:      " << (allocation::Memory::peakBytes - baseline) << " bytes peak" << std::endl
+                  << "    errors:      " << slimStatistics.errors / repeat << std::endl
+                  << "    elements:    "
+                  << slimStatistics.nodes / repeat << " nodes, "
+                  << slimStatistics.parameters / repeat << " parameters, "
+                  << slimStatistics.commands / repeat << " commands, "
+                  << slimStatistics.streamEntries / repeat << " stream entries, "
+                  << slimStatistics.matrices / repeat << " matrices, "
+                  << slimStatistics.signals / repeat << " signals, "
+                  << slimStatistics.connections / repeat << " connections" << std::endl;
+    }
+
+    void printUsage()
+    {
+        std::cerr << "usage: tool-libember-s101replay [--repeat <count>] [--slim] <file>..." << std::endl
+                  << "  <file>     A pcap capture or a raw dump of an s101 byte stream." << std::endl
+                  << "  --repeat   Replays each file <count> times, 1 by default." << std::endl
+                  << "  --slim     Also replays each file through the GlowReader of libember_slim." << std::endl;
+    }
+}
+
+int main(int argc, char const* const* argv)
+{
+    try
+    {
+        std::vector<std::string> filenames;
+        int repeat = 1;
+        bool useSlim = false;
+
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string const argument = argv[i];
+            if (argument == "--repeat" && i + 1 < argc)
+            {
+                repeat = std::max(std::atoi(argv[++i]), 1);
+            }
+            else if (argument == "--slim")
+            {
+                useSlim = true;
+            }
+            else if (argument.compare(0, 2, "--") == 0)
+            {
+                printUsage();
+                return 1;
+            }
+            else
+            {
+                filenames.push_back(argument);
+            }
+        }
+
+        if (filenames.empty())
+        {
+            printUsage();
+            return 1;
+        }
+
+        ember_init(onSlimError, onSlimAssertion, allocateSlim, releaseSlim);
+
+        for (std::vector<std::string>::const_iterator it = filenames.begin(); it != filenames.end(); ++it)
+        {
+            FlowCollection flows;
+            {
+                ByteVector const buffer = load(*it);
+                if (extractPcapFlows(buffer, flows) == false)
+                {
+                    flows.push_back(Flow());
+                    flows.back().name = "raw s101 stream";
+                    flows.back().bytes = buffer;
+                }
+            }
+
+            std::size_t bytes = 0;
+            unsigned long gaps = 0;
+            for (FlowCollection::const_iterator flow = flows.begin(); flow != flows.end(); ++flow)
+            {
+                bytes += flow->bytes.size();
+                gaps += flow->gaps;
+            }
+
+            std::cout << *it << ": " << flows.size() << " flows, " << bytes << " bytes";
+            if (gaps > 0)
+            {
+                std::cout << ", " << gaps << " gaps in the captured tcp streams";
+            }
+            std::cout << std::endl;
+
+            if (bytes == 0)
+            {
+                continue;
+            }
+
+            replay(flows, bytes, repeat);
+
+            if (useSlim)
+            {
+                replaySlim(flows, bytes, repeat);
+            }
+        }
+    }
+    catch (std::exception const& e)
+    {
+        std::cerr << "ERROR: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
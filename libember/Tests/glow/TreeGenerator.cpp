@@ -0,0 +1,345 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "ember/Ember.hpp"
+#include "s101/CommandType.hpp"
+#include "s101/Dtd.hpp"
+#include "s101/MessageType.hpp"
+#include "s101/PackageFlag.hpp"
+#include "s101/StreamEncoder.hpp"
+#include "TreeGenerator.hpp"
+
+#define THROW_TEST_EXCEPTION(message)                       \
+            {                                               \
+                std::ostringstream msgStream;               \
+                msgStream << message ;                      \
+                throw std::runtime_error(msgStream.str());  \
+            }
+
+namespace
+{
+    typedef std::vector<unsigned char> ByteVector;
+
+    /**
+     * Enumeration of the supported output formats.
+     */
+    enum Format
+    {
+        /** The BER encoded glow message without framing. */
+        Ber,
+
+        /** The glow message framed into s101 EmBER packages, as sent by a provider. */
+        S101,
+
+        /** A TinyEmberPlus archive, which is unframed BER limited to the elements TinyEmberPlus supports. */
+        TinyEmber
+    };
+
+    /**
+     * The command line options of the tool.
+     */
+    struct Options
+    {
+        Options()
+            : format(Ber)
+        {}
+
+        generator::TreeShape shape;
+        Format format;
+        std::string output;
+        std::string streams;
+    };
+
+    void printUsage()
+    {
+        std::cout
+            << "Usage: tool-libember-treegen [options] --output <file>\n"
+            << "  --depth <n>               number of node levels below the root node (3)\n"
+            << "  --fan-out <n>             number of child nodes of each node (4)\n"
+            << "  --parameters <n>          number of parameters of each node (8)\n"
+            << "  --types <chars>           parameter types used in turn: i integer, r real,\n"
+            << "                            s string, b boolean, e enum, o octets, t trigger (irsbeot)\n"
+            << "  --stream-parameters <n>   number of stream parameters of each leaf node (0)\n"
+            << "  --streams-per-id <n>      number of stream parameters sharing an identifier (1)\n"
+            << "  --matrices <n>            number of matrices of the root node (1)\n"
+            << "  --targets <n>             number of targets of each matrix (16)\n"
+            << "  --sources <n>             number of sources of each matrix (16)\n"
+            << "  --matrix-type <type>      oneToN, oneToOne or nToN (nToN)\n"
+            << "  --linear                  use linear instead of non-linear addressing\n"
+            << "  --connects <n>            sources per target of an n:n matrix (2)\n"
+            << "  --no-labels               do not create label nodes\n"
+            << "  --no-matrix-parameters    do not create matrix parameters\n"
+            << "  --seed <n>                seed of the parameter values (1)\n"
+            << "  --format <format>         ber, s101 or tinyember (ber)\n"
+            << "  --output <file>           file to write the tree to\n"
+            << "  --streams <file>          file to write a stream collection to, in the same format\n";
+    }
+
+    int parseCount(char const* option, char const* value)
+    {
+        char* end = 0;
+        long const result = std::strtol(value, &end, 10);
+        if (*value == 0 || *end != 0 || result < 0)
+        {
+            THROW_TEST_EXCEPTION("Invalid value '" << value << "' for " << option);
+        }
+        return static_cast<int>(result);
+    }
+
+    /**
+     * Parses the command line.
+     * @return false if the usage has been requested, otherwise true.
+     */
+    bool parse(int argc, char const* const* argv, Options& options)
+    {
+        using namespace libember::glow;
+
+        generator::TreeShape& shape = options.shape;
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string const option = argv[i];
+            if (option == "--help" || option == "-h")
+            {
+                return false;
+            }
+            else if (option == "--linear")
+            {
+                shape.addressingMode = MatrixAddressingMode::Linear;
+                continue;
+            }
+            else if (option == "--no-labels")
+            {
+                shape.labels = false;
+                continue;
+            }
+            else if (option == "--no-matrix-parameters")
+            {
+                shape.matrixParameters = false;
+                continue;
+            }
+
+            if (i + 1 >= argc)
+            {
+                THROW_TEST_EXCEPTION("Unknown option or missing value: " << option);
+            }
+
+            char const* const value = argv[++i];
+            if (option == "--depth")
+                shape.depth = parseCount(argv[i - 1], value);
+            else if (option == "--fan-out")
+                shape.fanOut = parseCount(argv[i - 1], value);
+            else if (option == "--parameters")
+                shape.parametersPerNode = parseCount(argv[i - 1], value);
+            else if (option == "--types")
+                shape.parameterTypes = value;
+            else if (option == "--stream-parameters")
+                shape.streamParameters = parseCount(argv[i - 1], value);
+            else if (option == "--streams-per-id")
+                shape.streamsPerIdentifier = std::max(1, parseCount(argv[i - 1], value));
+            else if (option == "--matrices")
+                shape.matrices = parseCount(argv[i - 1], value);
+            else if (option == "--targets")
+                shape.targets = parseCount(argv[i - 1], value);
+            else if (option == "--sources")
+                shape.sources = parseCount(argv[i - 1], value);
+            else if (option == "--connects")
+                shape.connectsPerTarget = parseCount(argv[i - 1], value);
+            else if (option == "--seed")
+                shape.seed = static_cast<unsigned long>(parseCount(argv[i - 1], value));
+            else if (option == "--output")
+                options.output = value;
+            else if (option == "--streams")
+                options.streams = value;
+            else if (option == "--matrix-type")
+            {
+                std::string const type = value;
+                if (type == "oneToN")
+                    shape.matrixType = MatrixType::OneToN;
+                else if (type == "oneToOne")
+                    shape.matrixType = MatrixType::OneToOne;
+                else if (type == "nToN")
+                    shape.matrixType = MatrixType::NToN;
+                else
+                    THROW_TEST_EXCEPTION("Unknown matrix type: " << type);
+            }
+            else if (option == "--format")
+            {
+                std::string const format = value;
+                if (format == "ber")
+                    options.format = Ber;
+                else if (format == "s101")
+                    options.format = S101;
+                else if (format == "tinyember")
+                    options.format = TinyEmber;
+                else
+                    THROW_TEST_EXCEPTION("Unknown format: " << format);
+            }
+            else
+            {
+                THROW_TEST_EXCEPTION("Unknown option: " << option);
+            }
+        }
+
+        if (options.output.empty())
+        {
+            THROW_TEST_EXCEPTION("No output file specified");
+        }
+
+        if (options.format == TinyEmber)
+        {
+            if (shape.matrices > 0)
+            {
+                THROW_TEST_EXCEPTION("TinyEmberPlus archives cannot contain matrices, use --matrices 0");
+            }
+
+            if (shape.parameterTypes.find_first_not_of("irsbe") != std::string::npos)
+            {
+                THROW_TEST_EXCEPTION("TinyEmberPlus archives only support the parameter types irsbe");
+            }
+        }
+        return true;
+    }
+
+    /**
+     * Frames a glow message into s101 packages of at most 1000 payload bytes, so that
+     * the decoded packages including header and crc fit into the 1024 byte receive
+     * buffers of libember_slim.
+     */
+    ByteVector frame(ByteVector const& message)
+    {
+        unsigned short const version = libember::glow::GlowDtd::version();
+        std::size_t const packageSize = 1000;
+        ByteVector result;
+
+        std::size_t offset = 0;
+        do
+        {
+            std::size_t const size = std::min(packageSize, message.size() - offset);
+            unsigned char const flags = static_cast<unsigned char>(
+                    (offset == 0 ? libs101::PackageFlag::FirstPackage : 0) |
+                    (offset + size == message.size() ? libs101::PackageFlag::LastPackage : 0) |
+                    (size == 0 ? libs101::PackageFlag::EmptyPackage : 0)
+                );
+
+            libs101::StreamEncoder<unsigned char> encoder;
+            encoder.encode(0x00);                           // Slot
+            encoder.encode(libs101::MessageType::EmBER);    // Message type
+            encoder.encode(libs101::CommandType::EmBER);    // Ember Command
+            encoder.encode(0x01);                           // Version
+            encoder.encode(flags);                          // Flags
+            encoder.encode(libs101::Dtd::Glow);             // Glow Dtd
+            encoder.encode(0x02);                           // App bytes
+            encoder.encode(version & 0xFF);                 // Minor version
+            encoder.encode((version >> 8) & 0xFF);          // Major version
+            if (size > 0)
+            {
+                encoder.encode(&message[offset], &message[offset] + size);
+            }
+            encoder.finish();
+
+            result.insert(result.end(), encoder.begin(), encoder.end());
+            offset += size;
+        }
+        while (offset < message.size());
+
+        return result;
+    }
+
+    /**
+     * Encodes a node in the requested format and writes it to a file.
+     * @return The number of bytes written.
+     */
+    std::size_t write(libember::dom::Node const& node, Format format, std::string const& filename)
+    {
+        libember::util::OctetStream stream;
+        node.encode(stream);
+
+        ByteVector buffer(stream.begin(), stream.end());
+        if (format == S101)
+        {
+            buffer = frame(buffer);
+        }
+
+        std::ofstream file(filename.c_str(), std::ios::binary);
+        if (file.good() && buffer.empty() == false)
+        {
+            file.write(reinterpret_cast<char const*>(&buffer[0]), buffer.size());
+        }
+
+        if (file.good() == false)
+        {
+            THROW_TEST_EXCEPTION("Unable to write " << filename);
+        }
+        return buffer.size();
+    }
+}
+
+/**
+ * Generates a glow tree of the shape described by the command line options and
+ * writes it to a file. The file can be passed to benchmark-libember-codec,
+ * tool-libember-s101replay, or be loaded by TinyEmberPlus.
+ */
+int main(int argc, char const* const* argv)
+{
+    try
+    {
+        Options options;
+        if (parse(argc, argv, options) == false)
+        {
+            printUsage();
+            return 0;
+        }
+
+        generator::TreeGenerator treeGenerator(options.shape);
+        std::auto_ptr<libember::dom::Node> const tree(treeGenerator.createTree());
+        std::size_t const size = write(*tree, options.format, options.output);
+
+        generator::TreeStatistics const& statistics = treeGenerator.statistics();
+        std::cout << options.output << ": " << size << " bytes\n"
+                  << "    nodes              " << statistics.nodes << '\n'
+                  << "    parameters         " << statistics.parameters << '\n'
+                  << "    stream parameters  " << statistics.streamParameters << '\n'
+                  << "    stream identifiers " << statistics.streamIdentifiers << '\n'
+                  << "    matrices           " << statistics.matrices << '\n'
+                  << "    signals            " << statistics.signals << '\n'
+                  << "    connections        " << statistics.connections << std::endl;
+
+        if (options.streams.empty() == false)
+        {
+            std::auto_ptr<libember::dom::Node> const streams(treeGenerator.createStreams());
+            std::size_t const streamSize = write(*streams, options.format, options.streams);
+            std::cout << options.streams << ": " << streamSize << " bytes" << std::endl;
+        }
+    }
+    catch (std::exception const& e)
+    {
+        std::cerr << "ERROR: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,630 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef __LIBEMBER_TESTS_GLOW_TREEGENERATOR_HPP
+#define __LIBEMBER_TESTS_GLOW_TREEGENERATOR_HPP
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "ember/Ember.hpp"
+
+namespace generator
+{
+    /**
+     * Describes the shape of a generated tree. The default values create a small
+     * tree that contains each kind of element at least once.
+     */
+    struct TreeShape
+    {
+        /** Initializes a shape with the default values. */
+        TreeShape()
+            : depth(3)
+            , fanOut(4)
+            , parametersPerNode(8)
+            , parameterTypes("irsbeot")
+            , streamParameters(0)
+            , streamsPerIdentifier(1)
+            , matrices(1)
+            , targets(16)
+            , sources(16)
+            , matrixType(libember::glow::MatrixType::NToN)
+            , addressingMode(libember::glow::MatrixAddressingMode::NonLinear)
+            , connectsPerTarget(2)
+            , labels(true)
+            , matrixParameters(true)
+            , seed(1)
+        {}
+
+        /** The number of node levels below the root node. */
+        int depth;
+
+        /** The number of child nodes of each node above the last level. */
+        int fanOut;
+
+        /** The number of parameters of each node. */
+        int parametersPerNode;
+
+        /**
+         * The types of the parameters, one character per type, which are used in turn:
+         * 'i' integer, 'r' real, 's' string, 'b' boolean, 'e' enum, 'o' octets and
+         * 't' trigger.
+         */
+        std::string parameterTypes;
+
+        /**
+         * The number of integer or real parameters of each node on the last level that
+         * have a stream identifier. These parameters are created in addition to the
+         * parametersPerNode ones.
+         */
+        int streamParameters;
+
+        /**
+         * The number of stream parameters that share a stream identifier. If greater than
+         * one, the parameters also have a stream descriptor with their offset within the
+         * octet string of the shared stream.
+         */
+        int streamsPerIdentifier;
+
+        /** The number of matrices of the root node. */
+        int matrices;
+
+        /** The number of targets of each matrix. */
+        int targets;
+
+        /** The number of sources of each matrix. */
+        int sources;
+
+        /** The type of the matrices. */
+        libember::glow::MatrixType matrixType;
+
+        /**
+         * The addressing mode of the matrices. Non-linear matrices contain their targets
+         * and sources, which are numbered with odd numbers only.
+         */
+        libember::glow::MatrixAddressingMode addressingMode;
+
+        /** The number of sources connected to each target of an n:n matrix. */
+        int connectsPerTarget;
+
+        /** Whether each matrix has a label node with a string parameter per signal. */
+        bool labels;
+
+        /**
+         * Whether each matrix contains a gain parameter for each target, each source and
+         * each connection, located within the matrix.
+         */
+        bool matrixParameters;
+
+        /** The seed of the pseudo random values of the parameters. */
+        unsigned long seed;
+    };
+
+    /**
+     * The number of elements of each kind that have been created by a TreeGenerator.
+     */
+    struct TreeStatistics
+    {
+        /** Initializes all counts with zero. */
+        TreeStatistics()
+            : nodes(0)
+            , parameters(0)
+            , streamParameters(0)
+            , streamIdentifiers(0)
+            , matrices(0)
+            , signals(0)
+            , connections(0)
+        {}
+
+        /** The number of nodes, including the root node, the label nodes and the matrix parameter nodes. */
+        std::size_t nodes;
+
+        /** The number of parameters, including the stream parameters, labels and gains. */
+        std::size_t parameters;
+
+        /** The number of parameters with a stream identifier. */
+        std::size_t streamParameters;
+
+        /** The number of distinct stream identifiers. */
+        std::size_t streamIdentifiers;
+
+        /** The number of matrices. */
+        std::size_t matrices;
+
+        /** The number of targets and sources of all matrices. */
+        std::size_t signals;
+
+        /** The number of connections, one for each target of a matrix. */
+        std::size_t connections;
+    };
+
+    /**
+     * Creates glow trees of a configurable shape for scaling tests and benchmarks. The
+     * generated trees contain a single root node, so an unframed BER encoding of a tree
+     * that contains no matrices is also a valid TinyEmberPlus archive.
+     * Equal shapes always result in equal trees.
+     */
+    class TreeGenerator
+    {
+        public:
+            /**
+             * Initializes a new generator.
+             * @param shape The shape of the trees to generate.
+             */
+            explicit TreeGenerator(TreeShape const& shape)
+                : m_shape(shape)
+                , m_random(shape.seed)
+            {}
+
+            /**
+             * Creates a new tree.
+             * @return The root of the new tree, which must be deleted by the caller.
+             */
+            libember::glow::GlowRootElementCollection* createTree()
+            {
+                using namespace libember::glow;
+
+                m_random = m_shape.seed;
+                m_statistics = TreeStatistics();
+
+                GlowRootElementCollection* const root = GlowRootElementCollection::create();
+                GlowNode* const node = new GlowNode(root, 1);
+                node->setIdentifier("root");
+                node->setDescription("Generated tree");
+                m_statistics.nodes += 1;
+
+                Path path(1, 1);
+                int const number = createLevel(node, path, 0);
+
+                for (int i = 0; i < m_shape.matrices; ++i)
+                {
+                    createMatrix(node, path, number + 2 * i, i);
+                }
+                return root;
+            }
+
+            /**
+             * Creates a stream collection with one entry for each stream identifier of
+             * the last tree created by createTree. The entries of shared identifiers
+             * contain an octet string with a 32 bit value for each parameter, all other
+             * entries an integer.
+             * @return The new collection, which must be deleted by the caller.
+             */
+            libember::glow::GlowStreamCollection* createStreams()
+            {
+                libember::glow::GlowStreamCollection* const streams = libember::glow::GlowStreamCollection::create();
+                int const shared = m_shape.streamsPerIdentifier;
+                for (std::size_t i = 0; i < m_statistics.streamIdentifiers; ++i)
+                {
+                    int const identifier = static_cast<int>(i) + 1;
+                    if (shared > 1)
+                    {
+                        std::vector<unsigned char> octets(4 * shared);
+                        for (std::size_t j = 0; j < octets.size(); ++j)
+                        {
+                            octets[j] = static_cast<unsigned char>(next() & 0xFF);
+                        }
+                        streams->insert(identifier, octets.begin(), octets.end());
+                    }
+                    else
+                    {
+                        streams->insert(identifier, static_cast<int>(next() % 256) - 128);
+                    }
+                }
+                return streams;
+            }
+
+            /**
+             * Returns the number of elements created by the last call to createTree.
+             * @return The number of elements of the last tree.
+             */
+            TreeStatistics const& statistics() const
+            {
+                return m_statistics;
+            }
+
+        private:
+            typedef std::vector<int> Path;
+
+            /**
+             * Creates the parameters and the child nodes of a node.
+             * @param node The node to fill.
+             * @param path The path of the node.
+             * @param level The level of the node, where the root node is level 0.
+             * @return The number of the next unused child number of @p node.
+             */
+            int createLevel(libember::glow::GlowNode* node, Path& path, int level)
+            {
+                using namespace libember::glow;
+
+                int number = 1;
+                for (int i = 0; i < m_shape.parametersPerNode; ++i, ++number)
+                {
+                    createParameter(node, number, i);
+                }
+
+                if (level == m_shape.depth)
+                {
+                    for (int i = 0; i < m_shape.streamParameters; ++i, ++number)
+                    {
+                        createStreamParameter(node, number, i);
+                    }
+                    return number;
+                }
+
+                for (int i = 0; i < m_shape.fanOut; ++i, ++number)
+                {
+                    GlowNode* const child = new GlowNode(node, number);
+                    child->setIdentifier(indexed("node", i));
+                    child->setDescription(indexed("Node ", i));
+                    m_statistics.nodes += 1;
+
+                    path.push_back(number);
+                    createLevel(child, path, level + 1);
+                    path.pop_back();
+                }
+                return number;
+            }
+
+            /**
+             * Creates a parameter of the type selected by its index.
+             */
+            void createParameter(libember::glow::GlowNode* node, int number, int index)
+            {
+                using namespace libember;
+                using namespace libember::glow;
+
+                GlowParameter* const parameter = new GlowParameter(node, number);
+                parameter->setIdentifier(indexed("param", index));
+                parameter->setDescription(indexed("Parameter ", index));
+                parameter->setAccess(Access::ReadWrite);
+                m_statistics.parameters += 1;
+
+                std::string const& types = m_shape.parameterTypes;
+                char const type = types.empty() ? 'i' : types[index % types.size()];
+                switch (type)
+                {
+                    case 'r':
+                        parameter->setType(ParameterType::Real);
+                        parameter->setMinimum(-100.0);
+                        parameter->setMaximum(100.0);
+                        parameter->setValue((static_cast<int>(next() % 20001) - 10000) / 100.0);
+                        break;
+
+                    case 's':
+                        parameter->setType(ParameterType::String);
+                        parameter->setValue(indexed("value ", static_cast<int>(next() % 1000)));
+                        break;
+
+                    case 'b':
+                        parameter->setType(ParameterType::Boolean);
+                        parameter->setValue((next() & 1) != 0);
+                        break;
+
+                    case 'e':
+                        parameter->setType(ParameterType::Enum);
+                        parameter->setEnumeration("Off\nLow\nMedium\nHigh");
+                        parameter->setValue(static_cast<long>(next() % 4));
+                        break;
+
+                    case 'o':
+                        {
+                            unsigned char octets[16];
+                            for (std::size_t i = 0; i < sizeof(octets); ++i)
+                            {
+                                octets[i] = static_cast<unsigned char>(next() & 0xFF);
+                            }
+                            parameter->setType(ParameterType::Octets);
+                            parameter->setValue(ber::Octets(octets, octets + sizeof(octets)));
+                        }
+                        break;
+
+                    case 't':
+                        parameter->setType(ParameterType::Trigger);
+                        parameter->setAccess(Access::WriteOnly);
+                        break;
+
+                    default:
+                        parameter->setType(ParameterType::Integer);
+                        parameter->setMinimum(-4096L);
+                        parameter->setMaximum(4096L);
+                        parameter->setValue(static_cast<long>(next() % 8193) - 4096L);
+                        break;
+                }
+            }
+
+            /**
+             * Creates a parameter with a stream identifier, and a stream descriptor if several
+             * parameters share their identifier.
+             */
+            void createStreamParameter(libember::glow::GlowNode* node, int number, int index)
+            {
+                using namespace libember::glow;
+
+                GlowParameter* const parameter = new GlowParameter(node, number);
+                parameter->setIdentifier(indexed("stream", index));
+                parameter->setAccess(Access::ReadOnly);
+                m_statistics.parameters += 1;
+
+                int const shared = m_shape.streamsPerIdentifier > 1 ? m_shape.streamsPerIdentifier : 1;
+                int const position = static_cast<int>(m_statistics.streamParameters % shared);
+                if (position == 0)
+                {
+                    m_statistics.streamIdentifiers += 1;
+                }
+
+                parameter->setStreamIdentifier(static_cast<int>(m_statistics.streamIdentifiers));
+                if (shared > 1)
+                {
+                    parameter->setType(ParameterType::Real);
+                    parameter->setMinimum(-128.0);
+                    parameter->setMaximum(0.0);
+                    parameter->setValue(-128.0);
+                    parameter->setStreamDescriptor(StreamFormat::IeeeFloat32LittleEndian, 4 * position);
+                }
+                else
+                {
+                    parameter->setType(ParameterType::Integer);
+                    parameter->setMinimum(-128L);
+                    parameter->setMaximum(127L);
+                    parameter->setValue(0L);
+                }
+                m_statistics.streamParameters += 1;
+            }
+
+            /**
+             * Creates a matrix and, if labels are enabled, its label node.
+             * @param node The node that will contain the matrix and the label node.
+             * @param path The path of @p node.
+             * @param number The number of the matrix. The label node uses the next number.
+             * @param index The index of the matrix.
+             */
+            void createMatrix(libember::glow::GlowNode* node, Path const& path, int number, int index)
+            {
+                using namespace libember;
+                using namespace libember::glow;
+
+                int const targets = m_shape.targets;
+                int const sources = m_shape.sources;
+                bool const isLinear = m_shape.addressingMode.value() == MatrixAddressingMode::Linear;
+                bool const isNToN = m_shape.matrixType.value() == MatrixType::NToN;
+                int const connects = isNToN ? std::max(1, std::min(m_shape.connectsPerTarget, sources)) : 1;
+
+                GlowMatrix* const matrix = new GlowMatrix(node, number);
+                matrix->setIdentifier(indexed("matrix", index));
+                matrix->setDescription(indexed("Matrix ", index));
+                matrix->setType(m_shape.matrixType);
+                matrix->setAddressingMode(m_shape.addressingMode);
+                matrix->setTargetCount(targets);
+                matrix->setSourceCount(sources);
+                if (isNToN)
+                {
+                    matrix->setMaximumTotalConnects(targets * connects);
+                    matrix->setMaximumConnectsPerTarget(connects);
+                }
+                m_statistics.matrices += 1;
+                m_statistics.signals += targets + sources;
+
+                if (isLinear == false)
+                {
+                    dom::Sequence* const targetSequence = matrix->targets();
+                    for (int i = 0; i < targets; ++i)
+                    {
+                        targetSequence->insert(targetSequence->end(), new GlowTarget(signal(i)));
+                    }
+
+                    dom::Sequence* const sourceSequence = matrix->sources();
+                    for (int i = 0; i < sources; ++i)
+                    {
+                        sourceSequence->insert(sourceSequence->end(), new GlowSource(signal(i)));
+                    }
+                }
+
+                std::vector<int> connected(connects);
+                dom::Sequence* const connections = matrix->connections();
+                for (int i = 0; i < targets; ++i)
+                {
+                    connectedSources(i, connected);
+
+                    GlowConnection* const connection = new GlowConnection(signal(i));
+                    connection->setSources(ber::ObjectIdentifier(connected.begin(), connected.end()));
+                    connections->insert(connections->end(), connection);
+                    m_statistics.connections += 1;
+                }
+
+                if (m_shape.matrixParameters)
+                {
+                    int const subid = 1;
+                    matrix->setParametersLocation(subid);
+                    matrix->setGainParameterNumber(1);
+                    createMatrixParameters(matrix->children(), subid, connected);
+                }
+
+                if (m_shape.labels)
+                {
+                    Path labelsPath(path);
+                    labelsPath.push_back(number + 1);
+
+                    dom::Sequence* const labels = matrix->labels();
+                    labels->insert(labels->end(), new GlowLabel(ber::ObjectIdentifier(labelsPath.begin(), labelsPath.end()), "Primary"));
+
+                    GlowNode* const labelNode = new GlowNode(node, number + 1);
+                    labelNode->setIdentifier(indexed("labels", index));
+                    m_statistics.nodes += 1;
+
+                    createLabels(new GlowNode(labelNode, 1), "targets", "T", targets);
+                    createLabels(new GlowNode(labelNode, 2), "sources", "S", sources);
+                }
+            }
+
+            /**
+             * Creates the inline parameters of a matrix: a gain parameter for each target,
+             * each source and each connection.
+             * @param children The children of the matrix.
+             * @param subid The number of the parameters node within the matrix.
+             * @param connected A buffer for the sources connected to a target.
+             */
+            void createMatrixParameters(libember::glow::GlowElementCollection* children, int subid, std::vector<int>& connected)
+            {
+                using namespace libember::glow;
+
+                GlowNode* const parameters = new GlowNode(subid);
+                parameters->setIdentifier("parameters");
+                children->insert(children->end(), parameters);
+
+                GlowNode* const targets = new GlowNode(parameters, 1);
+                targets->setIdentifier("targets");
+                createGainNodes(targets, m_shape.targets);
+
+                GlowNode* const sources = new GlowNode(parameters, 2);
+                sources->setIdentifier("sources");
+                createGainNodes(sources, m_shape.sources);
+
+                GlowNode* const connections = new GlowNode(parameters, 3);
+                connections->setIdentifier("connections");
+                m_statistics.nodes += 4;
+
+                for (int i = 0; i < m_shape.targets; ++i)
+                {
+                    connectedSources(i, connected);
+
+                    GlowNode* const target = new GlowNode(connections, signal(i));
+                    target->setIdentifier(indexed("t", signal(i)));
+                    m_statistics.nodes += 1;
+
+                    for (std::vector<int>::const_iterator it = connected.begin(); it != connected.end(); ++it)
+                    {
+                        GlowNode* const source = new GlowNode(target, *it);
+                        source->setIdentifier(indexed("s", *it));
+                        m_statistics.nodes += 1;
+                        createGain(source);
+                    }
+                }
+            }
+
+            /**
+             * Creates a node containing a gain parameter for each of @p count signals.
+             */
+            void createGainNodes(libember::glow::GlowNode* parent, int count)
+            {
+                for (int i = 0; i < count; ++i)
+                {
+                    libember::glow::GlowNode* const node = new libember::glow::GlowNode(parent, signal(i));
+                    node->setIdentifier(indexed("signal", signal(i)));
+                    m_statistics.nodes += 1;
+                    createGain(node);
+                }
+            }
+
+            /**
+             * Creates the gain parameter with the number 1.
+             */
+            void createGain(libember::glow::GlowNode* node)
+            {
+                using namespace libember::glow;
+
+                GlowParameter* const gain = new GlowParameter(node, 1);
+                gain->setIdentifier("gain");
+                gain->setType(ParameterType::Real);
+                gain->setAccess(Access::ReadWrite);
+                gain->setMinimum(-128.0);
+                gain->setMaximum(15.0);
+                gain->setValue(0.0);
+                m_statistics.parameters += 1;
+            }
+
+            /**
+             * Fills a label node with a string parameter for each of @p count signals.
+             */
+            void createLabels(libember::glow::GlowNode* node, char const* identifier, char const* prefix, int count)
+            {
+                using namespace libember::glow;
+
+                node->setIdentifier(identifier);
+                m_statistics.nodes += 1;
+
+                for (int i = 0; i < count; ++i)
+                {
+                    GlowParameter* const label = new GlowParameter(node, signal(i));
+                    label->setIdentifier(indexed(prefix, signal(i)));
+                    label->setType(ParameterType::String);
+                    label->setAccess(Access::ReadWrite);
+                    label->setValue(indexed(prefix, signal(i)));
+                    m_statistics.parameters += 1;
+                }
+            }
+
+            /**
+             * Stores the numbers of the sources connected to a target in @p connected.
+             * @param target The index of the target.
+             * @param connected The buffer, whose size determines the number of sources.
+             */
+            void connectedSources(int target, std::vector<int>& connected) const
+            {
+                int const sources = std::max(m_shape.sources, 1);
+                if (m_shape.matrixType.value() == libember::glow::MatrixType::OneToOne)
+                {
+                    connected[0] = signal(target % sources);
+                    return;
+                }
+
+                for (std::size_t i = 0; i < connected.size(); ++i)
+                {
+                    connected[i] = signal(static_cast<int>((target * 7 + i) % sources));
+                }
+            }
+
+            /**
+             * Returns the number of the signal with the passed index.
+             */
+            int signal(int index) const
+            {
+                return m_shape.addressingMode.value() == libember::glow::MatrixAddressingMode::Linear
+                    ? index
+                    : 2 * index + 1;
+            }
+
+            /**
+             * Returns the next value of a linear congruential generator.
+             */
+            unsigned long next()
+            {
+                m_random = (m_random * 1103515245UL + 12345UL) & 0x7FFFFFFFUL;
+                return m_random >> 8;
+            }
+
+            /**
+             * Returns the concatenation of @p prefix and @p index.
+             */
+            static std::string indexed(char const* prefix, int index)
+            {
+                std::ostringstream stream;
+                stream << prefix << index;
+                return stream.str();
+            }
+
+        private:
+            TreeShape const m_shape;
+            unsigned long m_random;
+            TreeStatistics m_statistics;
+    };
+}
+
+#endif  // __LIBEMBER_TESTS_GLOW_TREEGENERATOR_HPP
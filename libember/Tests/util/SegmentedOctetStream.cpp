@@ -0,0 +1,141 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+#include "ember/Ember.hpp"
+#include "ember/util/SegmentedOctetStream.hpp"
+
+#define THROW_TEST_EXCEPTION(message)                       \
+            {                                               \
+                std::ostringstream msgStream;               \
+                msgStream << message ;                      \
+                throw std::runtime_error(msgStream.str());  \
+            }
+
+namespace
+{
+    typedef std::vector<unsigned char> ByteVector;
+    typedef libember::util::SegmentedOctetStream SegmentedOctetStream;
+
+    libember::glow::GlowRootElementCollection* createTree()
+    {
+        using namespace libember::glow;
+
+        GlowRootElementCollection* const root = GlowRootElementCollection::create();
+        GlowNode* const node = new GlowNode(root, 1);
+        node->setIdentifier("root");
+
+        for (int i = 1; i <= 200; ++i)
+        {
+            std::ostringstream identifier;
+            identifier << "parameter" << i;
+
+            GlowParameter* const parameter = new GlowParameter(node, i);
+            parameter->setIdentifier(identifier.str());
+            parameter->setValue(static_cast<long>(i * 1000));
+        }
+        return root;
+    }
+
+    ByteVector gather(SegmentedOctetStream::SegmentVector const& segments)
+    {
+        ByteVector result;
+        for (SegmentedOctetStream::SegmentVector::const_iterator it = segments.begin(); it != segments.end(); ++it)
+        {
+            result.insert(result.end(), it->data, it->data + it->size);
+        }
+        return result;
+    }
+
+    void testProvidedBuffers(libember::dom::Node const& tree, ByteVector const& expected)
+    {
+        std::size_t const headerSize = 9;
+        ByteVector first(64);
+        ByteVector second(1000);
+
+        SegmentedOctetStream stream(512);
+        stream.provide(&first[0], first.size());
+        stream.provide(&second[0], second.size());
+
+        unsigned char* const header = stream.reserveHeader(headerSize);
+        tree.encode(stream);
+
+        if (header != &first[0])
+        {
+            THROW_TEST_EXCEPTION("The header has not been reserved at the front of the first buffer");
+        }
+
+        SegmentedOctetStream::SegmentVector const& segments = stream.segments();
+        if (segments.size() < 3 || segments[0].data != &first[0] || segments[0].size != first.size() || segments[1].data != &second[0])
+        {
+            THROW_TEST_EXCEPTION("The provided buffers have not been filled in order");
+        }
+
+        ByteVector const result = gather(segments);
+        if (stream.size() != expected.size() + headerSize || result.size() != stream.size()
+        ||  std::equal(expected.begin(), expected.end(), result.begin() + headerSize) == false)
+        {
+            THROW_TEST_EXCEPTION("The segments do not contain the encoded tree");
+        }
+    }
+
+    void testHeaderAfterWrite()
+    {
+        SegmentedOctetStream stream;
+        stream.append(0x30);
+
+        try
+        {
+            stream.reserveHeader(4);
+        }
+        catch (std::runtime_error const&)
+        {
+            return;
+        }
+
+        THROW_TEST_EXCEPTION("Reserving a header after writing did not fail");
+    }
+}
+
+int main(int, char const* const*)
+{
+    try
+    {
+        std::auto_ptr<libember::dom::Node> const tree(createTree());
+
+        libember::util::OctetStream reference;
+        tree->encode(reference);
+
+        ByteVector expected(reference.size());
+        reference.copy(expected.begin());
+
+        testProvidedBuffers(*tree, expected);
+        testHeaderAfterWrite();
+    }
+    catch (std::exception const& e)
+    {
+        std::cerr << "ERROR: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -20,6 +20,7 @@
 #include <iostream>
 #include <sstream>
 #include <stdexcept>
+#include <vector>
 #include <ember/util/StreamBuffer.hpp>
 
 #define THROW_TEST_EXCEPTION(message)                       \
@@ -65,6 +66,17 @@ int main(int, char const* const*)
                 THROW_TEST_EXCEPTION("Invalid size of buffer! Expected " << ((i + 1) * 2) << ", found " << size);
             }
         }
+        {
+            std::vector<unsigned short> copy(testStream.size());
+            testStream.copy(copy.begin());
+            for (std::size_t i = 0; i < copy.size(); ++i)
+            {
+                if (copy[i] != 5000 + i)
+                {
+                    THROW_TEST_EXCEPTION("Invalid copy of buffer! Expected " << (5000 + i) << " at " << i << ", found " << copy[i]);
+                }
+            }
+        }
         for (unsigned int i = 0; i < 1000; ++i)
         {
             for (unsigned int j = 0; j < 2; ++j)
@@ -486,6 +486,62 @@ int ber_encodeReal(BerOutput *pOut, double value)
    return size;
 }
 
+// max encoded length: 11
+int ber_encodeFixedReal(BerOutput *pOut, berlong value, int fractionBits)
+{
+   int size = 0;
+   berlong exponent;
+   qword mantissa;
+   qword bits;
+   int exponentLength;
+   byte preamble;
+
+   if(value != 0)
+   {
+      preamble = 0x80;
+      exponent = -fractionBits;
+
+      if(value < 0)
+      {
+         preamble |= 0x40; // Sign
+         mantissa = 0 - (qword)value;
+      }
+      else
+      {
+         mantissa = (qword)value;
+      }
+
+      // normalize mantissa (required by CER and DER)
+      while((mantissa & 0xFF) == 0)
+      {
+         mantissa >>= 8;
+         exponent += 8;
+      }
+
+      while((mantissa & 0x01) == 0)
+      {
+         mantissa >>= 1;
+         exponent++;
+      }
+
+      // like ber_encodeReal, the exponent refers to
+      // the most significant bit of the mantissa
+      for(bits = mantissa >> 1; bits != 0; bits >>= 1)
+         exponent++;
+
+      exponentLength = ber_getLongLength(exponent);
+      preamble |= (byte)(exponentLength - 1);
+
+      pOut->writeByte(pOut, preamble);
+
+      size++;
+      size += ber_encodeLong(pOut, exponent, exponentLength);
+      size += ber_encodeLong(pOut, (berlong)mantissa, getLongLength((berlong)mantissa, false));
+   }
+
+   return size;
+}
+
 int ber_encodeString(BerOutput *pOut, pcstr pValue)
 {
    int length = ber_getStringLength(pValue);
@@ -775,6 +831,57 @@ double ber_decodeReal(BerInput *pIn, int length)
    return value;
 }
 
+berlong ber_decodeFixedReal(BerInput *pIn, int length, int fractionBits)
+{
+   const qword maxMagnitude = 0x7FFFFFFFFFFFFFFFULL;
+   byte preamble;
+   int exponentLength;
+   berlong exponent;
+   qword mantissa;
+   qword bits;
+
+   if(length == 0)
+      return 0;
+
+   preamble = pIn->readByte(pIn);
+
+   if(length == 1 && preamble == 0x40) // positive infinity
+      return (berlong)maxMagnitude;
+
+   if(length == 1 && preamble == 0x41) // negative infinity
+      return -(berlong)maxMagnitude;
+
+   exponentLength = 1 + (preamble & 3);
+   exponent = decodeLong(pIn, exponentLength, true);
+   mantissa = (qword)decodeLong(pIn, length - exponentLength - 1, false) << ((preamble >> 2) & 3);
+
+   // the exponent refers to the most significant bit of
+   // the mantissa, turn it into the shift of the integer
+   exponent += fractionBits;
+
+   for(bits = mantissa >> 1; bits != 0; bits >>= 1)
+      exponent--;
+
+   if(exponent >= 0)
+   {
+      if(mantissa != 0
+      && (exponent > 62 || mantissa > (maxMagnitude >> exponent)))
+         mantissa = maxMagnitude;
+      else
+         mantissa <<= exponent;
+   }
+   else
+   {
+      mantissa = exponent < -63
+                 ? 0
+                 : mantissa >> -exponent;
+   }
+
+   return (preamble & 0x40) != 0
+          ? -(berlong)mantissa
+          : (berlong)mantissa;
+}
+
 void ber_decodeString(BerInput *pIn, pstr pDest, int length)
 {
    ASSERT(pDest != NULL);
@@ -173,6 +173,19 @@ int ber_encodeLong(BerOutput *pOut, berlong value, int length);
   */
 int ber_encodeReal(BerOutput *pOut, double value);
 
+/**
+  * Encodes a fixed-point value to the passed output.
+  * The encoding is identical to the one produced by ber_encodeReal
+  * for the same number, but it is computed with integer operations
+  * only. Use this on targets without floating-point unit.
+  * @param pOut pointer to the output to encode to.
+  * @param value the fixed-point value to encode.
+  * @param fractionBits the number of fraction bits of @p value,
+  *     e.g. 16 if @p value holds the number multiplied by 65536.
+  * @return the number of bytes written to @p pOut.
+  */
+int ber_encodeFixedReal(BerOutput *pOut, berlong value, int fractionBits);
+
 /**
   * Encodes a zero-terminated string to the passed output.
   * @param pOut pointer to the output to encode to.
@@ -267,6 +280,21 @@ berlong ber_decodeLong(BerInput *pIn, int length);
   */
 double ber_decodeReal(BerInput *pIn, int length);
 
+/**
+  * Decodes a floating-point value from the passed input
+  * and returns it as a fixed-point value.
+  * The value is computed with integer operations only. Digits
+  * beyond @p fractionBits are truncated, values that do not fit
+  * into a berlong - including the infinities - are saturated.
+  * @param pIn pointer to the input to decode from.
+  * @param length the number of bytes that make up
+  *     the encoding.
+  * @param fractionBits the number of fraction bits of the
+  *     returned value.
+  * @return the decoded fixed-point value.
+  */
+berlong ber_decodeFixedReal(BerInput *pIn, int length, int fractionBits);
+
 /**
   * Decodes a character string from the passed input into
   * a zero-terminated character array.
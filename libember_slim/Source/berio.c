@@ -61,6 +61,18 @@ static byte berFileInput_readByte(BerInput *pBase)
    return 0xFF;
 }
 
+static byte berBufferedFileInput_readByte(BerInput *pBase)
+{
+   BerBufferedFileInput *pThis = (BerBufferedFileInput *)pBase;
+
+   if(berBufferedFileInput_isEof(pThis) == false)
+      return pThis->pBuffer[pThis->position++];
+   else
+      throwError(305, "BerBufferedFileInput EOF");
+
+   return 0xFF;
+}
+
 static void berMemoryOutput_writeBytes(BerOutput *pBase, const byte *pBytes, int count)
 {
    BerMemoryOutput *pThis = (BerMemoryOutput *)pBase;
@@ -100,6 +112,42 @@ static void berFileOutput_writeBytes(BerOutput *pBase, const byte *pBytes, int c
    fwrite(pBytes, 1, count, pThis->pFile);
 }
 
+static void berBufferedFileOutput_writeByte(BerOutput *pBase, byte b)
+{
+   BerBufferedFileOutput *pThis = (BerBufferedFileOutput *)pBase;
+
+   if(pThis->position >= pThis->size)
+      berBufferedFileOutput_flush(pThis);
+
+   pThis->pBuffer[pThis->position++] = b;
+}
+
+static void berBufferedFileOutput_writeBytes(BerOutput *pBase, const byte *pBytes, int count)
+{
+   BerBufferedFileOutput *pThis = (BerBufferedFileOutput *)pBase;
+   unsigned int ucount;
+
+   if(count > 0)
+   {
+      ucount = (unsigned int)count;
+
+      if(ucount > pThis->size - pThis->position)
+      {
+         berBufferedFileOutput_flush(pThis);
+
+         // blocks that don't fit into the buffer are not copied
+         if(ucount >= pThis->size)
+         {
+            fwrite(pBytes, 1, ucount, pThis->pFile);
+            return;
+         }
+      }
+
+      memcpy(pThis->pBuffer + pThis->position, pBytes, ucount);
+      pThis->position += ucount;
+   }
+}
+
 
 // ======================================================
 //
@@ -158,6 +206,34 @@ void berFileInput_init(BerFileInput *pThis, FILE *pFile)
    pThis->pFile = pFile;
 }
 
+void berBufferedFileInput_init(BerBufferedFileInput *pThis, FILE *pFile, byte *pBuffer, unsigned int size)
+{
+   ASSERT(pThis != NULL);
+   ASSERT(pBuffer != NULL);
+   ASSERT(size > 0);
+
+   // init methods
+   pThis->base.readByte = berBufferedFileInput_readByte;
+
+   // init data
+   pThis->pFile = pFile;
+   pThis->pBuffer = pBuffer;
+   pThis->size = size;
+   pThis->length = 0;
+   pThis->position = 0;
+}
+
+bool berBufferedFileInput_isEof(BerBufferedFileInput *pThis)
+{
+   if(pThis->position >= pThis->length)
+   {
+      pThis->length = (unsigned int)fread(pThis->pBuffer, 1, pThis->size, pThis->pFile);
+      pThis->position = 0;
+   }
+
+   return pThis->position >= pThis->length;
+}
+
 void berMemoryOutput_init(BerMemoryOutput *pThis, byte *pMemory, unsigned int size)
 {
    ASSERT(pThis != NULL);
@@ -190,3 +266,31 @@ void berFileOutput_init(BerFileOutput *pThis, FILE *pFile)
    // init data
    pThis->pFile = pFile;
 }
+
+void berBufferedFileOutput_init(BerBufferedFileOutput *pThis, FILE *pFile, byte *pBuffer, unsigned int size)
+{
+   ASSERT(pThis != NULL);
+   ASSERT(pBuffer != NULL);
+   ASSERT(size > 0);
+
+   // init methods
+   pThis->base.writeByte = berBufferedFileOutput_writeByte;
+   pThis->base.writeBytes = berBufferedFileOutput_writeBytes;
+
+   // init data
+   pThis->pFile = pFile;
+   pThis->pBuffer = pBuffer;
+   pThis->size = size;
+   pThis->position = 0;
+}
+
+void berBufferedFileOutput_flush(BerBufferedFileOutput *pThis)
+{
+   ASSERT(pThis != NULL);
+
+   if(pThis->position > 0)
+   {
+      fwrite(pThis->pBuffer, 1, pThis->position, pThis->pFile);
+      pThis->position = 0;
+   }
+}
@@ -136,6 +136,75 @@ typedef struct SBerFileInput
 void berFileInput_init(BerFileInput *pThis, FILE *pFile);
 
 
+// ======================================================
+//
+// BerBufferedFileInput
+//
+// ======================================================
+
+/**
+  * Aggregates BerInput to provide file decoding with large
+  * block reads. The bytes are read from the file into a
+  * buffer owned by the caller, so the file is accessed once
+  * per buffer instead of once per byte.
+  * The readByte function is initialized when calling
+  * berBufferedFileInput_init.
+  */
+typedef struct SBerBufferedFileInput
+{
+   /**
+     * Base input
+     */
+   BerInput base;
+
+   /**
+     * Pointer to the io buffer to read from.
+     */
+   FILE *pFile;
+
+   /**
+     * Address of the buffer the file is read into.
+     */
+   byte *pBuffer;
+
+   /**
+     * Number of bytes at the location pointed to by pBuffer.
+     */
+   unsigned int size;
+
+   /**
+     * Number of valid bytes in pBuffer.
+     */
+   unsigned int length;
+
+   /**
+     * Current position of the read cursor within pBuffer.
+     */
+   unsigned int position;
+} BerBufferedFileInput;
+
+/**
+  * Initializes a BerBufferedFileInput instance.
+  * Must be called before any other operations on the
+  * BerBufferedFileInput instance are invoked.
+  * @param pThis pointer to the object to process.
+  * @param pFile pointer to the io buffer to read from.
+  *     Must be open and readable.
+  * @param pBuffer pointer to the buffer to read the file into.
+  *     Must remain valid as long as @p pThis is in use.
+  * @param size number of bytes at @p pBuffer. Must not be 0.
+  */
+void berBufferedFileInput_init(BerBufferedFileInput *pThis, FILE *pFile, byte *pBuffer, unsigned int size);
+
+/**
+  * Returns a value indicating whether all bytes of the file
+  * have been read. Reads the next block of the file if the
+  * buffer has been consumed.
+  * @param pThis pointer to the object to process.
+  */
+bool berBufferedFileInput_isEof(BerBufferedFileInput *pThis);
+
+
 // ======================================================
 //
 // BerOutput
@@ -241,4 +310,63 @@ typedef struct SBerFileOutput
   */
 void berFileOutput_init(BerFileOutput *pThis, FILE *pFile);
 
+
+/**
+  * Aggregates BerOutput to provide encoding to a file with
+  * large block writes. The encoded bytes are collected in a
+  * buffer owned by the caller, which is written to the file
+  * when it is full or when berBufferedFileOutput_flush is called.
+  * Blocks larger than the buffer are written to the file directly.
+  * The writeByte and writeBytes functions are initialized when calling
+  * berBufferedFileOutput_init.
+  */
+typedef struct SBerBufferedFileOutput
+{
+   /**
+     * Base output.
+     */
+   BerOutput base;
+
+   /**
+     * Pointer to the io buffer to write to.
+     */
+   FILE *pFile;
+
+   /**
+     * Address of the buffer collecting the encoded bytes.
+     */
+   byte *pBuffer;
+
+   /**
+     * Number of bytes at the location pointed to by pBuffer.
+     */
+   unsigned int size;
+
+   /**
+     * Number of bytes in pBuffer that have not been written
+     * to the file yet.
+     */
+   unsigned int position;
+} BerBufferedFileOutput;
+
+/**
+  * Initializes a BerBufferedFileOutput instance.
+  * Must be called before any other operations on the
+  * BerBufferedFileOutput instance are invoked.
+  * @param pThis pointer to the object to process.
+  * @param pFile pointer to the io buffer to write to.
+  *     Must be open and writeable.
+  * @param pBuffer pointer to the buffer collecting the encoded bytes.
+  *     Must remain valid as long as @p pThis is in use.
+  * @param size number of bytes at @p pBuffer. Must not be 0.
+  */
+void berBufferedFileOutput_init(BerBufferedFileOutput *pThis, FILE *pFile, byte *pBuffer, unsigned int size);
+
+/**
+  * Writes all buffered bytes to the file. Must be called
+  * after the last byte has been encoded, before the file is closed.
+  * @param pThis pointer to the object to process.
+  */
+void berBufferedFileOutput_flush(BerBufferedFileOutput *pThis);
+
 #endif
@@ -35,7 +35,11 @@ void berReader_init(BerReader *pThis)
 
    bzero(*pThis);
 
+#ifdef EMBER_STATIC_MEMORY
+   byteBuffer_init(&pThis->buffer, pThis->valueBuffer, sizeof(pThis->valueBuffer));
+#else
    byteBuffer_initDynamic(&pThis->buffer, 0);
+#endif
 }
 
 void berReader_free(BerReader *pThis)
@@ -118,6 +122,20 @@ double berReader_getReal(const BerReader *pThis)
    return ber_decodeReal(&input.base, pThis->length);
 }
 
+berlong berReader_getFixedReal(const BerReader *pThis, int fractionBits)
+{
+   BerMemoryInput input;
+
+   if(pThis->isContainer)
+      throwError(204, "Invalid Real encoding");
+
+   ASSERT(pThis->type == BerType_Real || IsApplicationDefinedBerType(pThis->type));
+
+   berMemoryInput_init(&input, pThis->buffer.pMemory, pThis->length);
+
+   return ber_decodeFixedReal(&input.base, pThis->length, fractionBits);
+}
+
 void berReader_getString(const BerReader *pThis, pstr pDest, int size)
 {
    BerMemoryInput input;
@@ -24,6 +24,17 @@
 #include "bytebuffer.h"
 #include "bertag.h"
 
+#ifndef EMBER_MAX_VALUE_LENGTH
+/**
+  * The maximum length of a primitive value to decode when
+  * EMBER_STATIC_MEMORY is defined.
+  * Can be set using a compiler option. Default is 1024.
+  * If this value is exceeded during the decoding
+  * process, the throwError callback is called.
+  */
+#define EMBER_MAX_VALUE_LENGTH (1024)
+#endif
+
 /**
   * Defines a basic reader to decode in-memory ember TLTLVs.
   * When aggregated, the aggregating type must provide
@@ -61,6 +72,13 @@ typedef struct SBerReader
      * Buffer containing the encoded value of the current TLTLV.
      */
    ByteBuffer buffer;
+
+#ifdef EMBER_STATIC_MEMORY
+   /**
+     * private field
+     */
+   byte valueBuffer[EMBER_MAX_VALUE_LENGTH];
+#endif
 } BerReader;
 
 /**
@@ -117,6 +135,16 @@ berlong berReader_getLong(const BerReader *pThis);
   */
 double berReader_getReal(const BerReader *pThis);
 
+/**
+  * Gets the value of the current TLTLV as a fixed-point value.
+  * Expected type is BerType_Real.
+  * @param pThis pointer to the object to process.
+  * @param fractionBits the number of fraction bits of the
+  *     returned value.
+  * @return the decoded value.
+  */
+berlong berReader_getFixedReal(const BerReader *pThis, int fractionBits);
+
 /**
   * Gets the value of the current TLTLV as a zero-terminated utf-8 string.
   * Expected type is BerType_UTF8String.
@@ -167,6 +167,24 @@ void ember_writeReal(BerOutput *pOut, const BerTag *pTag, double value)
    pOut->writeBytes(pOut, out.pMemory, valueLength);
 }
 
+void ember_writeFixedReal(BerOutput *pOut, const BerTag *pTag, berlong value, int fractionBits)
+{
+   BerMemoryOutput out;
+   byte buffer[12];
+   int valueLength;
+
+   ASSERT(pOut != NULL);
+   ASSERT(pTag != NULL);
+
+   berMemoryOutput_init(&out, buffer, sizeof(buffer));
+
+   valueLength = ber_encodeFixedReal(&out.base, value, fractionBits);
+   writeOuterHeader(pOut, pTag, valueLength + 2);
+   writeTypeTag(pOut, BerType_Real, false);
+   ber_encodeLength(pOut, valueLength);
+   pOut->writeBytes(pOut, out.pMemory, valueLength);
+}
+
 void ember_writeString(BerOutput *pOut, const BerTag *pTag, pcstr pValue)
 {
    int valueLength;
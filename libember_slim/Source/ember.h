@@ -160,6 +160,17 @@ void ember_writeLong(BerOutput *pOut, const BerTag *pTag, berlong value);
   */
 void ember_writeReal(BerOutput *pOut, const BerTag *pTag, double value);
 
+/**
+  * Writes a TLTLV with a fixed-point value, using the definite
+  * length form for both Ls.
+  * The inner T is 'UNIVERSAL BerType_Real'.
+  * @param pOut pointer to the output to write to.
+  * @param pTag pointer to the outer tag of the TLTLV.
+  * @param value the fixed-point value to write.
+  * @param fractionBits the number of fraction bits of @p value.
+  */
+void ember_writeFixedReal(BerOutput *pOut, const BerTag *pTag, berlong value, int fractionBits);
+
 /**
   * Writes a TLTLV with a zero-terminated string value, using the definite
   * length form for both Ls.
@@ -51,8 +51,10 @@ static bool container_isEof(const __EmberAsyncContainer *pThis)
 //
 // ======================================================
 
-static void containerStack_init(__EmberAsyncContainerStack *pThis)
+static void containerStack_init(__EmberAsyncContainerStack *pThis, __EmberAsyncContainer *pItems, int capacity)
 {
+   pThis->pItems = pItems;
+   pThis->capacity = capacity;
    pThis->length = 0;
 }
 
@@ -60,9 +62,9 @@ static __EmberAsyncContainer *containerStack_push(__EmberAsyncContainerStack *pT
 {
    __EmberAsyncContainer *pItem;
 
-   if(pThis->length < EMBER_MAX_TREE_DEPTH)
+   if(pThis->length < pThis->capacity)
    {
-      pItem = &pThis->items[pThis->length];
+      pItem = &pThis->pItems[pThis->length];
       container_init(pItem, pTag, type, length);
       pThis->length++;
 
@@ -82,7 +84,7 @@ static __EmberAsyncContainer *containerStack_pop(__EmberAsyncContainerStack *pTh
    {
       pThis->length--;
 
-      return &pThis->items[pThis->length];
+      return &pThis->pItems[pThis->length];
    }
    else
    {
@@ -95,7 +97,7 @@ static __EmberAsyncContainer *containerStack_pop(__EmberAsyncContainerStack *pTh
 static __EmberAsyncContainer *containerStack_peek(__EmberAsyncContainerStack *pThis)
 {
    if(pThis->length > 0)
-      return &pThis->items[pThis->length - 1];
+      return &pThis->pItems[pThis->length - 1];
 
    return NULL;
 }
@@ -134,62 +136,116 @@ static void pushContainer(EmberAsyncReader *pThis)
 {
    BerReader *pBase = &pThis->base;
 
-   pThis->pCurrentContainer = containerStack_push(pThis->pContainerStack, &pBase->tag, pBase->type, pBase->length);
+   pThis->pCurrentContainer = containerStack_push(&pThis->containerStack, &pBase->tag, pBase->type, pBase->length);
 
    ASSERT(pThis->pCurrentContainer != NULL);
 }
 
-static bool readByte_Tag(EmberAsyncReader *pThis, byte b)
+static void decodeTag(EmberAsyncReader *pThis, const byte *pMemory, unsigned int size)
 {
-   BerReader *pBase;
+   BerReader *pBase = &pThis->base;
    BerMemoryInput input;
    BerTag typeTag;
 
-   if(b == 0 && pThis->bytesRead == 0)
+   berMemoryInput_init(&input, pMemory, size);
+
+   if(berTag_isZero(&pBase->tag))
    {
-      resetState(pThis, DecodeState_Terminator);
+      pBase->tag = ber_decodeTag(&input.base);
+
+      if(berTag_getClass(&pBase->tag) == BerClass_Universal)
+         throwError(107, "Universal outer tag encountered");
+
+      if(berTag_isContainer(&pBase->tag) == false)
+         throwError(108, "Primitive outer tag encountered");
+
+      berTag_setContainer(&pBase->tag, false);
+   }
+   else
+   {
+      typeTag = ber_decodeTag(&input.base);
+
+      pBase->isContainer = berTag_isContainer(&typeTag);
+      pBase->type = berTag_numberAsType(&typeTag);
+
+      if(IsApplicationDefinedBerType(pBase->type) == false)
+      {
+         if(berTag_getClass(&typeTag) != BerClass_Universal)
+            throwError(110, "Non-universal inner tag encountered");
+
+         if(pBase->type == 0 || pBase->type >= BerType_LastUniversal)
+            throwError(109, "Invalid BER type encountered");
+      }
+   }
+
+   resetState(pThis, DecodeState_Length);
+}
+
+static bool decodeLength(EmberAsyncReader *pThis, const byte *pMemory, unsigned int size)
+{
+   BerReader *pBase = &pThis->base;
+   BerMemoryInput input;
+   bool isEofOk;
+
+   berMemoryInput_init(&input, pMemory, size);
+
+   if(pBase->type == 0)
+   {
+      pBase->outerLength = ber_decodeLength(&input.base);
+
+      if(pBase->outerLength == 0)
+         throwError(102, "Zero outer length encountered");
+
+      resetState(pThis, DecodeState_Tag);
       return false;
    }
 
-   if(pThis->bytesRead > 6)
-      throwError(103, "Number of tag octets out of bounds");
+   pBase->length = ber_decodeLength(&input.base);
+   isEofOk = pBase->length == 0;
 
-   if((pThis->bytesRead == 0 && (b & 0x1F) != 0x1F)
-   || (pThis->bytesRead > 0 && (b & 0x80) == 0))
+   if(pBase->isContainer)
    {
-      pBase = &pThis->base;
-      berMemoryInput_init(&input, pBase->buffer.pMemory, (unsigned int)pBase->buffer.size);
+      resetState(pThis, DecodeState_Tag);
 
-      if(berTag_isZero(&pBase->tag))
-      {
-         pBase->tag = ber_decodeTag(&input.base);
+      if(pThis->onNewContainer != NULL)
+         pThis->onNewContainer(pBase);
 
-         if(berTag_getClass(&pBase->tag) == BerClass_Universal)
-            throwError(107, "Universal outer tag encountered");
+      pushContainer(pThis);
 
-         if(berTag_isContainer(&pBase->tag) == false)
-            throwError(108, "Primitive outer tag encountered");
+      disposeCurrentTlv(pThis);
+      return isEofOk;
+   }
 
-         berTag_setContainer(&pBase->tag, false);
-      }
-      else
-      {
-         typeTag = ber_decodeTag(&input.base);
+   if(pBase->length == 0)
+   {
+      onValueReady(pThis);
+   }
+   else
+   {
+      resetState(pThis, DecodeState_Value);
+   }
 
-         pBase->isContainer = berTag_isContainer(&typeTag);
-         pBase->type = berTag_numberAsType(&typeTag);
+   return isEofOk;
+}
 
-         if(IsApplicationDefinedBerType(pBase->type) == false)
-         {
-            if(berTag_getClass(&typeTag) != BerClass_Universal)
-               throwError(110, "Non-universal inner tag encountered");
+static bool readByte_Tag(EmberAsyncReader *pThis, byte b)
+{
+   BerReader *pBase;
 
-            if(pBase->type == 0 || pBase->type >= BerType_LastUniversal)
-               throwError(109, "Invalid BER type encountered");
-         }
-      }
+   if(b == 0 && pThis->bytesRead == 0)
+   {
+      resetState(pThis, DecodeState_Terminator);
+      return false;
+   }
+
+   if(pThis->bytesRead > 6)
+      throwError(103, "Number of tag octets out of bounds");
 
-      resetState(pThis, DecodeState_Length);
+   if((pThis->bytesRead == 0 && (b & 0x1F) != 0x1F)
+   || (pThis->bytesRead > 0 && (b & 0x80) == 0))
+   {
+      pBase = &pThis->base;
+      decodeTag(pThis, pBase->buffer.pMemory, (unsigned int)pBase->buffer.size);
       return false;
    }
 
@@ -200,8 +256,6 @@ static bool readByte_Tag(EmberAsyncReader *pThis, byte b)
 bool readByte_Length(EmberAsyncReader *pThis, byte b)
 {
    BerReader *pBase;
-   BerMemoryInput input;
-   bool isEofOk;
 
    if(pThis->bytesExpected == 0)
    {
@@ -219,46 +273,7 @@ bool readByte_Length(EmberAsyncReader *pThis, byte b)
    if(pThis->bytesRead == pThis->bytesExpected)
    {
       pBase = &pThis->base;
-      berMemoryInput_init(&input, pBase->buffer.pMemory, (unsigned int)pBase->buffer.size);
-
-      if(pBase->type == 0)
-      {
-         pBase->outerLength = ber_decodeLength(&input.base);
-
-         if(pBase->outerLength == 0)
-            throwError(102, "Zero outer length encountered");
-
-         resetState(pThis, DecodeState_Tag);
-      }
-      else
-      {
-         pBase->length = ber_decodeLength(&input.base);
-         isEofOk = pBase->length == 0;
-
-         if(pBase->isContainer)
-         {
-            resetState(pThis, DecodeState_Tag);
-
-            if(pThis->onNewContainer != NULL)
-               pThis->onNewContainer(pBase);
-
-            pushContainer(pThis);
-
-            disposeCurrentTlv(pThis);
-            return isEofOk;
-         }
-
-         if(pBase->length == 0)
-         {
-            onValueReady(pThis);
-         }
-         else
-         {
-            resetState(pThis, DecodeState_Value);
-         }
-
-         return isEofOk;
-      }
+      return decodeLength(pThis, pBase->buffer.pMemory, (unsigned int)pBase->buffer.size);
    }
 
    return false;
@@ -320,10 +335,10 @@ static bool endContainer(EmberAsyncReader *pThis)
    BerReader *pBase;
    __EmberAsyncContainer *pContainer;
 
-   if(pThis->pContainerStack->length != 0)
+   if(pThis->containerStack.length != 0)
    {
       pBase = &pThis->base;
-      pContainer = containerStack_pop(pThis->pContainerStack);
+      pContainer = containerStack_pop(&pThis->containerStack);
 
       ASSERT(pContainer != NULL);
       ASSERT(pContainer == pThis->pCurrentContainer);
@@ -336,9 +351,9 @@ static bool endContainer(EmberAsyncReader *pThis)
       if(pThis->onItemReady != NULL)
          pThis->onItemReady(pBase);
 
-      if(pThis->pContainerStack->length != 0)
+      if(pThis->containerStack.length != 0)
       {
-         pThis->pCurrentContainer = containerStack_peek(pThis->pContainerStack);
+         pThis->pCurrentContainer = containerStack_peek(&pThis->containerStack);
          pThis->pCurrentContainer->bytesRead += pBase->length;
       }
       else
@@ -355,6 +370,162 @@ static bool endContainer(EmberAsyncReader *pThis)
    return false;
 }
 
+static void endContainers(EmberAsyncReader *pThis, bool isEofOk)
+{
+   while(pThis->pCurrentContainer != NULL
+      && container_isEof(pThis->pCurrentContainer))
+   {
+      if(isEofOk == false)
+         throwError(106, "Unexpected end of container");
+
+      endContainer(pThis);
+   }
+}
+
+static int getBlockSize(const EmberAsyncReader *pThis, int count)
+{
+   const __EmberAsyncContainer *pContainer = pThis->pCurrentContainer;
+   int remaining;
+
+   // never read past the end of the current container, so that
+   // a malformed TLV is reported exactly like by the byte-wise path.
+   if(pContainer != NULL
+   && pContainer->length != BER_INDEFINITE_LENGTH)
+   {
+      remaining = pContainer->length - pContainer->bytesRead;
+
+      if(remaining < count)
+         return remaining > 0 ? remaining : 0;
+   }
+
+   return count;
+}
+
+static int readBlock_Tag(EmberAsyncReader *pThis, const byte *pBytes, int count)
+{
+   int size;
+
+   if(pThis->bytesRead != 0 || pBytes[0] == 0)
+      return 0;
+
+   if((pBytes[0] & 0x1F) == 0x1F)
+   {
+      for(size = 1; size < count && size < 7; size++)
+      {
+         if((pBytes[size] & 0x80) == 0)
+            break;
+      }
+
+      if(size == count || size == 7)
+         return 0;
+
+      size++;
+   }
+   else
+   {
+      size = 1;
+   }
+
+   if(pThis->pCurrentContainer != NULL)
+      pThis->pCurrentContainer->bytesRead += size;
+
+   decodeTag(pThis, pBytes, (unsigned int)size);
+   endContainers(pThis, false);
+   return size;
+}
+
+static int readBlock_Length(EmberAsyncReader *pThis, const byte *pBytes, int count)
+{
+   bool isEofOk;
+   int size;
+
+   if(pThis->bytesRead != 0)
+      return 0;
+
+   size = (pBytes[0] & 0x80) != 0
+          ? (pBytes[0] & 0x7F) + 1
+          : 1;
+
+   if(size > 5 || size > count)
+      return 0;
+
+   if(pThis->pCurrentContainer != NULL)
+      pThis->pCurrentContainer->bytesRead += size;
+
+   isEofOk = decodeLength(pThis, pBytes, (unsigned int)size);
+   endContainers(pThis, isEofOk);
+   return size;
+}
+
+static int readBlock_Value(EmberAsyncReader *pThis, const byte *pBytes, int count)
+{
+   BerReader *pBase = &pThis->base;
+   ByteBuffer *pBuffer = &pBase->buffer;
+   bool isEofOk = false;
+   int size;
+
+   // leave invalid lengths to the byte-wise path
+   if(pBase->length <= 0)
+      return 0;
+
+   if(pThis->bytesRead == 0)
+   {
+      pThis->bytesExpected = pBase->length;
+      byteBuffer_resize(pBuffer, pBase->length);
+   }
+
+   size = pThis->bytesExpected - pThis->bytesRead;
+
+   if(size > count)
+      size = count;
+
+   // let byteBuffer_add report the overrun of a static buffer
+   if(pBuffer->position + size > pBuffer->size)
+      return 0;
+
+   memcpy(pBuffer->pMemory + pBuffer->position, pBytes, size);
+   pBuffer->position += size;
+   pThis->bytesRead += size;
+
+   if(pThis->pCurrentContainer != NULL)
+      pThis->pCurrentContainer->bytesRead += size;
+
+   if(pThis->bytesRead == pThis->bytesExpected)
+   {
+      ASSERT(pThis->bytesRead == pBase->length);
+      ASSERT(pBuffer->position == (unsigned int)pThis->bytesRead);
+
+      onValueReady(pThis);
+      isEofOk = true;
+   }
+
+   endContainers(pThis, isEofOk);
+   return size;
+}
+
+static int readBlock(EmberAsyncReader *pThis, const byte *pBytes, int count)
+{
+   count = getBlockSize(pThis, count);
+
+   if(count <= 0)
+      return 0;
+
+   switch(pThis->decodeState)
+   {
+      case DecodeState_Tag:
+         return readBlock_Tag(pThis, pBytes, count);
+
+      case DecodeState_Length:
+         return readBlock_Length(pThis, pBytes, count);
+
+      case DecodeState_Value:
+         return readBlock_Value(pThis, pBytes, count);
+
+      default:
+         return 0;
+   }
+}
+
 
 // ======================================================
 //
@@ -372,26 +543,51 @@ void emberAsyncReader_init(EmberAsyncReader *pThis)
 
    resetState(pThis, DecodeState_Tag);
 
-   pThis->pContainerStack = newobj(__EmberAsyncContainerStack);
-   containerStack_init(pThis->pContainerStack);
+#ifdef EMBER_STATIC_MEMORY
+   containerStack_init(&pThis->containerStack, pThis->defaultStackItems, EMBER_MAX_TREE_DEPTH);
+#else
+   pThis->pDefaultStackItems = newarr(__EmberAsyncContainer, EMBER_MAX_TREE_DEPTH);
+   containerStack_init(&pThis->containerStack, pThis->pDefaultStackItems, EMBER_MAX_TREE_DEPTH);
+#endif
+}
+
+void emberAsyncReader_setStack(EmberAsyncReader *pThis, __EmberAsyncContainer *pItems, int capacity)
+{
+   ASSERT(pThis != NULL);
+   ASSERT(pItems != NULL);
+   ASSERT(capacity > 0);
+
+#ifndef EMBER_STATIC_MEMORY
+   if(pThis->pDefaultStackItems != NULL)
+   {
+      freeMemory(pThis->pDefaultStackItems);
+      pThis->pDefaultStackItems = NULL;
+   }
+#endif
+
+   resetState(pThis, DecodeState_Tag);
+   pThis->pCurrentContainer = NULL;
+   containerStack_init(&pThis->containerStack, pItems, capacity);
 }
 
 void emberAsyncReader_reset(EmberAsyncReader *pThis)
 {
    ASSERT(pThis != NULL);
-   ASSERT(pThis->pContainerStack != NULL);
+   ASSERT(pThis->containerStack.pItems != NULL);
 
    resetState(pThis, DecodeState_Tag);
    pThis->pCurrentContainer = NULL;
-   containerStack_init(pThis->pContainerStack);
+   pThis->containerStack.length = 0;
 }
 
 void emberAsyncReader_free(EmberAsyncReader *pThis)
 {
    ASSERT(pThis != NULL);
 
-   if(pThis->pContainerStack != NULL)
-      freeMemory(pThis->pContainerStack);
+#ifndef EMBER_STATIC_MEMORY
+   if(pThis->pDefaultStackItems != NULL)
+      freeMemory(pThis->pDefaultStackItems);
+#endif
 
    berReader_free(&pThis->base);
 
@@ -434,20 +630,28 @@ void emberAsyncReader_readByte(EmberAsyncReader *pThis, byte b)
          break;
    }
 
-   while(pThis->pCurrentContainer != NULL
-      && container_isEof(pThis->pCurrentContainer))
-   {
-      if(isEofOk == false)
-         throwError(106, "Unexpected end of container");
-
-      endContainer(pThis);
-   }
+   endContainers(pThis, isEofOk);
 }
 
 void emberAsyncReader_readBytes(EmberAsyncReader *pThis, const byte *pBytes, int count)
 {
+   int size;
+
    ASSERT(pThis != NULL);
 
-   for( ; count > 0; count--, pBytes++)
-      emberAsyncReader_readByte(pThis, *pBytes);
+   while(count > 0)
+   {
+      size = readBlock(pThis, pBytes, count);
+
+      // fall back to the byte-wise state machine for fields
+      // split across chunk boundaries, terminators and errors.
+      if(size == 0)
+      {
+         emberAsyncReader_readByte(pThis, *pBytes);
+         size = 1;
+      }
+
+      pBytes += size;
+      count -= size;
+   }
 }
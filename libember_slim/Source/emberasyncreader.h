@@ -46,7 +46,9 @@ typedef enum
 
 
 /**
-  * private type supporting EmberAsyncReader
+  * private type supporting EmberAsyncReader.
+  * Applications only allocate arrays of this type to pass
+  * them to emberAsyncReader_setStack.
   */
 typedef struct
 {
@@ -62,7 +64,8 @@ typedef struct
   */
 typedef struct
 {
-   __EmberAsyncContainer items[EMBER_MAX_TREE_DEPTH];
+   __EmberAsyncContainer *pItems;
+   int capacity;
    int length;
 } __EmberAsyncContainerStack;
 
@@ -90,7 +93,19 @@ typedef struct SEmberAsyncReader
    /**
      * private field
      */
-   __EmberAsyncContainerStack *pContainerStack;
+   __EmberAsyncContainerStack containerStack;
+
+#ifdef EMBER_STATIC_MEMORY
+   /**
+     * private field
+     */
+   __EmberAsyncContainer defaultStackItems[EMBER_MAX_TREE_DEPTH];
+#else
+   /**
+     * private field
+     */
+   __EmberAsyncContainer *pDefaultStackItems;
+#endif
 
    /**
      * private field
@@ -173,6 +188,20 @@ void emberAsyncReader_readByte(EmberAsyncReader *pThis, byte b);
   */
 void emberAsyncReader_readBytes(EmberAsyncReader *pThis, const byte *pBytes, int count);
 
+/**
+  * Replaces the container stack of the passed EmberAsyncReader
+  * with caller-provided storage, so that the maximum tree depth
+  * can be chosen at runtime instead of by EMBER_MAX_TREE_DEPTH.
+  * Resets the internal state of the reader. The default stack
+  * allocated by emberAsyncReader_init is released.
+  * @param pThis pointer to the object to process.
+  * @param pItems pointer to the stack storage. Must remain valid
+  *     until the reader is freed or another stack is set.
+  * @param capacity the number of items at @p pItems, which is the
+  *     maximum depth of an ember tree to decode.
+  */
+void emberAsyncReader_setStack(EmberAsyncReader *pThis, __EmberAsyncContainer *pItems, int capacity);
+
 /**
   * Resets the internal state of the passed EmberAsyncReader.
   * @param pThis pointer to the object to process.
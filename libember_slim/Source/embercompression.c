@@ -0,0 +1,307 @@
+/*
+   libember_slim -- ANSI C implementation of the Ember+ Protocol
+   Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <string.h>
+#include "embercompression.h"
+#include "emberinternal.h"
+
+
+// ======================================================
+//
+// Ember compression defines
+//
+// ======================================================
+
+/**
+  * The minimum length of a match.
+  */
+#define COMPRESSION_MIN_MATCH       (4)
+
+/**
+  * The number of bytes at the end of a block that are always literals.
+  */
+#define COMPRESSION_LAST_LITERALS   (5)
+
+/**
+  * The number of bytes at the end of a block where no match may start.
+  */
+#define COMPRESSION_MATCH_LIMIT     (12)
+
+/**
+  * The largest payload that can be compressed, so that every
+  * position fits into an entry of the hash table.
+  */
+#define COMPRESSION_MAX_LENGTH      (0xFFFF - EMBER_COMPRESSION_DICTIONARY_SIZE)
+
+
+// ======================================================
+//
+// Ember compression dictionary
+//
+// ======================================================
+
+const byte emberCompressionDictionary[EMBER_COMPRESSION_DICTIONARY_SIZE] =
+{
+   // Root, root element collection and element collection with
+   // indefinite lengths, as written by libember_slim.
+   0x60, 0x80, 0x6B, 0x80, 0xA0, 0x80, 0x64, 0x80, 0xA0, 0x80,
+   0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+
+   // Qualified node and qualified parameter with path and contents.
+   0x6A, 0x80, 0xA0, 0x80, 0x0D, 0x01, 0x01, 0x00, 0x00, 0xA1, 0x80, 0x31, 0x80,
+   0xA0, 0x80, 0x0C, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+   0x69, 0x80, 0xA0, 0x80, 0x0D, 0x02, 0x01, 0x01, 0x00, 0x00, 0xA1, 0x80, 0x31, 0x80,
+   0xA0, 0x80, 0x0C, 0x00, 0x00, 0xA1, 0x80, 0x0C, 0x00, 0x00,
+
+   // Parameter contents: value, minimum, maximum, access, type and
+   // enumeration.
+   0xA2, 0x80, 0x02, 0x01, 0x00, 0x00, 0x00, 0xA3, 0x80, 0x02, 0x01, 0x00, 0x00, 0x00,
+   0xA4, 0x80, 0x02, 0x01, 0x00, 0x00, 0x00, 0xA5, 0x80, 0x02, 0x01, 0x03, 0x00, 0x00,
+   0xAD, 0x80, 0x02, 0x01, 0x01, 0x00, 0x00, 0xA2, 0x80, 0x09, 0x00, 0x00, 0x00,
+   0xA7, 0x80, 0x0C, 0x00, 0x00, 0x00, 0xAD, 0x80, 0x02, 0x01, 0x04, 0x00, 0x00,
+
+   // Node and parameter with definite lengths, as written by libember.
+   0x63, 0x00, 0xA0, 0x03, 0x02, 0x01, 0x01, 0xA1, 0x00, 0x31, 0x00, 0xA0, 0x00, 0x0C,
+   0xA2, 0x00, 0x64, 0x00, 0xA0, 0x00, 0x61, 0x00, 0xA0, 0x03, 0x02, 0x01, 0x01,
+   0xA5, 0x03, 0x02, 0x01, 0x03, 0xAD, 0x03, 0x02, 0x01, 0x01, 0xA3, 0x04, 0x02, 0x02,
+   0xA4, 0x04, 0x02, 0x02, 0xA2, 0x03, 0x02, 0x01, 0x00, 0xA2, 0x03, 0x01, 0x01, 0xFF,
+
+   // Get directory command and stream entries.
+   0x62, 0x80, 0xA0, 0x03, 0x02, 0x01, 0x20, 0xA1, 0x03, 0x02, 0x01, 0xFF, 0x00, 0x00,
+   0x66, 0x80, 0xA0, 0x80, 0x65, 0x80, 0xA0, 0x03, 0x02, 0x01, 0x01, 0xA1, 0x80,
+   0x00, 0x00, 0x00, 0x00
+};
+
+
+// ======================================================
+//
+// Ember compression locals
+//
+// ======================================================
+
+// the dictionary and the payload form a single window, so that
+// matches may refer to the dictionary as if it had been part of
+// the payload.
+static byte getWindowByte(const byte *pSource, unsigned int position)
+{
+   return position < EMBER_COMPRESSION_DICTIONARY_SIZE
+          ? emberCompressionDictionary[position]
+          : pSource[position - EMBER_COMPRESSION_DICTIONARY_SIZE];
+}
+
+static unsigned int hashWindow(const byte *pSource, unsigned int position)
+{
+   unsigned long value = (unsigned long)getWindowByte(pSource, position)
+                       | ((unsigned long)getWindowByte(pSource, position + 1) << 8)
+                       | ((unsigned long)getWindowByte(pSource, position + 2) << 16)
+                       | ((unsigned long)getWindowByte(pSource, position + 3) << 24);
+
+   return (unsigned int)(((value * 2654435761UL) & 0xFFFFFFFFUL) >> (32 - EMBER_COMPRESSION_HASH_BITS));
+}
+
+static unsigned int writeLength(BerOutput *pOut, unsigned int length)
+{
+   unsigned int count = 1;
+
+   for( ; length >= 255; length -= 255, count++)
+      pOut->writeByte(pOut, 255);
+
+   pOut->writeByte(pOut, (byte)length);
+   return count;
+}
+
+static unsigned int writeLiterals(BerOutput *pOut, const byte *pSource, unsigned int anchor, unsigned int count, unsigned int matchLength)
+{
+   unsigned int matchCode = matchLength > 0 ? matchLength - COMPRESSION_MIN_MATCH : 0;
+   unsigned int written = 1;
+   byte token;
+
+   token = (byte)(((count < 15 ? count : 15) << 4) | (matchCode < 15 ? matchCode : 15));
+   pOut->writeByte(pOut, token);
+
+   if(count >= 15)
+      written += writeLength(pOut, count - 15);
+
+   if(count > 0)
+      pOut->writeBytes(pOut, pSource + (anchor - EMBER_COMPRESSION_DICTIONARY_SIZE), (int)count);
+
+   return written + count;
+}
+
+static bool readLength(const byte **ppSource, const byte *pEnd, unsigned int *pLength)
+{
+   byte b = 255;
+
+   while(b == 255)
+   {
+      if(*ppSource >= pEnd)
+         return false;
+
+      b = **ppSource;
+      (*ppSource)++;
+      *pLength += b;
+   }
+
+   return true;
+}
+
+
+// ======================================================
+//
+// Ember compression globals
+//
+// ======================================================
+
+unsigned int emberCompression_compress(const byte *pSource, unsigned int length, BerOutput *pOut)
+{
+   unsigned short table[1 << EMBER_COMPRESSION_HASH_BITS];
+   unsigned int start = EMBER_COMPRESSION_DICTIONARY_SIZE;
+   unsigned int end = start + length;
+   unsigned int position;
+   unsigned int anchor;
+   unsigned int candidate;
+   unsigned int matchLength;
+   unsigned int offset;
+   unsigned int key;
+   unsigned int written = 0;
+
+   ASSERT(pSource != NULL);
+   ASSERT(pOut != NULL);
+
+   if(length == 0 || length > COMPRESSION_MAX_LENGTH)
+      return 0;
+
+   // positions are stored incremented by one, so zero marks an empty entry.
+   memset(table, 0, sizeof(table));
+
+   for(position = 0; position + COMPRESSION_MIN_MATCH <= start; position++)
+      table[hashWindow(pSource, position)] = (unsigned short)(position + 1);
+
+   anchor = start;
+   position = start;
+
+   while(length > COMPRESSION_MATCH_LIMIT && position + COMPRESSION_MATCH_LIMIT <= end)
+   {
+      key = hashWindow(pSource, position);
+      candidate = table[key];
+      table[key] = (unsigned short)(position + 1);
+
+      if(candidate == 0)
+      {
+         position++;
+         continue;
+      }
+
+      candidate--;
+
+      for(matchLength = 0; matchLength < COMPRESSION_MIN_MATCH; matchLength++)
+      {
+         if(getWindowByte(pSource, candidate + matchLength) != getWindowByte(pSource, position + matchLength))
+            break;
+      }
+
+      if(matchLength < COMPRESSION_MIN_MATCH)
+      {
+         position++;
+         continue;
+      }
+
+      while(position + matchLength < end - COMPRESSION_LAST_LITERALS
+         && getWindowByte(pSource, candidate + matchLength) == getWindowByte(pSource, position + matchLength))
+         matchLength++;
+
+      written += writeLiterals(pOut, pSource, anchor, position - anchor, matchLength);
+
+      offset = position - candidate;
+      pOut->writeByte(pOut, (byte)((offset >> 0) & 0xFF));
+      pOut->writeByte(pOut, (byte)((offset >> 8) & 0xFF));
+      written += 2;
+
+      if(matchLength - COMPRESSION_MIN_MATCH >= 15)
+         written += writeLength(pOut, matchLength - COMPRESSION_MIN_MATCH - 15);
+
+      position += matchLength;
+      anchor = position;
+   }
+
+   written += writeLiterals(pOut, pSource, anchor, end - anchor, 0);
+   return written;
+}
+
+int emberCompression_decompress(const byte *pSource, unsigned int length, byte *pDest, unsigned int size)
+{
+   const byte *pEnd = pSource + length;
+   unsigned int position = 0;
+   unsigned int literalCount;
+   unsigned int matchLength;
+   unsigned int offset;
+   unsigned int index;
+   byte token;
+
+   ASSERT(pSource != NULL);
+   ASSERT(pDest != NULL);
+
+   while(pSource < pEnd)
+   {
+      token = *pSource++;
+
+      literalCount = token >> 4;
+      if(literalCount == 15 && readLength(&pSource, pEnd, &literalCount) == false)
+         return -1;
+
+      if(literalCount > (unsigned int)(pEnd - pSource) || literalCount > size - position)
+         return -1;
+
+      memcpy(pDest + position, pSource, literalCount);
+      pSource += literalCount;
+      position += literalCount;
+
+      // the last sequence of a block consists of literals only.
+      if(pSource >= pEnd)
+         break;
+
+      if(pEnd - pSource < 2)
+         return -1;
+
+      offset = pSource[0] | (pSource[1] << 8);
+      pSource += 2;
+
+      matchLength = token & 0x0F;
+      if(matchLength == 15 && readLength(&pSource, pEnd, &matchLength) == false)
+         return -1;
+
+      matchLength += COMPRESSION_MIN_MATCH;
+
+      if(offset == 0
+      || offset > position + EMBER_COMPRESSION_DICTIONARY_SIZE
+      || matchLength > size - position)
+         return -1;
+
+      // a match may overlap the bytes it produces, so it is
+      // copied byte by byte.
+      for(index = 0; index < matchLength; index++, position++)
+      {
+         pDest[position] = offset > position
+                           ? emberCompressionDictionary[EMBER_COMPRESSION_DICTIONARY_SIZE - (offset - position)]
+                           : pDest[position - offset];
+      }
+   }
+
+   return (int)position;
+}
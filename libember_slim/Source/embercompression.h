@@ -0,0 +1,88 @@
+/*
+   libember_slim -- ANSI C implementation of the Ember+ Protocol
+   Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef __LIBEMBER_SLIM_EMBERCOMPRESSION_H
+#define __LIBEMBER_SLIM_EMBERCOMPRESSION_H
+
+#include "berio.h"
+
+#ifndef EMBER_COMPRESSION_HASH_BITS
+/**
+  * The number of bits of the hash table used by
+  * emberCompression_compress to look up matches. The table
+  * takes 2 << EMBER_COMPRESSION_HASH_BITS bytes on the stack.
+  * Can be set using a compiler option. Default is 10.
+  */
+#define EMBER_COMPRESSION_HASH_BITS (10)
+#endif
+
+/**
+  * The number of bytes of the preset dictionary.
+  */
+#define EMBER_COMPRESSION_DICTIONARY_SIZE (204)
+
+
+// ======================================================
+//
+// Ember compression
+//
+// ======================================================
+
+/**
+  * The payload of a package flagged with EmberFramingFlag_Compressed
+  * is stored as an LZ4 block, which has been compressed with a preset
+  * dictionary containing the tags and length prefixes that are most
+  * common in glow trees. Each package is compressed on its own.
+  * A package may only be compressed if the remote host has announced
+  * EMBER_CAPABILITY_COMPRESSION.
+  */
+
+/**
+  * The preset dictionary.
+  */
+extern const byte emberCompressionDictionary[EMBER_COMPRESSION_DICTIONARY_SIZE];
+
+/**
+  * Compresses a package payload.
+  * @param pSource pointer to the first byte of the payload.
+  * @param length the number of bytes at @p pSource. Must not
+  *     exceed 65535 - EMBER_COMPRESSION_DICTIONARY_SIZE.
+  * @param pOut pointer to the output the compressed block is
+  *     written to.
+  * @return the number of bytes written to @p pOut, or 0 if @p length
+  *     is 0 or too big.
+  * @note the compressed block may be bigger than the payload. Write
+  *     to a BerFramingLengthOutput first to decide whether compressing
+  *     the payload is worth it.
+  */
+unsigned int emberCompression_compress(const byte *pSource, unsigned int length, BerOutput *pOut);
+
+/**
+  * Decompresses the payload of a compressed package.
+  * @param pSource pointer to the first byte of the compressed block.
+  * @param length the number of bytes at @p pSource.
+  * @param pDest pointer to the memory location to write the
+  *     payload to.
+  * @param size number of bytes at @p pDest.
+  * @return the number of bytes written to @p pDest, or -1 if the
+  *     block is malformed or the payload exceeds @p size.
+  */
+int emberCompression_decompress(const byte *pSource, unsigned int length, byte *pDest, unsigned int size);
+
+#endif
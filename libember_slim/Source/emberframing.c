@@ -19,6 +19,7 @@
 
 #include <string.h>
 #include "bytebuffer.h"
+#include "embercompression.h"
 #include "emberframing.h"
 #include "emberinternal.h"
 
@@ -113,6 +114,7 @@ static void writeEscapedByteWithCrc(BerFramingOutput *pThis, byte b)
    BerOutput *pBase = &pThis->base.base;
 
    pThis->crc = crc_addByte(pThis->crc, b);
+   pThis->bytesAfterFlags++;
 
    writeEscapedByte(pBase, b);
 }
@@ -125,9 +127,45 @@ static void berFramingOutput_writeByte(BerOutput *pBase, byte b)
 static void berFramingOutput_writeBytes(BerOutput *pBase, const byte *pBytes, int count)
 {
    BerFramingOutput *pThis = (BerFramingOutput *)pBase;
+   BerMemoryOutput *pOut = &pThis->base;
+   unsigned short crc;
+   byte *pCursor;
+   byte b;
 
-   for( ; count > 0; count--, pBytes++)
-      writeEscapedByteWithCrc(pThis, *pBytes);
+   if(count <= 0)
+      return;
+
+   // an escaped byte takes two bytes in the frame. if even the worst
+   // case fits, the bytes are escaped and checksummed straight into
+   // the package buffer without checking its bounds for every byte.
+   if(pOut->size - pOut->position >= (unsigned int)count * 2)
+   {
+      pThis->bytesAfterFlags += (unsigned int)count;
+      crc = pThis->crc;
+      pCursor = pOut->pMemory + pOut->position;
+
+      for( ; count > 0; count--, pBytes++)
+      {
+         b = *pBytes;
+         crc = crc_addByte(crc, b);
+
+         if(b >= S101_Invalid)
+         {
+            *pCursor++ = S101_CE;
+            b ^= S101_Xor;
+         }
+
+         *pCursor++ = b;
+      }
+
+      pThis->crc = crc;
+      pOut->position = (unsigned int)(pCursor - pOut->pMemory);
+   }
+   else
+   {
+      for( ; count > 0; count--, pBytes++)
+         writeEscapedByteWithCrc(pThis, *pBytes);
+   }
 }
 
 
@@ -176,11 +214,13 @@ void berFramingOutput_writeHeader(BerFramingOutput *pThis, EmberFramingFlags fla
    pThis->crc = 0xFFFF;
 
    berMemoryOutput_writeByte(pBase, S101_BOF);
-   writeEscapedByteWithCrc(pThis, 0x00);                  // slotid
+   writeEscapedByteWithCrc(pThis, pThis->slotId);         // slotid
    writeEscapedByteWithCrc(pThis, EMBER_MESSAGE_ID);      // message
    writeEscapedByteWithCrc(pThis, EMBER_COMMAND_PAYLOAD); // command
    writeEscapedByteWithCrc(pThis, 0x01);                  // framing version
    writeEscapedByteWithCrc(pThis, (byte)(flags & 0xFF));  // flags: first_package | last_package
+   pThis->flagsPosition = pThis->base.position - 1;
+   pThis->bytesAfterFlags = 0;
    writeEscapedByteWithCrc(pThis, pThis->dtd);            // dtd
 
    if(pThis->pAppBytes != NULL)
@@ -215,6 +255,65 @@ unsigned int berFramingOutput_finish(BerFramingOutput *pThis)
    return position;
 }
 
+void berFramingOutput_setFlags(BerFramingOutput *pThis, EmberFramingFlags flags)
+{
+   byte *pFlags;
+   unsigned short delta;
+   unsigned int index;
+
+   ASSERT(pThis != NULL);
+   ASSERT(pThis->flagsPosition > 0);
+   ASSERT((flags & 0xFF) < S101_Invalid);
+
+   pFlags = &pThis->base.pMemory[pThis->flagsPosition];
+
+   // the crc is linear, so replacing a byte changes it by the crc of
+   // the difference, followed by all bytes checksummed after it as zeros.
+   delta = crc_addByte(0, (byte)(*pFlags ^ (flags & 0xFF)));
+
+   for(index = 0; index < pThis->bytesAfterFlags; index++)
+      delta = crc_addByte(delta, 0);
+
+   pThis->crc ^= delta;
+   *pFlags = (byte)(flags & 0xFF);
+}
+
+
+// ======================================================
+//
+// BerFramingLengthOutput locals
+//
+// ======================================================
+
+static void berFramingLengthOutput_writeByte(BerOutput *pBase, byte b)
+{
+   BerFramingLengthOutput *pThis = (BerFramingLengthOutput *)pBase;
+
+   pThis->length += b >= S101_Invalid ? 2 : 1;
+}
+
+static void berFramingLengthOutput_writeBytes(BerOutput *pBase, const byte *pBytes, int count)
+{
+   for( ; count > 0; count--, pBytes++)
+      berFramingLengthOutput_writeByte(pBase, *pBytes);
+}
+
+
+// ======================================================
+//
+// BerFramingLengthOutput globals
+//
+// ======================================================
+
+void berFramingLengthOutput_init(BerFramingLengthOutput *pThis)
+{
+   ASSERT(pThis != NULL);
+
+   pThis->base.writeByte = berFramingLengthOutput_writeByte;
+   pThis->base.writeBytes = berFramingLengthOutput_writeBytes;
+   pThis->length = 0;
+}
+
 
 // ======================================================
 //
@@ -222,6 +321,27 @@ unsigned int berFramingOutput_finish(BerFramingOutput *pThis)
 //
 // ======================================================
 
+// Keep-alive messages carry no payload, so the frames of slot 0 are
+// constant and don't need to be escaped and checksummed at runtime.
+static const byte _keepAliveRequestFrame[] =
+{
+   S101_BOF, 0x00, EMBER_MESSAGE_ID, EMBER_COMMAND_KEEPALIVE_REQUEST, 0x01, 0x94, 0xE4, S101_EOF
+};
+
+static const byte _keepAliveResponseFrame[] =
+{
+   S101_BOF, 0x00, EMBER_MESSAGE_ID, EMBER_COMMAND_KEEPALIVE_RESPONSE, 0x01, S101_CE, 0xDC, 0xCE, S101_EOF
+};
+
+static unsigned int copyKeepAliveFrame(byte *pBuffer, unsigned int size, const byte *pFrame, unsigned int frameSize)
+{
+   if(size < frameSize)
+      return 0;
+
+   memcpy(pBuffer, pFrame, frameSize);
+   return frameSize;
+}
+
 static unsigned int writeKeepAlivePackage(BerFramingOutput *pOut, byte command)
 {
    berMemoryOutput_writeByte(&pOut->base.base, S101_BOF);
@@ -233,6 +353,42 @@ static unsigned int writeKeepAlivePackage(BerFramingOutput *pOut, byte command)
    return berFramingOutput_finish(pOut);
 }
 
+static unsigned int unframePackage(const byte *pPackage, unsigned int length, byte *pDest, unsigned int size)
+{
+   unsigned int index;
+   unsigned int position = 0;
+   bool isEscaped = false;
+   byte b;
+
+   if(length < 2 || pPackage[0] != S101_BOF || pPackage[length - 1] != S101_EOF)
+      return 0;
+
+   for(index = 1; index < length - 1; index++)
+   {
+      b = pPackage[index];
+
+      if(b == S101_CE)
+      {
+         isEscaped = true;
+         continue;
+      }
+
+      if(isEscaped)
+      {
+         isEscaped = false;
+         b ^= S101_Xor;
+      }
+
+      if(position >= size)
+         return 0;
+
+      pDest[position++] = b;
+   }
+
+   // the crc is not part of the unframed package.
+   return position >= 2 ? position - 2 : 0;
+}
+
 
 // ======================================================
 //
@@ -243,6 +399,10 @@ static unsigned int writeKeepAlivePackage(BerFramingOutput *pOut, byte command)
 unsigned int emberFraming_writeKeepAliveRequest(byte *pBuffer, unsigned int size, byte slotId)
 {
    BerFramingOutput output;
+
+   if(slotId == 0)
+      return copyKeepAliveFrame(pBuffer, size, _keepAliveRequestFrame, sizeof(_keepAliveRequestFrame));
+
    berFramingOutput_init(&output, pBuffer, size, slotId, 0, NULL, 0);
 
    return writeKeepAlivePackage(&output, EMBER_COMMAND_KEEPALIVE_REQUEST);
@@ -251,11 +411,94 @@ unsigned int emberFraming_writeKeepAliveRequest(byte *pBuffer, unsigned int size
 unsigned int emberFraming_writeKeepAliveResponse(byte *pBuffer, unsigned int size, byte slotId)
 {
    BerFramingOutput output;
+
+   if(slotId == 0)
+      return copyKeepAliveFrame(pBuffer, size, _keepAliveResponseFrame, sizeof(_keepAliveResponseFrame));
+
    berFramingOutput_init(&output, pBuffer, size, slotId, 0, NULL, 0);
 
    return writeKeepAlivePackage(&output, EMBER_COMMAND_KEEPALIVE_RESPONSE);
 }
 
+unsigned int emberFraming_writeCapabilities(byte *pBuffer, unsigned int size, byte slotId, byte capabilities)
+{
+   BerFramingOutput output;
+
+   berFramingOutput_init(&output, pBuffer, size, slotId, 0, NULL, 0);
+
+   berMemoryOutput_writeByte(&output.base.base, S101_BOF);
+   writeEscapedByteWithCrc(&output, slotId);
+   writeEscapedByteWithCrc(&output, EMBER_MESSAGE_ID);           // message
+   writeEscapedByteWithCrc(&output, EMBER_COMMAND_CAPABILITIES); // command
+   writeEscapedByteWithCrc(&output, 0x01);                       // framing version
+   writeEscapedByteWithCrc(&output, capabilities);
+
+   return berFramingOutput_finish(&output);
+}
+
+byte emberFraming_readCapabilities(const byte *pPackage, int length)
+{
+   ASSERT(pPackage != NULL);
+
+   if(length >= 5
+   && pPackage[1] == EMBER_MESSAGE_ID
+   && pPackage[2] == EMBER_COMMAND_CAPABILITIES)
+      return pPackage[4];
+
+   return 0;
+}
+
+unsigned int emberFraming_compressPackage(byte *pPackage,
+                                          unsigned int length,
+                                          unsigned int size,
+                                          byte *pScratch,
+                                          unsigned int scratchSize)
+{
+   BerFramingOutput output;
+   BerFramingLengthOutput lengthOutput;
+   unsigned int unframedLength;
+   unsigned int headerLength;
+   unsigned int payloadLength;
+   byte flags;
+
+   ASSERT(pPackage != NULL);
+   ASSERT(pScratch != NULL);
+
+   unframedLength = unframePackage(pPackage, length, pScratch, scratchSize);
+
+   if(unframedLength < 7
+   || pScratch[1] != EMBER_MESSAGE_ID
+   || pScratch[2] != EMBER_COMMAND_PAYLOAD)
+      return length;
+
+   flags = pScratch[4];
+   headerLength = 7 + pScratch[6];
+
+   if((flags & (EmberFramingFlag_Compressed | EmberFramingFlag_EmptyPackage)) != 0
+   || headerLength >= unframedLength)
+      return length;
+
+   payloadLength = unframedLength - headerLength;
+
+   // the compressor runs twice, so that the package isn't touched
+   // unless the compressed package is smaller and fits into the buffer.
+   // the flags stay below S101_Invalid, so the header is escaped the
+   // same way, and the crc takes up to four bytes.
+   berFramingLengthOutput_init(&lengthOutput);
+   lengthOutput.base.writeBytes(&lengthOutput.base, pScratch, (int)headerLength);
+
+   if(emberCompression_compress(pScratch + headerLength, payloadLength, &lengthOutput.base) >= payloadLength
+   || 1 + lengthOutput.length + 4 + 1 >= length
+   || 1 + lengthOutput.length + 4 + 1 > size)
+      return length;
+
+   berFramingOutput_init(&output, pPackage, size, pScratch[0], pScratch[5], pScratch + 7, pScratch[6]);
+   berFramingOutput_writeHeader(&output, (EmberFramingFlags)(flags | EmberFramingFlag_Compressed));
+   emberCompression_compress(pScratch + headerLength, payloadLength, &output.base.base);
+
+   return berFramingOutput_finish(&output);
+}
+
 
 // ======================================================
 //
@@ -263,6 +506,107 @@ unsigned int emberFraming_writeKeepAliveResponse(byte *pBuffer, unsigned int siz
 //
 // ======================================================
 
+#define STREAM_STAGED      (0)
+#define STREAM_UNDECIDED   (1)
+#define STREAM_STREAMING   (2)
+
+static void beginFrame(EmberFramingReader *pThis)
+{
+   ByteBuffer *pBuffer = &pThis->buffer;
+
+   byteBuffer_reset(pBuffer);
+   byteBuffer_add(pBuffer, S101_BOF);
+   pThis->isEscaped = false;
+   pThis->crc = 0xFFFF;
+   pThis->pendingCount = 0;
+   pThis->streamState = pThis->onPayloadReceived != NULL
+                        ? STREAM_UNDECIDED
+                        : STREAM_STAGED;
+}
+
+static void finishStream(EmberFramingReader *pThis, bool isValid)
+{
+   // while streaming, the buffer holds nothing but the header.
+   if(pThis->streamState == STREAM_STREAMING)
+   {
+      pThis->streamState = STREAM_STAGED;
+      pThis->onPayloadFinished(pThis->buffer.pMemory + 1, isValid, pThis->state);
+   }
+}
+
+static void decideStreaming(EmberFramingReader *pThis)
+{
+   const byte *pHeader = pThis->buffer.pMemory + 1;
+   unsigned int length = pThis->buffer.position - 1;
+
+   // only uncompressed ember payloads are streamed. everything
+   // else is either short or has to be staged for inflating.
+   if(length == 3
+   && (pHeader[1] != EMBER_MESSAGE_ID || pHeader[2] != EMBER_COMMAND_PAYLOAD))
+   {
+      pThis->streamState = STREAM_STAGED;
+   }
+   else if(length == 5
+        && (pHeader[4] & EmberFramingFlag_Compressed) != 0)
+   {
+      pThis->streamState = STREAM_STAGED;
+   }
+   else if(length >= 7
+        && length == 7u + pHeader[6])
+   {
+      pThis->streamState = STREAM_STREAMING;
+      pThis->onPayloadReceived(pHeader, NULL, 0, pThis->state);
+   }
+}
+
+static void streamPayloadBytes(EmberFramingReader *pThis, const byte *pBytes, int count)
+{
+   const byte *pHeader = pThis->buffer.pMemory + 1;
+
+   // the last two bytes of a frame are the crc, so the two most
+   // recent bytes are held back until more bytes follow.
+   if(count >= 2)
+   {
+      if(pThis->pendingCount > 0)
+         pThis->onPayloadReceived(pHeader, pThis->pending, pThis->pendingCount, pThis->state);
+
+      if(count > 2)
+         pThis->onPayloadReceived(pHeader, pBytes, count - 2, pThis->state);
+
+      pThis->pending[0] = pBytes[count - 2];
+      pThis->pending[1] = pBytes[count - 1];
+      pThis->pendingCount = 2;
+   }
+   else if(count == 1)
+   {
+      if(pThis->pendingCount == 2)
+      {
+         pThis->onPayloadReceived(pHeader, pThis->pending, 1, pThis->state);
+         pThis->pending[0] = pThis->pending[1];
+         pThis->pendingCount = 1;
+      }
+
+      pThis->pending[pThis->pendingCount++] = pBytes[0];
+   }
+}
+
+static void addUnescapedByte(EmberFramingReader *pThis, byte b)
+{
+   pThis->crc = crc_addByte(pThis->crc, b);
+
+   if(pThis->streamState == STREAM_STREAMING)
+   {
+      streamPayloadBytes(pThis, &b, 1);
+   }
+   else
+   {
+      byteBuffer_add(&pThis->buffer, b);
+
+      if(pThis->streamState == STREAM_UNDECIDED)
+         decideStreaming(pThis);
+   }
+}
+
 static void readFramedByte(EmberFramingReader *pThis, byte b)
 {
    ByteBuffer *pBuffer = &pThis->buffer;
@@ -270,28 +614,25 @@ static void readFramedByte(EmberFramingReader *pThis, byte b)
    if(byteBuffer_isEmpty(pBuffer))
    {
       if(b == S101_BOF)
-      {
-         byteBuffer_reset(pBuffer);
-         byteBuffer_add(pBuffer, S101_BOF);
-         pThis->isEscaped = false;
-         pThis->crc = 0xFFFF;
-      }
+         beginFrame(pThis);
 
       return;
    }
 
    if(b == S101_BOF)
    {
-      byteBuffer_reset(pBuffer);
-      byteBuffer_add(pBuffer, S101_BOF);
-      pThis->isEscaped = false;
-      pThis->crc = 0xFFFF;
+      finishStream(pThis, false);
+      beginFrame(pThis);
       return;
    }
 
    if(b == S101_EOF)
    {
-      if(pBuffer->position >= 2)
+      if(pThis->streamState == STREAM_STREAMING)
+      {
+         finishStream(pThis, pThis->pendingCount == 2 && pThis->crc == 0xF0B8);
+      }
+      else if(pBuffer->position >= 2)
       {
          if(pThis->crc == 0xF0B8)
             pThis->onPackageReceived(pBuffer->pMemory + 1, pBuffer->position - 3, pThis->state);
@@ -309,6 +650,7 @@ static void readFramedByte(EmberFramingReader *pThis, byte b)
 
    if(b >= S101_Invalid)
    {
+      finishStream(pThis, false);
       byteBuffer_reset(pBuffer);
       return;
    }
@@ -319,8 +661,54 @@ static void readFramedByte(EmberFramingReader *pThis, byte b)
       b ^= 0x20;
    }
 
-   byteBuffer_add(pBuffer, b);
-   pThis->crc = crc_addByte(pThis->crc, b);
+   addUnescapedByte(pThis, b);
+}
+
+static int readUnescapedBytes(EmberFramingReader *pThis, const byte *pBytes, int count)
+{
+   ByteBuffer *pBuffer = &pThis->buffer;
+   unsigned short crc;
+   byte *pCursor;
+   byte *pEnd;
+   int index;
+
+   // inside a frame, runs of bytes that need no unescaping are
+   // checksummed and copied in one go, or passed on without
+   // copying when streaming. anything else, including a full
+   // buffer and a header that is still being inspected, is left
+   // to readFramedByte.
+   if(byteBuffer_isEmpty(pBuffer)
+   || pThis->isEscaped
+   || pThis->streamState == STREAM_UNDECIDED)
+      return 0;
+
+   crc = pThis->crc;
+
+   if(pThis->streamState == STREAM_STREAMING)
+   {
+      for(index = 0; index < count && pBytes[index] < S101_Invalid; index++)
+         crc = crc_addByte(crc, pBytes[index]);
+
+      pThis->crc = crc;
+      streamPayloadBytes(pThis, pBytes, index);
+      return index;
+   }
+
+   if((unsigned int)count > pBuffer->size - pBuffer->position)
+      count = (int)(pBuffer->size - pBuffer->position);
+
+   pCursor = pBuffer->pMemory + pBuffer->position;
+   pEnd = pCursor + count;
+
+   for(index = 0; pCursor < pEnd && pBytes[index] < S101_Invalid; index++)
+   {
+      crc = crc_addByte(crc, pBytes[index]);
+      *pCursor++ = pBytes[index];
+   }
+
+   pThis->crc = crc;
+   pBuffer->position += index;
+   return index;
 }
 
 
@@ -347,6 +735,21 @@ void emberFramingReader_init(EmberFramingReader *pThis,
    pThis->crc = 0xFFFF;
    pThis->onPackageReceived = onPackageReceived;
    pThis->state = state;
+   pThis->streamState = STREAM_STAGED;
+}
+
+void emberFramingReader_setStreaming(EmberFramingReader *pThis,
+                                     onPayloadReceived_t onPayloadReceived,
+                                     onPayloadFinished_t onPayloadFinished)
+{
+   ASSERT(pThis != NULL);
+   ASSERT(onPayloadReceived == NULL || onPayloadFinished != NULL);
+   ASSERT(onPayloadReceived == NULL || pThis->buffer.size >= 1 + 7 + 255);
+
+   pThis->onPayloadReceived = onPayloadReceived;
+   pThis->onPayloadFinished = onPayloadFinished;
+
+   emberFramingReader_reset(pThis);
 }
 
 void emberFramingReader_reset(EmberFramingReader *pThis)
@@ -357,13 +760,28 @@ void emberFramingReader_reset(EmberFramingReader *pThis)
 
    pThis->crc = 0xFFFF;
    pThis->isEscaped = false;
+   pThis->pendingCount = 0;
+   pThis->streamState = STREAM_STAGED;
 }
 
 void emberFramingReader_readBytes(EmberFramingReader *pThis, const byte *pBytes, int count)
 {
+   int length;
+
    ASSERT(pThis != NULL);
    ASSERT(pBytes != NULL);
 
-   for( ; count > 0; count--, pBytes++)
-      readFramedByte(pThis, *pBytes);
+   while(count > 0)
+   {
+      length = readUnescapedBytes(pThis, pBytes, count);
+      pBytes += length;
+      count -= length;
+
+      if(count > 0)
+      {
+         readFramedByte(pThis, *pBytes);
+         pBytes++;
+         count--;
+      }
+   }
 }
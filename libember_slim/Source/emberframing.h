@@ -55,6 +55,18 @@
   */
 #define EMBER_COMMAND_KEEPALIVE_RESPONSE  (2)
 
+/**
+  * framing "command" byte: message announces the optional
+  * protocol features supported by the sender
+  */
+#define EMBER_COMMAND_CAPABILITIES        (4)
+
+/**
+  * capability flag: the host is able to decode packages
+  * flagged with EmberFramingFlag_Compressed
+  */
+#define EMBER_CAPABILITY_COMPRESSION      (0x01)
+
 
 /**
   * maximum length of an ember+ package.
@@ -67,6 +79,7 @@
   */
 typedef enum EEmberFramingFlags
 {
+   EmberFramingFlag_Compressed   = 0x10,
    EmberFramingFlag_EmptyPackage = 0x20,
    EmberFramingFlag_LastPackage  = 0x40,
    EmberFramingFlag_FirstPackage = 0x80,
@@ -82,6 +95,9 @@ typedef enum EEmberFramingFlags
 /**
   * Aggregates BerMemoryOutput to provide encoding a framed package
   * to memory.
+  * Bytes are escaped and checksummed while they are written, so the
+  * memory passed to berFramingOutput_init receives the final package
+  * and may be the transmit buffer of the application.
   * The writeByte and writeBytes functions are initialized when calling
   * berFramingOutput_init.
   */
@@ -118,6 +134,16 @@ typedef struct SBerFramingOutput
      * Number of application-defined bytes at pAppBytes.
      */
    byte appBytesCount;
+
+   /**
+     * Private field.
+     */
+   unsigned int flagsPosition;
+
+   /**
+     * Private field.
+     */
+   unsigned int bytesAfterFlags;
 } BerFramingOutput;
 
 /**
@@ -166,6 +192,53 @@ void berFramingOutput_writeHeader(BerFramingOutput *pThis, EmberFramingFlags fla
   */
 unsigned int berFramingOutput_finish(BerFramingOutput *pThis);
 
+/**
+  * Replaces the flags of the package currently written to a
+  * BerFramingOutput, updating the checksum accordingly.
+  * Allows to decide whether a package is the last package
+  * of a message after its payload has been written.
+  * @param pThis pointer to the object to process.
+  * @param flags contains a combination of package flags
+  * @note must be called after berFramingOutput_writeHeader
+  *     and before berFramingOutput_finish.
+  */
+void berFramingOutput_setFlags(BerFramingOutput *pThis, EmberFramingFlags flags);
+
+
+// ======================================================
+//
+// BerFramingLengthOutput
+//
+// ======================================================
+
+/**
+  * Aggregates BerOutput to determine the number of bytes
+  * some ember data takes in a framed package, including
+  * escape characters, without writing the data.
+  * The writeByte and writeBytes functions are initialized when calling
+  * berFramingLengthOutput_init.
+  */
+typedef struct SBerFramingLengthOutput
+{
+   /**
+     * Base output.
+     */
+   BerOutput base;
+
+   /**
+     * The number of bytes written to the output so far.
+     */
+   unsigned int length;
+} BerFramingLengthOutput;
+
+/**
+  * Initializes a BerFramingLengthOutput instance.
+  * Must be called before any other operations on the
+  * BerFramingLengthOutput instance are invoked.
+  * @param pThis pointer to the object to process.
+  */
+void berFramingLengthOutput_init(BerFramingLengthOutput *pThis);
+
 
 // ======================================================
 //
@@ -195,6 +268,55 @@ unsigned int emberFraming_writeKeepAliveRequest(byte *pBuffer, unsigned int size
   */
 unsigned int emberFraming_writeKeepAliveResponse(byte *pBuffer, unsigned int size, byte slotId);
 
+/**
+  * Frames a Capabilities message into the passed buffer.
+  * Both hosts should send this message once the connection has
+  * been established. Since hosts that do not know the command
+  * ignore it, an optional feature may only be used when the
+  * remote host has announced it.
+  * @param pBuffer pointer to the buffer where to store the
+  *     framed package.
+  * @param size the size of @pBuffer.
+  * @param slotId the S101 slot id of the remote host.
+  * @param capabilities combination of EMBER_CAPABILITY_ flags.
+  * @return the number of bytes written to @p pBuffer.
+  */
+unsigned int emberFraming_writeCapabilities(byte *pBuffer, unsigned int size, byte slotId, byte capabilities);
+
+/**
+  * Returns the capability flags announced by an unframed package,
+  * as passed to the onPackageReceived callback.
+  * @param pPackage pointer to the first byte in the
+  *     unframed package.
+  * @param length the length of the unframed package.
+  * @return the combination of EMBER_CAPABILITY_ flags, or 0 if
+  *     the package is not a Capabilities message.
+  */
+byte emberFraming_readCapabilities(const byte *pPackage, int length);
+
+/**
+  * Compresses the payload of a framed package in place, e.g. a
+  * package written by GlowOutput, and sets the
+  * EmberFramingFlag_Compressed flag.
+  * The package is left unchanged if it does not carry an ember
+  * payload or if compressing it does not make it smaller.
+  * Must only be called if the remote host has announced
+  * EMBER_CAPABILITY_COMPRESSION.
+  * @param pPackage pointer to the framed package.
+  * @param length the length of the framed package at @p pPackage.
+  * @param size the number of bytes available at @p pPackage.
+  * @param pScratch pointer to memory used to unframe the package.
+  * @param scratchSize the number of bytes at @p pScratch. The
+  *     package is left unchanged if its unframed length exceeds
+  *     this value, so passing @p length bytes is always enough.
+  * @return the length of the package at @p pPackage.
+  */
+unsigned int emberFraming_compressPackage(byte *pPackage,
+                                          unsigned int length,
+                                          unsigned int size,
+                                          byte *pScratch,
+                                          unsigned int scratchSize);
+
 
 // ======================================================
 //
@@ -214,6 +336,34 @@ unsigned int emberFraming_writeKeepAliveResponse(byte *pBuffer, unsigned int siz
   */
 typedef void (*onPackageReceived_t)(const byte *pPackage, int length, voidptr state);
 
+/**
+  * Function type used by EmberFramingReader in streaming mode to
+  * pass the unescaped payload of an EmBER package on as it arrives.
+  * Invoked once with @p count zero as soon as the header of a
+  * package is complete, and then for each run of payload bytes.
+  * @param pHeader pointer to the header of the package, starting
+  *     with the slot id. The header is 7 bytes long, followed by the
+  *     number of application bytes given by pHeader[6].
+  * @param pBytes pointer to the next payload bytes, NULL if
+  *     @p count is zero.
+  * @param count the number of bytes at @p pBytes.
+  * @param state application-defined argument.
+  */
+typedef void (*onPayloadReceived_t)(const byte *pHeader, const byte *pBytes, int count, voidptr state);
+
+/**
+  * Function type used by EmberFramingReader in streaming mode to
+  * notify the application that the last byte of a streamed package
+  * has been read.
+  * @param pHeader pointer to the header of the package, starting
+  *     with the slot id.
+  * @param isValid false if the checksum of the package did not
+  *     match. The payload that has already been passed on must then
+  *     be discarded.
+  * @param state application-defined argument.
+  */
+typedef void (*onPayloadFinished_t)(const byte *pHeader, bool isValid, voidptr state);
+
 /**
   * An in-memory reader used to unframe framed packages.
   */
@@ -241,9 +391,39 @@ typedef struct SEmberFramingReader
    onPackageReceived_t onPackageReceived;
 
    /**
-     * Application-defined argument passed to onPackageReceived.
+     * Pointer to application-defined function called with the
+     * payload of streamed packages, NULL if streaming is disabled.
+     * Set by emberFramingReader_setStreaming.
+     */
+   onPayloadReceived_t onPayloadReceived;
+
+   /**
+     * Pointer to application-defined function called when a
+     * streamed package is complete.
+     * Set by emberFramingReader_setStreaming.
+     */
+   onPayloadFinished_t onPayloadFinished;
+
+   /**
+     * Application-defined argument passed to onPackageReceived,
+     * onPayloadReceived and onPayloadFinished.
      */
    voidptr state;
+
+   /**
+     * Private field.
+     */
+   byte streamState;
+
+   /**
+     * Private field.
+     */
+   byte pending[2];
+
+   /**
+     * Private field.
+     */
+   int pendingCount;
 } EmberFramingReader;
 
 /**
@@ -264,6 +444,33 @@ void emberFramingReader_init(EmberFramingReader *pThis,
                              onPackageReceived_t onPackageReceived,
                              voidptr state);
 
+/**
+  * Enables streaming mode on an EmberFramingReader instance.
+  * In streaming mode, only the header of an uncompressed EmBER
+  * package is unframed into the buffer passed to
+  * emberFramingReader_init. The payload is passed to
+  * @p onPayloadReceived straight from the bytes fed into the reader,
+  * without being copied, so that it can be decoded while the frame
+  * is still arriving.
+  * All other packages, like keep-alives and compressed packages,
+  * are still unframed into the buffer and passed to
+  * onPackageReceived, so the buffer has to be large enough for
+  * the biggest of those, and at least 263 bytes to hold a header
+  * with the maximum number of application bytes.
+  * Since the checksum is only known when the frame is complete,
+  * the application must be prepared to discard a payload when
+  * @p onPayloadFinished reports the package to be invalid.
+  * @param pThis pointer to the object to process.
+  * @param onPayloadReceived pointer to application-defined function
+  *     called with the payload of streamed packages. Pass NULL to
+  *     disable streaming mode.
+  * @param onPayloadFinished pointer to application-defined function
+  *     called when a streamed package is complete.
+  */
+void emberFramingReader_setStreaming(EmberFramingReader *pThis,
+                                     onPayloadReceived_t onPayloadReceived,
+                                     onPayloadFinished_t onPayloadFinished);
+
 /**
   * Resets an EmberFramingReader instance.
   * After this function has been called, another framed package
@@ -27,8 +27,30 @@
   */
 #define EMBER_LIBRARY_VERSION (0x0146) //1.70
 
+#ifdef EMBER_STATIC_MEMORY
+/**
+  * EMBER_STATIC_MEMORY can be defined using a compiler option
+  * to build the library without any dynamic memory allocation
+  * on the RX side.
+  * BerReader, EmberAsyncReader, NonFramingGlowReader and
+  * GlowReader then embed all storage they need, sized at compile
+  * time by EMBER_MAX_VALUE_LENGTH, EMBER_MAX_TREE_DEPTH and
+  * GLOW_READER_STORAGE_SIZE. The caller provides this storage
+  * by placing the reader object in static memory, and the
+  * allocMemory and freeMemory callbacks passed to ember_init are
+  * never invoked by the readers and may be NULL.
+  * If a decoded value does not fit into the available storage,
+  * the throwError callback is invoked.
+  */
+#endif
+
+#include "embercompression.h"
 #include "glowtx.h"
 #include "glowrx.h"
+#include "glowprovider.h"
+#include "glowcrosspoints.h"
+#include "glowmirror.h"
+#include "embertransport.h"
 
 /**
   * Initializes internal parameters of the ember library.
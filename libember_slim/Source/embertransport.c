@@ -0,0 +1,221 @@
+/*
+   libember_slim -- ANSI C implementation of the Ember+ Protocol
+   Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include "embertransport.h"
+#include "emberinternal.h"
+
+
+// ====================================================================
+//
+// EmberRxRing globals
+//
+// ====================================================================
+
+void emberRxRing_init(EmberRxRing *pThis, byte *pMemory, unsigned int size)
+{
+   ASSERT(pThis != NULL);
+   ASSERT(pMemory != NULL);
+   ASSERT(size > 0 && (size & (size - 1)) == 0);
+
+   pThis->pMemory = pMemory;
+   pThis->mask = size - 1;
+   pThis->head = 0;
+   pThis->tail = 0;
+   pThis->overflowCount = 0;
+}
+
+bool emberRxRing_push(EmberRxRing *pThis, byte b)
+{
+   unsigned int head;
+
+   ASSERT(pThis != NULL);
+
+   head = pThis->head;
+
+   if(head - pThis->tail > pThis->mask)
+   {
+      pThis->overflowCount++;
+      return false;
+   }
+
+   pThis->pMemory[head & pThis->mask] = b;
+
+   // the byte has to be stored before the consumer can see it
+   EMBER_MEMORY_BARRIER();
+   pThis->head = head + 1;
+   return true;
+}
+
+unsigned int emberRxRing_pushBytes(EmberRxRing *pThis, const byte *pBytes, unsigned int count)
+{
+   unsigned int head;
+   unsigned int space;
+   unsigned int index;
+
+   ASSERT(pThis != NULL);
+   ASSERT(pBytes != NULL || count == 0);
+
+   head = pThis->head;
+   space = pThis->mask + 1 - (head - pThis->tail);
+
+   if(count > space)
+   {
+      pThis->overflowCount += count - space;
+      count = space;
+   }
+
+   for(index = 0; index < count; index++)
+      pThis->pMemory[(head + index) & pThis->mask] = pBytes[index];
+
+   EMBER_MEMORY_BARRIER();
+   pThis->head = head + count;
+   return count;
+}
+
+unsigned int emberRxRing_count(const EmberRxRing *pThis)
+{
+   ASSERT(pThis != NULL);
+
+   return pThis->head - pThis->tail;
+}
+
+unsigned int emberRxRing_drain(EmberRxRing *pThis, EmberFramingReader *pReader)
+{
+   unsigned int head;
+   unsigned int tail;
+   unsigned int offset;
+   unsigned int count;
+   unsigned int block;
+
+   ASSERT(pThis != NULL);
+   ASSERT(pReader != NULL);
+
+   head = pThis->head;
+   tail = pThis->tail;
+   count = head - tail;
+
+   if(count == 0)
+      return 0;
+
+   // the bytes up to the snapshot of head have been stored
+   // before head has been written
+   EMBER_MEMORY_BARRIER();
+
+   offset = tail & pThis->mask;
+   block = pThis->mask + 1 - offset;
+
+   if(block > count)
+      block = count;
+
+   emberFramingReader_readBytes(pReader, pThis->pMemory + offset, (int)block);
+
+   if(block < count)
+      emberFramingReader_readBytes(pReader, pThis->pMemory, (int)(count - block));
+
+   // the reader must be done with the bytes before the
+   // producer may overwrite them
+   EMBER_MEMORY_BARRIER();
+   pThis->tail = head;
+   return count;
+}
+
+
+// ====================================================================
+//
+// EmberTxQueue globals
+//
+// ====================================================================
+
+void emberTxQueue_init(EmberTxQueue *pThis, byte *pMemory, unsigned int size)
+{
+   ASSERT(pThis != NULL);
+   ASSERT(pMemory != NULL);
+   ASSERT(size >= 2);
+
+   pThis->size = size / 2;
+   pThis->pBuffers[0] = pMemory;
+   pThis->pBuffers[1] = pMemory + pThis->size;
+   pThis->lengths[0] = 0;
+   pThis->lengths[1] = 0;
+   pThis->head = 0;
+   pThis->tail = 0;
+}
+
+byte *emberTxQueue_acquire(EmberTxQueue *pThis, unsigned int *pSize)
+{
+   unsigned int head;
+
+   ASSERT(pThis != NULL);
+   ASSERT(pSize != NULL);
+
+   head = pThis->head;
+
+   if(head - pThis->tail >= 2)
+      return NULL;
+
+   // the transmitter must be done with the buffer before
+   // it is written again
+   EMBER_MEMORY_BARRIER();
+
+   *pSize = pThis->size;
+   return pThis->pBuffers[head & 1];
+}
+
+void emberTxQueue_commit(EmberTxQueue *pThis, unsigned int length)
+{
+   unsigned int head;
+
+   ASSERT(pThis != NULL);
+   ASSERT(length <= pThis->size);
+
+   head = pThis->head;
+   ASSERT(head - pThis->tail < 2);
+
+   pThis->lengths[head & 1] = length;
+
+   EMBER_MEMORY_BARRIER();
+   pThis->head = head + 1;
+}
+
+const byte *emberTxQueue_peek(const EmberTxQueue *pThis, unsigned int *pLength)
+{
+   unsigned int tail;
+
+   ASSERT(pThis != NULL);
+   ASSERT(pLength != NULL);
+
+   tail = pThis->tail;
+
+   if(pThis->head == tail)
+      return NULL;
+
+   EMBER_MEMORY_BARRIER();
+
+   *pLength = pThis->lengths[tail & 1];
+   return pThis->pBuffers[tail & 1];
+}
+
+void emberTxQueue_release(EmberTxQueue *pThis)
+{
+   ASSERT(pThis != NULL);
+   ASSERT(pThis->head != pThis->tail);
+
+   EMBER_MEMORY_BARRIER();
+   pThis->tail = pThis->tail + 1;
+}
@@ -0,0 +1,246 @@
+/*
+   libember_slim -- ANSI C implementation of the Ember+ Protocol
+   Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef __LIBEMBER_SLIM_EMBERTRANSPORT_H
+#define __LIBEMBER_SLIM_EMBERTRANSPORT_H
+
+#include "ember.h"
+
+#ifndef EMBER_MEMORY_BARRIER
+/**
+  * Keeps the compiler from moving memory accesses across the
+  * update of the indices of EmberRxRing and EmberTxQueue.
+  * The default is sufficient on single-core targets, where the
+  * producer and the consumer are an interrupt handler and a task.
+  * Define EMBER_MEMORY_BARRIER using a compiler option if the
+  * producer and the consumer run on different cores, e.g. as
+  * __DMB() on ARM Cortex-M or __sync_synchronize() with gcc.
+  */
+#if defined(__GNUC__)
+#define EMBER_MEMORY_BARRIER() __asm__ __volatile__("" ::: "memory")
+#elif defined(_MSC_VER)
+#include <intrin.h>
+#define EMBER_MEMORY_BARRIER() _ReadWriteBarrier()
+#else
+#define EMBER_MEMORY_BARRIER()
+#endif
+#endif
+
+
+// ====================================================================
+//
+// EmberRxRing
+//
+// ====================================================================
+
+/**
+  * A single-producer, single-consumer ring of received bytes
+  * that does not need any locks. Meant for serial transports
+  * like UART or USB-CDC: the receive interrupt handler pushes the
+  * bytes, and a task drains them in blocks into an
+  * EmberFramingReader, so that the interrupt handler never runs
+  * the decoder and the decoder does not process single bytes.
+  * Each index is only written by one side, the head by the
+  * producer and the tail by the consumer.
+  */
+typedef struct SEmberRxRing
+{
+   /**
+     * Private field.
+     */
+   byte *pMemory;
+
+   /**
+     * Private field.
+     */
+   unsigned int mask;
+
+   /**
+     * Private field. The number of bytes pushed so far,
+     * wraps around.
+     */
+   volatile unsigned int head;
+
+   /**
+     * Private field. The number of bytes drained so far,
+     * wraps around.
+     */
+   volatile unsigned int tail;
+
+   /**
+     * The number of bytes that have been dropped because the
+     * ring was full. Only written by the producer.
+     */
+   volatile unsigned int overflowCount;
+} EmberRxRing;
+
+/**
+  * Initializes an EmberRxRing instance.
+  * @param pThis pointer to the object to process.
+  * @param pMemory pointer to the memory location to store
+  *     the received bytes at.
+  * @param size number of bytes at @p pMemory. Must be a
+  *     power of two.
+  */
+void emberRxRing_init(EmberRxRing *pThis, byte *pMemory, unsigned int size);
+
+/**
+  * Pushes a single received byte into the ring.
+  * Must only be called by the producer, usually the
+  * receive interrupt handler.
+  * @param pThis pointer to the object to process.
+  * @param b the received byte.
+  * @return false if the ring is full and the byte has been
+  *     dropped, in which case overflowCount is incremented.
+  */
+bool emberRxRing_push(EmberRxRing *pThis, byte b);
+
+/**
+  * Pushes multiple received bytes into the ring, e.g. the
+  * contents of a hardware FIFO or of a completed DMA transfer.
+  * Must only be called by the producer.
+  * @param pThis pointer to the object to process.
+  * @param pBytes pointer to the first byte to push.
+  * @param count the number of bytes at @p pBytes.
+  * @return the number of bytes that have been pushed. The
+  *     remaining bytes are dropped and counted in overflowCount.
+  */
+unsigned int emberRxRing_pushBytes(EmberRxRing *pThis, const byte *pBytes, unsigned int count);
+
+/**
+  * Returns the number of bytes waiting to be drained.
+  * May be called by either side.
+  * @param pThis pointer to the object to process.
+  * @return the number of bytes waiting to be drained.
+  */
+unsigned int emberRxRing_count(const EmberRxRing *pThis);
+
+/**
+  * Feeds all bytes pushed so far into an EmberFramingReader,
+  * in at most two contiguous blocks, directly from the memory
+  * of the ring. The space is only released to the producer
+  * after the reader has processed the bytes.
+  * Must only be called by the consumer, usually a task.
+  * To feed a GlowReader, pass its framing member.
+  * @param pThis pointer to the object to process.
+  * @param pReader pointer to the reader to feed.
+  * @return the number of bytes that have been fed into @p pReader.
+  */
+unsigned int emberRxRing_drain(EmberRxRing *pThis, EmberFramingReader *pReader);
+
+
+// ====================================================================
+//
+// EmberTxQueue
+//
+// ====================================================================
+
+/**
+  * A double buffer for transmitting framed packages without
+  * locks, e.g. by DMA. While one buffer is being transmitted,
+  * the next package can be encoded into the other one by
+  * passing the acquired buffer to glowOutput_init or
+  * berFramingOutput_init. A buffer is only reused after the
+  * transmitter has released it, so its contents stay untouched
+  * while the transfer is running.
+  * The producer is a task, the consumer is the transmitter,
+  * usually the DMA completion interrupt handler.
+  */
+typedef struct SEmberTxQueue
+{
+   /**
+     * Private field.
+     */
+   byte *pBuffers[2];
+
+   /**
+     * Private field.
+     */
+   unsigned int size;
+
+   /**
+     * Private field.
+     */
+   volatile unsigned int lengths[2];
+
+   /**
+     * Private field. The number of committed packages,
+     * wraps around.
+     */
+   volatile unsigned int head;
+
+   /**
+     * Private field. The number of released packages,
+     * wraps around.
+     */
+   volatile unsigned int tail;
+} EmberTxQueue;
+
+/**
+  * Initializes an EmberTxQueue instance.
+  * @param pThis pointer to the object to process.
+  * @param pMemory pointer to the memory location that is
+  *     split into the two buffers.
+  * @param size number of bytes at @p pMemory. Each buffer
+  *     gets half of it.
+  */
+void emberTxQueue_init(EmberTxQueue *pThis, byte *pMemory, unsigned int size);
+
+/**
+  * Returns the buffer to encode the next package to.
+  * Must only be called by the producer.
+  * @param pThis pointer to the object to process.
+  * @param pSize receives the number of bytes available
+  *     in the returned buffer.
+  * @return pointer to the buffer, or NULL if both buffers
+  *     are still waiting to be transmitted.
+  */
+byte *emberTxQueue_acquire(EmberTxQueue *pThis, unsigned int *pSize);
+
+/**
+  * Queues the package that has been encoded into the buffer
+  * returned by the last call to emberTxQueue_acquire.
+  * Must only be called by the producer.
+  * @param pThis pointer to the object to process.
+  * @param length the length of the framed package, as
+  *     returned by glowOutput_finishPackage.
+  */
+void emberTxQueue_commit(EmberTxQueue *pThis, unsigned int length);
+
+/**
+  * Returns the next package to transmit, without removing
+  * it from the queue.
+  * Must only be called by the consumer.
+  * @param pThis pointer to the object to process.
+  * @param pLength receives the length of the returned package.
+  * @return pointer to the package, or NULL if no package
+  *     is waiting to be transmitted.
+  */
+const byte *emberTxQueue_peek(const EmberTxQueue *pThis, unsigned int *pLength);
+
+/**
+  * Removes the package returned by emberTxQueue_peek from the
+  * queue once it has been transmitted, so that its buffer can
+  * be reused.
+  * Must only be called by the consumer.
+  * @param pThis pointer to the object to process.
+  */
+void emberTxQueue_release(EmberTxQueue *pThis);
+
+#endif
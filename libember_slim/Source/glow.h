@@ -38,6 +38,27 @@
 #define GLOW_SCHEMA_VERSION (0x021F)
 
 
+#ifdef GLOW_FIXED_REAL_FRACTION_BITS
+/**
+  * Type of the real values stored in GlowValue and GlowMinMax.
+  * Since GLOW_FIXED_REAL_FRACTION_BITS is defined, real values are
+  * fixed-point numbers with the defined number of fraction bits,
+  * e.g. 1.5 is stored as 3 << (GLOW_FIXED_REAL_FRACTION_BITS - 1).
+  * They are encoded and decoded without floating-point arithmetic,
+  * which avoids software floating-point calls on targets without FPU.
+  * Can be set using a compiler option.
+  */
+typedef berlong glowreal;
+#else
+/**
+  * Type of the real values stored in GlowValue and GlowMinMax.
+  * Define GLOW_FIXED_REAL_FRACTION_BITS using a compiler option
+  * to store real values as fixed-point numbers.
+  */
+typedef double glowreal;
+#endif
+
+
 /**
   * Defines the structure of all ber tags used by the glow dtd.
   */
@@ -509,7 +530,7 @@ typedef struct SGlowMinMax
    union
    {
       berlong integer;
-      double real;
+      glowreal real;
    } choice;
 } GlowMinMax;
 
@@ -543,7 +564,7 @@ typedef struct SGlowValue
    union
    {
       berlong integer;
-      double real;
+      glowreal real;
       bool boolean;
       pstr pString;
       GlowOctetsValue octets;
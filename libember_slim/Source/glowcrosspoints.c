@@ -0,0 +1,295 @@
+/*
+   libember_slim -- ANSI C implementation of the Ember+ Protocol
+   Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <string.h>
+#include "glowcrosspoints.h"
+#include "emberinternal.h"
+
+
+// ====================================================================
+//
+// GlowCrosspoints locals
+//
+// ====================================================================
+
+static byte *getRow(const GlowCrosspoints *pThis, berint target)
+{
+   return pThis->pBits + target * pThis->rowLength;
+}
+
+static void markChanged(GlowCrosspoints *pThis, berint target)
+{
+   if(pThis->pChanged != NULL)
+      pThis->pChanged[target >> 3] |= (byte)(1 << (target & 7));
+}
+
+static bool isChanged(const GlowCrosspoints *pThis, berint target)
+{
+   return pThis->pChanged != NULL
+       && (pThis->pChanged[target >> 3] & (1 << (target & 7))) != 0;
+}
+
+static bool setBit(GlowCrosspoints *pThis, berint target, berint source, bool isConnected)
+{
+   byte *pByte = getRow(pThis, target) + (source >> 3);
+   byte mask = (byte)(1 << (source & 7));
+   byte value = isConnected
+                ? (byte)(*pByte | mask)
+                : (byte)(*pByte & ~mask);
+
+   if(value == *pByte)
+      return false;
+
+   *pByte = value;
+   markChanged(pThis, target);
+   return true;
+}
+
+static bool containsSource(const berint *pSources, int count, berint source)
+{
+   int index;
+
+   for(index = 0; index < count; index++)
+   {
+      if(pSources[index] == source)
+         return true;
+   }
+
+   return false;
+}
+
+static bool disconnectSource(GlowCrosspoints *pThis, berint source, berint exceptTarget)
+{
+   bool isChanged = false;
+   berint target;
+
+   for(target = 0; target < pThis->targetCount; target++)
+   {
+      if(target != exceptTarget)
+         isChanged |= setBit(pThis, target, source, false);
+   }
+
+   return isChanged;
+}
+
+static bool assignSources(GlowCrosspoints *pThis, berint target, const berint *pSources, int count)
+{
+   byte *pRow = getRow(pThis, target);
+   bool isChanged = false;
+   berint source;
+   int index;
+
+   for(source = 0; source < pThis->sourceCount; source++)
+   {
+      // skip eight unconnected sources at once
+      if((source & 7) == 0 && pRow[source >> 3] == 0)
+      {
+         source += 7;
+         continue;
+      }
+
+      if((pRow[source >> 3] & (1 << (source & 7))) != 0
+      && containsSource(pSources, count, source) == false)
+         isChanged |= setBit(pThis, target, source, false);
+   }
+
+   for(index = 0; index < count; index++)
+   {
+      if(pThis->type == GlowMatrixType_OneToOne)
+         isChanged |= disconnectSource(pThis, pSources[index], target);
+
+      isChanged |= setBit(pThis, target, pSources[index], true);
+   }
+
+   return isChanged;
+}
+
+
+// ====================================================================
+//
+// GlowCrosspoints globals
+//
+// ====================================================================
+
+void glowCrosspoints_init(GlowCrosspoints *pThis,
+                          byte *pBits,
+                          byte *pChanged,
+                          int targetCount,
+                          int sourceCount)
+{
+   ASSERT(pThis != NULL);
+   ASSERT(pBits != NULL || targetCount == 0 || sourceCount == 0);
+   ASSERT(targetCount >= 0);
+   ASSERT(sourceCount >= 0);
+
+   bzero(*pThis);
+
+   pThis->pBits = pBits;
+   pThis->pChanged = pChanged;
+   pThis->targetCount = targetCount;
+   pThis->sourceCount = sourceCount;
+   pThis->rowLength = GLOW_CROSSPOINTS_ROW_LENGTH(sourceCount);
+   pThis->type = GlowMatrixType_OneToN;
+
+   if(pBits != NULL)
+      memset(pBits, 0, GLOW_CROSSPOINTS_SIZE(targetCount, sourceCount));
+
+   if(pChanged != NULL)
+      memset(pChanged, 0, GLOW_CROSSPOINTS_CHANGED_SIZE(targetCount));
+}
+
+bool glowCrosspoints_isConnected(const GlowCrosspoints *pThis, berint target, berint source)
+{
+   ASSERT(pThis != NULL);
+
+   if(target < 0 || target >= pThis->targetCount
+   || source < 0 || source >= pThis->sourceCount)
+      return false;
+
+   return (getRow(pThis, target)[source >> 3] & (1 << (source & 7))) != 0;
+}
+
+bool glowCrosspoints_set(GlowCrosspoints *pThis, berint target, berint source, bool isConnected)
+{
+   ASSERT(pThis != NULL);
+
+   if(target < 0 || target >= pThis->targetCount
+   || source < 0 || source >= pThis->sourceCount)
+      return false;
+
+   return setBit(pThis, target, source, isConnected);
+}
+
+bool glowCrosspoints_applyConnection(GlowCrosspoints *pThis, const GlowConnection *pConnection)
+{
+   berint target;
+   bool isChanged = false;
+   int index;
+
+   ASSERT(pThis != NULL);
+   ASSERT(pConnection != NULL);
+
+   target = pConnection->target;
+
+   if(target < 0 || target >= pThis->targetCount)
+      return false;
+
+   for(index = 0; index < pConnection->sourcesLength; index++)
+   {
+      if(pConnection->pSources[index] < 0
+      || pConnection->pSources[index] >= pThis->sourceCount)
+         return false;
+   }
+
+   if(pConnection->operation == GlowConnectionOperation_Disconnect)
+   {
+      for(index = 0; index < pConnection->sourcesLength; index++)
+         isChanged |= setBit(pThis, target, pConnection->pSources[index], false);
+
+      return isChanged;
+   }
+
+   if(pConnection->operation == GlowConnectionOperation_Connect
+   && pConnection->sourcesLength == 0)
+      return false;
+
+   // a oneToN or oneToOne target has at most one source, which
+   // is replaced by a connect request as well.
+   if(pThis->type != GlowMatrixType_NToN)
+   {
+      return assignSources(pThis,
+                           target,
+                           pConnection->pSources + pConnection->sourcesLength - (pConnection->sourcesLength > 0 ? 1 : 0),
+                           pConnection->sourcesLength > 0 ? 1 : 0);
+   }
+
+   if(pConnection->operation == GlowConnectionOperation_Absolute)
+      return assignSources(pThis, target, pConnection->pSources, pConnection->sourcesLength);
+
+   for(index = 0; index < pConnection->sourcesLength; index++)
+      isChanged |= setBit(pThis, target, pConnection->pSources[index], true);
+
+   return isChanged;
+}
+
+void glowCrosspoints_markChanged(GlowCrosspoints *pThis, berint target)
+{
+   ASSERT(pThis != NULL);
+
+   if(target >= 0 && target < pThis->targetCount)
+      markChanged(pThis, target);
+}
+
+bool glowCrosspoints_hasChanges(const GlowCrosspoints *pThis)
+{
+   int index;
+
+   ASSERT(pThis != NULL);
+
+   if(pThis->pChanged == NULL)
+      return false;
+
+   for(index = 0; index < GLOW_CROSSPOINTS_CHANGED_SIZE(pThis->targetCount); index++)
+   {
+      if(pThis->pChanged[index] != 0)
+         return true;
+   }
+
+   return false;
+}
+
+int glowCrosspoints_writeConnections(GlowCrosspoints *pThis,
+                                     GlowOutput *pOut,
+                                     const berint *pMatrixPath,
+                                     int matrixPathLength,
+                                     bool isChangesOnly)
+{
+   berint target;
+   int count = 0;
+
+   ASSERT(pThis != NULL);
+   ASSERT(pOut != NULL);
+
+   glow_writeConnectionsPrefix(pOut, pMatrixPath, matrixPathLength);
+
+   for(target = 0; target < pThis->targetCount; target++)
+   {
+      // skip eight unchanged targets at once
+      if(isChangesOnly
+      && (target & 7) == 0
+      && (pThis->pChanged == NULL || pThis->pChanged[target >> 3] == 0))
+      {
+         target += 7;
+         continue;
+      }
+
+      if(isChangesOnly == false || isChanged(pThis, target))
+      {
+         glow_writeConnectionBits(pOut, target, getRow(pThis, target), pThis->sourceCount, GlowConnectionDisposition_Tally);
+         count++;
+      }
+   }
+
+   glow_writeConnectionsSuffix(pOut);
+
+   if(pThis->pChanged != NULL)
+      memset(pThis->pChanged, 0, GLOW_CROSSPOINTS_CHANGED_SIZE(pThis->targetCount));
+
+   return count;
+}
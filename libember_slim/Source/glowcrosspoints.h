@@ -0,0 +1,186 @@
+/*
+   libember_slim -- ANSI C implementation of the Ember+ Protocol
+   Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef __LIBEMBER_SLIM_GLOWCROSSPOINTS_H
+#define __LIBEMBER_SLIM_GLOWCROSSPOINTS_H
+
+#include "glowtx.h"
+
+/**
+  * The number of bytes of the bitmap describing the sources
+  * connected to a single target.
+  */
+#define GLOW_CROSSPOINTS_ROW_LENGTH(sourceCount) (((sourceCount) + 7) / 8)
+
+/**
+  * The number of bytes to pass as pBits to glowCrosspoints_init.
+  */
+#define GLOW_CROSSPOINTS_SIZE(targetCount, sourceCount) ((targetCount) * GLOW_CROSSPOINTS_ROW_LENGTH(sourceCount))
+
+/**
+  * The number of bytes to pass as pChanged to glowCrosspoints_init.
+  */
+#define GLOW_CROSSPOINTS_CHANGED_SIZE(targetCount) (((targetCount) + 7) / 8)
+
+
+// ====================================================================
+//
+// GlowCrosspoints
+//
+// ====================================================================
+
+/**
+  * Stores the connections of a linear matrix as a bitmap, one bit
+  * per crosspoint, plus one bit per target that tells whether the
+  * connections of the target have changed since they have last
+  * been written.
+  * Connection requests read from a consumer are applied straight
+  * to the bitmap, and connections are written straight from it,
+  * without building GlowConnection structures.
+  * Targets and sources are addressed by their numbers, which
+  * must be less than the counts passed to glowCrosspoints_init.
+  */
+typedef struct SGlowCrosspoints
+{
+   /**
+     * Private field.
+     */
+   byte *pBits;
+
+   /**
+     * Private field.
+     */
+   byte *pChanged;
+
+   /**
+     * Private field.
+     */
+   int targetCount;
+
+   /**
+     * Private field.
+     */
+   int sourceCount;
+
+   /**
+     * Private field.
+     */
+   int rowLength;
+
+   /**
+     * The type of the matrix, which defines how connection
+     * requests are applied. Initialized to GlowMatrixType_OneToN.
+     */
+   GlowMatrixType type;
+} GlowCrosspoints;
+
+/**
+  * Initializes a GlowCrosspoints instance with all crosspoints
+  * disconnected and all targets unchanged.
+  * @param pThis pointer to the object to process.
+  * @param pBits pointer to the memory location to store the
+  *     crosspoints at, GLOW_CROSSPOINTS_SIZE(targetCount, sourceCount)
+  *     bytes.
+  * @param pChanged pointer to the memory location to store the
+  *     changed targets at, GLOW_CROSSPOINTS_CHANGED_SIZE(targetCount)
+  *     bytes. May be NULL if changes are not tracked.
+  * @param targetCount the number of targets of the matrix.
+  * @param sourceCount the number of sources of the matrix.
+  */
+void glowCrosspoints_init(GlowCrosspoints *pThis,
+                          byte *pBits,
+                          byte *pChanged,
+                          int targetCount,
+                          int sourceCount);
+
+/**
+  * Returns whether a source is connected to a target.
+  * @param pThis pointer to the object to process.
+  * @param target the number of the target.
+  * @param source the number of the source.
+  * @return true if @p source is connected to @p target, false
+  *     if not or if either number is out of range.
+  */
+bool glowCrosspoints_isConnected(const GlowCrosspoints *pThis, berint target, berint source);
+
+/**
+  * Connects or disconnects a single crosspoint, e.g. when the
+  * routing has been changed locally. The matrix type is not
+  * taken into account.
+  * @param pThis pointer to the object to process.
+  * @param target the number of the target.
+  * @param source the number of the source.
+  * @param isConnected true to connect, false to disconnect.
+  * @return true if the crosspoint has changed, in which case the
+  *     target is marked as changed.
+  */
+bool glowCrosspoints_set(GlowCrosspoints *pThis, berint target, berint source, bool isConnected);
+
+/**
+  * Applies a connection read from a consumer, e.g. from the
+  * onConnection callback of a GlowReader.
+  * The operation of @p pConnection is honored, and so is the
+  * matrix type: a oneToN target keeps the last requested source
+  * only, and connecting a source of a oneToOne matrix disconnects
+  * it from all other targets.
+  * Requests that address a target or source out of range are
+  * ignored as a whole.
+  * @param pThis pointer to the object to process.
+  * @param pConnection the requested connection.
+  * @return true if any crosspoint has changed.
+  */
+bool glowCrosspoints_applyConnection(GlowCrosspoints *pThis, const GlowConnection *pConnection);
+
+/**
+  * Marks the connections of a target as changed, e.g. to report
+  * a request that has been rejected by the application.
+  * @param pThis pointer to the object to process.
+  * @param target the number of the target.
+  */
+void glowCrosspoints_markChanged(GlowCrosspoints *pThis, berint target);
+
+/**
+  * Returns whether the connections of any target have changed
+  * since they have last been written.
+  * @param pThis pointer to the object to process.
+  * @return true if there are changes to write.
+  */
+bool glowCrosspoints_hasChanges(const GlowCrosspoints *pThis);
+
+/**
+  * Writes the connections of a matrix, including the prefix and
+  * suffix of the QualifiedMatrix, and marks all written targets
+  * as unchanged. Each connection is encoded straight from the
+  * bitmap using glow_writeConnectionBits.
+  * @param pThis pointer to the object to process.
+  * @param pOut pointer to the output to write to.
+  * @param pMatrixPath pointer to the first number in the path of
+  *     the matrix.
+  * @param matrixPathLength number of node numbers at @p pMatrixPath.
+  * @param isChangesOnly true to write only the targets whose
+  *     connections have changed, false to write all targets.
+  * @return the number of connections written.
+  */
+int glowCrosspoints_writeConnections(GlowCrosspoints *pThis,
+                                     GlowOutput *pOut,
+                                     const berint *pMatrixPath,
+                                     int matrixPathLength,
+                                     bool isChangesOnly);
+
+#endif
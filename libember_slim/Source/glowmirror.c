@@ -0,0 +1,463 @@
+/*
+   libember_slim -- ANSI C implementation of the Ember+ Protocol
+   Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <string.h>
+#include "glowmirror.h"
+#include "emberinternal.h"
+
+
+// ====================================================================
+//
+// GlowMirror locals
+//
+// ====================================================================
+
+#define HASH_SEED (2166136261u)
+#define HASH_PRIME (16777619u)
+
+static dword hashNumber(dword hash, berint number)
+{
+   return (hash ^ (dword)number) * HASH_PRIME;
+}
+
+static dword hashString(pcstr pString)
+{
+   dword hash = HASH_SEED;
+
+   for( ; *pString != 0; pString++)
+      hash = (hash ^ (byte)*pString) * HASH_PRIME;
+
+   return hash;
+}
+
+// a hash of zero marks an unused entry
+static dword toEntryHash(dword hash)
+{
+   return hash != 0 ? hash : 1;
+}
+
+static bool isFull(const GlowMirror *pThis, int count)
+{
+   return count >= pThis->capacity - pThis->capacity / 4;
+}
+
+static bool matchesPath(const GlowMirror *pThis, const GlowMirrorEntry *pEntry, const berint *pPath, int pathLength)
+{
+   int index = pathLength - 1;
+
+   while(index >= 0 && pEntry != NULL && pEntry->number == pPath[index])
+   {
+      pEntry = glowMirror_getParent(pThis, pEntry);
+      index--;
+   }
+
+   return index < 0 && pEntry == NULL;
+}
+
+// returns the index of the entry, or -1 - the index of the
+// unused entry to store it at if it does not exist.
+static int findChild(const GlowMirror *pThis, dword hash, int parent, berint number)
+{
+   int mask = pThis->capacity - 1;
+   int index = (int)(hash & mask);
+   const GlowMirrorEntry *pEntry;
+
+   for(pEntry = &pThis->pEntries[index]; pEntry->hash != 0; pEntry = &pThis->pEntries[index])
+   {
+      if(pEntry->hash == hash && pEntry->parent == parent && pEntry->number == number)
+         return index;
+
+      index = (index + 1) & mask;
+   }
+
+   return -1 - index;
+}
+
+static GlowMirrorEntry *getEntry(GlowMirror *pThis, const berint *pPath, int pathLength)
+{
+   GlowMirrorEntry *pEntry = (GlowMirrorEntry *)glowMirror_find(pThis, pPath, pathLength);
+   dword hash = HASH_SEED;
+   int parent = GLOW_MIRROR_NO_ENTRY;
+   int index;
+   int depth;
+
+   if(pEntry != NULL)
+      return pEntry;
+
+   // the element is new: look up or create the entries of its parents first
+   for(depth = 0; depth < pathLength; depth++)
+   {
+      hash = hashNumber(hash, pPath[depth]);
+      index = findChild(pThis, toEntryHash(hash), parent, pPath[depth]);
+
+      if(index < 0)
+      {
+         if(isFull(pThis, pThis->entryCount))
+         {
+            pThis->isOverflow = true;
+            return NULL;
+         }
+
+         index = -1 - index;
+         pEntry = &pThis->pEntries[index];
+         memset(pEntry, 0, sizeof(*pEntry));
+         pEntry->hash = toEntryHash(hash);
+         pEntry->parent = parent;
+         pEntry->number = pPath[depth];
+         pEntry->type = GlowElementType_Node;
+         pEntry->fields = GlowFieldFlag_None;
+         pEntry->identifier = GLOW_MIRROR_NO_STRING;
+         pEntry->isOnline = true;
+         pThis->entryCount++;
+      }
+
+      parent = index;
+   }
+
+   return &pThis->pEntries[parent];
+}
+
+static int internString(GlowMirror *pThis, pcstr pString)
+{
+   int mask = pThis->capacity - 1;
+   int index;
+   int length;
+   int offset;
+
+   if(pString == NULL)
+      return GLOW_MIRROR_NO_STRING;
+
+   for(index = (int)(hashString(pString) & mask); pThis->pStringSlots[index] != GLOW_MIRROR_NO_STRING; index = (index + 1) & mask)
+   {
+      offset = pThis->pStringSlots[index];
+
+      if(strcmp(pThis->pStrings + offset, pString) == 0)
+         return offset;
+   }
+
+   length = (int)strlen(pString) + 1;
+
+   if(isFull(pThis, pThis->stringCount)
+   || length > pThis->stringsSize - pThis->stringsLength)
+   {
+      pThis->isOverflow = true;
+      return GLOW_MIRROR_NO_STRING;
+   }
+
+   offset = pThis->stringsLength;
+   memcpy(pThis->pStrings + offset, pString, length);
+   pThis->stringsLength += length;
+   pThis->pStringSlots[index] = offset;
+   pThis->stringCount++;
+   return offset;
+}
+
+static void addFields(GlowMirrorEntry *pEntry, GlowFieldFlags fields)
+{
+   pEntry->fields = (GlowFieldFlags)(pEntry->fields | fields);
+}
+
+static void setValue(GlowMirror *pThis, GlowMirrorEntry *pEntry, const GlowValue *pValue)
+{
+   pEntry->choice.parameter.valueFlag = pValue->flag;
+
+   switch(pValue->flag)
+   {
+      case GlowParameterType_Integer:
+         pEntry->choice.parameter.value.integer = pValue->choice.integer;
+         break;
+
+      case GlowParameterType_Real:
+         pEntry->choice.parameter.value.real = pValue->choice.real;
+         break;
+
+      case GlowParameterType_String:
+         pEntry->choice.parameter.value.string = internString(pThis, pValue->choice.pString);
+         break;
+
+      case GlowParameterType_Boolean:
+         pEntry->choice.parameter.value.boolean = pValue->choice.boolean;
+         break;
+
+      default:
+         // octets are not stored
+         break;
+   }
+}
+
+
+// ====================================================================
+//
+// GlowMirror globals
+//
+// ====================================================================
+
+void glowMirror_init(GlowMirror *pThis,
+                     GlowMirrorEntry *pEntries,
+                     int *pStringSlots,
+                     int capacity,
+                     char *pStrings,
+                     int stringsSize)
+{
+   ASSERT(pThis != NULL);
+   ASSERT(pEntries != NULL);
+   ASSERT(pStringSlots != NULL);
+   ASSERT(capacity > 0 && (capacity & (capacity - 1)) == 0);
+   ASSERT(pStrings != NULL || stringsSize == 0);
+
+   pThis->pEntries = pEntries;
+   pThis->pStringSlots = pStringSlots;
+   pThis->capacity = capacity;
+   pThis->pStrings = pStrings;
+   pThis->stringsSize = stringsSize;
+
+   glowMirror_clear(pThis);
+}
+
+void glowMirror_clear(GlowMirror *pThis)
+{
+   int index;
+
+   ASSERT(pThis != NULL);
+
+   for(index = 0; index < pThis->capacity; index++)
+   {
+      pThis->pEntries[index].hash = 0;
+      pThis->pStringSlots[index] = GLOW_MIRROR_NO_STRING;
+   }
+
+   pThis->entryCount = 0;
+   pThis->stringCount = 0;
+   pThis->stringsLength = 0;
+   pThis->isOverflow = false;
+}
+
+const GlowMirrorEntry *glowMirror_applyNode(GlowMirror *pThis,
+                                            const GlowNode *pNode,
+                                            GlowFieldFlags fields,
+                                            const berint *pPath,
+                                            int pathLength)
+{
+   GlowMirrorEntry *pEntry;
+
+   ASSERT(pThis != NULL);
+   ASSERT(pNode != NULL);
+   ASSERT(pPath != NULL);
+   ASSERT(pathLength > 0);
+
+   pEntry = getEntry(pThis, pPath, pathLength);
+
+   if(pEntry != NULL)
+   {
+      pEntry->type = GlowElementType_Node;
+
+      if(fields & GlowFieldFlag_Identifier)
+         pEntry->identifier = internString(pThis, pNode->pIdentifier);
+
+      if(fields & GlowFieldFlag_IsOnline)
+         pEntry->isOnline = pNode->isOnline;
+
+      addFields(pEntry, fields);
+   }
+
+   return pEntry;
+}
+
+const GlowMirrorEntry *glowMirror_applyParameter(GlowMirror *pThis,
+                                                 const GlowParameter *pParameter,
+                                                 GlowFieldFlags fields,
+                                                 const berint *pPath,
+                                                 int pathLength)
+{
+   GlowMirrorEntry *pEntry;
+
+   ASSERT(pThis != NULL);
+   ASSERT(pParameter != NULL);
+   ASSERT(pPath != NULL);
+   ASSERT(pathLength > 0);
+
+   pEntry = getEntry(pThis, pPath, pathLength);
+
+   if(pEntry != NULL)
+   {
+      pEntry->type = GlowElementType_Parameter;
+
+      if(fields & GlowFieldFlag_Identifier)
+         pEntry->identifier = internString(pThis, pParameter->pIdentifier);
+
+      if(fields & GlowFieldFlag_IsOnline)
+         pEntry->isOnline = pParameter->isOnline;
+
+      if(fields & GlowFieldFlag_Type)
+         pEntry->choice.parameter.type = pParameter->type;
+
+      if(fields & GlowFieldFlag_Access)
+         pEntry->choice.parameter.access = pParameter->access;
+
+      if(fields & GlowFieldFlag_StreamIdentifier)
+         pEntry->choice.parameter.streamIdentifier = pParameter->streamIdentifier;
+
+      if(fields & GlowFieldFlag_Value)
+         setValue(pThis, pEntry, &pParameter->value);
+
+      addFields(pEntry, fields);
+   }
+
+   return pEntry;
+}
+
+const GlowMirrorEntry *glowMirror_applyMatrix(GlowMirror *pThis,
+                                              const GlowMatrix *pMatrix,
+                                              const berint *pPath,
+                                              int pathLength)
+{
+   GlowMirrorEntry *pEntry;
+
+   ASSERT(pThis != NULL);
+   ASSERT(pMatrix != NULL);
+   ASSERT(pPath != NULL);
+   ASSERT(pathLength > 0);
+
+   pEntry = getEntry(pThis, pPath, pathLength);
+
+   if(pEntry != NULL)
+   {
+      pEntry->type = GlowElementType_Matrix;
+
+      // the identifier is mandatory in the matrix contents
+      if(pMatrix->pIdentifier != NULL)
+      {
+         pEntry->identifier = internString(pThis, pMatrix->pIdentifier);
+         pEntry->choice.matrix.type = pMatrix->type;
+         pEntry->choice.matrix.targetCount = pMatrix->targetCount;
+         pEntry->choice.matrix.sourceCount = pMatrix->sourceCount;
+         addFields(pEntry, (GlowFieldFlags)(GlowFieldFlag_Identifier | GlowFieldFlag_Type));
+      }
+   }
+
+   return pEntry;
+}
+
+void glowMirror_onNode(const GlowNode *pNode, GlowFieldFlags fields, const berint *pPath, int pathLength, voidptr state)
+{
+   glowMirror_applyNode((GlowMirror *)state, pNode, fields, pPath, pathLength);
+}
+
+void glowMirror_onParameter(const GlowParameter *pParameter, GlowFieldFlags fields, const berint *pPath, int pathLength, voidptr state)
+{
+   glowMirror_applyParameter((GlowMirror *)state, pParameter, fields, pPath, pathLength);
+}
+
+void glowMirror_onMatrix(const GlowMatrix *pMatrix, const berint *pPath, int pathLength, voidptr state)
+{
+   glowMirror_applyMatrix((GlowMirror *)state, pMatrix, pPath, pathLength);
+}
+
+const GlowMirrorEntry *glowMirror_find(const GlowMirror *pThis, const berint *pPath, int pathLength)
+{
+   int mask;
+   int index;
+   dword hash = HASH_SEED;
+   const GlowMirrorEntry *pEntry;
+
+   ASSERT(pThis != NULL);
+   ASSERT(pPath != NULL || pathLength == 0);
+
+   if(pathLength <= 0)
+      return NULL;
+
+   for(index = 0; index < pathLength; index++)
+      hash = hashNumber(hash, pPath[index]);
+
+   hash = toEntryHash(hash);
+   mask = pThis->capacity - 1;
+
+   for(index = (int)(hash & mask); pThis->pEntries[index].hash != 0; index = (index + 1) & mask)
+   {
+      pEntry = &pThis->pEntries[index];
+
+      if(pEntry->hash == hash && matchesPath(pThis, pEntry, pPath, pathLength))
+         return pEntry;
+   }
+
+   return NULL;
+}
+
+const GlowMirrorEntry *glowMirror_getParent(const GlowMirror *pThis, const GlowMirrorEntry *pEntry)
+{
+   ASSERT(pThis != NULL);
+   ASSERT(pEntry != NULL);
+
+   return pEntry->parent != GLOW_MIRROR_NO_ENTRY
+          ? &pThis->pEntries[pEntry->parent]
+          : NULL;
+}
+
+const GlowMirrorEntry *glowMirror_next(const GlowMirror *pThis, const GlowMirrorEntry *pPrevious)
+{
+   const GlowMirrorEntry *pEntry;
+   const GlowMirrorEntry *pEnd;
+
+   ASSERT(pThis != NULL);
+
+   pEntry = pPrevious != NULL ? pPrevious + 1 : pThis->pEntries;
+   pEnd = pThis->pEntries + pThis->capacity;
+
+   for( ; pEntry < pEnd; pEntry++)
+   {
+      if(pEntry->hash != 0)
+         return pEntry;
+   }
+
+   return NULL;
+}
+
+int glowMirror_getPath(const GlowMirror *pThis, const GlowMirrorEntry *pEntry, berint *pPath, int maxPathLength)
+{
+   const GlowMirrorEntry *pParent;
+   int length = 0;
+   int index;
+
+   ASSERT(pThis != NULL);
+   ASSERT(pEntry != NULL);
+   ASSERT(pPath != NULL || maxPathLength == 0);
+
+   for(pParent = pEntry; pParent != NULL; pParent = glowMirror_getParent(pThis, pParent))
+      length++;
+
+   if(length > maxPathLength)
+      return -1;
+
+   for(index = length - 1; pEntry != NULL; index--)
+   {
+      pPath[index] = pEntry->number;
+      pEntry = glowMirror_getParent(pThis, pEntry);
+   }
+
+   return length;
+}
+
+pcstr glowMirror_getString(const GlowMirror *pThis, int offset)
+{
+   ASSERT(pThis != NULL);
+
+   return offset != GLOW_MIRROR_NO_STRING
+          ? pThis->pStrings + offset
+          : NULL;
+}
@@ -0,0 +1,368 @@
+/*
+   libember_slim -- ANSI C implementation of the Ember+ Protocol
+   Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef __LIBEMBER_SLIM_GLOWMIRROR_H
+#define __LIBEMBER_SLIM_GLOWMIRROR_H
+
+#include "glowrx.h"
+
+/**
+  * The index of a GlowMirrorEntry that does not exist, e.g.
+  * the parent of a top-level element.
+  */
+#define GLOW_MIRROR_NO_ENTRY (-1)
+
+/**
+  * The offset of a string that has not been received or could
+  * not be stored.
+  */
+#define GLOW_MIRROR_NO_STRING (-1)
+
+
+// ====================================================================
+//
+// GlowMirrorEntry
+//
+// ====================================================================
+
+/**
+  * Holds the state of a single element received by a consumer.
+  * Strings are stored as offsets into the string pool of the
+  * GlowMirror and can be resolved with glowMirror_getString.
+  */
+typedef struct SGlowMirrorEntry
+{
+   /**
+     * Private field.
+     */
+   dword hash;
+
+   /**
+     * The index of the entry of the parent element, or
+     * GLOW_MIRROR_NO_ENTRY for a top-level element.
+     */
+   int parent;
+
+   /**
+     * The number of the element.
+     */
+   berint number;
+
+   /**
+     * The type of the element. Entries that have been created for
+     * the parents of a qualified element are nodes.
+     */
+   GlowElementType type;
+
+   /**
+     * All fields that have been received for this element. This
+     * is GlowFieldFlag_None for entries that have only been
+     * created as parents of other elements.
+     * For matrices, GlowFieldFlag_Identifier and GlowFieldFlag_Type
+     * are set once the matrix contents have been received.
+     */
+   GlowFieldFlags fields;
+
+   /**
+     * The offset of the interned "identifier" field.
+     */
+   int identifier;
+
+   /**
+     * The "isOnline" field, initialized to true.
+     */
+   bool isOnline;
+
+   union
+   {
+      /**
+        * The fields of an entry with type GlowElementType_Parameter.
+        */
+      struct
+      {
+         /**
+           * The "type" field.
+           */
+         GlowParameterType type;
+
+         /**
+           * The "access" field.
+           */
+         GlowAccess access;
+
+         /**
+           * The "streamIdentifier" field.
+           */
+         berint streamIdentifier;
+
+         /**
+           * The type of the stored value. Octets values are not
+           * stored, their flag is GlowParameterType_Octets.
+           * If valueFlag is GlowParameterType_String, value.string
+           * is the offset of the interned string.
+           */
+         GlowParameterType valueFlag;
+
+         union
+         {
+            berlong integer;
+            glowreal real;
+            bool boolean;
+            int string;
+         } value;
+      } parameter;
+
+      /**
+        * The fields of an entry with type GlowElementType_Matrix.
+        */
+      struct
+      {
+         /**
+           * The "type" field.
+           */
+         GlowMatrixType type;
+
+         /**
+           * The "targetCount" field.
+           */
+         berint targetCount;
+
+         /**
+           * The "sourceCount" field.
+           */
+         berint sourceCount;
+      } matrix;
+   } choice;
+} GlowMirrorEntry;
+
+
+// ====================================================================
+//
+// GlowMirror
+//
+// ====================================================================
+
+/**
+  * Keeps the state of the elements received by a consumer in
+  * memory provided by the caller, so that a consumer does not
+  * have to maintain its own lists.
+  * The entries are kept in an open-addressed hash table keyed
+  * by the path of an element, which allows to look up an element
+  * in constant time. Identifiers and string values are interned
+  * in a string pool, so that the identifiers shared by many
+  * elements are stored only once.
+  * Entries are never removed or moved, a pointer to an entry
+  * remains valid until glowMirror_clear is called.
+  * To keep the probe sequences short, at most three quarters of
+  * the entries and string slots are used. Elements and strings
+  * that don't fit are dropped and isOverflow is set.
+  */
+typedef struct SGlowMirror
+{
+   /**
+     * Private field.
+     */
+   GlowMirrorEntry *pEntries;
+
+   /**
+     * Private field.
+     */
+   int *pStringSlots;
+
+   /**
+     * Private field.
+     */
+   int capacity;
+
+   /**
+     * Private field.
+     */
+   int entryCount;
+
+   /**
+     * Private field.
+     */
+   int stringCount;
+
+   /**
+     * Private field.
+     */
+   char *pStrings;
+
+   /**
+     * Private field.
+     */
+   int stringsSize;
+
+   /**
+     * Private field.
+     */
+   int stringsLength;
+
+   /**
+     * Set when an element or a string has been dropped because
+     * the mirror was full.
+     */
+   bool isOverflow;
+} GlowMirror;
+
+/**
+  * Initializes an empty GlowMirror instance.
+  * @param pThis pointer to the object to process.
+  * @param pEntries pointer to an array of @p capacity entries.
+  * @param pStringSlots pointer to an array of @p capacity ints,
+  *     which is used to look up interned strings.
+  * @param capacity the number of entries and string slots, must
+  *     be a power of two.
+  * @param pStrings pointer to the memory location to store the
+  *     interned strings at.
+  * @param stringsSize the number of bytes at @p pStrings.
+  */
+void glowMirror_init(GlowMirror *pThis,
+                     GlowMirrorEntry *pEntries,
+                     int *pStringSlots,
+                     int capacity,
+                     char *pStrings,
+                     int stringsSize);
+
+/**
+  * Removes all entries and strings from a GlowMirror, e.g.
+  * after the connection to the provider has been lost.
+  * @param pThis pointer to the object to process.
+  */
+void glowMirror_clear(GlowMirror *pThis);
+
+/**
+  * Stores the fields of a node, as passed to onNode_t.
+  * Entries are created for all parents of the node that are
+  * not stored yet.
+  * @param pThis pointer to the object to process.
+  * @param pNode pointer to the received node.
+  * @param fields the fields that are set in @p pNode.
+  * @param pPath pointer to the first number in the path of the node.
+  * @param pathLength number of node numbers at @p pPath.
+  * @return the entry of the node, or NULL if the mirror is full.
+  */
+const GlowMirrorEntry *glowMirror_applyNode(GlowMirror *pThis,
+                                            const GlowNode *pNode,
+                                            GlowFieldFlags fields,
+                                            const berint *pPath,
+                                            int pathLength);
+
+/**
+  * Stores the fields of a parameter, as passed to onParameter_t.
+  * Entries are created for all parents of the parameter that
+  * are not stored yet.
+  * @param pThis pointer to the object to process.
+  * @param pParameter pointer to the received parameter.
+  * @param fields the fields that are set in @p pParameter.
+  * @param pPath pointer to the first number in the path of the parameter.
+  * @param pathLength number of node numbers at @p pPath.
+  * @return the entry of the parameter, or NULL if the mirror is full.
+  */
+const GlowMirrorEntry *glowMirror_applyParameter(GlowMirror *pThis,
+                                                 const GlowParameter *pParameter,
+                                                 GlowFieldFlags fields,
+                                                 const berint *pPath,
+                                                 int pathLength);
+
+/**
+  * Stores the fields of a matrix, as passed to onMatrix_t.
+  * Entries are created for all parents of the matrix that are
+  * not stored yet.
+  * @param pThis pointer to the object to process.
+  * @param pMatrix pointer to the received matrix.
+  * @param pPath pointer to the first number in the path of the matrix.
+  * @param pathLength number of node numbers at @p pPath.
+  * @return the entry of the matrix, or NULL if the mirror is full.
+  */
+const GlowMirrorEntry *glowMirror_applyMatrix(GlowMirror *pThis,
+                                              const GlowMatrix *pMatrix,
+                                              const berint *pPath,
+                                              int pathLength);
+
+/**
+  * Callback that can be passed to glowReader_init as onNode if
+  * the state passed to the reader is a pointer to a GlowMirror.
+  */
+void glowMirror_onNode(const GlowNode *pNode, GlowFieldFlags fields, const berint *pPath, int pathLength, voidptr state);
+
+/**
+  * Callback that can be passed to glowReader_init as onParameter if
+  * the state passed to the reader is a pointer to a GlowMirror.
+  */
+void glowMirror_onParameter(const GlowParameter *pParameter, GlowFieldFlags fields, const berint *pPath, int pathLength, voidptr state);
+
+/**
+  * Callback that can be assigned to the onMatrix field of a
+  * GlowReader if the state passed to the reader is a pointer
+  * to a GlowMirror.
+  */
+void glowMirror_onMatrix(const GlowMatrix *pMatrix, const berint *pPath, int pathLength, voidptr state);
+
+/**
+  * Looks up the entry of an element by its path.
+  * @param pThis pointer to the object to process.
+  * @param pPath pointer to the first number in the path of the element.
+  * @param pathLength number of node numbers at @p pPath.
+  * @return the entry of the element, or NULL if the element
+  *     has not been stored.
+  */
+const GlowMirrorEntry *glowMirror_find(const GlowMirror *pThis, const berint *pPath, int pathLength);
+
+/**
+  * Returns the entry of the parent of an element.
+  * @param pThis pointer to the object to process.
+  * @param pEntry pointer to the entry of the element.
+  * @return the entry of the parent, or NULL for a top-level element.
+  */
+const GlowMirrorEntry *glowMirror_getParent(const GlowMirror *pThis, const GlowMirrorEntry *pEntry);
+
+/**
+  * Returns the stored entry that follows another one, which can
+  * be used to enumerate all entries in no particular order.
+  * @param pThis pointer to the object to process.
+  * @param pPrevious pointer to the previous entry, or NULL to
+  *     get the first entry.
+  * @return the next entry, or NULL if there are no more entries.
+  */
+const GlowMirrorEntry *glowMirror_next(const GlowMirror *pThis, const GlowMirrorEntry *pPrevious);
+
+/**
+  * Writes the path of an element.
+  * @param pThis pointer to the object to process.
+  * @param pEntry pointer to the entry of the element.
+  * @param pPath pointer to the location to write the path to.
+  * @param maxPathLength the number of node numbers that fit at @p pPath.
+  * @return the length of the path, or -1 if the path does not
+  *     fit at @p pPath.
+  */
+int glowMirror_getPath(const GlowMirror *pThis, const GlowMirrorEntry *pEntry, berint *pPath, int maxPathLength);
+
+/**
+  * Resolves the offset of an interned string, e.g. the
+  * identifier of an entry.
+  * @param pThis pointer to the object to process.
+  * @param offset the offset of the string.
+  * @return the zero-terminated string, or NULL if @p offset
+  *     is GLOW_MIRROR_NO_STRING.
+  */
+pcstr glowMirror_getString(const GlowMirror *pThis, int offset);
+
+#endif
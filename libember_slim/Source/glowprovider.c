@@ -0,0 +1,363 @@
+/*
+   libember_slim -- ANSI C implementation of the Ember+ Protocol
+   Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <string.h>
+#include "glowprovider.h"
+#include "emberinternal.h"
+
+
+// ====================================================================
+//
+// GlowProvider locals
+//
+// ====================================================================
+
+static const GlowProviderElement *findChild(const GlowProviderElement *pElement, berint number)
+{
+   int first = 0;
+   int last = pElement->childrenCount - 1;
+   int middle;
+   const GlowProviderElement *pChild;
+
+   while(first <= last)
+   {
+      middle = first + (last - first) / 2;
+      pChild = &pElement->pChildren[middle];
+
+      if(pChild->number == number)
+         return pChild;
+
+      if(pChild->number < number)
+         first = middle + 1;
+      else
+         last = middle - 1;
+   }
+
+   return NULL;
+}
+
+static void writeElement(GlowOutput *pOut, const GlowProviderElement *pElement, GlowFieldFlags fields, const berint *pPath, int pathLength)
+{
+   GlowParameter parameter;
+
+   switch(pElement->type)
+   {
+      case GlowElementType_Node:
+         glow_writeQualifiedNode(pOut, (const GlowNode *)pElement->pGlow, fields, pPath, pathLength);
+         break;
+
+      case GlowElementType_Parameter:
+         // the description is constant, only the value is taken from RAM
+         parameter = *(const GlowParameter *)pElement->pGlow;
+
+         if(pElement->pValue != NULL)
+            parameter.value = *pElement->pValue;
+
+         glow_writeQualifiedParameter(pOut, &parameter, fields, pPath, pathLength);
+         break;
+
+      case GlowElementType_Matrix:
+         glow_writeQualifiedMatrix(pOut, (const GlowMatrix *)pElement->pGlow, fields, pPath, pathLength);
+         break;
+
+      default:
+         throwError(601, "GlowProviderElement has unsupported type!");
+         break;
+   }
+}
+
+static void writeDirectory(GlowProvider *pThis, const GlowProviderElement *pElement, GlowFieldFlags dirFieldMask, const berint *pPath, int pathLength)
+{
+   GlowOutput output;
+   berint path[GLOW_MAX_TREE_DEPTH];
+   const GlowProviderElement *pChild;
+   int index;
+
+   glowOutput_initMultiPackage(&output, pThis->pTxBuffer, pThis->txBufferSize, pThis->slotId, pThis->onPackageReady, pThis->state);
+   glowOutput_beginPackage(&output, true);
+
+   if(pElement->type != GlowElementType_Node)
+   {
+      // parameter or matrix - send the element itself
+      writeElement(&output, pElement, (GlowFieldFlags)(pElement->fields & dirFieldMask), pPath, pathLength);
+   }
+   else if(pElement->childrenCount == 0)
+   {
+      // leaf node - send single empty node
+      writeElement(&output, pElement, GlowFieldFlag_None, pPath, pathLength);
+   }
+   else if(pathLength < GLOW_MAX_TREE_DEPTH)
+   {
+      // node - send children
+      memcpy(path, pPath, pathLength * sizeof(berint));
+
+      for(index = 0; index < pElement->childrenCount; index++)
+      {
+         pChild = &pElement->pChildren[index];
+         path[pathLength] = pChild->number;
+
+         writeElement(&output, pChild, (GlowFieldFlags)(pChild->fields & dirFieldMask), path, pathLength + 1);
+      }
+   }
+
+   pThis->onPackageReady(pThis->pTxBuffer, glowOutput_finishPackage(&output), pThis->state);
+}
+
+static void subscribeStream(GlowProvider *pThis, const GlowProviderElement *pElement, bool isSubscribe)
+{
+   const GlowParameter *pGlow;
+   byte *pCount;
+
+   if(pElement->type != GlowElementType_Parameter
+   || (pElement->fields & GlowFieldFlag_StreamIdentifier) != GlowFieldFlag_StreamIdentifier)
+      return;
+
+   pGlow = (const GlowParameter *)pElement->pGlow;
+
+   if(pGlow->streamIdentifier < 0
+   || pGlow->streamIdentifier >= GLOW_PROVIDER_MAX_STREAMS)
+      return;
+
+   pCount = &pThis->subscriptions[pGlow->streamIdentifier];
+
+   if(isSubscribe)
+   {
+      if(*pCount == 0xFF)
+         return;
+
+      if(*pCount == 0)
+         pThis->subscribedStreamCount++;
+
+      (*pCount)++;
+   }
+   else if(*pCount > 0)
+   {
+      (*pCount)--;
+
+      if(*pCount == 0)
+         pThis->subscribedStreamCount--;
+   }
+}
+
+static void onCommand(const GlowCommand *pCommand, const berint *pPath, int pathLength, voidptr state)
+{
+   glowProvider_handleCommand((GlowProvider *)state, pCommand, pPath, pathLength);
+}
+
+static void onParameter(const GlowParameter *pParameter, GlowFieldFlags fields, const berint *pPath, int pathLength, voidptr state)
+{
+   glowProvider_handleParameter((GlowProvider *)state, pParameter, fields, pPath, pathLength);
+}
+
+
+// ====================================================================
+//
+// GlowProvider globals
+//
+// ====================================================================
+
+void glowProvider_init(GlowProvider *pThis,
+                       const GlowProviderElement *pRoot,
+                       byte *pTxBuffer,
+                       unsigned int txBufferSize,
+                       byte slotId,
+                       onPackageReady_t onPackageReady,
+                       voidptr state)
+{
+   ASSERT(pThis != NULL);
+   ASSERT(pRoot != NULL);
+   ASSERT(pTxBuffer != NULL);
+   ASSERT(onPackageReady != NULL);
+
+   bzero(*pThis);
+
+   pThis->pRoot = pRoot;
+   pThis->pTxBuffer = pTxBuffer;
+   pThis->txBufferSize = txBufferSize;
+   pThis->slotId = slotId;
+   pThis->onPackageReady = onPackageReady;
+   pThis->state = state;
+}
+
+void glowProvider_initReader(GlowProvider *pThis,
+                             GlowReader *pReader,
+                             byte *pRxBuffer,
+                             unsigned int rxBufferSize)
+{
+   ASSERT(pThis != NULL);
+   ASSERT(pReader != NULL);
+
+   glowReader_init(pReader, NULL, onParameter, onCommand, NULL, (voidptr)pThis, pRxBuffer, rxBufferSize);
+}
+
+const GlowProviderElement *glowProvider_findElement(const GlowProvider *pThis, const berint *pPath, int pathLength)
+{
+   const GlowProviderElement *pCursor;
+   int index;
+
+   ASSERT(pThis != NULL);
+   ASSERT(pPath != NULL || pathLength == 0);
+
+   pCursor = pThis->pRoot;
+
+   for(index = 0; index < pathLength && pCursor != NULL; index++)
+      pCursor = findChild(pCursor, pPath[index]);
+
+   return pCursor;
+}
+
+void glowProvider_handleCommand(GlowProvider *pThis, const GlowCommand *pCommand, const berint *pPath, int pathLength)
+{
+   const GlowProviderElement *pElement;
+
+   ASSERT(pThis != NULL);
+   ASSERT(pCommand != NULL);
+
+   pElement = glowProvider_findElement(pThis, pPath, pathLength);
+
+   if(pElement == NULL)
+      return;
+
+   if(pCommand->number == GlowCommandType_GetDirectory)
+   {
+      writeDirectory(pThis, pElement, pCommand->options.dirFieldMask, pPath, pathLength);
+   }
+   else if(pCommand->number == GlowCommandType_Subscribe)
+   {
+      subscribeStream(pThis, pElement, true);
+
+      if(pThis->onSubscribe != NULL)
+         pThis->onSubscribe(pElement, true, pPath, pathLength, pThis->state);
+   }
+   else if(pCommand->number == GlowCommandType_Unsubscribe)
+   {
+      subscribeStream(pThis, pElement, false);
+
+      if(pThis->onSubscribe != NULL)
+         pThis->onSubscribe(pElement, false, pPath, pathLength, pThis->state);
+   }
+}
+
+void glowProvider_handleParameter(GlowProvider *pThis, const GlowParameter *pParameter, GlowFieldFlags fields, const berint *pPath, int pathLength)
+{
+   const GlowProviderElement *pElement;
+   const GlowParameter *pGlow;
+
+   ASSERT(pThis != NULL);
+   ASSERT(pParameter != NULL);
+
+   pElement = glowProvider_findElement(pThis, pPath, pathLength);
+
+   if(pElement == NULL
+   || pElement->type != GlowElementType_Parameter
+   || pElement->pValue == NULL
+   || (fields & GlowFieldFlag_Value) != GlowFieldFlag_Value)
+      return;
+
+   pGlow = (const GlowParameter *)pElement->pGlow;
+
+   if((pGlow->access & GlowAccess_Write) == GlowAccess_Write)
+   {
+      if(pThis->onSetValue == NULL
+      || pThis->onSetValue(pElement, &pParameter->value, pPath, pathLength, pThis->state))
+      {
+         glowValue_free(pElement->pValue);
+         glowValue_copyFrom(pElement->pValue, &pParameter->value);
+      }
+   }
+
+   // report the current value, even if the request has been rejected
+   glowProvider_notifyValue(pThis, pPath, pathLength);
+}
+
+void glowProvider_notifyValue(GlowProvider *pThis, const berint *pPath, int pathLength)
+{
+   GlowOutput output;
+   const GlowProviderElement *pElement;
+
+   ASSERT(pThis != NULL);
+
+   pElement = glowProvider_findElement(pThis, pPath, pathLength);
+
+   if(pElement == NULL
+   || pElement->type != GlowElementType_Parameter)
+      return;
+
+   glowOutput_initMultiPackage(&output, pThis->pTxBuffer, pThis->txBufferSize, pThis->slotId, pThis->onPackageReady, pThis->state);
+   glowOutput_beginPackage(&output, true);
+   writeElement(&output, pElement, GlowFieldFlag_Value, pPath, pathLength);
+   pThis->onPackageReady(pThis->pTxBuffer, glowOutput_finishPackage(&output), pThis->state);
+}
+
+bool glowProvider_isStreamSubscribed(const GlowProvider *pThis, berint streamIdentifier)
+{
+   ASSERT(pThis != NULL);
+
+   return streamIdentifier >= 0
+       && streamIdentifier < GLOW_PROVIDER_MAX_STREAMS
+       && pThis->subscriptions[streamIdentifier] > 0;
+}
+
+void glowProvider_tick(GlowProvider *pThis)
+{
+   GlowOutput output;
+   GlowStreamEntry entry;
+   const GlowValue *pValue;
+   bool hasEntries = false;
+   int index;
+
+   ASSERT(pThis != NULL);
+
+   pThis->tickCount++;
+
+   if(pThis->tickCount < pThis->streamInterval)
+      return;
+
+   pThis->tickCount = 0;
+
+   if(pThis->onStreamValue == NULL
+   || pThis->subscribedStreamCount == 0)
+      return;
+
+   for(index = 0; index < GLOW_PROVIDER_MAX_STREAMS; index++)
+   {
+      if(pThis->subscriptions[index] == 0)
+         continue;
+
+      pValue = pThis->onStreamValue((berint)index, pThis->state);
+
+      if(pValue == NULL)
+         continue;
+
+      // the package is only started once there is something to send
+      if(hasEntries == false)
+      {
+         glowOutput_initMultiPackage(&output, pThis->pTxBuffer, pThis->txBufferSize, pThis->slotId, pThis->onPackageReady, pThis->state);
+         glowOutput_beginStreamPackage(&output, true);
+         hasEntries = true;
+      }
+
+      entry.streamIdentifier = (berint)index;
+      entry.streamValue = *pValue;
+      glow_writeStreamEntry(&output, &entry);
+   }
+
+   if(hasEntries)
+      pThis->onPackageReady(pThis->pTxBuffer, glowOutput_finishPackage(&output), pThis->state);
+}
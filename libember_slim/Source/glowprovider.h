@@ -0,0 +1,338 @@
+/*
+   libember_slim -- ANSI C implementation of the Ember+ Protocol
+   Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef __LIBEMBER_SLIM_GLOWPROVIDER_H
+#define __LIBEMBER_SLIM_GLOWPROVIDER_H
+
+#include "glowtx.h"
+#include "glowrx.h"
+
+#ifndef GLOW_PROVIDER_MAX_STREAMS
+/**
+  * The number of stream identifiers a GlowProvider keeps track of.
+  * Subscriptions to parameters with a stream identifier of this
+  * value or greater are passed to onSubscribe, but never streamed
+  * by glowProvider_tick.
+  * Defines the size of the subscription table embedded in every
+  * GlowProvider instance, one byte per stream.
+  */
+#define GLOW_PROVIDER_MAX_STREAMS (64)
+#endif
+
+// ====================================================================
+//
+// GlowProviderElement
+//
+// ====================================================================
+
+/**
+  * Describes an element of a provider tree.
+  * The tree is meant to be defined as a const table, so that
+  * it can be placed in ROM. Only parameter values, which may
+  * change at runtime, are referenced through a pointer to RAM.
+  */
+typedef struct SGlowProviderElement
+{
+   /**
+     * The number of the element, unique among its siblings.
+     */
+   berint number;
+
+   /**
+     * The type of the element. Must be GlowElementType_Node,
+     * GlowElementType_Parameter or GlowElementType_Matrix.
+     */
+   GlowElementType type;
+
+   /**
+     * The fields of the element that are reported to
+     * consumers.
+     */
+   GlowFieldFlags fields;
+
+   /**
+     * Points to a GlowNode, GlowParameter or GlowMatrix,
+     * depending on type.
+     */
+   const void *pGlow;
+
+   /**
+     * Only used for parameters: points to the current value
+     * of the parameter, which replaces the value at pGlow.
+     * Must be set for parameters that may be written by
+     * consumers. May be NULL for constant parameters.
+     */
+   GlowValue *pValue;
+
+   /**
+     * Points to the children of the element, sorted by number
+     * in ascending order. May be NULL if childrenCount is 0.
+     */
+   const struct SGlowProviderElement *pChildren;
+
+   /**
+     * The number of elements at pChildren.
+     */
+   int childrenCount;
+} GlowProviderElement;
+
+
+// ====================================================================
+//
+// GlowProvider
+//
+// ====================================================================
+
+/**
+  * Function type used by GlowProvider to notify the application
+  * that a consumer wants to set the value of a parameter.
+  * @param pElement the provider element of the parameter.
+  * @param pValue the value requested by the consumer.
+  * @param pPath the path of the parameter.
+  * @param pathLength the number of sub-identifiers at @p pPath.
+  * @param state application-defined state as stored in GlowProvider.
+  * @return true to store the value in the parameter's pValue,
+  *     false to reject it.
+  */
+typedef bool (*onSetValue_t)(const GlowProviderElement *pElement, const GlowValue *pValue, const berint *pPath, int pathLength, voidptr state);
+
+/**
+  * Function type used by GlowProvider to notify the application
+  * that a consumer has subscribed to or unsubscribed from an element.
+  * @param pElement the provider element.
+  * @param isSubscribe true if the consumer subscribed, false if it
+  *     unsubscribed.
+  * @param pPath the path of the element.
+  * @param pathLength the number of sub-identifiers at @p pPath.
+  * @param state application-defined state as stored in GlowProvider.
+  */
+typedef void (*onSubscribe_t)(const GlowProviderElement *pElement, bool isSubscribe, const berint *pPath, int pathLength, voidptr state);
+
+/**
+  * Function type used by GlowProvider to query the current value
+  * of a stream the consumer has subscribed to.
+  * @param streamIdentifier the identifier of the stream.
+  * @param state application-defined state as stored in GlowProvider.
+  * @return pointer to the value to send, which must stay valid
+  *     until glowProvider_tick returns, or NULL to skip the stream
+  *     in this tick, e.g. because its value has not changed.
+  */
+typedef const GlowValue *(*onStreamValue_t)(berint streamIdentifier, voidptr state);
+
+/**
+  * Answers the requests of a consumer from a tree of
+  * GlowProviderElement structures.
+  * GetDirectory commands are answered with the children of the
+  * addressed element, parameter values written by the consumer are
+  * stored and reported back, and subscriptions are passed to the
+  * application. All responses are passed to onPackageReady.
+  * The provider also keeps track of the streams the consumer has
+  * subscribed to, so that glowProvider_tick can send the values
+  * of all subscribed streams without scanning the tree.
+  */
+typedef struct SGlowProvider
+{
+   /**
+     * Private field.
+     */
+   const GlowProviderElement *pRoot;
+
+   /**
+     * Private field.
+     */
+   byte *pTxBuffer;
+
+   /**
+     * Private field.
+     */
+   unsigned int txBufferSize;
+
+   /**
+     * Private field.
+     */
+   byte slotId;
+
+   /**
+     * Callback function invoked with every framed package
+     * that has to be transmitted to the consumer.
+     */
+   onPackageReady_t onPackageReady;
+
+   /**
+     * May be set to a callback function called when
+     * a consumer sets the value of a parameter.
+     * If NULL, all values are accepted.
+     */
+   onSetValue_t onSetValue;
+
+   /**
+     * May be set to a callback function called when
+     * a consumer subscribes to or unsubscribes from an element.
+     */
+   onSubscribe_t onSubscribe;
+
+   /**
+     * May be set to a callback function called by glowProvider_tick
+     * for every stream the consumer has subscribed to.
+     * If NULL, no streams are sent.
+     */
+   onStreamValue_t onStreamValue;
+
+   /**
+     * The number of calls to glowProvider_tick between two
+     * stream packages. If 0 or 1, streams are sent on every tick.
+     */
+   unsigned int streamInterval;
+
+   /**
+     * Application-defined argument passed to callback
+     * functions.
+     */
+   voidptr state;
+
+   /**
+     * Private field.
+     */
+   unsigned int tickCount;
+
+   /**
+     * Private field.
+     */
+   int subscribedStreamCount;
+
+   /**
+     * Private field. The number of subscribed parameters
+     * per stream identifier, since parameters may share a
+     * stream by means of a stream descriptor.
+     */
+   byte subscriptions[GLOW_PROVIDER_MAX_STREAMS];
+} GlowProvider;
+
+/**
+  * Initializes a GlowProvider instance.
+  * @param pThis pointer to the object to process.
+  * @param pRoot pointer to the root element of the tree. The
+  *     children of the root element are the top-level elements
+  *     reported to consumers. The other fields of the root element
+  *     are not used.
+  * @param pTxBuffer pointer to the memory location to encode
+  *     responses to.
+  * @param txBufferSize number of bytes at @p pTxBuffer. Responses
+  *     that do not fit are split into multiple packages.
+  * @param slotId the slot id as described in the framing
+  *     protocol documentation.
+  * @param onPackageReady callback function invoked with every
+  *     package that has to be transmitted.
+  * @param state application-defined argument passed to
+  *     callback functions.
+  */
+void glowProvider_init(GlowProvider *pThis,
+                       const GlowProviderElement *pRoot,
+                       byte *pTxBuffer,
+                       unsigned int txBufferSize,
+                       byte slotId,
+                       onPackageReady_t onPackageReady,
+                       voidptr state);
+
+/**
+  * Initializes a GlowReader that passes all commands and
+  * parameters it reads to the passed GlowProvider.
+  * @param pThis pointer to the provider to pass requests to.
+  * @param pReader pointer to the reader to initialize.
+  * @param pRxBuffer pointer to the memory location to unframe
+  *     packages to.
+  * @param rxBufferSize number of available bytes at @p pRxBuffer.
+  * @note you need to call glowReader_free to release
+  *     all memory allocated by this function.
+  */
+void glowProvider_initReader(GlowProvider *pThis,
+                             GlowReader *pReader,
+                             byte *pRxBuffer,
+                             unsigned int rxBufferSize);
+
+/**
+  * Looks up an element of the provider tree.
+  * The children of each element are searched using binary search.
+  * @param pThis pointer to the object to process.
+  * @param pPath the path of the element to look up.
+  * @param pathLength the number of sub-identifiers at @p pPath.
+  *     If 0, the root element is returned.
+  * @return pointer to the element, or NULL if the path does not
+  *     address an element of the tree.
+  */
+const GlowProviderElement *glowProvider_findElement(const GlowProvider *pThis, const berint *pPath, int pathLength);
+
+/**
+  * Answers a command sent by a consumer.
+  * GetDirectory, Subscribe and Unsubscribe are supported, other
+  * commands and paths that do not address an element are ignored.
+  * Subscribing to a parameter that reports a stream identifier
+  * adds the stream to the ones sent by glowProvider_tick.
+  * @param pThis pointer to the object to process.
+  * @param pCommand the command read from the consumer.
+  * @param pPath the path of the element the command refers to.
+  * @param pathLength the number of sub-identifiers at @p pPath.
+  */
+void glowProvider_handleCommand(GlowProvider *pThis, const GlowCommand *pCommand, const berint *pPath, int pathLength);
+
+/**
+  * Answers a parameter sent by a consumer.
+  * If it carries a value and the addressed parameter is writable,
+  * the value is passed to onSetValue and stored on acceptance.
+  * The current value is then reported back to the consumer.
+  * @param pThis pointer to the object to process.
+  * @param pParameter the parameter read from the consumer.
+  * @param fields the fields present in @p pParameter.
+  * @param pPath the path of the parameter.
+  * @param pathLength the number of sub-identifiers at @p pPath.
+  */
+void glowProvider_handleParameter(GlowProvider *pThis, const GlowParameter *pParameter, GlowFieldFlags fields, const berint *pPath, int pathLength);
+
+/**
+  * Reports the current value of a parameter to the consumer,
+  * e.g. after the application has changed it.
+  * @param pThis pointer to the object to process.
+  * @param pPath the path of the parameter.
+  * @param pathLength the number of sub-identifiers at @p pPath.
+  */
+void glowProvider_notifyValue(GlowProvider *pThis, const berint *pPath, int pathLength);
+
+/**
+  * Returns whether the consumer has subscribed to at least one
+  * parameter reporting the passed stream identifier.
+  * @param pThis pointer to the object to process.
+  * @param streamIdentifier the identifier of the stream.
+  * @return true if the stream is subscribed.
+  */
+bool glowProvider_isStreamSubscribed(const GlowProvider *pThis, berint streamIdentifier);
+
+/**
+  * Advances the stream scheduler by one tick. Meant to be called
+  * periodically by the application, e.g. from a timer.
+  * Every streamInterval ticks, the values of all subscribed streams
+  * are queried through onStreamValue and written as stream entries
+  * of a single StreamCollection, which is only split into several
+  * packages if it does not fit into the tx buffer.
+  * Nothing is sent if the consumer has not subscribed to any stream
+  * or if onStreamValue skips all of them.
+  * @param pThis pointer to the object to process.
+  */
+void glowProvider_tick(GlowProvider *pThis);
+
+#endif
@@ -19,6 +19,7 @@
 
 #include <string.h>
 #include "glowrx.h"
+#include "embercompression.h"
 #include "emberinternal.h"
 
 
@@ -31,14 +32,57 @@
 bool glow_assertIdentifierValid(pcstr pIdentifier, bool isRx);
 
 
+// ====================================================================
+//
+// NonFramingGlowReader storage
+//
+// ====================================================================
+
+static void *allocStorage(NonFramingGlowReader *pThis, size_t size)
+{
+   byte *pMemory;
+
+#ifndef EMBER_STATIC_MEMORY
+   if(pThis->pStorage == NULL)
+      return allocMemory(size);
+#endif
+
+   // keep every block aligned for the members of GlowValue
+   size = (size + sizeof(double) - 1) / sizeof(double) * sizeof(double);
+
+   if(size > (size_t)(pThis->storageSize - pThis->storageLength))
+   {
+      throwError(511, "glow reader storage exhausted");
+      return NULL;
+   }
+
+   pMemory = &pThis->pStorage[pThis->storageLength];
+   pThis->storageLength += (unsigned int)size;
+   return pMemory;
+}
+
+// the blocks of the storage are released all at once, when the
+// reader starts to decode the next element.
+#define newstoragearr(pThis, type, count) ((type *)allocStorage((pThis), sizeof(type) * (count)))
+#ifdef EMBER_STATIC_MEMORY
+#define freeStorage(pThis, pMemory) ((void)0)
+#define freeElement(pThis, freeFunction, pElement) (bzero(*(pElement)), (pThis)->storageLength = 0)
+#else
+#define freeStorage(pThis, pMemory) ((pThis)->pStorage == NULL ? freeMemory(pMemory) : (void)0)
+#define freeElement(pThis, freeFunction, pElement) ((pThis)->pStorage == NULL ? freeFunction(pElement) : (void)(bzero(*(pElement)), (pThis)->storageLength = 0))
+#endif
+
+
 // ====================================================================
 //
 // NonFramingGlowReader locals
 //
 // ====================================================================
 
-static void readValue(const BerReader *pBase, GlowValue *pValue)
+static void readValue(NonFramingGlowReader *pThis, GlowValue *pValue)
 {
+   const BerReader *pBase = &pThis->base.base;
+
    switch(pBase->type)
    {
       case BerType_Integer:
@@ -48,12 +92,16 @@ static void readValue(const BerReader *pBase, GlowValue *pValue)
 
       case BerType_Real:
          pValue->flag = GlowParameterType_Real;
+#ifdef GLOW_FIXED_REAL_FRACTION_BITS
+         pValue->choice.real = berReader_getFixedReal(pBase, GLOW_FIXED_REAL_FRACTION_BITS);
+#else
          pValue->choice.real = berReader_getReal(pBase);
+#endif
          break;
 
       case BerType_UTF8String:
          pValue->flag = GlowParameterType_String;
-         pValue->choice.pString = newarr(char, pBase->length + 1);
+         pValue->choice.pString = newstoragearr(pThis, char, pBase->length + 1);
          berReader_getString(pBase, pValue->choice.pString, pBase->length);
          break;
 
@@ -66,7 +114,7 @@ static void readValue(const BerReader *pBase, GlowValue *pValue)
          pValue->flag = GlowParameterType_Octets;
          if(pBase->length > 0)
          {
-            pValue->choice.octets.pOctets = newarr(byte, pBase->length);
+            pValue->choice.octets.pOctets = newstoragearr(pThis, byte, pBase->length);
             pValue->choice.octets.length = berReader_getOctetString(pBase, pValue->choice.octets.pOctets, pBase->length);
          }
          else
@@ -93,7 +141,11 @@ static void readMinMax(const BerReader *pBase, GlowMinMax *pMinMax)
 
       case BerType_Real:
          pMinMax->flag = GlowParameterType_Real;
+#ifdef GLOW_FIXED_REAL_FRACTION_BITS
+         pMinMax->choice.real = berReader_getFixedReal(pBase, GLOW_FIXED_REAL_FRACTION_BITS);
+#else
          pMinMax->choice.real = berReader_getReal(pBase);
+#endif
          break;
 
       default:
@@ -104,6 +156,27 @@ static void readMinMax(const BerReader *pBase, GlowMinMax *pMinMax)
 
 typedef void (*onItemReady_t)(NonFramingGlowReader *pThis);
 
+static bool isPathSelected(const NonFramingGlowReader *pThis)
+{
+   int index;
+
+   if(pThis->pathLength < pThis->pathFilterLength)
+      return false;
+
+   for(index = 0; index < pThis->pathFilterLength; index++)
+   {
+      if(pThis->pPath[index] != pThis->pPathFilter[index])
+         return false;
+   }
+
+   return true;
+}
+
+static bool isFieldSelected(const NonFramingGlowReader *pThis, GlowFieldFlags field)
+{
+   return (pThis->fieldMask & field) == field;
+}
+
 static void onItemReady_Node(NonFramingGlowReader *pThis)
 {
    berint number;
@@ -115,7 +188,7 @@ static void onItemReady_Node(NonFramingGlowReader *pThis)
       {
          number = berReader_getInteger(pBase);
 
-         pThis->path[pThis->pathLength] = number;
+         pThis->pPath[pThis->pathLength] = number;
          pThis->pathLength++;
       }
    }
@@ -136,7 +209,7 @@ static void onItemReady_QualifiedNode(NonFramingGlowReader *pThis)
          if(pThis->pathLength != 0)
             throwError(502, "QualifiedNode encountered on non-root level!");
 
-         pThis->pathLength = berReader_getRelativeOid(pBase, pThis->path, GLOW_MAX_TREE_DEPTH);
+         pThis->pathLength = berReader_getRelativeOid(pBase, pThis->pPath, pThis->pathCapacity);
 
          if(pThis->pathLength == 0)
             throwError(501, "empty path in QualifiedNode!");
@@ -152,26 +225,32 @@ static void onItemReady_NodeContents(NonFramingGlowReader *pThis)
 
    if(pBase->isContainer)
    {
-      if(pThis->onNode != NULL)
-         pThis->onNode(&pThis->glow.node, pThis->fields, pThis->path, pThis->pathLength, pThis->state);
+      if(pThis->onNode != NULL && isPathSelected(pThis))
+         pThis->onNode(&pThis->glow.node, pThis->fields, pThis->pPath, pThis->pathLength, pThis->state);
 
-      glowNode_free(&pThis->glow.node);
+      freeElement(pThis, glowNode_free, &pThis->glow.node);
       pThis->fields = GlowFieldFlag_None;
    }
-   else
+   else if(isPathSelected(pThis))
    {
       if(berTag_equals(pTag, &glowTags.nodeContents.identifier))
       {
-         pThis->glow.node.pIdentifier = newarr(char, pBase->length + 1);
-         berReader_getString(pBase, pThis->glow.node.pIdentifier, pBase->length + 1);
-         glow_assertIdentifierValid(pThis->glow.node.pIdentifier, true);
-         fields |= GlowFieldFlag_Identifier;
+         if(isFieldSelected(pThis, GlowFieldFlag_Identifier))
+         {
+            pThis->glow.node.pIdentifier = newstoragearr(pThis, char, pBase->length + 1);
+            berReader_getString(pBase, pThis->glow.node.pIdentifier, pBase->length + 1);
+            glow_assertIdentifierValid(pThis->glow.node.pIdentifier, true);
+            fields |= GlowFieldFlag_Identifier;
+         }
       }
       else if(berTag_equals(pTag, &glowTags.nodeContents.description))
       {
-         pThis->glow.node.pDescription = newarr(char, pBase->length + 1);
-         berReader_getString(pBase, pThis->glow.node.pDescription, pBase->length + 1);
-         fields |= GlowFieldFlag_Description;
+         if(isFieldSelected(pThis, GlowFieldFlag_Description))
+         {
+            pThis->glow.node.pDescription = newstoragearr(pThis, char, pBase->length + 1);
+            berReader_getString(pBase, pThis->glow.node.pDescription, pBase->length + 1);
+            fields |= GlowFieldFlag_Description;
+         }
       }
       else if(berTag_equals(pTag, &glowTags.nodeContents.isRoot))
       {
@@ -185,17 +264,20 @@ static void onItemReady_NodeContents(NonFramingGlowReader *pThis)
       }
       else if(berTag_equals(pTag, &glowTags.nodeContents.schemaIdentifiers))
       {
-         pThis->glow.node.pSchemaIdentifiers = newarr(char, pBase->length + 1);
-         berReader_getString(pBase, pThis->glow.node.pSchemaIdentifiers, pBase->length + 1);
-         fields |= GlowFieldFlag_SchemaIdentifier;
+         if(isFieldSelected(pThis, GlowFieldFlag_SchemaIdentifier))
+         {
+            pThis->glow.node.pSchemaIdentifiers = newstoragearr(pThis, char, pBase->length + 1);
+            berReader_getString(pBase, pThis->glow.node.pSchemaIdentifiers, pBase->length + 1);
+            fields |= GlowFieldFlag_SchemaIdentifier;
+         }
       }
       else
       {
          if(pThis->onUnsupportedTltlv != NULL)
-            pThis->onUnsupportedTltlv(pBase, pThis->path, pThis->pathLength, GlowReaderPosition_NodeContents, pThis->state);
+            pThis->onUnsupportedTltlv(pBase, pThis->pPath, pThis->pathLength, GlowReaderPosition_NodeContents, pThis->state);
       }
 
-      pThis->fields = (GlowFieldFlags)fields;
+      pThis->fields = (GlowFieldFlags)(fields & pThis->fieldMask);
    }
 }
 
@@ -210,7 +292,7 @@ static void onItemReady_Parameter(NonFramingGlowReader *pThis)
       {
          number = berReader_getInteger(pBase);
 
-         pThis->path[pThis->pathLength] = number;
+         pThis->pPath[pThis->pathLength] = number;
          pThis->pathLength++;
       }
    }
@@ -231,7 +313,7 @@ static void onItemReady_QualifiedParameter(NonFramingGlowReader *pThis)
          if(pThis->pathLength != 0)
             throwError(504, "QualifiedParameter encountered on non-root level!");
 
-         pThis->pathLength = berReader_getRelativeOid(pBase, pThis->path, GLOW_MAX_TREE_DEPTH);
+         pThis->pathLength = berReader_getRelativeOid(pBase, pThis->pPath, pThis->pathCapacity);
 
          if(pThis->pathLength == 0)
             throwError(503, "empty path in QualifiedParameter!");
@@ -247,42 +329,57 @@ static void onItemReady_ParameterContents(NonFramingGlowReader *pThis)
 
    if(pBase->isContainer)
    {
-      if(pThis->onParameter != NULL)
-         pThis->onParameter(&pThis->glow.parameter, pThis->fields, pThis->path, pThis->pathLength, pThis->state);
+      if(pThis->onParameter != NULL && isPathSelected(pThis))
+         pThis->onParameter(&pThis->glow.parameter, pThis->fields, pThis->pPath, pThis->pathLength, pThis->state);
 
       // reset read parameter
-      glowParameter_free(&pThis->glow.parameter);
+      freeElement(pThis, glowParameter_free, &pThis->glow.parameter);
       pThis->fields = GlowFieldFlag_None;
    }
-   else
+   else if(isPathSelected(pThis))
    {
       if(berTag_equals(pTag, &glowTags.parameterContents.identifier))
       {
-         pThis->glow.parameter.pIdentifier = newarr(char, pBase->length + 1);
-         berReader_getString(pBase, pThis->glow.parameter.pIdentifier, pBase->length + 1);
-         glow_assertIdentifierValid(pThis->glow.parameter.pIdentifier, true);
-         fields |= GlowFieldFlag_Identifier;
+         if(isFieldSelected(pThis, GlowFieldFlag_Identifier))
+         {
+            pThis->glow.parameter.pIdentifier = newstoragearr(pThis, char, pBase->length + 1);
+            berReader_getString(pBase, pThis->glow.parameter.pIdentifier, pBase->length + 1);
+            glow_assertIdentifierValid(pThis->glow.parameter.pIdentifier, true);
+            fields |= GlowFieldFlag_Identifier;
+         }
       }
       else if(berTag_equals(pTag, &glowTags.parameterContents.description))
       {
-         pThis->glow.parameter.pDescription = newarr(char, pBase->length + 1);
-         berReader_getString(pBase, pThis->glow.parameter.pDescription, pBase->length + 1);
-         fields |= GlowFieldFlag_Description;
+         if(isFieldSelected(pThis, GlowFieldFlag_Description))
+         {
+            pThis->glow.parameter.pDescription = newstoragearr(pThis, char, pBase->length + 1);
+            berReader_getString(pBase, pThis->glow.parameter.pDescription, pBase->length + 1);
+            fields |= GlowFieldFlag_Description;
+         }
       }
       else if(berTag_equals(pTag, &glowTags.parameterContents.value))
       {
-         readValue(pBase, &pThis->glow.parameter.value);
-         fields |= GlowFieldFlag_Value;
+         if(isFieldSelected(pThis, GlowFieldFlag_Value))
+         {
+            readValue(pThis, &pThis->glow.parameter.value);
+            fields |= GlowFieldFlag_Value;
+         }
       }
       else if(berTag_equals(pTag, &glowTags.parameterContents.minimum))
       {
-         readMinMax(pBase, &pThis->glow.parameter.minimum);
-         fields |= GlowFieldFlag_Minimum;
+         if(isFieldSelected(pThis, GlowFieldFlag_Minimum))
+         {
+            readMinMax(pBase, &pThis->glow.parameter.minimum);
+            fields |= GlowFieldFlag_Minimum;
+         }
       }
       else if(berTag_equals(pTag, &glowTags.parameterContents.maximum))
       {
-         readMinMax(pBase, &pThis->glow.parameter.maximum);
-         fields |= GlowFieldFlag_Maximum;
+         if(isFieldSelected(pThis, GlowFieldFlag_Maximum))
+         {
+            readMinMax(pBase, &pThis->glow.parameter.maximum);
+            fields |= GlowFieldFlag_Maximum;
+         }
       }
       else if(berTag_equals(pTag, &glowTags.parameterContents.access))
       {
@@ -316,17 +413,20 @@ static void onItemReady_ParameterContents(NonFramingGlowReader *pThis)
       }
       else if(berTag_equals(pTag, &glowTags.parameterContents.schemaIdentifiers))
       {
-         pThis->glow.parameter.pSchemaIdentifiers = newarr(char, pBase->length + 1);
-         berReader_getString(pBase, pThis->glow.parameter.pSchemaIdentifiers, pBase->length + 1);
-         fields |= GlowFieldFlag_SchemaIdentifier;
+         if(isFieldSelected(pThis, GlowFieldFlag_SchemaIdentifier))
+         {
+            pThis->glow.parameter.pSchemaIdentifiers = newstoragearr(pThis, char, pBase->length + 1);
+            berReader_getString(pBase, pThis->glow.parameter.pSchemaIdentifiers, pBase->length + 1);
+            fields |= GlowFieldFlag_SchemaIdentifier;
+         }
       }
       else
       {
          if(pThis->onUnsupportedTltlv != NULL)
-            pThis->onUnsupportedTltlv(pBase, pThis->path, pThis->pathLength, GlowReaderPosition_ParameterContents, pThis->state);
+            pThis->onUnsupportedTltlv(pBase, pThis->pPath, pThis->pathLength, GlowReaderPosition_ParameterContents, pThis->state);
       }
 
-      pThis->fields = (GlowFieldFlags)fields;
+      pThis->fields = (GlowFieldFlags)(fields & pThis->fieldMask);
    }
 }
 
@@ -335,6 +435,10 @@ static void onItemReady_StreamDescription(NonFramingGlowReader *pThis)
    const BerReader *pBase = &pThis->base.base;
    const BerTag *pTag = &pBase->tag;
 
+   if(isPathSelected(pThis) == false
+   || isFieldSelected(pThis, GlowFieldFlag_StreamDescriptor) == false)
+      return;
+
    if(pBase->isContainer)
    {
       pThis->fields = (GlowFieldFlags)(pThis->fields | GlowFieldFlag_StreamDescriptor);
@@ -363,9 +467,9 @@ static void onItemReady_Command(NonFramingGlowReader *pThis)
          pThis->glow.command.options.dirFieldMask = GlowFieldFlag_All;
 
       if(pThis->onCommand != NULL)
-         pThis->onCommand(&pThis->glow.command, pThis->path, pThis->pathLength, pThis->state);
+         pThis->onCommand(&pThis->glow.command, pThis->pPath, pThis->pathLength, pThis->state);
 
-      glowCommand_free(&pThis->glow.command);
+      freeElement(pThis, glowCommand_free, &pThis->glow.command);
    }
    else
    {
@@ -380,7 +484,7 @@ static void onItemReady_Command(NonFramingGlowReader *pThis)
       else
       {
          if(pThis->onUnsupportedTltlv != NULL)
-            pThis->onUnsupportedTltlv(pBase, pThis->path, pThis->pathLength, GlowReaderPosition_Command, pThis->state);
+            pThis->onUnsupportedTltlv(pBase, pThis->pPath, pThis->pathLength, GlowReaderPosition_Command, pThis->state);
       }
    }
 }
@@ -394,7 +498,7 @@ static void onItemReady_StreamEntry(NonFramingGlowReader *pThis)
       if(pThis->onStreamEntry != NULL)
          pThis->onStreamEntry(&pThis->glow.streamEntry, pThis->state);
 
-      glowValue_free(&pThis->glow.streamEntry.streamValue);
+      freeElement(pThis, glowValue_free, &pThis->glow.streamEntry.streamValue);
    }
    else
    {
@@ -404,12 +508,12 @@ static void onItemReady_StreamEntry(NonFramingGlowReader *pThis)
       }
       else if(berTag_equals(&pBase->tag, &glowTags.streamEntry.streamValue))
       {
-         readValue(pBase, &pThis->glow.streamEntry.streamValue);
+         readValue(pThis, &pThis->glow.streamEntry.streamValue);
       }
       else
       {
          if(pThis->onUnsupportedTltlv != NULL)
-            pThis->onUnsupportedTltlv(pBase, pThis->path, pThis->pathLength, GlowReaderPosition_StreamEntry, pThis->state);
+            pThis->onUnsupportedTltlv(pBase, pThis->pPath, pThis->pathLength, GlowReaderPosition_StreamEntry, pThis->state);
       }
    }
 }
@@ -425,7 +529,7 @@ static void onItemReady_Matrix(NonFramingGlowReader *pThis)
       {
          number = berReader_getInteger(pBase);
 
-         pThis->path[pThis->pathLength] = number;
+         pThis->pPath[pThis->pathLength] = number;
          pThis->pathLength++;
       }
    }
@@ -446,7 +550,7 @@ static void onItemReady_QualifiedMatrix(NonFramingGlowReader *pThis)
          if(pThis->pathLength != 0)
             throwError(509, "QualifiedMatrix encountered on non-root level!");
 
-         pThis->pathLength = berReader_getRelativeOid(pBase, pThis->path, GLOW_MAX_TREE_DEPTH);
+         pThis->pathLength = berReader_getRelativeOid(pBase, pThis->pPath, pThis->pathCapacity);
 
          if(pThis->pathLength == 0)
             throwError(510, "empty path in QualifiedMatrix!");
@@ -462,23 +566,23 @@ static void onItemReady_MatrixContents(NonFramingGlowReader *pThis)
 
    if(pBase->isContainer)
    {
-      if(pThis->onMatrix != NULL)
-         pThis->onMatrix(&pThis->glow.matrix, pThis->path, pThis->pathLength, pThis->state);
+      if(pThis->onMatrix != NULL && isPathSelected(pThis))
+         pThis->onMatrix(&pThis->glow.matrix, pThis->pPath, pThis->pathLength, pThis->state);
 
       // reset read matrix
-      glowMatrix_free(&pThis->glow.matrix);
+      freeElement(pThis, glowMatrix_free, &pThis->glow.matrix);
    }
-   else
+   else if(isPathSelected(pThis))
    {
       if(berTag_equals(pTag, &glowTags.matrixContents.identifier))
       {
-         pThis->glow.matrix.pIdentifier = newarr(char, pBase->length + 1);
+         pThis->glow.matrix.pIdentifier = newstoragearr(pThis, char, pBase->length + 1);
          berReader_getString(pBase, pThis->glow.matrix.pIdentifier, pBase->length + 1);
          glow_assertIdentifierValid(pThis->glow.matrix.pIdentifier, true);
       }
       else if(berTag_equals(pTag, &glowTags.matrixContents.description))
       {
-         pThis->glow.matrix.pDescription = newarr(char, pBase->length + 1);
+         pThis->glow.matrix.pDescription = newstoragearr(pThis, char, pBase->length + 1);
          berReader_getString(pBase, pThis->glow.matrix.pDescription, pBase->length + 1);
       }
       else if(berTag_equals(pTag, &glowTags.matrixContents.type))
@@ -522,30 +626,33 @@ static void onItemReady_MatrixContents(NonFramingGlowReader *pThis)
       }
       else if(berTag_equals(pTag, &glowTags.matrixContents.schemaIdentifiers))
       {
-         pThis->glow.matrix.pSchemaIdentifiers = newarr(char, pBase->length + 1);
+         pThis->glow.matrix.pSchemaIdentifiers = newstoragearr(pThis, char, pBase->length + 1);
          berReader_getString(pBase, pThis->glow.matrix.pSchemaIdentifiers, pBase->length + 1);
       }
       else
       {
          if(pThis->onUnsupportedTltlv != NULL)
-            pThis->onUnsupportedTltlv(pBase, pThis->path, pThis->pathLength, GlowReaderPosition_MatrixContents, pThis->state);
+            pThis->onUnsupportedTltlv(pBase, pThis->pPath, pThis->pathLength, GlowReaderPosition_MatrixContents, pThis->state);
       }
    }
 }
 
 static void onItemReady_Signal(NonFramingGlowReader *pThis, const BerReader *pBase, bool isTarget)
 {
+   if(isPathSelected(pThis) == false)
+      return;
+
    if(pBase->isContainer)
    {
       if(isTarget)
       {
          if(pThis->onTarget != NULL)
-            pThis->onTarget(&pThis->glow.signal, pThis->path, pThis->pathLength, pThis->state);
+            pThis->onTarget(&pThis->glow.signal, pThis->pPath, pThis->pathLength, pThis->state);
       }
       else
       {
          if(pThis->onSource != NULL)
-            pThis->onSource(&pThis->glow.signal, pThis->path, pThis->pathLength, pThis->state);
+            pThis->onSource(&pThis->glow.signal, pThis->pPath, pThis->pathLength, pThis->state);
       }
 
       // reset read signal
@@ -560,7 +667,7 @@ static void onItemReady_Signal(NonFramingGlowReader *pThis, const BerReader *pBa
       else
       {
          if(pThis->onUnsupportedTltlv != NULL)
-            pThis->onUnsupportedTltlv(pBase, pThis->path, pThis->pathLength, GlowReaderPosition_Target, pThis->state);
+            pThis->onUnsupportedTltlv(pBase, pThis->pPath, pThis->pathLength, GlowReaderPosition_Target, pThis->state);
       }
    }
 }
@@ -581,13 +688,13 @@ static void onItemReady_Connection(NonFramingGlowReader *pThis)
 
    if(pBase->isContainer)
    {
-      if(pThis->onConnection != NULL)
-         pThis->onConnection(&pThis->glow.connection, pThis->path, pThis->pathLength, pThis->state);
+      if(pThis->onConnection != NULL && isPathSelected(pThis))
+         pThis->onConnection(&pThis->glow.connection, pThis->pPath, pThis->pathLength, pThis->state);
 
       // reset read connection
-      glowConnection_free(&pThis->glow.connection);
+      freeElement(pThis, glowConnection_free, &pThis->glow.connection);
    }
-   else
+   else if(isPathSelected(pThis))
    {
       if(berTag_equals(&pBase->tag, &glowTags.connection.target))
       {
@@ -597,7 +704,7 @@ static void onItemReady_Connection(NonFramingGlowReader *pThis)
       {
          if(pBase->length > 0)
          {
-            pThis->glow.connection.pSources = newarr(berint, pBase->length);
+            pThis->glow.connection.pSources = newstoragearr(pThis, berint, pBase->length);
             pThis->glow.connection.sourcesLength = berReader_getRelativeOid(pBase, pThis->glow.connection.pSources, pBase->length);
          }
          else
@@ -617,7 +724,7 @@ static void onItemReady_Connection(NonFramingGlowReader *pThis)
       else
       {
          if(pThis->onUnsupportedTltlv != NULL)
-            pThis->onUnsupportedTltlv(pBase, pThis->path, pThis->pathLength, GlowReaderPosition_Target, pThis->state);
+            pThis->onUnsupportedTltlv(pBase, pThis->pPath, pThis->pathLength, GlowReaderPosition_Target, pThis->state);
       }
    }
 }
@@ -633,7 +740,7 @@ static void onItemReady_Function(NonFramingGlowReader *pThis)
       {
          number = berReader_getInteger(pBase);
 
-         pThis->path[pThis->pathLength] = number;
+         pThis->pPath[pThis->pathLength] = number;
          pThis->pathLength++;
       }
    }
@@ -654,7 +761,7 @@ static void onItemReady_QualifiedFunction(NonFramingGlowReader *pThis)
          if(pThis->pathLength != 0)
             throwError(509, "QualifiedFunction encountered on non-root level!");
 
-         pThis->pathLength = berReader_getRelativeOid(pBase, pThis->path, GLOW_MAX_TREE_DEPTH);
+         pThis->pathLength = berReader_getRelativeOid(pBase, pThis->pPath, pThis->pathCapacity);
 
          if(pThis->pathLength == 0)
             throwError(510, "empty path in QualifiedFunction!");
@@ -669,23 +776,23 @@ static void onItemReady_FunctionContents(NonFramingGlowReader *pThis)
 
    if(pBase->isContainer)
    {
-      if(pThis->onFunction != NULL)
-         pThis->onFunction(&pThis->glow.function, pThis->path, pThis->pathLength, pThis->state);
+      if(pThis->onFunction != NULL && isPathSelected(pThis))
+         pThis->onFunction(&pThis->glow.function, pThis->pPath, pThis->pathLength, pThis->state);
 
       // reset read function
-      glowFunction_free(&pThis->glow.function);
+      freeElement(pThis, glowFunction_free, &pThis->glow.function);
    }
-   else
+   else if(isPathSelected(pThis))
    {
       if(berTag_equals(pTag, &glowTags.functionContents.identifier))
       {
-         pThis->glow.function.pIdentifier = newarr(char, pBase->length + 1);
+         pThis->glow.function.pIdentifier = newstoragearr(pThis, char, pBase->length + 1);
          berReader_getString(pBase, pThis->glow.function.pIdentifier, pBase->length + 1);
          glow_assertIdentifierValid(pThis->glow.function.pIdentifier, true);
       }
       else if(berTag_equals(pTag, &glowTags.functionContents.description))
       {
-         pThis->glow.function.pDescription = newarr(char, pBase->length + 1);
+         pThis->glow.function.pDescription = newstoragearr(pThis, char, pBase->length + 1);
          berReader_getString(pBase, pThis->glow.function.pDescription, pBase->length + 1);
       }
    }
@@ -709,7 +816,7 @@ static void onItemReady_FunctionArgument(NonFramingGlowReader *pThis)
       }
       else if(berTag_equals(&pBase->tag, &glowTags.tupleItemDescription.name))
       {
-         pTupleItem->pName = newarr(char, pBase->length + 1);
+         pTupleItem->pName = newstoragearr(pThis, char, pBase->length + 1);
          berReader_getString(pBase, pTupleItem->pName, pBase->length + 1);
       }
    }
@@ -733,7 +840,7 @@ static void onItemReady_FunctionResult(NonFramingGlowReader *pThis)
       }
       else if(berTag_equals(&pBase->tag, &glowTags.tupleItemDescription.name))
       {
-         pTupleItem->pName = newarr(char, pBase->length + 1);
+         pTupleItem->pName = newstoragearr(pThis, char, pBase->length + 1);
          berReader_getString(pBase, pTupleItem->pName, pBase->length + 1);
       }
    }
@@ -760,7 +867,7 @@ static void onItemReady_InvocationResult(NonFramingGlowReader *pThis)
          pThis->onInvocationResult(&pThis->glow.invocationResult, pThis->state);
 
       // reset read invocation result
-      glowInvocationResult_free(&pThis->glow.invocationResult);
+      freeElement(pThis, glowInvocationResult_free, &pThis->glow.invocationResult);
    }
    else
    {
@@ -775,7 +882,7 @@ static void onItemReady_InvocationResult(NonFramingGlowReader *pThis)
    }
 }
 
-static void allocValues(GlowValue **ppValues, int length)
+static void allocValues(NonFramingGlowReader *pThis, GlowValue **ppValues, int length)
 {
    GlowValue *pNew;
 
@@ -784,17 +891,17 @@ static void allocValues(GlowValue **ppValues, int length)
    if(*ppValues == NULL)
    {
       ASSERT(length == 0);
-      *ppValues = newarr(GlowValue, 4);
+      *ppValues = newstoragearr(pThis, GlowValue, 4);
       memset(*ppValues, 0, sizeof(GlowValue) * 4);
    }
    else
    {
       if(length >= 4)
       {
-         pNew = newarr(GlowValue, length + 1);
+         pNew = newstoragearr(pThis, GlowValue, length + 1);
          memset(pNew + length, 0, sizeof(GlowValue));
          memcpy(pNew, *ppValues, sizeof(GlowValue) * length);
-         freeMemory(*ppValues);
+         freeStorage(pThis, *ppValues);
          *ppValues = pNew;
       }
    }
@@ -807,8 +914,8 @@ static void onItemReady_InvocationArguments(NonFramingGlowReader *pThis)
 
    if(pBase->isContainer == false)
    {
-      allocValues(&pInvocation->pArguments, pInvocation->argumentsLength);
-      readValue(pBase, &pInvocation->pArguments[pInvocation->argumentsLength]);
+      allocValues(pThis, &pInvocation->pArguments, pInvocation->argumentsLength);
+      readValue(pThis, &pInvocation->pArguments[pInvocation->argumentsLength]);
       pInvocation->argumentsLength++;
    }
 }
@@ -820,13 +927,13 @@ static void onItemReady_InvocationResultResult(NonFramingGlowReader *pThis)
 
    if(pBase->isContainer == false)
    {
-      allocValues(&pInvocationResult->pResult, pInvocationResult->resultLength);
-      readValue(pBase, &pInvocationResult->pResult[pInvocationResult->resultLength]);
+      allocValues(pThis, &pInvocationResult->pResult, pInvocationResult->resultLength);
+      readValue(pThis, &pInvocationResult->pResult[pInvocationResult->resultLength]);
       pInvocationResult->resultLength++;
    }
 }
 
-static void allocTupleDescriptions(GlowTupleItemDescription **ppTupleItems, int length)
+static void allocTupleDescriptions(NonFramingGlowReader *pThis, GlowTupleItemDescription **ppTupleItems, int length)
 {
    GlowTupleItemDescription *pNew;
 
@@ -835,17 +942,17 @@ static void allocTupleDescriptions(GlowTupleItemDescription **ppTupleItems, int
    if(*ppTupleItems == NULL)
    {
       ASSERT(length == 0);
-      *ppTupleItems = newarr(GlowTupleItemDescription, 4);
+      *ppTupleItems = newstoragearr(pThis, GlowTupleItemDescription, 4);
       memset(*ppTupleItems, 0, sizeof(GlowTupleItemDescription) * 4);
    }
    else
    {
       if(length >= 4)
       {
-         pNew = newarr(GlowTupleItemDescription, length + 1);
+         pNew = newstoragearr(pThis, GlowTupleItemDescription, length + 1);
          memset(pNew + length, 0, sizeof(GlowTupleItemDescription));
          memcpy(pNew, *ppTupleItems, length * sizeof(GlowTupleItemDescription));
-         freeMemory(*ppTupleItems);
+         freeStorage(pThis, *ppTupleItems);
          *ppTupleItems = pNew;
       }
    }
@@ -911,11 +1018,11 @@ static onItemReady_t getOnItemReady_EnterContainer(const BerReader *pBase)
          bzero(pThis->glow.invocationResult);
          return onItemReady_InvocationResult;
       default:
-         pStack = pAsync->pContainerStack;
+         pStack = &pAsync->containerStack;
 
          if(pStack->length > 0)
          {
-            pParent = &pStack->items[pStack->length - 1];
+            pParent = &pStack->pItems[pStack->length - 1];
 
             if(pBase->type == BerType_Set)
             {
@@ -947,19 +1054,20 @@ static onItemReady_t getOnItemReady_EnterContainer(const BerReader *pBase)
                   return onItemReady_InvocationResultResult;
             }
 
-            if(pBase->type == GlowType_TupleItemDescription)
+            if(pBase->type == GlowType_TupleItemDescription
+            && isPathSelected(pThis))
             {
                if(berTag_equals(&pParent->tag, &glowTags.functionContents.arguments)
                && pParent->type == BerType_Sequence)
                {
-                  allocTupleDescriptions(&pThis->glow.function.pArguments, pThis->glow.function.argumentsLength);
+                  allocTupleDescriptions(pThis, &pThis->glow.function.pArguments, pThis->glow.function.argumentsLength);
                   return onItemReady_FunctionArgument;
                }
 
                if(berTag_equals(&pParent->tag, &glowTags.functionContents.result)
                && pParent->type == BerType_Sequence)
                {
-                  allocTupleDescriptions(&pThis->glow.function.pResult, pThis->glow.function.resultLength);
+                  allocTupleDescriptions(pThis, &pThis->glow.function.pResult, pThis->glow.function.resultLength);
                   return onItemReady_FunctionResult;
                }
             }
@@ -973,13 +1081,13 @@ static onItemReady_t getOnItemReady_EnterContainer(const BerReader *pBase)
 static onItemReady_t getOnItemReady_LeaveContainer(const BerReader *pBase)
 {
    EmberAsyncReader *pAsync = (EmberAsyncReader *)pBase;
-   __EmberAsyncContainerStack *pStack = pAsync->pContainerStack;
+   __EmberAsyncContainerStack *pStack = &pAsync->containerStack;
    __EmberAsyncContainer *pCurrent;
    __EmberAsyncContainer *pParent;
 
    if(pStack->length > 0)
    {
-      pCurrent = &pStack->items[pStack->length - 1];
+      pCurrent = &pStack->pItems[pStack->length - 1];
 
       switch(pCurrent->type)
       {
@@ -1002,7 +1110,7 @@ static onItemReady_t getOnItemReady_LeaveContainer(const BerReader *pBase)
          default:
             if(pStack->length > 1)
             {
-               pParent = &pStack->items[pStack->length - 2];
+               pParent = &pStack->pItems[pStack->length - 2];
 
                if(pCurrent->type == BerType_Set)
                {
@@ -1104,12 +1212,21 @@ void nonFramingGlowReader_init(NonFramingGlowReader *pThis,
    pThis->base.onNewContainer = onNewContainer;
    pThis->base.onItemReady = onItemReady;
 
+   pThis->pPath = pThis->defaultPath;
+   pThis->pathCapacity = GLOW_MAX_TREE_DEPTH;
+
    pThis->onNode = onNode;
    pThis->onParameter = onParameter;
    pThis->onCommand = onCommand;
    pThis->onStreamEntry = onStreamEntry;
 
+   pThis->fieldMask = GlowFieldFlag_All;
    pThis->state = state;
+
+#ifdef EMBER_STATIC_MEMORY
+   pThis->pStorage = pThis->storage.bytes;
+   pThis->storageSize = GLOW_READER_STORAGE_SIZE;
+#endif
 }
 
 void nonFramingGlowReader_free(NonFramingGlowReader *pThis)
@@ -1121,12 +1238,52 @@ void nonFramingGlowReader_free(NonFramingGlowReader *pThis)
    bzero(*pThis);
 }
 
+void nonFramingGlowReader_setStack(NonFramingGlowReader *pThis,
+                                   __EmberAsyncContainer *pContainers,
+                                   int containerCount,
+                                   berint *pPath)
+{
+   ASSERT(pThis != NULL);
+   ASSERT(pPath != NULL);
+
+   emberAsyncReader_setStack(&pThis->base, pContainers, containerCount);
+
+   pThis->pPath = pPath;
+   pThis->pathCapacity = containerCount / 2;
+   pThis->pathLength = 0;
+}
+
+void nonFramingGlowReader_setStorage(NonFramingGlowReader *pThis,
+                                     byte *pStorage,
+                                     unsigned int storageSize)
+{
+   ASSERT(pThis != NULL);
+   ASSERT(pStorage != NULL || storageSize == 0);
+
+   nonFramingGlowReader_reset(pThis);
+
+#ifdef EMBER_STATIC_MEMORY
+   if(pStorage == NULL)
+   {
+      pStorage = pThis->storage.bytes;
+      storageSize = GLOW_READER_STORAGE_SIZE;
+   }
+#endif
+
+   pThis->pStorage = pStorage;
+   pThis->storageSize = storageSize;
+   pThis->storageLength = 0;
+}
+
 void nonFramingGlowReader_reset(NonFramingGlowReader *pThis)
 {
    ASSERT(pThis != NULL);
 
    pThis->pathLength = 0;
    emberAsyncReader_reset(&pThis->base);
+
+   if(pThis->pStorage != NULL)
+      pThis->storageLength = 0;
 }
 
 
@@ -1141,6 +1298,7 @@ static void onPackageReceived(const byte *pPackage, int length, voidptr state)
    GlowReader *pThis = (GlowReader *)state;
    int appBytesCount;
    int headerLength;
+   int inflatedLength;
 
    ASSERT(pThis != NULL);
    ASSERT(pPackage != NULL);
@@ -1159,13 +1317,69 @@ static void onPackageReceived(const byte *pPackage, int length, voidptr state)
       if(pPackage[4] & EmberFramingFlag_FirstPackage)
          emberAsyncReader_reset(&pThis->base.base);
 
-      emberAsyncReader_readBytes(&pThis->base.base, pPackage + headerLength, length - headerLength);
+      if(pPackage[4] & EmberFramingFlag_Compressed)
+      {
+         inflatedLength = emberCompression_decompress(pPackage + headerLength,
+                                                      length > headerLength ? length - headerLength : 0,
+                                                      pThis->inflated,
+                                                      sizeof(pThis->inflated));
+
+         if(inflatedLength < 0)
+         {
+            throwError(512, "invalid compressed package");
+            return;
+         }
+
+         emberAsyncReader_readBytes(&pThis->base.base, pThis->inflated, inflatedLength);
+      }
+      else
+      {
+         emberAsyncReader_readBytes(&pThis->base.base, pPackage + headerLength, length - headerLength);
+      }
 
       if(pPackage[4] & EmberFramingFlag_LastPackage)
          glowReader_reset(pThis);
    }
 }
 
+static void onPayloadReceived(const byte *pHeader, const byte *pBytes, int count, voidptr state)
+{
+   GlowReader *pThis = (GlowReader *)state;
+
+   ASSERT(pThis != NULL);
+   ASSERT(pHeader != NULL);
+
+   if(pHeader[5] != EMBER_DTD_GLOW)
+      return;
+
+   if(count == 0)
+   {
+      if(pHeader[4] & EmberFramingFlag_FirstPackage)
+         emberAsyncReader_reset(&pThis->base.base);
+   }
+   else
+   {
+      emberAsyncReader_readBytes(&pThis->base.base, pBytes, count);
+   }
+}
+
+static void onPayloadFinished(const byte *pHeader, bool isValid, voidptr state)
+{
+   GlowReader *pThis = (GlowReader *)state;
+
+   ASSERT(pThis != NULL);
+   ASSERT(pHeader != NULL);
+
+   if(pHeader[5] != EMBER_DTD_GLOW)
+      return;
+
+   // a corrupted package leaves the decoder somewhere inside
+   // the tree, so it is reset as if the package had been dropped.
+   if(isValid == false
+   || (pHeader[4] & EmberFramingFlag_LastPackage))
+      nonFramingGlowReader_reset(&pThis->base);
+}
+
 
 // ====================================================================
 //
@@ -1207,6 +1421,24 @@ void glowReader_free(GlowReader *pThis)
    bzero(*pThis);
 }
 
+void glowReader_setStreaming(GlowReader *pThis, bool isStreaming)
+{
+   ASSERT(pThis != NULL);
+
+   if(isStreaming)
+      emberFramingReader_setStreaming(&pThis->framing, onPayloadReceived, onPayloadFinished);
+   else
+      emberFramingReader_setStreaming(&pThis->framing, NULL, NULL);
+}
+
+void glowReader_readPackage(GlowReader *pThis, const byte *pPackage, int length)
+{
+   ASSERT(pThis != NULL);
+   ASSERT(pPackage != NULL);
+
+   onPackageReceived(pPackage, length, pThis);
+}
+
 void glowReader_reset(GlowReader *pThis)
 {
    ASSERT(pThis != NULL);
@@ -1214,3 +1446,74 @@ void glowReader_reset(GlowReader *pThis)
    nonFramingGlowReader_reset(&pThis->base);
    emberFramingReader_reset(&pThis->framing);
 }
+
+
+// ====================================================================
+//
+// GlowSlotDemultiplexer locals
+//
+// ====================================================================
+
+static void onSlotPackageReceived(const byte *pPackage, int length, voidptr state)
+{
+   GlowSlotDemultiplexer *pThis = (GlowSlotDemultiplexer *)state;
+   GlowReader *pReader = NULL;
+
+   ASSERT(pThis != NULL);
+   ASSERT(pPackage != NULL);
+
+   if(length > 0 && pPackage[0] < pThis->readerCount)
+      pReader = pThis->ppReaders[pPackage[0]];
+
+   if(pReader != NULL)
+      glowReader_readPackage(pReader, pPackage, length);
+   else if(pThis->onUnknownSlot != NULL)
+      pThis->onUnknownSlot(pPackage, length, pThis->state);
+}
+
+
+// ====================================================================
+//
+// GlowSlotDemultiplexer globals
+//
+// ====================================================================
+
+void glowSlotDemultiplexer_init(GlowSlotDemultiplexer *pThis,
+                                GlowReader **ppReaders,
+                                int readerCount,
+                                byte *pRxBuffer,
+                                unsigned int rxBufferSize)
+{
+   ASSERT(pThis != NULL);
+   ASSERT(ppReaders != NULL || readerCount == 0);
+   ASSERT(pRxBuffer != NULL);
+   ASSERT(rxBufferSize > 0);
+
+   pThis->ppReaders = ppReaders;
+   pThis->readerCount = readerCount;
+   pThis->onUnknownSlot = NULL;
+   pThis->state = NULL;
+   emberFramingReader_init(&pThis->framing, pRxBuffer, rxBufferSize, onSlotPackageReceived, pThis);
+}
+
+void glowSlotDemultiplexer_readBytes(GlowSlotDemultiplexer *pThis, const byte *pBytes, int count)
+{
+   ASSERT(pThis != NULL);
+
+   emberFramingReader_readBytes(&pThis->framing, pBytes, count);
+}
+
+void glowSlotDemultiplexer_reset(GlowSlotDemultiplexer *pThis)
+{
+   int index;
+
+   ASSERT(pThis != NULL);
+
+   for(index = 0; index < pThis->readerCount; index++)
+   {
+      if(pThis->ppReaders[index] != NULL)
+         glowReader_reset(pThis->ppReaders[index]);
+   }
+
+   emberFramingReader_reset(&pThis->framing);
+}
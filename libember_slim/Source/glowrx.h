@@ -22,6 +22,30 @@
 
 #include "glow.h"
 
+#ifndef GLOW_READER_STORAGE_SIZE
+/**
+  * The number of bytes a NonFramingGlowReader reserves for the
+  * strings, octet strings and arrays of the glow element it is
+  * currently decoding, when EMBER_STATIC_MEMORY is defined.
+  * Can be set using a compiler option. Default is 2048.
+  * If this value is exceeded during the decoding
+  * process, the throwError callback is called.
+  */
+#define GLOW_READER_STORAGE_SIZE (2048)
+#endif
+
+#ifndef GLOW_READER_INFLATE_SIZE
+/**
+  * The number of bytes a GlowReader reserves for the payload
+  * of a compressed package.
+  * Can be set using a compiler option. Default is
+  * EMBER_MAXIMUM_PACKAGE_LENGTH.
+  * If the payload of a compressed package exceeds this value,
+  * the throwError callback is called.
+  */
+#define GLOW_READER_INFLATE_SIZE (EMBER_MAXIMUM_PACKAGE_LENGTH)
+#endif
+
 // ====================================================================
 //
 // NonFramingGlowReader
@@ -179,7 +203,8 @@ typedef void (*onUnsupportedTltlv_t)(const BerReader *pReader, const berint *pPa
   * Overrides EmberAsyncReader.onItemReady and
   * EmberAsyncReader.onNewContainer.
   * @note This structure is huge, therefore it is strongly recommended
-  *     to put it on the heap.
+  *     to put it on the heap, or into static memory if
+  *     EMBER_STATIC_MEMORY is defined.
   */
 typedef struct SNonFramingGlowReader
 {
@@ -191,13 +216,23 @@ typedef struct SNonFramingGlowReader
    /**
      * Private field.
      */
-   berint path[GLOW_MAX_TREE_DEPTH];
+   berint *pPath;
+
+   /**
+     * Private field.
+     */
+   int pathCapacity;
 
    /**
      * Private field.
      */
    int pathLength;
 
+   /**
+     * Private field.
+     */
+   berint defaultPath[GLOW_MAX_TREE_DEPTH];
+
    union
    {
       /**
@@ -323,11 +358,57 @@ typedef struct SNonFramingGlowReader
      */
    onUnsupportedTltlv_t onUnsupportedTltlv;
 
+   /**
+     * May be set to the path of the subtree the application is
+     * interested in. Nodes, parameters, matrices and functions
+     * outside this subtree are not decoded and not reported.
+     * Ignored if pathFilterLength is 0.
+     */
+   const berint *pPathFilter;
+
+   /**
+     * The number of sub-identifiers at pPathFilter.
+     */
+   int pathFilterLength;
+
+   /**
+     * May be set to the node and parameter fields the application
+     * is interested in. Other fields are not decoded and not
+     * reported. Initialized to GlowFieldFlag_All.
+     */
+   GlowFieldFlags fieldMask;
+
    /**
      * Application-defined argument passed to callback
      * functions.
      */
    voidptr state;
+
+   /**
+     * Private field.
+     */
+   byte *pStorage;
+
+   /**
+     * Private field.
+     */
+   unsigned int storageSize;
+
+   /**
+     * Private field.
+     */
+   unsigned int storageLength;
+
+#ifdef EMBER_STATIC_MEMORY
+   /**
+     * Private field.
+     */
+   union
+   {
+      byte bytes[GLOW_READER_STORAGE_SIZE];
+      double alignment;
+   } storage;
+#endif
 } NonFramingGlowReader;
 
 /**
@@ -361,6 +442,46 @@ void nonFramingGlowReader_init(NonFramingGlowReader *pThis,
   */
 void nonFramingGlowReader_free(NonFramingGlowReader *pThis);
 
+/**
+  * Replaces the tree stacks of the passed NonFramingGlowReader
+  * with caller-provided storage, so that the maximum tree depth
+  * can be chosen at runtime instead of by EMBER_MAX_TREE_DEPTH.
+  * Resets the internal state of the reader.
+  * @param pThis pointer to the object to process.
+  * @param pContainers pointer to the container stack storage,
+  *     see emberAsyncReader_setStack.
+  * @param containerCount the number of items at @p pContainers.
+  * @param pPath pointer to the path storage. Must hold at least
+  *     containerCount / 2 sub-identifiers, since each glow element
+  *     consists of two nested containers.
+  * @note the storage must remain valid until the reader is freed.
+  */
+void nonFramingGlowReader_setStack(NonFramingGlowReader *pThis,
+                                   __EmberAsyncContainer *pContainers,
+                                   int containerCount,
+                                   berint *pPath);
+
+/**
+  * Makes the passed NonFramingGlowReader place the strings, octets
+  * and arrays of the elements it decodes in caller-provided storage
+  * instead of allocating them through allocMemory. The storage is
+  * used like a stack: all blocks of an element are released at once
+  * when the reader starts to decode the next element, so that the
+  * pointers passed to the callbacks are only valid until they return.
+  * If an element does not fit, the throwError callback is invoked.
+  * Resets the internal state of the reader.
+  * @param pThis pointer to the object to process.
+  * @param pStorage pointer to the storage, which must be aligned
+  *     for double. Pass NULL to return to the default, which is
+  *     allocMemory, or the embedded storage if EMBER_STATIC_MEMORY
+  *     is defined.
+  * @param storageSize the number of bytes at @p pStorage.
+  * @note the storage must remain valid until the reader is freed.
+  */
+void nonFramingGlowReader_setStorage(NonFramingGlowReader *pThis,
+                                     byte *pStorage,
+                                     unsigned int storageSize);
+
 /**
   * Resets the internal state of the passedNonFramingGlowReader.
   * @param pThis pointer to the object to process.
@@ -379,7 +500,8 @@ void nonFramingGlowReader_reset(NonFramingGlowReader *pThis);
   * to provide ember reading functionality specialized on the Glow DTD,
   * unframing incoming packages on the fly.
   * @note This structure is huge, therefore it is strongly recommended
-  *     to put it on the heap.
+  *     to put it on the heap, or into static memory if
+  *     EMBER_STATIC_MEMORY is defined.
   */
 typedef struct SGlowReader
 {
@@ -398,6 +520,11 @@ typedef struct SGlowReader
      * received.
      */
    onPackageReceived_t onPackageReceived;
+
+   /**
+     * Private field.
+     */
+   byte inflated[GLOW_READER_INFLATE_SIZE];
 } GlowReader;
 
 /**
@@ -455,10 +582,127 @@ void glowReader_free(GlowReader *pThis);
   */
 void glowReader_readBytes(GlowReader *pThis, const byte *pBytes, int count);
 
+/**
+  * Enables or disables streaming mode on the passed GlowReader.
+  * In streaming mode, the payload of uncompressed packages is fed
+  * into the NonFramingGlowReader straight from the bytes passed to
+  * glowReader_readBytes, instead of being unframed into the receive
+  * buffer first. The receive buffer then only has to hold package
+  * headers and compressed packages, which saves both memory and
+  * copying on small targets. See emberFramingReader_setStreaming.
+  * Streamed packages are not passed to onPackageReceived. If the
+  * checksum of a streamed package does not match, the decoder is
+  * reset, just like a corrupted package is skipped when it has been
+  * staged, but the callbacks already invoked for the elements
+  * decoded from it cannot be taken back.
+  * @param pThis pointer to the object to process.
+  * @param isStreaming true to enable streaming mode.
+  */
+void glowReader_setStreaming(GlowReader *pThis, bool isStreaming);
+
+/**
+  * Feeds a single package that has already been unframed into
+  * the passed GlowReader, as if the reader had unframed it itself.
+  * Used by GlowSlotDemultiplexer to pass the packages of one
+  * slot to the reader of that slot.
+  * @param pThis pointer to the object to process.
+  * @param pPackage pointer to the first byte of the package,
+  *     which is the slot id, as passed to onPackageReceived.
+  * @param length the number of bytes at @p pPackage.
+  */
+void glowReader_readPackage(GlowReader *pThis, const byte *pPackage, int length);
+
 /**
   * Resets the internal state of the passed GlowReader.
   * @param pThis pointer to the object to process.
   */
 void glowReader_reset(GlowReader *pThis);
 
+
+// ====================================================================
+//
+// GlowSlotDemultiplexer
+//
+// ====================================================================
+
+/**
+  * Unframes the packages received over a single connection that
+  * carries several independent Ember+ sessions and passes each
+  * package to the GlowReader of its slot. This allows a gateway to
+  * serve many small providers over one connection, instead of
+  * opening a connection with its own buffers and keep-alive
+  * traffic for each of them. Each session should answer with
+  * its own slot id, e.g. by passing it to glowProvider_init.
+  * Since the demultiplexer unframes all packages into its own
+  * buffer, the readers never use their own receive buffers, which
+  * may therefore be kept small.
+  */
+typedef struct SGlowSlotDemultiplexer
+{
+   /**
+     * The frame reader used for unframing.
+     */
+   EmberFramingReader framing;
+
+   /**
+     * Private field.
+     */
+   GlowReader **ppReaders;
+
+   /**
+     * Private field.
+     */
+   int readerCount;
+
+   /**
+     * May be set to a callback function invoked with every package
+     * whose slot has no reader, e.g. to answer keep-alive requests.
+     */
+   onPackageReceived_t onUnknownSlot;
+
+   /**
+     * Application-defined argument passed to onUnknownSlot.
+     */
+   voidptr state;
+} GlowSlotDemultiplexer;
+
+/**
+  * Initializes a GlowSlotDemultiplexer instance.
+  * @param pThis pointer to the object to process.
+  * @param ppReaders pointer to the readers, indexed by slot id.
+  *     Entries may be NULL for slots that are not used.
+  * @param readerCount the number of entries at @p ppReaders.
+  *     Packages of slots not less than this value are passed
+  *     to onUnknownSlot.
+  * @param pRxBuffer pointer to the memory location to unframe
+  *     packages to.
+  * @param rxBufferSize number of available bytes at @p pRxBuffer.
+  *     This value has to be greater than or equal to the size of
+  *     the biggest package you expect to receive in any slot.
+  * @note the readers must remain valid until the demultiplexer
+  *     is no longer used.
+  */
+void glowSlotDemultiplexer_init(GlowSlotDemultiplexer *pThis,
+                                GlowReader **ppReaders,
+                                int readerCount,
+                                byte *pRxBuffer,
+                                unsigned int rxBufferSize);
+
+/**
+  * Feeds multiple bytes of framed Ember data into the passed
+  * GlowSlotDemultiplexer, which unframes the data and passes
+  * each package to the reader of its slot.
+  * @param pThis pointer to the object to process.
+  * @param pBytes pointer to the first byte to feed.
+  * @param count the number of bytes at @p pBytes to feed.
+  */
+void glowSlotDemultiplexer_readBytes(GlowSlotDemultiplexer *pThis, const byte *pBytes, int count);
+
+/**
+  * Resets the internal state of the passed GlowSlotDemultiplexer
+  * and of all its readers.
+  * @param pThis pointer to the object to process.
+  */
+void glowSlotDemultiplexer_reset(GlowSlotDemultiplexer *pThis);
+
 #endif//__LIBEMBER_SLIM_GLOWRX_H
@@ -37,17 +37,60 @@ bool glow_assertIdentifierValid(pcstr pIdentifier, bool isRx);
 //
 // ====================================================================
 
+/**
+  * Number of bytes written by ember_writeContainerEnd.
+  */
+#define GLOWOUTPUT_CONTAINER_END_LENGTH (4)
+
+/**
+  * Number of bytes to keep available in a package that may be split:
+  * the end of the root container, which may still have to be written
+  * to the same package, the escaped crc and the EOF byte.
+  */
+#define GLOWOUTPUT_TRAILER_LENGTH (GLOWOUTPUT_CONTAINER_END_LENGTH + 4 + 1)
+
 static void writeFramingHeader(GlowOutput *pThis, bool isFirstPackage, bool isLastPackage)
 {
    byte flags = 0;
 
    if(isFirstPackage)
       flags |= EmberFramingFlag_FirstPackage;
-   if(isLastPackage)
+
+   // a package that may be split is marked as the last
+   // package when it is finished, see markLastPackage.
+   if(isLastPackage && pThis->onPackageReady == NULL)
       flags |= EmberFramingFlag_LastPackage;
 
    berFramingOutput_writeHeader(&pThis->base, (EmberFramingFlags)flags);
    pThis->hasLastPackage = isLastPackage;
+   pThis->packageFlags = flags;
+   pThis->elementCount = 0;
+}
+
+static void markLastPackage(GlowOutput *pThis)
+{
+   if(pThis->onPackageReady != NULL)
+      berFramingOutput_setFlags(&pThis->base, (EmberFramingFlags)(pThis->packageFlags | EmberFramingFlag_LastPackage));
+}
+
+static void prepareElement(GlowOutput *pThis, unsigned int length)
+{
+   BerMemoryOutput *pMemory = &pThis->base.base;
+   unsigned int packageLength;
+
+   // an element that does not even fit into an empty package
+   // is written anyway, so that the capacity error is reported.
+   if(pThis->elementCount > 0
+   && pMemory->position + length + GLOWOUTPUT_TRAILER_LENGTH > pMemory->size)
+   {
+      packageLength = berFramingOutput_finish(&pThis->base);
+      pThis->onPackageReady(pMemory->pMemory, packageLength, pThis->state);
+
+      writeFramingHeader(pThis, false, pThis->hasLastPackage);
+      pThis->packageCount++;
+   }
+
+   pThis->elementCount++;
 }
 
 
@@ -71,11 +114,30 @@ void glowOutput_init(GlowOutput *pThis,
    berFramingOutput_init(&pThis->base, pMemory, size, slotId, EMBER_DTD_GLOW, s_appBytes, sizeof(s_appBytes));
    pThis->hasLastPackage = false;
    pThis->packageCount = 0;
+   pThis->onPackageReady = NULL;
+   pThis->state = NULL;
+   pThis->packageFlags = 0;
+   pThis->elementCount = 0;
 #ifdef _DEBUG
    pThis->positionHint = 0;
 #endif
 }
 
+void glowOutput_initMultiPackage(GlowOutput *pThis,
+                                 byte *pMemory,
+                                 unsigned int size,
+                                 byte slotId,
+                                 onPackageReady_t onPackageReady,
+                                 voidptr state)
+{
+   ASSERT(onPackageReady != NULL);
+
+   glowOutput_init(pThis, pMemory, size, slotId);
+
+   pThis->onPackageReady = onPackageReady;
+   pThis->state = state;
+}
+
 void glowOutput_beginPackage(GlowOutput *pThis, bool isLastPackage)
 {
    bool isFirstPackage = pThis->packageCount == 0;
@@ -105,6 +167,7 @@ unsigned int glowOutput_finishPackage(GlowOutput *pThis)
    if(pThis->hasLastPackage)
    {
       ember_writeContainerEnd(&pThis->base.base.base);
+      markLastPackage(pThis);
 
       pThis->hasLastPackage = false;
       pThis->packageCount = 0;
@@ -129,7 +192,11 @@ static void writeMinMax(BerOutput *pOut, const BerTag *pTag, const GlowMinMax *p
          break;
 
       case GlowParameterType_Real:
+#ifdef GLOW_FIXED_REAL_FRACTION_BITS
+         ember_writeFixedReal(pOut, pTag, pMinMax->choice.real, GLOW_FIXED_REAL_FRACTION_BITS);
+#else
          ember_writeReal(pOut, pTag, pMinMax->choice.real);
+#endif
          break;
 
       default:
@@ -147,7 +214,11 @@ static void writeValue(BerOutput *pOut, const BerTag *pTag, const GlowValue *pVa
          break;
 
       case GlowParameterType_Real:
+#ifdef GLOW_FIXED_REAL_FRACTION_BITS
+         ember_writeFixedReal(pOut, pTag, pValue->choice.real, GLOW_FIXED_REAL_FRACTION_BITS);
+#else
          ember_writeReal(pOut, pTag, pValue->choice.real);
+#endif
          break;
 
       case GlowParameterType_String:
@@ -560,6 +631,81 @@ void glow_writeConnectionImpl(BerOutput *pOut, const GlowConnection *pConnection
    ember_writeContainerEnd(pOut);
 }
 
+/**
+  * Number of sources collected from a bitmap at a time
+  * by glow_writeConnectionBitsImpl.
+  */
+#define GLOWOUTPUT_SOURCE_CHUNK_LENGTH (16)
+
+static int collectSourceBits(const byte *pSourceBits, int sourceCount, int *pNext, berint *pSources)
+{
+   int source = *pNext;
+   int count = 0;
+
+   while(source < sourceCount && count < GLOWOUTPUT_SOURCE_CHUNK_LENGTH)
+   {
+      // skip eight unconnected sources at once
+      if((source & 7) == 0 && pSourceBits[source >> 3] == 0)
+      {
+         source += 8;
+         continue;
+      }
+
+      if(pSourceBits[source >> 3] & (1 << (source & 7)))
+         pSources[count++] = source;
+
+      source++;
+   }
+
+   *pNext = source;
+   return count;
+}
+
+static void writeSourceBits(BerOutput *pOut, const BerTag *pTag, const byte *pSourceBits, int sourceCount)
+{
+   berint sources[GLOWOUTPUT_SOURCE_CHUNK_LENGTH];
+   BerTag outerTag;
+   BerTag innerTag;
+   int valueLength = 0;
+   int next = 0;
+   int count;
+
+   // the encoding of a RELATIVE-OID is the concatenation of its
+   // sub-identifiers, so it is computed and written in chunks.
+   while((count = collectSourceBits(pSourceBits, sourceCount, &next, sources)) > 0)
+      valueLength += ber_getRelativeOidLength(sources, count);
+
+   berTag_init(&innerTag, BerClass_Universal, BerType_RelativeOid);
+   outerTag = berTag_toContainer(pTag);
+
+   ber_encodeTag(pOut, &outerTag);
+   ber_encodeLength(pOut, valueLength + ber_getHeaderLength(&innerTag, valueLength));
+   ber_encodeTag(pOut, &innerTag);
+   ber_encodeLength(pOut, valueLength);
+
+   next = 0;
+
+   while((count = collectSourceBits(pSourceBits, sourceCount, &next, sources)) > 0)
+      ber_encodeRelativeOid(pOut, sources, count);
+}
+
+void glow_writeConnectionBitsImpl(BerOutput *pOut,
+                                  berint target,
+                                  const byte *pSourceBits,
+                                  int sourceCount,
+                                  GlowConnectionDisposition disposition)
+{
+   ember_writeContainerBegin(pOut, &glowTags.collection.item, GlowType_Connection);
+
+   ember_writeInteger(pOut, &glowTags.connection.target, target);
+   writeSourceBits(pOut, &glowTags.connection.sources, pSourceBits, sourceCount);
+
+   if(disposition != 0)
+      ember_writeInteger(pOut, &glowTags.connection.disposition, disposition);
+
+   ember_writeContainerEnd(pOut);
+}
+
 void glow_writeQualifiedFunctionImpl(BerOutput *pOut,
                                      const GlowFunction *pFunction,
                                      GlowFieldFlags fields,
@@ -652,11 +798,20 @@ void glow_writeQualifiedNode(GlowOutput *pOut,
                              const berint *pPath,
                              int pathLength)
 {
+   BerFramingLengthOutput length;
+
    ASSERT(pOut != NULL);
    ASSERT(pNode != NULL);
    ASSERT(pPath != NULL || pathLength == 0);
    ASSERT(pOut->positionHint == 0);
 
+   if(pOut->onPackageReady != NULL)
+   {
+      berFramingLengthOutput_init(&length);
+      glow_writeQualifiedNodeImpl(&length.base, pNode, fields, pPath, pathLength);
+      prepareElement(pOut, length.length);
+   }
+
    glow_writeQualifiedNodeImpl(&pOut->base.base.base, pNode, fields, pPath, pathLength);
 }
 
@@ -666,11 +821,20 @@ void glow_writeQualifiedParameter(GlowOutput *pOut,
                                   const berint *pPath,
                                   int pathLength)
 {
+   BerFramingLengthOutput length;
+
    ASSERT(pOut != NULL);
    ASSERT(pParameter != NULL);
    ASSERT(pPath != NULL || pathLength == 0);
    ASSERT(pOut->positionHint == 0);
 
+   if(pOut->onPackageReady != NULL)
+   {
+      berFramingLengthOutput_init(&length);
+      glow_writeQualifiedParameterImpl(&length.base, pParameter, fields, pPath, pathLength);
+      prepareElement(pOut, length.length);
+   }
+
    glow_writeQualifiedParameterImpl(&pOut->base.base.base, pParameter, fields, pPath, pathLength);
 }
 
@@ -680,20 +844,38 @@ void glow_writeQualifiedCommand(GlowOutput *pOut,
                                 int pathLength,
                                 GlowElementType parentType)
 {
+   BerFramingLengthOutput length;
+
    ASSERT(pOut != NULL);
    ASSERT(pCommand != NULL);
    ASSERT(pPath != NULL || pathLength == 0);
    ASSERT(pOut->positionHint == 0);
 
+   if(pOut->onPackageReady != NULL)
+   {
+      berFramingLengthOutput_init(&length);
+      glow_writeQualifiedCommandImpl(&length.base, pCommand, pPath, pathLength, parentType);
+      prepareElement(pOut, length.length);
+   }
+
    glow_writeQualifiedCommandImpl(&pOut->base.base.base, pCommand, pPath, pathLength, parentType);
 }
 
 void glow_writeStreamEntry(GlowOutput *pOut, const GlowStreamEntry *pEntry)
 {
+   BerFramingLengthOutput length;
+
    ASSERT(pOut != NULL);
    ASSERT(pEntry != NULL);
    ASSERT(pOut->positionHint == 0);
 
+   if(pOut->onPackageReady != NULL)
+   {
+      berFramingLengthOutput_init(&length);
+      glow_writeStreamEntryImpl(&length.base, pEntry);
+      prepareElement(pOut, length.length);
+   }
+
    glow_writeStreamEntryImpl(&pOut->base.base.base, pEntry);
 }
 
@@ -703,11 +885,20 @@ void glow_writeQualifiedMatrix(GlowOutput *pOut,
                                const berint *pPath,
                                int pathLength)
 {
+   BerFramingLengthOutput length;
+
    ASSERT(pOut != NULL);
    ASSERT(pMatrix != NULL);
    ASSERT(pPath != NULL || pathLength == 0);
    ASSERT(pOut->positionHint == 0);
 
+   if(pOut->onPackageReady != NULL)
+   {
+      berFramingLengthOutput_init(&length);
+      glow_writeQualifiedMatrixImpl(&length.base, pMatrix, fields, pPath, pathLength);
+      prepareElement(pOut, length.length);
+   }
+
    glow_writeQualifiedMatrixImpl(&pOut->base.base.base, pMatrix, fields, pPath, pathLength);
 }
 
@@ -715,6 +906,8 @@ void glow_writeTargetsPrefix(GlowOutput *pOut,
                              const berint *pMatrixPath,
                              int pathLength)
 {
+   BerFramingLengthOutput length;
+
    ASSERT(pOut != NULL);
    ASSERT(pMatrixPath != NULL || pathLength == 0);
    ASSERT(pOut->positionHint == 0);
@@ -722,15 +915,31 @@ void glow_writeTargetsPrefix(GlowOutput *pOut,
    pOut->positionHint = __GLOWOUTPUT_POSITION_TARGETS;
 #endif
 
+   if(pOut->onPackageReady != NULL)
+   {
+      berFramingLengthOutput_init(&length);
+      glow_writeTargetsPrefixImpl(&length.base, pMatrixPath, pathLength);
+      prepareElement(pOut, length.length);
+   }
+
    glow_writeTargetsPrefixImpl(&pOut->base.base.base, pMatrixPath, pathLength);
 }
 
 void glow_writeTarget(GlowOutput *pOut, const GlowSignal *pTarget)
 {
+   BerFramingLengthOutput length;
+
    ASSERT(pOut != NULL);
    ASSERT(pTarget != NULL);
    ASSERT(pOut->positionHint == __GLOWOUTPUT_POSITION_TARGETS);
 
+   if(pOut->onPackageReady != NULL)
+   {
+      berFramingLengthOutput_init(&length);
+      glow_writeTargetImpl(&length.base, pTarget);
+      prepareElement(pOut, length.length);
+   }
+
    glow_writeTargetImpl(&pOut->base.base.base, pTarget);
 }
 
@@ -742,6 +951,9 @@ void glow_writeTargetsSuffix(GlowOutput *pOut)
    pOut->positionHint = 0;
 #endif
 
+   if(pOut->onPackageReady != NULL)
+      prepareElement(pOut, 2 * GLOWOUTPUT_CONTAINER_END_LENGTH);
+
    writeDoubleContainerEnd(&pOut->base.base.base);
 }
 
@@ -749,6 +961,8 @@ void glow_writeSourcesPrefix(GlowOutput *pOut,
                              const berint *pMatrixPath,
                              int pathLength)
 {
+   BerFramingLengthOutput length;
+
    ASSERT(pOut != NULL);
    ASSERT(pMatrixPath != NULL || pathLength == 0);
    ASSERT(pOut->positionHint == 0);
@@ -756,15 +970,31 @@ void glow_writeSourcesPrefix(GlowOutput *pOut,
    pOut->positionHint = __GLOWOUTPUT_POSITION_SOURCES;
 #endif
 
+   if(pOut->onPackageReady != NULL)
+   {
+      berFramingLengthOutput_init(&length);
+      glow_writeSourcesPrefixImpl(&length.base, pMatrixPath, pathLength);
+      prepareElement(pOut, length.length);
+   }
+
    glow_writeSourcesPrefixImpl(&pOut->base.base.base, pMatrixPath, pathLength);
 }
 
 void glow_writeSource(GlowOutput *pOut, const GlowSignal *pSource)
 {
+   BerFramingLengthOutput length;
+
    ASSERT(pOut != NULL);
    ASSERT(pSource != NULL);
    ASSERT(pOut->positionHint == __GLOWOUTPUT_POSITION_SOURCES);
 
+   if(pOut->onPackageReady != NULL)
+   {
+      berFramingLengthOutput_init(&length);
+      glow_writeSourceImpl(&length.base, pSource);
+      prepareElement(pOut, length.length);
+   }
+
    glow_writeSourceImpl(&pOut->base.base.base, pSource);
 }
 
@@ -776,6 +1006,9 @@ void glow_writeSourcesSuffix(GlowOutput *pOut)
    pOut->positionHint = 0;
 #endif
 
+   if(pOut->onPackageReady != NULL)
+      prepareElement(pOut, 2 * GLOWOUTPUT_CONTAINER_END_LENGTH);
+
    writeDoubleContainerEnd(&pOut->base.base.base);
 }
 
@@ -783,6 +1016,8 @@ void glow_writeConnectionsPrefix(GlowOutput *pOut,
                                  const berint *pMatrixPath,
                                  int pathLength)
 {
+   BerFramingLengthOutput length;
+
    ASSERT(pOut != NULL);
    ASSERT(pMatrixPath != NULL || pathLength == 0);
    ASSERT(pOut->positionHint == 0);
@@ -790,18 +1025,56 @@ void glow_writeConnectionsPrefix(GlowOutput *pOut,
    pOut->positionHint = __GLOWOUTPUT_POSITION_CONNECTIONS;
 #endif
 
+   if(pOut->onPackageReady != NULL)
+   {
+      berFramingLengthOutput_init(&length);
+      glow_writeConnectionsPrefixImpl(&length.base, pMatrixPath, pathLength);
+      prepareElement(pOut, length.length);
+   }
+
    glow_writeConnectionsPrefixImpl(&pOut->base.base.base, pMatrixPath, pathLength);
 }
 
 void glow_writeConnection(GlowOutput *pOut, const GlowConnection *pConnection)
 {
+   BerFramingLengthOutput length;
+
    ASSERT(pOut != NULL);
    ASSERT(pConnection != NULL);
    ASSERT(pOut->positionHint == __GLOWOUTPUT_POSITION_CONNECTIONS);
 
+   if(pOut->onPackageReady != NULL)
+   {
+      berFramingLengthOutput_init(&length);
+      glow_writeConnectionImpl(&length.base, pConnection);
+      prepareElement(pOut, length.length);
+   }
+
    glow_writeConnectionImpl(&pOut->base.base.base, pConnection);
 }
 
+void glow_writeConnectionBits(GlowOutput *pOut,
+                              berint target,
+                              const byte *pSourceBits,
+                              int sourceCount,
+                              GlowConnectionDisposition disposition)
+{
+   BerFramingLengthOutput length;
+
+   ASSERT(pOut != NULL);
+   ASSERT(pSourceBits != NULL || sourceCount == 0);
+   ASSERT(pOut->positionHint == __GLOWOUTPUT_POSITION_CONNECTIONS);
+
+   if(pOut->onPackageReady != NULL)
+   {
+      berFramingLengthOutput_init(&length);
+      glow_writeConnectionBitsImpl(&length.base, target, pSourceBits, sourceCount, disposition);
+      prepareElement(pOut, length.length);
+   }
+
+   glow_writeConnectionBitsImpl(&pOut->base.base.base, target, pSourceBits, sourceCount, disposition);
+}
+
 void glow_writeConnectionsSuffix(GlowOutput *pOut)
 {
    ASSERT(pOut != NULL);
@@ -810,6 +1083,9 @@ void glow_writeConnectionsSuffix(GlowOutput *pOut)
    pOut->positionHint = 0;
 #endif
 
+   if(pOut->onPackageReady != NULL)
+      prepareElement(pOut, 2 * GLOWOUTPUT_CONTAINER_END_LENGTH);
+
    writeDoubleContainerEnd(&pOut->base.base.base);
 }
 
@@ -819,10 +1095,19 @@ void glow_writeQualifiedFunction(GlowOutput *pOut,
                                  const berint *pPath,
                                  int pathLength)
 {
+   BerFramingLengthOutput length;
+
    ASSERT(pOut != NULL);
    ASSERT(pFunction != NULL);
    ASSERT(pOut->positionHint == 0);
 
+   if(pOut->onPackageReady != NULL)
+   {
+      berFramingLengthOutput_init(&length);
+      glow_writeQualifiedFunctionImpl(&length.base, pFunction, fields, pPath, pathLength);
+      prepareElement(pOut, length.length);
+   }
+
    glow_writeQualifiedFunctionImpl(&pOut->base.base.base, pFunction, fields, pPath, pathLength);
 }
 
@@ -836,6 +1121,7 @@ unsigned int glow_writeInvocationResultPackage(GlowOutput *pOut, const GlowInvoc
    writeFramingHeader(pOut, true, true);
 
    glow_writeInvocationResultImpl(&pOut->base.base.base, &glowTags.root, pRoot);
+   markLastPackage(pOut);
 
    return berFramingOutput_finish(&pOut->base);
 }
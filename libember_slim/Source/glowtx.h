@@ -28,6 +28,18 @@
 //
 // ====================================================================
 
+/**
+  * Function type used by GlowOutput to pass a package to the
+  * application that has been finished early, because the next
+  * element did not fit into it.
+  * @param pPackage pointer to the first byte of the framed package.
+  *     The memory is re-used for the next package as soon as
+  *     this function returns.
+  * @param length the length of the framed package at @p pPackage.
+  * @param state application-defined argument.
+  */
+typedef void (*onPackageReady_t)(const byte *pPackage, unsigned int length, voidptr state);
+
 /**
   * Aliases an BerFramingOutput, specializing the
   * initialization function.
@@ -49,6 +61,26 @@ typedef struct SGlowOutput
      */
    int packageCount;
 
+   /**
+     * private field
+     */
+   onPackageReady_t onPackageReady;
+
+   /**
+     * private field
+     */
+   voidptr state;
+
+   /**
+     * private field
+     */
+   byte packageFlags;
+
+   /**
+     * private field
+     */
+   int elementCount;
+
 #ifdef _DEBUG
    /**
      * private field
@@ -79,6 +111,37 @@ void glowOutput_init(GlowOutput *pThis,
                      unsigned int size,
                      byte slotId);
 
+/**
+  * Initializes a GlowOutput instance that splits the glow tree
+  * into as many packages as needed.
+  * Before an element is written, the writer functions check whether
+  * it still fits into the current package. If it does not, the
+  * package is finished and passed to @p onPackageReady, and the
+  * element is written to a new package. This way, a matrix with
+  * thousands of targets and connections can be written through a
+  * small buffer.
+  * Packages are only split at element boundaries. Each of the
+  * glow_write functions writes one element, e.g. a single target,
+  * or the prefix or suffix of a signal collection.
+  * The last package is still returned by glowOutput_finishPackage.
+  * @param pThis pointer to the object to process.
+  * @param pMemory pointer to the memory location to write
+  *     the framed packages to.
+  * @param size number of bytes at @p pMemory.
+  * @param slotId the slot id as described in the
+  *     framing protocol documentation.
+  * @param onPackageReady callback function invoked with every
+  *     package that has been finished before the last package.
+  * @param state application-defined argument passed to
+  *     @p onPackageReady.
+  */
+void glowOutput_initMultiPackage(GlowOutput *pThis,
+                                 byte *pMemory,
+                                 unsigned int size,
+                                 byte slotId,
+                                 onPackageReady_t onPackageReady,
+                                 voidptr state);
+
 /**
   * Begins a new package by writing the framing header and the start tag
   * of the root container.
@@ -293,6 +356,25 @@ void glow_writeConnectionsPrefix(GlowOutput *pOut,
   */
 void glow_writeConnection(GlowOutput *pOut, const GlowConnection *pConnection);
 
+/**
+  * Writes a Connection to the passed GlowOutput, taking the connected
+  * sources from a bitmap instead of an array. Bit n % 8 of byte n / 8
+  * is set if source n is connected. The operation is not written,
+  * so the connection reports the complete list of sources.
+  * Only valid if preceeded by a call to glow_writeConnectionsPrefix.
+  * @param pOut pointer to the output to be used for in-memory framing.
+  * @param target the number of the target.
+  * @param pSourceBits pointer to the bitmap of connected sources.
+  * @param sourceCount the number of sources described by @p pSourceBits.
+  * @param disposition the disposition of the connection, written
+  *     unless it is GlowConnectionDisposition_Tally.
+  */
+void glow_writeConnectionBits(GlowOutput *pOut,
+                              berint target,
+                              const byte *pSourceBits,
+                              int sourceCount,
+                              GlowConnectionDisposition disposition);
+
 /**
   * Writes the suffix for the "connections" sequence of a QualifiedMatrix.
   * (in XML, this would be: </Connections></QualifiedMatrix>).
@@ -0,0 +1,448 @@
+/*
+   libember_slim benchmark
+   Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "emberplus.h"
+
+/**
+  * Seed of the pseudo random generator used to build the trees.
+  * Since the generator does not depend on the C library, the
+  * encoded trees are identical on all platforms.
+  */
+#define BENCHMARK_SEED (0x2A5F3C71UL)
+
+/**
+  * Minimum time in milliseconds each measurement runs.
+  */
+#define BENCHMARK_MIN_DURATION (500.0)
+
+/**
+  * Capacity of the buffer holding all framed packages of a tree.
+  */
+#define BENCHMARK_STREAM_SIZE (1 << 21)
+
+#define DEEP_NODES_BRANCHES (64)
+#define DEEP_NODES_DEPTH (24)
+#define MATRIX_SIGNALS (1024)
+#define STREAM_ENTRIES (4096)
+
+// ====================================================================
+//
+// utilities
+//
+// ====================================================================
+
+static dword randomState;
+
+static dword nextRandom()
+{
+   randomState = (randomState * 1664525UL + 1013904223UL) & 0xFFFFFFFFUL;
+   return randomState >> 8;
+}
+
+static double elapsed(clock_t start)
+{
+   return (clock() - start) * 1000.0 / CLOCKS_PER_SEC;
+}
+
+static void onThrowError(int error, pcstr pMessage)
+{
+   fprintf(stderr, "ERROR: ber error %d: '%s'\n", error, pMessage);
+   exit(1);
+}
+
+static void onFailAssertion(pcstr pFileName, int lineNumber)
+{
+   fprintf(stderr, "ERROR: Debug assertion failed @ '%s' line %d\n", pFileName, lineNumber);
+   exit(1);
+}
+
+
+// ====================================================================
+//
+// encoded stream
+//
+// ====================================================================
+
+typedef struct
+{
+   byte *pBytes;
+   unsigned int length;
+} Stream;
+
+static void stream_append(Stream *pThis, const byte *pBytes, unsigned int length)
+{
+   if(pThis->length + length > BENCHMARK_STREAM_SIZE)
+      onThrowError(0, "BENCHMARK_STREAM_SIZE exceeded");
+
+   memcpy(pThis->pBytes + pThis->length, pBytes, length);
+   pThis->length += length;
+}
+
+static void onPackageReady(const byte *pPackage, unsigned int length, voidptr state)
+{
+   stream_append((Stream *)state, pPackage, length);
+}
+
+
+// ====================================================================
+//
+// trees
+//
+// ====================================================================
+
+/**
+  * A chain of nodes per branch, each node containing an integer
+  * parameter, addressed by ever longer paths.
+  */
+static int writeDeepNodes(GlowOutput *pOut)
+{
+   berint path[DEEP_NODES_DEPTH + 1];
+   GlowNode node;
+   GlowParameter parameter;
+   int branch;
+   int depth;
+   int count = 0;
+
+   bzero(node);
+   node.pIdentifier = "node";
+   node.pDescription = "Benchmark Node";
+   node.isOnline = true;
+
+   bzero(parameter);
+   parameter.pIdentifier = "gain";
+   parameter.access = GlowAccess_ReadWrite;
+   parameter.value.flag = GlowParameterType_Integer;
+   parameter.minimum.flag = GlowParameterType_Integer;
+   parameter.minimum.choice.integer = -128;
+   parameter.maximum.flag = GlowParameterType_Integer;
+   parameter.maximum.choice.integer = 127;
+
+   glowOutput_beginPackage(pOut, false);
+
+   for(branch = 0; branch < DEEP_NODES_BRANCHES; branch++)
+   {
+      path[0] = branch + 1;
+
+      for(depth = 1; depth <= DEEP_NODES_DEPTH; depth++)
+      {
+         glow_writeQualifiedNode(pOut, &node, GlowFieldFlag_All, path, depth);
+
+         path[depth] = 0;
+         parameter.value.choice.integer = (berlong)(nextRandom() & 0xFF) - 128;
+         glow_writeQualifiedParameter(pOut, &parameter, GlowFieldFlag_All, path, depth + 1);
+
+         path[depth] = (berint)(nextRandom() % 8) + 1;
+         count += 2;
+      }
+   }
+
+   return count;
+}
+
+/**
+  * A square matrix with all targets, sources and one random
+  * connection per target.
+  */
+static int writeMatrix(GlowOutput *pOut)
+{
+   berint path[2] = { 1, 1 };
+   berint source;
+   GlowMatrix matrix;
+   GlowSignal signal;
+   GlowConnection connection;
+   int number;
+   int count = 1;
+
+   bzero(matrix);
+   matrix.pIdentifier = "router";
+   matrix.pDescription = "Benchmark Router";
+   matrix.type = GlowMatrixType_OneToN;
+   matrix.addressingMode = GlowMatrixAddressingMode_Linear;
+   matrix.targetCount = MATRIX_SIGNALS;
+   matrix.sourceCount = MATRIX_SIGNALS;
+
+   glowOutput_beginPackage(pOut, false);
+   glow_writeQualifiedMatrix(pOut, &matrix, GlowFieldFlag_All, path, 2);
+
+   glow_writeTargetsPrefix(pOut, path, 2);
+   for(number = 0; number < MATRIX_SIGNALS; number++)
+   {
+      signal.number = number;
+      glow_writeTarget(pOut, &signal);
+   }
+   glow_writeTargetsSuffix(pOut);
+
+   glow_writeSourcesPrefix(pOut, path, 2);
+   for(number = 0; number < MATRIX_SIGNALS; number++)
+   {
+      signal.number = number;
+      glow_writeSource(pOut, &signal);
+   }
+   glow_writeSourcesSuffix(pOut);
+
+   bzero(connection);
+   connection.pSources = &source;
+   connection.sourcesLength = 1;
+
+   glow_writeConnectionsPrefix(pOut, path, 2);
+   for(number = 0; number < MATRIX_SIGNALS; number++)
+   {
+      connection.target = number;
+      source = (berint)(nextRandom() % MATRIX_SIGNALS);
+      glow_writeConnection(pOut, &connection);
+   }
+   glow_writeConnectionsSuffix(pOut);
+
+   return count + 3 * MATRIX_SIGNALS;
+}
+
+/**
+  * A stream collection of integer and real meter values.
+  */
+static int writeStreams(GlowOutput *pOut)
+{
+   GlowStreamEntry entry;
+   int index;
+
+   glowOutput_beginStreamPackage(pOut, false);
+
+   for(index = 0; index < STREAM_ENTRIES; index++)
+   {
+      bzero(entry);
+      entry.streamIdentifier = index;
+
+      if((index & 1) == 0)
+      {
+         entry.streamValue.flag = GlowParameterType_Integer;
+         entry.streamValue.choice.integer = (berlong)(nextRandom() & 0xFFFF) - 0x8000;
+      }
+      else
+      {
+         entry.streamValue.flag = GlowParameterType_Real;
+#ifdef GLOW_FIXED_REAL_FRACTION_BITS
+         entry.streamValue.choice.real = (berlong)(nextRandom() & 0xFFFFFF) - 0x800000;
+#else
+         entry.streamValue.choice.real = ((double)(nextRandom() & 0xFFFFFF) - 0x800000) / 0x10000;
+#endif
+      }
+
+      glow_writeStreamEntry(pOut, &entry);
+   }
+
+   return STREAM_ENTRIES;
+}
+
+
+// ====================================================================
+//
+// decoding
+//
+// ====================================================================
+
+static void onNode(const GlowNode *pNode, GlowFieldFlags fields, const berint *pPath, int pathLength, voidptr state)
+{
+   (void)pNode;
+   (void)fields;
+   (void)pPath;
+   (void)pathLength;
+
+   (*(int *)state)++;
+}
+
+static void onParameter(const GlowParameter *pParameter, GlowFieldFlags fields, const berint *pPath, int pathLength, voidptr state)
+{
+   (void)pParameter;
+   (void)fields;
+   (void)pPath;
+   (void)pathLength;
+
+   (*(int *)state)++;
+}
+
+static void onStreamEntry(const GlowStreamEntry *pStreamEntry, voidptr state)
+{
+   (void)pStreamEntry;
+
+   (*(int *)state)++;
+}
+
+static void onMatrix(const GlowMatrix *pMatrix, const berint *pPath, int pathLength, voidptr state)
+{
+   (void)pMatrix;
+   (void)pPath;
+   (void)pathLength;
+
+   (*(int *)state)++;
+}
+
+static void onSignal(const GlowSignal *pSignal, const berint *pPath, int pathLength, voidptr state)
+{
+   (void)pSignal;
+   (void)pPath;
+   (void)pathLength;
+
+   (*(int *)state)++;
+}
+
+static void onConnection(const GlowConnection *pConnection, const berint *pPath, int pathLength, voidptr state)
+{
+   (void)pConnection;
+   (void)pPath;
+   (void)pathLength;
+
+   (*(int *)state)++;
+}
+
+static int decode(GlowReader *pReader, const Stream *pStream)
+{
+   int count = 0;
+
+   pReader->base.state = (voidptr)&count;
+   glowReader_readBytes(pReader, pStream->pBytes, pStream->length);
+   glowReader_reset(pReader);
+
+   return count;
+}
+
+
+// ====================================================================
+//
+// benchmark
+//
+// ====================================================================
+
+typedef struct
+{
+   pcstr pName;
+   int (*write)(GlowOutput *pOut);
+} Scenario;
+
+static int encode(const Scenario *pScenario, Stream *pStream, byte *pTxBuffer)
+{
+   GlowOutput output;
+   int count;
+
+   randomState = BENCHMARK_SEED;
+   pStream->length = 0;
+
+   glowOutput_initMultiPackage(&output, pTxBuffer, EMBER_MAXIMUM_PACKAGE_LENGTH, 0, onPackageReady, (voidptr)pStream);
+   count = pScenario->write(&output);
+   stream_append(pStream, pTxBuffer, glowOutput_finishPackage(&output));
+
+   return count;
+}
+
+static void writeCorpusFile(pcstr pDirectory, const Scenario *pScenario, const Stream *pStream)
+{
+   char fileName[512];
+   FILE *pFile;
+
+   sprintf(fileName, "%.480s/%s.s101", pDirectory, pScenario->pName);
+   pFile = fopen(fileName, "wb");
+
+   if(pFile == NULL
+   || fwrite(pStream->pBytes, 1, pStream->length, pFile) != pStream->length)
+      onThrowError(0, "writing corpus file failed");
+
+   fclose(pFile);
+}
+
+static void printResult(pcstr pName, pcstr pDirection, const Stream *pStream, int elementCount, int iterations, double time)
+{
+   double seconds = time / 1000.0;
+
+   printf("%-12s %s: %8.2f MB/s %12.0f elements/s\n",
+          pName,
+          pDirection,
+          (double)pStream->length * iterations / seconds / (1024.0 * 1024.0),
+          (double)elementCount * iterations / seconds);
+}
+
+static void runScenario(const Scenario *pScenario, GlowReader *pReader, Stream *pStream, byte *pTxBuffer, pcstr pCorpusDirectory)
+{
+   clock_t start;
+   double time;
+   int elementCount;
+   int decodedCount;
+   int iterations;
+
+   elementCount = encode(pScenario, pStream, pTxBuffer);
+
+   if(pCorpusDirectory != NULL)
+      writeCorpusFile(pCorpusDirectory, pScenario, pStream);
+
+   iterations = 0;
+   start = clock();
+   do
+   {
+      encode(pScenario, pStream, pTxBuffer);
+      iterations++;
+      time = elapsed(start);
+   } while(time < BENCHMARK_MIN_DURATION);
+
+   printResult(pScenario->pName, "encode", pStream, elementCount, iterations, time);
+
+   iterations = 0;
+   start = clock();
+   do
+   {
+      decodedCount = decode(pReader, pStream);
+      iterations++;
+      time = elapsed(start);
+   } while(time < BENCHMARK_MIN_DURATION);
+
+   if(decodedCount != elementCount)
+   {
+      fprintf(stderr, "ERROR: %s: decoded %d elements, expected %d\n", pScenario->pName, decodedCount, elementCount);
+      exit(1);
+   }
+
+   printResult(pScenario->pName, "decode", pStream, elementCount, iterations, time);
+}
+
+
+// ====================================================================
+//
+// entry point
+//
+// ====================================================================
+
+int main(int argc, char **argv)
+{
+   static const Scenario scenarios[] =
+   {
+      { "deepnodes", writeDeepNodes },
+      { "matrix", writeMatrix },
+      { "streams", writeStreams },
+   };
+   static GlowReader reader;
+   static byte rxBuffer[EMBER_MAXIMUM_PACKAGE_LENGTH];
+   static byte txBuffer[EMBER_MAXIMUM_PACKAGE_LENGTH];
+   Stream stream;
+   pcstr pCorpusDirectory = argc >= 2 ? argv[1] : NULL;
+   unsigned int index;
+
+   ember_init(onThrowError, onFailAssertion, malloc, free);
+
+   stream.pBytes = (byte *)malloc(BENCHMARK_STREAM_SIZE);
+   stream.length = 0;
+
+   glowReader_init(&reader, onNode, onParameter, NULL, onStreamEntry, NULL, rxBuffer, sizeof(rxBuffer));
+   reader.base.onMatrix = onMatrix;
+   reader.base.onTarget = onSignal;
+   reader.base.onSource = onSignal;
+   reader.base.onConnection = onConnection;
+
+   for(index = 0; index < sizeof(scenarios) / sizeof(scenarios[0]); index++)
+      runScenario(&scenarios[index], &reader, &stream, txBuffer, pCorpusDirectory);
+
+   glowReader_free(&reader);
+   free(stream.pBytes);
+   return 0;
+}
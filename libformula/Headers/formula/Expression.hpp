@@ -0,0 +1,651 @@
+#ifndef __LIBFORMULA_EXPRESSION_HPP
+#define __LIBFORMULA_EXPRESSION_HPP
+
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include "traits/StringStreamConverter.h"
+#include "Types.hpp"
+
+namespace libformula { namespace expression
+{
+    /**
+     * The binding strength of an expression when it is printed as a term. An
+     * operand is enclosed in parentheses when it binds weaker than its operator.
+     */
+    struct Precedence
+    {
+        enum _Domain
+        {
+            /** +, - and %, which the parser treats alike. */
+            Additive = 1,
+
+            /** * and / */
+            Multiplicative,
+
+            /** ^ */
+            Power,
+
+            /** A negated atom, e.g. -$ or -2. */
+            Signed,
+
+            /** $, a constant or a function call. */
+            Atom,
+        };
+    };
+
+    /**
+     * Base class of all expressions, which provides the interface of a compiled
+     * Term. An expression is built at compile time from it(), constants, the
+     * arithmetic operators and the functions of this namespace, for example
+     * log(it()) * 20, which is printed as log($) * 20. The compiler inlines the whole computation, so there is no
+     * interpretation overhead at all. The semantics are those of
+     * CodeInterpreter::compute: an operation with two long operands yields a long,
+     * / always yields a real, % always yields a long and all functions except
+     * int, abs and sgn operate on reals. toString() returns the equivalent term,
+     * which the TermCompiler compiles into code with the same results. This way,
+     * a provider with hard-coded scaling can advertise the formula it evaluates.
+     * @param Derived The type of the expression, which provides
+     *      evaluate(long_type) and evaluate(real_type), a static precedence and
+     *      print(std::ostream&).
+     */
+    template<typename Derived>
+    struct Expression
+    {
+        /**
+         * Computes the expression for a single value.
+         * @param value The value of $.
+         * @return The result, converted to the type of @p value.
+         */
+        template<typename ValueType>
+        ValueType compute(ValueType value) const
+        {
+            typedef typename std::conditional<std::is_floating_point<ValueType>::value, real_type, long_type>::type ItemType;
+            return static_cast<ValueType>(derived().evaluate(static_cast<ItemType>(value)));
+        }
+
+        /**
+         * Computes the expression for a range of values.
+         * @param first The first value to compute.
+         * @param last The end of the range of values to compute.
+         * @param dest The first element of the range receiving the results.
+         * @return The end of the range of results.
+         */
+        template<typename InputIterator, typename OutputIterator>
+        OutputIterator compute(InputIterator first, InputIterator last, OutputIterator dest) const
+        {
+            for ( ; first != last; ++first, ++dest)
+                *dest = compute(*first);
+
+            return dest;
+        }
+
+        /**
+         * Returns the term this expression is equivalent to.
+         * @return The term this expression is equivalent to.
+         */
+        std::string toString() const
+        {
+            std::ostringstream stream;
+            derived().print(stream);
+            return stream.str();
+        }
+
+        /**
+         * Returns this expression as its actual type.
+         * @return This expression as its actual type.
+         */
+        Derived const& derived() const
+        {
+            return static_cast<Derived const&>(*this);
+        }
+    };
+
+    namespace detail
+    {
+        /**
+         * Prints an operand, enclosed in parentheses if it binds weaker than @p precedence.
+         * @param out The stream to print to.
+         * @param operand The operand to print.
+         * @param precedence The precedence the operand must have to be printed without parentheses.
+         */
+        template<typename Operand>
+        inline void printOperand(std::ostream& out, Operand const& operand, int precedence)
+        {
+            if (Operand::precedence < precedence)
+            {
+                out << '(';
+                operand.print(out);
+                out << ')';
+            }
+            else
+            {
+                operand.print(out);
+            }
+        }
+
+        /**
+         * Prints a real constant in the shortest fixed notation that is converted
+         * back into the same value. The decimal point is always printed, since the
+         * scanner treats a number without one as a long.
+         * @param out The stream to print to.
+         * @param value The non-negative value to print.
+         */
+        inline void printReal(std::ostream& out, real_type value)
+        {
+            auto text = std::string();
+            for (auto digits = 1; digits < 1100; ++digits)
+            {
+                std::ostringstream stream;
+                stream << std::fixed << std::setprecision(digits) << value;
+                text = stream.str();
+
+                if (traits::StringStreamConverter<real_type>::parse(text.begin(), text.end()) == value)
+                    break;
+            }
+
+            out << text;
+        }
+
+        /**
+         * Converts an operand of a function into a real.
+         */
+        template<typename ValueType>
+        inline real_type real(ValueType value)
+        {
+            return static_cast<real_type>(value);
+        }
+    }
+
+
+    // ========================================================
+    //
+    // Atoms
+    //
+    // ========================================================
+
+    /**
+     * The value an expression is computed for, printed as $.
+     */
+    struct It : Expression<It>
+    {
+        static int const precedence = Precedence::Atom;
+
+        template<typename ValueType>
+        ValueType evaluate(ValueType it) const
+        {
+            return it;
+        }
+
+        void print(std::ostream& out) const
+        {
+            out << '$';
+        }
+    };
+
+    /**
+     * A long or real constant.
+     */
+    template<typename ValueType>
+    struct Constant : Expression<Constant<ValueType> >
+    {
+        static int const precedence = Precedence::Atom;
+
+        explicit Constant(ValueType value)
+            : value(value)
+        {}
+
+        template<typename ItType>
+        ValueType evaluate(ItType) const
+        {
+            return value;
+        }
+
+        void print(std::ostream& out) const
+        {
+            // a negative constant is enclosed in parentheses, so that it may be
+            // the operand of any operator
+            if (value < ValueType(0))
+                out << "(-";
+
+            if (std::is_floating_point<ValueType>::value)
+                detail::printReal(out, value < ValueType(0) ? -value : value);
+            else
+                out << (value < ValueType(0) ? -value : value);
+
+            if (value < ValueType(0))
+                out << ')';
+        }
+
+        ValueType value;
+    };
+
+    /**
+     * One of the named constants pi and e. The values are the ones the parser uses.
+     */
+    template<int Value>
+    struct NamedConstant : Expression<NamedConstant<Value> >
+    {
+        static int const precedence = Precedence::Atom;
+
+        template<typename ItType>
+        real_type evaluate(ItType) const
+        {
+            return Value == 0
+                ? 3.14159265358979323846
+                : 2.71828182845904523536;
+        }
+
+        void print(std::ostream& out) const
+        {
+            out << (Value == 0 ? "pi" : "e");
+        }
+    };
+
+    /**
+     * Returns the expression for the value the expression is computed for ($).
+     */
+    inline It it()
+    {
+        return It();
+    }
+
+    /**
+     * Returns the expression for pi.
+     */
+    inline NamedConstant<0> pi()
+    {
+        return NamedConstant<0>();
+    }
+
+    /**
+     * Returns the expression for e.
+     */
+    inline NamedConstant<1> e()
+    {
+        return NamedConstant<1>();
+    }
+
+    /**
+     * Returns the expression for a long constant.
+     */
+    inline Constant<long_type> constant(long_type value)
+    {
+        return Constant<long_type>(value);
+    }
+
+    /**
+     * Returns the expression for a real constant.
+     */
+    inline Constant<real_type> constant(real_type value)
+    {
+        return Constant<real_type>(value);
+    }
+
+
+    // ========================================================
+    //
+    // Operators
+    //
+    // ========================================================
+
+    namespace detail
+    {
+        struct Add
+        {
+            static int const precedence = Precedence::Additive;
+            static char const* symbol() { return "+"; }
+
+            template<typename X, typename Y>
+            static auto apply(X x, Y y) -> decltype(x + y) { return x + y; }
+        };
+
+        struct Subtract
+        {
+            static int const precedence = Precedence::Additive;
+            static char const* symbol() { return "-"; }
+
+            template<typename X, typename Y>
+            static auto apply(X x, Y y) -> decltype(x - y) { return x - y; }
+        };
+
+        struct Modulo
+        {
+            static int const precedence = Precedence::Additive;
+            static char const* symbol() { return "%"; }
+
+            template<typename X, typename Y>
+            static long_type apply(X x, Y y) { return static_cast<long_type>(x) % static_cast<long_type>(y); }
+        };
+
+        struct Multiply
+        {
+            static int const precedence = Precedence::Multiplicative;
+            static char const* symbol() { return "*"; }
+
+            template<typename X, typename Y>
+            static auto apply(X x, Y y) -> decltype(x * y) { return x * y; }
+        };
+
+        struct Divide
+        {
+            static int const precedence = Precedence::Multiplicative;
+            static char const* symbol() { return "/"; }
+
+            template<typename X, typename Y>
+            static real_type apply(X x, Y y) { return real(x) / real(y); }
+        };
+
+        struct Power
+        {
+            static int const precedence = Precedence::Power;
+            static char const* symbol() { return "^"; }
+
+            template<typename X, typename Y>
+            static real_type apply(X x, Y y) { return std::pow(real(x), real(y)); }
+        };
+
+        /**
+         * Converts the operand of an operator into an expression. Integral
+         * constants become long constants, floating point constants become real
+         * constants.
+         */
+        template<typename ValueType, typename Enable = void>
+        struct ToExpression
+        {
+            typedef ValueType type;
+
+            static ValueType const& convert(ValueType const& value)
+            {
+                return value;
+            }
+        };
+
+        template<typename ValueType>
+        struct ToExpression<ValueType, typename std::enable_if<std::is_integral<ValueType>::value>::type>
+        {
+            typedef Constant<long_type> type;
+
+            static type convert(ValueType value)
+            {
+                return type(static_cast<long_type>(value));
+            }
+        };
+
+        template<typename ValueType>
+        struct ToExpression<ValueType, typename std::enable_if<std::is_floating_point<ValueType>::value>::type>
+        {
+            typedef Constant<real_type> type;
+
+            static type convert(ValueType value)
+            {
+                return type(static_cast<real_type>(value));
+            }
+        };
+
+        /**
+         * Tests whether at least one operand of an operator is an expression.
+         */
+        template<typename X, typename Y>
+        struct IsOperation
+        {
+            static bool const value =
+                (std::is_base_of<Expression<X>, X>::value && (std::is_base_of<Expression<Y>, Y>::value || std::is_arithmetic<Y>::value))
+            ||  (std::is_base_of<Expression<Y>, Y>::value && std::is_arithmetic<X>::value);
+        };
+    }
+
+    /**
+     * An operator applied to two operands. The operator is evaluated left to
+     * right, like the parser does, so the right operand is enclosed in
+     * parentheses when it binds no stronger than the operator.
+     */
+    template<typename Operator, typename X, typename Y>
+    struct Binary : Expression<Binary<Operator, X, Y> >
+    {
+        static int const precedence = Operator::precedence;
+
+        Binary(X const& x, Y const& y)
+            : x(x)
+            , y(y)
+        {}
+
+        template<typename ItType>
+        auto evaluate(ItType it) const -> decltype(Operator::apply(std::declval<X const&>().evaluate(it), std::declval<Y const&>().evaluate(it)))
+        {
+            return Operator::apply(x.evaluate(it), y.evaluate(it));
+        }
+
+        void print(std::ostream& out) const
+        {
+            detail::printOperand(out, x, precedence);
+            // the spaces are required after a real constant, since the scanner takes
+            // a + or - following the digits for the sign of an exponent
+            out << ' ' << Operator::symbol() << ' ';
+
+            // the parser accepts $ - -$, but $ - (-$) is easier to read
+            detail::printOperand(out, y, Y::precedence == Precedence::Signed ? Precedence::Atom : precedence + 1);
+        }
+
+        X x;
+        Y y;
+    };
+
+    /**
+     * The negation of an expression.
+     */
+    template<typename X>
+    struct Negate : Expression<Negate<X> >
+    {
+        static int const precedence = Precedence::Signed;
+
+        explicit Negate(X const& x)
+            : x(x)
+        {}
+
+        template<typename ItType>
+        auto evaluate(ItType it) const -> decltype(-std::declval<X const&>().evaluate(it))
+        {
+            return -x.evaluate(it);
+        }
+
+        void print(std::ostream& out) const
+        {
+            out << '-';
+            detail::printOperand(out, x, Precedence::Atom);
+        }
+
+        X x;
+    };
+
+#define LIBFORMULA_EXPRESSION_OPERATOR(op, Operator)                                                                       \
+    template<typename X, typename Y>                                                                                        \
+    inline typename std::enable_if<                                                                                         \
+        detail::IsOperation<X, Y>::value,                                                                                   \
+        Binary<detail::Operator, typename detail::ToExpression<X>::type, typename detail::ToExpression<Y>::type> >::type    \
+    operator op(X const& x, Y const& y)                                                                                     \
+    {                                                                                                                       \
+        typedef Binary<detail::Operator, typename detail::ToExpression<X>::type, typename detail::ToExpression<Y>::type> result_type; \
+        return result_type(detail::ToExpression<X>::convert(x), detail::ToExpression<Y>::convert(y));                      \
+    }
+
+    LIBFORMULA_EXPRESSION_OPERATOR(+, Add)
+    LIBFORMULA_EXPRESSION_OPERATOR(-, Subtract)
+    LIBFORMULA_EXPRESSION_OPERATOR(%, Modulo)
+    LIBFORMULA_EXPRESSION_OPERATOR(*, Multiply)
+    LIBFORMULA_EXPRESSION_OPERATOR(/, Divide)
+
+#undef LIBFORMULA_EXPRESSION_OPERATOR
+
+    /**
+     * Returns the negation of an expression.
+     */
+    template<typename X>
+    inline Negate<X> operator-(Expression<X> const& x)
+    {
+        return Negate<X>(x.derived());
+    }
+
+    /**
+     * Returns the expression raising @p x to the power of @p y, printed as x^y.
+     * The term language has no pow function.
+     */
+    template<typename X, typename Y>
+    inline typename std::enable_if<
+        detail::IsOperation<X, Y>::value,
+        Binary<detail::Power, typename detail::ToExpression<X>::type, typename detail::ToExpression<Y>::type> >::type
+    pow(X const& x, Y const& y)
+    {
+        typedef Binary<detail::Power, typename detail::ToExpression<X>::type, typename detail::ToExpression<Y>::type> result_type;
+        return result_type(detail::ToExpression<X>::convert(x), detail::ToExpression<Y>::convert(y));
+    }
+
+
+    // ========================================================
+    //
+    // Functions
+    //
+    // ========================================================
+
+    /**
+     * A call of a function with one or two arguments. The arguments are printed
+     * without parentheses, since they are terms of their own.
+     */
+    template<typename Function, typename X, typename Y = void>
+    struct Call : Expression<Call<Function, X, Y> >
+    {
+        static int const precedence = Precedence::Atom;
+
+        Call(X const& x, Y const& y)
+            : x(x)
+            , y(y)
+        {}
+
+        template<typename ItType>
+        auto evaluate(ItType it) const -> decltype(Function::apply(std::declval<X const&>().evaluate(it), std::declval<Y const&>().evaluate(it)))
+        {
+            return Function::apply(x.evaluate(it), y.evaluate(it));
+        }
+
+        void print(std::ostream& out) const
+        {
+            out << Function::name() << '(';
+            x.print(out);
+            out << ", ";
+            y.print(out);
+            out << ')';
+        }
+
+        X x;
+        Y y;
+    };
+
+    template<typename Function, typename X>
+    struct Call<Function, X, void> : Expression<Call<Function, X, void> >
+    {
+        static int const precedence = Precedence::Atom;
+
+        explicit Call(X const& x)
+            : x(x)
+        {}
+
+        template<typename ItType>
+        auto evaluate(ItType it) const -> decltype(Function::apply(std::declval<X const&>().evaluate(it)))
+        {
+            return Function::apply(x.evaluate(it));
+        }
+
+        void print(std::ostream& out) const
+        {
+            out << Function::name() << '(';
+            x.print(out);
+            out << ')';
+        }
+
+        X x;
+    };
+
+#define LIBFORMULA_EXPRESSION_FUNCTION(function, term, Function, ResultType, expression)    \
+    namespace detail                                                                        \
+    {                                                                                       \
+        struct Function                                                                     \
+        {                                                                                   \
+            static char const* name() { return term; }                                      \
+                                                                                            \
+            template<typename X>                                                            \
+            static ResultType apply(X x) { return expression; }                             \
+        };                                                                                  \
+    }                                                                                       \
+                                                                                            \
+    template<typename X>                                                                    \
+    inline Call<detail::Function, X> function(Expression<X> const& x)                       \
+    {                                                                                       \
+        return Call<detail::Function, X>(x.derived());                                      \
+    }
+
+    LIBFORMULA_EXPRESSION_FUNCTION(exp, "exp", Exp, real_type, std::exp(real(x)))
+    LIBFORMULA_EXPRESSION_FUNCTION(cos, "cos", Cos, real_type, std::cos(real(x)))
+    LIBFORMULA_EXPRESSION_FUNCTION(sin, "sin", Sin, real_type, std::sin(real(x)))
+    LIBFORMULA_EXPRESSION_FUNCTION(tan, "tan", Tan, real_type, std::tan(real(x)))
+    LIBFORMULA_EXPRESSION_FUNCTION(acos, "acos", Acos, real_type, std::acos(real(x)))
+    LIBFORMULA_EXPRESSION_FUNCTION(asin, "asin", Asin, real_type, std::asin(real(x)))
+    LIBFORMULA_EXPRESSION_FUNCTION(atan, "atan", Atan, real_type, std::atan(real(x)))
+    LIBFORMULA_EXPRESSION_FUNCTION(cosh, "cosh", Cosh, real_type, std::cosh(real(x)))
+    LIBFORMULA_EXPRESSION_FUNCTION(sinh, "sinh", Sinh, real_type, std::sinh(real(x)))
+    LIBFORMULA_EXPRESSION_FUNCTION(tanh, "tanh", Tanh, real_type, std::tanh(real(x)))
+    LIBFORMULA_EXPRESSION_FUNCTION(toLong, "int", Int, long_type, static_cast<long_type>(x))
+    LIBFORMULA_EXPRESSION_FUNCTION(toReal, "float", Float, real_type, real(x))
+    LIBFORMULA_EXPRESSION_FUNCTION(log, "log", Log, real_type, std::log(real(x)))
+    LIBFORMULA_EXPRESSION_FUNCTION(ln, "ln", Ln, real_type, std::log(real(x)))
+    LIBFORMULA_EXPRESSION_FUNCTION(round, "round", Round, real_type, std::floor(real(x)))
+    LIBFORMULA_EXPRESSION_FUNCTION(ceil, "ceil", Ceil, real_type, std::ceil(real(x)))
+    LIBFORMULA_EXPRESSION_FUNCTION(sqrt, "sqrt", Sqrt, real_type, std::sqrt(real(x)))
+    LIBFORMULA_EXPRESSION_FUNCTION(abs, "abs", Abs, X, std::abs(x))
+    LIBFORMULA_EXPRESSION_FUNCTION(sgn, "sgn", Sgn, long_type, x < X(0) ? -1 : (x > X(0) ? 1 : 0))
+
+#undef LIBFORMULA_EXPRESSION_FUNCTION
+
+    namespace detail
+    {
+        struct Atan2
+        {
+            static char const* name() { return "atan"; }
+
+            template<typename X, typename Y>
+            static real_type apply(X x, Y y) { return std::atan2(real(y), real(x)); }
+        };
+
+        struct LogBase
+        {
+            static char const* name() { return "log"; }
+
+            template<typename X, typename Y>
+            static real_type apply(X x, Y y) { return std::log(real(x)) / std::log(real(y)); }
+        };
+    }
+
+    /**
+     * Returns the expression atan(x, y), which the CodeInterpreter computes as atan2(y, x).
+     */
+    template<typename X, typename Y>
+    inline Call<detail::Atan2, X, Y> atan(Expression<X> const& x, Expression<Y> const& y)
+    {
+        return Call<detail::Atan2, X, Y>(x.derived(), y.derived());
+    }
+
+    /**
+     * Returns the expression log(x, base).
+     */
+    template<typename X, typename Y>
+    inline Call<detail::LogBase, X, Y> log(Expression<X> const& x, Expression<Y> const& base)
+    {
+        return Call<detail::LogBase, X, Y>(x.derived(), base.derived());
+    }
+}
+}
+
+#endif  // __LIBFORMULA_EXPRESSION_HPP
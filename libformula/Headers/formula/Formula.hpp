@@ -21,9 +21,13 @@
 #define __LIBFORMULA_FORMULA_HPP
 
 #include "Version.hpp"
+#include "util/ClosureCompiler.hpp"
 #include "util/CodeDump.hpp"
 #include "util/CodeInterpreter.hpp"
 #include "CodeEmitter.hpp"
+#include "Expression.hpp"
+#include "FormulaPair.hpp"
+#include "TermCache.hpp"
 #include "TermCompiler.hpp"
 
 #endif  // __LIBFORMULA_FORMULA_HPP
@@ -0,0 +1,192 @@
+#ifndef __LIBFORMULA_FORMULAPAIR_HPP
+#define __LIBFORMULA_FORMULAPAIR_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+#include "TermCache.hpp"
+
+namespace libformula
+{
+    /**
+     * The two terms of a glow formula, which convert a parameter value from the
+     * provider's to the consumer's representation and back. Both terms are compiled
+     * through the TermCache. For a known range of provider values, the pair can check
+     * whether the terms are inverse to each other and build a lookup table, which
+     * approximates an expensive consumer to provider term by linear interpolation.
+     */
+    class FormulaPair
+    {
+        public:
+            /**
+             * Initializes a new formula pair by compiling both terms.
+             * @param providerToConsumer The term converting provider values into consumer values.
+             * @param consumerToProvider The term converting consumer values into provider values.
+             * @param error Error stack, must not be nullptr. Collects the errors of both terms.
+             */
+            FormulaPair(std::string const& providerToConsumer, std::string const& consumerToProvider, ErrorStack* error);
+
+            /**
+             * Converts a provider value into a consumer value.
+             * @param value The provider value.
+             * @return The consumer value.
+             */
+            real_type toConsumer(real_type value) const;
+
+            /**
+             * Converts a consumer value into a provider value by computing the
+             * consumer to provider term.
+             * @param value The consumer value.
+             * @return The provider value.
+             */
+            real_type toProvider(real_type value) const;
+
+            /**
+             * Converts a consumer value into a provider value, using the lookup table
+             * created by buildInverseTable. Values outside of the table are clamped
+             * to its range. Without a table, the term is computed.
+             * @param value The consumer value.
+             * @return The approximated provider value.
+             */
+            real_type toProviderApproximate(real_type value) const;
+
+            /**
+             * Checks whether the consumer to provider term reverts the provider to
+             * consumer term on @p samples points equally spaced in [first, last].
+             * @param first The smallest provider value to check.
+             * @param last The largest provider value to check.
+             * @param samples The number of points to check, at least 2.
+             * @param tolerance The maximum deviation, relative to the magnitude of the
+             *      provider value, or absolute for values below 1.
+             * @return true if the terms are inverse on all sample points.
+             */
+            bool isInverse(real_type first, real_type last, int samples, real_type tolerance) const;
+
+            /**
+             * Builds a lookup table for toProviderApproximate. The consumer to provider
+             * term is computed on @p size points equally spaced between the consumer
+             * values of @p first and @p last. Since the consumer values are equally
+             * spaced, a lookup does not need to search the table.
+             * @param first The provider value at the start of the table.
+             * @param last The provider value at the end of the table.
+             * @param size The number of table entries, at least 2.
+             * @return true if the table has been built, false if the term is not
+             *      strictly monotonic in the range or produces invalid values.
+             */
+            bool buildInverseTable(real_type first, real_type last, int size);
+
+            /**
+             * Returns true if a lookup table has been built.
+             * @return true if a lookup table has been built.
+             */
+            bool hasInverseTable() const;
+
+        private:
+            CompiledTerm m_providerToConsumer;
+            CompiledTerm m_consumerToProvider;
+            std::vector<real_type> m_providerValues;
+            real_type m_consumerFirst;
+            real_type m_consumerStep;
+    };
+
+    /**************************************************************************
+     * Inline implementation                                                  *
+     **************************************************************************/
+
+    inline FormulaPair::FormulaPair(std::string const& providerToConsumer, std::string const& consumerToProvider, ErrorStack* error)
+        : m_providerToConsumer(TermCache::instance().compile(providerToConsumer, error))
+        , m_consumerToProvider(TermCache::instance().compile(consumerToProvider, error))
+        , m_consumerFirst(0.0)
+        , m_consumerStep(0.0)
+    {}
+
+    inline real_type FormulaPair::toConsumer(real_type value) const
+    {
+        return m_providerToConsumer.compute(value);
+    }
+
+    inline real_type FormulaPair::toProvider(real_type value) const
+    {
+        return m_consumerToProvider.compute(value);
+    }
+
+    inline real_type FormulaPair::toProviderApproximate(real_type value) const
+    {
+        if (m_providerValues.empty())
+            return toProvider(value);
+
+        auto const last = m_providerValues.size() - 1;
+        auto const position = (value - m_consumerFirst) / m_consumerStep;
+
+        if (!(position > 0.0))
+            return m_providerValues.front();
+
+        if (position >= last)
+            return m_providerValues.back();
+
+        auto const index = static_cast<std::vector<real_type>::size_type>(position);
+        auto const fraction = position - index;
+        return m_providerValues[index] + fraction * (m_providerValues[index + 1] - m_providerValues[index]);
+    }
+
+    inline bool FormulaPair::isInverse(real_type first, real_type last, int samples, real_type tolerance) const
+    {
+        auto const step = (last - first) / std::max(samples - 1, 1);
+
+        for (auto i = 0; i < samples; ++i)
+        {
+            auto const value = first + i * step;
+            auto const result = toProvider(toConsumer(value));
+            auto const deviation = std::abs(result - value);
+
+            if (!(deviation <= tolerance * std::max(std::abs(value), real_type(1.0))))
+                return false;
+        }
+
+        return true;
+    }
+
+    inline bool FormulaPair::buildInverseTable(real_type first, real_type last, int size)
+    {
+        auto const consumerFirst = toConsumer(first);
+        auto const consumerLast = toConsumer(last);
+
+        if (size < 2 || std::isfinite(consumerFirst) == false || std::isfinite(consumerLast) == false || consumerFirst == consumerLast)
+            return false;
+
+        auto const step = (consumerLast - consumerFirst) / (size - 1);
+        auto const ascending = first < last;
+        auto values = std::vector<real_type>();
+
+        values.reserve(size);
+
+        for (auto i = 0; i < size; ++i)
+        {
+            auto const value = toProvider(consumerFirst + i * step);
+
+            if (std::isfinite(value) == false)
+                return false;
+
+            if (i > 0 && (value > values.back()) != ascending)
+                return false;
+
+            if (i > 0 && value == values.back())
+                return false;
+
+            values.push_back(value);
+        }
+
+        m_providerValues.swap(values);
+        m_consumerFirst = consumerFirst;
+        m_consumerStep = step;
+        return true;
+    }
+
+    inline bool FormulaPair::hasInverseTable() const
+    {
+        return m_providerValues.empty() == false;
+    }
+}
+
+#endif  // __LIBFORMULA_FORMULAPAIR_HPP
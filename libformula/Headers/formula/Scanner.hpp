@@ -1,26 +1,32 @@
 #ifndef __LIBFORMULA_SCANNER_HPP
 #define __LIBFORMULA_SCANNER_HPP
 
+#include <iterator>
 #include <string>
 #include "ErrorStack.hpp"
 #include "Symbol.hpp"
+#include "util/Arena.hpp"
 
 namespace libformula
 {
     /**
      * The Scanner is iterating through the term string and identifies the single tokens which
      * are used for parsing in the second pass.
+     * The scanner does not copy the term, the symbols refer to the scanned character range.
+     * The symbols themselves are stored in an arena provided by the caller, which usually
+     * lives as long as a single compilation. Since each symbol but the final EndOfFile
+     * symbol consumes at least one character, the storage for all symbols is allocated
+     * at once and never has to grow.
      */
     template<typename InputIterator>
     class Scanner
     {
-        typedef std::vector<Symbol<InputIterator>> SymbolContainer;
         public:
-            typedef typename SymbolContainer::value_type value_type;
-            typedef typename SymbolContainer::size_type size_type;
-            typedef typename SymbolContainer::const_iterator const_iterator;
-            typedef typename SymbolContainer::reference reference;
-            typedef typename SymbolContainer::const_reference const_reference;
+            typedef Symbol<InputIterator> value_type;
+            typedef std::size_t size_type;
+            typedef value_type const* const_iterator;
+            typedef value_type& reference;
+            typedef value_type const& const_reference;
             typedef typename InputIterator input_type;
 
             /**
@@ -28,10 +34,11 @@ namespace libformula
              * @param first Pointer to the first character in the term buffer.
              * @param last Points to the first item beyond the term to scan.
              * @param error Pointer to the error stack, where all detected errors are logged.
-             * @note Note that the provided buffer must exist as long as the scanner instance
-             *      is alive!
+             * @param arena The arena the symbols are allocated from.
+             * @note Note that the provided buffer and the arena must exist as long as the
+             *      scanner instance is alive!
              */
-            Scanner(InputIterator first, InputIterator last, ErrorStack *error);
+            Scanner(InputIterator first, InputIterator last, ErrorStack *error, util::Arena& arena);
 
             /**
              * Returns the number of tokens identified and created by the scanner.
@@ -90,7 +97,8 @@ namespace libformula
             InputIterator scanNumber(InputIterator first, InputIterator last, ErrorStack *error);
 
         private:
-            SymbolContainer m_symbols;
+            value_type* m_symbols;
+            size_type m_size;
     };
 
     /**************************************************************************
@@ -98,7 +106,9 @@ namespace libformula
      **************************************************************************/
 
     template<typename InputIterator>
-    inline Scanner<InputIterator>::Scanner(InputIterator first, InputIterator last, ErrorStack *error)
+    inline Scanner<InputIterator>::Scanner(InputIterator first, InputIterator last, ErrorStack *error, util::Arena& arena)
+        : m_symbols(arena.allocate<value_type>(static_cast<size_type>(std::distance(first, last)) + 1))
+        , m_size(0)
     {
         while(first != last && isspace(*first))
             ++first;
@@ -135,19 +145,19 @@ namespace libformula
     template<typename InputIterator>
     inline typename Scanner<InputIterator>::size_type Scanner<InputIterator>::size() const
     {
-        return m_symbols.size();
+        return m_size;
     }
 
     template<typename InputIterator>
     inline typename Scanner<InputIterator>::const_iterator Scanner<InputIterator>::begin() const
     {
-        return m_symbols.begin();
+        return m_symbols;
     }
 
     template<typename InputIterator>
     inline typename Scanner<InputIterator>::const_iterator Scanner<InputIterator>::end() const
     {
-        return m_symbols.end();
+        return m_symbols + m_size;
     }
 
     template<typename InputIterator>
@@ -285,7 +295,8 @@ namespace libformula
     template<typename InputIterator>
     inline void Scanner<InputIterator>::push(const_reference symbol)
     {
-        m_symbols.push_back(symbol);
+        new (m_symbols + m_size) value_type(symbol);
+        ++m_size;
     }
 }
 
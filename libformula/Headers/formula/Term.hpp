@@ -5,7 +5,10 @@
 #include "ErrorStack.hpp"
 #include "Scanner.hpp"
 #include "Parser.hpp"
+#include "util\Arena.hpp"
 #include "util\CodeInterpreter.hpp"
+#include <algorithm>
+#include <iterator>
 #include <memory>
 
 namespace libformula
@@ -19,6 +22,9 @@ namespace libformula
      *      signature: 
      *          template<typename DestType>
      *          DestType compute(DestType);
+     *      Copies of a term share the compiled code, which is not modified after
+     *      the term has been constructed. With the CodeInterpreter, a term may
+     *      therefore be computed on multiple threads at once.
      */
     template<typename CodeEmitterType>
     class Term
@@ -36,6 +42,18 @@ namespace libformula
             template<typename InputIterator>
             Term(InputIterator first, InputIterator last, ErrorStack* error);
 
+            /**
+             * Initializes a new term by parsing and compiling the term string in the
+             * character range [first, last), which is not copied. All temporary objects
+             * created while compiling are allocated from @p arena.
+             * @param first Points to the first character of the term.
+             * @param last Points to the first character beyond the term.
+             * @param error A pointer to the error stack which collects errors
+             *      that occur during scanning or parsing the term.
+             * @param arena The arena used for the temporary objects of the compilation.
+             */
+            Term(char const* first, char const* last, ErrorStack* error, util::Arena& arena);
+
             /**
              * Computes the term and returns the result.
              * @param value The value to use for the '$' symbol.
@@ -44,6 +62,45 @@ namespace libformula
             template<typename ValueType>
             ValueType compute(ValueType value) const;
 
+            /**
+             * Computes the term for each value in the range [first, last).
+             * This requires the CodeEmitterType to provide a function with the
+             * same signature.
+             * @param first The first value to use for the '$' symbol.
+             * @param last The end of the range of values.
+             * @param dest The output iterator to write the results to.
+             * @return Returns the output iterator pointing beyond the last result.
+             */
+            template<typename InputIterator, typename OutputIterator>
+            OutputIterator compute(InputIterator first, InputIterator last, OutputIterator dest) const;
+
+            /**
+             * Computes the term for each value in the range [first, last), using the
+             * scratch memory of a context owned by the calling thread, e.g. a
+             * util::CodeInterpreter::Context. This requires the CodeEmitterType
+             * to provide a function with the same signature.
+             * @param first The first value to use for the '$' symbol.
+             * @param last The end of the range of values.
+             * @param dest The output iterator to write the results to.
+             * @param context The context of the calling thread.
+             * @return Returns the output iterator pointing beyond the last result.
+             */
+            template<typename InputIterator, typename OutputIterator, typename ContextType>
+            OutputIterator compute(InputIterator first, InputIterator last, OutputIterator dest, ContextType& context) const;
+
+            /**
+             * Returns the compiled code of this term, which is shared by all copies
+             * and must not be modified.
+             * @return The compiled code.
+             */
+            std::shared_ptr<CodeEmitterType const> program() const;
+
+        private:
+            /**
+             * Scans and parses the term and emits its code.
+             */
+            void compile(char const* first, char const* last, ErrorStack* error, util::Arena& arena);
+
         private:
             std::shared_ptr<CodeEmitterType> m_emitter;
     };
@@ -57,11 +114,29 @@ namespace libformula
     inline Term<CodeEmitterType>::Term(InputIterator first, InputIterator last, ErrorStack* error)
         : m_emitter(std::make_shared<CodeEmitterType>())
     {
-        auto const scanner = Scanner<InputIterator>(first, last, error);
+        // The term is copied into the arena, so the scanner always runs over a plain character range
+        util::Arena arena;
+        auto const length = static_cast<std::size_t>(std::distance(first, last));
+        auto const buffer = arena.allocate<char>(length);
+        std::copy(first, last, buffer);
+        compile(buffer, buffer + length, error, arena);
+    }
+
+    template<typename CodeEmitterType>
+    inline Term<CodeEmitterType>::Term(char const* first, char const* last, ErrorStack* error, util::Arena& arena)
+        : m_emitter(std::make_shared<CodeEmitterType>())
+    {
+        compile(first, last, error, arena);
+    }
+
+    template<typename CodeEmitterType>
+    inline void Term<CodeEmitterType>::compile(char const* first, char const* last, ErrorStack* error, util::Arena& arena)
+    {
+        auto const scanner = Scanner<char const*>(first, last, error, arena);
         if (error->empty())
         {
             auto emitter = m_emitter.get();
-            auto const parser = Parser<InputIterator>(scanner, emitter, error);
+            auto const parser = Parser<char const*>(scanner, emitter, error);
         }
     }
 
@@ -73,7 +148,33 @@ namespace libformula
         return result;
     }
 
+    template<typename CodeEmitterType>
+    template<typename InputIterator, typename OutputIterator>
+    OutputIterator Term<CodeEmitterType>::compute(InputIterator first, InputIterator last, OutputIterator dest) const
+    {
+        return m_emitter->compute(first, last, dest);
+    }
+
+    template<typename CodeEmitterType>
+    template<typename InputIterator, typename OutputIterator, typename ContextType>
+    OutputIterator Term<CodeEmitterType>::compute(InputIterator first, InputIterator last, OutputIterator dest, ContextType& context) const
+    {
+        return m_emitter->compute(first, last, dest, context);
+    }
+
+    template<typename CodeEmitterType>
+    std::shared_ptr<CodeEmitterType const> Term<CodeEmitterType>::program() const
+    {
+        return m_emitter;
+    }
+
     typedef Term<util::CodeInterpreter> CompiledTerm;
+
+    /**
+     * A compiled term that computes transcendental functions approximately.
+     * @see util::FastMath
+     */
+    typedef Term<util::FastMathCodeInterpreter> FastCompiledTerm;
 }
 
 #endif  // __LIBFORMULA_TERM_HPP
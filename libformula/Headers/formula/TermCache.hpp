@@ -0,0 +1,175 @@
+#ifndef __LIBFORMULA_TERMCACHE_HPP
+#define __LIBFORMULA_TERMCACHE_HPP
+
+#include <cctype>
+#include <map>
+#include <mutex>
+#include <string>
+#include "TermCompiler.hpp"
+
+namespace libformula
+{
+    /**
+     * A process wide cache of compiled terms, keyed by the normalized term string.
+     * Many parameters usually share the same few formulas, so each of them is only
+     * compiled once and the compiled code is shared by all terms returned for it.
+     * The cache may be used from multiple threads, and so may the shared terms.
+     * Threads computing ranges of values should keep their own
+     * util::CodeInterpreter::Context to avoid allocating scratch memory per call.
+     */
+    class TermCache
+    {
+        typedef std::map<std::string, CompiledTerm> TermCollection;
+        public:
+            typedef TermCollection::size_type size_type;
+
+            /**
+             * Returns the process wide cache instance.
+             * @return The process wide cache instance.
+             */
+            static TermCache& instance();
+
+            /**
+             * Returns the compiled term for the provided term string. If the term has
+             * not been compiled before, it is compiled and stored in the cache. Terms
+             * that fail to compile are not stored, so their errors are reported to
+             * every caller.
+             * @param term Termstring to compile.
+             * @param error Error stack, must not be nullptr.
+             * @return The compiled term.
+             */
+            CompiledTerm compile(std::string const& term, ErrorStack* error);
+
+            /**
+             * Returns the compiled term for the provided term string.
+             * @param term Termstring to compile.
+             * @return The compiled term.
+             */
+            CompiledTerm compile(std::string const& term);
+
+            /**
+             * Returns the number of cached terms.
+             * @return The number of cached terms.
+             */
+            size_type size() const;
+
+            /**
+             * Removes all terms from the cache. Terms that have already been
+             * returned remain valid.
+             */
+            void clear();
+
+            /**
+             * Returns the key a term string is cached with. Letters are converted to
+             * lower case and whitespace is removed, unless it separates two parts of
+             * a symbol that would otherwise be scanned as one.
+             * @param term The term string to normalize.
+             * @return The normalized term string.
+             */
+            static std::string normalize(std::string const& term);
+
+        private:
+            /** Constructor */
+            TermCache();
+
+            /** Non-copyable */
+            TermCache(TermCache const&);
+            TermCache& operator=(TermCache const&);
+
+        private:
+            TermCollection m_terms;
+            mutable std::mutex m_mutex;
+    };
+
+    /**************************************************************************
+     * Inline implementation                                                  *
+     **************************************************************************/
+
+    inline TermCache::TermCache()
+    {}
+
+    inline TermCache& TermCache::instance()
+    {
+        static TermCache instance;
+        return instance;
+    }
+
+    inline CompiledTerm TermCache::compile(std::string const& term, ErrorStack* error)
+    {
+        auto const key = normalize(term);
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto const result = m_terms.find(key);
+            if (result != m_terms.end())
+                return result->second;
+        }
+
+        auto local = ErrorStack();
+        auto const compiled = TermCompiler::compile(term, &local);
+
+        if (local.any())
+        {
+            for (auto const& item : local)
+                error->push(item);
+
+            return compiled;
+        }
+
+        // another thread may have compiled the same term meanwhile, its result wins
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto const result = m_terms.insert(std::make_pair(key, compiled));
+        return result.first->second;
+    }
+
+    inline CompiledTerm TermCache::compile(std::string const& term)
+    {
+        auto error = ErrorStack();
+        return compile(term, &error);
+    }
+
+    inline TermCache::size_type TermCache::size() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_terms.size();
+    }
+
+    inline void TermCache::clear()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_terms.clear();
+    }
+
+    inline std::string TermCache::normalize(std::string const& term)
+    {
+        auto const isSymbolPart = [](char c) -> bool
+        {
+            return ::isalnum(static_cast<unsigned char>(c)) != 0 || c == '.';
+        };
+
+        auto result = std::string();
+        auto separated = false;
+
+        result.reserve(term.size());
+
+        for (auto const c : term)
+        {
+            if (::isspace(static_cast<unsigned char>(c)))
+            {
+                separated = true;
+                continue;
+            }
+
+            // "1 2" or "1.5e +3" must not become a single number
+            if (separated && result.empty() == false && isSymbolPart(result.back()) && (isSymbolPart(c) || c == '+' || c == '-'))
+                result.push_back(' ');
+
+            result.push_back(static_cast<char>(::tolower(static_cast<unsigned char>(c))));
+            separated = false;
+        }
+
+        return result;
+    }
+}
+
+#endif  // __LIBFORMULA_TERMCACHE_HPP
@@ -11,6 +11,21 @@ namespace libformula
     class TermCompiler
     {
         public:
+            /**
+             * Compiles a term from a character range, which is scanned in place, and
+             * returns the compilaton result. The temporary objects of the compilation
+             * are allocated from an arena that is released before this method returns.
+             * @param first Pointer to the first character of the term string.
+             * @param last Points to the first item beyond the term string.
+             * @param error Error stack, must not be nullptr.
+             */
+            static CompiledTerm compile(char const* first, char const* last, ErrorStack* error)
+            {
+                util::Arena arena;
+                auto const term = CompiledTerm(first, last, error, arena);
+                return term;
+            }
+
             /**
              * Compiles a term and returns the compilaton result.
              * @param first Pointer to the first character of the term string.
@@ -44,8 +59,8 @@ namespace libformula
              */
             static CompiledTerm compile(std::string const& term, ErrorStack* error)
             {
-                auto const first = std::begin(term);
-                auto const last = std::end(term);
+                auto const first = term.data();
+                auto const last = term.data() + term.size();
                 return compile(first, last, error);
             }
 
@@ -56,8 +71,8 @@ namespace libformula
             static CompiledTerm compile(std::string const& term)
             {
                 auto error = ErrorStack();
-                auto const first = std::begin(term);
-                auto const last = std::end(term);
+                auto const first = term.data();
+                auto const last = term.data() + term.size();
                 return compile(first, last, &error);
             }
     };
@@ -0,0 +1,128 @@
+#ifndef __LIBFORMULA_UTIL_ARENA_HPP
+#define __LIBFORMULA_UTIL_ARENA_HPP
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+
+namespace libformula { namespace util
+{
+    /**
+     * A memory arena which provides the storage for the temporary objects created
+     * while a term is being compiled, such as the symbols of the scanner.
+     * Allocating from the arena only advances a cursor. The first few kilobytes are
+     * located within the arena itself, so a term of typical length is compiled
+     * without any heap allocation when the arena lives on the stack. Larger requests
+     * are served from additional blocks. Memory is never returned to the arena, it
+     * is released as a whole when the arena is destroyed.
+     * @note Since no destructors are run, the arena may only hold objects that are
+     *      trivially destructible.
+     */
+    class Arena
+    {
+        public:
+            enum
+            {
+                /** The number of bytes stored within the arena. */
+                InlineSize = 2048,
+
+                /** The minimum number of bytes of an additional block. */
+                BlockSize = 8192
+            };
+
+            /** Constructor */
+            Arena();
+
+            /** Destructor, releases all additional blocks. */
+            ~Arena();
+
+            /**
+             * Allocates uninitialized storage for @p count objects of the specified type.
+             * The storage remains valid until the arena is destroyed.
+             * @param count The number of objects.
+             * @return Pointer to the storage of the first object.
+             * @throw std::bad_alloc if an additional block cannot be allocated.
+             */
+            template<typename ValueType>
+            ValueType* allocate(std::size_t count);
+
+        private:
+            /**
+             * The header of an additional block, followed by its storage.
+             */
+            struct Block
+            {
+                Block* next;
+            };
+
+            typedef std::aligned_storage<InlineSize>::type InlineStorage;
+
+            /**
+             * Allocates @p size bytes aligned at @p alignment.
+             */
+            void* allocate(std::size_t size, std::size_t alignment);
+
+            /** Prohibit copying */
+            Arena(Arena const&);
+
+            /** Prohibit assignment */
+            Arena& operator=(Arena const&);
+
+        private:
+            InlineStorage m_inline;
+            char* m_cursor;
+            char* m_end;
+            Block* m_blocks;
+    };
+
+    /**************************************************************************
+     * Inline implementation                                                  *
+     **************************************************************************/
+
+    inline Arena::Arena()
+        : m_cursor(reinterpret_cast<char*>(&m_inline))
+        , m_end(reinterpret_cast<char*>(&m_inline) + InlineSize)
+        , m_blocks(nullptr)
+    {}
+
+    inline Arena::~Arena()
+    {
+        while (m_blocks != nullptr)
+        {
+            auto const next = m_blocks->next;
+            ::operator delete(m_blocks);
+            m_blocks = next;
+        }
+    }
+
+    template<typename ValueType>
+    inline ValueType* Arena::allocate(std::size_t count)
+    {
+        static_assert(std::is_trivially_destructible<ValueType>::value, "The arena only holds trivially destructible objects");
+
+        return static_cast<ValueType*>(allocate(count * sizeof(ValueType), std::alignment_of<ValueType>::value));
+    }
+
+    inline void* Arena::allocate(std::size_t size, std::size_t alignment)
+    {
+        auto const padding = (alignment - reinterpret_cast<std::size_t>(m_cursor) % alignment) % alignment;
+        if (static_cast<std::size_t>(m_end - m_cursor) < padding + size)
+        {
+            // The capacity leaves room for the padding the storage following the header may need
+            auto const capacity = size + alignment > BlockSize ? size + alignment : std::size_t(BlockSize);
+            auto const block = static_cast<Block*>(::operator new(sizeof(Block) + capacity));
+            block->next = m_blocks;
+            m_blocks = block;
+            m_cursor = reinterpret_cast<char*>(block + 1);
+            m_end = m_cursor + capacity;
+            return allocate(size, alignment);
+        }
+
+        auto const result = m_cursor + padding;
+        m_cursor = result + size;
+        return result;
+    }
+}
+}
+
+#endif  // __LIBFORMULA_UTIL_ARENA_HPP
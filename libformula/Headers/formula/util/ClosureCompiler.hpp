@@ -0,0 +1,494 @@
+#ifndef __LIBFORMULA_UTIL_CLOSURECOMPILER_HPP
+#define __LIBFORMULA_UTIL_CLOSURECOMPILER_HPP
+
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <type_traits>
+#include <vector>
+#include "ValueStack.hpp"
+#include "../CodeEmitter.hpp"
+#include "../Types.hpp"
+
+namespace libformula { namespace util
+{
+    namespace detail
+    {
+        /**
+         * A compiled subexpression. Depending on its type, either asLong or asReal
+         * computes its value for the $ variable passed.
+         */
+        template<typename ItType>
+        struct Closure
+        {
+            typedef std::function<long_type(ItType)> LongFunction;
+            typedef std::function<real_type(ItType)> RealFunction;
+
+            /**
+             * Initializes a new closure of type long.
+             * @param function The function computing the value.
+             * @param constant true if the function does not depend on $.
+             */
+            Closure(LongFunction const& function, bool constant)
+                : type(ValueStackItemType::Long)
+                , asLong(function)
+                , isConstant(constant)
+            {}
+
+            /**
+             * Initializes a new closure of type real.
+             * @param function The function computing the value.
+             * @param constant true if the function does not depend on $.
+             */
+            Closure(RealFunction const& function, bool constant)
+                : type(ValueStackItemType::Real)
+                , asReal(function)
+                , isConstant(constant)
+            {}
+
+            ValueStackItemType::value_type type;
+            LongFunction asLong;
+            RealFunction asReal;
+            bool isConstant;
+        };
+
+        /**
+         * Composes the closures of a term for a fixed type of the $ variable. The
+         * emitted opcodes are evaluated on a stack of closures at compile time, so
+         * the result is a single closure which computes the term by calling its
+         * operands directly. Operations on constants are computed immediately.
+         */
+        template<typename ItType>
+        class ClosureBuilder
+        {
+            typedef Closure<ItType> ClosureType;
+            typedef typename ClosureType::LongFunction LongFunction;
+            typedef typename ClosureType::RealFunction RealFunction;
+            public:
+                /** Pushes a long constant. */
+                void pushLong(long_type value)
+                {
+                    m_stack.push_back(ClosureType(LongFunction([=](ItType) -> long_type { return value; }), true));
+                }
+
+                /** Pushes a real constant. */
+                void pushReal(real_type value)
+                {
+                    m_stack.push_back(ClosureType(RealFunction([=](ItType) -> real_type { return value; }), true));
+                }
+
+                /** Pushes the $ variable. */
+                void pushIt()
+                {
+                    pushIt(std::is_floating_point<ItType>());
+                }
+
+                /**
+                 * Replaces the two top closures by the result of either @p longOperation
+                 * or, if one of them is of type real, @p realOperation.
+                 */
+                template<typename LongOperation, typename RealOperation>
+                void arithmetic(LongOperation longOperation, RealOperation realOperation)
+                {
+                    auto const& y = m_stack[m_stack.size() - 1];
+                    auto const& x = m_stack[m_stack.size() - 2];
+
+                    if ((x.type | y.type) == ValueStackItemType::Long)
+                        binaryLong(longOperation);
+                    else
+                        binaryReal(realOperation);
+                }
+
+                /** Replaces the two top closures by the long result of @p operation. */
+                template<typename Operation>
+                void binaryLong(Operation operation)
+                {
+                    auto const y = toLong(pop());
+                    auto const x = toLong(pop());
+                    push(LongFunction([=](ItType it) -> long_type { return operation(x.asLong(it), y.asLong(it)); }), x.isConstant && y.isConstant);
+                }
+
+                /** Replaces the two top closures by the real result of @p operation. */
+                template<typename Operation>
+                void binaryReal(Operation operation)
+                {
+                    auto const y = toReal(pop());
+                    auto const x = toReal(pop());
+                    push(RealFunction([=](ItType it) -> real_type { return operation(x.asReal(it), y.asReal(it)); }), x.isConstant && y.isConstant);
+                }
+
+                /** Replaces the top closure by the real result of @p operation. */
+                template<typename Operation>
+                void unaryReal(Operation operation)
+                {
+                    auto const x = toReal(pop());
+                    push(RealFunction([=](ItType it) -> real_type { return operation(x.asReal(it)); }), x.isConstant);
+                }
+
+                /**
+                 * Replaces the top closure by the result of either @p longOperation or,
+                 * if it is of type real, @p realOperation.
+                 */
+                template<typename LongOperation, typename RealOperation>
+                void unary(LongOperation longOperation, RealOperation realOperation)
+                {
+                    auto const x = pop();
+
+                    if (x.type == ValueStackItemType::Long)
+                        push(LongFunction([=](ItType it) -> long_type { return longOperation(x.asLong(it)); }), x.isConstant);
+                    else
+                        push(RealFunction([=](ItType it) -> real_type { return realOperation(x.asReal(it)); }), x.isConstant);
+                }
+
+                /** Replaces the top closure by its sign, which is always of type long. */
+                void sgn()
+                {
+                    auto const x = pop();
+
+                    if (x.type == ValueStackItemType::Long)
+                        push(LongFunction([=](ItType it) -> long_type { auto const value = x.asLong(it); return value < 0 ? -1 : (value > 0 ? 1 : 0); }), x.isConstant);
+                    else
+                        push(LongFunction([=](ItType it) -> long_type { auto const value = x.asReal(it); return value < 0.0 ? -1 : (value > 0.0 ? 1 : 0); }), x.isConstant);
+                }
+
+                /** Converts the top closure to long. */
+                void convertToLong()
+                {
+                    m_stack.push_back(toLong(pop()));
+                }
+
+                /** Converts the top closure to real. */
+                void convertToReal()
+                {
+                    m_stack.push_back(toReal(pop()));
+                }
+
+                /**
+                 * Computes the term.
+                 * @param value The value of the $ variable.
+                 * @return The result of the term.
+                 */
+                template<typename ValueType>
+                ValueType compute(ValueType value) const
+                {
+                    if (m_stack.empty())
+                        return value;
+
+                    auto const& result = m_stack.back();
+                    auto const it = static_cast<ItType>(value);
+
+                    return result.type == ValueStackItemType::Long
+                        ? static_cast<ValueType>(result.asLong(it))
+                        : static_cast<ValueType>(result.asReal(it));
+                }
+
+            private:
+                void pushIt(std::true_type)
+                {
+                    m_stack.push_back(ClosureType(RealFunction([](ItType it) -> real_type { return it; }), false));
+                }
+
+                void pushIt(std::false_type)
+                {
+                    m_stack.push_back(ClosureType(LongFunction([](ItType it) -> long_type { return it; }), false));
+                }
+
+                ClosureType pop()
+                {
+                    auto const result = m_stack.back();
+                    m_stack.pop_back();
+                    return result;
+                }
+
+                /** Pushes a closure, constants are computed immediately. */
+                template<typename Function>
+                void push(Function const& function, bool constant)
+                {
+                    if (constant)
+                    {
+                        auto const value = function(ItType());
+                        m_stack.push_back(ClosureType(Function([=](ItType) { return value; }), true));
+                    }
+                    else
+                    {
+                        m_stack.push_back(ClosureType(function, false));
+                    }
+                }
+
+                static ClosureType toLong(ClosureType const& x)
+                {
+                    if (x.type == ValueStackItemType::Long)
+                        return x;
+
+                    auto const function = x.asReal;
+                    return ClosureType(LongFunction([=](ItType it) -> long_type { return static_cast<long_type>(function(it)); }), x.isConstant);
+                }
+
+                static ClosureType toReal(ClosureType const& x)
+                {
+                    if (x.type == ValueStackItemType::Real)
+                        return x;
+
+                    auto const function = x.asLong;
+                    return ClosureType(RealFunction([=](ItType it) -> real_type { return static_cast<real_type>(function(it)); }), x.isConstant);
+                }
+
+            private:
+                std::vector<ClosureType> m_stack;
+        };
+    }
+
+    /**
+     * Implementation of the CodeEmitter interface, which compiles the term into
+     * nested closures instead of opcodes. Each operation directly calls the closures
+     * of its operands, so computing a term neither dispatches on opcodes nor uses
+     * a value stack. As with the CodeInterpreter, the types of all subexpressions
+     * are resolved at compile time, separately for a long and for a real $ variable.
+     * Computing the term is thread-safe.
+     */
+    class ClosureCompiler : public CodeEmitter
+    {
+        typedef libformula::long_type long_type;
+        typedef libformula::real_type real_type;
+        public:
+            /**
+             * Computes the term with the provided value used for the $ variable.
+             * @param value Value of the variable.
+             * @return Returns the result of the term computation.
+             */
+            template<typename ValueType>
+            ValueType compute(ValueType value) const;
+
+            /**
+             * Computes the term for each value in the range [first, last) and writes
+             * the results to @p dest.
+             * @param first The first value of the $ variable.
+             * @param last The end of the range of values.
+             * @param dest The output iterator to write the results to.
+             * @return Returns the output iterator pointing beyond the last result.
+             */
+            template<typename InputIterator, typename OutputIterator>
+            OutputIterator compute(InputIterator first, InputIterator last, OutputIterator dest) const;
+
+        public:
+            /** @see CodeEmitter */
+            virtual void emitPushLong(long value);
+
+            /** @see CodeEmitter */
+            virtual void emitPushReal(double value);
+
+            /** @see CodeEmitter */
+            virtual void emitPushIt();
+
+            /** @see CodeEmitter */
+            virtual void emitAdd();
+
+            /** @see CodeEmitter */
+            virtual void emitSubtract();
+
+            /** @see CodeEmitter */
+            virtual void emitMultiply();
+
+            /** @see CodeEmitter */
+            virtual void emitDivide();
+
+            /** @see CodeEmitter */
+            virtual void emitLongDivide();
+
+            /** @see CodeEmitter */
+            virtual void emitModulo();
+
+            /** @see CodeEmitter */
+            virtual void emitCall(FunctionType const& function, int argcount);
+
+            /** @see CodeEmitter */
+            virtual void emitNegate();
+
+        private:
+            /**
+             * Appends a function call to the closures of the provided builder.
+             */
+            template<typename ItType>
+            static void call(detail::ClosureBuilder<ItType>& builder, FunctionType const& function, int argcount);
+
+        private:
+            detail::ClosureBuilder<long_type> m_longBuilder;
+            detail::ClosureBuilder<real_type> m_realBuilder;
+    };
+
+    /**************************************************************************
+     * Inline implementation                                                  *
+     **************************************************************************/
+
+    template<typename ValueType>
+    inline ValueType ClosureCompiler::compute(ValueType value) const
+    {
+        if (std::is_floating_point<ValueType>::value)
+            return m_realBuilder.compute(value);
+        else
+            return m_longBuilder.compute(value);
+    }
+
+    template<typename InputIterator, typename OutputIterator>
+    inline OutputIterator ClosureCompiler::compute(InputIterator first, InputIterator last, OutputIterator dest) const
+    {
+        for ( ; first != last; ++first, ++dest)
+            *dest = compute(*first);
+
+        return dest;
+    }
+
+    inline void ClosureCompiler::emitPushLong(long value)
+    {
+        m_longBuilder.pushLong(value);
+        m_realBuilder.pushLong(value);
+    }
+
+    inline void ClosureCompiler::emitPushReal(double value)
+    {
+        m_longBuilder.pushReal(value);
+        m_realBuilder.pushReal(value);
+    }
+
+    inline void ClosureCompiler::emitPushIt()
+    {
+        m_longBuilder.pushIt();
+        m_realBuilder.pushIt();
+    }
+
+    inline void ClosureCompiler::emitAdd()
+    {
+        auto const longOperation = [](long_type x, long_type y) -> long_type { return x + y; };
+        auto const realOperation = [](real_type x, real_type y) -> real_type { return x + y; };
+        m_longBuilder.arithmetic(longOperation, realOperation);
+        m_realBuilder.arithmetic(longOperation, realOperation);
+    }
+
+    inline void ClosureCompiler::emitSubtract()
+    {
+        auto const longOperation = [](long_type x, long_type y) -> long_type { return x - y; };
+        auto const realOperation = [](real_type x, real_type y) -> real_type { return x - y; };
+        m_longBuilder.arithmetic(longOperation, realOperation);
+        m_realBuilder.arithmetic(longOperation, realOperation);
+    }
+
+    inline void ClosureCompiler::emitMultiply()
+    {
+        auto const longOperation = [](long_type x, long_type y) -> long_type { return x * y; };
+        auto const realOperation = [](real_type x, real_type y) -> real_type { return x * y; };
+        m_longBuilder.arithmetic(longOperation, realOperation);
+        m_realBuilder.arithmetic(longOperation, realOperation);
+    }
+
+    inline void ClosureCompiler::emitDivide()
+    {
+        auto const operation = [](real_type x, real_type y) -> real_type { return x / y; };
+        m_longBuilder.binaryReal(operation);
+        m_realBuilder.binaryReal(operation);
+    }
+
+    inline void ClosureCompiler::emitLongDivide()
+    {
+        auto const operation = [](long_type x, long_type y) -> long_type { return x / y; };
+        m_longBuilder.binaryLong(operation);
+        m_realBuilder.binaryLong(operation);
+    }
+
+    inline void ClosureCompiler::emitModulo()
+    {
+        auto const operation = [](long_type x, long_type y) -> long_type { return x % y; };
+        m_longBuilder.binaryLong(operation);
+        m_realBuilder.binaryLong(operation);
+    }
+
+    inline void ClosureCompiler::emitCall(FunctionType const& function, int argcount)
+    {
+        call(m_longBuilder, function, argcount);
+        call(m_realBuilder, function, argcount);
+    }
+
+    inline void ClosureCompiler::emitNegate()
+    {
+        auto const longOperation = [](long_type x) -> long_type { return -x; };
+        auto const realOperation = [](real_type x) -> real_type { return -x; };
+        m_longBuilder.unary(longOperation, realOperation);
+        m_realBuilder.unary(longOperation, realOperation);
+    }
+
+    template<typename ItType>
+    inline void ClosureCompiler::call(detail::ClosureBuilder<ItType>& builder, FunctionType const& function, int argcount)
+    {
+        switch(function.value())
+        {
+            case FunctionType::Exp:
+                builder.unaryReal([](real_type x) -> real_type { return std::exp(x); });
+                break;
+            case FunctionType::Pow:
+                builder.binaryReal([](real_type x, real_type y) -> real_type { return std::pow(x, y); });
+                break;
+            case FunctionType::Cos:
+                builder.unaryReal([](real_type x) -> real_type { return std::cos(x); });
+                break;
+            case FunctionType::Sin:
+                builder.unaryReal([](real_type x) -> real_type { return std::sin(x); });
+                break;
+            case FunctionType::Tan:
+                builder.unaryReal([](real_type x) -> real_type { return std::tan(x); });
+                break;
+            case FunctionType::Acos:
+                builder.unaryReal([](real_type x) -> real_type { return std::acos(x); });
+                break;
+            case FunctionType::Asin:
+                builder.unaryReal([](real_type x) -> real_type { return std::asin(x); });
+                break;
+            case FunctionType::Atan:
+                if (argcount == 1)
+                    builder.unaryReal([](real_type x) -> real_type { return std::atan(x); });
+                else if (argcount == 2)
+                    builder.binaryReal([](real_type x, real_type y) -> real_type { return std::atan2(y, x); });
+                break;
+            case FunctionType::Cosh:
+                builder.unaryReal([](real_type x) -> real_type { return std::cosh(x); });
+                break;
+            case FunctionType::Sinh:
+                builder.unaryReal([](real_type x) -> real_type { return std::sinh(x); });
+                break;
+            case FunctionType::Tanh:
+                builder.unaryReal([](real_type x) -> real_type { return std::tanh(x); });
+                break;
+            case FunctionType::Int:
+                builder.convertToLong();
+                break;
+            case FunctionType::Float:
+                builder.convertToReal();
+                break;
+            case FunctionType::Log:
+                if (argcount == 1)
+                    builder.unaryReal([](real_type x) -> real_type { return std::log(x); });
+                else if (argcount == 2)
+                    builder.binaryReal([](real_type x, real_type y) -> real_type { return std::log(x) / std::log(y); });
+                break;
+            case FunctionType::Ln:
+                builder.unaryReal([](real_type x) -> real_type { return std::log(x); });
+                break;
+            case FunctionType::Round:
+                builder.unaryReal([](real_type x) -> real_type { return std::floor(x); });
+                break;
+            case FunctionType::Ceil:
+                builder.unaryReal([](real_type x) -> real_type { return std::ceil(x); });
+                break;
+            case FunctionType::Sqrt:
+                builder.unaryReal([](real_type x) -> real_type { return std::sqrt(x); });
+                break;
+            case FunctionType::Abs:
+                builder.unary([](long_type x) -> long_type { return std::abs(x); }, [](real_type x) -> real_type { return std::abs(x); });
+                break;
+            case FunctionType::Sgn:
+                builder.sgn();
+                break;
+        }
+    }
+}
+}
+
+#endif  //__LIBFORMULA_UTIL_CLOSURECOMPILER_HPP
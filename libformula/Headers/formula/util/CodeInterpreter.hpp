@@ -2,7 +2,12 @@
 #define __LIBFORMULA_UTIL_CODEINTERPRETER_HPP
 
 #include <cmath>
+#include <iterator>
+#include <type_traits>
 #include <vector>
+#include "FastMath.hpp"
+#include "TypedCode.hpp"
+#include "ValueBlockStack.hpp"
 #include "ValueStack.hpp"
 #include "../CodeEmitter.hpp"
 #include "../Types.hpp"
@@ -12,16 +17,45 @@ namespace libformula { namespace util
     /**
      * Implementation of the CodeEmitter interface, that generates the code
      * in an intermediate language which is able to execute the term operation.
+     * The code is optimized while it is emitted: operations on constants are
+     * computed immediately, operations with a neutral constant operand are removed,
+     * and common patterns are replaced by super-instructions, e.g. $ * a + b by a
+     * single MulAdd instruction.
+     * Additionally, the code is specialized for a long and for a real $ variable,
+     * which allows computing single values without type information on the stack.
+     * Once the term has been compiled, the interpreter is immutable and may be shared
+     * by multiple threads. Computing a range of values requires scratch memory, which
+     * is either allocated per call or provided by a Context owned by the calling thread.
      */
     class CodeInterpreter : public CodeEmitter
     {
         typedef libformula::long_type long_type;
         typedef libformula::real_type real_type;
         public:
+            /**
+             * Scratch memory used to compute a range of values. A context must only
+             * be used by one thread at a time, but may be used with any number of
+             * interpreters. It retains its memory between calls.
+             */
+            class Context
+            {
+                friend class CodeInterpreter;
+                public:
+                    /** Constructor */
+                    Context()
+                    {}
+
+                private:
+                    ValueBlockStack m_stack;
+            };
+
             /**
              * Initializes a new code interpreter instance.
+             * @param fastMath true to compute exp, pow, log and ln with the
+             *      approximations of FastMath. Constant subexpressions are always
+             *      computed with the standard library.
              */
-            CodeInterpreter();
+            explicit CodeInterpreter(bool fastMath = false);
 
             /**
              * Computes the term with the provided value used for the $ variable.
@@ -31,6 +65,38 @@ namespace libformula { namespace util
             template<typename ValueType>
             ValueType compute(ValueType value) const;
 
+            /**
+             * Computes the term for each value in the range [first, last) and writes
+             * the results to @p dest. The values are processed in blocks, each opcode
+             * is executed once per block. The block stack is allocated for each call,
+             * use the overload taking a Context to avoid that.
+             * @param first The first value of the $ variable.
+             * @param last The end of the range of values.
+             * @param dest The output iterator to write the results to.
+             * @return Returns the output iterator pointing beyond the last result.
+             */
+            template<typename InputIterator, typename OutputIterator>
+            OutputIterator compute(InputIterator first, InputIterator last, OutputIterator dest) const;
+
+            /**
+             * Computes the term for each value in the range [first, last) and writes
+             * the results to @p dest, using the scratch memory of the provided context.
+             * @param first The first value of the $ variable.
+             * @param last The end of the range of values.
+             * @param dest The output iterator to write the results to.
+             * @param context The context of the calling thread.
+             * @return Returns the output iterator pointing beyond the last result.
+             */
+            template<typename InputIterator, typename OutputIterator>
+            OutputIterator compute(InputIterator first, InputIterator last, OutputIterator dest, Context& context) const;
+
+            /**
+             * Returns the maximum number of items on the value stack while computing
+             * the term, as recorded when the code was emitted.
+             * @return The maximum stack depth of the term.
+             */
+            int maxDepth() const;
+
         public:
             /** @see CodeEmitter */
             virtual void emitPushLong(long value);
@@ -86,7 +152,11 @@ namespace libformula { namespace util
                     Idiv,
                     Mod,
                     Call,
-                    Negate
+                    Negate,
+                    MulConst,
+                    AddConst,
+                    MulAdd,
+                    Square
                 };
 
                 /**
@@ -123,6 +193,20 @@ namespace libformula { namespace util
                     m_long = type.value() | (argcount << 24);
                 }
 
+                /**
+                 * Initializes a new OpCode with one or two constant operands.
+                 * @param code OpCode.
+                 * @param first First constant operand.
+                 * @param second Second constant operand.
+                 */
+                OpCode(_Domain code, ValueStackItem const& first, ValueStackItem const& second = ValueStackItem())
+                    : m_code(code)
+                {
+                    m_long = 0;
+                    m_operands[0] = first;
+                    m_operands[1] = second;
+                }
+
                 /**
                  * Initializes a new OpCode which doesn't require any additional data.
                  * @param code OpCode.
@@ -150,86 +234,438 @@ namespace libformula { namespace util
                     return ((m_long >> 24) & 0xFF);
                 }
 
+                /**
+                 * Returns true if this opcode pushes a constant value.
+                 * @return true if this opcode pushes a constant value.
+                 */
+                bool isConstant() const
+                {
+                    return m_code == PushLong || m_code == PushReal;
+                }
+
+                /**
+                 * Returns the constant value pushed by this opcode. Must only be
+                 * called if isConstant returns true.
+                 * @return The constant value.
+                 */
+                ValueStackItem toConstant() const
+                {
+                    return m_code == PushLong
+                        ? ValueStackItem(m_long)
+                        : ValueStackItem(m_real);
+                }
+
                 union
                 {
                     real_type m_real;
                     long_type m_long; 
                 };
+                ValueStackItem m_operands[2];
                 _Domain m_code;
             };
 
             typedef std::vector<OpCode> OpCodeCollection;
 
+            /**
+             * Updates the number of items on the stack after emitting an opcode.
+             * @param delta The number of items the opcode adds to the stack.
+             */
+            void updateDepth(int delta);
+
+            /**
+             * Optimizes the code after an operation has been appended.
+             */
+            void optimize();
+
+            /**
+             * Replaces the last operation by its result, if all of its operands are
+             * constants.
+             * @return true if the operation has been replaced.
+             */
+            bool foldConstants();
+
+            /**
+             * Replaces an addition, subtraction or multiplication with a constant
+             * operand by an AddConst or MulConst instruction, or removes it, if the
+             * constant is neutral.
+             * @return true if the operation has been replaced.
+             */
+            bool reduceConstantOperand();
+
+            /**
+             * Regenerates the code specialized for a long and for a real $ variable
+             * from the current code.
+             */
+            void specialize();
+
+            /**
+             * Appends an opcode to the specialized code.
+             * @param code The specialized code to append the opcode to.
+             * @param opcode The opcode to append.
+             */
+            static void specialize(TypedCode& code, OpCode const& opcode);
+
+            /**
+             * Executes the code in the range [first, last) for a single value.
+             * @param stack The stack to execute the code on.
+             * @param it The value of the $ variable.
+             * @param first The first opcode to execute.
+             * @param last The end of the range of opcodes.
+             */
+            static void execute(ValueStack& stack, ValueStack::value_type const& it, OpCodeCollection::const_iterator first, OpCodeCollection::const_iterator last);
+
+            /**
+             * Executes the code for a block of values.
+             * @param stack The stack to execute the code on.
+             * @param values The values of the $ variable.
+             */
+            template<typename ValueType>
+            void execute(ValueBlockStack& stack, ValueType const* values) const;
+
+            /**
+             * Replaces the top item of the stack by the result of @p operation.
+             */
+            template<typename InType, typename OutType, typename Operation>
+            static void unary(ValueBlockStack& stack, Operation operation);
+
+            /**
+             * Replaces the two top items of the stack by the result of @p operation.
+             */
+            template<typename ValueType, typename Operation>
+            static void binary(ValueBlockStack& stack, Operation operation);
+
+            /**
+             * Replaces the two top items of the stack by the result of either @p longOperation
+             * or, if one of the items is of type real, @p realOperation.
+             */
+            template<typename LongOperation, typename RealOperation>
+            static void arithmetic(ValueBlockStack& stack, LongOperation longOperation, RealOperation realOperation);
+
+            /**
+             * Replaces the top item of the stack by the result of either @p longOperation
+             * with the constant @p y or, if the item or @p y is of type real, @p realOperation.
+             */
+            template<typename LongOperation, typename RealOperation>
+            static void arithmetic(ValueBlockStack& stack, ValueStackItem const& y, LongOperation longOperation, RealOperation realOperation);
+
         private:
             OpCodeCollection m_code;
+            TypedCode m_longCode;
+            TypedCode m_realCode;
+            int m_depth;
+            int m_maxDepth;
+            bool m_fastMath;
     };
 
-    inline CodeInterpreter::CodeInterpreter()
+    inline CodeInterpreter::CodeInterpreter(bool fastMath)
+        : m_longCode(ValueStackItemType::Long, fastMath)
+        , m_realCode(ValueStackItemType::Real, fastMath)
+        , m_depth(0)
+        , m_maxDepth(0)
+        , m_fastMath(fastMath)
     {}
 
+    inline int CodeInterpreter::maxDepth() const
+    {
+        return m_maxDepth;
+    }
+
+    inline void CodeInterpreter::updateDepth(int delta)
+    {
+        m_depth += delta;
+
+        if (m_depth > m_maxDepth)
+            m_maxDepth = m_depth;
+    }
+
+    inline void CodeInterpreter::optimize()
+    {
+        if (foldConstants() || reduceConstantOperand())
+            return;
+
+        auto const size = m_code.size();
+        auto& code = m_code.back();
+
+        if (size >= 3
+        && (code.m_code == OpCode::Add || code.m_code == OpCode::Mul)
+        && m_code[size - 2].m_code == OpCode::PushIt
+        && m_code[size - 3].isConstant())
+        {
+            // c + $ -> $ + c, c * $ -> $ * c
+            std::swap(m_code[size - 3], m_code[size - 2]);
+            reduceConstantOperand();
+        }
+        else if (size >= 2
+        && code.m_code == OpCode::Call
+        && code.toFunction().value() == FunctionType::Pow
+        && code.argcount() == 2
+        && m_code[size - 2].isConstant()
+        && m_code[size - 2].toConstant().toValueType<real_type>() == 2.0)
+        {
+            // pow(x, 2) -> x * x
+            m_code.erase(m_code.end() - 2, m_code.end());
+            m_code.push_back(OpCode(OpCode::Square));
+        }
+    }
+
+    inline bool CodeInterpreter::foldConstants()
+    {
+        auto const& code = m_code.back();
+        auto arity = 0;
+
+        switch(code.m_code)
+        {
+            case OpCode::Add:
+            case OpCode::Sub:
+            case OpCode::Mul:
+            case OpCode::Div:
+                arity = 2;
+                break;
+            case OpCode::Idiv:
+            case OpCode::Mod:
+            {
+                // keep divisions by zero for runtime
+                auto const size = m_code.size();
+                if (size >= 2 && m_code[size - 2].isConstant() && m_code[size - 2].toConstant().toValueType<long_type>() == 0)
+                    return false;
+
+                arity = 2;
+                break;
+            }
+            case OpCode::Negate:
+                arity = 1;
+                break;
+            case OpCode::Call:
+                arity = code.toFunction().value() != FunctionType::Invalid
+                    ? code.argcount()
+                    : 0;
+                break;
+            default:
+                break;
+        }
+
+        if (arity == 0 || m_code.size() < static_cast<OpCodeCollection::size_type>(arity + 1))
+            return false;
+
+        auto const first = m_code.end() - 1 - arity;
+        for (auto it = first; it != m_code.end() - 1; ++it)
+        {
+            if (it->isConstant() == false)
+                return false;
+        }
+
+        ValueStack stack;
+        execute(stack, ValueStackItem(), first, m_code.end());
+
+        auto const result = stack.pop();
+        m_code.erase(first, m_code.end());
+
+        if (result.type().value() == ValueStackItemType::Long)
+            m_code.push_back(OpCode(OpCode::PushLong, result.toValueType<long_type>()));
+        else
+            m_code.push_back(OpCode(OpCode::PushReal, result.toValueType<real_type>()));
+
+        return true;
+    }
+
+    inline bool CodeInterpreter::reduceConstantOperand()
+    {
+        auto const size = m_code.size();
+        auto const type = m_code.back().m_code;
+
+        if (size < 2
+        || (type != OpCode::Add && type != OpCode::Sub && type != OpCode::Mul)
+        || m_code[size - 2].isConstant() == false)
+            return false;
+
+        auto operand = m_code[size - 2].toConstant();
+        if (type == OpCode::Sub)
+            operand = -operand;
+
+        m_code.erase(m_code.end() - 2, m_code.end());
+
+        // x + 0, x - 0 and x * 1 keep the type of x, as long as the constant is a long
+        auto const neutral = type == OpCode::Mul ? long_type(1) : long_type(0);
+        if (operand.type().value() == ValueStackItemType::Long && operand.toValueType<long_type>() == neutral)
+            return true;
+
+        if (type == OpCode::Mul)
+        {
+            m_code.push_back(OpCode(OpCode::MulConst, operand));
+        }
+        else if (m_code.empty() == false && m_code.back().m_code == OpCode::MulConst)
+        {
+            auto const factor = m_code.back().m_operands[0];
+            m_code.back() = OpCode(OpCode::MulAdd, factor, operand);
+        }
+        else
+        {
+            m_code.push_back(OpCode(OpCode::AddConst, operand));
+        }
+
+        return true;
+    }
+
+    inline void CodeInterpreter::specialize()
+    {
+        m_longCode.clear();
+        m_realCode.clear();
+
+        for (auto const& opcode : m_code)
+        {
+            specialize(m_longCode, opcode);
+            specialize(m_realCode, opcode);
+        }
+    }
+
+    inline void CodeInterpreter::specialize(TypedCode& code, OpCode const& opcode)
+    {
+        switch(opcode.m_code)
+        {
+            case OpCode::PushLong:
+                code.pushLong(opcode.m_long);
+                break;
+            case OpCode::PushReal:
+                code.pushReal(opcode.m_real);
+                break;
+            case OpCode::PushIt:
+                code.pushIt();
+                break;
+            case OpCode::Add:
+                code.add();
+                break;
+            case OpCode::Sub:
+                code.sub();
+                break;
+            case OpCode::Mul:
+                code.mul();
+                break;
+            case OpCode::Div:
+                code.div();
+                break;
+            case OpCode::Idiv:
+                code.idiv();
+                break;
+            case OpCode::Mod:
+                code.mod();
+                break;
+            case OpCode::Negate:
+                code.negate();
+                break;
+            case OpCode::MulConst:
+                code.mulConst(opcode.m_operands[0]);
+                break;
+            case OpCode::AddConst:
+                code.addConst(opcode.m_operands[0]);
+                break;
+            case OpCode::MulAdd:
+                code.mulAdd(opcode.m_operands[0], opcode.m_operands[1]);
+                break;
+            case OpCode::Square:
+                code.square();
+                break;
+            case OpCode::Call:
+                code.call(opcode.toFunction(), opcode.argcount());
+                break;
+        }
+    }
+
     inline void CodeInterpreter::emitPushLong(long value)
     {
         m_code.push_back(OpCode(OpCode::PushLong, value));
+        updateDepth(1);
+        specialize();
     }
 
     inline void CodeInterpreter::emitPushReal(double value)
     {
         m_code.push_back(OpCode(OpCode::PushReal, value));
+        updateDepth(1);
+        specialize();
     }
 
     inline void CodeInterpreter::emitPushIt()
     {
         m_code.push_back(OpCode(OpCode::PushIt));
+        updateDepth(1);
+        specialize();
     }
 
     inline void CodeInterpreter::emitAdd()
     {
         m_code.push_back(OpCode(OpCode::Add));
+        updateDepth(-1);
+        optimize();
+        specialize();
     }
 
     inline void CodeInterpreter::emitSubtract()
     {
         m_code.push_back(OpCode(OpCode::Sub));
+        updateDepth(-1);
+        optimize();
+        specialize();
     }
 
     inline void CodeInterpreter::emitMultiply()
     {
         m_code.push_back(OpCode(OpCode::Mul));
+        updateDepth(-1);
+        optimize();
+        specialize();
     }
 
     inline void CodeInterpreter::emitDivide()
     {
         m_code.push_back(OpCode(OpCode::Div));
+        updateDepth(-1);
+        optimize();
+        specialize();
     }
 
     inline void CodeInterpreter::emitLongDivide()
     {
         m_code.push_back(OpCode(OpCode::Idiv));
+        updateDepth(-1);
+        optimize();
+        specialize();
     }
 
     inline void CodeInterpreter::emitModulo()
     {
         m_code.push_back(OpCode(OpCode::Mod));
+        updateDepth(-1);
+        optimize();
+        specialize();
     }
 
     inline void CodeInterpreter::emitCall(FunctionType const& function, int argcount)
     {
         m_code.push_back(OpCode(OpCode::Call, function, argcount));
+        updateDepth(1 - argcount);
+        optimize();
+        specialize();
     }
 
     inline void CodeInterpreter::emitNegate()
     {
         m_code.push_back(OpCode(OpCode::Negate));
+        optimize();
+        specialize();
     }
 
     template<typename ValueType>
     inline ValueType CodeInterpreter::compute(ValueType value) const
     {
-        ValueStack::value_type it = value;
-        ValueStack stack;
+        auto const& code = std::is_floating_point<ValueType>::value
+            ? m_realCode
+            : m_longCode;
 
-        auto first = std::begin(m_code);
-        auto const last = std::end(m_code);
+        return code.compute(value);
+    }
+
+    inline void CodeInterpreter::execute(ValueStack& stack, ValueStack::value_type const& it, OpCodeCollection::const_iterator first, OpCodeCollection::const_iterator last)
+    {
         for (; first != last; ++first)
         {
             auto& code = *first;
@@ -283,6 +719,34 @@ namespace libformula { namespace util
                     stack.push(r);
                     break;
                 }
+                case OpCode::MulConst:
+                {
+                    auto const x = stack.pop();
+                    auto const r = x * code.m_operands[0];
+                    stack.push(r);
+                    break;
+                }
+                case OpCode::AddConst:
+                {
+                    auto const x = stack.pop();
+                    auto const r = x + code.m_operands[0];
+                    stack.push(r);
+                    break;
+                }
+                case OpCode::MulAdd:
+                {
+                    auto const x = stack.pop();
+                    auto const r = x * code.m_operands[0] + code.m_operands[1];
+                    stack.push(r);
+                    break;
+                }
+                case OpCode::Square:
+                {
+                    auto const x = stack.pop<real_type>();
+                    auto const r = x * x;
+                    stack.push(r);
+                    break;
+                }
                 case OpCode::PushIt:
                     stack.push(it);
                     break;
@@ -473,17 +937,277 @@ namespace libformula { namespace util
                 }
             }
         }
+    }
+
+    template<typename InputIterator, typename OutputIterator>
+    inline OutputIterator CodeInterpreter::compute(InputIterator first, InputIterator last, OutputIterator dest) const
+    {
+        auto context = Context();
+        return compute(first, last, dest, context);
+    }
+
+    template<typename InputIterator, typename OutputIterator>
+    inline OutputIterator CodeInterpreter::compute(InputIterator first, InputIterator last, OutputIterator dest, Context& context) const
+    {
+        typedef typename std::iterator_traits<InputIterator>::value_type ValueType;
+        typedef typename std::conditional<std::is_floating_point<ValueType>::value, real_type, long_type>::type ItemType;
+
+        ValueType values[ValueBlockStack::BlockSize];
+        auto& stack = context.m_stack;
+
+        while (first != last)
+        {
+            auto count = ValueBlockStack::size_type(0);
+            for ( ; first != last && count < ValueBlockStack::BlockSize; ++first, ++count)
+                values[count] = *first;
+
+            stack.reset(count, static_cast<ValueBlockStack::size_type>(m_maxDepth));
+            execute(stack, values);
+
+            if (stack.empty())
+            {
+                dest = std::copy(values, values + count, dest);
+            }
+            else
+            {
+                auto const result = stack.pop<ItemType>();
+                for (auto i = ValueBlockStack::size_type(0); i < count; ++i, ++dest)
+                    *dest = static_cast<ValueType>(result[i]);
+            }
+        }
+
+        return dest;
+    }
+
+    template<typename ValueType>
+    inline void CodeInterpreter::execute(ValueBlockStack& stack, ValueType const* values) const
+    {
+        typedef typename std::conditional<std::is_floating_point<ValueType>::value, real_type, long_type>::type ItemType;
+
+        auto const count = stack.count();
+        auto first = std::begin(m_code);
+        auto const last = std::end(m_code);
+        for (; first != last; ++first)
+        {
+            auto& code = *first;
+            switch(code.m_code)
+            {
+                case OpCode::Add:
+                    arithmetic(stack, [](long_type x, long_type y) -> long_type { return x + y; }, [](real_type x, real_type y) -> real_type { return x + y; });
+                    break;
+                case OpCode::Sub:
+                    arithmetic(stack, [](long_type x, long_type y) -> long_type { return x - y; }, [](real_type x, real_type y) -> real_type { return x - y; });
+                    break;
+                case OpCode::Mul:
+                    arithmetic(stack, [](long_type x, long_type y) -> long_type { return x * y; }, [](real_type x, real_type y) -> real_type { return x * y; });
+                    break;
+                case OpCode::Div:
+                    binary<real_type>(stack, [](real_type x, real_type y) -> real_type { return x / y; });
+                    break;
+                case OpCode::Idiv:
+                    binary<long_type>(stack, [](long_type x, long_type y) -> long_type { return x / y; });
+                    break;
+                case OpCode::Mod:
+                    binary<long_type>(stack, [](long_type x, long_type y) -> long_type { return x % y; });
+                    break;
+                case OpCode::MulConst:
+                    arithmetic(stack, code.m_operands[0], [](long_type x, long_type y) -> long_type { return x * y; }, [](real_type x, real_type y) -> real_type { return x * y; });
+                    break;
+                case OpCode::AddConst:
+                    arithmetic(stack, code.m_operands[0], [](long_type x, long_type y) -> long_type { return x + y; }, [](real_type x, real_type y) -> real_type { return x + y; });
+                    break;
+                case OpCode::MulAdd:
+                    arithmetic(stack, code.m_operands[0], [](long_type x, long_type y) -> long_type { return x * y; }, [](real_type x, real_type y) -> real_type { return x * y; });
+                    arithmetic(stack, code.m_operands[1], [](long_type x, long_type y) -> long_type { return x + y; }, [](real_type x, real_type y) -> real_type { return x + y; });
+                    break;
+                case OpCode::Square:
+                    unary<real_type, real_type>(stack, [](real_type x) -> real_type { return x * x; });
+                    break;
+                case OpCode::PushIt:
+                {
+                    auto const r = stack.push<ItemType>();
+                    for (auto i = ValueBlockStack::size_type(0); i < count; ++i)
+                        r[i] = static_cast<ItemType>(values[i]);
+                    break;
+                }
+                case OpCode::PushLong:
+                {
+                    auto const r = stack.pushLong();
+                    std::fill(r, r + count, code.m_long);
+                    break;
+                }
+                case OpCode::PushReal:
+                {
+                    auto const r = stack.pushReal();
+                    std::fill(r, r + count, code.m_real);
+                    break;
+                }
+                case OpCode::Negate:
+                    if (stack.type() == ValueStackItemType::Real)
+                        unary<real_type, real_type>(stack, [](real_type x) -> real_type { return -x; });
+                    else
+                        unary<long_type, long_type>(stack, [](long_type x) -> long_type { return -x; });
+                    break;
+                case OpCode::Call:
+                {
+                    auto const type = code.toFunction();
+                    auto const args = code.argcount();
+                    switch(type.value())
+                    {
+                        case FunctionType::Exp:
+                            if (m_fastMath)
+                                unary<real_type, real_type>(stack, [](real_type x) -> real_type { return FastMath::exp(x); });
+                            else
+                                unary<real_type, real_type>(stack, [](real_type x) -> real_type { return std::exp(x); });
+                            break;
+                        case FunctionType::Pow:
+                            if (m_fastMath)
+                                binary<real_type>(stack, [](real_type x, real_type y) -> real_type { return FastMath::pow(x, y); });
+                            else
+                                binary<real_type>(stack, [](real_type x, real_type y) -> real_type { return std::pow(x, y); });
+                            break;
+                        case FunctionType::Cos:
+                            unary<real_type, real_type>(stack, [](real_type x) -> real_type { return std::cos(x); });
+                            break;
+                        case FunctionType::Sin:
+                            unary<real_type, real_type>(stack, [](real_type x) -> real_type { return std::sin(x); });
+                            break;
+                        case FunctionType::Tan:
+                            unary<real_type, real_type>(stack, [](real_type x) -> real_type { return std::tan(x); });
+                            break;
+                        case FunctionType::Acos:
+                            unary<real_type, real_type>(stack, [](real_type x) -> real_type { return std::acos(x); });
+                            break;
+                        case FunctionType::Asin:
+                            unary<real_type, real_type>(stack, [](real_type x) -> real_type { return std::asin(x); });
+                            break;
+                        case FunctionType::Atan:
+                            if (args == 1)
+                                unary<real_type, real_type>(stack, [](real_type x) -> real_type { return std::atan(x); });
+                            else if (args == 2)
+                                binary<real_type>(stack, [](real_type x, real_type y) -> real_type { return std::atan2(y, x); });
+                            break;
+                        case FunctionType::Cosh:
+                            unary<real_type, real_type>(stack, [](real_type x) -> real_type { return std::cosh(x); });
+                            break;
+                        case FunctionType::Sinh:
+                            unary<real_type, real_type>(stack, [](real_type x) -> real_type { return std::sinh(x); });
+                            break;
+                        case FunctionType::Tanh:
+                            unary<real_type, real_type>(stack, [](real_type x) -> real_type { return std::tanh(x); });
+                            break;
+                        case FunctionType::Int:
+                            unary<long_type, long_type>(stack, [](long_type x) -> long_type { return x; });
+                            break;
+                        case FunctionType::Float:
+                            unary<real_type, real_type>(stack, [](real_type x) -> real_type { return x; });
+                            break;
+                        case FunctionType::Log:
+                            if (args == 1 && m_fastMath)
+                                unary<real_type, real_type>(stack, [](real_type x) -> real_type { return FastMath::log(x); });
+                            else if (args == 1)
+                                unary<real_type, real_type>(stack, [](real_type x) -> real_type { return std::log(x); });
+                            else if (args == 2 && m_fastMath)
+                                binary<real_type>(stack, [](real_type x, real_type y) -> real_type { return FastMath::log(x) / FastMath::log(y); });
+                            else if (args == 2)
+                                binary<real_type>(stack, [](real_type x, real_type y) -> real_type { return std::log(x) / std::log(y); });
+                            break;
+                        case FunctionType::Ln:
+                            if (m_fastMath)
+                                unary<real_type, real_type>(stack, [](real_type x) -> real_type { return FastMath::log(x); });
+                            else
+                                unary<real_type, real_type>(stack, [](real_type x) -> real_type { return std::log(x); });
+                            break;
+                        case FunctionType::Round:
+                            unary<real_type, real_type>(stack, [](real_type x) -> real_type { return std::floor(x); });
+                            break;
+                        case FunctionType::Ceil:
+                            unary<real_type, real_type>(stack, [](real_type x) -> real_type { return std::ceil(x); });
+                            break;
+                        case FunctionType::Sqrt:
+                            unary<real_type, real_type>(stack, [](real_type x) -> real_type { return std::sqrt(x); });
+                            break;
+                        case FunctionType::Abs:
+                            if (stack.type() == ValueStackItemType::Real)
+                                unary<real_type, real_type>(stack, [](real_type x) -> real_type { return std::abs(x); });
+                            else
+                                unary<long_type, long_type>(stack, [](long_type x) -> long_type { return std::abs(x); });
+                            break;
+                        case FunctionType::Sgn:
+                            if (stack.type() == ValueStackItemType::Real)
+                                unary<real_type, long_type>(stack, [](real_type x) -> long_type { return x < 0.0 ? -1 : (x > 0.0 ? 1 : 0); });
+                            else
+                                unary<long_type, long_type>(stack, [](long_type x) -> long_type { return x < 0 ? -1 : (x > 0 ? 1 : 0); });
+                            break;
+                    }
+                    break;
+                }
+            }
+        }
+    }
+
+    template<typename InType, typename OutType, typename Operation>
+    inline void CodeInterpreter::unary(ValueBlockStack& stack, Operation operation)
+    {
+        auto const count = stack.count();
+        auto const x = stack.pop<InType>();
+        auto const r = stack.push<OutType>();
+
+        for (auto i = ValueBlockStack::size_type(0); i < count; ++i)
+            r[i] = operation(x[i]);
+    }
 
-        if (stack.empty())
+    template<typename ValueType, typename Operation>
+    inline void CodeInterpreter::binary(ValueBlockStack& stack, Operation operation)
+    {
+        auto const count = stack.count();
+        auto const y = stack.pop<ValueType>();
+        auto const x = stack.pop<ValueType>();
+        auto const r = stack.push<ValueType>();
+
+        for (auto i = ValueBlockStack::size_type(0); i < count; ++i)
+            r[i] = operation(x[i], y[i]);
+    }
+
+    template<typename LongOperation, typename RealOperation>
+    inline void CodeInterpreter::arithmetic(ValueBlockStack& stack, LongOperation longOperation, RealOperation realOperation)
+    {
+        if (stack.type(0) == ValueStackItemType::Long && stack.type(1) == ValueStackItemType::Long)
+            binary<long_type>(stack, longOperation);
+        else
+            binary<real_type>(stack, realOperation);
+    }
+
+    template<typename LongOperation, typename RealOperation>
+    inline void CodeInterpreter::arithmetic(ValueBlockStack& stack, ValueStackItem const& y, LongOperation longOperation, RealOperation realOperation)
+    {
+        if (stack.type() == ValueStackItemType::Long && y.type().value() == ValueStackItemType::Long)
         {
-            return it.toValueType<ValueType>();
+            auto const operand = y.toValueType<long_type>();
+            unary<long_type, long_type>(stack, [&](long_type x) -> long_type { return longOperation(x, operand); });
         }
         else
         {
-            auto const result = stack.pop();
-            return result.toValueType<ValueType>();
+            auto const operand = y.toValueType<real_type>();
+            unary<real_type, real_type>(stack, [&](real_type x) -> real_type { return realOperation(x, operand); });
         }
     }
+
+    /**
+     * A CodeInterpreter that computes exp, pow, log and ln with the approximations
+     * of FastMath, which are precise enough to display values. It can be used as
+     * template argument for Term, e.g. as FastCompiledTerm.
+     */
+    class FastMathCodeInterpreter : public CodeInterpreter
+    {
+        public:
+            /**
+             * Initializes a new code interpreter instance.
+             */
+            FastMathCodeInterpreter()
+                : CodeInterpreter(true)
+            {}
+    };
 }
 }
 
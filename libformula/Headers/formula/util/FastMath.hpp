@@ -0,0 +1,102 @@
+#ifndef __LIBFORMULA_UTIL_FASTMATH_HPP
+#define __LIBFORMULA_UTIL_FASTMATH_HPP
+
+#include <cmath>
+#include <cstring>
+#include "../Types.hpp"
+
+namespace libformula { namespace util
+{
+    /**
+     * Polynomial approximations of the transcendental functions used by terms. They
+     * are meant for values that are displayed, e.g. by meters, and trade the last
+     * digits of precision for speed. Arguments outside of the range of normal,
+     * positive doubles are passed to the standard library, so special values
+     * like 0, infinity or NaN give the same results as without approximation.
+     * The error bounds have been determined over the whole range of normal doubles.
+     * sqrt is not approximated, since it is a single instruction on all supported
+     * platforms.
+     */
+    struct FastMath
+    {
+        /**
+         * Returns the natural logarithm of @p x. The absolute error is below 3e-8.
+         * @param x Operand.
+         * @return The natural logarithm of @p x.
+         */
+        static real_type log(real_type x)
+        {
+            static real_type const Ln2 = 0.69314718055994530942;
+            static real_type const Sqrt2 = 1.41421356237309504880;
+
+            unsigned long long bits;
+            std::memcpy(&bits, &x, sizeof(bits));
+
+            auto const biased = static_cast<int>((bits >> 52) & 0x7FF);
+            if (x <= 0.0 || biased == 0 || biased == 0x7FF)
+                return std::log(x);
+
+            // x = m * 2^e, with m in [sqrt(2) / 2, sqrt(2))
+            auto exponent = biased - 1023;
+            bits = (bits & 0x000FFFFFFFFFFFFFULL) | 0x3FF0000000000000ULL;
+
+            real_type m;
+            std::memcpy(&m, &bits, sizeof(m));
+
+            if (m > Sqrt2)
+            {
+                m *= 0.5;
+                ++exponent;
+            }
+
+            // ln(m) = 2 * atanh(t), with t = (m - 1) / (m + 1) in [-0.172, 0.172], up to t^7
+            auto const t = (m - 1.0) / (m + 1.0);
+            auto const t2 = t * t;
+            auto const series = 1.0 + t2 * (1.0 / 3 + t2 * (1.0 / 5 + t2 * (1.0 / 7)));
+            return 2.0 * t * series + exponent * Ln2;
+        }
+
+        /**
+         * Returns e raised to the power of @p x. The relative error is below 2e-7.
+         * @param x Operand.
+         * @return e raised to the power of @p x.
+         */
+        static real_type exp(real_type x)
+        {
+            static real_type const Ln2 = 0.69314718055994530942;
+            static real_type const InvLn2 = 1.44269504088896340736;
+
+            if (!(x > -708.0 && x < 709.0))
+                return std::exp(x);
+
+            // x = k * ln(2) + r, with r in [-ln(2) / 2, ln(2) / 2], e^r up to r^6
+            auto const k = static_cast<int>(x * InvLn2 + (x < 0.0 ? -0.5 : 0.5));
+            auto const r = x - k * Ln2;
+            auto const series = 1.0 + r * (1.0 + r * (1.0 / 2 + r * (1.0 / 6 + r * (1.0 / 24 + r * (1.0 / 120 + r * (1.0 / 720))))));
+
+            auto const bits = static_cast<unsigned long long>(k + 1023) << 52;
+            real_type scale;
+            std::memcpy(&scale, &bits, sizeof(scale));
+
+            return series * scale;
+        }
+
+        /**
+         * Returns @p x raised to the power of @p y, computed as exp(y * log(x)) for positive
+         * @p x. The relative error is below 2e-7 * (1 + |y * ln(x)|).
+         * @param x Base.
+         * @param y Exponent.
+         * @return @p x raised to the power of @p y.
+         */
+        static real_type pow(real_type x, real_type y)
+        {
+            if (x > 0.0)
+                return exp(y * log(x));
+            else
+                return std::pow(x, y);
+        }
+    };
+}
+}
+
+#endif  //__LIBFORMULA_UTIL_FASTMATH_HPP
@@ -0,0 +1,674 @@
+#ifndef __LIBFORMULA_UTIL_TYPEDCODE_HPP
+#define __LIBFORMULA_UTIL_TYPEDCODE_HPP
+
+#include <cmath>
+#include <cstdlib>
+#include <type_traits>
+#include <vector>
+#include "FastMath.hpp"
+#include "ValueStack.hpp"
+#include "../FunctionType.hpp"
+#include "../Types.hpp"
+
+namespace libformula { namespace util
+{
+    /**
+     * An untagged stack slot, which either contains a long or a real value. The type
+     * of a slot is not stored, since it is known when the code is generated.
+     */
+    union ValueSlot
+    {
+        long_type m_long;
+        real_type m_real;
+    };
+
+    /**
+     * A term compiled for a fixed type of the $ variable. Since the type of each stack
+     * item then only depends on the opcodes, it is inferred while the code is appended
+     * and every operation is resolved to its long or real implementation. Values are
+     * converted by explicit opcodes where the operand types differ, so the code runs
+     * on untagged slots without inspecting any types.
+     */
+    class TypedCode
+    {
+        public:
+            /**
+             * Initializes new, empty code.
+             * @param itType The type of the $ variable.
+             * @param fastMath true to compute exp, pow, log and ln with the
+             *      approximations of FastMath.
+             */
+            explicit TypedCode(ValueStackItemType::_Domain itType, bool fastMath = false);
+
+            /**
+             * Removes all opcodes.
+             */
+            void clear();
+
+            /** Appends an operation pushing a long constant. */
+            void pushLong(long_type value);
+
+            /** Appends an operation pushing a real constant. */
+            void pushReal(real_type value);
+
+            /** Appends an operation pushing the $ variable. */
+            void pushIt();
+
+            /** Appends an addition of the two top items. */
+            void add();
+
+            /** Appends a subtraction of the two top items. */
+            void sub();
+
+            /** Appends a multiplication of the two top items. */
+            void mul();
+
+            /** Appends a real division of the two top items. */
+            void div();
+
+            /** Appends an integer division of the two top items. */
+            void idiv();
+
+            /** Appends the remainder of an integer division of the two top items. */
+            void mod();
+
+            /** Appends the negation of the top item. */
+            void negate();
+
+            /** Appends the addition of a constant to the top item. */
+            void addConst(ValueStackItem const& y);
+
+            /** Appends the multiplication of the top item with a constant. */
+            void mulConst(ValueStackItem const& y);
+
+            /** Appends the multiplication of the top item with @p a, followed by the addition of @p b. */
+            void mulAdd(ValueStackItem const& a, ValueStackItem const& b);
+
+            /** Appends the square of the top item. */
+            void square();
+
+            /**
+             * Appends a function call. Unknown functions or argument counts leave
+             * the stack unchanged.
+             * @param function The function to call.
+             * @param argcount The number of arguments on the stack.
+             */
+            void call(FunctionType const& function, int argcount);
+
+            /**
+             * Computes the term with the provided value used for the $ variable.
+             * @param value Value of the variable.
+             * @return Returns the result of the term computation.
+             */
+            template<typename ValueType>
+            ValueType compute(ValueType value) const;
+
+        private:
+            typedef ValueStackItemType::value_type TypeValue;
+
+            /**
+             * A single typed operation.
+             */
+            struct OpCode
+            {
+                enum _Domain
+                {
+                    PushConst,
+                    PushIt,
+                    ToLong,
+                    ToReal,
+                    AddLong,
+                    AddReal,
+                    SubLong,
+                    SubReal,
+                    MulLong,
+                    MulReal,
+                    DivReal,
+                    IdivLong,
+                    ModLong,
+                    NegLong,
+                    NegReal,
+                    AbsLong,
+                    AbsReal,
+                    SgnLong,
+                    SgnReal,
+                    AddConstLong,
+                    AddConstReal,
+                    MulConstLong,
+                    MulConstReal,
+                    MulAddLong,
+                    MulAddReal,
+                    Square,
+                    Exp,
+                    Pow,
+                    Cos,
+                    Sin,
+                    Tan,
+                    Acos,
+                    Asin,
+                    Atan,
+                    Atan2,
+                    Cosh,
+                    Sinh,
+                    Tanh,
+                    Log,
+                    LogBase,
+                    Ln,
+                    Floor,
+                    Ceil,
+                    Sqrt,
+                    FastExp,
+                    FastPow,
+                    FastLog,
+                    FastLogBase
+                };
+
+                /**
+                 * Initializes a new OpCode.
+                 * @param code OpCode.
+                 */
+                explicit OpCode(_Domain code)
+                    : m_code(code)
+                {
+                    m_operands[0].m_long = 0;
+                    m_operands[1].m_long = 0;
+                }
+
+                ValueSlot m_operands[2];
+                _Domain m_code;
+            };
+
+            /**
+             * Returns the type of the item @p offset positions below the top of the stack.
+             */
+            TypeValue type(int offset = 0) const;
+
+            /**
+             * Converts the item @p offset positions below the top of the stack to @p type.
+             */
+            void convert(int offset, TypeValue type);
+
+            /**
+             * Appends an operation that pops @p argcount items and pushes its result.
+             * The arguments are converted to @p argType before.
+             */
+            void append(OpCode const& code, int argcount, TypeValue argType, TypeValue resultType);
+
+            /**
+             * Appends either @p longCode or, if one of the two top items is of type real,
+             * @p realCode.
+             */
+            void arithmetic(OpCode::_Domain longCode, OpCode::_Domain realCode);
+
+            /**
+             * Appends either @p longCode or, if the top item or @p y is of type real,
+             * @p realCode, with @p y as constant operand.
+             */
+            void arithmetic(OpCode::_Domain longCode, OpCode::_Domain realCode, ValueStackItem const& y);
+
+            /**
+             * Converts a constant to a slot of the specified type.
+             */
+            static ValueSlot toSlot(ValueStackItem const& item, TypeValue type);
+
+        private:
+            std::vector<OpCode> m_code;
+            std::vector<TypeValue> m_types;
+            std::vector<TypeValue>::size_type m_maxDepth;
+            TypeValue m_itType;
+            bool m_fastMath;
+    };
+
+    /**************************************************************************
+     * Inline implementation                                                  *
+     **************************************************************************/
+
+    inline TypedCode::TypedCode(ValueStackItemType::_Domain itType, bool fastMath)
+        : m_maxDepth(0)
+        , m_itType(itType)
+        , m_fastMath(fastMath)
+    {}
+
+    inline void TypedCode::clear()
+    {
+        m_code.clear();
+        m_types.clear();
+        m_maxDepth = 0;
+    }
+
+    inline TypedCode::TypeValue TypedCode::type(int offset) const
+    {
+        return m_types[m_types.size() - 1 - offset];
+    }
+
+    inline void TypedCode::convert(int offset, TypeValue type)
+    {
+        if (this->type(offset) != type)
+        {
+            auto code = OpCode(type == ValueStackItemType::Long ? OpCode::ToLong : OpCode::ToReal);
+            code.m_operands[0].m_long = offset;
+            m_code.push_back(code);
+            m_types[m_types.size() - 1 - offset] = type;
+        }
+    }
+
+    inline void TypedCode::append(OpCode const& code, int argcount, TypeValue argType, TypeValue resultType)
+    {
+        for (auto offset = 0; offset < argcount; ++offset)
+            convert(offset, argType);
+
+        m_code.push_back(code);
+        m_types.resize(m_types.size() - argcount);
+        m_types.push_back(resultType);
+
+        if (m_types.size() > m_maxDepth)
+            m_maxDepth = m_types.size();
+    }
+
+    inline void TypedCode::arithmetic(OpCode::_Domain longCode, OpCode::_Domain realCode)
+    {
+        if ((type(0) | type(1)) == ValueStackItemType::Long)
+            append(OpCode(longCode), 2, ValueStackItemType::Long, ValueStackItemType::Long);
+        else
+            append(OpCode(realCode), 2, ValueStackItemType::Real, ValueStackItemType::Real);
+    }
+
+    inline void TypedCode::arithmetic(OpCode::_Domain longCode, OpCode::_Domain realCode, ValueStackItem const& y)
+    {
+        auto const resultType = (type() | y.type().value()) == ValueStackItemType::Long
+            ? TypeValue(ValueStackItemType::Long)
+            : TypeValue(ValueStackItemType::Real);
+        auto code = OpCode(resultType == ValueStackItemType::Long ? longCode : realCode);
+
+        code.m_operands[0] = toSlot(y, resultType);
+        append(code, 1, resultType, resultType);
+    }
+
+    inline ValueSlot TypedCode::toSlot(ValueStackItem const& item, TypeValue type)
+    {
+        auto slot = ValueSlot();
+
+        if (type == ValueStackItemType::Long)
+            slot.m_long = item.toValueType<long_type>();
+        else
+            slot.m_real = item.toValueType<real_type>();
+
+        return slot;
+    }
+
+    inline void TypedCode::pushLong(long_type value)
+    {
+        auto code = OpCode(OpCode::PushConst);
+        code.m_operands[0].m_long = value;
+        append(code, 0, ValueStackItemType::Long, ValueStackItemType::Long);
+    }
+
+    inline void TypedCode::pushReal(real_type value)
+    {
+        auto code = OpCode(OpCode::PushConst);
+        code.m_operands[0].m_real = value;
+        append(code, 0, ValueStackItemType::Real, ValueStackItemType::Real);
+    }
+
+    inline void TypedCode::pushIt()
+    {
+        append(OpCode(OpCode::PushIt), 0, m_itType, m_itType);
+    }
+
+    inline void TypedCode::add()
+    {
+        arithmetic(OpCode::AddLong, OpCode::AddReal);
+    }
+
+    inline void TypedCode::sub()
+    {
+        arithmetic(OpCode::SubLong, OpCode::SubReal);
+    }
+
+    inline void TypedCode::mul()
+    {
+        arithmetic(OpCode::MulLong, OpCode::MulReal);
+    }
+
+    inline void TypedCode::div()
+    {
+        append(OpCode(OpCode::DivReal), 2, ValueStackItemType::Real, ValueStackItemType::Real);
+    }
+
+    inline void TypedCode::idiv()
+    {
+        append(OpCode(OpCode::IdivLong), 2, ValueStackItemType::Long, ValueStackItemType::Long);
+    }
+
+    inline void TypedCode::mod()
+    {
+        append(OpCode(OpCode::ModLong), 2, ValueStackItemType::Long, ValueStackItemType::Long);
+    }
+
+    inline void TypedCode::negate()
+    {
+        auto const type = this->type();
+        append(OpCode(type == ValueStackItemType::Long ? OpCode::NegLong : OpCode::NegReal), 1, type, type);
+    }
+
+    inline void TypedCode::addConst(ValueStackItem const& y)
+    {
+        arithmetic(OpCode::AddConstLong, OpCode::AddConstReal, y);
+    }
+
+    inline void TypedCode::mulConst(ValueStackItem const& y)
+    {
+        arithmetic(OpCode::MulConstLong, OpCode::MulConstReal, y);
+    }
+
+    inline void TypedCode::mulAdd(ValueStackItem const& a, ValueStackItem const& b)
+    {
+        auto const type = this->type() | a.type().value() | b.type().value();
+
+        if (type != ValueStackItemType::Long && (this->type() | a.type().value()) == ValueStackItemType::Long)
+        {
+            // the product is computed as long before the real constant is added
+            mulConst(a);
+            addConst(b);
+        }
+        else
+        {
+            auto const resultType = type == ValueStackItemType::Long
+                ? TypeValue(ValueStackItemType::Long)
+                : TypeValue(ValueStackItemType::Real);
+            auto code = OpCode(resultType == ValueStackItemType::Long ? OpCode::MulAddLong : OpCode::MulAddReal);
+
+            code.m_operands[0] = toSlot(a, resultType);
+            code.m_operands[1] = toSlot(b, resultType);
+            append(code, 1, resultType, resultType);
+        }
+    }
+
+    inline void TypedCode::square()
+    {
+        append(OpCode(OpCode::Square), 1, ValueStackItemType::Real, ValueStackItemType::Real);
+    }
+
+    inline void TypedCode::call(FunctionType const& function, int argcount)
+    {
+        auto const real = TypeValue(ValueStackItemType::Real);
+        auto const integer = TypeValue(ValueStackItemType::Long);
+
+        switch(function.value())
+        {
+            case FunctionType::Exp:
+                append(OpCode(m_fastMath ? OpCode::FastExp : OpCode::Exp), 1, real, real);
+                break;
+            case FunctionType::Pow:
+                append(OpCode(m_fastMath ? OpCode::FastPow : OpCode::Pow), 2, real, real);
+                break;
+            case FunctionType::Cos:
+                append(OpCode(OpCode::Cos), 1, real, real);
+                break;
+            case FunctionType::Sin:
+                append(OpCode(OpCode::Sin), 1, real, real);
+                break;
+            case FunctionType::Tan:
+                append(OpCode(OpCode::Tan), 1, real, real);
+                break;
+            case FunctionType::Acos:
+                append(OpCode(OpCode::Acos), 1, real, real);
+                break;
+            case FunctionType::Asin:
+                append(OpCode(OpCode::Asin), 1, real, real);
+                break;
+            case FunctionType::Atan:
+                if (argcount == 1)
+                    append(OpCode(OpCode::Atan), 1, real, real);
+                else if (argcount == 2)
+                    append(OpCode(OpCode::Atan2), 2, real, real);
+                break;
+            case FunctionType::Cosh:
+                append(OpCode(OpCode::Cosh), 1, real, real);
+                break;
+            case FunctionType::Sinh:
+                append(OpCode(OpCode::Sinh), 1, real, real);
+                break;
+            case FunctionType::Tanh:
+                append(OpCode(OpCode::Tanh), 1, real, real);
+                break;
+            case FunctionType::Int:
+                convert(0, integer);
+                break;
+            case FunctionType::Float:
+                convert(0, real);
+                break;
+            case FunctionType::Log:
+                if (argcount == 1)
+                    append(OpCode(m_fastMath ? OpCode::FastLog : OpCode::Log), 1, real, real);
+                else if (argcount == 2)
+                    append(OpCode(m_fastMath ? OpCode::FastLogBase : OpCode::LogBase), 2, real, real);
+                break;
+            case FunctionType::Ln:
+                append(OpCode(m_fastMath ? OpCode::FastLog : OpCode::Ln), 1, real, real);
+                break;
+            case FunctionType::Round:
+                append(OpCode(OpCode::Floor), 1, real, real);
+                break;
+            case FunctionType::Ceil:
+                append(OpCode(OpCode::Ceil), 1, real, real);
+                break;
+            case FunctionType::Sqrt:
+                append(OpCode(OpCode::Sqrt), 1, real, real);
+                break;
+            case FunctionType::Abs:
+            {
+                auto const type = this->type();
+                append(OpCode(type == integer ? OpCode::AbsLong : OpCode::AbsReal), 1, type, type);
+                break;
+            }
+            case FunctionType::Sgn:
+            {
+                auto const type = this->type();
+                append(OpCode(type == integer ? OpCode::SgnLong : OpCode::SgnReal), 1, type, integer);
+                break;
+            }
+        }
+    }
+
+    template<typename ValueType>
+    inline ValueType TypedCode::compute(ValueType value) const
+    {
+        ValueSlot inlineSlots[ValueStack::InlineCapacity];
+        std::vector<ValueSlot> overflow;
+        auto const base = m_maxDepth <= ValueStack::InlineCapacity
+            ? inlineSlots
+            : (overflow.resize(m_maxDepth), overflow.data());
+        auto top = base - 1;
+
+        auto it = ValueSlot();
+        if (m_itType == ValueStackItemType::Long)
+            it.m_long = static_cast<long_type>(value);
+        else
+            it.m_real = static_cast<real_type>(value);
+
+        auto first = std::begin(m_code);
+        auto const last = std::end(m_code);
+        for (; first != last; ++first)
+        {
+            auto& code = *first;
+            switch(code.m_code)
+            {
+                case OpCode::PushConst:
+                    *++top = code.m_operands[0];
+                    break;
+                case OpCode::PushIt:
+                    *++top = it;
+                    break;
+                case OpCode::ToLong:
+                {
+                    auto& slot = top[-code.m_operands[0].m_long];
+                    slot.m_long = static_cast<long_type>(slot.m_real);
+                    break;
+                }
+                case OpCode::ToReal:
+                {
+                    auto& slot = top[-code.m_operands[0].m_long];
+                    slot.m_real = static_cast<real_type>(slot.m_long);
+                    break;
+                }
+                case OpCode::AddLong:
+                    --top;
+                    top->m_long = top[0].m_long + top[1].m_long;
+                    break;
+                case OpCode::AddReal:
+                    --top;
+                    top->m_real = top[0].m_real + top[1].m_real;
+                    break;
+                case OpCode::SubLong:
+                    --top;
+                    top->m_long = top[0].m_long - top[1].m_long;
+                    break;
+                case OpCode::SubReal:
+                    --top;
+                    top->m_real = top[0].m_real - top[1].m_real;
+                    break;
+                case OpCode::MulLong:
+                    --top;
+                    top->m_long = top[0].m_long * top[1].m_long;
+                    break;
+                case OpCode::MulReal:
+                    --top;
+                    top->m_real = top[0].m_real * top[1].m_real;
+                    break;
+                case OpCode::DivReal:
+                    --top;
+                    top->m_real = top[0].m_real / top[1].m_real;
+                    break;
+                case OpCode::IdivLong:
+                    --top;
+                    top->m_long = top[0].m_long / top[1].m_long;
+                    break;
+                case OpCode::ModLong:
+                    --top;
+                    top->m_long = top[0].m_long % top[1].m_long;
+                    break;
+                case OpCode::NegLong:
+                    top->m_long = -top->m_long;
+                    break;
+                case OpCode::NegReal:
+                    top->m_real = -top->m_real;
+                    break;
+                case OpCode::AbsLong:
+                    top->m_long = std::abs(top->m_long);
+                    break;
+                case OpCode::AbsReal:
+                    top->m_real = std::abs(top->m_real);
+                    break;
+                case OpCode::SgnLong:
+                    top->m_long = top->m_long < 0 ? -1 : (top->m_long > 0 ? 1 : 0);
+                    break;
+                case OpCode::SgnReal:
+                    top->m_long = top->m_real < 0.0 ? -1 : (top->m_real > 0.0 ? 1 : 0);
+                    break;
+                case OpCode::AddConstLong:
+                    top->m_long += code.m_operands[0].m_long;
+                    break;
+                case OpCode::AddConstReal:
+                    top->m_real += code.m_operands[0].m_real;
+                    break;
+                case OpCode::MulConstLong:
+                    top->m_long *= code.m_operands[0].m_long;
+                    break;
+                case OpCode::MulConstReal:
+                    top->m_real *= code.m_operands[0].m_real;
+                    break;
+                case OpCode::MulAddLong:
+                    top->m_long = top->m_long * code.m_operands[0].m_long + code.m_operands[1].m_long;
+                    break;
+                case OpCode::MulAddReal:
+                    top->m_real = top->m_real * code.m_operands[0].m_real + code.m_operands[1].m_real;
+                    break;
+                case OpCode::Square:
+                    top->m_real = top->m_real * top->m_real;
+                    break;
+                case OpCode::Exp:
+                    top->m_real = std::exp(top->m_real);
+                    break;
+                case OpCode::Pow:
+                    --top;
+                    top->m_real = std::pow(top[0].m_real, top[1].m_real);
+                    break;
+                case OpCode::Cos:
+                    top->m_real = std::cos(top->m_real);
+                    break;
+                case OpCode::Sin:
+                    top->m_real = std::sin(top->m_real);
+                    break;
+                case OpCode::Tan:
+                    top->m_real = std::tan(top->m_real);
+                    break;
+                case OpCode::Acos:
+                    top->m_real = std::acos(top->m_real);
+                    break;
+                case OpCode::Asin:
+                    top->m_real = std::asin(top->m_real);
+                    break;
+                case OpCode::Atan:
+                    top->m_real = std::atan(top->m_real);
+                    break;
+                case OpCode::Atan2:
+                    --top;
+                    top->m_real = std::atan2(top[1].m_real, top[0].m_real);
+                    break;
+                case OpCode::Cosh:
+                    top->m_real = std::cosh(top->m_real);
+                    break;
+                case OpCode::Sinh:
+                    top->m_real = std::sinh(top->m_real);
+                    break;
+                case OpCode::Tanh:
+                    top->m_real = std::tanh(top->m_real);
+                    break;
+                case OpCode::Log:
+                    top->m_real = std::log(top->m_real);
+                    break;
+                case OpCode::LogBase:
+                    --top;
+                    top->m_real = std::log(top[0].m_real) / std::log(top[1].m_real);
+                    break;
+                case OpCode::Ln:
+                    top->m_real = std::log(top->m_real);
+                    break;
+                case OpCode::Floor:
+                    top->m_real = std::floor(top->m_real);
+                    break;
+                case OpCode::Ceil:
+                    top->m_real = std::ceil(top->m_real);
+                    break;
+                case OpCode::Sqrt:
+                    top->m_real = std::sqrt(top->m_real);
+                    break;
+                case OpCode::FastExp:
+                    top->m_real = FastMath::exp(top->m_real);
+                    break;
+                case OpCode::FastPow:
+                    --top;
+                    top->m_real = FastMath::pow(top[0].m_real, top[1].m_real);
+                    break;
+                case OpCode::FastLog:
+                    top->m_real = FastMath::log(top->m_real);
+                    break;
+                case OpCode::FastLogBase:
+                    --top;
+                    top->m_real = FastMath::log(top[0].m_real) / FastMath::log(top[1].m_real);
+                    break;
+            }
+        }
+
+        if (m_types.empty())
+            return value;
+
+        return m_types.back() == ValueStackItemType::Long
+            ? static_cast<ValueType>(top->m_long)
+            : static_cast<ValueType>(top->m_real);
+    }
+}
+}
+
+#endif  //__LIBFORMULA_UTIL_TYPEDCODE_HPP
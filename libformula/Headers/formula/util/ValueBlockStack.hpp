@@ -0,0 +1,225 @@
+#ifndef __LIBFORMULA_UTIL_VALUEBLOCKSTACK_HPP
+#define __LIBFORMULA_UTIL_VALUEBLOCKSTACK_HPP
+
+#include <vector>
+#include "ValueStack.hpp"
+#include "../Types.hpp"
+
+namespace libformula { namespace util
+{
+    /**
+     * A value stack whose items are blocks of values instead of single values. It
+     * is used to compute a term for many values at once.
+     * All values of an item share the same type, since the type of an item only depends
+     * on the opcodes and on the type of the $ variable. The values are stored in
+     * contiguous arrays, one per type, so that each opcode can run over a whole block
+     * in a single loop.
+     * The memory is retained when the stack is reset, so a stack that is reused does
+     * not allocate once it has grown to the depth required by a term.
+     */
+    class ValueBlockStack
+    {
+        public:
+            typedef std::vector<long_type>::size_type size_type;
+
+            enum
+            {
+                /** The maximum number of values in a block. */
+                BlockSize = 64
+            };
+
+            /** Constructor */
+            ValueBlockStack();
+
+            /**
+             * Removes all items from the stack and sets the number of values
+             * in each of the following blocks.
+             * @param count The number of values in a block, at most BlockSize.
+             * @param depth The maximum number of items that will be pushed.
+             */
+            void reset(size_type count, size_type depth);
+
+            /**
+             * Returns the number of values in a block.
+             * @return The number of values in a block.
+             */
+            size_type count() const;
+
+            /**
+             * Returns true if the stack is empty, otherwise false.
+             * @return true if the stack is empty, otherwise false.
+             */
+            bool empty() const;
+
+            /**
+             * Returns the type of the item @p offset positions below the top of
+             * the stack. This method must not be called with an offset that
+             * exceeds the number of items on the stack.
+             * @param offset The position of the item, 0 being the top item.
+             * @return The type of the item.
+             */
+            ValueStackItemType::value_type type(size_type offset = 0) const;
+
+            /**
+             * Pushes a new item of type long onto the stack and returns its values,
+             * which have to be written by the caller.
+             * @return Pointer to the first value of the new item.
+             */
+            long_type* pushLong();
+
+            /**
+             * Pushes a new item of type real onto the stack and returns its values,
+             * which have to be written by the caller.
+             * @return Pointer to the first value of the new item.
+             */
+            real_type* pushReal();
+
+            /**
+             * Removes the top item from the stack and returns its values converted to long.
+             * The values remain valid until the next item is pushed.
+             * @return Pointer to the first value of the removed item.
+             */
+            long_type const* popLong();
+
+            /**
+             * Removes the top item from the stack and returns its values converted to real.
+             * The values remain valid until the next item is pushed.
+             * @return Pointer to the first value of the removed item.
+             */
+            real_type const* popReal();
+
+            /**
+             * Pushes a new item of the type specified by the template parameter.
+             * @see pushLong
+             * @see pushReal
+             */
+            template<typename ValueType>
+            ValueType* push();
+
+            /**
+             * Removes the top item from the stack and returns its values converted to
+             * the type specified by the template parameter.
+             * @see popLong
+             * @see popReal
+             */
+            template<typename ValueType>
+            ValueType const* pop();
+
+        private:
+            typedef std::vector<ValueStackItemType::value_type> TypeCollection;
+
+            std::vector<long_type> m_longs;
+            std::vector<real_type> m_reals;
+            TypeCollection m_types;
+            size_type m_count;
+    };
+
+    /**************************************************************************
+     * Inline implementation                                                  *
+     **************************************************************************/
+
+    inline ValueBlockStack::ValueBlockStack()
+        : m_count(0)
+    {}
+
+    inline void ValueBlockStack::reset(size_type count, size_type depth)
+    {
+        if (m_longs.size() < depth * BlockSize)
+        {
+            m_longs.resize(depth * BlockSize);
+            m_reals.resize(depth * BlockSize);
+            m_types.reserve(depth);
+        }
+
+        m_types.clear();
+        m_count = count;
+    }
+
+    inline ValueBlockStack::size_type ValueBlockStack::count() const
+    {
+        return m_count;
+    }
+
+    inline bool ValueBlockStack::empty() const
+    {
+        return m_types.empty();
+    }
+
+    inline ValueStackItemType::value_type ValueBlockStack::type(size_type offset) const
+    {
+        return m_types[m_types.size() - 1 - offset];
+    }
+
+    inline long_type* ValueBlockStack::pushLong()
+    {
+        auto const index = m_types.size();
+        m_types.push_back(ValueStackItemType::Long);
+        return &m_longs[index * BlockSize];
+    }
+
+    inline real_type* ValueBlockStack::pushReal()
+    {
+        auto const index = m_types.size();
+        m_types.push_back(ValueStackItemType::Real);
+        return &m_reals[index * BlockSize];
+    }
+
+    inline long_type const* ValueBlockStack::popLong()
+    {
+        auto const index = m_types.size() - 1;
+        auto const values = &m_longs[index * BlockSize];
+
+        if (m_types.back() == ValueStackItemType::Real)
+        {
+            auto const reals = &m_reals[index * BlockSize];
+            for (size_type i = 0; i < m_count; ++i)
+                values[i] = static_cast<long_type>(reals[i]);
+        }
+
+        m_types.pop_back();
+        return values;
+    }
+
+    inline real_type const* ValueBlockStack::popReal()
+    {
+        auto const index = m_types.size() - 1;
+        auto const values = &m_reals[index * BlockSize];
+
+        if (m_types.back() == ValueStackItemType::Long)
+        {
+            auto const longs = &m_longs[index * BlockSize];
+            for (size_type i = 0; i < m_count; ++i)
+                values[i] = static_cast<real_type>(longs[i]);
+        }
+
+        m_types.pop_back();
+        return values;
+    }
+
+    template<>
+    inline long_type* ValueBlockStack::push<long_type>()
+    {
+        return pushLong();
+    }
+
+    template<>
+    inline real_type* ValueBlockStack::push<real_type>()
+    {
+        return pushReal();
+    }
+
+    template<>
+    inline long_type const* ValueBlockStack::pop<long_type>()
+    {
+        return popLong();
+    }
+
+    template<>
+    inline real_type const* ValueBlockStack::pop<real_type>()
+    {
+        return popReal();
+    }
+}
+}
+
+#endif  //__LIBFORMULA_UTIL_VALUEBLOCKSTACK_HPP
@@ -1,7 +1,9 @@
 #ifndef __LIBFORMULA_UTIL_VALUESTACK_HPP
 #define __LIBFORMULA_UTIL_VALUESTACK_HPP
 
-#include <stack>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
 #include "../Types.hpp"
 
 namespace libformula { namespace util
@@ -119,6 +121,14 @@ namespace libformula { namespace util
         };
 
         public:
+            /**
+             * Initializes a new ValueStackItem with the long value 0.
+             */
+            ValueStackItem()
+                : m_type(ValueStackItemType::Long)
+                , m_long(0)
+            {}
+
             /**
              * Initializes a new ValueStackItem with the specified long value.
              * @param value The value to initialize the item with.
@@ -186,13 +196,30 @@ namespace libformula { namespace util
     /**
      * The value stack can store values of real and long types. Additionaly, it may
      * convert a long value to a real value and vice versa.
+     * The items are stored in an inline array, so a stack whose depth does not exceed
+     * InlineCapacity does not allocate any memory. Deeper stacks use a vector instead.
      */
     class ValueStack
     {
-        typedef std::stack<ValueStackItem> ValueStackItemContainer;
+        typedef std::vector<ValueStackItem> ValueStackItemContainer;
         public:
             typedef ValueStackItemContainer::value_type value_type;
             typedef ValueStackItemContainer::const_reference const_reference;
+            typedef ValueStackItemContainer::size_type size_type;
+
+            enum
+            {
+                /** The number of items that can be stored without allocating memory. */
+                InlineCapacity = 16
+            };
+
+            /**
+             * Initializes a new, empty stack.
+             * @param capacity The maximum number of items expected on the stack, e.g.
+             *      the maximum depth of a compiled term. The stack still grows if more
+             *      items are pushed.
+             */
+            explicit ValueStack(size_type capacity = InlineCapacity);
 
             /**
              * Removes the current item from the stack and returns it. This method
@@ -256,18 +283,54 @@ namespace libformula { namespace util
             bool any() const;
 
         private:
-            ValueStackItemContainer m_stack;
+            /** Non-copyable, since m_items may point to the inline array. */
+            ValueStack(ValueStack const&);
+            ValueStack& operator=(ValueStack const&);
+
+            /**
+             * Moves the items into a vector with twice the current capacity.
+             */
+            void grow();
+
+        private:
+            ValueStackItem m_inline[InlineCapacity];
+            ValueStackItemContainer m_overflow;
+            ValueStackItem* m_items;
+            size_type m_capacity;
+            size_type m_size;
     };
 
     /**************************************************************************
      * Inline implementation                                                  *
      **************************************************************************/
 
+    inline ValueStack::ValueStack(size_type capacity)
+        : m_items(m_inline)
+        , m_capacity(InlineCapacity)
+        , m_size(0)
+    {
+        if (capacity > InlineCapacity)
+        {
+            m_overflow.resize(capacity);
+            m_items = &m_overflow[0];
+            m_capacity = capacity;
+        }
+    }
+
+    inline void ValueStack::grow()
+    {
+        auto items = ValueStackItemContainer(m_items, m_items + m_size);
+        items.resize(m_capacity * 2);
+
+        m_overflow.swap(items);
+        m_items = &m_overflow[0];
+        m_capacity = m_overflow.size();
+    }
+
     inline ValueStack::value_type ValueStack::pop()
     {
-        auto const top = m_stack.top();
-        m_stack.pop();
-        return top;
+        --m_size;
+        return m_items[m_size];
     }
 
     template<typename ValueType>
@@ -279,38 +342,41 @@ namespace libformula { namespace util
 
     inline ValueStack::const_reference ValueStack::top()
     {
-        return m_stack.top();
+        return m_items[m_size - 1];
     }
 
     inline void ValueStack::push(value_type const& value)
     {
-        m_stack.push(value);
+        if (m_size == m_capacity)
+            grow();
+
+        m_items[m_size] = value;
+        ++m_size;
     }
 
     inline void ValueStack::push(long_type value)
     {
-        m_stack.push(value);
+        push(value_type(value));
     }
 
     inline void ValueStack::push(real_type value)
     {
-        m_stack.push(value);
+        push(value_type(value));
     }
 
     inline void ValueStack::clear()
     {
-        while(m_stack.empty() == false)
-            m_stack.pop();
+        m_size = 0;
     }
 
     inline bool ValueStack::empty() const
     {
-        return m_stack.empty();
+        return m_size == 0;
     }
 
     inline bool ValueStack::any() const
     {
-        return m_stack.empty() == false;
+        return m_size != 0;
     }
 
 
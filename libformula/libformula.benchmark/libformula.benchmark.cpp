@@ -0,0 +1,251 @@
+// libformula.benchmark.cpp : Measures compile latency and compute throughput of typical terms.
+//
+
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <new>
+#include <string>
+#include <vector>
+#include "formula/Formula.hpp"
+
+namespace
+{
+    /** The number of allocations made since the program has been started. */
+    unsigned long allocations = 0;
+
+    /** Minimum time in milliseconds each measurement runs. */
+    double const MinDuration = 500.0;
+
+    /** The number of values computed per call of the block compute. */
+    std::size_t const BlockLength = 1024;
+
+    /**
+     * Terms as they are typically found in the formula fields of
+     * consumer parameters.
+     */
+    char const* const Corpus[] =
+    {
+        "$ / 255 * 100",
+        "int($ * 2.55)",
+        "20 * log($ / 32768, 10)",
+        "10 ^ ($ / 20) * 32768",
+        "$ * $ / 100",
+        "sqrt($ / 100) * 100",
+        "0.5 * $ * $ * $ - 2 * $ * $ + 3 * $ - 1",
+        "($ - 32) * 5 / 9",
+        "sgn($) * ln(1 + abs($) / 10)",
+        "round($ * 4 + 0.5) / 4",
+    };
+
+    /**
+     * Code emitter that discards the code, used to measure the parser alone.
+     */
+    class NullEmitter : public libformula::CodeEmitter
+    {
+        public:
+            virtual void emitPushLong(long) {}
+            virtual void emitPushReal(double) {}
+            virtual void emitPushIt() {}
+            virtual void emitAdd() {}
+            virtual void emitSubtract() {}
+            virtual void emitMultiply() {}
+            virtual void emitDivide() {}
+            virtual void emitLongDivide() {}
+            virtual void emitModulo() {}
+            virtual void emitCall(libformula::FunctionType const&, int) {}
+            virtual void emitNegate() {}
+    };
+
+    double elapsed(std::clock_t start)
+    {
+        return (std::clock() - start) * 1000.0 / CLOCKS_PER_SEC;
+    }
+
+    /**
+     * Runs @p operation until MinDuration has elapsed and prints the time and the
+     * number of allocations per evaluation.
+     * @param name The name of the measurement.
+     * @param evaluations The number of evaluations made by a single call of @p operation.
+     * @param operation The operation to measure.
+     * @return The time of a single evaluation in nanoseconds.
+     */
+    template<typename Operation>
+    double measure(char const* name, std::size_t evaluations, Operation operation)
+    {
+        auto iterations = 0UL;
+        auto const firstAllocation = allocations;
+        auto const start = std::clock();
+        auto time = 0.0;
+
+        do
+        {
+            operation();
+            ++iterations;
+            time = elapsed(start);
+        } while(time < MinDuration);
+
+        auto const count = static_cast<double>(iterations) * evaluations;
+        auto const duration = time * 1000000.0 / count;
+        std::printf("  %-10s %10.1f ns/eval %8.2f allocations/eval\n",
+            name,
+            duration,
+            (allocations - firstAllocation) / count);
+        return duration;
+    }
+
+    void run(std::string const& term)
+    {
+        using namespace libformula;
+
+        auto values = std::vector<real_type>(BlockLength);
+        auto results = std::vector<real_type>(BlockLength);
+        auto context = util::CodeInterpreter::Context();
+        auto errors = ErrorStack();
+        auto const compiled = TermCompiler::compile(term, &errors);
+        auto volatile sink = 0.0;
+
+        for (auto i = std::size_t(0); i < BlockLength; ++i)
+            values[i] = 1.0 + i * 0.25;
+
+        if (errors.any())
+        {
+            std::printf("ERROR: %s does not compile\n", term.c_str());
+            std::exit(1);
+        }
+
+        std::printf("%s\n", term.c_str());
+
+        auto const first = term.data();
+        auto const last = term.data() + term.size();
+
+        measure("scan", 1, [&]()
+        {
+            util::Arena arena;
+            auto const scanner = Scanner<char const*>(first, last, &errors, arena);
+            sink = sink + scanner.size();
+        });
+
+        measure("parse", 1, [&]()
+        {
+            util::Arena arena;
+            auto emitter = NullEmitter();
+            auto const scanner = Scanner<char const*>(first, last, &errors, arena);
+            auto const parser = Parser<char const*>(scanner, &emitter, &errors);
+        });
+
+        measure("compile", 1, [&]()
+        {
+            auto const result = TermCompiler::compile(term, &errors);
+            sink = sink + result.compute(1.0);
+        });
+
+        measure("compute", BlockLength, [&]()
+        {
+            for (auto i = std::size_t(0); i < BlockLength; ++i)
+                sink = sink + compiled.compute(values[i]);
+        });
+
+        measure("block", BlockLength, [&]()
+        {
+            compiled.compute(values.begin(), values.end(), results.begin(), context);
+            sink = sink + results[0];
+        });
+    }
+
+    /**
+     * Compiles the whole corpus, as a consumer does with the formulas of the parameters
+     * it receives while synchronizing a tree, and prints the compile throughput.
+     */
+    void runCompileThroughput()
+    {
+        using namespace libformula;
+
+        auto const count = sizeof(Corpus) / sizeof(Corpus[0]);
+        auto const terms = std::vector<std::string>(Corpus, Corpus + count);
+        auto errors = ErrorStack();
+        auto volatile sink = 0.0;
+
+        std::printf("corpus (compile throughput)\n");
+
+        auto const duration = measure("compile", count, [&]()
+        {
+            for (auto const& term : terms)
+                sink = sink + TermCompiler::compile(term, &errors).compute(1.0);
+        });
+
+        std::printf("  %-10s %10.0f terms/s\n", "throughput", 1000000000.0 / duration);
+    }
+
+    /**
+     * Compares an expression compiled into the program with the interpreted
+     * term it is printed as.
+     * @param expression The expression to measure.
+     */
+    template<typename Expression>
+    void runExpression(Expression const& expression)
+    {
+        using namespace libformula;
+
+        auto const term = expression.toString();
+        auto const compiled = TermCompiler::compile(term);
+        auto values = std::vector<real_type>(BlockLength);
+        auto volatile sink = 0.0;
+
+        for (auto i = std::size_t(0); i < BlockLength; ++i)
+            values[i] = 1.0 + i * 0.25;
+
+        std::printf("%s (expression)\n", term.c_str());
+
+        measure("compute", BlockLength, [&]()
+        {
+            for (auto i = std::size_t(0); i < BlockLength; ++i)
+                sink = sink + compiled.compute(values[i]);
+        });
+
+        measure("inlined", BlockLength, [&]()
+        {
+            for (auto i = std::size_t(0); i < BlockLength; ++i)
+                sink = sink + expression.compute(values[i]);
+        });
+    }
+}
+
+void* operator new(std::size_t size)
+{
+    ++allocations;
+
+    if (auto const memory = std::malloc(size != 0 ? size : 1))
+        return memory;
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) throw()
+{
+    std::free(memory);
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc > 1)
+    {
+        for (auto i = 1; i < argc; ++i)
+            run(argv[i]);
+    }
+    else
+    {
+        for (auto const term : Corpus)
+            run(term);
+
+        runCompileThroughput();
+
+        using namespace libformula::expression;
+        runExpression(it() / 255 * 100);
+        runExpression(toLong(it() * 2.55));
+        runExpression(20 * log(it() / 32768, constant(10L)));
+        runExpression((it() - 32) * 5 / 9);
+    }
+
+    return 0;
+}
@@ -0,0 +1,117 @@
+/*
+    libs101 -- C++ 03 implementation of the S101 encoding and decoding
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef __LIBS101_CAPABILITIES_HPP
+#define __LIBS101_CAPABILITIES_HPP
+
+#include <iterator>
+#include "CommandType.hpp"
+#include "MessageType.hpp"
+#include "StreamEncoder.hpp"
+
+//SimianIgnore
+
+namespace libs101
+{
+    /**
+     * Encodes and decodes the capabilities message, which announces the optional
+     * protocol features a host supports. Both hosts should send this message once the
+     * connection has been established. A feature may only be used when the remote host
+     * has announced it, and since hosts that do not know the capabilities command
+     * ignore it, they never receive a message that makes use of an optional feature.
+     * The message consists of the slot, the message type, the command, the version and
+     * a single byte containing the capability flags.
+     */
+    struct Capabilities
+    {
+        typedef unsigned char value_type;
+
+        enum _Domain
+        {
+            /** The host supports no optional features. */
+            None = 0x00,
+
+            /**
+             * The host is able to decode packages with the PackageFlag::CompressedPackage
+             * flag, see Compression.
+             */
+            Compression = 0x01
+        };
+
+        /**
+         * Encodes a capabilities message.
+         * @param encoder The encoder to write the message to. The encoder is finished
+         *      when this method returns.
+         * @param slot The slot of the message.
+         * @param capabilities The combination of capability flags to announce.
+         */
+        template<typename ValueType>
+        static void encode(StreamEncoder<ValueType>& encoder, value_type slot, value_type capabilities)
+        {
+            encoder.encode(slot);
+            encoder.encode(MessageType::EmBER);
+            encoder.encode(CommandType::Capabilities);
+            encoder.encode(0x01);
+            encoder.encode(capabilities);
+            encoder.finish();
+        }
+
+        /**
+         * Tests whether a message that has been decoded by a StreamDecoder is a
+         * capabilities message.
+         * @param first The first byte of the decoded message.
+         * @param last The byte one past the last byte of the decoded message.
+         * @return true if the message is a capabilities message.
+         */
+        template<typename InputIterator>
+        static bool isCapabilities(InputIterator first, InputIterator last)
+        {
+            // Slot, message type, command, version and capabilities
+            if (std::distance(first, last) < 5)
+                return false;
+
+            ++first;
+            if (static_cast<value_type>(*first++) != MessageType::EmBER)
+                return false;
+
+            return static_cast<value_type>(*first) == CommandType::Capabilities;
+        }
+
+        /**
+         * Returns the capability flags announced by a capabilities message.
+         * @param first The first byte of the decoded message.
+         * @param last The byte one past the last byte of the decoded message.
+         * @return The capability flags, or None if the message is not a capabilities
+         *      message.
+         */
+        template<typename InputIterator>
+        static value_type decode(InputIterator first, InputIterator last)
+        {
+            if (isCapabilities(first, last) == false)
+                return None;
+
+            std::advance(first, 4);
+            return static_cast<value_type>(*first);
+        }
+    };
+}
+
+//EndSimianIgnore
+
+#endif  // __LIBS101_CAPABILITIES_HPP
@@ -50,7 +50,13 @@ namespace libs101
             /**
              * Reports the server status.
              */
-            ProviderState = 0x03
+            ProviderState = 0x03,
+
+            /**
+             * Announces the optional protocol features supported by the sender.
+             * @see Capabilities
+             */
+            Capabilities = 0x04
         };
 
 
@@ -0,0 +1,375 @@
+/*
+    libs101 -- C++ 03 implementation of the S101 encoding and decoding
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef __LIBS101_COMPRESSION_HPP
+#define __LIBS101_COMPRESSION_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <vector>
+
+//SimianIgnore
+
+namespace libs101
+{
+    /**
+     * Compresses and decompresses the payload of packages that carry the
+     * PackageFlag::CompressedPackage flag. The payload following the application
+     * bytes is stored as an LZ4 block, which has been compressed with the preset
+     * dictionary returned by dictionaryBegin(). The dictionary contains the tags
+     * and length prefixes that are most common in Glow trees, so even a short
+     * package finds matches right from its first byte.
+     * Each package is compressed on its own and the uncompressed payload of a
+     * package must not exceed 65535 bytes, so a receiver can decompress a package
+     * as soon as it has been decoded.
+     * A package may only be compressed if the remote host has announced
+     * Capabilities::Compression.
+     */
+    class Compression
+    {
+        public:
+            typedef unsigned char value_type;
+            typedef std::vector<value_type> ByteVector;
+            typedef value_type const* const_iterator;
+
+            enum
+            {
+                /** The number of bytes of the preset dictionary. */
+                DictionarySize = 204,
+
+                /** The maximum size of an uncompressed payload. */
+                MaximumPayloadSize = 65535
+            };
+
+            /**
+             * Returns the first byte of the preset dictionary.
+             * @return The first byte of the preset dictionary.
+             */
+            static const_iterator dictionaryBegin();
+
+            /**
+             * Returns the byte one past the last byte of the preset dictionary.
+             * @return The end of the preset dictionary.
+             */
+            static const_iterator dictionaryEnd();
+
+            /**
+             * Compresses a package payload and appends the compressed block to
+             * @p output. Nothing is appended if the compressed block would not be
+             * smaller than the payload, in which case the package should be sent
+             * uncompressed.
+             * @param first The first byte of the payload to compress.
+             * @param last The byte one past the last byte of the payload.
+             * @param output The buffer to append the compressed block to.
+             * @return true if the compressed block has been appended to @p output.
+             */
+            template<typename InputIterator>
+            static bool compress(InputIterator first, InputIterator last, ByteVector& output);
+
+            /**
+             * Decompresses the payload of a compressed package and appends it to
+             * @p output.
+             * @param first The first byte of the compressed block.
+             * @param last The byte one past the last byte of the compressed block.
+             * @param output The buffer to append the decompressed payload to.
+             * @return true if the block has been decompressed, false if it is
+             *      malformed. In the latter case, @p output may contain a part of
+             *      the payload.
+             */
+            template<typename InputIterator>
+            static bool decompress(InputIterator first, InputIterator last, ByteVector& output);
+
+        private:
+            enum
+            {
+                /** The number of bits of the hash used to look up matches. */
+                HashBits = 12,
+
+                /** The minimum length of a match. */
+                MinimumMatch = 4,
+
+                /** The number of bytes at the end of a block that are always literals. */
+                LastLiterals = 5,
+
+                /** The number of bytes at the end of a block where no match may start. */
+                MatchLimit = 12,
+
+                /** The largest distance a match may refer back to. */
+                MaximumOffset = 65535
+            };
+
+            /**
+             * Hashes the four bytes at @p position.
+             * @param window The dictionary followed by the payload.
+             * @param position The index of the first of the four bytes.
+             * @return The hash of the bytes.
+             */
+            static std::size_t hash(ByteVector const& window, std::size_t position);
+
+            /**
+             * Appends a length that does not fit into the four bits of a token.
+             * @param output The buffer to append the length to.
+             * @param length The remainder of the length, excluding the 15 stored
+             *      in the token.
+             */
+            static void appendLength(ByteVector& output, std::size_t length);
+
+            /**
+             * Appends the token and the literals of a sequence.
+             * @param output The buffer to append the sequence to.
+             * @param literals The first literal byte.
+             * @param literalCount The number of literal bytes.
+             * @param matchLength The length of the match that follows the literals,
+             *      or zero for the last sequence of a block.
+             */
+            static void appendLiterals(ByteVector& output, value_type const* literals, std::size_t literalCount, std::size_t matchLength);
+
+            /**
+             * Reads a length that did not fit into the four bits of a token.
+             * @param first The current position within the compressed block.
+             * @param last The end of the compressed block.
+             * @param length The length to increment.
+             * @return false if the block ends within the length.
+             */
+            template<typename InputIterator>
+            static bool readLength(InputIterator& first, InputIterator last, std::size_t& length);
+    };
+
+    /**************************************************************************/
+    /* Mandatory inline implementation                                        */
+    /**************************************************************************/
+
+    inline Compression::const_iterator Compression::dictionaryBegin()
+    {
+        static value_type const dictionary[DictionarySize] =
+        {
+            // Root, root element collection and element collection with
+            // indefinite lengths, as written by libember_slim.
+            0x60, 0x80, 0x6B, 0x80, 0xA0, 0x80, 0x64, 0x80, 0xA0, 0x80,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+
+            // Qualified node and qualified parameter with path and contents.
+            0x6A, 0x80, 0xA0, 0x80, 0x0D, 0x01, 0x01, 0x00, 0x00, 0xA1, 0x80, 0x31, 0x80,
+            0xA0, 0x80, 0x0C, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x69, 0x80, 0xA0, 0x80, 0x0D, 0x02, 0x01, 0x01, 0x00, 0x00, 0xA1, 0x80, 0x31, 0x80,
+            0xA0, 0x80, 0x0C, 0x00, 0x00, 0xA1, 0x80, 0x0C, 0x00, 0x00,
+
+            // Parameter contents: value, minimum, maximum, access, type and
+            // enumeration.
+            0xA2, 0x80, 0x02, 0x01, 0x00, 0x00, 0x00, 0xA3, 0x80, 0x02, 0x01, 0x00, 0x00, 0x00,
+            0xA4, 0x80, 0x02, 0x01, 0x00, 0x00, 0x00, 0xA5, 0x80, 0x02, 0x01, 0x03, 0x00, 0x00,
+            0xAD, 0x80, 0x02, 0x01, 0x01, 0x00, 0x00, 0xA2, 0x80, 0x09, 0x00, 0x00, 0x00,
+            0xA7, 0x80, 0x0C, 0x00, 0x00, 0x00, 0xAD, 0x80, 0x02, 0x01, 0x04, 0x00, 0x00,
+
+            // Node and parameter with definite lengths, as written by libember.
+            0x63, 0x00, 0xA0, 0x03, 0x02, 0x01, 0x01, 0xA1, 0x00, 0x31, 0x00, 0xA0, 0x00, 0x0C,
+            0xA2, 0x00, 0x64, 0x00, 0xA0, 0x00, 0x61, 0x00, 0xA0, 0x03, 0x02, 0x01, 0x01,
+            0xA5, 0x03, 0x02, 0x01, 0x03, 0xAD, 0x03, 0x02, 0x01, 0x01, 0xA3, 0x04, 0x02, 0x02,
+            0xA4, 0x04, 0x02, 0x02, 0xA2, 0x03, 0x02, 0x01, 0x00, 0xA2, 0x03, 0x01, 0x01, 0xFF,
+
+            // Get directory command and stream entries.
+            0x62, 0x80, 0xA0, 0x03, 0x02, 0x01, 0x20, 0xA1, 0x03, 0x02, 0x01, 0xFF, 0x00, 0x00,
+            0x66, 0x80, 0xA0, 0x80, 0x65, 0x80, 0xA0, 0x03, 0x02, 0x01, 0x01, 0xA1, 0x80,
+            0x00, 0x00, 0x00, 0x00
+        };
+
+        return dictionary;
+    }
+
+    inline Compression::const_iterator Compression::dictionaryEnd()
+    {
+        return dictionaryBegin() + DictionarySize;
+    }
+
+    template<typename InputIterator>
+    inline bool Compression::compress(InputIterator first, InputIterator last, ByteVector& output)
+    {
+        // The dictionary precedes the payload, so matches may refer to it as if it
+        // had been part of the package.
+        ByteVector window(dictionaryBegin(), dictionaryEnd());
+        window.insert(window.end(), first, last);
+
+        std::size_t const start = DictionarySize;
+        std::size_t const end = window.size();
+        std::size_t const payloadSize = end - start;
+        if (payloadSize == 0 || payloadSize > MaximumPayloadSize)
+            return false;
+
+        // Positions are stored incremented by one, so zero marks an empty slot.
+        std::vector<std::size_t> table(std::size_t(1) << HashBits, 0);
+        for (std::size_t position = 0; position + MinimumMatch <= start; ++position)
+            table[hash(window, position)] = position + 1;
+
+        ByteVector block;
+        block.reserve(payloadSize);
+
+        std::size_t anchor = start;
+        std::size_t position = start;
+        while (payloadSize > MatchLimit && position + MatchLimit <= end)
+        {
+            std::size_t const key = hash(window, position);
+            std::size_t const candidate = table[key];
+            table[key] = position + 1;
+
+            if (candidate == 0
+            ||  position - (candidate - 1) > MaximumOffset
+            ||  std::equal(window.begin() + position, window.begin() + position + MinimumMatch, window.begin() + (candidate - 1)) == false)
+            {
+                ++position;
+                continue;
+            }
+
+            std::size_t const match = candidate - 1;
+            std::size_t length = MinimumMatch;
+            while (position + length < end - LastLiterals && window[match + length] == window[position + length])
+                ++length;
+
+            appendLiterals(block, &window[0] + anchor, position - anchor, length);
+
+            std::size_t const offset = position - match;
+            block.push_back(static_cast<value_type>(offset & 0xFF));
+            block.push_back(static_cast<value_type>((offset >> 8) & 0xFF));
+
+            if (length - MinimumMatch >= 15)
+                appendLength(block, length - MinimumMatch - 15);
+
+            position += length;
+            anchor = position;
+
+            if (block.size() >= payloadSize)
+                return false;
+        }
+
+        appendLiterals(block, &window[0] + anchor, end - anchor, 0);
+        if (block.size() >= payloadSize)
+            return false;
+
+        output.insert(output.end(), block.begin(), block.end());
+        return true;
+    }
+
+    template<typename InputIterator>
+    inline bool Compression::decompress(InputIterator first, InputIterator last, ByteVector& output)
+    {
+        std::size_t const start = output.size();
+        while (first != last)
+        {
+            value_type const token = static_cast<value_type>(*first++);
+
+            std::size_t literalCount = (token >> 4);
+            if (literalCount == 15 && readLength(first, last, literalCount) == false)
+                return false;
+
+            for (/* Nothing */; literalCount > 0; --literalCount)
+            {
+                if (first == last)
+                    return false;
+
+                output.push_back(static_cast<value_type>(*first++));
+            }
+
+            // The last sequence of a block consists of literals only.
+            if (first == last)
+                break;
+
+            std::size_t offset = static_cast<value_type>(*first++);
+            if (first == last)
+                return false;
+
+            offset |= static_cast<std::size_t>(static_cast<value_type>(*first++)) << 8;
+
+            std::size_t length = (token & 0x0F);
+            if (length == 15 && readLength(first, last, length) == false)
+                return false;
+
+            length += MinimumMatch;
+
+            std::size_t const produced = output.size() - start;
+            if (offset == 0 || offset > produced + DictionarySize || produced + length > MaximumPayloadSize)
+                return false;
+
+            // A match may overlap the bytes it produces, so it is copied byte by byte.
+            for (std::size_t i = 0; i < length; ++i)
+            {
+                std::size_t const current = output.size() - start;
+                value_type const input = (offset > current)
+                    ? dictionaryBegin()[DictionarySize - (offset - current)]
+                    : output[output.size() - offset];
+
+                output.push_back(input);
+            }
+        }
+
+        return true;
+    }
+
+    inline std::size_t Compression::hash(ByteVector const& window, std::size_t position)
+    {
+        unsigned long const value = static_cast<unsigned long>(window[position])
+            | (static_cast<unsigned long>(window[position + 1]) << 8)
+            | (static_cast<unsigned long>(window[position + 2]) << 16)
+            | (static_cast<unsigned long>(window[position + 3]) << 24);
+
+        return static_cast<std::size_t>(((value * 2654435761UL) & 0xFFFFFFFFUL) >> (32 - HashBits));
+    }
+
+    inline void Compression::appendLength(ByteVector& output, std::size_t length)
+    {
+        for (/* Nothing */; length >= 255; length -= 255)
+            output.push_back(255);
+
+        output.push_back(static_cast<value_type>(length));
+    }
+
+    inline void Compression::appendLiterals(ByteVector& output, value_type const* literals, std::size_t literalCount, std::size_t matchLength)
+    {
+        std::size_t const matchCode = (matchLength > 0 ? matchLength - MinimumMatch : 0);
+        value_type const token = static_cast<value_type>(
+              ((literalCount < 15 ? literalCount : 15) << 4)
+            | (matchCode < 15 ? matchCode : 15));
+
+        output.push_back(token);
+
+        if (literalCount >= 15)
+            appendLength(output, literalCount - 15);
+
+        output.insert(output.end(), literals, literals + literalCount);
+    }
+
+    template<typename InputIterator>
+    inline bool Compression::readLength(InputIterator& first, InputIterator last, std::size_t& length)
+    {
+        value_type input = 255;
+        while (input == 255)
+        {
+            if (first == last)
+                return false;
+
+            input = static_cast<value_type>(*first++);
+            length += input;
+        }
+
+        return true;
+    }
+}
+
+//EndSimianIgnore
+
+#endif  // __LIBS101_COMPRESSION_HPP
@@ -0,0 +1,147 @@
+/*
+    libs101 -- C++ 03 implementation of the S101 encoding and decoding
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef __LIBS101_KEEPALIVE_HPP
+#define __LIBS101_KEEPALIVE_HPP
+
+#include <iterator>
+#include "CommandType.hpp"
+#include "MessageType.hpp"
+
+//SimianIgnore
+
+namespace libs101
+{
+    /**
+     * Provides the encoded keep-alive frames of slot 0. Since a keep-alive message
+     * has no payload, both frames are constant and can be written directly,
+     * without running a StreamEncoder for each request.
+     */
+    struct KeepAlive
+    {
+        typedef unsigned char value_type;
+        typedef value_type const* const_iterator;
+
+        enum
+        {
+            /** The number of bytes of the encoded keep-alive request. */
+            RequestSize = 8,
+
+            /** The number of bytes of the encoded keep-alive response. */
+            ResponseSize = 9
+        };
+
+        /**
+         * Returns the first byte of the encoded keep-alive request.
+         * @return The first byte of the encoded keep-alive request.
+         */
+        static const_iterator requestBegin()
+        {
+            static value_type const frame[RequestSize] =
+            {
+                0xFE, 0x00, 0x0E, 0x01, 0x01, 0x94, 0xE4, 0xFF
+            };
+
+            return frame;
+        }
+
+        /**
+         * Returns the byte one past the last byte of the encoded keep-alive request.
+         * @return The end of the encoded keep-alive request.
+         */
+        static const_iterator requestEnd()
+        {
+            return requestBegin() + RequestSize;
+        }
+
+        /**
+         * Returns the first byte of the encoded keep-alive response.
+         * @return The first byte of the encoded keep-alive response.
+         */
+        static const_iterator responseBegin()
+        {
+            // The high byte of the crc (0xFC) is escaped.
+            static value_type const frame[ResponseSize] =
+            {
+                0xFE, 0x00, 0x0E, 0x02, 0x01, 0xFD, 0xDC, 0xCE, 0xFF
+            };
+
+            return frame;
+        }
+
+        /**
+         * Returns the byte one past the last byte of the encoded keep-alive response.
+         * @return The end of the encoded keep-alive response.
+         */
+        static const_iterator responseEnd()
+        {
+            return responseBegin() + ResponseSize;
+        }
+
+        /**
+         * Tests whether a message that has been decoded by a StreamDecoder is a
+         * keep-alive request. Only the header bytes are inspected, so a transport
+         * can answer the request before the message is passed on to any EmBER
+         * processing.
+         * @param first The first byte of the decoded message.
+         * @param last The byte one past the last byte of the decoded message.
+         * @return true if the message is a keep-alive request.
+         */
+        template<typename InputIterator>
+        static bool isRequest(InputIterator first, InputIterator last)
+        {
+            return isCommand(first, last, CommandType::KeepAliveRequest);
+        }
+
+        /**
+         * Tests whether a message that has been decoded by a StreamDecoder is a
+         * keep-alive response.
+         * @see isRequest
+         */
+        template<typename InputIterator>
+        static bool isResponse(InputIterator first, InputIterator last)
+        {
+            return isCommand(first, last, CommandType::KeepAliveResponse);
+        }
+
+    private:
+        /**
+         * Tests whether the decoded message is an EmBER message with the passed command.
+         * @param first The first byte of the decoded message.
+         * @param last The byte one past the last byte of the decoded message.
+         * @param command The command to look for.
+         * @return true if the message contains the specified command.
+         */
+        template<typename InputIterator>
+        static bool isCommand(InputIterator first, InputIterator last, CommandType::_Domain command)
+        {
+            // Slot, message type, command and version
+            if (std::distance(first, last) < 4)
+                return false;
+
+            ++first;
+            if (static_cast<value_type>(*first++) != MessageType::EmBER)
+                return false;
+
+            return static_cast<value_type>(*first) == command;
+        }
+    };
+}
+
+#endif  // __LIBS101_KEEPALIVE_HPP
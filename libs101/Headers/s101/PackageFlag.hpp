@@ -31,7 +31,14 @@ namespace libs101
         {
             FirstPackage = 0x80,
             LastPackage = 0x40,
-            EmptyPackage = 0x20
+            EmptyPackage = 0x20,
+
+            /**
+             * The payload of the package has been compressed, see Compression.
+             * This flag may only be set if the remote host has announced
+             * Capabilities::Compression.
+             */
+            CompressedPackage = 0x10
         };
 
         typedef unsigned char value_type;
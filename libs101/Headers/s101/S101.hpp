@@ -26,9 +26,13 @@
 
 #include "Version.hpp"
 #include "Byte.hpp"
+#include "Capabilities.hpp"
 #include "CommandType.hpp"
+#include "Compression.hpp"
 #include "Dtd.hpp"
+#include "KeepAlive.hpp"
 #include "MessageType.hpp"
+#include "SlotDemultiplexer.hpp"
 #include "StreamDecoder.hpp"
 #include "StreamEncoder.hpp"
 #include "PackageFlag.hpp"
@@ -0,0 +1,213 @@
+/*
+    libs101 -- C++ 03 implementation of the S101 encoding and decoding
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+#ifndef __LIBS101_SLOTDEMULTIPLEXER_HPP
+#define __LIBS101_SLOTDEMULTIPLEXER_HPP
+
+#include <cstddef>
+
+namespace libs101
+{
+    /**
+     * Distributes the messages decoded from a single connection to independent
+     * sessions, depending on their slot. Every S101 message starts with a slot byte,
+     * so a gateway may serve many small providers over one connection instead of
+     * opening a connection, with its own socket buffers and keep-alive traffic, per
+     * provider. Each session keeps its own state, for example an ember reader, and
+     * answers with its own slot.
+     * The sessions are looked up in a table with one entry per slot, so dispatching
+     * a message does not depend on the number of attached sessions.
+     * @note The demultiplexer does not own the attached sessions.
+     * @param HandlerType The type of the sessions. A session must provide an
+     *      operator() that takes two iterators, which are passed the first byte of
+     *      the message, the slot, and the byte one past its last byte.
+     */
+    template<typename HandlerType>
+    class SlotDemultiplexer
+    {
+        public:
+            typedef unsigned char value_type;
+            typedef std::size_t size_type;
+            typedef HandlerType handler_type;
+
+            enum
+            {
+                /** The number of distinct slots. */
+                SlotCount = 256
+            };
+
+            /**
+             * A callback that can be passed to StreamDecoder::read, which copies
+             * its callback, and forwards each message to the demultiplexer.
+             */
+            class Forwarder
+            {
+                public:
+                    /**
+                     * Initializes a forwarder.
+                     * @param demultiplexer The demultiplexer to forward the messages to.
+                     */
+                    explicit Forwarder(SlotDemultiplexer& demultiplexer)
+                        : m_demultiplexer(&demultiplexer)
+                    {}
+
+                    /**
+                     * Forwards a decoded message to the demultiplexer.
+                     * @param first The first byte of the message, which is the slot.
+                     * @param last The byte one past the last byte of the message.
+                     */
+                    template<typename InputIterator>
+                    void operator()(InputIterator first, InputIterator last) const
+                    {
+                        m_demultiplexer->dispatch(first, last);
+                    }
+
+                private:
+                    SlotDemultiplexer* m_demultiplexer;
+            };
+
+        public:
+            /** Initializes a demultiplexer without any sessions. */
+            SlotDemultiplexer();
+
+            /**
+             * Attaches a session to a slot, replacing the session that has been
+             * attached to it before.
+             * @param slot The slot of the messages the session receives.
+             * @param handler The session to attach, or null to detach the current one.
+             * @return The session that has been attached to the slot before, or null.
+             */
+            handler_type* attach(value_type slot, handler_type* handler);
+
+            /**
+             * Detaches the session of a slot.
+             * @param slot The slot to detach the session from.
+             * @return The session that has been attached to the slot, or null.
+             */
+            handler_type* detach(value_type slot);
+
+            /**
+             * Returns the session attached to a slot.
+             * @param slot The slot to return the session of.
+             * @return The session attached to the slot, or null.
+             */
+            handler_type* handler(value_type slot) const;
+
+            /**
+             * Returns the number of slots a session is attached to.
+             * @return The number of slots a session is attached to.
+             */
+            size_type size() const;
+
+            /**
+             * Passes a decoded message to the session attached to its slot.
+             * @param first The first byte of the message, which is the slot.
+             * @param last The byte one past the last byte of the message.
+             * @return false if the message is empty or no session is attached to its
+             *      slot. The caller may answer the message itself in that case, for
+             *      example if it is a keep-alive request.
+             */
+            template<typename InputIterator>
+            bool dispatch(InputIterator first, InputIterator last) const;
+
+            /**
+             * Returns a callback that forwards the messages of a StreamDecoder to
+             * this demultiplexer.
+             * @return A callback that forwards messages to this demultiplexer.
+             */
+            Forwarder forwarder();
+
+        private:
+            /** Prohibits copying, since the forwarders refer to the instance. */
+            SlotDemultiplexer(SlotDemultiplexer const&);
+            SlotDemultiplexer& operator=(SlotDemultiplexer const&);
+
+        private:
+            handler_type* m_handlers[SlotCount];
+            size_type m_size;
+    };
+
+    /**************************************************************************
+     * Mandatory inline implementation                                        *
+     **************************************************************************/
+
+    template<typename HandlerType>
+    inline SlotDemultiplexer<HandlerType>::SlotDemultiplexer()
+        : m_size(0)
+    {
+        for (size_type i = 0; i < SlotCount; ++i)
+            m_handlers[i] = 0;
+    }
+
+    template<typename HandlerType>
+    inline typename SlotDemultiplexer<HandlerType>::handler_type* SlotDemultiplexer<HandlerType>::attach(value_type slot, handler_type* handler)
+    {
+        handler_type* const previous = m_handlers[slot];
+        m_handlers[slot] = handler;
+
+        if (previous == 0 && handler != 0)
+            ++m_size;
+        else if (previous != 0 && handler == 0)
+            --m_size;
+
+        return previous;
+    }
+
+    template<typename HandlerType>
+    inline typename SlotDemultiplexer<HandlerType>::handler_type* SlotDemultiplexer<HandlerType>::detach(value_type slot)
+    {
+        return attach(slot, 0);
+    }
+
+    template<typename HandlerType>
+    inline typename SlotDemultiplexer<HandlerType>::handler_type* SlotDemultiplexer<HandlerType>::handler(value_type slot) const
+    {
+        return m_handlers[slot];
+    }
+
+    template<typename HandlerType>
+    inline typename SlotDemultiplexer<HandlerType>::size_type SlotDemultiplexer<HandlerType>::size() const
+    {
+        return m_size;
+    }
+
+    template<typename HandlerType>
+    template<typename InputIterator>
+    inline bool SlotDemultiplexer<HandlerType>::dispatch(InputIterator first, InputIterator last) const
+    {
+        if (first == last)
+            return false;
+
+        handler_type* const handler = m_handlers[static_cast<value_type>(*first)];
+        if (handler == 0)
+            return false;
+
+        (*handler)(first, last);
+        return true;
+    }
+
+    template<typename HandlerType>
+    inline typename SlotDemultiplexer<HandlerType>::Forwarder SlotDemultiplexer<HandlerType>::forwarder()
+    {
+        return Forwarder(*this);
+    }
+}
+
+#endif  // __LIBS101_SLOTDEMULTIPLEXER_HPP
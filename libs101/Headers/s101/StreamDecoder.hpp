@@ -20,8 +20,10 @@
 #ifndef __LIBS101_STREAMDECODER_HPP
 #define __LIBS101_STREAMDECODER_HPP
 
+#include <deque>
 #include <vector>
 #include "Byte.hpp"
+#include "util/ByteScan.hpp"
 #include "util/Crc16.hpp"
 
 //SimianIgnore
@@ -30,13 +32,22 @@ namespace libs101
 {
     /**
      * Base class which decodes a S101 message.
+     * The buffer a message is decoded into retains its capacity across messages,
+     * reset never releases memory. A callback may take ownership of a decoded
+     * message by calling extract, in which case the decoder continues with a
+     * buffer from its free list. Buffers that are no longer needed can be
+     * handed back with recycle.
+     * A frame growing beyond the maximum frame size is dropped, so that a peer
+     * sending junk without an end of frame cannot grow the buffer without bound.
      */
     template<typename ValueType = unsigned char>
     class StreamDecoder
     {
         typedef std::vector<ValueType> ByteVector;
+        typedef std::deque<ByteVector> BufferPool;
 
     public:
+        typedef ByteVector buffer_type;
         typedef ValueType value_type;
         typedef typename ByteVector::iterator iterator;
         typedef typename ByteVector::const_iterator const_iterator;
@@ -46,6 +57,64 @@ namespace libs101
         typedef typename ByteVector::const_reference const_reference;
         typedef typename ByteVector::size_type size_type;
 
+        /**
+         * Stores the messages decoded from one or more input buffers back to back
+         * in a single buffer, so that they remain accessible after the decoder
+         * returns. Clearing a batch retains its capacity.
+         */
+        class FrameBatch
+        {
+            friend class StreamDecoder;
+        public:
+            typedef typename StreamDecoder::const_iterator const_iterator;
+            typedef typename StreamDecoder::size_type size_type;
+
+            /** Initializes an empty batch. */
+            FrameBatch();
+
+            /**
+             * Returns the number of frames stored in this batch.
+             * @return The number of frames stored in this batch.
+             */
+            size_type size() const;
+
+            /**
+             * Returns whether or not this batch contains any frames.
+             * @return true if this batch contains no frames.
+             */
+            bool empty() const;
+
+            /**
+             * Returns an iterator to the first byte of the frame at @p index.
+             * @param index The index of the frame.
+             * @return An iterator to the first byte of the frame.
+             */
+            const_iterator begin(size_type index) const;
+
+            /**
+             * Returns an iterator to the byte one past the last byte of the frame
+             * at @p index.
+             * @param index The index of the frame.
+             * @return An iterator one past the last byte of the frame.
+             */
+            const_iterator end(size_type index) const;
+
+            /** Removes all frames from this batch. */
+            void clear();
+
+        private:
+            /**
+             * Appends a frame to this batch.
+             * @param first The first byte of the decoded message.
+             * @param last The byte one past the last byte of the decoded message.
+             */
+            void append(const_iterator first, const_iterator last);
+
+        private:
+            ByteVector m_bytes;
+            std::vector<size_type> m_offsets;
+        };
+
         /** Constructor */
         StreamDecoder();
 
@@ -84,6 +153,48 @@ namespace libs101
         template<typename InputIterator, typename CallbackType>
         void read(InputIterator first, InputIterator last, CallbackType callback);
 
+        /**
+         * Reads the bytes of a contiguous buffer. Runs of bytes that neither
+         * delimit a frame nor are escaped are appended to the message and added
+         * to its crc in a single step.
+         * @see read(InputIterator, InputIterator, CallbackType, StateType)
+         */
+        template<typename CallbackType, typename StateType>
+        void read(value_type const* first, value_type const* last, CallbackType callback, StateType state);
+
+        /**
+         * Reads the bytes of a contiguous buffer.
+         * @see read(value_type const*, value_type const*, CallbackType, StateType)
+         */
+        template<typename CallbackType, typename StateType>
+        void read(value_type* first, value_type* last, CallbackType callback, StateType state);
+
+        /**
+         * Reads the bytes of a contiguous buffer.
+         * @see read(value_type const*, value_type const*, CallbackType, StateType)
+         */
+        template<typename CallbackType>
+        void read(value_type const* first, value_type const* last, CallbackType callback);
+
+        /**
+         * Reads the bytes of a contiguous buffer.
+         * @see read(value_type const*, value_type const*, CallbackType, StateType)
+         */
+        template<typename CallbackType>
+        void read(value_type* first, value_type* last, CallbackType callback);
+
+        /**
+         * Reads the bytes of the provided input buffer and appends all messages
+         * that are completed by them to @p batch, instead of invoking a callback
+         * for each of them.
+         * @param first First item of the buffer to decode the data from.
+         * @param last Last item of the buffer to decode the data from.
+         * @param batch The batch the decoded messages are appended to.
+         * @return The number of messages appended to @p batch.
+         */
+        template<typename InputIterator>
+        size_type readBatch(InputIterator first, InputIterator last, FrameBatch& batch);
+
         /**
          * Decodes a single byte. If this is the last byte of a S101 message
          * the provided callback function will be invoked.
@@ -110,9 +221,70 @@ namespace libs101
         template<typename InputType, typename CallbackType>
         void readByte(InputType input, CallbackType callback);
 
-        /** Resets the current decoding buffer. */
+        /** Resets the current decoding buffer. The capacity of the buffer is retained. */
         void reset();
 
+        /**
+         * Reserves memory for a decoded message of at least @p capacity bytes.
+         * @param capacity The number of bytes to reserve.
+         */
+        void reserve(size_type capacity);
+
+        /**
+         * Returns the number of bytes the current decoding buffer is able to
+         * store without reallocating.
+         * @return The capacity of the current decoding buffer.
+         */
+        size_type capacity() const;
+
+        /**
+         * Moves the message that is currently being reported to a callback into
+         * @p target, without copying it. The decoder continues with a buffer taken
+         * from the free list, or with the previous buffer of @p target if the
+         * free list is empty. This method may only be used while a callback is
+         * being invoked, afterwards the iterators passed to the callback are
+         * no longer valid.
+         * @param target The buffer that receives the decoded message, excluding
+         *      the crc.
+         * @return true if a message has been moved into @p target, false if no
+         *      callback is currently being invoked.
+         */
+        bool extract(buffer_type& target);
+
+        /**
+         * Adds a buffer that is no longer needed to the free list, so that it can
+         * be reused by a later call to extract. The buffer is left empty.
+         * @param buffer The buffer to hand back to the decoder.
+         */
+        void recycle(buffer_type& buffer);
+
+        /**
+         * Returns the number of buffers currently stored in the free list.
+         * @return The number of buffers in the free list.
+         */
+        size_type pooledBuffers() const;
+
+        /**
+         * Sets the maximum number of bytes a frame may decode to, including its crc.
+         * The bytes of a larger frame are discarded until the next start of a frame.
+         * @param size The maximum size of a decoded frame. By default, the size
+         *      is not limited.
+         */
+        void setMaximumFrameSize(size_type size);
+
+        /**
+         * Returns the maximum number of bytes a frame may decode to.
+         * @return The maximum size of a decoded frame.
+         */
+        size_type maximumFrameSize() const;
+
+        /**
+         * Returns the number of frames that have been dropped because they
+         * exceeded the maximum frame size.
+         * @return The number of dropped frames.
+         */
+        size_type droppedFrames() const;
+
     private:
         /** Resets the current decoding buffer.
          * @param frame Specifies whether a start byte has been received and
@@ -120,6 +292,9 @@ namespace libs101
          */
         void reset(bool frame);
 
+        /** Discards the frame currently being decoded, because it exceeds the maximum frame size. */
+        void dropFrame();
+
         /**
          * This static method is used to invoke a callback which doesn't have a state parameter.
          * @param first Start of the buffer containing a decoded S101 message.
@@ -129,21 +304,87 @@ namespace libs101
         template<typename CallbackType>
         static void invokeStatelessCallback(const_iterator first, const_iterator last, CallbackType callback);
 
+        /**
+         * Callback used by readBatch, appends a decoded message to a batch.
+         * @param first Start of the buffer containing a decoded S101 message.
+         * @param last End of the buffer.
+         * @param batch The batch to append the message to.
+         */
+        static void appendToBatch(const_iterator first, const_iterator last, FrameBatch* batch);
+
+        /**
+         * Returns the first byte within the provided buffer that has a special
+         * meaning in the S101 framing.
+         * @param first A pointer to the first byte to examine.
+         * @param last A pointer to the byte one past the last byte to examine.
+         * @return A pointer to the first special byte, or last if there is none.
+         */
+        static value_type const* findSpecialByte(value_type const* first, value_type const* last);
+
         ByteVector m_bytes;
+        BufferPool m_pool;
+        bool m_delivering;
         bool m_escape;
         bool m_frame;
         util::Crc16::value_type m_crc;
+        size_type m_maximumFrameSize;
+        size_type m_droppedFrames;
     };
 
     /**************************************************************************
      * Mandatory inline implementation                                        *
      **************************************************************************/
 
+    template<typename ValueType>
+    inline StreamDecoder<ValueType>::FrameBatch::FrameBatch()
+    {}
+
+    template<typename ValueType>
+    inline typename StreamDecoder<ValueType>::size_type StreamDecoder<ValueType>::FrameBatch::size() const
+    {
+        return m_offsets.size();
+    }
+
+    template<typename ValueType>
+    inline bool StreamDecoder<ValueType>::FrameBatch::empty() const
+    {
+        return m_offsets.empty();
+    }
+
+    template<typename ValueType>
+    inline typename StreamDecoder<ValueType>::const_iterator StreamDecoder<ValueType>::FrameBatch::begin(size_type index) const
+    {
+        return m_bytes.begin() + (index > 0 ? m_offsets[index - 1] : 0);
+    }
+
+    template<typename ValueType>
+    inline typename StreamDecoder<ValueType>::const_iterator StreamDecoder<ValueType>::FrameBatch::end(size_type index) const
+    {
+        return m_bytes.begin() + m_offsets[index];
+    }
+
+    template<typename ValueType>
+    inline void StreamDecoder<ValueType>::FrameBatch::clear()
+    {
+        m_bytes.clear();
+        m_offsets.clear();
+    }
+
+    template<typename ValueType>
+    inline void StreamDecoder<ValueType>::FrameBatch::append(const_iterator first, const_iterator last)
+    {
+        m_bytes.insert(m_bytes.end(), first, last);
+        m_offsets.push_back(m_bytes.size());
+    }
+
     template<typename ValueType>
     inline StreamDecoder<ValueType>::StreamDecoder()
-        : m_escape(false)
+        : m_delivering(false)
+        , m_escape(false)
         , m_frame(false)
         , m_crc(0xFFFF)
+        , m_maximumFrameSize(static_cast<size_type>(-1))
+        , m_droppedFrames(0)
     {}
 
     template<typename ValueType>
@@ -157,16 +398,103 @@ namespace libs101
         callback(first, last);
     }
 
+    template<typename ValueType>
+    inline void StreamDecoder<ValueType>::appendToBatch(const_iterator first, const_iterator last, FrameBatch* batch)
+    {
+        batch->append(first, last);
+    }
+
+    template<typename ValueType>
+    template<typename InputIterator>
+    inline typename StreamDecoder<ValueType>::size_type StreamDecoder<ValueType>::readBatch(InputIterator first, InputIterator last, FrameBatch& batch)
+    {
+        size_type const count = batch.size();
+        read(first, last, &StreamDecoder::appendToBatch, &batch);
+        return batch.size() - count;
+    }
+
     template<typename ValueType>
     inline void StreamDecoder<ValueType>::reset()
     {
         reset(false);
     }
 
+    template<typename ValueType>
+    inline void StreamDecoder<ValueType>::reserve(size_type capacity)
+    {
+        m_bytes.reserve(capacity);
+    }
+
+    template<typename ValueType>
+    inline typename StreamDecoder<ValueType>::size_type StreamDecoder<ValueType>::capacity() const
+    {
+        return m_bytes.capacity();
+    }
+
+    template<typename ValueType>
+    inline bool StreamDecoder<ValueType>::extract(buffer_type& target)
+    {
+        if (m_delivering == false)
+            return false;
+
+        m_bytes.resize(m_bytes.size() - 2);
+        m_bytes.swap(target);
+        m_bytes.clear();
+
+        if (m_bytes.capacity() == 0 && m_pool.empty() == false)
+        {
+            m_bytes.swap(m_pool.back());
+            m_pool.pop_back();
+        }
+
+        m_delivering = false;
+        return true;
+    }
+
+    template<typename ValueType>
+    inline void StreamDecoder<ValueType>::recycle(buffer_type& buffer)
+    {
+        m_pool.push_back(ByteVector());
+        m_pool.back().swap(buffer);
+        m_pool.back().clear();
+    }
+
+    template<typename ValueType>
+    inline typename StreamDecoder<ValueType>::size_type StreamDecoder<ValueType>::pooledBuffers() const
+    {
+        return m_pool.size();
+    }
+
+    template<typename ValueType>
+    inline void StreamDecoder<ValueType>::setMaximumFrameSize(size_type size)
+    {
+        m_maximumFrameSize = size;
+    }
+
+    template<typename ValueType>
+    inline typename StreamDecoder<ValueType>::size_type StreamDecoder<ValueType>::maximumFrameSize() const
+    {
+        return m_maximumFrameSize;
+    }
+
+    template<typename ValueType>
+    inline typename StreamDecoder<ValueType>::size_type StreamDecoder<ValueType>::droppedFrames() const
+    {
+        return m_droppedFrames;
+    }
+
+    template<typename ValueType>
+    inline void StreamDecoder<ValueType>::dropFrame()
+    {
+        ++m_droppedFrames;
+        reset(false);
+    }
+
     template<typename ValueType>
     inline void StreamDecoder<ValueType>::reset(bool frame)
     {
         m_bytes.clear();
+        m_delivering = false;
         m_escape = false;
         m_frame = frame;
         m_crc = 0xFFFF;
@@ -188,6 +516,66 @@ namespace libs101
             readByte(*first, callback);
     }
 
+    template<typename ValueType>
+    template<typename CallbackType, typename StateType>
+    inline void StreamDecoder<ValueType>::read(value_type const* first, value_type const* last, CallbackType callback, StateType state)
+    {
+        while (first != last)
+        {
+            if (m_frame && m_escape == false)
+            {
+                value_type const* const run = findSpecialByte(first, last);
+                if (run != first)
+                {
+                    if (static_cast<size_type>(run - first) > m_maximumFrameSize - m_bytes.size())
+                    {
+                        // the run does not contain a special byte, so the next frame starts behind it
+                        dropFrame();
+                        first = run;
+                        continue;
+                    }
+
+                    m_bytes.insert(m_bytes.end(), first, run);
+                    m_crc = util::Crc16::compute(m_crc, first, run);
+                    first = run;
+                    continue;
+                }
+            }
+
+            readByte(*first, callback, state);
+            ++first;
+        }
+    }
+
+    template<typename ValueType>
+    template<typename CallbackType, typename StateType>
+    inline void StreamDecoder<ValueType>::read(value_type* first, value_type* last, CallbackType callback, StateType state)
+    {
+        read(static_cast<value_type const*>(first), static_cast<value_type const*>(last), callback, state);
+    }
+
+    template<typename ValueType>
+    template<typename CallbackType>
+    inline void StreamDecoder<ValueType>::read(value_type const* first, value_type const* last, CallbackType callback)
+    {
+        typedef void (*CallbackBindType)(const_iterator, const_iterator, CallbackType);
+
+        read<CallbackBindType, CallbackType>(first, last, invokeStatelessCallback, callback);
+    }
+
+    template<typename ValueType>
+    template<typename CallbackType>
+    inline void StreamDecoder<ValueType>::read(value_type* first, value_type* last, CallbackType callback)
+    {
+        read(static_cast<value_type const*>(first), static_cast<value_type const*>(last), callback);
+    }
+
+    template<typename ValueType>
+    inline typename StreamDecoder<ValueType>::value_type const* StreamDecoder<ValueType>::findSpecialByte(value_type const* first, value_type const* last)
+    {
+        return util::ByteScan::findAtLeast(first, last, static_cast<value_type>(Byte::CE));
+    }
+
     template<typename ValueType>
     template<typename InputType, typename CallbackType>
     inline void StreamDecoder<ValueType>::readByte(InputType input, CallbackType callback)
@@ -213,7 +601,11 @@ namespace libs101
 
             case Byte::EoF:
                 if (m_crc == 0xF0B8 && m_bytes.size() > 1)
+                {
+                    m_delivering = true;
                     callback(m_bytes.begin(), m_bytes.end() - 2, state);
+                    m_delivering = false;
+                }
 
                 reset();
                 break;
@@ -230,6 +622,12 @@ namespace libs101
                     byte = byte ^ Byte::XOR;
                 }
 
+                if (m_bytes.size() >= m_maximumFrameSize)
+                {
+                    dropFrame();
+                    break;
+                }
+
                 m_bytes.push_back(byte);
                 m_crc = util::Crc16::add(m_crc, byte);
                 break;
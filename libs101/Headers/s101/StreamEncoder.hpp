@@ -20,8 +20,10 @@
 #ifndef __LIBS101_STREAMENCODER_HPP
 #define __LIBS101_STREAMENCODER_HPP
 
+#include <algorithm>
 #include <vector>
 #include "Byte.hpp"
+#include "util/ByteScan.hpp"
 #include "util/Crc16.hpp"
 
 //SimianIgnore
@@ -83,6 +85,21 @@ namespace libs101
             template<typename InputIterator>
             void encode(InputIterator first, InputIterator last);
 
+            /**
+             * Encodes the bytes of a contiguous buffer. The crc of the whole buffer
+             * is computed in a single step and runs of bytes that need no escaping
+             * are copied in bulk.
+             * @param first A pointer to the first byte to encode.
+             * @param last A pointer to the byte one past the last byte to encode.
+             */
+            void encode(value_type const* first, value_type const* last);
+
+            /**
+             * Encodes the bytes of a contiguous buffer.
+             * @see encode(value_type const*, value_type const*)
+             */
+            void encode(value_type* first, value_type* last);
+
             /**
              * Appends the crc and the EoF byte to the buffer. After calling
              * this method, the packet may be transmitted.
@@ -100,6 +117,57 @@ namespace libs101
              */
             bool isFinished() const;
 
+        public:
+            /**
+             * Returns the number of bytes a frame containing a message of @p messageSize
+             * bytes occupies at most, which is the case when all bytes of the message and
+             * of the crc have to be escaped.
+             * @param messageSize The number of bytes of the message, including the header.
+             * @return The maximum size of the encoded frame.
+             */
+            static size_type maximumFrameSize(size_type messageSize);
+
+            /**
+             * Computes the exact number of bytes of the frame encodeFrame() produces for a
+             * message consisting of a header and a payload. Since the escaping of the crc
+             * depends on its value, the crc is computed as well.
+             * @param headerFirst A pointer to the first byte of the header.
+             * @param headerLast A pointer to the byte one past the last byte of the header.
+             * @param first An iterator pointing to the first byte of the payload.
+             * @param last An iterator pointing one past the last byte of the payload.
+             * @return The size of the encoded frame.
+             */
+            template<typename InputIterator>
+            static size_type frameSize(value_type const* headerFirst, value_type const* headerLast, InputIterator first, InputIterator last);
+
+            /**
+             * Computes the exact size of a frame whose payload is a contiguous buffer.
+             * @see frameSize(value_type const*, value_type const*, InputIterator, InputIterator)
+             */
+            static size_type frameSize(value_type const* headerFirst, value_type const* headerLast, value_type* first, value_type* last);
+
+            /**
+             * Encodes a complete frame, consisting of the BoF byte, the escaped header and
+             * payload, the escaped crc and the EoF byte, directly into a buffer provided by
+             * the caller. Unlike the instance methods, this requires neither an internal
+             * buffer nor a copy of the encoded frame.
+             * @param headerFirst A pointer to the first byte of the header.
+             * @param headerLast A pointer to the byte one past the last byte of the header.
+             * @param first An iterator pointing to the first byte of the payload.
+             * @param last An iterator pointing one past the last byte of the payload.
+             * @param output The buffer to write the frame to. It must provide room for at
+             *      least frameSize() or maximumFrameSize() bytes.
+             * @return A pointer to the byte following the last byte of the written frame.
+             */
+            template<typename InputIterator>
+            static value_type* encodeFrame(value_type const* headerFirst, value_type const* headerLast, InputIterator first, InputIterator last, value_type* output);
+
+            /**
+             * Encodes a complete frame whose payload is a contiguous buffer.
+             * @see encodeFrame(value_type const*, value_type const*, InputIterator, InputIterator, value_type*)
+             */
+            static value_type* encodeFrame(value_type const* headerFirst, value_type const* headerLast, value_type* first, value_type* last, value_type* output);
+
         private:
             /**
              * Appends a single byte to the encoding buffer. 
@@ -107,6 +175,39 @@ namespace libs101
              */
             void append(value_type input);
 
+            /**
+             * Returns the number of bytes a sequence occupies once it has been escaped and
+             * adds the sequence to @p crc.
+             */
+            template<typename InputIterator>
+            static size_type escapedSize(InputIterator first, InputIterator last, util::Crc16::value_type& crc);
+
+            /**
+             * Returns the escaped size of a contiguous buffer, whose crc is computed in a
+             * single step and whose runs of bytes that need no escaping are skipped in bulk.
+             */
+            static size_type escapedSize(value_type const* first, value_type const* last, util::Crc16::value_type& crc);
+
+            /**
+             * Writes the escaped representation of a sequence to @p output and adds the
+             * sequence to @p crc.
+             * @return A pointer to the byte following the last written byte.
+             */
+            template<typename InputIterator>
+            static value_type* escape(InputIterator first, InputIterator last, util::Crc16::value_type& crc, value_type* output);
+
+            /**
+             * Writes the escaped representation of a contiguous buffer, copying runs of
+             * bytes that need no escaping in bulk.
+             */
+            static value_type* escape(value_type const* first, value_type const* last, util::Crc16::value_type& crc, value_type* output);
+
+            /**
+             * Writes the escaped representation of a single byte to @p output.
+             * @return A pointer to the byte following the last written byte.
+             */
+            static value_type* escape(value_type input, value_type* output);
+
         private:
             ByteVector m_bytes;
             util::Crc16::value_type m_crc;
@@ -193,6 +294,179 @@ namespace libs101
             encode(*first);
     }
 
+    template<typename ValueType>
+    inline void StreamEncoder<ValueType>::encode(value_type const* first, value_type const* last)
+    {
+        if (first == last)
+            return;
+
+        if (m_bytes.empty())
+        {
+            m_crc = 0xFFFF;
+            m_bytes.push_back(Byte::BoF);
+        }
+
+        m_crc = util::Crc16::compute(m_crc, first, last);
+
+        m_bytes.reserve(m_bytes.size() + (last - first));
+        while (first != last)
+        {
+            value_type const* const run = util::ByteScan::findAtLeast(first, last, static_cast<value_type>(Byte::Invalid));
+
+            m_bytes.insert(m_bytes.end(), first, run);
+            first = run;
+
+            if (first != last)
+            {
+                append(*first);
+                ++first;
+            }
+        }
+    }
+
+    template<typename ValueType>
+    inline void StreamEncoder<ValueType>::encode(value_type* first, value_type* last)
+    {
+        encode(static_cast<value_type const*>(first), static_cast<value_type const*>(last));
+    }
+
+    template<typename ValueType>
+    inline typename StreamEncoder<ValueType>::size_type StreamEncoder<ValueType>::maximumFrameSize(size_type messageSize)
+    {
+        // BoF, the escaped message, two escaped crc bytes and EoF
+        return 1 + 2 * messageSize + 4 + 1;
+    }
+
+    template<typename ValueType>
+    template<typename InputIterator>
+    inline typename StreamEncoder<ValueType>::size_type StreamEncoder<ValueType>::frameSize(value_type const* headerFirst, value_type const* headerLast, InputIterator first, InputIterator last)
+    {
+        util::Crc16::value_type crc = 0xFFFF;
+        size_type size = 1;
+        size += escapedSize(headerFirst, headerLast, crc);
+        size += escapedSize(first, last, crc);
+
+        crc = ~crc;
+        size += ((crc & 0xFF) >= Byte::Invalid) ? 2 : 1;
+        size += (((crc >> 8) & 0xFF) >= Byte::Invalid) ? 2 : 1;
+        return size + 1;
+    }
+
+    template<typename ValueType>
+    inline typename StreamEncoder<ValueType>::size_type StreamEncoder<ValueType>::frameSize(value_type const* headerFirst, value_type const* headerLast, value_type* first, value_type* last)
+    {
+        return frameSize(headerFirst, headerLast, static_cast<value_type const*>(first), static_cast<value_type const*>(last));
+    }
+
+    template<typename ValueType>
+    template<typename InputIterator>
+    inline typename StreamEncoder<ValueType>::value_type* StreamEncoder<ValueType>::encodeFrame(value_type const* headerFirst, value_type const* headerLast, InputIterator first, InputIterator last, value_type* output)
+    {
+        util::Crc16::value_type crc = 0xFFFF;
+        *output++ = Byte::BoF;
+        output = escape(headerFirst, headerLast, crc, output);
+        output = escape(first, last, crc, output);
+
+        crc = ~crc;
+        output = escape(static_cast<value_type>((crc >> 0) & 0xFF), output);
+        output = escape(static_cast<value_type>((crc >> 8) & 0xFF), output);
+        *output++ = Byte::EoF;
+        return output;
+    }
+
+    template<typename ValueType>
+    inline typename StreamEncoder<ValueType>::value_type* StreamEncoder<ValueType>::encodeFrame(value_type const* headerFirst, value_type const* headerLast, value_type* first, value_type* last, value_type* output)
+    {
+        return encodeFrame(headerFirst, headerLast, static_cast<value_type const*>(first), static_cast<value_type const*>(last), output);
+    }
+
+    template<typename ValueType>
+    template<typename InputIterator>
+    inline typename StreamEncoder<ValueType>::size_type StreamEncoder<ValueType>::escapedSize(InputIterator first, InputIterator last, util::Crc16::value_type& crc)
+    {
+        size_type size = 0;
+        for (; first != last; ++first)
+        {
+            value_type const input = *first;
+            crc = util::Crc16::add(crc, input);
+            size += (input >= Byte::Invalid) ? 2 : 1;
+        }
+        return size;
+    }
+
+    template<typename ValueType>
+    inline typename StreamEncoder<ValueType>::size_type StreamEncoder<ValueType>::escapedSize(value_type const* first, value_type const* last, util::Crc16::value_type& crc)
+    {
+        if (first == last)
+            return 0;
+
+        crc = util::Crc16::compute(crc, first, last);
+
+        size_type size = last - first;
+        for (;;)
+        {
+            first = util::ByteScan::findAtLeast(first, last, static_cast<value_type>(Byte::Invalid));
+            if (first == last)
+                break;
+
+            ++size;
+            ++first;
+        }
+        return size;
+    }
+
+    template<typename ValueType>
+    template<typename InputIterator>
+    inline typename StreamEncoder<ValueType>::value_type* StreamEncoder<ValueType>::escape(InputIterator first, InputIterator last, util::Crc16::value_type& crc, value_type* output)
+    {
+        for (; first != last; ++first)
+        {
+            value_type const input = *first;
+            crc = util::Crc16::add(crc, input);
+            output = escape(input, output);
+        }
+        return output;
+    }
+
+    template<typename ValueType>
+    inline typename StreamEncoder<ValueType>::value_type* StreamEncoder<ValueType>::escape(value_type const* first, value_type const* last, util::Crc16::value_type& crc, value_type* output)
+    {
+        if (first == last)
+            return output;
+
+        crc = util::Crc16::compute(crc, first, last);
+
+        while (first != last)
+        {
+            value_type const* const run = util::ByteScan::findAtLeast(first, last, static_cast<value_type>(Byte::Invalid));
+
+            output = std::copy(first, run, output);
+            first = run;
+
+            if (first != last)
+            {
+                output = escape(*first, output);
+                ++first;
+            }
+        }
+        return output;
+    }
+
+    template<typename ValueType>
+    inline typename StreamEncoder<ValueType>::value_type* StreamEncoder<ValueType>::escape(value_type input, value_type* output)
+    {
+        if (input >= Byte::Invalid)
+        {
+            *output++ = Byte::CE;
+            *output++ = input ^ Byte::XOR;
+        }
+        else
+        {
+            *output++ = input;
+        }
+        return output;
+    }
+
     template<typename ValueType>
     inline void StreamEncoder<ValueType>::append(value_type input)
     {
@@ -0,0 +1,825 @@
+/*
+    libs101 -- C++ 03 implementation of the S101 encoding and decoding
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef __LIBS101_NET_EPOLLSERVER_HPP
+#define __LIBS101_NET_EPOLLSERVER_HPP
+
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "../KeepAlive.hpp"
+#include "../StreamDecoder.hpp"
+#include "../util/TimerWheel.hpp"
+
+namespace libs101 { namespace net
+{
+    /**
+     * A headless TCP server for Linux that serves many S101 connections from a
+     * single thread. All sockets are non-blocking and registered edge-triggered
+     * with one epoll instance, so a pass of the event loop costs one epoll_wait
+     * call plus the reads and writes that actually transfer data.
+     * Frames written to a connection are collected in its output buffer and
+     * transmitted once at the end of the pass, no matter how many frames were
+     * written. Keep-alive requests are answered by the server itself, idle
+     * connections are probed with keep-alive requests and closed if they don't
+     * respond. The keep-alive supervision of each connection is a timer on the
+     * server's TimerWheel, which the application may use for its own timeouts.
+     * @note The server is not thread-safe, all methods must be called from the
+     *      thread which runs the event loop.
+     */
+    class EpollServer
+    {
+        public:
+            typedef StreamDecoder<unsigned char> Decoder;
+            typedef Decoder::const_iterator const_iterator;
+            typedef std::vector<unsigned char>::size_type size_type;
+
+            class Connection;
+
+            /**
+             * Interface which receives the events of the connections served by
+             * an EpollServer.
+             */
+            class Handler
+            {
+                public:
+                    /** Destructor */
+                    virtual ~Handler()
+                    {}
+
+                    /**
+                     * Called when a new consumer has connected.
+                     * @param connection The new connection.
+                     */
+                    virtual void connected(Connection& connection) = 0;
+
+                    /**
+                     * Called for each S101 message received, except keep-alive requests
+                     * and responses, which are handled by the server.
+                     * @param connection The connection the message has been received from.
+                     * @param first The first byte of the decoded message, which is the slot.
+                     * @param last The byte one past the last byte of the decoded message.
+                     */
+                    virtual void messageReceived(Connection& connection, const_iterator first, const_iterator last) = 0;
+
+                    /**
+                     * Called when a connection has been closed, either by the peer or
+                     * by the server. The connection is destroyed afterwards.
+                     * @param connection The closed connection.
+                     */
+                    virtual void disconnected(Connection& connection) = 0;
+            };
+
+            /**
+             * A single consumer connection.
+             */
+            class Connection
+            {
+                friend class EpollServer;
+                public:
+                    /**
+                     * Returns the socket descriptor of this connection.
+                     * @return The socket descriptor of this connection.
+                     */
+                    int descriptor() const;
+
+                    /**
+                     * Appends the passed encoded S101 frames to the output buffer. The
+                     * buffer is transmitted at the end of the current pass of the event
+                     * loop, or with the next call to EpollServer::flush.
+                     * @param first An iterator to the first byte to send.
+                     * @param last An iterator one past the last byte to send.
+                     */
+                    template<typename InputIterator>
+                    void write(InputIterator first, InputIterator last);
+
+                    /**
+                     * Returns the number of bytes that have been written but not yet
+                     * been accepted by the socket.
+                     * @return The number of pending bytes.
+                     */
+                    size_type pendingBytes() const;
+
+                    /**
+                     * Closes this connection at the end of the current pass of the event
+                     * loop, after its pending output has been handed to the socket.
+                     */
+                    void close();
+
+                    /**
+                     * Returns the user state associated with this connection.
+                     * @return The user state, which is null until setState is called.
+                     */
+                    void* state() const;
+
+                    /**
+                     * Associates a user state with this connection.
+                     * @param state The state to store.
+                     */
+                    void setState(void* state);
+
+                private:
+                    /**
+                     * Initializes a new connection.
+                     * @param server The server the connection belongs to.
+                     * @param descriptor The socket descriptor of the accepted connection.
+                     * @param now The current time in milliseconds.
+                     */
+                    Connection(EpollServer& server, int descriptor, long now);
+
+                    /** Closes the socket descriptor. */
+                    ~Connection();
+
+                    /**
+                     * Writes as much of the output buffer as the socket accepts.
+                     * @return false if the socket reported an error.
+                     */
+                    bool flush();
+
+                    /** Prohibit copy construction */
+                    Connection(Connection const&);
+
+                    /** Prohibit assignment */
+                    Connection& operator=(Connection const&);
+
+                    /**
+                     * The timer which supervises the keep-alive of a connection.
+                     */
+                    class KeepAliveTimer : public util::TimerWheel::Timer
+                    {
+                        public:
+                            /**
+                             * Initializes the timer of @p connection.
+                             * @param connection The connection to supervise.
+                             */
+                            explicit KeepAliveTimer(Connection& connection);
+
+                        protected:
+                            /** @see util::TimerWheel::Timer::expired */
+                            virtual void expired(util::TimerWheel& wheel);
+
+                        private:
+                            Connection& m_connection;
+                    };
+
+                private:
+                    EpollServer& m_server;
+                    int m_descriptor;
+                    Decoder m_decoder;
+                    std::vector<unsigned char> m_output;
+                    size_type m_outputOffset;
+                    long m_lastReceiveTime;
+                    bool m_isKeepAlivePending;
+                    bool m_isDirty;
+                    bool m_isClosing;
+                    void* m_state;
+                    KeepAliveTimer m_keepAliveTimer;
+            };
+
+        public:
+            /**
+             * Initializes a new server which reports its events to @p handler.
+             * @param handler The handler receiving the events of all connections.
+             * @throws std::runtime_error if the epoll instance cannot be created.
+             */
+            explicit EpollServer(Handler& handler);
+
+            /** Closes all connections and the listening socket. */
+            ~EpollServer();
+
+            /**
+             * Starts listening for incoming connections on the passed port of all
+             * local IPv4 interfaces.
+             * @param port The port to listen on.
+             * @throws std::runtime_error if the socket cannot be bound.
+             */
+            void listen(unsigned short port);
+
+            /**
+             * Sets the interval after which an idle connection receives a keep-alive
+             * request. A connection which doesn't send any message within another
+             * interval is closed.
+             * @param milliseconds The interval in milliseconds, 0 disables the
+             *      keep-alive supervision. The default is 0.
+             */
+            void setKeepAliveInterval(long milliseconds);
+
+            /**
+             * Returns the timer wheel of the server, which is advanced by each pass
+             * of the event loop. One tick is a millisecond of the monotonic clock,
+             * and the event loop doesn't wait longer than the wheel permits.
+             * Timers scheduled on it are called from within poll.
+             * @return The timer wheel of the server.
+             */
+            util::TimerWheel& timers();
+
+            /**
+             * Runs a single pass of the event loop. Waits for at most @p timeout
+             * milliseconds for socket events, handles them and transmits the output
+             * of all connections that have been written to.
+             * @param timeout The maximum time to wait in milliseconds, -1 waits
+             *      infinitely unless timers are scheduled on the timer wheel.
+             * @return The number of socket events handled.
+             * @throws std::runtime_error if epoll_wait fails.
+             */
+            int poll(int timeout);
+
+            /**
+             * Runs the event loop until stop is called.
+             */
+            void run();
+
+            /**
+             * Makes run return after the current pass of the event loop.
+             */
+            void stop();
+
+            /**
+             * Transmits the output of all connections that have been written to
+             * outside of the event loop.
+             */
+            void flush();
+
+            /**
+             * Appends the passed encoded S101 frames to the output buffer of each
+             * connection.
+             * @param first An iterator to the first byte to send.
+             * @param last An iterator one past the last byte to send.
+             */
+            template<typename InputIterator>
+            void broadcast(InputIterator first, InputIterator last);
+
+            /**
+             * Returns the number of open connections.
+             * @return The number of open connections.
+             */
+            size_type size() const;
+
+        private:
+            typedef std::map<int, Connection*> ConnectionMap;
+            typedef std::vector<Connection*> ConnectionVector;
+
+            enum
+            {
+                MaximumEvents = 64,
+                ReceiveBufferSize = 64 * 1024
+            };
+
+            /** Accepts all pending connections of the listening socket. */
+            void acceptConnections();
+
+            /**
+             * Reads all data available on the socket of @p connection. Since the
+             * socket is registered edge-triggered, it is read until it would block.
+             * @param connection The connection to read from.
+             */
+            void receive(Connection& connection);
+
+            /**
+             * Sends a keep-alive request to @p connection if it has been idle for
+             * the keep-alive interval, or closes it if it didn't answer the previous
+             * request. Called when the keep-alive timer of the connection expires.
+             * @param connection The connection to supervise.
+             */
+            void superviseKeepAlive(Connection& connection);
+
+            /**
+             * Marks @p connection as written to, so that its output is transmitted
+             * by the next flush.
+             * @param connection The connection which has been written to.
+             */
+            void markDirty(Connection& connection);
+
+            /**
+             * Stops serving @p connection at the end of the current pass.
+             * @param connection The connection to close.
+             */
+            void markClosing(Connection& connection);
+
+            /** Destroys all connections that have been marked for closing. */
+            void reapConnections();
+
+            /**
+             * Handles a message decoded by the StreamDecoder of a connection.
+             * @param first The first byte of the decoded message.
+             * @param last The byte one past the last byte of the decoded message.
+             * @param connection The connection the message has been received from.
+             */
+            static void dispatch(const_iterator first, const_iterator last, Connection* connection);
+
+            /**
+             * Returns the value of the monotonic clock in ticks of the timer wheel.
+             * @return The current tick.
+             */
+            static util::TimerWheel::tick_type currentTick();
+
+            /**
+             * Returns the value of the monotonic clock in milliseconds.
+             * @return The current time in milliseconds.
+             */
+            static long monotonicTime();
+
+            /**
+             * Throws a runtime_error containing @p what and the description of errno.
+             * @param what The operation that failed.
+             */
+            static void throwSystemError(char const* what);
+
+            /** Prohibit copy construction */
+            EpollServer(EpollServer const&);
+
+            /** Prohibit assignment */
+            EpollServer& operator=(EpollServer const&);
+
+        private:
+            Handler& m_handler;
+            int m_epoll;
+            int m_listener;
+            ConnectionMap m_connections;
+            ConnectionVector m_dirty;
+            ConnectionVector m_closing;
+            std::vector<unsigned char> m_receiveBuffer;
+            util::TimerWheel m_timers;
+            long m_keepAliveInterval;
+            bool m_isRunning;
+    };
+
+    /**************************************************************************
+     * Mandatory inline implementation                                        *
+     **************************************************************************/
+
+    inline EpollServer::Connection::Connection(EpollServer& server, int descriptor, long now)
+        : m_server(server)
+        , m_descriptor(descriptor)
+        , m_outputOffset(0)
+        , m_lastReceiveTime(now)
+        , m_isKeepAlivePending(false)
+        , m_isDirty(false)
+        , m_isClosing(false)
+        , m_state(0)
+        , m_keepAliveTimer(*this)
+    {}
+
+    inline EpollServer::Connection::~Connection()
+    {
+        ::close(m_descriptor);
+    }
+
+    inline int EpollServer::Connection::descriptor() const
+    {
+        return m_descriptor;
+    }
+
+    template<typename InputIterator>
+    inline void EpollServer::Connection::write(InputIterator first, InputIterator last)
+    {
+        if (m_isClosing == false)
+        {
+            m_output.insert(m_output.end(), first, last);
+            m_server.markDirty(*this);
+        }
+    }
+
+    inline EpollServer::size_type EpollServer::Connection::pendingBytes() const
+    {
+        return m_output.size() - m_outputOffset;
+    }
+
+    inline void EpollServer::Connection::close()
+    {
+        m_server.markClosing(*this);
+    }
+
+    inline void* EpollServer::Connection::state() const
+    {
+        return m_state;
+    }
+
+    inline void EpollServer::Connection::setState(void* state)
+    {
+        m_state = state;
+    }
+
+    inline bool EpollServer::Connection::flush()
+    {
+        while (m_outputOffset < m_output.size())
+        {
+            ssize_t const result = ::send(m_descriptor, &m_output[m_outputOffset], m_output.size() - m_outputOffset, MSG_NOSIGNAL);
+            if (result < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+
+                // The socket signals EPOLLOUT when it accepts more data.
+                return errno == EAGAIN || errno == EWOULDBLOCK;
+            }
+
+            m_outputOffset += static_cast<size_type>(result);
+        }
+
+        // Keep the capacity of the buffer for the next frames.
+        m_output.clear();
+        m_outputOffset = 0;
+        return true;
+    }
+
+    inline EpollServer::Connection::KeepAliveTimer::KeepAliveTimer(Connection& connection)
+        : m_connection(connection)
+    {}
+
+    inline void EpollServer::Connection::KeepAliveTimer::expired(util::TimerWheel&)
+    {
+        m_connection.m_server.superviseKeepAlive(m_connection);
+    }
+
+
+    inline EpollServer::EpollServer(Handler& handler)
+        : m_handler(handler)
+        , m_epoll(::epoll_create1(EPOLL_CLOEXEC))
+        , m_listener(-1)
+        , m_receiveBuffer(ReceiveBufferSize)
+        , m_timers(currentTick())
+        , m_keepAliveInterval(0)
+        , m_isRunning(false)
+    {
+        if (m_epoll < 0)
+            throwSystemError("epoll_create1");
+    }
+
+    inline EpollServer::~EpollServer()
+    {
+        ConnectionMap::iterator const last = m_connections.end();
+        for (ConnectionMap::iterator it = m_connections.begin(); it != last; ++it)
+            delete it->second;
+
+        if (m_listener >= 0)
+            ::close(m_listener);
+
+        ::close(m_epoll);
+    }
+
+    inline void EpollServer::listen(unsigned short port)
+    {
+        int const listener = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (listener < 0)
+            throwSystemError("socket");
+
+        int const enable = 1;
+        ::setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+
+        sockaddr_in address;
+        std::memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_ANY);
+        address.sin_port = htons(port);
+
+        if (::bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0
+        ||  ::listen(listener, SOMAXCONN) < 0)
+        {
+            int const error = errno;
+            ::close(listener);
+            errno = error;
+            throwSystemError("bind");
+        }
+
+        epoll_event event;
+        std::memset(&event, 0, sizeof(event));
+        event.events = EPOLLIN;
+        event.data.ptr = 0;
+
+        if (::epoll_ctl(m_epoll, EPOLL_CTL_ADD, listener, &event) < 0)
+        {
+            int const error = errno;
+            ::close(listener);
+            errno = error;
+            throwSystemError("epoll_ctl");
+        }
+
+        if (m_listener >= 0)
+            ::close(m_listener);
+
+        m_listener = listener;
+    }
+
+    inline void EpollServer::setKeepAliveInterval(long milliseconds)
+    {
+        long const now = monotonicTime();
+        m_keepAliveInterval = milliseconds;
+
+        ConnectionMap::iterator const last = m_connections.end();
+        for (ConnectionMap::iterator it = m_connections.begin(); it != last; ++it)
+        {
+            Connection& connection = *it->second;
+            connection.m_lastReceiveTime = now;
+            connection.m_isKeepAlivePending = false;
+
+            if (milliseconds > 0)
+                m_timers.schedule(connection.m_keepAliveTimer, currentTick() + static_cast<util::TimerWheel::tick_type>(milliseconds));
+            else
+                m_timers.cancel(connection.m_keepAliveTimer);
+        }
+    }
+
+    inline util::TimerWheel& EpollServer::timers()
+    {
+        return m_timers;
+    }
+
+    inline int EpollServer::poll(int timeout)
+    {
+        if (m_timers.empty() == false)
+        {
+            // The wheel's idle ticks are counted from the first tick it hasn't processed.
+            long const elapsed = static_cast<long>(currentTick() - m_timers.now());
+            long const remaining = static_cast<long>(m_timers.idleTicks()) - elapsed;
+            int const limit = remaining > 0 ? static_cast<int>(remaining) : 0;
+
+            if (timeout < 0 || timeout > limit)
+                timeout = limit;
+        }
+
+        epoll_event events[MaximumEvents];
+        int const count = ::epoll_wait(m_epoll, events, MaximumEvents, timeout);
+        if (count < 0)
+        {
+            if (errno == EINTR)
+                return 0;
+
+            throwSystemError("epoll_wait");
+        }
+
+        for (int index = 0; index < count; ++index)
+        {
+            epoll_event const& event = events[index];
+            Connection* const connection = static_cast<Connection*>(event.data.ptr);
+
+            if (connection == 0)
+            {
+                acceptConnections();
+            }
+            else if (connection->m_isClosing == false)
+            {
+                if (event.events & EPOLLIN)
+                    receive(*connection);
+
+                if (event.events & (EPOLLERR | EPOLLHUP))
+                    markClosing(*connection);
+                else if (event.events & EPOLLOUT)
+                    markDirty(*connection);
+            }
+        }
+
+        m_timers.advance(currentTick());
+
+        flush();
+        return count;
+    }
+
+    inline void EpollServer::run()
+    {
+        m_isRunning = true;
+
+        while (m_isRunning)
+            poll(-1);
+    }
+
+    inline void EpollServer::stop()
+    {
+        m_isRunning = false;
+    }
+
+    inline void EpollServer::flush()
+    {
+        ConnectionVector dirty;
+        dirty.swap(m_dirty);
+
+        ConnectionVector::iterator const last = dirty.end();
+        for (ConnectionVector::iterator it = dirty.begin(); it != last; ++it)
+        {
+            Connection* const connection = *it;
+            connection->m_isDirty = false;
+
+            if (connection->flush() == false)
+                markClosing(*connection);
+        }
+
+        // Reuse the capacity of the vector within the next pass.
+        dirty.clear();
+        if (m_dirty.empty())
+            m_dirty.swap(dirty);
+
+        reapConnections();
+    }
+
+    template<typename InputIterator>
+    inline void EpollServer::broadcast(InputIterator first, InputIterator last)
+    {
+        ConnectionMap::iterator const end = m_connections.end();
+        for (ConnectionMap::iterator it = m_connections.begin(); it != end; ++it)
+            it->second->write(first, last);
+    }
+
+    inline EpollServer::size_type EpollServer::size() const
+    {
+        return m_connections.size();
+    }
+
+    inline void EpollServer::acceptConnections()
+    {
+        for (;;)
+        {
+            int const descriptor = ::accept4(m_listener, 0, 0, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (descriptor < 0)
+            {
+                if (errno == EINTR || errno == ECONNABORTED)
+                    continue;
+
+                // EAGAIN once all pending connections have been accepted. Other
+                // errors, like running out of descriptors, are retried with the
+                // next event of the listening socket.
+                return;
+            }
+
+            int const enable = 1;
+            ::setsockopt(descriptor, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+
+            Connection* const connection = new Connection(*this, descriptor, monotonicTime());
+
+            epoll_event event;
+            std::memset(&event, 0, sizeof(event));
+            event.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+            event.data.ptr = connection;
+
+            if (::epoll_ctl(m_epoll, EPOLL_CTL_ADD, descriptor, &event) < 0)
+            {
+                delete connection;
+                continue;
+            }
+
+            m_connections.insert(std::make_pair(descriptor, connection));
+
+            if (m_keepAliveInterval > 0)
+                m_timers.schedule(connection->m_keepAliveTimer, currentTick() + static_cast<util::TimerWheel::tick_type>(m_keepAliveInterval));
+
+            m_handler.connected(*connection);
+        }
+    }
+
+    inline void EpollServer::receive(Connection& connection)
+    {
+        unsigned char* const buffer = &m_receiveBuffer[0];
+
+        while (connection.m_isClosing == false)
+        {
+            ssize_t const result = ::recv(connection.m_descriptor, buffer, m_receiveBuffer.size(), 0);
+            if (result > 0)
+            {
+                connection.m_lastReceiveTime = monotonicTime();
+                connection.m_isKeepAlivePending = false;
+                connection.m_decoder.read(static_cast<unsigned char const*>(buffer), buffer + result, &EpollServer::dispatch, &connection);
+
+                if (static_cast<size_type>(result) < m_receiveBuffer.size())
+                    return;
+            }
+            else if (result == 0)
+            {
+                markClosing(connection);
+            }
+            else if (errno != EINTR)
+            {
+                if (errno != EAGAIN && errno != EWOULDBLOCK)
+                    markClosing(connection);
+
+                return;
+            }
+        }
+    }
+
+    inline void EpollServer::superviseKeepAlive(Connection& connection)
+    {
+        if (connection.m_isClosing || m_keepAliveInterval <= 0)
+            return;
+
+        // Receiving doesn't touch the timer, it is moved here to the interval's
+        // end after the last receive instead.
+        long const now = monotonicTime();
+        long const idle = now - connection.m_lastReceiveTime;
+
+        if (idle < m_keepAliveInterval)
+        {
+            m_timers.schedule(connection.m_keepAliveTimer, static_cast<util::TimerWheel::tick_type>(now + m_keepAliveInterval - idle));
+        }
+        else if (connection.m_isKeepAlivePending)
+        {
+            markClosing(connection);
+        }
+        else
+        {
+            connection.m_isKeepAlivePending = true;
+            connection.m_lastReceiveTime = now;
+            connection.write(KeepAlive::requestBegin(), KeepAlive::requestEnd());
+            m_timers.schedule(connection.m_keepAliveTimer, static_cast<util::TimerWheel::tick_type>(now + m_keepAliveInterval));
+        }
+    }
+
+    inline void EpollServer::markDirty(Connection& connection)
+    {
+        if (connection.m_isDirty == false)
+        {
+            connection.m_isDirty = true;
+            m_dirty.push_back(&connection);
+        }
+    }
+
+    inline void EpollServer::markClosing(Connection& connection)
+    {
+        if (connection.m_isClosing == false)
+        {
+            connection.m_isClosing = true;
+            m_closing.push_back(&connection);
+        }
+    }
+
+    inline void EpollServer::reapConnections()
+    {
+        while (m_closing.empty() == false)
+        {
+            Connection* const connection = m_closing.back();
+            m_closing.pop_back();
+
+            if (connection->m_isDirty)
+            {
+                ConnectionVector::iterator const last = m_dirty.end();
+                for (ConnectionVector::iterator it = m_dirty.begin(); it != last; ++it)
+                {
+                    if (*it == connection)
+                    {
+                        m_dirty.erase(it);
+                        break;
+                    }
+                }
+
+                connection->flush();
+            }
+
+            m_connections.erase(connection->m_descriptor);
+            ::epoll_ctl(m_epoll, EPOLL_CTL_DEL, connection->m_descriptor, 0);
+            m_handler.disconnected(*connection);
+            delete connection;
+        }
+    }
+
+    inline void EpollServer::dispatch(const_iterator first, const_iterator last, Connection* connection)
+    {
+        if (KeepAlive::isRequest(first, last))
+            connection->write(KeepAlive::responseBegin(), KeepAlive::responseEnd());
+        else if (KeepAlive::isResponse(first, last) == false)
+            connection->m_server.m_handler.messageReceived(*connection, first, last);
+    }
+
+    inline util::TimerWheel::tick_type EpollServer::currentTick()
+    {
+        return static_cast<util::TimerWheel::tick_type>(monotonicTime());
+    }
+
+    inline long EpollServer::monotonicTime()
+    {
+        timespec now;
+        ::clock_gettime(CLOCK_MONOTONIC, &now);
+        return static_cast<long>(now.tv_sec) * 1000 + now.tv_nsec / 1000000;
+    }
+
+    inline void EpollServer::throwSystemError(char const* what)
+    {
+        throw std::runtime_error(std::string(what) + ": " + std::strerror(errno));
+    }
+}
+}
+
+#endif  // __LIBS101_NET_EPOLLSERVER_HPP
@@ -0,0 +1,495 @@
+/*
+    libs101 -- C++ 03 implementation of the S101 encoding and decoding
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef __LIBS101_NET_SHAREDMEMORYRING_HPP
+#define __LIBS101_NET_SHAREDMEMORYRING_HPP
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <semaphore.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace libs101 { namespace net
+{
+    /**
+     * A single-producer single-consumer ring of messages in a POSIX shared memory
+     * segment, which lets a provider serve consumers running on the same Linux host
+     * without TCP, S101 framing and CRC. The provider creates one ring per local
+     * consumer and writes the same unframed messages the StreamDecoder would deliver,
+     * starting with the slot byte. The consumer reads them with the callback it would
+     * pass to StreamDecoder::read, so the rest of its decode pipeline stays unchanged.
+     * A message is copied once, into the ring, and the consumer receives a pointer
+     * into the shared segment unless the message wraps around its end.
+     * The producer posts a process-shared semaphore after each write, the consumer
+     * may block on it with wait().
+     * @note Exactly one process or thread may write and exactly one may read. Both
+     *      must use the same data model, since the header stores native sizes.
+     *      Programs using this class link with -pthread, and with -lrt for glibc
+     *      versions before 2.17.
+     */
+    class SharedMemoryRing
+    {
+        public:
+            typedef unsigned char value_type;
+            typedef value_type const* const_iterator;
+            typedef std::size_t size_type;
+
+        public:
+            /**
+             * Creates a new ring, replacing a stale segment with the same name.
+             * @param name The name of the shared memory object, which must start
+             *      with a slash, for example "/tinyember-consumer-1".
+             * @param capacity The number of bytes the ring can hold, which is rounded up
+             *      to a power of two. Each message occupies four additional bytes for
+             *      its length.
+             * @throws std::runtime_error if the segment cannot be created.
+             */
+            SharedMemoryRing(std::string const& name, size_type capacity);
+
+            /**
+             * Opens a ring that has been created by another process.
+             * @param name The name of the shared memory object.
+             * @throws std::runtime_error if the segment does not exist or does
+             *      not contain a ring.
+             */
+            explicit SharedMemoryRing(std::string const& name);
+
+            /** Unmaps the segment. The creator also removes its name. */
+            ~SharedMemoryRing();
+
+            /**
+             * Returns the name of the shared memory object.
+             * @return The name of the shared memory object.
+             */
+            std::string const& name() const;
+
+            /**
+             * Returns the number of bytes the ring can hold.
+             * @return The capacity of the ring.
+             */
+            size_type capacity() const;
+
+            /**
+             * Returns the number of bytes the producer may currently write, including
+             * the length prefixes of the messages.
+             * @return The number of free bytes.
+             */
+            size_type available() const;
+
+            /**
+             * Appends a message to the ring and signals the consumer. The message is
+             * either written completely or not at all.
+             * @param first An iterator to the first byte of the message.
+             * @param last An iterator one past the last byte of the message.
+             * @return false if the ring doesn't have enough free space, because the
+             *      consumer doesn't keep up.
+             */
+            template<typename InputIterator>
+            bool write(InputIterator first, InputIterator last);
+
+            /**
+             * Passes all messages that are currently in the ring to @p callback,
+             * which is invoked as callback(first, last, state) with const_iterator
+             * arguments, and releases their space.
+             * @param callback The function to call for each message.
+             * @param state The state to pass to the callback.
+             * @return The number of messages read.
+             */
+            template<typename CallbackType, typename StateType>
+            size_type read(CallbackType callback, StateType state);
+
+            /**
+             * Blocks until the ring contains a message or the timeout elapses.
+             * @param milliseconds The maximum time to wait, -1 waits infinitely.
+             * @return true if the ring contains at least one message.
+             */
+            bool wait(long milliseconds);
+
+        private:
+            enum
+            {
+                Magic = 0x53313031,
+                LengthSize = 4,
+                CacheLineSize = 64
+            };
+
+            /**
+             * The layout at the beginning of the shared segment. The positions
+             * grow monotonically and are reduced modulo the capacity when the data
+             * is accessed, so a full ring can be distinguished from an empty one.
+             * Since the capacity is a power of two, the reduction remains correct
+             * when a position overflows.
+             * They are placed on separate cache lines, since each is written by
+             * another process.
+             */
+            struct Header
+            {
+                unsigned int magic;
+                unsigned int headerSize;
+                size_type capacity;
+                sem_t signal;
+                char padding0[CacheLineSize];
+                size_type head;
+                char padding1[CacheLineSize];
+                size_type tail;
+                char padding2[CacheLineSize];
+            };
+
+            /**
+             * Maps the segment referenced by m_descriptor.
+             * @param size The size of the segment in bytes.
+             */
+            void map(size_type size);
+
+            /**
+             * Copies bytes into the ring, wrapping around its end.
+             * @param position The unreduced position to write to.
+             * @param first An iterator to the first byte to copy.
+             * @param size The number of bytes to copy.
+             */
+            template<typename InputIterator>
+            void copyIn(size_type position, InputIterator first, size_type size);
+
+            /**
+             * Copies bytes out of the ring, wrapping around its end.
+             * @param position The unreduced position to read from.
+             * @param dest The buffer to copy to.
+             * @param size The number of bytes to copy.
+             */
+            void copyOut(size_type position, value_type* dest, size_type size) const;
+
+            /**
+             * Releases the resources acquired by a constructor and throws a runtime_error
+             * containing @p what and the description of errno.
+             * @param what The operation that failed.
+             */
+            void throwSystemError(char const* what);
+
+            static size_type load(size_type const& position);
+            static void store(size_type& position, size_type value);
+
+            /** Prohibit copy construction */
+            SharedMemoryRing(SharedMemoryRing const&);
+
+            /** Prohibit assignment */
+            SharedMemoryRing& operator=(SharedMemoryRing const&);
+
+        private:
+            std::string const m_name;
+            int m_descriptor;
+            void* m_segment;
+            size_type m_segmentSize;
+            Header* m_header;
+            value_type* m_data;
+            size_type m_capacity;
+            bool m_isOwner;
+            std::vector<value_type> m_buffer;
+    };
+
+    /**************************************************************************
+     * Mandatory inline implementation                                        *
+     **************************************************************************/
+
+    inline SharedMemoryRing::SharedMemoryRing(std::string const& name, size_type capacity)
+        : m_name(name)
+        , m_descriptor(-1)
+        , m_segment(0)
+        , m_segmentSize(0)
+        , m_header(0)
+        , m_data(0)
+        , m_capacity(LengthSize * 2)
+        , m_isOwner(true)
+    {
+        while (m_capacity < capacity)
+            m_capacity *= 2;
+
+        // A segment left behind by a crashed provider is replaced.
+        ::shm_unlink(name.c_str());
+        m_descriptor = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR | O_CLOEXEC, 0600);
+        if (m_descriptor < 0)
+            throwSystemError("shm_open");
+
+        size_type const size = sizeof(Header) + m_capacity;
+        if (::ftruncate(m_descriptor, static_cast<off_t>(size)) < 0)
+            throwSystemError("ftruncate");
+
+        map(size);
+
+        Header* const header = m_header;
+        header->headerSize = sizeof(Header);
+        header->capacity = m_capacity;
+        header->head = 0;
+        header->tail = 0;
+        if (::sem_init(&header->signal, 1, 0) < 0)
+            throwSystemError("sem_init");
+
+        // The magic number is stored last, so an opening consumer never sees a
+        // partially initialized header.
+        __atomic_store_n(&header->magic, static_cast<unsigned int>(Magic), __ATOMIC_RELEASE);
+    }
+
+    inline SharedMemoryRing::SharedMemoryRing(std::string const& name)
+        : m_name(name)
+        , m_descriptor(::shm_open(name.c_str(), O_RDWR | O_CLOEXEC, 0))
+        , m_segment(0)
+        , m_segmentSize(0)
+        , m_header(0)
+        , m_data(0)
+        , m_capacity(0)
+        , m_isOwner(false)
+    {
+        if (m_descriptor < 0)
+            throwSystemError("shm_open");
+
+        struct stat status;
+        if (::fstat(m_descriptor, &status) < 0)
+            throwSystemError("fstat");
+
+        size_type const size = static_cast<size_type>(status.st_size);
+        if (size <= sizeof(Header))
+        {
+            errno = EINVAL;
+            throwSystemError("The shared memory object does not contain a ring");
+        }
+
+        map(size);
+
+        Header const* const header = m_header;
+        if (__atomic_load_n(&header->magic, __ATOMIC_ACQUIRE) != static_cast<unsigned int>(Magic)
+        ||  header->headerSize != sizeof(Header)
+        ||  header->capacity != size - sizeof(Header)
+        ||  (header->capacity & (header->capacity - 1)) != 0)
+        {
+            errno = EINVAL;
+            throwSystemError("The shared memory object does not contain a ring");
+        }
+
+        m_capacity = header->capacity;
+    }
+
+    inline SharedMemoryRing::~SharedMemoryRing()
+    {
+        if (m_segment != 0)
+        {
+            if (m_isOwner)
+                ::sem_destroy(&m_header->signal);
+
+            ::munmap(m_segment, m_segmentSize);
+        }
+
+        if (m_descriptor >= 0)
+            ::close(m_descriptor);
+
+        if (m_isOwner)
+            ::shm_unlink(m_name.c_str());
+    }
+
+    inline std::string const& SharedMemoryRing::name() const
+    {
+        return m_name;
+    }
+
+    inline SharedMemoryRing::size_type SharedMemoryRing::capacity() const
+    {
+        return m_capacity;
+    }
+
+    inline SharedMemoryRing::size_type SharedMemoryRing::available() const
+    {
+        return m_capacity - (load(m_header->head) - load(m_header->tail));
+    }
+
+    template<typename InputIterator>
+    inline bool SharedMemoryRing::write(InputIterator first, InputIterator last)
+    {
+        size_type const size = static_cast<size_type>(std::distance(first, last));
+        if (size > 0xFFFFFFFFUL || size + LengthSize > available())
+            return false;
+
+        value_type const length[LengthSize] =
+        {
+            static_cast<value_type>((size >> 0) & 0xFF),
+            static_cast<value_type>((size >> 8) & 0xFF),
+            static_cast<value_type>((size >> 16) & 0xFF),
+            static_cast<value_type>((size >> 24) & 0xFF)
+        };
+
+        // Only the producer modifies the head, so it can be read without ordering.
+        size_type const head = m_header->head;
+        copyIn(head, length, LengthSize);
+        copyIn(head + LengthSize, first, size);
+        store(m_header->head, head + LengthSize + size);
+
+        ::sem_post(&m_header->signal);
+        return true;
+    }
+
+    template<typename CallbackType, typename StateType>
+    inline SharedMemoryRing::size_type SharedMemoryRing::read(CallbackType callback, StateType state)
+    {
+        size_type const head = load(m_header->head);
+        size_type tail = m_header->tail;
+        size_type count = 0;
+
+        while (tail != head)
+        {
+            value_type length[LengthSize];
+            copyOut(tail, length, LengthSize);
+
+            size_type const size = static_cast<size_type>(length[0])
+                | (static_cast<size_type>(length[1]) << 8)
+                | (static_cast<size_type>(length[2]) << 16)
+                | (static_cast<size_type>(length[3]) << 24);
+
+            size_type const offset = (tail + LengthSize) & (m_capacity - 1);
+            if (offset + size <= m_capacity)
+            {
+                const_iterator const message = m_data + offset;
+                callback(message, message + size, state);
+            }
+            else
+            {
+                m_buffer.resize(size);
+                copyOut(tail + LengthSize, &m_buffer.front(), size);
+
+                const_iterator const message = &m_buffer.front();
+                callback(message, message + size, state);
+            }
+
+            // The space is released after each message, so the producer can continue
+            // while the remaining messages are processed.
+            tail += LengthSize + size;
+            store(m_header->tail, tail);
+            ++count;
+        }
+
+        return count;
+    }
+
+    inline bool SharedMemoryRing::wait(long milliseconds)
+    {
+        while (load(m_header->head) == m_header->tail)
+        {
+            int result;
+            if (milliseconds < 0)
+            {
+                result = ::sem_wait(&m_header->signal);
+            }
+            else
+            {
+                timespec deadline;
+                ::clock_gettime(CLOCK_REALTIME, &deadline);
+                deadline.tv_sec += milliseconds / 1000;
+                deadline.tv_nsec += (milliseconds % 1000) * 1000000;
+                if (deadline.tv_nsec >= 1000000000)
+                {
+                    deadline.tv_sec += 1;
+                    deadline.tv_nsec -= 1000000000;
+                }
+
+                result = ::sem_timedwait(&m_header->signal, &deadline);
+            }
+
+            if (result < 0 && errno != EINTR)
+                break;
+        }
+
+        // Each message posts the semaphore once, the surplus left by messages that
+        // have been read together is consumed here.
+        while (::sem_trywait(&m_header->signal) == 0)
+            ;
+
+        return load(m_header->head) != m_header->tail;
+    }
+
+    inline void SharedMemoryRing::map(size_type size)
+    {
+        m_segment = ::mmap(0, size, PROT_READ | PROT_WRITE, MAP_SHARED, m_descriptor, 0);
+        if (m_segment == MAP_FAILED)
+        {
+            m_segment = 0;
+            throwSystemError("mmap");
+        }
+
+        m_segmentSize = size;
+        m_header = static_cast<Header*>(m_segment);
+        m_data = static_cast<value_type*>(m_segment) + sizeof(Header);
+    }
+
+    template<typename InputIterator>
+    inline void SharedMemoryRing::copyIn(size_type position, InputIterator first, size_type size)
+    {
+        size_type offset = position & (m_capacity - 1);
+        for ( ; size > 0; --size, ++first)
+        {
+            m_data[offset] = static_cast<value_type>(*first);
+            if (++offset == m_capacity)
+                offset = 0;
+        }
+    }
+
+    inline void SharedMemoryRing::copyOut(size_type position, value_type* dest, size_type size) const
+    {
+        size_type const offset = position & (m_capacity - 1);
+        size_type const count = std::min(size, m_capacity - offset);
+        std::memcpy(dest, m_data + offset, count);
+        std::memcpy(dest + count, m_data, size - count);
+    }
+
+    inline void SharedMemoryRing::throwSystemError(char const* what)
+    {
+        std::string const message = std::string(what) + ": " + std::strerror(errno);
+
+        // The destructor does not run when a constructor throws.
+        if (m_segment != 0)
+            ::munmap(m_segment, m_segmentSize);
+
+        if (m_descriptor >= 0)
+            ::close(m_descriptor);
+
+        if (m_isOwner)
+            ::shm_unlink(m_name.c_str());
+
+        m_segment = 0;
+        m_descriptor = -1;
+        throw std::runtime_error(message);
+    }
+
+    inline SharedMemoryRing::size_type SharedMemoryRing::load(size_type const& position)
+    {
+        return __atomic_load_n(&position, __ATOMIC_ACQUIRE);
+    }
+
+    inline void SharedMemoryRing::store(size_type& position, size_type value)
+    {
+        __atomic_store_n(&position, value, __ATOMIC_RELEASE);
+    }
+}
+}
+
+#endif  // __LIBS101_NET_SHAREDMEMORYRING_HPP
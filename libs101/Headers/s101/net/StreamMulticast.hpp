@@ -0,0 +1,505 @@
+/*
+    libs101 -- C++ 03 implementation of the S101 encoding and decoding
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef __LIBS101_NET_STREAMMULTICAST_HPP
+#define __LIBS101_NET_STREAMMULTICAST_HPP
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "../Byte.hpp"
+#include "../StreamDecoder.hpp"
+
+namespace libs101 { namespace net
+{
+    /**
+     * The layout of the datagrams exchanged by MulticastSender and MulticastReceiver.
+     * A datagram starts with an eight byte header, followed by one or more complete
+     * S101 frames. The header contains a magic number, a format version and a sequence
+     * number, which is incremented with every datagram and lets the receivers detect
+     * lost ones. S101 frames never span datagrams.
+     */
+    struct MulticastDatagram
+    {
+        enum
+        {
+            Magic0 = 0x53,
+            Magic1 = 0x4D,
+            Version = 0x01,
+            HeaderSize = 8,
+
+            /** The largest datagram that fits into an ethernet frame without fragmentation. */
+            MaximumSize = 1472
+        };
+    };
+
+    /**
+     * Sends S101 framed stream collections to a multicast group, so the cost of
+     * distributing high-rate stream entries, for example audio meters, doesn't depend
+     * on the number of consumers. The tree and all control traffic remain on the TCP
+     * connections. The provider announces the group, for example in a string parameter
+     * containing address(), and consumers that support multicast join it with a
+     * MulticastReceiver.
+     * @note The sender is not thread-safe.
+     */
+    class MulticastSender
+    {
+        public:
+            typedef std::vector<unsigned char>::size_type size_type;
+
+            /**
+             * Creates a socket sending to the passed group.
+             * @param group The IPv4 multicast address, for example "239.1.1.1".
+             * @param port The destination port.
+             * @param timeToLive The number of routers the datagrams may pass, 1 keeps
+             *      them in the local network.
+             * @param interfaceAddress The address of the local interface to send on,
+             *      or "0.0.0.0" to let the routing table choose.
+             * @throws std::runtime_error if the socket cannot be created.
+             */
+            MulticastSender(std::string const& group, unsigned short port, int timeToLive = 1, std::string const& interfaceAddress = "0.0.0.0");
+
+            /** Closes the socket. */
+            ~MulticastSender();
+
+            /**
+             * Returns the group and port as "address:port", which may be announced
+             * to the consumers.
+             * @return The address of the group.
+             */
+            std::string address() const;
+
+            /**
+             * Sends encoded S101 frames, usually the frames of a stream collection. The
+             * frames are packed into as few datagrams as possible, a frame larger than
+             * a datagram is sent in a datagram of its own.
+             * @param first An iterator to the first byte of the frames, which must start
+             *      with a BoF byte.
+             * @param last An iterator one past the EoF byte of the last frame.
+             * @return The number of datagrams that could not be sent.
+             */
+            template<typename InputIterator>
+            size_type send(InputIterator first, InputIterator last);
+
+            /**
+             * Returns the sequence number of the next datagram.
+             * @return The sequence number of the next datagram.
+             */
+            unsigned long sequence() const;
+
+        private:
+            /** Starts a new datagram in m_datagram. */
+            void begin();
+
+            /**
+             * Sends the datagram, if it contains a frame.
+             * @return true if the datagram has been sent.
+             */
+            bool transmit();
+
+            /** Prohibit copy construction */
+            MulticastSender(MulticastSender const&);
+
+            /** Prohibit assignment */
+            MulticastSender& operator=(MulticastSender const&);
+
+        private:
+            int m_descriptor;
+            sockaddr_in m_group;
+            unsigned long m_sequence;
+            std::vector<unsigned char> m_datagram;
+            std::vector<unsigned char> m_frame;
+    };
+
+    /**
+     * Joins a multicast group and decodes the S101 frames sent by a MulticastSender.
+     * The socket is non-blocking, its descriptor may be registered with select, poll
+     * or epoll to be notified about incoming datagrams.
+     */
+    class MulticastReceiver
+    {
+        public:
+            typedef StreamDecoder<unsigned char> Decoder;
+            typedef Decoder::const_iterator const_iterator;
+            typedef std::vector<unsigned char>::size_type size_type;
+
+            /**
+             * Interface which receives the decoded messages.
+             */
+            class Handler
+            {
+                public:
+                    /** Destructor */
+                    virtual ~Handler()
+                    {}
+
+                    /**
+                     * Called for each S101 message received.
+                     * @param first The first byte of the decoded message, which is the slot.
+                     * @param last The byte one past the last byte of the decoded message.
+                     */
+                    virtual void messageReceived(const_iterator first, const_iterator last) = 0;
+
+                    /**
+                     * Called before the messages of a datagram are reported when the
+                     * preceding datagrams have been lost. A consumer should discard a
+                     * partially received multi-packet message.
+                     * @param count The number of lost datagrams.
+                     */
+                    virtual void datagramsLost(unsigned long count) = 0;
+            };
+
+        public:
+            /**
+             * Joins the passed group.
+             * @param handler The handler receiving the decoded messages.
+             * @param group The IPv4 multicast address announced by the provider.
+             * @param port The port the provider sends to.
+             * @param interfaceAddress The address of the local interface to join the
+             *      group on, or "0.0.0.0" to let the system choose.
+             * @throws std::runtime_error if the socket cannot be bound or the group
+             *      cannot be joined.
+             */
+            MulticastReceiver(Handler& handler, std::string const& group, unsigned short port, std::string const& interfaceAddress = "0.0.0.0");
+
+            /** Leaves the group and closes the socket. */
+            ~MulticastReceiver();
+
+            /**
+             * Returns the socket descriptor.
+             * @return The socket descriptor.
+             */
+            int descriptor() const;
+
+            /**
+             * Reads and decodes all datagrams that have been received. Datagrams
+             * which are older than the last one received or don't start with a valid
+             * header are dropped.
+             * @return The number of datagrams read.
+             */
+            size_type receive();
+
+            /**
+             * Returns the total number of datagrams that have been lost.
+             * @return The number of lost datagrams.
+             */
+            unsigned long lost() const;
+
+        private:
+            /**
+             * Checks the header and the sequence number of a received datagram.
+             * @param first The first byte of the datagram.
+             * @param size The size of the datagram in bytes.
+             * @return true if the frames of the datagram should be decoded.
+             */
+            bool accept(unsigned char const* first, size_type size);
+
+            /**
+             * Forwards a decoded message to the handler.
+             * @param first The first byte of the decoded message.
+             * @param last The byte one past the last byte of the decoded message.
+             * @param receiver The receiver that decoded the message.
+             */
+            static void dispatch(const_iterator first, const_iterator last, MulticastReceiver* receiver);
+
+            /** Prohibit copy construction */
+            MulticastReceiver(MulticastReceiver const&);
+
+            /** Prohibit assignment */
+            MulticastReceiver& operator=(MulticastReceiver const&);
+
+        private:
+            Handler& m_handler;
+            int m_descriptor;
+            ip_mreq m_membership;
+            Decoder m_decoder;
+            std::vector<unsigned char> m_buffer;
+            unsigned long m_expected;
+            unsigned long m_lost;
+            bool m_isSynchronized;
+    };
+
+    namespace detail
+    {
+        /**
+         * Converts a dotted IPv4 address.
+         * @param address The address to convert.
+         * @return The address in network byte order.
+         * @throws std::invalid_argument if the address is malformed.
+         */
+        inline in_addr parseAddress(std::string const& address)
+        {
+            in_addr result;
+            if (::inet_pton(AF_INET, address.c_str(), &result) != 1)
+                throw std::invalid_argument("Invalid IPv4 address: " + address);
+
+            return result;
+        }
+
+        /**
+         * Closes @p descriptor and throws a runtime_error containing @p what and the
+         * description of errno.
+         * @param descriptor The socket to close.
+         * @param what The operation that failed.
+         */
+        inline void throwSocketError(int descriptor, char const* what)
+        {
+            std::string const message = std::string(what) + ": " + std::strerror(errno);
+            ::close(descriptor);
+            throw std::runtime_error(message);
+        }
+    }
+
+    /**************************************************************************
+     * Mandatory inline implementation                                        *
+     **************************************************************************/
+
+    inline MulticastSender::MulticastSender(std::string const& group, unsigned short port, int timeToLive, std::string const& interfaceAddress)
+        : m_descriptor(-1)
+        , m_sequence(0)
+    {
+        std::memset(&m_group, 0, sizeof(m_group));
+        m_group.sin_family = AF_INET;
+        m_group.sin_port = htons(port);
+        m_group.sin_addr = detail::parseAddress(group);
+
+        in_addr const local = detail::parseAddress(interfaceAddress);
+        unsigned char const ttl = static_cast<unsigned char>(timeToLive);
+
+        m_descriptor = ::socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+        if (m_descriptor < 0)
+            detail::throwSocketError(m_descriptor, "socket");
+
+        if (::setsockopt(m_descriptor, IPPROTO_IP, IP_MULTICAST_TTL, &ttl, sizeof(ttl)) < 0)
+            detail::throwSocketError(m_descriptor, "setsockopt(IP_MULTICAST_TTL)");
+
+        if (::setsockopt(m_descriptor, IPPROTO_IP, IP_MULTICAST_IF, &local, sizeof(local)) < 0)
+            detail::throwSocketError(m_descriptor, "setsockopt(IP_MULTICAST_IF)");
+
+        m_datagram.reserve(MulticastDatagram::MaximumSize);
+        begin();
+    }
+
+    inline MulticastSender::~MulticastSender()
+    {
+        ::close(m_descriptor);
+    }
+
+    inline std::string MulticastSender::address() const
+    {
+        char group[INET_ADDRSTRLEN];
+        ::inet_ntop(AF_INET, &m_group.sin_addr, group, sizeof(group));
+
+        char port[8];
+        std::sprintf(port, ":%u", static_cast<unsigned int>(ntohs(m_group.sin_port)));
+        return std::string(group) + port;
+    }
+
+    template<typename InputIterator>
+    inline MulticastSender::size_type MulticastSender::send(InputIterator first, InputIterator last)
+    {
+        size_type failed = 0;
+        for ( ; first != last; ++first)
+        {
+            unsigned char const byte = static_cast<unsigned char>(*first);
+            if (byte == Byte::BoF)
+                m_frame.clear();
+
+            m_frame.push_back(byte);
+            if (byte != Byte::EoF)
+                continue;
+
+            // The frame is complete and is appended to the current datagram, unless
+            // the datagram would exceed the maximum size.
+            if (m_datagram.size() + m_frame.size() > MulticastDatagram::MaximumSize && transmit() == false)
+                ++failed;
+
+            m_datagram.insert(m_datagram.end(), m_frame.begin(), m_frame.end());
+            m_frame.clear();
+        }
+
+        if (transmit() == false)
+            ++failed;
+
+        return failed;
+    }
+
+    inline unsigned long MulticastSender::sequence() const
+    {
+        return m_sequence;
+    }
+
+    inline void MulticastSender::begin()
+    {
+        unsigned long const sequence = m_sequence;
+        m_datagram.resize(MulticastDatagram::HeaderSize);
+        m_datagram[0] = MulticastDatagram::Magic0;
+        m_datagram[1] = MulticastDatagram::Magic1;
+        m_datagram[2] = MulticastDatagram::Version;
+        m_datagram[3] = 0x00;
+        m_datagram[4] = static_cast<unsigned char>((sequence >> 24) & 0xFF);
+        m_datagram[5] = static_cast<unsigned char>((sequence >> 16) & 0xFF);
+        m_datagram[6] = static_cast<unsigned char>((sequence >> 8) & 0xFF);
+        m_datagram[7] = static_cast<unsigned char>((sequence >> 0) & 0xFF);
+    }
+
+    inline bool MulticastSender::transmit()
+    {
+        if (m_datagram.size() <= MulticastDatagram::HeaderSize)
+            return true;
+
+        ssize_t result;
+        do
+        {
+            result = ::sendto(m_descriptor, &m_datagram.front(), m_datagram.size(), 0, reinterpret_cast<sockaddr const*>(&m_group), sizeof(m_group));
+        }
+        while (result < 0 && errno == EINTR);
+
+        // The sequence number is incremented for a datagram that could not be sent
+        // as well, so the receivers report it as lost.
+        m_sequence = (m_sequence + 1) & 0xFFFFFFFFUL;
+        begin();
+        return result >= 0;
+    }
+
+
+    inline MulticastReceiver::MulticastReceiver(Handler& handler, std::string const& group, unsigned short port, std::string const& interfaceAddress)
+        : m_handler(handler)
+        , m_descriptor(-1)
+        , m_buffer(64 * 1024)
+        , m_expected(0)
+        , m_lost(0)
+        , m_isSynchronized(false)
+    {
+        m_membership.imr_multiaddr = detail::parseAddress(group);
+        m_membership.imr_interface = detail::parseAddress(interfaceAddress);
+
+        m_descriptor = ::socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (m_descriptor < 0)
+            detail::throwSocketError(m_descriptor, "socket");
+
+        // Several consumers on the same host may join the same group.
+        int const reuse = 1;
+        if (::setsockopt(m_descriptor, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse)) < 0)
+            detail::throwSocketError(m_descriptor, "setsockopt(SO_REUSEADDR)");
+
+        sockaddr_in address;
+        std::memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_port = htons(port);
+        address.sin_addr = m_membership.imr_multiaddr;
+        if (::bind(m_descriptor, reinterpret_cast<sockaddr const*>(&address), sizeof(address)) < 0)
+            detail::throwSocketError(m_descriptor, "bind");
+
+        if (::setsockopt(m_descriptor, IPPROTO_IP, IP_ADD_MEMBERSHIP, &m_membership, sizeof(m_membership)) < 0)
+            detail::throwSocketError(m_descriptor, "setsockopt(IP_ADD_MEMBERSHIP)");
+    }
+
+    inline MulticastReceiver::~MulticastReceiver()
+    {
+        ::setsockopt(m_descriptor, IPPROTO_IP, IP_DROP_MEMBERSHIP, &m_membership, sizeof(m_membership));
+        ::close(m_descriptor);
+    }
+
+    inline int MulticastReceiver::descriptor() const
+    {
+        return m_descriptor;
+    }
+
+    inline MulticastReceiver::size_type MulticastReceiver::receive()
+    {
+        size_type count = 0;
+        for (;;)
+        {
+            ssize_t const result = ::recv(m_descriptor, &m_buffer.front(), m_buffer.size(), 0);
+            if (result < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+
+                break;
+            }
+
+            ++count;
+
+            unsigned char const* const first = &m_buffer.front();
+            size_type const size = static_cast<size_type>(result);
+            if (accept(first, size))
+            {
+                m_decoder.read(first + MulticastDatagram::HeaderSize, first + size, &MulticastReceiver::dispatch, this);
+            }
+        }
+
+        return count;
+    }
+
+    inline unsigned long MulticastReceiver::lost() const
+    {
+        return m_lost;
+    }
+
+    inline bool MulticastReceiver::accept(unsigned char const* first, size_type size)
+    {
+        if (size <= MulticastDatagram::HeaderSize
+        ||  first[0] != MulticastDatagram::Magic0
+        ||  first[1] != MulticastDatagram::Magic1
+        ||  first[2] != MulticastDatagram::Version)
+            return false;
+
+        unsigned long const sequence = (static_cast<unsigned long>(first[4]) << 24)
+            | (static_cast<unsigned long>(first[5]) << 16)
+            | (static_cast<unsigned long>(first[6]) << 8)
+            | (static_cast<unsigned long>(first[7]) << 0);
+
+        if (m_isSynchronized)
+        {
+            // The distance is evaluated modulo 2^32, so the comparison tolerates the
+            // wrap-around of the sequence number.
+            unsigned long const distance = (sequence - m_expected) & 0xFFFFFFFFUL;
+            if (distance >= 0x80000000UL)
+                return false;
+
+            if (distance > 0)
+            {
+                m_lost += distance;
+                m_decoder.reset();
+                m_handler.datagramsLost(distance);
+            }
+        }
+
+        m_expected = (sequence + 1) & 0xFFFFFFFFUL;
+        m_isSynchronized = true;
+        return true;
+    }
+
+    inline void MulticastReceiver::dispatch(const_iterator first, const_iterator last, MulticastReceiver* receiver)
+    {
+        receiver->m_handler.messageReceived(first, last);
+    }
+}
+}
+
+#endif  // __LIBS101_NET_STREAMMULTICAST_HPP
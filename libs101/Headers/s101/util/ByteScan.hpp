@@ -0,0 +1,132 @@
+/*
+    libs101 -- C++ 03 implementation of the S101 encoding and decoding
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef __LIBS101_UTIL_BYTESCAN_HPP
+#define __LIBS101_UTIL_BYTESCAN_HPP
+
+#include <cstddef>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define LIBS101_BYTESCAN_SSE2
+#  include <emmintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#  define LIBS101_BYTESCAN_NEON
+#  include <arm_neon.h>
+#endif
+
+namespace libs101 { namespace util
+{
+    /**
+     * Static class that locates the bytes of a buffer that have to be escaped
+     * or unescaped. The S101 framing only treats bytes at the top of the value
+     * range specially, so a scan looks for the first byte that is greater than
+     * or equal to a threshold. When compiled for SSE2 or AArch64 NEON, sixteen
+     * bytes are examined per step.
+     */
+    class ByteScan
+    {
+        public:
+            /**
+             * Returns the first byte within the provided range that is greater than
+             * or equal to @p threshold.
+             * @param first An iterator pointing to the first byte to examine.
+             * @param last An iterator pointing to the byte one past the last
+             *      byte to examine.
+             * @param threshold The smallest value that terminates the scan.
+             * @return An iterator pointing to the first byte that is not below
+             *      @p threshold, or @p last if there is none.
+             */
+            template<typename InputIterator, typename ValueType>
+            static InputIterator findAtLeast(InputIterator first, InputIterator last, ValueType threshold);
+
+            /**
+             * Returns the first byte within the provided buffer that is greater than
+             * or equal to @p threshold, examining multiple bytes per step when
+             * vector instructions are available.
+             * @see findAtLeast(InputIterator, InputIterator, ValueType)
+             */
+            static unsigned char const* findAtLeast(unsigned char const* first, unsigned char const* last, unsigned char threshold);
+
+        private:
+            /** Private, unimplemented constructor. */
+            ByteScan();
+    };
+
+
+    /**************************************************************************
+     * Inline Implementation                                                  *
+     **************************************************************************/
+
+    template<typename InputIterator, typename ValueType>
+    inline InputIterator ByteScan::findAtLeast(InputIterator first, InputIterator last, ValueType threshold)
+    {
+        while (first != last && *first < threshold)
+            ++first;
+
+        return first;
+    }
+
+    inline unsigned char const* ByteScan::findAtLeast(unsigned char const* first, unsigned char const* last, unsigned char threshold)
+    {
+#if defined(LIBS101_BYTESCAN_SSE2)
+        __m128i const limit = _mm_set1_epi8(static_cast<char>(threshold));
+
+        while (last - first >= 16)
+        {
+            __m128i const block = _mm_loadu_si128(reinterpret_cast<__m128i const*>(first));
+            __m128i const match = _mm_cmpeq_epi8(_mm_max_epu8(block, limit), block);
+            int const mask = _mm_movemask_epi8(match);
+
+            if (mask != 0)
+            {
+                while (*first < threshold)
+                    ++first;
+
+                return first;
+            }
+
+            first += 16;
+        }
+#elif defined(LIBS101_BYTESCAN_NEON)
+        uint8x16_t const limit = vdupq_n_u8(threshold);
+
+        while (last - first >= 16)
+        {
+            uint8x16_t const block = vld1q_u8(first);
+
+            if (vmaxvq_u8(vcgeq_u8(block, limit)) != 0)
+            {
+                while (*first < threshold)
+                    ++first;
+
+                return first;
+            }
+
+            first += 16;
+        }
+#endif
+        while (first != last && *first < threshold)
+            ++first;
+
+        return first;
+    }
+}
+}
+
+#endif  // __LIBS101_UTIL_BYTESCAN_HPP
@@ -0,0 +1,476 @@
+/*
+    libs101 -- C++ 03 implementation of the S101 encoding and decoding
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef __LIBS101_UTIL_TIMERWHEEL_HPP
+#define __LIBS101_UTIL_TIMERWHEEL_HPP
+
+#include <cstddef>
+
+namespace libs101 { namespace util
+{
+    /**
+     * A hierarchical timer wheel which schedules a large number of timers with
+     * constant cost per operation. The wheel has no clock of its own, time is
+     * measured in ticks and passed to advance by the owner, which decides what
+     * a tick is (a millisecond for the EpollServer, for example).
+     * The wheel consists of four levels of 64 slots. A timer due within the next
+     * 64 ticks is stored in the slot of its tick on the lowest level, timers
+     * further away are stored on the level whose slots span their distance. Each
+     * time the lower level completes a revolution, the timers of the next slot of
+     * the level above are redistributed. Timers due more than 2^24 ticks ahead
+     * are parked on the top level until they come into range.
+     * Timers are intrusive list nodes, so scheduling and cancelling a timer
+     * neither allocates memory nor searches, and a timer's destructor removes it
+     * from the wheel.
+     * @note The wheel is not thread-safe.
+     */
+    class TimerWheel
+    {
+        public:
+            typedef unsigned long tick_type;
+            typedef std::size_t size_type;
+
+        private:
+            /** The links of the intrusive slot lists. */
+            struct Link
+            {
+                Link* previous;
+                Link* next;
+            };
+
+        public:
+            /**
+             * Base class of all timers. A timer is scheduled on at most one wheel
+             * at a time, and the wheel calls its expired method when it is due.
+             */
+            class Timer : private Link
+            {
+                friend class TimerWheel;
+                public:
+                    /** Initializes a timer that is not scheduled. */
+                    Timer();
+
+                    /** Removes the timer from the wheel it is scheduled on. */
+                    virtual ~Timer();
+
+                    /**
+                     * Tests whether the timer is currently scheduled.
+                     * @return true if the timer is scheduled.
+                     */
+                    bool isScheduled() const;
+
+                    /**
+                     * Returns the tick the timer is due at. The value is only valid
+                     * while the timer is scheduled.
+                     * @return The tick the timer is due at.
+                     */
+                    tick_type deadline() const;
+
+                protected:
+                    /**
+                     * Called by TimerWheel::advance when the timer is due. The timer is
+                     * no longer scheduled at this point and may be scheduled again.
+                     * @param wheel The wheel the timer has been scheduled on.
+                     */
+                    virtual void expired(TimerWheel& wheel) = 0;
+
+                private:
+                    /** Prohibit copy construction */
+                    Timer(Timer const&);
+
+                    /** Prohibit assignment */
+                    Timer& operator=(Timer const&);
+
+                private:
+                    TimerWheel* m_wheel;
+                    tick_type m_deadline;
+            };
+
+        public:
+            /**
+             * Initializes an empty wheel.
+             * @param now The current tick.
+             */
+            explicit TimerWheel(tick_type now = 0);
+
+            /** Detaches all timers which are still scheduled, without calling them. */
+            ~TimerWheel();
+
+            /**
+             * Schedules @p timer to expire at @p deadline. A timer that is already
+             * scheduled, on this or another wheel, is moved. A deadline which has
+             * already passed expires with the next tick.
+             * @param timer The timer to schedule.
+             * @param deadline The tick the timer is due at.
+             */
+            void schedule(Timer& timer, tick_type deadline);
+
+            /**
+             * Schedules @p timer to expire @p delay ticks after the current tick.
+             * @param timer The timer to schedule.
+             * @param delay The number of ticks from now.
+             */
+            void scheduleAfter(Timer& timer, tick_type delay);
+
+            /**
+             * Removes @p timer from the wheel. Timers that are not scheduled are
+             * left untouched.
+             * @param timer The timer to cancel.
+             */
+            void cancel(Timer& timer);
+
+            /**
+             * Processes all ticks up to and including @p now and calls the timers
+             * that are due. The timers may schedule and cancel any timer, including
+             * themselves.
+             * @param now The current tick. Values before the current tick of the
+             *      wheel are ignored.
+             * @return The number of timers that expired.
+             */
+            size_type advance(tick_type now);
+
+            /**
+             * Returns the number of ticks the owner may wait before it has to call
+             * advance. This is the distance to the next due timer on the lowest
+             * level, bounded by the next redistribution of the upper levels.
+             * @return The number of ticks to wait, or 0 if advance should be called
+             *      right away. Returns the largest tick_type value if the wheel is empty.
+             */
+            tick_type idleTicks() const;
+
+            /**
+             * Returns the first tick that has not been processed yet.
+             * @return The current tick of the wheel.
+             */
+            tick_type now() const;
+
+            /**
+             * Returns the number of scheduled timers.
+             * @return The number of scheduled timers.
+             */
+            size_type size() const;
+
+            /**
+             * Tests whether no timer is scheduled.
+             * @return true if no timer is scheduled.
+             */
+            bool empty() const;
+
+        private:
+            enum
+            {
+                Levels = 4,
+                SlotBits = 6,
+                Slots = 1 << SlotBits,
+                SlotMask = Slots - 1
+            };
+
+            /**
+             * Inserts @p timer into the slot that covers its deadline, relative to
+             * the current tick.
+             * @param timer The timer to insert, which must not be linked.
+             */
+            void insert(Timer& timer);
+
+            /**
+             * Redistributes the timers of a slot of an upper level to the levels below.
+             * @param level The level of the slot.
+             * @param index The index of the slot.
+             */
+            void cascade(int level, int index);
+
+            /**
+             * Moves all timers of @p slot to the list @p head.
+             * @param slot The slot to empty.
+             * @param head The initialized head of the list to move the timers to.
+             */
+            static void splice(Link& slot, Link& head);
+
+            /** Links @p link in front of @p head, i.e. at the end of the list. */
+            static void pushBack(Link& head, Link& link);
+
+            /** Unlinks @p link from the list it belongs to. */
+            static void unlink(Link& link);
+
+            /** Prohibit copy construction */
+            TimerWheel(TimerWheel const&);
+
+            /** Prohibit assignment */
+            TimerWheel& operator=(TimerWheel const&);
+
+        private:
+            Link m_slots[Levels][Slots];
+            tick_type m_now;
+            size_type m_size;
+    };
+
+
+    /**************************************************************************
+     * Inline Implementation                                                  *
+     **************************************************************************/
+
+    inline TimerWheel::Timer::Timer()
+        : m_wheel(0)
+        , m_deadline(0)
+    {
+        previous = 0;
+        next = 0;
+    }
+
+    inline TimerWheel::Timer::~Timer()
+    {
+        if (m_wheel != 0)
+            m_wheel->cancel(*this);
+    }
+
+    inline bool TimerWheel::Timer::isScheduled() const
+    {
+        return m_wheel != 0;
+    }
+
+    inline TimerWheel::tick_type TimerWheel::Timer::deadline() const
+    {
+        return m_deadline;
+    }
+
+
+    inline TimerWheel::TimerWheel(tick_type now)
+        : m_now(now)
+        , m_size(0)
+    {
+        for (int level = 0; level < Levels; ++level)
+        {
+            for (int index = 0; index < Slots; ++index)
+            {
+                Link& slot = m_slots[level][index];
+                slot.previous = &slot;
+                slot.next = &slot;
+            }
+        }
+    }
+
+    inline TimerWheel::~TimerWheel()
+    {
+        for (int level = 0; level < Levels; ++level)
+        {
+            for (int index = 0; index < Slots; ++index)
+            {
+                Link& slot = m_slots[level][index];
+                while (slot.next != &slot)
+                {
+                    Timer& timer = static_cast<Timer&>(*slot.next);
+                    unlink(timer);
+                    timer.m_wheel = 0;
+                }
+            }
+        }
+    }
+
+    inline void TimerWheel::schedule(Timer& timer, tick_type deadline)
+    {
+        if (timer.m_wheel != 0)
+            timer.m_wheel->cancel(timer);
+
+        timer.m_wheel = this;
+        timer.m_deadline = deadline;
+        insert(timer);
+        ++m_size;
+    }
+
+    inline void TimerWheel::scheduleAfter(Timer& timer, tick_type delay)
+    {
+        schedule(timer, m_now + delay);
+    }
+
+    inline void TimerWheel::cancel(Timer& timer)
+    {
+        if (timer.m_wheel == this)
+        {
+            unlink(timer);
+            timer.m_wheel = 0;
+            --m_size;
+        }
+    }
+
+    inline TimerWheel::size_type TimerWheel::advance(tick_type now)
+    {
+        size_type expired = 0;
+
+        // The difference is interpreted as signed, so that the tick counter may wrap.
+        while (m_size > 0 && static_cast<long>(now - m_now) >= 0)
+        {
+            tick_type const tick = m_now;
+            int const index = static_cast<int>(tick & SlotMask);
+
+            if (index == 0)
+            {
+                // Find the highest level that completes with this tick and
+                // redistribute its timers first, so that they trickle down.
+                int top = 1;
+                while (top < Levels - 1 && ((tick >> (top * SlotBits)) & SlotMask) == 0)
+                    ++top;
+
+                for (int level = top; level > 0; --level)
+                    cascade(level, static_cast<int>((tick >> (level * SlotBits)) & SlotMask));
+            }
+
+            Link due;
+            due.previous = &due;
+            due.next = &due;
+            splice(m_slots[0][index], due);
+
+            // Timers scheduled by the callbacks are placed relative to the next tick.
+            m_now = tick + 1;
+
+            while (due.next != &due)
+            {
+                Timer& timer = static_cast<Timer&>(*due.next);
+                unlink(timer);
+                timer.m_wheel = 0;
+                --m_size;
+                ++expired;
+                timer.expired(*this);
+            }
+        }
+
+        // An empty wheel skips the remaining ticks at once.
+        if (m_size == 0 && static_cast<long>(now - m_now) >= 0)
+            m_now = now + 1;
+
+        return expired;
+    }
+
+    inline TimerWheel::tick_type TimerWheel::idleTicks() const
+    {
+        if (m_size == 0)
+            return ~tick_type(0);
+
+        // On a boundary of the lowest level, the upper levels are redistributed
+        // by the next call to advance, which may move timers to the current tick.
+        if ((m_now & SlotMask) == 0)
+        {
+            for (int level = 1; level < Levels; ++level)
+            {
+                int const index = static_cast<int>((m_now >> (level * SlotBits)) & SlotMask);
+                Link const& slot = m_slots[level][index];
+                if (slot.next != &slot)
+                    return 0;
+
+                if (index != 0)
+                    break;
+            }
+        }
+
+        tick_type const boundary = Slots - (m_now & SlotMask);
+        for (tick_type distance = 0; distance < boundary; ++distance)
+        {
+            Link const& slot = m_slots[0][(m_now + distance) & SlotMask];
+            if (slot.next != &slot)
+                return distance;
+        }
+
+        return boundary;
+    }
+
+    inline TimerWheel::tick_type TimerWheel::now() const
+    {
+        return m_now;
+    }
+
+    inline TimerWheel::size_type TimerWheel::size() const
+    {
+        return m_size;
+    }
+
+    inline bool TimerWheel::empty() const
+    {
+        return m_size == 0;
+    }
+
+    inline void TimerWheel::insert(Timer& timer)
+    {
+        tick_type deadline = timer.m_deadline;
+        tick_type distance = deadline - m_now;
+
+        if (static_cast<long>(distance) < 0)
+        {
+            deadline = m_now;
+            distance = 0;
+        }
+
+        int level = 0;
+        while (level < Levels - 1 && distance >= (tick_type(1) << ((level + 1) * SlotBits)))
+            ++level;
+
+        // Deadlines beyond the range of the top level wait in its farthest slot.
+        tick_type const range = tick_type(1) << (Levels * SlotBits);
+        if (distance >= range)
+            deadline = m_now + range - 1;
+
+        int const index = static_cast<int>((deadline >> (level * SlotBits)) & SlotMask);
+        pushBack(m_slots[level][index], timer);
+    }
+
+    inline void TimerWheel::cascade(int level, int index)
+    {
+        Link pending;
+        pending.previous = &pending;
+        pending.next = &pending;
+        splice(m_slots[level][index], pending);
+
+        while (pending.next != &pending)
+        {
+            Timer& timer = static_cast<Timer&>(*pending.next);
+            unlink(timer);
+            insert(timer);
+        }
+    }
+
+    inline void TimerWheel::splice(Link& slot, Link& head)
+    {
+        if (slot.next != &slot)
+        {
+            head.next = slot.next;
+            head.previous = slot.previous;
+            head.next->previous = &head;
+            head.previous->next = &head;
+            slot.previous = &slot;
+            slot.next = &slot;
+        }
+    }
+
+    inline void TimerWheel::pushBack(Link& head, Link& link)
+    {
+        link.next = &head;
+        link.previous = head.previous;
+        head.previous->next = &link;
+        head.previous = &link;
+    }
+
+    inline void TimerWheel::unlink(Link& link)
+    {
+        link.previous->next = link.next;
+        link.next->previous = link.previous;
+        link.previous = 0;
+        link.next = 0;
+    }
+}
+}
+
+#endif  // __LIBS101_UTIL_TIMERWHEEL_HPP
@@ -0,0 +1,297 @@
+/*
+    libs101 -- C++ 03 implementation of the S101 encoding and decoding
+    Copyright (C) 2012-2014  L-S-B Broadcast Technologies GmbH
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+#include "s101/util/TimerWheel.hpp"
+
+#define THROW_TEST_EXCEPTION(message)                       \
+            {                                               \
+                std::ostringstream msgStream;               \
+                msgStream << message ;                      \
+                throw std::runtime_error(msgStream.str());  \
+            }
+
+namespace
+{
+    typedef libs101::util::TimerWheel TimerWheel;
+    typedef TimerWheel::tick_type tick_type;
+
+    /**
+     * A timer which records the tick it expired at.
+     */
+    class RecordingTimer : public TimerWheel::Timer
+    {
+        public:
+            RecordingTimer()
+                : expirations(0)
+                , expiredAt(0)
+            {}
+
+            unsigned int expirations;
+            tick_type expiredAt;
+
+        protected:
+            virtual void expired(TimerWheel& wheel)
+            {
+                // The wheel has moved on to the tick following the one being processed.
+                ++expirations;
+                expiredAt = wheel.now() - 1;
+            }
+    };
+
+    /**
+     * A timer which reschedules itself a number of times.
+     */
+    class RepeatingTimer : public TimerWheel::Timer
+    {
+        public:
+            RepeatingTimer(tick_type interval, unsigned int repetitions)
+                : interval(interval)
+                , repetitions(repetitions)
+                , expirations(0)
+            {}
+
+            tick_type interval;
+            unsigned int repetitions;
+            unsigned int expirations;
+
+        protected:
+            virtual void expired(TimerWheel& wheel)
+            {
+                if (++expirations < repetitions)
+                {
+                    wheel.schedule(*this, wheel.now() - 1 + interval);
+                }
+            }
+    };
+
+    /**
+     * Returns true if @p tick lies before @p reference, tolerating wrap-around.
+     */
+    bool isBefore(tick_type tick, tick_type reference)
+    {
+        return static_cast<long>(tick - reference) < 0;
+    }
+
+    /**
+     * Verifies that idleTicks never exceeds the distance to the next due timer.
+     * @param wheel The wheel to examine.
+     * @param timers The timers which may be scheduled on the wheel.
+     */
+    void checkIdleTicks(TimerWheel const& wheel, std::vector<RecordingTimer*> const& timers)
+    {
+        tick_type const idle = wheel.idleTicks();
+        for (std::size_t i = 0; i < timers.size(); ++i)
+        {
+            RecordingTimer const& timer = *timers[i];
+            if (timer.isScheduled() && isBefore(timer.deadline(), wheel.now()) == false && timer.deadline() - wheel.now() < idle)
+            {
+                THROW_TEST_EXCEPTION("idleTicks returned " << idle << " at tick " << wheel.now() << " although timer " << i << " is due at " << timer.deadline());
+            }
+        }
+    }
+
+    /**
+     * Verifies that the upper levels are taken into account on a boundary of the
+     * lowest level.
+     */
+    void testIdleTicksOnBoundary()
+    {
+        TimerWheel wheel(0);
+        RecordingTimer timer;
+        wheel.schedule(timer, 100);
+        wheel.advance(63);
+
+        if (wheel.idleTicks() != 0)
+        {
+            THROW_TEST_EXCEPTION("idleTicks returned " << wheel.idleTicks() << " before the pending redistribution");
+        }
+
+        wheel.advance(64);
+        if (wheel.idleTicks() != 35)
+        {
+            THROW_TEST_EXCEPTION("idleTicks returned " << wheel.idleTicks() << " instead of 35 after the redistribution");
+        }
+
+        wheel.advance(99);
+        if (timer.expirations != 0)
+        {
+            THROW_TEST_EXCEPTION("A timer expired before its deadline");
+        }
+
+        wheel.advance(100);
+        if (timer.expirations != 1 || timer.expiredAt != 100 || wheel.empty() == false)
+        {
+            THROW_TEST_EXCEPTION("A timer did not expire at its deadline");
+        }
+    }
+
+    /**
+     * Schedules, cancels and advances random timers and compares each expiration
+     * with a reference model that simply remembers the deadline of each timer.
+     * @param start The initial tick of the wheel.
+     * @param seed The seed of the random numbers.
+     */
+    void testRandomized(tick_type start, unsigned int seed)
+    {
+        std::size_t const count = 512;
+        std::srand(seed);
+
+        TimerWheel wheel(start);
+        std::vector<RecordingTimer*> timers;
+        std::vector<tick_type> deadlines(count, 0);
+        std::vector<bool> scheduled(count, false);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            timers.push_back(new RecordingTimer());
+        }
+
+        try
+        {
+            tick_type now = start;
+            std::size_t expected = 0;
+            for (int step = 0; step < 20000; ++step)
+            {
+                std::size_t const index = static_cast<std::size_t>(std::rand()) % count;
+                int const operation = std::rand() % 8;
+
+                if (operation < 4)
+                {
+                    // Short, medium and far distances reach all levels of the wheel.
+                    tick_type const ranges[] = { 70, 5000, 300000, 20000000 };
+                    tick_type const deadline = wheel.now() + static_cast<tick_type>(std::rand()) % ranges[operation];
+                    expected += scheduled[index] ? 0 : 1;
+                    wheel.schedule(*timers[index], deadline);
+                    deadlines[index] = deadline;
+                    scheduled[index] = true;
+                }
+                else if (operation == 4)
+                {
+                    expected -= scheduled[index] ? 1 : 0;
+                    wheel.cancel(*timers[index]);
+                    scheduled[index] = false;
+                }
+                else
+                {
+                    checkIdleTicks(wheel, timers);
+
+                    // Either jump to the next tick the wheel asks for, or far ahead.
+                    tick_type const idle = wheel.idleTicks();
+                    tick_type const target = operation == 7 ? now + static_cast<tick_type>(std::rand()) % 100000 : wheel.now() + (idle < 1000 ? idle : 1000);
+                    std::vector<unsigned int> before(count);
+                    for (std::size_t i = 0; i < count; ++i)
+                    {
+                        before[i] = timers[i]->expirations;
+                    }
+
+                    wheel.advance(target);
+                    now = target;
+
+                    for (std::size_t i = 0; i < count; ++i)
+                    {
+                        bool const isDue = scheduled[i] && isBefore(now, deadlines[i]) == false;
+                        bool const hasExpired = timers[i]->expirations != before[i];
+                        if (isDue != hasExpired)
+                        {
+                            THROW_TEST_EXCEPTION("Timer " << i << " due at " << deadlines[i] << (hasExpired ? " expired" : " did not expire") << " when advancing to " << now);
+                        }
+
+                        if (hasExpired)
+                        {
+                            if (timers[i]->expiredAt != deadlines[i] || timers[i]->isScheduled())
+                            {
+                                THROW_TEST_EXCEPTION("Timer " << i << " due at " << deadlines[i] << " expired at " << timers[i]->expiredAt);
+                            }
+
+                            scheduled[i] = false;
+                            --expected;
+                        }
+                    }
+                }
+
+                if (wheel.size() != expected)
+                {
+                    THROW_TEST_EXCEPTION("The wheel holds " << wheel.size() << " instead of " << expected << " timers");
+                }
+            }
+        }
+        catch (...)
+        {
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                delete timers[i];
+            }
+            throw;
+        }
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            delete timers[i];
+        }
+
+        if (wheel.empty() == false)
+        {
+            THROW_TEST_EXCEPTION("Destroyed timers are still scheduled");
+        }
+    }
+
+    /**
+     * Verifies that timers may reschedule themselves from their callback.
+     */
+    void testRescheduling()
+    {
+        TimerWheel wheel(10);
+        RepeatingTimer timer(7, 100);
+        wheel.schedule(timer, 17);
+
+        for (tick_type tick = 10; tick <= 17 + 7 * 100; tick += 3)
+        {
+            wheel.advance(tick);
+        }
+
+        if (timer.expirations != 100 || timer.isScheduled())
+        {
+            THROW_TEST_EXCEPTION("A repeating timer expired " << timer.expirations << " instead of 100 times");
+        }
+    }
+}
+
+int main(int, char const* const*)
+{
+    try
+    {
+        testIdleTicksOnBoundary();
+        testRandomized(0, 1);
+        testRandomized(12345, 2);
+
+        // The tick counter wraps around while the timers are scheduled.
+        testRandomized(~tick_type(0) - 200000, 3);
+        testRescheduling();
+    }
+    catch (std::exception const& e)
+    {
+        std::cerr << "ERROR: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -20,6 +20,17 @@ solution "EmberPlus SDK"
         defines   { "LIBEMBER_DLL" }
 
 
+    -- Enable the allocation counters of libember, see ember/util/Instrumentation.hpp
+    newoption {
+        trigger     = "with-instrumentation",
+        description = "Count the allocations and live objects of libember"
+    }
+
+    if _OPTIONS["with-instrumentation"] then
+        configuration { }
+            defines   { "LIBEMBER_INSTRUMENTATION" }
+    end
+
     -- Disable Visual Studio security warnings
     configuration { "vs*" }
         defines   { "_CRT_SECURE_NO_DEPRECATE" }
@@ -103,6 +114,24 @@ solution "EmberPlus SDK"
         files       { "libember/Tests/util/StreamBuffer.cpp" }
         includedirs { "libember/Headers" }
 
+    project "EmberPlus Library Test - SegmentedOctetStream"
+        -- Common settings for all configurations of this project
+        language    "C++"
+        kind        "ConsoleApp"
+        targetname   "test-libemeber-segmentedoctetstream"
+        files       { "libember/Tests/util/SegmentedOctetStream.cpp" }
+        includedirs { "libember/Headers" }
+        links       { "EmberPlus C++ Library" } 
+
+    project "EmberPlus Library Test - MultiByteArray"
+        -- Common settings for all configurations of this project
+        language    "C++"
+        kind        "ConsoleApp"
+        targetname   "test-libemeber-multibytearray"
+        files       { "libember/Tests/ber/MultiByteArray.cpp" }
+        includedirs { "libember/Headers" }
+        links       { "EmberPlus C++ Library" } 
+
     project "EmberPlus Library Test - GlowValue"
         -- Common settings for all configurations of this project
         language    "C++"
@@ -112,6 +141,301 @@ solution "EmberPlus SDK"
         includedirs { "libember/Headers" }
         links       { "EmberPlus C++ Library" } 
 
+    project "EmberPlus Library Test - GlowElementNumber"
+        -- Common settings for all configurations of this project
+        language    "C++"
+        kind        "ConsoleApp"
+        targetname   "test-libemeber-glowelementnumber"
+        files       { "libember/Tests/glow/GlowElementNumber.cpp" }
+        includedirs { "libember/Headers" }
+        links       { "EmberPlus C++ Library" } 
+
+    project "EmberPlus Library Test - GlowValueLocale"
+        -- Common settings for all configurations of this project
+        language    "C++"
+        kind        "ConsoleApp"
+        targetname   "test-libemeber-glowvaluelocale"
+        files       { "libember/Tests/glow/GlowValueLocale.cpp" }
+        includedirs { "libember/Headers" }
+        links       { "EmberPlus C++ Library" } 
+
+    project "EmberPlus Library Test - CompliesWithSchema"
+        -- Common settings for all configurations of this project
+        language    "C++"
+        kind        "ConsoleApp"
+        targetname   "test-libemeber-complieswithschema"
+        files       { "libember/Tests/glow/CompliesWithSchema.cpp" }
+        includedirs { "libember/Headers" }
+        links       { "EmberPlus C++ Library" } 
+
+    project "EmberPlus Library Test - AsyncDomReader"
+        -- Common settings for all configurations of this project
+        language    "C++"
+        kind        "ConsoleApp"
+        targetname   "test-libemeber-asyncdomreader"
+        files       { "libember/Tests/dom/AsyncDomReader.cpp" }
+        includedirs { "libember/Headers" }
+        links       { "EmberPlus C++ Library" } 
+
+    -- The parallel readers and work stealing executor tests use posix threads
+    if not os.is("windows") then
+        project "EmberPlus Library Test - ParallelReaders"
+            -- Common settings for all configurations of this project
+            language    "C++"
+            kind        "ConsoleApp"
+            targetname   "test-libemeber-parallelreaders"
+            files       { "libember/Tests/dom/ParallelReaders.cpp" }
+            includedirs { "libember/Headers" }
+            links       { "EmberPlus C++ Library", "pthread" }
+
+        project "EmberPlus Library Test - WorkStealingExecutor"
+            -- Common settings for all configurations of this project
+            language    "C++"
+            kind        "ConsoleApp"
+            targetname   "test-libemeber-workstealingexecutor"
+            files       { "libember/Tests/dom/WorkStealingExecutor.cpp" }
+            includedirs { "libember/Headers" }
+            links       { "EmberPlus C++ Library", "pthread" }
+    end
+
+    project "EmberPlus Library Test - GlowTreeMirror"
+        -- Common settings for all configurations of this project
+        language    "C++"
+        kind        "ConsoleApp"
+        targetname   "test-libemeber-glowtreemirror"
+        files       { "libember/Tests/glow/GlowTreeMirror.cpp", "libember/Tests/glow/TreeGenerator.hpp" }
+        includedirs { "libember/Headers" }
+        links       { "EmberPlus C++ Library" } 
+
+    project "EmberPlus Library Test - GlowTreeDiff"
+        -- Common settings for all configurations of this project
+        language    "C++"
+        kind        "ConsoleApp"
+        targetname   "test-libemeber-glowtreediff"
+        files       { "libember/Tests/glow/GlowTreeDiff.cpp" }
+        includedirs { "libember/Headers" }
+        links       { "EmberPlus C++ Library" } 
+
+    project "EmberPlus Library Test - GlowConnectionTable"
+        -- Common settings for all configurations of this project
+        language    "C++"
+        kind        "ConsoleApp"
+        targetname   "test-libemeber-glowconnectiontable"
+        files       { "libember/Tests/glow/GlowConnectionTable.cpp" }
+        includedirs { "libember/Headers" }
+        links       { "EmberPlus C++ Library" } 
+
+    project "EmberPlus Library Test - CrosspointMatrix"
+        -- Common settings for all configurations of this project
+        language    "C++"
+        kind        "ConsoleApp"
+        targetname   "test-libemeber-crosspointmatrix"
+        files       { "libember/Tests/glow/CrosspointMatrix.cpp" }
+        includedirs { "libember/Headers" }
+        links       { "EmberPlus C++ Library" } 
+
+    project "EmberPlus Library Test - GlowStreamDecoder"
+        -- Common settings for all configurations of this project
+        language    "C++"
+        kind        "ConsoleApp"
+        targetname   "test-libemeber-glowstreamdecoder"
+        files       { "libember/Tests/glow/GlowStreamDecoder.cpp" }
+        includedirs { "libember/Headers" }
+        links       { "EmberPlus C++ Library" } 
+
+    project "EmberPlus Library Test - EnumerationPool"
+        -- Common settings for all configurations of this project
+        language    "C++"
+        kind        "ConsoleApp"
+        targetname   "test-libemeber-enumerationpool"
+        files       { "libember/Tests/glow/EnumerationPool.cpp" }
+        includedirs { "libember/Headers" }
+        links       { "EmberPlus C++ Library" } 
+
+    project "EmberPlus Library Test - GlowInvocationTable"
+        -- Common settings for all configurations of this project
+        language    "C++"
+        kind        "ConsoleApp"
+        targetname   "test-libemeber-glowinvocationtable"
+        files       { "libember/Tests/glow/GlowInvocationTable.cpp" }
+        includedirs { "libember/Headers" }
+        links       { "EmberPlus C++ Library" } 
+
+    project "EmberPlus Library Test - GlowProxy"
+        -- Common settings for all configurations of this project
+        language    "C++"
+        kind        "ConsoleApp"
+        targetname   "test-libemeber-glowproxy"
+        files       { "libember/Tests/glow/GlowProxy.cpp" }
+        includedirs { "libember/Headers" }
+        links       { "EmberPlus C++ Library" } 
+
+    project "EmberPlus Library Test - GlowSession"
+        -- Common settings for all configurations of this project
+        language    "C++"
+        kind        "ConsoleApp"
+        targetname   "test-libemeber-glowsession"
+        files       { "libember/Tests/glow/GlowSession.cpp" }
+        includedirs { "libember/Headers" }
+        links       { "EmberPlus C++ Library" } 
+
+    project "EmberPlus Library Test - GlowTreeBrowser"
+        -- Common settings for all configurations of this project
+        language    "C++"
+        kind        "ConsoleApp"
+        targetname   "test-libemeber-glowtreebrowser"
+        files       { "libember/Tests/glow/GlowTreeBrowser.cpp" }
+        includedirs { "libember/Headers" }
+        links       { "EmberPlus C++ Library" } 
+
+    project "EmberPlus Library Test - GlowSchemaValidation"
+        -- Common settings for all configurations of this project
+        language    "C++"
+        kind        "ConsoleApp"
+        targetname   "test-libemeber-glowschemavalidation"
+        files       { "libember/Tests/glow/GlowSchemaValidation.cpp" }
+        includedirs { "libember/Headers" }
+        links       { "EmberPlus C++ Library" } 
+
+    project "EmberPlus Library Test - GlowRequestEncoder"
+        -- Common settings for all configurations of this project
+        language    "C++"
+        kind        "ConsoleApp"
+        targetname   "test-libemeber-glowrequestencoder"
+        files       { "libember/Tests/glow/GlowRequestEncoder.cpp" }
+        includedirs { "libember/Headers" }
+        links       { "EmberPlus C++ Library" } 
+
+    project "EmberPlus Library Test - GlowWriter"
+        -- Common settings for all configurations of this project
+        language    "C++"
+        kind        "ConsoleApp"
+        targetname   "test-libemeber-glowwriter"
+        files       { "libember/Tests/glow/GlowWriter.cpp" }
+        includedirs { "libember/Headers" }
+        links       { "EmberPlus C++ Library" } 
+
+    project "EmberPlus Library Test - SharedNode"
+        -- Common settings for all configurations of this project
+        language    "C++"
+        kind        "ConsoleApp"
+        targetname   "test-libemeber-sharednode"
+        files       { "libember/Tests/dom/SharedNode.cpp" }
+        includedirs { "libember/Headers" }
+        links       { "EmberPlus C++ Library" } 
+
+    project "EmberPlus Library Test - LengthCache"
+        -- Common settings for all configurations of this project
+        language    "C++"
+        kind        "ConsoleApp"
+        targetname   "test-libemeber-lengthcache"
+        files       { "libember/Tests/dom/LengthCache.cpp" }
+        includedirs { "libember/Headers" }
+        links       { "EmberPlus C++ Library" } 
+
+    project "EmberPlus Library Test - LazyDocument"
+        -- Common settings for all configurations of this project
+        language    "C++"
+        kind        "ConsoleApp"
+        targetname   "test-libemeber-lazydocument"
+        files       { "libember/Tests/dom/LazyDocument.cpp" }
+        includedirs { "libember/Headers" }
+        links       { "EmberPlus C++ Library" } 
+
+    project "EmberPlus Library Test - FlatTree"
+        -- Common settings for all configurations of this project
+        language    "C++"
+        kind        "ConsoleApp"
+        targetname   "test-libemeber-flattree"
+        files       { "libember/Tests/dom/FlatTree.cpp" }
+        includedirs { "libember/Headers" }
+        links       { "EmberPlus C++ Library" } 
+
+    project "EmberPlus Library Test - GlowElementCollection"
+        -- Common settings for all configurations of this project
+        language    "C++"
+        kind        "ConsoleApp"
+        targetname   "test-libemeber-glowelementcollection"
+        files       { "libember/Tests/glow/GlowElementCollection.cpp" }
+        includedirs { "libember/Headers" }
+        links       { "EmberPlus C++ Library" } 
+
+    project "EmberPlus Library Test - ContainerInsert"
+        -- Common settings for all configurations of this project
+        language    "C++"
+        kind        "ConsoleApp"
+        targetname   "test-libemeber-containerinsert"
+        files       { "libember/Tests/dom/ContainerInsert.cpp" }
+        includedirs { "libember/Headers" }
+        links       { "EmberPlus C++ Library" } 
+
+    project "S101 Library Test - TimerWheel"
+        -- Common settings for all configurations of this project
+        language    "C++"
+        kind        "ConsoleApp"
+        targetname  "test-libs101-timerwheel"
+        files       { "libs101/Tests/util/TimerWheel.cpp" }
+        includedirs { "libs101/Headers" }
+
+    project "EmberPlus Library Benchmark - Container"
+        -- Common settings for all configurations of this project
+        language    "C++"
+        kind        "ConsoleApp"
+        targetname  "benchmark-libember-container"
+        files       { "libember/Tests/dom/ContainerBenchmark.cpp" }
+        includedirs { "libember/Headers" }
+        links       { "EmberPlus C++ Library" } 
+
+    project "EmberPlus Library Benchmark - Codec"
+        -- Common settings for all configurations of this project
+        language    "C++"
+        kind        "ConsoleApp"
+        targetname  "benchmark-libember-codec"
+        files       { "libember/Tests/glow/CodecBenchmark.cpp", "libember/Tests/glow/CountingAllocator.hpp", "libember/Tests/glow/TreeGenerator.hpp" }
+        includedirs { "libember/Headers", "libs101/Headers" }
+        links       { "EmberPlus C++ Library" }
+
+    project "EmberPlus Library Tool - Heap Footprint"
+        -- Common settings for all configurations of this project
+        language    "C++"
+        kind        "ConsoleApp"
+        targetname  "tool-libember-footprint"
+        files       { "libember/Tests/glow/HeapFootprint.cpp", "libember/Tests/glow/CountingAllocator.hpp", "libember/Tests/glow/TreeGenerator.hpp" }
+        includedirs { "libember/Headers", "libs101/Headers" }
+        links       { "EmberPlus C++ Library" }
+
+    project "EmberPlus Library Tool - Tree Generator"
+        -- Common settings for all configurations of this project
+        language    "C++"
+        kind        "ConsoleApp"
+        targetname  "tool-libember-treegen"
+        files       { "libember/Tests/glow/TreeGenerator.hpp", "libember/Tests/glow/TreeGenerator.cpp" }
+        includedirs { "libember/Headers", "libs101/Headers" }
+        links       { "EmberPlus C++ Library" }
+
+    project "EmberPlus Library Tool - S101 Replay"
+        -- Common settings for all configurations of this project
+        -- The libember_slim sources are compiled in, since libember_slim does not export its symbols
+        language    "C++"
+        kind        "ConsoleApp"
+        targetname  "tool-libember-s101replay"
+        files       { "libember/Tests/glow/S101Replay.cpp", "libember/Tests/glow/CountingAllocator.hpp", "libember_slim/Source/**.h", "libember_slim/Source/**.c" }
+        excludes    { "**__sample*" }
+        includedirs { "libember/Headers", "libs101/Headers", "libember_slim/Source" }
+        links       { "EmberPlus C++ Library" }
+
+    -- The load test uses posix sockets and reads the provider statistics from /proc
+    if not os.is("windows") then
+        project "EmberPlus Library Tool - Load Test"
+            -- Common settings for all configurations of this project
+            language    "C++"
+            kind        "ConsoleApp"
+            targetname  "tool-libember-loadtest"
+            files       { "libember/Tests/glow/LoadTest.cpp" }
+            includedirs { "libember/Headers", "libs101/Headers" }
+            links       { "EmberPlus C++ Library" }
+    end
+
     project "EmberPlus Library Sample - Static BER Codec"
         -- Common settings for all configurations of this project
         language    "C++"
@@ -153,3 +477,13 @@ solution "EmberPlus SDK"
             kind      "SharedLib"
             defines   { "LIBEMBER_DLL_EXPORTS" }
 
+    project "EmberPlus C Library Benchmark - Glow"
+        -- Common settings for all configurations of this project
+        -- The library sources are compiled in, since libember_slim does not export its symbols
+        language    "C"
+        kind        "ConsoleApp"
+        targetname  "benchmark-libember_slim-glow"
+        files       { "libember_slim/Tests/GlowBenchmark.c", "libember_slim/Source/**.h", "libember_slim/Source/**.c" }
+        excludes    { "**__sample*" }
+        includedirs { "libember_slim/Source" }
+
@@ -10,6 +10,11 @@ BooleanView::BooleanView(QWidget* parent, gadget::BooleanParameter* parameter)
 {
     m_view->setupUi(this);
     m_parameter->registerListener(this);
+
+    m_refreshTimer.setSingleShot(true);
+    m_refreshTimer.setInterval(16);
+    connect(&m_refreshTimer, SIGNAL(timeout()), this, SLOT(updateUi()));
+
     updateUi();
 }
 
@@ -78,6 +83,7 @@ void BooleanView::updateAccess(int access)
 
 void BooleanView::notifyStateChanged(gadget::ParameterFieldState const& state, gadget::Parameter const*)
 {
-    updateUi();
+    if (m_refreshTimer.isActive() == false)
+        m_refreshTimer.start();
 }
 
@@ -2,6 +2,7 @@
 #define __TINYEMBER_BOOLEANVIEW_H
 
 #include <qframe.h>
+#include <qtimer.h>
 #include "gadget/Parameter.h"
 #include "ui_BooleanView.h"
 
@@ -52,13 +53,14 @@ class BooleanView : public QFrame, gadget::Parameter::DirtyStateListener
 
     private:
         /**
-         * Updates the user interface.
+         * Schedules an update of the user interface.
          * @param state The new parameter state.
          */
         virtual void notifyStateChanged(gadget::ParameterFieldState const& state, gadget::Parameter const*);
 
     private:
         Ui::BooleanView* m_view;
+        QTimer m_refreshTimer;
         gadget::BooleanParameter* m_parameter;
 };
 
@@ -23,6 +23,10 @@ EnumerationView::EnumerationView(QWidget* parent, gadget::EnumParameter* paramet
     updateUi();
     m_view->valueComboBox->blockSignals(false);
     m_parameter->registerListener(this);
+
+    m_refreshTimer.setSingleShot(true);
+    m_refreshTimer.setInterval(16);
+    connect(&m_refreshTimer, SIGNAL(timeout()), this, SLOT(updateUi()));
 }
 
 EnumerationView::~EnumerationView(void)
@@ -287,5 +291,6 @@ void EnumerationView::updateStreamOffset()
 
 void EnumerationView::notifyStateChanged(gadget::ParameterFieldState const& state, gadget::Parameter const*)
 {
-    updateUi();
+    if (m_refreshTimer.isActive() == false)
+        m_refreshTimer.start();
 }
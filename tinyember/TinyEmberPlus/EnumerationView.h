@@ -2,6 +2,7 @@
 #define __TINYEMBER_ENUMERATIONVIEW_H
 
 #include <qframe.h>
+#include <qtimer.h>
 #include "gadget/Parameter.h"
 #include "ui_EnumerationView.h"
 
@@ -86,13 +87,14 @@ class EnumerationView : public QFrame, gadget::Parameter::DirtyStateListener
 
     private:
         /**
-         * Updates the user interface.
+         * Schedules an update of the user interface.
          * @param state The new parameter state.
          */
         virtual void notifyStateChanged(gadget::ParameterFieldState const& state, gadget::Parameter const*);
 
     private:
         Ui::EnumerationView* m_view;
+        QTimer m_refreshTimer;
         gadget::EnumParameter* m_parameter;
 };
 
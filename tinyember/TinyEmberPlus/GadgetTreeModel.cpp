@@ -0,0 +1,291 @@
+#include <algorithm>
+#include "GadgetTreeModel.h"
+#include "util\StringConverter.h"
+
+GadgetTreeModel::GadgetTreeModel(QObject* parent)
+    : QAbstractItemModel(parent)
+    , m_root(nullptr)
+    , m_rootIcon(":/image/resources/globe-medium.png")
+    , m_nodeIcon(":/image/resources/globe-small.png")
+    , m_parameterIcon(":/image/resources/leaf.png")
+{
+}
+
+void GadgetTreeModel::setRoot(gadget::Node* root)
+{
+    beginResetModel();
+    m_root = root;
+    m_rows.clear();
+    m_rowIndex.clear();
+    endResetModel();
+}
+
+gadget::Node* GadgetTreeModel::root() const
+{
+    return m_root;
+}
+
+TreeWidgetItemData GadgetTreeModel::entity(QModelIndex const& index) const
+{
+    if (index.isValid())
+    {
+        auto const parent = static_cast<gadget::Node const*>(index.internalPointer());
+        if (parent == nullptr)
+            return TreeWidgetItemData(m_root);
+
+        auto const& rows = this->rows(parent);
+        auto const row = static_cast<std::size_t>(index.row());
+        if (row < rows.parameters.size())
+            return TreeWidgetItemData(rows.parameters[row]);
+        else if (row - rows.parameters.size() < rows.nodes.size())
+            return TreeWidgetItemData(rows.nodes[row - rows.parameters.size()]);
+    }
+
+    return TreeWidgetItemData();
+}
+
+QModelIndex GadgetTreeModel::indexOf(gadget::Node* node) const
+{
+    if (node == nullptr)
+        return QModelIndex();
+
+    auto const parent = node->parent();
+    if (parent == nullptr)
+        return node == m_root ? createIndex(0, 0, static_cast<void*>(nullptr)) : QModelIndex();
+
+    rows(parent);
+    auto const result = m_rowIndex.find(node);
+    return result != m_rowIndex.end()
+        ? createIndex(result->second, 0, const_cast<gadget::Node*>(parent))
+        : QModelIndex();
+}
+
+QModelIndex GadgetTreeModel::indexOf(gadget::Parameter* parameter) const
+{
+    if (parameter == nullptr)
+        return QModelIndex();
+
+    auto const parent = parameter->parent();
+    rows(parent);
+    auto const result = m_rowIndex.find(parameter);
+    return result != m_rowIndex.end()
+        ? createIndex(result->second, 0, const_cast<gadget::Node*>(parent))
+        : QModelIndex();
+}
+
+void GadgetTreeModel::insert(gadget::Node* node)
+{
+    auto const parent = node->parent();
+    auto const cached = m_rows.find(parent);
+
+    // When the view hasn't asked for the children of the parent yet, they are read
+    // from the tree as soon as it does.
+    if (cached != m_rows.end())
+    {
+        auto& rows = cached->second;
+        auto const row = static_cast<int>(rows.parameters.size() + rows.nodes.size());
+        beginInsertRows(indexOf(const_cast<gadget::Node*>(parent)), row, row);
+        rows.nodes.push_back(node);
+        m_rowIndex[node] = row;
+        endInsertRows();
+    }
+}
+
+void GadgetTreeModel::insert(std::vector<gadget::Node*> const& nodes)
+{
+    if (nodes.empty())
+        return;
+
+    auto const parent = nodes.front()->parent();
+    auto const cached = m_rows.find(parent);
+
+    // All rows are inserted at once, so the view is updated only once for the whole sequence.
+    if (cached != m_rows.end())
+    {
+        auto& rows = cached->second;
+        auto row = static_cast<int>(rows.parameters.size() + rows.nodes.size());
+        beginInsertRows(indexOf(const_cast<gadget::Node*>(parent)), row, row + static_cast<int>(nodes.size()) - 1);
+        rows.nodes.reserve(rows.nodes.size() + nodes.size());
+        for each(auto node in nodes)
+        {
+            rows.nodes.push_back(node);
+            m_rowIndex[node] = row++;
+        }
+
+        endInsertRows();
+    }
+}
+
+void GadgetTreeModel::insert(gadget::Parameter* parameter)
+{
+    auto const parent = parameter->parent();
+    auto const cached = m_rows.find(parent);
+    if (cached != m_rows.end())
+    {
+        auto& rows = cached->second;
+        auto const row = static_cast<int>(rows.parameters.size());
+        beginInsertRows(indexOf(const_cast<gadget::Node*>(parent)), row, row);
+        rows.parameters.push_back(parameter);
+        updateRowIndex(rows);
+        endInsertRows();
+    }
+}
+
+void GadgetTreeModel::remove(QModelIndex const& index)
+{
+    if (index.isValid() == false)
+        return;
+
+    auto const parent = static_cast<gadget::Node const*>(index.internalPointer());
+    auto const row = index.row();
+    auto const data = entity(index);
+
+    beginRemoveRows(index.parent(), row, row);
+
+    if (parent == nullptr)
+    {
+        release(m_root);
+        m_root = nullptr;
+    }
+    else
+    {
+        auto& rows = m_rows[parent];
+        if (data.type().value() == TreeWidgetItemDataType::Node)
+        {
+            auto const node = data.payload<gadget::Node>();
+            release(node);
+            rows.nodes.erase(std::find(rows.nodes.begin(), rows.nodes.end(), node));
+            m_rowIndex.erase(node);
+        }
+        else
+        {
+            auto const parameter = data.payload<gadget::Parameter>();
+            rows.parameters.erase(std::find(rows.parameters.begin(), rows.parameters.end(), parameter));
+            m_rowIndex.erase(parameter);
+        }
+
+        updateRowIndex(rows);
+    }
+
+    endRemoveRows();
+}
+
+QModelIndex GadgetTreeModel::index(int row, int column, QModelIndex const& parent) const
+{
+    if (column != 0 || row < 0 || row >= rowCount(parent))
+        return QModelIndex();
+
+    return parent.isValid()
+        ? createIndex(row, column, nodeAt(parent))
+        : createIndex(row, column, static_cast<void*>(nullptr));
+}
+
+QModelIndex GadgetTreeModel::parent(QModelIndex const& child) const
+{
+    if (child.isValid() == false)
+        return QModelIndex();
+
+    auto const parent = static_cast<gadget::Node*>(child.internalPointer());
+    return parent != nullptr
+        ? indexOf(parent)
+        : QModelIndex();
+}
+
+int GadgetTreeModel::rowCount(QModelIndex const& parent) const
+{
+    if (parent.isValid() == false)
+        return m_root != nullptr ? 1 : 0;
+
+    auto const node = nodeAt(parent);
+    if (node != nullptr)
+    {
+        auto const& rows = this->rows(node);
+        return static_cast<int>(rows.parameters.size() + rows.nodes.size());
+    }
+
+    return 0;
+}
+
+int GadgetTreeModel::columnCount(QModelIndex const&) const
+{
+    return 1;
+}
+
+QVariant GadgetTreeModel::data(QModelIndex const& index, int role) const
+{
+    auto const data = entity(index);
+    auto const type = data.type().value();
+
+    if (type == TreeWidgetItemDataType::Node)
+    {
+        auto const node = data.payload<gadget::Node>();
+        if (role == Qt::DisplayRole)
+            return ::util::StringConverter::toUtf8QString(node->identifier());
+        else if (role == Qt::DecorationRole)
+            return node->parent() == nullptr ? m_rootIcon : m_nodeIcon;
+    }
+    else if (type == TreeWidgetItemDataType::Parameter)
+    {
+        auto const parameter = data.payload<gadget::Parameter>();
+        if (role == Qt::DisplayRole)
+            return ::util::StringConverter::toUtf8QString(parameter->identifier());
+        else if (role == Qt::DecorationRole)
+            return m_parameterIcon;
+    }
+
+    return QVariant();
+}
+
+GadgetTreeModel::Rows& GadgetTreeModel::rows(gadget::Node const* node) const
+{
+    auto const result = m_rows.find(node);
+    if (result != m_rows.end())
+        return result->second;
+
+    auto& rows = m_rows[node];
+    auto const& parameters = node->parameters();
+    auto const& nodes = node->nodes();
+    rows.parameters.assign(parameters.begin(), parameters.end());
+    rows.nodes.assign(nodes.begin(), nodes.end());
+    updateRowIndex(rows);
+    return rows;
+}
+
+void GadgetTreeModel::updateRowIndex(Rows const& rows) const
+{
+    auto row = 0;
+    for each(auto parameter in rows.parameters)
+        m_rowIndex[parameter] = row++;
+
+    for each(auto node in rows.nodes)
+        m_rowIndex[node] = row++;
+}
+
+void GadgetTreeModel::release(gadget::Node const* node)
+{
+    auto const result = m_rows.find(node);
+    if (result != m_rows.end())
+    {
+        auto rows = Rows();
+        rows.parameters.swap(result->second.parameters);
+        rows.nodes.swap(result->second.nodes);
+        m_rows.erase(result);
+
+        for each(auto parameter in rows.parameters)
+            m_rowIndex.erase(parameter);
+
+        for each(auto child in rows.nodes)
+        {
+            release(child);
+            m_rowIndex.erase(child);
+        }
+    }
+}
+
+gadget::Node* GadgetTreeModel::nodeAt(QModelIndex const& index) const
+{
+    auto const data = entity(index);
+    return data.type().value() == TreeWidgetItemDataType::Node
+        ? data.payload<gadget::Node>()
+        : nullptr;
+}
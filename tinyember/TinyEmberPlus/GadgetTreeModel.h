@@ -0,0 +1,150 @@
+#ifndef __TINYEMBER_GADGETTREEMODEL_H
+#define __TINYEMBER_GADGETTREEMODEL_H
+
+#include <unordered_map>
+#include <vector>
+#include <qabstractitemmodel.h>
+#include <qicon.h>
+#include "TreeWidgetItemData.h"
+
+/**
+ * Item model which presents a gadget tree to the gadget tree view. Instead of creating
+ * an item for each entity, the model reads the tree directly and only caches the
+ * children of the nodes the view has asked for, so the cost of loading a tree
+ * with thousands of parameters does not depend on its size.
+ * An index refers to an entity by its row and the node that owns it. The rows of a
+ * node contain its parameters first, followed by its child nodes.
+ * Since the model caches the rows, entities that are created or deleted while the
+ * tree is shown must be reported by insert and remove.
+ */
+class GadgetTreeModel : public QAbstractItemModel
+{
+    public:
+        /**
+         * Initializes a new, empty model.
+         * @param parent The parent object.
+         */
+        explicit GadgetTreeModel(QObject* parent);
+
+        /**
+         * Replaces the displayed tree. The model does not own the tree.
+         * @param root The root of the new tree, may be nullptr.
+         */
+        void setRoot(gadget::Node* root);
+
+        /**
+         * Returns the root of the displayed tree.
+         * @return The root of the displayed tree, or nullptr.
+         */
+        gadget::Node* root() const;
+
+        /**
+         * Returns the entity an index refers to.
+         * @param index The index to resolve.
+         * @return The node or parameter, or an empty object if the index is invalid.
+         */
+        TreeWidgetItemData entity(QModelIndex const& index) const;
+
+        /**
+         * Returns the index of the passed node.
+         * @param node The node to look for.
+         * @return The index of the node.
+         */
+        QModelIndex indexOf(gadget::Node* node) const;
+
+        /**
+         * Returns the index of the passed parameter.
+         * @param parameter The parameter to look for.
+         * @return The index of the parameter.
+         */
+        QModelIndex indexOf(gadget::Parameter* parameter) const;
+
+        /**
+         * Adds a row for a node that has just been appended to its parent.
+         * @param node The new node.
+         */
+        void insert(gadget::Node* node);
+
+        /**
+         * Adds the rows for a sequence of nodes that have just been appended to their
+         * common parent, for example by NodeFactory::createNodes().
+         * @param nodes The new nodes.
+         */
+        void insert(std::vector<gadget::Node*> const& nodes);
+
+        /**
+         * Adds a row for a parameter that has just been appended to its parent.
+         * @param parameter The new parameter.
+         */
+        void insert(gadget::Parameter* parameter);
+
+        /**
+         * Removes the row of an entity that is about to be deleted, including the rows
+         * of all of its descendants. The entity must be deleted afterwards.
+         * @param index The index of the entity to remove.
+         */
+        void remove(QModelIndex const& index);
+
+        /** @see QAbstractItemModel::index() */
+        virtual QModelIndex index(int row, int column, QModelIndex const& parent = QModelIndex()) const;
+
+        /** @see QAbstractItemModel::parent() */
+        virtual QModelIndex parent(QModelIndex const& child) const;
+
+        /** @see QAbstractItemModel::rowCount() */
+        virtual int rowCount(QModelIndex const& parent = QModelIndex()) const;
+
+        /** @see QAbstractItemModel::columnCount() */
+        virtual int columnCount(QModelIndex const& parent = QModelIndex()) const;
+
+        /** @see QAbstractItemModel::data() */
+        virtual QVariant data(QModelIndex const& index, int role = Qt::DisplayRole) const;
+
+    private:
+        /** The cached children of a node, in the order of their rows. */
+        struct Rows
+        {
+            std::vector<gadget::Parameter*> parameters;
+            std::vector<gadget::Node*> nodes;
+        };
+
+        typedef std::unordered_map<gadget::Node const*, Rows> RowsCollection;
+        typedef std::unordered_map<void const*, int> RowIndex;
+
+        /**
+         * Returns the rows of the passed node and reads them from the node, if they
+         * have not been cached yet.
+         * @param node The node whose rows to return.
+         * @return The rows of the node.
+         */
+        Rows& rows(gadget::Node const* node) const;
+
+        /**
+         * Updates the row numbers of all children of a node.
+         * @param rows The children whose row numbers to update.
+         */
+        void updateRowIndex(Rows const& rows) const;
+
+        /**
+         * Drops the cached rows of a node and all its descendants.
+         * @param node The node whose rows to drop.
+         */
+        void release(gadget::Node const* node);
+
+        /**
+         * Returns the node an index refers to.
+         * @param index The index to resolve.
+         * @return The node, or nullptr if the index is invalid or refers to a parameter.
+         */
+        gadget::Node* nodeAt(QModelIndex const& index) const;
+
+    private:
+        gadget::Node* m_root;
+        mutable RowsCollection m_rows;
+        mutable RowIndex m_rowIndex;
+        QIcon m_rootIcon;
+        QIcon m_nodeIcon;
+        QIcon m_parameterIcon;
+};
+
+#endif//__TINYEMBER_GADGETTREEMODEL_H
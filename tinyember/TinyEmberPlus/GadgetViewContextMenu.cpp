@@ -2,6 +2,7 @@
 #include <qmenu.h>
 #include "CreateNodeDialog.h"
 #include "CreateParameterDialog.h"
+#include "GadgetTreeModel.h"
 #include "GadgetViewContextMenu.h"
 #include "TreeWidgetItemData.h"
 #include "gadget\Node.h"
@@ -18,10 +19,11 @@
 
 using namespace gadget;
 
-GadgetViewContextMenu::GadgetViewContextMenu(::glow::ConsumerProxy* proxy, QTreeWidget* view, QPoint const& cursor)
+GadgetViewContextMenu::GadgetViewContextMenu(::glow::ConsumerProxy* proxy, QTreeView* view, GadgetTreeModel* model, QPoint const& cursor)
     : m_view(view)
+    , m_model(model)
     , m_proxy(proxy)
-    , m_item(view->currentItem())
+    , m_index(view->currentIndex())
     , m_position(view->mapToGlobal(cursor))
     , m_removeItem(false)
 {
@@ -29,9 +31,9 @@ GadgetViewContextMenu::GadgetViewContextMenu(::glow::ConsumerProxy* proxy, QTree
 
 void GadgetViewContextMenu::exec()
 {
-    if (m_item != nullptr)
+    if (m_index.isValid())
     {
-        auto const data = m_item->data(1, 0).value<TreeWidgetItemData>();
+        auto const data = m_model->entity(m_index);
         auto const type = data.type();
         if (type.value() == TreeWidgetItemDataType::Node)
         {
@@ -42,7 +44,10 @@ void GadgetViewContextMenu::exec()
                 exec(node);
                 if (m_removeItem)
                 {
-                    delete m_item;
+                    if (m_proxy)
+                        m_proxy->flushNotifications();
+
+                    m_model->remove(m_index);
                     delete node;
                 }
             }
@@ -56,13 +61,13 @@ void GadgetViewContextMenu::exec()
                 exec(parameter);
                 if (m_removeItem)
                 {
-                    delete m_item;
+                    m_model->remove(m_index);
                     delete parameter;
                 }
             }
         }
     }
-    else
+    else if (m_model->root() == nullptr)
     {
         QMenu menu;
         auto const newnode = menu.addAction(QIcon(":/image/resources/node-insert-child.png"), "Create Node...");
@@ -75,14 +80,10 @@ void GadgetViewContextMenu::exec()
                 auto const identifier = dialog.identifier();
                 auto const description = dialog.description();
                 auto root = NodeFactory::createRoot(identifier);
-                auto item = new QTreeWidgetItem(m_view);
 
                 root->setDescription(description);
-                item->setIcon(0, QIcon(":/image/resources/globe-medium.png"));
-                item->setText(0, ::util::StringConverter::toUtf8QString(root->identifier()));
-                item->setData(1, 0, QVariant::fromValue(TreeWidgetItemData(root)));
-
-                m_view->setCurrentItem(item);
+                m_model->setRoot(root);
+                m_view->setCurrentIndex(m_model->indexOf(root));
             }
         }
     }
@@ -125,12 +126,9 @@ void GadgetViewContextMenu::exec(gadget::Node* parent)
             auto const identifier = dialog.identifier();
             auto const description = dialog.description();
             auto node = NodeFactory::createNode(parent, identifier);
-            auto item = new QTreeWidgetItem(m_item);
 
             node->setDescription(description);
-            item->setIcon(0, QIcon(":/image/resources/globe-small.png"));
-            item->setText(0, ::util::StringConverter::toUtf8QString(node->identifier()));
-            item->setData(1, 0, QVariant::fromValue(TreeWidgetItemData(node)));
+            m_model->insert(node);
         }
     }
     else if (selection == newparameter)
@@ -171,11 +169,8 @@ void GadgetViewContextMenu::exec(gadget::Node* parent)
 
             if (parameter != nullptr)
             {
-                auto item = new QTreeWidgetItem(m_item);
                 parameter->setDescription(description);
-                item->setIcon(0, QIcon(":/image/resources/leaf.png"));
-                item->setText(0, ::util::StringConverter::toUtf8QString(parameter->identifier()));
-                item->setData(1, 0, QVariant::fromValue(TreeWidgetItemData(parameter)));
+                m_model->insert(parameter);
             }
         }
     }
@@ -3,7 +3,10 @@
 
 #include "gadget\Node.h"
 #include "gadget\Parameter.h"
-#include <qtreewidget.h>
+#include <qtreeview.h>
+
+/** Forward declarations */
+class GadgetTreeModel;
 
 namespace glow {
     class ConsumerProxy;
@@ -19,9 +22,11 @@ class GadgetViewContextMenu
          * Initializes a new GadgetViewContext menu.
          * @param proxy The proxy which manages the client connections.
          * @param view A pointer to the gadget tree view.
+         * @param model The model of the gadget tree view, which is updated when an entity
+         *      is created or removed.
          * @param cursor The top-left position of the context menu.
          */
-        GadgetViewContextMenu(::glow::ConsumerProxy* proxy, QTreeWidget* view, QPoint const& cursor);
+        GadgetViewContextMenu(::glow::ConsumerProxy* proxy, QTreeView* view, GadgetTreeModel* model, QPoint const& cursor);
 
         /**
          * Runs the context menu.
@@ -42,8 +47,9 @@ class GadgetViewContextMenu
         void exec(gadget::Parameter* parameter);
 
     private:
-        QTreeWidget *const m_view;
-        QTreeWidgetItem * const m_item;
+        QTreeView *const m_view;
+        GadgetTreeModel *const m_model;
+        QModelIndex const m_index;
         QPoint const m_position;
         ::glow::ConsumerProxy* m_proxy;
         bool m_removeItem;
@@ -12,6 +12,10 @@ IntegerView::IntegerView(QWidget* parent, gadget::IntegerParameter* parameter)
     m_view->setupUi(this);
     m_parameter->registerListener(this);
 
+    m_refreshTimer.setSingleShot(true);
+    m_refreshTimer.setInterval(16);
+    connect(&m_refreshTimer, SIGNAL(timeout()), this, SLOT(updateUi()));
+
     auto streamFormats = util::StreamFormatConverter();
     for each(auto& entry in streamFormats)
     {
@@ -289,5 +293,6 @@ void IntegerView::updateStreamOffset()
 
 void IntegerView::notifyStateChanged(gadget::ParameterFieldState const& state, gadget::Parameter const*)
 {
-    updateUi();
+    if (m_refreshTimer.isActive() == false)
+        m_refreshTimer.start();
 }
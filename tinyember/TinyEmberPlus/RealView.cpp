@@ -12,6 +12,10 @@ RealView::RealView(QWidget* parent, gadget::RealParameter* parameter)
     m_view->setupUi(this);
     m_parameter->registerListener(this);
 
+    m_refreshTimer.setSingleShot(true);
+    m_refreshTimer.setInterval(16);
+    connect(&m_refreshTimer, SIGNAL(timeout()), this, SLOT(updateUi()));
+
     auto streamFormats = util::StreamFormatConverter();
     for each(auto& entry in streamFormats)
     {
@@ -288,5 +292,6 @@ void RealView::updateStreamOffset()
 
 void RealView::notifyStateChanged(gadget::ParameterFieldState const& state, gadget::Parameter const*)
 {
-    updateUi();
+    if (m_refreshTimer.isActive() == false)
+        m_refreshTimer.start();
 }
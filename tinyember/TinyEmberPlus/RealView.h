@@ -2,6 +2,7 @@
 #define __TINYEMBER_REALVIEW_H
 
 #include <qframe.h>
+#include <qtimer.h>
 #include "gadget/Parameter.h"
 #include "ui_RealView.h"
 
@@ -99,7 +100,7 @@ class RealView : public QFrame, gadget::Parameter::DirtyStateListener
 
     private:
         /**
-         * Updates the user interface.
+         * Schedules an update of the user interface.
          * @param state The new parameter state.
          */
         virtual void notifyStateChanged(gadget::ParameterFieldState const& state, gadget::Parameter const*);
@@ -107,6 +108,7 @@ class RealView : public QFrame, gadget::Parameter::DirtyStateListener
     private:
         gadget::RealParameter* m_parameter;
         Ui::RealView* m_view;
+        QTimer m_refreshTimer;
 };
 
 #endif//__TINYEMBER_REALVIEW_H
@@ -10,6 +10,11 @@ StringView::StringView(QWidget* parent, gadget::StringParameter* parameter)
 {
     m_view->setupUi(this);
     m_parameter->registerListener(this);
+
+    m_refreshTimer.setSingleShot(true);
+    m_refreshTimer.setInterval(16);
+    connect(&m_refreshTimer, SIGNAL(timeout()), this, SLOT(updateUi()));
+
     updateUi();
 }
 
@@ -132,6 +137,7 @@ void StringView::updateStreamIdentifier()
 
 void StringView::notifyStateChanged(gadget::ParameterFieldState const& state, gadget::Parameter const*)
 {
-    updateUi();
+    if (m_refreshTimer.isActive() == false)
+        m_refreshTimer.start();
 }
 
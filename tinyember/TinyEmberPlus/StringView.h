@@ -2,6 +2,7 @@
 #define __TINYEMBER_STRINGVIEW_H
 
 #include <qframe.h>
+#include <qtimer.h>
 #include "gadget/Parameter.h"
 #include "ui_StringView.h"
 
@@ -60,13 +61,14 @@ class StringView : public QFrame, gadget::Parameter::DirtyStateListener
 
     private:
         /**
-         * Updates the user interface.
+         * Schedules an update of the user interface.
          * @param state The new parameter state.
          */
         virtual void notifyStateChanged(gadget::ParameterFieldState const& state, gadget::Parameter const*);
 
     private:
         Ui::StringView* m_view;
+        QTimer m_refreshTimer;
         gadget::StringParameter* m_parameter;
 };
 
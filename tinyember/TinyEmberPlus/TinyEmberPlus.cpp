@@ -3,23 +3,63 @@
 #include "gadget\StreamManager.h"
 #include "glow\ConsumerRequestProcessor.h"
 #include "glow\ConsumerProxy.h"
-#include "glow\util\StreamConverter.h"
 #include "serialization\Archive.h"
 #include "util\StringConverter.h"
+#include "GadgetTreeModel.h"
 #include "GadgetViewContextMenu.h"
 #include "TinyEmberPlus.h"
 #include "TreeWidgetItemData.h"
 #include "ViewFactory.h"
 #include <ember\Ember.hpp>
+#include <algorithm>
+#include <set>
 #include <sstream>
 #include <qdialog.h>
 #include <qfileinfo.h>
 #include <qfiledialog.h>
+#include <qthreadpool.h>
+#include <qtconcurrentmap.h>
 
 using namespace ::glow;
 using namespace ::libember;
 using namespace ::serialization;
 
+namespace
+{
+    /**
+     * Transmits the partial responses of the ConsumerRequestProcessor to all connected consumers.
+     */
+    class ProxyResponseWriter : public ConsumerRequestProcessor::ResponseWriter
+    {
+        public:
+            /**
+             * Initializes a new writer.
+             * @param proxy The proxy to transmit the responses with, may be nullptr.
+             */
+            explicit ProxyResponseWriter(ConsumerProxy* proxy)
+                : m_proxy(proxy)
+            {}
+
+            virtual void write(libember::glow::GlowRootElementCollection const* response)
+            {
+                if (m_proxy != nullptr)
+                    m_proxy->write(response, net::TcpClient::BulkPriority);
+            }
+
+            virtual bool writeChangesSince(long sequence, long& current)
+            {
+                if (m_proxy == nullptr)
+                    return false;
+
+                current = m_proxy->sequence();
+                return m_proxy->writeChangesSince(sequence);
+            }
+
+        private:
+            ConsumerProxy* const m_proxy;
+    };
+}
+
 const QString TinyEmberPlus::NotificationBehavior = "NotificationBehavior";
 const QString TinyEmberPlus::ResponseBehavior = "ResponseBehavior";
 const QString TinyEmberPlus::AlwaysReportOnlineState = "AlwaysReportOnlineState";
@@ -27,6 +67,10 @@ const QString TinyEmberPlus::AutoLoadConfig = "AutoLoadConfig";
 const QString TinyEmberPlus::ConfigurationName = "ConfigurationName";
 const QString TinyEmberPlus::GenerateRandomValues = "GenerateRandomValues";
 const QString TinyEmberPlus::StreamTimerInterval = "StreamTimerInterval";
+const QString TinyEmberPlus::StreamGroupIntervals = "StreamGroupIntervals";
+const QString TinyEmberPlus::SimulationRate = "SimulationRate";
+const QString TinyEmberPlus::SimulationStreamCount = "SimulationStreamCount";
+const QString TinyEmberPlus::SimulationFirstIdentifier = "SimulationFirstIdentifier";
 const QString TinyEmberPlus::SendKeepAliveRequest = "SendKeepAliveRequest";
 const QString TinyEmberPlus::UseEnumMap = "UseEnumMap";
 
@@ -34,12 +78,23 @@ TinyEmberPlus::TinyEmberPlus(::glow::ConsumerProxy* proxy, QWidget *parent, Qt::
     : QMainWindow(parent, flags)
     , m_proxy(proxy)
     , m_settingsSerializer("Settings.xml")
+    , m_import(nullptr)
+    , m_isResumePosted(false)
     , m_generateRandomValues(false)
     , m_sendKeepAlive(false)
     , m_lastKeepAliveTransmitTime(QDateTime::currentDateTimeUtc())
+    , m_streamScheduler(100)
 {
+    // The consumers register and unregister their subscribers from the network thread.
+    qRegisterMetaType<gadget::Subscriber*>("gadget::Subscriber*");
+    m_requestClock.start();
+
     m_dialog.setupUi(this);
     m_dialog.gadgetTreeView->setContextMenuPolicy( Qt::CustomContextMenu );
+
+    m_treeModel = new GadgetTreeModel(this);
+    m_dialog.gadgetTreeView->setModel(m_treeModel);
+    connect(m_dialog.gadgetTreeView->selectionModel(), SIGNAL(currentChanged(QModelIndex, QModelIndex)), this, SLOT(treeItemChanged(QModelIndex, QModelIndex)));
     m_dialog.portHintLabel->setText(QString("Listening on TCP/IP port ") + QVariant(proxy->port()).toString());
 
     m_timer = new QTimer(this);
@@ -47,9 +102,17 @@ TinyEmberPlus::TinyEmberPlus(::glow::ConsumerProxy* proxy, QWidget *parent, Qt::
     m_timer->setSingleShot(false);
     m_timer->start(500);
 
+    m_simulationTimer = nullptr;
+
+    m_streamTimer = new QTimer(this);
+    m_streamTimer->setSingleShot(true);
+    m_streamTimer->start(500);
+    m_streamClock.start();
+
     setWindowIcon(QIcon(":/image/resources/document-globe.png"));
     setWindowTitle(title());
     connect(m_timer, SIGNAL(timeout()), this, SLOT(timer()));
+    connect(m_streamTimer, SIGNAL(timeout()), this, SLOT(streamTimer()));
     
     auto const notificationBehavior = m_settingsSerializer.getOption(NotificationBehavior);
     auto const notificationBehaviorIndex = m_dialog.boxNotificationBehavior->findText(notificationBehavior);
@@ -104,6 +167,25 @@ TinyEmberPlus::TinyEmberPlus(::glow::ConsumerProxy* proxy, QWidget *parent, Qt::
         m_dialog.streamIntervalBox->setValue(streamTimer);
     }
 
+    m_streamScheduler.setDefaultInterval(m_dialog.streamIntervalBox->value());
+
+    // Format: "<stream identifier>:<interval in ms>", separated by commas
+    auto const groupIntervals = m_settingsSerializer.getOption(StreamGroupIntervals).split(',', QString::SkipEmptyParts);
+    for each(auto const& entry in groupIntervals)
+    {
+        auto const pair = entry.split(':');
+        if (pair.size() == 2)
+        {
+            auto identifierValid = false;
+            auto intervalValid = false;
+            auto const identifier = pair[0].trimmed().toInt(&identifierValid);
+            auto const interval = pair[1].trimmed().toInt(&intervalValid);
+
+            if (identifierValid && intervalValid)
+                m_streamScheduler.setInterval(identifier, interval);
+        }
+    }
+
     auto const sendKeepAlive = m_settingsSerializer.getOption(SendKeepAliveRequest).toLower() == "true";
     if (sendKeepAlive)
     {
@@ -111,56 +193,41 @@ TinyEmberPlus::TinyEmberPlus(::glow::ConsumerProxy* proxy, QWidget *parent, Qt::
     }
 
     m_dialog.checkAutoLoadConfig->setChecked(loadConfig);
+
+    // The simulation is meant for load tests of consumers and is only enabled via the
+    // settings file: the rate in Hz, the number of streams and the first stream identifier.
+    auto const simulationRate = m_settingsSerializer.getOption(SimulationRate, 0);
+    auto const simulationStreamCount = m_settingsSerializer.getOption(SimulationStreamCount, 0);
+    if (simulationRate > 0 && simulationStreamCount > 0)
+    {
+        auto const first = m_settingsSerializer.getOption(SimulationFirstIdentifier, 1);
+        m_streamSimulator.setStreams(first, simulationStreamCount, QThreadPool::globalInstance()->maxThreadCount());
+
+        m_simulationTimer = new QTimer(this);
+        m_simulationTimer->setSingleShot(false);
+        m_simulationTimer->start(std::max(1000 / simulationRate, 1));
+        connect(m_simulationTimer, SIGNAL(timeout()), this, SLOT(simulationTimer()));
+    }
 }
 
 TinyEmberPlus::~TinyEmberPlus()
 {
-    treeItemChanged(nullptr, nullptr);
+    treeItemChanged(QModelIndex(), QModelIndex());
+    delete m_import;
 }
 
 void TinyEmberPlus::rebuildTree(gadget::Node* root)
 {
-    treeItemChanged(nullptr, nullptr);
-    delete this->root();
+    treeItemChanged(QModelIndex(), QModelIndex());
+    m_proxy->flushNotifications();
 
-    m_dialog.gadgetTreeView->clear();
+    // The model only reads the rows the view displays, so the tree is not traversed here.
+    auto const previous = this->root();
+    m_treeModel->setRoot(root);
+    delete previous;
 
     if (root != nullptr)
-    {
         root->registerListener(m_proxy);
-
-        auto item = new QTreeWidgetItem(m_dialog.gadgetTreeView);
-        item->setIcon(0, QIcon(":/image/resources/globe-medium.png"));
-        item->setText(0, ::util::StringConverter::toUtf8QString(root->identifier()));
-        item->setData(1, 0, QVariant::fromValue(TreeWidgetItemData(root)));
-
-        rebuildTree(root, item);
-    }
-}
-
-void TinyEmberPlus::rebuildTree(gadget::Node* parent, QTreeWidgetItem* owner)
-{
-    auto& parameters = parent->parameters();
-    auto& children = parent->nodes();
-
-    for each(auto parameter in parameters)
-    {
-        auto const icon = QIcon(":/image/resources/leaf.png");
-        auto const item = new QTreeWidgetItem(owner);
-        item->setIcon(0, icon);
-        item->setText(0, ::util::StringConverter::toUtf8QString(parameter->identifier()));
-        item->setData(1, 0, QVariant::fromValue(TreeWidgetItemData(parameter)));
-    }
-
-    for each(auto node in children)
-    {
-        auto const icon = QIcon(":/image/resources/globe-small.png");
-        auto const item = new QTreeWidgetItem(owner);
-        item->setIcon(0, icon);
-        item->setText(0, ::util::StringConverter::toUtf8QString(node->identifier()));
-        item->setData(1, 0, QVariant::fromValue(TreeWidgetItemData(node)));
-        rebuildTree(node, item);
-    }
 }
 
 QString TinyEmberPlus::title() const
@@ -174,39 +241,54 @@ QString TinyEmberPlus::title() const
 
 gadget::Node* TinyEmberPlus::root()
 {
-    auto const view = m_dialog.gadgetTreeView;
-    auto const& children = view->children();
-    if (children.empty() == false)
-    {
-        auto const item = view->topLevelItem(0);
-        if (item != nullptr)
-        {
-            auto const data = item->data(1, 0).value<TreeWidgetItemData>();
-            if (data.type().value() == TreeWidgetItemDataType::Node)
-            {
-                auto node = data.payload<gadget::Node>();
-                return node;
-            }
-        }
-    }
-
-    return nullptr;
+    return m_treeModel->root();
 }
 
 void TinyEmberPlus::loadFile(QString const& filename)
 {
-    Archive archive;
-    auto root = archive.deserialize(filename.toStdString());
+    // The file is imported in batches, so the tree can be shown and served while it is loaded.
+    delete m_import;
+    m_import = new ArchiveImport(filename.toStdString(), this);
+    importBatch();
+}
 
-    if (root != nullptr)
+void TinyEmberPlus::importBatch()
+{
+    if (m_import == nullptr)
+        return;
+
+    auto const hasMore = m_import->step();
+    auto const root = m_import->root();
+
+    if (root != nullptr && root != this->root())
     {
         rebuildTree(root);
 
-        QFileInfo info(filename);
+        QFileInfo info(QString::fromStdString(m_import->filename()));
         m_dialog.configurationName->setText(info.fileName());
         m_settingsSerializer.setOption(ConfigurationName, info.fileName());
         m_settingsSerializer.save();
     }
+
+    if (hasMore)
+    {
+        QTimer::singleShot(0, this, SLOT(importBatch()));
+    }
+    else
+    {
+        delete m_import;
+        m_import = nullptr;
+    }
+}
+
+void TinyEmberPlus::nodeImported(gadget::Node* node)
+{
+    m_treeModel->insert(node);
+}
+
+void TinyEmberPlus::parameterImported(gadget::Parameter* parameter)
+{
+    m_treeModel->insert(parameter);
 }
 
 void TinyEmberPlus::loadFile()
@@ -215,7 +297,7 @@ void TinyEmberPlus::loadFile()
         this,
         "Load EmBER File...",
         QString(),
-        "*.EmBER");
+        "*.EmBER;;*.snapshot");
 
     if (filename.isEmpty() == false)
     {
@@ -227,7 +309,7 @@ void TinyEmberPlus::saveFile()
 {
     auto root = this->root();
     auto filename = m_dialog.configurationName->text();
-    if (filename.toLower().endsWith(".ember") == false)
+    if (filename.toLower().endsWith(".ember") == false && filename.toLower().endsWith(".snapshot") == false)
         filename += ".EmBER";
 
     Archive archive;
@@ -241,7 +323,7 @@ void TinyEmberPlus::saveFileAs()
         this,
         "Save EmBER Configuration...",
         QString(),
-        "*.EmBER");
+        "*.EmBER;;*.snapshot");
 
     if (filename.isEmpty() == false && root != nullptr)
     {
@@ -260,18 +342,18 @@ void TinyEmberPlus::exit()
     close();
 }
 
-void TinyEmberPlus::treeItemChanged(QTreeWidgetItem* item, QTreeWidgetItem*)
+void TinyEmberPlus::treeItemChanged(QModelIndex const& index, QModelIndex const&)
 {
     auto first = std::begin(m_dialog.entityView->children());
     auto const last = std::end(m_dialog.entityView->children());
     for (; first != last; ++first)
         delete *first;
 
-    if (item != nullptr)
+    if (index.isValid())
     {
         auto parent = m_dialog.entityView;
         auto view = static_cast<QFrame*>(nullptr);
-        auto const data = item->data(1, 0).value<TreeWidgetItemData>();
+        auto const data = m_treeModel->entity(index);
         auto const type = data.type();
         if (type.value() == TreeWidgetItemDataType::Node)
         {
@@ -296,7 +378,11 @@ void TinyEmberPlus::treeItemChanged(QTreeWidgetItem* item, QTreeWidgetItem*)
 
 void TinyEmberPlus::showContextMenu(QPoint cursor)
 {
-    auto menu = GadgetViewContextMenu(m_proxy, m_dialog.gadgetTreeView, cursor);
+    // The import still appends entities to the tree, so none may be removed meanwhile.
+    if (m_import != nullptr)
+        return;
+
+    auto menu = GadgetViewContextMenu(m_proxy, m_dialog.gadgetTreeView, m_treeModel, cursor);
     menu.exec();
 }
 
@@ -347,22 +433,6 @@ void TinyEmberPlus::generateRandomValuesStateChanged(bool state)
 
 void TinyEmberPlus::timer()
 {
-    auto& manager = gadget::StreamManager::instance();
-    if (manager.size() > 0)
-    {
-        if (m_generateRandomValues)
-            manager.updateValues();
-
-        auto proxy = m_proxy;
-        auto root = libember::glow::GlowStreamCollection::create();
-        ::glow::util::StreamConverter::create(root, manager);
-
-        if (proxy != nullptr && root->size() > 0)
-            proxy->write(root);
-
-        delete root;
-    }
-
     auto const now = QDateTime::currentDateTimeUtc();
     if (m_sendKeepAlive)
     {
@@ -374,11 +444,39 @@ void TinyEmberPlus::timer()
     }
 }
 
+void TinyEmberPlus::simulationTimer()
+{
+    QtConcurrent::blockingMap(m_streamSimulator.slices(), &glow::util::StreamSimulator::generate);
+
+    auto proxy = m_proxy;
+    if (m_streamPublisher.publish(m_streamSimulator.begin(), m_streamSimulator.end()) && proxy != nullptr)
+    {
+        auto const& frames = m_streamPublisher.frames();
+        proxy->write(QByteArray(reinterpret_cast<char const*>(frames.data()), static_cast<int>(frames.size())));
+    }
+}
+
+void TinyEmberPlus::streamTimer()
+{
+    auto& manager = gadget::StreamManager::instance();
+    if (m_streamScheduler.update(manager, m_streamClock.elapsed(), m_generateRandomValues))
+    {
+        auto proxy = m_proxy;
+        if (m_streamPublisher.publish(manager) && proxy != nullptr)
+        {
+            auto const& frames = m_streamPublisher.frames();
+            proxy->write(QByteArray(reinterpret_cast<char const*>(frames.data()), static_cast<int>(frames.size())));
+        }
+    }
+
+    m_streamTimer->start(m_streamScheduler.timeUntilNextUpdate(m_streamClock.elapsed()));
+}
+
 void TinyEmberPlus::updateStreamTimer()
 {
     auto const interval = m_dialog.streamIntervalBox->value();
 
-    m_timer->setInterval(interval);
+    m_streamScheduler.setDefaultInterval(interval);
     m_settingsSerializer.setOption(StreamTimerInterval, QVariant::fromValue(interval).toString());
     m_settingsSerializer.save();
 }
@@ -409,7 +507,135 @@ void TinyEmberPlus::notifyAsync(libember::dom::Node* node, gadget::Subscriber* s
     if (subscriber != nullptr)
         subscriber->addRef();
 
-    QMetaObject::invokeMethod(this, "synchronizedNotify", Q_ARG(void*, node), Q_ARG(void*, subscriber));
+    // This method is called by the network thread. Only the first request of a burst
+    // posts an event, the following ones are executed along with it.
+    auto request = Request();
+    request.node = node;
+    request.subscriber = subscriber;
+    request.offset = 0;
+
+    QMutexLocker const lock(&m_requestMutex);
+    m_requests.push_back(request);
+
+    if (m_requests.size() == 1)
+        QMetaObject::invokeMethod(this, "processRequests", Qt::QueuedConnection);
+}
+
+void TinyEmberPlus::processRequests()
+{
+    {
+        QMutexLocker const lock(&m_requestMutex);
+        m_backlog.insert(m_backlog.end(), m_requests.begin(), m_requests.end());
+        m_requests.clear();
+    }
+
+    // While a time slice has been used up, new requests wait behind the remaining ones
+    // until resumeRequests is invoked, so the other events are processed in between.
+    if (m_isResumePosted == false)
+        executeBacklog();
+}
+
+void TinyEmberPlus::resumeRequests()
+{
+    m_isResumePosted = false;
+    executeBacklog();
+}
+
+void TinyEmberPlus::executeBacklog()
+{
+    auto const deadline = m_requestClock.nsecsElapsed() + Q_INT64_C(1000) * RequestTimeSlice;
+
+    // The responses are sent to all consumers, so a directory request that equals an
+    // earlier one of the same slice has already been answered, unless a request in
+    // between has modified the tree.
+    auto answered = std::set<std::string>();
+    while (m_backlog.empty() == false)
+    {
+        auto& request = m_backlog.front();
+        if (request.offset == 0 && request.node != nullptr && ConsumerRequestProcessor::isDirectoryRequest(request.node))
+        {
+            libember::util::OctetStream stream;
+            request.node->encode(stream);
+
+            if (answered.insert(std::string(stream.begin(), stream.end())).second == false)
+            {
+                delete request.node;
+
+                if (request.subscriber != nullptr)
+                    request.subscriber->releaseRef();
+
+                m_backlog.pop_front();
+                continue;
+            }
+        }
+        else
+        {
+            answered.clear();
+        }
+
+        auto const isComplete = executeSlice(request, deadline);
+        if (isComplete)
+            m_backlog.pop_front();
+
+        if (isComplete == false || (m_backlog.empty() == false && m_requestClock.nsecsElapsed() >= deadline))
+        {
+            m_isResumePosted = true;
+            QMetaObject::invokeMethod(this, "resumeRequests", Qt::QueuedConnection);
+            return;
+        }
+    }
+}
+
+bool TinyEmberPlus::executeSlice(Request& request, qint64 deadline)
+{
+    auto const collection = dynamic_cast<libember::glow::GlowRootElementCollection const*>(request.node);
+    auto const root = this->root();
+
+    // Only a root element collection can be split into several parts.
+    if (collection == nullptr || root == nullptr)
+    {
+        synchronizedNotify(request.node, request.subscriber);
+        return true;
+    }
+
+    auto const last = collection->end();
+    auto first = collection->begin();
+    std::advance(first, request.offset);
+
+    do
+    {
+        auto next = first;
+        for (auto count = 0; count < RequestSliceElements && next != last; ++count, ++request.offset)
+            ++next;
+
+        executeElements(first, next, root, request.subscriber);
+        first = next;
+    }
+    while (first != last && m_requestClock.nsecsElapsed() < deadline);
+
+    if (first != last)
+        return false;
+
+    delete request.node;
+
+    if (request.subscriber != nullptr)
+        request.subscriber->releaseRef();
+
+    return true;
+}
+
+void TinyEmberPlus::executeElements(libember::dom::Container::const_iterator first, libember::dom::Container::const_iterator last, gadget::Node* root, gadget::Subscriber* subscriber)
+{
+    auto transmit = false;
+    auto response = libember::glow::GlowRootElementCollection::create();
+    auto proxy = m_proxy;
+    auto writer = ProxyResponseWriter(proxy);
+    ConsumerRequestProcessor::execute(first, last, root, response, transmit, subscriber, &writer);
+
+    if (transmit && proxy != nullptr)
+        proxy->write(response, net::TcpClient::BulkPriority);
+
+    delete response;
 }
 
 void TinyEmberPlus::registerSubscriberAsync(gadget::Subscriber* subscriber)
@@ -456,16 +682,8 @@ void TinyEmberPlus::synchronizedNotify(void* nodeptr, void* subscriberptr)
         if (type.value() == libember::glow::GlowType::RootElementCollection
         &&  root != nullptr)
         {
-            auto transmit = false;
-            auto response = libember::glow::GlowRootElementCollection::create();
-            auto collection = dynamic_cast<libember::glow::GlowRootElementCollection*>(node);
-            auto proxy = m_proxy;
-            ConsumerRequestProcessor::execute(collection, root, response, transmit, subscriber);
-
-            if (transmit && proxy != nullptr)
-                proxy->write(response);
-
-            delete response;
+            auto const collection = dynamic_cast<libember::glow::GlowRootElementCollection const*>(node);
+            executeElements(collection->begin(), collection->end(), root, subscriber);
         }
 
         delete node;
@@ -1,16 +1,24 @@
 #ifndef TINYEMBERPLUS_H
 #define TINYEMBERPLUS_H
 
+#include <deque>
+#include <vector>
 #include <QtGui/QMainWindow>
+#include <qabstractitemmodel.h>
 #include <qdatetime.h>
+#include <qelapsedtimer.h>
+#include <qmutex.h>
 #include <qtimer.h>
+#include "gadget\StreamScheduler.h"
 #include "glow\ProviderInterface.h"
+#include "glow\util\StreamPublisher.h"
+#include "glow\util\StreamSimulator.h"
+#include "serialization\ArchiveImport.h"
 #include "serialization\SettingsSerializer.h"
 #include "ui_TinyEmberPlus.h"
 
 /** Forward declarations */
-class QModelIndex;
-class QTreeWidgetItem;
+class GadgetTreeModel;
 
 namespace gadget
 {
@@ -26,7 +34,7 @@ namespace glow
 /**
  * The MainWindow of the TinyEmber+ application.
  */
-class TinyEmberPlus : public QMainWindow, public glow::ProviderInterface
+class TinyEmberPlus : public QMainWindow, public glow::ProviderInterface, private serialization::ArchiveImport::Listener
 {
     Q_OBJECT
     public:
@@ -51,6 +59,15 @@ class TinyEmberPlus : public QMainWindow, public glow::ProviderInterface
         virtual void unregisterSubscriberAsync(gadget::Subscriber* subscriber);
 
     public slots:
+        /**
+         * Executes all consumer requests that have been queued by notifyAsync since
+         * the last call. A burst of requests is handled within a single event, so the
+         * resulting notifications can be coalesced. The requests are executed in time
+         * slices of RequestTimeSlice microseconds, the requests that remain when a slice
+         * has been used up are executed after the other events of the ui thread.
+         */
+        void processRequests();
+
         /**
          * All consumer requests are marhsalled to the ui thread and then executed.
          * @param nodeptr The pointer to the decoded node that has been sent by
@@ -72,11 +89,23 @@ class TinyEmberPlus : public QMainWindow, public glow::ProviderInterface
         void unregisterSubscriber(gadget::Subscriber* subscriber);
 
     private slots:
+        /**
+         * Continues executing the queued consumer requests when the last time slice
+         * has been used up.
+         */
+        void resumeRequests();
+
         /**
          * Loads a file that contains an ember tree which represents the data of the provider.
          */
         void loadFile();
 
+        /**
+         * Imports the next batch of the file that is currently being loaded. When the
+         * root node has been decoded, it replaces the current configuration.
+         */
+        void importBatch();
+
         /**
          * Saves the current provider configuration to a file.
          */
@@ -96,9 +125,9 @@ class TinyEmberPlus : public QMainWindow, public glow::ProviderInterface
         /**
          * This method is invoked when the selection of the gadget treeview changed.
          * In that case, a view for the new item will be created.
-         * @param item The currently selected item.
+         * @param index The index of the currently selected item.
          */
-        void treeItemChanged(QTreeWidgetItem* item, QTreeWidgetItem*);
+        void treeItemChanged(QModelIndex const& index, QModelIndex const&);
 
         /**
          * Display a context menu to create or remove a node or parameter.
@@ -111,6 +140,19 @@ class TinyEmberPlus : public QMainWindow, public glow::ProviderInterface
          */
         void timer();
 
+        /**
+         * Updates the stream groups that are due, transmits the modified values within a single
+         * stream collection and restarts the stream timer for the next group that becomes due.
+         */
+        void streamTimer();
+
+        /**
+         * Generates new values for all simulated streams and transmits them within a single
+         * stream collection. The slices of the simulation are generated on the threads of
+         * the global thread pool.
+         */
+        void simulationTimer();
+
         /**
          * Updates the notification behavior.
          * @param index The index of the new behavior.
@@ -136,8 +178,8 @@ class TinyEmberPlus : public QMainWindow, public glow::ProviderInterface
         void generateRandomValuesStateChanged(bool state);
 
         /**
-         * The timer slot is used to modify the values of parameters with stream identifier.
-         * The values are only updated when the 'Generate random values' option is active.
+         * Applies the stream interval from the dialog to all stream groups that do not
+         * have an interval of their own.
          */
         void updateStreamTimer();
 
@@ -171,29 +213,88 @@ class TinyEmberPlus : public QMainWindow, public glow::ProviderInterface
         QString title() const;
 
         /**
-         * Rebuilds the tree view.
-         * @param root The root node of the current configuration.
+         * Replaces the current configuration and rebuilds the tree view.
+         * @param root The root node of the new configuration.
          */
         void rebuildTree(gadget::Node* root);
 
-        /**
-         * Rebuilds the tree view.
-         * @param parent The current gadget node.
-         * @param owner The treeview item owning the current node.
-         */
-        void rebuildTree(gadget::Node* parent, QTreeWidgetItem* owner);
-
         /**
          * Loads a new configuration from the specified file.
          * @param filename The name of the file to load.
          */
         void loadFile(QString const& filename);
 
+        /** @see serialization::ArchiveImport::Listener::nodeImported() */
+        virtual void nodeImported(gadget::Node* node);
+
+        /** @see serialization::ArchiveImport::Listener::parameterImported() */
+        virtual void parameterImported(gadget::Parameter* parameter);
+
+    private:
+        /** A decoded consumer request that waits to be executed on the ui thread. */
+        struct Request
+        {
+            libember::dom::Node* node;
+            gadget::Subscriber* subscriber;
+
+            /** The number of root elements that have been executed in earlier time slices. */
+            std::size_t offset;
+        };
+
+        typedef std::vector<Request> RequestCollection;
+        typedef std::deque<Request> RequestBacklog;
+
+        enum
+        {
+            /** The time spent executing requests before other events are processed, in microseconds. */
+            RequestTimeSlice = 10000,
+
+            /** The number of root elements executed at once before the time slice is checked. */
+            RequestSliceElements = 16,
+        };
+
+        /**
+         * Executes the requests in the backlog until it is empty or the current time slice
+         * has been used up, in which case resumeRequests is invoked later on.
+         */
+        void executeBacklog();
+
+        /**
+         * Executes the next root elements of a request until all of them have been executed
+         * or the deadline has passed.
+         * @param request The request to execute.
+         * @param deadline The end of the current time slice in nanoseconds of m_requestClock.
+         * @return true if the request has been executed completely.
+         */
+        bool executeSlice(Request& request, qint64 deadline);
+
+        /**
+         * Executes a part of a consumer request and transmits the response.
+         * @param first Refers to the first root element to execute.
+         * @param last Refers to the position one past the last root element to execute.
+         * @param root The root node of the provider.
+         * @param subscriber The subscriber representing the consumer.
+         */
+        void executeElements(libember::dom::Container::const_iterator first, libember::dom::Container::const_iterator last, gadget::Node* root, gadget::Subscriber* subscriber);
+
     private:
         Ui::TinyEmberPlusClass m_dialog;
         glow::ConsumerProxy *const m_proxy;
+        GadgetTreeModel* m_treeModel;
+        glow::util::StreamPublisher m_streamPublisher;
         serialization::SettingsSerializer m_settingsSerializer;
+        serialization::ArchiveImport* m_import;
         QTimer* m_timer;
+        QTimer* m_streamTimer;
+        QTimer* m_simulationTimer;
+        QElapsedTimer m_streamClock;
+        gadget::StreamScheduler m_streamScheduler;
+        glow::util::StreamSimulator m_streamSimulator;
+        RequestCollection m_requests;
+        QMutex m_requestMutex;
+        RequestBacklog m_backlog;
+        QElapsedTimer m_requestClock;
+        bool m_isResumePosted;
         QDateTime m_lastKeepAliveTransmitTime;
         bool m_generateRandomValues;
         bool m_sendKeepAlive;
@@ -204,6 +305,10 @@ class TinyEmberPlus : public QMainWindow, public glow::ProviderInterface
         static const QString GenerateRandomValues;
         static const QString ConfigurationName;
         static const QString StreamTimerInterval;
+        static const QString StreamGroupIntervals;
+        static const QString SimulationRate;
+        static const QString SimulationStreamCount;
+        static const QString SimulationFirstIdentifier;
         static const QString SendKeepAliveRequest;
         static const QString AlwaysReportOnlineState;
         static const QString UseEnumMap;
@@ -7,7 +7,8 @@
 message("You are running qmake on a generated .pro file. This may not work!")
 
 
-HEADERS += ./GadgetViewContextMenu.h \
+HEADERS += ./GadgetTreeModel.h \
+    ./GadgetViewContextMenu.h \
     ./TreeWidgetItemData.h \
     ./Types.h \
     ./ViewFactory.h \
@@ -24,32 +25,54 @@ HEADERS += ./GadgetViewContextMenu.h \
     ./gadget/Parameter.h \
     ./gadget/ParameterFactory.h \
     ./gadget/ParameterField.h \
+    ./gadget/ParameterTemplate.h \
     ./gadget/ParameterType.h \
     ./gadget/ParameterTypeVisitor.h \
+    ./gadget/PropertyCache.h \
     ./gadget/RealParameter.h \
     ./gadget/StreamDescriptor.h \
     ./gadget/StreamFormat.h \
     ./gadget/StreamManager.h \
+    ./gadget/StreamScheduler.h \
+    ./gadget/StreamValueStore.h \
     ./gadget/StringParameter.h \
     ./gadget/Subscriber.h \
+    ./gadget/ValueObserver.h \
     ./gadget/util/EntityPath.h \
+    ./gadget/util/PathIndex.h \
     ./gadget/util/NumberFactory.h \
+    ./gadget/util/NumberIndex.h \
     ./glow/Consumer.h \
     ./glow/ConsumerProxy.h \
     ./glow/ConsumerRequestProcessor.h \
     ./glow/Encoder.h \
     ./glow/ProviderInterface.h \
+    ./glow/ProviderMetrics.h \
     ./glow/Settings.h \
     ./glow/util/NodeConverter.h \
     ./glow/util/ParameterConverter.h \
     ./glow/util/StreamConverter.h \
+    ./glow/util/StreamPublisher.h \
+    ./glow/util/StreamSimulator.h \
+    ./net/MetricsEndpoint.h \
+    ./net/ReceiveBufferPool.h \
     ./net/TcpClientFactory.h \
     ./net/TcpServer.h \
     ./net/TcpClient.h \
     ./serialization/Archive.h \
+    ./serialization/ArchiveImport.h \
+    ./serialization/ChangeLogReader.h \
+    ./serialization/ChangeLogWriter.h \
     ./serialization/SettingsSerializer.h \
+    ./serialization/detail/ChangeLog.h \
     ./serialization/detail/GadgetTreeReader.h \
+    ./serialization/detail/GadgetTreeStreamReader.h \
     ./serialization/detail/GadgetTreeWriter.h \
+    ./serialization/detail/Snapshot.h \
+    ./serialization/detail/SnapshotReader.h \
+    ./serialization/detail/SnapshotWriter.h \
+    ./util/Log.h \
+    ./util/Metrics.h \
     ./util/StringConverter.h \
     ./util/StreamFormatConverter.h \
     ./TinyEmberPlus.h \
@@ -61,7 +84,8 @@ HEADERS += ./GadgetViewContextMenu.h \
     ./EditEnumerationDialog.h \
     ./CreateParameterDialog.h \
     ./CreateNodeDialog.h
-SOURCES += ./GadgetViewContextMenu.cpp \
+SOURCES += ./GadgetTreeModel.cpp \
+    ./GadgetViewContextMenu.cpp \
     ./main.cpp \
     ./ViewFactory.cpp \
     ./gadget/EnumParameter.cpp \
@@ -72,22 +96,38 @@ SOURCES += ./GadgetViewContextMenu.cpp \
     ./gadget/ParameterFactory.cpp \
     ./gadget/RealParameter.cpp \
     ./gadget/StreamManager.cpp \
+    ./gadget/StreamScheduler.cpp \
+    ./gadget/StreamValueStore.cpp \
     ./gadget/StringParameter.cpp \
     ./gadget/Subscriber.cpp \
     ./gadget/util/EntityPath.cpp \
+    ./gadget/util/PathIndex.cpp \
     ./glow/Consumer.cpp \
     ./glow/ConsumerProxy.cpp \
     ./glow/ConsumerRequestProcessor.cpp \
     ./glow/Encoder.cpp \
+    ./glow/ProviderMetrics.cpp \
     ./glow/util/NodeConverter.cpp \
     ./glow/util/ParameterConverter.cpp \
     ./glow/util/StreamConverter.cpp \
+    ./glow/util/StreamPublisher.cpp \
+    ./glow/util/StreamSimulator.cpp \
+    ./net/MetricsEndpoint.cpp \
+    ./net/ReceiveBufferPool.cpp \
     ./net/TcpClient.cpp \
     ./net/TcpServer.cpp \
     ./serialization/Archive.cpp \
+    ./serialization/ArchiveImport.cpp \
+    ./serialization/ChangeLogReader.cpp \
+    ./serialization/ChangeLogWriter.cpp \
     ./serialization/SettingsSerializer.cpp \
     ./serialization/detail/GadgetTreeReader.cpp \
+    ./serialization/detail/GadgetTreeStreamReader.cpp \
     ./serialization/detail/GadgetTreeWriter.cpp \
+    ./serialization/detail/SnapshotReader.cpp \
+    ./serialization/detail/SnapshotWriter.cpp \
+    ./util/Log.cpp \
+    ./util/Metrics.cpp \
     ./util/StreamFormatConverter.cpp \
     ./CreateNodeDialog.cpp \
     ./CreateParameterDialog.cpp \
@@ -1,6 +1,7 @@
 #include <algorithm>
 #include "Node.h"
 #include "Parameter.h"
+#include "util/PathIndex.h"
 
 namespace gadget
 {
@@ -8,10 +9,16 @@ namespace gadget
         : m_identifier(identifier)
         , m_number(number)
         , m_parent(parent)
+        , m_path(parent != nullptr ? util::EntityPath(parent->m_path, number) : util::EntityPath(&number, &number + 1))
         , m_state(NodeField::All)
         , m_isOnline(true)
         , m_isMounted(true)
+        , m_isTracked(false)
+        , m_pathIndex(parent == nullptr ? new util::PathIndex(this) : nullptr)
     {
+        // A new node is completely dirty, so it has to be cleared with the next notification.
+        if (parent != nullptr)
+            parent->track(this);
     }
 
     Node::~Node()
@@ -31,6 +38,8 @@ namespace gadget
         {
             delete item;
         }
+
+        delete m_pathIndex;
     }
 
     int Node::number() const
@@ -43,6 +52,11 @@ namespace gadget
         return m_parent;
     }
 
+    util::EntityPath const& Node::path() const
+    {
+        return m_path;
+    }
+
     String const& Node::identifier() const
     {
         return m_identifier;
@@ -67,6 +81,31 @@ namespace gadget
     {
         return m_parameters;
     }
+
+    Node* Node::findNode(int number) const
+    {
+        return m_nodeIndex.find(number);
+    }
+
+    Parameter* Node::findParameter(int number) const
+    {
+        return m_parameterIndex.find(number);
+    }
+
+    int Node::maximumNumber() const
+    {
+        return std::max(m_nodeIndex.maximum(), m_parameterIndex.maximum());
+    }
+
+    Node::DirtyNodeCollection const& Node::dirtyNodes() const
+    {
+        return m_dirtyNodes;
+    }
+
+    Node::DirtyParameterCollection const& Node::dirtyParameters() const
+    {
+        return m_dirtyParameters;
+    }
         
     bool Node::isDirty() const
     {
@@ -115,6 +154,15 @@ namespace gadget
         return m_state;
     }
 
+    util::PathIndex const* Node::pathIndex() const
+    {
+        auto node = this;
+        while(node->m_parent != nullptr)
+            node = node->m_parent;
+
+        return node->m_pathIndex;
+    }
+
     void Node::setDescription(String const& value)
     {
         if (m_description != value)
@@ -160,15 +208,20 @@ namespace gadget
 
         if (recursive)
         {
-            for each(auto node in m_children)
+            for each(auto node in m_dirtyNodes)
             {
                 node->clearDirtyState(recursive);
+                node->m_isTracked = false;
             }
 
-            for each(auto parameter in m_parameters)
+            for each(auto parameter in m_dirtyParameters)
             {
                 parameter->clearDirtyState();
+                parameter->m_isTracked = false;
             }
+
+            m_dirtyNodes.clear();
+            m_dirtyParameters.clear();
         }
     }
 
@@ -203,6 +256,7 @@ namespace gadget
 
         if (m_parent != nullptr)
         {
+            m_parent->track(this);
             m_parent->markDirty();
         }
         else
@@ -217,9 +271,20 @@ namespace gadget
         auto const last = std::end(m_children);
         auto const where = std::find(first, last, node);
         auto const result = where != last;
+        if (result)
+            m_nodeIndex.remove(node->number());
+
         if (node)
+        {
             node->m_parent = nullptr;
 
+            if (node->m_isTracked)
+            {
+                node->m_isTracked = false;
+                m_dirtyNodes.erase(std::remove(std::begin(m_dirtyNodes), std::end(m_dirtyNodes), node), std::end(m_dirtyNodes));
+            }
+        }
+
         m_children.remove(where);
         return result;
     }
@@ -230,10 +295,45 @@ namespace gadget
         auto const last = std::end(m_parameters);
         auto const where = std::find(first, last, parameter);
         auto const result = where != last;
+        if (result)
+            m_parameterIndex.remove(parameter->number());
+
         if (parameter)
+        {
             parameter->m_parent = nullptr;
 
+            if (parameter->m_isTracked)
+            {
+                parameter->m_isTracked = false;
+                m_dirtyParameters.erase(std::remove(std::begin(m_dirtyParameters), std::end(m_dirtyParameters), parameter), std::end(m_dirtyParameters));
+            }
+        }
+
         m_parameters.remove(where);
         return result;
     }
+
+    void Node::track(Node* node)
+    {
+        if (node->m_isTracked == false)
+        {
+            node->m_isTracked = true;
+            m_dirtyNodes.push_back(node);
+
+            if (m_parent != nullptr)
+                m_parent->track(this);
+        }
+    }
+
+    void Node::track(Parameter* parameter)
+    {
+        if (parameter->m_isTracked == false)
+        {
+            parameter->m_isTracked = true;
+            m_dirtyParameters.push_back(parameter);
+
+            if (m_parent != nullptr)
+                m_parent->track(this);
+        }
+    }
 }
@@ -2,10 +2,13 @@
 #define __TINYEMBER_GADGET_NODE_H
 
 #include <list>
+#include <vector>
 #include "../Types.h"
 #include "Collection.h"
 #include "DirtyStateListener.h"
 #include "NodeField.h"
+#include "util/EntityPath.h"
+#include "util/NumberIndex.h"
 
 namespace gadget
 {
@@ -14,16 +17,24 @@ namespace gadget
     class Parameter;
     class ParameterFactory;
 
+    namespace util
+    {
+        class PathIndex;
+    }
+
     /**
      * Represents a node object within the gadget tree. A node may contain child nodes and parameters.
      */
     class Node
     {
         friend class NodeFactory;
+        friend class Parameter;
         friend class ParameterFactory;
         public:
             typedef Collection<Node*> NodeCollection;
             typedef Collection<Parameter*> ParameterCollection;
+            typedef std::vector<Node*> DirtyNodeCollection;
+            typedef std::vector<Parameter*> DirtyParameterCollection;
             typedef DirtyStateListener<NodeFieldState::flag_type, Node const*> DirtyStateListener;
 
             /** Destructor */
@@ -41,6 +52,13 @@ namespace gadget
              */
             Node const* parent() const;
 
+            /**
+             * Returns the numeric path of this node, which is computed once when
+             * the node is created.
+             * @return The path of this node.
+             */
+            util::EntityPath const& path() const;
+
             /**
              * Returns the string identifier of this node.
              * @return The string identifier of this node.
@@ -79,6 +97,43 @@ namespace gadget
              */
             ParameterCollection const& parameters() const;
 
+            /**
+             * Returns the child nodes that became dirty since the dirty state of this node has been
+             * cleared recursively. Each dirty child is contained, so a notification only has to visit
+             * the nodes that changed. A child may have been cleared in the meantime, so its dirty
+             * state has to be tested as well.
+             * @return The child nodes that may be dirty.
+             */
+            DirtyNodeCollection const& dirtyNodes() const;
+
+            /**
+             * Returns the parameters that became dirty since the dirty state of this node has been
+             * cleared recursively. A parameter may have been cleared in the meantime, for example
+             * after its value has been transmitted via a stream.
+             * @return The parameters that may be dirty.
+             */
+            DirtyParameterCollection const& dirtyParameters() const;
+
+            /**
+             * Returns the child node with the specified number.
+             * @param number The number of the child node to look for.
+             * @return The child node with the specified number, or nullptr if there is none.
+             */
+            Node* findNode(int number) const;
+
+            /**
+             * Returns the parameter with the specified number.
+             * @param number The number of the parameter to look for.
+             * @return The parameter with the specified number, or nullptr if there is none.
+             */
+            Parameter* findParameter(int number) const;
+
+            /**
+             * Returns the largest number used by a child node or parameter.
+             * @return The largest number in use, or 0 if the node has no children.
+             */
+            int maximumNumber() const;
+
             /**
              * Returns true if at least one node property is marked dirty.
              * @return true if at least one node property is marked dirty.
@@ -121,7 +176,7 @@ namespace gadget
              * Resets the dirty state if this node and optionally all children's states
              * as well.
              * @param recursive If set to true, the dirty states of all children will be 
-             *      cleared as well.
+             *      cleared as well. Only the children that have been marked dirty are visited.
              */
             void clearDirtyState(bool recursive) const;
 
@@ -177,6 +232,13 @@ namespace gadget
              */
             NodeFieldState const& dirtyState() const;
 
+            /**
+             * Returns the path index of the tree this node belongs to, which resolves
+             * the path of any node or parameter of the tree with one lookup per level.
+             * @return The path index owned by the root node.
+             */
+            util::PathIndex const* pathIndex() const;
+
         private:
             /**
              * Initializes a new Node.
@@ -191,18 +253,39 @@ namespace gadget
              */
             void notify() const;
 
+            /**
+             * Appends a child node to the collection of dirty nodes, unless it is already contained.
+             * This node is appended to the collection of its parent as well.
+             * @param node The child node that became dirty.
+             */
+            void track(Node* node);
+
+            /**
+             * Appends a parameter to the collection of dirty parameters, unless it is already contained.
+             * This node is appended to the collection of its parent as well.
+             * @param parameter The parameter that became dirty.
+             */
+            void track(Parameter* parameter);
+
         private:
             int const m_number;
             String m_description;
             String const m_identifier;
             String m_schema;
             Node* m_parent;
+            util::EntityPath const m_path;
             NodeCollection m_children;
             ParameterCollection m_parameters;
+            util::NumberIndex<Node*> m_nodeIndex;
+            util::NumberIndex<Parameter*> m_parameterIndex;
             std::list<DirtyStateListener*> m_listeners;
+            mutable DirtyNodeCollection m_dirtyNodes;
+            mutable DirtyParameterCollection m_dirtyParameters;
             bool m_isOnline;
             bool m_isMounted;
+            bool m_isTracked;
             mutable NodeFieldState m_state;
+            util::PathIndex* m_pathIndex;
     };
 
     /**************************************************************************
@@ -1,6 +1,7 @@
 #include <algorithm>
 #include "Node.h"
 #include "NodeFactory.h"
+#include "ParameterFactory.h"
 #include "util/NumberFactory.h"
 
 namespace gadget
@@ -22,8 +23,43 @@ namespace gadget
             auto const where = std::end(collection);
             node = new Node(parent, identifier, number);
             collection.insert(where, node);
+            parent->m_nodeIndex.insert(number, node);
         }
 
         return node;
     }
+
+    //static
+    std::vector<Node*> NodeFactory::createNodes(Node* parent, String const& prefix, std::size_t count, ParameterTemplates const& templates)
+    {
+        auto nodes = std::vector<Node*>();
+        if (parent != nullptr && count > 0)
+        {
+            auto& collection = parent->m_children;
+            auto const first = util::NumberFactory::create(parent);
+
+            nodes.reserve(count);
+            parent->m_nodeIndex.reserve(first + static_cast<int>(count));
+            parent->m_dirtyNodes.reserve(parent->m_dirtyNodes.size() + count);
+
+            for (auto index = std::size_t(0); index < count; ++index)
+            {
+                auto const number = first + static_cast<int>(index);
+                auto const identifier = prefix + std::to_string(static_cast<unsigned long long>(index + 1));
+                auto const where = std::end(collection);
+                auto node = new Node(parent, identifier, number);
+                collection.insert(where, node);
+                parent->m_nodeIndex.insert(number, node);
+
+                ParameterFactory::instantiate(node, templates);
+                nodes.push_back(node);
+            }
+
+            // The new entities have been tracked while they were created, so a single
+            // notification reports the complete bank.
+            parent->markDirty();
+        }
+
+        return nodes;
+    }
 }
@@ -1,7 +1,9 @@
 #ifndef __TINYEMBER_GADGET_NODEFACTORY_H
 #define __TINYEMBER_GADGET_NODEFACTORY_H
 
+#include <vector>
 #include "../Types.h"
+#include "ParameterTemplate.h"
 
 namespace gadget
 {
@@ -30,6 +32,20 @@ namespace gadget
              *      node it must not necessarily be deleted manually.
              */
             static Node* createNode(Node* parent, String const& identifier);
+
+            /**
+             * Creates a bank of nodes that contain the same parameters, like the channels
+             * of a mixer, and appends it to the passed parent node. The identifier of each
+             * node consists of the passed prefix, followed by its index starting with 1.
+             * No listener is notified while the entities are created, and the parent is
+             * marked dirty only once when the whole bank has been created.
+             * @param parent The parent node to attach the new nodes to.
+             * @param prefix The prefix of the node identifiers.
+             * @param count The number of nodes to create.
+             * @param templates The templates of the parameters each node contains.
+             * @return The newly created nodes, in the order of their numbers.
+             */
+            static std::vector<Node*> createNodes(Node* parent, String const& prefix, std::size_t count, ParameterTemplates const& templates);
     };
 }
 
@@ -5,15 +5,24 @@
 
 namespace gadget
 {
+    ValueObserver* Parameter::s_valueObserver = nullptr;
+
     Parameter::Parameter(ParameterType const& type, Node* parent, String const& identifier, int number)
         : m_identifier(identifier)
         , m_number(number)
         , m_parent(parent)
+        , m_path(parent != nullptr ? util::EntityPath(parent->path(), number) : util::EntityPath(&number, &number + 1))
         , m_type(type)
         , m_streamIdentifier(-1)
         , m_access(gadget::Access::ReadWrite)
         , m_state(ParameterField::All)
+        , m_isTracked(false)
+        , m_suppressUnchangedValues(false)
+        , m_valueSlot(StreamValueStore::NoSlot)
     {
+        // A new parameter is completely dirty, so it has to be cleared with the next notification.
+        if (parent != nullptr)
+            parent->track(this);
     }
 
     Parameter::~Parameter()
@@ -75,6 +84,16 @@ namespace gadget
         return m_parent;
     }
 
+    util::EntityPath const& Parameter::path() const
+    {
+        return m_path;
+    }
+
+    bool Parameter::suppressesUnchangedValues() const
+    {
+        return m_suppressUnchangedValues;
+    }
+
     bool Parameter::isDirty() const
     {
         return m_state.isDirty();
@@ -88,6 +107,19 @@ namespace gadget
     void Parameter::clearDirtyState()
     {
         m_state.clear();
+
+        if (m_valueSlot != StreamValueStore::NoSlot)
+            StreamManager::instance().m_values.clearDirty(m_valueSlot);
+    }
+
+    std::shared_ptr<PropertyCache> const& Parameter::propertyCache() const
+    {
+        return m_propertyCache;
+    }
+
+    void Parameter::setPropertyCache(std::shared_ptr<PropertyCache> const& cache) const
+    {
+        m_propertyCache = cache;
     }
 
     void Parameter::setDescription(String const& value)
@@ -99,6 +131,11 @@ namespace gadget
         }
     }
 
+    void Parameter::setSuppressUnchangedValues(bool value)
+    {
+        m_suppressUnchangedValues = value;
+    }
+
     void Parameter::setSchema(String const& value)
     {
         if (m_schema != value)
@@ -131,6 +168,7 @@ namespace gadget
         {
             m_streamIdentifier = value;
             markDirty(ParameterField::StreamIdentifier, true);
+            StreamManager::instance().streamChanged();
 
             if (hasStreamIdentifier())
                 subscribed();
@@ -143,6 +181,7 @@ namespace gadget
     {
         m_streamDescriptor = descriptor;
         markDirty(ParameterField::StreamDescriptor, true);
+        StreamManager::instance().streamChanged();
 
         if (descriptor)
             subscribed();
@@ -185,11 +224,26 @@ namespace gadget
     void Parameter::markDirty(ParameterField const& field, bool notify)
     {
         m_state.set(field.value);
+
+        // A streamed parameter mirrors its state into the store of the stream manager.
+        if (m_valueSlot != StreamValueStore::NoSlot)
+            StreamManager::instance().m_values.update(m_valueSlot, field);
+
+        // Only a value change keeps the data derived from the other properties valid.
+        if ((field.value & ~(ParameterField::Value | ParameterField::ForceUpdate | ParameterField::SubscriptionCount)) != 0)
+            m_propertyCache.reset();
+
         if (notify)
             this->notify();
 
+        if ((field.value & ParameterField::Value) != 0 && s_valueObserver != nullptr)
+            s_valueObserver->notifyValueChanged(this);
+
         if (m_parent != nullptr)
+        {
+            m_parent->track(this);
             m_parent->markDirty();
+        }
     }
 
     void Parameter::notify() const
@@ -210,6 +264,12 @@ namespace gadget
         return m_streamDescriptor != nullptr;
     }
 
+    //static
+    void Parameter::setValueObserver(ValueObserver* observer)
+    {
+        s_valueObserver = observer;
+    }
+
     void Parameter::subscribed()
     {
         if (hasStreamIdentifier() || hasStreamDescriptor() || isSubscribed())
@@ -9,8 +9,11 @@
 #include "Formula.h"
 #include "ParameterField.h"
 #include "ParameterType.h"
+#include "PropertyCache.h"
 #include "StreamDescriptor.h"
 #include "Subscriber.h"
+#include "ValueObserver.h"
+#include "util/EntityPath.h"
 
 namespace gadget
 {
@@ -18,8 +21,10 @@ namespace gadget
      * Forward declarations
      */
     class Node;
+    class ParameterFactory;
     class ParameterTypeVisitor;
     class ParameterTypeVisitorConst;
+    class StreamValueStore;
 
     /**
      * Base class for all parameter types. This class derives from the Subscribable interface
@@ -28,6 +33,8 @@ namespace gadget
     class Parameter : public Subscribable
     {
         friend class Node;
+        friend class ParameterFactory;
+        friend class StreamValueStore;
         public:
             typedef DirtyStateListener<ParameterFieldState::flag_type, Parameter const*> DirtyStateListener;
 
@@ -99,6 +106,13 @@ namespace gadget
              */
             Node const* parent() const;
 
+            /**
+             * Returns the numeric path of this parameter, which is computed once
+             * when the parameter is created.
+             * @return The path of this parameter.
+             */
+            util::EntityPath const& path() const;
+
             /**
              * Returns the current access to the parameter value.
              * @return The current access to the parameter value.
@@ -113,6 +127,13 @@ namespace gadget
              */
             Formula const& formula() const;
 
+            /**
+             * Returns true if a value set by a consumer that equals the current value
+             * is ignored instead of being broadcast to all consumers.
+             * @return true if unchanged values are suppressed.
+             */
+            bool suppressesUnchangedValues() const;
+
             /**
              * Returns the current dirty state of the parameter.
              * @return The current dirty state of the parameter.
@@ -126,6 +147,19 @@ namespace gadget
              */
             StreamDescriptor const* streamDescriptor() const;
 
+            /**
+             * Returns the data a protocol layer has derived from the current properties of this
+             * parameter. The cache is discarded whenever a property other than the value changes.
+             * @return The cached data or an empty pointer, if no data is cached.
+             */
+            std::shared_ptr<PropertyCache> const& propertyCache() const;
+
+            /**
+             * Stores data derived from the current properties of this parameter.
+             * @param cache The data to store.
+             */
+            void setPropertyCache(std::shared_ptr<PropertyCache> const& cache) const;
+
             /**
              * Returns true if at least one property is marked dirty.
              * @return true if at least one property is marked dirty.
@@ -155,6 +189,16 @@ namespace gadget
              */
             void setFormula(Formula const& formula);
 
+            /**
+             * Specifies whether a value set by a consumer that equals the current value
+             * is broadcast to all consumers. By default, every set request is broadcast,
+             * which some consumers rely on. Automation systems that periodically resend
+             * their current values cause a lot of redundant traffic, though. When this
+             * option is enabled, only the requesting consumer receives the current value.
+             * @param value If set to true, unchanged values are suppressed.
+             */
+            void setSuppressUnchangedValues(bool value);
+
             /**
              * Sets a new stream identifier.
              * @param value The new stream identifier to set. Set to -1 if the parameter
@@ -206,6 +250,14 @@ namespace gadget
              */
             bool hasStreamDescriptor() const;
 
+            /**
+             * Installs the observer that is notified whenever the value of any parameter
+             * is set, including the values of streamed parameters.
+             * @param observer The observer to notify, or nullptr to remove the current one.
+             *      The observer is not owned by the parameters.
+             */
+            static void setValueObserver(ValueObserver* observer);
+
         protected:
             /**
              * Initializes a new Parameter.
@@ -257,11 +309,18 @@ namespace gadget
             String m_description;
             String m_schema;
             Node* m_parent;
+            util::EntityPath const m_path;
             Formula m_formula;
             ParameterFieldState m_state;
             Access::value_type m_access;
             std::list<DirtyStateListener*> m_listeners;
             std::shared_ptr<StreamDescriptor> m_streamDescriptor;
+            mutable std::shared_ptr<PropertyCache> m_propertyCache;
+            bool m_isTracked;
+            bool m_suppressUnchangedValues;
+            int m_valueSlot;
+
+            static ValueObserver* s_valueObserver;
     };
 }
 
@@ -15,6 +15,7 @@ namespace gadget
         auto const where = std::end(parent->m_parameters);
         auto parameter = new BooleanParameter(parent, identifier, number, value);
         parent->m_parameters.insert(where, parameter);
+        parent->m_parameterIndex.insert(number, parameter);
 
         return parameter;
     }
@@ -25,6 +26,7 @@ namespace gadget
         auto const where = std::end(parent->m_parameters);
         auto parameter = new IntegerParameter(parent, identifier, number, minimum, maximum, value);
         parent->m_parameters.insert(where, parameter);
+        parent->m_parameterIndex.insert(number, parameter);
 
         return parameter;
     }
@@ -35,6 +37,7 @@ namespace gadget
         auto const where = std::end(parent->m_parameters);
         auto parameter = new RealParameter(parent, identifier, number, minimum, maximum, value);
         parent->m_parameters.insert(where, parameter);
+        parent->m_parameterIndex.insert(number, parameter);
 
         return parameter;
     }
@@ -45,6 +48,7 @@ namespace gadget
         auto const where = std::end(parent->m_parameters);
         auto parameter = new StringParameter(parent, identifier, number, value, maxLength);
         parent->m_parameters.insert(where, parameter);
+        parent->m_parameterIndex.insert(number, parameter);
 
         return parameter;
     }
@@ -55,7 +59,67 @@ namespace gadget
         auto const where = std::end(parent->m_parameters);
         auto parameter = new EnumParameter(parent, identifier, number);
         parent->m_parameters.insert(where, parameter);
+        parent->m_parameterIndex.insert(number, parameter);
 
         return parameter;
     }
+
+    void ParameterFactory::instantiate(Node* parent, ParameterTemplates const& templates)
+    {
+        auto const first = util::NumberFactory::create(parent);
+        auto const count = static_cast<int>(templates.size());
+        auto number = first;
+
+        // The index and the dirty collection grow once instead of once per parameter.
+        parent->m_parameterIndex.reserve(first + count);
+        parent->m_dirtyParameters.reserve(parent->m_dirtyParameters.size() + templates.size());
+
+        for each(auto const& item in templates)
+        {
+            auto const where = std::end(parent->m_parameters);
+            auto parameter = instantiate(parent, item, number);
+            parent->m_parameters.insert(where, parameter);
+            parent->m_parameterIndex.insert(number, parameter);
+            ++number;
+        }
+    }
+
+    //static
+    Parameter* ParameterFactory::instantiate(Node* parent, ParameterTemplate const& item, int number)
+    {
+        auto parameter = static_cast<Parameter*>(nullptr);
+
+        switch(item.m_type.value())
+        {
+            case ParameterType::Boolean:
+                parameter = new BooleanParameter(parent, item.m_identifier, number, item.m_value != 0.0);
+                break;
+
+            case ParameterType::Enum:
+                parameter = new EnumParameter(parent, item.m_identifier, number, std::begin(item.m_entries), std::end(item.m_entries));
+                break;
+
+            case ParameterType::Integer:
+                parameter = new IntegerParameter(
+                    parent, item.m_identifier, number,
+                    static_cast<IntegerParameter::value_type>(item.m_minimum),
+                    static_cast<IntegerParameter::value_type>(item.m_maximum),
+                    static_cast<IntegerParameter::value_type>(item.m_value));
+                break;
+
+            case ParameterType::Real:
+                parameter = new RealParameter(parent, item.m_identifier, number, item.m_minimum, item.m_maximum, item.m_value);
+                break;
+
+            case ParameterType::String:
+            default:
+                parameter = new StringParameter(parent, item.m_identifier, number, item.m_text, item.m_maxLength);
+                break;
+        }
+
+        // A new parameter is completely dirty, so the properties are reported with the parameter.
+        parameter->m_description = item.m_description;
+        parameter->m_access = item.m_access.value();
+        return parameter;
+    }
 }
@@ -2,6 +2,7 @@
 #define __TINYEMBER_GADGET_PARAMETERFACTORY_H
 
 #include "../Types.h"
+#include "ParameterTemplate.h"
 
 namespace gadget
 {
@@ -9,6 +10,7 @@ namespace gadget
     class BooleanParameter;
     class EnumParameter;
     class IntegerParameter;
+    class Parameter;
     class StringParameter;
     class RealParameter;
     class Node;
@@ -66,6 +68,28 @@ namespace gadget
              * @return The new parameter instance.
              */
             static BooleanParameter* create(Node* parent, String const& identifier, bool value);
+
+            /**
+             * Creates one parameter for each template and appends them to the parent in the
+             * order of the templates. The parameters are numbered consecutively and their
+             * description and access are initialized without sending a notification.
+             * Since new parameters are completely dirty, they are reported with the next
+             * notification of the parent, so a caller creating many parameters should mark
+             * the parent dirty once when done.
+             * @param parent The parameters' parent.
+             * @param templates The templates to create the parameters from.
+             */
+            static void instantiate(Node* parent, ParameterTemplates const& templates);
+
+        private:
+            /**
+             * Creates a single parameter from a template, without inserting it into its parent.
+             * @param parent The parameter's parent.
+             * @param item The template to create the parameter from.
+             * @param number The number of the new parameter.
+             * @return The new parameter instance.
+             */
+            static Parameter* instantiate(Node* parent, ParameterTemplate const& item, int number);
     };
 }
 
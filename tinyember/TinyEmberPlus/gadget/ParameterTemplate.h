@@ -0,0 +1,201 @@
+#ifndef __TINYEMBER_GADGET_PARAMETERTEMPLATE_H
+#define __TINYEMBER_GADGET_PARAMETERTEMPLATE_H
+
+#include <vector>
+#include "../Types.h"
+#include "Access.h"
+#include "ParameterType.h"
+
+namespace gadget
+{
+    /** Forward declaration */
+    class ParameterFactory;
+
+    /**
+     * Describes a parameter that is instantiated many times, for example once for
+     * each channel of a bank. The ParameterFactory creates a parameter with the type,
+     * identifier and initial properties of the template.
+     */
+    class ParameterTemplate
+    {
+        friend class ParameterFactory;
+        public:
+            typedef std::vector<String> EnumContainer;
+
+            /**
+             * Creates the template of an integer parameter.
+             * @param identifier The string identifier.
+             * @param minimum The smallest value accepted.
+             * @param maximum The largest value accepted.
+             * @param value The initial parameter value.
+             * @return The new template.
+             */
+            static ParameterTemplate integer(String const& identifier, int minimum, int maximum, int value);
+
+            /**
+             * Creates the template of a real parameter.
+             * @param identifier The string identifier.
+             * @param minimum The smallest value accepted.
+             * @param maximum The largest value accepted.
+             * @param value The initial parameter value.
+             * @return The new template.
+             */
+            static ParameterTemplate real(String const& identifier, double minimum, double maximum, double value);
+
+            /**
+             * Creates the template of a string parameter.
+             * @param identifier The string identifier.
+             * @param value The initial string value.
+             * @param maxLength The allowed length for the string value. If set to 0, the length is not limited.
+             * @return The new template.
+             */
+            static ParameterTemplate string(String const& identifier, String const& value, std::size_t maxLength = 0);
+
+            /**
+             * Creates the template of an enumeration parameter.
+             * @param identifier The string identifier.
+             * @param entries The enumeration entries.
+             * @return The new template.
+             */
+            static ParameterTemplate enumeration(String const& identifier, EnumContainer const& entries);
+
+            /**
+             * Creates the template of a boolean parameter.
+             * @param identifier The string identifier.
+             * @param value The initial parameter value.
+             * @return The new template.
+             */
+            static ParameterTemplate boolean(String const& identifier, bool value);
+
+            /**
+             * Sets the description of the parameters created from this template.
+             * @param value The description string.
+             * @return A reference to this template.
+             */
+            ParameterTemplate& setDescription(String const& value);
+
+            /**
+             * Sets the access of the parameters created from this template.
+             * @param value The access type.
+             * @return A reference to this template.
+             */
+            ParameterTemplate& setAccess(Access const& value);
+
+            /**
+             * Returns the type of the parameters created from this template.
+             * @return The parameter type.
+             */
+            ParameterType const& type() const;
+
+            /**
+             * Returns the identifier of the parameters created from this template.
+             * @return The identifier string.
+             */
+            String const& identifier() const;
+
+        private:
+            /**
+             * Initializes a new template.
+             * @param type The parameter type.
+             * @param identifier The string identifier.
+             */
+            ParameterTemplate(ParameterType const& type, String const& identifier);
+
+        private:
+            ParameterType m_type;
+            String m_identifier;
+            String m_description;
+            Access m_access;
+            double m_minimum;
+            double m_maximum;
+            double m_value;
+            String m_text;
+            std::size_t m_maxLength;
+            EnumContainer m_entries;
+    };
+
+    typedef std::vector<ParameterTemplate> ParameterTemplates;
+
+    /**************************************************************************
+     * Inline implementation                                                  *
+     **************************************************************************/
+
+    inline ParameterTemplate::ParameterTemplate(ParameterType const& type, String const& identifier)
+        : m_type(type)
+        , m_identifier(identifier)
+        , m_access(Access::ReadWrite)
+        , m_minimum(0.0)
+        , m_maximum(0.0)
+        , m_value(0.0)
+        , m_maxLength(0)
+    {}
+
+    //static
+    inline ParameterTemplate ParameterTemplate::integer(String const& identifier, int minimum, int maximum, int value)
+    {
+        auto result = ParameterTemplate(ParameterType::Integer, identifier);
+        result.m_minimum = minimum;
+        result.m_maximum = maximum;
+        result.m_value = value;
+        return result;
+    }
+
+    //static
+    inline ParameterTemplate ParameterTemplate::real(String const& identifier, double minimum, double maximum, double value)
+    {
+        auto result = ParameterTemplate(ParameterType::Real, identifier);
+        result.m_minimum = minimum;
+        result.m_maximum = maximum;
+        result.m_value = value;
+        return result;
+    }
+
+    //static
+    inline ParameterTemplate ParameterTemplate::string(String const& identifier, String const& value, std::size_t maxLength)
+    {
+        auto result = ParameterTemplate(ParameterType::String, identifier);
+        result.m_text = value;
+        result.m_maxLength = maxLength;
+        return result;
+    }
+
+    //static
+    inline ParameterTemplate ParameterTemplate::enumeration(String const& identifier, EnumContainer const& entries)
+    {
+        auto result = ParameterTemplate(ParameterType::Enum, identifier);
+        result.m_entries = entries;
+        return result;
+    }
+
+    //static
+    inline ParameterTemplate ParameterTemplate::boolean(String const& identifier, bool value)
+    {
+        auto result = ParameterTemplate(ParameterType::Boolean, identifier);
+        result.m_value = value ? 1.0 : 0.0;
+        return result;
+    }
+
+    inline ParameterTemplate& ParameterTemplate::setDescription(String const& value)
+    {
+        m_description = value;
+        return *this;
+    }
+
+    inline ParameterTemplate& ParameterTemplate::setAccess(Access const& value)
+    {
+        m_access = value;
+        return *this;
+    }
+
+    inline ParameterType const& ParameterTemplate::type() const
+    {
+        return m_type;
+    }
+
+    inline String const& ParameterTemplate::identifier() const
+    {
+        return m_identifier;
+    }
+}
+
+#endif//__TINYEMBER_GADGET_PARAMETERTEMPLATE_H
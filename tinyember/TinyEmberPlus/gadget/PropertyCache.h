@@ -0,0 +1,21 @@
+#ifndef __TINYEMBER_GADGET_PROPERTYCACHE_H
+#define __TINYEMBER_GADGET_PROPERTYCACHE_H
+
+namespace gadget
+{
+    /**
+     * Base class for data that a protocol layer derives from the properties of an entity,
+     * for example their encoded representation. An entity discards its cache as soon as
+     * one of the properties the data has been derived from changes.
+     */
+    class PropertyCache
+    {
+        public:
+            /** Destructor */
+            virtual ~PropertyCache()
+            {
+            }
+    };
+}
+
+#endif//__TINYEMBER_GADGET_PROPERTYCACHE_H
@@ -65,6 +65,11 @@ namespace gadget
     }
 
 
+    StreamManager::StreamManager()
+        : m_revision(0)
+    {
+    }
+
     StreamManager& StreamManager::instance()
     {
         static StreamManager instance;
@@ -90,48 +95,51 @@ namespace gadget
         }
     }
 
-    void StreamManager::registerParameter(Parameter* parameter)
+    void StreamManager::updateValue(Parameter* parameter) const
     {
-        auto const first = std::begin(m_parameters);
-        auto const last = std::end(m_parameters);
-        auto const result = std::find_if(first, last, [&parameter](decltype(*first) entry) -> bool
-        {
-            return entry == parameter;
-        });
+        auto valueGenerator = RandomValueGenerator();
+        parameter->accept(valueGenerator);
+    }
 
-        if (result == last)
-        {
-            m_parameters.push_back(parameter);
-        }
+    void StreamManager::registerParameter(Parameter* parameter)
+    {
+        if (m_values.insert(parameter))
+            ++m_revision;
     }
 
     void StreamManager::unregisterParameter(Parameter* parameter)
     {
-        auto const first = std::begin(m_parameters);
-        auto const last = std::end(m_parameters);
-        auto const where = std::find_if(first, last, [&parameter](decltype(*first) entry) -> bool
-        {
-            return entry == parameter;
-        });
+        if (m_values.remove(parameter))
+            ++m_revision;
+    }
 
-        if (where != last)
-        {
-            m_parameters.erase(where);
-        }
+    void StreamManager::streamChanged()
+    {
+        ++m_revision;
     }
 
     StreamManager::const_iterator StreamManager::begin() const
     {
-        return m_parameters.begin();
+        return m_values.begin();
     }
 
     StreamManager::const_iterator StreamManager::end() const
     {
-        return m_parameters.end();
+        return m_values.end();
     }
 
     StreamManager::size_type StreamManager::size() const
     {
-        return m_parameters.size();
+        return m_values.size();
+    }
+
+    StreamValueStore const& StreamManager::values() const
+    {
+        return m_values;
+    }
+
+    unsigned int StreamManager::revision() const
+    {
+        return m_revision;
     }
 }
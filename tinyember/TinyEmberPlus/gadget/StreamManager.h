@@ -3,6 +3,7 @@
 
 #include <vector>
 #include "ParameterTypeVisitor.h"
+#include "StreamValueStore.h"
 
 namespace gadget
 {
@@ -16,10 +17,9 @@ namespace gadget
     class StreamManager
     {
         friend class Parameter;
-        typedef std::vector<Parameter*> ParameterCollection;
         public:
-            typedef ParameterCollection::const_iterator const_iterator;
-            typedef ParameterCollection::size_type size_type;
+            typedef StreamValueStore::const_iterator const_iterator;
+            typedef StreamValueStore::size_type size_type;
 
             /**
              * Returns the singleton instance of the StreamManager.
@@ -45,11 +45,24 @@ namespace gadget
              */
             size_type size() const;
 
+            /**
+             * Returns the store that mirrors the stream related state of all registered
+             * parameters in contiguous arrays.
+             * @return The value store of the registered parameters.
+             */
+            StreamValueStore const& values() const;
+
             /**
              * Generates a random value for all registered parameters.
              */
             void updateValues();
 
+            /**
+             * Generates a random value for a single parameter.
+             * @param parameter The parameter to modify.
+             */
+            void updateValue(Parameter* parameter) const;
+
             /**
              * Tests whether the value of the passed parameter has to be transmitted via
              * a stream. This is the case when a parameter contains a stream identifier
@@ -60,7 +73,17 @@ namespace gadget
              */
             bool isParameterTransmittedViaStream(Parameter const* parameter) const;
 
+            /**
+             * Returns a number that changes whenever a parameter is registered or unregistered,
+             * or when the stream identifier or descriptor of a registered parameter changes.
+             * @return The current revision of the registered parameter set.
+             */
+            unsigned int revision() const;
+
         private:
+            /** Constructor */
+            StreamManager();
+
             /**
              * Registers a parameter. This method is invoked by a parameter when
              * a consumer subscribes to it.
@@ -76,8 +99,15 @@ namespace gadget
              */
             void unregisterParameter(Parameter* parameter);
 
+            /**
+             * Increments the revision. This method is invoked by a parameter when
+             * its stream identifier or descriptor changes.
+             */
+            void streamChanged();
+
         private:
-            ParameterCollection m_parameters;
+            StreamValueStore m_values;
+            unsigned int m_revision;
 
         private:
             /**
@@ -0,0 +1,110 @@
+#include <algorithm>
+#include "Parameter.h"
+#include "StreamManager.h"
+#include "StreamScheduler.h"
+
+namespace gadget
+{
+    StreamScheduler::StreamScheduler(int defaultInterval)
+        : m_lastUpdate(0)
+        , m_revision(0)
+        , m_defaultInterval(std::max(defaultInterval, 1))
+        , m_isValid(false)
+    {
+    }
+
+    int StreamScheduler::defaultInterval() const
+    {
+        return m_defaultInterval;
+    }
+
+    void StreamScheduler::setDefaultInterval(int value)
+    {
+        m_defaultInterval = std::max(value, 1);
+    }
+
+    int StreamScheduler::interval(int streamIdentifier) const
+    {
+        auto const result = m_intervals.find(streamIdentifier);
+        return result != m_intervals.end() ? result->second : m_defaultInterval;
+    }
+
+    void StreamScheduler::setInterval(int streamIdentifier, int value)
+    {
+        if (value > 0)
+            m_intervals[streamIdentifier] = value;
+        else
+            m_intervals.erase(streamIdentifier);
+    }
+
+    bool StreamScheduler::update(StreamManager const& manager, time_type now, bool generateValues)
+    {
+        if (m_isValid == false || m_revision != manager.revision())
+            rebuild(manager, now);
+
+        auto result = false;
+        m_lastUpdate = now;
+
+        for each(auto& pair in m_groups)
+        {
+            auto& group = pair.second;
+            if (group.due > now)
+                continue;
+
+            // A group that fell behind does not try to catch up with the missed ticks.
+            auto const period = interval(pair.first);
+            group.due = std::max(group.due + period, now + 1);
+
+            for each(auto parameter in group.parameters)
+            {
+                if (parameter->isSubscribed())
+                {
+                    if (generateValues)
+                        manager.updateValue(parameter);
+
+                    result = true;
+                }
+            }
+        }
+
+        return result;
+    }
+
+    int StreamScheduler::timeUntilNextUpdate(time_type now) const
+    {
+        auto next = m_lastUpdate + m_defaultInterval;
+        for each(auto const& pair in m_groups)
+        {
+            next = std::min(next, pair.second.due);
+        }
+
+        return static_cast<int>(std::max(next - now, time_type(0)));
+    }
+
+    void StreamScheduler::rebuild(StreamManager const& manager, time_type now)
+    {
+        auto groups = GroupCollection();
+        for each(auto parameter in manager)
+        {
+            auto const identifier = parameter->streamIdentifier();
+            auto const result = groups.find(identifier);
+
+            if (result == groups.end())
+            {
+                auto const previous = m_groups.find(identifier);
+                auto group = Group();
+                group.due = previous != m_groups.end() ? previous->second.due : now;
+                group.parameters.push_back(parameter);
+                groups.insert(std::make_pair(identifier, group));
+            }
+            else
+            {
+                result->second.parameters.push_back(parameter);
+            }
+        }
+
+        m_groups.swap(groups);
+        m_revision = manager.revision();
+        m_isValid = true;
+    }
+}
@@ -0,0 +1,112 @@
+#ifndef __TINYEMBER_GADGET_STREAMSCHEDULER_H
+#define __TINYEMBER_GADGET_STREAMSCHEDULER_H
+
+#include <map>
+#include <vector>
+
+namespace gadget
+{
+    /** Forward declaration */
+    class Parameter;
+    class StreamManager;
+
+    /**
+     * Schedules the updates of the parameters registered to the StreamManager. The parameters
+     * are grouped by their stream identifier, and each group is updated at a rate of its own.
+     * Groups without an explicit rate use the default interval. Only parameters that have at
+     * least one subscriber are updated, so the cost of a tick depends on the number of streams
+     * that are actually consumed.
+     */
+    class StreamScheduler
+    {
+        public:
+            typedef long long time_type;
+
+            /**
+             * Initializes a new scheduler.
+             * @param defaultInterval The update interval of stream groups without an explicit
+             *      interval, in milliseconds.
+             */
+            explicit StreamScheduler(int defaultInterval);
+
+            /**
+             * Returns the update interval of stream groups without an explicit interval.
+             * @return The default update interval in milliseconds.
+             */
+            int defaultInterval() const;
+
+            /**
+             * Changes the update interval of stream groups without an explicit interval.
+             * @param value The new default update interval in milliseconds, at least 1.
+             */
+            void setDefaultInterval(int value);
+
+            /**
+             * Returns the update interval of a stream group.
+             * @param streamIdentifier The stream identifier of the group.
+             * @return The update interval in milliseconds.
+             */
+            int interval(int streamIdentifier) const;
+
+            /**
+             * Changes the update interval of a single stream group.
+             * @param streamIdentifier The stream identifier of the group.
+             * @param value The new interval in milliseconds. If zero or negative, the group
+             *      uses the default interval again.
+             */
+            void setInterval(int streamIdentifier, int value);
+
+            /**
+             * Updates all groups that are due. All due groups of a tick are handled at once,
+             * so their values are transmitted within a single stream collection.
+             * @param manager The manager containing the registered parameters.
+             * @param now The current time in milliseconds.
+             * @param generateValues If true, a random value is generated for each subscribed
+             *      parameter of a due group.
+             * @return true if at least one group with a subscribed parameter was due.
+             */
+            bool update(StreamManager const& manager, time_type now, bool generateValues);
+
+            /**
+             * Returns the time when the next group is due. This time is never later than
+             * one default interval from the last update, so groups that are registered in
+             * the meantime are picked up.
+             * @param now The current time in milliseconds.
+             * @return The number of milliseconds until the next group is due.
+             */
+            int timeUntilNextUpdate(time_type now) const;
+
+        private:
+            typedef std::vector<Parameter*> ParameterCollection;
+
+            /**
+             * The parameters sharing a stream identifier.
+             */
+            struct Group
+            {
+                ParameterCollection parameters;
+                time_type due;
+            };
+
+            typedef std::map<int, Group> GroupCollection;
+            typedef std::map<int, int> IntervalCollection;
+
+            /**
+             * Rebuilds the groups from the registered parameters. The due times of
+             * groups that still exist are kept.
+             * @param manager The manager containing the registered parameters.
+             * @param now The current time in milliseconds.
+             */
+            void rebuild(StreamManager const& manager, time_type now);
+
+        private:
+            GroupCollection m_groups;
+            IntervalCollection m_intervals;
+            time_type m_lastUpdate;
+            unsigned int m_revision;
+            int m_defaultInterval;
+            bool m_isValid;
+    };
+}
+
+#endif//__TINYEMBER_GADGET_STREAMSCHEDULER_H
@@ -0,0 +1,146 @@
+#include "BooleanParameter.h"
+#include "EnumParameter.h"
+#include "IntegerParameter.h"
+#include "Parameter.h"
+#include "ParameterTypeVisitor.h"
+#include "RealParameter.h"
+#include "StreamValueStore.h"
+#include "StringParameter.h"
+
+namespace gadget
+{
+    namespace
+    {
+        /**
+         * Copies the value of a parameter into the integer or real column entry.
+         */
+        class ValueReader : public ParameterTypeVisitorConst
+        {
+            public:
+                ValueReader(std::int64_t& integer, double& real)
+                    : m_integer(integer)
+                    , m_real(real)
+                {}
+
+                virtual void visit(EnumParameter const* parameter) const
+                {
+                    m_integer = static_cast<std::int64_t>(parameter->index());
+                }
+
+                virtual void visit(StringParameter const* parameter) const
+                {
+                    /* Strings are not mirrored */
+                }
+
+                virtual void visit(IntegerParameter const* parameter) const
+                {
+                    m_integer = parameter->value();
+                }
+
+                virtual void visit(RealParameter const* parameter) const
+                {
+                    m_real = parameter->value();
+                }
+
+                virtual void visit(BooleanParameter const* parameter) const
+                {
+                    m_integer = parameter->value() ? 1 : 0;
+                }
+
+            private:
+                std::int64_t& m_integer;
+                double& m_real;
+        };
+    }
+
+    StreamValueStore::StreamValueStore()
+    {
+    }
+
+    bool StreamValueStore::insert(Parameter* parameter)
+    {
+        if (parameter->m_valueSlot != NoSlot)
+            return false;
+
+        auto const slot = m_parameters.size();
+        m_parameters.push_back(parameter);
+        m_types.push_back(static_cast<std::uint8_t>(parameter->type().value()));
+        m_integers.push_back(0);
+        m_reals.push_back(0.0);
+        m_dirty.push_back(parameter->isDirty() ? 1 : 0);
+        m_subscribers.push_back(static_cast<std::uint32_t>(parameter->subscribers()));
+        m_streamIdentifiers.push_back(-1);
+        m_formats.push_back(StreamFormat::Invalid);
+        m_offsets.push_back(0);
+
+        parameter->m_valueSlot = static_cast<int>(slot);
+        readValue(slot);
+        readStream(slot);
+        return true;
+    }
+
+    bool StreamValueStore::remove(Parameter* parameter)
+    {
+        if (parameter->m_valueSlot == NoSlot)
+            return false;
+
+        auto const slot = static_cast<size_type>(parameter->m_valueSlot);
+        auto const last = m_parameters.size() - 1;
+
+        if (slot != last)
+        {
+            m_parameters[slot] = m_parameters[last];
+            m_types[slot] = m_types[last];
+            m_integers[slot] = m_integers[last];
+            m_reals[slot] = m_reals[last];
+            m_dirty[slot] = m_dirty[last];
+            m_subscribers[slot] = m_subscribers[last];
+            m_streamIdentifiers[slot] = m_streamIdentifiers[last];
+            m_formats[slot] = m_formats[last];
+            m_offsets[slot] = m_offsets[last];
+            m_parameters[slot]->m_valueSlot = static_cast<int>(slot);
+        }
+
+        m_parameters.pop_back();
+        m_types.pop_back();
+        m_integers.pop_back();
+        m_reals.pop_back();
+        m_dirty.pop_back();
+        m_subscribers.pop_back();
+        m_streamIdentifiers.pop_back();
+        m_formats.pop_back();
+        m_offsets.pop_back();
+
+        parameter->m_valueSlot = NoSlot;
+        return true;
+    }
+
+    void StreamValueStore::update(size_type slot, ParameterField const& field)
+    {
+        m_dirty[slot] = 1;
+
+        if ((field.value & ParameterField::Value) != 0)
+            readValue(slot);
+
+        if ((field.value & (ParameterField::StreamIdentifier | ParameterField::StreamDescriptor)) != 0)
+            readStream(slot);
+
+        if ((field.value & ParameterField::SubscriptionCount) != 0)
+            m_subscribers[slot] = static_cast<std::uint32_t>(m_parameters[slot]->subscribers());
+    }
+
+    void StreamValueStore::readValue(size_type slot)
+    {
+        m_parameters[slot]->accept(ValueReader(m_integers[slot], m_reals[slot]));
+    }
+
+    void StreamValueStore::readStream(size_type slot)
+    {
+        auto const parameter = m_parameters[slot];
+        auto const descriptor = parameter->streamDescriptor();
+
+        m_streamIdentifiers[slot] = parameter->streamIdentifier();
+        m_formats[slot] = descriptor != nullptr ? descriptor->format().value() : StreamFormat::Invalid;
+        m_offsets[slot] = descriptor != nullptr ? descriptor->offset() : 0;
+    }
+}
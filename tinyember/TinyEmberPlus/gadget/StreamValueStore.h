@@ -0,0 +1,269 @@
+#ifndef __TINYEMBER_GADGET_STREAMVALUESTORE_H
+#define __TINYEMBER_GADGET_STREAMVALUESTORE_H
+
+#include <cstdint>
+#include <vector>
+#include "ParameterField.h"
+#include "StreamFormat.h"
+
+namespace gadget
+{
+    /** Forward declarations */
+    class Parameter;
+    class StreamManager;
+
+    /**
+     * Keeps the data needed to stream the parameters registered at the StreamManager in
+     * contiguous arrays, one per property, which are indexed by the slot of a parameter.
+     * A parameter obtains a slot when it is registered. When a parameter is unregistered,
+     * the parameter in the last slot takes its place.
+     * The parameters remain the owners of their values, the store mirrors the current value,
+     * the dirty state, the number of subscribers and the stream settings whenever they
+     * change. This allows the stream encoders to test and encode the values of many
+     * parameters in simple loops, without visiting each parameter object.
+     * String values are not mirrored, since they can't be part of an octet stream.
+     */
+    class StreamValueStore
+    {
+        friend class Parameter;
+        friend class StreamManager;
+        public:
+            typedef std::vector<Parameter*>::size_type size_type;
+            typedef std::vector<Parameter*>::const_iterator const_iterator;
+
+            /** The slot of a parameter that is not registered. */
+            static int const NoSlot = -1;
+
+            /**
+             * Returns the number of occupied slots.
+             * @return The number of registered parameters.
+             */
+            size_type size() const;
+
+            /**
+             * Returns an iterator to the parameter in the first slot.
+             * @return An iterator to the parameter in the first slot.
+             */
+            const_iterator begin() const;
+
+            /**
+             * Returns an iterator that points one past the parameter in the last slot.
+             * @return An iterator that points one past the parameter in the last slot.
+             */
+            const_iterator end() const;
+
+            /**
+             * Returns the parameter in the specified slot.
+             * @param slot The slot to look up.
+             * @return The parameter occupying the slot.
+             */
+            Parameter* parameter(size_type slot) const;
+
+            /**
+             * Returns the ParameterType value of the parameter in the specified slot.
+             * @param slot The slot to look up.
+             * @return The parameter type.
+             */
+            std::uint8_t type(size_type slot) const;
+
+            /**
+             * Returns the value of an integer parameter, the index of an enumeration
+             * or 1 or 0 for a boolean parameter.
+             * @param slot The slot to look up.
+             * @return The integral value.
+             */
+            std::int64_t integer(size_type slot) const;
+
+            /**
+             * Returns the value of a real parameter.
+             * @param slot The slot to look up.
+             * @return The real value.
+             */
+            double real(size_type slot) const;
+
+            /**
+             * Returns the stream identifier of the parameter in the specified slot.
+             * @param slot The slot to look up.
+             * @return The stream identifier, or -1 if none is set.
+             */
+            int streamIdentifier(size_type slot) const;
+
+            /**
+             * Returns true if the parameter in the specified slot has a stream descriptor.
+             * @param slot The slot to look up.
+             * @return true if the parameter has a stream descriptor.
+             */
+            bool hasStreamDescriptor(size_type slot) const;
+
+            /**
+             * Returns the format of the stream descriptor of the parameter in the specified slot.
+             * @param slot The slot to look up.
+             * @return The stream format, or StreamFormat::Invalid if the parameter has no descriptor.
+             */
+            StreamFormat format(size_type slot) const;
+
+            /**
+             * Returns the offset of the stream descriptor of the parameter in the specified slot.
+             * @param slot The slot to look up.
+             * @return The offset within the octet string of the stream.
+             */
+            std::size_t offset(size_type slot) const;
+
+            /**
+             * Returns true if the parameter in the specified slot is dirty and subscribed,
+             * which means that its value has to be transmitted.
+             * @param slot The slot to test.
+             * @return true if the value has to be transmitted.
+             */
+            bool isPending(size_type slot) const;
+
+            /**
+             * Tests whether at least one of the passed slots is pending.
+             * @param first An iterator to the first slot to test.
+             * @param last An iterator one past the last slot to test.
+             * @return true if at least one slot is pending.
+             */
+            template<typename SlotIterator>
+            bool isAnyPending(SlotIterator first, SlotIterator last) const;
+
+        private:
+            /** Constructor */
+            StreamValueStore();
+
+            /**
+             * Assigns a slot to a parameter and copies all its properties.
+             * @param parameter The parameter to insert.
+             * @return false if the parameter already occupies a slot.
+             */
+            bool insert(Parameter* parameter);
+
+            /**
+             * Releases the slot of a parameter. The parameter in the last slot is moved
+             * into the released one.
+             * @param parameter The parameter to remove.
+             * @return false if the parameter didn't occupy a slot.
+             */
+            bool remove(Parameter* parameter);
+
+            /**
+             * Marks a slot dirty and copies the properties that are referred to by @p field.
+             * This method is invoked by a parameter whenever it is marked dirty.
+             * @param slot The slot of the parameter.
+             * @param field The fields that have been marked dirty.
+             */
+            void update(size_type slot, ParameterField const& field);
+
+            /**
+             * Clears the dirty flag of a slot. This method is invoked by a parameter when
+             * its dirty state is cleared.
+             * @param slot The slot of the parameter.
+             */
+            void clearDirty(size_type slot);
+
+            /**
+             * Copies the current value of the parameter in the specified slot.
+             * @param slot The slot to update.
+             */
+            void readValue(size_type slot);
+
+            /**
+             * Copies the stream identifier and descriptor of the parameter in the specified slot.
+             * @param slot The slot to update.
+             */
+            void readStream(size_type slot);
+
+        private:
+            std::vector<Parameter*> m_parameters;
+            std::vector<std::uint8_t> m_types;
+            std::vector<std::int64_t> m_integers;
+            std::vector<double> m_reals;
+            std::vector<std::uint8_t> m_dirty;
+            std::vector<std::uint32_t> m_subscribers;
+            std::vector<int> m_streamIdentifiers;
+            std::vector<StreamFormat::value_type> m_formats;
+            std::vector<std::size_t> m_offsets;
+    };
+
+    /**************************************************************************
+     * Inline implementation                                                  *
+     **************************************************************************/
+
+    inline StreamValueStore::size_type StreamValueStore::size() const
+    {
+        return m_parameters.size();
+    }
+
+    inline StreamValueStore::const_iterator StreamValueStore::begin() const
+    {
+        return m_parameters.begin();
+    }
+
+    inline StreamValueStore::const_iterator StreamValueStore::end() const
+    {
+        return m_parameters.end();
+    }
+
+    inline Parameter* StreamValueStore::parameter(size_type slot) const
+    {
+        return m_parameters[slot];
+    }
+
+    inline std::uint8_t StreamValueStore::type(size_type slot) const
+    {
+        return m_types[slot];
+    }
+
+    inline std::int64_t StreamValueStore::integer(size_type slot) const
+    {
+        return m_integers[slot];
+    }
+
+    inline double StreamValueStore::real(size_type slot) const
+    {
+        return m_reals[slot];
+    }
+
+    inline int StreamValueStore::streamIdentifier(size_type slot) const
+    {
+        return m_streamIdentifiers[slot];
+    }
+
+    inline bool StreamValueStore::hasStreamDescriptor(size_type slot) const
+    {
+        return m_formats[slot] != StreamFormat::Invalid;
+    }
+
+    inline StreamFormat StreamValueStore::format(size_type slot) const
+    {
+        return static_cast<StreamFormat::_Domain>(m_formats[slot]);
+    }
+
+    inline std::size_t StreamValueStore::offset(size_type slot) const
+    {
+        return m_offsets[slot];
+    }
+
+    inline bool StreamValueStore::isPending(size_type slot) const
+    {
+        return (m_dirty[slot] != 0) & (m_subscribers[slot] != 0);
+    }
+
+    template<typename SlotIterator>
+    inline bool StreamValueStore::isAnyPending(SlotIterator first, SlotIterator last) const
+    {
+        // All slots are tested without branching, which is cheaper than stopping early
+        // for the small number of parameters that share a stream.
+        auto result = false;
+        for ( ; first != last; ++first)
+            result |= isPending(*first);
+
+        return result;
+    }
+
+    inline void StreamValueStore::clearDirty(size_type slot)
+    {
+        m_dirty[slot] = 0;
+    }
+}
+
+#endif//__TINYEMBER_GADGET_STREAMVALUESTORE_H
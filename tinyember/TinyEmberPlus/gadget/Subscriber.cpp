@@ -1,5 +1,8 @@
-#include <algorithm>
 #include "Subscriber.h"
+#ifdef _MSC_VER
+#  include <intrin.h>
+#  pragma intrinsic(_InterlockedIncrement, _InterlockedDecrement)
+#endif
 
 namespace gadget
 {
@@ -12,27 +15,38 @@ namespace gadget
 
     void Subscriber::addRef()
     {
-        m_refCount = m_refCount + 1;
+#ifdef _MSC_VER
+        _InterlockedIncrement(&m_refCount);
+#else
+        __sync_add_and_fetch(&m_refCount, 1);
+#endif
     }
 
     long Subscriber::releaseRef()
     {
-        if (m_refCount == 1)
-        {
+        // The consumers hold their subscribers on the network thread, while the requests
+        // that refer to them are executed on the ui thread.
+#ifdef _MSC_VER
+        auto const result = _InterlockedDecrement(&m_refCount);
+#else
+        auto const result = __sync_sub_and_fetch(&m_refCount, 1);
+#endif
+        if (result == 0)
             delete this;
-            return 0;
-        }
-        else
-        {
-            m_refCount = m_refCount - 1;
-            return m_refCount;
-        }
+
+        return result;
     }
 
     long Subscriber::unsubscribe()
     {
         addRef();
-        auto subscribables = m_subscribables;
+        auto subscribables = std::vector<Subscribable*>();
+        subscribables.reserve(m_subscriptions.size());
+        for each(auto const& entry in m_subscriptions)
+        {
+            subscribables.push_back(entry.first);
+        }
+
         for each(auto subscribable in subscribables)
         {
             subscribable->unsubscribe(this);
@@ -40,31 +54,28 @@ namespace gadget
         return releaseRef();
     }
 
-    void Subscriber::subscribe(Subscribable* subscribable)
+    bool Subscriber::find(Subscribable const* subscribable, std::size_t& index) const
     {
-        auto const first = std::begin(m_subscribables);
-        auto const last = std::end(m_subscribables);
-        auto const result = std::find_if(first, last, [&subscribable](decltype(*first) entry) -> bool
+        auto const result = m_subscriptions.find(const_cast<Subscribable*>(subscribable));
+        if (result != std::end(m_subscriptions))
         {
-            return entry == subscribable;
-        });
-
-        if (result == last)
+            index = result->second;
+            return true;
+        }
+        else
         {
-            m_subscribables.push_back(subscribable);
+            return false;
         }
     }
 
-    void Subscriber::unsubscribe(Subscribable* subscribable)
+    void Subscriber::subscribe(Subscribable* subscribable, std::size_t index)
     {
-        auto const first = std::begin(m_subscribables);
-        auto const last = std::end(m_subscribables);
-        auto const where = std::find_if(first, last, [&subscribable](decltype(*first) entry) -> bool
-        {
-            return entry == subscribable;
-        });
+        m_subscriptions[subscribable] = index;
+    }
 
-        m_subscribables.erase(where);
+    void Subscriber::unsubscribe(Subscribable* subscribable)
+    {
+        m_subscriptions.erase(subscribable);
     }
 
 
@@ -75,27 +86,18 @@ namespace gadget
 
     void Subscribable::subscribe(Subscriber* subscriber)
     {
-        if (subscriber != nullptr)
+        auto index = std::size_t(0);
+        if (subscriber != nullptr && subscriber->find(this, index) == false)
         {
             auto const isSubscribed = this->isSubscribed();
-            auto const first = std::begin(m_subscribers);
-            auto const last = std::end(m_subscribers);
-            auto const result = std::find_if(first, last, [&subscriber](decltype(*first) entry) -> bool
-            {
-                return entry == subscriber;
-            });
 
-            if (result == last)
-            {
-                m_subscribers.push_back(subscriber);
+            subscriber->subscribe(this, m_subscribers.size());
+            subscriber->addRef();
+            m_subscribers.push_back(subscriber);
+            subscriptionCountChanged(subscribers());
 
-                subscriber->subscribe(this);
-                subscriber->addRef();
-                subscriptionCountChanged(subscribers());
-
-                if (isSubscribed == false)
-                    subscribed();
-            }
+            if (isSubscribed == false)
+                subscribed();
         }
     }
 
@@ -104,16 +106,17 @@ namespace gadget
         if (subscriber != nullptr)
         {
             auto const isSubscribed = this->isSubscribed();
-            auto const first = std::begin(m_subscribers);
-            auto const last = std::end(m_subscribers);
-            auto const result = std::find_if(first, last, [&subscriber](decltype(*first) entry) -> bool
-            {
-                return entry == subscriber;
-            });
+            auto index = std::size_t(0);
 
-            if (result != last)
+            if (subscriber->find(this, index))
             {
-                m_subscribers.erase(result);
+                // The last subscriber takes the place of the removed one.
+                auto const last = m_subscribers.back();
+                m_subscribers[index] = last;
+                m_subscribers.pop_back();
+
+                if (last != subscriber)
+                    last->subscribe(this, index);
 
                 subscriber->unsubscribe(this);
                 subscriber->releaseRef();
@@ -127,15 +130,14 @@ namespace gadget
 
     void Subscribable::unsubscribe()
     {
-        auto const isSubscribed = this->isSubscribed();
-        auto subscribers = m_subscribers;
+        auto subscribers = SubscriberCollection();
+        subscribers.swap(m_subscribers);
         for each(auto subscriber in subscribers)
         {
             subscriber->unsubscribe(this);
             subscriber->releaseRef();
         }
     }
-
     bool Subscribable::isSubscribed() const
     {
         return m_subscribers.empty() == false;
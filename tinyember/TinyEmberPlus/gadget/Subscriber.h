@@ -2,6 +2,7 @@
 #define __TINYEMBER_GADGET_SUBSCRIBER_H
 
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include "util\EntityPath.h"
 
@@ -13,10 +14,13 @@ namespace gadget
     /**
      * Represents an object that subscribes to or unsubscribes from a Subscribable. This pattern
      * is currently implemented for parameter subscriptions.
+     * Each subscriber maps the objects it is subscribed to onto its position within their collections
+     * of subscribers, so subscribing and unsubscribing take constant time, and a subscriber drops all
+     * of its subscriptions in time proportional to their number.
      */
     class Subscriber
     {
-        typedef std::vector<Subscribable*> SubscribableCollection;
+        typedef std::unordered_map<Subscribable*, std::size_t> SubscriptionCollection;
         friend class Subscribable;
         public:
             /**
@@ -53,10 +57,20 @@ namespace gadget
 
         private:
             /**
-             * Adds the passed Subscribable to the object's collection of subscribables.
+             * Returns the position of this subscriber within the subscribers of the passed Subscribable.
+             * @param subscribable The Subscribable to look for.
+             * @param index Receives the position, if the subscriber is subscribed.
+             * @return true if this subscriber is subscribed to the passed Subscribable.
+             */
+            bool find(Subscribable const* subscribable, std::size_t& index) const;
+
+            /**
+             * Adds the passed Subscribable to the object's collection of subscribables, or updates
+             * the position of this subscriber when the Subscribable has reordered its subscribers.
              * @param subscribable The Subscribable to register.
+             * @param index The position of this subscriber within the subscribers of the Subscribable.
              */
-            void subscribe(Subscribable* subscribable);
+            void subscribe(Subscribable* subscribable, std::size_t index);
 
             /**
              * Removes that passed Subscribable from the object's list.
@@ -65,8 +79,8 @@ namespace gadget
             void unsubscribe(Subscribable* subscribable);
 
         private:
-            SubscribableCollection m_subscribables;
-            long m_refCount;
+            SubscriptionCollection m_subscriptions;
+            long volatile m_refCount;
     };
 
 
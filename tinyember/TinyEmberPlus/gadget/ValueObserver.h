@@ -0,0 +1,37 @@
+#ifndef __TINYEMBER_GADGET_VALUEOBSERVER_H
+#define __TINYEMBER_GADGET_VALUEOBSERVER_H
+
+namespace gadget
+{
+    /** Forward declaration */
+    class Parameter;
+
+    /**
+     * Interface notified about the value changes of all parameters of the gadget tree,
+     * for example to record them. In contrast to a DirtyStateListener, an observer
+     * does not register at each parameter, it is installed once with
+     * Parameter::setValueObserver.
+     */
+    class ValueObserver
+    {
+        public:
+            /** Destructor */
+            virtual ~ValueObserver();
+
+            /**
+             * This method is invoked by the thread owning the gadget tree whenever
+             * the value of a parameter has been set.
+             * @param parameter The parameter whose value has been set.
+             */
+            virtual void notifyValueChanged(Parameter const* parameter) = 0;
+    };
+
+    /**************************************************************************
+     * Mandatory inline implementation                                        *
+     **************************************************************************/
+
+    inline ValueObserver::~ValueObserver()
+    {}
+}
+
+#endif//__TINYEMBER_GADGET_VALUEOBSERVER_H
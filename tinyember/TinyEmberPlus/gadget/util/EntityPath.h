@@ -1,6 +1,7 @@
 #ifndef __TINYEMBER_GADGET_UTIL_ENTITYPATH_H
 #define __TINYEMBER_GADGET_UTIL_ENTITYPATH_H
 
+#include <algorithm>
 #include <vector>
 
 /** Forward declarations */
@@ -32,6 +33,13 @@ namespace gadget { namespace util
             template<typename InputIterator>
             EntityPath(InputIterator first, InputIterator last);
 
+            /**
+             * Initializes the path of a child by appending its number to the path of its parent.
+             * @param parent The path of the parent.
+             * @param number The number of the child.
+             */
+            EntityPath(EntityPath const& parent, value_type number);
+
             /**
              * Initializes an empty EntityPath
              */
@@ -68,6 +76,13 @@ namespace gadget { namespace util
         : m_items(first, last)
     {}
 
+    inline EntityPath::EntityPath(EntityPath const& parent, value_type number)
+    {
+        m_items.reserve(parent.size() + 1);
+        m_items.assign(parent.begin(), parent.end());
+        m_items.push_back(number);
+    }
+
     inline EntityPath::EntityPath()
     {}
 
@@ -86,32 +101,43 @@ namespace gadget { namespace util
         return m_items.size();
     }
 
+    /**
+     * Returns true if both paths contain the same numbers.
+     * @param lhs The first path to compare.
+     * @param rhs The second path to compare.
+     * @return true if both paths are equal, otherwise false.
+     */
+    inline bool operator==(EntityPath const& lhs, EntityPath const& rhs)
+    {
+        return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+    }
+
 
     /**
-     * Determines the depth of the provided entity by looping
-     * through all parents.
+     * Returns the depth of the provided entity, which is the length of its path.
      * @param entity The entity to compute the depth for.
-     * @return The depth of this entity.
+     * @return The depth of this entity, or 0 if @p entity is null.
      */
     std::size_t entity_depth(Node const* entity);
 
     /**
-     * Determines the depth of the provided entity by looping
-     * through all parents.
+     * Returns the depth of the provided entity, which is the length of its path.
      * @param entity The entity to compute the depth for.
-     * @return The depth of this entity.
+     * @return The depth of this entity, or 0 if @p entity is null.
      */
     std::size_t entity_depth(Parameter const* entity);
 
     /**
-     * Creates a new path from the passed node.
+     * Returns a copy of the path of the passed node. Use Node::path() to
+     * access the path without copying it.
      * @param entity The node to create the path for.
      * @return The node's path.
      */
     EntityPath make_path(Node const* entity);
 
     /**
-     * Creates a new path from the passed parameter.
+     * Returns a copy of the path of the passed parameter. Use Parameter::path()
+     * to access the path without copying it.
      * @param entity The parameter to create the path for.
      * @return The parameter's path.
      */
@@ -119,7 +145,8 @@ namespace gadget { namespace util
 
     /**
      * Searches for a child node which is identified by the provided pair of iterators which
-     * contains the path of the node to look for.
+     * contains the path of the node to look for. Each path element is looked up in the
+     * number index of its parent, so the lookup takes one step per level.
      * @param root The root node to start the lookup.
      * @param first Reference to the first path element.
      * @param last Reference to the first element beyond the buffer storing the path.
@@ -128,25 +155,16 @@ namespace gadget { namespace util
     template<typename InputIterator>
     inline Node const* resolve_node(Node const* root, InputIterator first, InputIterator last)
     {
-        auto const size = std::distance(first, last);
-        if (root->number() == *first)
-        {
-            for( ; first != last; ++first)
-            {
-                auto const& nodes = root->nodes();
-                auto result = std::find_if(std::begin(nodes), std::end(nodes), [first](Node const* node) -> bool
-                {
-                    return node->number() == *first;
-                });
+        if (root == nullptr || first == last || root->number() != static_cast<int>(*first))
+            return nullptr;
 
-                if (result != std::end(nodes))
-                {
-                    return *result;
-                }
-            }
+        auto node = root;
+        for(++first; node != nullptr && first != last; ++first)
+        {
+            node = node->findNode(static_cast<int>(*first));
         }
 
-        return nullptr;
+        return node;
     }
 
     /**
@@ -160,36 +178,7 @@ namespace gadget { namespace util
     template<typename InputIterator>
     inline Node* resolve_node(Node* root, InputIterator first, InputIterator last)
     {
-        auto const size = std::distance(first, last);
-        auto node = static_cast<Node*>(root);
-        if (size == 1)
-        {
-            if (root->number() == *first)
-                return root;
-        }
-        if (size > 1 && root->number() == *first)
-        {
-            first++;
-            for(; first != last; ++first)
-            {
-                auto& nodes = node->nodes();
-                auto result = std::find_if(std::begin(nodes), std::end(nodes), [first](Node* node) -> bool
-                {
-                    return node->number() == *first;
-                });
-
-                if (result != std::end(nodes))
-                {
-                    node = *result;
-                }
-                else
-                {
-                    return nullptr;
-                }
-            }
-        }
-
-        return node;
+        return const_cast<Node*>(resolve_node(static_cast<Node const*>(root), first, last));
     }
 
     /**
@@ -203,25 +192,12 @@ namespace gadget { namespace util
     template<typename InputIterator>
     inline Parameter const* resolve_parameter(Node const* root, InputIterator first, InputIterator last)
     {
-        auto const size = std::distance(first, last);
-        if (size > 0)
-        {
-            --last;
-            auto const node = resolve_node(root, first, last);
-            if (node != nullptr)
-            {
-                auto it = last;
-                auto const& parameters = node->parameters();
-                auto result = std::find_if(std::begin(parameters), std::end(parameters), [it](Parameter const* p) -> bool
-                {
-                    return p->number() == *it;
-                });
-
-                return result != std::end(parameters) ? *result : nullptr;
-            }
-        }
+        if (first == last)
+            return nullptr;
 
-        return nullptr;
+        --last;
+        auto const node = resolve_node(root, first, last);
+        return node != nullptr ? node->findParameter(static_cast<int>(*last)) : nullptr;
     }
 
     /**
@@ -235,25 +211,7 @@ namespace gadget { namespace util
     template<typename InputIterator>
     inline Parameter* resolve_parameter(Node* root, InputIterator first, InputIterator last)
     {
-        auto const size = std::distance(first, last);
-        if (size > 0)
-        {
-            --last;
-            auto node = resolve_node(root, first, last);
-            if (node != nullptr)
-            {
-                auto& parameters = node->parameters();
-                auto it = last;
-                auto result = std::find_if(std::begin(parameters), std::end(parameters), [it](Parameter* p) -> bool
-                {
-                    return p->number() == *it;
-                });
-
-                return result != std::end(parameters) ? *result : nullptr;
-            }
-        }
-
-        return nullptr;
+        return const_cast<Parameter*>(resolve_parameter(static_cast<Node const*>(root), first, last));
     }
 }
 }
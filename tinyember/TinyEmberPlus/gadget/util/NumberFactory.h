@@ -1,8 +1,6 @@
 #ifndef __TINYEMBER_GADGET_UTIL_NUMBERFACTORY_H
 #define __TINYEMBER_GADGET_UTIL_NUMBERFACTORY_H
 
-#include <algorithm>
-#include "../Collection.h"
 #include "../Node.h"
 #include "../Parameter.h"
 
@@ -22,27 +20,7 @@ namespace gadget { namespace util
              */
             static int create(Node const* node)
             {
-                auto const& nodes = node->nodes();
-                auto const& params = node->parameters();
-
-                auto const max = std::max(NumberFactory::max(nodes), NumberFactory::max(params));
-                return 1 + max;
-            }
-
-        private:
-            /**
-             * Searches for largest number that is already in use.
-             * @param collection The collection to traverse. The specified ValueType must be either Parameter or Node.
-             * @return The largest number within the collection.
-             */
-            template<typename ValueType>
-            static int max(Collection<ValueType> const& collection)
-            {
-                auto const first = std::begin(collection);
-                auto const last = std::end(collection);
-                auto result = std::max_element(first, last, [](ValueType c, ValueType n) -> bool { return n->number() > c->number(); });
-
-                return result != last ? (*result)->number() : 0;
+                return 1 + node->maximumNumber();
             }
     };
 }
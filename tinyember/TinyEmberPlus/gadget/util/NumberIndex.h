@@ -0,0 +1,229 @@
+#ifndef __TINYEMBER_GADGET_UTIL_NUMBERINDEX_H
+#define __TINYEMBER_GADGET_UTIL_NUMBERINDEX_H
+
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+namespace gadget { namespace util
+{
+    /**
+     * Maps the numbers of the child nodes or parameters of a node to the corresponding objects.
+     * Since the NumberFactory assigns contiguous numbers, the objects are usually stored in an
+     * array which is indexed by the number. When the numbers become too sparse, for example
+     * when a tree is loaded that has been created by another provider, the index switches to
+     * a hash map.
+     * @note The ValueType must be a pointer type.
+     */
+    template<typename ValueType>
+    class NumberIndex
+    {
+        typedef std::vector<ValueType> DenseContainer;
+        typedef std::unordered_map<int, ValueType> SparseContainer;
+        public:
+            typedef typename DenseContainer::size_type size_type;
+
+        public:
+            /**
+             * Initializes a new, empty index.
+             */
+            NumberIndex();
+
+            /**
+             * Returns the number of objects stored in the index.
+             * @return The number of objects stored in the index.
+             */
+            size_type size() const;
+
+            /**
+             * Returns the largest number that is stored in the index.
+             * @return The largest number in use, or 0 if the index is empty or contains
+             *      negative numbers only.
+             */
+            int maximum() const;
+
+            /**
+             * Returns the object with the specified number.
+             * @param number The number of the object to look for.
+             * @return The object with the specified number, or nullptr if the number is not in use.
+             */
+            ValueType find(int number) const;
+
+            /**
+             * Adds an object to the index. An object with the same number will be replaced.
+             * @param number The number of the object.
+             * @param value The object to add.
+             */
+            void insert(int number, ValueType value);
+
+            /**
+             * Allocates the array for all numbers up to the specified one in advance, so
+             * inserting a range of consecutive numbers doesn't reallocate it repeatedly.
+             * @param maximum The largest number that is about to be inserted.
+             */
+            void reserve(int maximum);
+
+            /**
+             * Removes the object with the specified number from the index.
+             * @param number The number of the object to remove.
+             */
+            void remove(int number);
+
+        private:
+            /**
+             * Moves all objects from the array into the hash map.
+             */
+            void convertToSparse();
+
+            /**
+             * Searches the largest number in use after the previous maximum has been removed.
+             */
+            void updateMaximum();
+
+        private:
+            DenseContainer m_dense;
+            SparseContainer m_sparse;
+            size_type m_size;
+            int m_maximum;
+            bool m_isDense;
+    };
+
+    /**************************************************************************
+     * Mandatory inline implementation                                        *
+     **************************************************************************/
+
+    template<typename ValueType>
+    inline NumberIndex<ValueType>::NumberIndex()
+        : m_size(0)
+        , m_maximum(0)
+        , m_isDense(true)
+    {
+    }
+
+    template<typename ValueType>
+    inline typename NumberIndex<ValueType>::size_type NumberIndex<ValueType>::size() const
+    {
+        return m_size;
+    }
+
+    template<typename ValueType>
+    inline int NumberIndex<ValueType>::maximum() const
+    {
+        return m_maximum;
+    }
+
+    template<typename ValueType>
+    inline ValueType NumberIndex<ValueType>::find(int number) const
+    {
+        if (m_isDense)
+        {
+            if (number >= 0 && static_cast<size_type>(number) < m_dense.size())
+                return m_dense[number];
+        }
+        else
+        {
+            auto const result = m_sparse.find(number);
+            if (result != m_sparse.end())
+                return result->second;
+        }
+
+        return nullptr;
+    }
+
+    template<typename ValueType>
+    inline void NumberIndex<ValueType>::insert(int number, ValueType value)
+    {
+        if (m_isDense)
+        {
+            // The array may contain at most one unused entry per object, plus a few entries
+            // for small nodes.
+            auto const limit = std::max(m_dense.size(), 2 * (m_size + 1) + 16);
+            if (number >= 0 && static_cast<size_type>(number) < limit)
+            {
+                if (static_cast<size_type>(number) >= m_dense.size())
+                    m_dense.resize(number + 1, nullptr);
+
+                if (m_dense[number] == nullptr)
+                    ++m_size;
+
+                m_dense[number] = value;
+                m_maximum = std::max(m_maximum, number);
+                return;
+            }
+
+            convertToSparse();
+        }
+
+        m_sparse[number] = value;
+        m_size = m_sparse.size();
+        m_maximum = std::max(m_maximum, number);
+    }
+
+    template<typename ValueType>
+    inline void NumberIndex<ValueType>::reserve(int maximum)
+    {
+        if (m_isDense && maximum >= 0)
+            m_dense.reserve(static_cast<size_type>(maximum) + 1);
+    }
+
+    template<typename ValueType>
+    inline void NumberIndex<ValueType>::remove(int number)
+    {
+        if (m_isDense)
+        {
+            if (number >= 0 && static_cast<size_type>(number) < m_dense.size() && m_dense[number] != nullptr)
+            {
+                m_dense[number] = nullptr;
+                --m_size;
+            }
+        }
+        else
+        {
+            m_sparse.erase(number);
+            m_size = m_sparse.size();
+        }
+
+        if (number == m_maximum)
+            updateMaximum();
+    }
+
+    template<typename ValueType>
+    inline void NumberIndex<ValueType>::convertToSparse()
+    {
+        auto const size = m_dense.size();
+        for (auto number = size_type(0); number < size; ++number)
+        {
+            if (m_dense[number] != nullptr)
+                m_sparse.insert(std::make_pair(static_cast<int>(number), m_dense[number]));
+        }
+
+        m_dense = DenseContainer();
+        m_isDense = false;
+    }
+
+    template<typename ValueType>
+    inline void NumberIndex<ValueType>::updateMaximum()
+    {
+        m_maximum = 0;
+
+        if (m_isDense)
+        {
+            auto number = m_dense.size();
+            while (number > 0 && m_dense[number - 1] == nullptr)
+                --number;
+
+            m_dense.resize(number);
+            m_maximum = number > 0 ? static_cast<int>(number - 1) : 0;
+        }
+        else
+        {
+            for each(auto const& pair in m_sparse)
+            {
+                m_maximum = std::max(m_maximum, pair.first);
+            }
+        }
+    }
+}
+}
+
+#endif//__TINYEMBER_GADGET_UTIL_NUMBERINDEX_H
@@ -0,0 +1,17 @@
+#include "PathIndex.h"
+#include "../../gadget/Parameter.h"
+#include "../../gadget/Node.h"
+
+namespace gadget { namespace util 
+{
+    Node* PathIndex::findNode(EntityPath const& path) const
+    {
+        return resolve_node(m_root, std::begin(path), std::end(path));
+    }
+
+    Parameter* PathIndex::findParameter(EntityPath const& path) const
+    {
+        return resolve_parameter(m_root, std::begin(path), std::end(path));
+    }
+}
+}
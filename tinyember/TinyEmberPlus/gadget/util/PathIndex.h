@@ -0,0 +1,83 @@
+#ifndef __TINYEMBER_GADGET_UTIL_PATHINDEX_H
+#define __TINYEMBER_GADGET_UTIL_PATHINDEX_H
+
+#include "EntityPath.h"
+
+namespace gadget { namespace util
+{
+    /**
+     * Resolves the numeric path of a node or a parameter of a gadget tree. The tree
+     * itself serves as a trie: every node keeps its children in a number index, which
+     * is usually a dense array, so a path is resolved with one array access per level
+     * and without hashing or copying it. The number indices are updated by the
+     * factories and by Node::remove, so the index has no state of its own besides the
+     * root. The index is owned by the root node.
+     */
+    class PathIndex
+    {
+        public:
+            /**
+             * Initializes a new PathIndex.
+             * @param root The root node of the tree to resolve paths in.
+             */
+            explicit PathIndex(Node* root);
+
+            /**
+             * Returns the node with the specified path.
+             * @param path The path of the node to look for.
+             * @return The node with the specified path or nullptr, if the path doesn't identify a node.
+             */
+            Node* findNode(EntityPath const& path) const;
+
+            /**
+             * Returns the node with the specified path.
+             * @param first Reference to the first path element.
+             * @param last Reference to the first element beyond the buffer storing the path.
+             * @return The node with the specified path or nullptr, if the path doesn't identify a node.
+             */
+            template<typename InputIterator>
+            Node* findNode(InputIterator first, InputIterator last) const;
+
+            /**
+             * Returns the parameter with the specified path.
+             * @param path The path of the parameter to look for.
+             * @return The parameter with the specified path or nullptr, if the path doesn't identify a parameter.
+             */
+            Parameter* findParameter(EntityPath const& path) const;
+
+            /**
+             * Returns the parameter with the specified path.
+             * @param first Reference to the first path element.
+             * @param last Reference to the first element beyond the buffer storing the path.
+             * @return The parameter with the specified path or nullptr, if the path doesn't identify a parameter.
+             */
+            template<typename InputIterator>
+            Parameter* findParameter(InputIterator first, InputIterator last) const;
+
+        private:
+            Node* m_root;
+    };
+
+    /**************************************************************************
+     * Inline implementation                                                  *
+     **************************************************************************/
+
+    inline PathIndex::PathIndex(Node* root)
+        : m_root(root)
+    {}
+
+    template<typename InputIterator>
+    inline Node* PathIndex::findNode(InputIterator first, InputIterator last) const
+    {
+        return resolve_node(m_root, first, last);
+    }
+
+    template<typename InputIterator>
+    inline Parameter* PathIndex::findParameter(InputIterator first, InputIterator last) const
+    {
+        return resolve_parameter(m_root, first, last);
+    }
+}
+}
+
+#endif//__TINYEMBER_GADGET_UTIL_PATHINDEX_H
@@ -1,14 +1,14 @@
 #include <algorithm>
-#include <iostream>
 #include <ember\Ember.hpp>
 #include <s101\CommandType.hpp>
 #include <s101\Dtd.hpp>
+#include <s101\KeepAlive.hpp>
 #include <s101\PackageFlag.hpp>
-#include <s101\StreamEncoder.hpp>
 #include <s101\MessageType.hpp>
 #include <qhostaddress.h>
 #include "Consumer.h"
 #include "ProviderInterface.h"
+#include "ProviderMetrics.h"
 
 namespace glow
 {
@@ -43,7 +43,7 @@ namespace glow
 
 
 
-    Consumer::Consumer(ProviderInterface* provider, QTcpSocket* socket)
+    Consumer::Consumer(ProviderInterface* provider, QTcpSocket* socket, ProviderMetrics* metrics)
         : ::net::TcpClient(socket)
 #ifdef _MSC_VER
 #  pragma warning(push)
@@ -54,6 +54,7 @@ namespace glow
 #  pragma warning(pop)
 #endif
         , m_provider(provider)
+        , m_metrics(metrics)
         , m_subscriber(new SubscriberImpl(socket))
     {
         if (provider != nullptr)
@@ -76,6 +77,24 @@ namespace glow
 
     void Consumer::handleMessage(Decoder::const_iterator first, Decoder::const_iterator last)
     {
+        // Keep-alive requests are answered with a constant frame before the
+        // message is interpreted any further.
+        if (libs101::KeepAlive::isRequest(first, last))
+        {
+            static auto const response = QByteArray::fromRawData(reinterpret_cast<char const*>(libs101::KeepAlive::responseBegin()), libs101::KeepAlive::ResponseSize);
+            write(response, StreamPriority, true);
+            return;
+        }
+
+        if (libs101::KeepAlive::isResponse(first, last))
+        {
+            auto const roundTripTime = keepAliveResponded();
+            if (m_metrics != nullptr && roundTripTime >= 0)
+                m_metrics->recordKeepAlive(roundTripTime);
+
+            return;
+        }
+
         first++;                                                    // Slot
         auto const message = *first++;                              // Message
 
@@ -94,11 +113,20 @@ namespace glow
 
                 try
                 {
-                    m_reader.read(first, last);
+                    // Pass the payload as a contiguous buffer so that the reader can
+                    // consume complete headers and values at once.
+                    if (first != last)
+                    {
+                        auto const start = m_metrics != nullptr ? m_metrics->now() : 0;
+                        m_reader.read(&*first, &*first + std::distance(first, last));
+
+                        if (m_metrics != nullptr)
+                            m_metrics->recordDecode(m_metrics->now() - start);
+                    }
                 }
                 catch(std::runtime_error ex)
                 {
-                    std::cerr << ex.what();
+                    LOG_ERROR_LIMITED(m_errorLog, peerName() << ": " << ex.what());
                 }
 
                 if (flags.value() & libs101::PackageFlag::LastPackage)
@@ -106,16 +134,6 @@ namespace glow
                     m_reader.reset();
                 }
             }
-            else if (command == libs101::CommandType::KeepAliveRequest)
-            {
-                auto encoder = libs101::StreamEncoder<unsigned char>();
-                encoder.encode(0x00);                                       // Slot
-                encoder.encode(libs101::MessageType::EmBER);                // Message Type
-                encoder.encode(libs101::CommandType::KeepAliveResponse);    // Command
-                encoder.encode(0x01);                                       // Framing Version (1)
-                encoder.finish();
-                write(encoder.begin(), encoder.end());
-            }
         }
     }
 
@@ -123,6 +141,9 @@ namespace glow
     {
         m_reader.detachRoot();
 
+        if (m_metrics != nullptr)
+            m_metrics->countReceived(dynamic_cast<libember::glow::GlowContainer*>(root));
+
         auto provider = m_provider;
         if (provider != nullptr && root != nullptr)
             provider->notifyAsync(root, m_subscriber);
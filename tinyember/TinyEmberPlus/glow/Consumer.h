@@ -6,11 +6,13 @@
 #include <s101/StreamDecoder.hpp>
 #include "../gadget/Subscriber.h"
 #include "../net/TcpClient.h"
+#include "../util/Log.h"
 
 namespace glow
 {
     /** Forward declaration */
     class ProviderInterface;
+    class ProviderMetrics;
 
     /**
      * Represents a consumer that connected via tcp/ip socket.
@@ -74,8 +76,9 @@ namespace glow
              * Initializes a new Consumer.
              * @param provider The provider which is used to notify consumer requests and subscriptions.
              * @param socket The accepted socket for this consumer.
+             * @param metrics The metrics to update, or nullptr if no metrics are collected.
              */
-            Consumer(ProviderInterface* provider, QTcpSocket* socket);
+            Consumer(ProviderInterface* provider, QTcpSocket* socket, ProviderMetrics* metrics = nullptr);
 
         private:
             /** Destructor */
@@ -114,8 +117,10 @@ namespace glow
         private:
             DomReader m_reader;
             ProviderInterface* m_provider;
+            ProviderMetrics* m_metrics;
             SubscriberImpl* m_subscriber;
             Decoder m_decoder;
+            util::LogRateLimiter m_errorLog;
     };
 }
 
@@ -6,9 +6,134 @@
 #include "../gadget/Node.h"
 #include "../gadget/StreamManager.h"
 #include "../gadget/Parameter.h"
+#include <qcoreapplication.h>
+#include <qcoreevent.h>
+#include <qelapsedtimer.h>
+#include <qthread.h>
 
 namespace glow
 {
+    namespace
+    {
+        /**
+         * Sends each packet of an ember message to all connected consumers as soon
+         * as it has been encoded.
+         */
+        class ServerPacketSink : public Encoder::PacketSink
+        {
+            public:
+                /**
+                 * Initializes a new sink.
+                 * @param server The server to send the packets with.
+                 * @param priority The traffic class of the message.
+                 * @param record Receives a copy of every packet, may be nullptr.
+                 */
+                ServerPacketSink(net::TcpServer* server, net::TcpClient::Priority priority, QByteArray* record = nullptr)
+                    : m_server(server)
+                    , m_priority(priority)
+                    , m_record(record)
+                {}
+
+                virtual void write(const_iterator first, const_iterator last, bool isLastPacket)
+                {
+                    auto const packet = QByteArray(reinterpret_cast<char const*>(&*first), static_cast<int>(last - first));
+                    m_server->write(packet, m_priority, isLastPacket);
+
+                    if (m_record != nullptr)
+                        m_record->append(packet);
+                }
+
+            private:
+                net::TcpServer* const m_server;
+                net::TcpClient::Priority const m_priority;
+                QByteArray* const m_record;
+        };
+    }
+
+    class ConsumerProxy::NotificationDispatcher : public QObject
+    {
+        public:
+            /**
+             * Initializes a new dispatcher.
+             * @param proxy The proxy to flush when the posted event is delivered.
+             */
+            explicit NotificationDispatcher(ConsumerProxy* proxy)
+                : m_proxy(proxy)
+                , m_isScheduled(false)
+                , m_timerId(0)
+            {}
+
+            /**
+             * Posts an event to this dispatcher, unless one is already pending. When a
+             * minimum notification interval is configured and the previous flush is more
+             * recent than that, a timer delays the flush until the interval has passed.
+             * Changes made in the meantime accumulate in the dirty states of the
+             * parameters, so only their latest values are sent.
+             */
+            void schedule()
+            {
+                if (m_isScheduled == false)
+                {
+                    m_isScheduled = true;
+
+                    auto const interval = ConsumerProxy::settings().minimumNotificationInterval();
+                    auto const remaining = m_lastFlush.isValid() ? interval - m_lastFlush.elapsed() : 0;
+
+                    if (remaining > 0)
+                        m_timerId = startTimer(static_cast<int>(remaining));
+                    else
+                        QCoreApplication::postEvent(this, new QEvent(QEvent::User));
+                }
+            }
+
+        protected:
+            /**
+             * Flushes the pending notification of the proxy when the posted event is delivered.
+             * @param event The event to handle.
+             * @return true if the event has been handled.
+             */
+            virtual bool event(QEvent* event)
+            {
+                if (event->type() == QEvent::User)
+                {
+                    deliver();
+                    return true;
+                }
+
+                return QObject::event(event);
+            }
+
+            /**
+             * Flushes the pending notification of the proxy when the delay requested
+             * by schedule() has passed.
+             * @param event The timer event.
+             */
+            virtual void timerEvent(QTimerEvent* event)
+            {
+                if (event->timerId() == m_timerId)
+                {
+                    killTimer(m_timerId);
+                    m_timerId = 0;
+                    deliver();
+                }
+            }
+
+        private:
+            void deliver()
+            {
+                m_isScheduled = false;
+                m_lastFlush.start();
+                m_proxy->flushNotifications();
+            }
+
+        private:
+            ConsumerProxy* const m_proxy;
+            bool m_isScheduled;
+            int m_timerId;
+            QElapsedTimer m_lastFlush;
+    };
+
+
     Settings ConsumerProxy::s_settings;
 
     Settings& ConsumerProxy::settings()
@@ -16,15 +141,32 @@ namespace glow
         return s_settings;
     }
 
-    ConsumerProxy::ConsumerProxy(QApplication* app, ProviderInterface* provider, short port)
+    ConsumerProxy::ConsumerProxy(QApplication* app, ProviderInterface* provider, short port, ::util::MetricsRegistry* metrics)
         : m_provider(provider)
+        , m_metrics(metrics != nullptr ? new ProviderMetrics(metrics) : nullptr)
+        , m_thread(new QThread())
+        , m_dispatcher(new NotificationDispatcher(this))
+        , m_pendingNode(nullptr)
+        , m_sequence(0)
     {
-        m_server = new net::TcpServer(app, this, port);
+        Q_UNUSED(app);
+
+        // The server has no parent, so it can be moved to the network thread. The consumers
+        // it accepts are created on that thread as well.
+        m_server = new net::TcpServer(nullptr, this, port);
+        if (metrics != nullptr)
+            m_server->setMetrics(metrics);
+
+        m_server->moveToThread(m_thread);
+        m_thread->start();
     }
 
     ConsumerProxy::~ConsumerProxy()
     {
         close();
+        delete m_thread;
+        delete m_dispatcher;
+        delete m_metrics;
     }
 
     void ConsumerProxy::close()
@@ -32,7 +174,11 @@ namespace glow
         auto server = m_server;
         if (server != nullptr)
         {
-            server->close();
+            // The sockets must be closed by the thread they belong to. The server itself
+            // is deleted when the network thread has finished.
+            QMetaObject::invokeMethod(server, "shutdown", Qt::BlockingQueuedConnection);
+            m_thread->quit();
+            m_thread->wait();
             delete server;
         }
 
@@ -41,7 +187,7 @@ namespace glow
 
     Consumer* ConsumerProxy::create(QTcpSocket* socket)
     {
-        return new Consumer(m_provider, socket);
+        return new Consumer(m_provider, socket, m_metrics);
     }
 
     void ConsumerProxy::writeRequestKeepAlive()
@@ -50,11 +196,7 @@ namespace glow
         auto server = m_server;
         if (server != nullptr)
         {
-            auto const last = result.end();
-            for(auto it = result.begin(); it != last; ++it)
-            {
-                server->write(it->begin(), it->end());
-            }
+            server->writeKeepAliveRequest(net::TcpServer::join(result.begin(), result.end()));
         }
     }
 
@@ -64,50 +206,134 @@ namespace glow
         auto server = m_server;
         if (server != nullptr)
         {
-            auto const last = result.end();
-            for(auto it = result.begin(); it != last; ++it)
-            {
-                server->write(it->begin(), it->end());
-            }
+            server->writePackets(result.begin(), result.end());
         }
     }
 
-    void ConsumerProxy::write(libember::glow::GlowContainer const* container)
+    void ConsumerProxy::write(libember::glow::GlowContainer const* container, net::TcpClient::Priority priority)
     {
-        // The createEmberMessage returns an Encoder which may contain several packets
-        // that need to be transmitted separately.
-        auto const result = Encoder::createEmberMessage(container);
+        // Each packet is sent as soon as it is complete, so a large message is
+        // never held in memory as a whole.
         auto server = m_server;
         if (server != nullptr)
         {
-            auto const last = result.end();
-            for(auto it = result.begin(); it != last; ++it)
-            {
-                server->write(it->begin(), it->end());
-            }
+            auto sink = ServerPacketSink(server, priority);
+            encode(container, sink);
         }
     }
 
+    void ConsumerProxy::write(QByteArray const& frames)
+    {
+        auto server = m_server;
+        if (server != nullptr)
+        {
+            if (m_metrics != nullptr)
+                m_metrics->countSentStream();
+
+            server->writeStream(frames);
+        }
+    }
+
+    bool ConsumerProxy::writeChangesSince(long sequence)
+    {
+        if (sequence < 0)
+            return true;
+
+        auto const count = static_cast<std::size_t>(m_sequence - sequence);
+        if (sequence > m_sequence || count > m_changes.size())
+            return false;
+
+        auto server = m_server;
+        if (server != nullptr)
+        {
+            auto const last = m_changes.end();
+            for(auto it = last - count; it != last; ++it)
+                server->write(*it, net::TcpClient::NotificationPriority);
+        }
+
+        return true;
+    }
+
+    void ConsumerProxy::writeNotification(libember::glow::GlowContainer const* container)
+    {
+        auto message = QByteArray();
+        auto server = m_server;
+        if (server != nullptr)
+        {
+            auto sink = ServerPacketSink(server, net::TcpClient::NotificationPriority, &message);
+            encode(container, sink);
+        }
+
+        m_changes.push_back(message);
+        ++m_sequence;
+
+        if (m_changes.size() > ChangeLogCapacity)
+            m_changes.pop_front();
+    }
+
+    void ConsumerProxy::encode(libember::glow::GlowContainer const* container, Encoder::PacketSink& sink)
+    {
+        if (m_metrics != nullptr)
+        {
+            auto const start = m_metrics->now();
+            Encoder::writeEmberMessage(container, sink);
+            m_metrics->recordEncode(m_metrics->now() - start);
+            m_metrics->countSent(container);
+        }
+        else
+        {
+            Encoder::writeEmberMessage(container, sink);
+        }
+    }
+
+    void ConsumerProxy::flushNotifications()
+    {
+        auto const node = m_pendingNode;
+        m_pendingNode = nullptr;
+
+        if (node != nullptr)
+            notify(node);
+    }
+
     void ConsumerProxy::notifyStateChanged(gadget::NodeFieldState const& state, gadget::Node const* object)
+    {
+        if (settings().coalesceNotifications())
+        {
+            // The dirty states keep accumulating until the dispatcher flushes them, so
+            // every entity is reported once, containing all fields that changed.
+            if (m_pendingNode != nullptr && m_pendingNode != object)
+                flushNotifications();
+
+            m_pendingNode = object;
+            m_dispatcher->schedule();
+        }
+        else
+        {
+            flushNotifications();
+            notify(object);
+        }
+    }
+
+    void ConsumerProxy::notify(gadget::Node const* node)
     {
         using namespace libember;
         using namespace libember::glow;
 
-        if (isNotificationRequired(object))
+        if (isNotificationRequired(node))
         {
             auto const root = GlowRootElementCollection::create();
             auto const behavior = settings().notificationBehavior().value();
 
             if (behavior == NotificationBehavior::UseExpandedContainer)
-                transform(root, object);
+                transform(root, node);
             else
-                transformQualified(root, object);
+                transformQualified(root, node);
 
             if (root->size() > 0)
-                write(root);
+                writeNotification(root);
             delete root;
 
-            object->clearDirtyState(true);
+            node->clearDirtyState(true);
         }
     }
 
@@ -123,8 +349,8 @@ namespace glow
             else if(node->isDirty())
             {
                 auto const& manager = gadget::StreamManager::instance();
-                auto const& nodes = node->nodes();
-                auto const& parameters = node->parameters();
+                auto const& nodes = node->dirtyNodes();
+                auto const& parameters = node->dirtyParameters();
                 for each(auto parameter in parameters)
                 {
                     if (manager.isParameterTransmittedViaStream(parameter) && parameter->dirtyState().isSet(gadget::ParameterField::ForceUpdate) == false)
@@ -161,16 +387,18 @@ namespace glow
             util::NodeConverter::createQualified(root, node, state);
         }
 
-        auto const& nodes = node->nodes();
+        auto const& nodes = node->dirtyNodes();
         for each(auto child in nodes)
         {
-            transformQualified(root, child);
+            if (child->isDirty())
+                transformQualified(root, child);
         }
 
-        auto const& parameters = node->parameters();
+        auto const& parameters = node->dirtyParameters();
         for each(auto parameter in parameters)
         {
-            transformQualified(root, parameter);
+            if (parameter->isDirty())
+                transformQualified(root, parameter);
         }
     }
 
@@ -180,14 +408,14 @@ namespace glow
         {
             parent = util::NodeConverter::create(parent, node, node->dirtyState())->children();
 
-            auto const& nodes = node->nodes();
+            auto const& nodes = node->dirtyNodes();
             for each(auto child in nodes)
             {
                 if (child->isDirty())
                     transform(parent, child);
             }
 
-            auto const& parameters = node->parameters();
+            auto const& parameters = node->dirtyParameters();
             for each(auto parameter in parameters)
             {
                 transform(parent, parameter);
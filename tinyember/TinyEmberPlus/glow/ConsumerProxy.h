@@ -1,14 +1,18 @@
 #ifndef __TINYEMBER_GLOW_CONSUMERPROXY_H
 #define __TINYEMBER_GLOW_CONSUMERPROXY_H
 
+#include <deque>
 #include "../net/TcpClientFactory.h"
 #include "../net/TcpServer.h"
 #include "../gadget/Node.h"
 #include "Consumer.h"
+#include "Encoder.h"
+#include "ProviderMetrics.h"
 #include "Settings.h"
 
 /** Forward declarations */
 class QApplication;
+class QThread;
 
 namespace libember { namespace glow
 {
@@ -25,6 +29,9 @@ namespace glow
     /**
      * The ConsumerProxy creates a tcp/ip listener which accepts consumers. Additionally, it provides a method
      * to send an ember tree to the connected consumers.
+     * The listener and all consumers run on a network thread owned by the proxy, which receives and decodes
+     * the requests and passes them to the provider interface. The trees are encoded on the thread that calls
+     * write, and the packets are sent by the network thread.
      */
     class ConsumerProxy : 
         public gadget::Node::DirtyStateListener,
@@ -43,8 +50,10 @@ namespace glow
              * @param app Reference to the application object.
              * @param provider Reference to the provider interface.
              * @param port The tcp ip port to listen for connections.
+             * @param metrics The registry to create the metrics of the proxy and its consumers
+             *      with, or nullptr if no metrics are collected. The registry must outlive the proxy.
              */
-            ConsumerProxy(QApplication* app, ProviderInterface* provider, short port);
+            ConsumerProxy(QApplication* app, ProviderInterface* provider, short port, ::util::MetricsRegistry* metrics = nullptr);
 
             /** Destructor */
             ~ConsumerProxy();
@@ -55,11 +64,43 @@ namespace glow
             /**
              * Encodes the passed tree and sends it to all currently connected consumers.
              * @param container The tree to encode and transmit.
+             * @param priority The traffic class of the tree. Responses to directory requests
+             *      should be sent as bulk traffic, so they don't delay notifications and streams.
              */
-            void write(libember::glow::GlowContainer const* container);
+            void write(libember::glow::GlowContainer const* container, net::TcpClient::Priority priority = net::TcpClient::NotificationPriority);
 
             /**
-             * Sends a keep-alive request message to all connected clients.
+             * Sends the passed S101 packets, which have already been encoded and framed,
+             * to all currently connected consumers. The packets must form complete messages
+             * and are sent with stream priority. A slow consumer only receives the latest
+             * frame that has been written while its previous frames were still queued.
+             * @param frames The packets to transmit.
+             */
+            void write(QByteArray const& frames);
+
+            /**
+             * Returns the sequence number of the last notification. The number is incremented
+             * with every notification, so a consumer can present it after it has reconnected
+             * to query the notifications it has missed.
+             * @return The sequence number of the last notification, or 0 if no notification
+             *      has been sent yet.
+             */
+            long sequence() const;
+
+            /**
+             * Retransmits the notifications sent after the notification with the specified
+             * sequence number to all connected consumers, oldest first. Only the last
+             * ChangeLogCapacity notifications are kept.
+             * @param sequence The sequence number of the last notification known to the consumer,
+             *      or -1 to retransmit nothing.
+             * @return false if not all notifications sent after @p sequence are known anymore,
+             *      in which case nothing is retransmitted.
+             */
+            bool writeChangesSince(long sequence);
+
+            /**
+             * Sends a keep-alive request message to all connected clients. The round trip time
+             * of the response is measured for each client and decides whether it is slow.
              */
             void writeRequestKeepAlive();
 
@@ -70,7 +111,13 @@ namespace glow
             void writeProviderState(bool state);
 
             /**
-             * Closes the tcp/ip listener and initiates a disconnect of all consumers.
+             * Transmits the pending notification immediately, if any. This must be
+             * called before the tree whose changes are pending is destroyed.
+             */
+            void flushNotifications();
+
+            /**
+             * Closes the tcp/ip listener, disconnects all consumers and stops the network thread.
              */
             void close();
 
@@ -84,8 +131,9 @@ namespace glow
             
         private:
             /**
-             * This method is invoked when the root node or one of its children have changed. It then write
-             * the updated data to all consumers.
+             * This method is invoked when the root node or one of its children have changed. It then writes
+             * the updated data to all consumers. When the notifications are coalesced, the transmission is
+             * deferred until control returns to the event loop.
              * @param state The dirty state of the node that changed.
              * @param object The node that has changed its state.
              */
@@ -129,9 +177,44 @@ namespace glow
              */
             bool isNotificationRequired(gadget::Node const* node) const;
 
+            /**
+             * Transforms the dirty entities of the passed node and sends them to all consumers.
+             * Afterwards, the dirty state of the node and its children is cleared.
+             * @param node The node that has changed its state.
+             */
+            void notify(gadget::Node const* node);
+
+            /**
+             * Sends a notification to all connected consumers and keeps the encoded
+             * message for writeChangesSince.
+             * @param container The notification to encode and transmit.
+             */
+            void writeNotification(libember::glow::GlowContainer const* container);
+
+            /**
+             * Encodes a message and passes its packets to a sink. When metrics are collected,
+             * the duration of the encoding and the type of the message are recorded.
+             * @param container The message to encode.
+             * @param sink The sink to pass the packets to.
+             */
+            void encode(libember::glow::GlowContainer const* container, Encoder::PacketSink& sink);
+
+        private:
+            /** Posts an event to itself and flushes the pending notification when it is delivered. */
+            class NotificationDispatcher;
+
+            /** The number of notifications kept for consumers that reconnect. */
+            static const std::size_t ChangeLogCapacity = 1000;
+
         private:
             ProviderInterface *const m_provider;
+            ProviderMetrics* m_metrics;
+            QThread* m_thread;
             net::TcpServer* m_server;
+            NotificationDispatcher* m_dispatcher;
+            gadget::Node const* m_pendingNode;
+            std::deque<QByteArray> m_changes;
+            long m_sequence;
 
             static Settings s_settings;
     };
@@ -140,6 +223,11 @@ namespace glow
     {
         return m_server->port();
     }
+
+    inline long ConsumerProxy::sequence() const
+    {
+        return m_sequence;
+    }
 }
 
 #endif//__TINYEMBER_GLOW_CONSUMERPROXY_H
@@ -6,6 +6,7 @@
 #include "..\gadget\RealParameter.h"
 #include "..\gadget\StringParameter.h"
 #include "..\gadget\util\EntityPath.h"
+#include "..\gadget\util\PathIndex.h"
 #include "ConsumerProxy.h"
 #include "util\NodeConverter.h"
 #include "util\ParameterConverter.h"
@@ -16,22 +17,27 @@ using namespace gadget::util;
 
 namespace glow
 {
-    ConsumerRequestProcessor::GlowContainer* ConsumerRequestProcessor::execute(GlowContainer const* request, Node* root, GlowRootElementCollection* response, bool& transmitResponse, gadget::Subscriber* subscriber)
+    ConsumerRequestProcessor::GlowContainer* ConsumerRequestProcessor::execute(GlowContainer const* request, Node* root, GlowRootElementCollection* response, bool& transmitResponse, gadget::Subscriber* subscriber, ResponseWriter* writer)
     {
-        auto context = Context(false, false, subscriber);
-        auto const first = request->begin();
-        auto const last = request->end();
+        return execute(request->begin(), request->end(), root, response, transmitResponse, subscriber, writer);
+    }
+
+    ConsumerRequestProcessor::GlowContainer* ConsumerRequestProcessor::execute(libember::dom::Container::const_iterator first, libember::dom::Container::const_iterator last, Node* root, GlowRootElementCollection* response, bool& transmitResponse, gadget::Subscriber* subscriber, ResponseWriter* writer)
+    {
+        auto context = Context(false, false, subscriber, writer);
         for(auto it = first; it != last; ++it)
         {
             auto const& node = *it;
-            auto const type = ber::Type::fromTag(node.typeTag());
+            auto const element = libember::glow::GlowVisitor::toGlowContainer(&node);
+            if (element == nullptr)
+                continue;
 
-            switch(type.value())
+            switch(element->typeTag().number())
             {
                 case libember::glow::GlowType::Command:
                 {
                     // Report root node
-                    auto const& glow = dynamic_cast<GlowCommand const&>(node);
+                    auto const& glow = static_cast<GlowCommand const&>(*element);
                     if (glow.number().value() == libember::glow::CommandType::GetDirectory)
                     {
                         auto const& settings = ConsumerProxy::settings();
@@ -51,14 +57,37 @@ namespace glow
                             context.setTransmitResponse(true);
                         }
                     }
+                    else if (glow.number().value() == libember::glow::CommandType::GetDirectoryRecursive)
+                    {
+                        if (root->isMounted())
+                        {
+                            auto const mask = glow.dirFieldMask();
+                            auto count = 1U;
+                            util::NodeConverter::createQualified(response, root, toNodeFieldFlags(mask).value);
+                            executeRecursiveDirectory(root, toNodeFieldFlags(mask), toParameterFieldFlags(mask), response, context, count);
+                            context.setTransmitResponse(true);
+                        }
+                    }
+                    else if (glow.number().value() == libember::glow::CommandType::GetChangesSince)
+                    {
+                        // The reply follows the retransmitted notifications and carries no sequence
+                        // number if the consumer has to query the tree again.
+                        auto const writer = context.writer();
+                        auto const reply = new GlowCommand(response, libember::glow::CommandType::GetChangesSince);
+                        auto current = -1L;
+
+                        if (writer != nullptr && writer->writeChangesSince(glow.sequence(), current))
+                            reply->setSequence(current);
+
+                        context.setTransmitResponse(true);
+                    }
                     break;
                 }
                 case libember::glow::GlowType::QualifiedNode:
                 {
-                    auto const& glow = dynamic_cast<libember::glow::GlowQualifiedNode const&>(node);
+                    auto const& glow = static_cast<libember::glow::GlowQualifiedNode const&>(*element);
                     auto const oid = glow.path();
-                    auto const path = EntityPath(oid.begin(), oid.end());
-                    auto local = resolve_node(root, path.begin(), path.end());
+                    auto local = root->pathIndex()->findNode(oid.begin(), oid.end());
                     if (local != nullptr)
                     {
                         context.setIsQualifiedRequest(true);
@@ -68,10 +97,9 @@ namespace glow
                 }
                 case libember::glow::GlowType::QualifiedParameter:
                 {
-                    auto const& glow = dynamic_cast<libember::glow::GlowQualifiedParameter const&>(node);
+                    auto const& glow = static_cast<libember::glow::GlowQualifiedParameter const&>(*element);
                     auto const oid = glow.path();
-                    auto const path = EntityPath(oid.begin(), oid.end());
-                    auto local = resolve_parameter(root, path.begin(), path.end());
+                    auto local = root->pathIndex()->findParameter(oid.begin(), oid.end());
                     if (local != nullptr)
                     {
                         context.setIsQualifiedRequest(true);
@@ -82,7 +110,7 @@ namespace glow
                 case libember::glow::GlowType::Node:
                 {
                     context.setIsQualifiedRequest(false);
-                    auto const& glow = dynamic_cast<libember::glow::GlowNode const&>(node);
+                    auto const& glow = static_cast<libember::glow::GlowNode const&>(*element);
                     auto const number = glow.number();
                     if (number == root->number())
                     {
@@ -112,47 +140,37 @@ namespace glow
             {
                 for each(auto& child in *children)
                 {
-                    auto const type = libember::ber::Type::fromTag(child.typeTag());
-                    switch(type.value())
+                    auto const element = libember::glow::GlowVisitor::toGlowContainer(&child);
+                    if (element == nullptr)
+                        continue;
+
+                    switch(element->typeTag().number())
                     {
                         case libember::glow::GlowType::Command:
                         {
-                            auto const& command = dynamic_cast<libember::glow::GlowCommand const&>(child);
+                            auto const& command = static_cast<libember::glow::GlowCommand const&>(*element);
                             executeCommand(&command, node, response, context);
                             break;
                         }
                         case libember::glow::GlowType::Node:
                         {
-                            auto const& glow = dynamic_cast<libember::glow::GlowNode const&>(child);
-                            auto const& nodes = node->nodes();
-                            auto const first = std::begin(nodes);
-                            auto const last = std::end(nodes);
-                            auto const number = glow.number();
-                            auto result = std::find_if(first, last, [&glow](Node const* child) -> bool
-                            {
-                                return glow.number() == child->number();
-                            });
+                            auto const& glow = static_cast<libember::glow::GlowNode const&>(*element);
+                            auto const result = node->findNode(glow.number());
 
-                            if (result != last)
+                            if (result != nullptr)
                             {
-                                executeNode(&glow, *result, response, context);
+                                executeNode(&glow, result, response, context);
                             }
                             break;
                         }
                         case libember::glow::GlowType::Parameter:
                         {
-                            auto const& glow = dynamic_cast<libember::glow::GlowParameter const&>(child);
-                            auto const& parameters = node->parameters();
-                            auto const first = std::begin(parameters);
-                            auto const last = std::end(parameters);
-                            auto result = std::find_if(first, last, [&glow](Parameter const* child) -> bool
-                            {
-                                return glow.number() == child->number();
-                            });
+                            auto const& glow = static_cast<libember::glow::GlowParameter const&>(*element);
+                            auto const result = node->findParameter(glow.number());
 
-                            if (result != last)
+                            if (result != nullptr)
                             {
-                                executeParameter(&glow, *result, response, context);
+                                executeParameter(&glow, result, response, context);
                             }
                             break;
                         }
@@ -193,6 +211,8 @@ namespace glow
             }
             else
             {
+                auto count = 0U;
+
                 if (behavior == ResponseBehavior::ForceQualifiedContainer 
                 || (context.isQualifiedRequest() && behavior != ResponseBehavior::ForceExpandedContainer))
                 {
@@ -200,31 +220,72 @@ namespace glow
                     {
                         if(child->isMounted())
                         {
+                            nextDirectoryElement(response, context, count);
                             util::NodeConverter::createQualified(response, child, nodeFlags.value);
                         }
                     }
 
                     for each(auto parameter in parameters)
                     {
+                        nextDirectoryElement(response, context, count);
                         util::ParameterConverter::createQualified(response, parameter, parameterFlags.value);
                     }
                 }
                 else
                 {
-                    auto local = util::NodeConverter::createStructured(response, node);
-                    auto container = local->children();
+                    // Each chunk repeats the path to the node, so it can be processed on its own.
+                    auto container = util::NodeConverter::createStructured(response, node)->children();
 
                     for each(auto parameter in parameters)
                     {
+                        if (nextDirectoryElement(response, context, count))
+                            container = util::NodeConverter::createStructured(response, node)->children();
+
                         util::ParameterConverter::create(container, parameter, parameterFlags.value);
                     }
                     for each(auto child in nodes)
                     {
+                        if (nextDirectoryElement(response, context, count))
+                            container = util::NodeConverter::createStructured(response, node)->children();
+
                         util::NodeConverter::create(container, child, nodeFlags.value);
                     }
                 }
             }
         }
+        else if (command->number().value() == libember::glow::CommandType::GetDirectoryRecursive)
+        {
+            auto const mask = command->dirFieldMask();
+            auto count = 0U;
+
+            context.setTransmitResponse(true);
+
+            if (node->nodes().empty() && node->parameters().empty())
+                util::NodeConverter::createQualified(response, node);
+            else
+                executeRecursiveDirectory(node, toNodeFieldFlags(mask), toParameterFieldFlags(mask), response, context, count);
+        }
+    }
+
+    void ConsumerRequestProcessor::executeRecursiveDirectory(Node* node, gadget::NodeField const& nodeFlags, gadget::ParameterField const& parameterFlags, GlowRootElementCollection* response, Context& context, unsigned int& count)
+    {
+        for each(auto child in node->nodes())
+        {
+            if (child->isMounted())
+            {
+                nextDirectoryElement(response, context, count);
+                util::NodeConverter::createQualified(response, child, nodeFlags.value);
+
+                if (child->isOnline())
+                    executeRecursiveDirectory(child, nodeFlags, parameterFlags, response, context, count);
+            }
+        }
+
+        for each(auto parameter in node->parameters())
+        {
+            nextDirectoryElement(response, context, count);
+            util::ParameterConverter::createQualified(response, parameter, parameterFlags.value);
+        }
     }
 
     void ConsumerRequestProcessor::executeParameter(GlowParameterBase const* request, Parameter* parameter, GlowRootElementCollection* response, Context& context)
@@ -235,40 +296,60 @@ namespace glow
             {
                 auto const value = request->value();
                 auto const type = parameter->type();
-                auto const forceNotification = true;
+                auto const suppress = parameter->suppressesUnchangedValues();
+                auto const forceNotification = suppress == false;
+                auto isUnchanged = false;
                 switch(type.value())
                 {
                     case gadget::ParameterType::Boolean:
                     {
                         auto boolean = dynamic_cast<gadget::BooleanParameter*>(parameter);
-                        boolean->setValue(value.toBoolean(), forceNotification);
+                        auto const newValue = value.toBoolean();
+                        isUnchanged = boolean->value() == newValue;
+                        boolean->setValue(newValue, forceNotification);
                         break;
                     }
                     case gadget::ParameterType::Enum:
                     {
                         auto enumeration = dynamic_cast<gadget::EnumParameter*>(parameter);
-                        enumeration->setIndex(static_cast<gadget::EnumParameter::size_type>(value.toInteger()), forceNotification);
+                        auto const newIndex = static_cast<gadget::EnumParameter::size_type>(value.toInteger());
+                        isUnchanged = enumeration->index() == newIndex;
+                        enumeration->setIndex(newIndex, forceNotification);
                         break;
                     }
                     case gadget::ParameterType::Integer:
                     {
                         auto integer = dynamic_cast<gadget::IntegerParameter*>(parameter);
-                        integer->setValue(value.toInteger(), forceNotification);
+                        auto const newValue = value.toInteger();
+                        isUnchanged = integer->value() == newValue;
+                        integer->setValue(newValue, forceNotification);
                         break;
                     }
                     case gadget::ParameterType::Real:
                     {
                         auto real = dynamic_cast<gadget::RealParameter*>(parameter);
-                        real->setValue(value.toReal(), forceNotification);
+                        auto const newValue = value.toReal();
+                        isUnchanged = real->value() == newValue;
+                        real->setValue(newValue, forceNotification);
                         break;
                     }
                     case gadget::ParameterType::String:
                     {
                         auto string = dynamic_cast<gadget::StringParameter*>(parameter);
-                        string->setValue(value.toString(), forceNotification);
+                        auto const newValue = value.toString();
+                        isUnchanged = string->value() == newValue;
+                        string->setValue(newValue, forceNotification);
                         break;
                     }
                 }
+
+                // Nothing is broadcast for a suppressed value, but the requester
+                // still expects the current value as the answer to its request.
+                if (suppress && isUnchanged)
+                {
+                    context.setTransmitResponse(true);
+                    util::ParameterConverter::createQualified(response, parameter, gadget::ParameterField::Value);
+                }
             }
 
             auto children = request->children();
@@ -276,11 +357,14 @@ namespace glow
             {
                 for each(auto& child in *children)
                 {
-                    auto const type = libember::ber::Type::fromTag(child.typeTag());
-                    switch(type.value())
+                    auto const element = libember::glow::GlowVisitor::toGlowContainer(&child);
+                    if (element == nullptr)
+                        continue;
+
+                    switch(element->typeTag().number())
                     {
                         case libember::glow::GlowType::Command:
-                            auto const& command = dynamic_cast<libember::glow::GlowCommand const&>(child);
+                            auto const& command = static_cast<libember::glow::GlowCommand const&>(*element);
                             executeCommand(&command, parameter, response, context);
                             break;
                     }
@@ -292,7 +376,8 @@ namespace glow
     void ConsumerRequestProcessor::executeCommand(GlowCommand const* command, Parameter* parameter, GlowRootElementCollection* response, Context& context)
     {
         auto const number = command->number();
-        if (number.value() == libember::glow::CommandType::GetDirectory)
+        if (number.value() == libember::glow::CommandType::GetDirectory
+        ||  number.value() == libember::glow::CommandType::GetDirectoryRecursive)
         {
             context.setTransmitResponse(true);
             auto const& settings = ConsumerProxy::settings();
@@ -319,6 +404,50 @@ namespace glow
         }
     }
 
+    bool ConsumerRequestProcessor::isDirectoryRequest(libember::dom::Node const* request)
+    {
+        auto const command = dynamic_cast<GlowCommand const*>(request);
+        if (command != nullptr)
+        {
+            auto const number = command->number().value();
+            return number == libember::glow::CommandType::GetDirectory
+                || number == libember::glow::CommandType::GetDirectoryRecursive;
+        }
+
+        auto const parameter = dynamic_cast<GlowParameterBase const*>(request);
+        if (parameter != nullptr && parameter->contains(libember::glow::ParameterProperty::Value))
+            return false;
+
+        auto const container = dynamic_cast<libember::dom::Container const*>(request);
+        if (container != nullptr)
+        {
+            for each(auto const& child in *container)
+            {
+                if (isDirectoryRequest(&child) == false)
+                    return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool ConsumerRequestProcessor::nextDirectoryElement(GlowRootElementCollection* response, Context& context, unsigned int& count)
+    {
+        auto const writer = context.writer();
+        if (writer != nullptr && count >= DirectoryChunkSize)
+        {
+            writer->write(response);
+            response->clear();
+            count = 1;
+            return true;
+        }
+        else
+        {
+            ++count;
+            return false;
+        }
+    }
+
     gadget::NodeField ConsumerRequestProcessor::toNodeFieldFlags(libember::glow::DirFieldMask const& mask)
     {
         auto const value = mask.value();
@@ -1,10 +1,17 @@
 #ifndef __TINYEMBER_GLOW_CONSUMERREQUESTPROCESSOR_H
 #define __TINYEMBER_GLOW_CONSUMERREQUESTPROCESSOR_H
 
+#include <ember/dom/Container.hpp>
 #include "../gadget/ParameterField.h"
 #include "../gadget/NodeField.h"
 
 /** Forward declarations */
+namespace libember { namespace dom
+{
+    class Node;
+}
+}
+
 namespace libember { namespace glow
 {
     struct DirFieldMask;
@@ -35,6 +42,42 @@ namespace glow
      */
     class ConsumerRequestProcessor
     {
+        public:
+            /**
+             * Interface of the receivers of partial responses. The response to a GetDirectory
+             * request of a node with many children is split into several root element collections,
+             * each of which is passed to the writer as soon as it contains DirectoryChunkSize elements.
+             */
+            class ResponseWriter
+            {
+                public:
+                    /** Destructor */
+                    virtual ~ResponseWriter()
+                    {}
+
+                    /**
+                     * Transmits a partial response. The collection is cleared afterwards.
+                     * @param response The partial response to transmit.
+                     */
+                    virtual void write(libember::glow::GlowRootElementCollection const* response) = 0;
+
+                    /**
+                     * Retransmits the notifications that have been sent after the notification with
+                     * the specified sequence number, in response to a GetChangesSince command.
+                     * @param sequence The sequence number presented by the consumer, or -1 if the
+                     *      consumer only queries the current sequence number.
+                     * @param current Receives the sequence number of the last notification.
+                     * @return false if not all notifications sent after @p sequence are known anymore.
+                     */
+                    virtual bool writeChangesSince(long sequence, long& current) = 0;
+            };
+
+            /**
+             * The maximum number of children a partial directory response contains.
+             */
+            static const unsigned int DirectoryChunkSize = 500;
+
+        private:
         /**
          * Helper struct which stores some local settings while processing a request.
          */
@@ -46,11 +89,13 @@ namespace glow
              *      sent by the consumer.
              * @param transmitResponse Indicates whether it is necessary to transmit the resulting response.
              * @param subscriber A pointer to a subscriber who represents the consumer that sent the request.
+             * @param writer The writer receiving partial responses, may be nullptr.
              */
-            explicit Context(bool isQualifiedRequest, bool transmitResponse, gadget::Subscriber* subscriber)
+            explicit Context(bool isQualifiedRequest, bool transmitResponse, gadget::Subscriber* subscriber, ResponseWriter* writer)
                 : m_isQualifiedRequest(isQualifiedRequest)
                 , m_transmitResponse(transmitResponse)
                 , m_subscriber(subscriber)
+                , m_writer(writer)
             {}
 
             /**
@@ -98,8 +143,18 @@ namespace glow
                 return m_subscriber;
             }
 
+            /**
+             * Returns the writer that receives partial responses.
+             * @return The response writer, or nullptr if the response must not be split.
+             */
+            ResponseWriter* writer() const
+            {
+                return m_writer;
+            }
+
             private:
                 gadget::Subscriber* m_subscriber;
+                ResponseWriter* m_writer;
                 bool m_isQualifiedRequest;
                 bool m_transmitResponse;
         };
@@ -125,9 +180,38 @@ namespace glow
              * @param transmitResponse A reference to a boolean parameter which will be set to true
              *      when the generated response needs to be transmitted to the consumer.
              * @param subscriber The subscriber representing the consumer.
+             * @param writer If not nullptr, large directory responses are passed to this writer in
+             *      chunks while they are being generated. The response only contains the last chunk then.
+             * @return The response root node.
+             */
+            static GlowContainer* execute(GlowContainer const* request, Node* root, GlowRootElementCollection* response, bool& transmitResponse, gadget::Subscriber* subscriber, ResponseWriter* writer = nullptr);
+
+            /**
+             * Executes a part of a consumer request, consisting of the root elements from first
+             * to last. Executing all parts of a request one after the other has the same effect
+             * as executing it at once, except that each part generates a response of its own.
+             * @param first Refers to the first root element to execute.
+             * @param last Refers to the position one past the last root element to execute.
+             * @param root The root node of the local provider.
+             * @param response The root element collection to append the response to.
+             * @param transmitResponse A reference to a boolean parameter which will be set to true
+             *      when the generated response needs to be transmitted to the consumer.
+             * @param subscriber The subscriber representing the consumer.
+             * @param writer If not nullptr, large directory responses are passed to this writer in
+             *      chunks while they are being generated. The response only contains the last chunk then.
              * @return The response root node.
              */
-            static GlowContainer* execute(GlowContainer const* request, Node* root, GlowRootElementCollection* response, bool& transmitResponse, gadget::Subscriber* subscriber);
+            static GlowContainer* execute(libember::dom::Container::const_iterator first, libember::dom::Container::const_iterator last, Node* root, GlowRootElementCollection* response, bool& transmitResponse, gadget::Subscriber* subscriber, ResponseWriter* writer = nullptr);
+
+            /**
+             * Tests whether a request only queries the provider tree. The response to such a request
+             * doesn't depend on the consumer that sent it and the request doesn't modify the tree, so
+             * identical requests that are executed one after the other yield identical responses.
+             * @param request The decoded consumer request.
+             * @return true if the request contains no commands other than GetDirectory and
+             *      GetDirectoryRecursive and no parameter values.
+             */
+            static bool isDirectoryRequest(libember::dom::Node const* request);
 
         private:
             /**
@@ -168,6 +252,30 @@ namespace glow
              */
             static void executeCommand(GlowCommand const* command, Parameter* parameter, GlowRootElementCollection* response, Context& context);
 
+            /**
+             * Appends all descendants of a node to the response as qualified elements, in the order
+             * of a depth-first walk. This is the response to a GetDirectoryRecursive command. The
+             * children of unmounted or offline nodes are not reported.
+             * @param node The node whose descendants shall be reported.
+             * @param nodeFlags The properties to report for each node.
+             * @param parameterFlags The properties to report for each parameter.
+             * @param response The root element collection to append the elements to.
+             * @param context The context containing the response writer.
+             * @param count The number of elements within the current chunk.
+             */
+            static void executeRecursiveDirectory(Node* node, gadget::NodeField const& nodeFlags, gadget::ParameterField const& parameterFlags, GlowRootElementCollection* response, Context& context, unsigned int& count);
+
+            /**
+             * Counts an element that is about to be appended to a directory response. When the response
+             * already contains a complete chunk, it is passed to the response writer and cleared.
+             * @param response The response the element will be appended to.
+             * @param context The context containing the response writer.
+             * @param count The number of elements within the current chunk. Is reset when a chunk is written.
+             * @return true if the response has been written and cleared, so the caller has to recreate
+             *      the containers it appends its elements to.
+             */
+            static bool nextDirectoryElement(GlowRootElementCollection* response, Context& context, unsigned int& count);
+
             /**
              * Converts a DirFieldMask into a new NodeField instance which contains all flags for the
              * properties that are requested by the mask.
@@ -23,8 +23,13 @@ namespace glow
     }
 
 
-    Encoder::Stream::Stream(Encoder *const encoder)
-        : libember::util::OctetStream(1024)
+    Encoder::PacketSink::~PacketSink()
+    {
+    }
+
+
+    Encoder::Stream::Stream(Encoder *const encoder, size_type packetSize)
+        : libember::util::OctetStream(packetSize > 0 ? packetSize : size_type(DefaultPacketSize))
         , m_encoder(encoder)
     {}
 
@@ -41,9 +46,14 @@ namespace glow
     }
 
 
-    Encoder Encoder::createEmberMessage(libember::glow::GlowContainer const* container)
+    Encoder Encoder::createEmberMessage(libember::glow::GlowContainer const* container, size_type packetSize)
+    {
+        return Encoder(container, nullptr, packetSize);
+    }
+
+    void Encoder::writeEmberMessage(libember::glow::GlowContainer const* container, PacketSink& sink, size_type packetSize)
     {
-        return Encoder(container);
+        auto const encoder = Encoder(container, &sink, packetSize);
     }
 
     Encoder Encoder::createRequestKeepAliveMessage()
@@ -69,10 +79,11 @@ namespace glow
         return Encoder(encoder.begin(), encoder.end());
     }
 
-    Encoder::Encoder(libember::dom::Node const* node)
+    Encoder::Encoder(libember::dom::Node const* node, PacketSink* sink, size_type packetSize)
         : m_isFirstPacket(true)
+        , m_sink(sink)
     {
-        auto stream = Stream(this);
+        auto stream = Stream(this, packetSize);
         node->encode(stream);
         stream.finish();
     }
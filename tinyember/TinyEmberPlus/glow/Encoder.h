@@ -1,6 +1,7 @@
 #ifndef __TINYEMBER_GLOW_ENCODER_H
 #define __TINYEMBER_GLOW_ENCODER_H
 
+#include <iterator>
 #include <vector>
 #include <ember/Ember.hpp>
 #include <s101\CommandType.hpp>
@@ -13,7 +14,9 @@ namespace glow
 {
     /**
      * The Encoder class is used to encode a glow tree and also generates the ready-to-use s101 
-     * packets which contain the encoded tree.
+     * packets which contain the encoded tree. The packets can either be collected, or handed to
+     * a PacketSink as soon as each of them is complete, so large trees never have to be kept in
+     * memory as a whole.
      */
     class Encoder
     {
@@ -66,17 +69,51 @@ namespace glow
                     Container m_encodedBytes;
             };
 
+            /**
+             * Interface of the receivers of the packets generated by writeEmberMessage.
+             */
+            class PacketSink
+            {
+                public:
+                    typedef std::vector<unsigned char>::const_iterator const_iterator;
+
+                    /** Destructor */
+                    virtual ~PacketSink();
+
+                    /**
+                     * Called for each complete s101 packet, in order. The buffer is reused
+                     * for the next packet, so the data must be copied if it is kept.
+                     * @param first An iterator that points to the first byte of the packet.
+                     * @param last An iterator that points one past the last byte of the packet.
+                     * @param isLastPacket true if the packet completes the message.
+                     */
+                    virtual void write(const_iterator first, const_iterator last, bool isLastPacket) = 0;
+            };
+
             typedef std::vector<Packet> PacketCollection;
             typedef PacketCollection::const_iterator const_iterator;
             typedef PacketCollection::size_type size_type;
 
+            /** The default number of payload bytes per s101 packet. */
+            static size_type const DefaultPacketSize = 1024;
+
         public:
             /**
              * Encodes the passed container and wraps it into one or more s101 packages.
              * @param container The container to encode and wrap.
+             * @param packetSize The maximum number of ember bytes per packet.
              * @return A new Encoder instance which contains a collection of s101 packets.
              */
-            static Encoder createEmberMessage(libember::glow::GlowContainer const* container);
+            static Encoder createEmberMessage(libember::glow::GlowContainer const* container, size_type packetSize = DefaultPacketSize);
+
+            /**
+             * Encodes the passed container and passes each s101 packet to @p sink as soon as
+             * it is complete. Only the packet currently being encoded is kept in memory.
+             * @param container The container to encode and wrap.
+             * @param sink The receiver of the packets.
+             * @param packetSize The maximum number of ember bytes per packet.
+             */
+            static void writeEmberMessage(libember::glow::GlowContainer const* container, PacketSink& sink, size_type packetSize = DefaultPacketSize);
 
             /**
              * Creates a new provider state message.
@@ -114,8 +151,11 @@ namespace glow
              * Initializes a new Encoder instance and generates the s101 packets from the
              * node passed.
              * @param node The node to encode.
+             * @param sink The receiver of the packets. If nullptr, the packets are
+             *      stored in this instance.
+             * @param packetSize The maximum number of ember bytes per packet.
              */
-            explicit Encoder(libember::dom::Node const* node);
+            Encoder(libember::dom::Node const* node, PacketSink* sink, size_type packetSize);
 
             /**
              * Initializes a new Encoder instance with the provided packets.
@@ -138,12 +178,15 @@ namespace glow
 
         private:
             bool m_isFirstPacket;
+            PacketSink* m_sink;
             PacketCollection m_packets;
+            /** The buffer the frames are encoded into, reused for all packets. */
+            std::vector<unsigned char> m_frame;
 
         private:
             /**
              * Helper class which forwards encoded ember data to the Encoder, which then 
-             * generates a new s101 packet. This stream class is limited to 1024 bytes.
+             * generates a new s101 packet whenever the stream reaches the packet size.
              */
             class Stream : public libember::util::OctetStream
             {
@@ -151,8 +194,9 @@ namespace glow
                     /**
                      * Initializes a new Stream instance.
                      * @param encoder The encoder that finalizes the s101 packets.
+                     * @param packetSize The number of bytes after which a packet is finished.
                      */
-                    explicit Stream(Encoder *const encoder);
+                    Stream(Encoder *const encoder, size_type packetSize);
 
                     /**
                      * Finishes the pending data.
@@ -187,6 +231,7 @@ namespace glow
     template<typename InputIterator>
     inline Encoder::Encoder(InputIterator first, InputIterator last)
         : m_isFirstPacket(true)
+        , m_sink(nullptr)
     {
         m_packets.push_back(Packet(first, last));
     }
@@ -194,7 +239,6 @@ namespace glow
     template<typename InputIterator>
     inline void Encoder::finishPacket(InputIterator first, InputIterator last, bool isLastPacket)
     {
-        auto encoder = libs101::StreamEncoder<unsigned char>();
         auto const version = libember::glow::GlowDtd::version();
         auto const isEmpty = first == last;
         auto const flags = unsigned char(
@@ -203,20 +247,34 @@ namespace glow
                 (isEmpty ? libs101::PackageFlag::EmptyPackage : 0)
             );
 
-        encoder.encode(0x00);                       // Slot
-        encoder.encode(libs101::MessageType::EmBER);// Message type
-        encoder.encode(libs101::CommandType::EmBER);// Ember Command
-        encoder.encode(0x01);                       // Version
-        encoder.encode(flags);                      // Flags
-        encoder.encode(libs101::Dtd::Glow);         // Glow Dtd
-        encoder.encode(0x02);                       // App bytes low
-        encoder.encode((version >> 0) & 0xFF);      // App specific, minor revision
-        encoder.encode((version >> 8) & 0xFF);      // App specific, major revision
-        encoder.encode(first, last);
-        encoder.finish();
+        unsigned char const header[] =
+        {
+            0x00,                                               // Slot
+            libs101::MessageType::EmBER,                        // Message type
+            libs101::CommandType::EmBER,                        // Ember Command
+            0x01,                                               // Version
+            flags,                                              // Flags
+            libs101::Dtd::Glow,                                 // Glow Dtd
+            0x02,                                               // App bytes low
+            static_cast<unsigned char>((version >> 0) & 0xFF),  // App specific, minor revision
+            static_cast<unsigned char>((version >> 8) & 0xFF),  // App specific, major revision
+        };
+
+        // The frame is encoded straight into the reused frame buffer, which is grown to the worst case size
+        typedef libs101::StreamEncoder<unsigned char> FrameEncoder;
+        auto const payloadSize = static_cast<std::size_t>(std::distance(first, last));
+        if (m_frame.size() < FrameEncoder::maximumFrameSize(sizeof(header) + payloadSize))
+            m_frame.resize(FrameEncoder::maximumFrameSize(sizeof(header) + payloadSize));
+
+        auto const frameEnd = FrameEncoder::encodeFrame(header, header + sizeof(header), first, last, m_frame.data());
+        auto const frameSize = frameEnd - m_frame.data();
 
         m_isFirstPacket = false;
-        m_packets.push_back(Packet(encoder.begin(), encoder.end()));
+
+        if (m_sink != nullptr)
+            m_sink->write(m_frame.cbegin(), m_frame.cbegin() + frameSize, isLastPacket);
+        else
+            m_packets.push_back(Packet(m_frame.cbegin(), m_frame.cbegin() + frameSize));
     }
 }
 
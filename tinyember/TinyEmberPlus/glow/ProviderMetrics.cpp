@@ -0,0 +1,73 @@
+#include <algorithm>
+#include <iterator>
+#include "ProviderMetrics.h"
+
+namespace glow
+{
+    ProviderMetrics::ProviderMetrics(::util::MetricsRegistry* registry)
+        : m_decode(registry->histogram("tinyember_decode_seconds", "The time it took to decode the payload of a package."))
+        , m_encode(registry->histogram("tinyember_encode_seconds", "The time it took to encode a message."))
+        , m_keepAlive(registry->histogram("tinyember_keep_alive_rtt_seconds", "The time between queuing a keep-alive request for a consumer and receiving its response."))
+    {
+        using libember::glow::GlowType;
+
+        struct TypeName
+        {
+            int index;
+            char const* name;
+        };
+
+        static TypeName const typeNames[] =
+        {
+            { OtherIndex, "Other" },
+            { GlowType::Parameter, "Parameter" },
+            { GlowType::Command, "Command" },
+            { GlowType::Node, "Node" },
+            { GlowType::StreamCollection, "StreamCollection" },
+            { GlowType::QualifiedParameter, "QualifiedParameter" },
+            { GlowType::QualifiedNode, "QualifiedNode" },
+            { GlowType::Matrix, "Matrix" },
+            { GlowType::QualifiedMatrix, "QualifiedMatrix" },
+            { GlowType::Function, "Function" },
+            { GlowType::QualifiedFunction, "QualifiedFunction" },
+            { GlowType::InvocationResult, "InvocationResult" },
+        };
+
+        for each(auto const& type in typeNames)
+        {
+            auto const label = ::util::MetricsWriter::label("type", type.name);
+            m_received[type.index] = registry->counter("tinyember_messages_received_total", "The number of Glow messages received from consumers.", label);
+            m_sent[type.index] = registry->counter("tinyember_messages_sent_total", "The number of Glow messages sent to consumers.", label);
+        }
+
+        // Types that do not appear at the root of a message share a counter.
+        for (auto index = 1; index < IndexCount; index++)
+        {
+            auto const isNamed = std::any_of(std::begin(typeNames), std::end(typeNames), [index](TypeName const& type) { return type.index == index; });
+            if (isNamed == false)
+            {
+                m_received[index] = m_received[OtherIndex];
+                m_sent[index] = m_sent[OtherIndex];
+            }
+        }
+
+        m_clock.start();
+    }
+
+    //static
+    int ProviderMetrics::indexOf(libember::glow::GlowContainer const* glow)
+    {
+        if (glow == nullptr)
+            return OtherIndex;
+
+        auto const first = glow->childBegin();
+        if (first == glow->childEnd())
+            return OtherIndex;
+
+        auto const tag = first->typeTag();
+        if (tag.getClass() != libember::ber::Class::Application || tag.number() >= IndexCount)
+            return OtherIndex;
+
+        return static_cast<int>(tag.number());
+    }
+}
@@ -0,0 +1,134 @@
+#ifndef __TINYEMBER_GLOW_PROVIDERMETRICS_H
+#define __TINYEMBER_GLOW_PROVIDERMETRICS_H
+
+#include <ember/Ember.hpp>
+#include <qelapsedtimer.h>
+#include "../util/Metrics.h"
+
+namespace glow
+{
+    /**
+     * The metrics updated by the consumer proxy and the consumers. They are created
+     * once and updated by the ui and the network thread without any locking. Messages
+     * are labelled with the type of their first root element.
+     */
+    class ProviderMetrics
+    {
+        public:
+            /**
+             * Creates the metrics.
+             * @param registry The registry to create the metrics with.
+             */
+            explicit ProviderMetrics(::util::MetricsRegistry* registry);
+
+            /**
+             * Returns the current time of the clock used for all durations.
+             * @return The number of nanoseconds since the metrics have been created.
+             */
+            qint64 now() const;
+
+            /**
+             * Counts a message received from a consumer.
+             * @param glow The decoded message, or nullptr if it is not a glow container.
+             */
+            void countReceived(libember::glow::GlowContainer const* glow);
+
+            /**
+             * Counts a message sent to the consumers.
+             * @param glow The message that has been encoded.
+             */
+            void countSent(libember::glow::GlowContainer const* glow);
+
+            /**
+             * Counts stream entries that have been encoded as S101 frames by the caller.
+             */
+            void countSentStream();
+
+            /**
+             * Records the time it took to decode the payload of a package.
+             * @param nanoseconds The duration.
+             */
+            void recordDecode(qint64 nanoseconds);
+
+            /**
+             * Records the time it took to encode a message.
+             * @param nanoseconds The duration.
+             */
+            void recordEncode(qint64 nanoseconds);
+
+            /**
+             * Records the round trip time of a keep-alive request measured by a consumer.
+             * @param nanoseconds The round trip time.
+             */
+            void recordKeepAlive(qint64 nanoseconds);
+
+        private:
+            /**
+             * The indices of the message counters. The types of the root elements
+             * are indexed by their EmberPlus-Glow application tag.
+             */
+            enum
+            {
+                /** Messages of any type without a counter of its own. */
+                OtherIndex = 0,
+
+                IndexCount = libember::glow::GlowType::InvocationResult + 1
+            };
+
+            /**
+             * Returns the index of the counters of a message.
+             * @param glow The message.
+             * @return The index of the counters.
+             */
+            static int indexOf(libember::glow::GlowContainer const* glow);
+
+        private:
+            QElapsedTimer m_clock;
+            ::util::Counter* m_received[IndexCount];
+            ::util::Counter* m_sent[IndexCount];
+            ::util::Histogram* m_decode;
+            ::util::Histogram* m_encode;
+            ::util::Histogram* m_keepAlive;
+    };
+
+    /**************************************************************************
+     * Inline implementation                                                  *
+     **************************************************************************/
+
+    inline qint64 ProviderMetrics::now() const
+    {
+        return m_clock.nsecsElapsed();
+    }
+
+    inline void ProviderMetrics::countReceived(libember::glow::GlowContainer const* glow)
+    {
+        m_received[indexOf(glow)]->increment();
+    }
+
+    inline void ProviderMetrics::countSent(libember::glow::GlowContainer const* glow)
+    {
+        m_sent[indexOf(glow)]->increment();
+    }
+
+    inline void ProviderMetrics::countSentStream()
+    {
+        m_sent[libember::glow::GlowType::StreamCollection]->increment();
+    }
+
+    inline void ProviderMetrics::recordDecode(qint64 nanoseconds)
+    {
+        m_decode->record(nanoseconds);
+    }
+
+    inline void ProviderMetrics::recordEncode(qint64 nanoseconds)
+    {
+        m_encode->record(nanoseconds);
+    }
+
+    inline void ProviderMetrics::recordKeepAlive(qint64 nanoseconds)
+    {
+        m_keepAlive->record(nanoseconds);
+    }
+}
+
+#endif//__TINYEMBER_GLOW_PROVIDERMETRICS_H
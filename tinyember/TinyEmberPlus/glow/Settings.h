@@ -112,6 +112,20 @@ namespace glow
              */
             bool useEnumMap() const;
 
+            /**
+             * Returns true if the changes made within one pass of the event loop
+             * are collected and transmitted as a single notification.
+             * @return true if notifications are coalesced.
+             */
+            bool coalesceNotifications() const;
+
+            /**
+             * Returns the minimum time between two coalesced notifications.
+             * @return The minimum interval in milliseconds, 0 if notifications
+             *      are sent as soon as control returns to the event loop.
+             */
+            int minimumNotificationInterval() const;
+
             /**
              * Updates the response behavior.
              * @param value The new response behavior.
@@ -140,12 +154,33 @@ namespace glow
              */
             void setUseEnumMap(bool value);
 
+            /**
+             * Updates the "Coalesce Notifications" property. If set, the
+             * dirty states are accumulated until control returns to the
+             * event loop, so each parameter is reported only once with all
+             * fields that changed in the meantime. Otherwise, each change is
+             * reported immediately.
+             * @param value The value for this option.
+             */
+            void setCoalesceNotifications(bool value);
+
+            /**
+             * Updates the "Minimum Notification Interval" property. While
+             * notifications are coalesced, a notification is sent at most once
+             * per interval. Parameters changing faster, like a fader being
+             * dragged, are reported once per interval with their latest value.
+             * @param milliseconds The minimum interval, 0 disables the limit.
+             */
+            void setMinimumNotificationInterval(int milliseconds);
+
         private:
             /** Constructor */
             Settings();
 
             bool m_useEnumMap;
             bool m_alwaysReportOnlineState;
+            bool m_coalesceNotifications;
+            int m_minimumNotificationInterval;
             ResponseBehavior m_responseBehavior;
             NotificationBehavior m_notificationBehavior;
     };
@@ -174,6 +209,16 @@ namespace glow
         return m_useEnumMap;
     }
 
+    inline bool Settings::coalesceNotifications() const
+    {
+        return m_coalesceNotifications;
+    }
+
+    inline int Settings::minimumNotificationInterval() const
+    {
+        return m_minimumNotificationInterval;
+    }
+
     inline void Settings::setResponseBehavior(ResponseBehavior const& value)
     {
         m_responseBehavior = value;
@@ -194,10 +239,22 @@ namespace glow
         m_useEnumMap = value;
     }
 
+    inline void Settings::setCoalesceNotifications(bool value)
+    {
+        m_coalesceNotifications = value;
+    }
+
+    inline void Settings::setMinimumNotificationInterval(int milliseconds)
+    {
+        m_minimumNotificationInterval = milliseconds;
+    }
+
     inline Settings::Settings()
         : m_responseBehavior(ResponseBehavior::Default)
         , m_notificationBehavior(NotificationBehavior::UseExpandedContainer)
         , m_useEnumMap(false)
+        , m_coalesceNotifications(true)
+        , m_minimumNotificationInterval(0)
     {}
 }
 
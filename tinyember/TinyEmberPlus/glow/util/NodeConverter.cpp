@@ -57,7 +57,7 @@ namespace glow { namespace util
     {
         if(makeQualified)
         {
-            auto const path = gadget::util::make_path(node);
+            auto const& path = node->path();
             m_node = new libember::glow::GlowQualifiedNode(libember::ber::ObjectIdentifier(path.begin(), path.end()));
         }
         else
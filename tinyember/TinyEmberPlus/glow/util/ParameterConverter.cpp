@@ -1,3 +1,5 @@
+#include <algorithm>
+#include <vector>
 #include <ember\Ember.hpp>
 #include "NodeConverter.h"
 #include "ParameterConverter.h"
@@ -15,6 +17,84 @@ using namespace libember::glow;
 
 namespace glow { namespace util 
 {
+    namespace
+    {
+        /**
+         * Contains the encoded static properties of a parameter, which are reused as long
+         * as the parameter doesn't change its properties. Consumers request different sets
+         * of properties, for example a monitoring consumer may only query the identifiers
+         * while others query all properties. The most recently used encodings of several
+         * sets are kept, so these requests don't evict each other.
+         */
+        class EncodedProperties : public gadget::PropertyCache
+        {
+            public:
+                /**
+                 * The maximum number of property sets whose encoding is kept.
+                 */
+                static const std::size_t Capacity = 4;
+
+                /**
+                 * Returns the encoded properties of the specified set.
+                 * @param fields The properties that have to be encoded.
+                 * @param useEnumMap The current enumeration setting.
+                 * @return A pointer to the encoded properties, or nullptr if they have not been cached.
+                 */
+                libember::util::OctetSlice const* find(gadget::ParameterFieldState const& fields, bool useEnumMap)
+                {
+                    auto const first = std::begin(m_entries);
+                    auto const last = std::end(m_entries);
+                    for (auto it = first; it != last; ++it)
+                    {
+                        if (it->fields == fields && it->useEnumMap == useEnumMap)
+                        {
+                            // Move the entry to the front, so the least recently used entry is at the end.
+                            std::rotate(first, it, it + 1);
+                            return &first->properties;
+                        }
+                    }
+
+                    return nullptr;
+                }
+
+                /**
+                 * Adds the encoding of a property set. When the cache is full, the least recently
+                 * used entry is replaced.
+                 * @param fields The properties that have been encoded.
+                 * @param useEnumMap The enumeration setting the properties have been encoded with.
+                 * @param properties The encoded properties.
+                 */
+                void insert(gadget::ParameterFieldState const& fields, bool useEnumMap, libember::util::OctetSlice const& properties)
+                {
+                    if (m_entries.size() >= Capacity)
+                        m_entries.pop_back();
+
+                    auto const entry = Entry(fields, useEnumMap, properties);
+                    m_entries.insert(std::begin(m_entries), entry);
+                }
+
+            private:
+                /**
+                 * The encoding of a single property set.
+                 */
+                struct Entry
+                {
+                    Entry(gadget::ParameterFieldState const& fields, bool useEnumMap, libember::util::OctetSlice const& properties)
+                        : fields(fields)
+                        , useEnumMap(useEnumMap)
+                        , properties(properties)
+                    {
+                    }
+
+                    gadget::ParameterFieldState fields;
+                    bool useEnumMap;
+                    libember::util::OctetSlice properties;
+                };
+
+                std::vector<Entry> m_entries;
+        };
+    }
+
     libember::glow::GlowParameterBase* ParameterConverter::create(libember::glow::GlowContainer* parent, gadget::Parameter const* parameter, gadget::ParameterFieldState const& fields)
     {
         auto const result = ParameterConverter(parent, parameter, fields, false);
@@ -44,11 +124,11 @@ namespace glow { namespace util
     }
 
     ParameterConverter::ParameterConverter(libember::glow::GlowContainer* parent, gadget::Parameter const* parameter, gadget::ParameterFieldState const& fields, bool makeQualified)
-        : m_fields(fields)
+        : m_fields(ParameterField::None)
     {
         if (makeQualified)
         {
-            auto path = gadget::util::make_path(parameter);
+            auto const& path = parameter->path();
             m_parameter = new GlowQualifiedParameter(libember::ber::ObjectIdentifier(path.begin(), path.end()));
         }
         else
@@ -59,6 +139,51 @@ namespace glow { namespace util
         if (parent != nullptr)
             parent->insert(parent->end(), m_parameter);
 
+        // The static properties are only converted and encoded once, the value is always converted.
+        auto const staticFields = fields.mask(~(ParameterField::Value | ParameterField::ForceUpdate | ParameterField::SubscriptionCount));
+        if (staticFields.isDirty())
+        {
+            auto const useEnumMap = ConsumerProxy::settings().useEnumMap();
+            auto cache = std::dynamic_pointer_cast<EncodedProperties>(parameter->propertyCache());
+            auto const properties = cache != nullptr ? cache->find(staticFields, useEnumMap) : nullptr;
+            if (properties != nullptr)
+            {
+                m_parameter->insertEncodedProperties(*properties);
+            }
+            else
+            {
+                m_fields = staticFields;
+                convertProperties(parameter);
+
+                libember::util::OctetStream stream;
+                m_parameter->encodeProperties(stream);
+
+                libember::util::OctetSliceBuffer buffer(stream.size());
+                auto const encoded = buffer.append(stream.begin(), stream.size());
+
+                if (cache == nullptr)
+                {
+                    cache = std::make_shared<EncodedProperties>();
+                    parameter->setPropertyCache(cache);
+                }
+
+                cache->insert(staticFields, useEnumMap, encoded);
+            }
+        }
+        else if (parameter->type().value() == gadget::ParameterType::Trigger)
+        {
+            m_parameter->setType(libember::glow::ParameterType::Trigger);
+        }
+
+        if (fields.isSet(ParameterField::Value))
+        {
+            m_fields = ParameterField::Value;
+            parameter->accept(*this);
+        }
+    }
+
+    void ParameterConverter::convertProperties(gadget::Parameter const* parameter)
+    {
         if (m_fields.isSet(ParameterField::Identifier))
             m_parameter->setIdentifier(parameter->identifier());
 
@@ -61,6 +61,12 @@ namespace glow { namespace util
              */
             ParameterConverter(libember::glow::GlowContainer* parent, gadget::Parameter const* parameter, gadget::ParameterFieldState const& fields, bool makeQualified);
 
+            /**
+             * Transforms the properties selected by the current field state, except for the value.
+             * @param parameter The parameter to transform.
+             */
+            void convertProperties(gadget::Parameter const* parameter);
+
             /**
              * Transforms an enumeration.
              * @param parameter The parameter to transform.
@@ -24,6 +24,7 @@ namespace glow { namespace util
      */
     class StreamConverter
     {
+        friend class StreamPublisher;
         public:
             /**
              * Creates a new stream collection that contains all parameters that are registered to the specified stream manager.
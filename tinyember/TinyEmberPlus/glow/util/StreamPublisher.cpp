@@ -0,0 +1,260 @@
+#include <algorithm>
+#include <map>
+#include <s101\CommandType.hpp>
+#include <s101\Dtd.hpp>
+#include <s101\MessageType.hpp>
+#include <s101\PackageFlag.hpp>
+#include "StreamConverter.h"
+#include "StreamPublisher.h"
+#include "../../gadget/Parameter.h"
+#include "../../gadget/StreamManager.h"
+#include "../../gadget/StringParameter.h"
+
+namespace glow { namespace util
+{
+    StreamPublisher::StreamPublisher()
+        : m_revision(0)
+        , m_isValid(false)
+        , m_isFirstPacket(true)
+    {
+    }
+
+    bool StreamPublisher::publish(gadget::StreamManager const& manager)
+    {
+        if (m_isValid == false || m_revision != manager.revision())
+        {
+            rebuild(manager);
+        }
+
+        auto const& values = manager.values();
+        auto contentLength = std::size_t(0);
+        for each(auto& block in m_blocks)
+        {
+            block.isDirty = values.isAnyPending(std::begin(block.slots), std::end(block.slots));
+
+            if (block.isDirty)
+            {
+                patch(values, block);
+                contentLength += block.last - block.first;
+            }
+        }
+
+        m_entries.clear();
+        for each(auto slot in m_scalars)
+        {
+            if (values.isPending(slot))
+                encodeScalar(values, slot);
+        }
+
+        contentLength += m_entries.size();
+        m_frames.clear();
+
+        if (contentLength == 0)
+            return false;
+
+        beginMessage(contentLength);
+
+        for each(auto const& block in m_blocks)
+        {
+            if (block.isDirty)
+            {
+                auto const first = static_cast<unsigned char const*>(m_template.data());
+                writePayload(first + block.first, first + block.last);
+            }
+        }
+
+        writePayload(std::begin(m_entries), std::end(m_entries));
+        finishPacket(true);
+        return true;
+    }
+
+    void StreamPublisher::rebuild(gadget::StreamManager const& manager)
+    {
+        typedef std::map<int, SlotCollection> StreamMap;
+
+        auto const& values = manager.values();
+        auto streams = StreamMap();
+        for (auto slot = gadget::StreamValueStore::size_type(0); slot < values.size(); ++slot)
+            streams[values.streamIdentifier(slot)].push_back(slot);
+
+        m_blocks.clear();
+        m_scalars.clear();
+        m_template.clear();
+
+        for each(auto const& pair in streams)
+        {
+            auto const& slots = pair.second;
+
+            if (slots.size() == 1 && values.hasStreamDescriptor(slots.front()) == false)
+            {
+                m_scalars.push_back(slots.front());
+            }
+            else
+            {
+                auto block = Block();
+                auto size = std::size_t(0);
+
+                for each(auto slot in slots)
+                {
+                    if (values.hasStreamDescriptor(slot))
+                    {
+                        block.slots.push_back(slot);
+                        size = std::max(size, values.offset(slot) + values.format(slot).size());
+                    }
+                }
+
+                if (block.slots.empty())
+                    continue;
+
+                // The entry is encoded once, the octet string it ends with is
+                // overwritten whenever one of the parameters has changed.
+                auto const buffer = FrameBuffer(size, 0x00);
+                auto const entry = libember::glow::GlowStreamEntry(pair.first, std::begin(buffer), std::end(buffer));
+                auto output = libember::util::OctetStream();
+                entry.encode(output);
+
+                block.first = m_template.size();
+                m_template.insert(std::end(m_template), std::begin(output), std::end(output));
+                block.last = m_template.size();
+                block.offset = block.last - size;
+                block.isDirty = false;
+                m_blocks.push_back(block);
+            }
+        }
+
+        m_revision = manager.revision();
+        m_isValid = true;
+    }
+
+    void StreamPublisher::beginMessage(std::size_t contentLength)
+    {
+        auto const typeTag = libember::glow::GlowType(libember::glow::GlowType::StreamCollection).toTypeTag();
+
+        m_header.clear();
+        encodeHeader(m_header, libember::glow::GlowTags::Root(), encodedContainerLength(typeTag, contentLength));
+        encodeHeader(m_header, typeTag, contentLength);
+
+        m_isFirstPacket = true;
+        m_payload.clear();
+        writePayload(std::begin(m_header), std::end(m_header));
+    }
+
+    void StreamPublisher::patch(gadget::StreamValueStore const& values, Block& block)
+    {
+        auto const first = m_template.begin() + block.offset;
+        auto const last = m_template.begin() + block.last;
+
+        for each(auto slot in block.slots)
+        {
+            auto const output = first + values.offset(slot);
+
+            switch(values.type(slot))
+            {
+                case gadget::ParameterType::Enum:
+                case gadget::ParameterType::Integer:
+                    StreamConverter::encode(static_cast<long long>(values.integer(slot)), values.format(slot), output, last);
+                    break;
+
+                case gadget::ParameterType::Real:
+                    StreamConverter::encode(values.real(slot), values.format(slot), output, last);
+                    break;
+
+                default:
+                    /* Booleans and strings are not supported within octet streams */
+                    break;
+            }
+
+            values.parameter(slot)->clearDirtyState();
+        }
+    }
+
+    void StreamPublisher::encodeScalar(gadget::StreamValueStore const& values, gadget::StreamValueStore::size_type slot)
+    {
+        auto const identifier = values.streamIdentifier(slot);
+
+        switch(values.type(slot))
+        {
+            case gadget::ParameterType::Boolean:
+                // Booleans are streamed as integers, like the GlowStreamEntry created by the StreamConverter.
+                encodeEntry(m_entries, identifier, values.integer(slot) != 0 ? 1 : 0);
+                break;
+
+            case gadget::ParameterType::Enum:
+            case gadget::ParameterType::Integer:
+                encodeEntry(m_entries, identifier, static_cast<int>(values.integer(slot)));
+                break;
+
+            case gadget::ParameterType::Real:
+                encodeEntry(m_entries, identifier, values.real(slot));
+                break;
+
+            case gadget::ParameterType::String:
+                // Strings are not mirrored by the store, so they are read from the parameter.
+                encodeEntry(m_entries, identifier, static_cast<gadget::StringParameter const*>(values.parameter(slot))->value());
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    void StreamPublisher::writePayload(unsigned char const* first, unsigned char const* last)
+    {
+        while (first != last)
+        {
+            if (m_payload.size() == MaximumPayloadSize)
+                finishPacket(false);
+
+            auto const available = static_cast<std::ptrdiff_t>(MaximumPayloadSize - m_payload.size());
+            auto const count = std::min(available, last - first);
+            m_payload.insert(std::end(m_payload), first, first + count);
+            first += count;
+        }
+    }
+
+    void StreamPublisher::finishPacket(bool isLastPacket)
+    {
+        auto const version = libember::glow::GlowDtd::version();
+        auto const flags = static_cast<unsigned char>(
+                (m_isFirstPacket ? libs101::PackageFlag::FirstPackage : 0) |
+                (isLastPacket ? libs101::PackageFlag::LastPackage : 0)
+            );
+
+        unsigned char const header[] =
+        {
+            0x00,                                               // Slot
+            libs101::MessageType::EmBER,                        // Message type
+            libs101::CommandType::EmBER,                        // Ember Command
+            0x01,                                               // Version
+            flags,                                              // Flags
+            libs101::Dtd::Glow,                                 // Glow Dtd
+            0x02,                                               // App bytes low
+            static_cast<unsigned char>((version >> 0) & 0xFF),  // App specific, minor revision
+            static_cast<unsigned char>((version >> 8) & 0xFF),  // App specific, major revision
+        };
+
+        // The frame is appended to the frame buffer directly, which is grown by the worst case size first
+        typedef libs101::StreamEncoder<unsigned char> FrameEncoder;
+        auto const offset = m_frames.size();
+        m_frames.resize(offset + FrameEncoder::maximumFrameSize(sizeof(header) + m_payload.size()));
+
+        auto const frameEnd = FrameEncoder::encodeFrame(header, header + sizeof(header), m_payload.data(), m_payload.data() + m_payload.size(), m_frames.data() + offset);
+        m_frames.resize(frameEnd - m_frames.data());
+        m_payload.clear();
+        m_isFirstPacket = false;
+    }
+
+    //static
+    void StreamPublisher::encodeHeader(libember::util::OctetStream& output, libember::ber::Tag const& tag, std::size_t length)
+    {
+        libember::ber::encode(output, tag.toContainer());
+        libember::ber::encode(output, libember::ber::make_length(length));
+    }
+
+    //static
+    std::size_t StreamPublisher::encodedContainerLength(libember::ber::Tag const& tag, std::size_t length)
+    {
+        return libember::ber::encodedLength(tag.toContainer()) + libember::ber::encodedLength(libember::ber::make_length(length)) + length;
+    }
+}
+}
@@ -0,0 +1,234 @@
+#ifndef __TINYEMBER_GLOW_UTIL_STREAMPUBLISHER_H
+#define __TINYEMBER_GLOW_UTIL_STREAMPUBLISHER_H
+
+#include <vector>
+#include <ember\Ember.hpp>
+#include <s101\StreamEncoder.hpp>
+#include "../../gadget/StreamValueStore.h"
+
+namespace gadget
+{
+    class StreamManager;
+}
+
+namespace glow { namespace util
+{
+    /**
+     * Encodes the values of all streamed parameters into ready-made S101 frames, without
+     * building a GlowStreamCollection for each tick.
+     * The stream entries of parameters that share an octet string block are encoded once
+     * into a template, their values are then patched in place. Entries of single parameters
+     * are encoded directly into a buffer that retains its capacity. The template is only
+     * rebuilt when the set of parameters registered at the StreamManager changes.
+     * The parameters are referred to by their slots in the StreamValueStore of the manager,
+     * so testing and encoding the values doesn't touch the parameter objects.
+     */
+    class StreamPublisher
+    {
+        public:
+            typedef std::vector<unsigned char> FrameBuffer;
+
+            /** Constructor */
+            StreamPublisher();
+
+            /**
+             * Encodes the entries of all subscribed streams whose values have changed.
+             * @param manager The stream manager containing the streamed parameters.
+             * @return true if at least one entry has been encoded and frames() contains
+             *      the packets to transmit, otherwise false.
+             */
+            bool publish(gadget::StreamManager const& manager);
+
+            /**
+             * Frames stream entries that have already been encoded, for example by a
+             * simulation, into a single stream collection, without touching any parameter.
+             * @param first An iterator to the first buffer of encoded entries.
+             * @param last An iterator one past the last buffer of encoded entries.
+             * @return true if at least one entry has been passed and frames() contains
+             *      the packets to transmit, otherwise false.
+             * @note A buffer must provide the methods begin(), end() and size().
+             */
+            template<typename BufferIterator>
+            bool publish(BufferIterator first, BufferIterator last);
+
+            /**
+             * Encodes a single stream entry, including its element tag.
+             * @param output The stream to append the entry to.
+             * @param identifier The stream identifier.
+             * @param value The value of the stream.
+             */
+            template<typename ValueType>
+            static void encodeEntry(libember::util::OctetStream& output, int identifier, ValueType const& value);
+
+            /**
+             * Returns the S101 packets encoded by the last call to publish. The buffer is
+             * overwritten by the next call to publish.
+             * @return The encoded S101 packets.
+             */
+            FrameBuffer const& frames() const;
+
+        private:
+            /**
+             * Stream entry whose value is an octet string composed of the values of
+             * several parameters, each located by its stream descriptor.
+             */
+            struct Block
+            {
+                std::vector<gadget::StreamValueStore::size_type> slots;
+                FrameBuffer::size_type first;
+                FrameBuffer::size_type last;
+                FrameBuffer::size_type offset;
+                bool isDirty;
+            };
+
+            typedef std::vector<Block> BlockCollection;
+            typedef std::vector<gadget::StreamValueStore::size_type> SlotCollection;
+
+            enum
+            {
+                /** The maximum number of payload bytes in a single S101 packet. */
+                MaximumPayloadSize = 1024
+            };
+
+            /**
+             * Rebuilds the template for the parameters currently registered at the manager.
+             * @param manager The stream manager containing the streamed parameters.
+             */
+            void rebuild(gadget::StreamManager const& manager);
+
+            /**
+             * Encodes the values of all parameters of @p block into the template.
+             * @param values The store containing the values of the parameters.
+             * @param block The block to update.
+             */
+            void patch(gadget::StreamValueStore const& values, Block& block);
+
+            /**
+             * Encodes the stream entry of a single parameter, by using its value type.
+             * @param values The store containing the value of the parameter.
+             * @param slot The slot of the parameter.
+             */
+            void encodeScalar(gadget::StreamValueStore const& values, gadget::StreamValueStore::size_type slot);
+
+            /**
+             * Encodes the header of a stream collection into the first packet.
+             * @param contentLength The number of bytes of all entries of the collection.
+             */
+            void beginMessage(std::size_t contentLength);
+
+            /**
+             * Appends the passed bytes to the payload of the current packet. The packet
+             * is finished when it reaches the maximum payload size.
+             * @param first The first byte to append.
+             * @param last The byte one past the last byte to append.
+             */
+            template<typename InputIterator>
+            void writePayload(InputIterator first, InputIterator last);
+
+            /**
+             * Appends the bytes of a contiguous buffer to the payload of the current packet.
+             * @see writePayload(InputIterator, InputIterator)
+             */
+            void writePayload(unsigned char const* first, unsigned char const* last);
+
+            /**
+             * Frames the current payload and appends the packet to the frame buffer.
+             * @param isLastPacket true if this is the last packet of the message.
+             */
+            void finishPacket(bool isLastPacket);
+
+            /**
+             * Encodes the tag and the definite length of a container. The tag is encoded
+             * with the constructed flag set.
+             * @param output The stream to encode the header to.
+             * @param tag The tag of the container.
+             * @param length The length of the container's content.
+             */
+            static void encodeHeader(libember::util::OctetStream& output, libember::ber::Tag const& tag, std::size_t length);
+
+            /**
+             * Returns the number of bytes of a container with the passed tag and content length.
+             * @param tag The tag of the container.
+             * @param length The length of the container's content.
+             * @return The encoded length of the container, including its header.
+             */
+            static std::size_t encodedContainerLength(libember::ber::Tag const& tag, std::size_t length);
+
+        private:
+            unsigned int m_revision;
+            bool m_isValid;
+            BlockCollection m_blocks;
+            SlotCollection m_scalars;
+            FrameBuffer m_template;
+            libember::util::OctetStream m_header;
+            libember::util::OctetStream m_entries;
+            FrameBuffer m_payload;
+            FrameBuffer m_frames;
+            bool m_isFirstPacket;
+    };
+
+    /**************************************************************************
+     * Inline implementation                                                  *
+     **************************************************************************/
+
+    inline StreamPublisher::FrameBuffer const& StreamPublisher::frames() const
+    {
+        return m_frames;
+    }
+
+    template<typename BufferIterator>
+    inline bool StreamPublisher::publish(BufferIterator first, BufferIterator last)
+    {
+        auto contentLength = std::size_t(0);
+        for (auto it = first; it != last; ++it)
+            contentLength += it->size();
+
+        m_frames.clear();
+
+        if (contentLength == 0)
+            return false;
+
+        beginMessage(contentLength);
+
+        for ( ; first != last; ++first)
+            writePayload(first->begin(), first->end());
+
+        finishPacket(true);
+        return true;
+    }
+
+    template<typename ValueType>
+    inline void StreamPublisher::encodeEntry(libember::util::OctetStream& output, int identifier, ValueType const& value)
+    {
+        typedef libember::glow::GlowTags::StreamEntry EntryTags;
+
+        auto const identifierLength = libember::ber::encodedFrameLength(identifier);
+        auto const valueLength = libember::ber::encodedFrameLength(value);
+        auto const contentLength =
+            encodedContainerLength(EntryTags::StreamIdentifier(), identifierLength) +
+            encodedContainerLength(EntryTags::StreamValue(), valueLength);
+        auto const typeTag = libember::glow::GlowType(libember::glow::GlowType::StreamEntry).toTypeTag();
+
+        encodeHeader(output, libember::glow::GlowTags::ElementDefault(), encodedContainerLength(typeTag, contentLength));
+        encodeHeader(output, typeTag, contentLength);
+        encodeHeader(output, EntryTags::StreamIdentifier(), identifierLength);
+        libember::ber::encodeFrame(output, identifier);
+        encodeHeader(output, EntryTags::StreamValue(), valueLength);
+        libember::ber::encodeFrame(output, value);
+    }
+
+    template<typename InputIterator>
+    inline void StreamPublisher::writePayload(InputIterator first, InputIterator last)
+    {
+        for ( ; first != last; ++first)
+        {
+            if (m_payload.size() == MaximumPayloadSize)
+                finishPacket(false);
+
+            m_payload.push_back(*first);
+        }
+    }
+}
+}
+
+#endif//__TINYEMBER_GLOW_UTIL_STREAMPUBLISHER_H
@@ -0,0 +1,55 @@
+#include <algorithm>
+#include "StreamPublisher.h"
+#include "StreamSimulator.h"
+
+namespace glow { namespace util
+{
+    StreamSimulator::Slice::Slice(int first, int count, unsigned int seed)
+        : m_first(first)
+        , m_count(count)
+        , m_state(seed)
+    {
+    }
+
+    //static
+    void StreamSimulator::generate(Slice& slice)
+    {
+        auto const first = slice.m_first;
+        auto const last = slice.m_first + slice.m_count;
+
+        slice.m_entries.clear();
+        for (auto identifier = first; identifier < last; ++identifier)
+        {
+            auto const value = static_cast<int>(slice.next() & 0xFFFF) - 0x8000;
+            StreamPublisher::encodeEntry(slice.m_entries, identifier, value);
+        }
+    }
+
+    StreamSimulator::StreamSimulator()
+        : m_count(0)
+    {
+    }
+
+    void StreamSimulator::setStreams(int first, int count, int sliceCount)
+    {
+        m_slices.clear();
+        m_count = std::max(count, 0);
+
+        if (m_count == 0)
+            return;
+
+        auto const slices = std::min(std::max(sliceCount, 1), m_count);
+        auto const size = m_count / slices;
+        auto const remainder = m_count % slices;
+
+        for (auto i = 0; i < slices; ++i)
+        {
+            // Each slice starts a sequence of its own, the seed only needs to be non-zero.
+            auto const seed = 2463534242U + 0x9E3779B9U * static_cast<unsigned int>(i);
+            auto const streams = size + (i < remainder ? 1 : 0);
+            m_slices.push_back(Slice(first, streams, seed != 0 ? seed : 1));
+            first += streams;
+        }
+    }
+}
+}
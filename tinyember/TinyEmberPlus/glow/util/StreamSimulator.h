@@ -0,0 +1,173 @@
+#ifndef __TINYEMBER_GLOW_UTIL_STREAMSIMULATOR_H
+#define __TINYEMBER_GLOW_UTIL_STREAMSIMULATOR_H
+
+#include <vector>
+#include <ember\Ember.hpp>
+
+namespace glow { namespace util
+{
+    /**
+     * Generates random values for a range of stream identifiers and encodes them
+     * directly into stream entries, without a parameter for each stream. This is used
+     * to turn the provider into a load generator for testing consumers.
+     * The streams are divided into slices, each having its own random number generator
+     * and its own buffer, so the slices can be generated on different threads at once.
+     * The encoded entries are passed to StreamPublisher::publish.
+     */
+    class StreamSimulator
+    {
+        public:
+            /**
+             * A range of streams that is generated as a unit.
+             */
+            class Slice
+            {
+                friend class StreamSimulator;
+                public:
+                    typedef libember::util::OctetStream::const_iterator const_iterator;
+                    typedef libember::util::OctetStream::size_type size_type;
+
+                    /**
+                     * Returns an iterator to the first byte of the encoded entries.
+                     * @return An iterator to the first byte of the encoded entries.
+                     */
+                    const_iterator begin() const;
+
+                    /**
+                     * Returns an iterator one past the last byte of the encoded entries.
+                     * @return An iterator one past the last byte of the encoded entries.
+                     */
+                    const_iterator end() const;
+
+                    /**
+                     * Returns the number of bytes of the encoded entries.
+                     * @return The number of bytes of the encoded entries.
+                     */
+                    size_type size() const;
+
+                private:
+                    /**
+                     * Initializes a new slice.
+                     * @param first The first stream identifier of the slice.
+                     * @param count The number of streams of the slice.
+                     * @param seed The initial state of the random number generator, must not be 0.
+                     */
+                    Slice(int first, int count, unsigned int seed);
+
+                    /**
+                     * Returns the next number of the xorshift generator of this slice.
+                     * @return The next random number.
+                     */
+                    unsigned int next();
+
+                private:
+                    int m_first;
+                    int m_count;
+                    unsigned int m_state;
+                    libember::util::OctetStream m_entries;
+            };
+
+            typedef std::vector<Slice> SliceCollection;
+            typedef SliceCollection::const_iterator const_iterator;
+
+            /**
+             * Generates new values for all streams of the passed slice and encodes them. Different
+             * slices may be generated concurrently.
+             * @param slice The slice to generate.
+             */
+            static void generate(Slice& slice);
+
+        public:
+            /** Constructor, initializes a simulation without any streams. */
+            StreamSimulator();
+
+            /**
+             * Sets the simulated streams. The values are 16 bit signed integers.
+             * @param first The first stream identifier.
+             * @param count The number of consecutive stream identifiers to simulate.
+             * @param sliceCount The number of slices the streams are divided into, usually the
+             *      number of threads generating them.
+             */
+            void setStreams(int first, int count, int sliceCount);
+
+            /**
+             * Returns the slices of the simulation, which may be passed to generate.
+             * @return The slices of the simulation.
+             */
+            SliceCollection& slices();
+
+            /**
+             * Returns an iterator to the first slice.
+             * @return An iterator to the first slice.
+             */
+            const_iterator begin() const;
+
+            /**
+             * Returns an iterator one past the last slice.
+             * @return An iterator one past the last slice.
+             */
+            const_iterator end() const;
+
+            /**
+             * Returns the number of simulated streams.
+             * @return The number of simulated streams.
+             */
+            int count() const;
+
+        private:
+            SliceCollection m_slices;
+            int m_count;
+    };
+
+    /**************************************************************************
+     * Inline implementation                                                  *
+     **************************************************************************/
+
+    inline StreamSimulator::Slice::const_iterator StreamSimulator::Slice::begin() const
+    {
+        return m_entries.begin();
+    }
+
+    inline StreamSimulator::Slice::const_iterator StreamSimulator::Slice::end() const
+    {
+        return m_entries.end();
+    }
+
+    inline StreamSimulator::Slice::size_type StreamSimulator::Slice::size() const
+    {
+        return m_entries.size();
+    }
+
+    inline unsigned int StreamSimulator::Slice::next()
+    {
+        auto state = m_state;
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        m_state = state;
+        return state;
+    }
+
+    inline StreamSimulator::SliceCollection& StreamSimulator::slices()
+    {
+        return m_slices;
+    }
+
+    inline StreamSimulator::const_iterator StreamSimulator::begin() const
+    {
+        return m_slices.begin();
+    }
+
+    inline StreamSimulator::const_iterator StreamSimulator::end() const
+    {
+        return m_slices.end();
+    }
+
+    inline int StreamSimulator::count() const
+    {
+        return m_count;
+    }
+}
+}
+
+#endif//__TINYEMBER_GLOW_UTIL_STREAMSIMULATOR_H
@@ -9,12 +9,20 @@
 //    return a.exec();
 //}
 #include "TinyEmberPlus.h"
+#include <iostream>
+#include <limits>
 #include <memory>
 #include <QtGui/QApplication>
 
+#include "gadget/Parameter.h"
 #include "gadget/Subscriber.h"
 #include "glow\ConsumerProxy.h"
 #include "glow\ProviderInterface.h"
+#include "net\MetricsEndpoint.h"
+#include "serialization\ChangeLogReader.h"
+#include "serialization\ChangeLogWriter.h"
+#include "util\Log.h"
+#include "util\Metrics.h"
 
 /**
  * The LocalScheduler class marshalls asynchronous consumer request to the ui thread,
@@ -81,6 +89,77 @@ class LocalScheduler : public glow::ProviderInterface
         glow::ProviderInterface* m_provider;
 };
 
+/**
+ * Prints the changes read from a change log as comma separated values.
+ */
+class ChangeLogPrinter
+{
+    public:
+        /**
+         * Constructor
+         * @param reader The reader providing the paths of the changes.
+         */
+        explicit ChangeLogPrinter(serialization::ChangeLogReader const& reader)
+            : m_reader(reader)
+        {
+        }
+
+        /**
+         * Prints a single change.
+         * @param change The change to print.
+         */
+        void operator()(serialization::ChangeLogReader::Change const& change)
+        {
+            typedef serialization::detail::ChangeLog ChangeLog;
+
+            std::cout << change.time << ',';
+
+            auto const& path = m_reader.path(change.path);
+            for (auto it = std::begin(path); it != std::end(path); ++it)
+                std::cout << (it != std::begin(path) ? "." : "") << *it;
+
+            std::cout << ',' << change.stream << ',';
+
+            switch(change.type)
+            {
+                case ChangeLog::Integer: std::cout << "integer," << change.integer; break;
+                case ChangeLog::Real: std::cout << "real," << change.real; break;
+                case ChangeLog::Boolean: std::cout << "boolean," << (change.integer != 0 ? "true" : "false"); break;
+                case ChangeLog::Enum: std::cout << "enum," << change.integer; break;
+                case ChangeLog::String: std::cout << "string,\""; std::cout.write(change.text, change.textLength); std::cout << '"'; break;
+                default: std::cout << "unknown,"; break;
+            }
+
+            std::cout << '\n';
+        }
+
+    private:
+        ChangeLogPrinter& operator=(ChangeLogPrinter const&);
+
+        serialization::ChangeLogReader const& m_reader;
+};
+
+/**
+ * Prints the content of a change log to the standard output.
+ * @param filename The name of the log file.
+ * @return The exit code of the application.
+ */
+static int dumpChangeLog(QString const& filename)
+{
+    serialization::ChangeLogReader reader(filename);
+    if (reader.open() == false)
+    {
+        std::cerr << "Failed to open change log " << filename.toStdString() << std::endl;
+        return 1;
+    }
+
+    auto printer = ChangeLogPrinter(reader);
+    std::cout << "time,path,stream,type,value\n";
+    reader.query(std::numeric_limits<std::int64_t>::min(), std::numeric_limits<std::int64_t>::max(), serialization::ChangeLogReader::AnyPath, printer);
+    std::cout.flush();
+    return 0;
+}
+
 int main(int argc, char *argv[])
 {
     QApplication app(argc, argv);
@@ -88,6 +167,9 @@ int main(int argc, char *argv[])
     auto first = argv;
     auto const last = argv + argc;
     auto port = short(9000);
+    auto metricsPort = short(0);
+    auto logLevel = util::LogLevel::Info;
+    auto changeLog = QString();
 
     for (; first != last; first++)
     {
@@ -96,20 +178,63 @@ int main(int argc, char *argv[])
         {
             std::advance(first, 1);
             port = QString(*first).toShort();
-            break;
+        }
+        else if (item.contains("metrics", Qt::CaseInsensitive) && (std::next(first) != last))
+        {
+            std::advance(first, 1);
+            metricsPort = QString(*first).toShort();
+        }
+        else if (item.contains("loglevel", Qt::CaseInsensitive) && (std::next(first) != last))
+        {
+            // One of debug, info, warning, error or none.
+            std::advance(first, 1);
+            util::LogLevel::parse(QString(*first), logLevel);
+        }
+        else if (item.contains("dumpchangelog", Qt::CaseInsensitive) && (std::next(first) != last))
+        {
+            // Prints a recorded log instead of starting the provider.
+            std::advance(first, 1);
+            return dumpChangeLog(QString(*first));
+        }
+        else if (item.contains("changelog", Qt::CaseInsensitive) && (std::next(first) != last))
+        {
+            std::advance(first, 1);
+            changeLog = QString(*first);
         }
     }
 
     auto result = -1;
     {
+        // The log messages are written by a background thread until the provider has been closed.
+        util::Log::setLevel(logLevel);
+        util::LogWriter logWriter;
+
+        // The metrics are only collected when an endpoint to export them is requested.
+        util::MetricsRegistry metrics;
         LocalScheduler scheduler;
-        glow::ConsumerProxy proxy(&app, &scheduler, port);
+        glow::ConsumerProxy proxy(&app, &scheduler, port, metricsPort != 0 ? &metrics : nullptr);
+        std::unique_ptr<net::MetricsEndpoint> endpoint;
+
+        if (metricsPort != 0)
+            endpoint.reset(new net::MetricsEndpoint(nullptr, &metrics, metricsPort));
+
+        // The value changes are only recorded when a log file is specified.
+        std::unique_ptr<serialization::ChangeLogWriter> writer;
+        if (changeLog.isEmpty() == false)
+        {
+            writer.reset(new serialization::ChangeLogWriter(changeLog));
+            if (writer->open())
+                gadget::Parameter::setValueObserver(writer.get());
+            else
+                writer.reset();
+        }
 
         TinyEmberPlus window(&proxy);
         window.show();
         scheduler.setSynchronizationObject(&window);
         result = app.exec();
         proxy.close();
+        gadget::Parameter::setValueObserver(nullptr);
     }
 
     return result;
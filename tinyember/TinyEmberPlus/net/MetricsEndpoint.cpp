@@ -0,0 +1,86 @@
+#include "MetricsEndpoint.h"
+#include "../util/Metrics.h"
+
+namespace net
+{
+    class MetricsEndpoint::Client : public TcpClient
+    {
+        public:
+            /**
+             * Initializes a new client.
+             * @param socket The accepted socket.
+             * @param registry The registry to export.
+             */
+            Client(QTcpSocket* socket, util::MetricsRegistry const* registry)
+                : TcpClient(socket)
+                , m_registry(registry)
+            {}
+
+        protected:
+            /**
+             * Collects the received bytes until the header of a request is complete
+             * and answers it. The body of a request is not expected and ignored. Each
+             * connection serves a single request and is closed after the response.
+             */
+            virtual void read(const_iterator first, const_iterator last, size_type size)
+            {
+                Q_UNUSED(size);
+                m_request.append(reinterpret_cast<char const*>(first), static_cast<int>(last - first));
+
+                if (m_request.indexOf("\r\n\r\n") >= 0)
+                {
+                    respond(m_request.startsWith("GET "));
+                }
+                else if (m_request.size() > MaximumRequestSize)
+                {
+                    // A client sending a header of this size doesn't speak HTTP.
+                    respond(false);
+                }
+            }
+
+        private:
+            /**
+             * Writes the response to a request and closes the connection, as announced
+             * by its header.
+             * @param isValid true if the request is a GET request, which is answered with
+             *      the metrics. Any other request is rejected.
+             */
+            void respond(bool isValid)
+            {
+                auto const body = isValid ? m_registry->exportText() : QByteArray("Only GET requests are supported.\n");
+                auto response = QByteArray(isValid ? "HTTP/1.0 200 OK\r\n" : "HTTP/1.0 405 Method Not Allowed\r\n");
+
+                response.append("Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n");
+                response.append("Content-Length: ").append(QByteArray::number(body.size())).append("\r\n");
+                response.append("Connection: close\r\n\r\n");
+                response.append(body);
+                m_request.clear();
+                write(response);
+                close();
+            }
+
+        private:
+            enum { MaximumRequestSize = 16 * 1024 };
+
+            util::MetricsRegistry const* const m_registry;
+            QByteArray m_request;
+    };
+
+
+    MetricsEndpoint::MetricsEndpoint(QObject* parent, util::MetricsRegistry const* registry, short port)
+        : m_registry(registry)
+#ifdef _MSC_VER
+#  pragma warning(push)
+#  pragma warning(disable : 4355)
+#endif
+        , m_server(parent, this, port)
+#ifdef _MSC_VER
+#  pragma warning(pop)
+#endif
+    {}
+
+    TcpClient* MetricsEndpoint::create(QTcpSocket* socket)
+    {
+        return new Client(socket, m_registry);
+    }
+}
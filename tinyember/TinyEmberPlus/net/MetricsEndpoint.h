@@ -0,0 +1,50 @@
+#ifndef __TINYEMBER_NET_METRICSENDPOINT_H
+#define __TINYEMBER_NET_METRICSENDPOINT_H
+
+#include "TcpClientFactory.h"
+#include "TcpServer.h"
+
+namespace util
+{
+    /** Forward declaration */
+    class MetricsRegistry;
+}
+
+namespace net
+{
+    /**
+     * Serves the metrics of a registry via HTTP, so they can be scraped by Prometheus
+     * or fetched with any browser. Every GET request is answered with the current
+     * metrics in the text exposition format, regardless of the requested path. The
+     * metrics are formatted by the thread the endpoint has been created in.
+     */
+    class MetricsEndpoint : private TcpClientFactory
+    {
+        public:
+            /**
+             * Initializes a new MetricsEndpoint.
+             * @param parent The parent object of the tcp/ip server.
+             * @param registry The registry to export, which must outlive the endpoint.
+             * @param port The tcp/ip port to listen to.
+             */
+            MetricsEndpoint(QObject* parent, util::MetricsRegistry const* registry, short port);
+
+        private:
+            /**
+             * Creates a client answering the HTTP requests received via the passed socket.
+             * @param socket The accepted socket.
+             * @return The new client.
+             */
+            virtual TcpClient* create(QTcpSocket* socket);
+
+        private:
+            /** Reads HTTP requests and writes the responses. */
+            class Client;
+
+        private:
+            util::MetricsRegistry const* const m_registry;
+            TcpServer m_server;
+    };
+}
+
+#endif//__TINYEMBER_NET_METRICSENDPOINT_H
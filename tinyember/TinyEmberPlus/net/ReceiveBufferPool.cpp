@@ -0,0 +1,55 @@
+#include <utility>
+#include "ReceiveBufferPool.h"
+
+namespace net
+{
+    ReceiveBufferPool::ReceiveBufferPool(size_type bufferSize, size_type maximumIdleBuffers)
+        : m_bufferSize(bufferSize > 0 ? bufferSize : 1)
+        , m_maximumIdleBuffers(maximumIdleBuffers)
+    {
+        m_idle.reserve(maximumIdleBuffers);
+    }
+
+    ReceiveBufferPool::Buffer ReceiveBufferPool::acquire()
+    {
+        auto size = size_type(0);
+        {
+            QMutexLocker const lock(&m_mutex);
+            if (m_idle.empty() == false)
+            {
+                auto buffer = std::move(m_idle.back());
+                m_idle.pop_back();
+                return buffer;
+            }
+
+            size = m_bufferSize;
+        }
+
+        // Allocated outside of the lock, so other clients are not held up.
+        return Buffer(size);
+    }
+
+    void ReceiveBufferPool::release(Buffer&& buffer)
+    {
+        QMutexLocker const lock(&m_mutex);
+        if (buffer.size() == m_bufferSize && m_idle.size() < m_maximumIdleBuffers)
+            m_idle.push_back(std::move(buffer));
+    }
+
+    void ReceiveBufferPool::setBufferSize(size_type value)
+    {
+        auto idle = std::vector<Buffer>();
+        {
+            QMutexLocker const lock(&m_mutex);
+            m_bufferSize = value > 0 ? value : 1;
+            m_idle.swap(idle);
+            m_idle.reserve(m_maximumIdleBuffers);
+        }
+    }
+
+    ReceiveBufferPool::size_type ReceiveBufferPool::bufferSize() const
+    {
+        QMutexLocker const lock(&m_mutex);
+        return m_bufferSize;
+    }
+}
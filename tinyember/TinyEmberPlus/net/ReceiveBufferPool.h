@@ -0,0 +1,79 @@
+#ifndef __TINYEMBER_NET_RECEIVEBUFFERPOOL_H
+#define __TINYEMBER_NET_RECEIVEBUFFERPOOL_H
+
+#include <cstddef>
+#include <vector>
+#include <qmutex.h>
+
+namespace net
+{
+    /**
+     * A pool of receive buffers shared by the clients of a server. A client only holds
+     * a buffer while it drains its socket, so idle connections do not occupy any receive
+     * memory, and the buffers are reused instead of being allocated for each read.
+     * The pool may be used by several threads at the same time.
+     */
+    class ReceiveBufferPool
+    {
+        public:
+            typedef unsigned char value_type;
+            typedef std::vector<value_type> Buffer;
+            typedef std::size_t size_type;
+
+            enum
+            {
+                DefaultBufferSize = 64 * 1024,
+                DefaultMaximumIdleBuffers = 4,
+            };
+
+            /**
+             * Initializes a new, empty pool.
+             * @param bufferSize The size of the buffers handed out by the pool.
+             * @param maximumIdleBuffers The maximum number of released buffers the pool
+             *      keeps for reuse. Further buffers are freed when they are released.
+             */
+            explicit ReceiveBufferPool(size_type bufferSize = DefaultBufferSize, size_type maximumIdleBuffers = DefaultMaximumIdleBuffers);
+
+            /**
+             * Returns a buffer of the current buffer size, which is either taken from the
+             * idle buffers or allocated.
+             * @return A buffer which must be returned to the pool with release().
+             */
+            Buffer acquire();
+
+            /**
+             * Returns a buffer to the pool. Buffers of a size other than the current one
+             * are freed.
+             * @param buffer The buffer to return, as obtained from acquire().
+             */
+            void release(Buffer&& buffer);
+
+            /**
+             * Changes the size of the buffers handed out by the pool. Buffers of the previous
+             * size are freed when they are returned.
+             * @param value The new buffer size, at least one byte.
+             */
+            void setBufferSize(size_type value);
+
+            /**
+             * Returns the size of the buffers handed out by the pool.
+             * @return The size of the buffers in bytes.
+             */
+            size_type bufferSize() const;
+
+        private:
+            /** Prohibit copying */
+            ReceiveBufferPool(ReceiveBufferPool const&);
+
+            /** Prohibit assignment */
+            ReceiveBufferPool& operator=(ReceiveBufferPool const&);
+
+        private:
+            mutable QMutex m_mutex;
+            std::vector<Buffer> m_idle;
+            size_type m_bufferSize;
+            size_type m_maximumIdleBuffers;
+    };
+}
+
+#endif//__TINYEMBER_NET_RECEIVEBUFFERPOOL_H
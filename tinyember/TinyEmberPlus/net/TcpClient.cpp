@@ -1,18 +1,52 @@
+#include <algorithm>
+#include <utility>
+#include <QtNetwork\qhostaddress.h>
 #include "TcpClient.h"
 
 namespace net
 {
+    namespace
+    {
+        /** The key of the stream frames queued for a slow client. */
+        QByteArray const StreamKey = QByteArray("stream");
+
+        /**
+         * The pool of the clients that have not been assigned a pool of their own. It is
+         * initialized before main, because clients may receive data on several threads.
+         */
+        ReceiveBufferPool s_sharedReceiveBuffers;
+    }
+
     TcpClient::TcpClient(QTcpSocket* socket)
         : m_socket(socket)
+        , m_peerName(socket->peerAddress().toString() + ":" + QString::number(socket->peerPort()))
+        , m_counters(nullptr)
+        , m_receiveBuffers(nullptr)
+        , m_openMessage(PriorityCount)
+        , m_queuedBytes(0)
+        , m_highWaterMark(DefaultHighWaterMark)
+        , m_maximumQueueSize(DefaultMaximumQueueSize)
+        , m_slowRoundTripTime(Q_INT64_C(1000000) * DefaultSlowRoundTripTime)
+        , m_slowQueueSize(DefaultSlowQueueSize)
+        , m_readTimeSlice(Q_INT64_C(1000) * DefaultReadTimeSlice)
+        , m_isReadResumePosted(false)
+        , m_isAbortPosted(false)
+        , m_isClosing(false)
+        , m_keepAliveRequestedAt(-1)
+        , m_roundTripTime(-1)
+        , m_isSlow(false)
     {
+        m_clock.start();
         m_socket->connect(m_socket, SIGNAL(disconnected()), this, SLOT(onDisconnect()));
         m_socket->connect(m_socket, SIGNAL(readyRead()), this, SLOT(onReadyRead()));
+        m_socket->connect(m_socket, SIGNAL(bytesWritten(qint64)), this, SLOT(onBytesWritten(qint64)));
     }
 
     TcpClient::~TcpClient()
     {
         m_socket->disconnect(m_socket, SIGNAL(disconnected()), this, SLOT(onDisconnect()));
         m_socket->disconnect(m_socket, SIGNAL(readyRead()), this, SLOT(onReadyRead()));
+        m_socket->disconnect(m_socket, SIGNAL(bytesWritten(qint64)), this, SLOT(onBytesWritten(qint64)));
         m_socket->close();
         m_socket = nullptr;
     }
@@ -22,16 +56,242 @@ namespace net
         emit disconnected(this);
     }
 
+    void TcpClient::writeStream(QByteArray const& array)
+    {
+        enqueue(array, isSlow() ? StreamKey : QByteArray(), StreamPriority, true);
+    }
+
+    void TcpClient::writeKeepAliveRequest(QByteArray const& array)
+    {
+        if (m_socket == nullptr)
+            return;
+
+        // An unanswered request keeps its time, so a client that stopped answering
+        // is detected as soon as the request is older than the threshold.
+        if (m_keepAliveRequestedAt < 0)
+            m_keepAliveRequestedAt = m_clock.nsecsElapsed();
+
+        enqueue(array, QByteArray(), StreamPriority, true);
+    }
+
+    qint64 TcpClient::keepAliveResponded()
+    {
+        if (m_keepAliveRequestedAt < 0)
+            return -1;
+
+        auto const sample = m_clock.nsecsElapsed() - m_keepAliveRequestedAt;
+        auto const smoothed = m_roundTripTime.load(std::memory_order_relaxed);
+        m_keepAliveRequestedAt = -1;
+
+        // Smoothed like the round trip time of tcp, srtt = 7/8 srtt + 1/8 sample.
+        m_roundTripTime.store(smoothed < 0 ? sample : smoothed + (sample - smoothed) / 8, std::memory_order_relaxed);
+        updateSlowState();
+        return sample;
+    }
+
+    void TcpClient::updateSlowState()
+    {
+        auto const queued = m_queuedBytes.load(std::memory_order_relaxed);
+        auto delay = m_roundTripTime.load(std::memory_order_relaxed);
+
+        // The age of an unanswered request only counts for clients that answered before,
+        // consumers that ignore keep-alive requests are judged by their queue alone.
+        if (m_slowRoundTripTime > 0 && delay >= 0 && m_keepAliveRequestedAt >= 0)
+            delay = std::max(delay, m_clock.nsecsElapsed() - m_keepAliveRequestedAt);
+
+        if (m_isSlow.load(std::memory_order_relaxed) == false)
+        {
+            auto const isDelayed = m_slowRoundTripTime > 0 && delay > m_slowRoundTripTime;
+            if (isDelayed || queued > m_slowQueueSize)
+            {
+                m_isSlow.store(true, std::memory_order_relaxed);
+
+                if (m_counters != nullptr)
+                    m_counters->slowClients->increment();
+            }
+        }
+        else
+        {
+            auto const isPunctual = m_slowRoundTripTime == 0 || delay < m_slowRoundTripTime / 2;
+            if (isPunctual && queued < m_slowQueueSize / 2)
+                m_isSlow.store(false, std::memory_order_relaxed);
+        }
+    }
+
+    void TcpClient::enqueue(QByteArray const& array, QByteArray const& key, Priority priority, bool isMessageEnd)
+    {
+        if (m_socket == nullptr || m_isAbortPosted || m_isClosing)
+            return;
+
+        auto& queue = m_queues[priority];
+        if (key.isEmpty() == false)
+        {
+            auto const last = queue.end();
+            for (auto it = queue.begin(); it != last; ++it)
+            {
+                if (it->key == key)
+                {
+                    // The queued frame has been superseded and has not been sent yet.
+                    if (m_counters != nullptr)
+                        m_counters->framesSuperseded->increment();
+
+                    m_queuedBytes += array.size() - it->data.size();
+                    it->data = array;
+                    return;
+                }
+            }
+        }
+
+        Frame frame;
+        frame.data = array;
+        frame.key = key;
+        frame.isMessageEnd = isMessageEnd;
+        queue.push_back(frame);
+        m_queuedBytes += array.size();
+
+        if (m_queuedBytes > m_maximumQueueSize)
+        {
+            // The client doesn't read its data, so it is disconnected before
+            // the queue consumes all memory.
+            for (auto priority = 0; priority < PriorityCount; ++priority)
+            {
+                if (m_counters != nullptr)
+                    m_counters->framesDiscarded->increment(m_queues[priority].size());
+
+                m_queues[priority].clear();
+            }
+
+            m_openMessage = PriorityCount;
+            m_queuedBytes = 0;
+
+            // The server may be iterating its clients, so the connection is torn
+            // down once control has returned to the event loop.
+            m_isAbortPosted = true;
+            QMetaObject::invokeMethod(this, "onOverflowAbort", Qt::QueuedConnection);
+            return;
+        }
+
+        updateSlowState();
+        flush();
+    }
+
+    void TcpClient::flush()
+    {
+        auto socket = m_socket;
+        if (socket == nullptr || m_queuedBytes == 0)
+            return;
+
+        auto available = m_highWaterMark - socket->bytesToWrite();
+        auto buffer = QByteArray();
+        while (available > 0)
+        {
+            // A message that has been started must be completed before any other
+            // frame may be sent, even if its remaining packets have not been queued yet.
+            auto priority = m_openMessage;
+            if (priority == PriorityCount)
+            {
+                priority = 0;
+                while (priority < PriorityCount && m_queues[priority].empty())
+                    ++priority;
+            }
+
+            if (priority == PriorityCount || m_queues[priority].empty())
+                break;
+
+            auto& queue = m_queues[priority];
+            auto const& frame = queue.front();
+            buffer.append(frame.data);
+            available -= frame.data.size();
+            m_queuedBytes -= frame.data.size();
+            m_openMessage = frame.isMessageEnd ? PriorityCount : priority;
+            queue.pop_front();
+        }
+
+        if (buffer.isEmpty() == false)
+        {
+            if (m_counters != nullptr)
+                m_counters->bytesSent->increment(buffer.size());
+
+            socket->write(buffer);
+            updateSlowState();
+        }
+    }
+
+    void TcpClient::close()
+    {
+        if (m_socket == nullptr || m_isClosing)
+            return;
+
+        m_isClosing = true;
+        QMetaObject::invokeMethod(this, "onClose", Qt::QueuedConnection);
+    }
+
+    void TcpClient::onClose()
+    {
+        // The socket itself delays the disconnect until its buffer has been written.
+        if (m_socket != nullptr && m_queuedBytes == 0)
+            m_socket->disconnectFromHost();
+    }
+
+    void TcpClient::onBytesWritten(qint64 bytes)
+    {
+        Q_UNUSED(bytes);
+        auto const wasQueued = m_queuedBytes != 0;
+        flush();
+
+        if (m_isClosing && wasQueued && m_queuedBytes == 0)
+            QMetaObject::invokeMethod(this, "onClose", Qt::QueuedConnection);
+    }
+
     void TcpClient::onReadyRead()
     {
         auto socket = m_socket;
-        if (socket != nullptr)
+        if (socket == nullptr || m_isReadResumePosted)
+            return;
+
+        // Everything that has arrived is drained into a single pooled buffer, in as few
+        // reads as its size permits, and handed to the decoder without further copies.
+        // A large message is read in time slices, so the other sockets of the thread
+        // are served in between. The socket does not signal the data it has already
+        // buffered again, so reading is resumed by a queued call.
+        auto& pool = m_receiveBuffers != nullptr ? *m_receiveBuffers : s_sharedReceiveBuffers;
+        auto buffer = pool.acquire();
+        auto const data = buffer.data();
+        auto const capacity = static_cast<qint64>(buffer.size());
+        auto const deadline = m_readTimeSlice > 0 ? m_clock.nsecsElapsed() + m_readTimeSlice : 0;
+
+        while(socket->bytesAvailable() > 0)
         {
-            while(socket->bytesAvailable() > 0)
+            if (deadline != 0 && m_clock.nsecsElapsed() >= deadline)
             {
-                auto const size = socket->read(reinterpret_cast<char*>(m_buffer), RxBufferSize);
-                read(m_buffer, m_buffer + size, size);
+                m_isReadResumePosted = true;
+                QMetaObject::invokeMethod(this, "onReadResume", Qt::QueuedConnection);
+                break;
             }
+
+            auto const size = socket->read(reinterpret_cast<char*>(data), capacity);
+            if (size <= 0)
+                break;
+
+            if (m_counters != nullptr)
+                m_counters->bytesReceived->increment(size);
+
+            if (m_isClosing == false)
+                read(data, data + size, static_cast<size_type>(size));
         }
+
+        pool.release(std::move(buffer));
+    }
+
+    void TcpClient::onOverflowAbort()
+    {
+        if (m_socket != nullptr)
+            m_socket->abort();
+    }
+
+    void TcpClient::onReadResume()
+    {
+        m_isReadResumePosted = false;
+        onReadyRead();
     }
 }
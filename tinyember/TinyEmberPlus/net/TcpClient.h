@@ -1,7 +1,12 @@
 #ifndef __TINYEMBER_NET_TCPCLIENT_H
 #define __TINYEMBER_NET_TCPCLIENT_H
 
+#include <atomic>
+#include <deque>
+#include <qelapsedtimer.h>
 #include <QtNetwork\qtcpsocket.h>
+#include "../util/Metrics.h"
+#include "ReceiveBufferPool.h"
 
 namespace net
 {
@@ -10,6 +15,15 @@ namespace net
 
     /**
      * Base class for a tcp/ip client.
+     * Outgoing frames are queued by priority, so stream entries and notifications are not
+     * delayed by large directory responses. The socket only buffers up to the high-water
+     * mark, the remaining frames wait in their queues and the next frame is selected each
+     * time the socket has drained. S101 frames carry no message identifier, so the packets
+     * of a multi-packet message are always sent without interruption, a frame of a higher
+     * priority is sent before the first or after the last packet of a message.
+     * The client measures the round trip time of keep-alive requests. A client whose
+     * round trip time or output queue exceeds a threshold is considered slow, and the
+     * stream frames queued for it are replaced by newer ones until it has caught up.
      */
     class TcpClient : public QObject
     {
@@ -19,6 +33,45 @@ namespace net
             typedef value_type const* const_iterator;
             typedef std::size_t size_type;
 
+            /**
+             * The classes of outgoing traffic. The queued frames of a class are sent
+             * before those of the classes after it.
+             */
+            enum Priority
+            {
+                /** Stream entries and keep-alive messages. */
+                StreamPriority,
+
+                /** Notifications about changed entities. */
+                NotificationPriority,
+
+                /** Responses to GetDirectory requests and other large messages. */
+                BulkPriority,
+
+                PriorityCount
+            };
+
+            /**
+             * The counters a client updates, which are shared by all clients of a server.
+             */
+            struct Counters
+            {
+                /** The number of bytes read from the socket. */
+                util::Counter* bytesReceived;
+
+                /** The number of bytes handed to the socket. */
+                util::Counter* bytesSent;
+
+                /** The number of queued frames replaced by a later frame with the same key. */
+                util::Counter* framesSuperseded;
+
+                /** The number of frames discarded because the output queue was full. */
+                util::Counter* framesDiscarded;
+
+                /** The number of times a client has been found to be slow. */
+                util::Counter* slowClients;
+            };
+
             /** Destructor */
             virtual ~TcpClient();
 
@@ -36,6 +89,130 @@ namespace net
              */
             void write(QByteArray const& array);
 
+            /**
+             * Sends the passed byte array to the connected client. While the frame is
+             * waiting in the output queue, it is replaced by any later frame written
+             * with the same @p key, so a slow client only receives the latest one.
+             * @param array The array to transmit.
+             * @param key Identifies the content of the frame, for example the path of
+             *      the parameter whose value it contains. An empty key never matches.
+             */
+            void write(QByteArray const& array, QByteArray const& key);
+
+            /**
+             * Sends the passed byte array to the connected client with the specified priority.
+             * @param array The array to transmit.
+             * @param priority The traffic class of the frame.
+             * @param isMessageEnd Must be false when the array ends with a packet of a
+             *      multi-packet message whose last packet follows in a later array. No other
+             *      frame is sent until that array has been written.
+             */
+            void write(QByteArray const& array, Priority priority, bool isMessageEnd = true);
+
+            /**
+             * Sends a frame of stream entries. While the client is slow, a stream frame
+             * that is still waiting in the output queue is replaced by this one, so the
+             * client only receives the latest values instead of falling further behind.
+             * @param array The complete S101 packets of a stream collection.
+             */
+            void writeStream(QByteArray const& array);
+
+            /**
+             * Sends a keep-alive request and starts measuring the round trip time, unless
+             * a previous request is still unanswered. The time includes the time the request
+             * waits in the output queue, so it grows with the backlog of the client.
+             * @param array The encoded keep-alive request.
+             */
+            void writeKeepAliveRequest(QByteArray const& array);
+
+            /**
+             * Closes the connection once the frames written so far have been sent.
+             * Frames written and data received afterwards are discarded.
+             */
+            void close();
+
+            /**
+             * Sets the number of bytes the socket may buffer before further frames are
+             * kept in the output queues. Queued frames are written as soon as the socket
+             * buffer drops below this mark, so the mark also limits how long a frame of
+             * a higher priority waits behind frames that have already been written.
+             * @param value The new high-water mark in bytes.
+             */
+            void setHighWaterMark(qint64 value);
+
+            /**
+             * Sets the number of bytes the output queue may hold. When a client does not
+             * read its data and the queue exceeds this size, the connection is aborted.
+             * @param value The new maximum queue size in bytes.
+             */
+            void setMaximumQueueSize(qint64 value);
+
+            /**
+             * Sets the round trip time above which the client is considered slow. Such a
+             * client is considered fast again when its round trip time has dropped below
+             * half of this value.
+             * @param milliseconds The threshold, or 0 to ignore the round trip time.
+             */
+            void setSlowRoundTripTime(qint64 milliseconds);
+
+            /**
+             * Sets the size of the output queue above which the client is considered slow.
+             * Such a client is considered fast again when its queue has shrunk below half
+             * of this size.
+             * @param value The threshold in bytes, which should be less than the maximum
+             *      queue size.
+             */
+            void setSlowQueueSize(qint64 value);
+
+            /**
+             * Sets the counters this client updates.
+             * @param value The counters, or nullptr to not count anything.
+             */
+            void setCounters(Counters const* value);
+
+            /**
+             * Sets the pool the buffers for receiving data are taken from.
+             * @param value The pool, or nullptr to use a pool shared by all clients that
+             *      have none. The pool must outlive the client.
+             */
+            void setReceiveBufferPool(ReceiveBufferPool* value);
+
+            /**
+             * Sets the time the client spends reading and decoding received data before
+             * it returns to the event loop. The data remaining in the socket is read
+             * when the other events of the thread have been processed.
+             * @param microseconds The duration of a time slice, 0 reads all available
+             *      data at once.
+             */
+            void setReadTimeSlice(qint64 microseconds);
+
+            /**
+             * Returns the number of bytes in the output queues. May be called by any thread.
+             * @return The number of bytes waiting to be handed to the socket.
+             */
+            qint64 queuedBytes() const;
+
+            /**
+             * Returns the address and port of the remote end of the connection.
+             * @return The address of the remote end, like 192.168.0.1:50000.
+             */
+            QString const& peerName() const;
+
+            /**
+             * Returns the smoothed round trip time of the keep-alive requests. May be
+             * called by any thread.
+             * @return The round trip time in nanoseconds, or -1 if no response has been
+             *      received yet.
+             */
+            qint64 roundTripTime() const;
+
+            /**
+             * Returns whether the client currently is considered slow. May be called by
+             * any thread.
+             * @return true if the stream frames queued for this client are superseded.
+             */
+            bool isSlow() const;
+
         signals:
             /**
              * This signal is emitted when the socket disconnects.
@@ -51,13 +228,21 @@ namespace net
             explicit TcpClient(QTcpSocket* socket);
 
             /**
-             * Handles bytes received from the connected client.
+             * Handles bytes received from the connected client. The bytes are passed in the
+             * receive buffer, which is reused once this method returns.
              * @param first Points to the first element in the rx buffer.
              * @param last Points one past the last element of the current rx buffer.
              * @param size The number of bytes that have been received.
              */
             virtual void read(const_iterator first, const_iterator last, size_type size) = 0;
 
+            /**
+             * Must be called by the derived class when a keep-alive response has been received.
+             * @return The round trip time of the answered request in nanoseconds, or -1 if no
+             *      request has been outstanding.
+             */
+            qint64 keepAliveResponded();
+
         private slots:
             /**
              * Handles a socket disconnect event.
@@ -70,11 +255,93 @@ namespace net
              */
             void onReadyRead();
 
+            /**
+             * Continues reading the data that remained in the socket when the last time
+             * slice has been used up.
+             */
+            void onReadResume();
+
+            /**
+             * Aborts the connection of a client whose output queue has overflowed. This
+             * slot is invoked by a queued call, since aborting emits disconnected, which
+             * makes the server delete the client while it may still be writing to it.
+             */
+            void onOverflowAbort();
+
+            /**
+             * Disconnects from the peer once the output queues have been drained. This
+             * slot is invoked by a queued call, since disconnecting may emit disconnected
+             * right away, which makes the server delete the client.
+             */
+            void onClose();
+
+            /**
+             * Writes the queued frames when the socket buffer has been drained.
+             * @param bytes The number of bytes the socket has written.
+             */
+            void onBytesWritten(qint64 bytes);
+
+        private:
+            /**
+             * Appends the passed frame to the output queue of its priority.
+             * @param array The frame to transmit.
+             * @param key Identifies the content of the frame.
+             * @param priority The traffic class of the frame.
+             * @param isMessageEnd false if the frame is followed by further packets
+             *      of the same message.
+             */
+            void enqueue(QByteArray const& array, QByteArray const& key, Priority priority, bool isMessageEnd);
+
+            /**
+             * Hands the queued frames to the socket in a single write, highest priority
+             * first, until the socket buffer reaches the high-water mark.
+             */
+            void flush();
+
+            /**
+             * Decides whether the client is slow, based on the smoothed round trip time, the
+             * age of an unanswered keep-alive request and the size of the output queue.
+             */
+            void updateSlowState();
+
         private:
-            enum { RxBufferSize = 4096, };
+            enum
+            {
+                DefaultHighWaterMark = 64 * 1024,
+                DefaultMaximumQueueSize = 16 * 1024 * 1024,
+                DefaultSlowRoundTripTime = 1000,
+                DefaultSlowQueueSize = 1024 * 1024,
+                DefaultReadTimeSlice = 5000,
+            };
+
+            struct Frame
+            {
+                QByteArray data;
+                QByteArray key;
+                bool isMessageEnd;
+            };
+
+            typedef std::deque<Frame> FrameQueue;
 
-            value_type m_buffer[RxBufferSize];
             QTcpSocket* m_socket;
+            QString const m_peerName;
+            Counters const* m_counters;
+            ReceiveBufferPool* m_receiveBuffers;
+            FrameQueue m_queues[PriorityCount];
+            int m_openMessage;
+            std::atomic<qint64> m_queuedBytes;
+            qint64 m_highWaterMark;
+            qint64 m_maximumQueueSize;
+            qint64 m_slowRoundTripTime;
+            qint64 m_slowQueueSize;
+            qint64 m_readTimeSlice;
+            bool m_isReadResumePosted;
+            bool m_isAbortPosted;
+            bool m_isClosing;
+            QElapsedTimer m_clock;
+            qint64 m_keepAliveRequestedAt;
+            std::atomic<qint64> m_roundTripTime;
+            std::atomic<bool> m_isSlow;
     };
 
     /**************************************************************************
@@ -91,9 +358,72 @@ namespace net
 
     inline void TcpClient::write(QByteArray const& array)
     {
-        auto socket = m_socket;
-        if (socket != nullptr)
-            socket->write(array);
+        enqueue(array, QByteArray(), NotificationPriority, true);
+    }
+
+    inline void TcpClient::write(QByteArray const& array, QByteArray const& key)
+    {
+        enqueue(array, key, NotificationPriority, true);
+    }
+
+    inline void TcpClient::write(QByteArray const& array, Priority priority, bool isMessageEnd)
+    {
+        enqueue(array, QByteArray(), priority, isMessageEnd);
+    }
+
+    inline void TcpClient::setHighWaterMark(qint64 value)
+    {
+        m_highWaterMark = value;
+    }
+
+    inline void TcpClient::setMaximumQueueSize(qint64 value)
+    {
+        m_maximumQueueSize = value;
+    }
+
+    inline void TcpClient::setSlowRoundTripTime(qint64 milliseconds)
+    {
+        m_slowRoundTripTime = milliseconds * 1000000;
+    }
+
+    inline void TcpClient::setSlowQueueSize(qint64 value)
+    {
+        m_slowQueueSize = value;
+    }
+
+    inline void TcpClient::setCounters(Counters const* value)
+    {
+        m_counters = value;
+    }
+
+    inline void TcpClient::setReceiveBufferPool(ReceiveBufferPool* value)
+    {
+        m_receiveBuffers = value;
+    }
+
+    inline void TcpClient::setReadTimeSlice(qint64 microseconds)
+    {
+        m_readTimeSlice = microseconds * 1000;
+    }
+
+    inline qint64 TcpClient::queuedBytes() const
+    {
+        return m_queuedBytes.load(std::memory_order_relaxed);
+    }
+
+    inline QString const& TcpClient::peerName() const
+    {
+        return m_peerName;
+    }
+
+    inline qint64 TcpClient::roundTripTime() const
+    {
+        return m_roundTripTime.load(std::memory_order_relaxed);
+    }
+
+    inline bool TcpClient::isSlow() const
+    {
+        return m_isSlow.load(std::memory_order_relaxed);
     }
 }
 
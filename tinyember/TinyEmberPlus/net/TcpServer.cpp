@@ -6,11 +6,13 @@
 
 namespace net
 {
-    TcpServer::TcpServer(QApplication* app, TcpClientFactory* factory, short port)
-        : QTcpServer(app)
+    TcpServer::TcpServer(QObject* parent, TcpClientFactory* factory, short port)
+        : QTcpServer(parent)
         , m_factory(factory)
         , m_mutex(QMutex::Recursive)
         , m_port(port)
+        , m_registry(nullptr)
+        , m_accepted(nullptr)
     {
         connect(this, SIGNAL(newConnection()), this, SLOT(clientAccepted()));
         listen(QHostAddress::Any, port);
@@ -18,6 +20,16 @@ namespace net
 
     TcpServer::~TcpServer()
     {
+        if (m_registry != nullptr)
+            m_registry->removeCollector(this);
+
+        shutdown();
+    }
+
+    void TcpServer::shutdown()
+    {
+        close();
+
         auto clients = ClientCollection();
         {
             QMutexLocker const lock(&m_mutex);
@@ -33,11 +45,62 @@ namespace net
     }
 
     void TcpServer::write(QByteArray const& array)
+    {
+        write(array, TcpClient::NotificationPriority);
+    }
+
+    void TcpServer::write(QByteArray const& array, TcpClient::Priority priority, bool isMessageEnd)
+    {
+        if (QThread::currentThread() != thread())
+        {
+            QMetaObject::invokeMethod(this, "writeToClients", Qt::QueuedConnection, Q_ARG(QByteArray, array), Q_ARG(int, priority), Q_ARG(bool, isMessageEnd));
+        }
+        else
+        {
+            writeToClients(array, priority, isMessageEnd);
+        }
+    }
+
+    void TcpServer::writeStream(QByteArray const& array)
+    {
+        if (QThread::currentThread() != thread())
+            QMetaObject::invokeMethod(this, "writeStreamToClients", Qt::QueuedConnection, Q_ARG(QByteArray, array));
+        else
+            writeStreamToClients(array);
+    }
+
+    void TcpServer::writeKeepAliveRequest(QByteArray const& array)
+    {
+        if (QThread::currentThread() != thread())
+            QMetaObject::invokeMethod(this, "writeKeepAliveRequestToClients", Qt::QueuedConnection, Q_ARG(QByteArray, array));
+        else
+            writeKeepAliveRequestToClients(array);
+    }
+
+    void TcpServer::writeToClients(QByteArray const& array, int priority, bool isMessageEnd)
+    {
+        QMutexLocker const lock(&m_mutex);
+        for each(auto client in m_clients)
+        {
+            client->write(array, static_cast<TcpClient::Priority>(priority), isMessageEnd);
+        }
+    }
+
+    void TcpServer::writeStreamToClients(QByteArray const& array)
+    {
+        QMutexLocker const lock(&m_mutex);
+        for each(auto client in m_clients)
+        {
+            client->writeStream(array);
+        }
+    }
+
+    void TcpServer::writeKeepAliveRequestToClients(QByteArray const& array)
     {
         QMutexLocker const lock(&m_mutex);
         for each(auto client in m_clients)
         {
-            client->write(array);
+            client->writeKeepAliveRequest(array);
         }
     }
      
@@ -47,6 +110,13 @@ namespace net
         if (socket != nullptr)
         {
             auto const client = m_factory->create(socket);
+            client->setReceiveBufferPool(&m_receiveBuffers);
+            if (m_registry != nullptr)
+            {
+                m_accepted->increment();
+                client->setCounters(&m_counters);
+            }
+
             connect(client, SIGNAL(disconnected(TcpClient*)), this, SLOT(clientDisconnected(TcpClient*)));
             {
                 QMutexLocker const lock(&m_mutex);
@@ -71,4 +141,45 @@ namespace net
             delete client;
         }
     }
+
+    void TcpServer::setMetrics(util::MetricsRegistry* registry)
+    {
+        m_registry = registry;
+        m_portLabel = util::MetricsWriter::label("port", QString::number(m_port));
+        m_accepted = registry->counter("tinyember_connections_accepted_total", "The number of accepted connections.", m_portLabel);
+        m_counters.bytesReceived = registry->counter("tinyember_bytes_received_total", "The number of bytes received from all clients.", m_portLabel);
+        m_counters.bytesSent = registry->counter("tinyember_bytes_sent_total", "The number of bytes sent to all clients.", m_portLabel);
+
+        auto const name = QByteArray("tinyember_frames_dropped_total");
+        auto const help = QByteArray("The number of frames that have not been sent to a client.");
+        m_counters.framesSuperseded = registry->counter(name, help, m_portLabel + "," + util::MetricsWriter::label("reason", "superseded"));
+        m_counters.framesDiscarded = registry->counter(name, help, m_portLabel + "," + util::MetricsWriter::label("reason", "overflow"));
+        m_counters.slowClients = registry->counter("tinyember_slow_clients_total", "The number of times a client has been found to be slow.", m_portLabel);
+
+        registry->addCollector(this);
+    }
+
+    void TcpServer::collect(util::MetricsWriter& writer) const
+    {
+        QMutexLocker const lock(&m_mutex);
+        writer.writeGauge("tinyember_connections", "The number of connected clients.", m_portLabel, static_cast<qint64>(m_clients.size()));
+
+        // The samples of a metric have to be written one after the other.
+        auto labels = std::vector<QByteArray>();
+        for each(auto client in m_clients)
+            labels.push_back(m_portLabel + "," + util::MetricsWriter::label("client", client->peerName()));
+
+        for (auto index = std::size_t(0); index < m_clients.size(); ++index)
+            writer.writeGauge("tinyember_client_queued_bytes", "The number of bytes waiting in the output queues of a client.", labels[index], m_clients[index]->queuedBytes());
+
+        for (auto index = std::size_t(0); index < m_clients.size(); ++index)
+        {
+            auto const roundTripTime = m_clients[index]->roundTripTime();
+            if (roundTripTime >= 0)
+                writer.writeGauge("tinyember_client_rtt_seconds", "The smoothed round trip time of the keep-alive requests sent to a client.", labels[index], roundTripTime / 1e9);
+        }
+
+        for (auto index = std::size_t(0); index < m_clients.size(); ++index)
+            writer.writeGauge("tinyember_client_slow", "1 if the stream frames queued for a client are superseded because it is slow.", labels[index], qint64(m_clients[index]->isSlow() ? 1 : 0));
+    }
 }
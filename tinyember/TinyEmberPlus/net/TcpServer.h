@@ -5,28 +5,36 @@
 #include <QtNetwork/qtcpserver.h>
 #include <qmutex.h>
 #include <qthread.h>
+#include "ReceiveBufferPool.h"
+#include "TcpClient.h"
+#include "../util/Metrics.h"
 
 namespace net
 {
-    class TcpClient;
     class TcpClientFactory;
 
     /**
      * Implementation of a tcp/ip server which listens to a specified port and
      * uses a factory to create clients for accepted connections.
+     * The server may be moved to a thread of its own. The clients are then created on
+     * that thread, so receiving and decoding requests never blocks the ui, and data
+     * written from any other thread is passed to the server's thread.
+     * When metrics are enabled, the server exports the number of connected clients
+     * and the size of the output queue, the round trip time and the state of each client.
      */
-    class TcpServer : public QTcpServer
+    class TcpServer : public QTcpServer, private util::MetricsCollector
     {
         Q_OBJECT;
         public:
             /**
              * Initializes a new TcpServer.
-             * @param app Pointer to the application object.
+             * @param parent The parent object, must be nullptr if the server shall be moved to
+             *      another thread.
              * @param factory Pointer to the client factory which is used when a new connection
              *      has been accepted.
              * @param port The tcp/ip port to listen to.
              */
-            TcpServer(QApplication* app, TcpClientFactory* factory, short port);
+            TcpServer(QObject* parent, TcpClientFactory* factory, short port);
 
             /** Destructor */
             virtual ~TcpServer();
@@ -35,11 +43,24 @@ namespace net
             int port() const;
 
             /**
-             * Sends the passed data to all currently connected clients.
+             * Sends the passed data to all currently connected clients. When called from
+             * a thread other than the server's, the data is queued and sent by the server's
+             * thread.
              * @param array The array to transmit.
              */
             void write(QByteArray const& array);
 
+            /**
+             * Sends the passed data to all currently connected clients with the specified
+             * priority.
+             * @param array The array to transmit.
+             * @param priority The traffic class of the data.
+             * @param isMessageEnd false if the array ends with a packet of a multi-packet
+             *      message which is continued by the next array written with this priority.
+             * @see TcpClient::write()
+             */
+            void write(QByteArray const& array, TcpClient::Priority priority, bool isMessageEnd = true);
+
             /**
              * Sends the buffer defined by the iterators to all connected clients.
              * @param first An iterator that points to the first item to copy.
@@ -48,7 +69,90 @@ namespace net
             template<typename InputIterator>
             void write(InputIterator first, InputIterator last);
 
+            /**
+             * Sends the passed s101 packets to all currently connected clients. The packets
+             * are merged into a single array that is built once and shared by all clients,
+             * instead of being copied for each packet and client.
+             * @param first An iterator that points to the first packet to send.
+             * @param last An iterator that points one past the last packet to send.
+             * @note A packet must provide the methods begin(), end() and size().
+             */
+            template<typename PacketIterator>
+            void writePackets(PacketIterator first, PacketIterator last);
+
+            /**
+             * Sends a frame of stream entries to all currently connected clients.
+             * @param array The complete S101 packets of a stream collection.
+             * @see TcpClient::writeStream()
+             */
+            void writeStream(QByteArray const& array);
+
+            /**
+             * Sends a keep-alive request to all currently connected clients, which measure
+             * the time until they receive the response.
+             * @param array The encoded keep-alive request.
+             * @see TcpClient::writeKeepAliveRequest()
+             */
+            void writeKeepAliveRequest(QByteArray const& array);
+
+            /**
+             * Merges s101 packets into a single array.
+             * @param first An iterator that points to the first packet to merge.
+             * @param last An iterator that points one past the last packet to merge.
+             * @return The bytes of all packets.
+             * @note A packet must provide the methods begin(), end() and size().
+             */
+            template<typename PacketIterator>
+            static QByteArray join(PacketIterator first, PacketIterator last);
+
+            /**
+             * Creates the traffic counters of this server, which are labelled with its port,
+             * and registers the server as collector. Must be called before the server is
+             * moved to another thread.
+             * @param registry The registry to create the metrics with, which must outlive
+             *      the server.
+             */
+            void setMetrics(util::MetricsRegistry* registry);
+
+            /**
+             * Sets the size of the buffers the clients receive their data with. A client
+             * reads as much of the available data as fits into one buffer at once, and the
+             * buffers are shared by all clients of the server. The default size is 64 KB.
+             * @param value The size of a receive buffer in bytes.
+             */
+            void setReceiveBufferSize(std::size_t value);
+
+        public slots:
+            /**
+             * Stops listening and disconnects all clients. If the server has been moved to
+             * another thread, this method must be invoked on that thread.
+             */
+            void shutdown();
+
         private slots:
+            /**
+             * Sends the passed data to all currently connected clients. This slot must be
+             * called on the server's thread.
+             * @param array The array to transmit.
+             * @param priority The traffic class of the data, a TcpClient::Priority.
+             * @param isMessageEnd false if the message is continued by the next array.
+             */
+            void writeToClients(QByteArray const& array, int priority, bool isMessageEnd);
+
+            /**
+             * Sends a frame of stream entries to all currently connected clients. This slot
+             * must be called on the server's thread.
+             * @param array The stream frame to transmit.
+             */
+            void writeStreamToClients(QByteArray const& array);
+
+            /**
+             * Sends a keep-alive request to all currently connected clients. This slot must
+             * be called on the server's thread.
+             * @param array The keep-alive request to transmit.
+             */
+            void writeKeepAliveRequestToClients(QByteArray const& array);
+
             /**
              * Handles an accepted connection.
              */
@@ -60,12 +164,25 @@ namespace net
              */
             void clientDisconnected(TcpClient* client);
 
+        private:
+            /**
+             * Writes the number of connected clients, the sizes of their output queues, their
+             * round trip times and whether they are slow.
+             * @param writer The writer to pass the metrics to.
+             */
+            virtual void collect(util::MetricsWriter& writer) const;
+
         private:
             typedef std::vector<TcpClient*> ClientCollection;
             ClientCollection m_clients;
             TcpClientFactory *const m_factory;
-            QMutex m_mutex;
+            mutable QMutex m_mutex;
             int m_port;
+            util::MetricsRegistry* m_registry;
+            TcpClient::Counters m_counters;
+            ReceiveBufferPool m_receiveBuffers;
+            util::Counter* m_accepted;
+            QByteArray m_portLabel;
     };
 
     /**************************************************************************
@@ -77,6 +194,11 @@ namespace net
         return m_port;
     }
 
+    inline void TcpServer::setReceiveBufferSize(std::size_t value)
+    {
+        m_receiveBuffers.setBufferSize(value);
+    }
+
     template<typename InputIterator>
     inline void TcpServer::write(InputIterator first, InputIterator last)
     {
@@ -84,6 +206,30 @@ namespace net
         std::copy(first, last, std::back_inserter(array));
         write(array);
     }
+
+    template<typename PacketIterator>
+    inline void TcpServer::writePackets(PacketIterator first, PacketIterator last)
+    {
+        write(join(first, last));
+    }
+
+    template<typename PacketIterator>
+    inline QByteArray TcpServer::join(PacketIterator first, PacketIterator last)
+    {
+        auto size = 0;
+        for (auto it = first; it != last; ++it)
+            size += static_cast<int>(it->size());
+
+        auto array = QByteArray();
+        array.reserve(size);
+        for ( ; first != last; ++first)
+        {
+            if (first->size() > 0)
+                array.append(reinterpret_cast<char const*>(&*first->begin()), static_cast<int>(first->size()));
+        }
+
+        return array;
+    }
 }
 
 #endif//__TINYEMBER_NET_TCPSERVER_H
@@ -4,11 +4,19 @@
 #include "Archive.h"
 #include "detail/GadgetTreeReader.h"
 #include "detail/GadgetTreeWriter.h"
+#include "detail/SnapshotReader.h"
+#include "detail/SnapshotWriter.h"
 
 namespace serialization
 {
     void Archive::serialize(gadget::Node const* root, String const& filename) const
     {
+        if (QString::fromStdString(filename).endsWith(".snapshot", Qt::CaseInsensitive))
+        {
+            serializeSnapshot(root, filename);
+            return;
+        }
+
         auto const writer = detail::GadgetTreeWriter(root);
         auto& berstream = writer.m_stream;
 
@@ -25,6 +33,19 @@ namespace serialization
         }
     }
 
+    void Archive::serializeSnapshot(gadget::Node const* root, String const& filename) const
+    {
+        auto const writer = detail::SnapshotWriter(root);
+
+        QFile file(QString::fromStdString(filename));
+        if (file.open(QIODevice::WriteOnly))
+        {
+            file.write(reinterpret_cast<char const*>(&*writer.begin()), static_cast<qint64>(writer.size()));
+            file.flush();
+            file.close();
+        }
+    }
+
     gadget::Node* Archive::deserialize(String const& filename) const
     {
         auto result = static_cast<gadget::Node*>(nullptr);
@@ -33,12 +54,38 @@ namespace serialization
             QFile file(QString::fromStdString(filename));
             if (file.open(QIODevice::ReadOnly))
             {
-                auto bytearray = file.readAll();
-                auto stream = libember::util::OctetStream(0);
-                stream.append(bytearray.begin(), bytearray.end());
+                auto const size = static_cast<std::size_t>(file.size());
+                auto const mapped = file.map(0, file.size());
+
+                if (mapped != nullptr && detail::SnapshotReader::isSnapshot(mapped, size))
+                {
+                    auto const reader = detail::SnapshotReader(mapped, size);
+                    result = reader.m_root;
+                }
+                else
+                {
+                    auto bytearray = file.readAll();
+                    auto const first = reinterpret_cast<unsigned char const*>(bytearray.constData());
+                    auto const length = static_cast<std::size_t>(bytearray.size());
+
+                    if (detail::SnapshotReader::isSnapshot(first, length))
+                    {
+                        auto const reader = detail::SnapshotReader(first, length);
+                        result = reader.m_root;
+                    }
+                    else
+                    {
+                        auto stream = libember::util::OctetStream(0);
+                        stream.append(bytearray.begin(), bytearray.end());
+
+                        auto reader = detail::GadgetTreeReader(stream);
+                        result = reader.m_root;
+                    }
+                }
+
+                if (mapped != nullptr)
+                    file.unmap(mapped);
 
-                auto reader = detail::GadgetTreeReader(stream);
-                result = reader.m_root;
                 file.close();
             }
         }
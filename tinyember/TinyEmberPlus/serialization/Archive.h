@@ -14,20 +14,31 @@ namespace serialization
     /**
      * The Archive provides method to store a gadget tree to a file or load it. The trees
      * are converted into their glow representation and are then ber encoded and written
-     * to disk.
+     * to disk. Alternatively, a tree can be stored as binary snapshot, which is mapped into
+     * memory when it is loaded and does not need to be decoded. This is considerably faster
+     * for large trees.
      */
     class Archive
     {
         public:
             /**
-             * Writes the gadget tree to a file.
+             * Writes the gadget tree to a file. If the file name has the extension
+             * ".snapshot", the tree is stored in the snapshot format.
              * @param root The root node to serialize.
              * @param filename The name of the file where the encoded data will be written.
              */
             void serialize(gadget::Node const* root, String const& filename) const;
 
             /**
-             * Loads a gadget tree from a file.
+             * Writes the gadget tree to a file in the snapshot format.
+             * @param root The root node to serialize.
+             * @param filename The name of the file where the snapshot will be written.
+             */
+            void serializeSnapshot(gadget::Node const* root, String const& filename) const;
+
+            /**
+             * Loads a gadget tree from a file, which may either contain an encoded glow tree
+             * or a snapshot.
              * @param filename The name of the file containing the data.
              * @return The deserialized gadget tree.
              */
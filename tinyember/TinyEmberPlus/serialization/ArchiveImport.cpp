@@ -0,0 +1,94 @@
+#include <stdexcept>
+#include <qfile.h>
+#include "Archive.h"
+#include "ArchiveImport.h"
+#include "detail/GadgetTreeStreamReader.h"
+#include "detail/SnapshotReader.h"
+
+namespace serialization
+{
+    ArchiveImport::ArchiveImport(String const& filename, Listener* listener, std::size_t batchSize)
+        : m_filename(filename)
+        , m_file(new QFile(QString::fromStdString(filename)))
+        , m_reader(new detail::GadgetTreeStreamReader(listener))
+        , m_snapshotRoot(nullptr)
+        , m_buffer(batchSize > 0 ? batchSize : DefaultBatchSize)
+        , m_isSnapshot(false)
+        , m_atEnd(true)
+    {
+        if (m_file->open(QIODevice::ReadOnly))
+        {
+            auto const size = static_cast<std::size_t>(m_file->size());
+            auto const mapped = m_file->map(0, m_file->size());
+            if (mapped != nullptr)
+            {
+                m_isSnapshot = detail::SnapshotReader::isSnapshot(mapped, size);
+                m_file->unmap(mapped);
+            }
+
+            m_atEnd = false;
+        }
+    }
+
+    ArchiveImport::~ArchiveImport()
+    {
+        delete m_reader;
+        delete m_file;
+    }
+
+    String const& ArchiveImport::filename() const
+    {
+        return m_filename;
+    }
+
+    gadget::Node* ArchiveImport::root() const
+    {
+        return m_isSnapshot ? m_snapshotRoot : m_reader->m_root;
+    }
+
+    bool ArchiveImport::atEnd() const
+    {
+        return m_atEnd;
+    }
+
+    bool ArchiveImport::step()
+    {
+        if (m_atEnd)
+            return false;
+
+        if (m_isSnapshot)
+        {
+            // A snapshot does not need to be decoded, so it is loaded at once.
+            m_file->close();
+            m_snapshotRoot = Archive().deserialize(m_filename);
+            m_atEnd = true;
+            return false;
+        }
+
+        auto const first = reinterpret_cast<char*>(&m_buffer.front());
+        auto const length = m_file->read(first, static_cast<qint64>(m_buffer.size()));
+        auto isValid = true;
+        if (length > 0)
+        {
+            try
+            {
+                auto const begin = &m_buffer.front();
+                m_reader->read(begin, begin + length);
+            }
+            catch (std::exception const&)
+            {
+                // The entities that have been created before the error are kept.
+                isValid = false;
+            }
+        }
+
+        if (length <= 0 || isValid == false || m_file->atEnd())
+        {
+            m_file->close();
+            m_reader->finish();
+            m_atEnd = true;
+        }
+
+        return m_atEnd == false;
+    }
+}
@@ -0,0 +1,120 @@
+#ifndef __TINYEMBER_SERIALIZATION_ARCHIVEIMPORT_H
+#define __TINYEMBER_SERIALIZATION_ARCHIVEIMPORT_H
+
+#include <cstddef>
+#include <vector>
+#include "../Types.h"
+
+/** Forward declarations */
+class QFile;
+
+namespace gadget
+{
+    class Node;
+    class Parameter;
+}
+
+namespace serialization { namespace detail
+{
+    class GadgetTreeStreamReader;
+}
+}
+
+namespace serialization
+{
+    /**
+     * Loads a gadget tree from a file in batches, so that large trees become available
+     * before the whole file has been read. Each call to step() decodes the next block
+     * of the file and creates the nodes and parameters it completes. The glow elements
+     * are released as soon as they have been converted, so the transient memory only
+     * depends on the depth of the tree and not on its size.
+     * A child of the root node is unmounted while its subtree is created and mounted
+     * again when the subtree is complete, so consumers never see a partially loaded
+     * subtree. Snapshots are loaded at once by the first step.
+     */
+    class ArchiveImport
+    {
+        public:
+            /**
+             * Interface which is notified about every entity the import creates. It
+             * may be used to present the entities while the import is in progress.
+             */
+            class Listener
+            {
+                public:
+                    /** Destructor */
+                    virtual ~Listener()
+                    {}
+
+                    /**
+                     * Called when a node has been appended to its parent. The root node
+                     * is not reported.
+                     * @param node The new node.
+                     */
+                    virtual void nodeImported(gadget::Node* node) = 0;
+
+                    /**
+                     * Called when a parameter has been appended to its parent.
+                     * @param parameter The new parameter.
+                     */
+                    virtual void parameterImported(gadget::Parameter* parameter) = 0;
+            };
+
+            /** The default number of bytes decoded by a single step. */
+            static std::size_t const DefaultBatchSize = 64 * 1024;
+
+        public:
+            /**
+             * Opens the file to import.
+             * @param filename The name of the file containing the encoded glow tree or a snapshot.
+             * @param listener The listener to notify about new entities, may be nullptr.
+             * @param batchSize The number of bytes decoded by a single step.
+             */
+            ArchiveImport(String const& filename, Listener* listener, std::size_t batchSize = DefaultBatchSize);
+
+            /** Destructor, closes the file. The imported tree is not deleted. */
+            ~ArchiveImport();
+
+            /**
+             * Returns the name of the imported file.
+             * @return The name of the imported file.
+             */
+            String const& filename() const;
+
+            /**
+             * Returns the root of the imported tree. The root is available as soon as the
+             * properties of the first node have been decoded and belongs to the caller from
+             * then on. Its subtree keeps growing with every step until the import is complete.
+             * @return The root node, or nullptr if it has not been decoded yet.
+             */
+            gadget::Node* root() const;
+
+            /**
+             * Returns true when the whole file has been read or the file could not be opened.
+             * @return true when the import is complete.
+             */
+            bool atEnd() const;
+
+            /**
+             * Decodes the next block of the file and creates all entities it completes.
+             * @return true if the file contains more data, false when the import is complete.
+             */
+            bool step();
+
+        private:
+            /** Prohibit copies */
+            ArchiveImport(ArchiveImport const&);
+            ArchiveImport& operator=(ArchiveImport const&);
+
+        private:
+            String const m_filename;
+            QFile* m_file;
+            detail::GadgetTreeStreamReader* m_reader;
+            gadget::Node* m_snapshotRoot;
+            std::vector<unsigned char> m_buffer;
+            bool m_isSnapshot;
+            bool m_atEnd;
+    };
+}
+
+#endif//__TINYEMBER_SERIALIZATION_ARCHIVEIMPORT_H
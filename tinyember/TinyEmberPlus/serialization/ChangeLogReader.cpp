@@ -0,0 +1,205 @@
+#include <algorithm>
+#include <cstring>
+#include "ChangeLogReader.h"
+
+namespace serialization
+{
+    ChangeLogReader::ChangeLogReader(QString const& filename)
+        : m_file(filename)
+        , m_data(nullptr)
+        , m_validSize(0)
+    {
+    }
+
+    ChangeLogReader::~ChangeLogReader()
+    {
+        close();
+    }
+
+    bool ChangeLogReader::open()
+    {
+        using detail::ChangeLog;
+
+        close();
+
+        if (m_file.open(QIODevice::ReadOnly) == false)
+            return false;
+
+        auto const size = static_cast<std::uint64_t>(m_file.size());
+        if (size < sizeof(ChangeLog::Header))
+        {
+            close();
+            return false;
+        }
+
+        // The blocks are accessed in place, which requires the mapping to be aligned
+        // to eight bytes. Mapped files always are.
+        m_data = m_file.map(0, m_file.size());
+        if (m_data == nullptr || reinterpret_cast<std::size_t>(m_data) % sizeof(ChangeLog::Number) != 0)
+        {
+            close();
+            return false;
+        }
+
+        auto const& header = *reinterpret_cast<ChangeLog::Header const*>(m_data);
+        if (header.magic != ChangeLog::Magic || header.version != ChangeLog::Version)
+        {
+            close();
+            return false;
+        }
+
+        auto offset = std::uint64_t(sizeof(ChangeLog::Header));
+        while (offset + sizeof(BlockHeader) <= size)
+        {
+            auto const& block = *reinterpret_cast<BlockHeader const*>(m_data + offset);
+            auto const end = offset + sizeof(BlockHeader) + block.size;
+
+            if (block.size % sizeof(ChangeLog::Number) != 0 || end > size)
+                break;
+
+            if (block.type == ChangeLog::PathBlock)
+            {
+                if (readPaths(block) == false)
+                    break;
+            }
+            else if (block.type == ChangeLog::ValueBlock)
+            {
+                if (block.count > block.size / sizeof(ChangeLog::Number) || ChangeLog::columnSize(block.count) > block.size)
+                    break;
+
+                m_blocks.push_back(&block);
+            }
+            else
+            {
+                break;
+            }
+
+            offset = end;
+        }
+
+        m_validSize = offset;
+        return true;
+    }
+
+    void ChangeLogReader::close()
+    {
+        if (m_data != nullptr)
+            m_file.unmap(m_data);
+
+        m_file.close();
+        m_data = nullptr;
+        m_validSize = 0;
+        m_paths.clear();
+        m_blocks.clear();
+    }
+
+    std::uint64_t ChangeLogReader::validSize() const
+    {
+        return m_validSize;
+    }
+
+    std::uint32_t ChangeLogReader::pathCount() const
+    {
+        return static_cast<std::uint32_t>(m_paths.size());
+    }
+
+    ChangeLogReader::Path const& ChangeLogReader::path(std::uint32_t identifier) const
+    {
+        return m_paths[identifier];
+    }
+
+    std::uint32_t ChangeLogReader::find(Path const& path) const
+    {
+        auto const first = std::begin(m_paths);
+        auto const last = std::end(m_paths);
+        auto const result = std::find(first, last, path);
+        return result != last ? static_cast<std::uint32_t>(result - first) : AnyPath;
+    }
+
+    std::size_t ChangeLogReader::blockCount() const
+    {
+        return m_blocks.size();
+    }
+
+    bool ChangeLogReader::readPaths(BlockHeader const& header)
+    {
+        using detail::ChangeLog;
+
+        auto cursor = reinterpret_cast<unsigned char const*>(&header + 1);
+        auto const last = cursor + header.size;
+
+        for (auto index = std::uint32_t(0); index < header.count; ++index)
+        {
+            if (last - cursor < static_cast<std::ptrdiff_t>(sizeof(ChangeLog::PathEntry)))
+                return false;
+
+            auto const& entry = *reinterpret_cast<ChangeLog::PathEntry const*>(cursor);
+            auto const numbers = reinterpret_cast<std::int32_t const*>(cursor + sizeof(ChangeLog::PathEntry));
+
+            if (static_cast<std::uint64_t>(last - cursor) < sizeof(ChangeLog::PathEntry) + static_cast<std::uint64_t>(entry.length) * sizeof(std::int32_t))
+                return false;
+
+            // Identifiers are assigned in ascending order, starting with zero.
+            if (entry.identifier != m_paths.size())
+                return false;
+
+            m_paths.push_back(Path(numbers, numbers + entry.length));
+            cursor += sizeof(ChangeLog::PathEntry) + entry.length * sizeof(std::int32_t);
+        }
+
+        return true;
+    }
+
+    //static
+    bool ChangeLogReader::readChange(BlockHeader const& header, std::uint32_t index, std::int64_t time, Change& change)
+    {
+        using detail::ChangeLog;
+
+        auto const payload = reinterpret_cast<unsigned char const*>(&header + 1);
+        auto const values = reinterpret_cast<ChangeLog::Number const*>(payload);
+        auto const paths = reinterpret_cast<std::uint32_t const*>(values + header.count);
+        auto const types = reinterpret_cast<std::uint8_t const*>(paths + 2 * header.count);
+        auto const& value = values[index];
+
+        change.time = time;
+        change.path = paths[index];
+        change.stream = header.stream;
+        change.type = static_cast<ChangeLog::ValueType>(types[index]);
+        change.integer = 0;
+        change.real = 0.0;
+        change.text = nullptr;
+        change.textLength = 0;
+
+        switch(change.type)
+        {
+            case ChangeLog::Real:
+                change.real = value.real;
+                break;
+
+            case ChangeLog::String:
+                {
+                    auto const strings = payload + ChangeLog::columnSize(header.count);
+                    auto const stringSize = static_cast<std::uint64_t>(header.size - ChangeLog::columnSize(header.count));
+                    auto const offset = static_cast<std::uint64_t>(value.integer);
+                    auto length = std::uint32_t(0);
+
+                    if (offset + sizeof(length) > stringSize)
+                        return false;
+
+                    std::memcpy(&length, strings + offset, sizeof(length));
+                    if (offset + sizeof(length) + length > stringSize)
+                        return false;
+
+                    change.text = reinterpret_cast<char const*>(strings + offset + sizeof(length));
+                    change.textLength = length;
+                }
+                break;
+
+            default:
+                change.integer = value.integer;
+                break;
+        }
+
+        return true;
+    }
+}
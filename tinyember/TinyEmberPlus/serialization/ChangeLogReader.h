@@ -0,0 +1,187 @@
+#ifndef __TINYEMBER_SERIALIZATION_CHANGELOGREADER_H
+#define __TINYEMBER_SERIALIZATION_CHANGELOGREADER_H
+
+#include <cstdint>
+#include <vector>
+#include <qfile.h>
+#include "detail/ChangeLog.h"
+
+namespace serialization
+{
+    /**
+     * Provides read access to a change log written by the ChangeLogWriter. The log is
+     * mapped into memory and the changes are read in place. When the log is opened,
+     * only the block headers and the path blocks are read, which yields an index of the
+     * value blocks. A query skips all blocks outside of the requested time range, and
+     * filtering by path only reads the path column of the remaining blocks.
+     * A block that has not been written completely ends the log.
+     */
+    class ChangeLogReader
+    {
+        public:
+            typedef std::vector<int> Path;
+
+            /** The path identifier that matches the changes of all paths. */
+            static std::uint32_t const AnyPath = 0xFFFFFFFF;
+
+            /**
+             * A single recorded change. The text of a string value refers to the mapped
+             * log and is only valid while the reader is open.
+             */
+            struct Change
+            {
+                std::int64_t time;
+                std::uint32_t path;
+                std::int32_t stream;
+                detail::ChangeLog::ValueType type;
+
+                /** The value of integer, boolean and enumeration parameters. */
+                std::int64_t integer;
+
+                /** The value of real parameters. */
+                double real;
+
+                /** The value of string parameters, which is not null-terminated. */
+                char const* text;
+                std::uint32_t textLength;
+            };
+
+        public:
+            /**
+             * Initializes a new reader. The file is not accessed before open() is called.
+             * @param filename The name of the log file.
+             */
+            explicit ChangeLogReader(QString const& filename);
+
+            /** Destructor, unmaps the log. */
+            ~ChangeLogReader();
+
+            /**
+             * Maps the log into memory and reads its paths and block headers.
+             * @return false if the file cannot be mapped or is not a change log.
+             */
+            bool open();
+
+            /**
+             * Unmaps the log.
+             */
+            void close();
+
+            /**
+             * Returns the number of bytes of the log up to the end of the last complete block.
+             * @return The size of the valid part of the log.
+             */
+            std::uint64_t validSize() const;
+
+            /**
+             * Returns the number of interned paths.
+             * @return The number of paths, which is also the next identifier to assign.
+             */
+            std::uint32_t pathCount() const;
+
+            /**
+             * Returns the path with the specified identifier.
+             * @param identifier The identifier of the path, which must be less than pathCount().
+             * @return The numbers of the path.
+             */
+            Path const& path(std::uint32_t identifier) const;
+
+            /**
+             * Looks up the identifier of a path.
+             * @param path The numbers of the path.
+             * @return The identifier of the path, or AnyPath if the log does not contain it.
+             */
+            std::uint32_t find(Path const& path) const;
+
+            /**
+             * Returns the number of value blocks.
+             * @return The number of value blocks.
+             */
+            std::size_t blockCount() const;
+
+            /**
+             * Passes all changes recorded within a time range to a visitor, in the order
+             * in which they have been written.
+             * @param first The time of the first change to report, in microseconds since the epoch.
+             * @param last The time of the last change to report, in microseconds since the epoch.
+             * @param path The identifier of the path to report the changes of, or AnyPath.
+             * @param visitor Function object invoked with a Change const& for each change.
+             * @return The number of changes that have been reported.
+             */
+            template<typename Visitor>
+            std::size_t query(std::int64_t first, std::int64_t last, std::uint32_t path, Visitor& visitor) const;
+
+        private:
+            typedef detail::ChangeLog::BlockHeader BlockHeader;
+
+            /**
+             * Reads the entries of a path block.
+             * @param header The header of the block.
+             * @return false if an entry exceeds the block.
+             */
+            bool readPaths(BlockHeader const& header);
+
+            /**
+             * Reads a change of a value block.
+             * @param header The header of the block.
+             * @param index The index of the change within the block.
+             * @param time The time of the change.
+             * @param change Receives the change.
+             * @return false if a string exceeds the block.
+             */
+            static bool readChange(BlockHeader const& header, std::uint32_t index, std::int64_t time, Change& change);
+
+            /** Prohibit copies */
+            ChangeLogReader(ChangeLogReader const&);
+            ChangeLogReader& operator=(ChangeLogReader const&);
+
+        private:
+            QFile m_file;
+            unsigned char* m_data;
+            std::uint64_t m_validSize;
+            std::vector<Path> m_paths;
+            std::vector<BlockHeader const*> m_blocks;
+    };
+
+    /**************************************************************************
+     * Inline implementation                                                  *
+     **************************************************************************/
+
+    template<typename Visitor>
+    inline std::size_t ChangeLogReader::query(std::int64_t first, std::int64_t last, std::uint32_t path, Visitor& visitor) const
+    {
+        auto count = std::size_t(0);
+        auto change = Change();
+
+        for each(auto header in m_blocks)
+        {
+            if (header->lastTime < first || header->firstTime > last)
+                continue;
+
+            auto const payload = reinterpret_cast<unsigned char const*>(header + 1);
+            auto const paths = reinterpret_cast<std::uint32_t const*>(payload + header->count * sizeof(detail::ChangeLog::Number));
+            auto const deltas = paths + header->count;
+            auto time = header->firstTime;
+
+            for (auto index = std::uint32_t(0); index < header->count; ++index)
+            {
+                time += deltas[index];
+                if (time > last)
+                    break;
+
+                if (time < first || (path != AnyPath && paths[index] != path))
+                    continue;
+
+                if (readChange(*header, index, time, change) == false)
+                    break;
+
+                visitor(static_cast<Change const&>(change));
+                ++count;
+            }
+        }
+
+        return count;
+    }
+}
+
+#endif//__TINYEMBER_SERIALIZATION_CHANGELOGREADER_H
@@ -0,0 +1,414 @@
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <qdatetime.h>
+#include "ChangeLogReader.h"
+#include "ChangeLogWriter.h"
+#include "../gadget/BooleanParameter.h"
+#include "../gadget/EnumParameter.h"
+#include "../gadget/IntegerParameter.h"
+#include "../gadget/ParameterTypeVisitor.h"
+#include "../gadget/RealParameter.h"
+#include "../gadget/StringParameter.h"
+
+namespace serialization
+{
+    namespace
+    {
+        using detail::ChangeLog;
+
+        enum
+        {
+            /** The maximum number of changes within a single value block. */
+            MaximumBlockCount = 65536
+        };
+
+        /**
+         * Copies the current value of a parameter, together with its type.
+         */
+        class ValueReader : public gadget::ParameterTypeVisitorConst
+        {
+            public:
+                ValueReader(std::uint32_t& type, ChangeLog::Number& value, String& text)
+                    : m_type(type)
+                    , m_value(value)
+                    , m_text(text)
+                {}
+
+                virtual void visit(gadget::EnumParameter const* parameter) const
+                {
+                    m_type = ChangeLog::Enum;
+                    m_value.integer = static_cast<std::int64_t>(parameter->index());
+                }
+
+                virtual void visit(gadget::StringParameter const* parameter) const
+                {
+                    m_type = ChangeLog::String;
+                    m_text = parameter->value();
+                }
+
+                virtual void visit(gadget::IntegerParameter const* parameter) const
+                {
+                    m_type = ChangeLog::Integer;
+                    m_value.integer = parameter->value();
+                }
+
+                virtual void visit(gadget::RealParameter const* parameter) const
+                {
+                    m_type = ChangeLog::Real;
+                    m_value.real = parameter->value();
+                }
+
+                virtual void visit(gadget::BooleanParameter const* parameter) const
+                {
+                    m_type = ChangeLog::Boolean;
+                    m_value.integer = parameter->value() ? 1 : 0;
+                }
+
+            private:
+                std::uint32_t& m_type;
+                ChangeLog::Number& m_value;
+                String& m_text;
+        };
+
+        /**
+         * Rounds a size up to the next multiple of eight bytes.
+         */
+        std::size_t align(std::size_t size)
+        {
+            return (size + 7) & ~std::size_t(7);
+        }
+    }
+
+    void ChangeLogWriter::Batch::clear()
+    {
+        changes.clear();
+        strings.clear();
+        paths.clear();
+    }
+
+    std::size_t ChangeLogWriter::PathHash::operator()(gadget::util::EntityPath const& path) const
+    {
+        auto hash = std::size_t(17);
+        for each(auto number in path)
+            hash = hash * 31 + static_cast<std::size_t>(number);
+
+        return hash;
+    }
+
+    ChangeLogWriter::Worker::Worker(ChangeLogWriter& writer)
+        : m_writer(writer)
+    {
+    }
+
+    void ChangeLogWriter::Worker::run()
+    {
+        m_writer.run();
+    }
+
+    ChangeLogWriter::ChangeLogWriter(QString const& filename, int flushInterval)
+        : m_file(filename)
+        , m_flushInterval(flushInterval)
+        , m_startTime(0)
+        , m_nextPath(0)
+        , m_recordedCount(0)
+        , m_isOpen(false)
+        , m_isStopping(false)
+        , m_worker(*this)
+    {
+    }
+
+    ChangeLogWriter::~ChangeLogWriter()
+    {
+        close();
+    }
+
+    bool ChangeLogWriter::open()
+    {
+        if (m_isOpen)
+            return true;
+
+        if (resume() == false)
+        {
+            m_file.close();
+            return false;
+        }
+
+        m_startTime = QDateTime::currentMSecsSinceEpoch() * 1000;
+        m_clock.start();
+        m_recordedCount = 0;
+        m_isStopping = false;
+        m_isOpen = true;
+        m_worker.start();
+        return true;
+    }
+
+    void ChangeLogWriter::close()
+    {
+        if (m_isOpen == false)
+            return;
+
+        {
+            QMutexLocker const lock(&m_mutex);
+            m_isStopping = true;
+            m_condition.wakeOne();
+        }
+
+        m_worker.wait();
+        m_file.close();
+        m_paths.clear();
+        m_nextPath = 0;
+        m_isOpen = false;
+    }
+
+    void ChangeLogWriter::flush()
+    {
+        QMutexLocker const lock(&m_mutex);
+        m_condition.wakeOne();
+    }
+
+    void ChangeLogWriter::notifyValueChanged(gadget::Parameter const* parameter)
+    {
+        if (m_isOpen == false)
+            return;
+
+        auto change = Change();
+        auto text = String();
+        change.time = now();
+        change.stream = parameter->hasStreamIdentifier() ? parameter->streamIdentifier() : ChangeLog::NoStream;
+        change.type = 0;
+        change.value.integer = 0;
+        parameter->accept(ValueReader(change.type, change.value, text));
+
+        // The paths are only accessed by the thread owning the tree, so they are looked up
+        // before the lock is taken. Only new paths are copied into the batch.
+        auto const& path = parameter->path();
+        auto result = m_paths.find(path);
+        auto const isNewPath = result == m_paths.end();
+
+        if (isNewPath)
+            result = m_paths.insert(std::make_pair(path, m_nextPath++)).first;
+
+        change.path = result->second;
+
+        QMutexLocker const lock(&m_mutex);
+        if (isNewPath)
+            m_pending.paths.push_back(Batch::PathEntry(change.path, std::vector<int>(path.begin(), path.end())));
+
+        if (change.type == ChangeLog::String)
+        {
+            change.value.integer = static_cast<std::int64_t>(m_pending.strings.size());
+            m_pending.strings.push_back(String());
+            m_pending.strings.back().swap(text);
+        }
+
+        m_pending.changes.push_back(change);
+        ++m_recordedCount;
+    }
+
+    bool ChangeLogWriter::resume()
+    {
+        if (m_file.exists() && m_file.size() > 0)
+        {
+            auto size = std::uint64_t(0);
+            {
+                ChangeLogReader reader(m_file.fileName());
+                if (reader.open() == false)
+                    return false;
+
+                m_nextPath = reader.pathCount();
+                for (auto identifier = std::uint32_t(0); identifier < m_nextPath; ++identifier)
+                {
+                    auto const& numbers = reader.path(identifier);
+                    m_paths.insert(std::make_pair(gadget::util::EntityPath(numbers.begin(), numbers.end()), identifier));
+                }
+
+                size = reader.validSize();
+            }
+
+            if (m_file.open(QIODevice::ReadWrite) == false)
+                return false;
+
+            // A block truncated by a crash is removed, so the new blocks follow the last complete one.
+            if (static_cast<std::uint64_t>(m_file.size()) != size)
+                m_file.resize(static_cast<qint64>(size));
+
+            return m_file.seek(static_cast<qint64>(size));
+        }
+        else
+        {
+            if (m_file.open(QIODevice::WriteOnly | QIODevice::Truncate) == false)
+                return false;
+
+            auto header = ChangeLog::Header();
+            header.magic = ChangeLog::Magic;
+            header.version = ChangeLog::Version;
+            return m_file.write(reinterpret_cast<char const*>(&header), sizeof(header)) == sizeof(header);
+        }
+    }
+
+    void ChangeLogWriter::run()
+    {
+        auto batch = Batch();
+        auto isStopping = false;
+
+        while (isStopping == false)
+        {
+            {
+                QMutexLocker const lock(&m_mutex);
+                if (m_isStopping == false)
+                    m_condition.wait(&m_mutex, static_cast<unsigned long>(m_flushInterval));
+
+                // Swapping keeps the capacity of both batches, so recording rarely allocates.
+                isStopping = m_isStopping;
+                std::swap(batch, m_pending);
+            }
+
+            write(batch);
+            batch.clear();
+        }
+    }
+
+    void ChangeLogWriter::write(Batch const& batch)
+    {
+        if (batch.paths.empty() && batch.changes.empty())
+            return;
+
+        auto const time = batch.changes.empty() ? now() : batch.changes.front().time;
+
+        if (batch.paths.empty() == false)
+        {
+            auto size = std::size_t(0);
+            for each(auto const& entry in batch.paths)
+                size += sizeof(ChangeLog::PathEntry) + entry.second.size() * sizeof(std::int32_t);
+
+            m_block.assign(align(size), 0);
+            auto cursor = m_block.data();
+
+            for each(auto const& entry in batch.paths)
+            {
+                auto pathEntry = ChangeLog::PathEntry();
+                pathEntry.identifier = entry.first;
+                pathEntry.length = static_cast<std::uint32_t>(entry.second.size());
+                std::memcpy(cursor, &pathEntry, sizeof(pathEntry));
+                cursor += sizeof(pathEntry);
+
+                for each(auto number in entry.second)
+                {
+                    auto const value = static_cast<std::int32_t>(number);
+                    std::memcpy(cursor, &value, sizeof(value));
+                    cursor += sizeof(value);
+                }
+            }
+
+            auto header = ChangeLog::BlockHeader();
+            header.type = ChangeLog::PathBlock;
+            header.stream = ChangeLog::NoStream;
+            header.count = static_cast<std::uint32_t>(batch.paths.size());
+            header.firstTime = time;
+            header.lastTime = time;
+            writeBlock(header);
+        }
+
+        // Usually only a few streams change within one interval.
+        auto streams = std::vector<std::int32_t>();
+        for each(auto const& change in batch.changes)
+        {
+            if (std::find(std::begin(streams), std::end(streams), change.stream) == std::end(streams))
+                streams.push_back(change.stream);
+        }
+
+        for each(auto stream in streams)
+            writeValues(batch, stream);
+
+        m_file.flush();
+    }
+
+    void ChangeLogWriter::writeValues(Batch const& batch, std::int32_t stream)
+    {
+        auto const& changes = batch.changes;
+        auto selection = std::vector<std::size_t>();
+        auto next = std::size_t(0);
+
+        while (next < changes.size())
+        {
+            // A block ends when it is full or when a timestamp delta exceeds 32 bits.
+            selection.clear();
+            for ( ; next < changes.size() && selection.size() < MaximumBlockCount; ++next)
+            {
+                auto const& change = changes[next];
+                if (change.stream != stream)
+                    continue;
+
+                if (selection.empty() == false && change.time - changes[selection.back()].time > std::numeric_limits<std::uint32_t>::max())
+                    break;
+
+                selection.push_back(next);
+            }
+
+            if (selection.empty())
+                break;
+
+            auto const count = static_cast<std::uint32_t>(selection.size());
+            auto stringSize = std::size_t(0);
+            for each(auto index in selection)
+            {
+                if (changes[index].type == ChangeLog::String)
+                    stringSize += sizeof(std::uint32_t) + batch.strings[static_cast<std::size_t>(changes[index].value.integer)].size();
+            }
+
+            auto const columnSize = ChangeLog::columnSize(count);
+            m_block.assign(columnSize + align(stringSize), 0);
+
+            auto const payload = m_block.data();
+            auto const values = reinterpret_cast<ChangeLog::Number*>(payload);
+            auto const paths = reinterpret_cast<std::uint32_t*>(values + count);
+            auto const deltas = paths + count;
+            auto const types = reinterpret_cast<std::uint8_t*>(deltas + count);
+            auto const strings = payload + columnSize;
+            auto stringOffset = std::uint32_t(0);
+            auto time = changes[selection.front()].time;
+
+            for (auto position = std::uint32_t(0); position < count; ++position)
+            {
+                auto const& change = changes[selection[position]];
+                values[position] = change.value;
+                paths[position] = change.path;
+                deltas[position] = static_cast<std::uint32_t>(change.time - time);
+                types[position] = static_cast<std::uint8_t>(change.type);
+                time = change.time;
+
+                if (change.type == ChangeLog::String)
+                {
+                    auto const& text = batch.strings[static_cast<std::size_t>(change.value.integer)];
+                    auto const length = static_cast<std::uint32_t>(text.size());
+                    values[position].integer = stringOffset;
+
+                    std::memcpy(strings + stringOffset, &length, sizeof(length));
+                    std::memcpy(strings + stringOffset + sizeof(length), text.data(), text.size());
+                    stringOffset += static_cast<std::uint32_t>(sizeof(length) + text.size());
+                }
+            }
+
+            auto header = ChangeLog::BlockHeader();
+            header.type = ChangeLog::ValueBlock;
+            header.stream = stream;
+            header.count = count;
+            header.firstTime = changes[selection.front()].time;
+            header.lastTime = changes[selection.back()].time;
+            writeBlock(header);
+        }
+    }
+
+    void ChangeLogWriter::writeBlock(ChangeLog::BlockHeader& header)
+    {
+        header.size = static_cast<std::uint32_t>(m_block.size());
+        m_file.write(reinterpret_cast<char const*>(&header), sizeof(header));
+        m_file.write(m_block.data(), static_cast<qint64>(m_block.size()));
+    }
+
+    std::int64_t ChangeLogWriter::now() const
+    {
+        return m_startTime + m_clock.nsecsElapsed() / 1000;
+    }
+}
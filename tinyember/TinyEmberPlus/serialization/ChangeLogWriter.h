@@ -0,0 +1,189 @@
+#ifndef __TINYEMBER_SERIALIZATION_CHANGELOGWRITER_H
+#define __TINYEMBER_SERIALIZATION_CHANGELOGWRITER_H
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include <qelapsedtimer.h>
+#include <qfile.h>
+#include <qmutex.h>
+#include <qthread.h>
+#include <qwaitcondition.h>
+#include "detail/ChangeLog.h"
+#include "../Types.h"
+#include "../gadget/ValueObserver.h"
+#include "../gadget/util/EntityPath.h"
+
+namespace serialization
+{
+    /**
+     * Records the value changes of all parameters, including the values of streamed
+     * parameters, in the change log format described by detail::ChangeLog.
+     * The writer is installed as the value observer of the gadget tree. Recording a
+     * change only looks up the interned path of the parameter, copies its value and
+     * appends it to a pending batch. A background thread takes the batch over in
+     * regular intervals and encodes it into one value block per stream, so neither
+     * formatting nor file access happens on the thread owning the tree.
+     * When the log file already exists, the writer appends to it and continues the
+     * numbering of its paths. A block that has not been written completely, for
+     * example because the application crashed, is removed.
+     */
+    class ChangeLogWriter : public gadget::ValueObserver
+    {
+        public:
+            /**
+             * Initializes a new writer. The file is not accessed before open() is called.
+             * @param filename The name of the log file.
+             * @param flushInterval The number of milliseconds between two writes of the
+             *      pending changes.
+             */
+            explicit ChangeLogWriter(QString const& filename, int flushInterval = 1000);
+
+            /** Destructor, writes the pending changes and closes the log. */
+            virtual ~ChangeLogWriter();
+
+            /**
+             * Opens the log file and starts the background thread.
+             * @return false if the file cannot be opened or is not a change log.
+             */
+            bool open();
+
+            /**
+             * Writes the pending changes, stops the background thread and closes the log.
+             */
+            void close();
+
+            /**
+             * Wakes the background thread, which then writes the pending changes
+             * without waiting for the end of the current interval.
+             */
+            void flush();
+
+            /**
+             * Returns the number of changes that have been recorded since the log has been opened.
+             * @return The number of recorded changes.
+             */
+            inline std::uint64_t recordedCount() const { return m_recordedCount; }
+
+            /**
+             * Records the current value of a parameter.
+             * @param parameter The parameter whose value has been set.
+             */
+            virtual void notifyValueChanged(gadget::Parameter const* parameter);
+
+        private:
+            /**
+             * A single change, as recorded by the thread owning the gadget tree.
+             */
+            struct Change
+            {
+                std::int64_t time;
+                std::uint32_t path;
+                std::int32_t stream;
+                std::uint32_t type;
+
+                /** The value, or the index of the string within the batch. */
+                detail::ChangeLog::Number value;
+            };
+
+            /**
+             * The changes and new paths recorded during one interval.
+             */
+            struct Batch
+            {
+                typedef std::pair<std::uint32_t, std::vector<int>> PathEntry;
+
+                void clear();
+
+                std::vector<Change> changes;
+                std::vector<String> strings;
+                std::vector<PathEntry> paths;
+            };
+
+            struct PathHash
+            {
+                std::size_t operator()(gadget::util::EntityPath const& path) const;
+            };
+
+            typedef std::unordered_map<gadget::util::EntityPath, std::uint32_t, PathHash> PathMap;
+
+            /**
+             * The background thread, which runs the write loop of the writer.
+             */
+            class Worker : public QThread
+            {
+                public:
+                    explicit Worker(ChangeLogWriter& writer);
+
+                protected:
+                    virtual void run();
+
+                private:
+                    ChangeLogWriter& m_writer;
+            };
+
+            friend class Worker;
+
+            /**
+             * Reads the existing log, continues its path numbering and removes a
+             * block that has not been written completely.
+             * @return false if the file is not a change log.
+             */
+            bool resume();
+
+            /**
+             * Takes over the pending batch and writes it, until the writer is closed.
+             */
+            void run();
+
+            /**
+             * Writes a path block for the new paths of @p batch and one value block per
+             * stream for its changes.
+             * @param batch The batch to write.
+             */
+            void write(Batch const& batch);
+
+            /**
+             * Encodes the value block of a stream and writes it to the log.
+             * @param batch The batch containing the changes.
+             * @param stream The stream to write the changes of.
+             */
+            void writeValues(Batch const& batch, std::int32_t stream);
+
+            /**
+             * Writes a block consisting of the header and the payload in m_block.
+             * @param header The header of the block. Its size is updated.
+             */
+            void writeBlock(detail::ChangeLog::BlockHeader& header);
+
+            /**
+             * Returns the current time in microseconds since the epoch.
+             * @return The current time.
+             */
+            std::int64_t now() const;
+
+            /** Prohibit copies */
+            ChangeLogWriter(ChangeLogWriter const&);
+            ChangeLogWriter& operator=(ChangeLogWriter const&);
+
+        private:
+            QFile m_file;
+            int const m_flushInterval;
+            std::int64_t m_startTime;
+            QElapsedTimer m_clock;
+            PathMap m_paths;
+            std::uint32_t m_nextPath;
+            std::uint64_t m_recordedCount;
+            QMutex m_mutex;
+            QWaitCondition m_condition;
+            Batch m_pending;
+            bool m_isOpen;
+            bool m_isStopping;
+            Worker m_worker;
+
+            /** The payload of the block being encoded, only used by the background thread. */
+            std::vector<char> m_block;
+    };
+}
+
+#endif//__TINYEMBER_SERIALIZATION_CHANGELOGWRITER_H
@@ -0,0 +1,116 @@
+#ifndef __TINYEMBER_SERIALIZATION_CHANGELOG_H
+#define __TINYEMBER_SERIALIZATION_CHANGELOG_H
+
+#include <cstdint>
+
+namespace serialization { namespace detail
+{
+    /**
+     * Definition of the binary change log format, which records the value changes of
+     * parameters. A change log starts with a Header, which is followed by a sequence of
+     * blocks. Each block starts with a BlockHeader and its payload size is a multiple of
+     * eight bytes, so all blocks and columns can be accessed in place when the log is
+     * mapped into memory.
+     * Paths are interned: a path block assigns an identifier to each new path before the
+     * first value block referring to it. A value block contains the changes of a single
+     * stream, or of the parameters that are not streamed, in columns: first the values
+     * of all changes, then their path identifiers, their timestamps and their value types,
+     * followed by the strings the block refers to. Each timestamp is stored as the number
+     * of microseconds since the previous change of the block, the first one relative to
+     * the first time of the block header.
+     * All integers are stored in the byte order of the machine that wrote the log. A log
+     * written with a different byte order does not match the magic number and is rejected.
+     */
+    struct ChangeLog
+    {
+        /** The magic number at the start of each change log, "TEPL" in little endian. */
+        static std::uint32_t const Magic = 0x4C504554;
+
+        /** The version of the format described here. */
+        static std::uint32_t const Version = 1;
+
+        /** The stream of the parameters whose values are not streamed. */
+        static std::int32_t const NoStream = -1;
+
+        /**
+         * The kinds of blocks.
+         */
+        enum BlockType
+        {
+            /** Assigns identifiers to paths. */
+            PathBlock = 1,
+
+            /** Contains the value changes of a single stream. */
+            ValueBlock = 2,
+        };
+
+        /**
+         * The types of the recorded values.
+         */
+        enum ValueType
+        {
+            Integer = 1,
+            Real = 2,
+            Boolean = 3,
+            Enum = 4,
+            String = 5,
+        };
+
+        /**
+         * The file header.
+         */
+        struct Header
+        {
+            std::uint32_t magic;
+            std::uint32_t version;
+        };
+
+        /**
+         * The header of each block.
+         */
+        struct BlockHeader
+        {
+            std::uint32_t type;         // BlockType
+            std::int32_t stream;        // The stream identifier of a value block, or NoStream
+            std::uint32_t count;        // The number of paths or changes
+            std::uint32_t size;         // The size of the payload following the header
+            std::int64_t firstTime;     // Microseconds since the epoch, UTC
+            std::int64_t lastTime;      // Microseconds since the epoch, UTC
+        };
+
+        /**
+         * An entry of a path block, followed by the numbers of the path.
+         */
+        struct PathEntry
+        {
+            std::uint32_t identifier;
+            std::uint32_t length;
+        };
+
+        /**
+         * A recorded value, interpreted according to its value type. Booleans and
+         * enumeration indices are stored as integers, strings as the offset of a
+         * 32 bit length followed by the characters within the string table of the block.
+         */
+        union Number
+        {
+            std::int64_t integer;
+            double real;
+        };
+
+        /**
+         * Returns the size of the columns of a value block with @p count changes,
+         * which is also the offset of its string table.
+         * @param count The number of changes.
+         * @return The size of the columns, rounded up to a multiple of eight.
+         */
+        static std::uint32_t columnSize(std::uint32_t count)
+        {
+            auto const size = count * (sizeof(Number) + 2 * sizeof(std::uint32_t) + sizeof(std::uint8_t));
+            return static_cast<std::uint32_t>((size + 7) & ~std::size_t(7));
+        }
+    };
+}
+}
+
+#endif//__TINYEMBER_SERIALIZATION_CHANGELOG_H
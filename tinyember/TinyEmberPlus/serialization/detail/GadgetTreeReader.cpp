@@ -90,48 +90,69 @@ namespace serialization { namespace detail
                     }
                     else if (type.value() == GlowType::Parameter)
                     {
-                        auto& glowparam = dynamic_cast<GlowParameter&>(child);
-                        auto identifier = glowparam.identifier();
-                        auto paramtype = glowparam.effectiveType();
-                        switch(paramtype.value())
-                        {
-                            case libember::glow::ParameterType::Boolean:
-                                transform(gadget::ParameterFactory::create(parent, identifier, false), &glowparam);
-                                break;
-
-                            case libember::glow::ParameterType::Enum:
-                                transform(gadget::ParameterFactory::create(parent, identifier), &glowparam);
-                                break;
-
-                            case libember::glow::ParameterType::Integer:
-                                transform(gadget::ParameterFactory::create(parent, identifier, 0, 1000, 0), &glowparam);
-                                break;
-
-                            case libember::glow::ParameterType::Octets:
-                                break;
-
-                            case libember::glow::ParameterType::Real:
-                                transform(gadget::ParameterFactory::create(parent, identifier, 0.0, 1000.0, 0.0), &glowparam);
-                                break;
-
-                            case libember::glow::ParameterType::String:
-                                transform(gadget::ParameterFactory::create(parent, identifier, std::string("text")), &glowparam);
-                                break;
-
-                            case libember::glow::ParameterType::Trigger:
-                                break;
-
-                            default:
-                                volatile int x = paramtype.value();
-                                break;
-                        }
+                        createParameter(parent, dynamic_cast<GlowParameter*>(&child));
                     }
                 }
             }
         }
     }
 
-    void GadgetTreeReader::transformBase(gadget::Parameter* param, libember::glow::GlowParameter* source) const
+    gadget::Parameter* GadgetTreeReader::createParameter(gadget::Node* parent, libember::glow::GlowParameter* source)
+    {
+        auto identifier = source->identifier();
+        auto paramtype = source->effectiveType();
+        switch(paramtype.value())
+        {
+            case libember::glow::ParameterType::Boolean:
+            {
+                auto param = gadget::ParameterFactory::create(parent, identifier, false);
+                transform(param, source);
+                return param;
+            }
+
+            case libember::glow::ParameterType::Enum:
+            {
+                auto param = gadget::ParameterFactory::create(parent, identifier);
+                transform(param, source);
+                return param;
+            }
+
+            case libember::glow::ParameterType::Integer:
+            {
+                auto param = gadget::ParameterFactory::create(parent, identifier, 0, 1000, 0);
+                transform(param, source);
+                return param;
+            }
+
+            case libember::glow::ParameterType::Octets:
+                break;
+
+            case libember::glow::ParameterType::Real:
+            {
+                auto param = gadget::ParameterFactory::create(parent, identifier, 0.0, 1000.0, 0.0);
+                transform(param, source);
+                return param;
+            }
+
+            case libember::glow::ParameterType::String:
+            {
+                auto param = gadget::ParameterFactory::create(parent, identifier, std::string("text"));
+                transform(param, source);
+                return param;
+            }
+
+            case libember::glow::ParameterType::Trigger:
+                break;
+
+            default:
+                volatile int x = paramtype.value();
+                break;
+        }
+
+        return nullptr;
+    }
+
+    void GadgetTreeReader::transformBase(gadget::Parameter* param, libember::glow::GlowParameter* source)
     {
         param->setDescription(source->description());
         param->setSchema(source->schemaIdentifiers());
@@ -157,7 +178,7 @@ namespace serialization { namespace detail
         }
     }
 
-    void GadgetTreeReader::transform(gadget::EnumParameter* param, libember::glow::GlowParameter* source) const
+    void GadgetTreeReader::transform(gadget::EnumParameter* param, libember::glow::GlowParameter* source)
     {
         transformBase(param, source);
 
@@ -176,7 +197,7 @@ namespace serialization { namespace detail
         param->setIndex(source->value().toInteger());
     }
 
-    void GadgetTreeReader::transform(gadget::IntegerParameter* param, libember::glow::GlowParameter* source) const
+    void GadgetTreeReader::transform(gadget::IntegerParameter* param, libember::glow::GlowParameter* source)
     {
         transformBase(param, source);
 
@@ -190,7 +211,7 @@ namespace serialization { namespace detail
             param->setValue(source->value().toInteger());
     }
 
-    void GadgetTreeReader::transform(gadget::RealParameter* param, libember::glow::GlowParameter* source) const
+    void GadgetTreeReader::transform(gadget::RealParameter* param, libember::glow::GlowParameter* source)
     {
         transformBase(param, source);
 
@@ -204,7 +225,7 @@ namespace serialization { namespace detail
             param->setValue(source->value().toReal());
     }
 
-    void GadgetTreeReader::transform(gadget::StringParameter* param, libember::glow::GlowParameter* source) const
+    void GadgetTreeReader::transform(gadget::StringParameter* param, libember::glow::GlowParameter* source)
     {
         transformBase(param, source);
 
@@ -215,7 +236,7 @@ namespace serialization { namespace detail
             param->setValue(source->value().toString());
     }
 
-    void GadgetTreeReader::transform(gadget::BooleanParameter* param, libember::glow::GlowParameter* source) const
+    void GadgetTreeReader::transform(gadget::BooleanParameter* param, libember::glow::GlowParameter* source)
     {
         transformBase(param, source);
 
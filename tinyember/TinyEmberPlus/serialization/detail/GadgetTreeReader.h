@@ -28,6 +28,7 @@ namespace serialization { namespace detail
     class GadgetTreeReader
     {
         friend class Archive;
+        friend class GadgetTreeStreamReader;
         private:
             /**
              * Initializes a new reader.
@@ -50,48 +51,57 @@ namespace serialization { namespace detail
              */
             void iterate(gadget::Node* parent, libember::glow::GlowElementCollection* collection);
 
+            /**
+             * Creates the gadget parameter described by a glow parameter and appends it to
+             * the passed node. Octet string and trigger parameters are not supported.
+             * @param parent The gadget node where the parameter shall be appended to.
+             * @param source The glow parameter to read the properties from.
+             * @return The new parameter, or nullptr if the parameter type is not supported.
+             */
+            static gadget::Parameter* createParameter(gadget::Node* parent, libember::glow::GlowParameter* source);
+
             /**
              * Reads all common parameter properties from the glow parameter and assigns them to the passed
              * parameter.
              * @param param The parameter to assign the glow parameter's properties to.
              * @param source The glow parameter to read the available properties from.
              */
-            void transformBase(gadget::Parameter* param, libember::glow::GlowParameter* source) const;
+            static void transformBase(gadget::Parameter* param, libember::glow::GlowParameter* source);
 
             /**
              * Copies the enumeration parameter properties.
              * @param param the gadget parameter to assign the properties to.
              * @param source The glow parameter to read the properties from.
              */
-            void transform(gadget::EnumParameter* param, libember::glow::GlowParameter* source) const;
+            static void transform(gadget::EnumParameter* param, libember::glow::GlowParameter* source);
 
             /**
              * Copies the integer parameter properties.
              * @param param the gadget parameter to assign the properties to.
              * @param source The glow parameter to read the properties from.
              */
-            void transform(gadget::IntegerParameter* param, libember::glow::GlowParameter* source) const;
+            static void transform(gadget::IntegerParameter* param, libember::glow::GlowParameter* source);
 
             /**
              * Copies the real parameter properties.
              * @param param the gadget parameter to assign the properties to.
              * @param source The glow parameter to read the properties from.
              */
-            void transform(gadget::RealParameter* param, libember::glow::GlowParameter* source) const;
+            static void transform(gadget::RealParameter* param, libember::glow::GlowParameter* source);
 
             /**
              * Copies the string parameter properties.
              * @param param the gadget parameter to assign the properties to.
              * @param source The glow parameter to read the properties from.
              */
-            void transform(gadget::StringParameter* param, libember::glow::GlowParameter* source) const;
+            static void transform(gadget::StringParameter* param, libember::glow::GlowParameter* source);
 
             /**
              * Copies the boolean parameter properties.
              * @param param the gadget parameter to assign the properties to.
              * @param source The glow parameter to read the properties from.
              */
-            void transform(gadget::BooleanParameter* param, libember::glow::GlowParameter* source) const;
+            static void transform(gadget::BooleanParameter* param, libember::glow::GlowParameter* source);
 
         private:
             gadget::Node* m_root;
@@ -0,0 +1,158 @@
+#include "GadgetTreeStreamReader.h"
+#include "GadgetTreeReader.h"
+#include "../../gadget/Node.h"
+#include "../../gadget/NodeFactory.h"
+#include "../../gadget/Parameter.h"
+
+using namespace libember;
+using namespace libember::glow;
+
+namespace serialization { namespace detail
+{
+    GadgetTreeStreamReader::GadgetTreeStreamReader(ArchiveImport::Listener* listener)
+        : dom::AsyncDomReader(GlowNodeFactory::getFactory())
+        , m_listener(listener)
+        , m_root(nullptr)
+    {}
+
+    void GadgetTreeStreamReader::finish()
+    {
+        for each(auto const& entry in m_nodes)
+        {
+            auto const node = entry.second;
+            if (node->parent() == m_root && node != m_root)
+                node->setIsOnline(true);
+        }
+
+        m_nodes.clear();
+    }
+
+    void GadgetTreeStreamReader::containerReady(dom::Node* node)
+    {
+        // The contents of a node are encoded before its children, so the node can be
+        // created when its children collection begins.
+        auto const type = ber::Type::fromTag(node->typeTag());
+        if (type.isApplicationDefined() && type.value() == GlowType::ElementCollection)
+        {
+            auto const glownode = dynamic_cast<GlowNode*>(node->parent());
+            if (glownode != nullptr)
+                createNode(glownode);
+        }
+    }
+
+    void GadgetTreeStreamReader::itemReady(dom::Node* node)
+    {
+        auto const type = ber::Type::fromTag(node->typeTag());
+        if (type.isApplicationDefined() == false)
+            return;
+
+        if (type.value() == GlowType::Node)
+        {
+            auto const glownode = dynamic_cast<GlowNode*>(node);
+            if (glownode != nullptr)
+            {
+                createNode(glownode);
+
+                auto const result = m_nodes.find(glownode);
+                if (result != m_nodes.end())
+                {
+                    auto const gadgetnode = result->second;
+                    m_nodes.erase(result);
+
+                    // setIsOnline also remounts the subtree, whereas mount() would keep
+                    // the offline state unmount() has set.
+                    if (gadgetnode->parent() == m_root && gadgetnode != m_root)
+                        gadgetnode->setIsOnline(true);
+                }
+
+                release(glownode);
+            }
+        }
+        else if (type.value() == GlowType::Parameter)
+        {
+            auto const glowparam = dynamic_cast<GlowParameter*>(node);
+            if (glowparam != nullptr)
+            {
+                auto const parent = parentOf(glowparam);
+                if (parent != nullptr)
+                {
+                    auto const parameter = GadgetTreeReader::createParameter(parent, glowparam);
+                    if (parameter != nullptr && m_listener != nullptr)
+                        m_listener->parameterImported(parameter);
+                }
+
+                release(glowparam);
+            }
+        }
+    }
+
+    gadget::Node* GadgetTreeStreamReader::parentOf(dom::Node const* element) const
+    {
+        auto const collection = element->parent();
+        if (collection != nullptr)
+        {
+            auto const result = m_nodes.find(collection->parent());
+            if (result != m_nodes.end())
+                return result->second;
+        }
+
+        return nullptr;
+    }
+
+    void GadgetTreeStreamReader::createNode(GlowNode* glownode)
+    {
+        if (m_nodes.find(glownode) != m_nodes.end())
+            return;
+
+        auto const collection = glownode->parent();
+        if (collection == nullptr)
+            return;
+
+        auto const type = ber::Type::fromTag(collection->typeTag());
+        if (type.isApplicationDefined() && type.value() == GlowType::RootElementCollection)
+        {
+            if (m_root == nullptr)
+            {
+                m_root = gadget::NodeFactory::createRoot(glownode->identifier());
+                m_root->setDescription(glownode->description());
+                m_nodes[glownode] = m_root;
+            }
+        }
+        else
+        {
+            auto const parent = parentOf(glownode);
+            if (parent != nullptr)
+            {
+                auto const node = gadget::NodeFactory::createNode(parent, glownode->identifier());
+                node->setDescription(glownode->description());
+                node->setSchema(glownode->schemaIdentifiers());
+
+                if (parent == m_root)
+                    node->unmount();
+
+                m_nodes[glownode] = node;
+
+                if (m_listener != nullptr)
+                    m_listener->nodeImported(node);
+            }
+        }
+    }
+
+    void GadgetTreeStreamReader::release(dom::Node* element)
+    {
+        auto const collection = dynamic_cast<dom::Container*>(element->parent());
+        if (collection != nullptr)
+        {
+            auto const last = std::end(*collection);
+            for(auto it = std::begin(*collection); it != last; ++it)
+            {
+                if (&*it == element)
+                {
+                    delete collection->release(it);
+                    return;
+                }
+            }
+        }
+    }
+}
+}
@@ -0,0 +1,78 @@
+#ifndef __TINYEMBER_SERIALIZATION_GADGETTREESTREAMREADER_H
+#define __TINYEMBER_SERIALIZATION_GADGETTREESTREAMREADER_H
+
+#include <unordered_map>
+#include "../ArchiveImport.h"
+#include <ember\Ember.hpp>
+
+/** Forward declarations */
+namespace gadget
+{
+    class Node;
+}
+
+namespace serialization { namespace detail
+{
+    /**
+     * This reader decodes a ber encoded glow tree incrementally and creates the gadget
+     * entities while the data is being fed. A node is created as soon as its contents have
+     * been decoded, a parameter as soon as it is complete. Every glow element is deleted
+     * after it has been converted, so only the glow nodes that are still being decoded
+     * are kept in memory.
+     */
+    class GadgetTreeStreamReader : public libember::dom::AsyncDomReader
+    {
+        friend class serialization::ArchiveImport;
+        private:
+            typedef std::unordered_map<libember::dom::Node const*, gadget::Node*> NodeMap;
+
+            /**
+             * Initializes a new reader.
+             * @param listener The listener to notify about new entities, may be nullptr.
+             */
+            explicit GadgetTreeStreamReader(ArchiveImport::Listener* listener);
+
+            /**
+             * Mounts the subtrees that are still incomplete when the input ends early,
+             * for example because it is malformed.
+             */
+            void finish();
+
+            /** @see AsyncDomReader::containerReady() */
+            virtual void containerReady(libember::dom::Node* node);
+
+            /** @see AsyncDomReader::itemReady() */
+            virtual void itemReady(libember::dom::Node* node);
+
+            /**
+             * Returns the gadget node that owns the element collection containing the
+             * passed glow element.
+             * @param element The glow element to look up the gadget parent for.
+             * @return The gadget parent, or nullptr if the element is not part of the
+             *      imported tree.
+             */
+            gadget::Node* parentOf(libember::dom::Node const* element) const;
+
+            /**
+             * Creates the gadget node for a glow node, if it hasn't been created yet.
+             * The first node in the root collection becomes the root node, all other
+             * nodes in the root collection are ignored.
+             * @param glownode The glow node whose properties have been decoded.
+             */
+            void createNode(libember::glow::GlowNode* glownode);
+
+            /**
+             * Removes a converted glow element from its collection and deletes it.
+             * @param element The element to delete.
+             */
+            static void release(libember::dom::Node* element);
+
+        private:
+            ArchiveImport::Listener* const m_listener;
+            gadget::Node* m_root;
+            NodeMap m_nodes;
+    };
+}
+}
+
+#endif//__TINYEMBER_SERIALIZATION_GADGETTREESTREAMREADER_H
@@ -0,0 +1,100 @@
+#ifndef __TINYEMBER_SERIALIZATION_SNAPSHOT_H
+#define __TINYEMBER_SERIALIZATION_SNAPSHOT_H
+
+#include <cstdint>
+
+namespace serialization { namespace detail
+{
+    /**
+     * Definition of the binary snapshot format. A snapshot starts with a Header, which is
+     * followed by one fixed-size Element record per node or parameter, a table of enumeration
+     * entries and a table of strings. The elements are stored in depth-first order, so the
+     * parent of an element always precedes it. Strings are referenced by their offset in the
+     * string table, where each of them is stored as a 32 bit length followed by its characters.
+     * All integers are stored in the byte order of the machine that wrote the snapshot. A
+     * snapshot written with a different byte order does not match the magic number and is
+     * rejected. Since no record has to be decoded, a snapshot can be mapped into memory and
+     * the tree be built in a single pass over the element array.
+     */
+    struct Snapshot
+    {
+        /** The magic number at the start of each snapshot, "TEPS" in little endian. */
+        static std::uint32_t const Magic = 0x53504554;
+
+        /** The version of the format described here. */
+        static std::uint32_t const Version = 1;
+
+        /** The parent index of the root node. */
+        static std::uint32_t const NoParent = 0xFFFFFFFF;
+
+        /** The element type of nodes. Parameters use the values of gadget::ParameterType. */
+        static std::uint32_t const NodeType = 0;
+
+        /**
+         * Flags that tell which of the optional element properties are present.
+         */
+        enum Flag
+        {
+            IsOnline = 0x01,
+            HasFormula = 0x02,
+            HasStreamIdentifier = 0x04,
+            HasStreamDescriptor = 0x08,
+        };
+
+        /**
+         * The file header. All offsets are relative to the start of the snapshot.
+         */
+        struct Header
+        {
+            std::uint32_t magic;
+            std::uint32_t version;
+            std::uint32_t elementCount;
+            std::uint32_t elementOffset;
+            std::uint32_t entryCount;
+            std::uint32_t entryOffset;
+            std::uint32_t stringSize;
+            std::uint32_t stringOffset;
+        };
+
+        /**
+         * A numeric property, interpreted according to the element type.
+         */
+        union Number
+        {
+            std::int64_t integer;
+            double real;
+        };
+
+        /**
+         * The record of a single node or parameter.
+         */
+        struct Element
+        {
+            std::uint32_t type;                 // NodeType or gadget::ParameterType
+            std::uint32_t parent;               // Index of the parent element, or NoParent
+            std::uint32_t identifier;           // String
+            std::uint32_t description;          // String
+            std::uint32_t schema;               // String
+            std::uint32_t flags;                // Combination of Flag values
+            std::uint32_t access;               // gadget::Access
+            std::int32_t streamIdentifier;      // If HasStreamIdentifier is set
+            std::uint32_t streamFormat;         // If HasStreamDescriptor is set
+            std::uint32_t streamOffset;         // If HasStreamDescriptor is set
+            std::uint32_t consumerToProvider;   // String, if HasFormula is set
+            std::uint32_t providerToConsumer;   // String, if HasFormula is set
+            std::uint32_t text;                 // String value or integer and real format
+            std::uint32_t firstEntry;           // Index of the first enumeration entry
+            std::uint32_t entryCount;           // Number of enumeration entries
+            std::uint32_t maxLength;            // Maximum length of a string value
+            Number value;                       // Integer, real, boolean or enumeration index
+            Number minimum;
+            Number maximum;
+        };
+
+        static_assert(sizeof(Header) == 32, "Unexpected size of Snapshot::Header");
+        static_assert(sizeof(Element) == 88, "Unexpected size of Snapshot::Element");
+    };
+}
+}
+
+#endif//__TINYEMBER_SERIALIZATION_SNAPSHOT_H
@@ -0,0 +1,228 @@
+#include <cstring>
+#include "SnapshotReader.h"
+#include "../../gadget/BooleanParameter.h"
+#include "../../gadget/EnumParameter.h"
+#include "../../gadget/IntegerParameter.h"
+#include "../../gadget/Node.h"
+#include "../../gadget/NodeFactory.h"
+#include "../../gadget/ParameterFactory.h"
+#include "../../gadget/RealParameter.h"
+#include "../../gadget/StringParameter.h"
+
+namespace serialization { namespace detail
+{
+    //static
+    bool SnapshotReader::isSnapshot(unsigned char const* first, std::size_t size)
+    {
+        auto magic = std::uint32_t(0);
+        if (size < sizeof(Snapshot::Header))
+            return false;
+
+        std::memcpy(&magic, first, sizeof(magic));
+        return magic == Snapshot::Magic;
+    }
+
+    SnapshotReader::SnapshotReader(unsigned char const* first, std::size_t size)
+        : m_root(nullptr)
+        , m_entries(nullptr)
+        , m_entryCount(0)
+        , m_strings(nullptr)
+        , m_stringSize(0)
+    {
+        // The records are accessed in place, which requires the buffer to be aligned
+        // like the Element structure. Mapped files and heap buffers always are.
+        if (isSnapshot(first, size) == false || reinterpret_cast<std::size_t>(first) % sizeof(Snapshot::Number) != 0)
+            return;
+
+        auto const& header = *reinterpret_cast<Snapshot::Header const*>(first);
+        auto const elementSize = static_cast<unsigned long long>(header.elementCount) * sizeof(Snapshot::Element);
+        auto const entrySize = static_cast<unsigned long long>(header.entryCount) * sizeof(std::uint32_t);
+
+        if (header.version != Snapshot::Version
+        ||  header.elementCount == 0
+        ||  header.elementOffset % sizeof(Snapshot::Number) != 0
+        ||  header.entryOffset % sizeof(std::uint32_t) != 0
+        ||  header.elementOffset + elementSize > size
+        ||  header.entryOffset + entrySize > size
+        ||  static_cast<unsigned long long>(header.stringOffset) + header.stringSize > size)
+        {
+            return;
+        }
+
+        auto const elements = reinterpret_cast<Snapshot::Element const*>(first + header.elementOffset);
+        m_entries = reinterpret_cast<std::uint32_t const*>(first + header.entryOffset);
+        m_entryCount = header.entryCount;
+        m_strings = reinterpret_cast<char const*>(first + header.stringOffset);
+        m_stringSize = header.stringSize;
+        m_nodes.resize(header.elementCount, nullptr);
+
+        for (auto index = std::uint32_t(0); index < header.elementCount; ++index)
+        {
+            if (create(elements[index], index) == false)
+            {
+                delete m_root;
+                m_root = nullptr;
+                break;
+            }
+        }
+
+        m_nodes.clear();
+    }
+
+    bool SnapshotReader::create(Snapshot::Element const& element, std::uint32_t index)
+    {
+        auto identifier = String();
+        auto description = String();
+        auto schema = String();
+
+        if (string(element.identifier, identifier) == false
+        ||  string(element.description, description) == false
+        ||  string(element.schema, schema) == false)
+        {
+            return false;
+        }
+
+        // The root is the first element, all other elements refer to a preceding node.
+        if (index == 0 || element.parent == Snapshot::NoParent)
+        {
+            if (index != 0 || element.parent != Snapshot::NoParent || element.type != Snapshot::NodeType)
+                return false;
+
+            m_root = gadget::NodeFactory::createRoot(identifier);
+            m_root->setDescription(description);
+            m_root->setSchema(schema);
+            m_root->setIsOnline((element.flags & Snapshot::IsOnline) != 0);
+            m_nodes[index] = m_root;
+            return true;
+        }
+
+        if (element.parent >= index || m_nodes[element.parent] == nullptr)
+            return false;
+
+        auto const parent = m_nodes[element.parent];
+        switch(element.type)
+        {
+            case Snapshot::NodeType:
+                {
+                    auto const node = gadget::NodeFactory::createNode(parent, identifier);
+                    node->setDescription(description);
+                    node->setSchema(schema);
+                    node->setIsOnline((element.flags & Snapshot::IsOnline) != 0);
+                    m_nodes[index] = node;
+                }
+                return true;
+
+            case gadget::ParameterType::Boolean:
+                {
+                    auto const parameter = gadget::ParameterFactory::create(parent, identifier, element.value.integer != 0);
+                    return transformBase(parameter, element, description, schema);
+                }
+
+            case gadget::ParameterType::Enum:
+                {
+                    if (element.firstEntry > m_entryCount || element.entryCount > m_entryCount - element.firstEntry)
+                        return false;
+
+                    auto entries = std::vector<String>(element.entryCount);
+                    for (auto i = std::uint32_t(0); i < element.entryCount; ++i)
+                    {
+                        if (string(m_entries[element.firstEntry + i], entries[i]) == false)
+                            return false;
+                    }
+
+                    auto const parameter = gadget::ParameterFactory::create(parent, identifier);
+                    parameter->assign(std::begin(entries), std::end(entries));
+                    parameter->setIndex(static_cast<gadget::EnumParameter::size_type>(element.value.integer));
+                    return transformBase(parameter, element, description, schema);
+                }
+
+            case gadget::ParameterType::Integer:
+                {
+                    auto format = String();
+                    if (string(element.text, format) == false)
+                        return false;
+
+                    auto const parameter = gadget::ParameterFactory::create(parent, identifier, 0, 1000, 0);
+                    parameter->setMin(static_cast<gadget::IntegerParameter::value_type>(element.minimum.integer));
+                    parameter->setMax(static_cast<gadget::IntegerParameter::value_type>(element.maximum.integer));
+                    parameter->setValue(static_cast<gadget::IntegerParameter::value_type>(element.value.integer));
+                    parameter->setFormat(format);
+                    return transformBase(parameter, element, description, schema);
+                }
+
+            case gadget::ParameterType::Real:
+                {
+                    auto format = String();
+                    if (string(element.text, format) == false)
+                        return false;
+
+                    auto const parameter = gadget::ParameterFactory::create(parent, identifier, 0.0, 1000.0, 0.0);
+                    parameter->setMin(element.minimum.real);
+                    parameter->setMax(element.maximum.real);
+                    parameter->setValue(element.value.real);
+                    parameter->setFormat(format);
+                    return transformBase(parameter, element, description, schema);
+                }
+
+            case gadget::ParameterType::String:
+                {
+                    auto value = String();
+                    if (string(element.text, value) == false)
+                        return false;
+
+                    auto const parameter = gadget::ParameterFactory::create(parent, identifier, value, element.maxLength);
+                    return transformBase(parameter, element, description, schema);
+                }
+
+            default:
+                return false;
+        }
+    }
+
+    bool SnapshotReader::transformBase(gadget::Parameter* parameter, Snapshot::Element const& element, String const& description, String const& schema) const
+    {
+        parameter->setDescription(description);
+        parameter->setSchema(schema);
+        parameter->setAccess(static_cast<gadget::Access::_Domain>(element.access));
+
+        if (element.flags & Snapshot::HasFormula)
+        {
+            auto consumerToProvider = String();
+            auto providerToConsumer = String();
+
+            if (string(element.consumerToProvider, consumerToProvider) == false || string(element.providerToConsumer, providerToConsumer) == false)
+                return false;
+
+            parameter->setFormula(gadget::Formula(providerToConsumer, consumerToProvider));
+        }
+
+        if (element.flags & Snapshot::HasStreamDescriptor)
+        {
+            auto const format = static_cast<gadget::StreamFormat::_Domain>(element.streamFormat);
+            parameter->setStreamDescriptor(format, element.streamOffset);
+        }
+
+        if (element.flags & Snapshot::HasStreamIdentifier)
+        {
+            parameter->setStreamIdentifier(element.streamIdentifier);
+        }
+
+        return true;
+    }
+
+    bool SnapshotReader::string(std::uint32_t offset, String& value) const
+    {
+        auto length = std::uint32_t(0);
+        if (offset > m_stringSize || m_stringSize - offset < sizeof(length))
+            return false;
+
+        std::memcpy(&length, m_strings + offset, sizeof(length));
+        if (m_stringSize - offset - sizeof(length) < length)
+            return false;
+
+        auto const first = m_strings + offset + sizeof(length);
+        value.assign(first, first + length);
+        return true;
+    }
+}
+}
@@ -0,0 +1,84 @@
+#ifndef __TINYEMBER_SERIALIZATION_SNAPSHOTREADER_H
+#define __TINYEMBER_SERIALIZATION_SNAPSHOTREADER_H
+
+#include <cstddef>
+#include <vector>
+#include "Snapshot.h"
+#include "../../Types.h"
+
+/** Forward declarations */
+namespace gadget
+{
+    class Node;
+    class Parameter;
+}
+
+namespace serialization 
+{
+    class Archive;
+}
+
+namespace serialization { namespace detail
+{
+    /**
+     * This reader creates a gadget tree from a snapshot that is usually mapped into memory.
+     */
+    class SnapshotReader
+    {
+        friend class serialization::Archive;
+        public:
+            /**
+             * Returns true if the buffer starts with the magic number of a snapshot.
+             * @param first Pointer to the first byte of the buffer.
+             * @param size The size of the buffer in bytes.
+             * @return true if the buffer contains a snapshot.
+             */
+            static bool isSnapshot(unsigned char const* first, std::size_t size);
+
+        private:
+            /**
+             * Initializes a new reader and creates the tree stored in the buffer. When
+             * the snapshot is invalid, no tree is created.
+             * @param first Pointer to the first byte of the snapshot.
+             * @param size The size of the snapshot in bytes.
+             */
+            SnapshotReader(unsigned char const* first, std::size_t size);
+
+            /**
+             * Creates the node or parameter described by an element record.
+             * @param element The record to create the object from.
+             * @param index The index of the record.
+             * @return false if the record is invalid.
+             */
+            bool create(Snapshot::Element const& element, std::uint32_t index);
+
+            /**
+             * Copies the common parameter properties of an element record.
+             * @param parameter The parameter to assign the properties to.
+             * @param element The record to read the properties from.
+             * @param description The description of the parameter.
+             * @param schema The schema identifiers of the parameter.
+             * @return false if the record is invalid.
+             */
+            bool transformBase(gadget::Parameter* parameter, Snapshot::Element const& element, String const& description, String const& schema) const;
+
+            /**
+             * Reads a string from the string table.
+             * @param offset The offset of the string in the string table.
+             * @param value Receives the string.
+             * @return false if the offset or the length of the string are out of bounds.
+             */
+            bool string(std::uint32_t offset, String& value) const;
+
+        private:
+            gadget::Node* m_root;
+            std::vector<gadget::Node*> m_nodes;
+            std::uint32_t const* m_entries;
+            std::uint32_t m_entryCount;
+            char const* m_strings;
+            std::uint32_t m_stringSize;
+    };
+}
+}
+
+#endif//__TINYEMBER_SERIALIZATION_SNAPSHOTREADER_H
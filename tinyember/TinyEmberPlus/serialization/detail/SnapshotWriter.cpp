@@ -0,0 +1,189 @@
+#include <cstring>
+#include "SnapshotWriter.h"
+#include "../../gadget/BooleanParameter.h"
+#include "../../gadget/EnumParameter.h"
+#include "../../gadget/IntegerParameter.h"
+#include "../../gadget/Node.h"
+#include "../../gadget/RealParameter.h"
+#include "../../gadget/StringParameter.h"
+
+namespace serialization { namespace detail
+{
+    SnapshotWriter::SnapshotWriter(gadget::Node const* root)
+    {
+        // The empty string is stored first, so zero initialized offsets refer to it.
+        string(String());
+        write(root, Snapshot::NoParent);
+
+        auto header = Snapshot::Header();
+        header.magic = Snapshot::Magic;
+        header.version = Snapshot::Version;
+        header.elementCount = static_cast<std::uint32_t>(m_elements.size());
+        header.elementOffset = sizeof(Snapshot::Header);
+        header.entryCount = static_cast<std::uint32_t>(m_entries.size());
+        header.entryOffset = header.elementOffset + header.elementCount * sizeof(Snapshot::Element);
+        header.stringSize = static_cast<std::uint32_t>(m_strings.size());
+        header.stringOffset = header.entryOffset + header.entryCount * sizeof(std::uint32_t);
+
+        m_bytes.resize(header.stringOffset + header.stringSize);
+
+        auto const data = &m_bytes.front();
+        std::memcpy(data, &header, sizeof(header));
+
+        if (m_elements.empty() == false)
+            std::memcpy(data + header.elementOffset, &m_elements.front(), m_elements.size() * sizeof(Snapshot::Element));
+
+        if (m_entries.empty() == false)
+            std::memcpy(data + header.entryOffset, &m_entries.front(), m_entries.size() * sizeof(std::uint32_t));
+
+        std::memcpy(data + header.stringOffset, &m_strings.front(), m_strings.size());
+    }
+
+    SnapshotWriter::size_type SnapshotWriter::size() const
+    {
+        return m_bytes.size();
+    }
+
+    SnapshotWriter::const_iterator SnapshotWriter::begin() const
+    {
+        return m_bytes.begin();
+    }
+
+    SnapshotWriter::const_iterator SnapshotWriter::end() const
+    {
+        return m_bytes.end();
+    }
+
+    void SnapshotWriter::write(gadget::Node const* node, std::uint32_t parent)
+    {
+        auto const index = static_cast<std::uint32_t>(m_elements.size());
+        auto element = Snapshot::Element();
+        element.type = Snapshot::NodeType;
+        element.parent = parent;
+        element.identifier = string(node->identifier());
+        element.description = string(node->description());
+        element.schema = string(node->schema());
+        element.flags = node->isOnline() ? Snapshot::IsOnline : 0;
+        m_elements.push_back(element);
+
+        auto const& params = node->parameters();
+        auto const& nodes = node->nodes();
+
+        for each(auto param in params)
+        {
+            write(param, index);
+        }
+
+        for each(auto child in nodes)
+        {
+            write(child, index);
+        }
+    }
+
+    void SnapshotWriter::write(gadget::Parameter const* parameter, std::uint32_t parent)
+    {
+        auto element = Snapshot::Element();
+        element.type = static_cast<std::uint32_t>(parameter->type().value());
+        element.parent = parent;
+        element.identifier = string(parameter->identifier());
+        element.description = string(parameter->description());
+        element.schema = string(parameter->schema());
+        element.access = static_cast<std::uint32_t>(parameter->access().value());
+
+        auto const& formula = parameter->formula();
+        if (formula.empty() == false)
+        {
+            element.flags |= Snapshot::HasFormula;
+            element.consumerToProvider = string(formula.consumerToProvider());
+            element.providerToConsumer = string(formula.providerToConsumer());
+        }
+
+        if (parameter->hasStreamIdentifier())
+        {
+            element.flags |= Snapshot::HasStreamIdentifier;
+            element.streamIdentifier = parameter->streamIdentifier();
+        }
+
+        if (parameter->hasStreamDescriptor())
+        {
+            auto const descriptor = parameter->streamDescriptor();
+            element.flags |= Snapshot::HasStreamDescriptor;
+            element.streamFormat = static_cast<std::uint32_t>(descriptor->format().value());
+            element.streamOffset = static_cast<std::uint32_t>(descriptor->offset());
+        }
+
+        switch(parameter->type().value())
+        {
+            case gadget::ParameterType::Boolean:
+                {
+                    auto const boolean = static_cast<gadget::BooleanParameter const*>(parameter);
+                    element.value.integer = boolean->value() ? 1 : 0;
+                }
+                break;
+
+            case gadget::ParameterType::Enum:
+                {
+                    auto const enumeration = static_cast<gadget::EnumParameter const*>(parameter);
+                    element.value.integer = enumeration->index();
+                    element.firstEntry = static_cast<std::uint32_t>(m_entries.size());
+                    element.entryCount = static_cast<std::uint32_t>(enumeration->size());
+
+                    for each(auto const& entry in *enumeration)
+                    {
+                        m_entries.push_back(string(entry));
+                    }
+                }
+                break;
+
+            case gadget::ParameterType::Integer:
+                {
+                    auto const integer = static_cast<gadget::IntegerParameter const*>(parameter);
+                    element.value.integer = integer->value();
+                    element.minimum.integer = integer->minimum();
+                    element.maximum.integer = integer->maximum();
+                    element.text = string(integer->format());
+                }
+                break;
+
+            case gadget::ParameterType::Real:
+                {
+                    auto const real = static_cast<gadget::RealParameter const*>(parameter);
+                    element.value.real = real->value();
+                    element.minimum.real = real->minimum();
+                    element.maximum.real = real->maximum();
+                    element.text = string(real->format());
+                }
+                break;
+
+            case gadget::ParameterType::String:
+                {
+                    auto const text = static_cast<gadget::StringParameter const*>(parameter);
+                    element.text = string(text->value());
+                    element.maxLength = static_cast<std::uint32_t>(text->maxLength());
+                }
+                break;
+
+            default:
+                return;
+        }
+
+        m_elements.push_back(element);
+    }
+
+    std::uint32_t SnapshotWriter::string(String const& value)
+    {
+        auto const result = m_offsets.find(value);
+        if (result != m_offsets.end())
+            return result->second;
+
+        auto const offset = static_cast<std::uint32_t>(m_strings.size());
+        auto const length = static_cast<std::uint32_t>(value.size());
+        auto const first = reinterpret_cast<char const*>(&length);
+
+        m_strings.insert(m_strings.end(), first, first + sizeof(length));
+        m_strings.insert(m_strings.end(), value.begin(), value.end());
+        m_offsets.insert(std::make_pair(value, offset));
+        return offset;
+    }
+}
+}
@@ -0,0 +1,91 @@
+#ifndef __TINYEMBER_SERIALIZATION_SNAPSHOTWRITER_H
+#define __TINYEMBER_SERIALIZATION_SNAPSHOTWRITER_H
+
+#include <map>
+#include <vector>
+#include "Snapshot.h"
+#include "../../Types.h"
+
+/** Forward declarations */
+namespace gadget
+{
+    class Node;
+    class Parameter;
+}
+
+namespace serialization 
+{
+    class Archive;
+}
+
+namespace serialization { namespace detail
+{
+    /**
+     * The snapshot writer stores the local gadget tree in the binary snapshot format.
+     */
+    class SnapshotWriter
+    {
+        friend class serialization::Archive;
+        typedef std::vector<unsigned char> ByteVector;
+        public:
+            typedef ByteVector::const_iterator const_iterator;
+            typedef ByteVector::size_type size_type;
+
+            /**
+             * Returns the size of the snapshot in bytes.
+             * @return The size of the snapshot in bytes.
+             */
+            size_type size() const;
+
+            /**
+             * Returns an iterator that points to the first byte of the snapshot.
+             * @return An iterator that points to the first byte of the snapshot.
+             */
+            const_iterator begin() const;
+
+            /**
+             * Returns an iterator that points one past the last byte of the snapshot.
+             * @return An iterator that points one past the last byte of the snapshot.
+             */
+            const_iterator end() const;
+
+        private:
+            /**
+             * Initializes a new SnapshotWriter and creates the snapshot of the passed tree.
+             * @param root The root node of the tree to store.
+             */
+            explicit SnapshotWriter(gadget::Node const* root);
+
+            /**
+             * Appends the records of a node and of all its parameters and child nodes.
+             * @param node The node to store.
+             * @param parent The index of the parent element.
+             */
+            void write(gadget::Node const* node, std::uint32_t parent);
+
+            /**
+             * Appends the record of a single parameter.
+             * @param parameter The parameter to store.
+             * @param parent The index of the parent element.
+             */
+            void write(gadget::Parameter const* parameter, std::uint32_t parent);
+
+            /**
+             * Returns the offset of a string in the string table. Each distinct string
+             * is stored only once.
+             * @param value The string to look up.
+             * @return The offset of the string in the string table.
+             */
+            std::uint32_t string(String const& value);
+
+        private:
+            std::vector<Snapshot::Element> m_elements;
+            std::vector<std::uint32_t> m_entries;
+            std::vector<char> m_strings;
+            std::map<String, std::uint32_t> m_offsets;
+            ByteVector m_bytes;
+    };
+}
+}
+
+#endif//__TINYEMBER_SERIALIZATION_SNAPSHOTWRITER_H
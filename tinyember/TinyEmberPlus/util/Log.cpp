@@ -0,0 +1,368 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <QtCore/QDateTime>
+#include <QtCore/QString>
+#include "Log.h"
+
+namespace util
+{
+    namespace
+    {
+        /**
+         * A bounded queue that may be written by several threads and is read by the
+         * log writer thread only. Each slot carries a sequence number which tells the
+         * producers and the consumer whether the slot is free or filled, so neither
+         * side takes a lock.
+         */
+        class LogQueue
+        {
+            public:
+                static std::size_t const Capacity = 1024;
+
+                LogQueue()
+                    : m_tail(0)
+                    , m_head(0)
+                    , m_dropped(0)
+                {
+                    for (std::size_t index = 0; index < Capacity; ++index)
+                        m_slots[index].sequence.store(index, std::memory_order_relaxed);
+                }
+
+                bool push(LogMessage const& message)
+                {
+                    auto position = m_tail.load(std::memory_order_relaxed);
+
+                    for (;;)
+                    {
+                        auto& slot = m_slots[position & (Capacity - 1)];
+                        auto const sequence = slot.sequence.load(std::memory_order_acquire);
+                        auto const difference = static_cast<std::ptrdiff_t>(sequence - position);
+
+                        if (difference == 0)
+                        {
+                            if (m_tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                            {
+                                slot.message = message;
+                                slot.sequence.store(position + 1, std::memory_order_release);
+                                return true;
+                            }
+                        }
+                        else if (difference < 0)
+                        {
+                            m_dropped.fetch_add(1, std::memory_order_relaxed);
+                            return false;
+                        }
+                        else
+                        {
+                            position = m_tail.load(std::memory_order_relaxed);
+                        }
+                    }
+                }
+
+                bool pop(LogMessage& message)
+                {
+                    auto& slot = m_slots[m_head & (Capacity - 1)];
+
+                    if (slot.sequence.load(std::memory_order_acquire) != m_head + 1)
+                        return false;
+
+                    message = slot.message;
+                    slot.sequence.store(m_head + Capacity, std::memory_order_release);
+                    ++m_head;
+                    return true;
+                }
+
+                unsigned int takeDropped()
+                {
+                    return m_dropped.exchange(0, std::memory_order_relaxed);
+                }
+
+            private:
+                struct Slot
+                {
+                    std::atomic<std::size_t> sequence;
+                    LogMessage message;
+                };
+
+                Slot m_slots[Capacity];
+                std::atomic<std::size_t> m_tail;
+                std::size_t m_head;
+                std::atomic<unsigned int> m_dropped;
+        };
+
+        LogQueue s_queue;
+    }
+
+    /**************************************************************************
+     * LogLevel                                                               *
+     **************************************************************************/
+
+    char const* LogLevel::name(_Domain level)
+    {
+        switch (level)
+        {
+            case Debug: return "DEBUG";
+            case Info: return "INFO";
+            case Warning: return "WARNING";
+            case Error: return "ERROR";
+            default: return "NONE";
+        }
+    }
+
+    bool LogLevel::parse(QString const& name, _Domain& level)
+    {
+        for (auto value = int(Debug); value <= int(None); ++value)
+        {
+            if (name.compare(LogLevel::name(static_cast<_Domain>(value)), Qt::CaseInsensitive) == 0)
+            {
+                level = static_cast<_Domain>(value);
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    /**************************************************************************
+     * LogMessage                                                             *
+     **************************************************************************/
+
+    LogMessage::LogMessage(LogLevel::_Domain level)
+        : m_time(QDateTime::currentMSecsSinceEpoch())
+        , m_level(level)
+        , m_length(0)
+    {
+        m_text[0] = 0;
+    }
+
+    LogMessage& LogMessage::operator<<(char const* text)
+    {
+        if (text != nullptr)
+            append(text, std::strlen(text));
+
+        return *this;
+    }
+
+    LogMessage& LogMessage::operator<<(std::string const& text)
+    {
+        append(text.data(), text.size());
+        return *this;
+    }
+
+    LogMessage& LogMessage::operator<<(QString const& text)
+    {
+        auto const utf8 = text.toUtf8();
+        append(utf8.constData(), static_cast<std::size_t>(utf8.size()));
+        return *this;
+    }
+
+    LogMessage& LogMessage::operator<<(char value)
+    {
+        append(&value, 1);
+        return *this;
+    }
+
+    LogMessage& LogMessage::operator<<(bool value)
+    {
+        return *this << (value ? "true" : "false");
+    }
+
+    LogMessage& LogMessage::operator<<(double value)
+    {
+        char buffer[32];
+        auto const length = std::sprintf(buffer, "%g", value);
+        append(buffer, static_cast<std::size_t>(length));
+        return *this;
+    }
+
+    void LogMessage::appendSuppressed(unsigned int count)
+    {
+        if (count > 0)
+            *this << " (" << count << " similar messages suppressed)";
+    }
+
+    void LogMessage::append(char const* text, std::size_t length)
+    {
+        auto const count = std::min(length, Capacity - m_length);
+        std::memcpy(m_text + m_length, text, count);
+        m_length += count;
+        m_text[m_length] = 0;
+    }
+
+    void LogMessage::appendSigned(qint64 value)
+    {
+        if (value < 0)
+        {
+            append("-", 1);
+            appendUnsigned(quint64(0) - static_cast<quint64>(value));
+        }
+        else
+        {
+            appendUnsigned(static_cast<quint64>(value));
+        }
+    }
+
+    void LogMessage::appendUnsigned(quint64 value)
+    {
+        char buffer[20];
+        auto first = buffer + sizeof(buffer);
+
+        do
+        {
+            *--first = static_cast<char>('0' + value % 10);
+            value /= 10;
+        } while (value != 0);
+
+        append(first, static_cast<std::size_t>(buffer + sizeof(buffer) - first));
+    }
+
+    /**************************************************************************
+     * Log                                                                    *
+     **************************************************************************/
+
+    std::atomic<int> Log::s_level(LogLevel::Info);
+    std::atomic<bool> Log::s_isWriterRunning(false);
+
+    void Log::setLevel(LogLevel::_Domain level)
+    {
+        s_level.store(level, std::memory_order_relaxed);
+    }
+
+    void Log::post(LogMessage const& message)
+    {
+        if (s_isWriterRunning.load(std::memory_order_acquire))
+        {
+            s_queue.push(message);
+        }
+        else
+        {
+            write(message);
+            std::fflush(stderr);
+        }
+    }
+
+    void Log::write(LogMessage const& message)
+    {
+        auto const time = QDateTime::fromMSecsSinceEpoch(message.m_time).toString("hh:mm:ss.zzz").toLatin1();
+        std::fprintf(stderr, "%s %-7s %s\n", time.constData(), LogLevel::name(message.level()), message.text());
+    }
+
+    void Log::writeDropped()
+    {
+        auto const dropped = s_queue.takeDropped();
+
+        if (dropped > 0)
+        {
+            auto message = LogMessage(LogLevel::Warning);
+            message << dropped << " log messages dropped";
+            write(message);
+        }
+    }
+
+    /**************************************************************************
+     * LogWriter                                                              *
+     **************************************************************************/
+
+    struct LogWriter::Thread
+    {
+        Thread()
+            : isStopping(false)
+        {}
+
+        std::atomic<bool> isStopping;
+        std::thread thread;
+    };
+
+    LogWriter::LogWriter()
+        : m_thread(new Thread())
+    {
+        Log::s_isWriterRunning.store(true, std::memory_order_release);
+        m_thread->thread = std::thread(&LogWriter::run, this);
+    }
+
+    LogWriter::~LogWriter()
+    {
+        m_thread->isStopping.store(true, std::memory_order_release);
+        m_thread->thread.join();
+        Log::s_isWriterRunning.store(false, std::memory_order_release);
+
+        // messages posted while the writer was stopping
+        auto message = LogMessage();
+        while (s_queue.pop(message))
+            Log::write(message);
+
+        Log::writeDropped();
+        std::fflush(stderr);
+        delete m_thread;
+    }
+
+    void LogWriter::run()
+    {
+        auto message = LogMessage();
+
+        for (;;)
+        {
+            auto const isStopping = m_thread->isStopping.load(std::memory_order_acquire);
+            auto count = 0;
+
+            while (s_queue.pop(message))
+            {
+                Log::write(message);
+                ++count;
+            }
+
+            Log::writeDropped();
+
+            if (count > 0)
+                std::fflush(stderr);
+
+            if (isStopping)
+                break;
+
+            // the queue is polled, so that posting a message never has to wake up the writer
+            if (count == 0)
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+
+    /**************************************************************************
+     * LogRateLimiter                                                         *
+     **************************************************************************/
+
+    LogRateLimiter::LogRateLimiter(unsigned int burst, qint64 interval)
+        : m_burst(burst)
+        , m_interval(interval)
+        , m_tokens(burst)
+        , m_lastRefill(0)
+        , m_suppressed(0)
+    {
+        Q_ASSERT(interval > 0);
+    }
+
+    bool LogRateLimiter::tryAcquire()
+    {
+        auto const now = QDateTime::currentMSecsSinceEpoch();
+
+        if (m_tokens < m_burst && now - m_lastRefill >= m_interval)
+        {
+            auto const refill = static_cast<quint64>((now - m_lastRefill) / m_interval);
+            m_tokens = static_cast<unsigned int>(std::min<quint64>(m_burst, m_tokens + refill));
+            m_lastRefill = now;
+        }
+
+        if (m_tokens == 0)
+        {
+            ++m_suppressed;
+            return false;
+        }
+
+        if (m_tokens == m_burst)
+            m_lastRefill = now;
+
+        --m_tokens;
+        return true;
+    }
+}
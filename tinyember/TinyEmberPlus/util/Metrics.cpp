@@ -0,0 +1,253 @@
+#include <algorithm>
+#include "Metrics.h"
+
+namespace util
+{
+    Histogram::Histogram()
+        : m_count(0)
+        , m_sum(0)
+    {
+        for (auto bucket = 0; bucket < BucketCount; bucket++)
+            m_buckets[bucket].store(0, std::memory_order_relaxed);
+    }
+
+    void Histogram::record(qint64 nanoseconds)
+    {
+        auto microseconds = nanoseconds / 1000;
+        auto bucket = 0;
+
+        while (microseconds > 0 && bucket < BucketCount - 1)
+        {
+            microseconds >>= 1;
+            bucket++;
+        }
+
+        m_buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+        m_count.fetch_add(1, std::memory_order_relaxed);
+        m_sum.fetch_add(nanoseconds > 0 ? static_cast<quint64>(nanoseconds) : 0, std::memory_order_relaxed);
+    }
+
+    //static
+    QByteArray MetricsWriter::label(char const* name, QString const& value)
+    {
+        auto const utf8 = value.toUtf8();
+        auto result = QByteArray(name);
+        result.append("=\"");
+
+        for (auto index = 0; index < utf8.size(); index++)
+        {
+            auto const ch = utf8[index];
+
+            if (ch == '\\')
+                result.append("\\\\");
+            else if (ch == '"')
+                result.append("\\\"");
+            else if (ch == '\n')
+                result.append("\\n");
+            else
+                result.append(ch);
+        }
+
+        result.append('"');
+        return result;
+    }
+
+    void MetricsWriter::writeCounter(QByteArray const& name, QByteArray const& help, QByteArray const& labels, quint64 value)
+    {
+        writeHeader(name, help, "counter");
+        writeSample(name, "", labels, QByteArray::number(value));
+    }
+
+    void MetricsWriter::writeGauge(QByteArray const& name, QByteArray const& help, QByteArray const& labels, qint64 value)
+    {
+        writeHeader(name, help, "gauge");
+        writeSample(name, "", labels, QByteArray::number(value));
+    }
+
+    void MetricsWriter::writeGauge(QByteArray const& name, QByteArray const& help, QByteArray const& labels, double value)
+    {
+        writeHeader(name, help, "gauge");
+        writeSample(name, "", labels, QByteArray::number(value, 'g', 9));
+    }
+
+    void MetricsWriter::writeHistogram(QByteArray const& name, QByteArray const& help, QByteArray const& labels, Histogram const& histogram)
+    {
+        auto const separator = labels.isEmpty() ? "" : ",";
+        auto cumulative = quint64(0);
+
+        writeHeader(name, help, "histogram");
+
+        for (auto bucket = 0; bucket < Histogram::BucketCount - 1; bucket++)
+        {
+            auto const bound = QByteArray::number(Histogram::upperBound(bucket) / 1e6, 'g', 6);
+
+            cumulative += histogram.count(bucket);
+            writeSample(name, "_bucket", labels + separator + "le=\"" + bound + "\"", QByteArray::number(cumulative));
+        }
+
+        // concurrent updates may not have reached the count yet, but +Inf must match it
+        auto const count = std::max(histogram.count(), cumulative + histogram.count(Histogram::BucketCount - 1));
+
+        writeSample(name, "_bucket", labels + separator + "le=\"+Inf\"", QByteArray::number(count));
+        writeSample(name, "_sum", labels, QByteArray::number(histogram.sum() / 1e9, 'g', 9));
+        writeSample(name, "_count", labels, QByteArray::number(count));
+    }
+
+    void MetricsWriter::writeHeader(QByteArray const& name, QByteArray const& help, char const* type)
+    {
+        if (name == m_metric)
+            return;
+
+        m_metric = name;
+        m_text.append("# HELP ").append(name).append(' ').append(help).append('\n');
+        m_text.append("# TYPE ").append(name).append(' ').append(type).append('\n');
+    }
+
+    void MetricsWriter::writeSample(QByteArray const& name, char const* suffix, QByteArray const& labels, QByteArray const& value)
+    {
+        m_text.append(name).append(suffix);
+
+        if (labels.isEmpty() == false)
+            m_text.append('{').append(labels).append('}');
+
+        m_text.append(' ').append(value).append('\n');
+    }
+
+    MetricsRegistry::MetricsRegistry()
+    {}
+
+    MetricsRegistry::~MetricsRegistry()
+    {
+        for each(auto const& entry in m_entries)
+        {
+            switch (entry.type)
+            {
+                case MetricType::Counter:
+                    delete static_cast<Counter*>(entry.metric);
+                    break;
+
+                case MetricType::Gauge:
+                    delete static_cast<Gauge*>(entry.metric);
+                    break;
+
+                case MetricType::Histogram:
+                    delete static_cast<Histogram*>(entry.metric);
+                    break;
+            }
+        }
+    }
+
+    Counter* MetricsRegistry::counter(QByteArray const& name, QByteArray const& help, QByteArray const& labels)
+    {
+        QMutexLocker const lock(&m_mutex);
+        auto result = static_cast<Counter*>(find(MetricType::Counter, name, labels));
+
+        if (result == nullptr)
+        {
+            result = new Counter();
+            insert(MetricType::Counter, name, help, labels, result);
+        }
+
+        return result;
+    }
+
+    Gauge* MetricsRegistry::gauge(QByteArray const& name, QByteArray const& help, QByteArray const& labels)
+    {
+        QMutexLocker const lock(&m_mutex);
+        auto result = static_cast<Gauge*>(find(MetricType::Gauge, name, labels));
+
+        if (result == nullptr)
+        {
+            result = new Gauge();
+            insert(MetricType::Gauge, name, help, labels, result);
+        }
+
+        return result;
+    }
+
+    Histogram* MetricsRegistry::histogram(QByteArray const& name, QByteArray const& help, QByteArray const& labels)
+    {
+        QMutexLocker const lock(&m_mutex);
+        auto result = static_cast<Histogram*>(find(MetricType::Histogram, name, labels));
+
+        if (result == nullptr)
+        {
+            result = new Histogram();
+            insert(MetricType::Histogram, name, help, labels, result);
+        }
+
+        return result;
+    }
+
+    void MetricsRegistry::addCollector(MetricsCollector* collector)
+    {
+        QMutexLocker const lock(&m_mutex);
+        m_collectors.push_back(collector);
+    }
+
+    void MetricsRegistry::removeCollector(MetricsCollector* collector)
+    {
+        QMutexLocker const lock(&m_mutex);
+        m_collectors.erase(std::remove(m_collectors.begin(), m_collectors.end(), collector), m_collectors.end());
+    }
+
+    QByteArray MetricsRegistry::exportText() const
+    {
+        auto writer = MetricsWriter();
+        QMutexLocker const lock(&m_mutex);
+
+        for each(auto const& entry in m_entries)
+        {
+            switch (entry.type)
+            {
+                case MetricType::Counter:
+                    writer.writeCounter(entry.name, entry.help, entry.labels, static_cast<Counter const*>(entry.metric)->value());
+                    break;
+
+                case MetricType::Gauge:
+                    writer.writeGauge(entry.name, entry.help, entry.labels, static_cast<Gauge const*>(entry.metric)->value());
+                    break;
+
+                case MetricType::Histogram:
+                    writer.writeHistogram(entry.name, entry.help, entry.labels, *static_cast<Histogram const*>(entry.metric));
+                    break;
+            }
+        }
+
+        for each(auto collector in m_collectors)
+            collector->collect(writer);
+
+        return writer.text();
+    }
+
+    void* MetricsRegistry::find(MetricType::_Domain type, QByteArray const& name, QByteArray const& labels) const
+    {
+        for each(auto const& entry in m_entries)
+        {
+            if (entry.type == type && entry.name == name && entry.labels == labels)
+                return entry.metric;
+        }
+
+        return nullptr;
+    }
+
+    void MetricsRegistry::insert(MetricType::_Domain type, QByteArray const& name, QByteArray const& help, QByteArray const& labels, void* metric)
+    {
+        auto entry = Entry();
+        entry.type = type;
+        entry.name = name;
+        entry.help = help;
+        entry.labels = labels;
+        entry.metric = metric;
+
+        // the samples of a metric have to be exported one after the other
+        auto position = m_entries.end();
+        for (auto it = m_entries.begin(); it != m_entries.end(); ++it)
+        {
+            if (it->name == name)
+                position = it + 1;
+        }
+
+        m_entries.insert(position, entry);
+    }
+}
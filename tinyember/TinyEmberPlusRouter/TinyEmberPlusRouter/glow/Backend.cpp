@@ -0,0 +1,245 @@
+#include <ember/glow/GlowNodeFactory.hpp>
+#include <s101\CommandType.hpp>
+#include <s101\KeepAlive.hpp>
+#include <s101\PackageFlag.hpp>
+#include <s101\MessageType.hpp>
+#include "Backend.h"
+#include "Dispatcher.h"
+#include "Encoder.h"
+
+namespace glow
+{
+   // ========================================================
+   //
+   // Backend::DomReader Definitions
+   //
+   // ========================================================
+
+   Backend::DomReader::DomReader(Backend* backend)
+      : libember::dom::AsyncDomReader(libember::glow::GlowNodeFactory::getFactory())
+      , m_backend(backend)
+   {}
+
+   void Backend::DomReader::rootReady(libember::dom::Node* root)
+   {
+      m_backend->rootReady(root);
+   }
+
+
+   // ========================================================
+   //
+   // Backend Definitions
+   //
+   // ========================================================
+
+   Backend::Backend(QTcpSocket* socket, Dispatcher* dispatcher, int number, QString const& host, quint16 port)
+      : TcpClient(socket)
+      , m_socket(socket)
+      , m_dispatcher(dispatcher)
+      , m_number(number)
+      , m_reader(this)
+      , m_request(nullptr)
+      , m_isMounted(false)
+   {
+      // the socket is deleted after the base class has closed it
+      socket->setParent(this);
+      socket->connectToHost(host, port);
+
+      // the answer reports the element owned by the backend and registers
+      // the interest of the front in it
+      new libember::glow::GlowCommand(request(), libember::glow::CommandType::GetDirectory);
+      flush();
+   }
+
+   Backend::~Backend()
+   {
+      delete m_request;
+   }
+
+   bool Backend::isAvailable() const
+   {
+      return m_socket->state() != QAbstractSocket::UnconnectedState;
+   }
+
+   void Backend::forwardCommand(libember::glow::GlowCommand const* glow, util::Oid const& path)
+   {
+      // the router walks commands by path only, so the type of the
+      // element containing the command does not matter
+      auto node = new libember::glow::GlowQualifiedNode(request(), path);
+      auto command = new libember::glow::GlowCommand(node, glow->number(), glow->dirFieldMask());
+      auto const invocation = glow->invocation();
+
+      if(invocation != nullptr)
+      {
+         auto arguments = util::VariantValueVector();
+         invocation->typedArguments(std::back_inserter(arguments));
+
+         auto glowInvocation = new libember::glow::GlowInvocation();
+         glowInvocation->setInvocationId(invocation->invocationId());
+         glowInvocation->setTypedArguments(arguments.begin(), arguments.end());
+         command->setInvocation(glowInvocation);
+      }
+   }
+
+   void Backend::forwardParameter(libember::glow::GlowParameterBase const* glow, util::Oid const& path)
+   {
+      if(glow->contains(libember::glow::ParameterProperty::Value) == false)
+         return;
+
+      auto glowValue = glow->value();
+      auto glowParam = new libember::glow::GlowQualifiedParameter(request(), path);
+
+      switch(glowValue.type().value())
+      {
+         case libember::glow::ParameterType::Integer:
+            glowParam->setValue(glowValue.toInteger());
+            break;
+
+         case libember::glow::ParameterType::Real:
+            glowParam->setValue(glowValue.toReal());
+            break;
+
+         case libember::glow::ParameterType::String:
+            glowParam->setValue(glowValue.toString());
+            break;
+
+         case libember::glow::ParameterType::Boolean:
+            glowParam->setValue(glowValue.toBoolean());
+            break;
+      }
+   }
+
+   void Backend::forwardMatrix(libember::glow::GlowMatrixBase const* glow, util::Oid const& path)
+   {
+      auto connections = glow->connections();
+
+      if(connections == nullptr)
+         return;
+
+      auto glowMatrix = new libember::glow::GlowQualifiedMatrix(request(), path);
+      auto glowConnections = glowMatrix->connections();
+
+      for each(libember::dom::Node const& ember in *connections)
+      {
+         auto connection = dynamic_cast<libember::glow::GlowConnection const*>(&ember);
+
+         if(connection != nullptr)
+         {
+            auto glowConnection = new libember::glow::GlowConnection(connection->target());
+            glowConnection->setSources(connection->sources());
+            glowConnection->setOperation(connection->operation());
+
+            glowConnections->insert(glowConnections->end(), glowConnection);
+         }
+      }
+   }
+
+   void Backend::flush()
+   {
+      if(m_request == nullptr)
+         return;
+
+      auto encoder = Encoder::createEmberMessage(m_request);
+
+      for each(auto packet in encoder)
+         write(packet.begin(), packet.end());
+
+      delete m_request;
+      m_request = nullptr;
+   }
+
+   libember::glow::GlowRootElementCollection* Backend::request()
+   {
+      if(m_request == nullptr)
+         m_request = libember::glow::GlowRootElementCollection::create();
+
+      return m_request;
+   }
+
+   void Backend::read(const_iterator first, const_iterator last, size_type size)
+   {
+      Q_UNUSED(size);
+
+      m_frames.clear();
+      m_decoder.readBatch(first, last, m_frames);
+
+      for(Decoder::size_type index = 0; index < m_frames.size(); ++index)
+         handleS101Message(m_frames.begin(index), m_frames.end(index));
+   }
+
+   void Backend::handleS101Message(Decoder::const_iterator first, Decoder::const_iterator last)
+   {
+      if(libs101::KeepAlive::isRequest(first, last))
+      {
+         static auto const response = QByteArray::fromRawData(reinterpret_cast<char const*>(libs101::KeepAlive::responseBegin()), libs101::KeepAlive::ResponseSize);
+         write(response);
+         return;
+      }
+
+      first++;                                                   // Slot
+      auto const message = *first++;                             // Message
+
+      if(message == libs101::MessageType::EmBER)
+      {
+         auto const command = *first++;                          // Command
+         first++;                                                // Version
+         auto const flags = libs101::PackageFlag(*first++);      // Flags
+         first++;                                                // DTD
+
+         if(command == libs101::CommandType::EmBER)
+         {
+            auto appbytes = *first++;   // 1 Byte AppBytesCount
+            while(appbytes-- > 0)
+               first++;
+
+            if(flags.value() & libs101::PackageFlag::FirstPackage)
+               m_reader.reset();
+
+            // malformed input is reported once, the reader ignores the rest
+            // of the message until it is reset by the next first package
+            if(first != last && m_reader.status() == DomReader::ReadStatus::Ok)
+            {
+               auto const status = m_reader.tryRead(&*first, &*first + std::distance(first, last));
+
+               if(status != DomReader::ReadStatus::Ok)
+                  LOG_ERROR_LIMITED(m_errorLog, "Backend " << m_number << ": " << DomReader::describe(status));
+            }
+         }
+      }
+   }
+
+   void Backend::rootReady(libember::dom::Node* root)
+   {
+      m_reader.detachRoot();
+
+      auto glow = dynamic_cast<libember::glow::GlowContainer*>(root);
+
+      if(glow != nullptr)
+      {
+         auto const path = util::Oid(m_number);
+
+         for(auto it = glow->childBegin(); it != glow->childEnd(); ++it)
+         {
+            auto node = dynamic_cast<libember::glow::GlowQualifiedNode const*>(&*it);
+
+            if(node != nullptr && node->path() == path)
+            {
+               auto const identifier = node->peekIdentifier();
+               auto const description = node->peekDescription();
+
+               if(identifier != nullptr)
+                  m_identifier = *identifier;
+
+               if(description != nullptr)
+                  m_description = *description;
+
+               m_isMounted = true;
+            }
+         }
+
+         m_dispatcher->receiveBackendGlow(glow, this);
+      }
+
+      delete root;
+   }
+}
@@ -0,0 +1,183 @@
+#ifndef __TINYEMBERROUTER_GLOW_BACKEND_H
+#define __TINYEMBERROUTER_GLOW_BACKEND_H
+
+#include <string>
+#include <ember/dom/AsyncDomReader.hpp>
+#include <ember/glow/GlowContainer.hpp>
+#include <s101/StreamDecoder.hpp>
+#include "../net/TcpClient.h"
+#include "../util/Log.h"
+#include "../util/Types.h"
+
+namespace glow
+{
+   class Dispatcher;
+
+   /**
+     * The connection of a front dispatcher to a backend router, which owns the
+     * subtree below one element of the root. The backend is a router process of
+     * its own, so several backends share the routing load of a plant while
+     * consumers see a single tree. Requests addressing the subtree are forwarded
+     * unchanged, since the backend reports its elements with the same paths.
+     * Everything the backend sends is passed to the dispatcher, which forwards
+     * it to the interested consumers.
+     * All methods must be called by the thread owning the DOM.
+     */
+   class Backend : public net::TcpClient
+   {
+      /**
+        * Implementation of an async DomReader which forwards decoded ember trees
+        * to the backend.
+        */
+      class DomReader : public libember::dom::AsyncDomReader
+      {
+      public:
+         /**
+           * Initializes a new DomReader.
+           * @param backend The backend to notify when a new tree has been decoded.
+           */
+         explicit DomReader(Backend* backend);
+
+      private:
+         /**
+           * This method is invoked by the base class when a tree has been decoded.
+           * This override forwards the root node to the backend.
+           * @param root The decoded root node.
+           */
+         virtual void rootReady(libember::dom::Node* root);
+
+      private:
+         Backend *const m_backend;
+      };
+
+      typedef libs101::StreamDecoder<unsigned char> Decoder;
+
+   public:
+      /**
+        * Creates a new instance of Backend, connects @p socket to the backend
+        * and queries the element owned by the backend.
+        * @param socket The unconnected socket to use. The backend takes ownership.
+        * @param dispatcher The front dispatcher to pass the received trees to.
+        * @param number The number of the root element owned by the backend.
+        * @param host The host name or address of the backend.
+        * @param port The port the backend listens on.
+        */
+      Backend(QTcpSocket* socket, Dispatcher* dispatcher, int number, QString const& host, quint16 port);
+
+      /** Destructor */
+      virtual ~Backend();
+
+      /**
+        * Returns the number of the root element owned by this backend.
+        * @return The number of the root element owned by this backend.
+        */
+      inline int number() const { return m_number; }
+
+      /**
+        * Tests whether this backend owns the element at @p path.
+        * @param path The path to test.
+        * @return True if @p path lies within the subtree of this backend.
+        */
+      inline bool owns(util::Oid const& path) const { return path.empty() == false && *path.begin() == m_number; }
+
+      /**
+        * Tests whether requests can be forwarded to the backend. Requests
+        * written while the connection is being established are buffered.
+        * @return False if the connection has failed or has been closed.
+        */
+      bool isAvailable() const;
+
+      /**
+        * Tests whether the backend has reported the element it owns, which
+        * is the case once it has answered the initial query.
+        * @return True if the element owned by the backend is known.
+        */
+      inline bool isMounted() const { return m_isMounted; }
+
+      /**
+        * Returns the identifier of the element owned by the backend.
+        * @return The identifier of the element owned by the backend.
+        */
+      inline std::string const& identifier() const { return m_identifier; }
+
+      /**
+        * Returns the description of the element owned by the backend.
+        * @return The description of the element owned by the backend.
+        */
+      inline std::string const& description() const { return m_description; }
+
+      /**
+        * Appends a command to the pending request.
+        * @param glow The command to forward.
+        * @param path The path of the element the command addresses.
+        */
+      void forwardCommand(libember::glow::GlowCommand const* glow, util::Oid const& path);
+
+      /**
+        * Appends a parameter value to the pending request.
+        * @param glow The parameter to forward.
+        * @param path The path of the parameter.
+        */
+      void forwardParameter(libember::glow::GlowParameterBase const* glow, util::Oid const& path);
+
+      /**
+        * Appends matrix connects to the pending request.
+        * @param glow The matrix to forward.
+        * @param path The path of the matrix.
+        */
+      void forwardMatrix(libember::glow::GlowMatrixBase const* glow, util::Oid const& path);
+
+      /**
+        * Writes the pending request to the backend in a single message,
+        * if anything has been forwarded since the last call.
+        */
+      void flush();
+
+   private:
+      /**
+        * This method is called by the TcpClient when several bytes have been received. All bytes are
+        * forwarded to the s101 decoder.
+        * @param first Reference to the first byte that has been received.
+        * @param last Points the the first element beyond the rx buffer.
+        * @param size The number of bytes that have been received.
+        */
+      virtual void read(const_iterator first, const_iterator last, size_type size);
+
+      /**
+        * This method is called when a s101 message has been decoded.
+        * @param first Reference to the first byte of the decoded s101 message.
+        * @param last Points the the first element beyond the s101 message buffer.
+        */
+      void handleS101Message(Decoder::const_iterator first, Decoder::const_iterator last);
+
+      /**
+        * This method is called by the DomReader when a tree has been decoded.
+        * Records the element owned by the backend when it is reported and
+        * passes the tree to the dispatcher.
+        * @param root The decoded tree.
+        */
+      void rootReady(libember::dom::Node* root);
+
+      /**
+        * Returns the pending request, creating it if nothing has been
+        * forwarded since the last flush.
+        * @return The pending request.
+        */
+      libember::glow::GlowRootElementCollection* request();
+
+   private:
+      QTcpSocket* m_socket;
+      Dispatcher* m_dispatcher;
+      int m_number;
+      DomReader m_reader;
+      Decoder m_decoder;
+      Decoder::FrameBatch m_frames;
+      libember::glow::GlowRootElementCollection* m_request;
+      bool m_isMounted;
+      std::string m_identifier;
+      std::string m_description;
+      util::LogRateLimiter m_errorLog;
+   };
+}
+
+#endif//__TINYEMBERROUTER_GLOW_BACKEND_H
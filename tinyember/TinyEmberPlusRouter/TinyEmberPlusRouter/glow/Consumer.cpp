@@ -1,10 +1,9 @@
-#include <iostream>
 #include <QtCore>
 #include <ember/glow/GlowNodeFactory.hpp>
 #include <s101\CommandType.hpp>
 #include <s101\Dtd.hpp>
+#include <s101\KeepAlive.hpp>
 #include <s101\PackageFlag.hpp>
-#include <s101\StreamEncoder.hpp>
 #include <s101\MessageType.hpp>
 #include "Dispatcher.h"
 #include "Encoder.h"
@@ -32,6 +31,18 @@ namespace glow
       m_consumer->rootReady(root);
    }
 
+   void Consumer::DomReader::containerReady()
+   {
+      util::LatencyScope const scope(m_consumer->m_trace, util::LatencyStage::DomAssembly);
+      libember::dom::AsyncDomReader::containerReady();
+   }
+
+   void Consumer::DomReader::itemReady()
+   {
+      util::LatencyScope const scope(m_consumer->m_trace, util::LatencyStage::DomAssembly);
+      libember::dom::AsyncDomReader::itemReady();
+   }
+
 
    // ========================================================
    //
@@ -43,24 +54,87 @@ namespace glow
       : TcpClient(socket)
       , m_dispatcher(dispatcher)
       , m_reader(this)
+      , m_pendingRequests(0)
+      , m_pendingGlow(nullptr)
+      , m_trace(nullptr)
    {}
 
+   Consumer::~Consumer()
+   {
+      delete m_pendingGlow;
+      delete m_trace;
+   }
+
    void Consumer::writeGlow(libember::glow::GlowContainer const* glow)
    {
+      util::LatencyScope const scope(m_dispatcher->m_trace, util::LatencyStage::Encode);
       auto encoder = Encoder::createEmberMessage(glow);
 
+      if(m_dispatcher->m_metrics != nullptr)
+         m_dispatcher->m_metrics->countSent(glow);
+
       for each(auto packet in encoder)
          write(packet.begin(), packet.end());
    }
 
+   void Consumer::writeGlow(libember::glow::GlowWriter const& writer)
+   {
+      util::LatencyScope const scope(m_dispatcher->m_trace, util::LatencyStage::Encode);
+      auto encoder = Encoder::createEmberMessage(writer);
+
+      if(m_dispatcher->m_metrics != nullptr)
+         m_dispatcher->m_metrics->countSentResponse();
+
+      for each(auto packet in encoder)
+         write(packet.begin(), packet.end());
+   }
+
+   void Consumer::addInterest(util::Oid const& path)
+   {
+      QMutexLocker const lock(&m_interestsMutex);
+      m_interests.insert(path);
+   }
+
+   bool Consumer::isInterestedIn(util::Oid const& path) const
+   {
+      QMutexLocker const lock(&m_interestsMutex);
+      return m_interests.containsAncestorOf(path, 1);
+   }
+
+   void Consumer::completeRequest()
+   {
+      m_pendingRequests.deref();
+   }
+
    void Consumer::read(const_iterator first, const_iterator last, size_type size)
    {
-      std::cout << "received " << size << " bytes" << std::endl;
-      m_decoder.read(first, last, Consumer::onS101Message, this);
+      LOG_DEBUG(peerName() << ": received " << size << " bytes");
+
+      // Decode all frames contained in the received chunk before dispatching
+      // them, so that the decoder is not re-entered for each frame.
+      beginTrace();
+
+      {
+         util::LatencyScope const scope(m_trace, util::LatencyStage::Deframe);
+         m_frames.clear();
+         m_decoder.readBatch(first, last, m_frames);
+      }
+
+      for(Decoder::size_type index = 0; index < m_frames.size(); ++index)
+         handleS101Message(m_frames.begin(index), m_frames.end(index));
    }
 
    void Consumer::handleS101Message(Decoder::const_iterator first, Decoder::const_iterator last)
    {
+      // Keep-alive requests are answered with a constant frame before the
+      // message is interpreted any further.
+      if(libs101::KeepAlive::isRequest(first, last))
+      {
+         static auto const response = QByteArray::fromRawData(reinterpret_cast<char const*>(libs101::KeepAlive::responseBegin()), libs101::KeepAlive::ResponseSize);
+         write(response);
+         return;
+      }
+
       first++;                                                   // Slot
       auto const message = *first++;                             // Message
 
@@ -80,24 +154,31 @@ namespace glow
             if(flags.value() & libs101::PackageFlag::FirstPackage)
                m_reader.reset();
 
-            try
-            {
-               m_reader.read(first, last);
-            }
-            catch(std::runtime_error ex)
+            beginTrace();
+
             {
-               std::cerr << ex.what();
+               // The time spent in the reader is BER decoding, except for the
+               // part the DomReader records as DOM assembly.
+               auto const assembly = m_trace != nullptr ? m_trace->duration(util::LatencyStage::DomAssembly) : 0;
+               util::LatencyScope const scope(m_trace, util::LatencyStage::BerDecode);
+
+               // Pass the payload as a contiguous buffer so that the reader can
+               // consume complete headers and values at once. Malformed input is
+               // reported once, the reader ignores the rest of the message until
+               // it is reset by the next first package.
+               if(first != last && m_reader.status() == DomReader::ReadStatus::Ok)
+               {
+                  auto const status = m_reader.tryRead(&*first, &*first + std::distance(first, last));
+
+                  if(status != DomReader::ReadStatus::Ok)
+                     LOG_ERROR_LIMITED(m_errorLog, peerName() << ": " << DomReader::describe(status));
+               }
+
+               if(m_trace != nullptr)
+                  m_trace->add(util::LatencyStage::BerDecode, assembly - m_trace->duration(util::LatencyStage::DomAssembly));
             }
-         }
-         else if(command == libs101::CommandType::KeepAliveRequest)
-         {
-            auto encoder = libs101::StreamEncoder<unsigned char>();
-            encoder.encode(0x00);                                       // Slot
-            encoder.encode(libs101::MessageType::EmBER);                // Message Type
-            encoder.encode(libs101::CommandType::KeepAliveResponse);    // Command
-            encoder.encode(0x01);                                       // Framing Version (1)
-            encoder.finish();
-            write(encoder.begin(), encoder.end());
+
+            postPendingGlow();
          }
       }
    }
@@ -108,10 +189,50 @@ namespace glow
 
       auto glow = dynamic_cast<libember::glow::GlowContainer*>(root);
 
+      // The tree is decoded within the consumer's thread, the dispatcher
+      // applies it within the thread owning the DOM. It is posted when the
+      // reader has returned, so the trace is complete.
       if(glow != nullptr)
       {
-         std::cout << "Received Glow" << std::endl;
-         m_dispatcher->receiveGlow(glow, this);
+         LOG_DEBUG(peerName() << ": received glow");
+         delete m_pendingGlow;
+         m_pendingGlow = glow;
+      }
+      else
+      {
+         delete root;
+      }
+   }
+
+   void Consumer::beginTrace()
+   {
+      if(m_trace == nullptr && m_dispatcher->isTracing())
+         m_trace = new util::LatencyTrace();
+   }
+
+   void Consumer::postPendingGlow()
+   {
+      if(m_pendingGlow != nullptr)
+      {
+         if(m_dispatcher->m_metrics != nullptr)
+            m_dispatcher->m_metrics->countReceived(m_pendingGlow);
+
+         // GetDirectory commands on matrices are answered from the connection
+         // snapshots within this thread, unless the responses to requests that
+         // are still waiting for the DOM thread have to be written first.
+         if(m_pendingRequests == 0 && m_dispatcher->writeSnapshotResponse(m_pendingGlow, this))
+         {
+            delete m_pendingGlow;
+            delete m_trace;
+            m_pendingGlow = nullptr;
+            m_trace = nullptr;
+            return;
+         }
+
+         m_pendingRequests.ref();
+         m_dispatcher->postGlow(m_pendingGlow, this, m_trace);
+         m_pendingGlow = nullptr;
+         m_trace = nullptr;
       }
    }
 
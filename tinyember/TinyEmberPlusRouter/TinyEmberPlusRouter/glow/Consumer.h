@@ -4,7 +4,13 @@
 #include <ember/dom/AsyncDomReader.hpp>
 #include <ember/glow/GlowContainer.hpp>
 #include <s101/StreamDecoder.hpp>
+#include <QtCore/QAtomicInt>
+#include <QtCore/QMutex>
 #include "../net/TcpClient.h"
+#include "Encoder.h"
+#include "../util/LatencyTrace.h"
+#include "../util/Log.h"
+#include "../util/PathTrie.h"
 
 namespace glow
 {
@@ -38,6 +44,18 @@ namespace glow
            */
          virtual void rootReady(libember::dom::Node* root);
 
+         /**
+           * Overridden to add the time spent assembling the tree to the
+           * trace of the current request.
+           */
+         virtual void containerReady();
+
+         /**
+           * Overridden to add the time spent assembling the tree to the
+           * trace of the current request.
+           */
+         virtual void itemReady();
+
       private:
          Consumer *const m_consumer;
       };
@@ -47,6 +65,9 @@ namespace glow
    public:
       explicit Consumer(QTcpSocket* socket, Dispatcher* dispatcher);
 
+      /** Destructor */
+      virtual ~Consumer();
+
       /**
         * Encode the passed Glow tree and write the encoded EmBER
         * to the remote consumer.
@@ -54,6 +75,49 @@ namespace glow
         */
       void writeGlow(libember::glow::GlowContainer const* glow);
 
+      /**
+        * Write the message encoded by @p writer to the remote consumer.
+        * @param writer The writer containing a complete message.
+        */
+      void writeGlow(libember::glow::GlowWriter const& writer);
+
+      /**
+        * Records that the remote consumer has queried or subscribed to the
+        * element at @p path, so that it receives notifications about the
+        * element and its children.
+        * @param path The path of the queried element.
+        */
+      void addInterest(util::Oid const& path);
+
+      /**
+        * Tests whether the remote consumer has queried the element at
+        * @p path or its parent, and thus needs to be notified when the
+        * element changes.
+        * @param path The path of the element that changed.
+        * @return True if the consumer needs to be notified.
+        */
+      bool isInterestedIn(util::Oid const& path) const;
+
+      /**
+        * Writes a response that has been encoded from connection snapshots
+        * within the consumer's thread, if @p isCurrent returns true. The test
+        * and the write are atomic with respect to isInterestedIn, so that the
+        * notification about a change published after the test is always
+        * written after the response.
+        * @param encoder The encoded response.
+        * @param isCurrent A predicate which returns true if the snapshots the
+        *     response has been encoded from are still current.
+        * @return True if the response has been written.
+        */
+      template<typename Predicate>
+      bool writeSnapshot(Encoder const& encoder, Predicate isCurrent);
+
+      /**
+        * Called by the dispatcher when it has applied a request posted by
+        * this consumer, within the thread owning the DOM.
+        */
+      void completeRequest();
+
    private:
       /**
          * This method is called by the TcpClient when several bytes have been received. All bytes are
@@ -77,6 +141,18 @@ namespace glow
         */
       void handleS101Message(Decoder::const_iterator first, Decoder::const_iterator last);
 
+      /**
+        * Creates the trace of the next request, if the dispatcher traces
+        * requests and no trace exists yet.
+        */
+      void beginTrace();
+
+      /**
+        * Passes the tree decoded by the last call to handleS101Message to
+        * the dispatcher, together with its trace.
+        */
+      void postPendingGlow();
+
       /**
         * Static callback for the s101 decoder.
         * @param first Reference to the first byte that has been received.
@@ -89,7 +165,40 @@ namespace glow
       Dispatcher* m_dispatcher;
       DomReader m_reader;
       Decoder m_decoder;
+      Decoder::FrameBatch m_frames;
+      util::PathTrie m_interests;
+      mutable QMutex m_interestsMutex;
+      QAtomicInt m_pendingRequests;
+      libember::glow::GlowContainer* m_pendingGlow;
+      util::LatencyTrace* m_trace;
+      util::LogRateLimiter m_errorLog;
    };
+
+
+   // ========================================================
+   //
+   // Inline Implementation
+   //
+   // ========================================================
+
+   template<typename Predicate>
+   inline bool Consumer::writeSnapshot(Encoder const& encoder, Predicate isCurrent)
+   {
+      auto array = QByteArray();
+      auto const last = encoder.end();
+
+      for(auto packet = encoder.begin(); packet != last; ++packet)
+         array.append(reinterpret_cast<char const*>(&*packet->begin()), static_cast<int>(packet->size()));
+
+      QMutexLocker const lock(&m_interestsMutex);
+
+      if(isCurrent() == false)
+         return false;
+
+      // queued behind the notifications the DOM thread has written before
+      post(array);
+      return true;
+   }
 }
 
 #endif//__TINYEMBERROUTER_GLOW_CONSUMER_H
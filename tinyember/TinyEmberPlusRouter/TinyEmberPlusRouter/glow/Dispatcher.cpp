@@ -1,10 +1,116 @@
+#include <algorithm>
+#include <iterator>
 #include "../model/model.h"
+#include "Backend.h"
 #include "Consumer.h"
 #include "Encoder.h"
 #include "Dispatcher.h"
+#include "../util/Log.h"
 
 namespace glow
 {
+   namespace
+   {
+      /**
+        * Predicate which accepts the consumers that need to be notified
+        * when the element at the specified path changes.
+        */
+      class InterestFilter
+      {
+      public:
+         explicit InterestFilter(util::Oid const& path)
+            : m_path(path)
+         {}
+
+         bool operator()(net::TcpClient const* client) const
+         {
+            return static_cast<Consumer const*>(client)->isInterestedIn(m_path);
+         }
+
+      private:
+         util::Oid const& m_path;
+      };
+
+      /**
+        * Predicate which accepts the consumers that need to receive a tree
+        * forwarded from a backend.
+        */
+      class BackendFilter
+      {
+      public:
+         BackendFilter(std::vector<util::Oid> const& paths, bool acceptAll)
+            : m_paths(paths)
+            , m_acceptAll(acceptAll)
+         {}
+
+         bool operator()(net::TcpClient const* client) const
+         {
+            if(m_acceptAll)
+               return true;
+
+            auto const consumer = static_cast<Consumer const*>(client);
+
+            for each(auto const& path in m_paths)
+            {
+               if(consumer->isInterestedIn(path))
+                  return true;
+            }
+
+            return false;
+         }
+
+      private:
+         std::vector<util::Oid> const& m_paths;
+         bool m_acceptAll;
+      };
+
+      /**
+        * Predicate which tests whether the connection snapshots a response
+        * has been encoded from are still current.
+        */
+      class SnapshotValidator
+      {
+      public:
+         typedef std::vector<model::matrix::Matrix*> MatrixVector;
+         typedef std::vector<model::matrix::ConnectionSnapshot::Pointer> SnapshotVector;
+
+      public:
+         SnapshotValidator(MatrixVector const& matrices, SnapshotVector const& snapshots)
+            : m_matrices(matrices)
+            , m_snapshots(snapshots)
+         {}
+
+         bool operator()() const
+         {
+            for(auto index = MatrixVector::size_type(0); index < m_matrices.size(); index++)
+            {
+               if(m_matrices[index]->isCurrent(m_snapshots[index]) == false)
+                  return false;
+            }
+
+            return true;
+         }
+
+      private:
+         MatrixVector const& m_matrices;
+         SnapshotVector const& m_snapshots;
+      };
+
+      /**
+        * Appends the encoding of a Glow object to the collection that is
+        * currently open in @p writer.
+        */
+      void writeEncoded(libember::glow::GlowWriter& writer, libember::dom::Node const& glow)
+      {
+         auto stream = libember::util::OctetStream();
+         glow.encode(stream);
+
+         auto const bytes = std::vector<unsigned char>(stream.begin(), stream.end());
+         writer.encoded(bytes.data(), bytes.data() + bytes.size());
+      }
+   }
+
+
    // ========================================================
    //
    // Dispatcher::Walker Definitions
@@ -14,51 +120,136 @@ namespace glow
    Dispatcher::GlowWalker::GlowWalker(Dispatcher* dispatcher, Consumer* source)
       : m_dispatcher(dispatcher)
       , m_source(source)
+      , m_response(nullptr)
    {}
 
    void Dispatcher::GlowWalker::handleCommand(libember::glow::GlowCommand const* glow, libember::ber::ObjectIdentifier const& path)
    {
+      if(glow->number().value() == libember::glow::CommandType::GetChangesSince)
+      {
+         m_dispatcher->writeChangesSince(glow->sequence(), m_source);
+         return;
+      }
+
+      auto const isRecursive = glow->number().value() == libember::glow::CommandType::GetDirectoryRecursive;
+
+      // notifications are only sent to consumers that have queried the changed element
+      if(glow->number().value() == libember::glow::CommandType::GetDirectory
+      || glow->number().value() == libember::glow::CommandType::Subscribe
+      || isRecursive)
+         m_source->addInterest(path);
+
+      auto const backend = m_dispatcher->findBackend(path);
+
+      // the answer of the backend is forwarded due to the interest registered above
+      if(backend != nullptr)
+      {
+         backend->forwardCommand(glow, path);
+         return;
+      }
+
+      auto index = -1;
+      auto isGainParameter = false;
+      auto matrix = m_dispatcher->findCrosspoint(path, index, isGainParameter);
+
+      // crosspoints of dynamic matrices are converted directly from the gain array
+      if(matrix != nullptr)
+      {
+         if(glow->number().value() == libember::glow::CommandType::GetDirectory || isRecursive)
+         {
+            auto gainPath = std::vector<int>(path.begin(), path.end());
+
+            if(isGainParameter == false)
+               gainPath.insert(gainPath.end(), matrix->gainParameterNumber());
+
+            auto writer = libember::glow::GlowWriter();
+            writer.beginRoot();
+            m_dispatcher->writeCrosspointGain(writer, matrix, util::Oid(gainPath.begin(), gainPath.end()), index, glow->dirFieldMask().value());
+            writer.endRoot();
+
+            m_source->writeGlow(writer);
+         }
+
+         return;
+      }
+
       auto lookup = model::Element::Lookup(m_dispatcher->m_root, path);
       auto parent = lookup.result();
 
       if(parent != nullptr)
       {
-         if(glow->number().value() == libember::glow::CommandType::GetDirectory)
+         if(glow->number().value() == libember::glow::CommandType::GetDirectory || isRecursive)
          {
-            auto glowRoot = libember::glow::GlowRootElementCollection::create();
+            auto const key = DirectoryKey(path, glow->dirFieldMask().value(), isRecursive);
+            auto const cached = m_dispatcher->m_directoryResponses.find(key);
+
+            // an identical request that is still queued has already been answered
+            if(cached != m_dispatcher->m_directoryResponses.end())
+            {
+               for each(auto const& interest in cached->second.interests)
+                  m_source->addInterest(interest);
+
+               for each(auto const& message in cached->second.messages)
+               {
+                  if(m_dispatcher->m_metrics != nullptr)
+                     m_dispatcher->m_metrics->countSentResponse();
+
+                  m_source->write(message);
+               }
+
+               return;
+            }
+
+            m_response = &m_dispatcher->m_directoryResponses[key];
+
+            auto writer = libember::glow::GlowWriter();
+            writer.beginRoot();
 
             if(dynamic_cast<model::ParameterBase*>(parent) != nullptr
             || dynamic_cast<model::Function*>(parent) != nullptr)
             {
-               auto glowElement = m_dispatcher->elementToGlow(parent, glow->dirFieldMask().value(), false);
-               glowRoot->insert(glowRoot->end(), glowElement);
+               m_dispatcher->writeElement(writer, parent, glow->dirFieldMask().value(), false);
             }
             else if(dynamic_cast<model::matrix::Matrix*>(parent) != nullptr)
             {
-               auto glowElement = m_dispatcher->elementToGlow(parent, glow->dirFieldMask().value(), true);
-               glowRoot->insert(glowRoot->end(), glowElement);
+               m_dispatcher->writeElement(writer, parent, glow->dirFieldMask().value(), true);
             }
             else if(dynamic_cast<model::Node*>(parent) != nullptr)
             {
+               auto const isMountPoint = parent == m_dispatcher->m_root && m_dispatcher->m_backends.empty() == false;
+
+               // the elements of the backends are listed before the local ones
+               if(isMountPoint)
+                  writeBackends(glow, writer);
+
                if(parent->empty())
                {
-                  glowRoot->insert(glowRoot->end(), new libember::glow::GlowQualifiedNode(parent->path())); // empty node
+                  if(isMountPoint == false)
+                  {
+                     // empty node
+                     writer.beginNode(parent->path());
+                     writer.endNode();
+                  }
+               }
+               else if(isRecursive)
+               {
+                  writeDescendants(parent, glow->dirFieldMask().value(), writer);
                }
                else
                {
                   for each(auto child in *parent)
-                  {
-                     auto glowElement = m_dispatcher->elementToGlow(child, glow->dirFieldMask().value(), false);
-                     glowRoot->insert(glowRoot->end(), glowElement);
-                  }
+                     m_dispatcher->writeElement(writer, child, glow->dirFieldMask().value(), false);
                }
             }
 
-            m_source->writeGlow(glowRoot);
-            delete glowRoot;
+            writeDirectory(writer);
+            m_response = nullptr;
          }
          else if(glow->number().value() == libember::glow::CommandType::Invoke)
          {
+            // a function may change the DOM without notifying the dispatcher
+            m_dispatcher->invalidateDirectoryResponses();
+
             auto const function = dynamic_cast<model::Function*>(parent);
             auto const invocation = glow->invocation();
 
@@ -69,28 +260,142 @@ namespace glow
                auto argumentValues = util::VariantValueVector();
                invocation->typedArguments(std::back_inserter(argumentValues));
 
-               auto result = util::VariantValueVector();
-               auto success = function->invoke(argumentValues.begin(), argumentValues.end(), result);
-
-               if(invocationId >= 0)
+               if(function->isConcurrent())
+               {
+                  m_dispatcher->invokeConcurrently(function, argumentValues, invocationId, m_source);
+               }
+               else
                {
-                  auto invocationResult = libember::glow::GlowInvocationResult();
-                  invocationResult.setInvocationId(invocationId);
+                  auto result = util::VariantValueVector();
+                  auto success = function->invoke(argumentValues.begin(), argumentValues.end(), result);
 
-                  if(success)
-                     invocationResult.setTypedResult(result.begin(), result.end());
-                  else
-                     invocationResult.setSuccess(false);
+                  if(invocationId >= 0)
+                  {
+                     auto invocationResult = libember::glow::GlowInvocationResult();
+                     invocationResult.setInvocationId(invocationId);
+
+                     if(success)
+                        invocationResult.setTypedResult(result.begin(), result.end());
+                     else
+                        invocationResult.setSuccess(false);
 
-                  m_source->writeGlow(&invocationResult);
+                     m_source->writeGlow(&invocationResult);
+                  }
                }
             }
          }
       }
    }
 
+   void Dispatcher::GlowWalker::writeDescendants(model::Element* parent, int dirFieldMask, libember::glow::GlowWriter& writer)
+   {
+      for each(auto child in *parent)
+      {
+         if(writer.size() >= DirectoryChunkSize)
+         {
+            writeDirectory(writer);
+            writer.clear();
+            writer.beginRoot();
+         }
+
+         // matrices are reported completely, since their contents are not stored as children
+         auto const isMatrix = dynamic_cast<model::matrix::Matrix*>(child) != nullptr;
+         m_dispatcher->writeElement(writer, child, dirFieldMask, isMatrix);
+
+         if(dynamic_cast<model::Node*>(child) != nullptr)
+         {
+            addInterest(child->path());
+            writeDescendants(child, dirFieldMask, writer);
+         }
+      }
+   }
+
+   void Dispatcher::GlowWalker::writeDirectory(libember::glow::GlowWriter& writer)
+   {
+      auto message = QByteArray();
+
+      writer.endRoot();
+
+      {
+         util::LatencyScope const scope(m_dispatcher->m_trace, util::LatencyStage::Encode);
+         auto const encoder = Encoder::createEmberMessage(writer);
+
+         for each(auto const& packet in encoder)
+            message.append(reinterpret_cast<char const*>(&*packet.begin()), static_cast<int>(packet.size()));
+      }
+
+      if(m_response != nullptr)
+         m_response->messages.push_back(message);
+
+      if(m_dispatcher->m_metrics != nullptr)
+         m_dispatcher->m_metrics->countSentResponse();
+
+      m_source->write(message);
+   }
+
+   void Dispatcher::GlowWalker::addInterest(util::Oid const& path)
+   {
+      if(m_response != nullptr)
+         m_response->interests.push_back(path);
+
+      m_source->addInterest(path);
+   }
+
+   void Dispatcher::GlowWalker::writeBackends(libember::glow::GlowCommand const* glow, libember::glow::GlowWriter& writer)
+   {
+      auto const isRecursive = glow->number().value() == libember::glow::CommandType::GetDirectoryRecursive;
+
+      for each(auto backend in m_dispatcher->m_backends)
+      {
+         if(backend->isMounted() == false || backend->isAvailable() == false)
+            continue;
+
+         auto const path = util::Oid(backend->number());
+         writer.beginNode(path);
+         writer.identifier(backend->identifier());
+
+         if(backend->description().empty() == false)
+            writer.description(backend->description());
+
+         writer.endNode();
+
+         if(isRecursive)
+         {
+            addInterest(path);
+            backend->forwardCommand(glow, path);
+         }
+      }
+   }
+
    void Dispatcher::GlowWalker::handleParameter(libember::glow::GlowParameterBase const* glow, libember::ber::ObjectIdentifier const& path)
    {
+      auto const backend = m_dispatcher->findBackend(path);
+
+      if(backend != nullptr)
+      {
+         backend->forwardParameter(glow, path);
+         return;
+      }
+
+      m_dispatcher->invalidateDirectoryResponses();
+
+      auto index = -1;
+      auto isGainParameter = false;
+      auto matrix = m_dispatcher->findCrosspoint(path, index, isGainParameter);
+
+      if(matrix != nullptr)
+      {
+         if(isGainParameter && glow->contains(libember::glow::ParameterProperty::Value))
+         {
+            auto glowValue = glow->value();
+
+            if(glowValue.type().value() == libember::glow::ParameterType::Integer)
+               matrix->setCrosspointGain(path, index, glowValue.toInteger());
+         }
+
+         return;
+      }
+
       auto lookup = model::Element::Lookup(m_dispatcher->m_root, path);
       auto parent = lookup.result();
 
@@ -128,6 +433,16 @@ namespace glow
 
    void Dispatcher::GlowWalker::handleMatrix(libember::glow::GlowMatrixBase const* glow, libember::ber::ObjectIdentifier const& path)
    {
+      auto const backend = m_dispatcher->findBackend(path);
+
+      if(backend != nullptr)
+      {
+         backend->forwardMatrix(glow, path);
+         return;
+      }
+
+      m_dispatcher->invalidateDirectoryResponses();
+
       auto lookup = model::Element::Lookup(m_dispatcher->m_root, path);
       auto parent = lookup.result();
 
@@ -141,6 +456,8 @@ namespace glow
 
             if(connections != nullptr)
             {
+               auto salvo = model::matrix::Matrix::Salvo();
+
                for each(libember::dom::Node const& ember in *connections)
                {
                   auto connection = dynamic_cast<libember::glow::GlowConnection const*>(&ember);
@@ -162,10 +479,14 @@ namespace glow
                               sources.insert(sources.end(), source);
                         }
 
-                        matrix->connect(target, sources.begin(), sources.end(), m_source, connection->operation());
+                        salvo.add(target, sources.begin(), sources.end(), connection->operation());
                      }
                   }
                }
+
+               // all connections of a request are reported in a single message
+               if(salvo.empty() == false)
+                  matrix->connect(salvo, m_source);
             }
          }
       }
@@ -174,292 +495,1541 @@ namespace glow
 
    // ========================================================
    //
-   // Dispatcher::ElementToGlowConverter Definitions
+   // Dispatcher::SnapshotWalker Definitions
    //
    // ========================================================
 
-   Dispatcher::ElementToGlowConverter::ElementToGlowConverter(int dirFieldMask, bool isCompleteMatrixEnquired)
-      : m_dirFieldMask(dirFieldMask == 0 ? libember::glow::DirFieldMask::All : dirFieldMask)
-      , m_isCompleteMatrixEnquired(isCompleteMatrixEnquired)
-      , m_result(nullptr)
-   {
-   }
+   Dispatcher::SnapshotWalker::SnapshotWalker(Dispatcher const* dispatcher)
+      : m_dispatcher(dispatcher)
+      , m_isSnapshotRequest(true)
+   {}
 
-   libember::glow::GlowElement* Dispatcher::ElementToGlowConverter::detachResult()
+   void Dispatcher::SnapshotWalker::handleCommand(libember::glow::GlowCommand const* glow, libember::ber::ObjectIdentifier const& path)
    {
-      auto result = m_result;
+      auto const number = glow->number().value();
+      auto matrix = (model::matrix::Matrix*)nullptr;
 
-      m_result = nullptr;
+      if(number == libember::glow::CommandType::GetDirectory
+      || number == libember::glow::CommandType::GetDirectoryRecursive)
+         matrix = m_dispatcher->findMatrix(path);
 
-      return result;
+      if(matrix != nullptr)
+         m_requests.push_back(Request(matrix, glow->dirFieldMask().value()));
+      else
+         m_isSnapshotRequest = false;
    }
 
-   void Dispatcher::ElementToGlowConverter::visit(model::Node* element)
+   void Dispatcher::SnapshotWalker::handleParameter(libember::glow::GlowParameterBase const* glow, libember::ber::ObjectIdentifier const& path)
    {
-      auto glow = store(new libember::glow::GlowQualifiedNode(element->path()));
-
-      if(hasDirField(libember::glow::DirFieldMask::Identifier))
-         glow->setIdentifier(element->identifier());
+      m_isSnapshotRequest = false;
+   }
 
-      if(hasDirField(libember::glow::DirFieldMask::Description)
-      && element->description().empty() == false)
-         glow->setDescription(element->description());
+   void Dispatcher::SnapshotWalker::handleMatrix(libember::glow::GlowMatrixBase const* glow, libember::ber::ObjectIdentifier const& path)
+   {
+      if(glow->connections() != nullptr)
+         m_isSnapshotRequest = false;
    }
 
-   void Dispatcher::ElementToGlowConverter::visit(model::IntegerParameter* element)
+
+   // ========================================================
+   //
+   // Dispatcher::RequestQueue Definitions
+   //
+   // ========================================================
+
+   namespace
    {
-      auto glow = store(new libember::glow::GlowQualifiedParameter(element->path()));
+      /**
+        * Event carrying a Glow tree from a consumer thread to the
+        * thread owning the DOM.
+        */
+      class RequestEvent : public QEvent
+      {
+      public:
+         RequestEvent(libember::glow::GlowContainer* glow, Consumer* source, util::LatencyTrace* trace)
+            : QEvent(QEvent::User)
+            , m_glow(glow)
+            , m_source(source)
+            , m_trace(trace)
+            , m_postedAt(trace != nullptr ? util::LatencyTrace::now() : 0)
+         {}
+
+         virtual ~RequestEvent()
+         {
+            delete m_glow;
+            delete m_trace;
+         }
 
-      if(hasDirField(libember::glow::DirFieldMask::Identifier))
-         glow->setIdentifier(element->identifier());
+         inline libember::glow::GlowContainer* glow() const { return m_glow; }
+         inline Consumer* source() const { return m_source; }
+         inline util::LatencyTrace* trace() const { return m_trace; }
+         inline qint64 postedAt() const { return m_postedAt; }
 
-      if(hasDirField(libember::glow::DirFieldMask::Description)
-      && element->description().empty() == false)
-         glow->setDescription(element->description());
+         /** Passes the ownership of the tree and the trace to the caller. */
+         inline void release()
+         {
+            m_glow = nullptr;
+            m_trace = nullptr;
+         }
 
-      if(hasDirField(libember::glow::DirFieldMask::Value))
-         glow->setValue(element->value());
+      private:
+         libember::glow::GlowContainer* m_glow;
+         Consumer* m_source;
+         util::LatencyTrace* m_trace;
+         qint64 m_postedAt;
+      };
+
+      /**
+        * The type of the events carrying the result of a concurrent
+        * invocation from a worker thread to the thread owning the DOM.
+        */
+      QEvent::Type const InvocationResultEventType = static_cast<QEvent::Type>(QEvent::User + 1);
+
+      /**
+        * The type of the event the request queue posts to itself in order to
+        * resume applying its backlog when a time slice has been used up.
+        */
+      QEvent::Type const ResumeEventType = static_cast<QEvent::Type>(QEvent::User + 2);
+
+      /**
+        * Event carrying the result of a concurrent invocation from a
+        * worker thread to the thread owning the DOM.
+        */
+      class InvocationResultEvent : public QEvent
+      {
+      public:
+         InvocationResultEvent(libember::glow::GlowInvocationResult* glow, Consumer* source, quint64 key)
+            : QEvent(InvocationResultEventType)
+            , m_glow(glow)
+            , m_source(source)
+            , m_key(key)
+         {}
+
+         virtual ~InvocationResultEvent()
+         {
+            delete m_glow;
+         }
 
-      if(hasDirField(libember::glow::DirFieldMask::All))
+         inline libember::glow::GlowInvocationResult const* glow() const { return m_glow; }
+         inline Consumer* source() const { return m_source; }
+         inline quint64 key() const { return m_key; }
+
+      private:
+         libember::glow::GlowInvocationResult* m_glow;
+         Consumer* m_source;
+         quint64 m_key;
+      };
+
+      /**
+        * Invokes a concurrent function on a worker thread and posts
+        * the result to the request queue.
+        */
+      class InvocationTask : public QRunnable
       {
-         glow->setMinimum(element->minimum());
-         glow->setMaximum(element->maximum());
-         
-         if(element->isReadOnly() == false)
-            glow->setAccess(libember::glow::Access::ReadWrite);
-      }
-   }
+      public:
+         InvocationTask(model::Function const* function, util::VariantValueVector const& arguments, int invocationId, Consumer* source, quint64 key, QObject* receiver)
+            : m_function(function)
+            , m_arguments(arguments)
+            , m_invocationId(invocationId)
+            , m_source(source)
+            , m_key(key)
+            , m_receiver(receiver)
+         {}
+
+         virtual void run()
+         {
+            auto result = util::VariantValueVector();
+            auto success = m_function->invoke(m_arguments.begin(), m_arguments.end(), result);
 
-   void Dispatcher::ElementToGlowConverter::visit(model::StringParameter* element)
-   {
-      auto glow = store(new libember::glow::GlowQualifiedParameter(element->path()));
+            if(m_invocationId >= 0)
+            {
+               auto invocationResult = new libember::glow::GlowInvocationResult();
+               invocationResult->setInvocationId(m_invocationId);
 
-      if(hasDirField(libember::glow::DirFieldMask::Identifier))
-         glow->setIdentifier(element->identifier());
+               if(success)
+                  invocationResult->setTypedResult(result.begin(), result.end());
+               else
+                  invocationResult->setSuccess(false);
 
-      if(hasDirField(libember::glow::DirFieldMask::Description)
-      && element->description().empty() == false)
-         glow->setDescription(element->description());
+               QCoreApplication::postEvent(m_receiver, new InvocationResultEvent(invocationResult, m_source, m_key));
+            }
+         }
 
-      if(hasDirField(libember::glow::DirFieldMask::Value))
-         glow->setValue(element->value());
+      private:
+         model::Function const* m_function;
+         util::VariantValueVector m_arguments;
+         int m_invocationId;
+         Consumer* m_source;
+         quint64 m_key;
+         QObject* m_receiver;
+      };
+   }
 
-      if(hasDirField(libember::glow::DirFieldMask::All))
+   /**
+     * A request in the backlog of the queue, together with the position
+     * of the next root element to apply.
+     */
+   struct Dispatcher::RequestQueue::Request
+   {
+      Request(libember::glow::GlowContainer* glow, Consumer* source, util::LatencyTrace* trace, qint64 postedAt)
+         : glow(glow)
+         , source(source)
+         , trace(trace)
+         , postedAt(postedAt)
+         , next(static_cast<libember::glow::GlowContainer const*>(glow)->childBegin())
+      {}
+
+      ~Request()
       {
-         if(element->isReadOnly() == false)
-            glow->setAccess(libember::glow::Access::ReadWrite);
+         delete glow;
+         delete trace;
       }
-   }
 
-   void Dispatcher::ElementToGlowConverter::visit(model::Function* element)
+      libember::glow::GlowContainer* glow;
+      Consumer* source;
+      util::LatencyTrace* trace;
+      qint64 postedAt;
+      libember::glow::GlowContainer::const_child_iterator next;
+   };
+
+   /**
+     * A concurrent invocation whose result has not arrived yet. The timer
+     * expires when the invocation has timed out.
+     */
+   struct Dispatcher::RequestQueue::PendingInvocation : public libs101::util::TimerWheel::Timer
    {
-      auto glow = store(new libember::glow::GlowQualifiedFunction(element->path()));
+      PendingInvocation(RequestQueue* queue, quint64 key, int invocationId, Consumer* source)
+         : queue(queue)
+         , key(key)
+         , invocationId(invocationId)
+         , source(source)
+      {}
+
+      virtual void expired(libs101::util::TimerWheel&)
+      {
+         queue->expireInvocation(this);
+      }
 
-      if(hasDirField(libember::glow::DirFieldMask::Identifier))
-         glow->setIdentifier(element->identifier());
+      RequestQueue* queue;
+      quint64 key;
+      int invocationId;
+      Consumer* source;
+   };
 
-      if(hasDirField(libember::glow::DirFieldMask::Description)
-      && element->description().empty() == false)
-         glow->setDescription(element->description());
+   Dispatcher::RequestQueue::RequestQueue(Dispatcher* dispatcher)
+      : m_dispatcher(dispatcher)
+      , m_pending(0)
+      , m_timeSlice(DefaultRequestTimeSlice)
+      , m_sliceElements(DefaultRequestSliceElements)
+      , m_isResumePosted(false)
+      , m_nextInvocationKey(1)
+      , m_invocationTimeout(DefaultInvocationTimeout)
+   {
+      m_clock.start();
+   }
 
-      if(hasDirField(libember::glow::DirFieldMask::All))
-      {
-         for each(auto item in element->arguments())
-         {
-            auto arguments = glow->arguments();
-            auto glowTupleItem = new libember::glow::GlowTupleItemDescription(item.type(), item.name());
-            arguments->insert(arguments->end(), glowTupleItem);
-         }
+   Dispatcher::RequestQueue::~RequestQueue()
+   {
+      for each(auto request in m_backlog)
+         delete request;
 
-         for each(auto item in element->result())
-         {
-            auto result = glow->result();
-            auto glowTupleItem = new libember::glow::GlowTupleItemDescription(item.type(), item.name());
-            result->insert(result->end(), glowTupleItem);
-         }
-      }
+      for each(auto const& entry in m_invocations)
+         delete entry.second;
    }
 
-   void Dispatcher::ElementToGlowConverter::visit(model::matrix::OneToNLinearMatrix* element)
+   void Dispatcher::RequestQueue::post(libember::glow::GlowContainer* glow, Consumer* source, util::LatencyTrace* trace)
    {
-      auto glow = MatrixToGlow(element);
+      m_pending.ref();
+
+      if(m_dispatcher->m_metrics != nullptr)
+         m_dispatcher->m_metrics->queueDepth->add(1);
+
+      QCoreApplication::postEvent(this, new RequestEvent(glow, source, trace));
    }
 
-   void Dispatcher::ElementToGlowConverter::visit(model::matrix::NToNLinearMatrix* element)
+   void Dispatcher::RequestQueue::setTimeSlice(int microseconds, int elements)
    {
-      auto glow = MatrixToGlow(element);
+      m_timeSlice = std::max(microseconds, 0);
+      m_sliceElements = std::max(elements, 1);
+   }
 
-      if(hasDirField(libember::glow::DirFieldMask::All))
-         glow->setType(libember::glow::MatrixType::NToN);
+   void Dispatcher::RequestQueue::setInvocationTimeout(int milliseconds)
+   {
+      m_invocationTimeout = std::max(milliseconds, 0);
    }
 
-   void Dispatcher::ElementToGlowConverter::visit(model::matrix::NToNNonlinearMatrix* element)
+   quint64 Dispatcher::RequestQueue::trackInvocation(int invocationId, Consumer* source)
    {
-      auto glow = MatrixToGlow(element);
+      if(m_invocationTimeout <= 0 || invocationId < 0)
+         return 0;
 
-      if(hasDirField(libember::glow::DirFieldMask::All))
-      {
-         glow->setType(libember::glow::MatrixType::NToN);
-         glow->setAddressingMode(libember::glow::MatrixAddressingMode::NonLinear);
-         glow->setParametersLocation(element->parametersPath());
+      auto const key = m_nextInvocationKey++;
+      auto const invocation = new PendingInvocation(this, key, invocationId, source);
 
-         if(element->gainParameterNumber() >= 0)
-            glow->setGainParameterNumber(element->gainParameterNumber());
+      auto const now = currentTick();
 
-         if(m_isCompleteMatrixEnquired)
-         {
-            auto glowTargets = glow->targets();
-            auto glowSources = glow->sources();
+      // the wheel is not advanced while it is empty, this catches up at once
+      m_timers.advance(now);
 
-            for each(auto signal in element->targets())
-               glowTargets->insert(glowTargets->end(), new libember::glow::GlowTarget(signal->number()));
+      m_invocations[key] = invocation;
+      m_timers.schedule(*invocation, now + static_cast<libs101::util::TimerWheel::tick_type>(m_invocationTimeout));
+      scheduleWheelTimer();
+      return key;
+   }
 
-            for each(auto signal in element->sources())
-               glowSources->insert(glowSources->end(), new libember::glow::GlowSource(signal->number()));
-         }
+   void Dispatcher::RequestQueue::expireInvocation(PendingInvocation* invocation)
+   {
+      // the consumer may have disconnected while the function was running
+      if(m_dispatcher->m_server.contains(invocation->source))
+      {
+         auto invocationResult = libember::glow::GlowInvocationResult();
+         invocationResult.setInvocationId(invocation->invocationId);
+         invocationResult.setSuccess(false);
+         invocation->source->writeGlow(&invocationResult);
       }
+
+      LOG_WARNING("invocation " << invocation->invocationId << " timed out after " << m_invocationTimeout << " ms");
+
+      m_invocations.erase(invocation->key);
+      delete invocation;
    }
 
-   void Dispatcher::ElementToGlowConverter::visit(model::matrix::DynamicNToNLinearMatrix* element)
+   void Dispatcher::RequestQueue::scheduleWheelTimer()
    {
-      auto glow = MatrixToGlow(element);
-
-      if(hasDirField(libember::glow::DirFieldMask::All))
+      if(m_timers.empty())
       {
-         glow->setType(libember::glow::MatrixType::NToN);
-         glow->setParametersLocation(element->parametersSubid());
-         glow->setGainParameterNumber(element->gainParameterNumber());
+         m_wheelTimer.stop();
+         return;
       }
+
+      // the idle ticks are counted from the first tick the wheel has not processed
+      auto const elapsed = static_cast<qint64>(currentTick() - m_timers.now());
+      auto const delay = static_cast<qint64>(m_timers.idleTicks()) - elapsed;
+
+      m_wheelTimer.start(delay > 0 ? static_cast<int>(delay) : 0, this);
    }
 
-   libember::glow::GlowMatrixBase* Dispatcher::ElementToGlowConverter::MatrixToGlow(model::matrix::Matrix const* element)
+   libs101::util::TimerWheel::tick_type Dispatcher::RequestQueue::currentTick() const
    {
-      auto glow = store(new libember::glow::GlowQualifiedMatrix(element->path()));
+      return static_cast<libs101::util::TimerWheel::tick_type>(m_clock.elapsed());
+   }
 
-      if(hasDirField(libember::glow::DirFieldMask::Identifier))
-         glow->setIdentifier(element->identifier());
+   bool Dispatcher::RequestQueue::event(QEvent* event)
+   {
+      if(event->type() == QEvent::User)
+      {
+         auto request = static_cast<RequestEvent*>(event);
 
-      glow->setTargetCount(element->targetCount());
-      glow->setSourceCount(element->sourceCount());
+         m_backlog.push_back(new Request(request->glow(), request->source(), request->trace(), request->postedAt()));
+         request->release();
 
-      if(hasDirField(libember::glow::DirFieldMask::Description)
-      && element->description().empty() == false)
-         glow->setDescription(element->description());
+         // while a time slice has been used up, the request waits for the
+         // resume event, so that other events are processed in between
+         if(m_isResumePosted == false)
+            processBacklog();
 
-      if(hasDirField(libember::glow::DirFieldMask::All)
-      && element->labelsPath().empty() == false)
+         return true;
+      }
+      else if(event->type() == ResumeEventType)
       {
-         auto labels = glow->labels();
-         auto label = new libember::glow::GlowLabel(element->labelsPath(), "Primary");
-         labels->insert(labels->end(), label);
+         m_isResumePosted = false;
+         processBacklog();
+         return true;
       }
-
-      if(hasDirField(libember::glow::DirFieldMask::Connections)
-      && m_isCompleteMatrixEnquired)
+      else if(event->type() == InvocationResultEventType)
       {
-         auto glowConnections = glow->connections();
+         auto response = static_cast<InvocationResultEvent*>(event);
 
-         for each(auto signal in element->targets())
+         if(response->key() != 0)
          {
-            auto glowConnection = new libember::glow::GlowConnection(signal->number());
+            auto const it = m_invocations.find(response->key());
 
-            if(signal->connectedSources().empty() == false)
-            {
-               auto sourceNumbers = std::vector<int>();
+            // the consumer has already received a failed result
+            if(it == m_invocations.end())
+               return true;
 
-               for each(auto source in signal->connectedSources())
-                  sourceNumbers.insert(sourceNumbers.end(), source->number());
+            delete it->second;
+            m_invocations.erase(it);
+            scheduleWheelTimer();
+         }
 
-               glowConnection->setSources(libember::ber::ObjectIdentifier(sourceNumbers.begin(), sourceNumbers.end()));
-            }
+         // the consumer may have disconnected while the function was running
+         if(m_dispatcher->m_server.contains(response->source()))
+            response->source()->writeGlow(response->glow());
 
-            glowConnections->insert(glowConnections->end(), glowConnection);
-         }
+         return true;
+      }
+      else if(event->type() == QEvent::Timer && static_cast<QTimerEvent*>(event)->timerId() == m_wheelTimer.timerId())
+      {
+         m_timers.advance(currentTick());
+         scheduleWheelTimer();
+         return true;
       }
 
-      return glow;
+      return QObject::event(event);
    }
 
+   void Dispatcher::RequestQueue::processBacklog()
+   {
+      auto const deadline = m_timeSlice > 0 ? util::LatencyTrace::now() + m_timeSlice * 1000 : 0;
+
+      while(m_backlog.empty() == false)
+      {
+         auto const request = m_backlog.front();
+
+         // the consumer may have disconnected while the request was queued
+         if(m_dispatcher->m_server.contains(request->source))
+         {
+            if(applySlice(request, deadline) == false)
+            {
+               m_isResumePosted = true;
+               QCoreApplication::postEvent(this, new QEvent(ResumeEventType));
+               return;
+            }
+
+            m_dispatcher->completeTrace(request->trace);
+            request->source->completeRequest();
+         }
+
+         m_backlog.pop_front();
+         delete request;
+
+         if(m_dispatcher->m_metrics != nullptr)
+            m_dispatcher->m_metrics->queueDepth->add(-1);
+
+         // responses are only shared among requests that are in flight at the same time
+         if(m_pending.deref() == false)
+            m_dispatcher->invalidateDirectoryResponses();
+
+         if(deadline != 0 && m_backlog.empty() == false && util::LatencyTrace::now() >= deadline)
+         {
+            m_isResumePosted = true;
+            QCoreApplication::postEvent(this, new QEvent(ResumeEventType));
+            return;
+         }
+      }
+   }
+
+   bool Dispatcher::RequestQueue::applySlice(Request* request, qint64 deadline)
+   {
+      auto const dispatcher = m_dispatcher;
+      auto const source = request->source;
+      auto const glow = static_cast<libember::glow::GlowContainer const*>(request->glow);
+
+      if(request->trace != nullptr && request->postedAt != 0)
+      {
+         request->trace->add(util::LatencyStage::Queue, util::LatencyTrace::now() - request->postedAt);
+         request->postedAt = 0;
+      }
+
+      // only the root element collection of a request can be split
+      if(deadline == 0 || glow->typeTag().number() != libember::glow::GlowType::RootElementCollection)
+      {
+         dispatcher->dispatchTraced(request->trace, [=] { dispatcher->receiveGlow(glow, source); });
+         return true;
+      }
+
+      auto const last = glow->childEnd();
+
+      do
+      {
+         auto const first = request->next;
+         auto const count = std::min<std::ptrdiff_t>(m_sliceElements, std::distance(first, last));
+         auto const next = first + count;
+
+         dispatcher->dispatchTraced(request->trace, [=] { dispatcher->receiveElements(first, next, source); });
+         request->next = next;
+      } while(request->next != last && util::LatencyTrace::now() < deadline);
+
+      return request->next == last;
+   }
+
+
+   // ========================================================
+   //
+   // Dispatcher::Metrics Definitions
+   //
+   // ========================================================
+
+   Dispatcher::Metrics::Metrics(util::MetricsRegistry* registry)
+      : queueDepth(registry->gauge("tinyember_request_queue_depth", "The number of requests waiting for the thread owning the DOM."))
+   {
+      using libember::glow::GlowType;
+
+      static char const* const stageNames[util::LatencyStage::Count] =
+      {
+         "deframe", "ber_decode", "dom_assembly", "queue", "dispatch", "encode"
+      };
+
+      struct TypeName
+      {
+         int index;
+         char const* name;
+      };
+
+      static TypeName const typeNames[] =
+      {
+         { OtherIndex, "Other" },
+         { GlowType::Parameter, "Parameter" },
+         { GlowType::Command, "Command" },
+         { GlowType::Node, "Node" },
+         { GlowType::StreamCollection, "StreamCollection" },
+         { GlowType::QualifiedParameter, "QualifiedParameter" },
+         { GlowType::QualifiedNode, "QualifiedNode" },
+         { GlowType::Matrix, "Matrix" },
+         { GlowType::QualifiedMatrix, "QualifiedMatrix" },
+         { GlowType::Function, "Function" },
+         { GlowType::QualifiedFunction, "QualifiedFunction" },
+         { GlowType::InvocationResult, "InvocationResult" },
+         { ResponseIndex, "Response" },
+      };
+
+      for each(auto const& type in typeNames)
+      {
+         auto const label = util::MetricsWriter::label("type", type.name);
+         received[type.index] = registry->counter("tinyember_messages_received_total", "The number of Glow messages received from consumers.", label);
+         sent[type.index] = registry->counter("tinyember_messages_sent_total", "The number of Glow messages sent to consumers.", label);
+      }
+
+      // types that do not appear at the root of a message share a counter
+      for(auto index = 1; index < ResponseIndex; index++)
+      {
+         auto const isNamed = std::any_of(std::begin(typeNames), std::end(typeNames), [index](TypeName const& type) { return type.index == index; });
+
+         if(isNamed == false)
+         {
+            received[index] = received[OtherIndex];
+            sent[index] = sent[OtherIndex];
+         }
+      }
+
+      for(auto stage = 0; stage < util::LatencyStage::Count; stage++)
+         stages[stage] = registry->histogram("tinyember_request_stage_seconds", "The time requests have spent in each stage.", util::MetricsWriter::label("stage", stageNames[stage]));
+   }
+
+   void Dispatcher::Metrics::countReceived(libember::glow::GlowContainer const* glow)
+   {
+      received[indexOf(glow)]->increment();
+   }
+
+   void Dispatcher::Metrics::countSent(libember::glow::GlowContainer const* glow)
+   {
+      sent[indexOf(glow)]->increment();
+   }
+
+   void Dispatcher::Metrics::countSentResponse()
+   {
+      sent[ResponseIndex]->increment();
+   }
+
+   //static
+   int Dispatcher::Metrics::indexOf(libember::glow::GlowContainer const* glow)
+   {
+      auto const first = glow->childBegin();
+
+      if(first == glow->childEnd())
+         return OtherIndex;
+
+      auto const tag = first->typeTag();
+
+      if(tag.getClass() != libember::ber::Class::Application || tag.number() >= ResponseIndex)
+         return OtherIndex;
+
+      return static_cast<int>(tag.number());
+   }
+
+
+   // ========================================================
+   //
+   // Dispatcher::MatrixMetadataCache Definitions
+   //
+   // ========================================================
+
+   bool Dispatcher::MatrixMetadataCache::find(model::matrix::Matrix const* matrix, int dirFieldMask, bool isComplete, QByteArray& metadata) const
+   {
+      QMutexLocker const lock(&m_mutex);
+      auto const result = m_entries.find(Key(matrix, dirFieldMask, isComplete));
+
+      if(result == m_entries.end())
+         return false;
+
+      metadata = result->second;
+      return true;
+   }
+
+   void Dispatcher::MatrixMetadataCache::insert(model::matrix::Matrix const* matrix, int dirFieldMask, bool isComplete, QByteArray const& metadata)
+   {
+      QMutexLocker const lock(&m_mutex);
+      m_entries[Key(matrix, dirFieldMask, isComplete)] = metadata;
+   }
+
+   void Dispatcher::MatrixMetadataCache::clear()
+   {
+      QMutexLocker const lock(&m_mutex);
+      m_entries.clear();
+   }
+
+
+   // ========================================================
+   //
+   // Dispatcher::ElementToGlowConverter Definitions
+   //
+   // ========================================================
+
+   Dispatcher::ElementToGlowConverter::ElementToGlowConverter(libember::glow::GlowWriter& writer, MatrixMetadataCache* matrices, int dirFieldMask, bool isCompleteMatrixEnquired, model::matrix::ConnectionSnapshot const* connections)
+      : m_writer(writer)
+      , m_matrices(matrices)
+      , m_dirFieldMask(dirFieldMask == 0 ? libember::glow::DirFieldMask::All : dirFieldMask)
+      , m_isCompleteMatrixEnquired(isCompleteMatrixEnquired)
+      , m_connections(connections)
+      , m_metadataBegin(0)
+      , m_isEncodingMetadata(false)
+   {
+   }
+
+   void Dispatcher::ElementToGlowConverter::visit(model::Node* element)
+   {
+      m_writer.beginNode(element->path());
+
+      if(hasDirField(libember::glow::DirFieldMask::Identifier))
+         m_writer.identifier(element->identifier());
+
+      if(hasDirField(libember::glow::DirFieldMask::Description)
+      && element->description().empty() == false)
+         m_writer.description(element->description());
+
+      m_writer.endNode();
+   }
+
+   void Dispatcher::ElementToGlowConverter::visit(model::IntegerParameter* element)
+   {
+      m_writer.beginParameter(element->path());
+
+      if(hasDirField(libember::glow::DirFieldMask::Identifier))
+         m_writer.identifier(element->identifier());
+
+      if(hasDirField(libember::glow::DirFieldMask::Description)
+      && element->description().empty() == false)
+         m_writer.description(element->description());
+
+      if(hasDirField(libember::glow::DirFieldMask::Value))
+         m_writer.value(static_cast<long>(element->value()));
+
+      if(hasDirField(libember::glow::DirFieldMask::All))
+      {
+         m_writer.minimum(static_cast<long>(element->minimum()));
+         m_writer.maximum(static_cast<long>(element->maximum()));
+
+         if(element->isReadOnly() == false)
+            m_writer.access(libember::glow::Access::ReadWrite);
+      }
+
+      m_writer.endParameter();
+   }
+
+   void Dispatcher::ElementToGlowConverter::visit(model::StringParameter* element)
+   {
+      m_writer.beginParameter(element->path());
+
+      if(hasDirField(libember::glow::DirFieldMask::Identifier))
+         m_writer.identifier(element->identifier());
+
+      if(hasDirField(libember::glow::DirFieldMask::Description)
+      && element->description().empty() == false)
+         m_writer.description(element->description());
+
+      if(hasDirField(libember::glow::DirFieldMask::Value))
+         m_writer.value(element->value());
+
+      if(hasDirField(libember::glow::DirFieldMask::All))
+      {
+         if(element->isReadOnly() == false)
+            m_writer.access(libember::glow::Access::ReadWrite);
+      }
+
+      m_writer.endParameter();
+   }
+
+   void Dispatcher::ElementToGlowConverter::visit(model::Function* element)
+   {
+      libember::glow::GlowQualifiedFunction glow(element->path());
+
+      if(hasDirField(libember::glow::DirFieldMask::Identifier))
+         glow.setIdentifier(element->identifier());
+
+      if(hasDirField(libember::glow::DirFieldMask::Description)
+      && element->description().empty() == false)
+         glow.setDescription(element->description());
+
+      if(hasDirField(libember::glow::DirFieldMask::All))
+      {
+         for each(auto item in element->arguments())
+         {
+            auto arguments = glow.arguments();
+            auto glowTupleItem = new libember::glow::GlowTupleItemDescription(item.type(), item.name());
+            arguments->insert(arguments->end(), glowTupleItem);
+         }
+
+         for each(auto item in element->result())
+         {
+            auto result = glow.result();
+            auto glowTupleItem = new libember::glow::GlowTupleItemDescription(item.type(), item.name());
+            result->insert(result->end(), glowTupleItem);
+         }
+      }
+
+      writeEncoded(m_writer, glow);
+   }
+
+   void Dispatcher::ElementToGlowConverter::visit(model::matrix::OneToNLinearMatrix* element)
+   {
+      beginMatrix(element);
+      endMatrix(element);
+   }
+
+   void Dispatcher::ElementToGlowConverter::visit(model::matrix::NToNLinearMatrix* element)
+   {
+      if(beginMatrix(element))
+      {
+         if(hasDirField(libember::glow::DirFieldMask::All))
+            m_metadata.type(libember::glow::MatrixType::NToN);
+      }
+
+      endMatrix(element);
+   }
+
+   void Dispatcher::ElementToGlowConverter::visit(model::matrix::NToNNonlinearMatrix* element)
+   {
+      if(beginMatrix(element)
+      && hasDirField(libember::glow::DirFieldMask::All))
+      {
+         m_metadata.type(libember::glow::MatrixType::NToN);
+         m_metadata.addressingMode(libember::glow::MatrixAddressingMode::NonLinear);
+         m_metadata.parametersLocation(element->parametersPath());
+
+         if(element->gainParameterNumber() >= 0)
+            m_metadata.gainParameterNumber(element->gainParameterNumber());
+
+         if(m_isCompleteMatrixEnquired)
+         {
+            m_metadata.beginTargets();
+
+            for each(auto signal in element->targets())
+               m_metadata.target(signal->number());
+
+            m_metadata.endTargets();
+            m_metadata.beginSources();
+
+            for each(auto signal in element->sources())
+               m_metadata.source(signal->number());
+
+            m_metadata.endSources();
+         }
+      }
+
+      endMatrix(element);
+   }
+
+   void Dispatcher::ElementToGlowConverter::visit(model::matrix::DynamicNToNLinearMatrix* element)
+   {
+      if(beginMatrix(element)
+      && hasDirField(libember::glow::DirFieldMask::All))
+      {
+         m_metadata.type(libember::glow::MatrixType::NToN);
+         m_metadata.parametersLocation(element->parametersSubid());
+         m_metadata.gainParameterNumber(element->gainParameterNumber());
+      }
+
+      endMatrix(element);
+   }
+
+   void Dispatcher::ElementToGlowConverter::visitCrosspointGain(model::matrix::DynamicNToNLinearMatrix const* matrix, util::Oid const& gainPath, int index)
+   {
+      m_writer.beginParameter(gainPath);
+
+      if(hasDirField(libember::glow::DirFieldMask::Identifier))
+         m_writer.identifier("gain");
+
+      if(hasDirField(libember::glow::DirFieldMask::Value))
+         m_writer.value(static_cast<long>(matrix->crosspointGain(index)));
+
+      if(hasDirField(libember::glow::DirFieldMask::All))
+      {
+         m_writer.minimum(static_cast<long>(matrix->minimumGain()));
+         m_writer.maximum(static_cast<long>(matrix->maximumGain()));
+         m_writer.access(libember::glow::Access::ReadWrite);
+      }
+
+      m_writer.endParameter();
+   }
+
+   bool Dispatcher::ElementToGlowConverter::beginMatrix(model::matrix::Matrix const* element)
+   {
+      m_isEncodingMetadata = m_matrices == nullptr
+         || m_matrices->find(element, m_dirFieldMask, m_isCompleteMatrixEnquired, m_metadataBytes) == false;
+
+      if(m_isEncodingMetadata == false)
+         return false;
+
+      // the metadata is encoded within a matrix of its own, since the part
+      // following the path is only final once the contents have been ended
+      m_metadata.clear();
+      m_metadata.beginRoot();
+      m_metadata.beginMatrix(element->path());
+      m_metadataBegin = m_metadata.size();
+
+      if(hasDirField(libember::glow::DirFieldMask::Identifier))
+         m_metadata.identifier(element->identifier());
+
+      m_metadata.targetCount(element->targetCount());
+      m_metadata.sourceCount(element->sourceCount());
+
+      if(hasDirField(libember::glow::DirFieldMask::Description)
+      && element->description().empty() == false)
+         m_metadata.description(element->description());
+
+      if(hasDirField(libember::glow::DirFieldMask::All)
+      && element->labelsPath().empty() == false)
+      {
+         m_metadata.beginLabels();
+         m_metadata.label(element->labelsPath(), "Primary");
+         m_metadata.endLabels();
+      }
+
+      return true;
+   }
+
+   void Dispatcher::ElementToGlowConverter::endMatrix(model::matrix::Matrix const* element)
+   {
+      if(m_isEncodingMetadata)
+      {
+         m_metadata.endContents();
+
+         auto const first = m_metadata.begin() + m_metadataBegin;
+         m_metadataBytes = QByteArray(reinterpret_cast<char const*>(first), static_cast<int>(m_metadata.end() - first));
+
+         if(m_matrices != nullptr)
+            m_matrices->insert(element, m_dirFieldMask, m_isCompleteMatrixEnquired, m_metadataBytes);
+      }
+
+      auto const metadata = reinterpret_cast<unsigned char const*>(m_metadataBytes.constData());
+
+      m_writer.beginMatrix(element->path());
+      m_writer.encoded(metadata, metadata + m_metadataBytes.size());
+      writeConnections(element);
+      m_writer.endMatrix();
+   }
+
+   void Dispatcher::ElementToGlowConverter::writeConnections(model::matrix::Matrix const* element)
+   {
+      if(hasDirField(libember::glow::DirFieldMask::Connections) == false
+      || m_isCompleteMatrixEnquired == false)
+         return;
+
+      m_writer.beginConnections();
+
+      if(m_connections != nullptr)
+      {
+         for each(auto const& connection in m_connections->connections())
+         {
+            if(connection.sources->empty())
+               m_writer.connection(connection.target);
+            else
+               m_writer.connection(connection.target, libember::ber::ObjectIdentifier(connection.sources->begin(), connection.sources->end()));
+         }
+      }
+      else
+      {
+         auto sourceNumbers = std::vector<int>();
+
+         for each(auto signal in element->targets())
+         {
+            if(signal->connectedSources().empty())
+            {
+               m_writer.connection(signal->number());
+               continue;
+            }
+
+            sourceNumbers.clear();
+            for each(auto source in signal->connectedSources())
+               sourceNumbers.insert(sourceNumbers.end(), source->number());
+
+            m_writer.connection(signal->number(), libember::ber::ObjectIdentifier(sourceNumbers.begin(), sourceNumbers.end()));
+         }
+      }
+
+      m_writer.endConnections();
+   }
+
+
+   // ========================================================
+   //
+   // Dispatcher Definitions
+   //
+   // ========================================================
+
+   Dispatcher::Dispatcher(QObject* parent, int port)
+      : m_server(parent, this, port)
+      , m_requests(this)
+      , m_changes(ChangeLogCapacity)
+      , m_latencySink(nullptr)
+      , m_metrics(nullptr)
+      , m_journal(nullptr)
+      , m_minimumNotificationInterval(0)
+      , m_transactionDepth(0)
+      , m_trace(nullptr)
+   {}
+
+   Dispatcher::~Dispatcher()
+   {
+      for each(auto backend in m_backends)
+         delete backend;
+
+      delete m_metrics;
+   }
+
+   void Dispatcher::setMetrics(util::MetricsRegistry* registry)
+   {
+      delete m_metrics;
+      m_metrics = new Metrics(registry);
+      m_server.setMetrics(registry);
+   }
+
+   void Dispatcher::setRoot(model::Element* value)
+   {
+      m_root = value;
+      m_matrices.clear();
+      m_matrixMetadata.clear();
+      invalidateDirectoryResponses();
+
+      if(value != nullptr)
+         indexMatrices(value);
+   }
+
+   void Dispatcher::notifyMatrixConnection(model::matrix::Matrix* matrix, model::matrix::Signal* target, void* state)
+   {
+      auto targets = std::vector<model::matrix::Signal*>(1, target);
+
+      notifyMatrixConnections(matrix, targets, state);
+   }
+
+   void Dispatcher::notifyMatrixConnections(model::matrix::Matrix* matrix, std::vector<model::matrix::Signal*> const& targets, void* state)
+   {
+      auto const path = matrix->path();
+
+      invalidateDirectoryResponses();
+
+      // the parameter values changed before are reported first
+      if(m_valueChanges.empty() == false)
+         writeValueChanges();
+
+      if(m_journal != nullptr)
+         m_journal->recordConnections(matrix, targets);
+
+      for each(auto target in targets)
+         m_changes.add(path, target->number());
+
+      if(m_server.containsAny(InterestFilter(path)) == false)
+         return;
+
+      auto glow = libember::glow::GlowRootElementCollection::create();
+      glow->insert(glow->end(), connectionsToGlow(matrix, targets));
+
+      writeGlow(glow, path);
+      delete glow;
+   }
+
+   void Dispatcher::notifyParameterValueChanged(util::Oid const& parameterPath, int value)
+   {
+      auto change = ValueChange(parameterPath);
+      change.integer = value;
+
+      notifyValueChanged(change);
+   }
 
-   // ========================================================
-   //
-   // Dispatcher Definitions
-   //
-   // ========================================================
+   void Dispatcher::notifyParameterValueChanged(util::Oid const& parameterPath, std::string const& value)
+   {
+      auto change = ValueChange(parameterPath);
+      change.isString = true;
+      change.text = value;
 
-   Dispatcher::Dispatcher(QObject* parent, int port)
-      : m_server(parent, this, port)
-   {}
+      notifyValueChanged(change);
+   }
 
-   void Dispatcher::notifyMatrixConnection(model::matrix::Matrix* matrix, model::matrix::Signal* target, void* state)
+   void Dispatcher::beginTransaction()
    {
-      auto glow = libember::glow::GlowRootElementCollection::create();
-      auto glowMatrix = new libember::glow::GlowQualifiedMatrix(matrix->path());
-      auto glowConnection = new libember::glow::GlowConnection(target->number());
+      m_transactionDepth++;
+   }
 
-      auto sourceNumbers = std::vector<int>();
-      for each(auto source in target->connectedSources())
-         sourceNumbers.insert(sourceNumbers.end(), source->number());
+   void Dispatcher::commitTransaction()
+   {
+      if(m_transactionDepth > 0 && --m_transactionDepth == 0 && m_valueChanges.empty() == false)
+         writeValueChanges();
+   }
 
-      glowConnection->setSources(libember::ber::ObjectIdentifier(sourceNumbers.begin(), sourceNumbers.end()));
-      glowConnection->setDisposition(libember::glow::ConnectionDisposition::Modified);
+   void Dispatcher::notifyValueChanged(ValueChange const& change)
+   {
+      invalidateDirectoryResponses();
 
-      auto glowConnections = glowMatrix->connections();
-      glowConnections->insert(glowConnections->end(), glowConnection);
-      glow->insert(glow->end(), glowMatrix);
+      if(m_transactionDepth > 0)
+      {
+         auto const result = m_valueChangeIndex.insert(std::make_pair(change.path, m_valueChanges.size()));
+
+         // only the last value of a parameter is reported when the transaction is committed
+         if(result.second)
+            m_valueChanges.push_back(change);
+         else
+            m_valueChanges[result.first->second] = change;
+
+         return;
+      }
 
-      writeGlow(glow);
+      recordValueChange(change);
+
+      if(m_server.containsAny(InterestFilter(change.path)) == false)
+         return;
+
+      auto glow = libember::glow::GlowRootElementCollection::create();
+      glow->insert(glow->end(), valueToGlow(change));
+
+      writeGlow(glow, change.path, true);
       delete glow;
    }
 
-   void Dispatcher::notifyParameterValueChanged(util::Oid const& parameterPath, int value)
+   void Dispatcher::writeValueChanges()
    {
-      auto glow = libember::glow::GlowRootElementCollection::create();
-      auto glowParam = new libember::glow::GlowQualifiedParameter(parameterPath);
-      glowParam->setValue(value);
+      auto changes = ValueChangeVector();
+      changes.swap(m_valueChanges);
+      m_valueChangeIndex.clear();
 
-      glow->insert(glow->end(), glowParam);
+      for each(auto const& change in changes)
+         recordValueChange(change);
 
-      writeGlow(glow);
-      delete glow;
+      auto consumers = std::vector<Consumer*>();
+      m_server.forEach([&consumers](net::TcpClient* client) { consumers.push_back(static_cast<Consumer*>(client)); });
+
+      // most consumers are interested in all changed parameters and share one message
+      auto complete = QByteArray();
+      auto selected = std::vector<ValueChangeVector::size_type>();
+
+      for each(auto consumer in consumers)
+      {
+         selected.clear();
+
+         for(auto index = ValueChangeVector::size_type(0); index < changes.size(); index++)
+         {
+            if(consumer->isInterestedIn(changes[index].path))
+               selected.push_back(index);
+         }
+
+         if(selected.empty())
+            continue;
+
+         if(selected.size() == changes.size() && complete.isEmpty() == false)
+         {
+            consumer->write(complete);
+            continue;
+         }
+
+         auto glow = libember::glow::GlowRootElementCollection::create();
+
+         for each(auto index in selected)
+            glow->insert(glow->end(), valueToGlow(changes[index]));
+
+         auto const message = encodeMessage(glow);
+         delete glow;
+
+         if(selected.size() == changes.size())
+            complete = message;
+
+         consumer->write(message);
+      }
    }
 
-   void Dispatcher::notifyParameterValueChanged(util::Oid const& parameterPath, std::string const& value)
+   void Dispatcher::recordValueChange(ValueChange const& change)
    {
-      auto glow = libember::glow::GlowRootElementCollection::create();
-      auto glowParam = new libember::glow::GlowQualifiedParameter(parameterPath);
-      glowParam->setValue(value);
+      if(m_journal != nullptr)
+      {
+         if(change.isString)
+            m_journal->recordValue(change.path, change.text);
+         else
+            m_journal->recordValue(change.path, change.integer);
+      }
+
+      m_changes.add(change.path);
+   }
+
+   //static
+   libember::glow::GlowQualifiedParameter* Dispatcher::valueToGlow(ValueChange const& change)
+   {
+      auto glowParam = new libember::glow::GlowQualifiedParameter(change.path);
 
-      glow->insert(glow->end(), glowParam);
+      if(change.isString)
+         glowParam->setValue(change.text);
+      else
+         glowParam->setValue(change.integer);
 
-      writeGlow(glow);
-      delete glow;
+      return glowParam;
+   }
+
+   QByteArray Dispatcher::encodeMessage(libember::glow::GlowContainer const* glow) const
+   {
+      util::LatencyScope const scope(m_trace, util::LatencyStage::Encode);
+      auto const encoder = Encoder::createEmberMessage(glow);
+      auto message = QByteArray();
+
+      if(m_metrics != nullptr)
+         m_metrics->countSent(glow);
+
+      for each(auto const& packet in encoder)
+         message.append(reinterpret_cast<char const*>(&*packet.begin()), static_cast<int>(packet.size()));
+
+      return message;
+   }
+
+   void Dispatcher::mountBackend(int number, QString const& host, quint16 port)
+   {
+      m_backends.push_back(new Backend(new QTcpSocket(), this, number, host, port));
+      invalidateDirectoryResponses();
    }
 
    net::TcpClient* Dispatcher::create(QTcpSocket* socket)
    {
-      return new Consumer(socket, this);
+      auto consumer = new Consumer(socket, this);
+
+      // value notifications are keyed by the parameter path, see writeGlow
+      consumer->setMinimumKeyInterval(m_minimumNotificationInterval);
+      return consumer;
+   }
+
+   void Dispatcher::invokeConcurrently(model::Function const* function, util::VariantValueVector const& arguments, int invocationId, Consumer* source)
+   {
+      auto const key = m_requests.trackInvocation(invocationId, source);
+      m_invocations.start(new InvocationTask(function, arguments, invocationId, source, key, &m_requests));
+   }
+
+   void Dispatcher::postGlow(libember::glow::GlowContainer* glow, Consumer* source, util::LatencyTrace* trace)
+   {
+      m_requests.post(glow, source, trace);
    }
 
    void Dispatcher::receiveGlow(libember::glow::GlowContainer const* glow, Consumer* source)
    {
       auto walker = GlowWalker(this, source);
 
-      walker.walk(glow);
+      {
+         // all parameter values set by a request are reported in a single message
+         model::NotificationTransaction const transaction(this);
+         walker.walk(glow);
+      }
+
+      // everything a request forwards to a backend is sent as one message
+      for each(auto backend in m_backends)
+         backend->flush();
+   }
+
+   void Dispatcher::receiveElements(libember::glow::GlowContainer::const_child_iterator first, libember::glow::GlowContainer::const_child_iterator last, Consumer* source)
+   {
+      auto walker = GlowWalker(this, source);
+
+      {
+         model::NotificationTransaction const transaction(this);
+         walker.walk(first, last);
+      }
+
+      for each(auto backend in m_backends)
+         backend->flush();
+   }
+
+   void Dispatcher::receiveBackendGlow(libember::glow::GlowContainer const* glow, Backend* source)
+   {
+      using libember::glow::GlowType;
+
+      auto paths = std::vector<util::Oid>();
+      auto acceptAll = false;
+
+      // the merged root directory may contain the element of the backend
+      invalidateDirectoryResponses();
+
+      for(auto it = glow->childBegin(); it != glow->childEnd(); ++it)
+      {
+         auto const child = libember::glow::GlowVisitor::toGlowContainer(&*it);
+
+         if(child == nullptr)
+            continue;
+
+         switch(child->typeTag().number())
+         {
+            case GlowType::QualifiedNode:
+               paths.push_back(static_cast<libember::glow::GlowQualifiedNode const*>(child)->path());
+               break;
+
+            case GlowType::QualifiedParameter:
+               paths.push_back(static_cast<libember::glow::GlowQualifiedParameter const*>(child)->path());
+               break;
+
+            case GlowType::QualifiedMatrix:
+               paths.push_back(static_cast<libember::glow::GlowQualifiedMatrix const*>(child)->path());
+               break;
+
+            case GlowType::QualifiedFunction:
+               paths.push_back(static_cast<libember::glow::GlowQualifiedFunction const*>(child)->path());
+               break;
+
+            case GlowType::Node:
+               paths.push_back(util::Oid(static_cast<libember::glow::GlowNode const*>(child)->number()));
+               break;
+
+            case GlowType::InvocationResult:
+               acceptAll = true;
+               break;
+         }
+      }
+
+      if(paths.empty() && acceptAll == false)
+         return;
+
+      auto encoder = Encoder::createEmberMessage(glow);
+      m_server.writePackets(encoder.begin(), encoder.end(), BackendFilter(paths, acceptAll));
+
+      if(m_metrics != nullptr)
+         m_metrics->countSent(glow);
+   }
+
+   Backend* Dispatcher::findBackend(util::Oid const& path) const
+   {
+      for each(auto backend in m_backends)
+      {
+         if(backend->owns(path))
+            return backend->isAvailable() ? backend : nullptr;
+      }
+
+      return nullptr;
+   }
+
+   template<typename Function>
+   void Dispatcher::dispatchTraced(util::LatencyTrace* trace, Function const& apply)
+   {
+      if(trace == nullptr || isTracing() == false)
+      {
+         apply();
+         return;
+      }
+
+      // while m_trace is set, all responses and notifications are encoded
+      // on behalf of this request
+      auto const encoding = trace->duration(util::LatencyStage::Encode);
+      auto const start = util::LatencyTrace::now();
+
+      m_trace = trace;
+
+      try
+      {
+         apply();
+      }
+      catch(...)
+      {
+         m_trace = nullptr;
+         throw;
+      }
+
+      m_trace = nullptr;
+      trace->add(util::LatencyStage::Dispatch, util::LatencyTrace::now() - start - (trace->duration(util::LatencyStage::Encode) - encoding));
+   }
+
+   void Dispatcher::completeTrace(util::LatencyTrace const* trace)
+   {
+      if(trace == nullptr || isTracing() == false)
+         return;
+
+      if(m_metrics != nullptr)
+      {
+         for(auto stage = 0; stage < util::LatencyStage::Count; stage++)
+            m_metrics->stages[stage]->record(trace->duration(static_cast<util::LatencyStage::_Domain>(stage)));
+      }
+
+      if(m_latencySink != nullptr)
+      {
+         for(auto stage = 0; stage < util::LatencyStage::Count; stage++)
+            m_latencyHistograms[stage].record(trace->duration(static_cast<util::LatencyStage::_Domain>(stage)));
+
+         m_latencySink->notifyRequestTraced(*trace, m_latencyHistograms);
+      }
    }
 
-   libember::glow::GlowElement* Dispatcher::elementToGlow(model::Element* element, int dirFieldMask, bool isCompleteMatrixEnquired) const
+   void Dispatcher::writeElement(libember::glow::GlowWriter& writer, model::Element* element, int dirFieldMask, bool isCompleteMatrixEnquired) const
    {
-      auto converter = ElementToGlowConverter(dirFieldMask, isCompleteMatrixEnquired);
+      auto converter = ElementToGlowConverter(writer, &m_matrixMetadata, dirFieldMask, isCompleteMatrixEnquired);
       element->accept(&converter);
-      return converter.detachResult();
    }
 
-   void Dispatcher::writeGlow(libember::glow::GlowContainer const* glow)
+   model::matrix::DynamicNToNLinearMatrix* Dispatcher::findCrosspoint(util::Oid const& path, int& index, bool& isGainParameter) const
+   {
+      // a crosspoint is addressed as "<matrix>/parameters/connections/<target>/<source>[/<gain>]"
+      for(auto depth = 4; depth <= 5; depth++)
+      {
+         if(path.size() > (std::size_t)depth)
+         {
+            auto matrixPath = util::Oid(path.begin(), path.end() - depth);
+            auto lookup = model::Element::Lookup(m_root, matrixPath);
+            auto matrix = dynamic_cast<model::matrix::DynamicNToNLinearMatrix*>(lookup.result());
+
+            if(matrix != nullptr)
+            {
+               index = matrix->crosspointIndex(path, isGainParameter);
+
+               if(index >= 0)
+                  return matrix;
+            }
+         }
+      }
+
+      return nullptr;
+   }
+
+   void Dispatcher::writeCrosspointGain(libember::glow::GlowWriter& writer, model::matrix::DynamicNToNLinearMatrix const* matrix, util::Oid const& gainPath, int index, int dirFieldMask) const
+   {
+      auto converter = ElementToGlowConverter(writer, nullptr, dirFieldMask, false);
+      converter.visitCrosspointGain(matrix, gainPath, index);
+   }
+
+   void Dispatcher::writeGlow(libember::glow::GlowContainer const* glow, util::Oid const& path, bool isSupersedable)
    {
+      util::LatencyScope const scope(m_trace, util::LatencyStage::Encode);
       auto encoder = Encoder::createEmberMessage(glow);
+      auto key = QByteArray();
+
+      if(isSupersedable)
+      {
+         // only the latest value of a parameter matters to a consumer that lags behind
+         for each(auto number in path)
+            key.append(reinterpret_cast<char const*>(&number), sizeof(number));
+      }
+
+      m_server.writePackets(encoder.begin(), encoder.end(), InterestFilter(path), key);
+
+      if(m_metrics != nullptr)
+         m_metrics->countSent(glow);
+   }
+
+   void Dispatcher::writeChangesSince(long sequence, Consumer* source)
+   {
+      auto changes = util::ChangeLog::EntryVector();
+      auto reply = libember::glow::GlowRootElementCollection::create();
+      auto command = new libember::glow::GlowCommand(reply, libember::glow::CommandType::GetChangesSince);
+
+      if(sequence < 0)
+      {
+         command->setSequence(m_changes.sequence());
+      }
+      else if(m_changes.changesSince(sequence, changes))
+      {
+         addInterests(m_root, source);
+         writeChanges(changes, source);
+         command->setSequence(m_changes.sequence());
+      }
+
+      source->writeGlow(reply);
+      delete reply;
+   }
+
+   void Dispatcher::writeChanges(util::ChangeLog::EntryVector const& changes, Consumer* source)
+   {
+      typedef std::unordered_map<util::Oid, std::vector<int>, util::OidHash> TargetMap;
+
+      // report every element once, in the order of its first change
+      auto paths = std::vector<util::Oid>();
+      auto targets = TargetMap();
+
+      for each(auto const& change in changes)
+      {
+         auto where = targets.find(change.path);
+
+         if(where == targets.end())
+         {
+            paths.push_back(change.path);
+            where = targets.insert(TargetMap::value_type(change.path, std::vector<int>())).first;
+         }
+
+         auto& numbers = where->second;
+
+         if(change.target >= 0 && util::contains(numbers.begin(), numbers.end(), change.target) == false)
+            numbers.push_back(change.target);
+      }
+
+      auto writer = libember::glow::GlowWriter();
+      auto count = 0u;
+
+      writer.beginRoot();
+
+      for each(auto const& path in paths)
+      {
+         auto index = -1;
+         auto isGainParameter = false;
+         auto crosspointMatrix = findCrosspoint(path, index, isGainParameter);
+
+         if(crosspointMatrix != nullptr)
+         {
+            if(isGainParameter == false)
+               continue;
+
+            writeCrosspointGain(writer, crosspointMatrix, path, index, libember::glow::DirFieldMask::Value);
+         }
+         else
+         {
+            auto lookup = model::Element::Lookup(m_root, path);
+            auto const element = lookup.result();
+            auto const matrix = dynamic_cast<model::matrix::Matrix*>(element);
+
+            if(matrix != nullptr)
+            {
+               auto signals = model::matrix::Signal::Vector();
+
+               for each(auto number in targets[path])
+               {
+                  auto const target = matrix->getTarget(number);
+
+                  if(target != nullptr)
+                     signals.push_back(target);
+               }
+
+               // the connections carry their disposition, which the writer does not support
+               auto const glowMatrix = connectionsToGlow(matrix, signals);
+               writeEncoded(writer, *glowMatrix);
+               delete glowMatrix;
+            }
+            else if(dynamic_cast<model::ParameterBase*>(element) != nullptr)
+            {
+               writeElement(writer, element, libember::glow::DirFieldMask::Value, false);
+            }
+            else
+            {
+               continue;
+            }
+         }
+
+         if(++count >= ChangeChunkSize)
+         {
+            writer.endRoot();
+            source->writeGlow(writer);
+            writer.clear();
+            writer.beginRoot();
+            count = 0;
+         }
+      }
+
+      if(count > 0)
+      {
+         writer.endRoot();
+         source->writeGlow(writer);
+      }
+   }
+
+   void Dispatcher::addInterests(model::Element* parent, Consumer* source) const
+   {
+      source->addInterest(parent->path());
+
+      for each(auto child in *parent)
+      {
+         if(dynamic_cast<model::Node*>(child) != nullptr)
+            addInterests(child, source);
+      }
+   }
+
+   libember::glow::GlowQualifiedMatrix* Dispatcher::connectionsToGlow(model::matrix::Matrix const* matrix, std::vector<model::matrix::Signal*> const& targets) const
+   {
+      auto glowMatrix = new libember::glow::GlowQualifiedMatrix(matrix->path());
+      auto glowConnections = glowMatrix->connections();
+      auto sourceNumbers = std::vector<int>();
+
+      for each(auto target in targets)
+      {
+         auto glowConnection = new libember::glow::GlowConnection(target->number());
+
+         sourceNumbers.clear();
+         for each(auto source in target->connectedSources())
+            sourceNumbers.insert(sourceNumbers.end(), source->number());
+
+         glowConnection->setSources(libember::ber::ObjectIdentifier(sourceNumbers.begin(), sourceNumbers.end()));
+         glowConnection->setDisposition(libember::glow::ConnectionDisposition::Modified);
+         glowConnections->insert(glowConnections->end(), glowConnection);
+      }
+
+      return glowMatrix;
+   }
+
+   void Dispatcher::indexMatrices(model::Element* parent)
+   {
+      for each(auto child in *parent)
+      {
+         auto const matrix = dynamic_cast<model::matrix::Matrix*>(child);
+
+         // Element::path caches the path, so the consumer threads only read it
+         if(matrix != nullptr)
+         {
+            m_matrices.insert(std::make_pair(matrix->path(), matrix));
+            matrix->publishConnections();
+         }
+
+         indexMatrices(child);
+      }
+   }
+
+   model::matrix::Matrix* Dispatcher::findMatrix(util::Oid const& path) const
+   {
+      auto const result = m_matrices.find(path);
+      return result != m_matrices.end() ? result->second : nullptr;
+   }
+
+   bool Dispatcher::writeSnapshotResponse(libember::glow::GlowContainer const* glow, Consumer* source) const
+   {
+      auto walker = SnapshotWalker(this);
+      walker.walk(glow);
+
+      if(walker.isSnapshotRequest() == false)
+         return false;
+
+      auto matrices = SnapshotValidator::MatrixVector();
+
+      // the interest is registered first, so that any change published after
+      // the snapshots have been acquired is notified to the consumer
+      for each(auto const& request in walker.requests())
+      {
+         source->addInterest(request.matrix->path());
+         matrices.push_back(request.matrix);
+      }
+
+      for(auto attempt = 0; attempt < SnapshotAttempts; attempt++)
+      {
+         auto snapshots = SnapshotValidator::SnapshotVector();
+         auto writer = libember::glow::GlowWriter();
+
+         writer.beginRoot();
+
+         for each(auto const& request in walker.requests())
+         {
+            auto const snapshot = request.matrix->connectionSnapshot();
+
+            if(snapshot.isNull())
+               return false;
+
+            // only the connections are encoded for every response, the
+            // metadata of the matrix is taken from the cache
+            auto converter = ElementToGlowConverter(writer, &m_matrixMetadata, request.dirFieldMask, true, snapshot.data());
+            request.matrix->accept(&converter);
+            snapshots.push_back(snapshot);
+         }
+
+         writer.endRoot();
+
+         auto const encoder = Encoder::createEmberMessage(writer);
+
+         // connections changed while encoding are notified before the
+         // response would arrive, so the response is encoded again
+         if(source->writeSnapshot(encoder, SnapshotValidator(matrices, snapshots)))
+            return true;
+      }
 
-      for each(auto packet in encoder)
-         m_server.write(packet.begin(), packet.end());
+      return false;
    }
 }
@@ -1,28 +1,113 @@
 #ifndef __TINYEMBERROUTER_GLOW_DISPATCHER_H
 #define __TINYEMBERROUTER_GLOW_DISPATCHER_H
 
+#include <deque>
+#include <unordered_map>
 #include <QtCore>
+#include <s101/util/TimerWheel.hpp>
 #include "../model/NotificationSink.h"
 #include "../net/TcpClientFactory.h"
 #include "../net/TcpServer.h"
 #include "Walker.h"
 #include "../model/Element.h"
 #include "../model/ElementVisitor.h"
+#include "../model/matrix/ConnectionSnapshot.h"
+#include "../model/StateJournal.h"
+#include "../util/ChangeLog.h"
+#include "../util/LatencyTrace.h"
+#include "../util/Metrics.h"
 
 namespace glow
 {
+   class Backend;
+
    /**
      * The application's Ember+ front-end.
      * Aggregates net::TcpServer to listen for inbound connections from consumers.
      * Handles inbound Ember+ packages.
      * Creates and dispatches spontaneous Ember+ updates to consumers.
+     * Forwards requests addressing the subtrees of mounted backend routers
+     * and merges the elements and notifications of the backends into its
+     * own tree, so that several router processes appear as one provider.
      * Implements two interfaces: model::NotificationSink and net::TcpClientFactory.
      */
    class Dispatcher : public model::NotificationSink, public net::TcpClientFactory
    {
+      friend class Backend;
       friend class Consumer;
       friend class Walker;
 
+   public:
+      /**
+        * The default duration of the time slices requests are applied in,
+        * in microseconds.
+        */
+      static const int DefaultRequestTimeSlice = 10000;
+
+      /**
+        * The default number of root elements applied at once before the
+        * time slice is checked.
+        */
+      static const int DefaultRequestSliceElements = 64;
+
+      /**
+        * The default time in milliseconds after which a concurrent invocation
+        * that has not returned is answered with a failed result.
+        */
+      static const int DefaultInvocationTimeout = 30000;
+
+
+   // ========================================================
+   //
+   // Dispatcher::DirectoryResponse Declaration
+   //
+   // ========================================================
+
+   private:
+      /**
+        * Identifies a directory request by the queried path, the requested
+        * fields and whether the descendants have been requested as well.
+        */
+      struct DirectoryKey
+      {
+         DirectoryKey(util::Oid const& path, int dirFieldMask, bool isRecursive)
+            : path(path)
+            , dirFieldMask(dirFieldMask)
+            , isRecursive(isRecursive)
+         {}
+
+         inline bool operator==(DirectoryKey const& other) const
+         {
+            return dirFieldMask == other.dirFieldMask && isRecursive == other.isRecursive && path == other.path;
+         }
+
+         util::Oid path;
+         int dirFieldMask;
+         bool isRecursive;
+      };
+
+      struct DirectoryKeyHash
+      {
+         inline std::size_t operator()(DirectoryKey const& key) const
+         {
+            return (key.path.hash() * 31 + static_cast<std::size_t>(key.dirFieldMask)) * 2 + (key.isRecursive ? 1 : 0);
+         }
+      };
+
+      /**
+        * The encoded response to a directory request, which is written
+        * unchanged to every consumer sending the same request while the
+        * response is current. Each message holds the merged s101 frames
+        * of one chunk of the response.
+        */
+      struct DirectoryResponse
+      {
+         std::vector<QByteArray> messages;
+         std::vector<util::Oid> interests;
+      };
+
+      typedef std::unordered_map<DirectoryKey, DirectoryResponse, DirectoryKeyHash> DirectoryResponseCache;
+
 
    // ========================================================
    //
@@ -47,7 +132,7 @@ namespace glow
 
       protected:
          /**
-           * Overridden to respond to GetDirectory commands.
+           * Overridden to respond to GetDirectory and GetChangesSince commands.
            */
          virtual void handleCommand(libember::glow::GlowCommand const* glow, libember::ber::ObjectIdentifier const& path);
 
@@ -61,9 +146,417 @@ namespace glow
            */
          virtual void handleMatrix(libember::glow::GlowMatrixBase const* glow, libember::ber::ObjectIdentifier const& path);
 
+      private:
+         /**
+           * The number of encoded bytes after which a message is written
+           * to the consumer while responding to a GetDirectoryRecursive
+           * command.
+           */
+         static const std::size_t DirectoryChunkSize = 64 * 1024;
+
+         /**
+           * Appends all descendants of @p parent to the root collection of
+           * @p writer in the order of a depth-first walk, and registers the
+           * interest of the consumer in each node. Whenever @p writer contains
+           * DirectoryChunkSize bytes, the message is written to the consumer
+           * and a new one is begun.
+           * @param parent The element whose descendants to report.
+           * @param dirFieldMask The EmberPlus-Glow.FieldFlags values
+           *     indicating the fields to report.
+           * @param writer The writer to append the elements to.
+           */
+         void writeDescendants(model::Element* parent, int dirFieldMask, libember::glow::GlowWriter& writer);
+
+         /**
+           * Ends the root collection of @p writer, writes the chunk of a
+           * directory response to the consumer and appends the encoded
+           * chunk to the response being recorded.
+           * @param writer The writer containing the chunk.
+           */
+         void writeDirectory(libember::glow::GlowWriter& writer);
+
+         /**
+           * Registers the interest of the consumer in a node reported
+           * by a directory response and records it with the response.
+           * @param path The path of the reported node.
+           */
+         void addInterest(util::Oid const& path);
+
+         /**
+           * Appends the elements owned by the mounted backends to a
+           * directory response on the root. If the descendants have been
+           * requested as well, the command is forwarded to each backend,
+           * which answers for its own subtree.
+           * @param glow The GetDirectory command on the root.
+           * @param writer The writer to append the elements to.
+           */
+         void writeBackends(libember::glow::GlowCommand const* glow, libember::glow::GlowWriter& writer);
+
       private:
          Dispatcher* m_dispatcher;
          Consumer* m_source;
+         DirectoryResponse* m_response;
+      };
+
+
+   // ========================================================
+   //
+   // Dispatcher::SnapshotWalker Declaration
+   //
+   // ========================================================
+
+   private:
+      /**
+        * Tests within the thread of a consumer whether a Glow tree can be
+        * answered from the connection snapshots of the matrices, which is the
+        * case if it contains nothing but GetDirectory commands on matrices.
+        */
+      class SnapshotWalker : public glow::Walker
+      {
+      public:
+         /**
+           * A GetDirectory command on a matrix.
+           */
+         struct Request
+         {
+            Request(model::matrix::Matrix* matrix, int dirFieldMask)
+               : matrix(matrix)
+               , dirFieldMask(dirFieldMask)
+            {}
+
+            model::matrix::Matrix* matrix;
+            int dirFieldMask;
+         };
+
+         typedef std::vector<Request> RequestVector;
+
+      public:
+         /**
+           * Creates a new instance of Dispatcher::SnapshotWalker.
+           * @param dispatcher Pointer to the owner Dispatcher object.
+           */
+         explicit SnapshotWalker(Dispatcher const* dispatcher);
+
+         /**
+           * Returns true if the walked tree can be answered from the
+           * connection snapshots.
+           * @return True if the walked tree only contains GetDirectory
+           *     commands on matrices.
+           */
+         inline bool isSnapshotRequest() const { return m_isSnapshotRequest && m_requests.empty() == false; }
+
+         /**
+           * Returns the GetDirectory commands of the walked tree.
+           * @return The GetDirectory commands of the walked tree.
+           */
+         inline RequestVector const& requests() const { return m_requests; }
+
+      protected:
+         /**
+           * Overridden to collect GetDirectory commands on matrices.
+           */
+         virtual void handleCommand(libember::glow::GlowCommand const* glow, libember::ber::ObjectIdentifier const& path);
+
+         /**
+           * Overridden to reject trees that contain parameter values.
+           */
+         virtual void handleParameter(libember::glow::GlowParameterBase const* glow, libember::ber::ObjectIdentifier const& path);
+
+         /**
+           * Overridden to reject trees that contain matrix connects.
+           */
+         virtual void handleMatrix(libember::glow::GlowMatrixBase const* glow, libember::ber::ObjectIdentifier const& path);
+
+      private:
+         Dispatcher const* m_dispatcher;
+         RequestVector m_requests;
+         bool m_isSnapshotRequest;
+      };
+
+
+   // ========================================================
+   //
+   // Dispatcher::RequestQueue Declaration
+   //
+   // ========================================================
+
+   private:
+      /**
+        * Forwards the Glow trees decoded by the consumer threads to the
+        * thread owning the DOM, which is the thread the dispatcher has
+        * been created in. All requests are applied by this thread, one
+        * after the other, so the DOM does not require any locking.
+        * A consumer may post further requests before the previous ones
+        * have been answered. Identical directory requests that are in the
+        * queue at the same time share a single encoded response, which is
+        * discarded when the queue runs empty.
+        * The requests are applied in time slices, so that a large request
+        * does not block the event loop of the thread owning the DOM. When
+        * a slice has been used up, the remaining root elements of the
+        * current request and all requests behind it are kept in a backlog,
+        * which is resumed by a posted event once the other events of the
+        * thread have been processed.
+        * The queue also supervises the concurrent invocations. Each one is
+        * a timer on a libs101::util::TimerWheel, which is advanced by a
+        * single Qt timer running while invocations are pending.
+        */
+      class RequestQueue : public QObject
+      {
+      public:
+         /**
+           * Creates a new instance of Dispatcher::RequestQueue.
+           * @param dispatcher Pointer to the owner Dispatcher object.
+           */
+         explicit RequestQueue(Dispatcher* dispatcher);
+
+         /** Destructor, discards the requests that have not been applied. */
+         virtual ~RequestQueue();
+
+         /**
+           * Enqueues a decoded Glow tree. This method may be called from
+           * any thread.
+           * @param glow The decoded Glow tree. The queue takes ownership.
+           * @param source Pointer to the consumer that sent the tree.
+           * @param trace The trace of the request, or nullptr if latencies
+           *     are not traced. The queue takes ownership.
+           */
+         void post(libember::glow::GlowContainer* glow, Consumer* source, util::LatencyTrace* trace);
+
+         /**
+           * Sets the time spent applying requests before the queue yields
+           * to the other events of the thread owning the DOM.
+           * @param microseconds The duration of a time slice, 0 applies
+           *     every request at once.
+           * @param elements The number of root elements applied at once
+           *     before the time slice is checked, at least 1.
+           */
+         void setTimeSlice(int microseconds, int elements);
+
+         /**
+           * Sets the time after which a concurrent invocation that has not
+           * returned is answered with a failed result. The result arriving
+           * later is discarded.
+           * @param milliseconds The timeout, 0 waits for every invocation
+           *     to return.
+           */
+         void setInvocationTimeout(int milliseconds);
+
+         /**
+           * Registers a concurrent invocation whose result is expected by
+           * @p source and starts its timeout. Must be called by the thread
+           * owning the DOM.
+           * @param invocationId The identifier of the invocation.
+           * @param source The consumer that sent the invocation.
+           * @return The key passed along with the result, or 0 if no
+           *     timeout is supervised.
+           */
+         quint64 trackInvocation(int invocationId, Consumer* source);
+
+      protected:
+         /**
+           * Overridden to pass queued Glow trees to Dispatcher::receiveGlow.
+           */
+         virtual bool event(QEvent* event);
+
+      private:
+         struct Request;
+         struct PendingInvocation;
+
+         typedef std::unordered_map<quint64, PendingInvocation*> PendingInvocationMap;
+
+         /**
+           * Applies the requests in the backlog until it is empty or the
+           * current time slice has been used up, in which case a resume
+           * event is posted.
+           */
+         void processBacklog();
+
+         /**
+           * Applies the next root elements of @p request until all of them
+           * have been applied or @p deadline has passed.
+           * @param request The request to apply.
+           * @param deadline The end of the current time slice as returned by
+           *     util::LatencyTrace::now(), or 0 to apply the request at once.
+           * @return True if the request has been applied completely.
+           */
+         bool applySlice(Request* request, qint64 deadline);
+
+         /**
+           * Answers an invocation that has not returned in time with a failed
+           * result and stops tracking it.
+           * @param invocation The invocation that has timed out.
+           */
+         void expireInvocation(PendingInvocation* invocation);
+
+         /**
+           * Starts the Qt timer for the next tick the timer wheel has to be
+           * advanced at, or stops it if no timer is scheduled.
+           */
+         void scheduleWheelTimer();
+
+         /**
+           * Returns the current tick of the timer wheel, which counts the
+           * milliseconds since the queue has been created.
+           * @return The current tick.
+           */
+         libs101::util::TimerWheel::tick_type currentTick() const;
+
+      private:
+         Dispatcher* m_dispatcher;
+         QAtomicInt m_pending;
+         std::deque<Request*> m_backlog;
+         qint64 m_timeSlice;
+         int m_sliceElements;
+         bool m_isResumePosted;
+         QElapsedTimer m_clock;
+         libs101::util::TimerWheel m_timers;
+         QBasicTimer m_wheelTimer;
+         PendingInvocationMap m_invocations;
+         quint64 m_nextInvocationKey;
+         int m_invocationTimeout;
+      };
+
+
+   // ========================================================
+   //
+   // Dispatcher::Metrics Declaration
+   //
+   // ========================================================
+
+   private:
+      /**
+        * The metrics updated by the dispatcher and its consumers. They are
+        * created once when metrics are enabled and updated by any thread
+        * without locking. Messages are labelled with the type of their
+        * first root element. A message sent to several consumers at once
+        * is counted once.
+        */
+      struct Metrics
+      {
+         /**
+           * The indices of the message counters. The types of the root
+           * elements are indexed by their EmberPlus-Glow application tag.
+           */
+         enum
+         {
+            /** Messages of any type without a counter of its own. */
+            OtherIndex = 0,
+
+            /** Responses encoded from a GlowWriter instead of a tree. */
+            ResponseIndex = libember::glow::GlowType::InvocationResult + 1,
+
+            IndexCount
+         };
+
+         /**
+           * Creates the metrics.
+           * @param registry The registry to create the metrics with.
+           */
+         explicit Metrics(util::MetricsRegistry* registry);
+
+         /**
+           * Counts a message received from a consumer.
+           * @param glow The decoded message.
+           */
+         void countReceived(libember::glow::GlowContainer const* glow);
+
+         /**
+           * Counts a message sent to consumers.
+           * @param glow The message that has been encoded.
+           */
+         void countSent(libember::glow::GlowContainer const* glow);
+
+         /**
+           * Counts a response that has not been encoded from a tree.
+           */
+         void countSentResponse();
+
+         /**
+           * Returns the index of the counters of a message.
+           * @param glow The message.
+           * @return The index of the counters.
+           */
+         static int indexOf(libember::glow::GlowContainer const* glow);
+
+         util::Counter* received[IndexCount];
+         util::Counter* sent[IndexCount];
+         util::Histogram* stages[util::LatencyStage::Count];
+         util::Gauge* queueDepth;
+      };
+
+
+   // ========================================================
+   //
+   // Dispatcher::MatrixMetadataCache Declaration
+   //
+   // ========================================================
+
+   private:
+      /**
+        * Caches the encoded metadata of matrices, which consists of the
+        * contents and, if the complete matrix is enquired, the targets and
+        * sources. The metadata does not change while the DOM is in use, so
+        * it is encoded once for each matrix and set of requested fields and
+        * only the connections are encoded for every response.
+        * All methods may be called by any thread.
+        */
+      class MatrixMetadataCache
+      {
+      public:
+         /**
+           * Looks up the metadata of a matrix.
+           * @param matrix The matrix to look up.
+           * @param dirFieldMask The EmberPlus-Glow.FieldFlags values the
+           *     metadata has been encoded with.
+           * @param isComplete True if the metadata contains the signals.
+           * @param metadata Receives the encoded metadata if it is cached.
+           * @return True if the metadata is cached.
+           */
+         bool find(model::matrix::Matrix const* matrix, int dirFieldMask, bool isComplete, QByteArray& metadata) const;
+
+         /**
+           * Stores the metadata of a matrix.
+           * @see find()
+           */
+         void insert(model::matrix::Matrix const* matrix, int dirFieldMask, bool isComplete, QByteArray const& metadata);
+
+         /**
+           * Discards the metadata of all matrices. Called when the DOM is replaced.
+           */
+         void clear();
+
+      private:
+         struct Key
+         {
+            Key(model::matrix::Matrix const* matrix, int dirFieldMask, bool isComplete)
+               : matrix(matrix)
+               , dirFieldMask(dirFieldMask)
+               , isComplete(isComplete)
+            {}
+
+            inline bool operator==(Key const& other) const
+            {
+               return matrix == other.matrix && dirFieldMask == other.dirFieldMask && isComplete == other.isComplete;
+            }
+
+            model::matrix::Matrix const* matrix;
+            int dirFieldMask;
+            bool isComplete;
+         };
+
+         struct KeyHash
+         {
+            inline std::size_t operator()(Key const& key) const
+            {
+               return (reinterpret_cast<std::size_t>(key.matrix) * 31 + static_cast<std::size_t>(key.dirFieldMask)) * 2 + (key.isComplete ? 1 : 0);
+            }
+         };
+
+         typedef std::unordered_map<Key, QByteArray, KeyHash> EntryMap;
+
+      private:
+         mutable QMutex m_mutex;
+         EntryMap m_entries;
       };
 
 
@@ -75,96 +568,123 @@ namespace glow
 
    private:
       /**
-        * Implements interface ElementVisitor to create Glow objects
-        * from Element objects.
-        * Used by method Dispatcher::elementToGlow.
-        * After visiting the Element object, the created Glow object
-        * must be fetched by calling detachResult().
+        * Implements interface ElementVisitor to encode Element objects
+        * directly into a Glow message, without creating Glow objects.
+        * Used by method Dispatcher::writeElement.
+        * Each visited element is appended to the collection that is
+        * currently open in the writer.
         */
       class ElementToGlowConverter : public model::ElementVisitor
       {
       public:
          /**
            * Creates a new instance of ElementToGlowConverter.
+           * @param writer The writer to append the elements to.
+           * @param matrices The cache of the matrix metadata, or nullptr if
+           *     the metadata is to be encoded for every matrix.
            * @param dirFieldMask The EmberPlus-Glow.FieldFlags values
-           *     indicating the fields to set on the Glow object.
-           * @param isCompleteMatrixEnquired True if the Glow object is
-           *     to be created in response to a GetDirectory command
+           *     indicating the fields to write.
+           * @param isCompleteMatrixEnquired True if the element is
+           *     written in response to a GetDirectory command
            *     on a matrix element.
-           *     If true, GlowMatrix objects will be rendered including
+           *     If true, matrices will be written including
            *     The "connections" and (if applicable) the "targets" and
            *     "sources" fields.
+           * @param connections The snapshot to read the "connections" field
+           *     of a matrix from, or nullptr to read the connections from the
+           *     targets of the matrix.
            */
-         ElementToGlowConverter(int dirFieldMask, bool isCompleteMatrixEnquired);
-
-         /**
-           * Fetches the Glow object previously created by one of the
-           * visit() overloads and detaches the 
-           * @return the Glow object previously created by one of the
-           *      visit() overloads. The caller is responsible for
-           *      deleting the returned object.
-           */
-         libember::glow::GlowElement* detachResult();
+         ElementToGlowConverter(libember::glow::GlowWriter& writer, MatrixMetadataCache* matrices, int dirFieldMask, bool isCompleteMatrixEnquired, model::matrix::ConnectionSnapshot const* connections = nullptr);
 
       public:
          /**
-           * Overriden to create GlowQualifiedNode objects from model::Node objects.
+           * Overriden to write a qualified node.
            */
          virtual void visit(model::Node* element);
 
          /**
-           * Overriden to create GlowQualifiedParameter objects from model::Parameter objects.
+           * Overriden to write a qualified parameter.
            */
          virtual void visit(model::IntegerParameter* element);
 
          /**
-           * Overriden to create GlowQualifiedParameter objects from model::Parameter objects.
+           * Overriden to write a qualified parameter.
            */
          virtual void visit(model::StringParameter* element);
 
          /**
-           * Overriden to create GlowQualifiedFunction objects from model::Function objects.
+           * Overriden to write a qualified function. Functions are still
+           * converted to a GlowQualifiedFunction, which is appended encoded,
+           * since the writer does not support their tuple descriptions.
            */
          virtual void visit(model::Function* element);
 
          /**
-           * Overriden to create GlowQualifiedMatrix objects from model::Matrix objects.
+           * Overriden to write a qualified matrix.
            */
          virtual void visit(model::matrix::OneToNLinearMatrix* element);
 
          /**
-           * Overriden to create GlowQualifiedMatrix objects from model::Matrix objects.
+           * Overriden to write a qualified matrix.
            */
          virtual void visit(model::matrix::NToNLinearMatrix* element);
 
          /**
-           * Overriden to create GlowQualifiedMatrix objects from model::Matrix objects.
+           * Overriden to write a qualified matrix.
            */
          virtual void visit(model::matrix::NToNNonlinearMatrix* element);
 
          /**
-           * Overriden to create GlowQualifiedMatrix objects from model::Matrix objects.
+           * Overriden to write a qualified matrix.
            */
          virtual void visit(model::matrix::DynamicNToNLinearMatrix* element);
 
+         /**
+           * Writes the "gain" parameter of a crosspoint, reading the value
+           * directly from the matrix without emitting a parameter element.
+           * @param matrix The matrix that owns the crosspoint.
+           * @param gainPath The path of the crosspoint's "gain" parameter.
+           * @param index The index of the crosspoint.
+           */
+         void visitCrosspointGain(model::matrix::DynamicNToNLinearMatrix const* matrix, util::Oid const& gainPath, int index);
+
       private:
          inline bool hasDirField(int value) const { return (m_dirFieldMask & value) == value; }
-         libember::glow::GlowMatrixBase* MatrixToGlow(model::matrix::Matrix const* element);
 
-         template<typename GlowElementType>
-         inline GlowElementType* store(GlowElementType* glow)
-         {
-            if(m_result != nullptr)
-               throw std::runtime_error("Result of previous operation has not been detached!");
+         /**
+           * Looks up the metadata of @p element. If it is not cached, begins
+           * to encode it and writes the contents all matrix types have in
+           * common, so that the caller can add the contents and signals
+           * specific to the type of the matrix.
+           * @param element The matrix to write.
+           * @return True if the caller has to complete the metadata.
+           */
+         bool beginMatrix(model::matrix::Matrix const* element);
 
-            m_result = glow;
-            return glow;
-         }
+         /**
+           * Caches the metadata of @p element if it has been encoded and
+           * writes the matrix, consisting of the metadata and the connections.
+           * @param element The matrix to write.
+           */
+         void endMatrix(model::matrix::Matrix const* element);
+
+         /**
+           * Writes the "connections" field of @p element into the matrix
+           * that is currently open in the writer.
+           * @param element The matrix whose connections to write.
+           */
+         void writeConnections(model::matrix::Matrix const* element);
 
       private:
+         libember::glow::GlowWriter& m_writer;
+         MatrixMetadataCache* m_matrices;
          int m_dirFieldMask;
          bool m_isCompleteMatrixEnquired;
-         libember::glow::GlowElement* m_result;
+         model::matrix::ConnectionSnapshot const* m_connections;
+         libember::glow::GlowWriter m_metadata;
+         libember::glow::GlowWriter::size_type m_metadataBegin;
+         bool m_isEncodingMetadata;
+         QByteArray m_metadataBytes;
       };
 
 
@@ -183,6 +703,9 @@ namespace glow
         */
       Dispatcher(QObject* parent, int port);
 
+      /** Destructor */
+      ~Dispatcher();
+
       // --------------------- properties
       /**
         * Returns the root of the DOM tree.
@@ -191,14 +714,115 @@ namespace glow
       inline model::Element* root() const { return m_root; }
 
       /**
-        * Sets the root of the DOM tree.
+        * Sets the root of the DOM tree and publishes the connection snapshots
+        * of all matrices it contains. The root must be set before the first
+        * consumer connects.
         * @param value The root of the DOM tree.
         */
-      inline void setRoot(model::Element* value)
+      void setRoot(model::Element* value);
+
+      /**
+        * Returns the sink receiving the latencies of all requests.
+        * @return The latency sink, or nullptr if latencies are not traced.
+        */
+      inline util::LatencySink* latencySink() const { return m_latencySink; }
+
+      /**
+        * Sets the sink receiving the latencies of all requests. Tracing is
+        * disabled as long as no sink is set. The sink must be set before
+        * the first consumer connects.
+        * @param value The latency sink, or nullptr to disable tracing.
+        */
+      inline void setLatencySink(util::LatencySink* value)
       {
-         m_root = value;
+         m_latencySink = value;
       }
 
+      /**
+        * Enables the metrics of the dispatcher and of its TcpServer. Requests
+        * are traced while metrics are enabled, even if no latency sink is set.
+        * The metrics must be enabled before the first consumer connects.
+        * @param registry The registry to create the metrics with, which must
+        *     outlive the dispatcher.
+        */
+      void setMetrics(util::MetricsRegistry* registry);
+
+      /**
+        * Returns true if the latencies of requests are traced, which is the
+        * case if a latency sink is set or metrics are enabled.
+        * @return True if requests are traced.
+        */
+      inline bool isTracing() const { return m_latencySink != nullptr || m_metrics != nullptr; }
+
+      /**
+        * Returns the journal recording all connection and parameter changes.
+        * @return The journal, or nullptr if changes are not recorded.
+        */
+      inline model::StateJournal* journal() const { return m_journal; }
+
+      /**
+        * Sets the journal recording all connection and parameter changes.
+        * The journal should be set after it has restored the DOM, so that
+        * the restored state is not recorded again.
+        * @param value The journal, or nullptr to stop recording changes.
+        */
+      inline void setJournal(model::StateJournal* value)
+      {
+         m_journal = value;
+      }
+
+      /**
+        * Sets the minimum interval between two value notifications of the same
+        * parameter sent to a consumer. Values changing faster are coalesced by
+        * each consumer, which then receives the latest value once the interval
+        * has elapsed. The interval applies to consumers connecting afterwards.
+        * @param milliseconds The minimum interval, 0 sends every change.
+        */
+      inline void setMinimumNotificationInterval(int milliseconds)
+      {
+         m_minimumNotificationInterval = milliseconds;
+      }
+
+      /**
+        * Sets the time the thread owning the DOM spends applying requests
+        * before it processes its other events, like the messages of the
+        * backends and the results of concurrent invocations. A request
+        * taking longer is applied in several parts, each part reporting
+        * its parameter changes in a message of its own.
+        * @param microseconds The duration of a time slice, 0 applies
+        *     every request at once. The default is
+        *     DefaultRequestTimeSlice.
+        * @param elements The number of root elements applied at once
+        *     before the time slice is checked, at least 1.
+        */
+      inline void setRequestTimeSlice(int microseconds, int elements = DefaultRequestSliceElements)
+      {
+         m_requests.setTimeSlice(microseconds, elements);
+      }
+
+      /**
+        * Sets the time after which a concurrent invocation that has not
+        * returned is answered with a failed result, so that a consumer
+        * waiting for the result is not blocked by a function that hangs.
+        * @param milliseconds The timeout, 0 waits for every invocation to
+        *     return. The default is DefaultInvocationTimeout.
+        */
+      inline void setInvocationTimeout(int milliseconds)
+      {
+         m_requests.setInvocationTimeout(milliseconds);
+      }
+
+      /**
+        * Mounts the subtree of a backend router as the root element @p number.
+        * The backend must report its subtree as this root element, so that
+        * requests and notifications are forwarded without changing any paths.
+        * The local DOM must not contain an element with the same number.
+        * @param number The number of the root element owned by the backend.
+        * @param host The host name or address of the backend.
+        * @param port The port the backend listens on.
+        */
+      void mountBackend(int number, QString const& host, quint16 port);
+
 
       // --------------------- model::NotificationSink implementation
       /**
@@ -207,6 +831,12 @@ namespace glow
         */
       virtual void notifyMatrixConnection(model::matrix::Matrix* matrix, model::matrix::Signal* target, void* state);
 
+      /**
+        * Implemented to send a single GlowQualifiedMatrix object containing
+        * all changed connections to all connected consumers.
+        */
+      virtual void notifyMatrixConnections(model::matrix::Matrix* matrix, std::vector<model::matrix::Signal*> const& targets, void* state);
+
       /**
         * Implemented to send GlowQualifiedParameter objects to all connected consumers
         * when a parameter value has changed in the DOM.
@@ -219,6 +849,19 @@ namespace glow
         */
       virtual void notifyParameterValueChanged(util::Oid const& parameterPath, std::string const& value);
 
+      /**
+        * Implemented to defer parameter value notifications until the
+        * transaction is committed.
+        */
+      virtual void beginTransaction();
+
+      /**
+        * Implemented to send the last value of every parameter changed during
+        * the transaction to each consumer in a single message, which contains
+        * the parameters the consumer is interested in.
+        */
+      virtual void commitTransaction();
+
 
       // --------------------- net::TcpClientFactory implementation
       /**
@@ -227,14 +870,261 @@ namespace glow
       virtual net::TcpClient* create(QTcpSocket* socket);
 
    private:
+      /**
+        * The new value of a parameter.
+        */
+      struct ValueChange
+      {
+         explicit ValueChange(util::Oid const& path)
+            : path(path)
+            , isString(false)
+            , integer(0)
+         {}
+
+         util::Oid path;
+         bool isString;
+         int integer;
+         std::string text;
+      };
+
+      typedef std::vector<ValueChange> ValueChangeVector;
+      typedef std::unordered_map<util::Oid, ValueChangeVector::size_type, util::OidHash> ValueChangeIndex;
+
+      void postGlow(libember::glow::GlowContainer* glow, Consumer* source, util::LatencyTrace* trace);
+
+      /**
+        * Records a parameter value change and sends it to the interested
+        * consumers, or keeps it until the current transaction is committed.
+        * A change replaces an earlier change of the same parameter made
+        * within the same transaction.
+        * @param change The new value of the parameter.
+        */
+      void notifyValueChanged(ValueChange const& change);
+
+      /**
+        * Records the value changes kept by the current transaction and writes
+        * them to the interested consumers, one message per consumer.
+        */
+      void writeValueChanges();
+
+      /**
+        * Appends a parameter value change to the journal and the change log.
+        * @param change The new value of the parameter.
+        */
+      void recordValueChange(ValueChange const& change);
+
+      /**
+        * Creates a GlowQualifiedParameter containing a new parameter value.
+        * @param change The new value of the parameter.
+        * @return The new GlowQualifiedParameter. The caller is responsible for deleting it.
+        */
+      static libember::glow::GlowQualifiedParameter* valueToGlow(ValueChange const& change);
+
+      /**
+        * Encodes @p glow into a single buffer of merged s101 frames.
+        * @param glow The tree to encode.
+        * @return The encoded message.
+        */
+      QByteArray encodeMessage(libember::glow::GlowContainer const* glow) const;
+
+      /**
+        * Invokes a concurrent function on a worker thread. The result is
+        * written to @p source by the thread owning the DOM, unless the
+        * consumer has disconnected in the meantime.
+        * @param function The function to invoke.
+        * @param arguments The argument values of the invocation.
+        * @param invocationId The identifier of the invocation, or a negative
+        *     value if the consumer does not expect a result.
+        * @param source The consumer that sent the invocation.
+        */
+      void invokeConcurrently(model::Function const* function, util::VariantValueVector const& arguments, int invocationId, Consumer* source);
+
       void receiveGlow(libember::glow::GlowContainer const* glow, Consumer* source);
-      libember::glow::GlowElement* elementToGlow(model::Element* element, int dirFieldMask, bool isCompleteMatrixEnquired) const;
 
-      void writeGlow(libember::glow::GlowContainer const* glow);
+      /**
+        * Applies a range of the root elements of a request, as if they had
+        * been received as a request of their own.
+        * @param first Refers to the first root element to apply.
+        * @param last Refers to the position one past the last root element to apply.
+        * @param source The consumer that sent the request.
+        */
+      void receiveElements(libember::glow::GlowContainer::const_child_iterator first, libember::glow::GlowContainer::const_child_iterator last, Consumer* source);
+
+      /**
+        * Forwards a tree received from a backend to all consumers that have
+        * queried one of the elements it contains or their parents. Invocation
+        * results are forwarded to all consumers, since the backend does not
+        * know which consumer has sent the invocation.
+        * @param glow The tree received from the backend.
+        * @param source The backend that sent the tree.
+        */
+      void receiveBackendGlow(libember::glow::GlowContainer const* glow, Backend* source);
+
+      /**
+        * Finds the backend owning the element at @p path.
+        * @param path The path of an element.
+        * @return The backend owning the element, or nullptr if the element
+        *     is part of the local DOM or its backend is not available.
+        */
+      Backend* findBackend(util::Oid const& path) const;
+
+      /**
+        * Appends @p element to the collection that is currently open in @p writer.
+        * @param writer The writer to append the element to.
+        * @param element The element to write.
+        * @param dirFieldMask The EmberPlus-Glow.FieldFlags values indicating the fields to write.
+        * @param isCompleteMatrixEnquired True if a matrix is to be written with its signals and connections.
+        */
+      void writeElement(libember::glow::GlowWriter& writer, model::Element* element, int dirFieldMask, bool isCompleteMatrixEnquired) const;
+
+      /**
+        * Calls @p apply, which applies a request or a part of it, and adds the
+        * time spent dispatching it and encoding its responses to @p trace.
+        * @param trace The trace of the request, or nullptr if latencies are not traced.
+        * @param apply A function object applying the request.
+        */
+      template<typename Function>
+      void dispatchTraced(util::LatencyTrace* trace, Function const& apply);
+
+      /**
+        * Records the durations of a request that has been applied completely
+        * in the metrics and passes its trace to the latency sink.
+        * @param trace The trace of the request, or nullptr if latencies are not traced.
+        */
+      void completeTrace(util::LatencyTrace const* trace);
+
+      /**
+        * Finds the dynamic matrix owning the crosspoint identified by @p path.
+        * @param path The path of a crosspoint node or of its "gain" parameter.
+        * @param index Receives the index of the crosspoint.
+        * @param isGainParameter Receives the value true if @p path points to
+        *     the "gain" parameter of the crosspoint.
+        * @return The matrix owning the crosspoint, or nullptr if @p path does
+        *     not point to a crosspoint of a dynamic matrix.
+        */
+      model::matrix::DynamicNToNLinearMatrix* findCrosspoint(util::Oid const& path, int& index, bool& isGainParameter) const;
+      void writeCrosspointGain(libember::glow::GlowWriter& writer, model::matrix::DynamicNToNLinearMatrix const* matrix, util::Oid const& gainPath, int index, int dirFieldMask) const;
+
+      /**
+        * Encodes @p glow once and sends it to all consumers that have queried
+        * the element at @p path or its parent.
+        * @param glow The notification to send.
+        * @param path The path of the element that changed.
+        * @param isSupersedable If true, a notification for the same path that is
+        *     still queued for a slow consumer is replaced by this one.
+        */
+      void writeGlow(libember::glow::GlowContainer const* glow, util::Oid const& path, bool isSupersedable = false);
+
+      /**
+        * Answers a GetChangesSince command. If the change log contains all
+        * changes made after @p sequence, the changed elements are written to
+        * @p source, followed by a GetChangesSince command carrying the current
+        * sequence number. Since the consumer has not queried any element on
+        * its new connection, its interest in all nodes is registered as if it
+        * had queried the whole tree. If changes are missing, the reply carries
+        * no sequence number, so that the consumer queries the tree again.
+        * @param sequence The sequence number presented by the consumer, or -1
+        *     to query the current sequence number only.
+        * @param source The consumer that sent the command.
+        */
+      void writeChangesSince(long sequence, Consumer* source);
+
+      /**
+        * Writes the current state of the elements affected by @p changes to
+        * @p source. Parameters are reported once with their current value,
+        * matrices with the current connections of the changed targets.
+        * @param changes The changes to report, oldest first.
+        * @param source The consumer to write the elements to.
+        */
+      void writeChanges(util::ChangeLog::EntryVector const& changes, Consumer* source);
+
+      /**
+        * Registers the interest of @p source in @p parent and all nodes below it.
+        * @param parent The element to register the interest in.
+        * @param source The consumer to register the interest of.
+        */
+      void addInterests(model::Element* parent, Consumer* source) const;
+
+      /**
+        * Creates a GlowQualifiedMatrix containing the connections of @p targets.
+        * @param matrix The matrix owning the targets.
+        * @param targets The targets whose connections to report.
+        * @return The new GlowQualifiedMatrix. The caller is responsible for deleting it.
+        */
+      libember::glow::GlowQualifiedMatrix* connectionsToGlow(model::matrix::Matrix const* matrix, std::vector<model::matrix::Signal*> const& targets) const;
+
+      /**
+        * Enters all matrices below @p parent into the matrix index and
+        * publishes their connection snapshots.
+        * @param parent The element whose descendants to index.
+        */
+      void indexMatrices(model::Element* parent);
+
+      /**
+        * Finds the matrix at @p path. This method may be called from any thread.
+        * @param path The path of the matrix.
+        * @return The matrix, or nullptr if there is no matrix at @p path.
+        */
+      model::matrix::Matrix* findMatrix(util::Oid const& path) const;
+
+      /**
+        * Answers a request consisting of GetDirectory commands on matrices from
+        * the connection snapshots, without waiting for the thread owning the DOM.
+        * Called within the thread of @p source.
+        * @param glow The decoded request.
+        * @param source The consumer that sent the request.
+        * @return True if the request has been answered, false if it has to
+        *     be applied by the thread owning the DOM.
+        */
+      bool writeSnapshotResponse(libember::glow::GlowContainer const* glow, Consumer* source) const;
+
+      /**
+        * Discards the recorded directory responses. Called whenever the
+        * DOM changes and when no more requests are queued.
+        */
+      inline void invalidateDirectoryResponses() { m_directoryResponses.clear(); }
+
+   private:
+      typedef std::unordered_map<util::Oid, model::matrix::Matrix*, util::OidHash> MatrixIndex;
+      typedef std::vector<Backend*> BackendVector;
+
+      /**
+        * The number of times a response is encoded from new snapshots when
+        * connections have changed while it was encoded, before the request
+        * is passed to the thread owning the DOM.
+        */
+      static const int SnapshotAttempts = 3;
+
+      /**
+        * The number of changes kept for consumers that reconnect.
+        */
+      static const std::size_t ChangeLogCapacity = 10000;
+
+      /**
+        * The maximum number of elements written to a consumer in a single
+        * message while responding to a GetChangesSince command.
+        */
+      static const unsigned int ChangeChunkSize = 500;
 
    private:
       net::TcpServer m_server;
+      RequestQueue m_requests;
       model::Element* m_root;
+      MatrixIndex m_matrices;
+      BackendVector m_backends;
+      DirectoryResponseCache m_directoryResponses;
+      mutable MatrixMetadataCache m_matrixMetadata;
+      util::ChangeLog m_changes;
+      util::LatencySink* m_latencySink;
+      Metrics* m_metrics;
+      model::StateJournal* m_journal;
+      int m_minimumNotificationInterval;
+      int m_transactionDepth;
+      ValueChangeVector m_valueChanges;
+      ValueChangeIndex m_valueChangeIndex;
+      util::LatencyTrace* m_trace;
+      util::LatencyHistogram m_latencyHistograms[util::LatencyStage::Count];
+      QThreadPool m_invocations;
    };
 }
 
@@ -2,6 +2,10 @@
 
 namespace glow
 {
+   Encoder::Packet::Packet()
+   {
+   }
+
    Encoder::Packet::Packet(Packet const& other)
       : m_encodedBytes(other.m_encodedBytes)
    {
@@ -46,6 +50,11 @@ namespace glow
       return Encoder(container);
    }
 
+   Encoder Encoder::createEmberMessage(libember::glow::GlowWriter const& writer)
+   {
+      return Encoder(writer);
+   }
+
    Encoder Encoder::createRequestKeepAliveMessage()
    {
       libs101::StreamEncoder<unsigned char> encoder;
@@ -65,6 +74,14 @@ namespace glow
       stream.finish();
    }
 
+   Encoder::Encoder(libember::glow::GlowWriter const& writer)
+      : m_isFirstPacket(true)
+   {
+      auto stream = Stream(this);
+      stream.append(writer.begin(), writer.end());
+      stream.finish();
+   }
+
    Encoder::const_iterator Encoder::begin() const
    {
       return m_packets.begin();
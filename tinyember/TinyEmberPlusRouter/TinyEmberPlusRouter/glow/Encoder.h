@@ -1,6 +1,7 @@
 #ifndef __TINYEMBERROUTER_GLOW_ENCODER_H
 #define __TINYEMBERROUTER_GLOW_ENCODER_H
 
+#include <iterator>
 #include <vector>
 #include <ember/Ember.hpp>
 #include <s101/CommandType.hpp>
@@ -30,6 +31,11 @@ namespace glow
                     typedef Container::const_iterator const_iterator;
                     typedef Container::size_type size_type;
 
+                    /**
+                     * Initializes a new, empty packet.
+                     */
+                    Packet();
+
                     /**
                      * Copy constructor.
                      * @param other The packet to copy the data from.
@@ -78,6 +84,13 @@ namespace glow
              */
             static Encoder createEmberMessage(libember::glow::GlowContainer const* container);
 
+            /**
+             * Wraps the message encoded by the passed writer into one or more s101 packages.
+             * @param writer The writer containing a complete message.
+             * @return A new Encoder instance which contains a collection of s101 packets.
+             */
+            static Encoder createEmberMessage(libember::glow::GlowWriter const& writer);
+
             /**
              * Creates a new keep-alive request.
              * @return A new Encoder instance which contains the encoded keep-alive request.
@@ -110,6 +123,13 @@ namespace glow
              */
             explicit Encoder(libember::dom::Node const* node);
 
+            /**
+             * Initializes a new Encoder instance and generates the s101 packets from the
+             * bytes of the passed writer.
+             * @param writer The writer containing the encoded message.
+             */
+            explicit Encoder(libember::glow::GlowWriter const& writer);
+
             /**
              * Initializes a new Encoder instance with the provided packets.
              * @param first An iterator that points to the first packet to copy.
@@ -187,7 +207,6 @@ namespace glow
     template<typename InputIterator>
     inline void Encoder::finishPacket(InputIterator first, InputIterator last, bool isLastPacket)
     {
-        auto encoder = libs101::StreamEncoder<unsigned char>();
         auto const version = libember::glow::GlowDtd::version();
         auto const isEmpty = first == last;
         auto const flags = unsigned char(
@@ -196,20 +215,31 @@ namespace glow
                 (isEmpty ? libs101::PackageFlag::EmptyPackage : 0)
             );
 
-        encoder.encode(0x00);                       // Slot
-        encoder.encode(libs101::MessageType::EmBER);// Message type
-        encoder.encode(libs101::CommandType::EmBER);// Ember Command
-        encoder.encode(0x01);                       // Version
-        encoder.encode(flags);                      // Flags
-        encoder.encode(libs101::Dtd::Glow);         // Glow Dtd
-        encoder.encode(0x02);                       // App bytes low
-        encoder.encode((version >> 0) & 0xFF);      // App specific, minor revision
-        encoder.encode((version >> 8) & 0xFF);      // App specific, major revision
-        encoder.encode(first, last);
-        encoder.finish();
+        unsigned char const header[] =
+        {
+            0x00,                                               // Slot
+            libs101::MessageType::EmBER,                        // Message type
+            libs101::CommandType::EmBER,                        // Ember Command
+            0x01,                                               // Version
+            flags,                                              // Flags
+            libs101::Dtd::Glow,                                 // Glow Dtd
+            0x02,                                               // App bytes low
+            static_cast<unsigned char>((version >> 0) & 0xFF),  // App specific, minor revision
+            static_cast<unsigned char>((version >> 8) & 0xFF),  // App specific, major revision
+        };
+
+        // The frame is encoded straight into the buffer of the packet, which is sized for the worst case
+        typedef libs101::StreamEncoder<unsigned char> FrameEncoder;
+        auto const payloadSize = static_cast<std::size_t>(std::distance(first, last));
+        m_packets.emplace_back();
+
+        auto& bytes = m_packets.back().m_encodedBytes;
+        bytes.resize(FrameEncoder::maximumFrameSize(sizeof(header) + payloadSize));
+
+        auto const frameEnd = FrameEncoder::encodeFrame(header, header + sizeof(header), first, last, bytes.data());
+        bytes.resize(frameEnd - bytes.data());
 
         m_isFirstPacket = false;
-        m_packets.push_back(Packet(encoder.begin(), encoder.end()));
     }
 }
 
@@ -9,11 +9,11 @@ namespace glow
       switch(glow->typeTag().number())
       {
          case GlowType::Command:
-            handleCommand(static_cast<libember::glow::GlowCommand const*>(glow), pathToOid());
+            handleCommand(static_cast<libember::glow::GlowCommand const*>(glow), m_path);
             break;
 
          case GlowType::RootElementCollection:
-            walkElements(glow->begin(), glow->end());
+            walkElements(glow->childBegin(), glow->childEnd());
             break;
 
          case GlowType::Matrix:
@@ -58,6 +58,11 @@ namespace glow
       }
    }
 
+   void Walker::walk(libember::glow::GlowContainer::const_child_iterator first, libember::glow::GlowContainer::const_child_iterator last)
+   {
+      walkElements(first, last);
+   }
+
    void Walker::handleNode(libember::glow::GlowNodeBase const* glow, libember::ber::ObjectIdentifier const& path)
    {}
 
@@ -74,12 +79,12 @@ namespace glow
    {
       m_path.push_back(glow->number());
 
-      handleNode(glow, pathToOid());
+      handleNode(glow, m_path);
 
       auto children = glow->children();
 
       if(children != nullptr)
-         walkElements(children->begin(), children->end());
+         walkElements(children->childBegin(), children->childEnd());
 
       m_path.pop_back();
    }
@@ -88,12 +93,12 @@ namespace glow
    {
       m_path.push_back(glow->number());
 
-      handleParameter(glow, pathToOid());
+      handleParameter(glow, m_path);
 
       auto children = glow->children();
 
       if(children != nullptr)
-         walkElements(children->begin(), children->end());
+         walkElements(children->childBegin(), children->childEnd());
 
       m_path.pop_back();
    }
@@ -102,12 +107,12 @@ namespace glow
    {
       m_path.push_back(glow->number());
 
-      handleMatrix(glow, pathToOid());
+      handleMatrix(glow, m_path);
 
       auto children = glow->children();
 
       if(children != nullptr)
-         walkElements(children->begin(), children->end());
+         walkElements(children->childBegin(), children->childEnd());
 
       m_path.pop_back();
    }
@@ -116,76 +121,68 @@ namespace glow
    {
       m_path.push_back(glow->number());
 
-      handleFunction(glow, pathToOid());
+      handleFunction(glow, m_path);
 
       auto children = glow->children();
 
       if(children != nullptr)
-         walkElements(children->begin(), children->end());
+         walkElements(children->childBegin(), children->childEnd());
 
       m_path.pop_back();
    }
 
    void Walker::walkQualifiedNode(libember::glow::GlowQualifiedNode const* glow)
    {
-      auto glowPath = glow->path();
-      m_path.clear();
-      m_path.insert(m_path.end(), glowPath.begin(), glowPath.end());
+      m_path = glow->path();
 
-      handleNode(glow, glowPath);
+      handleNode(glow, m_path);
 
       auto children = glow->children();
 
       if(children != nullptr)
-         walkElements(children->begin(), children->end());
+         walkElements(children->childBegin(), children->childEnd());
 
       m_path.clear();
    }
 
    void Walker::walkQualifiedParameter(libember::glow::GlowQualifiedParameter const* glow)
    {
-      auto glowPath = glow->path();
-      m_path.clear();
-      m_path.insert(m_path.end(), glowPath.begin(), glowPath.end());
+      m_path = glow->path();
 
-      handleParameter(glow, glowPath);
+      handleParameter(glow, m_path);
 
       auto children = glow->children();
 
       if(children != nullptr)
-         walkElements(children->begin(), children->end());
+         walkElements(children->childBegin(), children->childEnd());
 
       m_path.clear();
    }
 
    void Walker::walkQualifiedMatrix(libember::glow::GlowQualifiedMatrix const* glow)
    {
-      auto glowPath = glow->path();
-      m_path.clear();
-      m_path.insert(m_path.end(), glowPath.begin(), glowPath.end());
+      m_path = glow->path();
 
-      handleMatrix(glow, glowPath);
+      handleMatrix(glow, m_path);
 
       auto children = glow->children();
 
       if(children != nullptr)
-         walkElements(children->begin(), children->end());
+         walkElements(children->childBegin(), children->childEnd());
 
       m_path.clear();
    }
 
    void Walker::walkQualifiedFunction(libember::glow::GlowQualifiedFunction const* glow)
    {
-      auto glowPath = glow->path();
-      m_path.clear();
-      m_path.insert(m_path.end(), glowPath.begin(), glowPath.end());
+      m_path = glow->path();
 
-      handleFunction(glow, glowPath);
+      handleFunction(glow, m_path);
 
       auto children = glow->children();
 
       if(children != nullptr)
-         walkElements(children->begin(), children->end());
+         walkElements(children->childBegin(), children->childEnd());
 
       m_path.clear();
    }
@@ -194,10 +191,10 @@ namespace glow
    {
       for each(libember::dom::Node const& ember in *glow)
       {
-         auto streamEntry = dynamic_cast<libember::glow::GlowStreamEntry const*>(&ember);
+         auto glow = libember::glow::GlowVisitor::toGlowContainer(&ember);
 
-         if(streamEntry != nullptr)
-            handleStreamEntry(streamEntry);
+         if(glow != nullptr && glow->typeTag().number() == libember::glow::GlowType::StreamEntry)
+            handleStreamEntry(static_cast<libember::glow::GlowStreamEntry const*>(glow));
       }
    }
 }
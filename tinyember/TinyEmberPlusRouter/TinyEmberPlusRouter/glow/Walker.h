@@ -1,7 +1,6 @@
 #ifndef __TINYEMBERROUTER_GLOW_WALKER_H
 #define __TINYEMBERROUTER_GLOW_WALKER_H
 
-#include <list>
 #include <ember/Ember.hpp>
 
 namespace glow
@@ -12,6 +11,9 @@ namespace glow
      * This makes the differences between Parameter and QualifiedParameter etc.
      * transparent, since every GlowContentElement is treated like its
      * qualified version.
+     * The path passed to the handlers refers to the path stack of the walker,
+     * which is reused for all elements. It is only valid during the call and
+     * must be copied by handlers that want to keep it.
      */
    class Walker
    {
@@ -23,6 +25,14 @@ namespace glow
         */
       void walk(libember::glow::GlowContainer const* glow);
 
+      /**
+        * Walks a range of the root elements of a Glow tree, as if they
+        * were the only children of its root element collection.
+        * @param first Refers to the first root element to walk.
+        * @param last Refers to the position one past the last root element to walk.
+        */
+      void walk(libember::glow::GlowContainer::const_child_iterator first, libember::glow::GlowContainer::const_child_iterator last);
+
    protected:
       /**
         * Override this method to process GlowCommand objects.
@@ -81,8 +91,6 @@ namespace glow
       virtual void handleInvocationResult(libember::glow::GlowInvocationResult const* glow);
 
    private:
-      inline libember::ber::ObjectIdentifier pathToOid() const { return libember::ber::ObjectIdentifier(m_path.begin(), m_path.end()); }
-
       void walkNode(libember::glow::GlowNode const* glow);
       void walkParameter(libember::glow::GlowParameter const* glow);
       void walkMatrix(libember::glow::GlowMatrix const* glow);
@@ -97,7 +105,7 @@ namespace glow
       void walkElements(InputIterator first, InputIterator last);
 
    private:
-      std::list<int> m_path;
+      libember::ber::ObjectIdentifier m_path;
    };
 
    template<typename InputIterator>
@@ -105,7 +113,7 @@ namespace glow
    {
       for( ; first != last; first++)
       {
-         auto glow = dynamic_cast<libember::glow::GlowContainer const*>(std::addressof(*first));
+         auto glow = libember::glow::GlowVisitor::toGlowContainer(std::addressof(*first));
 
          if(glow != nullptr)
             walk(glow);
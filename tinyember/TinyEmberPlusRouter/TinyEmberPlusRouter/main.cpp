@@ -1,13 +1,17 @@
 #include <iostream>
+#include <memory>
 #include <sstream>
 #include <QtCore>
 #include <QtCore/QCoreApplication>
 #include "model/model.h"
 #include "glow/Dispatcher.h"
+#include "net/MetricsEndpoint.h"
+#include "util/Log.h"
 
 
 #define VERSION_STRING "1.5.1"
 #define TCP_PORT 9092
+#define JOURNAL_FILENAME "TinyEmberPlusRouter.journal"
 
 // =====================================================
 //
@@ -177,6 +181,11 @@ public:
       auto sum = arg1 + arg2;
       result.insert(result.end(), libember::glow::Value(sum));
    };
+
+   virtual bool isConcurrent() const
+   {
+      return true;
+   }
 };
 
 // void doNothing()
@@ -244,10 +253,15 @@ void createFunctions(model::Node* router, int nodeNumber, glow::Dispatcher* disp
                                               &enterLicenseKeyResult, &enterLicenseKeyResult + 1);
 }
 
-model::Element* createTree(glow::Dispatcher* dispatcher)
+model::Element* createTree(glow::Dispatcher* dispatcher, int routerNumber)
 {
    auto root = model::Element::createRoot();
-   auto router = new model::Node(1, root, "router");
+
+   // a front dispatcher only exposes the subtrees of its backends
+   if(routerNumber <= 0)
+      return root;
+
+   auto router = new model::Node(routerNumber, root, "router");
    createIdentity(router, 0);
    createOneToN(router, 1, dispatcher);
    createNToN(router, 2, dispatcher);
@@ -258,6 +272,136 @@ model::Element* createTree(glow::Dispatcher* dispatcher)
 }
 
 
+// =====================================================
+//
+// Command line
+//
+// =====================================================
+
+/**
+  * The settings passed on the command line:
+  *   -port <port>                    The port to listen on.
+  *   -node <number>                  The number of the root element containing the router tree.
+  *   -backend <number> <host>:<port> Mounts the subtree of a backend router, which has been
+  *                                   started with -node <number>. May be repeated. A router
+  *                                   mounting backends does not create a tree of its own.
+  *   -rate <count>                   The maximum number of value notifications per second
+  *                                   a consumer receives for a single parameter. Faster
+  *                                   changes are coalesced to the latest value.
+  *   -slice <microseconds>           The time spent applying requests before other events are
+  *                                   processed. Larger requests are applied in several parts.
+  *                                   0 applies every request at once. The default is 10000.
+  *   -invocationtimeout <milliseconds>
+  *                                   The time after which a concurrent function that has not
+  *                                   returned is reported as failed. 0 waits for every function
+  *                                   to return. The default is 30000.
+  *   -metrics <port>                 Serves the metrics of the router via HTTP on this port,
+  *                                   in the Prometheus text format.
+  *   -log <level>                    The lowest level of the messages written to stderr:
+  *                                   debug, info, warning, error or none. The default is info.
+  */
+struct Options
+{
+   struct Backend
+   {
+      int number;
+      QString host;
+      quint16 port;
+   };
+
+   Options()
+      : port(TCP_PORT)
+      , routerNumber(1)
+      , maximumUpdateRate(0)
+      , timeSlice(glow::Dispatcher::DefaultRequestTimeSlice)
+      , invocationTimeout(glow::Dispatcher::DefaultInvocationTimeout)
+      , metricsPort(0)
+      , logLevel(util::LogLevel::Info)
+   {}
+
+   int port;
+   int routerNumber;
+   int maximumUpdateRate;
+   int timeSlice;
+   int invocationTimeout;
+   int metricsPort;
+   util::LogLevel::_Domain logLevel;
+   std::vector<Backend> backends;
+};
+
+bool parseOptions(QStringList const& arguments, Options& options)
+{
+   for(auto index = 1; index < arguments.size(); index++)
+   {
+      auto const& name = arguments[index];
+      auto isValid = false;
+
+      if(name == "-port" && index + 1 < arguments.size())
+      {
+         options.port = arguments[++index].toInt(&isValid);
+      }
+      else if(name == "-node" && index + 1 < arguments.size())
+      {
+         options.routerNumber = arguments[++index].toInt(&isValid);
+      }
+      else if(name == "-rate" && index + 1 < arguments.size())
+      {
+         options.maximumUpdateRate = arguments[++index].toInt(&isValid);
+         isValid = isValid && options.maximumUpdateRate >= 0;
+      }
+      else if(name == "-slice" && index + 1 < arguments.size())
+      {
+         options.timeSlice = arguments[++index].toInt(&isValid);
+         isValid = isValid && options.timeSlice >= 0;
+      }
+      else if(name == "-invocationtimeout" && index + 1 < arguments.size())
+      {
+         options.invocationTimeout = arguments[++index].toInt(&isValid);
+         isValid = isValid && options.invocationTimeout >= 0;
+      }
+      else if(name == "-metrics" && index + 1 < arguments.size())
+      {
+         options.metricsPort = arguments[++index].toInt(&isValid);
+         isValid = isValid && options.metricsPort > 0;
+      }
+      else if(name == "-log" && index + 1 < arguments.size())
+      {
+         isValid = util::LogLevel::parse(arguments[++index], options.logLevel);
+      }
+      else if(name == "-backend" && index + 2 < arguments.size())
+      {
+         auto backend = Options::Backend();
+         auto const address = arguments[index + 2].split(':');
+
+         backend.number = arguments[index + 1].toInt(&isValid);
+         index += 2;
+
+         if(isValid && address.size() == 2)
+         {
+            backend.host = address[0];
+            backend.port = address[1].toUShort(&isValid);
+            options.backends.push_back(backend);
+         }
+         else
+         {
+            isValid = false;
+         }
+      }
+
+      if(isValid == false)
+      {
+         std::cerr << "Invalid argument: " << name.toStdString() << std::endl;
+         return false;
+      }
+   }
+
+   if(options.backends.empty() == false)
+      options.routerNumber = 0;
+
+   return true;
+}
+
+
 // =====================================================
 //
 // Qt console reading
@@ -268,33 +412,42 @@ class ConsoleReaderThread : public QThread
 {
    Q_OBJECT
 
+public:
+   explicit ConsoleReaderThread(int port) : m_port(port) {}
+
 protected:
    void run()
    {
       std::cout << "Tiny Ember+ Router v"
                 << VERSION_STRING
                 << " listening on port "
-                << TCP_PORT
+                << m_port
                 << ". Press enter to quit..."
                 << std::endl;
 
       fgetc(stdin);
    }
+
+private:
+   int m_port;
 };
 
 class Task : public QObject
 {
    Q_OBJECT
 public:
-   Task(QObject *parent = 0) : QObject(parent) {}
+   Task(int port, QObject *parent = 0) : QObject(parent), m_port(port) {}
 
 public slots:
    void run()
    {
-      ConsoleReaderThread* thread = new ConsoleReaderThread();
+      ConsoleReaderThread* thread = new ConsoleReaderThread(m_port);
       thread->start();
       QObject::connect(thread, SIGNAL(finished()), parent(), SLOT(quit()));
    }
+
+private:
+   int m_port;
 };
 
 #include "main.moc"
@@ -310,17 +463,54 @@ int main(int argc, char *argv[])
 {
     QCoreApplication a(argc, argv);
 
-    auto dispatcher = glow::Dispatcher(&a, TCP_PORT);
-    auto root = createTree(&dispatcher);
+    auto options = Options();
+    if(parseOptions(a.arguments(), options) == false)
+        return 1;
+
+    // the messages are written by a background thread until all components have been destroyed
+    util::Log::setLevel(options.logLevel);
+    util::LogWriter logWriter;
+
+    // the metrics are created before and destroyed after all components updating them
+    util::MetricsRegistry metrics;
+
+    auto dispatcher = glow::Dispatcher(&a, options.port);
+    if(options.maximumUpdateRate > 0)
+        dispatcher.setMinimumNotificationInterval(1000 / options.maximumUpdateRate);
+    dispatcher.setRequestTimeSlice(options.timeSlice);
+    dispatcher.setInvocationTimeout(options.invocationTimeout);
+
+    auto metricsEndpoint = std::unique_ptr<net::MetricsEndpoint>();
+    if(options.metricsPort > 0)
+    {
+        dispatcher.setMetrics(&metrics);
+        metricsEndpoint.reset(new net::MetricsEndpoint(&a, &metrics, static_cast<short>(options.metricsPort)));
+    }
+
+    auto root = createTree(&dispatcher, options.routerNumber);
     dispatcher.setRoot(root);
 
+    for each(auto const& backend in options.backends)
+        dispatcher.mountBackend(backend.number, backend.host, backend.port);
+
+    // restore the connections and parameter values of the last run
+    // before recording new changes. Routers sharing a directory are
+    // told apart by their ports.
+    auto const journalFilename = options.port == TCP_PORT
+        ? QString(JOURNAL_FILENAME)
+        : QString("TinyEmberPlusRouter-%1.journal").arg(options.port);
+    model::StateJournal journal(journalFilename);
+    journal.restore(root);
+    dispatcher.setJournal(&journal);
+
     // Task will be deleted by the application object.
-    auto task = new Task(&a);
+    auto task = new Task(options.port, &a);
 
     // run the task from the application event loop.
     QTimer::singleShot(0, task, SLOT(run()));
 
     auto result = a.exec();
+    dispatcher.setJournal(nullptr);
     delete root;
     return result;
 }
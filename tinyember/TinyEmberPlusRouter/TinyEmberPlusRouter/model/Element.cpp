@@ -8,9 +8,16 @@ namespace model
       , m_parent(parent)
       , m_identifier(identifier)
       , m_path(nullptr)
+      , m_index(nullptr)
    {
       if(parent != nullptr)
+      {
          parent->insert(parent->end(), this);
+
+         auto const index = root()->m_index;
+         if(index != nullptr)
+            index->insert(std::make_pair(Element::path(), this));
+      }
    }
 
    Element::~Element()
@@ -18,8 +25,18 @@ namespace model
       for each(auto child in *this)
          delete child;
 
+      if(m_parent != nullptr)
+      {
+         auto const index = root()->m_index;
+         if(index != nullptr)
+            index->erase(Element::path());
+      }
+
       if(m_path != nullptr)
          delete m_path;
+
+      if(m_index != nullptr)
+         delete m_index;
    }
 
    util::Oid Element::path() const
@@ -45,6 +62,18 @@ namespace model
 
       isDynamic = false;
 
+      // Static elements are resolved through the path index of the root, only
+      // unknown paths are walked in order to give dynamic emitters a chance.
+      if(isRoot() && path.empty() == false)
+      {
+         if(m_index == nullptr)
+            buildIndex();
+
+         auto const result = m_index->find(path);
+         if(result != m_index->end())
+            return result->second;
+      }
+
       for( ; first != last; first++)
       {
          auto number = *first;
@@ -83,6 +112,30 @@ namespace model
       return nullptr;
    }
 
+   Element* Element::root() const
+   {
+      auto elem = (Element*)this;
+      while(elem->m_parent != nullptr)
+         elem = elem->m_parent;
+
+      return elem;
+   }
+
+   void Element::buildIndex() const
+   {
+      m_index = new PathIndex();
+
+      auto pending = Vector(m_children.begin(), m_children.end());
+      while(pending.empty() == false)
+      {
+         auto const elem = pending.back();
+         pending.pop_back();
+
+         m_index->insert(std::make_pair(elem->Element::path(), elem));
+         pending.insert(pending.end(), elem->begin(), elem->end());
+      }
+   }
+
    // static
    Element* Element::createRoot()
    {
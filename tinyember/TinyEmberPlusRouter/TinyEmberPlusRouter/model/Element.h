@@ -2,6 +2,7 @@
 #define __TINYEMBERROUTER_MODEL_ELEMENT_H
 
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include "../util/Types.h"
 
@@ -183,6 +184,22 @@ namespace model
         */
       Element* findDescendant(util::Oid const& path, bool& isDynamic) const;
 
+      /**
+        * Returns the root of the DOM tree this element belongs to.
+        * @return The root element.
+        */
+      Element* root() const;
+
+      /**
+        * Builds the path index of this root element from the current tree.
+        * Afterwards, elements register and unregister themselves when they
+        * are created or destroyed.
+        */
+      void buildIndex() const;
+
+   private:
+      typedef std::unordered_map<util::Oid, Element*, util::OidHash> PathIndex;
+
    private:
       int m_number;
       std::string m_identifier;
@@ -190,6 +207,7 @@ namespace model
       Element* m_parent;
       Vector m_children;
       mutable util::Oid* m_path;
+      mutable PathIndex* m_index;
    };
 
 
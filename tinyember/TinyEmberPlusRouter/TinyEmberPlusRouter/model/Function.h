@@ -23,6 +23,16 @@ namespace model
       public:
          virtual void invoke(util::VariantValueVector const& arguments,
                              util::VariantValueVector& result) = 0;
+
+         /**
+           * Returns true if invoke() neither accesses the DOM nor any other
+           * state owned by the thread owning the DOM. Such a function is
+           * invoked on a worker thread, so a long-running invocation does not
+           * delay the requests of other consumers. Since several invocations
+           * may run at the same time, invoke() must be reentrant.
+           * @return True if invoke() may be called from any thread.
+           */
+         virtual bool isConcurrent() const { return false; }
       };
 
    public:
@@ -81,6 +91,13 @@ namespace model
         */
       inline TupleItemVector const& result() const { return m_result; }
 
+      /**
+        * Returns true if the function may be invoked from any thread.
+        * @return True if the delegate of the function is concurrent.
+        * @see Delegate::isConcurrent
+        */
+      inline bool isConcurrent() const { return m_delegate->isConcurrent(); }
+
       /**
         * Invokes the function.
         * @param firstArgumentValue Iterator pointing to the first argument value.
@@ -1,6 +1,7 @@
 #ifndef __TINYEMBERROUTER_MODEL_NOTIFICATIONSINK_H
 #define __TINYEMBERROUTER_MODEL_NOTIFICATIONSINK_H
 
+#include <vector>
 #include "../util/Types.h"
 
 namespace model
@@ -13,6 +14,8 @@ namespace model
 
    /**
      * Interface that can be implemented to receive notifications from the DOM.
+     * Changes made between beginTransaction() and commitTransaction() may be
+     * reported to consumers at once when the transaction is committed.
      */
    class NotificationSink
    {
@@ -25,6 +28,15 @@ namespace model
         */
       virtual void notifyMatrixConnection(matrix::Matrix* matrix, matrix::Signal* target, void* state) = 0;
 
+      /**
+        * Implement this method to handle connection changes of several targets
+        * that have been issued at once.
+        * @param matrix Pointer to the matrix object the connection changes were issued on.
+        * @param targets The target objects that changed.
+        * @param state State passed through by the caller that initiated the changes.
+        */
+      virtual void notifyMatrixConnections(matrix::Matrix* matrix, std::vector<matrix::Signal*> const& targets, void* state) = 0;
+
       /**
         * Implement this method to handle integer parameter value changes.
         * @param parameterPath Path of the parameter that changed.
@@ -38,6 +50,53 @@ namespace model
         * @param value The new parameter value.
         */
       virtual void notifyParameterValueChanged(util::Oid const& parameterPath, std::string const& value) = 0;
+
+      /**
+        * Implement this method to start a transaction. Transactions may be
+        * nested, the outermost commit publishes the changes.
+        */
+      virtual void beginTransaction() = 0;
+
+      /**
+        * Implement this method to publish the changes made since the
+        * matching call to beginTransaction().
+        */
+      virtual void commitTransaction() = 0;
+   };
+
+   /**
+     * Begins a transaction on a NotificationSink when created and commits
+     * it when destroyed, so that the transaction is committed even if an
+     * exception is thrown.
+     */
+   class NotificationTransaction
+   {
+   public:
+      /**
+        * Creates a new instance of NotificationTransaction.
+        * @param sink The sink to begin the transaction on, or nullptr.
+        */
+      explicit NotificationTransaction(NotificationSink* sink)
+         : m_sink(sink)
+      {
+         if(m_sink != nullptr)
+            m_sink->beginTransaction();
+      }
+
+      /** Destructor, commits the transaction. */
+      ~NotificationTransaction()
+      {
+         if(m_sink != nullptr)
+            m_sink->commitTransaction();
+      }
+
+   private:
+      /** Prohibit copies */
+      NotificationTransaction(NotificationTransaction const&);
+      NotificationTransaction& operator=(NotificationTransaction const&);
+
+   private:
+      NotificationSink *const m_sink;
    };
 }
 
@@ -0,0 +1,298 @@
+#include <algorithm>
+#include <stdexcept>
+#include "IntegerParameter.h"
+#include "StringParameter.h"
+#include "StateJournal.h"
+#include "matrix/Matrix.h"
+
+namespace model
+{
+   // ========================================================
+   //
+   // StateJournal::Record Definitions
+   //
+   // ========================================================
+
+   StateJournal::Record::Record()
+      : sequence(0)
+      , type(0)
+      , target(-1)
+   {}
+
+
+   // ========================================================
+   //
+   // StateJournal Definitions
+   //
+   // ========================================================
+
+   StateJournal::StateJournal(QString const& filename)
+      : m_file(filename)
+      , m_sequence(0)
+   {}
+
+   int StateJournal::restore(Element* root)
+   {
+      auto records = RecordMap();
+      load(records);
+
+      auto applied = std::vector<Record>();
+      applied.reserve(records.size());
+
+      for each(auto const& entry in records)
+      {
+         if(apply(root, entry.second))
+            applied.push_back(entry.second);
+      }
+
+      std::sort(applied.begin(), applied.end(), [](Record const& lhs, Record const& rhs) { return lhs.sequence < rhs.sequence; });
+
+      rewrite(applied);
+      return static_cast<int>(applied.size());
+   }
+
+   void StateJournal::recordConnections(matrix::Matrix const* matrix, std::vector<matrix::Signal*> const& targets)
+   {
+      auto record = Record();
+      record.type = RecordType::Connection;
+      record.path = matrix->path();
+
+      for each(auto target in targets)
+      {
+         record.target = target->number();
+         record.numbers.clear();
+
+         for each(auto source in target->connectedSources())
+            record.numbers.push_back(source->number());
+
+         append(record);
+      }
+   }
+
+   void StateJournal::recordValue(util::Oid const& parameterPath, int value)
+   {
+      auto record = Record();
+      record.type = RecordType::Integer;
+      record.path = parameterPath;
+      record.numbers.push_back(value);
+
+      append(record);
+   }
+
+   void StateJournal::recordValue(util::Oid const& parameterPath, std::string const& value)
+   {
+      auto record = Record();
+      record.type = RecordType::String;
+      record.path = parameterPath;
+      record.text = value;
+
+      append(record);
+   }
+
+   void StateJournal::load(RecordMap& records)
+   {
+      if(m_file.open(QIODevice::ReadOnly) == false)
+         return;
+
+      auto const size = m_file.size();
+      auto const mapped = size > 0 ? m_file.map(0, size) : nullptr;
+
+      if(mapped != nullptr)
+      {
+         // the stream reads the mapped pages directly, the file is not copied
+         auto const bytes = QByteArray::fromRawData(reinterpret_cast<char const*>(mapped), static_cast<int>(size));
+         QDataStream stream(bytes);
+         auto magic = quint32(0);
+         auto version = quint32(0);
+
+         stream.setVersion(QDataStream::Qt_4_6);
+         stream >> magic >> version;
+
+         if(stream.status() == QDataStream::Ok && magic == Magic && version == Version)
+         {
+            auto record = Record();
+
+            while(read(stream, record))
+            {
+               m_sequence = std::max(m_sequence, record.sequence);
+               records[RecordKey(record.path, record.target)] = record;
+            }
+         }
+
+         m_file.unmap(mapped);
+      }
+
+      m_file.close();
+   }
+
+   //static
+   bool StateJournal::apply(Element* root, Record const& record)
+   {
+      auto lookup = Element::Lookup(root, record.path);
+      auto const element = lookup.result();
+
+      if(element == nullptr)
+         return false;
+
+      switch(record.type)
+      {
+         case RecordType::Connection:
+         {
+            auto const owner = dynamic_cast<matrix::Matrix*>(element);
+            auto const target = owner != nullptr ? owner->getTarget(record.target) : nullptr;
+
+            if(target == nullptr)
+               return false;
+
+            auto sources = matrix::Signal::Vector();
+
+            for each(auto number in record.numbers)
+            {
+               auto const source = owner->getSource(number);
+
+               if(source != nullptr)
+                  sources.push_back(source);
+            }
+
+            try
+            {
+               owner->connect(target, sources.begin(), sources.end(), nullptr, util::ConnectOperation::Absolute);
+            }
+            catch(std::exception const&)
+            {
+               return false;
+            }
+
+            return true;
+         }
+
+         case RecordType::Integer:
+         {
+            auto const parameter = dynamic_cast<IntegerParameter*>(element);
+
+            if(parameter == nullptr || record.numbers.size() != 1)
+               return false;
+
+            parameter->setValue(record.numbers.front());
+            return true;
+         }
+
+         case RecordType::String:
+         {
+            auto const parameter = dynamic_cast<StringParameter*>(element);
+
+            if(parameter == nullptr)
+               return false;
+
+            parameter->setValue(record.text);
+            return true;
+         }
+      }
+
+      return false;
+   }
+
+   void StateJournal::rewrite(std::vector<Record> const& records)
+   {
+      auto const filename = m_file.fileName();
+      QFile temporary(filename + ".tmp");
+
+      if(temporary.open(QIODevice::WriteOnly | QIODevice::Truncate) == false)
+         return;
+
+      QDataStream stream(&temporary);
+      stream.setVersion(QDataStream::Qt_4_6);
+      stream << Magic << Version;
+
+      for each(auto const& record in records)
+         write(stream, record);
+
+      temporary.close();
+
+      // the journal is replaced only once the compacted file is complete
+      QFile::remove(filename);
+
+      if(temporary.rename(filename))
+         m_file.open(QIODevice::WriteOnly | QIODevice::Append);
+   }
+
+   void StateJournal::append(Record& record)
+   {
+      if(m_file.isOpen() == false)
+         return;
+
+      record.sequence = ++m_sequence;
+
+      QDataStream stream(&m_file);
+      stream.setVersion(QDataStream::Qt_4_6);
+      write(stream, record);
+      m_file.flush();
+   }
+
+   //static
+   void StateJournal::write(QDataStream& stream, Record const& record)
+   {
+      stream << quint8(record.type) << record.sequence << quint32(record.path.size());
+
+      for each(auto segment in record.path)
+         stream << qint32(segment);
+
+      stream << qint32(record.target) << quint32(record.numbers.size());
+
+      for each(auto number in record.numbers)
+         stream << qint32(number);
+
+      stream << QByteArray(record.text.data(), static_cast<int>(record.text.size()));
+   }
+
+   //static
+   bool StateJournal::read(QDataStream& stream, Record& record)
+   {
+      auto type = quint8(0);
+      auto pathLength = quint32(0);
+
+      stream >> type >> record.sequence >> pathLength;
+
+      // guard against allocating for lengths read from a damaged file
+      if(stream.status() != QDataStream::Ok || pathLength > stream.device()->bytesAvailable() / 4)
+         return false;
+
+      auto segments = std::vector<int>(pathLength);
+
+      for(auto it = segments.begin(); it != segments.end(); ++it)
+      {
+         auto segment = qint32(0);
+         stream >> segment;
+         *it = segment;
+      }
+
+      auto target = qint32(0);
+      auto count = quint32(0);
+
+      stream >> target >> count;
+
+      if(stream.status() != QDataStream::Ok || count > stream.device()->bytesAvailable() / 4)
+         return false;
+
+      record.numbers.resize(count);
+
+      for(auto it = record.numbers.begin(); it != record.numbers.end(); ++it)
+      {
+         auto number = qint32(0);
+         stream >> number;
+         *it = number;
+      }
+
+      auto text = QByteArray();
+      stream >> text;
+
+      if(stream.status() != QDataStream::Ok)
+         return false;
+
+      record.type = type;
+      record.path = util::Oid(segments.begin(), segments.end());
+      record.target = target;
+      record.text = std::string(text.constData(), text.size());
+      return true;
+   }
+}
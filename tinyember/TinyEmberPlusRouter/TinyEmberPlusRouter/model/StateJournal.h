@@ -0,0 +1,191 @@
+#ifndef __TINYEMBERROUTER_MODEL_STATEJOURNAL_H
+#define __TINYEMBERROUTER_MODEL_STATEJOURNAL_H
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <QtCore>
+#include "../util/Types.h"
+
+namespace model
+{
+   class Element;
+
+   namespace matrix
+   {
+      class Matrix;
+      class Signal;
+   }
+
+   /**
+     * Persists the matrix connections and parameter values of the DOM, so that
+     * a restarted router starts with the state it had when it was stopped.
+     * Every change is appended to the journal file as a record carrying a
+     * sequence number. When the journal is restored, the file is mapped into
+     * memory, the last record of every connection and every parameter is
+     * applied to the DOM and the file is rewritten to contain only these
+     * records, so its size depends on the state and not on the number of
+     * changes that have been made.
+     * All methods must be called by the thread owning the DOM.
+     */
+   class StateJournal
+   {
+   public:
+      /**
+        * Creates a new instance of StateJournal. The file is not accessed
+        * before restore() is called.
+        * @param filename The name of the journal file.
+        */
+      explicit StateJournal(QString const& filename);
+
+      /**
+        * Restores the state recorded in the journal file, if it exists, and
+        * opens the file for appending new records. The journal must be
+        * restored before changes are recorded. Records referring to elements
+        * that no longer exist are dropped. If the file cannot be written,
+        * the DOM is restored but no changes are recorded.
+        * @param root The root of the DOM to restore the state of.
+        * @return The number of records that were applied to the DOM.
+        */
+      int restore(Element* root);
+
+      /**
+        * Returns the sequence number of the last recorded change.
+        * @return The sequence number of the last recorded change, or 0 if
+        *     no change has been recorded yet.
+        */
+      inline quint64 sequence() const { return m_sequence; }
+
+      /**
+        * Appends the connected sources of @p targets to the journal.
+        * @param matrix The matrix owning the targets.
+        * @param targets The targets whose connections have changed.
+        */
+      void recordConnections(matrix::Matrix const* matrix, std::vector<matrix::Signal*> const& targets);
+
+      /**
+        * Appends the value of an integer parameter to the journal.
+        * @param parameterPath Path of the parameter that changed.
+        * @param value The new parameter value.
+        */
+      void recordValue(util::Oid const& parameterPath, int value);
+
+      /**
+        * Appends the value of a string parameter to the journal.
+        * @param parameterPath Path of the parameter that changed.
+        * @param value The new parameter value.
+        */
+      void recordValue(util::Oid const& parameterPath, std::string const& value);
+
+   private:
+      /**
+        * Enumeration of the kinds of records.
+        */
+      struct RecordType
+      {
+         enum _Domain
+         {
+            Connection = 1,
+            Integer = 2,
+            String = 3,
+         };
+      };
+
+      /**
+        * A single change of a connection or parameter value.
+        */
+      struct Record
+      {
+         Record();
+
+         quint64 sequence;
+         int type;
+         util::Oid path;
+
+         /** The number of the target, or -1 if the record contains a parameter value. */
+         int target;
+
+         /** The connected sources, or the value of an integer parameter. */
+         std::vector<int> numbers;
+
+         /** The value of a string parameter. */
+         std::string text;
+      };
+
+      /**
+        * Identifies the connection or parameter a record belongs to, so that
+        * a later record replaces an earlier one.
+        */
+      struct RecordKey
+      {
+         RecordKey(util::Oid const& path, int target)
+            : path(path)
+            , target(target)
+         {}
+
+         inline bool operator==(RecordKey const& other) const
+         {
+            return target == other.target && path == other.path;
+         }
+
+         util::Oid path;
+         int target;
+      };
+
+      struct RecordKeyHash
+      {
+         inline std::size_t operator()(RecordKey const& key) const
+         {
+            return key.path.hash() ^ (static_cast<std::size_t>(key.target) * 31);
+         }
+      };
+
+      typedef std::unordered_map<RecordKey, Record, RecordKeyHash> RecordMap;
+
+      /** The first bytes of every journal file. */
+      static const quint32 Magic = 0x544A524E;
+      static const quint32 Version = 1;
+
+      /**
+        * Reads all complete records from the mapped journal file, keeping
+        * only the last record of every connection and parameter. A record
+        * truncated by a crash ends the journal.
+        * @param records Receives the last record of every connection and parameter.
+        */
+      void load(RecordMap& records);
+
+      /**
+        * Applies a record to the DOM.
+        * @param root The root of the DOM.
+        * @param record The record to apply.
+        * @return True if the record could be applied.
+        */
+      static bool apply(Element* root, Record const& record);
+
+      /**
+        * Replaces the journal file with a file containing only @p records
+        * and leaves it open for appending, unless the file cannot be written.
+        * @param records The records to keep, ordered by sequence number.
+        */
+      void rewrite(std::vector<Record> const& records);
+
+      /**
+        * Assigns the next sequence number to @p record and appends it to the journal file.
+        * @param record The record to append.
+        */
+      void append(Record& record);
+
+      static void write(QDataStream& stream, Record const& record);
+      static bool read(QDataStream& stream, Record& record);
+
+      /** Prohibit copies */
+      StateJournal(StateJournal const&);
+      StateJournal& operator=(StateJournal const&);
+
+   private:
+      QFile m_file;
+      quint64 m_sequence;
+   };
+}
+
+#endif//__TINYEMBERROUTER_MODEL_STATEJOURNAL_H
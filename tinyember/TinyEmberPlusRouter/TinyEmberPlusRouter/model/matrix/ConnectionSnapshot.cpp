@@ -0,0 +1,47 @@
+#include "ConnectionSnapshot.h"
+
+namespace model { namespace matrix
+{
+   ConnectionSnapshot::ConnectionSnapshot(Signal::Vector const& targets)
+   {
+      m_connections.reserve(targets.size());
+
+      for each(auto target in targets)
+         m_connections.push_back(Connection(target->number(), copySources(target)));
+   }
+
+   ConnectionSnapshot::ConnectionSnapshot(ConnectionSnapshot const& previous, Signal::Vector const& changedTargets)
+      : m_connections(previous.m_connections)
+   {
+      auto const size = (int)m_connections.size();
+
+      for each(auto target in changedTargets)
+      {
+         auto index = target->number();
+
+         // the targets of linear matrices are stored at the index of their number
+         if(index < 0 || index >= size || m_connections[index].target != target->number())
+         {
+            for(index = 0; index < size; index++)
+            {
+               if(m_connections[index].target == target->number())
+                  break;
+            }
+         }
+
+         if(index < size)
+            m_connections[index].sources = copySources(target);
+      }
+   }
+
+   QSharedPointer<ConnectionSnapshot::SourceVector const> ConnectionSnapshot::copySources(Signal const* target)
+   {
+      auto sources = new SourceVector();
+      sources->reserve(target->connectedSources().size());
+
+      for each(auto source in target->connectedSources())
+         sources->push_back(source->number());
+
+      return QSharedPointer<SourceVector const>(sources);
+   }
+}}
@@ -0,0 +1,70 @@
+#ifndef __TINYEMBERROUTER_MODEL_MATRIX_CONNECTIONSNAPSHOT_H
+#define __TINYEMBERROUTER_MODEL_MATRIX_CONNECTIONSNAPSHOT_H
+
+#include <vector>
+#include "Signal.h"
+#include "../../util/Snapshot.h"
+
+namespace model { namespace matrix
+{
+   /**
+     * An immutable copy of the connections of a matrix. The matrix publishes
+     * a new copy whenever its connections change, so that threads other than
+     * the one owning the DOM can report the connections without locking.
+     * A copy shares the sources of all targets that did not change with the
+     * copy it has been created from.
+     */
+   class ConnectionSnapshot
+   {
+   public:
+      typedef util::Snapshot<ConnectionSnapshot>::Pointer Pointer;
+      typedef std::vector<int> SourceVector;
+
+      /**
+        * The sources connected to a single target.
+        */
+      struct Connection
+      {
+         Connection(int target, QSharedPointer<SourceVector const> const& sources)
+            : target(target)
+            , sources(sources)
+         {}
+
+         int target;
+         QSharedPointer<SourceVector const> sources;
+      };
+
+      typedef std::vector<Connection> ConnectionVector;
+
+   public:
+      /**
+        * Creates a copy of the connections of all @p targets.
+        * @param targets The targets of the matrix.
+        */
+      explicit ConnectionSnapshot(Signal::Vector const& targets);
+
+      /**
+        * Creates a copy of @p previous in which the connections of
+        * @p changedTargets are replaced by their current connections.
+        * @param previous The snapshot to copy.
+        * @param changedTargets The targets whose connections have changed
+        *     since @p previous has been created.
+        */
+      ConnectionSnapshot(ConnectionSnapshot const& previous, Signal::Vector const& changedTargets);
+
+      /**
+        * Returns the connections of all targets, in the order of the
+        * targets of the matrix.
+        * @return The connections of all targets.
+        */
+      inline ConnectionVector const& connections() const { return m_connections; }
+
+   private:
+      static QSharedPointer<SourceVector const> copySources(Signal const* target);
+
+   private:
+      ConnectionVector m_connections;
+   };
+}}
+
+#endif//__TINYEMBERROUTER_MODEL_MATRIX_CONNECTIONSNAPSHOT_H
@@ -82,24 +82,52 @@ namespace model { namespace matrix
       return detail::connectNToN(target, sources, state, operation);
    }
 
-   bool DynamicNToNLinearMatrix::onParameterValueChanged(util::Oid const& path, int value)
+   int DynamicNToNLinearMatrix::crosspointIndex(util::Oid const& path, bool& isGainParameter) const
    {
       auto offset = this->path().size();
 
-      if(path.size() == offset + 5
+      isGainParameter = path.size() == offset + 5;
+
+      if((path.size() == offset + 4 || isGainParameter)
       && path[offset + 0] == parametersSubid()
-      && path[offset + 1] == 3 // connections
-      && path[offset + 4] == gainParameterNumber())
+      && path[offset + 1] == 3) // connections
       {
-         auto targetNumber = path[offset + 2];
-         auto sourceNumber = path[offset + 3];
-         auto index = targetNumber * sourceCount() + sourceNumber;
+         auto targetNumber = (int)path[offset + 2];
+         auto sourceNumber = (int)path[offset + 3];
 
-         if(index >= 0 && index < (unsigned int)(targetCount() * sourceCount()))
-         {
-            m_xpointGains[index] = value;
-            return true;
-         }
+         if(isGainParameter && path[offset + 4] != gainParameterNumber())
+            return -1;
+
+         if(targetNumber >= 0 && targetNumber < targetCount()
+         && sourceNumber >= 0 && sourceNumber < sourceCount())
+            return targetNumber * sourceCount() + sourceNumber;
+      }
+
+      return -1;
+   }
+
+   void DynamicNToNLinearMatrix::setCrosspointGain(util::Oid const& gainPath, int index, int value)
+   {
+      if(m_xpointGains[index] != value)
+      {
+         m_xpointGains[index] = value;
+
+         auto notificationSink = this->notificationSink();
+
+         if(notificationSink != nullptr)
+            notificationSink->notifyParameterValueChanged(gainPath, value);
+      }
+   }
+
+   bool DynamicNToNLinearMatrix::onParameterValueChanged(util::Oid const& path, int value)
+   {
+      auto isGainParameter = false;
+      auto index = crosspointIndex(path, isGainParameter);
+
+      if(index >= 0 && isGainParameter)
+      {
+         m_xpointGains[index] = value;
+         return true;
       }
 
       return false;
@@ -107,39 +135,30 @@ namespace model { namespace matrix
 
    Element* DynamicNToNLinearMatrix::emitDescendant(util::Oid const& path)
    {
-      auto offset = this->path().size();
+      auto isGainParameter = false;
+      auto index = crosspointIndex(path, isGainParameter);
 
-      if(path.size() >= offset + 4
-      && path[offset + 0] == parametersSubid()
-      && path[offset + 1] == 3) // connections)
+      if(index >= 0)
       {
-         auto targetNumber = path[offset + 2];
-         auto sourceNumber = path[offset + 3];
-         auto index = targetNumber * sourceCount() + sourceNumber;
-
-         if(index >= 0 && index < (unsigned int)(targetCount() * sourceCount()))
+         if(isGainParameter == false) // return node "parameters/<targetNumber>/<sourceNumber>"
+         {
+            auto node = new DynamicNode(path);
+            auto gainPath = std::vector<int>(path.begin(), path.end());
+            gainPath.insert(gainPath.end(), gainParameterNumber());
+
+            auto gain = new DynamicIntegerParameter(util::Oid(gainPath.begin(), gainPath.end()),
+                                                    node,
+                                                    "gain",
+                                                    this,
+                                                    m_xpointGains[index],
+                                                    minimumGain(),
+                                                    maximumGain());
+
+            return node;
+         }
+         else // return parameter "parameters/<targetNumber>/<sourceNumber>/<gainParameterNumber>"
          {
-            if(path.size() == offset + 4) // return node "parameters/<targetNumber>/<sourceNumber>"
-            {
-               auto node = new DynamicNode(path);
-               auto gainPath = std::vector<int>(path.begin(), path.end());
-               gainPath.insert(gainPath.end(), gainParameterNumber());
-
-               auto gain = new DynamicIntegerParameter(util::Oid(gainPath.begin(), gainPath.end()),
-                                                       node,
-                                                       "gain",
-                                                       this,
-                                                       m_xpointGains[index],
-                                                       minimumGain(),
-                                                       maximumGain());
-
-               return node;
-            }
-            else // return parameter "parameters/<targetNumber>/<sourceNumber>/<gainParameterNumber>"
-            {
-               if(path[offset + 4] == gainParameterNumber())
-                  return new DynamicIntegerParameter(path, nullptr, "gain", this, m_xpointGains[index], minimumGain(), maximumGain());
-            }
+            return new DynamicIntegerParameter(path, nullptr, "gain", this, m_xpointGains[index], minimumGain(), maximumGain());
          }
       }
 
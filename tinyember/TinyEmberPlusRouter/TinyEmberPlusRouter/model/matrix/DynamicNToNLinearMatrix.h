@@ -120,6 +120,34 @@ namespace model { namespace matrix
         */
       inline int gainParameterNumber() const { return 1; }
 
+      /**
+        * Resolves the path of a crosspoint node "parameters/<targetNumber>/<sourceNumber>"
+        * or of its "gain" parameter to the index of the crosspoint.
+        * @param path The path to resolve.
+        * @param isGainParameter Receives the value true if @p path points to
+        *     the "gain" parameter rather than to the crosspoint node.
+        * @return The index of the crosspoint, or -1 if @p path does not point
+        *     to a crosspoint of this matrix.
+        */
+      int crosspointIndex(util::Oid const& path, bool& isGainParameter) const;
+
+      /**
+        * Returns the value of the "gain" parameter of the crosspoint at @p index.
+        * @param index The index of the crosspoint, as returned by crosspointIndex().
+        * @return The value of the crosspoint's "gain" parameter.
+        */
+      inline int crosspointGain(int index) const { return m_xpointGains[index]; }
+
+      /**
+        * Sets the value of the "gain" parameter of the crosspoint at @p index
+        * without emitting a parameter element. The notification sink is
+        * notified if the value changed.
+        * @param gainPath The path of the crosspoint's "gain" parameter.
+        * @param index The index of the crosspoint, as returned by crosspointIndex().
+        * @param value The new value.
+        */
+      void setCrosspointGain(util::Oid const& gainPath, int index, int value);
+
       /**
         * Overridden to call the appropriate visit() overload.
         */
@@ -5,14 +5,7 @@ namespace model { namespace matrix
    LinearMatrix::LinearMatrix(int number, Element* parent, std::string const& identifier, NotificationSink* notificationSink, int targetCount, int sourceCount)
       : Matrix(number, parent, identifier, notificationSink)
    {
-      auto& targets = this->targets();
-      auto& sources = this->sources();
-
-      for(int index = 0; index < targetCount; index++)
-         targets.insert(targets.end(), new Signal(index));
-
-      for(int index = 0; index < sourceCount; index++)
-         sources.insert(sources.end(), new Signal(index));
+      createSignals(targetCount, sourceCount);
    }
 
    int LinearMatrix::targetCount() const
@@ -2,17 +2,173 @@
 
 namespace model { namespace matrix
 {
+   namespace
+   {
+      int const TargetLabelsNumber = 1;
+      int const SourceLabelsNumber = 2;
+   }
+
    Matrix::Matrix(int number, Element* parent, std::string const& identifier, NotificationSink* notificationSink)
       : Element(number, parent, identifier)
+      , m_storedTargetCount(0)
       , m_notificationSink(notificationSink)
+      , m_labels(nullptr)
    {}
 
    Matrix::~Matrix()
    {
       for each(auto signal in m_targets)
-         delete signal;
+      {
+         if(isStored(signal) == false)
+            delete signal;
+      }
 
       for each(auto signal in m_sources)
-         delete signal;
+      {
+         if(isStored(signal) == false)
+            delete signal;
+      }
+   }
+
+   void Matrix::createSignals(int targetCount, int sourceCount)
+   {
+      if(m_signals.empty() == false)
+         throw std::runtime_error("signals");
+
+      // the block must not be reallocated once pointers to its signals have been taken
+      m_signals.reserve(targetCount + sourceCount);
+
+      for(int index = 0; index < targetCount; index++)
+         m_signals.push_back(Signal(index));
+
+      for(int index = 0; index < sourceCount; index++)
+         m_signals.push_back(Signal(index));
+
+      m_storedTargetCount = targetCount;
+      m_targets.reserve(m_targets.size() + targetCount);
+      m_sources.reserve(m_sources.size() + sourceCount);
+
+      for(int index = 0; index < targetCount; index++)
+         m_targets.push_back(&m_signals[index]);
+
+      for(int index = 0; index < sourceCount; index++)
+         m_sources.push_back(&m_signals[targetCount + index]);
+   }
+
+   bool Matrix::isTarget(Signal const* signal) const
+   {
+      if(isStored(signal))
+         return signal < &m_signals.front() + m_storedTargetCount;
+
+      return util::contains(m_targets.begin(), m_targets.end(), signal);
+   }
+
+   bool Matrix::isSource(Signal const* signal) const
+   {
+      if(isStored(signal))
+         return signal >= &m_signals.front() + m_storedTargetCount;
+
+      return util::contains(m_sources.begin(), m_sources.end(), signal);
+   }
+
+   std::string Matrix::targetLabel(int number) const
+   {
+      auto const parameter = findLabel(TargetLabelsNumber, number, m_targetLabels);
+
+      return parameter != nullptr ? parameter->value() : std::string();
+   }
+
+   std::string Matrix::sourceLabel(int number) const
+   {
+      auto const parameter = findLabel(SourceLabelsNumber, number, m_sourceLabels);
+
+      return parameter != nullptr ? parameter->value() : std::string();
+   }
+
+   StringParameter const* Matrix::findLabel(int group, int number, LabelCache& cache) const
+   {
+      auto const where = cache.find(number);
+
+      if(where != cache.end())
+         return where->second;
+
+      if(m_labels == nullptr && m_labelsPath.empty() == false)
+      {
+         // walk down from the root without the path index, so that no
+         // dynamic elements are emitted for the labels
+         auto elem = static_cast<Element const*>(this);
+
+         while(elem->parent() != nullptr)
+            elem = elem->parent();
+
+         for each(auto segment in m_labelsPath)
+         {
+            elem = elem->findChild(segment);
+
+            if(elem == nullptr)
+               break;
+         }
+
+         m_labels = elem;
+      }
+
+      if(m_labels == nullptr)
+         return nullptr;
+
+      auto const labels = m_labels->findChild(group);
+      auto const parameter = labels != nullptr ? dynamic_cast<StringParameter const*>(labels->findChild(number)) : nullptr;
+
+      if(parameter != nullptr)
+         cache[number] = parameter;
+
+      return parameter;
+   }
+
+   void Matrix::connect(Salvo const& salvo, void* state)
+   {
+      auto const& entries = salvo.entries();
+
+      for each(auto const& entry in entries)
+      {
+         if(isTarget(entry.target) == false)
+            throw std::runtime_error("target");
+
+         if(entry.sources.empty() == false)
+         {
+            if(isSource(entry.sources.front()) == false)
+               throw std::runtime_error("sources");
+         }
+      }
+
+      auto changedTargets = Signal::Vector();
+
+      for each(auto const& entry in entries)
+      {
+         if(connectOverride(entry.target, entry.sources, state, entry.operation))
+         {
+            if(util::contains(changedTargets.begin(), changedTargets.end(), entry.target) == false)
+               changedTargets.push_back(entry.target);
+         }
+      }
+
+      if(changedTargets.empty() == false)
+      {
+         publishConnections(changedTargets);
+         m_notificationSink->notifyMatrixConnections(this, changedTargets, state);
+      }
+   }
+
+   void Matrix::publishConnections()
+   {
+      m_connections.publish(new ConnectionSnapshot(m_targets));
+   }
+
+   void Matrix::publishConnections(Signal::Vector const& changedTargets)
+   {
+      // the DOM thread is the only one publishing, so the snapshot cannot change in between
+      auto const current = m_connections.acquire();
+
+      if(current.isNull() == false)
+         m_connections.publish(new ConnectionSnapshot(*current, changedTargets));
    }
 }}
@@ -1,8 +1,11 @@
 #ifndef __TINYEMBERROUTER_MODEL_MATRIX_MATRIX_H
 #define __TINYEMBERROUTER_MODEL_MATRIX_MATRIX_H
 
+#include <unordered_map>
 #include "../Element.h"
+#include "../StringParameter.h"
 #include "Signal.h"
+#include "ConnectionSnapshot.h"
 #include "../NotificationSink.h"
 #include "../../util/Collection.h"
 #include "../../util/Types.h"
@@ -14,6 +17,53 @@ namespace model { namespace matrix
      */
    class Matrix : public Element
    {
+   public:
+      /**
+        * A collection of connect operations that are issued on a matrix
+        * at once, for example when a preset is recalled.
+        */
+      class Salvo
+      {
+      public:
+         /**
+           * A connect operation on a single target.
+           */
+         struct Entry
+         {
+            Entry(Signal* target, Signal::Vector const& sources, util::ConnectOperation const& operation)
+               : target(target)
+               , sources(sources)
+               , operation(operation)
+            {}
+
+            Signal* target;
+            Signal::Vector sources;
+            util::ConnectOperation operation;
+         };
+
+         typedef std::vector<Entry> EntryVector;
+
+      public:
+         /**
+           * Appends a connect operation on the specified @p target.
+           * @param target Pointer to the target to connect to.
+           * @param firstSource Iterator pointing to the first source to connect.
+           * @param lastSource Iterator pointing behind the last source to connect.
+           * @param operation The connect operation to issue.
+           */
+         template<typename InputIterator>
+         void add(Signal* target, InputIterator firstSource, InputIterator lastSource, util::ConnectOperation const& operation)
+         {
+            m_entries.push_back(Entry(target, Signal::Vector(firstSource, lastSource), operation));
+         }
+
+         inline EntryVector const& entries() const { return m_entries; }
+         inline bool empty() const { return m_entries.empty(); }
+
+      private:
+         EntryVector m_entries;
+      };
+
    public:
       /**
         * Creates a new instance of DynamicNToNLinearMatrix.
@@ -74,8 +124,35 @@ namespace model { namespace matrix
       inline void setLabelsPath(util::Oid const& value)
       {
          m_labelsPath = value;
+         m_labels = nullptr;
+         m_targetLabels.clear();
+         m_sourceLabels.clear();
       }
 
+      /**
+        * Returns the label of the target with the specified number, which is
+        * the value of the StringParameter with the same number below the
+        * "targets" child (number 1) of the labels node. Found parameters are
+        * cached, so subsequent calls neither resolve the labels path nor
+        * search the children of the labels node. The label parameters must
+        * live as long as the matrix.
+        * @param number The number of the target.
+        * @return The label of the target, or an empty string if the labels
+        *     node does not contain a parameter for the target.
+        */
+      std::string targetLabel(int number) const;
+
+      /**
+        * Returns the label of the source with the specified number, which is
+        * the value of the StringParameter with the same number below the
+        * "sources" child (number 2) of the labels node.
+        * @see targetLabel()
+        * @param number The number of the source.
+        * @return The label of the source, or an empty string if the labels
+        *     node does not contain a parameter for the source.
+        */
+      std::string sourceLabel(int number) const;
+
       /**
         * Issues a connect operation on the specified @p target.
         * @param target Pointer to the target to connect to.
@@ -100,6 +177,39 @@ namespace model { namespace matrix
       template<typename InputIterator>
       void connect(Signal* target, InputIterator firstSource, InputIterator lastSource, void* state);
 
+      /**
+        * Issues all connect operations contained in @p salvo. The salvo is
+        * validated before any connection is changed, and a single notification
+        * is issued for all targets whose connected sources were updated.
+        * @param salvo The connect operations to issue.
+        * @param state Caller-defined state to be passed through.
+        */
+      void connect(Salvo const& salvo, void* state);
+
+      /**
+        * Returns the connections of the matrix as of the last change. Unlike
+        * the connected sources of the targets, the snapshot may be read by any
+        * thread while the thread owning the DOM keeps changing connections.
+        * @return The current snapshot, or a null pointer if publishConnections()
+        *     has not been called yet.
+        */
+      inline ConnectionSnapshot::Pointer connectionSnapshot() const { return m_connections.acquire(); }
+
+      /**
+        * Tests whether @p snapshot still reflects the connections of the matrix.
+        * This method may be called from any thread.
+        * @param snapshot A snapshot previously returned by connectionSnapshot().
+        * @return True if no connection has changed since @p snapshot was published.
+        */
+      inline bool isCurrent(ConnectionSnapshot::Pointer const& snapshot) const { return m_connections.isCurrent(snapshot); }
+
+      /**
+        * Publishes a snapshot of all connections. Must be called by the thread
+        * owning the DOM once the targets have been created. Afterwards, every
+        * connect operation publishes a new snapshot before it is notified.
+        */
+      void publishConnections();
+
       /**
         * Returns the number of targets owned by the matrix.
         * @return The number of targets owned by the matrix.
@@ -138,11 +248,80 @@ namespace model { namespace matrix
         */
       virtual bool connectOverride(Signal* target, Signal::Vector const& sources, void* state, util::ConnectOperation const& operation) = 0;
 
+      /**
+        * Creates @p targetCount targets and @p sourceCount sources numbered
+        * from zero and appends them to targets() and sources(). All signals
+        * are stored in a single block owned by the matrix, so creating large
+        * matrices neither allocates every signal separately nor fragments
+        * the heap. Since a signal does not allocate its connections before
+        * it is connected, the signals of a matrix cost a single allocation.
+        * May be called only once.
+        * @param targetCount The number of targets to create.
+        * @param sourceCount The number of sources to create.
+        */
+      void createSignals(int targetCount, int sourceCount);
+
+   private:
+      /**
+        * Tests whether @p signal points into the block allocated by createSignals().
+        * @param signal Pointer to the signal to test.
+        * @return True if @p signal is owned by the block of signals.
+        */
+      inline bool isStored(Signal const* signal) const
+      {
+         return m_signals.empty() == false && signal >= &m_signals.front() && signal <= &m_signals.back();
+      }
+
+      /**
+        * Tests whether @p signal is contained in the collection returned by
+        * targets(). Targets created by createSignals() are tested in constant time.
+        * @param signal Pointer to the signal to test.
+        * @return True if @p signal is a target of the matrix.
+        */
+      bool isTarget(Signal const* signal) const;
+
+      /**
+        * Tests whether @p signal is contained in the collection returned by
+        * sources(). Sources created by createSignals() are tested in constant time.
+        * @param signal Pointer to the signal to test.
+        * @return True if @p signal is a source of the matrix.
+        */
+      bool isSource(Signal const* signal) const;
+
+      /**
+        * Publishes a snapshot that replaces the connections of @p changedTargets
+        * in the current snapshot. Does nothing as long as publishConnections()
+        * has not been called, so that the initial connects are not copied.
+        * @param changedTargets The targets whose connections have changed.
+        */
+      void publishConnections(Signal::Vector const& changedTargets);
+
+      typedef std::unordered_map<int, StringParameter const*> LabelCache;
+
+      /**
+        * Looks up the label parameter of a signal, first in @p cache and
+        * then below the labels node, and enters a found parameter in @p cache.
+        * Parameters that are not found are not cached, so labels created later
+        * are found as well.
+        * @param group The number of the child of the labels node containing
+        *     the label parameters.
+        * @param number The number of the signal.
+        * @param cache The cache of the label parameters of @p group.
+        * @return The label parameter, or nullptr if none exists.
+        */
+      StringParameter const* findLabel(int group, int number, LabelCache& cache) const;
+
    private:
+      std::vector<Signal> m_signals;
+      int m_storedTargetCount;
       Signal::Vector m_targets;
       Signal::Vector m_sources;
       NotificationSink* m_notificationSink;
       util::Oid m_labelsPath;
+      mutable Element const* m_labels;
+      mutable LabelCache m_targetLabels;
+      mutable LabelCache m_sourceLabels;
+      util::Snapshot<ConnectionSnapshot> m_connections;
    };
 
 
@@ -155,19 +334,22 @@ namespace model { namespace matrix
    template<typename InputIterator>
    inline void Matrix::connect(Signal* target, InputIterator firstSource, InputIterator lastSource, void* state, util::ConnectOperation const& operation)
    {
-      if(util::contains(m_targets.begin(), m_targets.end(), target) == false)
+      if(isTarget(target) == false)
          throw std::runtime_error("target");
 
       if(firstSource != lastSource)
       {
-         if(util::contains(m_sources.begin(), m_sources.end(), *firstSource) == false)
+         if(isSource(*firstSource) == false)
             throw std::runtime_error("sources");
       }
 
       auto sources = Signal::Vector(firstSource, lastSource);
 
       if(connectOverride(target, sources, state, operation))
+      {
+         publishConnections(Signal::Vector(1, target));
          m_notificationSink->notifyMatrixConnection(this, target, state);
+      }
    }
 
    template<typename InputIterator>
@@ -1,8 +1,9 @@
 #ifndef __TINYEMBERROUTER_MODEL_MATRIX_SIGNAL_H
 #define __TINYEMBERROUTER_MODEL_MATRIX_SIGNAL_H
 
+#include <algorithm>
+#include <climits>
 #include <vector>
-#include "../../util/Collection.h"
 
 namespace model { namespace matrix
 {
@@ -18,6 +19,14 @@ namespace model { namespace matrix
       inline int number() const { return m_number; }
       inline Vector const& connectedSources() const { return m_connectedSources; }
 
+      /**
+        * Tests whether @p source is connected to this signal. The test
+        * does not depend on the number of connected sources.
+        * @param source The source to look for.
+        * @return True if @p source is connected to this signal.
+        */
+      inline bool isConnected(Signal const* source) const { return testBit(source->number()); }
+
       // methods
       template<typename InputIterator>
       void connect(InputIterator firstSource, InputIterator lastSource, bool isAbsolute);
@@ -25,25 +34,62 @@ namespace model { namespace matrix
       template<typename InputIterator>
       void disconnect(InputIterator firstSource, InputIterator lastSource);
 
+   private:
+      typedef unsigned int Word;
+      typedef std::vector<Word> Bitset;
+
+      static const int BitsPerWord = static_cast<int>(sizeof(Word) * CHAR_BIT);
+
+      bool testBit(int number) const;
+      void setBit(int number);
+      void clearBit(int number);
+
    private:
       int m_number;
       Vector m_connectedSources;
+      Bitset m_connectionMask;
    };
 
+   inline bool Signal::testBit(int number) const
+   {
+      auto const index = static_cast<Bitset::size_type>(number / BitsPerWord);
+      return index < m_connectionMask.size() && (m_connectionMask[index] & (Word(1) << (number % BitsPerWord))) != 0;
+   }
+
+   inline void Signal::setBit(int number)
+   {
+      auto const index = static_cast<Bitset::size_type>(number / BitsPerWord);
+      if(index >= m_connectionMask.size())
+         m_connectionMask.resize(index + 1, 0);
+
+      m_connectionMask[index] |= Word(1) << (number % BitsPerWord);
+   }
+
+   inline void Signal::clearBit(int number)
+   {
+      auto const index = static_cast<Bitset::size_type>(number / BitsPerWord);
+      if(index < m_connectionMask.size())
+         m_connectionMask[index] &= ~(Word(1) << (number % BitsPerWord));
+   }
+
    template<typename InputIterator>
    inline void Signal::connect(InputIterator firstSource, InputIterator lastSource, bool isAbsolute)
    {
       if(isAbsolute)
       {
+         // clearing the words is cheaper than clearing the bits of the previous sources
+         std::fill(m_connectionMask.begin(), m_connectionMask.end(), 0);
          m_connectedSources.clear();
-         m_connectedSources.insert(m_connectedSources.end(), firstSource, lastSource);
       }
-      else
+
+      for( ; firstSource != lastSource; firstSource++)
       {
-         for( ; firstSource != lastSource; firstSource++)
+         auto const source = *firstSource;
+
+         if(testBit(source->number()) == false)
          {
-            if(util::contains(m_connectedSources.begin(), m_connectedSources.end(), *firstSource) == false)
-               m_connectedSources.insert(m_connectedSources.end(), *firstSource);
+            setBit(source->number());
+            m_connectedSources.push_back(source);
          }
       }
    }
@@ -51,13 +97,32 @@ namespace model { namespace matrix
    template<typename InputIterator>
    inline void Signal::disconnect(InputIterator firstSource, InputIterator lastSource)
    {
+      auto isAnyDisconnected = false;
+
       for( ; firstSource != lastSource; firstSource++)
       {
-         auto last = m_connectedSources.end();
-         auto where = util::find(m_connectedSources.begin(), last, *firstSource);
+         auto const number = (*firstSource)->number();
+
+         if(testBit(number))
+         {
+            clearBit(number);
+            isAnyDisconnected = true;
+         }
+      }
+
+      // remove all sources whose bits have been cleared in a single pass
+      if(isAnyDisconnected)
+      {
+         auto const last = m_connectedSources.end();
+         auto where = m_connectedSources.begin();
+
+         for(auto it = where; it != last; it++)
+         {
+            if(testBit((*it)->number()))
+               *where++ = *it;
+         }
 
-         if(where != last)
-            m_connectedSources.erase(where);
+         m_connectedSources.erase(where, last);
       }
    }
 }}
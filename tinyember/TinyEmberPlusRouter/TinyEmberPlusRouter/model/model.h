@@ -12,5 +12,6 @@
 #include "matrix/NToNNonlinearMatrix.h"
 #include "matrix/OneToNLinearMatrix.h"
 #include "ElementVisitor.h"
+#include "StateJournal.h"
 
 #endif//__TINYEMBERROUTER_MODEL_H
@@ -1,18 +1,47 @@
 #include "TcpClient.h"
+#include <utility>
+#include <QtNetwork\qhostaddress.h>
 
 namespace net
 {
+    namespace
+    {
+        /**
+         * The pool of the clients that have not been assigned a pool of their own. It is
+         * initialized before main, because clients may receive data on several threads.
+         */
+        ReceiveBufferPool s_sharedReceiveBuffers;
+    }
+
     TcpClient::TcpClient(QTcpSocket* socket)
         : m_socket(socket)
+        , m_peerName(socket->peerAddress().toString() + ":" + QString::number(socket->peerPort()))
+        , m_counters(nullptr)
+        , m_receiveBuffers(nullptr)
+        , m_queuedBytes(0)
+        , m_highWaterMark(DefaultHighWaterMark)
+        , m_maximumQueueSize(DefaultMaximumQueueSize)
+        , m_minimumKeyInterval(0)
+        , m_readTimeSlice(Q_INT64_C(1000) * DefaultReadTimeSlice)
+        , m_isReadResumePosted(false)
+        , m_isClosing(false)
+        , m_throttleTimer(new QTimer(this))
     {
+        // The timer is a child of the client, so it moves to the client's thread with it.
+        m_clock.start();
+        m_throttleTimer->setSingleShot(true);
+        m_throttleTimer->connect(m_throttleTimer, SIGNAL(timeout()), this, SLOT(onThrottleTimeout()));
+
         m_socket->connect(m_socket, SIGNAL(disconnected()), this, SLOT(onDisconnect()));
         m_socket->connect(m_socket, SIGNAL(readyRead()), this, SLOT(onReadyRead()));
+        m_socket->connect(m_socket, SIGNAL(bytesWritten(qint64)), this, SLOT(onBytesWritten(qint64)));
     }
 
     TcpClient::~TcpClient()
     {
         m_socket->disconnect(m_socket, SIGNAL(disconnected()), this, SLOT(onDisconnect()));
         m_socket->disconnect(m_socket, SIGNAL(readyRead()), this, SLOT(onReadyRead()));
+        m_socket->disconnect(m_socket, SIGNAL(bytesWritten(qint64)), this, SLOT(onBytesWritten(qint64)));
         m_socket->close();
         m_socket = nullptr;
     }
@@ -22,16 +51,224 @@ namespace net
         emit disconnected(this);
     }
 
+    void TcpClient::enqueue(QByteArray const& array, QByteArray const& key)
+    {
+        if (m_socket == nullptr || m_isClosing)
+            return;
+
+        if (key.isEmpty() == false && m_minimumKeyInterval > 0 && throttle(array, key))
+            return;
+
+        append(array, key);
+    }
+
+    bool TcpClient::throttle(QByteArray const& array, QByteArray const& key)
+    {
+        auto const now = m_clock.elapsed();
+        auto const it = m_throttles.find(key);
+
+        if (it != m_throttles.end() && it->deadline > now)
+        {
+            // The last value wins, it is sent when the interval has elapsed.
+            if (it->pending.isEmpty() == false && m_counters != nullptr)
+                m_counters->framesThrottled->increment();
+
+            it->pending = array;
+            return true;
+        }
+
+        auto throttle = Throttle();
+        throttle.deadline = now + m_minimumKeyInterval;
+        m_throttles.insert(key, throttle);
+        m_deadlines.push_back(std::make_pair(throttle.deadline, key));
+
+        if (m_throttleTimer->isActive() == false)
+            scheduleThrottleTimer(now);
+
+        return false;
+    }
+
+    void TcpClient::onThrottleTimeout()
+    {
+        auto const now = m_clock.elapsed();
+
+        while (m_deadlines.empty() == false && m_deadlines.front().first <= now)
+        {
+            auto const entry = m_deadlines.front();
+            m_deadlines.pop_front();
+
+            auto const it = m_throttles.find(entry.second);
+            if (it == m_throttles.end() || it->deadline != entry.first)
+                continue;
+
+            if (it->pending.isEmpty())
+            {
+                m_throttles.erase(it);
+            }
+            else
+            {
+                auto const array = it->pending;
+                it->pending.clear();
+                it->deadline = now + m_minimumKeyInterval;
+                m_deadlines.push_back(std::make_pair(it->deadline, entry.second));
+
+                if (m_socket != nullptr && m_isClosing == false)
+                    append(array, entry.second);
+            }
+        }
+
+        scheduleThrottleTimer(now);
+    }
+
+    void TcpClient::scheduleThrottleTimer(qint64 now)
+    {
+        if (m_deadlines.empty() == false)
+        {
+            auto const delay = m_deadlines.front().first - now;
+            m_throttleTimer->start(delay > 0 ? static_cast<int>(delay) : 0);
+        }
+    }
+
+    void TcpClient::append(QByteArray const& array, QByteArray const& key)
+    {
+        if (key.isEmpty() == false)
+        {
+            auto const last = m_queue.end();
+            for (auto it = m_queue.begin(); it != last; ++it)
+            {
+                if (it->key == key)
+                {
+                    // The queued frame has been superseded and has not been sent yet.
+                    if (m_counters != nullptr)
+                        m_counters->framesSuperseded->increment();
+
+                    m_queuedBytes += array.size() - it->data.size();
+                    it->data = array;
+                    return;
+                }
+            }
+        }
+
+        Frame frame;
+        frame.data = array;
+        frame.key = key;
+        m_queue.push_back(frame);
+        m_queuedBytes += array.size();
+
+        if (m_queuedBytes > m_maximumQueueSize)
+        {
+            // The client doesn't read its data, so it is disconnected before
+            // the queue consumes all memory.
+            if (m_counters != nullptr)
+                m_counters->framesDiscarded->increment(m_queue.size());
+
+            m_queue.clear();
+            m_queuedBytes = 0;
+            m_socket->abort();
+            return;
+        }
+
+        flush();
+    }
+
+    void TcpClient::flush()
+    {
+        auto socket = m_socket;
+        if (socket == nullptr || m_queue.empty() || socket->bytesToWrite() >= m_highWaterMark)
+            return;
+
+        if (m_counters != nullptr)
+            m_counters->bytesSent->increment(m_queuedBytes);
+
+        if (m_queue.size() == 1)
+        {
+            socket->write(m_queue.front().data);
+        }
+        else
+        {
+            auto buffer = QByteArray();
+            buffer.reserve(static_cast<int>(m_queuedBytes));
+
+            auto const last = m_queue.end();
+            for (auto it = m_queue.begin(); it != last; ++it)
+                buffer.append(it->data);
+
+            socket->write(buffer);
+        }
+
+        m_queue.clear();
+        m_queuedBytes = 0;
+    }
+
+    void TcpClient::close()
+    {
+        if (m_socket == nullptr || m_isClosing)
+            return;
+
+        m_isClosing = true;
+        QMetaObject::invokeMethod(this, "onClose", Qt::QueuedConnection);
+    }
+
+    void TcpClient::onClose()
+    {
+        // The socket itself delays the disconnect until its buffer has been written.
+        if (m_socket != nullptr && m_queue.empty())
+            m_socket->disconnectFromHost();
+    }
+
+    void TcpClient::onBytesWritten(qint64 bytes)
+    {
+        Q_UNUSED(bytes);
+        auto const wasQueued = m_queue.empty() == false;
+        flush();
+
+        if (m_isClosing && wasQueued && m_queue.empty())
+            QMetaObject::invokeMethod(this, "onClose", Qt::QueuedConnection);
+    }
+
     void TcpClient::onReadyRead()
     {
         auto socket = m_socket;
-        if (socket != nullptr)
+        if (socket == nullptr || m_isReadResumePosted)
+            return;
+
+        // Everything that has arrived is drained into a single pooled buffer, in as few
+        // reads as its size permits, and handed to the decoder without further copies.
+        // A large message is read in time slices, so the other events of the thread
+        // are processed in between. The socket does not signal the data it has already
+        // buffered again, so reading is resumed by a queued call.
+        auto& pool = m_receiveBuffers != nullptr ? *m_receiveBuffers : s_sharedReceiveBuffers;
+        auto buffer = pool.acquire();
+        auto const data = buffer.data();
+        auto const capacity = static_cast<qint64>(buffer.size());
+        auto const deadline = m_readTimeSlice > 0 ? m_clock.nsecsElapsed() + m_readTimeSlice : 0;
+
+        while(socket->bytesAvailable() > 0)
         {
-            while(socket->bytesAvailable() > 0)
+            if (deadline != 0 && m_clock.nsecsElapsed() >= deadline)
             {
-                auto const size = socket->read(reinterpret_cast<char*>(m_buffer), RxBufferSize);
-                read(m_buffer, m_buffer + size, size);
+                m_isReadResumePosted = true;
+                QMetaObject::invokeMethod(this, "onReadResume", Qt::QueuedConnection);
+                break;
             }
+
+            auto const size = socket->read(reinterpret_cast<char*>(data), capacity);
+            if (size <= 0)
+                break;
+
+            if (m_counters != nullptr)
+                m_counters->bytesReceived->increment(size);
+
+            if (m_isClosing == false)
+                read(data, data + size, static_cast<size_type>(size));
         }
+
+        pool.release(std::move(buffer));
+    }
+
+    void TcpClient::onReadResume()
+    {
+        m_isReadResumePosted = false;
+        onReadyRead();
     }
 }
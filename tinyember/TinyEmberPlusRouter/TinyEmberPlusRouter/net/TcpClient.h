@@ -1,7 +1,15 @@
 #ifndef __TINYEMBERROUTER_NET_TCPCLIENT_H
 #define __TINYEMBERROUTER_NET_TCPCLIENT_H
 
+#include <atomic>
+#include <deque>
 #include <QtNetwork\qtcpsocket.h>
+#include <qelapsedtimer.h>
+#include <qhash.h>
+#include <qthread.h>
+#include <qtimer.h>
+#include "../util/Metrics.h"
+#include "ReceiveBufferPool.h"
 
 namespace net
 {
@@ -19,6 +27,27 @@ namespace net
             typedef value_type const* const_iterator;
             typedef std::size_t size_type;
 
+            /**
+             * The counters a client updates, which are shared by all clients of a server.
+             */
+            struct Counters
+            {
+                /** The number of bytes read from the socket. */
+                util::Counter* bytesReceived;
+
+                /** The number of bytes handed to the socket. */
+                util::Counter* bytesSent;
+
+                /** The number of queued frames replaced by a later frame with the same key. */
+                util::Counter* framesSuperseded;
+
+                /** The number of held back frames replaced by a later frame with the same key. */
+                util::Counter* framesThrottled;
+
+                /** The number of frames discarded because the output queue was full. */
+                util::Counter* framesDiscarded;
+            };
+
             /** Destructor */
             virtual ~TcpClient();
 
@@ -31,11 +60,104 @@ namespace net
             void write(InputIterator first, InputIterator last);
 
             /**
-             * Sends the passed byte array to the connected client.
+             * Sends the passed byte array to the connected client. When called from
+             * a thread other than the one the client lives in, the array is queued
+             * and written by the client's thread.
              * @param array The array to transmit.
              */
             void write(QByteArray const& array);
 
+            /**
+             * Sends the passed byte array to the connected client. While the frame is
+             * waiting in the output queue, it is replaced by any later frame written
+             * with the same @p key, so a slow client only receives the latest one. When called from
+             * a thread other than the one the client lives in, the frame is passed to
+             * the client's thread.
+             * @param array The array to transmit.
+             * @param key Identifies the content of the frame, for example the path of
+             *      the parameter whose value it contains. An empty key never matches.
+             */
+            void write(QByteArray const& array, QByteArray const& key);
+
+            /**
+             * Sends the passed byte array to the connected client through the event
+             * queue of the client's thread, even when called within that thread. The
+             * array is thus written after all frames other threads have passed to
+             * the client before.
+             * @param array The array to transmit.
+             */
+            void post(QByteArray const& array);
+
+            /**
+             * Closes the connection once the frames in the output queue have been sent.
+             * Frames that reach the queue and data received afterwards are discarded.
+             * Must be called within the client's thread.
+             */
+            void close();
+
+            /**
+             * Sets the number of bytes the socket may buffer before further frames are
+             * kept in the output queue. Queued frames are written at once as soon as
+             * the socket buffer drops below this mark.
+             * @param value The new high-water mark in bytes.
+             */
+            void setHighWaterMark(qint64 value);
+
+            /**
+             * Sets the number of bytes the output queue may hold. When a client does not
+             * read its data and the queue exceeds this size, the connection is aborted.
+             * @param value The new maximum queue size in bytes.
+             */
+            void setMaximumQueueSize(qint64 value);
+
+            /**
+             * Sets the minimum time between two frames written with the same key. A
+             * keyed frame that follows the previous one too soon is held back until
+             * the interval has elapsed and is replaced by any later frame with the same
+             * key, so the client receives at most one frame per key and interval, and
+             * always the latest one. Frames without a key are never held back.
+             * Must be called before the client is used by another thread.
+             * @param milliseconds The minimum interval, 0 disables the rate limit.
+             */
+            void setMinimumKeyInterval(int milliseconds);
+
+            /**
+             * Sets the counters this client updates. Must be called before the client is
+             * used by another thread.
+             * @param value The counters, or nullptr to not count anything.
+             */
+            void setCounters(Counters const* value);
+
+            /**
+             * Sets the pool the buffers for receiving data are taken from. Must be called before the client is
+             * used by another thread.
+             * @param value The pool, or nullptr to use a pool shared by all clients that
+             *      have none. The pool must outlive the client.
+             */
+            void setReceiveBufferPool(ReceiveBufferPool* value);
+
+            /**
+             * Sets the time the client spends reading and decoding received data before
+             * it returns to the event loop. The data remaining in the socket is read
+             * when the other events of the thread have been processed. Must be called
+             * before the client is used by another thread.
+             * @param microseconds The duration of a time slice, 0 reads all available
+             *      data at once.
+             */
+            void setReadTimeSlice(qint64 microseconds);
+
+            /**
+             * Returns the number of bytes in the output queue. May be called by any thread.
+             * @return The number of bytes waiting to be handed to the socket.
+             */
+            qint64 queuedBytes() const;
+
+            /**
+             * Returns the address and port of the remote end of the connection.
+             * @return The address of the remote end, like 192.168.0.1:50000.
+             */
+            QString const& peerName() const;
+
         signals:
             /**
              * This signal is emitted when the socket disconnects.
@@ -51,7 +173,8 @@ namespace net
             explicit TcpClient(QTcpSocket* socket);
 
             /**
-             * Handles bytes received from the connected client.
+             * Handles bytes received from the connected client. The bytes are passed in the
+             * receive buffer, which is reused once this method returns.
              * @param first Points to the first element in the rx buffer.
              * @param last Points one past the last element of the current rx buffer.
              * @param size The number of bytes that have been received.
@@ -70,11 +193,120 @@ namespace net
              */
             void onReadyRead();
 
+            /**
+             * Continues reading the data that remained in the socket when the last time
+             * slice has been used up.
+             */
+            void onReadResume();
+
+            /**
+             * Appends the passed frame to the output queue. This slot is invoked
+             * within the client's thread.
+             * @param array The frame to transmit.
+             * @param key Identifies the content of the frame.
+             */
+            void enqueue(QByteArray const& array, QByteArray const& key);
+
+            /**
+             * Writes the queued frames when the socket buffer has been drained.
+             * @param bytes The number of bytes the socket has written.
+             */
+            void onBytesWritten(qint64 bytes);
+
+            /**
+             * Releases the frames that have been held back by the rate limit and whose
+             * interval has elapsed.
+             */
+            void onThrottleTimeout();
+
+            /**
+             * Disconnects from the peer once the output queue has been drained. This
+             * slot is invoked by a queued call, so the socket is not disconnected while
+             * the client is still processing the data it has received.
+             */
+            void onClose();
+
         private:
-            enum { RxBufferSize = 4096, };
+            /**
+             * Appends a frame to the output queue, replacing a queued frame with the
+             * same key, and flushes the queue.
+             * @param array The frame to transmit.
+             * @param key Identifies the content of the frame.
+             */
+            void append(QByteArray const& array, QByteArray const& key);
+
+            /**
+             * Applies the rate limit to a keyed frame. If the frame may be sent, the
+             * key is blocked for the minimum interval. Otherwise, the frame replaces
+             * the one that is already held back for the same key.
+             * @param array The frame to transmit.
+             * @param key Identifies the content of the frame.
+             * @return true if the frame has been held back.
+             */
+            bool throttle(QByteArray const& array, QByteArray const& key);
+
+            /**
+             * Starts the throttle timer for the earliest deadline, if any.
+             * @param now The current time of the throttle clock.
+             */
+            void scheduleThrottleTimer(qint64 now);
+
+            /**
+             * Hands all queued frames to the socket in a single write, unless the
+             * socket buffer is above the high-water mark.
+             */
+            void flush();
+
+        private:
+            enum
+            {
+                DefaultHighWaterMark = 64 * 1024,
+                DefaultMaximumQueueSize = 16 * 1024 * 1024,
+                DefaultReadTimeSlice = 5000,
+            };
+
+            struct Frame
+            {
+                QByteArray data;
+                QByteArray key;
+            };
+
+            typedef std::deque<Frame> FrameQueue;
+
+            /**
+             * The rate limit state of a key that has been sent within the last interval.
+             */
+            struct Throttle
+            {
+                qint64 deadline;
+                QByteArray pending;
+            };
+
+            typedef QHash<QByteArray, Throttle> ThrottleMap;
+
+            /**
+             * The deadlines in the order they expire. Since all keys share the same
+             * interval, new deadlines are always appended to the back. An entry whose
+             * deadline differs from the one of its key is obsolete and skipped.
+             */
+            typedef std::deque<std::pair<qint64, QByteArray> > DeadlineQueue;
 
-            value_type m_buffer[RxBufferSize];
             QTcpSocket* m_socket;
+            QString const m_peerName;
+            Counters const* m_counters;
+            ReceiveBufferPool* m_receiveBuffers;
+            FrameQueue m_queue;
+            std::atomic<qint64> m_queuedBytes;
+            qint64 m_highWaterMark;
+            qint64 m_maximumQueueSize;
+            int m_minimumKeyInterval;
+            ThrottleMap m_throttles;
+            DeadlineQueue m_deadlines;
+            qint64 m_readTimeSlice;
+            bool m_isReadResumePosted;
+            bool m_isClosing;
+            QElapsedTimer m_clock;
+            QTimer* m_throttleTimer;
     };
 
     /**************************************************************************
@@ -91,9 +323,60 @@ namespace net
 
     inline void TcpClient::write(QByteArray const& array)
     {
-        auto socket = m_socket;
-        if (socket != nullptr)
-            socket->write(array);
+        write(array, QByteArray());
+    }
+
+    inline void TcpClient::write(QByteArray const& array, QByteArray const& key)
+    {
+        if (QThread::currentThread() == thread())
+            enqueue(array, key);
+        else
+            QMetaObject::invokeMethod(this, "enqueue", Qt::QueuedConnection, Q_ARG(QByteArray, array), Q_ARG(QByteArray, key));
+    }
+
+    inline void TcpClient::post(QByteArray const& array)
+    {
+        QMetaObject::invokeMethod(this, "enqueue", Qt::QueuedConnection, Q_ARG(QByteArray, array), Q_ARG(QByteArray, QByteArray()));
+    }
+
+    inline void TcpClient::setHighWaterMark(qint64 value)
+    {
+        m_highWaterMark = value;
+    }
+
+    inline void TcpClient::setMaximumQueueSize(qint64 value)
+    {
+        m_maximumQueueSize = value;
+    }
+
+    inline void TcpClient::setMinimumKeyInterval(int milliseconds)
+    {
+        m_minimumKeyInterval = milliseconds;
+    }
+
+    inline void TcpClient::setCounters(Counters const* value)
+    {
+        m_counters = value;
+    }
+
+    inline void TcpClient::setReceiveBufferPool(ReceiveBufferPool* value)
+    {
+        m_receiveBuffers = value;
+    }
+
+    inline void TcpClient::setReadTimeSlice(qint64 microseconds)
+    {
+        m_readTimeSlice = microseconds * 1000;
+    }
+
+    inline qint64 TcpClient::queuedBytes() const
+    {
+        return m_queuedBytes.load(std::memory_order_relaxed);
+    }
+
+    inline QString const& TcpClient::peerName() const
+    {
+        return m_peerName;
     }
 }
 
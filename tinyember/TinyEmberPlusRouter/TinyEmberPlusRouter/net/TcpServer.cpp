@@ -11,13 +11,21 @@ namespace net
         : QTcpServer(parent)
         , m_factory(factory)
         , m_mutex(QMutex::Recursive)
+        , m_registry(nullptr)
+        , m_accepted(nullptr)
     {
+        // The clients live in their own threads, so their disconnect signals are queued.
+        qRegisterMetaType<TcpClient*>("TcpClient*");
+
         connect(this, SIGNAL(newConnection()), this, SLOT(clientAccepted()));
         listen(QHostAddress::Any, port);
     }
 
     TcpServer::~TcpServer()
     {
+        if (m_registry != nullptr)
+            m_registry->removeCollector(this);
+
         auto clients = ClientCollection();
         {
             QMutexLocker const lock(&m_mutex);
@@ -27,7 +35,15 @@ namespace net
 
         auto const last = clients.end();
         for (auto first = clients.begin(); first != last; ++first)
-            delete *first;
+        {
+            auto const client = *first;
+            auto const thread = client->thread();
+            thread->quit();
+            thread->wait();
+
+            delete client;
+            delete thread;
+        }
     }
 
     void TcpServer::write(QByteArray const& array)
@@ -45,11 +61,27 @@ namespace net
         if (socket != nullptr)
         {
             auto const client = m_factory->create(socket);
+            client->setReceiveBufferPool(&m_receiveBuffers);
+            if (m_registry != nullptr)
+            {
+                m_accepted->increment();
+                client->setCounters(&m_counters);
+            }
+
             connect(client, SIGNAL(disconnected(TcpClient*)), this, SLOT(clientDisconnected(TcpClient*)));
             {
                 QMutexLocker const lock(&m_mutex);
                 m_clients.push_back(client);
             }
+
+            // Each client receives and decodes its data within its own thread. The socket
+            // becomes a child of the client, so that both are moved to the new thread.
+            auto const thread = new QThread();
+            socket->setParent(client);
+            client->moveToThread(thread);
+            connect(client, SIGNAL(destroyed()), thread, SLOT(quit()));
+            connect(thread, SIGNAL(finished()), thread, SLOT(deleteLater()));
+            thread->start();
         }
     }
 
@@ -65,8 +97,46 @@ namespace net
             {
                 m_clients.erase(result);
             }
+        }
 
-            delete client;
+        // The client is deleted by its own thread, which terminates afterwards.
+        client->deleteLater();
+    }
+
+    bool TcpServer::contains(TcpClient const* client) const
+    {
+        QMutexLocker const lock(&m_mutex);
+        auto const first = m_clients.begin();
+        auto const last = m_clients.end();
+        return std::find(first, last, client) != last;
+    }
+
+    void TcpServer::setMetrics(util::MetricsRegistry* registry)
+    {
+        m_registry = registry;
+        m_portLabel = util::MetricsWriter::label("port", QString::number(serverPort()));
+        m_accepted = registry->counter("tinyember_connections_accepted_total", "The number of accepted connections.", m_portLabel);
+        m_counters.bytesReceived = registry->counter("tinyember_bytes_received_total", "The number of bytes received from all clients.", m_portLabel);
+        m_counters.bytesSent = registry->counter("tinyember_bytes_sent_total", "The number of bytes sent to all clients.", m_portLabel);
+
+        auto const name = QByteArray("tinyember_frames_dropped_total");
+        auto const help = QByteArray("The number of frames that have not been sent to a client.");
+        m_counters.framesSuperseded = registry->counter(name, help, m_portLabel + "," + util::MetricsWriter::label("reason", "superseded"));
+        m_counters.framesThrottled = registry->counter(name, help, m_portLabel + "," + util::MetricsWriter::label("reason", "throttled"));
+        m_counters.framesDiscarded = registry->counter(name, help, m_portLabel + "," + util::MetricsWriter::label("reason", "overflow"));
+
+        registry->addCollector(this);
+    }
+
+    void TcpServer::collect(util::MetricsWriter& writer) const
+    {
+        QMutexLocker const lock(&m_mutex);
+        writer.writeGauge("tinyember_connections", "The number of connected clients.", m_portLabel, static_cast<qint64>(m_clients.size()));
+
+        for each(auto client in m_clients)
+        {
+            auto const labels = m_portLabel + "," + util::MetricsWriter::label("client", client->peerName());
+            writer.writeGauge("tinyember_client_queued_bytes", "The number of bytes waiting in the output queue of a client.", labels, client->queuedBytes());
         }
     }
 }
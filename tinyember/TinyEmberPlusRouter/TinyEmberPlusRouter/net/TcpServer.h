@@ -5,17 +5,22 @@
 #include <QtNetwork/QTcpServer.h>
 #include <qmutex.h>
 #include <qthread.h>
+#include "ReceiveBufferPool.h"
+#include "TcpClient.h"
+#include "../util/Metrics.h"
 
 namespace net
 {
-    class TcpClient;
     class TcpClientFactory;
 
     /**
      * Implementation of a tcp/ip server which listens to a specified port and
-     * uses a factory to create clients for accepted connections.
+     * uses a factory to create clients for accepted connections. Every client
+     * is moved to a thread of its own, which handles the socket i/o.
+     * When metrics are enabled, the server exports the number of connected
+     * clients and the size of the output queue of each client.
      */
-    class TcpServer : public QTcpServer
+    class TcpServer : public QTcpServer, private util::MetricsCollector
     {
         Q_OBJECT;
         public:
@@ -45,6 +50,73 @@ namespace net
             template<typename InputIterator>
             void write(InputIterator first, InputIterator last);
 
+            /**
+             * Sends the passed s101 packets to all currently connected clients. The packets
+             * are merged into a single array that is built once and shared by all clients,
+             * instead of being copied for each packet and client.
+             * @param first An iterator that points to the first packet to send.
+             * @param last An iterator that points one past the last packet to send.
+             * @note A packet must provide the methods begin(), end() and size().
+             */
+            template<typename PacketIterator>
+            void writePackets(PacketIterator first, PacketIterator last);
+
+            /**
+             * Sends the passed s101 packets to all currently connected clients accepted
+             * by @p accept. The packets are merged and shared like with writePackets.
+             * @param first An iterator that points to the first packet to send.
+             * @param last An iterator that points one past the last packet to send.
+             * @param accept A predicate which is invoked with a pointer to each client
+             *      and returns true if the packets shall be sent to that client.
+             * @param key Identifies the content of the packets. Packets still waiting
+             *      in the output queue of a client are replaced by later packets with
+             *      the same key, see TcpClient::write.
+             */
+            template<typename PacketIterator, typename Predicate>
+            void writePackets(PacketIterator first, PacketIterator last, Predicate accept, QByteArray const& key = QByteArray());
+
+            /**
+             * Tests whether at least one of the currently connected clients is accepted
+             * by @p accept.
+             * @param accept A predicate which is invoked with a pointer to each client.
+             * @return true if @p accept returned true for at least one client.
+             */
+            template<typename Predicate>
+            bool containsAny(Predicate accept) const;
+
+            /**
+             * Invokes @p function with a pointer to each of the currently connected clients.
+             * @param function A function object which is invoked with a pointer to each client.
+             */
+            template<typename Function>
+            void forEach(Function function) const;
+
+            /**
+             * Tests whether the passed client is still connected. Clients are only removed
+             * within the thread of the server, so the result remains valid until control
+             * returns to the event loop of that thread.
+             * @param client The client to look for.
+             * @return true if the client is connected, otherwise false.
+             */
+            bool contains(TcpClient const* client) const;
+
+            /**
+             * Creates the traffic counters of this server, which are labelled with its port,
+             * and registers the server as collector. Must be called before the first client
+             * connects.
+             * @param registry The registry to create the metrics with, which must outlive
+             *      the server.
+             */
+            void setMetrics(util::MetricsRegistry* registry);
+
+            /**
+             * Sets the size of the buffers the clients receive their data with. A client
+             * reads as much of the available data as fits into one buffer at once, and the
+             * buffers are shared by all clients of the server. The default size is 64 KB.
+             * @param value The size of a receive buffer in bytes.
+             */
+            void setReceiveBufferSize(std::size_t value);
+
         private slots:
             /**
              * Handles an accepted connection.
@@ -57,11 +129,32 @@ namespace net
              */
             void clientDisconnected(TcpClient* client);
 
+        private:
+            /**
+             * Writes the number of connected clients and the sizes of their output queues.
+             * @param writer The writer to pass the metrics to.
+             */
+            virtual void collect(util::MetricsWriter& writer) const;
+
+            /**
+             * Merges the passed s101 packets into a single array.
+             * @param first An iterator that points to the first packet to merge.
+             * @param last An iterator that points one past the last packet to merge.
+             * @return The array containing all packets.
+             */
+            template<typename PacketIterator>
+            static QByteArray mergePackets(PacketIterator first, PacketIterator last);
+
         private:
             typedef std::vector<TcpClient*> ClientCollection;
             ClientCollection m_clients;
             TcpClientFactory *const m_factory;
-            QMutex m_mutex;
+            mutable QMutex m_mutex;
+            util::MetricsRegistry* m_registry;
+            TcpClient::Counters m_counters;
+            ReceiveBufferPool m_receiveBuffers;
+            util::Counter* m_accepted;
+            QByteArray m_portLabel;
     };
 
     /**************************************************************************
@@ -75,6 +168,72 @@ namespace net
         std::copy(first, last, std::back_inserter(array));
         write(array);
     }
+
+    inline void TcpServer::setReceiveBufferSize(std::size_t value)
+    {
+        m_receiveBuffers.setBufferSize(value);
+    }
+
+    template<typename PacketIterator>
+    inline void TcpServer::writePackets(PacketIterator first, PacketIterator last)
+    {
+        write(mergePackets(first, last));
+    }
+
+    template<typename PacketIterator, typename Predicate>
+    inline void TcpServer::writePackets(PacketIterator first, PacketIterator last, Predicate accept, QByteArray const& key)
+    {
+        auto const array = mergePackets(first, last);
+
+        QMutexLocker const lock(&m_mutex);
+        auto const end = m_clients.end();
+        for (auto it = m_clients.begin(); it != end; ++it)
+        {
+            if (accept(*it))
+                (*it)->write(array, key);
+        }
+    }
+
+    template<typename Predicate>
+    inline bool TcpServer::containsAny(Predicate accept) const
+    {
+        QMutexLocker const lock(&m_mutex);
+        auto const end = m_clients.end();
+        for (auto it = m_clients.begin(); it != end; ++it)
+        {
+            if (accept(*it))
+                return true;
+        }
+
+        return false;
+    }
+
+    template<typename Function>
+    inline void TcpServer::forEach(Function function) const
+    {
+        QMutexLocker const lock(&m_mutex);
+        auto const end = m_clients.end();
+        for (auto it = m_clients.begin(); it != end; ++it)
+            function(*it);
+    }
+
+    template<typename PacketIterator>
+    inline QByteArray TcpServer::mergePackets(PacketIterator first, PacketIterator last)
+    {
+        auto size = 0;
+        for (auto it = first; it != last; ++it)
+            size += static_cast<int>(it->size());
+
+        auto array = QByteArray();
+        array.reserve(size);
+        for ( ; first != last; ++first)
+        {
+            if (first->size() > 0)
+                array.append(reinterpret_cast<char const*>(&*first->begin()), static_cast<int>(first->size()));
+        }
+
+        return array;
+    }
 }
 
 #endif//__TINYEMBERROUTER_NET_TCPSERVER_H
@@ -0,0 +1,125 @@
+#ifndef __TINYEMBERROUTER_UTIL_CHANGELOG_H
+#define __TINYEMBERROUTER_UTIL_CHANGELOG_H
+
+#include <cstddef>
+#include <vector>
+#include "Types.h"
+
+namespace util
+{
+   /**
+     * Ring buffer of the most recent changes of the DOM. Every change is
+     * tagged with a sequence number which increases by one with each change,
+     * so that a consumer that has been disconnected for a short time can
+     * query the changes it has missed instead of querying the whole tree.
+     * The sequence numbers start at zero whenever the provider is started.
+     */
+   class ChangeLog
+   {
+   public:
+      /**
+        * A single change.
+        */
+      struct Entry
+      {
+         Entry(long sequence, Oid const& path, int target)
+            : sequence(sequence)
+            , path(path)
+            , target(target)
+         {}
+
+         long sequence;
+         Oid path;
+
+         /** The number of the matrix target that changed, or -1 if the element itself changed. */
+         int target;
+      };
+
+      typedef std::vector<Entry> EntryVector;
+
+   public:
+      /**
+        * Creates a new instance of ChangeLog.
+        * @param capacity The number of changes to keep.
+        */
+      explicit ChangeLog(std::size_t capacity);
+
+      /**
+        * Returns the sequence number of the last change.
+        * @return The sequence number of the last change, or 0 if nothing has changed yet.
+        */
+      inline long sequence() const { return m_sequence; }
+
+      /**
+        * Appends a change, replacing the oldest change once the log is full.
+        * @param path The path of the element that changed.
+        * @param target The number of the matrix target that changed, or -1
+        *     if the element itself changed.
+        */
+      void add(Oid const& path, int target = -1);
+
+      /**
+        * Copies the changes made after the change with the specified
+        * sequence number, oldest first.
+        * @param sequence The sequence number of the last change known to the caller.
+        * @param entries Receives the changes.
+        * @return False if the log no longer contains all changes made since
+        *     @p sequence, or if @p sequence has not been assigned yet.
+        */
+      bool changesSince(long sequence, EntryVector& entries) const;
+
+   private:
+      EntryVector m_entries;
+      std::size_t m_capacity;
+      std::size_t m_next;
+      long m_sequence;
+   };
+
+
+   // ========================================================
+   //
+   // Inline Implementation
+   //
+   // ========================================================
+
+   inline ChangeLog::ChangeLog(std::size_t capacity)
+      : m_capacity(capacity > 0 ? capacity : 1)
+      , m_next(0)
+      , m_sequence(0)
+   {
+      m_entries.reserve(m_capacity);
+   }
+
+   inline void ChangeLog::add(Oid const& path, int target)
+   {
+      auto const entry = Entry(++m_sequence, path, target);
+
+      if(m_entries.size() < m_capacity)
+         m_entries.push_back(entry);
+      else
+         m_entries[m_next] = entry;
+
+      m_next = (m_next + 1) % m_capacity;
+   }
+
+   inline bool ChangeLog::changesSince(long sequence, EntryVector& entries) const
+   {
+      if(sequence < 0 || sequence > m_sequence)
+         return false;
+
+      auto const count = static_cast<std::size_t>(m_sequence - sequence);
+      auto const size = m_entries.size();
+
+      if(count > size)
+         return false;
+
+      // while the log is not full, m_next equals its size, so the oldest
+      // entry is found the same way in both cases
+      for(auto index = size - count; index < size; index++)
+         entries.push_back(m_entries[(m_next + index) % size]);
+
+      return true;
+   }
+}
+
+#endif//__TINYEMBERROUTER_UTIL_CHANGELOG_H
@@ -0,0 +1,74 @@
+#include <algorithm>
+#include <QtCore>
+#include "LatencyTrace.h"
+
+namespace util
+{
+   namespace
+   {
+      QElapsedTimer startClock()
+      {
+         auto timer = QElapsedTimer();
+         timer.start();
+         return timer;
+      }
+
+      // Initialized before main, so reading it needs no synchronization.
+      QElapsedTimer const clock = startClock();
+   }
+
+   // ========================================================
+   //
+   // LatencyTrace Definitions
+   //
+   // ========================================================
+
+   //static
+   qint64 LatencyTrace::now()
+   {
+      return clock.nsecsElapsed();
+   }
+
+   LatencyTrace::LatencyTrace()
+   {
+      std::fill(m_durations, m_durations + LatencyStage::Count, 0);
+   }
+
+   qint64 LatencyTrace::total() const
+   {
+      auto result = qint64(0);
+
+      for(auto stage = 0; stage < LatencyStage::Count; stage++)
+         result += m_durations[stage];
+
+      return result;
+   }
+
+
+   // ========================================================
+   //
+   // LatencyHistogram Definitions
+   //
+   // ========================================================
+
+   LatencyHistogram::LatencyHistogram()
+      : m_count(0)
+   {
+      std::fill(m_buckets, m_buckets + BucketCount, 0);
+   }
+
+   void LatencyHistogram::record(qint64 nanoseconds)
+   {
+      auto microseconds = nanoseconds / 1000;
+      auto bucket = 0;
+
+      while(microseconds > 0 && bucket < BucketCount - 1)
+      {
+         microseconds >>= 1;
+         bucket++;
+      }
+
+      m_buckets[bucket]++;
+      m_count++;
+   }
+}
@@ -0,0 +1,214 @@
+#ifndef __TINYEMBERROUTER_UTIL_LATENCYTRACE_H
+#define __TINYEMBERROUTER_UTIL_LATENCYTRACE_H
+
+#include <QtGlobal>
+
+namespace util
+{
+   /**
+     * Enumeration of the stages a request passes, from receiving its first
+     * bytes to encoding the responses.
+     */
+   struct LatencyStage
+   {
+      enum _Domain
+      {
+         /** s101 deframing in StreamDecoder::readBatch. */
+         Deframe = 0,
+
+         /** Parsing of the BER tags, lengths and values in AsyncBerReader::read. */
+         BerDecode,
+
+         /** Creating and attaching the dom nodes in AsyncDomReader. */
+         DomAssembly,
+
+         /** Waiting for the thread owning the DOM. */
+         Queue,
+
+         /** Applying the request in Dispatcher::receiveGlow, without encoding the responses. */
+         Dispatch,
+
+         /** Encoding the responses and the notifications caused by the request. */
+         Encode,
+
+         Count
+      };
+   };
+
+   /**
+     * The time a single request has spent in each stage.
+     */
+   class LatencyTrace
+   {
+   public:
+      /**
+        * Returns the current time of a monotonic clock.
+        * @return The number of nanoseconds since the application has been started.
+        */
+      static qint64 now();
+
+   public:
+      /** Initializes a trace with all durations set to zero. */
+      LatencyTrace();
+
+      /**
+        * Adds time spent in a stage.
+        * @param stage The stage.
+        * @param nanoseconds The number of nanoseconds to add.
+        */
+      void add(LatencyStage::_Domain stage, qint64 nanoseconds);
+
+      /**
+        * Returns the time spent in a stage.
+        * @param stage The stage.
+        * @return The number of nanoseconds spent in the stage.
+        */
+      qint64 duration(LatencyStage::_Domain stage) const;
+
+      /**
+        * Returns the time spent in all stages.
+        * @return The number of nanoseconds spent in all stages.
+        */
+      qint64 total() const;
+
+   private:
+      qint64 m_durations[LatencyStage::Count];
+   };
+
+   /**
+     * Counts durations in buckets of powers of two microseconds. Bucket 0 contains
+     * the durations below one microsecond, bucket i the durations from 2^(i - 1) up to
+     * 2^i microseconds and the last bucket all longer ones.
+     */
+   class LatencyHistogram
+   {
+   public:
+      enum { BucketCount = 24 };
+
+      /** Initializes an empty histogram. */
+      LatencyHistogram();
+
+      /**
+        * Adds a duration to its bucket.
+        * @param nanoseconds The duration to add.
+        */
+      void record(qint64 nanoseconds);
+
+      /**
+        * Returns the number of durations in a bucket.
+        * @param bucket The index of the bucket, less than BucketCount.
+        * @return The number of durations in the bucket.
+        */
+      quint64 count(int bucket) const;
+
+      /**
+        * Returns the number of recorded durations.
+        * @return The number of recorded durations.
+        */
+      quint64 count() const;
+
+      /**
+        * Returns the exclusive upper bound of a bucket.
+        * @param bucket The index of the bucket, less than BucketCount - 1.
+        * @return The upper bound of the bucket in microseconds.
+        */
+      static qint64 upperBound(int bucket);
+
+   private:
+      quint64 m_buckets[BucketCount];
+      quint64 m_count;
+   };
+
+   /**
+     * Interface which receives the traces of all completed requests, e.g. to export
+     * them to a monitoring system. It is always invoked within the thread owning the DOM.
+     */
+   class LatencySink
+   {
+   public:
+      /** Destructor */
+      virtual ~LatencySink()
+      {}
+
+      /**
+        * Called when a request and all of its responses have been processed.
+        * @param trace The time the request has spent in each stage.
+        * @param histograms The histograms of all requests traced so far, including this
+        *     one, with one histogram for each LatencyStage.
+        */
+      virtual void notifyRequestTraced(LatencyTrace const& trace, LatencyHistogram const* histograms) = 0;
+   };
+
+   /**
+     * Adds the time between its construction and its destruction to a stage of a
+     * trace. If the trace is nullptr, the clock is not read at all.
+     */
+   class LatencyScope
+   {
+   public:
+      /**
+        * Starts measuring.
+        * @param trace The trace to add the time to, may be nullptr.
+        * @param stage The stage to measure.
+        */
+      LatencyScope(LatencyTrace* trace, LatencyStage::_Domain stage);
+
+      /** Adds the elapsed time to the trace. */
+      ~LatencyScope();
+
+   private:
+      LatencyScope(LatencyScope const&);
+      LatencyScope& operator=(LatencyScope const&);
+
+   private:
+      LatencyTrace* const m_trace;
+      LatencyStage::_Domain const m_stage;
+      qint64 const m_start;
+   };
+
+
+   // ========================================================
+   //
+   // Inline Implementation
+   //
+   // ========================================================
+
+   inline void LatencyTrace::add(LatencyStage::_Domain stage, qint64 nanoseconds)
+   {
+      m_durations[stage] += nanoseconds;
+   }
+
+   inline qint64 LatencyTrace::duration(LatencyStage::_Domain stage) const
+   {
+      return m_durations[stage];
+   }
+
+   inline quint64 LatencyHistogram::count(int bucket) const
+   {
+      return m_buckets[bucket];
+   }
+
+   inline quint64 LatencyHistogram::count() const
+   {
+      return m_count;
+   }
+
+   inline qint64 LatencyHistogram::upperBound(int bucket)
+   {
+      return Q_INT64_C(1) << bucket;
+   }
+
+   inline LatencyScope::LatencyScope(LatencyTrace* trace, LatencyStage::_Domain stage)
+      : m_trace(trace)
+      , m_stage(stage)
+      , m_start(trace != nullptr ? LatencyTrace::now() : 0)
+   {}
+
+   inline LatencyScope::~LatencyScope()
+   {
+      if(m_trace != nullptr)
+         m_trace->add(m_stage, LatencyTrace::now() - m_start);
+   }
+}
+
+#endif//__TINYEMBERROUTER_UTIL_LATENCYTRACE_H
@@ -0,0 +1,296 @@
+#ifndef __TINYEMBERROUTER_UTIL_LOG_H
+#define __TINYEMBERROUTER_UTIL_LOG_H
+
+#include <atomic>
+#include <cstddef>
+#include <string>
+#include <type_traits>
+#include <QtGlobal>
+
+class QString;
+
+/**
+  * The lowest level of the messages that are compiled in. The messages of the
+  * LOG_* macros with a lower level are removed by the compiler, including the
+  * evaluation of their arguments. Debug messages are only compiled into debug builds.
+  */
+#ifndef TINYEMBER_LOG_MINIMUM_LEVEL
+#  ifdef _DEBUG
+#     define TINYEMBER_LOG_MINIMUM_LEVEL 0
+#  else
+#     define TINYEMBER_LOG_MINIMUM_LEVEL 1
+#  endif
+#endif
+
+/**
+  * Posts a message to the log if its level is compiled in and enabled. The message
+  * arguments are only evaluated in this case.
+  * Usage: TINYEMBER_LOG(util::LogLevel::Info, "received " << size << " bytes");
+  */
+#define TINYEMBER_LOG(level, message)                                              \
+   do                                                                              \
+   {                                                                               \
+      if((level) >= TINYEMBER_LOG_MINIMUM_LEVEL && ::util::Log::isEnabled(level))  \
+      {                                                                            \
+         ::util::LogMessage _logMessage(level);                                    \
+         _logMessage << message;                                                   \
+         ::util::Log::post(_logMessage);                                           \
+      }                                                                            \
+   } while(false)
+
+/**
+  * Posts a message like TINYEMBER_LOG, but only if the passed LogRateLimiter permits
+  * it. The number of messages suppressed before is appended to the message.
+  */
+#define TINYEMBER_LOG_LIMITED(level, limiter, message)                             \
+   do                                                                              \
+   {                                                                               \
+      if((level) >= TINYEMBER_LOG_MINIMUM_LEVEL && ::util::Log::isEnabled(level)   \
+      && (limiter).tryAcquire())                                                   \
+      {                                                                            \
+         ::util::LogMessage _logMessage(level);                                    \
+         _logMessage << message;                                                   \
+         _logMessage.appendSuppressed((limiter).takeSuppressed());                 \
+         ::util::Log::post(_logMessage);                                           \
+      }                                                                            \
+   } while(false)
+
+#define LOG_DEBUG(message) TINYEMBER_LOG(::util::LogLevel::Debug, message)
+#define LOG_INFO(message) TINYEMBER_LOG(::util::LogLevel::Info, message)
+#define LOG_WARNING(message) TINYEMBER_LOG(::util::LogLevel::Warning, message)
+#define LOG_ERROR(message) TINYEMBER_LOG(::util::LogLevel::Error, message)
+#define LOG_ERROR_LIMITED(limiter, message) TINYEMBER_LOG_LIMITED(::util::LogLevel::Error, limiter, message)
+
+namespace util
+{
+   /**
+     * Enumeration of the severities of log messages.
+     */
+   struct LogLevel
+   {
+      enum _Domain
+      {
+         Debug = 0,
+         Info = 1,
+         Warning = 2,
+         Error = 3,
+
+         /** Disables all messages when passed to Log::setLevel. */
+         None = 4,
+      };
+
+      /**
+        * Returns the name of a level, as printed in front of each message.
+        * @param level The level.
+        * @return The upper case name of the level.
+        */
+      static char const* name(_Domain level);
+
+      /**
+        * Parses the name of a level, e.g. from a command line argument.
+        * @param name The case insensitive name, like "debug" or "none".
+        * @param level Receives the parsed level.
+        * @return true if the name is known.
+        */
+      static bool parse(QString const& name, _Domain& level);
+   };
+
+   /**
+     * A single log message, formatted into a buffer of fixed size so that posting it
+     * does not allocate memory. Text that does not fit is truncated.
+     */
+   class LogMessage
+   {
+      friend class Log;
+
+   public:
+      /** The maximum number of characters of a message. */
+      static std::size_t const Capacity = 232;
+
+      /**
+        * Initializes an empty message and records the current time.
+        * @param level The level of the message.
+        */
+      explicit LogMessage(LogLevel::_Domain level = LogLevel::Info);
+
+      LogMessage& operator<<(char const* text);
+      LogMessage& operator<<(std::string const& text);
+      LogMessage& operator<<(QString const& text);
+      LogMessage& operator<<(char value);
+      LogMessage& operator<<(bool value);
+      LogMessage& operator<<(double value);
+
+      template<typename IntegralType>
+      typename std::enable_if<std::is_integral<IntegralType>::value, LogMessage&>::type operator<<(IntegralType value);
+
+      /**
+        * Appends the number of messages that have been suppressed by a LogRateLimiter.
+        * @param count The number of suppressed messages. Nothing is appended if it is 0.
+        */
+      void appendSuppressed(unsigned int count);
+
+      /**
+        * Returns the level of the message.
+        * @return The level of the message.
+        */
+      LogLevel::_Domain level() const;
+
+      /**
+        * Returns the text of the message.
+        * @return The zero-terminated text.
+        */
+      char const* text() const;
+
+   private:
+      void append(char const* text, std::size_t length);
+      void appendSigned(qint64 value);
+      void appendUnsigned(quint64 value);
+
+   private:
+      qint64 m_time;
+      LogLevel::_Domain m_level;
+      std::size_t m_length;
+      char m_text[Capacity + 1];
+   };
+
+   /**
+     * The process wide log. Messages are queued in a fixed size lock-free queue by the
+     * threads posting them and written to stderr by a background thread, so that posting
+     * never waits for console output. Messages posted while the queue is full are dropped
+     * and their number is reported with the next message written.
+     * When no LogWriter is running, messages are written synchronously.
+     */
+   class Log
+   {
+      friend class LogWriter;
+
+   public:
+      /**
+        * Tests whether messages of a level are posted.
+        * @param level The level to test.
+        * @return true if the level is at least the level passed to setLevel.
+        */
+      static bool isEnabled(LogLevel::_Domain level);
+
+      /**
+        * Sets the lowest level of the messages to post. The default is LogLevel::Info.
+        * Levels below TINYEMBER_LOG_MINIMUM_LEVEL are never posted.
+        * @param level The lowest level to post.
+        */
+      static void setLevel(LogLevel::_Domain level);
+
+      /**
+        * Posts a message. Instead of calling this method directly, use the LOG_* macros.
+        * @param message The message to post.
+        */
+      static void post(LogMessage const& message);
+
+   private:
+      static void write(LogMessage const& message);
+      static void writeDropped();
+
+   private:
+      static std::atomic<int> s_level;
+      static std::atomic<bool> s_isWriterRunning;
+   };
+
+   /**
+     * Runs the background thread that writes the queued log messages. Only one instance
+     * may exist at a time. The destructor writes the remaining messages and stops the
+     * thread.
+     */
+   class LogWriter
+   {
+   public:
+      /** Starts the background thread. */
+      LogWriter();
+
+      /** Writes the remaining messages and stops the background thread. */
+      ~LogWriter();
+
+   private:
+      LogWriter(LogWriter const&);
+      LogWriter& operator=(LogWriter const&);
+
+      void run();
+
+   private:
+      struct Thread;
+      Thread* m_thread;
+   };
+
+   /**
+     * Limits the number of messages logged because of a single peer, so that a
+     * misbehaving consumer or provider can not flood the log. Up to burst messages
+     * are permitted at once, afterwards one message per interval.
+     * A limiter is meant to be used by a single thread.
+     */
+   class LogRateLimiter
+   {
+   public:
+      /**
+        * Initializes a new limiter.
+        * @param burst The number of messages permitted at once.
+        * @param interval The number of milliseconds after which another message is permitted, must be positive.
+        */
+      explicit LogRateLimiter(unsigned int burst = 5, qint64 interval = 1000);
+
+      /**
+        * Tests whether a message may be logged now and counts it as suppressed if not.
+        * @return true if the message may be logged.
+        */
+      bool tryAcquire();
+
+      /**
+        * Returns the number of messages suppressed since the last call and resets it.
+        * @return The number of suppressed messages.
+        */
+      unsigned int takeSuppressed();
+
+   private:
+      unsigned int m_burst;
+      qint64 m_interval;
+      unsigned int m_tokens;
+      qint64 m_lastRefill;
+      unsigned int m_suppressed;
+   };
+
+   /**************************************************************************
+    * Inline implementation                                                  *
+    **************************************************************************/
+
+   template<typename IntegralType>
+   inline typename std::enable_if<std::is_integral<IntegralType>::value, LogMessage&>::type LogMessage::operator<<(IntegralType value)
+   {
+      if(std::is_signed<IntegralType>::value)
+         appendSigned(static_cast<qint64>(value));
+      else
+         appendUnsigned(static_cast<quint64>(value));
+
+      return *this;
+   }
+
+   inline LogLevel::_Domain LogMessage::level() const
+   {
+      return m_level;
+   }
+
+   inline char const* LogMessage::text() const
+   {
+      return m_text;
+   }
+
+   inline bool Log::isEnabled(LogLevel::_Domain level)
+   {
+      return level >= s_level.load(std::memory_order_relaxed);
+   }
+
+   inline unsigned int LogRateLimiter::takeSuppressed()
+   {
+      auto const result = m_suppressed;
+      m_suppressed = 0;
+      return result;
+   }
+}
+
+#endif//__TINYEMBERROUTER_UTIL_LOG_H
@@ -0,0 +1,371 @@
+#ifndef __TINYEMBERROUTER_UTIL_METRICS_H
+#define __TINYEMBERROUTER_UTIL_METRICS_H
+
+#include <atomic>
+#include <vector>
+#include <QtCore>
+
+namespace util
+{
+   /**
+     * A monotonically increasing number, e.g. the number of bytes received.
+     * Updating a counter is a single atomic operation and may be done by any thread.
+     */
+   class Counter
+   {
+   public:
+      /** Initializes a counter with the value 0. */
+      Counter();
+
+      /**
+        * Adds to the value of the counter.
+        * @param count The number to add.
+        */
+      void increment(quint64 count = 1);
+
+      /**
+        * Returns the current value.
+        * @return The current value.
+        */
+      quint64 value() const;
+
+   private:
+      Counter(Counter const&);
+      Counter& operator=(Counter const&);
+
+   private:
+      std::atomic<quint64> m_value;
+   };
+
+   /**
+     * A number that may go up and down, e.g. the number of queued requests.
+     * Updating a gauge is a single atomic operation and may be done by any thread.
+     */
+   class Gauge
+   {
+   public:
+      /** Initializes a gauge with the value 0. */
+      Gauge();
+
+      /**
+        * Replaces the value of the gauge.
+        * @param value The new value.
+        */
+      void set(qint64 value);
+
+      /**
+        * Adds to the value of the gauge.
+        * @param delta The number to add, may be negative.
+        */
+      void add(qint64 delta);
+
+      /**
+        * Returns the current value.
+        * @return The current value.
+        */
+      qint64 value() const;
+
+   private:
+      Gauge(Gauge const&);
+      Gauge& operator=(Gauge const&);
+
+   private:
+      std::atomic<qint64> m_value;
+   };
+
+   /**
+     * Counts durations in the buckets of a LatencyHistogram, but may be updated by
+     * several threads at once and also keeps the sum of all durations. The buckets,
+     * the count and the sum are updated separately, so a concurrent export may see
+     * a duration in one of them but not yet in the others.
+     */
+   class Histogram
+   {
+   public:
+      enum { BucketCount = 24 };
+
+      /** Initializes an empty histogram. */
+      Histogram();
+
+      /**
+        * Adds a duration to its bucket.
+        * @param nanoseconds The duration to add.
+        */
+      void record(qint64 nanoseconds);
+
+      /**
+        * Returns the number of durations in a bucket.
+        * @param bucket The index of the bucket, less than BucketCount.
+        * @return The number of durations in the bucket.
+        */
+      quint64 count(int bucket) const;
+
+      /**
+        * Returns the number of recorded durations.
+        * @return The number of recorded durations.
+        */
+      quint64 count() const;
+
+      /**
+        * Returns the sum of all recorded durations.
+        * @return The sum of all durations in nanoseconds.
+        */
+      quint64 sum() const;
+
+      /**
+        * Returns the exclusive upper bound of a bucket.
+        * @param bucket The index of the bucket, less than BucketCount - 1.
+        * @return The upper bound of the bucket in microseconds.
+        */
+      static qint64 upperBound(int bucket);
+
+   private:
+      Histogram(Histogram const&);
+      Histogram& operator=(Histogram const&);
+
+   private:
+      std::atomic<quint64> m_buckets[BucketCount];
+      std::atomic<quint64> m_count;
+      std::atomic<quint64> m_sum;
+   };
+
+   /**
+     * Formats metrics in the Prometheus text exposition format. The samples of a
+     * metric must be written one after the other, the HELP and TYPE lines are only
+     * written for the first of them.
+     */
+   class MetricsWriter
+   {
+   public:
+      /**
+        * Formats a label, escaping the value as required by the exposition format.
+        * Several labels are joined by commas.
+        * @param name The name of the label.
+        * @param value The value of the label.
+        * @return The formatted label, like name="value".
+        */
+      static QByteArray label(char const* name, QString const& value);
+
+   public:
+      /**
+        * Writes the value of a counter.
+        * @param name The name of the metric.
+        * @param help The description of the metric.
+        * @param labels The formatted labels of the sample, may be empty.
+        * @param value The value of the counter.
+        */
+      void writeCounter(QByteArray const& name, QByteArray const& help, QByteArray const& labels, quint64 value);
+
+      /**
+        * Writes the value of a gauge.
+        * @param name The name of the metric.
+        * @param help The description of the metric.
+        * @param labels The formatted labels of the sample, may be empty.
+        * @param value The value of the gauge.
+        */
+      void writeGauge(QByteArray const& name, QByteArray const& help, QByteArray const& labels, qint64 value);
+
+      /**
+        * Writes the cumulative buckets, the sum and the count of a histogram. The
+        * durations are written in seconds.
+        * @param name The name of the metric.
+        * @param help The description of the metric.
+        * @param labels The formatted labels of the sample, may be empty.
+        * @param histogram The histogram to write.
+        */
+      void writeHistogram(QByteArray const& name, QByteArray const& help, QByteArray const& labels, Histogram const& histogram);
+
+      /**
+        * Returns the formatted metrics.
+        * @return The formatted metrics.
+        */
+      QByteArray const& text() const;
+
+   private:
+      void writeHeader(QByteArray const& name, QByteArray const& help, char const* type);
+      void writeSample(QByteArray const& name, char const* suffix, QByteArray const& labels, QByteArray const& value);
+
+   private:
+      QByteArray m_text;
+      QByteArray m_metric;
+   };
+
+   /**
+     * Interface of objects that provide metrics which are only known when they are
+     * exported, e.g. the size of the output queue of every connected client.
+     */
+   class MetricsCollector
+   {
+   public:
+      /** Destructor */
+      virtual ~MetricsCollector()
+      {}
+
+      /**
+        * Writes the current metrics. This method is invoked by the thread exporting
+        * the metrics and must not use a name of a metric created by the registry.
+        * @param writer The writer to pass the metrics to.
+        */
+      virtual void collect(MetricsWriter& writer) const = 0;
+   };
+
+   /**
+     * Owns the metrics of the application and exports them in the Prometheus text
+     * format. Creating a metric and exporting are synchronized, the metrics themselves
+     * are updated without any locking, so the components keep pointers to the metrics
+     * they update, which remain valid until the registry is destroyed.
+     */
+   class MetricsRegistry
+   {
+   public:
+      /** Initializes an empty registry. */
+      MetricsRegistry();
+
+      /** Destructor, deletes all metrics. */
+      ~MetricsRegistry();
+
+      /**
+        * Returns the counter with the specified name and labels, creating it if
+        * it doesn't exist yet.
+        * @param name The name of the metric, e.g. tinyember_bytes_received_total.
+        * @param help The description of the metric.
+        * @param labels The labels formatted by MetricsWriter::label, may be empty.
+        * @return The counter, which is owned by the registry.
+        */
+      Counter* counter(QByteArray const& name, QByteArray const& help, QByteArray const& labels = QByteArray());
+
+      /**
+        * Returns the gauge with the specified name and labels, creating it if
+        * it doesn't exist yet.
+        * @see counter
+        */
+      Gauge* gauge(QByteArray const& name, QByteArray const& help, QByteArray const& labels = QByteArray());
+
+      /**
+        * Returns the histogram with the specified name and labels, creating it if
+        * it doesn't exist yet.
+        * @see counter
+        */
+      Histogram* histogram(QByteArray const& name, QByteArray const& help, QByteArray const& labels = QByteArray());
+
+      /**
+        * Adds a collector whose metrics are exported after those owned by the registry.
+        * @param collector The collector to add, which must be removed before it is destroyed.
+        */
+      void addCollector(MetricsCollector* collector);
+
+      /**
+        * Removes a collector. Returns after an export using the collector has finished.
+        * @param collector The collector to remove.
+        */
+      void removeCollector(MetricsCollector* collector);
+
+      /**
+        * Formats the current values of all metrics. May be called by any thread.
+        * @return The metrics in the Prometheus text exposition format.
+        */
+      QByteArray exportText() const;
+
+   private:
+      struct MetricType
+      {
+         enum _Domain
+         {
+            Counter,
+            Gauge,
+            Histogram,
+         };
+      };
+
+      struct Entry
+      {
+         MetricType::_Domain type;
+         QByteArray name;
+         QByteArray help;
+         QByteArray labels;
+         void* metric;
+      };
+
+      typedef std::vector<Entry> EntryVector;
+      typedef std::vector<MetricsCollector*> CollectorVector;
+
+      void* find(MetricType::_Domain type, QByteArray const& name, QByteArray const& labels) const;
+      void insert(MetricType::_Domain type, QByteArray const& name, QByteArray const& help, QByteArray const& labels, void* metric);
+
+   private:
+      MetricsRegistry(MetricsRegistry const&);
+      MetricsRegistry& operator=(MetricsRegistry const&);
+
+   private:
+      EntryVector m_entries;
+      CollectorVector m_collectors;
+      mutable QMutex m_mutex;
+   };
+
+
+   // ========================================================
+   //
+   // Inline Implementation
+   //
+   // ========================================================
+
+   inline Counter::Counter()
+      : m_value(0)
+   {}
+
+   inline void Counter::increment(quint64 count)
+   {
+      m_value.fetch_add(count, std::memory_order_relaxed);
+   }
+
+   inline quint64 Counter::value() const
+   {
+      return m_value.load(std::memory_order_relaxed);
+   }
+
+   inline Gauge::Gauge()
+      : m_value(0)
+   {}
+
+   inline void Gauge::set(qint64 value)
+   {
+      m_value.store(value, std::memory_order_relaxed);
+   }
+
+   inline void Gauge::add(qint64 delta)
+   {
+      m_value.fetch_add(delta, std::memory_order_relaxed);
+   }
+
+   inline qint64 Gauge::value() const
+   {
+      return m_value.load(std::memory_order_relaxed);
+   }
+
+   inline quint64 Histogram::count(int bucket) const
+   {
+      return m_buckets[bucket].load(std::memory_order_relaxed);
+   }
+
+   inline quint64 Histogram::count() const
+   {
+      return m_count.load(std::memory_order_relaxed);
+   }
+
+   inline quint64 Histogram::sum() const
+   {
+      return m_sum.load(std::memory_order_relaxed);
+   }
+
+   inline qint64 Histogram::upperBound(int bucket)
+   {
+      return Q_INT64_C(1) << bucket;
+   }
+
+   inline QByteArray const& MetricsWriter::text() const
+   {
+      return m_text;
+   }
+}
+
+#endif//__TINYEMBERROUTER_UTIL_METRICS_H
@@ -0,0 +1,117 @@
+#ifndef __TINYEMBERROUTER_UTIL_PATHTRIE_H
+#define __TINYEMBERROUTER_UTIL_PATHTRIE_H
+
+#include <map>
+#include "Types.h"
+
+namespace util
+{
+   /**
+     * Stores a set of paths in a tree keyed by sub-identifier, so that all stored
+     * paths along another path can be tested with a single walk down the tree.
+     */
+   class PathTrie
+   {
+   public:
+      PathTrie();
+
+      ~PathTrie();
+
+      /**
+        * Adds @p path to the trie.
+        * @param path The path to add.
+        */
+      void insert(Oid const& path);
+
+      /**
+        * Tests whether the trie contains @p path or one of its ancestors.
+        * @param path The path to test.
+        * @param maxDistance The maximum number of levels a stored ancestor
+        *     may be above @p path, 0 only tests @p path itself.
+        * @return True if @p path or an ancestor within @p maxDistance has been added.
+        */
+      bool containsAncestorOf(Oid const& path, std::size_t maxDistance) const;
+
+   private:
+      struct Node
+      {
+         typedef std::map<Oid::value_type, Node*> Children;
+
+         Node() : isTerminal(false) {}
+         ~Node();
+
+         bool isTerminal;
+         Children children;
+      };
+
+      PathTrie(PathTrie const&);
+      PathTrie& operator=(PathTrie const&);
+
+   private:
+      Node m_root;
+   };
+
+
+   // ========================================================
+   //
+   // Inline Implementation
+   //
+   // ========================================================
+
+   inline PathTrie::Node::~Node()
+   {
+      auto const last = children.end();
+      for(auto it = children.begin(); it != last; it++)
+         delete it->second;
+   }
+
+   inline PathTrie::PathTrie()
+   {}
+
+   inline PathTrie::~PathTrie()
+   {}
+
+   inline void PathTrie::insert(Oid const& path)
+   {
+      auto node = &m_root;
+
+      auto const last = path.end();
+      for(auto first = path.begin(); first != last; first++)
+      {
+         auto& child = node->children[*first];
+
+         if(child == nullptr)
+            child = new Node();
+
+         node = child;
+      }
+
+      node->isTerminal = true;
+   }
+
+   inline bool PathTrie::containsAncestorOf(Oid const& path, std::size_t maxDistance) const
+   {
+      auto node = &m_root;
+      auto remaining = path.size();
+
+      auto const last = path.end();
+      for(auto first = path.begin(); ; first++)
+      {
+         if(node->isTerminal && remaining <= maxDistance)
+            return true;
+
+         if(first == last)
+            return false;
+
+         auto const child = node->children.find(*first);
+
+         if(child == node->children.end())
+            return false;
+
+         node = child->second;
+         remaining--;
+      }
+   }
+}
+
+#endif//__TINYEMBERROUTER_UTIL_PATHTRIE_H
@@ -0,0 +1,96 @@
+#ifndef __TINYEMBERROUTER_UTIL_SNAPSHOT_H
+#define __TINYEMBERROUTER_UTIL_SNAPSHOT_H
+
+#include <QtCore/QMutex>
+#include <QtCore/QSharedPointer>
+
+namespace util
+{
+   /**
+     * Holds the current version of a value that is changed by copy-on-write.
+     * The thread owning the DOM publishes every change as a new version, while
+     * any other thread may acquire the current version and read it without
+     * further synchronization. An acquired version stays alive until the reader
+     * releases it, so neither side waits for the other to finish its work; the
+     * mutex only protects the exchange of the pointer.
+     */
+   template<typename ValueType>
+   class Snapshot
+   {
+   public:
+      typedef QSharedPointer<ValueType const> Pointer;
+
+   public:
+      Snapshot();
+
+      /**
+        * Returns the current version. This method may be called from any thread.
+        * @return The current version, or a null pointer if no version has
+        *     been published yet.
+        */
+      Pointer acquire() const;
+
+      /**
+        * Tests whether @p version is still the current version. This method
+        * may be called from any thread.
+        * @param version A version previously returned by acquire().
+        * @return True if no other version has been published since.
+        */
+      bool isCurrent(Pointer const& version) const;
+
+      /**
+        * Replaces the current version. Readers still holding the previous
+        * version keep it alive until they release it.
+        * @param value The new version. The snapshot takes ownership.
+        */
+      void publish(ValueType const* value);
+
+   private:
+      Snapshot(Snapshot const&);
+      Snapshot& operator=(Snapshot const&);
+
+   private:
+      mutable QMutex m_mutex;
+      Pointer m_current;
+   };
+
+
+   // ========================================================
+   //
+   // Inline Implementation
+   //
+   // ========================================================
+
+   template<typename ValueType>
+   inline Snapshot<ValueType>::Snapshot()
+   {}
+
+   template<typename ValueType>
+   inline typename Snapshot<ValueType>::Pointer Snapshot<ValueType>::acquire() const
+   {
+      QMutexLocker const lock(&m_mutex);
+      return m_current;
+   }
+
+   template<typename ValueType>
+   inline bool Snapshot<ValueType>::isCurrent(Pointer const& version) const
+   {
+      QMutexLocker const lock(&m_mutex);
+      return m_current == version;
+   }
+
+   template<typename ValueType>
+   inline void Snapshot<ValueType>::publish(ValueType const* value)
+   {
+      auto version = Pointer(value);
+
+      {
+         QMutexLocker const lock(&m_mutex);
+         qSwap(m_current, version);
+      }
+
+      // the previous version is released outside of the lock
+   }
+}
+
+#endif//__TINYEMBERROUTER_UTIL_SNAPSHOT_H
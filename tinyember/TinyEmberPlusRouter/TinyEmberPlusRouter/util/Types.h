@@ -16,6 +16,14 @@ namespace util
    typedef std::vector<libember::glow::Value> VariantValueVector;
    typedef libember::glow::ParameterType VariantType;
 
+   /**
+     * Hashes an Oid, so that it can be used as key of an unordered container.
+     */
+   struct OidHash
+   {
+      inline std::size_t operator()(Oid const& oid) const { return oid.hash(); }
+   };
+
    class TupleItem
    {
    public: